@@ -33,8 +33,17 @@ DEFINE_int32(heartbeat_interval_secs, 10, "Heartbeat interval in seconds");
 DEFINE_int32(meta_client_retry_times, 3, "meta client retry times, 0 means no retry");
 DEFINE_int32(meta_client_retry_interval_secs, 1, "meta client sleep interval between retry");
 DEFINE_int32(meta_client_timeout_ms, 60 * 1000, "meta client timeout");
+DEFINE_string(meta_client_protocol,
+              "compact",
+              "The thrift protocol of the requests to meta and the responses, compact or binary");
 DEFINE_string(cluster_id_path, "cluster.id", "file path saved clusterId");
 DEFINE_int32(check_plan_killed_frequency, 8, "check plan killed every 1<<n times");
+DEFINE_bool(enable_optimizer_stats,
+            false,
+            "Whether to load the stats of spaces for the cost based optimizer, only for graphd");
+DEFINE_int32(optimizer_stats_refresh_interval_secs,
+             60,
+             "The interval in seconds to reload the stats of spaces for the optimizer");
 DEFINE_uint32(failed_login_attempts,
               0,
               "how many consecutive incorrect passwords input to a SINGLE graph service node cause "
@@ -44,6 +53,20 @@ DEFINE_uint32(
     0,
     "how long in seconds to lock the account after too many consecutive login attempts provide an "
     "incorrect password.");
+DEFINE_uint32(leader_refresh_delay_ms,
+              200,
+              "The delay in ms to reload the storage leaders from metad after a leader changed "
+              "error, the errors within it share one reload. 0 means never reload until the next "
+              "heartbeat");
+DEFINE_uint32(leader_change_report_delay_ms,
+              100,
+              "The delay in ms of the extra heartbeat which reports the leaders of a storage after "
+              "its leadership changed, the changes within it share one heartbeat. 0 means only "
+              "report them by the regular heartbeat");
+DEFINE_uint32(heartbeat_full_leaders_interval,
+              30,
+              "A storage reports only the leaders changed since the last heartbeat acked by metad, "
+              "and all its leaders every so many heartbeats. 0 or 1 means always report all");
 
 // Sanity-checking Flag Values
 static bool ValidateFailedLoginAttempts(const char* flagname, uint32_t value) {
@@ -62,18 +85,63 @@ namespace meta {
 
 Indexes buildIndexes(std::vector<cpp2::IndexItem> indexItemVec);
 
+// Copy the entries of the given spaces, the maps are keyed by the space id or a pair of it
+template <typename Map>
+void keepSpaces(const Map& from, const std::unordered_set<GraphSpaceID>& spaces, Map& to) {
+  for (const auto& entry : from) {
+    GraphSpaceID spaceId;
+    if constexpr (std::is_same_v<typename Map::key_type, GraphSpaceID>) {
+      spaceId = entry.first;
+    } else {
+      spaceId = entry.first.first;
+    }
+    if (spaces.count(spaceId) > 0) {
+      to.emplace(entry);
+    }
+  }
+}
+
+// The leaders in current which are not in reported, or with a different term
+std::unordered_map<GraphSpaceID, std::vector<cpp2::LeaderInfo>> changedLeaders(
+    const std::unordered_map<GraphSpaceID, std::vector<cpp2::LeaderInfo>>& reported,
+    const std::unordered_map<GraphSpaceID, std::vector<cpp2::LeaderInfo>>& current) {
+  std::unordered_map<GraphSpaceID, std::vector<cpp2::LeaderInfo>> changed;
+  for (const auto& [spaceId, leaders] : current) {
+    std::unordered_map<PartitionID, TermID> terms;
+    auto it = reported.find(spaceId);
+    if (it != reported.end()) {
+      for (const auto& leader : it->second) {
+        terms.emplace(leader.get_part_id(), leader.get_term());
+      }
+    }
+    for (const auto& leader : leaders) {
+      auto term = terms.find(leader.get_part_id());
+      if (term == terms.end() || term->second != leader.get_term()) {
+        changed[spaceId].emplace_back(leader);
+      }
+    }
+  }
+  return changed;
+}
+
 MetaClient::MetaClient(std::shared_ptr<folly::IOThreadPoolExecutor> ioThreadPool,
                        std::vector<HostAddr> addrs,
                        const MetaClientOptions& options)
     : ioThreadPool_(ioThreadPool),
+      leadersInfo_(new LeaderInfo()),
       addrs_(std::move(addrs)),
       options_(options),
       metadata_(new MetaData()) {
   CHECK(ioThreadPool_ != nullptr) << "IOThreadPool is required";
   CHECK(!addrs_.empty())
       << "No meta server address is specified or can be solved. Meta server is required";
+  auto channelOptions = thrift::ChannelOptions::make(FLAGS_meta_client_protocol, "none", 0);
+  if (!channelOptions.ok()) {
+    LOG(WARNING) << channelOptions.status() << ", use the default channel options of meta client";
+    channelOptions = thrift::ChannelOptions();
+  }
   clientsMan_ = std::make_shared<thrift::ThriftClientManager<cpp2::MetaServiceAsyncClient>>(
-      FLAGS_enable_ssl || FLAGS_enable_meta_ssl);
+      FLAGS_enable_ssl || FLAGS_enable_meta_ssl, std::move(channelOptions).value());
   updateActive();
   updateLeader();
   bgThread_ = std::make_unique<thread::GenericWorker>();
@@ -86,6 +154,7 @@ MetaClient::~MetaClient() {
   notifyStop();
   stop();
   delete metadata_.load();
+  delete leadersInfo_.load();
   VLOG(3) << "~MetaClient";
 }
 
@@ -177,6 +246,8 @@ void MetaClient::stop() {
     bgThread_->wait();
     bgThread_.reset();
   }
+  // The stats continuation captures this, wait for it before the client goes away
+  statsLoading_.wait();
 }
 
 void MetaClient::heartBeatThreadFunc() {
@@ -197,6 +268,77 @@ void MetaClient::heartBeatThreadFunc() {
   // if MetaServer has some changes, refresh the localCache_
   loadData();
   loadCfg();
+
+  // The stats are only changed by stats job, which doesn't bump the last update time of metad
+  if (options_.role_ == cpp2::HostRole::GRAPH && FLAGS_enable_optimizer_stats) {
+    auto now = time::WallClock::fastNowInSec();
+    // Skip this round if the last load is still in flight
+    if (now - statsLastLoadTime_ >= FLAGS_optimizer_stats_refresh_interval_secs &&
+        statsLoading_.isReady()) {
+      statsLastLoadTime_ = now;
+      loadStats();
+    }
+  }
+}
+
+void MetaClient::loadStats() {
+  std::vector<GraphSpaceID> spaces;
+  {
+    folly::rcu_reader guard;
+    const auto& metadata = *metadata_.load();
+    for (const auto& it : metadata.localCache_) {
+      spaces.emplace_back(it.first);
+    }
+  }
+
+  // Fetch the stats of all spaces concurrently, and swap the cache once all of them are back, so
+  // the heartbeat thread never blocks on them
+  std::vector<folly::Future<StatusOr<cpp2::StatsItem>>> futures;
+  futures.reserve(spaces.size());
+  for (auto spaceId : spaces) {
+    futures.emplace_back(getStats(spaceId));
+  }
+  statsLoading_ =
+      folly::collectAll(std::move(futures))
+          .via(ioThreadPool_.get())
+          .thenValue([this, spaces = std::move(spaces)](
+                         std::vector<folly::Try<StatusOr<cpp2::StatsItem>>>&& results) {
+            decltype(statsCache_) statsCache;
+            for (size_t i = 0; i < results.size(); ++i) {
+              auto spaceId = spaces[i];
+              auto& result = results[i];
+              if (result.hasException()) {
+                VLOG(2) << "Get stats of space " << spaceId
+                        << " failed, exception: " << result.exception().what();
+                continue;
+              }
+              auto& ret = result.value();
+              if (!ret.ok()) {
+                // The stats job may never be submitted in this space
+                VLOG(2) << "Get stats of space " << spaceId << " failed, status: " << ret.status();
+                continue;
+              }
+              auto stats = std::move(ret).value();
+              if (stats.get_status() != cpp2::JobStatus::FINISHED) {
+                continue;
+              }
+              statsCache.emplace(spaceId,
+                                 std::make_shared<const cpp2::StatsItem>(std::move(stats)));
+            }
+
+            folly::RWSpinLock::WriteHolder holder(statsLock_);
+            statsCache_ = std::move(statsCache);
+          });
+}
+
+StatusOr<std::shared_ptr<const cpp2::StatsItem>> MetaClient::getStatsFromCache(
+    GraphSpaceID spaceId) {
+  folly::RWSpinLock::ReadHolder holder(statsLock_);
+  auto iter = statsCache_.find(spaceId);
+  if (iter == statsCache_.end()) {
+    return Status::Error("The stats of space %d is not found", spaceId);
+  }
+  return iter->second;
 }
 
 bool MetaClient::loadUsersAndRoles() {
@@ -285,6 +427,23 @@ bool MetaClient::loadData() {
     return false;
   }
 
+  // If nothing but the schemas, indexes or listeners of some spaces changed since the last
+  // load, only the spaces changed are reloaded, the others are kept as they are
+  std::optional<int64_t> globalUpdateTime;
+  std::unordered_map<GraphSpaceID, int64_t> spaceUpdateTimes;
+  {
+    std::lock_guard<thread::ProfiledMutex> guard(updateTimesLock_);
+    globalUpdateTime = metadGlobalUpdateTime_;
+    spaceUpdateTimes = metadSpaceUpdateTimes_;
+  }
+  bool incremental = globalUpdateTime.has_value() && localGlobalUpdateTime_ == globalUpdateTime;
+  auto updateTimeOf = [](const auto& updateTimes, GraphSpaceID spaceId) -> int64_t {
+    auto iter = updateTimes.find(spaceId);
+    return iter == updateTimes.end() ? 0 : iter->second;
+  };
+  const auto* lastMetaData = metadata_.load();
+  std::unordered_set<GraphSpaceID> keptSpaces;
+
   auto ret = listSpaces().get();
   if (!ret.ok()) {
     LOG(ERROR) << "List space failed, status:" << ret.status();
@@ -311,6 +470,24 @@ bool MetaClient::loadData() {
       return false;
     }
 
+    if (incremental && localCache_.count(spaceId) > 0 &&
+        lastMetaData->localCache_.count(spaceId) > 0 &&
+        updateTimeOf(spaceUpdateTimes, spaceId) == updateTimeOf(localSpaceUpdateTimes_, spaceId)) {
+      // The terms of the parts change with their leaders, which don't bump the update time of
+      // the space, so they are refreshed along with the leaders
+      auto spaceCache = localCache_[spaceId];
+      if (spaceCache->termOfPartition_ != partTerms || spaceCache->partsAlloc_ != r.value()) {
+        spaceCache = std::make_shared<SpaceInfoCache>(*spaceCache);
+        spaceCache->partsOnHost_ = reverse(r.value());
+        spaceCache->partsAlloc_ = std::move(r).value();
+        spaceCache->termOfPartition_ = std::move(partTerms);
+      }
+      keptSpaces.emplace(spaceId);
+      cache.emplace(spaceId, std::move(spaceCache));
+      spaceIndexByName.emplace(space.second, spaceId);
+      continue;
+    }
+
     auto spaceCache = std::make_shared<SpaceInfoCache>();
     auto partsAlloc = r.value();
     auto& spaceName = space.second;
@@ -355,6 +532,17 @@ bool MetaClient::loadData() {
     cache.emplace(spaceId, spaceCache);
     spaceIndexByName.emplace(space.second, spaceId);
   }
+  if (!keptSpaces.empty()) {
+    keepSpaces(spaceTagIndexByName_, keptSpaces, spaceTagIndexByName);
+    keepSpaces(spaceEdgeIndexByName_, keptSpaces, spaceEdgeIndexByName);
+    keepSpaces(spaceNewestTagVerMap_, keptSpaces, spaceNewestTagVerMap);
+    keepSpaces(spaceNewestEdgeVerMap_, keptSpaces, spaceNewestEdgeVerMap);
+    keepSpaces(spaceEdgeIndexByType_, keptSpaces, spaceEdgeIndexByType);
+    keepSpaces(spaceTagIndexById_, keptSpaces, spaceTagIndexById);
+    keepSpaces(spaceAllEdgeMap_, keptSpaces, spaceAllEdgeMap);
+  }
+  VLOG(1) << "Reload " << ret.value().size() - keptSpaces.size() << " of "
+          << ret.value().size() << " spaces";
 
   auto hostsRet = listHosts().get();
   if (!hostsRet.ok()) {
@@ -390,6 +578,20 @@ bool MetaClient::loadData() {
 
   for (auto& spaceInfo : localCache_) {
     GraphSpaceID spaceId = spaceInfo.first;
+    if (keptSpaces.count(spaceId) > 0) {
+      // The schemas and indexes built are never modified once published, so they are shared
+      auto kept = lastMetaData->localCache_.at(spaceId);
+      const auto& info = spaceInfo.second;
+      if (kept->termOfPartition_ != info->termOfPartition_ ||
+          kept->partsAlloc_ != info->partsAlloc_) {
+        kept = std::make_shared<SpaceInfoCache>(*kept);
+        kept->partsAlloc_ = info->partsAlloc_;
+        kept->partsOnHost_ = info->partsOnHost_;
+        kept->termOfPartition_ = info->termOfPartition_;
+      }
+      newMetaData->localCache_[spaceId] = std::move(kept);
+      continue;
+    }
     std::shared_ptr<SpaceInfoCache> info = spaceInfo.second;
     std::shared_ptr<SpaceInfoCache> infoDeepCopy = std::make_shared<SpaceInfoCache>(*info);
     infoDeepCopy->tagSchemas_ = buildTagSchemas(infoDeepCopy->tagItemVec_);
@@ -417,6 +619,8 @@ bool MetaClient::loadData() {
   auto oldMetaData = metadata_.load();
   metadata_.store(newMetaData);
   folly::rcu_retire(oldMetaData);
+  localGlobalUpdateTime_ = globalUpdateTime;
+  localSpaceUpdateTimes_ = std::move(spaceUpdateTimes);
   diff(oldCache, localCache_);
   listenerDiff(oldCache, localCache_);
   loadRemoteListeners();
@@ -1177,6 +1381,54 @@ PartitionID MetaClient::partId(int32_t numParts, const VertexID id) const {
   return pId;
 }
 
+int32_t MetaClient::splitParts(GraphSpaceID spaceId, const VertexID& id) const {
+  if (!ready_) {
+    return 1;
+  }
+  folly::rcu_reader guard;
+  const auto& metadata = *metadata_.load();
+  auto spaceIt = metadata.localCache_.find(spaceId);
+  if (spaceIt == metadata.localCache_.end()) {
+    return 1;
+  }
+  const auto& splitVertices = spaceIt->second->spaceDesc_.split_vertices_ref();
+  if (!splitVertices.has_value()) {
+    return 1;
+  }
+  auto found = splitVertices->find(id);
+  return found == splitVertices->end() ? 1 : found->second;
+}
+
+PartitionID MetaClient::edgePart(GraphSpaceID spaceId,
+                                 int32_t numParts,
+                                 const VertexID& src,
+                                 const VertexID& dst) const {
+  auto first = partId(numParts, src);
+  auto num = splitParts(spaceId, src);
+  if (num <= 1) {
+    return first;
+  }
+  return nthPart(numParts, first, MurmurHash2()(dst.data(), dst.size()) % num);
+}
+
+void MetaClient::edgeParts(GraphSpaceID spaceId,
+                           int32_t numParts,
+                           const VertexID& src,
+                           const VertexID& dst,
+                           std::vector<PartitionID>* parts) const {
+  auto first = partId(numParts, src);
+  auto num = splitParts(spaceId, src);
+  if (num <= 1) {
+    parts->emplace_back(first);
+    return;
+  }
+  auto part = nthPart(numParts, first, MurmurHash2()(dst.data(), dst.size()) % num);
+  parts->emplace_back(part);
+  if (part != first) {
+    parts->emplace_back(first);
+  }
+}
+
 folly::Future<StatusOr<cpp2::AdminJobResult>> MetaClient::submitJob(
     GraphSpaceID spaceId, cpp2::JobOp op, cpp2::JobType type, std::vector<std::string> paras) {
   cpp2::AdminJobReq req;
@@ -1210,10 +1462,12 @@ folly::Future<StatusOr<GraphSpaceID>> MetaClient::createSpace(meta::cpp2::SpaceD
 }
 
 folly::Future<StatusOr<GraphSpaceID>> MetaClient::createSpaceAs(const std::string& oldSpaceName,
-                                                                const std::string& newSpaceName) {
+                                                                const std::string& newSpaceName,
+                                                                bool withData) {
   cpp2::CreateSpaceAsReq req;
   req.old_space_name_ref() = oldSpaceName;
   req.new_space_name_ref() = newSpaceName;
+  req.with_data_ref() = withData;
   folly::Promise<StatusOr<GraphSpaceID>> promise;
   auto future = promise.getFuture();
   getResponse(
@@ -1705,13 +1959,15 @@ folly::Future<StatusOr<bool>> MetaClient::dropEdgeSchema(GraphSpaceID spaceId,
   return future;
 }
 
-folly::Future<StatusOr<IndexID>> MetaClient::createTagIndex(GraphSpaceID spaceID,
-                                                            std::string indexName,
-                                                            std::string tagName,
-                                                            std::vector<cpp2::IndexFieldDef> fields,
-                                                            bool ifNotExists,
-                                                            const cpp2::IndexParams* indexParams,
-                                                            const std::string* comment) {
+folly::Future<StatusOr<IndexID>> MetaClient::createTagIndex(
+    GraphSpaceID spaceID,
+    std::string indexName,
+    std::string tagName,
+    std::vector<cpp2::IndexFieldDef> fields,
+    bool ifNotExists,
+    const cpp2::IndexParams* indexParams,
+    const std::string* comment,
+    std::vector<std::string> includeFields) {
   cpp2::CreateTagIndexReq req;
   req.space_id_ref() = spaceID;
   req.index_name_ref() = std::move(indexName);
@@ -1724,6 +1980,9 @@ folly::Future<StatusOr<IndexID>> MetaClient::createTagIndex(GraphSpaceID spaceID
   if (comment != nullptr) {
     req.comment_ref() = *comment;
   }
+  if (!includeFields.empty()) {
+    req.include_fields_ref() = std::move(includeFields);
+  }
 
   folly::Promise<StatusOr<IndexID>> promise;
   auto future = promise.getFuture();
@@ -1827,7 +2086,8 @@ folly::Future<StatusOr<IndexID>> MetaClient::createEdgeIndex(
     std::vector<cpp2::IndexFieldDef> fields,
     bool ifNotExists,
     const cpp2::IndexParams* indexParams,
-    const std::string* comment) {
+    const std::string* comment,
+    std::vector<std::string> includeFields) {
   cpp2::CreateEdgeIndexReq req;
   req.space_id_ref() = spaceID;
   req.index_name_ref() = std::move(indexName);
@@ -1840,6 +2100,9 @@ folly::Future<StatusOr<IndexID>> MetaClient::createEdgeIndex(
   if (comment != nullptr) {
     req.comment_ref() = *comment;
   }
+  if (!includeFields.empty()) {
+    req.include_fields_ref() = std::move(includeFields);
+  }
 
   folly::Promise<StatusOr<IndexID>> promise;
   auto future = promise.getFuture();
@@ -2275,9 +2538,10 @@ StatusOr<HostAddr> MetaClient::getStorageLeaderFromCache(GraphSpaceID spaceId, P
   }
 
   {
-    folly::RWSpinLock::ReadHolder holder(leadersLock_);
-    auto iter = leadersInfo_.leaderMap_.find({spaceId, partId});
-    if (iter != leadersInfo_.leaderMap_.end()) {
+    folly::rcu_reader guard;
+    const auto& leaderMap = leadersInfo_.load()->leaderMap_;
+    auto iter = leaderMap.find({spaceId, partId});
+    if (iter != leaderMap.end()) {
       return iter->second;
     }
   }
@@ -2288,12 +2552,14 @@ StatusOr<HostAddr> MetaClient::getStorageLeaderFromCache(GraphSpaceID spaceId, P
       return partHostsRet.status();
     }
     auto partHosts = partHostsRet.value();
-    folly::RWSpinLock::WriteHolder wh(leadersLock_);
     VLOG(1) << "No leader exists. Choose one in round-robin.";
-    auto index = (leadersInfo_.pickedIndex_[{spaceId, partId}] + 1) % partHosts.hosts_.size();
-    auto picked = partHosts.hosts_[index];
-    leadersInfo_.leaderMap_[{spaceId, partId}] = picked;
-    leadersInfo_.pickedIndex_[{spaceId, partId}] = index;
+    HostAddr picked;
+    updateLeaders([&](LeaderInfo& leaders) {
+      auto index = (leaders.pickedIndex_[{spaceId, partId}] + 1) % partHosts.hosts_.size();
+      picked = partHosts.hosts_[index];
+      leaders.leaderMap_[{spaceId, partId}] = picked;
+      leaders.pickedIndex_[{spaceId, partId}] = index;
+    });
     return picked;
   }
 }
@@ -2302,22 +2568,27 @@ void MetaClient::updateStorageLeader(GraphSpaceID spaceId,
                                      PartitionID partId,
                                      const HostAddr& leader) {
   VLOG(1) << "Update the leader for [" << spaceId << ", " << partId << "] to " << leader;
-  folly::RWSpinLock::WriteHolder holder(leadersLock_);
-  leadersInfo_.leaderMap_[{spaceId, partId}] = leader;
+  updateLeaders([&](LeaderInfo& leaders) { leaders.leaderMap_[{spaceId, partId}] = leader; });
 }
 
 void MetaClient::invalidStorageLeader(GraphSpaceID spaceId, PartitionID partId) {
   VLOG(1) << "Invalidate the leader for [" << spaceId << ", " << partId << "]";
-  folly::RWSpinLock::WriteHolder holder(leadersLock_);
-  leadersInfo_.leaderMap_.erase({spaceId, partId});
+  updateLeaders([&](LeaderInfo& leaders) { leaders.leaderMap_.erase({spaceId, partId}); });
+}
+
+void MetaClient::updateLeaders(std::function<void(LeaderInfo&)> update) {
+  std::lock_guard<thread::ProfiledMutex> guard(leadersLock_);
+  auto* newLeaders = new LeaderInfo(*leadersInfo_.load());
+  update(*newLeaders);
+  folly::rcu_retire(leadersInfo_.exchange(newLeaders));
 }
 
 StatusOr<LeaderInfo> MetaClient::getLeaderInfo() {
   if (!ready_) {
     return Status::Error("Not ready!");
   }
-  folly::RWSpinLock::ReadHolder holder(leadersLock_);
-  return leadersInfo_;
+  folly::rcu_reader guard;
+  return *leadersInfo_.load();
 }
 
 const std::vector<HostAddr>& MetaClient::getAddresses() {
@@ -2477,24 +2748,36 @@ folly::Future<StatusOr<bool>> MetaClient::heartbeat() {
   req.host_ref() = options_.localHost_;
   req.role_ref() = options_.role_;
   req.git_info_sha_ref() = options_.gitInfoSHA_;
+  // The leaders acked by metad are kept to compute the changed ones of the next heartbeat
+  std::unordered_map<GraphSpaceID, std::vector<cpp2::LeaderInfo>> leaders;
   if (options_.role_ == cpp2::HostRole::STORAGE) {
     if (options_.clusterId_.load() == 0) {
       options_.clusterId_ = FileBasedClusterIdMan::getClusterIdFromFile(FLAGS_cluster_id_path);
     }
     req.cluster_id_ref() = options_.clusterId_.load();
-    std::unordered_map<GraphSpaceID, std::vector<cpp2::LeaderInfo>> leaderIds;
     if (listener_ != nullptr) {
-      listener_->fetchLeaderInfo(leaderIds);
-      if (leaderIds_ != leaderIds) {
-        {
-          folly::RWSpinLock::WriteHolder holder(leaderIdsLock_);
-          leaderIds_.clear();
-          leaderIds_ = leaderIds;
-        }
-      }
-      req.leader_partIds_ref() = std::move(leaderIds);
+      listener_->fetchLeaderInfo(leaders);
+    }
+    // With hundreds of storages, metad checks every leader reported against its term, so only
+    // the changed ones are reported, and all of them once in a while in case metad lost some,
+    // e.g. restored from a snapshot
+    auto interval = std::max(FLAGS_heartbeat_full_leaders_interval, 1U);
+    if (heartbeatsSinceFullLeaders_++ % interval == 0) {
+      req.leader_partIds_ref() = leaders;
     } else {
-      req.leader_partIds_ref() = std::move(leaderIds);
+      folly::RWSpinLock::ReadHolder holder(leaderIdsLock_);
+      auto changed = changedLeaders(leaderIds_, leaders);
+      if (!changed.empty()) {
+        req.leader_partIds_ref() = std::move(changed);
+      }
+    }
+
+    if (options_.partLoadsFetcher_) {
+      PartLoadsMap partLoads;
+      options_.partLoadsFetcher_(partLoads);
+      if (!partLoads.empty()) {
+        req.part_loads_ref() = std::move(partLoads);
+      }
     }
 
     kvstore::SpaceDiskPartsMap diskParts;
@@ -2533,7 +2816,7 @@ folly::Future<StatusOr<bool>> MetaClient::heartbeat() {
   getResponse(
       std::move(req),
       [](auto client, auto request) { return client->future_heartBeat(request); },
-      [this](cpp2::HBResp&& resp) -> bool {
+      [this, leaders = std::move(leaders)](cpp2::HBResp&& resp) -> bool {
         if (options_.role_ == cpp2::HostRole::STORAGE && options_.clusterId_.load() == 0) {
           LOG(INFO) << "Persist the cluster Id from metad " << resp.get_cluster_id();
           if (FileBasedClusterIdMan::persistInFile(resp.get_cluster_id(), FLAGS_cluster_id_path)) {
@@ -2543,6 +2826,23 @@ folly::Future<StatusOr<bool>> MetaClient::heartbeat() {
           }
         }
         heartbeatTime_ = time::WallClock::fastNowInMilliSec();
+        {
+          std::lock_guard<thread::ProfiledMutex> guard(updateTimesLock_);
+          if (resp.global_update_time_in_ms_ref().has_value()) {
+            metadGlobalUpdateTime_ = *resp.global_update_time_in_ms_ref();
+            metadSpaceUpdateTimes_ = resp.space_update_time_in_ms_ref().value_or(
+                std::unordered_map<GraphSpaceID, int64_t>());
+          } else {
+            metadGlobalUpdateTime_.reset();
+            metadSpaceUpdateTimes_.clear();
+          }
+        }
+        if (resp.killed_queries_ref().has_value()) {
+          std::lock_guard<std::mutex> guard(killedQueriesLock_);
+          for (auto& [sessionId, epIds] : *resp.killed_queries_ref()) {
+            killedQueries_[sessionId].insert(epIds.begin(), epIds.end());
+          }
+        }
         metadLastUpdateTime_ = resp.get_last_update_time_in_ms();
         VLOG(1) << "Metad last update time: " << metadLastUpdateTime_;
         metaServerVersion_ = resp.get_meta_version();
@@ -2550,6 +2850,10 @@ folly::Future<StatusOr<bool>> MetaClient::heartbeat() {
         bool succeeded = resp.get_code() == nebula::cpp2::ErrorCode::SUCCEEDED;
         if (succeeded) {
           dirInfoReported_ = true;
+          if (options_.role_ == cpp2::HostRole::STORAGE) {
+            folly::RWSpinLock::WriteHolder holder(leaderIdsLock_);
+            leaderIds_ = leaders;
+          }
         }
         return succeeded;
       },
@@ -3098,9 +3402,48 @@ void MetaClient::loadLeader(const std::vector<cpp2::HostItem>& hostItems,
     // todo(doodle): in worst case, storage and meta isolated, so graph may get a outdate
     // leader info. The problem could be solved if leader term are cached as well.
     LOG(INFO) << "Load leader ok";
-    folly::RWSpinLock::WriteHolder wh(leadersLock_);
-    leadersInfo_ = std::move(leaderInfo);
+    std::lock_guard<thread::ProfiledMutex> guard(leadersLock_);
+    folly::rcu_retire(leadersInfo_.exchange(new LeaderInfo(std::move(leaderInfo))));
+  }
+}
+
+void MetaClient::refreshLeadersSoon() {
+  if (FLAGS_leader_refresh_delay_ms == 0 || !isRunning_ || bgThread_ == nullptr) {
+    return;
+  }
+  bool expected = false;
+  if (!leaderRefreshScheduled_.compare_exchange_strong(expected, true)) {
+    return;
+  }
+  // Run in bgThread_ as loadData, so spaceIndexByName_ is safe to read
+  bgThread_->addDelayTask(FLAGS_leader_refresh_delay_ms, [this]() {
+    leaderRefreshScheduled_ = false;
+    auto hostsRet = listHosts().get();
+    if (!hostsRet.ok()) {
+      LOG(WARNING) << "Refresh the storage leaders failed, status: " << hostsRet.status();
+      return;
+    }
+    loadLeader(hostsRet.value(), spaceIndexByName_);
+  });
+}
+
+void MetaClient::reportLeadersSoon() {
+  if (FLAGS_leader_change_report_delay_ms == 0 || !isRunning_ || bgThread_ == nullptr ||
+      options_.role_ != cpp2::HostRole::STORAGE) {
+    return;
   }
+  bool expected = false;
+  if (!leaderReportScheduled_.compare_exchange_strong(expected, true)) {
+    return;
+  }
+  bgThread_->addDelayTask(FLAGS_leader_change_report_delay_ms, [this]() {
+    leaderReportScheduled_ = false;
+    // The heartbeat carries all the leaders of this host
+    auto ret = heartbeat().get();
+    if (!ret.ok()) {
+      LOG(WARNING) << "Report the leaders changed failed, status: " << ret.status();
+    }
+  });
 }
 
 folly::Future<StatusOr<bool>> MetaClient::addHosts(std::vector<HostAddr> hosts) {
@@ -3616,10 +3959,21 @@ bool MetaClient::checkIsPlanKilled(SessionID sessionId, ExecutionPlanID planId)
   if (check_counter != 0) {
     return false;
   }
+  return isPlanKilled(sessionId, planId);
+}
+
+bool MetaClient::isPlanKilled(SessionID sessionId, ExecutionPlanID planId) {
   folly::rcu_reader guard;
   return metadata_.load()->killedPlans_.count({sessionId, planId});
 }
 
+KilledQueries MetaClient::takeKilledQueries() {
+  std::lock_guard<std::mutex> guard(killedQueriesLock_);
+  KilledQueries killedQueries;
+  killedQueries.swap(killedQueries_);
+  return killedQueries;
+}
+
 Status MetaClient::verifyVersion() {
   auto req = cpp2::VerifyClientVersionReq();
   req.build_version_ref() = getOriginVersion();
@@ -24,6 +24,7 @@
 #include "common/meta/GflagsManager.h"
 #include "common/meta/NebulaSchemaProvider.h"
 #include "common/thread/GenericWorker.h"
+#include "common/thread/ProfiledMutex.h"
 #include "common/thrift/ThriftClientManager.h"
 #include "interface/gen-cpp2/MetaServiceAsyncClient.h"
 #include "interface/gen-cpp2/common_types.h"
@@ -155,6 +156,12 @@ using FTIndexMap = std::unordered_map<std::string, cpp2::FTIndex>;
 
 using SessionMap = std::unordered_map<SessionID, cpp2::Session>;
 
+// The queries to kill of each session
+using KilledQueries = std::unordered_map<SessionID, std::unordered_set<ExecutionPlanID>>;
+
+// The recent requests of each part
+using PartLoadsMap = std::unordered_map<GraphSpaceID, std::unordered_map<PartitionID, int64_t>>;
+
 class MetaChangedListener {
  public:
   virtual ~MetaChangedListener() = default;
@@ -190,7 +197,8 @@ struct MetaClientOptions {
         role_(opt.role_),
         gitInfoSHA_(opt.gitInfoSHA_),
         dataPaths_(opt.dataPaths_),
-        rootPath_(opt.rootPath_) {}
+        rootPath_(opt.rootPath_),
+        partLoadsFetcher_(opt.partLoadsFetcher_) {}
 
   // Current host address
   HostAddr localHost_{"", 0};
@@ -209,6 +217,8 @@ struct MetaClientOptions {
   std::vector<std::string> dataPaths_;
   // Install path, used in metad/graphd/storaged
   std::string rootPath_;
+  // Fetch the recent requests of the parts reported by the heartbeats, used in storaged
+  std::function<void(PartLoadsMap&)> partLoadsFetcher_;
 };
 
 class BaseMetaClient {
@@ -271,8 +281,10 @@ class MetaClient : public BaseMetaClient {
   folly::Future<StatusOr<GraphSpaceID>> createSpace(meta::cpp2::SpaceDesc spaceDesc,
                                                     bool ifNotExists = false);
 
+  // Clone the data of the old space as well if withData is set
   folly::Future<StatusOr<GraphSpaceID>> createSpaceAs(const std::string& oldSpaceName,
-                                                      const std::string& newSpaceName);
+                                                      const std::string& newSpaceName,
+                                                      bool withData = false);
 
   folly::Future<StatusOr<std::vector<SpaceIdName>>> listSpaces();
 
@@ -348,7 +360,8 @@ class MetaClient : public BaseMetaClient {
       std::vector<cpp2::IndexFieldDef> fields,
       bool ifNotExists = false,
       const meta::cpp2::IndexParams* indexParams = nullptr,
-      const std::string* comment = nullptr);
+      const std::string* comment = nullptr,
+      std::vector<std::string> includeFields = {});
 
   // Remove the define of tag index
   folly::Future<StatusOr<bool>> dropTagIndex(GraphSpaceID spaceId,
@@ -369,7 +382,8 @@ class MetaClient : public BaseMetaClient {
                                                    std::vector<cpp2::IndexFieldDef> fields,
                                                    bool ifNotExists = false,
                                                    const cpp2::IndexParams* indexParams = nullptr,
-                                                   const std::string* comment = nullptr);
+                                                   const std::string* comment = nullptr,
+                                                   std::vector<std::string> includeFields = {});
 
   // Remove the definition of edge index
   folly::Future<StatusOr<bool>> dropEdgeIndex(GraphSpaceID spaceId,
@@ -537,6 +551,29 @@ class MetaClient : public BaseMetaClient {
 
   PartitionID partId(int32_t numParts, VertexID id) const;
 
+  // The number of the consecutive parts from partId(numParts, id) which the vertex is split into,
+  // 1 if it's not split by ALTER SPACE
+  int32_t splitParts(GraphSpaceID spaceId, const VertexID& id) const;
+
+  // The part of the edge from src to dst, which is chosen by dst among the parts of src
+  PartitionID edgePart(GraphSpaceID spaceId,
+                       int32_t numParts,
+                       const VertexID& src,
+                       const VertexID& dst) const;
+
+  // Append the parts which may hold the edge from src to dst: the one by edgePart, and the part of
+  // src if it differs, where the edges written before src was split stay
+  void edgeParts(GraphSpaceID spaceId,
+                 int32_t numParts,
+                 const VertexID& src,
+                 const VertexID& dst,
+                 std::vector<PartitionID>* parts) const;
+
+  // The nth of the consecutive parts from the first one, wrapping around
+  static PartitionID nthPart(int32_t numParts, PartitionID first, int32_t n) {
+    return (first - 1 + n) % numParts + 1;
+  }
+
   StatusOr<std::shared_ptr<const NebulaSchemaProvider>> getTagSchemaFromCache(GraphSpaceID spaceId,
                                                                               TagID tagID,
                                                                               SchemaVer ver = -1);
@@ -597,12 +634,33 @@ class MetaClient : public BaseMetaClient {
 
   bool checkIsPlanKilled(SessionID session_id, ExecutionPlanID plan_id);
 
+  // Same as checkIsPlanKilled, but looks up the killed plans on every call
+  bool isPlanKilled(SessionID session_id, ExecutionPlanID plan_id);
+
+  // The queries on this graph killed since the last call, pushed by the heartbeats
+  KilledQueries takeKilledQueries();
+
   StatusOr<HostAddr> getStorageLeaderFromCache(GraphSpaceID spaceId, PartitionID partId);
 
   void updateStorageLeader(GraphSpaceID spaceId, PartitionID partId, const HostAddr& leader);
 
   void invalidStorageLeader(GraphSpaceID spaceId, PartitionID partId);
 
+  /**
+   * @brief Reload the leaders of all the storage hosts from metad a while later, once a storage
+   * tells its part is not led by it anymore. The calls within leader_refresh_delay_ms are served
+   * by one reload, so the other parts moved together, e.g. by a leader balance, are known before
+   * their requests fail as well.
+   */
+  void refreshLeadersSoon();
+
+  /**
+   * @brief Send an extra heartbeat to report the leaders of this storage a while later, once the
+   * leadership of some part is changed. The changes within leader_change_report_delay_ms are
+   * reported by one heartbeat.
+   */
+  void reportLeadersSoon();
+
   StatusOr<LeaderInfo> getLeaderInfo();
 
   folly::Future<StatusOr<bool>> addHosts(std::vector<HostAddr> hosts);
@@ -630,6 +688,10 @@ class MetaClient : public BaseMetaClient {
 
   folly::Future<StatusOr<cpp2::StatsItem>> getStats(GraphSpaceID spaceId);
 
+  // The stats of the space collected by the last finished stats job, only loaded by graphd when
+  // FLAGS_enable_optimizer_stats is on.
+  StatusOr<std::shared_ptr<const cpp2::StatsItem>> getStatsFromCache(GraphSpaceID spaceId);
+
   folly::Future<StatusOr<nebula::cpp2::ErrorCode>> reportTaskFinish(
       GraphSpaceID spaceId,
       int32_t jobId,
@@ -649,10 +711,20 @@ class MetaClient : public BaseMetaClient {
     return heartbeatTime_;
   }
 
+  // Changed each time the local cache is reloaded since the metad data has been updated, e.g. by
+  // the schema changes
+  int64_t localDataLastUpdateTime() const {
+    return localDataLastUpdateTime_.load();
+  }
+
   std::string getLocalIp() {
     return options_.localHost_.toString();
   }
 
+  const HostAddr& getLocalHost() const {
+    return options_.localHost_;
+  }
+
  protected:
   // Return true if load succeeded.
   bool loadData();
@@ -685,6 +757,9 @@ class MetaClient : public BaseMetaClient {
 
   bool loadSessions();
 
+  // Refresh statsCache_ asynchronously, the result is tracked by statsLoading_
+  void loadStats();
+
   void loadLeader(const std::vector<cpp2::HostItem>& hostItems,
                   const SpaceNameIdMap& spaceIndexByName);
 
@@ -709,6 +784,9 @@ class MetaClient : public BaseMetaClient {
   // part diff
   void diff(const LocalCache& oldCache, const LocalCache& newCache);
 
+  // Publish a copy of the leaders modified by the given function
+  void updateLeaders(std::function<void(LeaderInfo&)> update);
+
   void listenerDiff(const LocalCache& oldCache, const LocalCache& newCache);
 
   // add remote listener as part peers
@@ -750,9 +828,10 @@ class MetaClient : public BaseMetaClient {
   std::shared_ptr<thrift::ThriftClientManager<cpp2::MetaServiceAsyncClient>> clientsMan_;
 
   // heartbeat is a single thread, maybe leaderIdsLock_ and diskPartsLock_ is useless?
-  // leaderIdsLock_ is used to protect leaderIds_
+  // leaderIdsLock_ is used to protect leaderIds_, the leaders acked by metad
   std::unordered_map<GraphSpaceID, std::vector<cpp2::LeaderInfo>> leaderIds_;
   folly::RWSpinLock leaderIdsLock_;
+  std::atomic<uint32_t> heartbeatsSinceFullLeaders_{0};
   // diskPartsLock_ is used to protect diskParts_;
   kvstore::SpaceDiskPartsMap diskParts_;
   folly::RWSpinLock diskPartsLock_;
@@ -760,13 +839,24 @@ class MetaClient : public BaseMetaClient {
   std::atomic<int64_t> localDataLastUpdateTime_{-1};
   std::atomic<int64_t> localCfgLastUpdateTime_{-1};
   std::atomic<int64_t> metadLastUpdateTime_{0};
+  // The update times of the meta data not belonging to any space and of each space in metad,
+  // reported by the heartbeats
+  thread::ProfiledMutex updateTimesLock_{"meta_client.update_times"};
+  std::optional<int64_t> metadGlobalUpdateTime_;
+  std::unordered_map<GraphSpaceID, int64_t> metadSpaceUpdateTimes_;
+  std::mutex killedQueriesLock_;
+  KilledQueries killedQueries_;
+  // The update times of the meta data loaded, only accessed by loadData
+  std::optional<int64_t> localGlobalUpdateTime_;
+  std::unordered_map<GraphSpaceID, int64_t> localSpaceUpdateTimes_;
 
   int64_t metaServerVersion_{-1};
   static constexpr int64_t EXPECT_META_VERSION = 3;
 
-  // leadersLock_ is used to protect leadersInfo
-  folly::RWSpinLock leadersLock_;
-  LeaderInfo leadersInfo_;
+  // The leaders are read by every request to storage, so they are published as an immutable
+  // snapshot in RCU style, leadersLock_ only serializes the writers
+  thread::ProfiledMutex leadersLock_{"meta_client.leaders"};
+  std::atomic<LeaderInfo*> leadersInfo_;
 
   LocalCache localCache_;
   std::vector<HostAddr> addrs_;
@@ -835,8 +925,17 @@ class MetaClient : public BaseMetaClient {
   folly::RWSpinLock listenerLock_;
   std::atomic<ClusterID> clusterId_{0};
   bool isRunning_{false};
+  // Whether a leader refresh or an extra heartbeat is already scheduled in bgThread_
+  std::atomic_bool leaderRefreshScheduled_{false};
+  std::atomic_bool leaderReportScheduled_{false};
   bool sendHeartBeat_{false};
   std::atomic_bool ready_{false};
+  // The lock used to protect statsCache_
+  folly::RWSpinLock statsLock_;
+  std::unordered_map<GraphSpaceID, std::shared_ptr<const cpp2::StatsItem>> statsCache_;
+  int64_t statsLastLoadTime_{0};
+  // The in-flight stats refresh, only touched by the heartbeat thread and stop()
+  folly::Future<folly::Unit> statsLoading_{folly::makeFuture()};
   MetaConfigMap metaConfigMap_;
   folly::RWSpinLock configCacheLock_;
   cpp2::ConfigModule gflagsModule_{cpp2::ConfigModule::UNKNOWN};
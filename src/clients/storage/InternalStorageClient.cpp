@@ -177,5 +177,19 @@ void InternalStorageClient::chainDeleteEdges(cpp2::DeleteEdgesRequest& req,
   });
 }
 
+folly::Future<::nebula::cpp2::ErrorCode> InternalStorageClient::algoMessages(
+    const HostAddr& host, const cpp2::AlgoMessagesRequest& req, folly::EventBase* evb) {
+  HostAddr internalHost = host;
+  internalHost.port += kInternalPortOffset;
+  auto resp = getResponse(
+      evb,
+      internalHost,
+      req,
+      [](cpp2::InternalStorageServiceAsyncClient* client, const cpp2::AlgoMessagesRequest& r) {
+        return client->future_algoMessages(r);
+      });
+  return std::move(resp).thenTry([](auto&& t) { return getErrorCode(t); });
+}
+
 }  // namespace storage
 }  // namespace nebula
@@ -52,6 +52,10 @@ class InternalStorageClient
                                 folly::Promise<::nebula::cpp2::ErrorCode>&& p,
                                 folly::EventBase* evb = nullptr);
 
+  // Send the messages of a graph algorithm job to the given storage host
+  virtual folly::Future<::nebula::cpp2::ErrorCode> algoMessages(
+      const HostAddr& host, const cpp2::AlgoMessagesRequest& req, folly::EventBase* evb = nullptr);
+
  private:
   cpp2::ChainAddEdgesRequest makeChainAddReq(const cpp2::AddEdgesRequest& req,
                                              TermID termId,
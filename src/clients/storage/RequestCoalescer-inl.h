@@ -0,0 +1,324 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef CLIENTS_STORAGE_REQUESTCOALESCER_INL_H_
+#define CLIENTS_STORAGE_REQUESTCOALESCER_INL_H_
+
+#include <folly/Try.h>
+#include <folly/io/async/EventBase.h>
+#include <folly/io/async/EventBaseManager.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+namespace nebula {
+namespace storage {
+
+template <typename ClientType>
+template <typename Request, typename Response>
+folly::Future<Response> RequestCoalescer<ClientType>::submit(Batches<Request, Response>& batches,
+                                                             ClientType* client,
+                                                             const Request& req) {
+  auto* evb = folly::EventBaseManager::get()->getExistingEventBase();
+  auto shape = shapeOf(req);
+  if (evb == nullptr || !shape.has_value()) {
+    return send(client, req);
+  }
+
+  // The client is bound to the event base of this thread, so it is a part of the key as well
+  std::string key;
+  apache::thrift::CompactSerializer::serialize(*shape, &key);
+  key.append(reinterpret_cast<const char*>(&client), sizeof(client));
+
+  folly::Promise<Response> promise;
+  auto future = promise.getFuture();
+  bool first = false;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    auto& batch = batches[key];
+    first = batch.requests.empty();
+    if (first) {
+      batch.shape = std::move(shape).value();
+    }
+    batch.requests.emplace_back(req);
+    batch.promises.emplace_back(std::move(promise));
+  }
+  if (first) {
+    // The first request of a batch schedules the flush, the later ones just wait for it
+    auto flushFunc = [this, &batches, key, client]() { this->flush(batches, key, client); };
+    auto window = FLAGS_storage_client_coalesce_window_us;
+    if (window < 1000) {
+      // The timer of event base is in milliseconds, a shorter window coalesces the requests
+      // sent in the current loop
+      evb->runInLoop(std::move(flushFunc));
+    } else {
+      evb->runAfterDelay(std::move(flushFunc), window / 1000);
+    }
+  }
+  return future;
+}
+
+template <typename ClientType>
+template <typename Request, typename Response>
+void RequestCoalescer<ClientType>::flush(Batches<Request, Response>& batches,
+                                         const std::string& key,
+                                         ClientType* client) {
+  Batch<Request, Response> batch;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    auto iter = batches.find(key);
+    if (iter == batches.end()) {
+      return;
+    }
+    batch = std::move(iter->second);
+    batches.erase(iter);
+  }
+
+  if (batch.requests.size() == 1) {
+    send(client, batch.requests.front())
+        .thenTry([promise = std::move(batch.promises.front())](folly::Try<Response>&& t) mutable {
+          promise.setTry(std::move(t));
+        });
+    return;
+  }
+
+  // The vertices requested by several requests are only requested once
+  std::unordered_map<PartitionID, std::vector<Row>> parts;
+  std::unordered_set<std::string> vids;
+  for (const auto& req : batch.requests) {
+    for (const auto& part : req.get_parts()) {
+      for (const auto& row : part.second) {
+        auto vid = row.values.empty() ? std::nullopt : vidOf(row.values.front());
+        if (!vid.has_value() || vids.emplace(std::move(vid).value()).second) {
+          parts[part.first].emplace_back(row);
+        }
+      }
+    }
+  }
+  VLOG(4) << "Coalesce " << batch.requests.size() << " requests of " << vids.size()
+          << " vertices";
+
+  auto merged = std::move(batch.shape);
+  merged.parts_ref() = std::move(parts);
+  mergeCommon(merged, batch.requests);
+  send(client, merged).thenTry(
+      [requests = std::move(batch.requests), promises = std::move(batch.promises)](
+          folly::Try<Response>&& t) mutable {
+        if (t.hasException()) {
+          for (auto& promise : promises) {
+            promise.setException(t.exception());
+          }
+          return;
+        }
+        split(std::move(t).value(), requests, promises);
+      });
+}
+
+template <typename ClientType>
+template <typename Request, typename Response>
+void RequestCoalescer<ClientType>::split(Response&& merged,
+                                         const std::vector<Request>& requests,
+                                         std::vector<folly::Promise<Response>>& promises) {
+  // vid => index of the requests, once for each time it is requested
+  std::unordered_map<std::string, std::vector<size_t>> owners;
+  std::vector<std::unordered_set<PartitionID>> reqParts(requests.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    for (const auto& part : requests[i].get_parts()) {
+      reqParts[i].emplace(part.first);
+      for (const auto& row : part.second) {
+        auto vid = row.values.empty() ? std::nullopt : vidOf(row.values.front());
+        if (vid.has_value()) {
+          owners[std::move(vid).value()].emplace_back(i);
+        }
+      }
+    }
+  }
+
+  std::vector<Response> resps(requests.size());
+  const auto& result = merged.get_result();
+  for (size_t i = 0; i < requests.size(); ++i) {
+    cpp2::ResponseCommon common;
+    common.latency_in_us_ref() = result.get_latency_in_us();
+    if (result.latency_detail_us_ref().has_value()) {
+      common.latency_detail_us_ref() = *result.latency_detail_us_ref();
+    }
+    std::vector<cpp2::PartitionResult> failedParts;
+    for (const auto& part : result.get_failed_parts()) {
+      if (reqParts[i].count(part.get_part_id()) > 0) {
+        failedParts.emplace_back(part);
+      }
+    }
+    common.failed_parts_ref() = std::move(failedParts);
+    resps[i].result_ref() = std::move(common);
+  }
+
+  auto* data = dataOf(merged);
+  if (data != nullptr) {
+    std::vector<DataSet> datas(requests.size(), DataSet(data->colNames));
+    for (auto& row : data->rows) {
+      auto vid = row.values.empty() ? std::nullopt : vidOf(row.values.front());
+      if (!vid.has_value()) {
+        continue;
+      }
+      auto found = owners.find(*vid);
+      if (found == owners.end()) {
+        continue;
+      }
+      const auto& indices = found->second;
+      for (size_t j = 0; j + 1 < indices.size(); ++j) {
+        datas[indices[j]].rows.emplace_back(row);
+      }
+      datas[indices.back()].rows.emplace_back(std::move(row));
+    }
+    for (size_t i = 0; i < requests.size(); ++i) {
+      setData(resps[i], std::move(datas[i]));
+    }
+  }
+
+  for (size_t i = 0; i < promises.size(); ++i) {
+    promises[i].setValue(std::move(resps[i]));
+  }
+}
+
+template <typename ClientType>
+std::optional<cpp2::GetNeighborsRequest> RequestCoalescer<ClientType>::shapeOf(
+    const cpp2::GetNeighborsRequest& req) {
+  const auto& spec = req.get_traverse_spec();
+  // The limit with order_by and the edge budget are applied to all the vertices of a request, and
+  // the dst vertices are not split back by the srcs
+  bool ordered = spec.order_by_ref().has_value() && !spec.order_by_ref()->empty();
+  if (req.get_column_names().size() != 1 || ordered || spec.edge_budget_ref().has_value() ||
+      spec.dst_vertex_props_ref().has_value()) {
+    return std::nullopt;
+  }
+  cpp2::GetNeighborsRequest shape;
+  if (req.common_ref().has_value()) {
+    auto common = shapeOf(*req.common_ref());
+    if (!common.has_value()) {
+      return std::nullopt;
+    }
+    shape.common_ref() = std::move(common).value();
+  }
+  shape.space_id_ref() = req.get_space_id();
+  shape.column_names_ref() = req.get_column_names();
+  shape.traverse_spec_ref() = spec;
+  return shape;
+}
+
+template <typename ClientType>
+std::optional<cpp2::GetPropRequest> RequestCoalescer<ClientType>::shapeOf(
+    const cpp2::GetPropRequest& req) {
+  // Only the props of vertices are coalesced, of which the first column is always the vid
+  if (!req.vertex_props_ref().has_value() || req.edge_props_ref().has_value() ||
+      req.get_dedup()) {
+    return std::nullopt;
+  }
+  bool ordered = req.order_by_ref().has_value() && !req.order_by_ref()->empty();
+  bool limited = req.limit_ref().has_value() &&
+                 *req.limit_ref() != std::numeric_limits<int64_t>::max();
+  if (ordered || limited) {
+    return std::nullopt;
+  }
+  cpp2::GetPropRequest shape;
+  if (req.common_ref().has_value()) {
+    auto common = shapeOf(*req.common_ref());
+    if (!common.has_value()) {
+      return std::nullopt;
+    }
+    shape.common_ref() = std::move(common).value();
+  }
+  shape.space_id_ref() = req.get_space_id();
+  shape.vertex_props_ref() = *req.vertex_props_ref();
+  if (req.expressions_ref().has_value()) {
+    shape.expressions_ref() = *req.expressions_ref();
+  }
+  if (req.filter_ref().has_value()) {
+    shape.filter_ref() = *req.filter_ref();
+  }
+  return shape;
+}
+
+template <typename ClientType>
+std::optional<cpp2::RequestCommon> RequestCoalescer<ClientType>::shapeOf(
+    const cpp2::RequestCommon& common) {
+  if (common.profile_detail_ref().value_or(false)) {
+    return std::nullopt;
+  }
+  // The ids of the session and the plan and the timeout differ between the queries, they are
+  // merged when the batch is sent
+  cpp2::RequestCommon shape;
+  if (common.max_staleness_ms_ref().has_value()) {
+    shape.max_staleness_ms_ref() = *common.max_staleness_ms_ref();
+  }
+  if (common.resource_group_ref().has_value()) {
+    shape.resource_group_ref() = *common.resource_group_ref();
+  }
+  if (common.vid_filter_ref().has_value()) {
+    shape.vid_filter_ref() = *common.vid_filter_ref();
+  }
+  if (common.data_set_version_ref().has_value()) {
+    shape.data_set_version_ref() = *common.data_set_version_ref();
+  }
+  if (common.encoded_rows_ref().has_value()) {
+    shape.encoded_rows_ref() = *common.encoded_rows_ref();
+  }
+  return shape;
+}
+
+template <typename ClientType>
+template <typename Request>
+void RequestCoalescer<ClientType>::mergeCommon(Request& merged,
+                                               const std::vector<Request>& requests) {
+  std::vector<cpp2::PlanID> plans;
+  std::set<std::pair<SessionID, ExecutionPlanID>> planIds;
+  std::optional<int64_t> timeoutMs = 0;
+  const cpp2::RequestCommon none;
+  for (const auto& req : requests) {
+    // The request without the ids is never killed, nor is the merged one then
+    const auto& common = req.common_ref().has_value() ? *req.common_ref() : none;
+    auto sessionId = common.session_id_ref().value_or(0);
+    auto planId = common.plan_id_ref().value_or(0);
+    if (planIds.emplace(sessionId, planId).second) {
+      cpp2::PlanID plan;
+      plan.session_id_ref() = sessionId;
+      plan.plan_id_ref() = planId;
+      plans.emplace_back(std::move(plan));
+    }
+    // The merged request runs as long as the longest of them
+    if (!common.timeout_ms_ref().has_value()) {
+      timeoutMs.reset();
+    } else if (timeoutMs.has_value()) {
+      timeoutMs = std::max(*timeoutMs, *common.timeout_ms_ref());
+    }
+  }
+  if (!merged.common_ref().has_value()) {
+    merged.common_ref() = cpp2::RequestCommon();
+  }
+  auto& common = *merged.common_ref();
+  common.session_id_ref() = plans.front().get_session_id();
+  common.plan_id_ref() = plans.front().get_plan_id();
+  if (timeoutMs.has_value()) {
+    common.timeout_ms_ref() = *timeoutMs;
+  }
+  if (plans.size() > 1) {
+    common.coalesced_plans_ref() = std::move(plans);
+  }
+}
+
+template <typename ClientType>
+std::optional<std::string> RequestCoalescer<ClientType>::vidOf(const Value& v) {
+  if (v.isStr()) {
+    return v.getStr();
+  }
+  if (v.isInt()) {
+    // The vids of an INT64 space are returned as integers
+    auto id = v.getInt();
+    return std::string(reinterpret_cast<const char*>(&id), sizeof(id));
+  }
+  return std::nullopt;
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // CLIENTS_STORAGE_REQUESTCOALESCER_INL_H_
@@ -0,0 +1,142 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef CLIENTS_STORAGE_REQUESTCOALESCER_H_
+#define CLIENTS_STORAGE_REQUESTCOALESCER_H_
+
+#include <folly/futures/Future.h>
+
+#include "common/base/Base.h"
+#include "interface/gen-cpp2/storage_types.h"
+
+DECLARE_uint32(storage_client_coalesce_window_us);
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief Coalesce the GetNeighbors and GetProps requests of concurrent queries which are bound
+ * for the same storage host. The requests of the same shape, i.e. the same space, traverse spec
+ * or props, which arrive within storage_client_coalesce_window_us are merged into one rpc, the
+ * vertices requested by several queries are only requested once. The rows of the response are
+ * then handed back to each request by the vertex id.
+ *
+ * Only the requests whose results are independent of each vertex are coalesced, so those with
+ * order_by, a limit of the whole request or an edge budget are always sent alone. Since the
+ * clients are bound to their event bases, the requests are coalesced per IO thread.
+ */
+template <typename ClientType>
+class RequestCoalescer final {
+ public:
+  /**
+   * @brief Whether the requests should be coalesced
+   */
+  static bool enabled() {
+    return FLAGS_storage_client_coalesce_window_us > 0;
+  }
+
+  /**
+   * @brief Send the request with the others of the same shape to the same host. Must be called in
+   * the thread of the event base the client is bound to.
+   *
+   * @param client Client of the storage host
+   * @param req
+   * @return folly::Future<cpp2::GetNeighborsResponse> Rows of the vertices in the request
+   */
+  folly::Future<cpp2::GetNeighborsResponse> getNeighbors(ClientType* client,
+                                                         const cpp2::GetNeighborsRequest& req) {
+    return submit(neighbors_, client, req);
+  }
+
+  folly::Future<cpp2::GetPropResponse> getProps(ClientType* client,
+                                                const cpp2::GetPropRequest& req) {
+    return submit(props_, client, req);
+  }
+
+ private:
+  template <typename Request, typename Response>
+  struct Batch {
+    // The request carrying all the fields but parts, the ids of the query and the timeout
+    Request shape;
+    std::vector<Request> requests;
+    std::vector<folly::Promise<Response>> promises;
+  };
+
+  // client and shape of the requests => the batch
+  template <typename Request, typename Response>
+  using Batches = std::unordered_map<std::string, Batch<Request, Response>>;
+
+  template <typename Request, typename Response>
+  folly::Future<Response> submit(Batches<Request, Response>& batches,
+                                 ClientType* client,
+                                 const Request& req);
+
+  template <typename Request, typename Response>
+  void flush(Batches<Request, Response>& batches, const std::string& key, ClientType* client);
+
+  /**
+   * @brief Hand the rows of the merged response back to each request by the vid in the first
+   * column, the failed parts are returned to the requests containing them.
+   */
+  template <typename Request, typename Response>
+  static void split(Response&& merged,
+                    const std::vector<Request>& requests,
+                    std::vector<folly::Promise<Response>>& promises);
+
+  // Shape of the request, or none if it could not be coalesced
+  static std::optional<cpp2::GetNeighborsRequest> shapeOf(const cpp2::GetNeighborsRequest& req);
+
+  static std::optional<cpp2::GetPropRequest> shapeOf(const cpp2::GetPropRequest& req);
+
+  static std::optional<cpp2::RequestCommon> shapeOf(const cpp2::RequestCommon& common);
+
+  /**
+   * @brief Set the ids of the plans of all the requests to the merged one, so that it's killed
+   * only once all the queries are killed, and the longest timeout of them
+   */
+  template <typename Request>
+  static void mergeCommon(Request& merged, const std::vector<Request>& requests);
+
+  static folly::Future<cpp2::GetNeighborsResponse> send(ClientType* client,
+                                                        const cpp2::GetNeighborsRequest& req) {
+    return client->future_getNeighbors(req);
+  }
+
+  static folly::Future<cpp2::GetPropResponse> send(ClientType* client,
+                                                   const cpp2::GetPropRequest& req) {
+    return client->future_getProps(req);
+  }
+
+  static DataSet* dataOf(cpp2::GetNeighborsResponse& resp) {
+    return resp.vertices_ref().has_value() ? &*resp.vertices_ref() : nullptr;
+  }
+
+  static DataSet* dataOf(cpp2::GetPropResponse& resp) {
+    return resp.props_ref().has_value() ? &*resp.props_ref() : nullptr;
+  }
+
+  static void setData(cpp2::GetNeighborsResponse& resp, DataSet&& data) {
+    resp.vertices_ref() = std::move(data);
+  }
+
+  static void setData(cpp2::GetPropResponse& resp, DataSet&& data) {
+    resp.props_ref() = std::move(data);
+  }
+
+  // The vid in its binary form, which is the one in the requests
+  static std::optional<std::string> vidOf(const Value& v);
+
+ private:
+  std::mutex lock_;
+  Batches<cpp2::GetNeighborsRequest, cpp2::GetNeighborsResponse> neighbors_;
+  Batches<cpp2::GetPropRequest, cpp2::GetPropResponse> props_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#include "clients/storage/RequestCoalescer-inl.h"
+
+#endif  // CLIENTS_STORAGE_REQUESTCOALESCER_H_
@@ -6,6 +6,7 @@
 #include "clients/storage/StorageClient.h"
 
 #include "common/base/Base.h"
+#include "common/tracing/Tracing.h"
 
 using nebula::cpp2::PropertyType;
 using nebula::storage::cpp2::ExecResponse;
@@ -33,13 +34,38 @@ cpp2::RequestCommon StorageClient::CommonRequestParam::toReqCommon() const {
   common.session_id_ref() = session;
   common.plan_id_ref() = plan;
   common.profile_detail_ref() = profile;
+  if (maxStalenessMs > 0) {
+    common.max_staleness_ms_ref() = maxStalenessMs;
+  }
+  if (timeoutMs > 0) {
+    common.timeout_ms_ref() = timeoutMs;
+  }
+  if (!resourceGroup.empty()) {
+    common.resource_group_ref() = resourceGroup;
+  }
+  if (vidFilter != nullptr) {
+    common.vid_filter_ref() = *vidFilter;
+  }
+  common.data_set_version_ref() = DataSet::kPackedVersion;
+  if (encodedRows) {
+    common.encoded_rows_ref() = true;
+  }
+  auto trace = tracing::Span::currentContext();
+  if (trace.valid()) {
+    cpp2::TraceContext context;
+    context.trace_id_high_ref() = static_cast<int64_t>(trace.traceIdHigh);
+    context.trace_id_low_ref() = static_cast<int64_t>(trace.traceIdLow);
+    context.span_id_ref() = static_cast<int64_t>(trace.spanId);
+    context.sampled_ref() = trace.sampled;
+    common.trace_context_ref() = std::move(context);
+  }
   return common;
 }
 
 StorageRpcRespFuture<cpp2::GetNeighborsResponse> StorageClient::getNeighbors(
     const CommonRequestParam& param,
     std::vector<std::string> colNames,
-    const std::vector<Row>& vertices,
+    std::vector<Row> vertices,
     const std::vector<EdgeType>& edgeTypes,
     cpp2::EdgeDirection edgeDirection,
     const std::vector<cpp2::StatProp>* statProps,
@@ -50,60 +76,253 @@ StorageRpcRespFuture<cpp2::GetNeighborsResponse> StorageClient::getNeighbors(
     bool random,
     const std::vector<cpp2::OrderBy>& orderBy,
     int64_t limit,
-    const Expression* filter) {
+    const Expression* filter,
+    bool statsOnly,
+    int64_t edgeBudget) {
   auto cbStatus = getIdFromRow(param.space, false);
   if (!cbStatus.ok()) {
     return folly::makeFuture<StorageRpcResponse<cpp2::GetNeighborsResponse>>(
         std::runtime_error(cbStatus.status().toString()));
   }
+  auto numParts = metaClient_->partsNum(param.space);
+  if (!numParts.ok()) {
+    return folly::makeFuture<StorageRpcResponse<cpp2::GetNeighborsResponse>>(
+        std::runtime_error(folly::stringPrintf("Space not found, spaceid: %d", param.space)));
+  }
+
+  auto getId = std::move(cbStatus).value();
+  std::unordered_map<PartitionID, std::vector<Row>> parts;
+  for (auto& row : vertices) {
+    auto part = metaClient_->partId(numParts.value(), getId(row));
+    parts[part].emplace_back(std::move(row));
+  }
+  return getNeighbors(param,
+                      std::move(colNames),
+                      std::move(parts),
+                      edgeTypes,
+                      edgeDirection,
+                      statProps,
+                      vertexProps,
+                      edgeProps,
+                      expressions,
+                      dedup,
+                      random,
+                      orderBy,
+                      limit,
+                      filter,
+                      statsOnly,
+                      edgeBudget);
+}
+
+StorageRpcRespFuture<cpp2::GetNeighborsResponse> StorageClient::getNeighbors(
+    const CommonRequestParam& param,
+    std::vector<std::string> colNames,
+    std::unordered_map<PartitionID, std::vector<Row>> parts,
+    const std::vector<EdgeType>& edgeTypes,
+    cpp2::EdgeDirection edgeDirection,
+    const std::vector<cpp2::StatProp>* statProps,
+    const std::vector<cpp2::VertexProp>* vertexProps,
+    const std::vector<cpp2::EdgeProp>* edgeProps,
+    const std::vector<cpp2::Expr>* expressions,
+    bool dedup,
+    bool random,
+    const std::vector<cpp2::OrderBy>& orderBy,
+    int64_t limit,
+    const Expression* filter,
+    bool statsOnly,
+    int64_t edgeBudget,
+    ResponseHandler<cpp2::GetNeighborsResponse> onResponse) {
+  // The edges of a split vertex are spread among its parts, so it's read from all of them
+  auto numParts = metaClient_->partsNum(param.space);
+  if (!numParts.ok()) {
+    return folly::makeFuture<StorageRpcResponse<cpp2::GetNeighborsResponse>>(
+        std::runtime_error(folly::stringPrintf("Space not found, spaceid: %d", param.space)));
+  }
+  std::unordered_map<PartitionID, std::vector<Row>> mirrors;
+  for (const auto& part : parts) {
+    for (const auto& row : part.second) {
+      if (!row.values.front().isStr()) {
+        continue;
+      }
+      auto num = metaClient_->splitParts(param.space, row.values.front().getStr());
+      for (int32_t i = 1; i < num; ++i) {
+        mirrors[meta::MetaClient::nthPart(numParts.value(), part.first, i)].emplace_back(row);
+      }
+    }
+  }
+  for (auto& mirror : mirrors) {
+    auto& rows = parts[mirror.first];
+    std::move(mirror.second.begin(), mirror.second.end(), std::back_inserter(rows));
+  }
 
-  auto status = clusterIdsToHosts(param.space, vertices, std::move(cbStatus).value());
+  auto status = clusterPartsToHosts(param.space, std::move(parts), param.maxStalenessMs > 0);
   if (!status.ok()) {
     return folly::makeFuture<StorageRpcResponse<cpp2::GetNeighborsResponse>>(
         std::runtime_error(status.status().toString()));
   }
+  if (param.analytical) {
+    moveToAnalyticsReplicas(param.space, &status.value());
+  }
 
   auto& clusters = status.value();
   auto common = param.toReqCommon();
-  std::unordered_map<HostAddr, cpp2::GetNeighborsRequest> requests;
+  cpp2::TraverseSpec spec;
+  spec.edge_types_ref() = edgeTypes;
+  spec.edge_direction_ref() = edgeDirection;
+  spec.dedup_ref() = dedup;
+  spec.random_ref() = random;
+  if (statProps != nullptr) {
+    spec.stat_props_ref() = *statProps;
+  }
+  if (vertexProps != nullptr) {
+    spec.vertex_props_ref() = *vertexProps;
+  }
+  if (edgeProps != nullptr) {
+    spec.edge_props_ref() = *edgeProps;
+  }
+  if (expressions != nullptr) {
+    spec.expressions_ref() = *expressions;
+  }
+  if (!orderBy.empty()) {
+    spec.order_by_ref() = orderBy;
+  }
+  spec.limit_ref() = limit;
+  if (filter != nullptr) {
+    spec.filter_ref() = filter->encode();
+  }
+  if (statsOnly) {
+    spec.stats_only_ref() = true;
+  }
+  if (edgeBudget >= 0) {
+    spec.edge_budget_ref() = edgeBudget;
+  }
+  if (param.dstVertexProps != nullptr) {
+    spec.dst_vertex_props_ref() = *param.dstVertexProps;
+  }
+
+  std::vector<std::pair<HostAddr, cpp2::GetNeighborsRequest>> requests;
+  auto addRequest = [&](const HostAddr& host,
+                        std::unordered_map<PartitionID, std::vector<Row>> parts) {
+    cpp2::GetNeighborsRequest req;
+    req.space_id_ref() = param.space;
+    req.column_names_ref() = colNames;
+    req.parts_ref() = std::move(parts);
+    req.common_ref() = common;
+    req.traverse_spec_ref() = spec;
+    requests.emplace_back(host, std::move(req));
+  };
+
+  // The limit is applied to each request by storaged, so the vertices are not split when there
+  // is a limit, otherwise more edges would be returned.
+  size_t batchSize = FLAGS_storage_client_get_neighbors_batch_size;
+  bool split = batchSize > 0 && limit == std::numeric_limits<int64_t>::max();
+  for (auto& c : clusters) {
+    auto& host = c.first;
+    if (!split) {
+      addRequest(host, std::move(c.second));
+      continue;
+    }
+    std::unordered_map<PartitionID, std::vector<Row>> parts;
+    size_t num = 0;
+    for (auto& part : c.second) {
+      for (auto& row : part.second) {
+        parts[part.first].emplace_back(std::move(row));
+        if (++num == batchSize) {
+          addRequest(host, std::move(parts));
+          parts.clear();
+          num = 0;
+        }
+      }
+    }
+    if (num > 0) {
+      addRequest(host, std::move(parts));
+    }
+  }
+
+  return collectResponse(
+      param.evb,
+      std::move(requests),
+      [this](ThriftClientType* client, const cpp2::GetNeighborsRequest& r) {
+        if (RequestCoalescer<ThriftClientType>::enabled()) {
+          return coalescer_.getNeighbors(client, r);
+        }
+        return client->future_getNeighbors(r);
+      },
+      std::move(onResponse));
+}
+
+StorageRpcRespFuture<cpp2::KHopGetNeighborsResponse> StorageClient::getNeighborsKHop(
+    const CommonRequestParam& param,
+    std::vector<std::string> colNames,
+    const std::vector<Row>& vertices,
+    cpp2::TraverseSpec traverseSpec,
+    int32_t steps) {
+  auto cbStatus = getIdFromRow(param.space, false);
+  if (!cbStatus.ok()) {
+    return folly::makeFuture<StorageRpcResponse<cpp2::KHopGetNeighborsResponse>>(
+        std::runtime_error(cbStatus.status().toString()));
+  }
+
+  auto status = clusterIdsToPartsHosts(
+      param.space, vertices, vertexPartsOf<Row>(param.space, std::move(cbStatus).value()));
+  if (!status.ok()) {
+    return folly::makeFuture<StorageRpcResponse<cpp2::KHopGetNeighborsResponse>>(
+        std::runtime_error(status.status().toString()));
+  }
+
+  // The frontiers are expanded by the leaders, so the vertices are not sent to the followers. A
+  // split vertex is expanded in all its parts
+  auto& clusters = status.value();
+  std::unordered_map<HostAddr, cpp2::KHopGetNeighborsRequest> requests;
+  auto common = param.toReqCommon();
   for (auto& c : clusters) {
     auto& host = c.first;
     auto& req = requests[host];
     req.space_id_ref() = param.space;
     req.column_names_ref() = colNames;
     req.parts_ref() = std::move(c.second);
+    req.traverse_spec_ref() = traverseSpec;
+    req.steps_ref() = steps;
     req.common_ref() = common;
-    cpp2::TraverseSpec spec;
-    spec.edge_types_ref() = edgeTypes;
-    spec.edge_direction_ref() = edgeDirection;
-    spec.dedup_ref() = dedup;
-    spec.random_ref() = random;
-    if (statProps != nullptr) {
-      spec.stat_props_ref() = *statProps;
-    }
-    if (vertexProps != nullptr) {
-      spec.vertex_props_ref() = *vertexProps;
-    }
-    if (edgeProps != nullptr) {
-      spec.edge_props_ref() = *edgeProps;
-    }
-    if (expressions != nullptr) {
-      spec.expressions_ref() = *expressions;
-    }
-    if (!orderBy.empty()) {
-      spec.order_by_ref() = orderBy;
-    }
-    spec.limit_ref() = limit;
-    if (filter != nullptr) {
-      spec.filter_ref() = filter->encode();
-    }
-    req.traverse_spec_ref() = std::move(spec);
   }
 
   return collectResponse(param.evb,
                          std::move(requests),
-                         [](ThriftClientType* client, const cpp2::GetNeighborsRequest& r) {
-                           return client->future_getNeighbors(r);
+                         [](ThriftClientType* client, const cpp2::KHopGetNeighborsRequest& r) {
+                           return client->future_getNeighborsKHop(r);
+                         });
+}
+
+StorageRpcRespFuture<cpp2::GetDegreesResponse> StorageClient::getDegrees(
+    const CommonRequestParam& param, std::vector<Value> ids, std::vector<EdgeType> edgeTypes) {
+  auto cbStatus = getIdFromValue(param.space);
+  if (!cbStatus.ok()) {
+    return folly::makeFuture<StorageRpcResponse<cpp2::GetDegreesResponse>>(
+        std::runtime_error(cbStatus.status().toString()));
+  }
+
+  auto status = clusterIdsToHosts(param.space, std::move(ids), std::move(cbStatus).value());
+  if (!status.ok()) {
+    return folly::makeFuture<StorageRpcResponse<cpp2::GetDegreesResponse>>(
+        std::runtime_error(status.status().toString()));
+  }
+
+  auto& clusters = status.value();
+  std::unordered_map<HostAddr, cpp2::GetDegreesRequest> requests;
+  auto common = param.toReqCommon();
+  for (auto& c : clusters) {
+    auto& host = c.first;
+    auto& req = requests[host];
+    req.space_id_ref() = param.space;
+    req.parts_ref() = std::move(c.second);
+    req.edge_types_ref() = edgeTypes;
+    req.common_ref() = common;
+  }
+
+  return collectResponse(param.evb,
+                         std::move(requests),
+                         [](ThriftClientType* client, const cpp2::GetDegreesRequest& r) {
+                           return client->future_getDegrees(r);
                          });
 }
 
@@ -119,7 +338,11 @@ StorageRpcRespFuture<cpp2::ExecResponse> StorageClient::addVertices(
         std::runtime_error(cbStatus.status().toString()));
   }
 
-  auto status = clusterIdsToHosts(param.space, std::move(vertices), std::move(cbStatus).value());
+  // The tags of a split vertex are copied to all its parts
+  auto status = clusterIdsToPartsHosts(
+      param.space,
+      std::move(vertices),
+      vertexPartsOf<cpp2::NewVertex>(param.space, std::move(cbStatus).value()));
   if (!status.ok()) {
     return folly::makeFuture<StorageRpcResponse<cpp2::ExecResponse>>(
         std::runtime_error(status.status().toString()));
@@ -157,15 +380,50 @@ StorageRpcRespFuture<cpp2::ExecResponse> StorageClient::addEdges(const CommonReq
         std::runtime_error(cbStatus.status().toString()));
   }
 
-  auto status = clusterIdsToHosts(param.space, std::move(edges), std::move(cbStatus).value());
+  auto status = clusterIdsToPartsHosts(
+      param.space,
+      std::move(edges),
+      edgePartOf<cpp2::NewEdge>(
+          param.space, std::move(cbStatus).value(), [](const cpp2::NewEdge& e) -> const auto& {
+            return e.get_key().get_dst().getStr();
+          }));
   if (!status.ok()) {
     return folly::makeFuture<StorageRpcResponse<cpp2::ExecResponse>>(
         std::runtime_error(status.status().toString()));
   }
 
   auto& clusters = status.value();
-  std::unordered_map<HostAddr, cpp2::AddEdgesRequest> requests;
   auto common = param.toReqCommon();
+  // The edges of a split src written before the split stay in the part of src. When such an edge
+  // is written again into the part chosen by its dst, the old copy is removed after that, so each
+  // edge is stored in one part. IF NOT EXISTS only checks the part chosen by dst.
+  std::unordered_map<HostAddr, cpp2::DeleteEdgesRequest> stale;
+  auto numParts = metaClient_->partsNum(param.space);
+  if (!numParts.ok()) {
+    return folly::makeFuture<StorageRpcResponse<cpp2::ExecResponse>>(
+        std::runtime_error(numParts.status().toString()));
+  }
+  for (const auto& c : clusters) {
+    for (const auto& part : c.second) {
+      for (const auto& edge : part.second) {
+        auto own = metaClient_->partId(numParts.value(), edge.get_key().get_src().getStr());
+        if (own == part.first) {
+          continue;
+        }
+        auto host = getLeader(param.space, own);
+        if (!host.ok()) {
+          return folly::makeFuture<StorageRpcResponse<cpp2::ExecResponse>>(
+              std::runtime_error(host.status().toString()));
+        }
+        auto& req = stale[host.value()];
+        req.space_id_ref() = param.space;
+        req.common_ref() = common;
+        (*req.parts_ref())[own].emplace_back(edge.get_key());
+      }
+    }
+  }
+
+  std::unordered_map<HostAddr, cpp2::AddEdgesRequest> requests;
   for (auto& c : clusters) {
     auto& host = c.first;
     auto& req = requests[host];
@@ -176,13 +434,40 @@ StorageRpcRespFuture<cpp2::ExecResponse> StorageClient::addEdges(const CommonReq
     req.prop_names_ref() = propNames;
     req.common_ref() = common;
   }
-  return collectResponse(param.evb,
-                         std::move(requests),
-                         [useToss = param.useExperimentalFeature](ThriftClientType* client,
-                                                                  const cpp2::AddEdgesRequest& r) {
-                           return useToss ? client->future_chainAddEdges(r)
-                                          : client->future_addEdges(r);
-                         });
+  auto future = collectResponse(
+      param.evb,
+      std::move(requests),
+      [useToss = param.useExperimentalFeature](ThriftClientType* client,
+                                               const cpp2::AddEdgesRequest& r) {
+        return useToss ? client->future_chainAddEdges(r) : client->future_addEdges(r);
+      });
+  if (stale.empty()) {
+    return future;
+  }
+  return std::move(future).deferValue(
+      [this, evb = param.evb, stale = std::move(stale)](
+          StorageRpcResponse<cpp2::ExecResponse>&& resp) mutable
+      -> StorageRpcRespFuture<cpp2::ExecResponse> {
+        if (!resp.succeeded()) {
+          return folly::makeSemiFuture(std::move(resp));
+        }
+        // Only the old copies are removed, the reversed edges are kept even with TOSS
+        return collectResponse(evb,
+                               std::move(stale),
+                               [](ThriftClientType* client, const cpp2::DeleteEdgesRequest& r) {
+                                 return client->future_deleteEdges(r);
+                               })
+            .deferValue([resp = std::move(resp)](
+                            StorageRpcResponse<cpp2::ExecResponse>&& removed) mutable {
+              if (!removed.succeeded()) {
+                resp.markFailure();
+                for (const auto& part : removed.failedParts()) {
+                  resp.emplaceFailedPart(part.first, part.second);
+                }
+              }
+              return std::move(resp);
+            });
+      });
 }
 
 StorageRpcRespFuture<cpp2::GetPropResponse> StorageClient::getProps(
@@ -201,11 +486,35 @@ StorageRpcRespFuture<cpp2::GetPropResponse> StorageClient::getProps(
         std::runtime_error(cbStatus.status().toString()));
   }
 
-  auto status = clusterIdsToHosts(param.space, input.rows, std::move(cbStatus).value());
+  // The edges of a split vertex are in the parts chosen by their dsts, or in its own part if they
+  // were written before the split, so they are read from both, and the empty rows returned for
+  // the edges not found are dropped. The tags of a split vertex are in all its parts, so the first
+  // one is read.
+  bool readTwice = false;
+  auto edgeParts =
+      edgePartsOf<Row>(param.space, cbStatus.value(), [](const Row& r) -> const auto& {
+        return r.values[3].getStr();
+      });
+  auto status =
+      edgeProps != nullptr
+          ? clusterIdsToPartsHosts(
+                param.space,
+                input.rows,
+                [&readTwice, &edgeParts](
+                    int32_t numParts, const Row& r, std::vector<PartitionID>* parts) {
+                  edgeParts(numParts, r, parts);
+                  readTwice |= parts->size() > 1;
+                },
+                param.maxStalenessMs > 0)
+          : clusterIdsToHosts(
+                param.space, input.rows, std::move(cbStatus).value(), param.maxStalenessMs > 0);
   if (!status.ok()) {
     return folly::makeFuture<StorageRpcResponse<cpp2::GetPropResponse>>(
         std::runtime_error(status.status().toString()));
   }
+  if (param.analytical) {
+    moveToAnalyticsReplicas(param.space, &status.value());
+  }
 
   auto& clusters = status.value();
   std::unordered_map<HostAddr, cpp2::GetPropRequest> requests;
@@ -235,10 +544,37 @@ StorageRpcRespFuture<cpp2::GetPropResponse> StorageClient::getProps(
     req.common_ref() = common;
   }
 
-  return collectResponse(
-      param.evb, std::move(requests), [](ThriftClientType* client, const cpp2::GetPropRequest& r) {
+  auto future = collectResponse(
+      param.evb,
+      std::move(requests),
+      [this](ThriftClientType* client, const cpp2::GetPropRequest& r) {
+        if (RequestCoalescer<ThriftClientType>::enabled()) {
+          return coalescer_.getProps(client, r);
+        }
         return client->future_getProps(r);
       });
+  if (!readTwice) {
+    return future;
+  }
+  return std::move(future).deferValue([](StorageRpcResponse<cpp2::GetPropResponse>&& resp) {
+    for (auto& r : resp.responses()) {
+      auto props = r.props_ref();
+      if (!props.has_value()) {
+        continue;
+      }
+      auto& rows = props->rows;
+      rows.erase(std::remove_if(rows.begin(),
+                                rows.end(),
+                                [](const Row& row) {
+                                  return !row.values.empty() &&
+                                         std::all_of(row.values.begin(),
+                                                     row.values.end(),
+                                                     [](const Value& v) { return v.empty(); });
+                                }),
+                 rows.end());
+    }
+    return std::move(resp);
+  });
 }
 
 StorageRpcRespFuture<cpp2::ExecResponse> StorageClient::deleteEdges(
@@ -249,7 +585,15 @@ StorageRpcRespFuture<cpp2::ExecResponse> StorageClient::deleteEdges(
         std::runtime_error(cbStatus.status().toString()));
   }
 
-  auto status = clusterIdsToHosts(param.space, std::move(edges), std::move(cbStatus).value());
+  // The edge of a split src is removed from its own part as well, which holds the edges written
+  // before the split
+  auto status = clusterIdsToPartsHosts(
+      param.space,
+      std::move(edges),
+      edgePartsOf<cpp2::EdgeKey>(
+          param.space, std::move(cbStatus).value(), [](const cpp2::EdgeKey& k) -> const auto& {
+            return k.get_dst().getStr();
+          }));
   if (!status.ok()) {
     return folly::makeFuture<StorageRpcResponse<cpp2::ExecResponse>>(
         std::runtime_error(status.status().toString()));
@@ -283,7 +627,8 @@ StorageRpcRespFuture<cpp2::ExecResponse> StorageClient::deleteVertices(
         std::runtime_error(cbStatus.status().toString()));
   }
 
-  auto status = clusterIdsToHosts(param.space, std::move(ids), std::move(cbStatus).value());
+  auto status = clusterIdsToPartsHosts(
+      param.space, std::move(ids), vertexPartsOf<Value>(param.space, std::move(cbStatus).value()));
   if (!status.ok()) {
     return folly::makeFuture<StorageRpcResponse<cpp2::ExecResponse>>(
         std::runtime_error(status.status().toString()));
@@ -315,7 +660,10 @@ StorageRpcRespFuture<cpp2::ExecResponse> StorageClient::deleteTags(
         std::runtime_error(cbStatus.status().toString()));
   }
 
-  auto status = clusterIdsToHosts(param.space, std::move(delTags), std::move(cbStatus).value());
+  auto status = clusterIdsToPartsHosts(
+      param.space,
+      std::move(delTags),
+      vertexPartsOf<cpp2::DelTags>(param.space, std::move(cbStatus).value()));
   if (!status.ok()) {
     return folly::makeFuture<StorageRpcResponse<cpp2::ExecResponse>>(
         std::runtime_error(status.status().toString()));
@@ -358,7 +706,9 @@ folly::Future<StatusOr<storage::cpp2::UpdateResponse>> StorageClient::updateVert
     return Status::Error("Space not found, spaceid: %d", param.space);
   }
   auto numParts = status.value();
-  status = metaClient_->partId(numParts, std::move(cbStatus).value()(vertexId));
+  const auto& vid = std::move(cbStatus).value()(vertexId);
+  auto num = metaClient_->splitParts(param.space, vid);
+  status = metaClient_->partId(numParts, vid);
   if (!status.ok()) {
     return folly::makeFuture<StatusOr<storage::cpp2::UpdateResponse>>(status.status());
   }
@@ -381,12 +731,51 @@ folly::Future<StatusOr<storage::cpp2::UpdateResponse>> StorageClient::updateVert
     req.condition_ref() = std::move(condition);
   }
 
-  return getResponse(param.evb,
-                     host.value(),
-                     req,
-                     [](ThriftClientType* client, const cpp2::UpdateVertexRequest& r) {
-                       return client->future_updateVertex(r);
-                     });
+  auto remote = [](ThriftClientType* client, const cpp2::UpdateVertexRequest& r) {
+    return client->future_updateVertex(r);
+  };
+  auto future = getResponse(param.evb, host.value(), req, remote);
+  if (num <= 1) {
+    return future;
+  }
+  // The tags of a split vertex are copied to all its parts. The first part is updated at first
+  // to check the condition, then the others are updated by the same request.
+  return std::move(future).thenValue(
+      [this, evb = param.evb, req = std::move(req), remote, numParts, num](
+          StatusOr<storage::cpp2::UpdateResponse>&& resp) mutable
+      -> folly::SemiFuture<StatusOr<storage::cpp2::UpdateResponse>> {
+        if (!resp.ok() || !resp.value().get_result().get_failed_parts().empty()) {
+          return folly::makeSemiFuture(std::move(resp));
+        }
+        std::vector<folly::Future<StatusOr<storage::cpp2::UpdateResponse>>> futures;
+        for (int32_t i = 1; i < num; ++i) {
+          auto part = meta::MetaClient::nthPart(numParts, req.get_part_id(), i);
+          auto mirrorHost = this->getLeader(req.get_space_id(), part);
+          if (!mirrorHost.ok()) {
+            return folly::makeSemiFuture<StatusOr<storage::cpp2::UpdateResponse>>(
+                mirrorHost.status());
+          }
+          req.part_id_ref() = part;
+          futures.emplace_back(getResponse(evb, mirrorHost.value(), req, remote));
+        }
+        return folly::collectAll(futures).deferValue(
+            [resp = std::move(resp)](
+                std::vector<folly::Try<StatusOr<storage::cpp2::UpdateResponse>>>&& tries) mutable
+            -> StatusOr<storage::cpp2::UpdateResponse> {
+              for (auto& t : tries) {
+                if (t.hasException()) {
+                  return Status::Error("%s", t.exception().what().c_str());
+                }
+                if (!t.value().ok()) {
+                  return t.value().status();
+                }
+                if (!t.value().value().get_result().get_failed_parts().empty()) {
+                  return std::move(t).value();
+                }
+              }
+              return std::move(resp);
+            });
+      });
 }
 
 folly::Future<StatusOr<storage::cpp2::UpdateResponse>> StorageClient::updateEdge(
@@ -408,12 +797,11 @@ folly::Future<StatusOr<storage::cpp2::UpdateResponse>> StorageClient::updateEdge
     return Status::Error("Space not found, spaceid: %d", space);
   }
   auto numParts = status.value();
-  status = metaClient_->partId(numParts, std::move(cbStatus).value()(edgeKey));
-  if (!status.ok()) {
-    return folly::makeFuture<StatusOr<storage::cpp2::UpdateResponse>>(status.status());
-  }
+  const auto& src = std::move(cbStatus).value()(edgeKey);
+  std::vector<PartitionID> parts;
+  metaClient_->edgeParts(space, numParts, src, edgeKey.get_dst().getStr(), &parts);
 
-  auto part = status.value();
+  auto part = parts.front();
   auto host = this->getLeader(space, part);
   if (!host.ok()) {
     return folly::makeFuture<StatusOr<storage::cpp2::UpdateResponse>>(host.status());
@@ -430,14 +818,38 @@ folly::Future<StatusOr<storage::cpp2::UpdateResponse>> StorageClient::updateEdge
     req.condition_ref() = std::move(condition);
   }
 
-  return getResponse(param.evb,
-                     host.value(),
-                     req,
-                     [useExperimentalFeature = param.useExperimentalFeature](
-                         ThriftClientType* client, const cpp2::UpdateEdgeRequest& r) {
-                       return useExperimentalFeature ? client->future_chainUpdateEdge(r)
-                                                     : client->future_updateEdge(r);
-                     });
+  auto remote = [useExperimentalFeature = param.useExperimentalFeature](
+                    ThriftClientType* client, const cpp2::UpdateEdgeRequest& r) {
+    return useExperimentalFeature ? client->future_chainUpdateEdge(r)
+                                  : client->future_updateEdge(r);
+  };
+  if (parts.size() == 1) {
+    return getResponse(param.evb, host.value(), req, remote);
+  }
+  // The edge of a split src written before the split is updated in the own part of src if it's
+  // there, otherwise in the part chosen by dst, where it's inserted if insertable
+  auto own = parts.back();
+  auto ownHost = this->getLeader(space, own);
+  if (!ownHost.ok()) {
+    return folly::makeFuture<StatusOr<storage::cpp2::UpdateResponse>>(ownHost.status());
+  }
+  auto ownReq = req;
+  ownReq.part_id_ref() = own;
+  ownReq.insertable_ref() = false;
+  return getResponse(param.evb, ownHost.value(), ownReq, remote)
+      .thenValue([this, evb = param.evb, host = host.value(), req = std::move(req), remote](
+                     StatusOr<storage::cpp2::UpdateResponse>&& resp) mutable
+                 -> folly::Future<StatusOr<storage::cpp2::UpdateResponse>> {
+        if (!resp.ok()) {
+          return folly::makeFuture(std::move(resp));
+        }
+        const auto& failed = resp.value().get_result().get_failed_parts();
+        if (failed.size() != 1 ||
+            failed.front().get_code() != nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
+          return folly::makeFuture(std::move(resp));
+        }
+        return getResponse(evb, host, req, remote);
+      });
 }
 
 folly::Future<StatusOr<cpp2::GetUUIDResp>> StorageClient::getUUID(GraphSpaceID space,
@@ -477,7 +889,8 @@ StorageRpcRespFuture<cpp2::LookupIndexResp> StorageClient::lookupIndex(
     int32_t tagOrEdge,
     const std::vector<std::string>& returnCols,
     std::vector<storage::cpp2::OrderBy> orderBy,
-    int64_t limit) {
+    int64_t limit,
+    bool intersect) {
   // TODO(sky) : instead of isEdge and tagOrEdge to nebula::cpp2::SchemaID for graph layer.
   auto space = param.space;
   auto status = getHostParts(space);
@@ -505,6 +918,7 @@ StorageRpcRespFuture<cpp2::LookupIndexResp> StorageClient::lookupIndex(
     cpp2::IndexSpec spec;
     spec.contexts_ref() = contexts;
     spec.schema_id_ref() = schemaId;
+    spec.intersect_ref() = intersect;
     req.indices_ref() = spec;
     req.common_ref() = common;
     req.limit_ref() = limit;
@@ -551,7 +965,8 @@ StorageRpcRespFuture<cpp2::ScanResponse> StorageClient::scanEdge(
     const CommonRequestParam& param,
     const std::vector<cpp2::EdgeProp>& edgeProp,
     int64_t limit,
-    const Expression* filter) {
+    const Expression* filter,
+    const std::vector<cpp2::OrderBy>& orderBy) {
   std::unordered_map<HostAddr, cpp2::ScanEdgeRequest> requests;
   auto status = getHostPartsWithCursor(param.space);
   if (!status.ok()) {
@@ -569,6 +984,9 @@ StorageRpcRespFuture<cpp2::ScanResponse> StorageClient::scanEdge(
     if (filter != nullptr) {
       req.filter_ref() = filter->encode();
     }
+    if (!orderBy.empty()) {
+      req.order_by_ref() = orderBy;
+    }
     req.common_ref() = param.toReqCommon();
   }
 
@@ -636,6 +1054,42 @@ folly::SemiFuture<StorageRpcResponse<cpp2::KVGetResponse>> StorageClient::get(
       });
 }
 
+void StorageClient::killPlan(GraphSpaceID space, SessionID session, ExecutionPlanID plan) {
+  DCHECK(!!metaClient_);
+  auto numParts = metaClient_->partsNum(space);
+  if (!numParts.ok()) {
+    LOG(WARNING) << "Failed to kill plan " << plan << " in storage: " << numParts.status();
+    return;
+  }
+  // The reads may be served by the followers, so all the replicas are told
+  std::unordered_set<HostAddr> hosts;
+  for (PartitionID part = 1; part <= numParts.value(); ++part) {
+    auto partHosts = getPartHosts(space, part);
+    if (partHosts.ok()) {
+      hosts.insert(partHosts.value().hosts_.begin(), partHosts.value().hosts_.end());
+    }
+  }
+
+  cpp2::KillPlanRequest req;
+  req.space_id_ref() = space;
+  req.session_id_ref() = session;
+  req.plan_id_ref() = plan;
+  for (const auto& host : hosts) {
+    getResponse(nullptr,
+                host,
+                req,
+                [](ThriftClientType* client, const cpp2::KillPlanRequest& r) {
+                  return client->future_killPlan(r);
+                })
+        .thenValue([host, plan](auto&& resp) {
+          if (!resp.ok()) {
+            LOG(WARNING) << "Failed to kill plan " << plan << " in " << host << ": "
+                         << resp.status();
+          }
+        });
+  }
+}
+
 folly::SemiFuture<StorageRpcResponse<cpp2::ExecResponse>> StorageClient::put(
     GraphSpaceID space, std::vector<KeyValue> kvs, folly::EventBase* evb) {
   auto status = clusterIdsToHosts(
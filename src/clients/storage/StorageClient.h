@@ -6,6 +6,7 @@
 #ifndef CLIENTS_STORAGE_STORAGECLIENT_H
 #define CLIENTS_STORAGE_STORAGECLIENT_H
 
+#include "clients/storage/RequestCoalescer.h"
 #include "clients/storage/StorageClientBase.h"
 #include "common/base/Base.h"
 #include "common/thrift/ThriftClientManager.h"
@@ -46,6 +47,21 @@ class StorageClient
     bool profile{false};
     bool useExperimentalFeature{false};
     folly::EventBase* evb{nullptr};
+    // The reads could be served by the followers at most maxStalenessMs behind, 0 means leader only
+    int64_t maxStalenessMs{0};
+    // The reads are served by the ANALYTICS listeners of the parts having one
+    bool analytical{false};
+    // The time left of the query, the storage gives up the request after it. 0 means no limit
+    int64_t timeoutMs{0};
+    // The resource group of storaged to run the read, empty means the group of the space
+    std::string resourceGroup;
+    // Only the vertices, or the edges whose dst, in the filter are read if it's set
+    std::shared_ptr<const cpp2::VidFilter> vidFilter;
+    // The props of the dsts read by GetNeighbors along with the edges, from the parts led by the
+    // same hosts as the srcs
+    const std::vector<cpp2::VertexProp>* dstVertexProps{nullptr};
+    // The tag props of GetNeighbors are returned as the encoded rows, to be decoded on reading
+    bool encodedRows{false};
 
     CommonRequestParam(GraphSpaceID space_,
                        SessionID sess,
@@ -66,8 +82,8 @@ class StorageClient
   StorageRpcRespFuture<cpp2::GetNeighborsResponse> getNeighbors(
       const CommonRequestParam& param,
       std::vector<std::string> colNames,
-      // The first column has to be the VertexID
-      const std::vector<Row>& vertices,
+      // The first column has to be the VertexID, the rows are moved into the requests
+      std::vector<Row> vertices,
       const std::vector<EdgeType>& edgeTypes,
       cpp2::EdgeDirection edgeDirection,
       const std::vector<cpp2::StatProp>* statProps,
@@ -78,7 +94,46 @@ class StorageClient
       bool random = false,
       const std::vector<cpp2::OrderBy>& orderBy = std::vector<cpp2::OrderBy>(),
       int64_t limit = std::numeric_limits<int64_t>::max(),
-      const Expression* filter = nullptr);
+      const Expression* filter = nullptr,
+      bool statsOnly = false,
+      int64_t edgeBudget = -1);
+
+  // Same as above, but with the vertices already grouped by their parts, and each response is
+  // passed to onResponse as soon as it arrives if it's given
+  StorageRpcRespFuture<cpp2::GetNeighborsResponse> getNeighbors(
+      const CommonRequestParam& param,
+      std::vector<std::string> colNames,
+      std::unordered_map<PartitionID, std::vector<Row>> parts,
+      const std::vector<EdgeType>& edgeTypes,
+      cpp2::EdgeDirection edgeDirection,
+      const std::vector<cpp2::StatProp>* statProps,
+      const std::vector<cpp2::VertexProp>* vertexProps,
+      const std::vector<cpp2::EdgeProp>* edgeProps,
+      const std::vector<cpp2::Expr>* expressions,
+      bool dedup = false,
+      bool random = false,
+      const std::vector<cpp2::OrderBy>& orderBy = std::vector<cpp2::OrderBy>(),
+      int64_t limit = std::numeric_limits<int64_t>::max(),
+      const Expression* filter = nullptr,
+      bool statsOnly = false,
+      int64_t edgeBudget = -1,
+      ResponseHandler<cpp2::GetNeighborsResponse> onResponse = nullptr);
+
+  // Expand the vertices by the given steps inside storaged, the frontiers of the intermediate
+  // steps which are not led by the hosts expanding them are returned as pending vertices
+  StorageRpcRespFuture<cpp2::KHopGetNeighborsResponse> getNeighborsKHop(
+      const CommonRequestParam& param,
+      std::vector<std::string> colNames,
+      // The first column has to be the VertexID
+      const std::vector<Row>& vertices,
+      cpp2::TraverseSpec traverseSpec,
+      int32_t steps);
+
+  // Read the counted degrees of the vertices by the given edge types, or by all the edge types in
+  // both directions if none is given
+  StorageRpcRespFuture<cpp2::GetDegreesResponse> getDegrees(const CommonRequestParam& param,
+                                                            std::vector<Value> ids,
+                                                            std::vector<EdgeType> edgeTypes);
 
   StorageRpcRespFuture<cpp2::GetPropResponse> getProps(
       const CommonRequestParam& param,
@@ -141,7 +196,8 @@ class StorageClient
       int32_t tagOrEdge,
       const std::vector<std::string>& returnCols,
       std::vector<storage::cpp2::OrderBy> orderBy,
-      int64_t limit);
+      int64_t limit,
+      bool intersect = false);
 
   StorageRpcRespFuture<cpp2::GetNeighborsResponse> lookupAndTraverse(
       const CommonRequestParam& param, cpp2::IndexSpec indexSpec, cpp2::TraverseSpec traverseSpec);
@@ -149,7 +205,9 @@ class StorageClient
   StorageRpcRespFuture<cpp2::ScanResponse> scanEdge(const CommonRequestParam& param,
                                                     const std::vector<cpp2::EdgeProp>& vertexProp,
                                                     int64_t limit,
-                                                    const Expression* filter);
+                                                    const Expression* filter,
+                                                    const std::vector<cpp2::OrderBy>& orderBy =
+                                                        std::vector<cpp2::OrderBy>());
 
   StorageRpcRespFuture<cpp2::ScanResponse> scanVertex(
       const CommonRequestParam& param,
@@ -157,6 +215,10 @@ class StorageClient
       int64_t limit,
       const Expression* filter);
 
+  // Tell all the storage hosts of the space to give up the requests of the killed plan, without
+  // waiting for the responses, the failures are only logged
+  void killPlan(GraphSpaceID space, SessionID session, ExecutionPlanID plan);
+
   folly::SemiFuture<StorageRpcResponse<cpp2::KVGetResponse>> get(GraphSpaceID space,
                                                                  std::vector<std::string>&& keys,
                                                                  bool returnPartly = false,
@@ -171,6 +233,47 @@ class StorageClient
                                                                    folly::EventBase* evb = nullptr);
 
  private:
+  // The parts of the vertex given by getId for clusterIdsToPartsHosts, all the parts of a split
+  // vertex
+  template <class T>
+  auto vertexPartsOf(GraphSpaceID space, std::function<const VertexID&(const T&)> getId) const {
+    return [this, space, getId = std::move(getId)](
+               int32_t numParts, const T& id, std::vector<PartitionID>* parts) {
+      const auto& vid = getId(id);
+      auto first = metaClient_->partId(numParts, vid);
+      auto num = metaClient_->splitParts(space, vid);
+      for (int32_t i = 0; i < num; ++i) {
+        parts->emplace_back(meta::MetaClient::nthPart(numParts, first, i));
+      }
+    };
+  }
+
+  // The part to write the edge for clusterIdsToPartsHosts, getSrc has to be called before getDst
+  // as it converts both the ends of an INT64 space to their binary form
+  template <class T, class GetDst>
+  auto edgePartOf(GraphSpaceID space,
+                  std::function<const VertexID&(const T&)> getSrc,
+                  GetDst getDst) const {
+    return [this, space, getSrc = std::move(getSrc), getDst](
+               int32_t numParts, const T& id, std::vector<PartitionID>* parts) {
+      const auto& src = getSrc(id);
+      parts->emplace_back(metaClient_->edgePart(space, numParts, src, getDst(id)));
+    };
+  }
+
+  // The parts to read or delete the edge for clusterIdsToPartsHosts, which include the part of a
+  // split src holding the edges written before the split
+  template <class T, class GetDst>
+  auto edgePartsOf(GraphSpaceID space,
+                   std::function<const VertexID&(const T&)> getSrc,
+                   GetDst getDst) const {
+    return [this, space, getSrc = std::move(getSrc), getDst](
+               int32_t numParts, const T& id, std::vector<PartitionID>* parts) {
+      const auto& src = getSrc(id);
+      metaClient_->edgeParts(space, numParts, src, getDst(id), parts);
+    };
+  }
+
   StatusOr<std::function<const VertexID&(const Row&)>> getIdFromRow(GraphSpaceID space,
                                                                     bool isEdgeProps) const;
 
@@ -187,6 +290,9 @@ class StorageClient
 
   StatusOr<std::function<const VertexID&(const cpp2::DelTags&)>> getIdFromDelTags(
       GraphSpaceID space) const;
+
+ private:
+  RequestCoalescer<ThriftClientType> coalescer_;
 };
 
 }  // namespace storage
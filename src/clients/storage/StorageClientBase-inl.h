@@ -7,8 +7,10 @@
 #define CLIENTS_STORAGE_STORAGECLIENTBASE_INL_H
 
 #include <folly/ExceptionWrapper.h>
+#include <folly/Random.h>
 #include <folly/Try.h>
 #include <folly/futures/Future.h>
+#include <thrift/lib/cpp2/protocol/CompactProtocol.h>
 
 #include <optional>
 #include <unordered_map>
@@ -30,7 +32,14 @@ template <typename ClientType, typename ClientManagerType>
 StorageClientBase<ClientType, ClientManagerType>::StorageClientBase(
     std::shared_ptr<folly::IOThreadPoolExecutor> threadPool, meta::MetaClient* metaClient)
     : metaClient_(metaClient), ioThreadPool_(threadPool) {
-  clientsMan_ = std::make_unique<ClientManagerType>(FLAGS_enable_ssl);
+  auto options = thrift::ChannelOptions::make(FLAGS_storage_client_protocol,
+                                              FLAGS_storage_client_compression,
+                                              FLAGS_storage_client_compression_size_limit);
+  if (!options.ok()) {
+    LOG(WARNING) << options.status() << ", use the default channel options of storage clients";
+    options = thrift::ChannelOptions();
+  }
+  clientsMan_ = std::make_unique<ClientManagerType>(FLAGS_enable_ssl, std::move(options).value());
 }
 
 template <typename ClientType, typename ClientManagerType>
@@ -75,34 +84,76 @@ StorageClientBase<ClientType, ClientManagerType>::collectResponse(
     folly::EventBase* evb,
     std::unordered_map<HostAddr, Request> requests,
     RemoteFunc&& remoteFunc) {
-  std::vector<folly::Future<StatusOr<Response>>> respFutures;
-  respFutures.reserve(requests.size());
+  std::vector<std::pair<HostAddr, Request>> reqs;
+  reqs.reserve(requests.size());
+  for (auto& req : requests) {
+    reqs.emplace_back(req.first, std::move(req.second));
+  }
+  return collectResponse(evb, std::move(reqs), std::forward<RemoteFunc>(remoteFunc));
+}
 
-  auto hosts = std::make_shared<std::vector<HostAddr>>(requests.size());
-  auto totalLatencies = std::make_shared<std::vector<int32_t>>(requests.size());
+template <typename ClientType, typename ClientManagerType>
+template <class Request, class RemoteFunc, class Response>
+folly::SemiFuture<StorageRpcResponse<Response>>
+StorageClientBase<ClientType, ClientManagerType>::collectResponse(
+    folly::EventBase* evb,
+    std::vector<std::pair<HostAddr, Request>> requests,
+    RemoteFunc&& remoteFunc,
+    ResponseHandler<Response> onResponse) {
+  // The responses of the hosts are joined by a counter shared by them, and the latency and size of
+  // each is taken when it's joined, rather than by a continuation of its own and collectAll
+  struct Join {
+    explicit Join(size_t num) : pending(num), resps(num), latencies(num), bytes(num) {}
+
+    std::atomic<size_t> pending;
+    std::vector<folly::Try<StatusOr<Response>>> resps;
+    std::vector<int32_t> latencies;
+    std::vector<size_t> bytes;
+    folly::Promise<std::vector<folly::Try<StatusOr<Response>>>> promise;
+  };
+  auto join = std::make_shared<Join>(requests.size());
+  auto future = join->promise.getSemiFuture();
+  if (requests.empty()) {
+    join->promise.setValue(std::move(join->resps));
+  }
 
-  for (const auto& req : requests) {
+  for (size_t i = 0; i < requests.size(); i++) {
     auto start = time::WallClock::fastNowInMicroSec();
-
-    size_t i = respFutures.size();
-    (*hosts)[i] = req.first;
     // Future process code will be executed on the IO thread
     // Since all requests are sent using the same eventbase, all
     // then-callback will be executed on the same IO thread
-    auto fut = getResponse(evb, req.first, req.second, std::move(remoteFunc))
-                   .ensure([totalLatencies, i, start]() {
-                     (*totalLatencies)[i] = time::WallClock::fastNowInMicroSec() - start;
-                   });
-
-    respFutures.emplace_back(std::move(fut));
+    hedgedResponse(evb, requests[i].first, requests[i].second, remoteFunc)
+        .thenTry([join, i, start, onResponse](folly::Try<StatusOr<Response>>&& resp) {
+          join->latencies[i] = time::WallClock::fastNowInMicroSec() - start;
+          if (resp.hasValue() && resp.value().ok()) {
+            // The size is taken before the handler takes the data out
+            auto& value = resp.value().value();
+            apache::thrift::CompactProtocolWriter writer;
+            join->bytes[i] = value.serializedSize(&writer);
+            if (onResponse) {
+              onResponse(value);
+            }
+          }
+          join->resps[i] = std::move(resp);
+          if (join->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            join->promise.setValue(std::move(join->resps));
+          }
+        });
   }
 
-  return folly::collectAll(respFutures)
-      .deferValue([this, requests = std::move(requests), totalLatencies, hosts](
-                      std::vector<folly::Try<StatusOr<Response>>>&& resps) {
+  return std::move(future)
+      .deferValue([this,
+                   evb,
+                   remoteFunc = std::forward<RemoteFunc>(remoteFunc),
+                   requests = std::move(requests),
+                   onResponse = std::move(onResponse),
+                   join](std::vector<folly::Try<StatusOr<Response>>>&& resps) mutable
+                  -> folly::SemiFuture<StorageRpcResponse<Response>> {
         StorageRpcResponse<Response> rpcResp(resps.size());
+        // The parts failed by the followers too far behind, which are retried on the leaders
+        std::vector<std::pair<HostAddr, Request>> retries;
         for (size_t i = 0; i < resps.size(); i++) {
-          auto& host = hosts->at(i);
+          const auto& host = requests[i].first;
           auto& tryResp = resps[i];
           std::optional<std::string> errMsg;
           if (tryResp.hasException()) {
@@ -113,16 +164,35 @@ StorageClientBase<ClientType, ClientManagerType>::collectResponse(
               auto resp = std::move(status).value();
               auto result = resp.get_result();
 
-              if (!result.get_failed_parts().empty()) {
+              bool failed = false;
+              std::unordered_map<HostAddr, std::vector<PartitionID>> retryParts;
+              auto spaceId = requests[i].second.get_space_id();
+              for (auto& part : result.get_failed_parts()) {
+                if (part.get_code() == nebula::cpp2::ErrorCode::E_LEADER_CHANGED &&
+                    servedByFollowers(requests[i].second)) {
+                  auto leader = getLeader(spaceId, part.get_part_id());
+                  if (leader.ok()) {
+                    retryParts[leader.value()].emplace_back(part.get_part_id());
+                    continue;
+                  }
+                }
+                failed = true;
+                rpcResp.emplaceFailedPart(part.get_part_id(), part.get_code());
+              }
+              if (failed) {
                 rpcResp.markFailure();
-                for (auto& part : result.get_failed_parts()) {
-                  rpcResp.emplaceFailedPart(part.get_part_id(), part.get_code());
+              }
+              for (auto& leaderParts : retryParts) {
+                auto retry = takeLeaderRequest(requests[i].second, leaderParts.second);
+                if (retry.has_value()) {
+                  retries.emplace_back(leaderParts.first, std::move(retry).value());
                 }
               }
 
               // Adjust the latency
               auto latency = result.get_latency_in_us();
-              rpcResp.setLatency(host, latency, totalLatencies->at(i));
+              rpcResp.setLatency(host, latency, join->latencies[i]);
+              rpcResp.addResponseBytes(join->bytes[i]);
               // Keep the response
               rpcResp.addResponse(std::move(resp));
             } else {
@@ -133,13 +203,35 @@ StorageClientBase<ClientType, ClientManagerType>::collectResponse(
           if (errMsg) {
             rpcResp.markFailure();
             LOG(ERROR) << "There some RPC errors: " << errMsg.value();
-            auto req = requests.at(host);
-            auto parts = getReqPartsId(req);
+            auto parts = getReqPartsId(requests[i].second);
             rpcResp.appendFailedParts(parts, nebula::cpp2::ErrorCode::E_RPC_FAILURE);
           }
         }
 
-        return rpcResp;
+        if (retries.empty()) {
+          return folly::makeSemiFuture(std::move(rpcResp));
+        }
+        VLOG(2) << "Retry the reads of " << retries.size() << " requests on the leaders";
+        return collectResponse(
+                   evb, std::move(retries), std::move(remoteFunc), std::move(onResponse))
+            .deferValue([rpcResp = std::move(rpcResp)](
+                            StorageRpcResponse<Response>&& retried) mutable {
+              if (!retried.succeeded()) {
+                rpcResp.markFailure();
+              }
+              for (const auto& part : retried.failedParts()) {
+                rpcResp.emplaceFailedPart(part.first, part.second);
+              }
+              for (const auto& latency : retried.hostLatency()) {
+                rpcResp.setLatency(
+                    std::get<0>(latency), std::get<1>(latency), std::get<2>(latency));
+              }
+              rpcResp.addResponseBytes(retried.responseBytes());
+              for (auto& resp : retried.responses()) {
+                rpcResp.addResponse(std::move(resp));
+              }
+              return std::move(rpcResp);
+            });
       });
 }
 
@@ -156,14 +248,28 @@ folly::Future<StatusOr<Response>> StorageClientBase<ClientType, ClientManagerTyp
   }
 
   auto spaceId = request.get_space_id();
-  return folly::via(evb)
+  // Wait until the host has less rpc than the limit in flight
+  return clientsMan_->hostLoad()
+      .acquire(host)
+      .via(evb)
       .thenValue([remoteFunc = std::move(remoteFunc), request, evb, host, this](auto&&) {
-        // NOTE: Create new channel on each thread to avoid TIMEOUT RPC error
-        auto client = clientsMan_->client(host, evb, false, FLAGS_storage_client_timeout_ms);
-        return remoteFunc(client.get(), request);
+        auto start = time::WallClock::fastNowInMicroSec();
+        onRpcSent(host);
+        return folly::makeFutureWith([&]() {
+                 // NOTE: Create new channel on each thread to avoid TIMEOUT RPC error
+                 auto client =
+                     clientsMan_->client(host, evb, false, FLAGS_storage_client_timeout_ms);
+                 return remoteFunc(client.get(), request);
+               })
+            .ensure([host, start, this]() {
+              onRpcDone(host, time::WallClock::fastNowInMicroSec() - start);
+            });
       })
-      .thenValue([spaceId, this](Response&& resp) mutable -> StatusOr<Response> {
+      .thenValue([spaceId, host, this](Response&& resp) mutable -> StatusOr<Response> {
         auto& result = resp.get_result();
+        if (result.write_epoch_ref().has_value()) {
+          recordWriteEpoch(spaceId, host, *result.write_epoch_ref());
+        }
         for (auto& part : result.get_failed_parts()) {
           auto partId = part.get_part_id();
           auto code = part.get_code();
@@ -175,10 +281,18 @@ folly::Future<StatusOr<Response>> StorageClientBase<ClientType, ClientManagerTyp
             case nebula::cpp2::ErrorCode::E_LEADER_CHANGED: {
               auto* leader = part.get_leader();
               if (isValidHostPtr(leader)) {
+                // A follower too far behind fails the read with the leader cached already, the
+                // leaders are only refreshed if they are changed
+                auto cached = getLeader(spaceId, partId);
+                if (cached.ok() && cached.value() == *leader) {
+                  break;
+                }
                 updateLeader(spaceId, partId, *leader);
               } else {
                 invalidLeader(spaceId, partId);
               }
+              // The other parts are likely moved as well, e.g. by a leader balance
+              metaClient_->refreshLeadersSoon();
               break;
             }
             case nebula::cpp2::ErrorCode::E_PART_NOT_FOUND:
@@ -209,6 +323,240 @@ folly::Future<StatusOr<Response>> StorageClientBase<ClientType, ClientManagerTyp
       });
 }
 
+template <typename ClientType, typename ClientManagerType>
+template <class Request, class RemoteFunc, class Response>
+folly::Future<StatusOr<Response>> StorageClientBase<ClientType, ClientManagerType>::hedgedResponse(
+    folly::EventBase* evb, const HostAddr& host, const Request& request, RemoteFunc remoteFunc) {
+  if (!FLAGS_storage_client_hedge_reads || !servedByFollowers(request)) {
+    return getResponse(evb, host, request, std::move(remoteFunc));
+  }
+  earnHedgeBudget();
+  // No hedging until some rpc to the host is done
+  auto delayMs = clientsMan_->hostLoad().tailLatencyUs(host) / 1000;
+  if (delayMs <= 0) {
+    return getResponse(evb, host, request, std::move(remoteFunc));
+  }
+  if (evb == nullptr) {
+    evb = DCHECK_NOTNULL(ioThreadPool_)->getEventBase();
+  }
+
+  // The rpc to the host and the one to the replica hedging it, the first success is taken
+  struct Hedged : public std::enable_shared_from_this<Hedged> {
+    Hedged(StorageClientBase* c, folly::EventBase* e, HostAddr h, Request req, RemoteFunc func)
+        : client(c),
+          evb(e),
+          host(std::move(h)),
+          request(std::move(req)),
+          remoteFunc(std::move(func)) {}
+
+    void send(const HostAddr& to) {
+      client->getResponse(evb, to, request, RemoteFunc(remoteFunc))
+          .thenTry([self = this->shared_from_this()](folly::Try<StatusOr<Response>>&& t) {
+            self->onResponse(std::move(t));
+          });
+    }
+
+    // Hedge the rpc once it's not responded within the tail latency of the host
+    void hedge() {
+      {
+        std::lock_guard<std::mutex> g(lock);
+        if (done || hedged) {
+          return;
+        }
+        hedged = true;
+        ++pending;
+      }
+      sendHedge();
+    }
+
+    // Send the request to another replica, pending is counted already
+    void sendHedge() {
+      auto other = client->hedgeHost(request.get_space_id(), host, request);
+      if (!other.has_value() || !client->spendHedgeBudget()) {
+        onResponse(std::nullopt);
+        return;
+      }
+      VLOG(2) << "Hedge the request to " << host << " by " << *other;
+      if (kNumHedgedRpcToStoraged.valid()) {
+        stats::StatsManager::addValue(kNumHedgedRpcToStoraged);
+      }
+      send(*other);
+    }
+
+    // The response of an rpc, or none if the hedge is not sent
+    void onResponse(std::optional<folly::Try<StatusOr<Response>>> t) {
+      bool succeeded = t.has_value() && t->hasValue() && t->value().ok() &&
+                       t->value().value().get_result().get_failed_parts().empty();
+      bool hedgeNow = false;
+      {
+        std::lock_guard<std::mutex> g(lock);
+        --pending;
+        if (done) {
+          return;
+        }
+        if (!succeeded) {
+          if (t.has_value()) {
+            failure = std::move(t);
+          }
+          if (pending > 0) {
+            // A failure is only taken if the other rpc is failed as well
+            return;
+          }
+          // The host failed before it's hedged, so the other replica is tried at once
+          hedgeNow = !hedged;
+          if (hedgeNow) {
+            hedged = true;
+            ++pending;
+          }
+        }
+        done = !hedgeNow;
+      }
+      if (hedgeNow) {
+        sendHedge();
+      } else if (succeeded) {
+        promise.setTry(std::move(*t));
+      } else {
+        promise.setTry(std::move(*failure));
+      }
+    }
+
+    StorageClientBase* client;
+    folly::EventBase* evb;
+    HostAddr host;
+    Request request;
+    RemoteFunc remoteFunc;
+    folly::Promise<StatusOr<Response>> promise;
+    std::mutex lock;
+    // The rpc not responded yet, and the last failure
+    size_t pending{1};
+    std::optional<folly::Try<StatusOr<Response>>> failure;
+    bool hedged{false};
+    bool done{false};
+  };
+
+  auto hedged = std::make_shared<Hedged>(this, evb, host, request, std::move(remoteFunc));
+  auto future = hedged->promise.getFuture();
+  hedged->send(host);
+  evb->runInEventBaseThread([evb, hedged, delayMs]() {
+    evb->runAfterDelay([hedged]() { hedged->hedge(); }, delayMs);
+  });
+  return future;
+}
+
+template <typename ClientType, typename ClientManagerType>
+template <class Request>
+std::optional<HostAddr> StorageClientBase<ClientType, ClientManagerType>::hedgeHost(
+    GraphSpaceID spaceId, const HostAddr& host, const Request& request) const {
+  std::optional<std::unordered_set<HostAddr>> common;
+  for (auto partId : getReqPartsId(request)) {
+    auto partHosts = metaClient_->getPartHostsFromCache(spaceId, partId);
+    if (!partHosts.ok()) {
+      return std::nullopt;
+    }
+    std::unordered_set<HostAddr> replicas(partHosts.value().hosts_.begin(),
+                                          partHosts.value().hosts_.end());
+    if (!common.has_value()) {
+      common = std::move(replicas);
+      common->erase(host);
+    } else {
+      for (auto iter = common->begin(); iter != common->end();) {
+        iter = replicas.count(*iter) > 0 ? std::next(iter) : common->erase(iter);
+      }
+    }
+    if (common->empty()) {
+      return std::nullopt;
+    }
+  }
+  if (!common.has_value()) {
+    return std::nullopt;
+  }
+  auto& hostLoad = clientsMan_->hostLoad();
+  std::optional<HostAddr> picked;
+  for (const auto& h : *common) {
+    if (!hostLoad.isSlow(h)) {
+      return h;
+    }
+    picked = h;
+  }
+  return picked;
+}
+
+template <typename ClientType, typename ClientManagerType>
+void StorageClientBase<ClientType, ClientManagerType>::earnHedgeBudget() {
+  // At most a burst of 10 hedges
+  static constexpr int64_t kMaxBudget = 10 * 100;
+  auto budget = hedgeBudget_.load();
+  auto earned = std::min<int64_t>(FLAGS_storage_client_hedge_budget_percent, 100);
+  while (budget < kMaxBudget &&
+         !hedgeBudget_.compare_exchange_weak(budget, std::min(budget + earned, kMaxBudget))) {
+  }
+}
+
+template <typename ClientType, typename ClientManagerType>
+int64_t StorageClientBase<ClientType, ClientManagerType>::dataVersion(GraphSpaceID spaceId) const {
+  auto writeEpochs = writeEpochs_.rlock();
+  auto iter = writeEpochs->find(spaceId);
+  return iter == writeEpochs->end() ? 0 : iter->second.version;
+}
+
+template <typename ClientType, typename ClientManagerType>
+void StorageClientBase<ClientType, ClientManagerType>::recordWriteEpoch(GraphSpaceID spaceId,
+                                                                        const HostAddr& host,
+                                                                        int64_t epoch) {
+  {
+    auto writeEpochs = writeEpochs_.rlock();
+    auto iter = writeEpochs->find(spaceId);
+    if (iter != writeEpochs->end()) {
+      auto found = iter->second.epochs.find(host);
+      if (found != iter->second.epochs.end() && found->second == epoch) {
+        return;
+      }
+    }
+  }
+  auto writeEpochs = writeEpochs_.wlock();
+  auto& space = (*writeEpochs)[spaceId];
+  auto& last = space.epochs[host];
+  if (last != epoch) {
+    last = epoch;
+    space.version++;
+  }
+}
+
+template <typename ClientType, typename ClientManagerType>
+bool StorageClientBase<ClientType, ClientManagerType>::spendHedgeBudget() {
+  auto budget = hedgeBudget_.load();
+  while (budget >= 100) {
+    if (hedgeBudget_.compare_exchange_weak(budget, budget - 100)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename ClientType, typename ClientManagerType>
+void StorageClientBase<ClientType, ClientManagerType>::onRpcSent(const HostAddr& host) {
+  if (kNumInflightRpcToStoraged.valid()) {
+    stats::StatsManager::addValue(stats::StatsManager::counterWithLabels(
+        kNumInflightRpcToStoraged, {{"host", host.toString()}}));
+  }
+}
+
+template <typename ClientType, typename ClientManagerType>
+void StorageClientBase<ClientType, ClientManagerType>::onRpcDone(const HostAddr& host,
+                                                                 int64_t latencyUs) {
+  clientsMan_->hostLoad().release(host, latencyUs);
+  // The stats are only registered in graphd
+  if (kNumInflightRpcToStoraged.valid()) {
+    stats::StatsManager::decValue(stats::StatsManager::counterWithLabels(
+        kNumInflightRpcToStoraged, {{"host", host.toString()}}));
+  }
+  if (kStorageRpcLatencyUs.valid()) {
+    stats::StatsManager::addValue(
+        stats::StatsManager::histoWithLabels(kStorageRpcLatencyUs, {{"host", host.toString()}}),
+        latencyUs);
+  }
+}
+
 template <typename ClientType, typename ClientManagerType>
 template <class Container, class GetIdFunc>
 StatusOr<std::unordered_map<
@@ -216,7 +564,8 @@ StatusOr<std::unordered_map<
     std::unordered_map<PartitionID, std::vector<typename Container::value_type>>>>
 StorageClientBase<ClientType, ClientManagerType>::clusterIdsToHosts(GraphSpaceID spaceId,
                                                                     const Container& ids,
-                                                                    GetIdFunc f) const {
+                                                                    GetIdFunc f,
+                                                                    bool readFromFollower) const {
   std::unordered_map<HostAddr,
                      std::unordered_map<PartitionID, std::vector<typename Container::value_type>>>
       clusters;
@@ -228,7 +577,7 @@ StorageClientBase<ClientType, ClientManagerType>::clusterIdsToHosts(GraphSpaceID
   auto numParts = status.value();
   std::unordered_map<PartitionID, HostAddr> leaders;
   for (int32_t partId = 1; partId <= numParts; ++partId) {
-    auto leader = getLeader(spaceId, partId);
+    auto leader = pickHost(spaceId, partId, readFromFollower);
     if (!leader.ok()) {
       return leader.status();
     }
@@ -248,6 +597,115 @@ StorageClientBase<ClientType, ClientManagerType>::clusterIdsToHosts(GraphSpaceID
   return clusters;
 }
 
+template <typename ClientType, typename ClientManagerType>
+template <class Container, class GetPartsFunc>
+StatusOr<std::unordered_map<
+    HostAddr,
+    std::unordered_map<PartitionID, std::vector<typename Container::value_type>>>>
+StorageClientBase<ClientType, ClientManagerType>::clusterIdsToPartsHosts(
+    GraphSpaceID spaceId, const Container& ids, GetPartsFunc f, bool readFromFollower) const {
+  std::unordered_map<HostAddr,
+                     std::unordered_map<PartitionID, std::vector<typename Container::value_type>>>
+      clusters;
+
+  CHECK(!!metaClient_);
+  auto status = metaClient_->partsNum(spaceId);
+  if (!status.ok()) {
+    return Status::Error("Space not found, spaceid: %d", spaceId);
+  }
+  auto numParts = status.value();
+  std::unordered_map<PartitionID, HostAddr> leaders;
+  for (int32_t partId = 1; partId <= numParts; ++partId) {
+    auto leader = pickHost(spaceId, partId, readFromFollower);
+    if (!leader.ok()) {
+      return leader.status();
+    }
+    leaders[partId] = std::move(leader).value();
+  }
+  std::vector<PartitionID> parts;
+  for (auto& id : ids) {
+    parts.clear();
+    f(numParts, id, &parts);
+    for (auto part : parts) {
+      clusters[leaders[part]][part].emplace_back(id);
+    }
+  }
+  return clusters;
+}
+
+template <typename ClientType, typename ClientManagerType>
+template <class T>
+StatusOr<std::unordered_map<HostAddr, std::unordered_map<PartitionID, std::vector<T>>>>
+StorageClientBase<ClientType, ClientManagerType>::clusterPartsToHosts(
+    GraphSpaceID spaceId,
+    std::unordered_map<PartitionID, std::vector<T>>&& parts,
+    bool readFromFollower) const {
+  std::unordered_map<HostAddr, std::unordered_map<PartitionID, std::vector<T>>> clusters;
+  for (auto& part : parts) {
+    auto host = pickHost(spaceId, part.first, readFromFollower);
+    if (!host.ok()) {
+      return host.status();
+    }
+    clusters[host.value()].emplace(part.first, std::move(part.second));
+  }
+  return clusters;
+}
+
+template <typename ClientType, typename ClientManagerType>
+template <class T>
+void StorageClientBase<ClientType, ClientManagerType>::moveToAnalyticsReplicas(
+    GraphSpaceID spaceId,
+    std::unordered_map<HostAddr, std::unordered_map<PartitionID, T>>* clusters) const {
+  std::unordered_map<HostAddr, std::unordered_map<PartitionID, T>> moved;
+  for (auto& cluster : *clusters) {
+    for (auto& part : cluster.second) {
+      auto replica = metaClient_->getListenerHostsBySpacePartType(
+          spaceId, part.first, meta::cpp2::ListenerType::ANALYTICS);
+      const auto& host = replica.ok() ? replica.value() : cluster.first;
+      moved[host].emplace(part.first, std::move(part.second));
+    }
+  }
+  *clusters = std::move(moved);
+}
+
+template <typename ClientType, typename ClientManagerType>
+StatusOr<HostAddr> StorageClientBase<ClientType, ClientManagerType>::pickHost(
+    GraphSpaceID spaceId, PartitionID partId, bool readFromFollower) const {
+  if (readFromFollower) {
+    auto partHosts = metaClient_->getPartHostsFromCache(spaceId, partId);
+    if (partHosts.ok() && !partHosts.value().hosts_.empty()) {
+      const auto& hosts = partHosts.value().hosts_;
+      if (FLAGS_storage_client_prefer_local_replica) {
+        // The replicas on the same host are preferred, which saves the round trip of network
+        const auto& localIp = metaClient_->getLocalHost().host;
+        auto isLocal = [&localIp](const HostAddr& h) { return h.host == localIp; };
+        auto numLocal = std::count_if(hosts.begin(), hosts.end(), isLocal);
+        if (!localIp.empty() && numLocal > 0) {
+          auto nth = folly::Random::rand32(numLocal);
+          for (const auto& h : hosts) {
+            if (isLocal(h) && nth-- == 0) {
+              return h;
+            }
+          }
+        }
+      }
+      // Avoid the replicas much slower than the others unless all of them are slow
+      auto& hostLoad = clientsMan_->hostLoad();
+      std::vector<const HostAddr*> candidates;
+      for (const auto& h : hosts) {
+        if (!hostLoad.isSlow(h)) {
+          candidates.emplace_back(&h);
+        }
+      }
+      if (!candidates.empty()) {
+        return *candidates[folly::Random::rand32(candidates.size())];
+      }
+      return hosts[folly::Random::rand32(hosts.size())];
+    }
+  }
+  return getLeader(spaceId, partId);
+}
+
 template <typename ClientType, typename ClientManagerType>
 StatusOr<std::unordered_map<HostAddr, std::vector<PartitionID>>>
 StorageClientBase<ClientType, ClientManagerType>::getHostParts(GraphSpaceID spaceId) const {
@@ -9,6 +9,39 @@ DEFINE_int32(storage_client_timeout_ms, 60 * 1000, "storage client timeout");
 DEFINE_uint32(storage_client_retry_interval_ms,
               1000,
               "storage client sleep interval milliseconds between retry");
+DEFINE_uint32(storage_client_get_neighbors_batch_size,
+              0,
+              "Max number of vertices sent to a storage host in one GetNeighbors request, the "
+              "vertices of a host are split into several requests if exceeded, so that the "
+              "responses are built and sent in smaller pieces. 0 means no limit");
+DEFINE_string(storage_client_protocol,
+              "compact",
+              "The thrift protocol of the requests to storage and the responses, compact or "
+              "binary");
+DEFINE_string(storage_client_compression,
+              "none",
+              "The codec the responses of storage are compressed by, none, zstd or zlib");
+DEFINE_int64(storage_client_compression_size_limit,
+             4096,
+             "The responses of storage no larger than it in bytes are not compressed");
+DEFINE_bool(storage_client_prefer_local_replica,
+            true,
+            "When the reads could be served by the followers, prefer the replicas on the same "
+            "host as graphd");
+DEFINE_uint32(storage_client_coalesce_window_us,
+              0,
+              "The max microseconds to buffer the GetNeighbors and GetProps requests of the same "
+              "shape to a storage host, so that the concurrent queries are served by one rpc, 0 "
+              "means sending them one by one");
+DEFINE_bool(storage_client_hedge_reads,
+            false,
+            "Send the reads which could be served by the followers to another replica as well, "
+            "if the first one is not responded within its tail latency, and take the response "
+            "arriving first");
+DEFINE_uint32(storage_client_hedge_budget_percent,
+              5,
+              "The max percent of the reads which could be served by the followers sent twice by "
+              "hedging");
 
 namespace nebula {
 namespace storage {}  // namespace storage
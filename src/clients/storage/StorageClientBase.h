@@ -6,6 +6,7 @@
 #ifndef CLIENTS_STORAGE_STORAGECLIENTBASE_H_
 #define CLIENTS_STORAGE_STORAGECLIENTBASE_H_
 
+#include <folly/Synchronized.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
 #include <folly/futures/Future.h>
 
@@ -19,6 +20,13 @@
 
 DECLARE_int32(storage_client_timeout_ms);
 DECLARE_uint32(storage_client_retry_interval_ms);
+DECLARE_uint32(storage_client_get_neighbors_batch_size);
+DECLARE_string(storage_client_protocol);
+DECLARE_string(storage_client_compression);
+DECLARE_int64(storage_client_compression_size_limit);
+DECLARE_bool(storage_client_prefer_local_replica);
+DECLARE_bool(storage_client_hedge_reads);
+DECLARE_uint32(storage_client_hedge_budget_percent);
 
 constexpr int32_t kInternalPortOffset = -2;
 
@@ -87,6 +95,21 @@ class StorageRpcResponse final {
     responses_.emplace_back(std::move(resp));
   }
 
+  size_t requestsSent() const {
+    return totalReqsSent_;
+  }
+
+  void addResponseBytes(size_t bytes) {
+    std::lock_guard<std::mutex> g(*lock_);
+    responseBytes_ += bytes;
+  }
+
+  // The serialized size of the responses
+  size_t responseBytes() const {
+    std::lock_guard<std::mutex> g(*lock_);
+    return responseBytes_;
+  }
+
   // Not thread-safe.
   const std::unordered_map<PartitionID, nebula::cpp2::ErrorCode>& failedParts() const {
     return failedParts_;
@@ -106,6 +129,7 @@ class StorageRpcResponse final {
   std::unique_ptr<std::mutex> lock_;
   const size_t totalReqsSent_;
   size_t failedReqs_{0};
+  size_t responseBytes_{0};
 
   Result result_{Result::ALL_SUCCEEDED};
   std::unordered_map<PartitionID, nebula::cpp2::ErrorCode> failedParts_;
@@ -114,6 +138,13 @@ class StorageRpcResponse final {
   std::vector<std::tuple<HostAddr, int32_t, int32_t>> hostLatency_;
 };
 
+// Called with each successful response of collectResponse as soon as it arrives, so the caller
+// could consume it before the others are back. It may take the data out of the response, which
+// is collected for its latency and failed parts still. The responses from different hosts may be
+// handled concurrently.
+template <class Response>
+using ResponseHandler = std::function<void(Response&)>;
+
 /**
  * A base class for all storage clients
  */
@@ -122,6 +153,17 @@ class StorageClientBase {
  public:
   StatusOr<HostAddr> getLeader(GraphSpaceID spaceId, PartitionID partId) const;
 
+  // The leader of the part, or any replica of it if readFromFollower is true, in which case the
+  // replicas on this host are preferred if storage_client_prefer_local_replica is set, and the
+  // slow replicas are avoided
+  StatusOr<HostAddr> pickHost(GraphSpaceID spaceId,
+                              PartitionID partId,
+                              bool readFromFollower) const;
+
+  // The version of the data of the space seen by this client, which is changed whenever a host
+  // responds with a write epoch of the space different from the one it responded last time
+  int64_t dataVersion(GraphSpaceID spaceId) const;
+
  protected:
   StorageClientBase(std::shared_ptr<folly::IOThreadPoolExecutor> ioThreadPool,
                     meta::MetaClient* metaClient);
@@ -140,6 +182,18 @@ class StorageClientBase {
       std::unordered_map<HostAddr, Request> requests,
       RemoteFunc&& remoteFunc);
 
+  // Same as above, but more than one request could be sent to the same host, and each response
+  // is passed to onResponse once it arrives if it's given
+  template <class Request,
+            class RemoteFunc,
+            class Response =
+                typename std::result_of<RemoteFunc(ClientType*, const Request&)>::type::value_type>
+  folly::SemiFuture<StorageRpcResponse<Response>> collectResponse(
+      folly::EventBase* evb,
+      std::vector<std::pair<HostAddr, Request>> requests,
+      RemoteFunc&& remoteFunc,
+      ResponseHandler<Response> onResponse = nullptr);
+
   template <class Request,
             class RemoteFunc,
             class Response = typename std::result_of<RemoteFunc(ClientType* client,
@@ -149,15 +203,61 @@ class StorageClientBase {
                                                 const Request& request,
                                                 RemoteFunc&& remoteFunc);
 
+  /**
+   * @brief Same as getResponse, but if storage_client_hedge_reads is set and the request could be
+   * served by the followers, the request is sent to another replica holding all its parts as
+   * well once the first host doesn't respond within its tail latency, or at once if the host fails
+   * before that. The first successful response is taken, and a failure only if both have failed.
+   */
+  template <class Request,
+            class RemoteFunc,
+            class Response = typename std::result_of<RemoteFunc(ClientType* client,
+                                                                const Request&)>::type::value_type>
+  folly::Future<StatusOr<Response>> hedgedResponse(folly::EventBase* evb,
+                                                   const HostAddr& host,
+                                                   const Request& request,
+                                                   RemoteFunc remoteFunc);
+
   // Cluster given ids into the host they belong to
   // The method returns a map
   //  host_addr (A host, but in most case, the leader will be chosen)
   //      => (partition -> [ids that belong to the shard])
+  // If readFromFollower is true, any replica of the part could be chosen to spread the reads
   template <class Container, class GetIdFunc>
   StatusOr<std::unordered_map<
       HostAddr,
       std::unordered_map<PartitionID, std::vector<typename Container::value_type>>>>
-  clusterIdsToHosts(GraphSpaceID spaceId, const Container& ids, GetIdFunc f) const;
+  clusterIdsToHosts(GraphSpaceID spaceId,
+                    const Container& ids,
+                    GetIdFunc f,
+                    bool readFromFollower = false) const;
+
+  // The same as clusterIdsToHosts, but f(numParts, id, &parts) appends the parts the id is sent
+  // to, which are more than one for the vertex split by ALTER SPACE, so its tags are written to
+  // and its edges are read from all its parts
+  template <class Container, class GetPartsFunc>
+  StatusOr<std::unordered_map<
+      HostAddr,
+      std::unordered_map<PartitionID, std::vector<typename Container::value_type>>>>
+  clusterIdsToPartsHosts(GraphSpaceID spaceId,
+                         const Container& ids,
+                         GetPartsFunc f,
+                         bool readFromFollower = false) const;
+
+  // Cluster the ids already grouped by their parts into the hosts the parts belong to, which
+  // saves computing the part of each id
+  template <class T>
+  StatusOr<std::unordered_map<HostAddr, std::unordered_map<PartitionID, std::vector<T>>>>
+  clusterPartsToHosts(GraphSpaceID spaceId,
+                      std::unordered_map<PartitionID, std::vector<T>>&& parts,
+                      bool readFromFollower = false) const;
+
+  // Move the clustered parts having an ANALYTICS listener to it, the others are left where they
+  // are
+  template <class T>
+  void moveToAnalyticsReplicas(
+      GraphSpaceID spaceId,
+      std::unordered_map<HostAddr, std::unordered_map<PartitionID, T>>* clusters) const;
 
   StatusOr<std::unordered_map<HostAddr, std::unordered_map<PartitionID, cpp2::ScanCursor>>>
   getHostPartsWithCursor(GraphSpaceID spaceId) const;
@@ -208,12 +308,90 @@ class StorageClientBase {
     return addr != nullptr && !addr->host.empty() && addr->port != 0;
   }
 
+  // Whether the request could be served by the followers
+  template <class Request>
+  static bool servedByFollowers(const Request&) {
+    return false;
+  }
+
+  static bool servedByFollowers(const cpp2::GetNeighborsRequest& req) {
+    return req.common_ref().has_value() && req.common_ref()->max_staleness_ms_ref().value_or(0) > 0;
+  }
+
+  static bool servedByFollowers(const cpp2::GetPropRequest& req) {
+    return req.common_ref().has_value() && req.common_ref()->max_staleness_ms_ref().value_or(0) > 0;
+  }
+
+  // Take the parts of a request served by the followers out of it, to retry them on their
+  // leader, where no staleness is allowed. nullopt if the request is never served by followers.
+  template <class Request>
+  static std::optional<Request> takeLeaderRequest(Request&, const std::vector<PartitionID>&) {
+    return std::nullopt;
+  }
+
+  static std::optional<cpp2::GetNeighborsRequest> takeLeaderRequest(
+      cpp2::GetNeighborsRequest& req, const std::vector<PartitionID>& parts) {
+    return takeParts(req, parts);
+  }
+
+  static std::optional<cpp2::GetPropRequest> takeLeaderRequest(
+      cpp2::GetPropRequest& req, const std::vector<PartitionID>& parts) {
+    return takeParts(req, parts);
+  }
+
+  template <class Request>
+  static Request takeParts(Request& req, const std::vector<PartitionID>& parts) {
+    auto rest = std::move(*req.parts_ref());
+    std::decay_t<decltype(rest)> taken;
+    for (auto partId : parts) {
+      auto found = rest.find(partId);
+      if (found != rest.end()) {
+        taken.emplace(partId, std::move(found->second));
+        rest.erase(found);
+      }
+    }
+    Request leaderReq = req;
+    *req.parts_ref() = std::move(rest);
+    *leaderReq.parts_ref() = std::move(taken);
+    if (leaderReq.common_ref().has_value()) {
+      leaderReq.common_ref()->max_staleness_ms_ref().reset();
+    }
+    return leaderReq;
+  }
+
+  // Another replica holding all the parts of the request, preferring the ones not slow
+  template <class Request>
+  std::optional<HostAddr> hedgeHost(GraphSpaceID spaceId,
+                                    const HostAddr& host,
+                                    const Request& request) const;
+
+  // Each read which could be hedged earns some budget, and each hedge spends one
+  void earnHedgeBudget();
+  bool spendHedgeBudget();
+
+  // Count the rpc in flight of the host
+  void onRpcSent(const HostAddr& host);
+
+  // Give back the slot of the host and record the latency of the rpc
+  void onRpcDone(const HostAddr& host, int64_t latencyUs);
+
+  void recordWriteEpoch(GraphSpaceID spaceId, const HostAddr& host, int64_t epoch);
+
  protected:
   meta::MetaClient* metaClient_{nullptr};
 
  private:
   std::shared_ptr<folly::IOThreadPoolExecutor> ioThreadPool_;
   std::unique_ptr<ClientManagerType> clientsMan_;
+  // The budget of hedging in percent of a request
+  std::atomic<int64_t> hedgeBudget_{0};
+
+  struct WriteEpochs {
+    // The last write epoch of the space responded by each host
+    std::unordered_map<HostAddr, int64_t> epochs;
+    int64_t version{0};
+  };
+  folly::Synchronized<std::unordered_map<GraphSpaceID, WriteEpochs>> writeEpochs_;
 };
 
 }  // namespace storage
@@ -9,12 +9,22 @@ namespace nebula {
 
 stats::CounterId kNumRpcSentToStoraged;
 stats::CounterId kNumRpcSentToStoragedFailed;
+stats::CounterId kNumInflightRpcToStoraged;
+stats::CounterId kStorageRpcLatencyUs;
+stats::CounterId kNumHedgedRpcToStoraged;
 
 void initStorageClientStats() {
   kNumRpcSentToStoraged =
       stats::StatsManager::registerStats("num_rpc_sent_to_storaged", "rate, sum");
   kNumRpcSentToStoragedFailed =
       stats::StatsManager::registerStats("num_rpc_sent_to_storaged_failed", "rate, sum");
+  // Labeled by the storage host
+  kNumInflightRpcToStoraged =
+      stats::StatsManager::registerStats("num_inflight_rpc_to_storaged", "sum");
+  kStorageRpcLatencyUs = stats::StatsManager::registerHisto(
+      "storage_rpc_latency_us", 1000, 0, 2000, "avg, p75, p95, p99, p999");
+  kNumHedgedRpcToStoraged =
+      stats::StatsManager::registerStats("num_hedged_rpc_to_storaged", "rate, sum");
 }
 
 }  // namespace nebula
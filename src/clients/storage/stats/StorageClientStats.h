@@ -12,6 +12,9 @@ namespace nebula {
 
 extern stats::CounterId kNumRpcSentToStoraged;
 extern stats::CounterId kNumRpcSentToStoragedFailed;
+extern stats::CounterId kNumInflightRpcToStoraged;
+extern stats::CounterId kStorageRpcLatencyUs;
+extern stats::CounterId kNumHedgedRpcToStoraged;
 
 void initStorageClientStats();
 
@@ -0,0 +1,124 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef CODEC_COUNTEROPERAND_H_
+#define CODEC_COUNTEROPERAND_H_
+
+#include "common/base/Base.h"
+#include "common/datatypes/Value.h"
+#include "common/thrift/ThriftTypes.h"
+
+namespace nebula {
+
+/**
+ * @brief Operand of the merge operator, which adds the deltas to the props of a vertex or an edge.
+ * The deltas are either integers or floats, and the ones of the same prop are added up when the
+ * operands are merged. It's decoded by the merge operator of storage and the CDC listener.
+ */
+struct CounterOperand {
+  static constexpr char kVersion = 0x01;
+
+  GraphSpaceID spaceId{0};
+  bool isEdge{false};
+  // Tag id or edge type
+  int32_t schemaId{0};
+  // prop name => delta
+  std::vector<std::pair<std::string, Value>> deltas;
+
+  std::string encode() const {
+    std::string encoded;
+    encoded.append(1, kVersion);
+    encoded.append(reinterpret_cast<const char*>(&spaceId), sizeof(spaceId));
+    encoded.append(1, isEdge ? 1 : 0);
+    encoded.append(reinterpret_cast<const char*>(&schemaId), sizeof(schemaId));
+    auto num = static_cast<uint32_t>(deltas.size());
+    encoded.append(reinterpret_cast<const char*>(&num), sizeof(num));
+    for (const auto& delta : deltas) {
+      auto len = static_cast<uint32_t>(delta.first.size());
+      encoded.append(reinterpret_cast<const char*>(&len), sizeof(len)).append(delta.first);
+      if (delta.second.isInt()) {
+        auto v = delta.second.getInt();
+        encoded.append(1, 'i').append(reinterpret_cast<const char*>(&v), sizeof(v));
+      } else {
+        auto v = delta.second.getFloat();
+        encoded.append(1, 'f').append(reinterpret_cast<const char*>(&v), sizeof(v));
+      }
+    }
+    return encoded;
+  }
+
+  static std::optional<CounterOperand> decode(folly::StringPiece data) {
+    CounterOperand operand;
+    auto read = [&data](void* to, size_t len) {
+      if (data.size() < len) {
+        return false;
+      }
+      memcpy(to, data.data(), len);
+      data.advance(len);
+      return true;
+    };
+    char version = 0;
+    char isEdge = 0;
+    uint32_t num = 0;
+    if (!read(&version, 1) || version != kVersion ||
+        !read(&operand.spaceId, sizeof(GraphSpaceID)) || !read(&isEdge, 1) ||
+        !read(&operand.schemaId, sizeof(int32_t)) || !read(&num, sizeof(num))) {
+      return std::nullopt;
+    }
+    operand.isEdge = isEdge != 0;
+    for (uint32_t i = 0; i < num; i++) {
+      uint32_t len = 0;
+      if (!read(&len, sizeof(len)) || data.size() < len) {
+        return std::nullopt;
+      }
+      std::string name(data.data(), len);
+      data.advance(len);
+      char type = 0;
+      if (!read(&type, 1)) {
+        return std::nullopt;
+      }
+      if (type == 'i') {
+        int64_t v = 0;
+        if (!read(&v, sizeof(v))) {
+          return std::nullopt;
+        }
+        operand.deltas.emplace_back(std::move(name), v);
+      } else if (type == 'f') {
+        double v = 0;
+        if (!read(&v, sizeof(v))) {
+          return std::nullopt;
+        }
+        operand.deltas.emplace_back(std::move(name), v);
+      } else {
+        return std::nullopt;
+      }
+    }
+    return operand;
+  }
+
+  /**
+   * @brief Add the delta to the value, the value is kept if it is null or the sum overflows
+   *
+   * @return Whether the delta is added
+   */
+  static bool add(Value& value, const Value& delta) {
+    if (value.isInt() && delta.isInt()) {
+      int64_t sum = 0;
+      if (__builtin_add_overflow(value.getInt(), delta.getInt(), &sum)) {
+        return false;
+      }
+      value = sum;
+      return true;
+    }
+    if (value.isFloat()) {
+      value = value.getFloat() + (delta.isInt() ? delta.getInt() : delta.getFloat());
+      return true;
+    }
+    return false;
+  }
+};
+
+}  // namespace nebula
+#endif  // CODEC_COUNTEROPERAND_H_
@@ -157,6 +157,15 @@ class RowReader {
     return data_.toString();
   }
 
+  /**
+   * @brief Get the raw value in kv engine without copying it
+   *
+   * @return folly::StringPiece
+   */
+  virtual folly::StringPiece getRawData() const noexcept {
+    return data_;
+  }
+
  protected:
   meta::SchemaProviderIf const* schema_;
   folly::StringPiece data_;
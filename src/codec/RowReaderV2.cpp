@@ -9,135 +9,86 @@ namespace nebula {
 
 using nebula::cpp2::PropertyType;
 
-bool RowReaderV2::resetImpl(meta::SchemaProviderIf const* schema, folly::StringPiece row) noexcept {
-  RowReader::resetImpl(schema, row);
-
-  DCHECK(!!schema_);
-
-  size_t numVerBytes = data_[0] & 0x07;
-  headerLen_ = numVerBytes + 1;
-
-#ifndef NDEBUG
-  // Get the schema version
-  SchemaVer schemaVer = 0;
-  if (numVerBytes > 0) {
-    memcpy(reinterpret_cast<void*>(&schemaVer), &data_[1], numVerBytes);
-  }
-  DCHECK_EQ(schemaVer, schema_->getVersion());
-#endif
+namespace {
 
-  // Null flags
-  size_t numNullables = schema_->getNumNullableFields();
-  if (numNullables > 0) {
-    numNullBytes_ = ((numNullables - 1) >> 3) + 1;
-  } else {
-    numNullBytes_ = 0;
-  }
-
-  return true;
-}
-
-bool RowReaderV2::isNull(size_t pos) const {
-  static const uint8_t bits[] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
-
-  size_t offset = headerLen_ + (pos >> 3);
-  int8_t flag = data_[offset] & bits[pos & 0x0000000000000007L];
-  return flag != 0;
-}
-
-Value RowReaderV2::getValueByName(const std::string& prop) const noexcept {
-  int64_t index = schema_->getFieldIndex(prop);
-  return getValueByIndex(index);
-}
-
-Value RowReaderV2::getValueByIndex(const int64_t index) const noexcept {
-  if (index < 0 || static_cast<size_t>(index) >= schema_->getNumFields()) {
-    return Value(NullType::UNKNOWN_PROP);
-  }
-
-  auto field = schema_->field(index);
-  size_t offset = headerLen_ + numNullBytes_ + field->offset();
-
-  if (field->nullable() && isNull(field->nullFlagPos())) {
-    return NullType::__NULL__;
-  }
-
-  switch (field->type()) {
+// Decode the value of the field of type at the offset of the row
+Value readField(folly::StringPiece data, PropertyType type, size_t offset, size_t size) {
+  switch (type) {
     case PropertyType::BOOL: {
-      if (data_[offset]) {
+      if (data[offset]) {
         return true;
       } else {
         return false;
       }
     }
     case PropertyType::INT8: {
-      return static_cast<int8_t>(data_[offset]);
+      return static_cast<int8_t>(data[offset]);
     }
     case PropertyType::INT16: {
       int16_t val;
-      memcpy(reinterpret_cast<void*>(&val), &data_[offset], sizeof(int16_t));
+      memcpy(reinterpret_cast<void*>(&val), &data[offset], sizeof(int16_t));
       return val;
     }
     case PropertyType::INT32: {
       int32_t val;
-      memcpy(reinterpret_cast<void*>(&val), &data_[offset], sizeof(int32_t));
+      memcpy(reinterpret_cast<void*>(&val), &data[offset], sizeof(int32_t));
       return val;
     }
     case PropertyType::INT64: {
       int64_t val;
-      memcpy(reinterpret_cast<void*>(&val), &data_[offset], sizeof(int64_t));
+      memcpy(reinterpret_cast<void*>(&val), &data[offset], sizeof(int64_t));
       return val;
     }
     case PropertyType::VID: {
       // This is to be compatible with V1, so we treat it as
       // 8-byte long string
-      return std::string(&data_[offset], sizeof(int64_t));
+      return std::string(&data[offset], sizeof(int64_t));
     }
     case PropertyType::FLOAT: {
       float val;
-      memcpy(reinterpret_cast<void*>(&val), &data_[offset], sizeof(float));
+      memcpy(reinterpret_cast<void*>(&val), &data[offset], sizeof(float));
       return val;
     }
     case PropertyType::DOUBLE: {
       double val;
-      memcpy(reinterpret_cast<void*>(&val), &data_[offset], sizeof(double));
+      memcpy(reinterpret_cast<void*>(&val), &data[offset], sizeof(double));
       return val;
     }
     case PropertyType::STRING: {
       int32_t strOffset;
       int32_t strLen;
-      memcpy(reinterpret_cast<void*>(&strOffset), &data_[offset], sizeof(int32_t));
-      memcpy(reinterpret_cast<void*>(&strLen), &data_[offset + sizeof(int32_t)], sizeof(int32_t));
-      if (static_cast<size_t>(strOffset) == data_.size() && strLen == 0) {
+      memcpy(reinterpret_cast<void*>(&strOffset), &data[offset], sizeof(int32_t));
+      memcpy(reinterpret_cast<void*>(&strLen), &data[offset + sizeof(int32_t)], sizeof(int32_t));
+      if (static_cast<size_t>(strOffset) == data.size() && strLen == 0) {
         return std::string();
       }
-      CHECK_LT(strOffset, data_.size());
-      return std::string(&data_[strOffset], strLen);
+      CHECK_LT(strOffset, data.size());
+      return std::string(&data[strOffset], strLen);
     }
     case PropertyType::FIXED_STRING: {
-      return std::string(&data_[offset], field->size());
+      return std::string(&data[offset], size);
     }
     case PropertyType::TIMESTAMP: {
       Timestamp ts;
-      memcpy(reinterpret_cast<void*>(&ts), &data_[offset], sizeof(Timestamp));
+      memcpy(reinterpret_cast<void*>(&ts), &data[offset], sizeof(Timestamp));
       return ts;
     }
     case PropertyType::DATE: {
       Date dt;
-      memcpy(reinterpret_cast<void*>(&dt.year), &data_[offset], sizeof(int16_t));
-      memcpy(reinterpret_cast<void*>(&dt.month), &data_[offset + sizeof(int16_t)], sizeof(int8_t));
+      memcpy(reinterpret_cast<void*>(&dt.year), &data[offset], sizeof(int16_t));
+      memcpy(reinterpret_cast<void*>(&dt.month), &data[offset + sizeof(int16_t)], sizeof(int8_t));
       memcpy(reinterpret_cast<void*>(&dt.day),
-             &data_[offset + sizeof(int16_t) + sizeof(int8_t)],
+             &data[offset + sizeof(int16_t) + sizeof(int8_t)],
              sizeof(int8_t));
       return dt;
     }
     case PropertyType::TIME: {
       Time t;
-      memcpy(reinterpret_cast<void*>(&t.hour), &data_[offset], sizeof(int8_t));
-      memcpy(reinterpret_cast<void*>(&t.minute), &data_[offset + sizeof(int8_t)], sizeof(int8_t));
-      memcpy(reinterpret_cast<void*>(&t.sec), &data_[offset + 2 * sizeof(int8_t)], sizeof(int8_t));
+      memcpy(reinterpret_cast<void*>(&t.hour), &data[offset], sizeof(int8_t));
+      memcpy(reinterpret_cast<void*>(&t.minute), &data[offset + sizeof(int8_t)], sizeof(int8_t));
+      memcpy(reinterpret_cast<void*>(&t.sec), &data[offset + 2 * sizeof(int8_t)], sizeof(int8_t));
       memcpy(reinterpret_cast<void*>(&t.microsec),
-             &data_[offset + 3 * sizeof(int8_t)],
+             &data[offset + 3 * sizeof(int8_t)],
              sizeof(int32_t));
       return t;
     }
@@ -150,22 +101,22 @@ Value RowReaderV2::getValueByIndex(const int64_t index) const noexcept {
       int8_t minute;
       int8_t sec;
       int32_t microsec;
-      memcpy(reinterpret_cast<void*>(&year), &data_[offset], sizeof(int16_t));
-      memcpy(reinterpret_cast<void*>(&month), &data_[offset + sizeof(int16_t)], sizeof(int8_t));
+      memcpy(reinterpret_cast<void*>(&year), &data[offset], sizeof(int16_t));
+      memcpy(reinterpret_cast<void*>(&month), &data[offset + sizeof(int16_t)], sizeof(int8_t));
       memcpy(reinterpret_cast<void*>(&day),
-             &data_[offset + sizeof(int16_t) + sizeof(int8_t)],
+             &data[offset + sizeof(int16_t) + sizeof(int8_t)],
              sizeof(int8_t));
       memcpy(reinterpret_cast<void*>(&hour),
-             &data_[offset + sizeof(int16_t) + 2 * sizeof(int8_t)],
+             &data[offset + sizeof(int16_t) + 2 * sizeof(int8_t)],
              sizeof(int8_t));
       memcpy(reinterpret_cast<void*>(&minute),
-             &data_[offset + sizeof(int16_t) + 3 * sizeof(int8_t)],
+             &data[offset + sizeof(int16_t) + 3 * sizeof(int8_t)],
              sizeof(int8_t));
       memcpy(reinterpret_cast<void*>(&sec),
-             &data_[offset + sizeof(int16_t) + 4 * sizeof(int8_t)],
+             &data[offset + sizeof(int16_t) + 4 * sizeof(int8_t)],
              sizeof(int8_t));
       memcpy(reinterpret_cast<void*>(&microsec),
-             &data_[offset + sizeof(int16_t) + 5 * sizeof(int8_t)],
+             &data[offset + sizeof(int16_t) + 5 * sizeof(int8_t)],
              sizeof(int32_t));
       dt.year = year;
       dt.month = month;
@@ -178,25 +129,25 @@ Value RowReaderV2::getValueByIndex(const int64_t index) const noexcept {
     }
     case PropertyType::DURATION: {
       Duration d;
-      memcpy(reinterpret_cast<void*>(&d.seconds), &data_[offset], sizeof(int64_t));
+      memcpy(reinterpret_cast<void*>(&d.seconds), &data[offset], sizeof(int64_t));
       memcpy(reinterpret_cast<void*>(&d.microseconds),
-             &data_[offset + sizeof(int64_t)],
+             &data[offset + sizeof(int64_t)],
              sizeof(int32_t));
       memcpy(reinterpret_cast<void*>(&d.months),
-             &data_[offset + sizeof(int64_t) + sizeof(int32_t)],
+             &data[offset + sizeof(int64_t) + sizeof(int32_t)],
              sizeof(int32_t));
       return d;
     }
     case PropertyType::GEOGRAPHY: {
       int32_t strOffset;
       int32_t strLen;
-      memcpy(reinterpret_cast<void*>(&strOffset), &data_[offset], sizeof(int32_t));
-      memcpy(reinterpret_cast<void*>(&strLen), &data_[offset + sizeof(int32_t)], sizeof(int32_t));
-      if (static_cast<size_t>(strOffset) == data_.size() && strLen == 0) {
+      memcpy(reinterpret_cast<void*>(&strOffset), &data[offset], sizeof(int32_t));
+      memcpy(reinterpret_cast<void*>(&strLen), &data[offset + sizeof(int32_t)], sizeof(int32_t));
+      if (static_cast<size_t>(strOffset) == data.size() && strLen == 0) {
         return Value::kEmpty;  // Is it ok to return Value::kEmpty?
       }
-      CHECK_LT(strOffset, data_.size());
-      auto wkb = std::string(&data_[strOffset], strLen);
+      CHECK_LT(strOffset, data.size());
+      auto wkb = std::string(&data[strOffset], strLen);
       // Parse a geography from the wkb, normalize it and then verify its validity.
       auto geogRet = Geography::fromWKB(wkb, true, true);
       if (!geogRet.ok()) {
@@ -211,8 +162,104 @@ Value RowReaderV2::getValueByIndex(const int64_t index) const noexcept {
   LOG(FATAL) << "Should not reach here";
 }
 
+}  // namespace
+
+bool RowReaderV2::resetImpl(meta::SchemaProviderIf const* schema, folly::StringPiece row) noexcept {
+  RowReader::resetImpl(schema, row);
+
+  DCHECK(!!schema_);
+
+  size_t numVerBytes = data_[0] & 0x07;
+  headerLen_ = numVerBytes + 1;
+
+#ifndef NDEBUG
+  // Get the schema version
+  SchemaVer schemaVer = 0;
+  if (numVerBytes > 0) {
+    memcpy(reinterpret_cast<void*>(&schemaVer), &data_[1], numVerBytes);
+  }
+  DCHECK_EQ(schemaVer, schema_->getVersion());
+#endif
+
+  // Null flags
+  size_t numNullables = schema_->getNumNullableFields();
+  if (numNullables > 0) {
+    numNullBytes_ = ((numNullables - 1) >> 3) + 1;
+  } else {
+    numNullBytes_ = 0;
+  }
+
+  return true;
+}
+
+bool RowReaderV2::isNull(size_t pos) const {
+  static const uint8_t bits[] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
+
+  size_t offset = headerLen_ + (pos >> 3);
+  int8_t flag = data_[offset] & bits[pos & 0x0000000000000007L];
+  return flag != 0;
+}
+
+Value RowReaderV2::getValueByName(const std::string& prop) const noexcept {
+  int64_t index = schema_->getFieldIndex(prop);
+  return getValueByIndex(index);
+}
+
+Value RowReaderV2::getValueByIndex(const int64_t index) const noexcept {
+  if (index < 0 || static_cast<size_t>(index) >= schema_->getNumFields()) {
+    return Value(NullType::UNKNOWN_PROP);
+  }
+
+  auto field = schema_->field(index);
+  size_t offset = headerLen_ + numNullBytes_ + field->offset();
+
+  if (field->nullable() && isNull(field->nullFlagPos())) {
+    return NullType::__NULL__;
+  }
+
+  return readField(data_, field->type(), offset, field->size());
+}
+
 int64_t RowReaderV2::getTimestamp() const noexcept {
   return *reinterpret_cast<const int64_t*>(data_.begin() + (data_.size() - sizeof(int64_t)));
 }
 
+RowProjectionV2::RowProjectionV2(meta::SchemaProviderIf const* schema,
+                                 const std::vector<std::string>& fields)
+    : schema_(schema) {
+  DCHECK(!!schema_);
+  size_t numNullables = schema_->getNumNullableFields();
+  if (numNullables > 0) {
+    numNullBytes_ = ((numNullables - 1) >> 3) + 1;
+  }
+  fields_.reserve(fields.size());
+  for (const auto& name : fields) {
+    auto field = schema_->field(name);
+    if (field == nullptr) {
+      fields_.emplace_back(Field{PropertyType::UNKNOWN, -1, -1, 0});
+      continue;
+    }
+    fields_.emplace_back(Field{field->type(),
+                               static_cast<int64_t>(numNullBytes_ + field->offset()),
+                               field->nullable() ? static_cast<int64_t>(field->nullFlagPos()) : -1,
+                               field->size()});
+  }
+}
+
+void RowProjectionV2::decode(folly::StringPiece row, std::vector<Value>& values) const {
+  static const uint8_t bits[] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
+  // The header has the same format as RowReaderV2::resetImpl reads
+  size_t headerLen = (row[0] & 0x07) + 1;
+  for (const auto& field : fields_) {
+    if (field.offset < 0) {
+      values.emplace_back(NullType::UNKNOWN_PROP);
+    } else if (field.nullFlagPos >= 0 &&
+               (row[headerLen + (field.nullFlagPos >> 3)] & bits[field.nullFlagPos & 0x07]) != 0) {
+      values.emplace_back(NullType::__NULL__);
+    } else {
+      values.emplace_back(readField(row, field.type, headerLen + field.offset, field.size));
+    }
+  }
+}
+
 }  // namespace nebula
@@ -53,5 +53,50 @@ class RowReaderV2 : public RowReader {
   bool isNull(size_t pos) const;
 };
 
+/**
+ * The projection of some fields of the rows encoded by one schema version. The offsets and null
+ * flags of the fields are resolved once when it is built, so decoding a row reads the projected
+ * fields in one loop instead of looking up the schema for each field of each row.
+ */
+class RowProjectionV2 final {
+ public:
+  /**
+   * @brief Build the projection
+   *
+   * @param schema Schema of the rows to decode
+   * @param fields The names of fields to decode, the ones not in schema are decoded as
+   * NullType::UNKNOWN_PROP
+   */
+  RowProjectionV2(meta::SchemaProviderIf const* schema, const std::vector<std::string>& fields);
+
+  /**
+   * @brief Decode the projected fields of the row and append them to values in order, the row
+   * must be encoded by the schema of the projection
+   */
+  void decode(folly::StringPiece row, std::vector<Value>& values) const;
+
+  const meta::SchemaProviderIf* schema() const {
+    return schema_;
+  }
+
+  size_t numFields() const {
+    return fields_.size();
+  }
+
+ private:
+  struct Field {
+    nebula::cpp2::PropertyType type;
+    // offset after the null flags, -1 if the field is not in schema
+    int64_t offset;
+    // -1 if the field is not nullable
+    int64_t nullFlagPos;
+    size_t size;
+  };
+
+  meta::SchemaProviderIf const* schema_;
+  size_t numNullBytes_{0};
+  std::vector<Field> fields_;
+};
+
 }  // namespace nebula
 #endif  // CODEC_ROWREADERV2_H_
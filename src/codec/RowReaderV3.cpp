@@ -0,0 +1,286 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "codec/RowReaderV3.h"
+
+namespace nebula {
+
+using nebula::cpp2::PropertyType;
+
+namespace {
+
+// Read a varint at the offset and move the offset after it, return false if the data is broken
+bool readVarint(folly::StringPiece data, size_t end, size_t& offset, uint64_t& v) {
+  if (offset >= end) {
+    return false;
+  }
+  const uint8_t* start = reinterpret_cast<const uint8_t*>(&data[offset]);
+  folly::ByteRange range(start, end - offset);
+  try {
+    v = folly::decodeVarint(range);
+  } catch (const std::exception& ex) {
+    return false;
+  }
+  offset += range.begin() - start;
+  return true;
+}
+
+// Read len bytes at the offset and move the offset after them, return false if the data is broken
+bool readBytes(
+    folly::StringPiece data, size_t end, size_t& offset, size_t len, const char*& bytes) {
+  if (offset > end || len > end - offset) {
+    return false;
+  }
+  bytes = &data[offset];
+  offset += len;
+  return true;
+}
+
+// Read the property of the type at the offset and move the offset to the next one. The value is
+// not decoded if v is nullptr. Return false if the data is broken.
+bool readField(folly::StringPiece data, size_t end, PropertyType type, size_t& offset, Value* v) {
+  uint64_t u = 0;
+  const char* bytes = nullptr;
+  switch (type) {
+    case PropertyType::INT8:
+    case PropertyType::INT16:
+    case PropertyType::INT32:
+    case PropertyType::INT64:
+    case PropertyType::TIMESTAMP: {
+      if (!readVarint(data, end, offset, u)) {
+        return false;
+      }
+      if (v != nullptr) {
+        *v = folly::decodeZigZag(u);
+      }
+      return true;
+    }
+    case PropertyType::FLOAT: {
+      if (!readBytes(data, end, offset, sizeof(float), bytes)) {
+        return false;
+      }
+      if (v != nullptr) {
+        float val;
+        memcpy(reinterpret_cast<void*>(&val), bytes, sizeof(float));
+        *v = val;
+      }
+      return true;
+    }
+    case PropertyType::DOUBLE: {
+      if (!readBytes(data, end, offset, sizeof(double), bytes)) {
+        return false;
+      }
+      if (v != nullptr) {
+        double val;
+        memcpy(reinterpret_cast<void*>(&val), bytes, sizeof(double));
+        *v = val;
+      }
+      return true;
+    }
+    case PropertyType::VID: {
+      if (!readBytes(data, end, offset, sizeof(int64_t), bytes)) {
+        return false;
+      }
+      if (v != nullptr) {
+        *v = std::string(bytes, sizeof(int64_t));
+      }
+      return true;
+    }
+    case PropertyType::STRING:
+    case PropertyType::FIXED_STRING: {
+      if (!readVarint(data, end, offset, u) || !readBytes(data, end, offset, u, bytes)) {
+        return false;
+      }
+      if (v != nullptr) {
+        *v = std::string(bytes, u);
+      }
+      return true;
+    }
+    case PropertyType::GEOGRAPHY: {
+      if (!readVarint(data, end, offset, u) || !readBytes(data, end, offset, u, bytes)) {
+        return false;
+      }
+      if (v == nullptr) {
+        return true;
+      }
+      if (u == 0) {
+        // The same as the empty geography in V2
+        *v = Value::kEmpty;
+        return true;
+      }
+      // Parse a geography from the wkb, normalize it and then verify its validity.
+      auto geogRet = Geography::fromWKB(std::string(bytes, u), true, true);
+      if (!geogRet.ok()) {
+        LOG(WARNING) << "Geography::fromWKB failed: " << geogRet.status();
+        *v = Value::kNullBadData;
+      } else {
+        *v = std::move(geogRet).value();
+      }
+      return true;
+    }
+    case PropertyType::DATE:
+    case PropertyType::DATETIME: {
+      if (!readVarint(data, end, offset, u) || !readBytes(data, end, offset, 2, bytes)) {
+        return false;
+      }
+      int16_t year = folly::decodeZigZag(u);
+      int8_t month = bytes[0];
+      int8_t day = bytes[1];
+      if (type == PropertyType::DATE) {
+        if (v != nullptr) {
+          *v = Date(year, month, day);
+        }
+        return true;
+      }
+      if (!readBytes(data, end, offset, 3, bytes) || !readVarint(data, end, offset, u)) {
+        return false;
+      }
+      if (v != nullptr) {
+        *v = DateTime(year, month, day, bytes[0], bytes[1], bytes[2], u);
+      }
+      return true;
+    }
+    case PropertyType::TIME: {
+      if (!readBytes(data, end, offset, 3, bytes) || !readVarint(data, end, offset, u)) {
+        return false;
+      }
+      if (v != nullptr) {
+        Time t;
+        t.hour = bytes[0];
+        t.minute = bytes[1];
+        t.sec = bytes[2];
+        t.microsec = u;
+        *v = t;
+      }
+      return true;
+    }
+    case PropertyType::DURATION: {
+      uint64_t micro = 0;
+      uint64_t months = 0;
+      if (!readVarint(data, end, offset, u) || !readVarint(data, end, offset, micro) ||
+          !readVarint(data, end, offset, months)) {
+        return false;
+      }
+      if (v != nullptr) {
+        Duration d;
+        d.seconds = folly::decodeZigZag(u);
+        d.microseconds = folly::decodeZigZag(micro);
+        d.months = folly::decodeZigZag(months);
+        *v = d;
+      }
+      return true;
+    }
+    case PropertyType::BOOL:
+    case PropertyType::UNKNOWN:
+      break;
+  }
+  return false;
+}
+
+}  // namespace
+
+bool RowReaderV3::resetImpl(meta::SchemaProviderIf const* schema, folly::StringPiece row) noexcept {
+  RowReader::resetImpl(schema, row);
+
+  DCHECK(!!schema_);
+
+  size_t numVerBytes = data_[0] & 0x07;
+  headerLen_ = numVerBytes + 1;
+  if (data_[0] & kTtlFlag) {
+    headerLen_ += sizeof(int64_t);
+  }
+
+  // Null flags
+  size_t numNullables = schema_->getNumNullableFields();
+  if (numNullables > 0) {
+    numNullBytes_ = ((numNullables - 1) >> 3) + 1;
+  } else {
+    numNullBytes_ = 0;
+  }
+
+  located_ = false;
+  return true;
+}
+
+bool RowReaderV3::isNull(size_t pos) const {
+  static const uint8_t bits[] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
+
+  size_t offset = headerLen_ + (pos >> 3);
+  int8_t flag = data_[offset] & bits[pos & 0x0000000000000007L];
+  return flag != 0;
+}
+
+void RowReaderV3::locate() const {
+  auto numFields = schema_->getNumFields();
+  offsets_.resize(numFields);
+  size_t offset = headerLen_ + numNullBytes_;
+  size_t end = data_.size() >= offset + sizeof(int64_t) ? data_.size() - sizeof(int64_t) : 0;
+  int64_t numBools = 0;
+  bool broken = false;
+  for (size_t i = 0; i < numFields; i++) {
+    auto field = schema_->field(i);
+    if (field->type() == PropertyType::BOOL) {
+      offsets_[i] = numBools++;
+    } else if (broken) {
+      offsets_[i] = kBadField;
+    } else if (field->nullable() && isNull(field->nullFlagPos())) {
+      offsets_[i] = kNullField;
+    } else {
+      offsets_[i] = offset;
+      if (!readField(data_, end, field->type(), offset, nullptr)) {
+        offsets_[i] = kBadField;
+        broken = true;
+      }
+    }
+  }
+  located_ = true;
+}
+
+Value RowReaderV3::getValueByName(const std::string& prop) const noexcept {
+  int64_t index = schema_->getFieldIndex(prop);
+  return getValueByIndex(index);
+}
+
+Value RowReaderV3::getValueByIndex(const int64_t index) const noexcept {
+  static const uint8_t bits[] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
+
+  if (index < 0 || static_cast<size_t>(index) >= schema_->getNumFields()) {
+    return Value(NullType::UNKNOWN_PROP);
+  }
+
+  auto field = schema_->field(index);
+  if (field->nullable() && isNull(field->nullFlagPos())) {
+    return NullType::__NULL__;
+  }
+  if (!located_) {
+    locate();
+  }
+
+  auto offset = offsets_[index];
+  if (field->type() == PropertyType::BOOL) {
+    // The bool flags are stored backwards before the timestamp
+    size_t back = sizeof(int64_t) + 1 + (offset >> 3);
+    if (headerLen_ + numNullBytes_ + back > data_.size()) {
+      return Value::kNullBadData;
+    }
+    return (data_[data_.size() - back] & bits[offset & 0x07]) != 0;
+  }
+  if (offset < 0) {
+    return Value::kNullBadData;
+  }
+
+  Value v;
+  size_t pos = offset;
+  if (!readField(data_, data_.size() - sizeof(int64_t), field->type(), pos, &v)) {
+    return Value::kNullBadData;
+  }
+  return v;
+}
+
+int64_t RowReaderV3::getTimestamp() const noexcept {
+  return *reinterpret_cast<const int64_t*>(data_.begin() + (data_.size() - sizeof(int64_t)));
+}
+
+}  // namespace nebula
@@ -0,0 +1,71 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef CODEC_ROWREADERV3_H_
+#define CODEC_ROWREADERV3_H_
+
+#include <gtest/gtest_prod.h>
+
+#include "codec/RowReader.h"
+#include "common/base/Base.h"
+#include "common/meta/SchemaProviderIf.h"
+
+namespace nebula {
+
+class RowReaderWrapper;
+
+/**
+ * This class decodes the data from version 3, see RowWriterV3 for the format. The properties are
+ * variable length, so the offsets of all properties are located by one scan of the row when a
+ * property is read for the first time.
+ */
+class RowReaderV3 : public RowReader {
+  friend class RowReaderWrapper;
+
+ public:
+  // The flag in the header indicating the value of the TTL column follows the schema version
+  static constexpr char kTtlFlag = 0x20;
+
+  ~RowReaderV3() override = default;
+
+  Value getValueByName(const std::string& prop) const noexcept override;
+  Value getValueByIndex(const int64_t index) const noexcept override;
+  int64_t getTimestamp() const noexcept override;
+
+  int32_t readerVer() const noexcept override {
+    return 3;
+  }
+
+  size_t headerLen() const noexcept override {
+    return headerLen_;
+  }
+
+ protected:
+  bool resetImpl(meta::SchemaProviderIf const* schema, folly::StringPiece row) noexcept override;
+
+ private:
+  // The offset of a property whose value is NULL
+  static constexpr int64_t kNullField = -1;
+  // The offset of a property which could not be located because the data is broken
+  static constexpr int64_t kBadField = -2;
+
+  size_t headerLen_;
+  size_t numNullBytes_;
+
+  // The offset of each property, or the sequence of the bool flag for BOOL properties
+  mutable std::vector<int64_t> offsets_;
+  mutable bool located_{false};
+
+  RowReaderV3() = default;
+
+  // Check whether the flag at the given position is set or not
+  bool isNull(size_t pos) const;
+
+  // Scan the row to locate all properties
+  void locate() const;
+};
+
+}  // namespace nebula
+#endif  // CODEC_ROWREADERV3_H_
@@ -88,6 +88,9 @@ RowReaderWrapper::RowReaderWrapper(const meta::SchemaProviderIf* schema,
   } else if (readerVer_ == 2) {
     readerV2_.resetImpl(schema, row);
     currReader_ = &readerV2_;
+  } else if (readerVer_ == 3) {
+    readerV3_.resetImpl(schema, row);
+    currReader_ = &readerV3_;
   } else {
     LOG(FATAL) << "Should not reach here";
   }
@@ -106,6 +109,10 @@ bool RowReaderWrapper::reset(meta::SchemaProviderIf const* schema,
     readerV2_.resetImpl(schema, row);
     currReader_ = &readerV2_;
     return true;
+  } else if (readerVer_ == 3) {
+    readerV3_.resetImpl(schema, row);
+    currReader_ = &readerV3_;
+    return true;
   } else {
     LOG(WARNING) << "Unsupported row reader version " << readerVer;
     currReader_ = nullptr;
@@ -165,7 +172,7 @@ void RowReaderWrapper::getVersions(const folly::StringPiece& row,
     // schema version. If the number is zero, no schema version
     // presents
     verBytes = row[index++] >> 5;
-  } else if (readerVer == 2) {
+  } else if (readerVer == 2 || readerVer == 3) {
     // The last three bits indicate the number of bytes for the
     // schema version. If the number is zero, no schema version
     // presents
@@ -191,4 +198,21 @@ void RowReaderWrapper::getVersions(const folly::StringPiece& row,
   return;
 }
 
+// static
+bool RowReaderWrapper::getTtlValue(folly::StringPiece row,
+                                   SchemaVer& schemaVer,
+                                   int64_t& ttlValue) {
+  if (row.empty() || ((row[0] & 0x18) >> 3) + 1 != 3 || (row[0] & RowReaderV3::kTtlFlag) == 0) {
+    return false;
+  }
+  size_t verBytes = row[0] & 0x07;
+  if (1 + verBytes + sizeof(int64_t) > row.size()) {
+    return false;
+  }
+  schemaVer = 0;
+  memcpy(reinterpret_cast<void*>(&schemaVer), &row[1], verBytes);
+  memcpy(reinterpret_cast<void*>(&ttlValue), &row[1 + verBytes], sizeof(int64_t));
+  return true;
+}
+
 }  // namespace nebula
@@ -10,12 +10,13 @@
 
 #include "codec/RowReaderV1.h"
 #include "codec/RowReaderV2.h"
+#include "codec/RowReaderV3.h"
 #include "common/base/Base.h"
 
 namespace nebula {
 
 /**
- * @brief A wrapper class to hide details of RowReaderV1 and RowReaderV2
+ * @brief A wrapper class to hide details of RowReaderV1, RowReaderV2 and RowReaderV3
  */
 class RowReaderWrapper : public RowReader {
   FRIEND_TEST(RowReaderV1, headerInfo);
@@ -42,6 +43,9 @@ class RowReaderWrapper : public RowReader {
     } else if (this->readerVer_ == 2) {
       this->readerV2_ = std::move(rhs.readerV2_);
       this->currReader_ = &(this->readerV2_);
+    } else if (this->readerVer_ == 3) {
+      this->readerV3_ = std::move(rhs.readerV3_);
+      this->currReader_ = &(this->readerV3_);
     } else {
       this->currReader_ = nullptr;
     }
@@ -61,6 +65,9 @@ class RowReaderWrapper : public RowReader {
     } else if (this->readerVer_ == 2) {
       this->readerV2_ = std::move(rhs.readerV2_);
       this->currReader_ = &(this->readerV2_);
+    } else if (this->readerVer_ == 3) {
+      this->readerV3_ = std::move(rhs.readerV3_);
+      this->currReader_ = &(this->readerV3_);
     } else {
       this->currReader_ = nullptr;
     }
@@ -217,6 +224,11 @@ class RowReaderWrapper : public RowReader {
     return currReader_->getData();
   }
 
+  folly::StringPiece getRawData() const noexcept override {
+    DCHECK(!!currReader_);
+    return currReader_->getRawData();
+  }
+
   /**
    * @brief Get schema version and reader version by data
    *
@@ -226,6 +238,17 @@ class RowReaderWrapper : public RowReader {
    */
   static void getVersions(const folly::StringPiece& row, SchemaVer& schemaVer, int32_t& readerVer);
 
+  /**
+   * @brief Get the value of the TTL column kept in the header of the row without decoding it, only
+   * the rows in version 3 keep it.
+   *
+   * @param row Row data
+   * @param schemaVer Schema version of the row
+   * @param ttlValue Value of the TTL column
+   * @return Whether the row keeps the value of the TTL column
+   */
+  static bool getTtlValue(folly::StringPiece row, SchemaVer& schemaVer, int64_t& ttlValue);
+
   /**
    * @brief Return whether wrapper points to a valid data
    */
@@ -285,6 +308,7 @@ class RowReaderWrapper : public RowReader {
  private:
   RowReaderV1 readerV1_;
   RowReaderV2 readerV2_;
+  RowReaderV3 readerV3_;
   RowReader* currReader_ = nullptr;
   int32_t readerVer_ = 0;
 };
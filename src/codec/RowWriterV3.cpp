@@ -0,0 +1,266 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "codec/RowWriterV3.h"
+
+#include "codec/RowReaderWrapper.h"
+#include "common/meta/NebulaSchemaProvider.h"
+#include "common/time/WallClock.h"
+
+namespace nebula {
+
+using nebula::cpp2::PropertyType;
+
+namespace {
+
+void writeVarint(std::string& buf, uint64_t v) {
+  uint8_t bytes[folly::kMaxVarintLength64];
+  size_t len = folly::encodeVarint(v, bytes);
+  buf.append(reinterpret_cast<const char*>(bytes), len);
+}
+
+void writeZigZag(std::string& buf, int64_t v) {
+  writeVarint(buf, folly::encodeZigZag(v));
+}
+
+void writeString(std::string& buf, folly::StringPiece v) {
+  writeVarint(buf, v.size());
+  buf.append(v.data(), v.size());
+}
+
+template <typename T>
+void writeFixed(std::string& buf, T v) {
+  buf.append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+// Append the value of the non-BOOL property to buf
+WriteResult writeField(std::string& buf, PropertyType type, const Value& v) {
+  switch (type) {
+    case PropertyType::INT8:
+    case PropertyType::INT16:
+    case PropertyType::INT32:
+    case PropertyType::INT64:
+    case PropertyType::TIMESTAMP: {
+      if (!v.isInt()) {
+        return WriteResult::TYPE_MISMATCH;
+      }
+      writeZigZag(buf, v.getInt());
+      return WriteResult::SUCCEEDED;
+    }
+    case PropertyType::FLOAT: {
+      if (!v.isFloat()) {
+        return WriteResult::TYPE_MISMATCH;
+      }
+      writeFixed(buf, static_cast<float>(v.getFloat()));
+      return WriteResult::SUCCEEDED;
+    }
+    case PropertyType::DOUBLE: {
+      if (!v.isFloat()) {
+        return WriteResult::TYPE_MISMATCH;
+      }
+      writeFixed(buf, v.getFloat());
+      return WriteResult::SUCCEEDED;
+    }
+    case PropertyType::VID: {
+      if (!v.isStr() || v.getStr().size() != sizeof(int64_t)) {
+        return WriteResult::TYPE_MISMATCH;
+      }
+      buf.append(v.getStr());
+      return WriteResult::SUCCEEDED;
+    }
+    case PropertyType::STRING:
+    case PropertyType::FIXED_STRING: {
+      if (!v.isStr()) {
+        return WriteResult::TYPE_MISMATCH;
+      }
+      writeString(buf, v.getStr());
+      return WriteResult::SUCCEEDED;
+    }
+    case PropertyType::GEOGRAPHY: {
+      if (v.empty()) {
+        writeVarint(buf, 0);
+        return WriteResult::SUCCEEDED;
+      }
+      if (!v.isGeography()) {
+        return WriteResult::TYPE_MISMATCH;
+      }
+      writeString(buf, v.getGeography().asWKB());
+      return WriteResult::SUCCEEDED;
+    }
+    case PropertyType::DATE: {
+      if (!v.isDate()) {
+        return WriteResult::TYPE_MISMATCH;
+      }
+      const auto& date = v.getDate();
+      writeZigZag(buf, date.year);
+      writeFixed(buf, date.month);
+      writeFixed(buf, date.day);
+      return WriteResult::SUCCEEDED;
+    }
+    case PropertyType::TIME: {
+      if (!v.isTime()) {
+        return WriteResult::TYPE_MISMATCH;
+      }
+      const auto& t = v.getTime();
+      writeFixed(buf, t.hour);
+      writeFixed(buf, t.minute);
+      writeFixed(buf, t.sec);
+      writeVarint(buf, t.microsec);
+      return WriteResult::SUCCEEDED;
+    }
+    case PropertyType::DATETIME: {
+      if (!v.isDateTime()) {
+        return WriteResult::TYPE_MISMATCH;
+      }
+      const auto& dt = v.getDateTime();
+      writeZigZag(buf, dt.year);
+      writeFixed(buf, static_cast<int8_t>(dt.month));
+      writeFixed(buf, static_cast<int8_t>(dt.day));
+      writeFixed(buf, static_cast<int8_t>(dt.hour));
+      writeFixed(buf, static_cast<int8_t>(dt.minute));
+      writeFixed(buf, static_cast<int8_t>(dt.sec));
+      writeVarint(buf, dt.microsec);
+      return WriteResult::SUCCEEDED;
+    }
+    case PropertyType::DURATION: {
+      if (!v.isDuration()) {
+        return WriteResult::TYPE_MISMATCH;
+      }
+      const auto& d = v.getDuration();
+      writeZigZag(buf, d.seconds);
+      writeZigZag(buf, d.microseconds);
+      writeZigZag(buf, d.months);
+      return WriteResult::SUCCEEDED;
+    }
+    case PropertyType::BOOL:
+    case PropertyType::UNKNOWN:
+      break;
+  }
+  return WriteResult::TYPE_MISMATCH;
+}
+
+// The value of the TTL column of the row, if the column is INT64 or TIMESTAMP and not NULL
+std::optional<int64_t> ttlValue(const meta::SchemaProviderIf* schema, const RowReader& reader) {
+  const auto* ns = dynamic_cast<const meta::NebulaSchemaProvider*>(schema);
+  if (ns == nullptr) {
+    return std::nullopt;
+  }
+  auto prop = ns->getProp();
+  if (prop.get_ttl_col() == nullptr || prop.get_ttl_col()->empty()) {
+    return std::nullopt;
+  }
+  const auto& col = *prop.get_ttl_col();
+  auto type = schema->getFieldType(col);
+  if (type != PropertyType::INT64 && type != PropertyType::TIMESTAMP) {
+    return std::nullopt;
+  }
+  auto v = reader.getValueByName(col);
+  if (!v.isInt()) {
+    return std::nullopt;
+  }
+  return v.getInt();
+}
+
+}  // namespace
+
+// static
+WriteResult RowWriterV3::encode(const RowReader& reader, std::string& encoded) {
+  static const uint8_t bits[] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
+
+  auto schema = reader.getSchema();
+  CHECK(!!schema);
+  std::string buf;
+  buf.reserve(reader.getRawData().size());
+
+  // Header and schema version, the same as V2 except the encoder version
+  int64_t ver = schema->getVersion();
+  size_t verBytes = 0;
+  while (verBytes < 8 && (ver >> (verBytes * 8)) > 0) {
+    verBytes++;
+  }
+  CHECK_LT(verBytes, 8UL) << "Schema version too big";
+  auto ttl = ttlValue(schema.get(), reader);
+  auto header = static_cast<char>(0x10 | verBytes);
+  if (ttl.has_value()) {
+    header |= RowReaderV3::kTtlFlag;
+  }
+  buf.append(1, header);
+  buf.append(reinterpret_cast<const char*>(&ver), verBytes);
+  if (ttl.has_value()) {
+    writeFixed(buf, ttl.value());
+  }
+
+  // Null flags
+  size_t nullOffset = buf.size();
+  size_t numNullables = schema->getNumNullableFields();
+  if (numNullables > 0) {
+    buf.append(((numNullables - 1) >> 3) + 1, '\0');
+  }
+
+  std::vector<uint8_t> boolFlags;
+  size_t numBools = 0;
+  for (size_t i = 0; i < schema->getNumFields(); i++) {
+    auto field = schema->field(i);
+    auto v = reader.getValueByIndex(i);
+    bool isBool = field->type() == PropertyType::BOOL;
+    if (isBool && (numBools & 0x07) == 0) {
+      boolFlags.emplace_back(0);
+    }
+    if (v.isNull()) {
+      if (!field->nullable()) {
+        return WriteResult::NOT_NULLABLE;
+      }
+      auto pos = field->nullFlagPos();
+      buf[nullOffset + (pos >> 3)] |= bits[pos & 0x07];
+    } else if (isBool) {
+      if (!v.isBool()) {
+        return WriteResult::TYPE_MISMATCH;
+      }
+      if (v.getBool()) {
+        boolFlags.back() |= bits[numBools & 0x07];
+      }
+    } else {
+      auto ret = writeField(buf, field->type(), v);
+      if (ret != WriteResult::SUCCEEDED) {
+        return ret;
+      }
+    }
+    if (isBool) {
+      numBools++;
+    }
+  }
+
+  // The bool flags are stored backwards
+  for (auto iter = boolFlags.rbegin(); iter != boolFlags.rend(); ++iter) {
+    buf.append(1, static_cast<char>(*iter));
+  }
+
+  // Keep the timestamp of the row, V1 rows don't have one
+  int64_t ts =
+      reader.readerVer() >= 2 ? reader.getTimestamp() : time::WallClock::fastNowInMicroSec();
+  writeFixed(buf, ts);
+
+  encoded = std::move(buf);
+  return WriteResult::SUCCEEDED;
+}
+
+// static
+WriteResult RowWriterV3::upgrade(const meta::SchemaProviderIf* schema, std::string& row) {
+  auto reader = RowReaderWrapper::getRowReader(schema, row);
+  if (reader == nullptr) {
+    return WriteResult::INCORRECT_VALUE;
+  }
+  if (reader->readerVer() >= 3) {
+    return WriteResult::SUCCEEDED;
+  }
+  std::string encoded;
+  auto ret = encode(*reader, encoded);
+  if (ret == WriteResult::SUCCEEDED) {
+    row = std::move(encoded);
+  }
+  return ret;
+}
+
+}  // namespace nebula
@@ -0,0 +1,86 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef CODEC_ROWWRITERV3_H_
+#define CODEC_ROWWRITERV3_H_
+
+#include "codec/RowReader.h"
+#include "codec/RowWriterV2.h"
+#include "common/base/Base.h"
+#include "common/meta/SchemaProviderIf.h"
+
+namespace nebula {
+
+/********************************************************************************
+
+  Encoder version 3
+
+  The purpose of this version is a compact row, so that more rows are kept in
+  the block cache and less data is read from disk. The rows are built by
+  RowWriterV2 as usual (which checks the values, fills the default values and
+  so on), and then re-encoded in version 3.
+
+  Version 3:
+                 0 0 t 1 0 v v v
+    The middle two bits indicate the encoder version, and the right three bits
+    indicate the number of bytes used for the schema version. The bit t
+    indicates whether the value of the TTL column follows the schema version
+
+  If the schema has a TTL column of INT64 or TIMESTAMP and its value is not
+  NULL, the value is kept after the schema version in 8 bytes, so that the
+  expired rows could be skipped without decoding them. The value is also
+  stored as a property as usual.
+
+  Unlike version 2, the properties are not fixed length. Only the properties
+  which are neither NULL nor BOOL are stored, in the order of the schema:
+        INT8/INT16/INT32/INT64/TIMESTAMP    (ZigZag varint)
+        FLOAT                               (4 bytes)
+        DOUBLE                              (8 bytes)
+        STRING/FIXED_STRING/GEOGRAPHY       (varint length + content) *
+        VID                                 (8 bytes)
+        DATE                                (varint year, month and day in one byte each)
+        TIME                                (hour, minute and sec in one byte each, varint microsec)
+        DATETIME                            (DATE + TIME)
+        DURATION                            (ZigZag varint seconds, microseconds and months)
+
+  * The GEOGRAPHY is stored in WKB
+
+  The NULL flags are the same as version 2. All BOOL properties are bit-packed
+  in the BOOL flags, one bit for each BOOL property no matter whether it's NULL.
+  The BOOL flags are stored backwards before the timestamp, i.e. the flag of the
+  i-th BOOL property (counted in the order of the schema) is in the byte at
+  (timestamp offset - 1 - (i >> 3)), so no count is needed to locate them.
+
+  Here is the overall byte sequence for the version 3 encoding
+
+    <header> <schema version> <TTL value> <NULL flags> <properties> <BOOL flags> <timestamp>
+       |             |             |            |             |            |           |
+     1 byte     0 - 7 bytes    0/8 bytes     0+ bytes      N bytes     0+ bytes     8 bytes
+
+********************************************************************************/
+class RowWriterV3 {
+ public:
+  /**
+   * @brief Encode all properties read by the reader in version 3, the reader could be in any
+   * version. The timestamp of the row is kept if the reader has one.
+   *
+   * @param reader Reader of the row to encode
+   * @param encoded The encoded row
+   * @return WriteResult
+   */
+  static WriteResult encode(const RowReader& reader, std::string& encoded);
+
+  /**
+   * @brief Re-encode the row in version 3 if it's encoded in an older version
+   *
+   * @param schema Schema of the row
+   * @param row The row to encode, it's replaced by the encoded one if succeeded
+   * @return WriteResult
+   */
+  static WriteResult upgrade(const meta::SchemaProviderIf* schema, std::string& row);
+};
+
+}  // namespace nebula
+#endif  // CODEC_ROWWRITERV3_H_
@@ -6,6 +6,7 @@
 #include <gtest/gtest.h>
 
 #include "codec/RowReaderWrapper.h"
+#include "codec/RowWriterV2.h"
 #include "codec/test/SchemaWriter.h"
 #include "common/base/Base.h"
 #include "common/datatypes/Value.h"
@@ -348,6 +349,45 @@ TEST(RowReaderV2, iterator) {
   EXPECT_EQ(64, index);
 }
 
+TEST(RowReaderV2, projection) {
+  SchemaWriter schema(3 /*Schema version*/);
+  schema.appendCol("Col01", PropertyType::BOOL);
+  schema.appendCol("Col02", PropertyType::INT64, 0, true);
+  schema.appendCol("Col03", PropertyType::STRING);
+  schema.appendCol("Col04", PropertyType::DOUBLE, 0, true);
+  schema.appendCol("Col05", PropertyType::FIXED_STRING, 8);
+
+  RowWriterV2 writer(&schema);
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(0, true));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.setNull(1));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(2, "Hello world"));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(3, 1.5));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(4, "fixed"));
+  ASSERT_EQ(WriteResult::SUCCEEDED, writer.finish());
+  std::string encoded = writer.moveEncodedStr();
+
+  // The projected fields are decoded in the given order, and the same as the reader returns
+  std::vector<std::string> fields = {"Col05", "Col03", "Missing", "Col02", "Col04"};
+  RowProjectionV2 projection(&schema, fields);
+  EXPECT_EQ(fields.size(), projection.numFields());
+  auto reader = RowReaderWrapper::getRowReader(&schema, encoded);
+  ASSERT_TRUE(!!reader);
+  std::vector<Value> values;
+  projection.decode(encoded, values);
+  ASSERT_EQ(fields.size(), values.size());
+  for (size_t i = 0; i < fields.size(); i++) {
+    EXPECT_EQ(reader->getValueByName(fields[i]), values[i]) << fields[i];
+  }
+  EXPECT_EQ("Hello world", values[1]);
+  EXPECT_EQ(NullType::UNKNOWN_PROP, values[2].getNull());
+  EXPECT_EQ(NullType::__NULL__, values[3].getNull());
+  EXPECT_EQ(1.5, values[4]);
+
+  // Values are appended
+  projection.decode(encoded, values);
+  EXPECT_EQ(2 * fields.size(), values.size());
+}
+
 }  // namespace nebula
 
 int main(int argc, char** argv) {
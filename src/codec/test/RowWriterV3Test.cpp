@@ -0,0 +1,193 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "codec/RowReaderWrapper.h"
+#include "codec/RowWriterV2.h"
+#include "codec/RowWriterV3.h"
+#include "codec/test/SchemaWriter.h"
+#include "common/base/Base.h"
+#include "common/meta/NebulaSchemaProvider.h"
+
+namespace nebula {
+
+using nebula::cpp2::PropertyType;
+
+namespace {
+
+void checkUpgrade(const SchemaWriter* schema, const std::string& v2Row) {
+  auto v2Reader = RowReaderWrapper::getRowReader(schema, v2Row);
+  ASSERT_TRUE(!!v2Reader);
+  ASSERT_EQ(2, v2Reader->readerVer());
+
+  std::string v3Row = v2Row;
+  ASSERT_EQ(WriteResult::SUCCEEDED, RowWriterV3::upgrade(schema, v3Row));
+  EXPECT_LT(v3Row.size(), v2Row.size());
+  auto v3Reader = RowReaderWrapper::getRowReader(schema, v3Row);
+  ASSERT_TRUE(!!v3Reader);
+  EXPECT_EQ(3, v3Reader->readerVer());
+  EXPECT_EQ(schema->getVersion(), v3Reader->schemaVer());
+  EXPECT_EQ(v2Reader->getTimestamp(), v3Reader->getTimestamp());
+  // Read the props randomly, then in order
+  for (int64_t i = schema->getNumFields() - 1; i >= 0; i--) {
+    EXPECT_EQ(v2Reader->getValueByIndex(i), v3Reader->getValueByIndex(i)) << i;
+  }
+  size_t index = 0;
+  for (auto it = v3Reader->begin(); it != v3Reader->end(); ++it) {
+    EXPECT_EQ(v2Reader->getValueByIndex(index++), it->value());
+  }
+  EXPECT_EQ(schema->getNumFields(), index);
+  EXPECT_EQ(NullType::UNKNOWN_PROP, v3Reader->getValueByName("Missing").getNull());
+
+  // The V3 row could be read by the V2 writer and upgraded again
+  RowWriterV2 writer(*v3Reader);
+  ASSERT_EQ(WriteResult::SUCCEEDED, writer.finish());
+  auto rewritten = writer.moveEncodedStr();
+  EXPECT_EQ(v2Row.substr(0, v2Row.size() - sizeof(int64_t)),
+            rewritten.substr(0, rewritten.size() - sizeof(int64_t)));
+  auto v3Row2 = v3Row;
+  ASSERT_EQ(WriteResult::SUCCEEDED, RowWriterV3::upgrade(schema, v3Row2));
+  EXPECT_EQ(v3Row, v3Row2);
+}
+
+}  // namespace
+
+TEST(RowWriterV3, AllTypes) {
+  SchemaWriter schema(300 /*Schema version*/);
+  schema.appendCol("Col01", PropertyType::BOOL);
+  schema.appendCol("Col02", PropertyType::INT8);
+  schema.appendCol("Col03", PropertyType::INT16);
+  schema.appendCol("Col04", PropertyType::INT32);
+  schema.appendCol("Col05", PropertyType::INT64);
+  schema.appendCol("Col06", PropertyType::FLOAT);
+  schema.appendCol("Col07", PropertyType::DOUBLE);
+  schema.appendCol("Col08", PropertyType::STRING);
+  schema.appendCol("Col09", PropertyType::FIXED_STRING, 12);
+  schema.appendCol("Col10", PropertyType::TIMESTAMP);
+  schema.appendCol("Col11", PropertyType::DATE);
+  schema.appendCol("Col12", PropertyType::TIME);
+  schema.appendCol("Col13", PropertyType::DATETIME);
+  schema.appendCol("Col14", PropertyType::BOOL, 0, true);
+  schema.appendCol("Col15", PropertyType::INT64, 0, true);
+  schema.appendCol("Col16", PropertyType::GEOGRAPHY);
+  schema.appendCol("Col17", PropertyType::DURATION);
+  schema.appendCol("Col18", PropertyType::STRING, 0, true);
+  schema.appendCol("Col19", PropertyType::BOOL);
+
+  RowWriterV2 writer(&schema);
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(0, true));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(1, -8));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(2, 16));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(3, -32));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(4, std::numeric_limits<int64_t>::min()));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(5, 3.14F));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(6, 2.71828));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(7, std::string("Hello world!")));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(8, std::string("Nebula")));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(9, 1582183355));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(10, Date(-2020, 2, 20)));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(11, Time(10, 30, 45, 999999)));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(12, DateTime(2020, 2, 20, 10, 30, 45, 123)));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.setNull(13));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.setNull(14));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(15, Geography(Point(Coordinate(179.0, 89.9)))));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(16, Duration(-1, 2, 3)));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(17, std::string()));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(18, false));
+  ASSERT_EQ(WriteResult::SUCCEEDED, writer.finish());
+  checkUpgrade(&schema, writer.moveEncodedStr());
+}
+
+TEST(RowWriterV3, ManyBools) {
+  // The bool flags take more than one byte
+  SchemaWriter schema;
+  for (int32_t i = 0; i < 20; i++) {
+    schema.appendCol(folly::stringPrintf("Bool%02d", i), PropertyType::BOOL, 0, i % 3 == 0);
+    schema.appendCol(folly::stringPrintf("Int%02d", i), PropertyType::INT64);
+  }
+  RowWriterV2 writer(&schema);
+  for (int32_t i = 0; i < 20; i++) {
+    if (i % 6 == 0) {
+      EXPECT_EQ(WriteResult::SUCCEEDED, writer.setNull(2 * i));
+    } else {
+      EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(2 * i, i % 2 == 1));
+    }
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(2 * i + 1, i * 100));
+  }
+  ASSERT_EQ(WriteResult::SUCCEEDED, writer.finish());
+  checkUpgrade(&schema, writer.moveEncodedStr());
+}
+
+TEST(RowWriterV3, BrokenData) {
+  SchemaWriter schema;
+  schema.appendCol("Col01", PropertyType::INT64);
+  schema.appendCol("Col02", PropertyType::STRING);
+  RowWriterV2 writer(&schema);
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(0, 1));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(1, std::string("Hello world!")));
+  ASSERT_EQ(WriteResult::SUCCEEDED, writer.finish());
+  auto row = writer.moveEncodedStr();
+  ASSERT_EQ(WriteResult::SUCCEEDED, RowWriterV3::upgrade(&schema, row));
+
+  // Remove some content of the string
+  auto broken = row.substr(0, 6) + row.substr(row.size() - sizeof(int64_t));
+  auto reader = RowReaderWrapper::getRowReader(&schema, broken);
+  ASSERT_TRUE(!!reader);
+  EXPECT_EQ(1, reader->getValueByIndex(0));
+  EXPECT_EQ(NullType::BAD_DATA, reader->getValueByIndex(1).getNull());
+}
+
+TEST(RowWriterV3, TtlValue) {
+  meta::NebulaSchemaProvider schema(3);
+  schema.addField("Col01", PropertyType::STRING);
+  schema.addField("Col02", PropertyType::TIMESTAMP, 0, true);
+  meta::cpp2::SchemaProp prop;
+  prop.ttl_col_ref() = "Col02";
+  prop.ttl_duration_ref() = 100;
+  schema.setProp(prop);
+
+  RowWriterV2 writer(&schema);
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(0, std::string("Hello world!")));
+  EXPECT_EQ(WriteResult::SUCCEEDED, writer.set(1, 1582183355));
+  ASSERT_EQ(WriteResult::SUCCEEDED, writer.finish());
+  auto row = writer.moveEncodedStr();
+  SchemaVer schemaVer = -1;
+  int64_t ttlValue = 0;
+  EXPECT_FALSE(RowReaderWrapper::getTtlValue(row, schemaVer, ttlValue));
+
+  // The value of the TTL column is kept in the header of the V3 row
+  ASSERT_EQ(WriteResult::SUCCEEDED, RowWriterV3::upgrade(&schema, row));
+  ASSERT_TRUE(RowReaderWrapper::getTtlValue(row, schemaVer, ttlValue));
+  EXPECT_EQ(3, schemaVer);
+  EXPECT_EQ(1582183355, ttlValue);
+  auto reader = RowReaderWrapper::getRowReader(&schema, row);
+  ASSERT_TRUE(!!reader);
+  EXPECT_EQ(3, reader->readerVer());
+  EXPECT_EQ("Hello world!", reader->getValueByIndex(0));
+  EXPECT_EQ(1582183355, reader->getValueByIndex(1));
+
+  // A NULL value is not kept
+  RowWriterV2 nullWriter(&schema);
+  EXPECT_EQ(WriteResult::SUCCEEDED, nullWriter.set(0, std::string("Hello world!")));
+  EXPECT_EQ(WriteResult::SUCCEEDED, nullWriter.setNull(1));
+  ASSERT_EQ(WriteResult::SUCCEEDED, nullWriter.finish());
+  auto nullRow = nullWriter.moveEncodedStr();
+  ASSERT_EQ(WriteResult::SUCCEEDED, RowWriterV3::upgrade(&schema, nullRow));
+  EXPECT_FALSE(RowReaderWrapper::getTtlValue(nullRow, schemaVer, ttlValue));
+  reader = RowReaderWrapper::getRowReader(&schema, nullRow);
+  ASSERT_TRUE(!!reader);
+  EXPECT_EQ(NullType::__NULL__, reader->getValueByIndex(1).getNull());
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+
+  return RUN_ALL_TESTS();
+}
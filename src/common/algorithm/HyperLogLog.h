@@ -0,0 +1,93 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_ALGORITHM_HYPERLOGLOG_H_
+#define COMMON_ALGORITHM_HYPERLOGLOG_H_
+
+#include <cmath>
+
+#include "common/base/Base.h"
+#include "common/base/MurmurHash2.h"
+
+namespace nebula {
+namespace algorithm {
+
+// Estimate the number of distinct values with a fixed amount of memory.
+//
+// Two sketches built over disjoint data sets could be merged into the sketch
+// of the union, so the distinct count could be computed by each part and then
+// combined. The standard error is about 1.04 / sqrt(kNumRegisters), i.e. ~3%.
+class HyperLogLog final {
+ public:
+  static constexpr uint32_t kPrecision = 10;
+  static constexpr size_t kNumRegisters = 1UL << kPrecision;
+
+  HyperLogLog() : registers_(kNumRegisters, 0) {}
+
+  // Restore the sketch from toBinary(), return an empty sketch if the data is invalid
+  static HyperLogLog fromBinary(const std::string& data) {
+    HyperLogLog hll;
+    if (data.size() == kNumRegisters) {
+      hll.registers_ = data;
+    }
+    return hll;
+  }
+
+  const std::string& toBinary() const {
+    return registers_;
+  }
+
+  void add(const char* data, size_t size) {
+    addHash(MurmurHash2()(data, size));
+  }
+
+  void addHash(uint64_t hash) {
+    auto idx = hash >> (64 - kPrecision);
+    auto w = hash << kPrecision;
+    uint8_t rank = w == 0 ? (64 - kPrecision + 1) : (__builtin_clzll(w) + 1);
+    auto& reg = reinterpret_cast<uint8_t&>(registers_[idx]);
+    if (reg < rank) {
+      reg = rank;
+    }
+  }
+
+  void merge(const HyperLogLog& other) {
+    for (size_t i = 0; i < kNumRegisters; ++i) {
+      auto& reg = reinterpret_cast<uint8_t&>(registers_[i]);
+      auto r = static_cast<uint8_t>(other.registers_[i]);
+      if (reg < r) {
+        reg = r;
+      }
+    }
+  }
+
+  uint64_t estimate() const {
+    constexpr double m = kNumRegisters;
+    constexpr double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (auto c : registers_) {
+      auto r = static_cast<uint8_t>(c);
+      sum += std::ldexp(1.0, -r);
+      if (r == 0) {
+        ++zeros;
+      }
+    }
+    double est = alpha * m * m / sum;
+    // Small range correction by linear counting
+    if (est <= 2.5 * m && zeros != 0) {
+      est = m * std::log(m / zeros);
+    }
+    return static_cast<uint64_t>(std::llround(est));
+  }
+
+ private:
+  // One byte per register, so that it could be stored as binary directly
+  std::string registers_;
+};
+
+}  // namespace algorithm
+}  // namespace nebula
+#endif  // COMMON_ALGORITHM_HYPERLOGLOG_H_
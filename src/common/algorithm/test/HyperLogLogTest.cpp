@@ -0,0 +1,56 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/algorithm/HyperLogLog.h"
+
+namespace nebula {
+namespace algorithm {
+
+TEST(HyperLogLogTest, Estimate) {
+  {
+    HyperLogLog hll;
+    EXPECT_EQ(0, hll.estimate());
+  }
+  {
+    HyperLogLog hll;
+    for (size_t i = 0; i < 100000; ++i) {
+      auto str = std::to_string(i % 100);
+      hll.add(str.data(), str.size());
+    }
+    EXPECT_NEAR(100, hll.estimate(), 5);
+  }
+  {
+    HyperLogLog hll;
+    for (size_t i = 0; i < 100000; ++i) {
+      auto str = std::to_string(i);
+      hll.add(str.data(), str.size());
+    }
+    EXPECT_NEAR(100000, hll.estimate(), 100000 * 0.1);
+  }
+}
+
+TEST(HyperLogLogTest, Merge) {
+  HyperLogLog lhs, rhs;
+  for (size_t i = 0; i < 20000; ++i) {
+    auto str = std::to_string(i);
+    if (i < 15000) {
+      lhs.add(str.data(), str.size());
+    }
+    if (i >= 5000) {
+      rhs.add(str.data(), str.size());
+    }
+  }
+  auto merged = HyperLogLog::fromBinary(lhs.toBinary());
+  merged.merge(rhs);
+  EXPECT_NEAR(20000, merged.estimate(), 20000 * 0.1);
+
+  auto invalid = HyperLogLog::fromBinary("invalid");
+  EXPECT_EQ(0, invalid.estimate());
+}
+
+}  // namespace algorithm
+}  // namespace nebula
@@ -9,9 +9,8 @@
 #include <folly/SpinLock.h>
 
 #include <boost/core/noncopyable.hpp>
-#include <functional>
-#include <list>
 #include <type_traits>
+#include <vector>
 
 #include "common/base/Arena.h"
 #include "common/base/Logging.h"
@@ -33,7 +32,11 @@ class ObjectPool final : private boost::noncopyable, private cpp::NonMovable {
 
   void clear() {
     SLGuard g(lock_);
+    for (auto &holder : objects_) {
+      holder.destroy(holder.obj);
+    }
     objects_.clear();
+    size_ = 0;
   }
 
   template <typename T, typename... Args>
@@ -41,38 +44,43 @@ class ObjectPool final : private boost::noncopyable, private cpp::NonMovable {
     lock_.lock();
     void *ptr = arena_.allocateAligned(sizeof(T));
     lock_.unlock();
+    // Constructed out of the lock, since the constructor may make other objects in the pool
     return add(new (ptr) T(std::forward<Args>(args)...));
   }
 
   bool empty() const {
-    return objects_.empty();
+    return size_ == 0;
   }
 
- private:
-  // Holder the ownership of the any object
-  class OwnershipHolder {
-   public:
-    template <typename T>
-    explicit OwnershipHolder(T *obj)
-        : obj_(obj), deleteFn_([](void *p) { reinterpret_cast<T *>(p)->~T(); }) {}
-
-    ~OwnershipHolder() {
-      deleteFn_(obj_);
-    }
+  size_t size() const {
+    return size_;
+  }
 
-   private:
-    void *obj_;
-    std::function<void(void *)> deleteFn_;
+ private:
+  // The object to destroy and its destructor, the memory is freed with the arena
+  struct OwnershipHolder {
+    void *obj;
+    void (*destroy)(void *);
   };
 
+  template <typename T>
+  static void destroy(void *obj) {
+    reinterpret_cast<T *>(obj)->~T();
+  }
+
   template <typename T>
   T *add(T *obj) {
     SLGuard g(lock_);
-    objects_.emplace_back(obj);
+    size_++;
+    // Nothing to do for the trivially destructible objects, such as the plain structs
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      objects_.emplace_back(OwnershipHolder{obj, &destroy<T>});
+    }
     return obj;
   }
 
-  std::list<OwnershipHolder> objects_;
+  std::vector<OwnershipHolder> objects_;
+  size_t size_{0};
   Arena arena_;
 
   folly::SpinLock lock_;
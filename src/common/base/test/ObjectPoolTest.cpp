@@ -33,4 +33,26 @@ TEST(ObjectPoolTest, TestPooling) {
   ASSERT_EQ(instances, 0);
 }
 
+TEST(ObjectPoolTest, TestTrivialObjects) {
+  struct Point {
+    int64_t x;
+    int64_t y;
+  };
+  static_assert(std::is_trivially_destructible_v<Point>);
+
+  ObjectPool pool;
+  for (int64_t i = 0; i < 10000; i++) {
+    auto *point = pool.makeAndAdd<Point>(Point{i, -i});
+    ASSERT_NE(point, nullptr);
+    ASSERT_EQ(i, point->x);
+    ASSERT_NE(pool.makeAndAdd<MyClass>(), nullptr);
+  }
+  ASSERT_EQ(20000, pool.size());
+  ASSERT_EQ(instances, 10000);
+
+  pool.clear();
+  ASSERT_TRUE(pool.empty());
+  ASSERT_EQ(instances, 0);
+}
+
 }  // namespace nebula
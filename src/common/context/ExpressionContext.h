@@ -15,6 +15,16 @@
 
 namespace nebula {
 
+// The position of a property in the rows of a result, resolved by the names once for the result
+// instead of for each row. The results are identified by the ids unique in the process.
+struct PropSlot {
+  uint64_t resultId{0};
+  // Whether the property is in the result
+  bool exists{false};
+  size_t col{0};
+  size_t prop{0};
+};
+
 /***************************************************************************
  *
  * The base class for all ExpressionContext implementations
@@ -45,6 +55,15 @@ class ExpressionContext {
   // Get the specified property from the tag, such as tag.prop_name
   virtual Value getTagProp(const std::string& tag, const std::string& prop) const = 0;
 
+  // The same as getTagProp, the position of the property is cached in the slot by the context
+  // which supports it
+  virtual Value getTagPropBySlot(const std::string& tag,
+                                 const std::string& prop,
+                                 PropSlot* slot) const {
+    UNUSED(slot);
+    return getTagProp(tag, prop);
+  }
+
   // Get the specified property from the source vertex, such as
   // $^.tag_name.prop_name
   virtual Value getSrcProp(const std::string& tag, const std::string& prop) const = 0;
@@ -0,0 +1,123 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_DATATYPES_COWPTR_H_
+#define COMMON_DATATYPES_COWPTR_H_
+
+#include <atomic>
+#include <memory>
+
+namespace nebula {
+
+/**
+ * A reference counted pointer to an immutable object, which is copied on the first write through
+ * a shared pointer. Copying the pointer only bumps the counter, so the large composite values
+ * (vertices, edges and paths) could be passed around without deep copies. Unlike std::shared_ptr,
+ * it's as small as a raw pointer since the counter is allocated together with the object, which
+ * keeps the size of Value unchanged.
+ *
+ * The members using the pointed object are defined inline, so they must be instantiated where T is
+ * a complete type.
+ */
+template <class T>
+class CowPtr final {
+ public:
+  CowPtr() = default;
+
+  explicit CowPtr(std::unique_ptr<T> v) : p_(v ? new Block(std::move(*v)) : nullptr) {}
+
+  CowPtr(const CowPtr& rhs) : p_(rhs.p_) {
+    if (p_ != nullptr) {
+      p_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  CowPtr(CowPtr&& rhs) noexcept : p_(rhs.p_) {
+    rhs.p_ = nullptr;
+  }
+
+  ~CowPtr() {
+    reset();
+  }
+
+  CowPtr& operator=(const CowPtr& rhs) {
+    if (this != &rhs) {
+      CowPtr(rhs).swap(*this);
+    }
+    return *this;
+  }
+
+  CowPtr& operator=(CowPtr&& rhs) noexcept {
+    if (this != &rhs) {
+      reset();
+      std::swap(p_, rhs.p_);
+    }
+    return *this;
+  }
+
+  template <class... Args>
+  static CowPtr make(Args&&... args) {
+    CowPtr ptr;
+    ptr.p_ = new Block(std::forward<Args>(args)...);
+    return ptr;
+  }
+
+  const T& operator*() const {
+    return p_->val;
+  }
+
+  const T* operator->() const {
+    return &p_->val;
+  }
+
+  const T* get() const {
+    return p_ == nullptr ? nullptr : &p_->val;
+  }
+
+  // Whether nobody else shares the object
+  bool unique() const {
+    return p_ != nullptr && p_->refs.load(std::memory_order_acquire) == 1;
+  }
+
+  // Get the object for writing, which is copied first if it's shared with others
+  T& mutableRef() {
+    if (!unique()) {
+      *this = make(p_->val);
+    }
+    return p_->val;
+  }
+
+  // Take the object away, which is only moved if it's not shared with others
+  T take() {
+    T v = unique() ? std::move(p_->val) : p_->val;
+    reset();
+    return v;
+  }
+
+  void reset() {
+    if (p_ != nullptr && p_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete p_;
+    }
+    p_ = nullptr;
+  }
+
+  void swap(CowPtr& rhs) noexcept {
+    std::swap(p_, rhs.p_);
+  }
+
+ private:
+  struct Block {
+    template <class... Args>
+    explicit Block(Args&&... args) : val(std::forward<Args>(args)...) {}
+
+    std::atomic<uint32_t> refs{1};
+    T val;
+  };
+
+  Block* p_{nullptr};
+};
+
+}  // namespace nebula
+#endif  // COMMON_DATATYPES_COWPTR_H_
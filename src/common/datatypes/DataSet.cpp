@@ -0,0 +1,266 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/datatypes/DataSet.h"
+
+namespace nebula {
+
+namespace {
+
+enum PackedType : uint8_t {
+  kNone = 0x00,
+  kBool = 0x01,
+  kInt = 0x02,
+  kFloat = 0x03,
+  kString = 0x04,
+};
+
+// Set in the tag of the column if some of its rows are NULL or EMPTY
+constexpr uint8_t kHasMissing = 0x80;
+
+enum RowKind : uint8_t {
+  kPresent = 0x00,
+  kNull = 0x01,
+  kEmpty = 0x02,
+};
+
+// The tags of the columns, return false if the rows could not be packed
+bool columnTags(const DataSet& ds, std::vector<uint8_t>* tags) {
+  if (ds.colNames.empty()) {
+    return false;
+  }
+  tags->assign(ds.colNames.size(), kNone);
+  for (const auto& row : ds.rows) {
+    if (row.values.size() != tags->size()) {
+      return false;
+    }
+    for (size_t i = 0; i < row.values.size(); i++) {
+      const auto& v = row.values[i];
+      uint8_t type = kNone;
+      switch (v.type()) {
+        case Value::Type::__EMPTY__:
+          (*tags)[i] |= kHasMissing;
+          continue;
+        case Value::Type::NULLVALUE:
+          if (v.getNull() != NullType::__NULL__) {
+            return false;
+          }
+          (*tags)[i] |= kHasMissing;
+          continue;
+        case Value::Type::BOOL:
+          type = kBool;
+          break;
+        case Value::Type::INT:
+          type = kInt;
+          break;
+        case Value::Type::FLOAT:
+          type = kFloat;
+          break;
+        case Value::Type::STRING:
+          type = kString;
+          break;
+        default:
+          return false;
+      }
+      auto current = (*tags)[i] & ~kHasMissing;
+      if (current == kNone) {
+        (*tags)[i] |= type;
+      } else if (current != type) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+RowKind kindOf(const Value& v) {
+  if (v.type() == Value::Type::__EMPTY__) {
+    return kEmpty;
+  }
+  return v.type() == Value::Type::NULLVALUE ? kNull : kPresent;
+}
+
+size_t sizeOf(uint8_t type, const Value& v) {
+  switch (type) {
+    case kBool:
+      return 1;
+    case kInt:
+    case kFloat:
+      return sizeof(int64_t);
+    case kString:
+      return sizeof(uint32_t) + v.getStr().size();
+    default:
+      return 0;
+  }
+}
+
+template <typename T>
+void append(std::string* packed, T v) {
+  packed->append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+bool read(folly::StringPiece* packed, T* v) {
+  if (packed->size() < sizeof(T)) {
+    return false;
+  }
+  memcpy(v, packed->data(), sizeof(T));
+  packed->advance(sizeof(T));
+  return true;
+}
+
+}  // namespace
+
+size_t DataSet::packedSize() const {
+  std::vector<uint8_t> tags;
+  if (!columnTags(*this, &tags)) {
+    return 0;
+  }
+  // The version and the number of rows
+  size_t size = 1 + sizeof(uint32_t);
+  for (size_t i = 0; i < tags.size(); i++) {
+    size += 1;
+    if (tags[i] & kHasMissing) {
+      size += rows.size();
+    }
+    auto type = tags[i] & ~kHasMissing;
+    for (const auto& row : rows) {
+      if (kindOf(row.values[i]) == kPresent) {
+        size += sizeOf(type, row.values[i]);
+      }
+    }
+  }
+  return size;
+}
+
+bool DataSet::pack(std::string* packed) const {
+  std::vector<uint8_t> tags;
+  if (!columnTags(*this, &tags)) {
+    return false;
+  }
+  packed->clear();
+  packed->reserve(packedSize());
+  append<uint8_t>(packed, kPackedVersion);
+  append<uint32_t>(packed, rows.size());
+  for (size_t i = 0; i < tags.size(); i++) {
+    append<uint8_t>(packed, tags[i]);
+    if (tags[i] & kHasMissing) {
+      for (const auto& row : rows) {
+        append<uint8_t>(packed, kindOf(row.values[i]));
+      }
+    }
+    auto type = tags[i] & ~kHasMissing;
+    for (const auto& row : rows) {
+      const auto& v = row.values[i];
+      if (kindOf(v) != kPresent) {
+        continue;
+      }
+      switch (type) {
+        case kBool:
+          append<uint8_t>(packed, v.getBool());
+          break;
+        case kInt:
+          append<int64_t>(packed, v.getInt());
+          break;
+        case kFloat:
+          append<double>(packed, v.getFloat());
+          break;
+        case kString:
+          append<uint32_t>(packed, v.getStr().size());
+          packed->append(v.getStr());
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  return true;
+}
+
+bool DataSet::unpack(folly::StringPiece packed) {
+  uint8_t version = 0;
+  uint32_t numRows = 0;
+  if (!read(&packed, &version) || version != kPackedVersion || !read(&packed, &numRows)) {
+    return false;
+  }
+  // Each row takes at least one byte in each column
+  if (colNames.empty() || numRows > packed.size()) {
+    return false;
+  }
+  rows.clear();
+  rows.resize(numRows);
+  for (auto& row : rows) {
+    row.values.resize(colNames.size());
+  }
+  std::vector<uint8_t> kinds;
+  for (size_t i = 0; i < colNames.size(); i++) {
+    uint8_t tag = 0;
+    if (!read(&packed, &tag)) {
+      return false;
+    }
+    kinds.assign(numRows, kPresent);
+    if (tag & kHasMissing) {
+      if (packed.size() < numRows) {
+        return false;
+      }
+      memcpy(kinds.data(), packed.data(), numRows);
+      packed.advance(numRows);
+    }
+    auto type = tag & ~kHasMissing;
+    for (size_t r = 0; r < numRows; r++) {
+      auto& v = rows[r].values[i];
+      if (kinds[r] == kNull) {
+        v = Value::kNullValue;
+        continue;
+      }
+      if (kinds[r] == kEmpty) {
+        continue;
+      }
+      if (kinds[r] != kPresent) {
+        return false;
+      }
+      switch (type) {
+        case kBool: {
+          uint8_t b = 0;
+          if (!read(&packed, &b)) {
+            return false;
+          }
+          v = static_cast<bool>(b);
+          break;
+        }
+        case kInt: {
+          int64_t n = 0;
+          if (!read(&packed, &n)) {
+            return false;
+          }
+          v = n;
+          break;
+        }
+        case kFloat: {
+          double d = 0;
+          if (!read(&packed, &d)) {
+            return false;
+          }
+          v = d;
+          break;
+        }
+        case kString: {
+          uint32_t len = 0;
+          if (!read(&packed, &len) || packed.size() < len) {
+            return false;
+          }
+          v = std::string(packed.data(), len);
+          packed.advance(len);
+          break;
+        }
+        default:
+          return false;
+      }
+    }
+  }
+  return packed.empty();
+}
+
+}  // namespace nebula
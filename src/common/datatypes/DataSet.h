@@ -6,6 +6,7 @@
 #ifndef COMMON_DATATYPES_DATASET_H_
 #define COMMON_DATATYPES_DATASET_H_
 
+#include <folly/Range.h>
 #include <folly/dynamic.h>
 
 #include <iostream>
@@ -21,23 +22,32 @@ namespace nebula {
 using Row = List;
 
 struct DataSet {
+  // The version of the packed encoding of the rows, see pack
+  static constexpr int32_t kPackedVersion = 1;
+
   std::vector<std::string> colNames;
   std::vector<Row> rows;
+  // Whether the rows are written by thrift in the packed encoding if they could be packed. It's
+  // not serialized, and only set when the reader is known to read the encoding.
+  bool writePacked{false};
 
   DataSet() = default;
   explicit DataSet(std::vector<std::string> columns) : colNames(std::move(columns)) {}
   DataSet(const DataSet& ds) noexcept {
     colNames = ds.colNames;
     rows = ds.rows;
+    writePacked = ds.writePacked;
   }
   DataSet(DataSet&& ds) noexcept {
     colNames = std::move(ds.colNames);
     rows = std::move(ds.rows);
+    writePacked = ds.writePacked;
   }
   DataSet& operator=(const DataSet& ds) noexcept {
     if (&ds != this) {
       colNames = ds.colNames;
       rows = ds.rows;
+      writePacked = ds.writePacked;
     }
     return *this;
   }
@@ -45,6 +55,7 @@ struct DataSet {
     if (&ds != this) {
       colNames = std::move(ds.colNames);
       rows = std::move(ds.rows);
+      writePacked = ds.writePacked;
     }
     return *this;
   }
@@ -212,6 +223,19 @@ struct DataSet {
     return rowJsonObj;
   }
 
+  // Encode the rows by columns, each of which is of a single type of bool, int, float or string,
+  // besides NULL and EMPTY. Each column has a one byte tag of its type, followed by the kinds of
+  // its rows if some of them are NULL or EMPTY, and the values of the other rows in a contiguous
+  // array, instead of a header for each value as in thrift. Return false if the rows could not be
+  // packed.
+  bool pack(std::string* packed) const;
+
+  // The bytes of the packed rows, 0 if they could not be packed
+  size_t packedSize() const;
+
+  // Decode the packed rows of the columns already set, return false if they are corrupted
+  bool unpack(folly::StringPiece packed);
+
   bool operator==(const DataSet& rhs) const {
     return colNames == rhs.colNames && rows == rhs.rows;
   }
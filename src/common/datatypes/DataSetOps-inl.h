@@ -35,6 +35,9 @@ struct TccStructTraits<nebula::DataSet> {
     } else if (_fname == "rows") {
       fid = 2;
       _ftype = apache::thrift::protocol::T_LIST;
+    } else if (_fname == "packed_rows") {
+      fid = 3;
+      _ftype = apache::thrift::protocol::T_STRING;
     }
   }
 };
@@ -55,10 +58,18 @@ uint32_t Cpp2Ops<nebula::DataSet>::write(Protocol* proto, nebula::DataSet const*
                                        std::vector<std::string>>::write(*proto, obj->colNames);
   xfer += proto->writeFieldEnd();
 
-  xfer += proto->writeFieldBegin("rows", apache::thrift::protocol::T_LIST, 2);
-  xfer += detail::pm::protocol_methods<type_class::list<type_class::structure>,
-                                       std::vector<nebula::Row>>::write(*proto, obj->rows);
-  xfer += proto->writeFieldEnd();
+  // The packed rows are written instead of the rows if the reader reads them
+  std::string packed;
+  if (obj->writePacked && obj->pack(&packed)) {
+    xfer += proto->writeFieldBegin("packed_rows", protocol::T_STRING, 3);
+    xfer += proto->writeBinary(packed);
+    xfer += proto->writeFieldEnd();
+  } else {
+    xfer += proto->writeFieldBegin("rows", apache::thrift::protocol::T_LIST, 2);
+    xfer += detail::pm::protocol_methods<type_class::list<type_class::structure>,
+                                         std::vector<nebula::Row>>::write(*proto, obj->rows);
+    xfer += proto->writeFieldEnd();
+  }
 
   xfer += proto->writeFieldStop();
   xfer += proto->writeStructEnd();
@@ -102,6 +113,20 @@ _end:
 
   return;
 
+_readField_packed_rows : {
+  std::string packed;
+  proto->readBinary(packed);
+  if (!obj->unpack(packed)) {
+    throw protocol::TProtocolException(protocol::TProtocolException::INVALID_DATA,
+                                       "Invalid packed rows of DataSet");
+  }
+}
+
+  if (UNLIKELY(!readState.advanceToNextField(proto, 3, 0, protocol::T_STOP))) {
+    goto _loop;
+  }
+  goto _end;
+
 _loop:
   if (readState.fieldType == apache::thrift::protocol::T_STOP) {
     goto _end;
@@ -127,6 +152,13 @@ _loop:
         goto _skip;
       }
     }
+    case 3: {
+      if (LIKELY(readState.fieldType == apache::thrift::protocol::T_STRING)) {
+        goto _readField_packed_rows;
+      } else {
+        goto _skip;
+      }
+    }
     default: {
 _skip:
       proto->skip(readState.fieldType);
@@ -149,10 +181,17 @@ uint32_t Cpp2Ops<nebula::DataSet>::serializedSize(Protocol const* proto,
                                    std::vector<std::string>>::serializedSize<false>(*proto,
                                                                                     obj->colNames);
 
-  xfer += proto->serializedFieldSize("rows", apache::thrift::protocol::T_LIST, 2);
-  xfer += detail::pm::protocol_methods<type_class::list<type_class::structure>,
-                                       std::vector<nebula::Row>>::serializedSize<false>(*proto,
-                                                                                        obj->rows);
+  auto packedSize = obj->writePacked ? obj->packedSize() : 0;
+  if (packedSize > 0) {
+    xfer += proto->serializedFieldSize("packed_rows", protocol::T_STRING, 3);
+    xfer += proto->serializedSizeI32() + packedSize;
+  } else {
+    xfer += proto->serializedFieldSize("rows", apache::thrift::protocol::T_LIST, 2);
+    xfer +=
+        detail::pm::protocol_methods<type_class::list<type_class::structure>,
+                                     std::vector<nebula::Row>>::serializedSize<false>(*proto,
+                                                                                      obj->rows);
+  }
 
   xfer += proto->serializedSizeStop();
   return xfer;
@@ -170,10 +209,17 @@ uint32_t Cpp2Ops<nebula::DataSet>::serializedSizeZC(Protocol const* proto,
                                    std::vector<std::string>>::serializedSize<false>(*proto,
                                                                                     obj->colNames);
 
-  xfer += proto->serializedFieldSize("rows", protocol::T_LIST, 2);
-  xfer += detail::pm::protocol_methods<type_class::list<type_class::structure>,
-                                       std::vector<nebula::Row>>::serializedSize<false>(*proto,
-                                                                                        obj->rows);
+  auto packedSize = obj->writePacked ? obj->packedSize() : 0;
+  if (packedSize > 0) {
+    xfer += proto->serializedFieldSize("packed_rows", protocol::T_STRING, 3);
+    xfer += proto->serializedSizeI32() + packedSize;
+  } else {
+    xfer += proto->serializedFieldSize("rows", apache::thrift::protocol::T_LIST, 2);
+    xfer +=
+        detail::pm::protocol_methods<type_class::list<type_class::structure>,
+                                     std::vector<nebula::Row>>::serializedSize<false>(*proto,
+                                                                                      obj->rows);
+  }
 
   xfer += proto->serializedSizeStop();
   return xfer;
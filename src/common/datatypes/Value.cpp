@@ -89,6 +89,56 @@ std::size_t hash<nebula::Value>::operator()(const nebula::Value& v) const noexce
 
 namespace nebula {
 
+namespace {
+
+// The strings of the values freed by a thread are kept with their buffers, so the strings made
+// later by the thread need no allocation, most of them are short vids, names and properties.
+// Value keeps 16 bytes and hands out std::string references, so the string can't be inline.
+constexpr size_t kMaxCachedStrings = 256;
+constexpr size_t kMaxCachedCapacity = 64;
+
+// Trivially destructible, so it is still accessible while the thread local objects are destroyed
+struct StringCache {
+  std::string* strings[kMaxCachedStrings];
+  size_t size;
+  bool closed;
+};
+
+thread_local StringCache stringCache;
+
+// Free the strings cached when the thread exits
+struct StringCacheCloser {
+  ~StringCacheCloser() {
+    stringCache.closed = true;
+    while (stringCache.size > 0) {
+      delete stringCache.strings[--stringCache.size];
+    }
+  }
+};
+
+std::string* newString() {
+  if (stringCache.size > 0) {
+    return stringCache.strings[--stringCache.size];
+  }
+  return new std::string();
+}
+
+void deleteString(std::string* str) {
+  if (str == nullptr) {
+    return;
+  }
+  if (stringCache.closed || stringCache.size >= kMaxCachedStrings ||
+      str->capacity() > kMaxCachedCapacity) {
+    delete str;
+    return;
+  }
+  static thread_local StringCacheCloser closer;
+  str->clear();
+  stringCache.strings[stringCache.size++] = str;
+}
+
+}  // namespace
+
 const Value Value::kEmpty;
 const Value Value::kNullValue(NullType::__NULL__);
 const Value Value::kNullNaN(NullType::NaN);
@@ -907,17 +957,17 @@ DateTime& Value::mutableDateTime() {
 
 Vertex& Value::mutableVertex() {
   CHECK_EQ(type_, Type::VERTEX);
-  return *(value_.vVal);
+  return value_.vVal.mutableRef();
 }
 
 Edge& Value::mutableEdge() {
   CHECK_EQ(type_, Type::EDGE);
-  return *(value_.eVal);
+  return value_.eVal.mutableRef();
 }
 
 Path& Value::mutablePath() {
   CHECK_EQ(type_, Type::PATH);
-  return *(value_.pVal);
+  return value_.pVal.mutableRef();
 }
 
 List& Value::mutableList() {
@@ -1008,21 +1058,21 @@ DateTime Value::moveDateTime() {
 
 Vertex Value::moveVertex() {
   CHECK_EQ(type_, Type::VERTEX);
-  Vertex v = std::move(*(value_.vVal));
+  Vertex v = value_.vVal.take();
   clear();
   return v;
 }
 
 Edge Value::moveEdge() {
   CHECK_EQ(type_, Type::EDGE);
-  Edge v = std::move(*(value_.eVal));
+  Edge v = value_.eVal.take();
   clear();
   return v;
 }
 
 Path Value::movePath() {
   CHECK_EQ(type_, Type::PATH);
-  Path v = std::move(*(value_.pVal));
+  Path v = value_.pVal.take();
   clear();
   return v;
 }
@@ -1091,6 +1141,7 @@ void Value::clear() {
       break;
     }
     case Type::STRING: {
+      deleteString(value_.sVal.release());
       destruct(value_.sVal);
       break;
     }
@@ -1365,17 +1416,28 @@ void Value::setS(std::unique_ptr<std::string> v) {
 
 void Value::setS(const std::string& v) {
   type_ = Type::STRING;
-  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(new std::string(v));
+  auto* str = newString();
+  str->assign(v);
+  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(str);
 }
 
 void Value::setS(std::string&& v) {
   type_ = Type::STRING;
-  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(new std::string(std::move(v)));
+  auto* str = newString();
+  // Keep the cached buffer if it fits, rather than taking the one of v
+  if (v.size() <= str->capacity()) {
+    str->assign(v);
+  } else {
+    *str = std::move(v);
+  }
+  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(str);
 }
 
 void Value::setS(const char* v) {
   type_ = Type::STRING;
-  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(new std::string(v));
+  auto* str = newString();
+  str->assign(v);
+  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(str);
 }
 
 void Value::setD(const Date& v) {
@@ -1408,64 +1470,79 @@ void Value::setDT(DateTime&& v) {
   new (std::addressof(value_.dtVal)) DateTime(std::move(v));
 }
 
-void Value::setV(const std::unique_ptr<Vertex>& v) {
+void Value::setV(const CowPtr<Vertex>& v) {
   type_ = Type::VERTEX;
-  new (std::addressof(value_.vVal)) std::unique_ptr<Vertex>(new Vertex(*v));
+  new (std::addressof(value_.vVal)) CowPtr<Vertex>(v);
+}
+
+void Value::setV(CowPtr<Vertex>&& v) {
+  type_ = Type::VERTEX;
+  new (std::addressof(value_.vVal)) CowPtr<Vertex>(std::move(v));
 }
 
 void Value::setV(std::unique_ptr<Vertex>&& v) {
   type_ = Type::VERTEX;
-  new (std::addressof(value_.vVal)) std::unique_ptr<Vertex>(std::move(v));
+  new (std::addressof(value_.vVal)) CowPtr<Vertex>(std::move(v));
 }
 
 void Value::setV(const Vertex& v) {
   type_ = Type::VERTEX;
-  new (std::addressof(value_.vVal)) std::unique_ptr<Vertex>(new Vertex(v));
+  new (std::addressof(value_.vVal)) CowPtr<Vertex>(CowPtr<Vertex>::make(v));
 }
 
 void Value::setV(Vertex&& v) {
   type_ = Type::VERTEX;
-  new (std::addressof(value_.vVal)) std::unique_ptr<Vertex>(new Vertex(std::move(v)));
+  new (std::addressof(value_.vVal)) CowPtr<Vertex>(CowPtr<Vertex>::make(std::move(v)));
+}
+
+void Value::setE(const CowPtr<Edge>& v) {
+  type_ = Type::EDGE;
+  new (std::addressof(value_.eVal)) CowPtr<Edge>(v);
 }
 
-void Value::setE(const std::unique_ptr<Edge>& v) {
+void Value::setE(CowPtr<Edge>&& v) {
   type_ = Type::EDGE;
-  new (std::addressof(value_.eVal)) std::unique_ptr<Edge>(new Edge(*v));
+  new (std::addressof(value_.eVal)) CowPtr<Edge>(std::move(v));
 }
 
 void Value::setE(std::unique_ptr<Edge>&& v) {
   type_ = Type::EDGE;
-  new (std::addressof(value_.eVal)) std::unique_ptr<Edge>(std::move(v));
+  new (std::addressof(value_.eVal)) CowPtr<Edge>(std::move(v));
 }
 
 void Value::setE(const Edge& v) {
   type_ = Type::EDGE;
-  new (std::addressof(value_.eVal)) std::unique_ptr<Edge>(new Edge(v));
+  new (std::addressof(value_.eVal)) CowPtr<Edge>(CowPtr<Edge>::make(v));
 }
 
 void Value::setE(Edge&& v) {
   type_ = Type::EDGE;
-  new (std::addressof(value_.eVal)) std::unique_ptr<Edge>(new Edge(std::move(v)));
+  new (std::addressof(value_.eVal)) CowPtr<Edge>(CowPtr<Edge>::make(std::move(v)));
+}
+
+void Value::setP(const CowPtr<Path>& v) {
+  type_ = Type::PATH;
+  new (std::addressof(value_.pVal)) CowPtr<Path>(v);
 }
 
-void Value::setP(const std::unique_ptr<Path>& v) {
+void Value::setP(CowPtr<Path>&& v) {
   type_ = Type::PATH;
-  new (std::addressof(value_.pVal)) std::unique_ptr<Path>(new Path(*v));
+  new (std::addressof(value_.pVal)) CowPtr<Path>(std::move(v));
 }
 
 void Value::setP(std::unique_ptr<Path>&& v) {
   type_ = Type::PATH;
-  new (std::addressof(value_.pVal)) std::unique_ptr<Path>(std::move(v));
+  new (std::addressof(value_.pVal)) CowPtr<Path>(std::move(v));
 }
 
 void Value::setP(const Path& v) {
   type_ = Type::PATH;
-  new (std::addressof(value_.pVal)) std::unique_ptr<Path>(new Path(v));
+  new (std::addressof(value_.pVal)) CowPtr<Path>(CowPtr<Path>::make(v));
 }
 
 void Value::setP(Path&& v) {
   type_ = Type::PATH;
-  new (std::addressof(value_.pVal)) std::unique_ptr<Path>(new Path(std::move(v)));
+  new (std::addressof(value_.pVal)) CowPtr<Path>(CowPtr<Path>::make(std::move(v)));
 }
 
 void Value::setL(const std::unique_ptr<List>& v) {
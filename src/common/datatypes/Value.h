@@ -10,6 +10,7 @@
 
 #include <memory>
 
+#include "common/datatypes/CowPtr.h"
 #include "common/datatypes/Date.h"
 #include "common/datatypes/Duration.h"
 #include "common/thrift/ThriftTypes.h"
@@ -371,9 +372,9 @@ struct Value {
     Date dVal;
     Time tVal;
     DateTime dtVal;
-    std::unique_ptr<Vertex> vVal;
-    std::unique_ptr<Edge> eVal;
-    std::unique_ptr<Path> pVal;
+    CowPtr<Vertex> vVal;
+    CowPtr<Edge> eVal;
+    CowPtr<Path> pVal;
     std::unique_ptr<List> lVal;
     std::unique_ptr<Map> mVal;
     std::unique_ptr<Set> uVal;
@@ -417,17 +418,20 @@ struct Value {
   void setDT(const DateTime& v);
   void setDT(DateTime&& v);
   // Vertex value
-  void setV(const std::unique_ptr<Vertex>& v);
+  void setV(const CowPtr<Vertex>& v);
+  void setV(CowPtr<Vertex>&& v);
   void setV(std::unique_ptr<Vertex>&& v);
   void setV(const Vertex& v);
   void setV(Vertex&& v);
   // Edge value
-  void setE(const std::unique_ptr<Edge>& v);
+  void setE(const CowPtr<Edge>& v);
+  void setE(CowPtr<Edge>&& v);
   void setE(std::unique_ptr<Edge>&& v);
   void setE(const Edge& v);
   void setE(Edge&& v);
   // Path value
-  void setP(const std::unique_ptr<Path>& v);
+  void setP(const CowPtr<Path>& v);
+  void setP(CowPtr<Path>&& v);
   void setP(std::unique_ptr<Path>&& v);
   void setP(const Path& v);
   void setP(Path&& v);
@@ -4,8 +4,10 @@
  */
 
 #include <gtest/gtest.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include "common/base/Base.h"
+#include "common/datatypes/CommonCpp2Ops.h"
 #include "common/datatypes/DataSet.h"
 
 TEST(DataSetTest, Basic) {
@@ -39,6 +41,53 @@ TEST(DataSetTest, Basic) {
   EXPECT_EQ(data, data4);
 }
 
+TEST(DataSetTest, Packed) {
+  nebula::DataSet data({"bool", "int", "float", "string", "missing"});
+  data.emplace_back(nebula::Row({true, 1, 1.5, "a", nebula::Value::kNullValue}));
+  data.emplace_back(nebula::Row({false, nebula::Value::kNullValue, 2.5, "", nebula::Value()}));
+  data.emplace_back(nebula::Row({nebula::Value(), 3, -0.5, "abc", nebula::Value::kNullValue}));
+
+  std::string packed;
+  ASSERT_TRUE(data.pack(&packed));
+  EXPECT_EQ(data.packedSize(), packed.size());
+  nebula::DataSet unpacked(data.colNames);
+  ASSERT_TRUE(unpacked.unpack(packed));
+  EXPECT_EQ(data, unpacked);
+  EXPECT_FALSE(unpacked.unpack(packed.substr(0, packed.size() - 1)));
+
+  // Read either of the encodings, the packed one is only written if it's asked
+  for (auto writePacked : {false, true}) {
+    data.writePacked = writePacked;
+    std::string encoded;
+    apache::thrift::CompactSerializer::serialize(data, &encoded);
+    nebula::DataSet decoded;
+    apache::thrift::CompactSerializer::deserialize(encoded, decoded);
+    EXPECT_EQ(data, decoded);
+    EXPECT_FALSE(decoded.writePacked);
+    if (writePacked) {
+      EXPECT_NE(std::string::npos, encoded.find(packed));
+    }
+  }
+
+  // The rows of the values not primitive, of the mixed types, or of the other kinds of null are
+  // written as they are
+  for (const auto& value : {nebula::Value(nebula::List({1})),
+                            nebula::Value("mixed"),
+                            nebula::Value::kNullBadType}) {
+    nebula::DataSet mixed({"col"});
+    mixed.emplace_back(nebula::Row({1}));
+    mixed.emplace_back(nebula::Row({value}));
+    EXPECT_FALSE(mixed.pack(&packed));
+    EXPECT_EQ(0, mixed.packedSize());
+    mixed.writePacked = true;
+    std::string encoded;
+    apache::thrift::CompactSerializer::serialize(mixed, &encoded);
+    nebula::DataSet decoded;
+    apache::thrift::CompactSerializer::deserialize(encoded, decoded);
+    EXPECT_EQ(mixed, decoded);
+  }
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   folly::init(&argc, &argv, true);
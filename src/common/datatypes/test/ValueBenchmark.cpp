@@ -111,6 +111,48 @@ BENCHMARK(HashIntValue, n) {
   }
 }
 
+BENCHMARK_DRAW_LINE();
+
+// Make and free the string values, of which the strings are recycled
+BENCHMARK(MakeShortStringValue, n) {
+  std::vector<std::string> strings;
+  BENCHMARK_SUSPEND {
+    for (size_t i = 0; i < 1000; i++) {
+      strings.emplace_back(randomString(10));
+    }
+  }
+  for (size_t i = 0; i < n; i++) {
+    std::vector<Value> values(strings.begin(), strings.end());
+    folly::doNotOptimizeAway(values);
+  }
+}
+
+BENCHMARK(MakeLongStringValue, n) {
+  std::vector<std::string> strings;
+  BENCHMARK_SUSPEND {
+    for (size_t i = 0; i < 1000; i++) {
+      strings.emplace_back(randomString(40));
+    }
+  }
+  for (size_t i = 0; i < n; i++) {
+    std::vector<Value> values(strings.begin(), strings.end());
+    folly::doNotOptimizeAway(values);
+  }
+}
+
+BENCHMARK(CopyStringValue, n) {
+  std::vector<Value> values;
+  BENCHMARK_SUSPEND {
+    for (size_t i = 0; i < 1000; i++) {
+      values.emplace_back(randomString(20));
+    }
+  }
+  for (size_t i = 0; i < n; i++) {
+    auto copied = values;
+    folly::doNotOptimizeAway(copied);
+  }
+}
+
 int main() {
   folly::runBenchmarks();
   return 0;
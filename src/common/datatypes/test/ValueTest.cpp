@@ -1631,6 +1631,34 @@ TEST(Value, Ctor) {
   // Value v2(&tmp);
 }
 
+TEST(Value, CopyOnWrite) {
+  Value v1(Vertex("v1", {Tag("tag", {{"prop", 1}})}));
+  Value v2 = v1;
+  // The copy shares the vertex until it's written
+  EXPECT_EQ(v1.getVertexPtr(), v2.getVertexPtr());
+  v2.mutableVertex().tags[0].props["prop"] = 2;
+  EXPECT_NE(v1.getVertexPtr(), v2.getVertexPtr());
+  EXPECT_EQ(Value(1), v1.getVertex().tags[0].props.at("prop"));
+  EXPECT_EQ(Value(2), v2.getVertex().tags[0].props.at("prop"));
+
+  // The unshared edge is written in place
+  Value e1(Edge("src", "dst", 1, "edge", 0, {}));
+  const auto* ptr = e1.getEdgePtr();
+  e1.mutableEdge().props.emplace("prop", 3);
+  EXPECT_EQ(ptr, e1.getEdgePtr());
+
+  // Moving a shared path leaves the other value untouched
+  Path path;
+  path.src = Vertex("v1", {});
+  path.steps.emplace_back(Step(Vertex("v2", {}), 1, "edge", 0, {}));
+  Value p1(path);
+  Value p2 = p1;
+  Path moved = p2.movePath();
+  EXPECT_EQ(path, moved);
+  EXPECT_EQ(path, p1.getPath());
+  EXPECT_TRUE(p2.empty());
+}
+
 TEST(Value, ToString) {
   {
     Duration d;
@@ -1652,6 +1680,33 @@ TEST(Value, ToString) {
   }
 }
 
+TEST(Value, RecycledString) {
+  // The strings freed are reused by the values made later, in the same and other threads
+  std::vector<Value> values;
+  for (int i = 0; i < 1000; i++) {
+    values.emplace_back(std::string(i % 100, 'a' + i % 26));
+  }
+  std::thread([values = std::move(values)]() mutable { values.clear(); }).join();
+  for (int round = 0; round < 3; round++) {
+    std::vector<Value> reused;
+    for (int i = 0; i < 1000; i++) {
+      std::string str(i % 80, 'z' - i % 26);
+      if (i % 2 == 0) {
+        reused.emplace_back(str);
+      } else {
+        reused.emplace_back(std::move(str));
+      }
+    }
+    for (int i = 0; i < 1000; i++) {
+      ASSERT_EQ(std::string(i % 80, 'z' - i % 26), reused[i].getStr());
+    }
+    Value moved(reused[3]);
+    EXPECT_EQ(reused[3].moveStr(), moved.getStr());
+    moved.mutableStr().append(100, 'x');
+    EXPECT_EQ(103U, moved.getStr().size());
+  }
+}
+
 }  // namespace nebula
 
 int main(int argc, char** argv) {
@@ -38,23 +38,24 @@ void AggregateExpression::resetFrom(Decoder& decoder) {
 
 const Value& AggregateExpression::eval(ExpressionContext& ctx) {
   DCHECK(!!aggData_);
-  auto val = arg_->eval(ctx);
-  auto uniques = aggData_->uniques();
+  apply(aggData_, arg_->eval(ctx));
+  return aggData_->result();
+}
+
+void AggregateExpression::apply(AggData* aggData, const Value& val) {
   if (distinct_) {
+    auto uniques = aggData->uniques();
     if (uniques->contains(val)) {
-      return aggData_->result();
+      return;
     }
     uniques->values.emplace(val);
   }
 
-  DCHECK(aggFunc_);
-  aggFunc_(aggData_, val);
-
-  return aggData_->result();
-}
-
-void AggregateExpression::apply(AggData* aggData, const Value& val) {
-  AggFunctionManager::get(name_).value()(aggData, val);
+  if (aggFunc_) {
+    aggFunc_(aggData, val);
+  } else {
+    AggFunctionManager::get(name_).value()(aggData, val);
+  }
 }
 
 std::string AggregateExpression::toString() const {
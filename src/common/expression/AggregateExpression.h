@@ -29,6 +29,8 @@ class AggregateExpression final : public Expression {
 
   const Value& eval(ExpressionContext& ctx) override;
 
+  // Aggregate the value of arg evaluated already into aggData, which doesn't touch the aggData
+  // set to this expression, so it could be called by multiple threads with different aggData
   void apply(AggData* aggData, const Value& val);
 
   bool operator==(const Expression& rhs) const override;
@@ -0,0 +1,212 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/expression/ExpressionProgram.h"
+
+#include "common/expression/ArithmeticExpression.h"
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/LogicalExpression.h"
+#include "common/expression/RelationalExpression.h"
+#include "common/expression/UnaryExpression.h"
+
+DEFINE_bool(enable_expression_program,
+            true,
+            "Whether to evaluate the filters per row by the flat programs compiled from them, "
+            "instead of walking the expression trees");
+
+namespace nebula {
+
+namespace {
+
+bool isCompiled(const Expression* expr) {
+  switch (expr->kind()) {
+    case Expression::Kind::kRelEQ:
+    case Expression::Kind::kRelNE:
+    case Expression::Kind::kRelLT:
+    case Expression::Kind::kRelLE:
+    case Expression::Kind::kRelGT:
+    case Expression::Kind::kRelGE:
+    case Expression::Kind::kAdd:
+    case Expression::Kind::kMinus:
+    case Expression::Kind::kMultiply:
+    case Expression::Kind::kDivision:
+    case Expression::Kind::kMod:
+    case Expression::Kind::kUnaryNot:
+    case Expression::Kind::kLogicalAnd:
+    case Expression::Kind::kLogicalOr:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The same as LogicalExpression::evalAnd and evalOr, return true if the result is decided
+bool logicalStep(bool isAnd, const Value& value, Value& result) {
+  if (value.isBadNull() || (value.isImplicitBool() && value.implicitBool() != isAnd)) {
+    result = value;
+    return true;
+  }
+  if (!value.isImplicitBool()) {
+    if (value.isNull()) {
+      result = value;
+    } else if (value.empty() && !result.isNull()) {
+      result = value;
+    } else {
+      result = Value::kNullBadType;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<ExpressionProgram> ExpressionProgram::compile(Expression* expr) {
+  if (!FLAGS_enable_expression_program || expr == nullptr || !isCompiled(expr)) {
+    return nullptr;
+  }
+  std::unique_ptr<ExpressionProgram> program(new ExpressionProgram());
+  program->result_ = program->compileExpr(expr);
+  return program;
+}
+
+uint32_t ExpressionProgram::compileExpr(Expression* expr) {
+  if (expr->kind() == Expression::Kind::kConstant) {
+    auto reg = newRegister();
+    regs_[reg] = &static_cast<ConstantExpression*>(expr)->value();
+    return reg;
+  }
+  if (!isCompiled(expr)) {
+    auto reg = newRegister();
+    Instr instr{Op::kLoad, expr->kind(), reg};
+    instr.expr = expr;
+    instrs_.emplace_back(instr);
+    return reg;
+  }
+
+  if (expr->isRelExpr() || expr->isArithmeticExpr()) {
+    auto* binary = static_cast<BinaryExpression*>(expr);
+    auto lhs = compileExpr(binary->left());
+    auto rhs = compileExpr(binary->right());
+    auto reg = newRegister();
+    auto op = expr->isRelExpr() ? Op::kRelational : Op::kArithmetic;
+    instrs_.emplace_back(Instr{op, expr->kind(), reg, lhs, rhs});
+    return reg;
+  }
+  if (expr->kind() == Expression::Kind::kUnaryNot) {
+    auto operand = compileExpr(static_cast<UnaryExpression*>(expr)->operand());
+    auto reg = newRegister();
+    instrs_.emplace_back(Instr{Op::kNot, expr->kind(), reg, operand});
+    return reg;
+  }
+
+  DCHECK(expr->kind() == Expression::Kind::kLogicalAnd ||
+         expr->kind() == Expression::Kind::kLogicalOr);
+  auto reg = newRegister();
+  instrs_.emplace_back(Instr{Op::kLogicalBegin, expr->kind(), reg});
+  std::vector<size_t> steps;
+  for (auto* operand : static_cast<LogicalExpression*>(expr)->operands()) {
+    auto value = compileExpr(operand);
+    steps.emplace_back(instrs_.size());
+    instrs_.emplace_back(Instr{Op::kLogicalStep, expr->kind(), reg, value});
+  }
+  // Jump over the rest operands once the result is decided
+  for (auto step : steps) {
+    instrs_[step].target = instrs_.size();
+  }
+  return reg;
+}
+
+const Value& ExpressionProgram::eval(ExpressionContext& ctx) {
+  size_t pc = 0;
+  while (pc < instrs_.size()) {
+    const auto& instr = instrs_[pc];
+    switch (instr.op) {
+      case Op::kLoad: {
+        regs_[instr.dst] = &instr.expr->eval(ctx);
+        break;
+      }
+      case Op::kRelational: {
+        const auto& lhs = *regs_[instr.lhs];
+        const auto& rhs = *regs_[instr.rhs];
+        auto& result = slots_[instr.dst];
+        // The same as RelationalExpression::eval
+        switch (instr.kind) {
+          case Expression::Kind::kRelEQ:
+            result = lhs.equal(rhs);
+            break;
+          case Expression::Kind::kRelNE:
+            result = !lhs.equal(rhs);
+            break;
+          case Expression::Kind::kRelLT:
+            result = lhs.lessThan(rhs);
+            break;
+          case Expression::Kind::kRelLE:
+            result = lhs.lessThan(rhs) || lhs.equal(rhs);
+            break;
+          case Expression::Kind::kRelGT:
+            result = !lhs.lessThan(rhs) && !lhs.equal(rhs);
+            break;
+          case Expression::Kind::kRelGE:
+            result = !lhs.lessThan(rhs) || lhs.equal(rhs);
+            break;
+          default:
+            LOG(FATAL) << "Unexpected relational kind: " << static_cast<int>(instr.kind);
+        }
+        regs_[instr.dst] = &result;
+        break;
+      }
+      case Op::kArithmetic: {
+        const auto& lhs = *regs_[instr.lhs];
+        const auto& rhs = *regs_[instr.rhs];
+        auto& result = slots_[instr.dst];
+        switch (instr.kind) {
+          case Expression::Kind::kAdd:
+            result = lhs + rhs;
+            break;
+          case Expression::Kind::kMinus:
+            result = lhs - rhs;
+            break;
+          case Expression::Kind::kMultiply:
+            result = lhs * rhs;
+            break;
+          case Expression::Kind::kDivision:
+            result = lhs / rhs;
+            break;
+          case Expression::Kind::kMod:
+            result = lhs % rhs;
+            break;
+          default:
+            LOG(FATAL) << "Unexpected arithmetic kind: " << static_cast<int>(instr.kind);
+        }
+        regs_[instr.dst] = &result;
+        break;
+      }
+      case Op::kNot: {
+        slots_[instr.dst] = !(*regs_[instr.lhs]);
+        regs_[instr.dst] = &slots_[instr.dst];
+        break;
+      }
+      case Op::kLogicalBegin: {
+        slots_[instr.dst] = instr.kind == Expression::Kind::kLogicalAnd;
+        regs_[instr.dst] = &slots_[instr.dst];
+        break;
+      }
+      case Op::kLogicalStep: {
+        auto isAnd = instr.kind == Expression::Kind::kLogicalAnd;
+        if (logicalStep(isAnd, *regs_[instr.lhs], slots_[instr.dst])) {
+          pc = instr.target;
+          continue;
+        }
+        break;
+      }
+    }
+    ++pc;
+  }
+  return *regs_[result_];
+}
+
+}  // namespace nebula
@@ -0,0 +1,87 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_EXPRESSION_EXPRESSIONPROGRAM_H_
+#define COMMON_EXPRESSION_EXPRESSIONPROGRAM_H_
+
+#include "common/base/Base.h"
+#include "common/context/ExpressionContext.h"
+#include "common/expression/Expression.h"
+
+DECLARE_bool(enable_expression_program);
+
+namespace nebula {
+
+/**
+ * The flat form of an expression evaluated per row, e.g. a filter condition.
+ *
+ * The relational, arithmetic, logical and NOT operators are compiled into instructions on
+ * registers, and run in one loop instead of the chain of the virtual eval calls of the tree. The
+ * other sub expressions, e.g. the properties and the function calls, are the leaves loaded by
+ * their own eval. A register holds the pointer to the value, so the loaded values are not copied,
+ * and the computed ones are kept in the slots reused across the rows. The logical operators are
+ * short circuited by jumping over the instructions of the rest operands.
+ *
+ * The result is the same as the eval of the expression. The program refers to the expression,
+ * which must outlive it, and like the expression, it must not be evaluated concurrently.
+ */
+class ExpressionProgram final {
+ public:
+  // Return nullptr if it's disabled, or the root is a leaf, which gains nothing
+  static std::unique_ptr<ExpressionProgram> compile(Expression* expr);
+
+  const Value& eval(ExpressionContext& ctx);
+
+  size_t numInstrs() const {
+    return instrs_.size();
+  }
+
+ private:
+  enum class Op : uint8_t {
+    kLoad,
+    kRelational,
+    kArithmetic,
+    kNot,
+    // Initialize the result of a logical expression
+    kLogicalBegin,
+    // Merge an operand into the result of a logical expression, jump if it's decided
+    kLogicalStep,
+  };
+
+  struct Instr {
+    Op op;
+    Expression::Kind kind;
+    uint32_t dst;
+    uint32_t lhs{0};
+    uint32_t rhs{0};
+    // Where the kLogicalStep jumps to
+    uint32_t target{0};
+    // The leaf of kLoad
+    Expression* expr{nullptr};
+  };
+
+  ExpressionProgram() = default;
+
+  // Return the register of the result
+  uint32_t compileExpr(Expression* expr);
+
+  uint32_t newRegister() {
+    regs_.emplace_back(nullptr);
+    slots_.emplace_back();
+    return regs_.size() - 1;
+  }
+
+  std::vector<Instr> instrs_;
+  // The values of the registers, the constants are set at the compile time
+  std::vector<const Value*> regs_;
+  // The values computed by the instructions
+  std::vector<Value> slots_;
+  // The register of the result
+  uint32_t result_{0};
+};
+
+}  // namespace nebula
+
+#endif  // COMMON_EXPRESSION_EXPRESSIONPROGRAM_H_
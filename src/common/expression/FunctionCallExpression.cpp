@@ -5,6 +5,8 @@
 
 #include "common/expression/FunctionCallExpression.h"
 
+#include <folly/String.h>
+
 #include "common/expression/ExprVisitor.h"
 
 namespace nebula {
@@ -63,18 +65,155 @@ void FunctionCallExpression::resetFrom(Decoder& decoder) {
     args_->addArgument(decoder.readExpression(pool_));
   }
 
-  auto funcResult = FunctionManager::get(name_, args_->numArgs());
+  bind();
+}
+
+void FunctionCallExpression::bind() {
+  auto funcResult = FunctionManager::get(name_, DCHECK_NOTNULL(args_)->numArgs());
   if (funcResult.ok()) {
     func_ = std::move(funcResult).value();
   }
+  argValues_.reserve(args_->numArgs());
+
+  static const std::unordered_map<std::string, FastPath> fastPaths = {
+      {"id", FastPath::kId},
+      {"src", FastPath::kSrc},
+      {"dst", FastPath::kDst},
+      {"properties", FastPath::kProperties},
+      {"labels", FastPath::kLabels},
+      {"tags", FastPath::kLabels},
+      {"lower", FastPath::kLower},
+      {"tolower", FastPath::kLower},
+      {"abs", FastPath::kAbs},
+      {"size", FastPath::kSize},
+  };
+  fastPath_ = FastPath::kNone;
+  if (func_ && args_->numArgs() == 1) {
+    auto iter = fastPaths.find(boost::to_lower_copy(name_));
+    if (iter != fastPaths.end()) {
+      fastPath_ = iter->second;
+    }
+  }
+}
+
+bool FunctionCallExpression::evalFast(const Value& arg) {
+  // Keep the same results as the functions in FunctionManager
+  switch (fastPath_) {
+    case FastPath::kId: {
+      if (arg.isVertex()) {
+        result_ = arg.getVertex().vid;
+        return true;
+      }
+      break;
+    }
+    case FastPath::kSrc:
+    case FastPath::kDst: {
+      if (arg.isEdge()) {
+        const auto& edge = arg.getEdge();
+        bool forward = (edge.type > 0) == (fastPath_ == FastPath::kSrc);
+        result_ = forward ? edge.src : edge.dst;
+        return true;
+      }
+      break;
+    }
+    case FastPath::kProperties: {
+      if (arg.isVertex() || arg.isEdge()) {
+        // Reuse the map of the last result
+        if (!result_.isMap()) {
+          result_ = Map();
+        }
+        auto& kvs = result_.mutableMap().kvs;
+        kvs.clear();
+        if (arg.isVertex()) {
+          for (const auto& tag : arg.getVertex().tags) {
+            kvs.insert(tag.props.cbegin(), tag.props.cend());
+          }
+        } else {
+          const auto& props = arg.getEdge().props;
+          kvs.insert(props.cbegin(), props.cend());
+        }
+        return true;
+      }
+      break;
+    }
+    case FastPath::kLabels: {
+      if (arg.isVertex()) {
+        if (!result_.isList()) {
+          result_ = List();
+        }
+        auto& values = result_.mutableList().values;
+        values.clear();
+        for (const auto& tag : arg.getVertex().tags) {
+          values.emplace_back(tag.name);
+        }
+        return true;
+      }
+      break;
+    }
+    case FastPath::kLower: {
+      if (arg.isStr()) {
+        if (!result_.isStr()) {
+          result_ = std::string();
+        }
+        auto& str = result_.mutableStr();
+        str.assign(arg.getStr());
+        folly::toLowerAscii(str);
+        return true;
+      }
+      break;
+    }
+    case FastPath::kAbs: {
+      if (arg.isInt()) {
+        result_ = std::abs(arg.getInt());
+        return true;
+      }
+      if (arg.isFloat()) {
+        result_ = std::abs(arg.getFloat());
+        return true;
+      }
+      break;
+    }
+    case FastPath::kSize: {
+      if (arg.isStr()) {
+        result_ = static_cast<int64_t>(arg.getStr().size());
+        return true;
+      }
+      if (arg.isList()) {
+        result_ = static_cast<int64_t>(arg.getList().size());
+        return true;
+      }
+      if (arg.isMap()) {
+        result_ = static_cast<int64_t>(arg.getMap().size());
+        return true;
+      }
+      if (arg.isSet()) {
+        result_ = static_cast<int64_t>(arg.getSet().size());
+        return true;
+      }
+      break;
+    }
+    case FastPath::kNone: {
+      break;
+    }
+  }
+  return false;
 }
 
 const Value& FunctionCallExpression::eval(ExpressionContext& ctx) {
-  std::vector<std::reference_wrapper<const Value>> parameter;
-  for (const auto& arg : DCHECK_NOTNULL(args_)->args()) {
-    parameter.emplace_back(arg->eval(ctx));
+  const auto& args = DCHECK_NOTNULL(args_)->args();
+  argValues_.clear();
+  if (fastPath_ != FastPath::kNone && args.size() == 1) {
+    const auto& arg = args[0]->eval(ctx);
+    if (evalFast(arg)) {
+      return result_;
+    }
+    argValues_.emplace_back(arg);
+  } else {
+    for (const auto& arg : args) {
+      argValues_.emplace_back(arg->eval(ctx));
+    }
   }
-  result_ = DCHECK_NOTNULL(func_)(parameter);
+  result_ = DCHECK_NOTNULL(func_)(argValues_);
   return result_;
 }
 
@@ -120,16 +120,33 @@ class FunctionCallExpression final : public Expression {
   FunctionCallExpression(ObjectPool* pool, const std::string& name, ArgumentList* args)
       : Expression(pool, Kind::kFunctionCall), name_(name), args_(args) {
     if (!name_.empty()) {
-      auto funcResult = FunctionManager::get(name_, DCHECK_NOTNULL(args_)->numArgs());
-      if (funcResult.ok()) {
-        func_ = funcResult.value();
-      }
+      bind();
     }
   }
 
   void writeTo(Encoder& encoder) const override;
   void resetFrom(Decoder& decoder) override;
 
+  // The builtins in most of the filters and yields, which are evaluated without the type-erased
+  // call and the temporary result
+  enum class FastPath : int8_t {
+    kNone,
+    kId,
+    kSrc,
+    kDst,
+    kProperties,
+    kLabels,
+    kLower,
+    kAbs,
+    kSize,
+  };
+
+  // Resolve the function by the name and the arity once, rather than for each call
+  void bind();
+
+  // Return false if the type of the arg is not handled, then the function is called
+  bool evalFast(const Value& arg);
+
  private:
   std::string name_;
   ArgumentList* args_;
@@ -137,6 +154,9 @@ class FunctionCallExpression final : public Expression {
   // runtime cache
   Value result_;
   FunctionManager::Function func_;
+  FastPath fastPath_{FastPath::kNone};
+  // The args of a call, reused to not allocate for each call
+  std::vector<FunctionManager::ArgType> argValues_;
 };
 
 }  // namespace nebula
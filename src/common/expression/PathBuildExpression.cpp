@@ -14,6 +14,43 @@ const Value& PathBuildExpression::eval(ExpressionContext& ctx) {
   if (items_.empty()) {
     return Value::kNullValue;
   }
+  switch (output_) {
+    case Output::kPath: {
+      return evalPath(ctx);
+    }
+    case Output::kLength: {
+      return evalLength(ctx);
+    }
+    case Output::kStartNode:
+    case Output::kEndNode: {
+      // The nodes are only given if the path could be built, e.g. not for the null items of an
+      // OPTIONAL MATCH
+      if (walkPath(ctx) < 0) {
+        return Value::kNullValue;
+      }
+      // The nodes of the paths matched are given as the items at both ends
+      auto& node = output_ == Output::kStartNode ? items_.front()->eval(ctx)
+                                                 : items_.back()->eval(ctx);
+      if (node.isVertex()) {
+        return node;
+      }
+      break;
+    }
+  }
+
+  // Build the whole path for the items of other forms
+  auto& val = evalPath(ctx);
+  if (!val.isPath()) {
+    return Value::kNullValue;
+  }
+  const auto& path = val.getPath();
+  Value node = output_ == Output::kStartNode || path.steps.empty() ? Value(path.src)
+                                                                    : Value(path.steps.back().dst);
+  result_ = std::move(node);
+  return result_;
+}
+
+const Value& PathBuildExpression::evalPath(ExpressionContext& ctx) {
   Path path;
   auto& val = items_.front()->eval(ctx);
   if (!getVertex(val, path.src)) {
@@ -35,6 +72,90 @@ const Value& PathBuildExpression::eval(ExpressionContext& ctx) {
   return result_;
 }
 
+const Value& PathBuildExpression::evalLength(ExpressionContext& ctx) {
+  auto length = walkPath(ctx);
+  if (length < 0) {
+    return Value::kNullValue;
+  }
+  result_ = length;
+  return result_;
+}
+
+int64_t PathBuildExpression::walkPath(ExpressionContext& ctx) {
+  Value lastVid;
+  int64_t steps = 0;
+  auto& first = items_.front()->eval(ctx);
+  if (first.isStr() || first.isInt()) {
+    lastVid = first;
+  } else if (first.isVertex()) {
+    lastVid = first.getVertex().vid;
+  } else if (first.isPath()) {
+    const auto& path = first.getPath();
+    steps = path.steps.size();
+    lastVid = path.steps.empty() ? path.src.vid : path.steps.back().dst.vid;
+  } else {
+    return -1;
+  }
+  for (size_t i = 1; i < items_.size(); ++i) {
+    if (!walk(items_[i]->eval(ctx), lastVid, steps)) {
+      return -1;
+    }
+  }
+  return steps;
+}
+
+bool PathBuildExpression::walk(const Value& value, Value& lastVid, int64_t& steps) const {
+  switch (value.type()) {
+    case Value::Type::EDGE: {
+      const auto& edge = value.getEdge();
+      if (lastVid == edge.src) {
+        lastVid = edge.dst;
+      } else if (lastVid == edge.dst) {
+        lastVid = edge.src;
+      } else {
+        return false;
+      }
+      steps++;
+      return true;
+    }
+    case Value::Type::VERTEX: {
+      if (steps == 0) {
+        return lastVid == value.getVertex().vid;
+      }
+      lastVid = value.getVertex().vid;
+      return true;
+    }
+    case Value::Type::PATH: {
+      const auto& p = value.getPath();
+      if (!p.steps.empty()) {
+        lastVid = p.steps.back().dst.vid;
+      } else if (steps > 0) {
+        lastVid = p.src.vid;
+      }
+      steps += p.steps.size();
+      return true;
+    }
+    case Value::Type::LIST: {
+      const auto& values = value.getList().values;
+      for (const auto& val : values) {
+        if (!walk(val, lastVid, steps)) {
+          // Walked reversely from where it stops, as buildPath does
+          for (auto it = values.rbegin(); it != values.rend(); ++it) {
+            if (!walk(*it, lastVid, steps)) {
+              return false;
+            }
+          }
+          return true;
+        }
+      }
+      return true;
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
 bool PathBuildExpression::buildPath(const Value& value, Path& path) const {
   switch (value.type()) {
     case Value::Type::EDGE: {
@@ -147,6 +268,10 @@ bool PathBuildExpression::operator==(const Expression& rhs) const {
     return false;
   }
 
+  if (output_ != pathBuild.output_) {
+    return false;
+  }
+
   for (size_t i = 0; i < size(); ++i) {
     if (*items_[i] != *pathBuild.items_[i]) {
       return false;
@@ -166,6 +291,21 @@ std::string PathBuildExpression::toString() const {
     buf += ",";
   }
   buf.back() = ']';
+
+  switch (output_) {
+    case Output::kPath: {
+      return buf;
+    }
+    case Output::kLength: {
+      return "length(" + buf + ")";
+    }
+    case Output::kStartNode: {
+      return "startNode(" + buf + ")";
+    }
+    case Output::kEndNode: {
+      return "endNode(" + buf + ")";
+    }
+  }
   return buf;
 }
 
@@ -178,6 +318,7 @@ Expression* PathBuildExpression::clone() const {
   for (auto& item : items_) {
     pathBuild->add(item->clone());
   }
+  pathBuild->setOutput(output_);
   return pathBuild;
 }
 
@@ -187,6 +328,7 @@ void PathBuildExpression::writeTo(Encoder& encoder) const {
   for (auto& item : items_) {
     encoder << *item;
   }
+  encoder << static_cast<size_t>(output_);
 }
 
 void PathBuildExpression::resetFrom(Decoder& decoder) {
@@ -196,5 +338,6 @@ void PathBuildExpression::resetFrom(Decoder& decoder) {
     auto item = decoder.readExpression(pool_);
     items_.emplace_back(item);
   }
+  output_ = static_cast<Output>(decoder.readSize());
 }
 }  // namespace nebula
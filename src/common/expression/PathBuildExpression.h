@@ -14,6 +14,15 @@
 namespace nebula {
 class PathBuildExpression final : public Expression {
  public:
+  // What the expression evaluates to. Besides the whole path, the length and the end nodes of it
+  // could be evaluated from the items directly, without building the path.
+  enum class Output : uint8_t {
+    kPath,
+    kLength,
+    kStartNode,
+    kEndNode,
+  };
+
   PathBuildExpression& operator=(const PathBuildExpression& rhs) = delete;
   PathBuildExpression& operator=(PathBuildExpression&&) = delete;
 
@@ -53,6 +62,14 @@ class PathBuildExpression final : public Expression {
     return items_;
   }
 
+  Output output() const {
+    return output_;
+  }
+
+  void setOutput(Output output) {
+    output_ = output;
+  }
+
  private:
   friend ObjectPool;
   explicit PathBuildExpression(ObjectPool* pool) : Expression(pool, Kind::kPathBuild) {}
@@ -67,8 +84,21 @@ class PathBuildExpression final : public Expression {
 
   bool buildPath(const Value& value, Path& path) const;
 
+  const Value& evalPath(ExpressionContext& ctx);
+
+  const Value& evalLength(ExpressionContext& ctx);
+
+  // Check the items are connected as evalPath does, without building the path. The number of the
+  // steps of the path is returned, or -1 if evalPath returns null.
+  int64_t walkPath(ExpressionContext& ctx);
+
+  // Walk the value as buildPath appends it to the path, where only the vid of the last node and
+  // the number of the steps of the path are kept
+  bool walk(const Value& value, Value& lastVid, int64_t& steps) const;
+
  private:
   std::vector<Expression*> items_;
+  Output output_{Output::kPath};
   Value result_;
 };
 }  // namespace nebula
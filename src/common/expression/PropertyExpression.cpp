@@ -59,7 +59,7 @@ void EdgePropertyExpression::accept(ExprVisitor* visitor) {
 }
 
 const Value& TagPropertyExpression::eval(ExpressionContext& ctx) {
-  result_ = ctx.getTagProp(sym_, prop_);
+  result_ = ctx.getTagPropBySlot(sym_, prop_, &slot_);
   return result_;
 }
 
@@ -124,6 +124,8 @@ class TagPropertyExpression final : public PropertyExpression {
 
  private:
   Value result_;
+  // The position of the property in the rows being evaluated
+  PropSlot slot_;
 };
 
 // label.tag_name.any_prop_name
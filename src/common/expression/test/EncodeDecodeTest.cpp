@@ -475,6 +475,10 @@ TEST(ExpressionEncodeDecode, PathBuildExpression) {
       .add(LabelExpression::make(&pool, "path_v1"));
   auto decoded = Expression::decode(&pool, Expression::encode(*origin));
   ASSERT_EQ(*origin, *decoded);
+
+  origin->setOutput(PathBuildExpression::Output::kLength);
+  decoded = Expression::decode(&pool, Expression::encode(*origin));
+  ASSERT_EQ(*origin, *decoded);
 }
 
 TEST(ExpressionEncodeDecode, ListComprehensionExpression) {
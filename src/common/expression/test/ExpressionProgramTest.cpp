@@ -0,0 +1,81 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+#include "common/expression/ExpressionProgram.h"
+#include "common/expression/test/TestBase.h"
+
+namespace nebula {
+
+class ExpressionProgramTest : public ExpressionTest {
+ protected:
+  // The program must return the same as the expression tree
+  void testProgram(const std::string &exprSymbol, size_t numInstrs = 0) {
+    std::string query = "RETURN " + exprSymbol;
+    nebula::graph::QueryContext queryCtxt;
+    nebula::GQLParser gParser(&queryCtxt);
+    auto result = gParser.parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+    auto *sequentialSentences = static_cast<SequentialSentences *>(result.value().get());
+    auto *yieldSentence = static_cast<YieldSentence *>(sequentialSentences->sentences()[0]);
+    Expression *ep = yieldSentence->yield()->yields()->back()->expr();
+    auto expected = Expression::eval(ep->clone(), gExpCtxt);
+
+    auto program = ExpressionProgram::compile(ep);
+    ASSERT_NE(program, nullptr) << ep->toString();
+    if (numInstrs != 0) {
+      EXPECT_EQ(numInstrs, program->numInstrs()) << ep->toString();
+    }
+    // Evaluated repeatedly as for the rows
+    for (auto i = 0; i < 2; i++) {
+      const auto &val = program->eval(gExpCtxt);
+      EXPECT_EQ(expected.type(), val.type()) << "type check failed: " << ep->toString();
+      EXPECT_EQ(expected, val) << "check failed: " << ep->toString();
+    }
+  }
+};
+
+TEST_F(ExpressionProgramTest, Leaf) {
+  auto *leaf = ConstantExpression::make(&pool, 1);
+  EXPECT_EQ(nullptr, ExpressionProgram::compile(leaf));
+  EXPECT_EQ(nullptr, ExpressionProgram::compile(nullptr));
+}
+
+TEST_F(ExpressionProgramTest, Relational) {
+  testProgram("$-.int > 0", 2);
+  testProgram("$-.int == 1", 2);
+  testProgram("$-.int != $-.float", 3);
+  testProgram("$-.float <= 1", 2);
+  testProgram("$-.string16 >= \"a\"", 2);
+  testProgram("$-.int < $-.null", 3);
+  testProgram("$-.empty == 1", 2);
+}
+
+TEST_F(ExpressionProgramTest, Arithmetic) {
+  testProgram("$-.int + 1 == 2", 3);
+  testProgram("$-.int * 3 - $-.float > 1", 5);
+  testProgram("$-.int / 0", 2);
+  testProgram("$-.int % 0 == 1", 3);
+  testProgram("$-.string16 + 1", 2);
+}
+
+TEST_F(ExpressionProgramTest, Logical) {
+  testProgram("$-.int > 0 AND $-.float < 2", 7);
+  testProgram("$-.int > 1 AND $-.float < 2", 7);
+  testProgram("$-.null AND true", 4);
+  testProgram("$-.empty AND $-.null", 5);
+  testProgram("$-.null AND $-.empty", 5);
+  testProgram("$-.empty OR false", 4);
+  testProgram("$-.string16 AND true", 4);
+  testProgram("$-.bool_true OR $-.string16", 5);
+  testProgram("$-.bool_false OR $-.null OR $-.empty");
+  testProgram("$-.bool_true AND $-.empty AND $-.bool_false");
+  testProgram("($-.int > 0 OR $-.null) AND ($-.empty OR $-.bool_true)");
+  testProgram("($-.int > 1 AND $-.null) OR NOT ($-.empty AND $-.bool_true)");
+  testProgram("NOT ($-.int > 1)", 3);
+  testProgram("NOT $-.null", 2);
+  // The operators not compiled are evaluated as leaves
+  testProgram("$-.int IN [1, 2] AND ($-.bool_true XOR $-.bool_false)", 5);
+}
+
+}  // namespace nebula
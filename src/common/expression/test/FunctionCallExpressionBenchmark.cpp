@@ -16,9 +16,10 @@ nebula::ExpressionContextMock gExpCtxt;
 nebula::ObjectPool pool;
 namespace nebula {
 
-static FunctionCallExpression* expr = nullptr;
+static std::unordered_map<std::string, FunctionCallExpression*> exprs;
 
-size_t funcCall(size_t iters) {
+size_t funcCall(size_t iters, const std::string& name) {
+  auto* expr = exprs.at(name);
   for (size_t i = 0; i < iters; ++i) {
     Value eval = Expression::eval(expr, gExpCtxt);
     folly::doNotOptimizeAway(eval);
@@ -26,14 +27,34 @@ size_t funcCall(size_t iters) {
   return iters;
 }
 
-BENCHMARK_NAMED_PARAM_MULTI(funcCall, FunctionCallBM)
+// The builtins with a fast path
+BENCHMARK_NAMED_PARAM_MULTI(funcCall, abs, "abs")
+BENCHMARK_NAMED_PARAM_MULTI(funcCall, lower, "lower")
+BENCHMARK_NAMED_PARAM_MULTI(funcCall, src, "src")
+BENCHMARK_NAMED_PARAM_MULTI(funcCall, properties, "properties")
+// The builtins called through FunctionManager
+BENCHMARK_NAMED_PARAM_MULTI(funcCall, upper, "upper")
+BENCHMARK_NAMED_PARAM_MULTI(funcCall, pow, "pow")
+
+void addCall(const std::string& name, std::vector<Value> args) {
+  auto* argList = ArgumentList::make(&pool);
+  for (auto& arg : args) {
+    argList->addArgument(ConstantExpression::make(&pool, std::move(arg)));
+  }
+  exprs[name] = FunctionCallExpression::make(&pool, name, argList);
+}
 
 }  // namespace nebula
 
 int main(int argc, char** argv) {
-  nebula::ArgumentList* args = nebula::ArgumentList::make(&pool);
-  args->addArgument(nebula::ConstantExpression::make(&pool, 1));
-  nebula::expr = nebula::FunctionCallExpression::make(&pool, "abs", args);
+  using nebula::Value;
+  nebula::Edge edge("src", "dst", 1, "like", 0, {{"likeness", 90}, {"since", 2010}});
+  nebula::addCall("abs", {Value(-1)});
+  nebula::addCall("lower", {Value("Tim Duncan")});
+  nebula::addCall("src", {Value(edge)});
+  nebula::addCall("properties", {Value(edge)});
+  nebula::addCall("upper", {Value("Tim Duncan")});
+  nebula::addCall("pow", {Value(2), Value(10)});
 
   folly::init(&argc, &argv, true);
   folly::runBenchmarks();
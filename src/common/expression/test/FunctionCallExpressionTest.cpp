@@ -99,6 +99,39 @@ TEST_F(FunctionCallExpressionTest, FunctionCallTest) {
   }
 }
 
+TEST_F(FunctionCallExpressionTest, FastPathTest) {
+  Vertex vertex("v", {Tag("t1", {{"a", 1}, {"b", "x"}}), Tag("t2", {{"a", 2}, {"c", 3.0}})});
+  Edge edge("s", "d", 1, "e", 0, {{"p", 1}});
+  Edge reverse("d", "s", -1, "e", 0, {{"p", 1}});
+  std::vector<Value> values = {Value::kNullValue,
+                               Value::kEmpty,
+                               vertex,
+                               edge,
+                               reverse,
+                               "AbC",
+                               -3,
+                               -1.5,
+                               List({1, 2}),
+                               Map({{"k", 1}}),
+                               Set({1}),
+                               true};
+  for (auto name : {"id", "src", "dst", "properties", "labels", "tags", "lower", "abs", "size"}) {
+    auto func = FunctionManager::get(name, 1).value();
+    for (const auto &val : values) {
+      auto argList = ArgumentList::make(&pool);
+      argList->addArgument(ConstantExpression::make(&pool, val));
+      auto expr = FunctionCallExpression::make(&pool, name, argList);
+      auto expected = func({val});
+      // The result of the last call is reused by the next one
+      for (int i = 0; i < 2; i++) {
+        auto result = Expression::eval(expr, gExpCtxt);
+        EXPECT_EQ(expected.type(), result.type()) << name << "(" << val << ")";
+        EXPECT_EQ(expected, result) << name << "(" << val << ")";
+      }
+    }
+  }
+}
+
 TEST_F(FunctionCallExpressionTest, FunctionCallToStringTest) {
   {
     ArgumentList *argList = ArgumentList::make(&pool);
@@ -116,6 +116,84 @@ TEST_F(PathBuildExpressionTest, PathBuild) {
   }
 }
 
+TEST_F(PathBuildExpressionTest, PathBuildOutput) {
+  auto expr = PathBuildExpression::make(&pool);
+  expr->add(VariablePropertyExpression::make(&pool, "var1", "path_src"))
+      .add(VariablePropertyExpression::make(&pool, "var1", "path_edge1"))
+      .add(VariablePropertyExpression::make(&pool, "var1", "path_v1"))
+      .add(VariablePropertyExpression::make(&pool, "var1", "path_edge2"))
+      .add(VariablePropertyExpression::make(&pool, "var1", "path_v2"));
+  {
+    expr->setOutput(PathBuildExpression::Output::kLength);
+    auto eval = Expression::eval(expr, gExpCtxt);
+    EXPECT_EQ(eval, Value(2));
+    EXPECT_EQ(expr->toString(),
+              "length(PathBuild[$var1.path_src,$var1.path_edge1,$var1.path_v1,"
+              "$var1.path_edge2,$var1.path_v2])");
+  }
+  {
+    expr->setOutput(PathBuildExpression::Output::kStartNode);
+    auto eval = Expression::eval(expr, gExpCtxt);
+    EXPECT_EQ(eval, Value(Vertex("1", {})));
+  }
+  {
+    expr->setOutput(PathBuildExpression::Output::kEndNode);
+    auto eval = Expression::eval(expr, gExpCtxt);
+    EXPECT_EQ(eval, Value(Vertex("3", {})));
+  }
+  {
+    // Path + Edge, the end node is taken from the path built
+    auto expr0 = PathBuildExpression::make(&pool);
+    expr0->add(VariablePropertyExpression::make(&pool, "var1", "path_src"));
+    auto expr1 = PathBuildExpression::make(&pool);
+    expr1->add(expr0).add(VariablePropertyExpression::make(&pool, "var1", "path_edge1"));
+    expr1->setOutput(PathBuildExpression::Output::kEndNode);
+    auto eval = Expression::eval(expr1, gExpCtxt);
+    EXPECT_EQ(eval, Value(Vertex("2", {})));
+    expr1->setOutput(PathBuildExpression::Output::kLength);
+    eval = Expression::eval(expr1, gExpCtxt);
+    EXPECT_EQ(eval, Value(1));
+  }
+  {
+    // The items of an OPTIONAL MATCH not matched, or not connected, build no path
+    auto optional = PathBuildExpression::make(&pool);
+    optional->add(VariablePropertyExpression::make(&pool, "var1", "path_src"))
+        .add(VariablePropertyExpression::make(&pool, "var1", "path_edge1"))
+        .add(VariablePropertyExpression::make(&pool, "var1", "null"));
+    auto disconnected = PathBuildExpression::make(&pool);
+    disconnected->add(VariablePropertyExpression::make(&pool, "var1", "path_src"))
+        .add(VariablePropertyExpression::make(&pool, "var1", "path_edge2"))
+        .add(VariablePropertyExpression::make(&pool, "var1", "path_v2"));
+    for (auto* e : {optional, disconnected}) {
+      EXPECT_FALSE(Expression::eval(e, gExpCtxt).isPath());
+      for (auto output : {PathBuildExpression::Output::kLength,
+                          PathBuildExpression::Output::kStartNode,
+                          PathBuildExpression::Output::kEndNode}) {
+        e->setOutput(output);
+        EXPECT_EQ(Value::kNullValue, Expression::eval(e, gExpCtxt)) << e->toString();
+      }
+    }
+  }
+  {
+    // The edges of a list are walked reversely if they are not connected in order
+    auto edges = ExpressionList::make(&pool);
+    (*edges)
+        .add(VariablePropertyExpression::make(&pool, "var1", "path_edge1"))
+        .add(VariablePropertyExpression::make(&pool, "var1", "path_edge2"));
+    auto expr2 = PathBuildExpression::make(&pool);
+    expr2->add(VariablePropertyExpression::make(&pool, "var1", "path_v2"))
+        .add(ListExpression::make(&pool, edges));
+    auto path = Expression::eval(expr2, gExpCtxt);
+    ASSERT_TRUE(path.isPath());
+    expr2->setOutput(PathBuildExpression::Output::kLength);
+    EXPECT_EQ(Value(static_cast<int64_t>(path.getPath().steps.size())),
+              Expression::eval(expr2, gExpCtxt));
+    expr2->setOutput(PathBuildExpression::Output::kEndNode);
+    EXPECT_EQ(Value(path.getPath().steps.back().dst.vid),
+              Expression::eval(expr2, gExpCtxt).getVertex().vid);
+  }
+}
+
 TEST_F(PathBuildExpressionTest, PathBuildToString) {
   {
     auto expr = (PathBuildExpression::make(&pool));
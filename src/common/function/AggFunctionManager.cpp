@@ -273,6 +273,58 @@ AggFunctionManager::AggFunctionManager() {
       set.values.emplace(val);
     };
   }
+  {
+    auto& func = functions_["APPROX_COUNT_DISTINCT"];
+    func = [](AggData* aggData, const Value& val) {
+      if (aggData->sketch() == nullptr) {
+        aggData->setResult(0);
+        aggData->setSketch(std::make_unique<HyperLogLog>());
+      }
+      if (val.isNull() || val.empty()) {
+        return;
+      }
+      aggData->sketch()->add(val);
+    };
+  }
+  {
+    // The aggregate functions take one argument, so the percentile is a part of the name
+    const std::vector<std::pair<std::string, double>> percentiles = {
+        {"APPROX_MEDIAN", 0.5}, {"APPROX_P90", 0.9}, {"APPROX_P95", 0.95}, {"APPROX_P99", 0.99}};
+    for (const auto& [name, percentile] : percentiles) {
+      auto& func = functions_[name];
+      func = [quantile = percentile](AggData* aggData, const Value& val) {
+        auto& res = aggData->result();
+        if (res.isBadNull()) {
+          return;
+        }
+        if (UNLIKELY(!val.isNull() && !val.empty() && !val.isNumeric())) {
+          aggData->setSketch(nullptr);
+          res = Value::kNullBadType;
+          return;
+        }
+        if (val.isNull() || val.empty()) {
+          return;
+        }
+        if (aggData->sketch() == nullptr) {
+          aggData->setSketch(std::make_unique<QuantileDigest>(quantile));
+        }
+        aggData->sketch()->add(val);
+      };
+    }
+  }
+  {
+    auto& func = functions_["RESERVOIR_SAMPLE"];
+    func = [](AggData* aggData, const Value& val) {
+      if (aggData->sketch() == nullptr) {
+        aggData->setResult(List());
+        aggData->setSketch(std::make_unique<ReservoirSample>());
+      }
+      if (val.isNull() || val.empty()) {
+        return;
+      }
+      aggData->sketch()->add(val);
+    };
+  }
 }
 
 StatusOr<AggFunctionManager::AggFunction> AggFunctionManager::get(const std::string& func) {
@@ -10,6 +10,7 @@
 #include "common/base/Status.h"
 #include "common/base/StatusOr.h"
 #include "common/datatypes/Value.h"
+#include "common/function/AggSketch.h"
 /**
  * AggFunctionManager is for managing builtin and dynamic-loaded aggregate
  * functions, which users could use as AggregateExpression.
@@ -23,11 +24,8 @@ class AggData final {
  public:
   explicit AggData(Set* uniques = nullptr)
       : cnt_(0), sum_(0.0), avg_(0.0), deviation_(0.0), result_(Value::kNullValue) {
-    if (uniques == nullptr) {
-      uniques_ = std::make_unique<Set>();
-    } else {
-      uniques_.reset(uniques);
-    }
+    // The set is created on demand, since most of the aggregates are not distinct
+    uniques_.reset(uniques);
   }
 
   const Value& cnt() const {
@@ -99,6 +97,9 @@ class AggData final {
   }
 
   Set* uniques() {
+    if (uniques_ == nullptr) {
+      uniques_ = std::make_unique<Set>();
+    }
     return uniques_.get();
   }
 
@@ -106,6 +107,22 @@ class AggData final {
     uniques_.reset(uniques);
   }
 
+  AggSketch* sketch() {
+    return sketch_.get();
+  }
+
+  void setSketch(std::unique_ptr<AggSketch> sketch) {
+    sketch_ = std::move(sketch);
+  }
+
+  // The approximate aggregates only set the result from their sketch here, since computing it
+  // for each value added is too expensive, so it should be called before taking the result
+  void finish() {
+    if (sketch_ != nullptr) {
+      result_ = sketch_->result();
+    }
+  }
+
  private:
   Value cnt_;
   Value sum_;
@@ -113,6 +130,7 @@ class AggData final {
   Value deviation_;
   Value result_;
   std::unique_ptr<Set> uniques_;
+  std::unique_ptr<AggSketch> sketch_;
 };
 
 class AggFunctionManager final {
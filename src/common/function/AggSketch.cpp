@@ -0,0 +1,307 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/function/AggSketch.h"
+
+#include <folly/Random.h>
+#include <folly/hash/Hash.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include "common/datatypes/ValueOps-inl.h"
+
+namespace nebula {
+
+HyperLogLog::HyperLogLog(uint8_t precision)
+    : precision_(precision), registers_(static_cast<size_t>(1) << precision, 0) {
+  DCHECK(precision_ >= 4 && precision_ <= 18);
+}
+
+void HyperLogLog::add(const Value& val) {
+  // The hash of an int is itself, so mix it to spread the bits
+  uint64_t hash = folly::hash::twang_mix64(std::hash<Value>()(val));
+  auto index = hash >> (64 - precision_);
+  // With a sentinel bit, the rank is at most 64 - precision + 1
+  uint64_t rest = (hash << precision_) | (static_cast<uint64_t>(1) << (precision_ - 1));
+  auto rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+Value HyperLogLog::result() const {
+  return estimate();
+}
+
+int64_t HyperLogLog::estimate() const {
+  auto m = static_cast<double>(registers_.size());
+  double sum = 0;
+  int64_t zeros = 0;
+  for (auto rank : registers_) {
+    sum += std::ldexp(1.0, -rank);
+    if (rank == 0) {
+      zeros++;
+    }
+  }
+  auto estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+  if (estimate <= 2.5 * m && zeros > 0) {
+    // Linear counting is more accurate for the small cardinalities
+    estimate = m * std::log(m / zeros);
+  }
+  return std::llround(estimate);
+}
+
+void HyperLogLog::merge(const AggSketch& other) {
+  DCHECK(dynamic_cast<const HyperLogLog*>(&other) != nullptr);
+  const auto& hll = static_cast<const HyperLogLog&>(other);
+  DCHECK_EQ(precision_, hll.precision_);
+  for (size_t i = 0; i < registers_.size(); i++) {
+    registers_[i] = std::max(registers_[i], hll.registers_[i]);
+  }
+}
+
+std::string HyperLogLog::encode() const {
+  std::string data;
+  data.reserve(1 + registers_.size());
+  data.append(1, static_cast<char>(precision_));
+  data.append(reinterpret_cast<const char*>(registers_.data()), registers_.size());
+  return data;
+}
+
+bool HyperLogLog::decode(folly::StringPiece data) {
+  if (data.empty()) {
+    return false;
+  }
+  auto precision = static_cast<uint8_t>(data[0]);
+  if (precision < 4 || precision > 18 || data.size() != 1 + (static_cast<size_t>(1) << precision)) {
+    return false;
+  }
+  precision_ = precision;
+  registers_.assign(data.begin() + 1, data.end());
+  return true;
+}
+
+QuantileDigest::QuantileDigest(double quantile, double compression)
+    : quantile_(quantile),
+      compression_(compression),
+      min_(std::numeric_limits<double>::infinity()),
+      max_(-std::numeric_limits<double>::infinity()) {}
+
+void QuantileDigest::add(const Value& val) {
+  DCHECK(val.isNumeric());
+  add(val.isInt() ? static_cast<double>(val.getInt()) : val.getFloat());
+}
+
+void QuantileDigest::add(double val, double weight) {
+  min_ = std::min(min_, val);
+  max_ = std::max(max_, val);
+  buffer_.emplace_back(Centroid{val, weight});
+  if (buffer_.size() >= static_cast<size_t>(compression_ * 5)) {
+    compress();
+  }
+}
+
+void QuantileDigest::compress() const {
+  if (buffer_.empty()) {
+    return;
+  }
+  buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+  std::sort(buffer_.begin(), buffer_.end(), [](const auto& a, const auto& b) {
+    return a.mean < b.mean;
+  });
+  double total = 0;
+  for (const auto& centroid : buffer_) {
+    total += centroid.weight;
+  }
+  // The k1 scale function, a centroid covers at most one unit of k, so the centroids at the tails
+  // are smaller
+  auto k = [this](double q) {
+    return compression_ / (2 * M_PI) * std::asin(2 * std::min(q, 1.0) - 1);
+  };
+
+  std::vector<Centroid> merged;
+  double soFar = 0;
+  double kLeft = k(0);
+  auto current = buffer_.front();
+  for (size_t i = 1; i < buffer_.size(); i++) {
+    const auto& next = buffer_[i];
+    if (k((soFar + current.weight + next.weight) / total) - kLeft <= 1) {
+      current.weight += next.weight;
+      current.mean += (next.mean - current.mean) * next.weight / current.weight;
+    } else {
+      soFar += current.weight;
+      merged.emplace_back(current);
+      kLeft = k(soFar / total);
+      current = next;
+    }
+  }
+  merged.emplace_back(current);
+  centroids_.swap(merged);
+  buffer_.clear();
+}
+
+double QuantileDigest::estimate(double quantile) const {
+  compress();
+  if (centroids_.empty()) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  double total = 0;
+  for (const auto& centroid : centroids_) {
+    total += centroid.weight;
+  }
+  // Interpolate between the centres of the neighbouring centroids, and with the min and the max
+  // at both ends
+  auto target = quantile * total;
+  double leftPos = 0;
+  double leftVal = min_;
+  double soFar = 0;
+  for (const auto& centroid : centroids_) {
+    auto centre = soFar + centroid.weight / 2;
+    if (target < centre) {
+      if (centre <= leftPos) {
+        return centroid.mean;
+      }
+      return leftVal + (centroid.mean - leftVal) * (target - leftPos) / (centre - leftPos);
+    }
+    leftPos = centre;
+    leftVal = centroid.mean;
+    soFar += centroid.weight;
+  }
+  if (total <= leftPos) {
+    return max_;
+  }
+  return leftVal + (max_ - leftVal) * (target - leftPos) / (total - leftPos);
+}
+
+Value QuantileDigest::result() const {
+  auto value = estimate(quantile_);
+  if (std::isnan(value)) {
+    return Value::kNullValue;
+  }
+  return value;
+}
+
+void QuantileDigest::merge(const AggSketch& other) {
+  DCHECK(dynamic_cast<const QuantileDigest*>(&other) != nullptr);
+  const auto& digest = static_cast<const QuantileDigest&>(other);
+  digest.compress();
+  for (const auto& centroid : digest.centroids_) {
+    add(centroid.mean, centroid.weight);
+  }
+  min_ = std::min(min_, digest.min_);
+  max_ = std::max(max_, digest.max_);
+}
+
+std::string QuantileDigest::encode() const {
+  compress();
+  std::string data;
+  data.reserve(sizeof(double) * (4 + 2 * centroids_.size()));
+  for (auto val : {quantile_, compression_, min_, max_}) {
+    data.append(reinterpret_cast<const char*>(&val), sizeof(double));
+  }
+  for (const auto& centroid : centroids_) {
+    data.append(reinterpret_cast<const char*>(&centroid.mean), sizeof(double));
+    data.append(reinterpret_cast<const char*>(&centroid.weight), sizeof(double));
+  }
+  return data;
+}
+
+bool QuantileDigest::decode(folly::StringPiece data) {
+  if (data.size() < 4 * sizeof(double) || data.size() % (2 * sizeof(double)) != 0) {
+    return false;
+  }
+  std::vector<double> values(data.size() / sizeof(double));
+  memcpy(values.data(), data.data(), data.size());
+  quantile_ = values[0];
+  compression_ = values[1];
+  min_ = values[2];
+  max_ = values[3];
+  centroids_.clear();
+  buffer_.clear();
+  for (size_t i = 4; i < values.size(); i += 2) {
+    centroids_.emplace_back(Centroid{values[i], values[i + 1]});
+  }
+  return true;
+}
+
+void ReservoirSample::add(const Value& val) {
+  seen_++;
+  if (sample_.size() < capacity_) {
+    sample_.values.emplace_back(val);
+    return;
+  }
+  auto index = folly::Random::rand64(seen_);
+  if (index < capacity_) {
+    sample_.values[index] = val;
+  }
+}
+
+Value ReservoirSample::result() const {
+  return sample_;
+}
+
+void ReservoirSample::merge(const AggSketch& other) {
+  DCHECK(dynamic_cast<const ReservoirSample*>(&other) != nullptr);
+  const auto& reservoir = static_cast<const ReservoirSample&>(other);
+  if (reservoir.seen_ == 0) {
+    return;
+  }
+  // A value of a sample stands for seen / size values, so pick by the weighted sampling without
+  // replacement, of which the key is u ^ (1 / weight), and the log of it is compared
+  std::vector<std::pair<double, Value>> candidates;
+  auto addCandidates = [&candidates](const ReservoirSample& from) {
+    if (from.sample_.empty()) {
+      return;
+    }
+    auto weight = static_cast<double>(from.seen_) / from.sample_.size();
+    for (const auto& val : from.sample_.values) {
+      candidates.emplace_back(std::log(folly::Random::randDouble01()) / weight, val);
+    }
+  };
+  addCandidates(*this);
+  addCandidates(reservoir);
+  auto size = std::min(capacity_, candidates.size());
+  std::partial_sort(candidates.begin(),
+                    candidates.begin() + size,
+                    candidates.end(),
+                    [](const auto& a, const auto& b) { return a.first > b.first; });
+  sample_.values.clear();
+  for (size_t i = 0; i < size; i++) {
+    sample_.values.emplace_back(std::move(candidates[i].second));
+  }
+  seen_ += reservoir.seen_;
+}
+
+std::string ReservoirSample::encode() const {
+  std::string data;
+  uint64_t capacity = capacity_;
+  data.append(reinterpret_cast<const char*>(&capacity), sizeof(uint64_t));
+  data.append(reinterpret_cast<const char*>(&seen_), sizeof(int64_t));
+  apache::thrift::CompactSerializer::serialize(Value(sample_), &data);
+  return data;
+}
+
+bool ReservoirSample::decode(folly::StringPiece data) {
+  if (data.size() < sizeof(uint64_t) + sizeof(int64_t)) {
+    return false;
+  }
+  uint64_t capacity;
+  memcpy(&capacity, data.data(), sizeof(uint64_t));
+  int64_t seen;
+  memcpy(&seen, data.data() + sizeof(uint64_t), sizeof(int64_t));
+  Value sample;
+  try {
+    apache::thrift::CompactSerializer::deserialize(
+        data.subpiece(sizeof(uint64_t) + sizeof(int64_t)), sample);
+  } catch (const std::exception&) {
+    return false;
+  }
+  if (!sample.isList()) {
+    return false;
+  }
+  capacity_ = capacity;
+  seen_ = seen;
+  sample_ = sample.moveList();
+  return true;
+}
+
+}  // namespace nebula
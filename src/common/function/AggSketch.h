@@ -0,0 +1,130 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_FUNCTION_AGGSKETCH_H_
+#define COMMON_FUNCTION_AGGSKETCH_H_
+
+#include "common/base/Base.h"
+#include "common/datatypes/List.h"
+#include "common/datatypes/Value.h"
+
+namespace nebula {
+
+/**
+ * The state of an approximate aggregate, of which the memory is bounded regardless of the values
+ * added. The states of the same kind are mergeable, so the partial aggregates, e.g. of different
+ * parts, could be encoded, sent and combined.
+ */
+class AggSketch {
+ public:
+  virtual ~AggSketch() = default;
+
+  virtual void add(const Value& val) = 0;
+
+  virtual Value result() const = 0;
+
+  // Merge a sketch of the same kind and parameters
+  virtual void merge(const AggSketch& other) = 0;
+
+  virtual std::string encode() const = 0;
+
+  // Replace the state by the encoded one, return false if it is not valid
+  virtual bool decode(folly::StringPiece data) = 0;
+};
+
+/**
+ * HyperLogLog of the distinct values, the standard error is 1.04 / sqrt(2 ^ precision), which is
+ * 1.6% with the default precision taking 4KB
+ */
+class HyperLogLog final : public AggSketch {
+ public:
+  explicit HyperLogLog(uint8_t precision = 12);
+
+  void add(const Value& val) override;
+
+  Value result() const override;
+
+  void merge(const AggSketch& other) override;
+
+  std::string encode() const override;
+
+  bool decode(folly::StringPiece data) override;
+
+  int64_t estimate() const;
+
+ private:
+  uint8_t precision_;
+  std::vector<uint8_t> registers_;
+};
+
+/**
+ * The t-digest of the numbers, to estimate a quantile of them. The error is relative to
+ * q * (1 - q), so the tails such as p99 are more accurate than the median.
+ */
+class QuantileDigest final : public AggSketch {
+ public:
+  explicit QuantileDigest(double quantile, double compression = 100);
+
+  // Non numeric values should have been rejected by the caller
+  void add(const Value& val) override;
+
+  Value result() const override;
+
+  void merge(const AggSketch& other) override;
+
+  std::string encode() const override;
+
+  bool decode(folly::StringPiece data) override;
+
+  void add(double val, double weight = 1);
+
+  // NaN if no value is added
+  double estimate(double quantile) const;
+
+ private:
+  struct Centroid {
+    double mean;
+    double weight;
+  };
+
+  // Merge the buffered values into the centroids
+  void compress() const;
+
+  double quantile_;
+  double compression_;
+  double min_;
+  double max_;
+  // The digest is compressed on demand, which doesn't change the values represented
+  mutable std::vector<Centroid> centroids_;
+  mutable std::vector<Centroid> buffer_;
+};
+
+/**
+ * A uniform sample of the values without replacement, by reservoir sampling
+ */
+class ReservoirSample final : public AggSketch {
+ public:
+  explicit ReservoirSample(size_t capacity = 100) : capacity_(capacity) {}
+
+  void add(const Value& val) override;
+
+  Value result() const override;
+
+  void merge(const AggSketch& other) override;
+
+  std::string encode() const override;
+
+  bool decode(folly::StringPiece data) override;
+
+ private:
+  size_t capacity_;
+  // The number of values added, the sample stands for
+  int64_t seen_{0};
+  List sample_;
+};
+
+}  // namespace nebula
+
+#endif  // COMMON_FUNCTION_AGGSKETCH_H_
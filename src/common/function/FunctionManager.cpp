@@ -1161,7 +1161,7 @@ FunctionManager::FunctionManager() {
           return static_cast<int64_t>(value.length());
         }
         case Value::Type::PATH: {
-          auto path = args[0].get().getPath();
+          const auto &path = args[0].get().getPath();
           return static_cast<int64_t>(path.steps.size());
         }
         default: {
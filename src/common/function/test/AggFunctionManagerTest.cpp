@@ -26,6 +26,7 @@ class AggFunctionManagerTest : public ::testing::Test {
     for (auto i : groupData) {
       aggFunc(&aggData, i);
     }
+    aggData.finish();
     auto res = aggData.result();
     EXPECT_EQ(res.type(), expect.type()) << "agg function return type check failed: " << expr;
     EXPECT_EQ(res, expect) << "agg function return value check failed: " << expr;
@@ -125,6 +126,99 @@ TEST_F(AggFunctionManagerTest, aggFunc) {
     TEST_FUNCTION(collect_set, testData_["float"], Set({1.1, 2.2, 3.3}));
     TEST_FUNCTION(collect_set, testData_["mixed"], Set({1, 2.0}));
   }
+  {
+    TEST_FUNCTION(approx_count_distinct, testData_["empty"], 0);
+    TEST_FUNCTION(approx_count_distinct, testData_["null"], 0);
+    TEST_FUNCTION(approx_count_distinct, testData_["int"], 3);
+    TEST_FUNCTION(approx_count_distinct, testData_["float"], 3);
+    TEST_FUNCTION(approx_count_distinct, testData_["mixed"], 2);
+  }
+  {
+    TEST_FUNCTION(approx_median, testData_["empty"], Value::kNullValue);
+    TEST_FUNCTION(approx_median, testData_["null"], Value::kNullValue);
+    TEST_FUNCTION(approx_median, testData_["int"], 2.0);
+    TEST_FUNCTION(approx_median, testData_["float"], 2.2);
+    TEST_FUNCTION(approx_median, testData_["mixed"], 1.5);
+    TEST_FUNCTION(approx_p99, testData_["int"], 3.0);
+    TEST_FUNCTION(approx_median, std::vector<Value>({1, "a", 2}), Value::kNullBadType);
+  }
+  {
+    TEST_FUNCTION(reservoir_sample, testData_["empty"], List());
+    TEST_FUNCTION(reservoir_sample, testData_["null"], List());
+    TEST_FUNCTION(reservoir_sample, testData_["int"], List({1, 2, 3}));
+    TEST_FUNCTION(reservoir_sample, testData_["mixed"], List({1, 2.0}));
+  }
+}
+
+TEST_F(AggFunctionManagerTest, hyperLogLog) {
+  HyperLogLog all, first, second;
+  for (int64_t i = 0; i < 100000; i++) {
+    // Duplicates are not counted
+    all.add(i);
+    all.add(i);
+    (i % 2 == 0 ? first : second).add(folly::to<std::string>(i));
+    second.add(folly::to<std::string>(i / 4));
+  }
+  EXPECT_NEAR(100000, all.estimate(), 5000);
+  EXPECT_NEAR(50000, first.estimate(), 2500);
+
+  // The merged sketch is the one of the union
+  first.merge(second);
+  EXPECT_NEAR(100000, first.estimate(), 5000);
+
+  HyperLogLog decoded;
+  ASSERT_TRUE(decoded.decode(first.encode()));
+  EXPECT_EQ(first.estimate(), decoded.estimate());
+  EXPECT_FALSE(decoded.decode("bad"));
+}
+
+TEST_F(AggFunctionManagerTest, quantileDigest) {
+  std::vector<int64_t> values;
+  for (int64_t i = 1; i <= 100000; i++) {
+    values.emplace_back(i);
+  }
+  std::shuffle(values.begin(), values.end(), std::mt19937(0));
+  QuantileDigest all(0.5), first(0.5), second(0.5);
+  for (size_t i = 0; i < values.size(); i++) {
+    all.add(values[i]);
+    (i < values.size() / 3 ? first : second).add(values[i]);
+  }
+  EXPECT_NEAR(50000, all.estimate(0.5), 1000);
+  EXPECT_NEAR(99000, all.estimate(0.99), 200);
+  EXPECT_NEAR(99900, all.estimate(0.999), 50);
+  EXPECT_DOUBLE_EQ(1, all.estimate(0));
+  EXPECT_DOUBLE_EQ(100000, all.estimate(1));
+
+  first.merge(second);
+  EXPECT_NEAR(50000, first.estimate(0.5), 1000);
+  EXPECT_NEAR(99000, first.estimate(0.99), 200);
+
+  QuantileDigest decoded(0.9);
+  ASSERT_TRUE(decoded.decode(first.encode()));
+  EXPECT_EQ(first.result(), decoded.result());
+  EXPECT_TRUE(std::isnan(QuantileDigest(0.5).estimate(0.5)));
+}
+
+TEST_F(AggFunctionManagerTest, reservoirSample) {
+  ReservoirSample first(100), second(100);
+  for (int64_t i = 0; i < 10000; i++) {
+    first.add(i);
+  }
+  for (int64_t i = 0; i < 50; i++) {
+    second.add(-i);
+  }
+  auto sample = first.result().getList();
+  EXPECT_EQ(100, sample.size());
+  for (const auto& val : sample.values) {
+    EXPECT_TRUE(val.getInt() >= 0 && val.getInt() < 10000);
+  }
+
+  first.merge(second);
+  EXPECT_EQ(100, first.result().getList().size());
+
+  ReservoirSample decoded;
+  ASSERT_TRUE(decoded.decode(first.encode()));
+  EXPECT_EQ(first.result(), decoded.result());
 }
 
 }  // namespace nebula
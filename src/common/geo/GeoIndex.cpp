@@ -128,10 +128,22 @@ std::vector<ScanRange> GeoIndex::intersects(const S2Region& r, bool isPoint) con
   auto cells = coveringCells(r, isPoint);
   std::vector<ScanRange> scanRanges;
   for (const S2CellId& cellId : cells) {
+    auto min = cellId.range_min().id();
+    auto max = cellId.range_max().id();
+    // The covering is sorted, merge the ranges of the adjacent cells into one. The only id between
+    // them is of their common ancestor, whose rows are the candidates anyway.
+    if (!scanRanges.empty()) {
+      auto& last = scanRanges.back();
+      auto lastMax = last.isRangeScan ? last.rangeMax : last.rangeMin;
+      if (min == lastMax + 2) {
+        last = ScanRange(last.rangeMin, max);
+        continue;
+      }
+    }
     if (cellId.is_leaf()) {
       scanRanges.emplace_back(cellId.id());
     } else {
-      scanRanges.emplace_back(cellId.range_min().id(), cellId.range_max().id());
+      scanRanges.emplace_back(min, max);
     }
   }
 
@@ -306,6 +306,29 @@ TEST(indexCells, polygon) {
   }
 }
 
+TEST(intersects, mergeAdjacentCells) {
+  geo::RegionCoverParams rc(0, 30, 32);
+  geo::GeoIndex geoIndex(rc, true);
+  auto polygon =
+      Geography::fromWKT("POLYGON((1.0 1.0, 2.0 1.0, 2.0 2.0, 1.0 2.0, 1.0 1.0))").value();
+  auto ranges = geoIndex.intersects(polygon);
+  ASSERT_FALSE(ranges.empty());
+  for (size_t i = 1; i < ranges.size(); i++) {
+    auto lastMax = ranges[i - 1].isRangeScan ? ranges[i - 1].rangeMax : ranges[i - 1].rangeMin;
+    EXPECT_LT(lastMax + 2, ranges[i].rangeMin);
+  }
+  // The points in the polygon are still in the ranges
+  for (auto* wkt : {"POINT(1.1 1.1)", "POINT(1.5 1.5)", "POINT(1.9 1.2)", "POINT(1.01 1.99)"}) {
+    auto cells = geoIndex.indexCells(Geography::fromWKT(wkt).value());
+    ASSERT_EQ(1, cells.size());
+    auto cell = cells.front();
+    EXPECT_TRUE(std::any_of(ranges.begin(), ranges.end(), [cell](const auto& range) {
+      return range.isRangeScan ? range.rangeMin <= cell && cell <= range.rangeMax
+                               : range.rangeMin == cell;
+    })) << wkt;
+  }
+}
+
 }  // namespace geo
 }  // namespace nebula
 
@@ -0,0 +1,312 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/graph/JsonWriter.h"
+
+#include <folly/Conv.h>
+#include <folly/json.h>
+
+#include <cmath>
+
+namespace nebula {
+
+std::string JsonWriter::toJson(const ExecutionResponse& resp) {
+  static thread_local size_t lastSize = 0;
+  std::string out;
+  out.reserve(lastSize);
+  JsonWriter(&out).write(resp);
+  lastSize = out.size();
+  return out;
+}
+
+void JsonWriter::write(const ExecutionResponse& resp) {
+  out_->append("{\"results\":[{\"latencyInUs\":");
+  folly::toAppend(resp.latencyInUs, out_);
+  out_->append(",\"errors\":");
+  writeErrors(resp);
+  if (resp.data) {
+    out_->append(",\"columns\":[");
+    for (size_t i = 0; i < resp.data->colNames.size(); ++i) {
+      if (i > 0) {
+        out_->push_back(',');
+      }
+      writeString(resp.data->colNames[i]);
+    }
+    out_->append("],\"data\":");
+    write(*resp.data);
+  }
+  if (resp.spaceName) {
+    out_->append(",\"spaceName\":");
+    writeString(*resp.spaceName);
+  }
+  if (resp.planDesc) {
+    // The plan is small, not worth a writer of its own
+    out_->append(",\"planDesc\":");
+    out_->append(folly::toJson(resp.planDesc->toJson()));
+  }
+  if (resp.comment) {
+    out_->append(",\"comment\":");
+    writeString(*resp.comment);
+  }
+  out_->append("}],\"errors\":[");
+  writeErrors(resp);
+  out_->append("]}");
+}
+
+void JsonWriter::writeErrors(const ExecutionResponse& resp) {
+  out_->append("{\"code\":");
+  folly::toAppend(static_cast<int>(resp.errorCode), out_);
+  if (resp.errorMsg) {
+    out_->append(",\"message\":");
+    writeString(*resp.errorMsg);
+  }
+  out_->push_back('}');
+}
+
+void JsonWriter::write(const DataSet& ds) {
+  out_->push_back('[');
+  for (size_t i = 0; i < ds.rows.size(); ++i) {
+    if (i > 0) {
+      out_->push_back(',');
+    }
+    const auto& values = ds.rows[i].values;
+    out_->append("{\"row\":");
+    writeArray(values);
+    out_->append(",\"meta\":");
+    writeMetaDataArray(values);
+    out_->push_back('}');
+  }
+  out_->push_back(']');
+}
+
+void JsonWriter::write(const Value& value) {
+  switch (value.type()) {
+    case Value::Type::__EMPTY__: {
+      writeString("__EMPTY__");
+      return;
+    }
+    case Value::Type::NULLVALUE: {
+      out_->append("null");
+      return;
+    }
+    case Value::Type::BOOL: {
+      out_->append(value.getBool() ? "true" : "false");
+      return;
+    }
+    case Value::Type::INT: {
+      folly::toAppend(value.getInt(), out_);
+      return;
+    }
+    case Value::Type::FLOAT: {
+      auto f = value.getFloat();
+      if (std::isnan(f) || std::isinf(f)) {
+        out_->append("null");
+      } else {
+        folly::toAppend(f, out_);
+      }
+      return;
+    }
+    case Value::Type::STRING: {
+      writeString(value.getStr());
+      return;
+    }
+    case Value::Type::LIST: {
+      writeArray(value.getList().values);
+      return;
+    }
+    case Value::Type::SET: {
+      writeArray(value.getSet().values);
+      return;
+    }
+    case Value::Type::MAP: {
+      writeProps(value.getMap().kvs);
+      return;
+    }
+    case Value::Type::DATE: {
+      writeString(value.getDate().toString());
+      return;
+    }
+    case Value::Type::TIME: {
+      // 'Z' representing UTC timezone
+      writeString(value.getTime().toString() + "Z");
+      return;
+    }
+    case Value::Type::DATETIME: {
+      writeString(value.getDateTime().toString() + "Z");
+      return;
+    }
+    case Value::Type::EDGE: {
+      writeProps(value.getEdge().props);
+      return;
+    }
+    case Value::Type::VERTEX: {
+      writeVertexProps(value.getVertex());
+      return;
+    }
+    case Value::Type::PATH: {
+      const auto& path = value.getPath();
+      out_->push_back('[');
+      writeVertexProps(path.src);
+      for (const auto& step : path.steps) {
+        out_->push_back(',');
+        writeProps(step.props);
+        out_->push_back(',');
+        writeVertexProps(step.dst);
+      }
+      out_->push_back(']');
+      return;
+    }
+    case Value::Type::DATASET: {
+      write(value.getDataSet());
+      return;
+    }
+    case Value::Type::GEOGRAPHY: {
+      writeString(value.getGeography().toString());
+      return;
+    }
+    case Value::Type::DURATION: {
+      writeString(value.getDuration().toString());
+      return;
+    }
+      // no default so the compiler will warning when lack
+  }
+
+  LOG(FATAL) << "Unknown value type " << static_cast<int>(value.type());
+}
+
+void JsonWriter::writeMetaData(const Value& value) {
+  switch (value.type()) {
+    // Privative datatypes has no meta data
+    case Value::Type::__EMPTY__:
+    case Value::Type::BOOL:
+    case Value::Type::INT:
+    case Value::Type::FLOAT:
+    case Value::Type::STRING:
+    case Value::Type::DATASET:
+    case Value::Type::NULLVALUE:
+    case Value::Type::GEOGRAPHY: {
+      out_->append("null");
+      return;
+    }
+    // Extract the meta info of each element as the metadata of the container
+    case Value::Type::LIST: {
+      writeMetaDataArray(value.getList().values);
+      return;
+    }
+    case Value::Type::SET: {
+      writeMetaDataArray(value.getSet().values);
+      return;
+    }
+    case Value::Type::MAP: {
+      out_->push_back('[');
+      const auto& kvs = value.getMap().kvs;
+      for (auto it = kvs.begin(); it != kvs.end(); ++it) {
+        if (it != kvs.begin()) {
+          out_->push_back(',');
+        }
+        writeMetaData(it->second);
+      }
+      out_->push_back(']');
+      return;
+    }
+    case Value::Type::DURATION:
+    case Value::Type::DATE:
+    case Value::Type::TIME:
+    case Value::Type::DATETIME: {
+      out_->append("{\"type\":");
+      writeString(value.typeName());
+      out_->push_back('}');
+      return;
+    }
+    case Value::Type::VERTEX: {
+      writeVertexMetaData(value.getVertex());
+      return;
+    }
+    case Value::Type::EDGE: {
+      const auto& edge = value.getEdge();
+      writeEdgeMetaData(edge.src, edge.dst, edge.type, edge.name, edge.ranking);
+      return;
+    }
+    case Value::Type::PATH: {
+      // [vertex1_metadata, edge1_metadata, vertex2_metadata, edge2_metadata,....]
+      const auto& path = value.getPath();
+      out_->push_back('[');
+      writeVertexMetaData(path.src);
+      const auto* src = &path.src.vid;
+      for (const auto& step : path.steps) {
+        out_->push_back(',');
+        writeEdgeMetaData(*src, step.dst.vid, step.type, step.name, step.ranking);
+        out_->push_back(',');
+        writeVertexMetaData(step.dst);
+        src = &step.dst.vid;
+      }
+      out_->push_back(']');
+      return;
+    }
+  }
+
+  LOG(FATAL) << "Unknown value type " << static_cast<int>(value.type());
+}
+
+void JsonWriter::writeString(folly::StringPiece str) {
+  static const folly::json::serialization_opts opts;
+  folly::json::escapeString(str, *out_, opts);
+}
+
+void JsonWriter::writeProps(const std::unordered_map<std::string, Value>& props) {
+  out_->push_back('{');
+  for (auto it = props.begin(); it != props.end(); ++it) {
+    if (it != props.begin()) {
+      out_->push_back(',');
+    }
+    writeString(it->first);
+    out_->push_back(':');
+    write(it->second);
+  }
+  out_->push_back('}');
+}
+
+void JsonWriter::writeVertexProps(const Vertex& vertex) {
+  out_->push_back('{');
+  bool first = true;
+  for (const auto& tag : vertex.tags) {
+    for (const auto& prop : tag.props) {
+      if (!first) {
+        out_->push_back(',');
+      }
+      first = false;
+      writeString(tag.name + "." + prop.first);
+      out_->push_back(':');
+      write(prop.second);
+    }
+  }
+  out_->push_back('}');
+}
+
+void JsonWriter::writeVertexMetaData(const Vertex& vertex) {
+  out_->append("{\"id\":");
+  write(vertex.vid);
+  out_->append(",\"type\":\"vertex\"}");
+}
+
+void JsonWriter::writeEdgeMetaData(const Value& src,
+                                   const Value& dst,
+                                   EdgeType type,
+                                   const std::string& name,
+                                   EdgeRanking ranking) {
+  out_->append("{\"id\":{\"name\":");
+  writeString(name);
+  out_->append(",\"src\":");
+  write(src);
+  out_->append(",\"dst\":");
+  write(dst);
+  out_->append(",\"type\":");
+  folly::toAppend(type, out_);
+  out_->append(",\"ranking\":");
+  folly::toAppend(ranking, out_);
+  out_->append("},\"type\":\"edge\"}");
+}
+
+}  // namespace nebula
@@ -0,0 +1,83 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_GRAPH_JSONWRITER_H
+#define COMMON_GRAPH_JSONWRITER_H
+
+#include <folly/Range.h>
+
+#include <string>
+
+#include "common/graph/Response.h"
+
+namespace nebula {
+
+// Serializes the responses and the values into JSON text in one pass, the same as folly::toJson()
+// of their toJson(), but without building the folly::dynamic objects. A NaN or infinite float is
+// written as null, which folly::toJson() refuses to print.
+class JsonWriter final {
+ public:
+  explicit JsonWriter(std::string* out) : out_(out) {}
+
+  // Serialize the response into a new string, which is reserved by the size of the last response
+  // serialized in this thread, since the responses of a client are mostly alike in size
+  static std::string toJson(const ExecutionResponse& resp);
+
+  void write(const ExecutionResponse& resp);
+
+  // The rows of the dataset, each of which is an object of its values and their metadata
+  void write(const DataSet& ds);
+
+  void write(const Value& value);
+
+  void writeMetaData(const Value& value);
+
+ private:
+  void writeString(folly::StringPiece str);
+
+  void writeErrors(const ExecutionResponse& resp);
+
+  void writeProps(const std::unordered_map<std::string, Value>& props);
+
+  void writeVertexProps(const Vertex& vertex);
+
+  void writeVertexMetaData(const Vertex& vertex);
+
+  void writeEdgeMetaData(const Value& src,
+                         const Value& dst,
+                         EdgeType type,
+                         const std::string& name,
+                         EdgeRanking ranking);
+
+  template <typename Container>
+  void writeArray(const Container& values) {
+    out_->push_back('[');
+    for (auto it = values.begin(); it != values.end(); ++it) {
+      if (it != values.begin()) {
+        out_->push_back(',');
+      }
+      write(*it);
+    }
+    out_->push_back(']');
+  }
+
+  template <typename Container>
+  void writeMetaDataArray(const Container& values) {
+    out_->push_back('[');
+    for (auto it = values.begin(); it != values.end(); ++it) {
+      if (it != values.begin()) {
+        out_->push_back(',');
+      }
+      writeMetaData(*it);
+    }
+    out_->push_back(']');
+  }
+
+  std::string* out_;
+};
+
+}  // namespace nebula
+
+#endif  // COMMON_GRAPH_JSONWRITER_H
@@ -179,6 +179,7 @@
   X(E_INVALID_TASK_PARA, -3051)                                               \
   X(E_USER_CANCEL, -3052)                                                     \
   X(E_TASK_EXECUTION_FAILED, -3053)                                           \
+  X(E_RESOURCE_GROUP_OVERLOADED, -3054)                                       \
                                                                               \
   X(E_PLAN_IS_KILLED, -3060)                                                  \
   X(E_CLIENT_SERVER_INCOMPATIBLE, -3061)                                      \
@@ -12,6 +12,7 @@
 #include "common/graph/AuthResponseOps-inl.h"
 #include "common/graph/ExecutionResponseOps-inl.h"
 #include "common/graph/GraphCpp2Ops.h"
+#include "common/graph/JsonWriter.h"
 #include "common/graph/Response.h"
 
 namespace nebula {
@@ -164,4 +165,40 @@ TEST(ResponseEncodeDecodeTest, ToJson) {
     }
   }
 }
+
+TEST(ResponseEncodeDecodeTest, JsonWriter) {
+  Vertex v1("v1", {Tag("player", {{"name", "Tim \"Duncan\"\n"}, {"age", 42}})});
+  Vertex v2(2, {Tag("team", {{"name", "Spurs"}}), Tag("city", {})});
+  Edge e("v1", 2, 1, "serve", 0, {{"start", 1997}, {"ratio", 0.5}});
+  Path p(v1, {Step(v2, 1, "serve", 0, {{"start", 1997}}), Step(v1, -1, "serve", 3, {})});
+  DataSet inner({"a"});
+  inner.emplace_back(Row({Value(List({1, "x"}))}));
+
+  auto ds = std::make_unique<DataSet>(std::vector<std::string>{"v", "e", "p", "others"});
+  ds->emplace_back(Row({v1, e, p, List({Value::kNullValue, true, 1.5, Value::kEmpty})}));
+  ds->emplace_back(Row({v2,
+                        Map({{"k", v2}, {"d", Date(2020, 1, 2)}}),
+                        Set({Time(1, 2, 3, 4), DateTime(2020, 1, 2, 3, 4, 5, 6)}),
+                        Value(std::move(inner))}));
+  ds->emplace_back(Row({Value::kNullValue, Duration(1, 2, 3), "", -7}));
+
+  std::vector<ExecutionResponse> resps;
+  resps.emplace_back(ExecutionResponse{});
+  resps.emplace_back(ExecutionResponse{ErrorCode::SUCCEEDED,
+                                       233,
+                                       std::move(ds),
+                                       std::make_unique<std::string>("test_space"),
+                                       nullptr,
+                                       std::make_unique<PlanDescription>(),
+                                       std::make_unique<std::string>("comment")});
+  resps.emplace_back(ExecutionResponse{ErrorCode::E_SYNTAX_ERROR,
+                                       233,
+                                       std::make_unique<DataSet>(),
+                                       nullptr,
+                                       std::make_unique<std::string>("Error \"Msg\".")});
+  for (const auto &resp : resps) {
+    auto json = JsonWriter::toJson(resp);
+    EXPECT_EQ(resp.toJson(), folly::parseJson(json)) << json;
+  }
+}
 }  // namespace nebula
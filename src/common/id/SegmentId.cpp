@@ -7,62 +7,114 @@
 
 namespace nebula {
 
+SegmentId::~SegmentId() {
+  std::unique_lock<std::mutex> guard(mutex_);
+  cond_.wait(guard, [this] { return !fetching_; });
+}
+
 StatusOr<int64_t> SegmentId::getId() {
-  std::lock_guard<std::mutex> guard(mutex_);
+  auto* local = local_.get();
+  if (local->next >= local->end) {
+    NG_RETURN_IF_ERROR(refill(local));
+  }
+  return local->next++;
+}
 
-  if (cur_ < segmentStart_ + step_ - 1) {
-    // non-block prefetch next segment
-    if (cur_ == segmentStart_ + (step_ / 2) - 1) {
-      asyncFetchSegment();
-    }
-    cur_ += 1;
-  } else {  // cur == segment end
-    if (segmentStart_ >= nextSegmentStart_) {
-      // indicate asyncFetchSegment() failed or fetchSegment() slow
-      LOG(ERROR)
-          << "segmentId asyncFetchSegment() failed or slow(step is too small), segmentStart_: "
-          << segmentStart_ << ", nextSegmentStart_: " << nextSegmentStart_;
-      auto xRet = fetchSegment();
-      NG_RETURN_IF_ERROR(xRet);
-      nextSegmentStart_ = xRet.value();
-    }
-    segmentStart_ = nextSegmentStart_;
-    cur_ = segmentStart_;
+Status SegmentId::refill(LocalRange* local) {
+  std::unique_lock<std::mutex> guard(mutex_);
+  if (step_ <= 0) {
+    return Status::Error("SegmentId is not initialized");
+  }
+  if (cur_ >= segmentEnd_) {
+    NG_RETURN_IF_ERROR(nextSegment(guard));
+  }
+
+  auto batch = std::max<int64_t>(1, std::min(kMaxLocalBatch_, step_ / 64));
+  local->next = cur_;
+  local->end = std::min(cur_ + batch, segmentEnd_);
+  cur_ = local->end;
+
+  // non-block prefetch next segment
+  if (segmentEnd_ - cur_ <= step_ / 2 && nextSegmentStart_ < 0 && !fetching_) {
+    asyncFetchSegment();
+  }
+  return Status::OK();
+}
+
+Status SegmentId::nextSegment(std::unique_lock<std::mutex>& guard) {
+  cond_.wait(guard, [this] { return !fetching_; });
+  // another thread may have switched while waiting
+  if (cur_ < segmentEnd_) {
+    return Status::OK();
+  }
+
+  if (nextSegmentStart_ < 0) {
+    // indicate asyncFetchSegment() failed or the segment is used up before it's issued
+    LOG(ERROR) << "segmentId asyncFetchSegment() failed or slow(step is too small), "
+               << "segment end: " << segmentEnd_ << ", step: " << step_;
+    auto xRet = fetchSegment(step_);
+    NG_RETURN_IF_ERROR(xRet);
+    nextSegmentStart_ = xRet.value();
+    nextSegmentLength_ = step_;
   }
+  adjustStep();
 
-  return cur_;
+  cur_ = nextSegmentStart_;
+  segmentEnd_ = nextSegmentStart_ + nextSegmentLength_;
+  nextSegmentStart_ = -1;
+  return Status::OK();
+}
+
+void SegmentId::adjustStep() {
+  auto now = std::chrono::steady_clock::now();
+  auto elapsed = now - segmentBegin_;
+  segmentBegin_ = now;
+  if (elapsed < kSegmentTime_ / 2) {
+    step_ = std::min(step_ * 2, minStep_ * kMaxStepTimes_);
+  } else if (elapsed > kSegmentTime_ * 2) {
+    step_ = std::max(step_ / 2, minStep_);
+  }
 }
 
 void SegmentId::asyncFetchSegment() {
-  auto future = client_->getSegmentId(step_);
-  std::move(future).via(runner_).thenValue([this](StatusOr<int64_t> resp) {
-    NG_RETURN_IF_ERROR(resp);
-    if (!resp.value()) {
-      return Status::Error("asyncFetchSegment failed!");
+  fetching_ = true;
+  auto length = step_;
+  auto future = client_->getSegmentId(length);
+  std::move(future).via(runner_).thenTry([this, length](auto&& t) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (t.hasException()) {
+      LOG(ERROR) << "asyncFetchSegment failed: " << t.exception().what();
+    } else if (!t.value().ok()) {
+      LOG(ERROR) << "asyncFetchSegment failed: " << t.value().status();
+    } else {
+      nextSegmentStart_ = t.value().value();
+      nextSegmentLength_ = length;
     }
-    this->nextSegmentStart_ = resp.value();
-    return Status::OK();
+    fetching_ = false;
+    cond_.notify_all();
   });
 }
 
-StatusOr<int64_t> SegmentId::fetchSegment() {
-  auto result = client_->getSegmentId(step_).get();
+StatusOr<int64_t> SegmentId::fetchSegment(int64_t length) {
+  auto result = client_->getSegmentId(length).get();
 
   NG_RETURN_IF_ERROR(result);
   return result.value();
 }
 
 Status SegmentId::init(int64_t step) {
+  minStep_ = step;
   step_ = step;
   if (step < kMinStep_) {
     return Status::Error("Step is too small");
   }
 
-  auto xRet = fetchSegment();
+  auto xRet = fetchSegment(step_);
   NG_RETURN_IF_ERROR(xRet);
 
-  segmentStart_ = xRet.value();
-  cur_ = segmentStart_ - 1;
+  cur_ = xRet.value();
+  segmentEnd_ = cur_ + step_;
+  segmentBegin_ = std::chrono::steady_clock::now();
 
   return Status::OK();
 }
@@ -6,16 +6,31 @@
 #ifndef COMMON_ID_SEGMENTINCR_H_
 #define COMMON_ID_SEGMENTINCR_H_
 
+#include <folly/ThreadLocal.h>
+
+#include <chrono>
+#include <condition_variable>
+
 #include "clients/meta/MetaClient.h"
 
 namespace nebula {
 // Segment auto-increase id
+//
+// Each thread takes a small range of ids from the current segment into its own buffer, and serves
+// the ids from it without any lock, so the mutex is only taken once per range. The ids are unique,
+// and increase in a thread, but not across the threads, and the ids left in the buffer of an exited
+// thread are skipped.
+//
+// The next segment is fetched in the background when half of the current one is used. Its length
+// doubles if a segment is used up quicker than expected, and halves back towards the initial step
+// if slower.
 class SegmentId {
  public:
   SegmentId(meta::BaseMetaClient* client, folly::Executor* runner)
       : client_(client), runner_(runner) {}
 
-  ~SegmentId() = default;
+  // wait for the fetch in flight, of which the callback refers to this
+  ~SegmentId();
 
   SegmentId(const SegmentId&) = delete;
 
@@ -26,24 +41,56 @@ class SegmentId {
   StatusOr<int64_t> getId();
 
  private:
-  // when get id fast or fetchSegment() slow or fail, getSegmentId() directly.
-  // In this case, the new segment will overlap with the old one.
+  struct LocalRange {
+    int64_t next{0};
+    int64_t end{0};
+  };
+
+  // take a range of ids from the segment into the buffer of the thread
+  Status refill(LocalRange* local);
+
+  // switch to the next segment, wait for the fetch in flight, or fetch synchronously if there is
+  // none or it failed. In the latter case, the new segment overlaps with the old one.
+  Status nextSegment(std::unique_lock<std::mutex>& guard);
+
+  void adjustStep();
+
   void asyncFetchSegment();
 
-  StatusOr<int64_t> fetchSegment();
+  StatusOr<int64_t> fetchSegment(int64_t length);
 
   std::mutex mutex_;
+  std::condition_variable cond_;
 
-  int64_t cur_{-1};
+  // the initial step, which the step won't be less than
+  int64_t minStep_{-1};
   int64_t step_{-1};
 
-  int64_t segmentStart_{-2};
-  int64_t nextSegmentStart_{-2};
+  // the ids in [cur_, segmentEnd_) of the current segment are not taken by any thread yet
+  int64_t cur_{0};
+  int64_t segmentEnd_{0};
+  std::chrono::steady_clock::time_point segmentBegin_;
+
+  // the fetched next segment, nextSegmentStart_ is -1 if none
+  int64_t nextSegmentStart_{-1};
+  int64_t nextSegmentLength_{0};
+  bool fetching_{false};
+
+  folly::ThreadLocal<LocalRange> local_;
 
   // ensure the segment can be use for 10 mins.
   // 2 segment = max insert/secs * 600. segment = 400000 * 600 / 2 = 120000000
   static inline constexpr int64_t kMinStep_{120000000};
 
+  // the expected time to use up a segment, see kMinStep_
+  static inline constexpr std::chrono::seconds kSegmentTime_{300};
+
+  // the step grows up to kMaxStepTimes_ times of the initial one
+  static inline constexpr int64_t kMaxStepTimes_{64};
+
+  // the ids a thread takes at a time, no more than 1/64 of the segment
+  static inline constexpr int64_t kMaxLocalBatch_{1024};
+
   meta::BaseMetaClient* client_;
   folly::Executor* runner_;
 };
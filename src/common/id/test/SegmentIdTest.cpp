@@ -76,10 +76,41 @@ TEST_F(TestSegmentId, TestConcurrencyBigStep) {
     threads_[i].join();
   }
 
-  // check the result
-  for (int i = 0; i < (times_ * threadNum_); i++) {
-    ASSERT_TRUE(map_.find(i) != map_.end()) << "id: " << i;
+  // check the result, the ids left in the buffers of the threads are skipped
+  ASSERT_EQ(times_ * threadNum_, map_.size());
+  for (auto iter = map_.begin(); iter != map_.end(); ++iter) {
+    ASSERT_GE(iter->first, 0);
+    ASSERT_LT(iter->first, times_ * threadNum_ + threadNum_ * 1024) << "id: " << iter->first;
   }
 }
 
+TEST_F(TestSegmentId, TestIncreasingInThread) {
+  SegmentId generator = SegmentId(&metaClient_, threadManager_.get());
+  Status status = generator.init(120000000);
+  ASSERT_TRUE(status.ok());
+
+  auto proc = [&]() {
+    int64_t last = -1;
+    for (int i = 0; i < times_; i++) {
+      StatusOr<int64_t> id = generator.getId();
+      ASSERT_TRUE(id.ok());
+      ASSERT_GT(id.value(), last);
+      last = id.value();
+    }
+  };
+
+  for (int i = 0; i < threadNum_; i++) {
+    threads_.emplace_back(std::thread(proc));
+  }
+
+  for (int i = 0; i < threadNum_; i++) {
+    threads_[i].join();
+  }
+}
+
+TEST_F(TestSegmentId, TestNotInitialized) {
+  SegmentId generator = SegmentId(&metaClient_, threadManager_.get());
+  ASSERT_FALSE(generator.getId().ok());
+}
+
 }  // namespace nebula
@@ -0,0 +1,82 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/memory/MemoryTracker.h"
+
+namespace nebula {
+
+MemoryTracker::MemoryTracker(std::string name,
+                             int64_t limit,
+                             std::shared_ptr<MemoryTracker> parent)
+    : name_(std::move(name)), limit_(limit), parent_(std::move(parent)) {}
+
+MemoryTracker::~MemoryTracker() {
+  auto bytes = used();
+  for (auto* tracker = parent_.get(); tracker != nullptr; tracker = tracker->parent_.get()) {
+    tracker->used_.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+}
+
+Status MemoryTracker::consume(int64_t bytes) {
+  for (auto* tracker = this; tracker != nullptr; tracker = tracker->parent_.get()) {
+    if (!tracker->tryConsume(bytes)) {
+      // Roll back the trackers consumed
+      for (auto* consumed = this; consumed != tracker; consumed = consumed->parent_.get()) {
+        consumed->used_.fetch_sub(bytes, std::memory_order_relaxed);
+      }
+      return Status::Error("Used memory of %s exceeds the limit(%ld bytes)",
+                           tracker->name_.c_str(),
+                           tracker->limit());
+    }
+  }
+  return Status::OK();
+}
+
+void MemoryTracker::forceConsume(int64_t bytes) {
+  for (auto* tracker = this; tracker != nullptr; tracker = tracker->parent_.get()) {
+    auto used = tracker->used_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    auto peak = tracker->peak_.load(std::memory_order_relaxed);
+    while (used > peak &&
+           !tracker->peak_.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {
+    }
+  }
+}
+
+void MemoryTracker::release(int64_t bytes) {
+  for (auto* tracker = this; tracker != nullptr; tracker = tracker->parent_.get()) {
+    tracker->used_.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+}
+
+bool MemoryTracker::tryConsume(int64_t bytes) {
+  auto used = used_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  auto limit = this->limit();
+  if (limit > 0 && used > limit) {
+    used_.fetch_sub(bytes, std::memory_order_relaxed);
+    return false;
+  }
+  auto peak = peak_.load(std::memory_order_relaxed);
+  while (used > peak && !peak_.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {
+  }
+  return true;
+}
+
+// static
+std::shared_ptr<MemoryTracker> MemoryTracker::process() {
+  static auto tracker = std::make_shared<MemoryTracker>("process", 0);
+  return tracker;
+}
+
+// static
+StatusOr<std::shared_ptr<MemoryReservation>> MemoryReservation::reserve(
+    std::shared_ptr<MemoryTracker> tracker, int64_t bytes) {
+  auto status = tracker->consume(bytes);
+  if (!status.ok()) {
+    return status;
+  }
+  return std::shared_ptr<MemoryReservation>(new MemoryReservation(std::move(tracker), bytes));
+}
+
+}  // namespace nebula
@@ -0,0 +1,118 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_MEMORY_MEMORYTRACKER_H
+#define COMMON_MEMORY_MEMORYTRACKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common/base/StatusOr.h"
+
+namespace nebula {
+
+/**
+ * MemoryTracker accounts the memory used by a scope, e.g. a session, a query or an executor.
+ * The trackers form a tree rooted at the process tracker, the memory consumed by a tracker is
+ * consumed by all its ancestors too. Consuming fails if it would exceed the limit of any of
+ * them, so only the scope hitting the limit fails instead of the whole process.
+ */
+class MemoryTracker final {
+ public:
+  /**
+   * @param name Used in the error message
+   * @param limit Max bytes could be consumed, no limit if it's not positive
+   * @param parent Parent tracker, it's kept alive by the children
+   */
+  MemoryTracker(std::string name,
+                int64_t limit,
+                std::shared_ptr<MemoryTracker> parent = nullptr);
+
+  // The memory still consumed by the tracker is released from the ancestors
+  ~MemoryTracker();
+
+  /**
+   * @brief Consume the memory from the tracker and all its ancestors, nothing is consumed if
+   * any of them would exceed the limit.
+   */
+  Status consume(int64_t bytes);
+
+  /**
+   * @brief Consume the memory whatever the limits are, e.g. the memory of the data which has been
+   * taken and must be kept.
+   */
+  void forceConsume(int64_t bytes);
+
+  void release(int64_t bytes);
+
+  int64_t used() const {
+    return used_.load(std::memory_order_relaxed);
+  }
+
+  int64_t peak() const {
+    return peak_.load(std::memory_order_relaxed);
+  }
+
+  int64_t limit() const {
+    return limit_.load(std::memory_order_relaxed);
+  }
+
+  void setLimit(int64_t limit) {
+    limit_.store(limit, std::memory_order_relaxed);
+  }
+
+  const std::string& name() const {
+    return name_;
+  }
+
+  const std::shared_ptr<MemoryTracker>& parent() const {
+    return parent_;
+  }
+
+  // The root of all trackers in the process
+  static std::shared_ptr<MemoryTracker> process();
+
+ private:
+  MemoryTracker(const MemoryTracker&) = delete;
+  void operator=(const MemoryTracker&) = delete;
+
+  // Consume from this tracker only
+  bool tryConsume(int64_t bytes);
+
+  std::string name_;
+  std::atomic<int64_t> limit_;
+  std::atomic<int64_t> used_{0};
+  std::atomic<int64_t> peak_{0};
+  std::shared_ptr<MemoryTracker> parent_;
+};
+
+/**
+ * The memory consumed from a tracker, which is released when the reservation is destroyed.
+ */
+class MemoryReservation final {
+ public:
+  static StatusOr<std::shared_ptr<MemoryReservation>> reserve(
+      std::shared_ptr<MemoryTracker> tracker, int64_t bytes);
+
+  ~MemoryReservation() {
+    tracker_->release(bytes_);
+  }
+
+  int64_t bytes() const {
+    return bytes_;
+  }
+
+ private:
+  MemoryReservation(std::shared_ptr<MemoryTracker> tracker, int64_t bytes)
+      : tracker_(std::move(tracker)), bytes_(bytes) {}
+
+  std::shared_ptr<MemoryTracker> tracker_;
+  int64_t bytes_;
+};
+
+}  // namespace nebula
+#endif
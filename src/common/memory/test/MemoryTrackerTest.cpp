@@ -0,0 +1,64 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/memory/MemoryTracker.h"
+
+namespace nebula {
+
+TEST(MemoryTrackerTest, ConsumeAndRelease) {
+  auto root = std::make_shared<MemoryTracker>("root", 0);
+  auto child = std::make_shared<MemoryTracker>("child", 100, root);
+  ASSERT_TRUE(child->consume(60).ok());
+  EXPECT_EQ(60, child->used());
+  EXPECT_EQ(60, root->used());
+
+  // Exceeds the limit of the child, nothing is consumed
+  EXPECT_FALSE(child->consume(50).ok());
+  EXPECT_EQ(60, child->used());
+  EXPECT_EQ(60, root->used());
+
+  child->release(20);
+  EXPECT_EQ(40, child->used());
+  EXPECT_EQ(40, root->used());
+  EXPECT_EQ(60, child->peak());
+
+  // The memory still used is released from the parent when the child is destroyed
+  child.reset();
+  EXPECT_EQ(0, root->used());
+}
+
+TEST(MemoryTrackerTest, LimitOfAncestor) {
+  auto root = std::make_shared<MemoryTracker>("root", 0);
+  auto session = std::make_shared<MemoryTracker>("session", 100, root);
+  auto query1 = std::make_shared<MemoryTracker>("query1", 80, session);
+  auto query2 = std::make_shared<MemoryTracker>("query2", 80, session);
+  ASSERT_TRUE(query1->consume(70).ok());
+  // Within the limit of query2, but exceeds the one of the session
+  auto status = query2->consume(70);
+  ASSERT_FALSE(status.ok());
+  EXPECT_NE(std::string::npos, status.toString().find("session"));
+  EXPECT_EQ(0, query2->used());
+  EXPECT_EQ(70, session->used());
+  EXPECT_EQ(70, root->used());
+
+  ASSERT_TRUE(query2->consume(30).ok());
+  EXPECT_EQ(100, session->used());
+}
+
+TEST(MemoryTrackerTest, Reservation) {
+  auto root = std::make_shared<MemoryTracker>("root", 100);
+  {
+    auto reservation = MemoryReservation::reserve(root, 80);
+    ASSERT_TRUE(reservation.ok());
+    EXPECT_EQ(80, root->used());
+    EXPECT_FALSE(MemoryReservation::reserve(root, 80).ok());
+  }
+  EXPECT_EQ(0, root->used());
+  EXPECT_TRUE(MemoryReservation::reserve(root, 80).ok());
+}
+
+}  // namespace nebula
@@ -0,0 +1,197 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_STATS_HDRHISTOGRAM_H_
+#define COMMON_STATS_HDRHISTOGRAM_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace nebula {
+namespace stats {
+
+/**
+ * @brief The layout of log-linear buckets like HdrHistogram: the values below 2^kSubBucketBits
+ * have a bucket each, and every power of two above is split into 2^kSubBucketBits buckets of the
+ * same width. So the relative error of a bucket is at most 1/32 whatever the value is, and no
+ * range needs to be configured. Values above kMaxValue fall into the last bucket.
+ */
+struct HdrLayout {
+  static constexpr int kSubBucketBits = 5;
+  static constexpr int64_t kSubBuckets = 1L << kSubBucketBits;
+  static constexpr int kMaxBits = 40;
+  static constexpr int64_t kMaxValue = (1L << kMaxBits) - 1;
+  static constexpr size_t kNumBuckets = (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+
+  static size_t index(int64_t value) {
+    if (value < kSubBuckets) {
+      return value < 0 ? 0 : static_cast<size_t>(value);
+    }
+    value = std::min(value, kMaxValue);
+    int msb = 63 - __builtin_clzll(static_cast<uint64_t>(value));
+    int shift = msb - kSubBucketBits;
+    return static_cast<size_t>((shift + 1) * kSubBuckets + ((value >> shift) - kSubBuckets));
+  }
+
+  // The smallest value of the bucket
+  static int64_t lowerBound(size_t index) {
+    auto idx = static_cast<int64_t>(index);
+    if (idx < 2 * kSubBuckets) {
+      return idx;
+    }
+    int64_t shift = idx / kSubBuckets - 1;
+    return (kSubBuckets + idx % kSubBuckets) << shift;
+  }
+
+  static int64_t width(size_t index) {
+    auto idx = static_cast<int64_t>(index);
+    return idx < 2 * kSubBuckets ? 1 : 1L << (idx / kSubBuckets - 1);
+  }
+};
+
+/**
+ * @brief The counts of values in the log-linear buckets, which only grows to the largest bucket
+ * used, so a histogram of small values is small
+ */
+class HdrHistogram final {
+ public:
+  void add(size_t index, uint64_t count) {
+    if (index >= counts_.size()) {
+      counts_.resize(index + 1, 0);
+    }
+    counts_[index] += count;
+    total_ += count;
+  }
+
+  void merge(const HdrHistogram& other) {
+    for (size_t i = 0; i < other.counts_.size(); i++) {
+      if (other.counts_[i] != 0) {
+        add(i, other.counts_[i]);
+      }
+    }
+  }
+
+  void clear() {
+    counts_.clear();
+    total_ = 0;
+  }
+
+  uint64_t count() const {
+    return total_;
+  }
+
+  // The count of each bucket, the buckets after the last one are empty
+  const std::vector<uint64_t>& buckets() const {
+    return counts_;
+  }
+
+  /**
+   * @brief Estimate the value at the percentile, interpolating in the bucket where it falls
+   *
+   * @param pct In the range of [0, 100]
+   */
+  int64_t percentile(double pct) const {
+    if (total_ == 0) {
+      return 0;
+    }
+    double rank = std::clamp(pct, 0.0, 100.0) / 100.0 * static_cast<double>(total_);
+    uint64_t below = 0;
+    for (size_t i = 0; i < counts_.size(); i++) {
+      if (counts_[i] == 0) {
+        continue;
+      }
+      if (static_cast<double>(below + counts_[i]) > rank) {
+        auto width = HdrLayout::width(i);
+        double inBucket = (rank - static_cast<double>(below)) / static_cast<double>(counts_[i]);
+        auto offset = static_cast<int64_t>(inBucket * static_cast<double>(width));
+        return HdrLayout::lowerBound(i) + std::clamp<int64_t>(offset, 0, width - 1);
+      }
+      below += counts_[i];
+    }
+    return HdrLayout::lowerBound(counts_.size() - 1);
+  }
+
+ private:
+  std::vector<uint64_t> counts_;
+  uint64_t total_{0};
+};
+
+/**
+ * @brief The histograms of the last 5 seconds, 1 minute, 10 minutes and 1 hour. The values are
+ * kept in rings of slots, and a level merges the slots in its duration, so the window of a level
+ * moves by the width of a slot. The first two levels share the ring of one second slots. It is not
+ * thread safe.
+ */
+class WindowedHdrHistogram final {
+ public:
+  static constexpr size_t kNumLevels = 4;
+
+  WindowedHdrHistogram() {
+    rings_[0].init(1, 60);
+    rings_[1].init(60, 10);
+    rings_[2].init(300, 12);
+  }
+
+  void add(int64_t nowSec, size_t index, uint64_t count) {
+    for (auto& ring : rings_) {
+      ring.slot(nowSec).add(index, count);
+    }
+  }
+
+  int64_t percentile(size_t level, int64_t nowSec, double pct) const {
+    // {ring, number of slots} of each level
+    static constexpr std::array<std::pair<size_t, int64_t>, kNumLevels> kLevels = {
+        {{0, 5}, {0, 60}, {1, 10}, {2, 12}}};
+    const auto& [ringIdx, numSlots] = kLevels[std::min(level, kNumLevels - 1)];
+    const auto& ring = rings_[ringIdx];
+    auto current = nowSec / ring.slotSec;
+    HdrHistogram merged;
+    for (const auto& slot : ring.slots) {
+      if (slot.epoch <= current && slot.epoch > current - numSlots) {
+        merged.merge(slot.histogram);
+      }
+    }
+    return merged.percentile(pct);
+  }
+
+ private:
+  struct Slot {
+    int64_t epoch{-1};
+    HdrHistogram histogram;
+
+    void add(size_t index, uint64_t count) {
+      histogram.add(index, count);
+    }
+  };
+
+  struct Ring {
+    int64_t slotSec{1};
+    std::vector<Slot> slots;
+
+    void init(int64_t sec, size_t num) {
+      slotSec = sec;
+      slots.resize(num);
+    }
+
+    Slot& slot(int64_t nowSec) {
+      auto epoch = nowSec / slotSec;
+      auto& s = slots[epoch % slots.size()];
+      if (s.epoch != epoch) {
+        s.epoch = epoch;
+        s.histogram.clear();
+      }
+      return s;
+    }
+  };
+
+  std::array<Ring, 3> rings_;
+};
+
+}  // namespace stats
+}  // namespace nebula
+#endif  // COMMON_STATS_HDRHISTOGRAM_H_
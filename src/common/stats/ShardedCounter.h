@@ -0,0 +1,179 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_STATS_SHARDEDCOUNTER_H_
+#define COMMON_STATS_SHARDEDCOUNTER_H_
+
+#include <folly/lang/Align.h>
+#include <folly/stats/MultiLevelTimeSeries.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+#include "common/stats/HdrHistogram.h"
+#include "common/time/WallClock.h"
+
+namespace nebula {
+namespace stats {
+
+/**
+ * @brief A counter or histogram of StatsManager.
+ *
+ * A value is added to the shard of the adding thread by atomic operations, no lock is taken and
+ * threads seldom share a cache line. The shards are merged into the time series when the second
+ * changes or the counter is read, so a value may be accounted to the next second. The histogram
+ * uses log-linear buckets, so the percentiles of any value are precise to about 3%. Besides the
+ * windows, the totals since started are kept for the exporters which compute the rates themselves.
+ */
+class ShardedCounter final {
+ public:
+  using VT = int64_t;
+  using TimeSeries = folly::MultiLevelTimeSeries<VT>;
+
+  explicit ShardedCounter(bool isHisto)
+      : isHisto_(isHisto),
+        series_(60,
+                {std::chrono::seconds(5),
+                 std::chrono::seconds(60),
+                 std::chrono::seconds(600),
+                 std::chrono::seconds(3600)}) {}
+
+  ShardedCounter(const ShardedCounter&) = delete;
+  ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+  // The values since the counter is registered
+  struct Totals {
+    VT sum{0};
+    uint64_t count{0};
+    // Whether any value added is negative, i.e. the counter is a gauge
+    bool decreased{false};
+    HdrHistogram histogram;
+  };
+
+  bool isHisto() const {
+    return isHisto_;
+  }
+
+  void addValue(VT value) {
+    auto nowSec = time::WallClock::fastNowInSec();
+    auto lastSec = lastSec_.load(std::memory_order_relaxed);
+    if (nowSec != lastSec && lastSec_.compare_exchange_strong(lastSec, nowSec)) {
+      // The values in shards were added in the last second
+      std::lock_guard<std::mutex> guard(lock_);
+      merge(lastSec);
+    }
+    if (value < 0 && !decreased_.load(std::memory_order_relaxed)) {
+      decreased_.store(true, std::memory_order_relaxed);
+    }
+    auto& shard = shards_[shardIndex()];
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    if (isHisto_) {
+      shard.buckets()[HdrLayout::index(value)].fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Read the counter after merging the shards
+   *
+   * @param reader Called with the time series, the windowed histogram and the current second
+   */
+  template <class Reader>
+  auto read(Reader&& reader) {
+    auto nowSec = time::WallClock::fastNowInSec();
+    std::lock_guard<std::mutex> guard(lock_);
+    merge(lastSec_.load(std::memory_order_relaxed));
+    series_.update(std::chrono::seconds(nowSec));
+    return reader(series_, histogram_, nowSec);
+  }
+
+  Totals totals() {
+    std::lock_guard<std::mutex> guard(lock_);
+    merge(lastSec_.load(std::memory_order_relaxed));
+    Totals totals = totals_;
+    totals.decreased = decreased_.load(std::memory_order_relaxed);
+    return totals;
+  }
+
+ private:
+  static constexpr size_t kNumShards = 16;
+
+  struct alignas(folly::hardware_destructive_interference_size) Shard {
+    std::atomic<VT> sum{0};
+    std::atomic<uint64_t> count{0};
+    // The counts of histogram buckets, allocated when used
+    std::atomic<std::atomic<uint32_t>*> bucketCounts{nullptr};
+
+    ~Shard() {
+      delete[] bucketCounts.load();
+    }
+
+    std::atomic<uint32_t>* buckets() {
+      auto* counts = bucketCounts.load(std::memory_order_acquire);
+      if (counts != nullptr) {
+        return counts;
+      }
+      auto* allocated = new std::atomic<uint32_t>[HdrLayout::kNumBuckets];
+      for (size_t i = 0; i < HdrLayout::kNumBuckets; i++) {
+        allocated[i].store(0, std::memory_order_relaxed);
+      }
+      if (!bucketCounts.compare_exchange_strong(counts, allocated)) {
+        // Allocated by another thread sharing this shard
+        delete[] allocated;
+        return counts;
+      }
+      return allocated;
+    }
+  };
+
+  static size_t shardIndex() {
+    static std::atomic<size_t> nextIndex{0};
+    thread_local size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+    return index;
+  }
+
+  // Move the values in shards to the time series and histogram, lock_ must be held
+  void merge(int64_t sec) {
+    auto timePoint = std::chrono::seconds(sec);
+    for (auto& shard : shards_) {
+      auto count = shard.count.exchange(0, std::memory_order_relaxed);
+      auto sum = shard.sum.exchange(0, std::memory_order_relaxed);
+      if (count != 0 || sum != 0) {
+        series_.addValueAggr(timePoint, sum, count);
+        totals_.sum += sum;
+        totals_.count += count;
+      }
+      auto* counts = shard.bucketCounts.load(std::memory_order_acquire);
+      if (counts == nullptr) {
+        continue;
+      }
+      for (size_t i = 0; i < HdrLayout::kNumBuckets; i++) {
+        if (counts[i].load(std::memory_order_relaxed) != 0) {
+          auto n = counts[i].exchange(0, std::memory_order_relaxed);
+          histogram_.add(sec, i, n);
+          totals_.histogram.add(i, n);
+        }
+      }
+    }
+  }
+
+ private:
+  const bool isHisto_;
+  std::atomic<bool> decreased_{false};
+  std::atomic<int64_t> lastSec_{0};
+  std::array<Shard, kNumShards> shards_;
+
+  std::mutex lock_;
+  TimeSeries series_;
+  WindowedHdrHistogram histogram_;
+  Totals totals_;
+};
+
+}  // namespace stats
+}  // namespace nebula
+#endif  // COMMON_STATS_SHARDEDCOUNTER_H_
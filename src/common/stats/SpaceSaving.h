@@ -0,0 +1,137 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_STATS_SPACESAVING_H_
+#define COMMON_STATS_SPACESAVING_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nebula {
+namespace stats {
+
+/**
+ * @brief The heavy hitters of a stream by the Space-Saving algorithm. At most capacity keys are
+ * counted, a new key replaces the key of the smallest count and inherits its count as the error.
+ * So the count of a key is overestimated by at most its error, and any key whose weight is more
+ * than total / capacity is always counted. It is not thread safe.
+ */
+template <typename Key, typename Hash = std::hash<Key>>
+class SpaceSaving final {
+ public:
+  struct Counter {
+    Key key;
+    uint64_t count{0};
+    // The count may be overestimated by so much
+    uint64_t error{0};
+  };
+
+  explicit SpaceSaving(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
+
+  void add(const Key& key, uint64_t weight = 1) {
+    auto iter = positions_.find(key);
+    if (iter != positions_.end()) {
+      heap_[iter->second].count += weight;
+      siftDown(iter->second);
+      return;
+    }
+    if (heap_.size() < capacity_) {
+      heap_.emplace_back(Counter{key, weight, 0});
+      positions_.emplace(key, heap_.size() - 1);
+      siftUp(heap_.size() - 1);
+      return;
+    }
+    // Replace the key of the smallest count, which is the root
+    auto& root = heap_.front();
+    positions_.erase(root.key);
+    root.error = root.count;
+    root.count += weight;
+    root.key = key;
+    positions_.emplace(key, 0);
+    siftDown(0);
+  }
+
+  // Halve the counts so that the recent keys weigh more, the order of keys is kept
+  void decay(int times = 1) {
+    auto shift = std::min(times, 63);
+    for (auto& counter : heap_) {
+      counter.count >>= shift;
+      counter.error >>= shift;
+    }
+  }
+
+  // The k keys of the largest counts in descending order
+  std::vector<Counter> top(size_t k) const {
+    std::vector<Counter> counters(heap_);
+    auto n = std::min(k, counters.size());
+    std::partial_sort(counters.begin(),
+                      counters.begin() + n,
+                      counters.end(),
+                      [](const auto& a, const auto& b) { return a.count > b.count; });
+    counters.resize(n);
+    return counters;
+  }
+
+  // The counter of the key, nullptr if the key is not counted
+  const Counter* find(const Key& key) const {
+    auto iter = positions_.find(key);
+    return iter == positions_.end() ? nullptr : &heap_[iter->second];
+  }
+
+  size_t size() const {
+    return heap_.size();
+  }
+
+ private:
+  void swap(size_t i, size_t j) {
+    std::swap(heap_[i], heap_[j]);
+    positions_[heap_[i].key] = i;
+    positions_[heap_[j].key] = j;
+  }
+
+  void siftUp(size_t i) {
+    while (i > 0) {
+      auto parent = (i - 1) / 2;
+      if (heap_[parent].count <= heap_[i].count) {
+        break;
+      }
+      swap(i, parent);
+      i = parent;
+    }
+  }
+
+  void siftDown(size_t i) {
+    while (true) {
+      auto smallest = i;
+      auto left = 2 * i + 1;
+      auto right = left + 1;
+      if (left < heap_.size() && heap_[left].count < heap_[smallest].count) {
+        smallest = left;
+      }
+      if (right < heap_.size() && heap_[right].count < heap_[smallest].count) {
+        smallest = right;
+      }
+      if (smallest == i) {
+        break;
+      }
+      swap(i, smallest);
+      i = smallest;
+    }
+  }
+
+ private:
+  const size_t capacity_;
+  // A min heap by count
+  std::vector<Counter> heap_;
+  std::unordered_map<Key, size_t, Hash> positions_;
+};
+
+}  // namespace stats
+}  // namespace nebula
+#endif  // COMMON_STATS_SPACESAVING_H_
@@ -9,11 +9,79 @@
 #include <folly/String.h>
 #include <glog/logging.h>
 
+#include <cctype>
+
 #include "common/base/Base.h"
 
 namespace nebula {
 namespace stats {
 
+namespace {
+
+// The metric name of Prometheus, in which only letters, digits, '_' and ':' are allowed
+std::string prometheusName(folly::StringPiece name) {
+  std::string result = "nebula_";
+  for (auto c : name) {
+    bool valid = std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == ':';
+    result.push_back(valid ? c : '_');
+  }
+  return result;
+}
+
+// The labels like {k1="v1",k2="v2"}, with the extra label appended if given
+std::string prometheusLabels(const std::vector<std::pair<std::string, std::string>>& labels,
+                             const std::string& extraKey = "",
+                             const std::string& extraValue = "") {
+  if (labels.empty() && extraKey.empty()) {
+    return "";
+  }
+  std::string result = "{";
+  auto append = [&result](const std::string& key, const std::string& value) {
+    result.append(key).append("=\"");
+    for (auto c : value) {
+      if (c == '\\' || c == '"') {
+        result.push_back('\\');
+        result.push_back(c);
+      } else if (c == '\n') {
+        result.append("\\n");
+      } else {
+        result.push_back(c);
+      }
+    }
+    result.append("\",");
+  };
+  for (const auto& [key, value] : labels) {
+    append(key, value);
+  }
+  if (!extraKey.empty()) {
+    append(extraKey, extraValue);
+  }
+  result.back() = '}';
+  return result;
+}
+
+// Split the name registered by counterWithLabels, e.g. "num_queries{space=test}"
+void splitLabels(const std::string& index,
+                 std::string& name,
+                 std::vector<std::pair<std::string, std::string>>& labels) {
+  auto pos = index.find('{');
+  if (pos == std::string::npos || index.back() != '}') {
+    name = index;
+    return;
+  }
+  name = index.substr(0, pos);
+  std::vector<folly::StringPiece> pairs;
+  folly::split(",", folly::StringPiece(index).subpiece(pos + 1, index.size() - pos - 2), pairs);
+  for (auto pair : pairs) {
+    folly::StringPiece key, value;
+    if (folly::split('=', pair, key, value)) {
+      labels.emplace_back(key.str(), value.str());
+    }
+  }
+}
+
+}  // namespace
+
 // static
 StatsManager& StatsManager::get() {
   static StatsManager smInst;
@@ -75,8 +143,6 @@ CounterId StatsManager::registerStats(folly::StringPiece counterName, std::strin
 
 CounterId StatsManager::registerStats(folly::StringPiece counterName,
                                       std::vector<StatsMethod> methods) {
-  using std::chrono::seconds;
-
   auto& sm = get();
 
   std::string name = counterName.toString();
@@ -90,21 +156,16 @@ CounterId StatsManager::registerStats(folly::StringPiece counterName,
   }
 
   // Insert the Stats
-  sm.stats_.emplace(
-      counterName,
-      std::make_pair(std::make_unique<std::mutex>(),
-                     std::make_unique<StatsType>(
-                         60,
-                         std::initializer_list<StatsType::Duration>(
-                             {seconds(5), seconds(60), seconds(600), seconds(3600)}))));
-  std::string index(counterName);
+  auto counter = std::make_shared<ShardedCounter>(false);
+  sm.counters_.insert_or_assign(name, counter);
   auto it2 = sm.nameMap_.emplace(
       std::piecewise_construct,
-      std::forward_as_tuple(std::move(name)),
-      std::forward_as_tuple(
-          index, std::move(methods), std::vector<std::pair<std::string, double>>(), false));
+      std::forward_as_tuple(name),
+      std::forward_as_tuple(CounterId(name, std::move(counter)),
+                            std::move(methods),
+                            std::vector<std::pair<std::string, double>>()));
 
-  VLOG(1) << "Registered stats " << counterName.toString();
+  VLOG(1) << "Registered stats " << name;
   return it2.first->second.id_;
 }
 
@@ -127,7 +188,6 @@ CounterId StatsManager::registerHisto(folly::StringPiece counterName,
                                       StatsManager::VT max,
                                       std::vector<StatsMethod> methods,
                                       std::vector<std::pair<std::string, double>> percentiles) {
-  using std::chrono::seconds;
   auto& sm = get();
   std::string name = counterName.toString();
   folly::RWSpinLock::WriteHolder wh(sm.nameMapLock_);
@@ -141,156 +201,120 @@ CounterId StatsManager::registerHisto(folly::StringPiece counterName,
   }
 
   // Insert the Histogram
-  sm.histograms_.emplace(
-      counterName,
-      std::make_pair(std::make_unique<std::mutex>(),
-                     std::make_unique<HistogramType>(
-                         bucketSize,
-                         min,
-                         max,
-                         StatsType(60, {seconds(5), seconds(60), seconds(600), seconds(3600)}))));
-  std::string index(counterName);
+  auto counter = std::make_shared<ShardedCounter>(true);
+  sm.counters_.insert_or_assign(name, counter);
   auto it2 = sm.nameMap_.emplace(
       std::piecewise_construct,
-      std::forward_as_tuple(std::move(name)),
-      std::forward_as_tuple(
-          index, std::move(methods), std::move(percentiles), true, bucketSize, min, max));
-
-  VLOG(1) << "Registered histogram " << counterName.toString() << " [bucketSize: " << bucketSize
-          << ", min value: " << min << ", max value: " << max << "]";
+      std::forward_as_tuple(name),
+      std::forward_as_tuple(CounterId(name, std::move(counter)),
+                            std::move(methods),
+                            std::move(percentiles),
+                            bucketSize,
+                            min,
+                            max));
+
+  VLOG(1) << "Registered histogram " << name;
   return it2.first->second.id_;
 }
 
 // static
-CounterId StatsManager::counterWithLabels(const CounterId& id,
-                                          const std::vector<LabelPair>& labels) {
-  using std::chrono::seconds;
-
-  auto& sm = get();
-  auto index = id.index();
+std::string StatsManager::labeledName(const CounterId& id, const std::vector<LabelPair>& labels) {
   CHECK(!labels.empty());
-  std::string newIndex;
-  newIndex.append(index);
+  std::string newIndex = id.index();
   newIndex.append("{");
   for (auto& [k, v] : labels) {
     newIndex.append(k).append("=").append(v).append(",");
   }
   newIndex.back() = '}';
+  return newIndex;
+}
 
-  auto it = sm.nameMap_.find(newIndex);
-  // Get the counter if it already exists
-  if (it != sm.nameMap_.end()) {
-    return it->second.id_;
+// static
+CounterId StatsManager::counterWithLabels(const CounterId& id,
+                                          const std::vector<LabelPair>& labels) {
+  auto& sm = get();
+  auto newIndex = labeledName(id, labels);
+  std::vector<StatsMethod> methods;
+  {
+    folly::RWSpinLock::ReadHolder rh(sm.nameMapLock_);
+    auto it = sm.nameMap_.find(newIndex);
+    // Get the counter if it already exists
+    if (it != sm.nameMap_.end()) {
+      return it->second.id_;
+    }
+    auto it2 = sm.nameMap_.find(id.index());
+    DCHECK(it2 != sm.nameMap_.end());
+    methods = it2->second.methods_;
   }
 
   // Register a new counter if it doesn't exist
-  auto it2 = sm.nameMap_.find(index);
-  DCHECK(it2 != sm.nameMap_.end());
-  auto& methods = it2->second.methods_;
-
-  return registerStats(newIndex, methods);
+  return registerStats(newIndex, std::move(methods));
 }
 
 // static
 CounterId StatsManager::histoWithLabels(const CounterId& id, const std::vector<LabelPair>& labels) {
-  using std::chrono::seconds;
-
   auto& sm = get();
-  auto index = id.index();
-  CHECK(!labels.empty());
-  std::string newIndex;
-  newIndex.append(index);
-  newIndex.append("{");
-  for (auto& [k, v] : labels) {
-    newIndex.append(k).append("=").append(v).append(",");
-  }
-  newIndex.back() = '}';
-  auto it = sm.nameMap_.find(newIndex);
-  // Get the counter if it already exists
-  if (it != sm.nameMap_.end()) {
-    return it->second.id_;
+  auto newIndex = labeledName(id, labels);
+  std::vector<StatsMethod> methods;
+  std::vector<std::pair<std::string, double>> percentiles;
+  VT bucketSize = 0, min = 0, max = 0;
+  {
+    folly::RWSpinLock::ReadHolder rh(sm.nameMapLock_);
+    auto it = sm.nameMap_.find(newIndex);
+    // Get the counter if it already exists
+    if (it != sm.nameMap_.end()) {
+      return it->second.id_;
+    }
+    auto it2 = sm.nameMap_.find(id.index());
+    DCHECK(it2 != sm.nameMap_.end());
+    methods = it2->second.methods_;
+    percentiles = it2->second.percentiles_;
+    bucketSize = it2->second.bucketSize_;
+    min = it2->second.min_;
+    max = it2->second.max_;
   }
 
-  auto it2 = sm.nameMap_.find(index);
-  DCHECK(it2 != sm.nameMap_.end());
-  auto& methods = it2->second.methods_;
-  auto& percentiles = it2->second.percentiles_;
-
   return registerHisto(
-      newIndex, it2->second.bucketSize_, it2->second.min_, it2->second.max_, methods, percentiles);
+      newIndex, bucketSize, min, max, std::move(methods), std::move(percentiles));
 }
 
 // static
 void StatsManager::removeCounterWithLabels(const CounterId& id,
                                            const std::vector<LabelPair>& labels) {
-  using std::chrono::seconds;
-
   auto& sm = get();
-  auto index = id.index();
-  CHECK(!labels.empty());
-  std::string newIndex;
-  newIndex.append(index);
-  newIndex.append("{");
-  for (auto& [k, v] : labels) {
-    newIndex.append(k).append("=").append(v).append(",");
-  }
-  newIndex.back() = '}';
+  auto newIndex = labeledName(id, labels);
   folly::RWSpinLock::WriteHolder wh(sm.nameMapLock_);
-  auto it = sm.nameMap_.find(newIndex);
-  if (it != sm.nameMap_.end()) {
-    sm.nameMap_.erase(it);
-  }
-  sm.stats_.erase(newIndex);
+  sm.nameMap_.erase(newIndex);
+  sm.counters_.erase(newIndex);
 }
 
 // static
 void StatsManager::removeHistoWithLabels(const CounterId& id,
                                          const std::vector<LabelPair>& labels) {
-  using std::chrono::seconds;
+  removeCounterWithLabels(id, labels);
+}
 
-  auto& sm = get();
-  auto index = id.index();
-  CHECK(!labels.empty());
-  std::string newIndex;
-  newIndex.append(index);
-  newIndex.append("{");
-  for (auto& [k, v] : labels) {
-    newIndex.append(k).append("=").append(v).append(",");
-  }
-  newIndex.back() = '}';
-  folly::RWSpinLock::WriteHolder wh(sm.nameMapLock_);
-  auto it = sm.nameMap_.find(newIndex);
-  if (it != sm.nameMap_.end()) {
-    sm.nameMap_.erase(it);
+std::shared_ptr<ShardedCounter> StatsManager::find(const CounterId& id) const {
+  auto iter = counters_.find(id.index());
+  if (iter == counters_.end()) {
+    return nullptr;
   }
-  sm.histograms_.erase(newIndex);
+  return iter->second;
 }
 
 // static
 void StatsManager::addValue(const CounterId& id, VT value) {
-  using std::chrono::seconds;
-
-  auto& sm = get();
   if (!id.valid()) {
     // The counter is not registered
     return;
   }
-  std::string index = id.index();
-  bool isHisto = id.isHisto();
-  if (!isHisto) {
-    // Stats
-    auto iter = sm.stats_.find(index);
-    if (iter != sm.stats_.end()) {
-      std::lock_guard<std::mutex> g(*(iter->second.first));
-      iter->second.second->addValue(seconds(time::WallClock::fastNowInSec()), value);
-    }
-  } else {
-    // Histogram
-    auto iter = sm.histograms_.find(index);
-    if (iter != sm.histograms_.end()) {
-      std::lock_guard<std::mutex> g(*(iter->second.first));
-      iter->second.second->addValue(seconds(time::WallClock::fastNowInSec()), value);
-    }
+  if (id.counter() != nullptr) {
+    id.counter()->addValue(value);
+    return;
+  }
+  auto counter = get().find(id);
+  if (counter != nullptr) {
+    counter->addValue(value);
   }
 }
 
@@ -373,6 +397,7 @@ StatusOr<StatsManager::VT> StatsManager::readValue(folly::StringPiece metricName
 // static
 void StatsManager::readAllValue(folly::dynamic& vals) {
   auto& sm = get();
+  folly::RWSpinLock::ReadHolder rh(sm.nameMapLock_);
 
   for (auto const& statsName : sm.nameMap_) {
     // Add stats
@@ -454,33 +479,143 @@ void StatsManager::readAllValue(folly::dynamic& vals) {
   }
 }
 
+// static
+void StatsManager::registerGauges(const std::string& owner, GaugeCollector collector) {
+  auto& sm = get();
+  std::lock_guard<std::mutex> guard(sm.collectorsLock_);
+  sm.collectors_[owner] = std::move(collector);
+}
+
+// static
+void StatsManager::removeGauges(const std::string& owner) {
+  auto& sm = get();
+  std::lock_guard<std::mutex> guard(sm.collectorsLock_);
+  sm.collectors_.erase(owner);
+}
+
+// static
+std::string StatsManager::readAllPrometheus() {
+  auto& sm = get();
+  struct Series {
+    std::vector<LabelPair> labels;
+    ShardedCounter::Totals totals;
+  };
+  struct Family {
+    bool isHisto{false};
+    std::vector<Series> series;
+  };
+  // Group the counters registered with labels by the name, sorted to keep the output stable
+  std::map<std::string, Family> families;
+  {
+    folly::RWSpinLock::ReadHolder rh(sm.nameMapLock_);
+    for (const auto& [index, info] : sm.nameMap_) {
+      auto counter = sm.find(info.id_);
+      if (counter == nullptr) {
+        continue;
+      }
+      std::string name;
+      std::vector<LabelPair> labels;
+      splitLabels(index, name, labels);
+      auto& family = families[name];
+      family.isHisto = info.id_.isHisto();
+      family.series.emplace_back(Series{std::move(labels), counter->totals()});
+    }
+  }
+
+  std::string out;
+  for (const auto& [name, family] : families) {
+    auto metric = prometheusName(name);
+    if (!family.isHisto) {
+      bool gauge = std::any_of(family.series.begin(), family.series.end(), [](const auto& series) {
+        return series.totals.decreased;
+      });
+      out.append("# TYPE ").append(metric).append(gauge ? " gauge\n" : " counter\n");
+      for (const auto& series : family.series) {
+        out.append(metric).append(prometheusLabels(series.labels)).append(" ");
+        out.append(folly::to<std::string>(series.totals.sum)).append("\n");
+      }
+      continue;
+    }
+
+    // The bucket bounds are 1, 2, 5, 10, 20, 50... up to the max value of the family, the count of
+    // a bucket is accurate to the precision of the log-linear buckets
+    int64_t maxValue = 0;
+    for (const auto& series : family.series) {
+      const auto& buckets = series.totals.histogram.buckets();
+      if (!buckets.empty()) {
+        auto last = buckets.size() - 1;
+        maxValue = std::max(maxValue, HdrLayout::lowerBound(last) + HdrLayout::width(last) - 1);
+      }
+    }
+    std::vector<int64_t> bounds;
+    for (int64_t scale = 1; bounds.empty() || bounds.back() < maxValue; scale *= 10) {
+      for (auto step : {1, 2, 5}) {
+        bounds.emplace_back(scale * step);
+      }
+    }
+
+    out.append("# TYPE ").append(metric).append(" histogram\n");
+    for (const auto& series : family.series) {
+      const auto& histogram = series.totals.histogram;
+      const auto& buckets = histogram.buckets();
+      uint64_t cumulative = 0;
+      size_t i = 0;
+      for (auto bound : bounds) {
+        while (i < buckets.size() &&
+               HdrLayout::lowerBound(i) + HdrLayout::width(i) - 1 <= bound) {
+          cumulative += buckets[i++];
+        }
+        out.append(metric).append("_bucket");
+        out.append(prometheusLabels(series.labels, "le", folly::to<std::string>(bound)));
+        out.append(" ").append(folly::to<std::string>(cumulative)).append("\n");
+      }
+      auto count = folly::to<std::string>(histogram.count());
+      out.append(metric).append("_bucket").append(prometheusLabels(series.labels, "le", "+Inf"));
+      out.append(" ").append(count).append("\n");
+      out.append(metric).append("_sum").append(prometheusLabels(series.labels)).append(" ");
+      out.append(folly::to<std::string>(series.totals.sum)).append("\n");
+      out.append(metric).append("_count").append(prometheusLabels(series.labels)).append(" ");
+      out.append(count).append("\n");
+    }
+  }
+
+  std::vector<Gauge> gauges;
+  {
+    // The collectors are called with the lock held, so that the owner could not be destroyed
+    std::lock_guard<std::mutex> guard(sm.collectorsLock_);
+    for (const auto& collector : sm.collectors_) {
+      collector.second(gauges);
+    }
+  }
+  std::stable_sort(gauges.begin(), gauges.end(), [](const auto& a, const auto& b) {
+    return a.name < b.name;
+  });
+  for (size_t i = 0; i < gauges.size(); i++) {
+    auto metric = prometheusName(gauges[i].name);
+    if (i == 0 || gauges[i].name != gauges[i - 1].name) {
+      out.append("# TYPE ").append(metric).append(" gauge\n");
+    }
+    out.append(metric).append(prometheusLabels(gauges[i].labels)).append(" ");
+    out.append(folly::to<std::string>(gauges[i].value)).append("\n");
+  }
+  return out;
+}
+
 // static
 StatusOr<StatsManager::VT> StatsManager::readStats(const CounterId& id,
                                                    StatsManager::TimeRange range,
                                                    StatsManager::StatsMethod method) {
-  using std::chrono::seconds;
-  auto& sm = get();
-  std::string index = id.index();
-
-  if (index == "") {
+  if (!id.valid()) {
     return Status::Error("Invalid stats");
   }
 
-  if (!id.isHisto()) {
-    // stats
-    auto iter = sm.stats_.find(index);
-    DCHECK(iter != sm.stats_.end());
-    std::lock_guard<std::mutex> g(*(iter->second.first));
-    iter->second.second->update(seconds(time::WallClock::fastNowInSec()));
-    return readValue(*(iter->second.second), range, method);
-  } else {
-    // histograms_
-    auto iter = sm.histograms_.find(index);
-    DCHECK(iter != sm.histograms_.end());
-    std::lock_guard<std::mutex> g(*(iter->second.first));
-    iter->second.second->update(seconds(time::WallClock::fastNowInSec()));
-    return readValue(*(iter->second.second), range, method);
+  auto counter = get().find(id);
+  if (counter == nullptr) {
+    return Status::Error("Stats not found \"%s\"", id.index().c_str());
   }
+  return counter->read([range, method](auto& series, auto&, int64_t) {
+    return readValue(series, range, method);
+  });
 }
 
 // static
@@ -509,23 +644,18 @@ StatusOr<StatsManager::VT> StatsManager::readStats(const std::string& counterNam
 StatusOr<StatsManager::VT> StatsManager::readHisto(const CounterId& id,
                                                    StatsManager::TimeRange range,
                                                    double pct) {
-  using std::chrono::seconds;
-  auto& sm = get();
-  std::string index = id.index();
-
   if (!id.isHisto()) {
     return Status::Error("Invalid stats");
   }
 
-  auto it = sm.histograms_.find(index);
-  if (it == sm.histograms_.end()) {
+  auto counter = get().find(id);
+  if (counter == nullptr) {
     return Status::Error("Invalid stats");
   }
-
-  std::lock_guard<std::mutex> g(*(sm.histograms_[index].first));
-  sm.histograms_[index].second->update(seconds(time::WallClock::fastNowInSec()));
   auto level = static_cast<size_t>(range);
-  return sm.histograms_[index].second->getPercentileEstimate(pct, level);
+  return counter->read([level, pct](auto&, auto& histogram, int64_t nowSec) {
+    return histogram.percentile(level, nowSec, pct);
+  });
 }
 
 // static
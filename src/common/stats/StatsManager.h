@@ -8,12 +8,11 @@
 
 #include <folly/RWSpinLock.h>
 #include <folly/concurrency/ConcurrentHashMap.h>
-#include <folly/stats/MultiLevelTimeSeries.h>
-#include <folly/stats/TimeseriesHistogram.h>
 
 #include "common/base/Base.h"
 #include "common/base/StatusOr.h"
 #include "common/datatypes/HostAddr.h"
+#include "common/stats/ShardedCounter.h"
 #include "common/time/WallClock.h"
 
 namespace nebula {
@@ -25,6 +24,8 @@ class CounterId final {
   CounterId() = default;
   CounterId(const std::string& index, bool isHisto = false)  // NOLINT
       : index_{index}, isHisto_(isHisto) {}
+  CounterId(const std::string& index, std::shared_ptr<ShardedCounter> counter)
+      : index_{index}, isHisto_(counter->isHisto()), counter_(std::move(counter)) {}
   CounterId(const CounterId&) = default;
 
   CounterId& operator=(const CounterId& right) {
@@ -37,6 +38,7 @@ class CounterId final {
     }
     index_ = right.index_;
     isHisto_ = right.isHisto_;
+    counter_ = right.counter_;
     return *this;
   }
 
@@ -64,9 +66,15 @@ class CounterId final {
     return index_;
   }
 
+  // The counter registered, which is null if the id is only assigned a name
+  ShardedCounter* counter() const {
+    return counter_.get();
+  }
+
  private:
   std::string index_;
   bool isHisto_{false};
+  std::shared_ptr<ShardedCounter> counter_;
 };
 
 /**
@@ -91,11 +99,12 @@ class CounterId final {
  *   latency.p9999.60   -- The latency that slower than 99.99% of all queries
  *                           in the last one minute
  *   error.count.600    -- Total number of errors in the last ten minutes
+ *
+ * Adding a value takes no lock, see ShardedCounter. The id returned by registration refers to the
+ * counter directly, so keep the id of a labeled counter instead of looking it up for every value.
  */
 class StatsManager final {
   using VT = int64_t;
-  using StatsType = folly::MultiLevelTimeSeries<VT>;
-  using HistogramType = folly::TimeseriesHistogram<VT>;
   using LabelPair = std::pair<std::string, std::string>;
 
  public:
@@ -103,6 +112,14 @@ class StatsManager final {
 
   enum class TimeRange { FIVE_SECONDS = 0, ONE_MINUTE = 1, TEN_MINUTES = 2, ONE_HOUR = 3 };
 
+  // A value read when the metrics are exported, e.g. the state of a raft part
+  struct Gauge {
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> labels;
+    double value;
+  };
+  using GaugeCollector = std::function<void(std::vector<Gauge>&)>;
+
   static void setDomain(folly::StringPiece domain);
   // addr     -- The ip/port of the stats collector. StatsManager will
   // periodically
@@ -122,6 +139,9 @@ class StatsManager final {
   // the readAllValue() method. The readAllValue() only returns the matrix for
   // those specified in the parameter **stats**. If **stats** is empty, nothing
   // will return from readAllValue()
+  //
+  // The buckets of histograms are log-linear and cover all the values, so the percentiles are
+  // not bounded by **min** and **max** any more, and **bucketSize** is not used.
   static CounterId registerStats(folly::StringPiece counterName, std::string stats);
   static CounterId registerStats(folly::StringPiece counterName, std::vector<StatsMethod> methods);
   static CounterId registerHisto(
@@ -160,6 +180,16 @@ class StatsManager final {
   static StatusOr<VT> readHisto(const std::string& counterName, TimeRange range, double pct);
   static void readAllValue(folly::dynamic& vals);
 
+  // Register the collector of the gauges which are read when exporting, the collector of the same
+  // owner is replaced
+  static void registerGauges(const std::string& owner, GaugeCollector collector);
+  static void removeGauges(const std::string& owner);
+
+  // Export the totals of all the stats and histograms since started, and the gauges, in the text
+  // exposition format of Prometheus. Each name is prefixed by "nebula_", and the labels of the
+  // counters registered with labels are exported as the labels.
+  static std::string readAllPrometheus();
+
  private:
   static StatsManager& get();
 
@@ -183,14 +213,13 @@ class StatsManager final {
     std::vector<std::pair<std::string, double>> percentiles_;
     VT bucketSize_, min_, max_;
 
-    CounterInfo(const std::string& index,
+    CounterInfo(CounterId id,
                 std::vector<StatsMethod>&& methods,
                 std::vector<std::pair<std::string, double>>&& percentiles,
-                bool isHisto = false,
                 VT bucketSize = VT(),
                 VT min = VT(),
                 VT max = VT())
-        : id_(index, isHisto),
+        : id_(std::move(id)),
           methods_(std::move(methods)),
           percentiles_(std::move(percentiles)),
           bucketSize_(bucketSize),
@@ -198,25 +227,24 @@ class StatsManager final {
           max_(max) {}
   };
 
+  static std::string labeledName(const CounterId& id, const std::vector<LabelPair>& labels);
+
+  // Find the counter of an id which is not returned by registration
+  std::shared_ptr<ShardedCounter> find(const CounterId& id) const;
+
   std::string domain_;
   HostAddr collectorAddr_{"", 0};
   int32_t interval_{0};
 
-  // <counter_name> => index
-  // when index > 0, (index - 1) is the index of stats_ list
-  // when index < 0, [- (index + 1)] is the index of histograms_ list
+  // <counter_name> => the registration info
   folly::RWSpinLock nameMapLock_;
   std::unordered_map<std::string, CounterInfo> nameMap_;
 
-  // All time series stats
-  folly::ConcurrentHashMap<std::string,
-                           std::pair<std::unique_ptr<std::mutex>, std::unique_ptr<StatsType>>>
-      stats_;
+  // All the stats and histograms
+  folly::ConcurrentHashMap<std::string, std::shared_ptr<ShardedCounter>> counters_;
 
-  // All histogram stats
-  std::unordered_map<std::string,
-                     std::pair<std::unique_ptr<std::mutex>, std::unique_ptr<HistogramType>>>
-      histograms_;
+  std::mutex collectorsLock_;
+  std::map<std::string, GaugeCollector> collectors_;
 };
 
 }  // namespace stats
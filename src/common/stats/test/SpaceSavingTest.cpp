@@ -0,0 +1,83 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "common/stats/SpaceSaving.h"
+
+namespace nebula {
+namespace stats {
+
+TEST(SpaceSavingTest, ExactWithinCapacity) {
+  SpaceSaving<std::string> sketch(10);
+  for (int i = 0; i < 5; i++) {
+    for (int k = 0; k <= i; k++) {
+      sketch.add(folly::to<std::string>(i));
+    }
+  }
+  sketch.add("4", 10);
+  auto top = sketch.top(3);
+  ASSERT_EQ(3, top.size());
+  EXPECT_EQ("4", top[0].key);
+  EXPECT_EQ(15, top[0].count);
+  EXPECT_EQ(0, top[0].error);
+  EXPECT_EQ("3", top[1].key);
+  EXPECT_EQ(4, top[1].count);
+  EXPECT_EQ("2", top[2].key);
+  EXPECT_EQ(3, top[2].count);
+  EXPECT_EQ(5, sketch.size());
+  EXPECT_EQ(nullptr, sketch.find("5"));
+}
+
+TEST(SpaceSavingTest, HeavyHitters) {
+  SpaceSaving<int64_t> sketch(16);
+  // Two heavy keys hidden in a long tail of distinct keys
+  int64_t next = 100;
+  for (int i = 0; i < 10000; i++) {
+    sketch.add(next++);
+    if (i % 4 == 0) {
+      sketch.add(1);
+    }
+    if (i % 10 == 0) {
+      sketch.add(2);
+    }
+  }
+  auto top = sketch.top(2);
+  ASSERT_EQ(2, top.size());
+  EXPECT_EQ(1, top[0].key);
+  EXPECT_EQ(2, top[1].key);
+  // The count is never underestimated and the overestimation is bounded by the error
+  EXPECT_GE(top[0].count, 2500);
+  EXPECT_LE(top[0].count - top[0].error, 2500);
+  EXPECT_GE(top[1].count, 1000);
+  EXPECT_LE(top[1].count - top[1].error, 1000);
+  EXPECT_EQ(16, sketch.size());
+}
+
+TEST(SpaceSavingTest, Decay) {
+  SpaceSaving<int64_t> sketch(4);
+  sketch.add(1, 100);
+  sketch.add(2, 10);
+  sketch.decay();
+  EXPECT_EQ(50, sketch.find(1)->count);
+  EXPECT_EQ(5, sketch.find(2)->count);
+  sketch.add(2, 50);
+  auto top = sketch.top(1);
+  ASSERT_EQ(1, top.size());
+  EXPECT_EQ(2, top[0].key);
+  EXPECT_EQ(55, top[0].count);
+}
+
+}  // namespace stats
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+
+  return RUN_ALL_TESTS();
+}
@@ -163,6 +163,47 @@ TEST(StatsManager, ReadAllTest) {
   EXPECT_FALSE(counterExists(stats2, "stat04{space=test}.p95.5", val));
 }
 
+TEST(StatsManager, HistogramOutOfRangeTest) {
+  // The percentiles are not bounded by the range registered
+  auto statId = StatsManager::registerHisto("stat05", 1000, 0, 2000, "p50, p99");
+  for (int i = 1; i <= 100; i++) {
+    StatsManager::addValue(statId, i * 10000);
+  }
+
+  auto p50 = StatsManager::readHisto(statId, StatsManager::TimeRange::ONE_MINUTE, 50).value();
+  EXPECT_GE(p50, 500000 * 0.97);
+  EXPECT_LE(p50, 510000 * 1.03);
+  auto p99 = StatsManager::readHisto(statId, StatsManager::TimeRange::ONE_MINUTE, 99).value();
+  EXPECT_GE(p99, 990000 * 0.97);
+  EXPECT_LE(p99, 1000000 * 1.03);
+  EXPECT_EQ(50500000, StatsManager::readValue("stat05.sum.60").value());
+}
+
+TEST(StatsManager, ConcurrentAddTest) {
+  auto statId = StatsManager::registerStats("stat06", "sum");
+  auto labeled = StatsManager::counterWithLabels(statId, {{"space", "test"}});
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&statId, &labeled]() {
+      for (int k = 0; k < 100000; k++) {
+        StatsManager::addValue(statId);
+        StatsManager::addValue(labeled, 2);
+      }
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(800000, StatsManager::readValue("stat06.sum.60").value());
+  EXPECT_EQ(800000, StatsManager::readValue("stat06.count.60").value());
+  EXPECT_EQ(1600000,
+            StatsManager::readStats(
+                labeled, StatsManager::TimeRange::ONE_MINUTE, StatsManager::StatsMethod::SUM)
+                .value());
+}
+
 }  // namespace stats
 }  // namespace nebula
 
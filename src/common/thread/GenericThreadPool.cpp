@@ -17,7 +17,9 @@ GenericThreadPool::~GenericThreadPool() {
   wait();
 }
 
-bool GenericThreadPool::start(size_t nrThreads, const std::string &name) {
+bool GenericThreadPool::start(size_t nrThreads,
+                              const std::string &name,
+                              const std::vector<int> &cpus) {
   if (nrThreads_ != 0) {
     return false;
   }
@@ -26,7 +28,7 @@ bool GenericThreadPool::start(size_t nrThreads, const std::string &name) {
   for (auto i = 0UL; ok && i < nrThreads_; i++) {
     pool_.emplace_back(std::make_unique<GenericWorker>());
     auto workerName = folly::stringPrintf("%s-%lu", name.c_str(), i);
-    ok = ok && pool_.back()->start(std::move(workerName));
+    ok = ok && pool_.back()->start(std::move(workerName), cpus);
   }
   return ok;
 }
@@ -43,8 +43,10 @@ class GenericThreadPool final : public boost::noncopyable, public nebula::cpp::N
    *
    * @nrThreads   number of internal threads
    * @name        name of internal threads
+   * @cpus        cpus the internal threads are bound to, e.g. of a NUMA node,
+   *              not bound if empty
    */
-  bool start(size_t nrThreads, const std::string &name = "");
+  bool start(size_t nrThreads, const std::string &name = "", const std::vector<int> &cpus = {});
 
   /**
    * Asynchronously to notify the workers to stop handling further new tasks.
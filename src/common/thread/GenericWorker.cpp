@@ -9,6 +9,7 @@
 #include <sys/eventfd.h>
 
 #include "common/base/Base.h"
+#include "common/thread/NumaTopology.h"
 
 namespace nebula {
 namespace thread {
@@ -31,12 +32,13 @@ GenericWorker::~GenericWorker() {
   }
 }
 
-bool GenericWorker::start(std::string name) {
+bool GenericWorker::start(std::string name, std::vector<int> cpus) {
   if (!stopped_.load(std::memory_order_acquire)) {
     LOG(WARNING) << "GenericWroker already started";
     return false;
   }
   name_ = std::move(name);
+  cpus_ = std::move(cpus);
 
   // Create an event base
   evbase_ = event_base_new();
@@ -87,6 +89,9 @@ bool GenericWorker::wait() {
 }
 
 void GenericWorker::loop() {
+  if (!cpus_.empty()) {
+    NumaTopology::bindCurrentThread(cpus_);
+  }
   event_base_dispatch(evbase_);
 }
 
@@ -52,8 +52,11 @@ class GenericWorker final : public boost::noncopyable, public nebula::cpp::NonMo
    *
    * A GenericWorker MUST be `start'ed successfully before invoking
    * any other interfaces.
+   *
+   * If the cpus are given, the internal thread is bound to them, e.g. the cpus
+   * of a NUMA node.
    */
-  bool NG_MUST_USE_RESULT start(std::string name = "");
+  bool NG_MUST_USE_RESULT start(std::string name = "", std::vector<int> cpus = {});
 
   /**
    * Asynchronously to notify the worker to stop handling further new tasks.
@@ -153,6 +156,7 @@ class GenericWorker final : public boost::noncopyable, public nebula::cpp::NonMo
   static constexpr uint64_t TIMER_ID_BITS = 6 * 8;
   static constexpr uint64_t TIMER_ID_MASK = ((~0x0UL) >> (64 - TIMER_ID_BITS));
   std::string name_;
+  std::vector<int> cpus_;
   std::atomic<bool> stopped_{true};
   volatile uint64_t nextTimerId_{0};
   struct event_base *evbase_ = nullptr;
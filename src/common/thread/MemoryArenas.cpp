@@ -0,0 +1,175 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/thread/MemoryArenas.h"
+
+// Defined when linked with jemalloc
+extern "C" int mallctl(const char* name, void* oldp, size_t* oldlenp, void* newp, size_t newlen)
+    __attribute__((__weak__));
+extern "C" void* mallocx(size_t size, int flags) __attribute__((__weak__));
+extern "C" void dallocx(void* ptr, int flags) __attribute__((__weak__));
+extern "C" size_t sallocx(const void* ptr, int flags) __attribute__((__weak__));
+
+DEFINE_string(memory_arenas,
+              "",
+              "The subsystems of which the memory is allocated from their own jemalloc arenas, "
+              "separated by comma, among block_cache, reader and rpc of storaged, and query of "
+              "graphd. The memory of the arenas is exported by the memory_arena_* gauges");
+
+namespace nebula {
+namespace thread {
+
+namespace {
+
+// The flags of jemalloc, see MALLOCX_ARENA and MALLOCX_TCACHE_NONE
+int arenaFlags(unsigned arena) {
+  return static_cast<int>((arena + 1) << 20) | (1 << 8);
+}
+
+int64_t readStat(const std::string& name) {
+  size_t value = 0;
+  size_t len = sizeof(value);
+  if (mallctl(name.c_str(), &value, &len, nullptr, 0) != 0) {
+    return 0;
+  }
+  return static_cast<int64_t>(value);
+}
+
+}  // namespace
+
+// static
+std::vector<std::pair<std::string, unsigned>>& MemoryArenas::arenas() {
+  static std::vector<std::pair<std::string, unsigned>> arenas;
+  return arenas;
+}
+
+// static
+Status MemoryArenas::init() {
+  std::vector<std::string> subsystems;
+  folly::split(",", FLAGS_memory_arenas, subsystems, true);
+  for (auto& subsystem : subsystems) {
+    subsystem = folly::trimWhitespace(subsystem).str();
+    if (subsystem != kBlockCache && subsystem != kReader && subsystem != kRpc &&
+        subsystem != kQuery) {
+      return Status::Error("Unknown subsystem in --memory_arenas: %s", subsystem.c_str());
+    }
+  }
+  if (subsystems.empty()) {
+    return Status::OK();
+  }
+  if (mallctl == nullptr) {
+    LOG(WARNING) << "Not linked with jemalloc, --memory_arenas is ignored";
+    return Status::OK();
+  }
+  for (const auto& subsystem : subsystems) {
+    if (arenaOf(subsystem).has_value()) {
+      continue;
+    }
+    unsigned arena = 0;
+    size_t len = sizeof(arena);
+    if (mallctl("arenas.create", &arena, &len, nullptr, 0) != 0) {
+      return Status::Error("Failed to create the memory arena of %s", subsystem.c_str());
+    }
+    LOG(INFO) << "The memory arena of " << subsystem << " is " << arena;
+    arenas().emplace_back(subsystem, arena);
+  }
+  return Status::OK();
+}
+
+// static
+std::optional<unsigned> MemoryArenas::arenaOf(folly::StringPiece subsystem) {
+  for (const auto& [name, arena] : arenas()) {
+    if (name == subsystem) {
+      return arena;
+    }
+  }
+  return std::nullopt;
+}
+
+// static
+void MemoryArenas::bindCurrentThread(folly::StringPiece subsystem) {
+  auto arena = arenaOf(subsystem);
+  if (!arena.has_value()) {
+    return;
+  }
+  unsigned value = *arena;
+  if (mallctl("thread.arena", nullptr, nullptr, &value, sizeof(value)) != 0) {
+    LOG(WARNING) << "Failed to bind the thread to the memory arena of " << subsystem;
+  }
+}
+
+// static
+void* MemoryArenas::allocate(unsigned arena, size_t size) {
+  auto* ptr = mallocx(size == 0 ? 1 : size, arenaFlags(arena));
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+// static
+void MemoryArenas::deallocate(void* ptr) {
+  if (ptr != nullptr) {
+    // The arena is looked up by jemalloc from the pointer
+    dallocx(ptr, 1 << 8);
+  }
+}
+
+// static
+size_t MemoryArenas::usableSize(void* ptr) {
+  return sallocx(ptr, 0);
+}
+
+// static
+std::vector<MemoryArenas::Stats> MemoryArenas::stats() {
+  std::vector<Stats> result;
+  if (mallctl == nullptr) {
+    return result;
+  }
+  // The stats are refreshed by advancing the epoch
+  uint64_t epoch = 1;
+  size_t len = sizeof(epoch);
+  mallctl("epoch", &epoch, &len, &epoch, len);
+  auto pageSize = readStat("arenas.page");
+
+  Stats total{"total"};
+  total.allocated = readStat("stats.allocated");
+  total.active = readStat("stats.active");
+  total.resident = readStat("stats.resident");
+  total.mapped = readStat("stats.mapped");
+  total.retained = readStat("stats.retained");
+  // The rest after the arenas of the subsystems
+  auto other = total;
+  other.subsystem = "other";
+  int64_t subsystemsDirty = 0;
+  for (const auto& [subsystem, arena] : arenas()) {
+    auto prefix = folly::sformat("stats.arenas.{}.", arena);
+    Stats stats{subsystem};
+    stats.allocated =
+        readStat(prefix + "small.allocated") + readStat(prefix + "large.allocated");
+    stats.active = readStat(prefix + "pactive") * pageSize;
+    stats.dirty = readStat(prefix + "pdirty") * pageSize;
+    stats.resident = readStat(prefix + "resident");
+    stats.mapped = readStat(prefix + "mapped");
+    stats.retained = readStat(prefix + "retained");
+    other.allocated -= stats.allocated;
+    other.active -= stats.active;
+    other.resident -= stats.resident;
+    other.mapped -= stats.mapped;
+    other.retained -= stats.retained;
+    subsystemsDirty += stats.dirty;
+    result.emplace_back(std::move(stats));
+  }
+  // The dirty pages of all the arenas are merged in MALLCTL_ARENAS_ALL
+  auto allDirty = readStat("stats.arenas.4096.pdirty") * pageSize;
+  other.dirty = std::max<int64_t>(0, allDirty - subsystemsDirty);
+  total.dirty = allDirty;
+  result.emplace_back(std::move(other));
+  result.emplace_back(std::move(total));
+  return result;
+}
+
+}  // namespace thread
+}  // namespace nebula
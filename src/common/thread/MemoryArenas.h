@@ -0,0 +1,72 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_THREAD_MEMORYARENAS_H_
+#define COMMON_THREAD_MEMORYARENAS_H_
+
+#include "common/base/Base.h"
+#include "common/base/Status.h"
+
+DECLARE_string(memory_arenas);
+
+namespace nebula {
+namespace thread {
+
+/**
+ * The jemalloc arenas of the subsystems given by --memory_arenas, so that their memory doesn't
+ * fragment each other and the resident memory could be told apart. The threads of a subsystem
+ * allocate from its arena once bound to it, and the block cache allocates from its arena by the
+ * allocator of the cache. Nothing is changed if the process is not linked with jemalloc.
+ */
+class MemoryArenas final {
+ public:
+  // The blocks of the rocksdb block cache
+  static constexpr char kBlockCache[] = "block_cache";
+  // The threads of the reads of storaged
+  static constexpr char kReader[] = "reader";
+  // The IO threads of the RPC of storaged
+  static constexpr char kRpc[] = "rpc";
+  // The IO threads of graphd, which run the queries
+  static constexpr char kQuery[] = "query";
+
+  struct Stats {
+    // The subsystem, "other" for the default arenas, and "total" for all
+    std::string subsystem;
+    int64_t allocated{0};
+    // The pages of the allocated, and the dirty pages not returned to the system yet
+    int64_t active{0};
+    int64_t dirty{0};
+    int64_t resident{0};
+    int64_t mapped{0};
+    int64_t retained{0};
+  };
+
+  // Create the arenas of --memory_arenas, before the threads of the subsystems are started
+  static Status init();
+
+  // The arena of the subsystem, none if the subsystem has no arena of its own
+  static std::optional<unsigned> arenaOf(folly::StringPiece subsystem);
+
+  // Allocate from the arena of the subsystem in the calling thread, if it has one
+  static void bindCurrentThread(folly::StringPiece subsystem);
+
+  // Allocate from the arena directly, bypassing the thread cache
+  static void* allocate(unsigned arena, size_t size);
+
+  static void deallocate(void* ptr);
+
+  static size_t usableSize(void* ptr);
+
+  // The stats of the arenas of the subsystems, then of the other arenas and of all
+  static std::vector<Stats> stats();
+
+ private:
+  static std::vector<std::pair<std::string, unsigned>>& arenas();
+};
+
+}  // namespace thread
+}  // namespace nebula
+
+#endif  // COMMON_THREAD_MEMORYARENAS_H_
@@ -0,0 +1,113 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/thread/NumaTopology.h"
+
+#include <folly/FileUtil.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+namespace nebula {
+namespace thread {
+
+// static
+const NumaTopology& NumaTopology::instance() {
+  static NumaTopology topology;
+  return topology;
+}
+
+NumaTopology::NumaTopology() {
+  std::string online;
+  if (folly::readFile("/sys/devices/system/node/online", online)) {
+    for (auto node : parseCpuList(folly::trimWhitespace(online))) {
+      std::string list;
+      auto path = folly::sformat("/sys/devices/system/node/node{}/cpulist", node);
+      if (!folly::readFile(path.c_str(), list)) {
+        cpus_.clear();
+        break;
+      }
+      // The nodes are numbered from 0 without holes on the hosts we know
+      if (static_cast<size_t>(node) != cpus_.size()) {
+        cpus_.clear();
+        break;
+      }
+      cpus_.emplace_back(parseCpuList(folly::trimWhitespace(list)));
+    }
+  }
+  if (cpus_.empty()) {
+    std::vector<int> all;
+    for (unsigned int i = 0; i < std::thread::hardware_concurrency(); i++) {
+      all.emplace_back(i);
+    }
+    cpus_.emplace_back(std::move(all));
+  }
+}
+
+int NumaTopology::nodeOfPath(const std::string& path) const {
+  if (numNodes() <= 1) {
+    return numNodes() == 1 ? 0 : -1;
+  }
+  struct stat st;
+  if (::stat(path.c_str(), &st) != 0) {
+    return -1;
+  }
+  // The block device of the path, or its parent if it's a partition. The numa_node is of the
+  // device of the disk, or of the controller of it, e.g. NVMe.
+  auto dev = folly::sformat("/sys/dev/block/{}:{}", major(st.st_dev), minor(st.st_dev));
+  for (const auto* base : {"", "/.."}) {
+    for (const auto* file : {"/device/numa_node", "/device/device/numa_node"}) {
+      std::string content;
+      if (!folly::readFile(folly::sformat("{}{}{}", dev, base, file).c_str(), content)) {
+        continue;
+      }
+      auto node = folly::tryTo<int>(folly::trimWhitespace(content));
+      if (node.hasValue() && node.value() >= 0 && static_cast<size_t>(node.value()) < numNodes()) {
+        return node.value();
+      }
+    }
+  }
+  return -1;
+}
+
+// static
+bool NumaTopology::bindCurrentThread(const std::vector<int>& cpus) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  auto ret = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+  if (ret != 0) {
+    LOG(WARNING) << "Failed to bind the thread to the cpus: " << ::strerror(ret);
+    return false;
+  }
+  return true;
+}
+
+// static
+std::vector<int> NumaTopology::parseCpuList(folly::StringPiece list) {
+  std::vector<int> cpus;
+  std::vector<folly::StringPiece> ranges;
+  folly::split(",", list, ranges, true);
+  for (auto range : ranges) {
+    folly::StringPiece first, last;
+    if (!folly::split("-", range, first, last)) {
+      first = last = range;
+    }
+    auto from = folly::tryTo<int>(first);
+    auto to = folly::tryTo<int>(last);
+    if (!from.hasValue() || !to.hasValue()) {
+      return {};
+    }
+    for (auto cpu = from.value(); cpu <= to.value(); cpu++) {
+      cpus.emplace_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+}  // namespace thread
+}  // namespace nebula
@@ -0,0 +1,86 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_THREAD_NUMATOPOLOGY_H_
+#define COMMON_THREAD_NUMATOPOLOGY_H_
+
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+
+#include "common/base/Base.h"
+#include "common/thread/MemoryArenas.h"
+
+namespace nebula {
+namespace thread {
+
+/**
+ * The NUMA nodes of the host and their cpus, read from sysfs without libnuma. A host which is not
+ * NUMA, or of which sysfs is not readable, has one node of all the cpus.
+ */
+class NumaTopology final {
+ public:
+  static const NumaTopology& instance();
+
+  size_t numNodes() const {
+    return cpus_.size();
+  }
+
+  const std::vector<int>& cpusOf(size_t node) const {
+    return cpus_[node];
+  }
+
+  /**
+   * @brief The node of the disk the path is on, e.g. the node owning the NVMe controller of the
+   * disk. -1 if unknown, e.g. the path is on a device mapper or a network filesystem.
+   */
+  int nodeOfPath(const std::string& path) const;
+
+  // Bind the calling thread to the cpus, return false if failed
+  static bool bindCurrentThread(const std::vector<int>& cpus);
+
+  // Parse the cpu list of sysfs, e.g. "0-3,8-11"
+  static std::vector<int> parseCpuList(folly::StringPiece list);
+
+ private:
+  NumaTopology();
+
+  std::vector<std::vector<int>> cpus_;
+};
+
+/**
+ * The named threads bound to the cpus, e.g. the cpus of a NUMA node, so that the memory they
+ * touch first is allocated on the node. The threads also allocate from the memory arena of the
+ * subsystem if it's given, see MemoryArenas.
+ */
+class BoundThreadFactory final : public folly::NamedThreadFactory {
+ public:
+  BoundThreadFactory(folly::StringPiece prefix,
+                     std::vector<int> cpus,
+                     std::string arenaSubsystem = "")
+      : folly::NamedThreadFactory(prefix),
+        cpus_(std::move(cpus)),
+        arenaSubsystem_(std::move(arenaSubsystem)) {}
+
+  std::thread newThread(folly::Func&& func) override {
+    return folly::NamedThreadFactory::newThread(
+        [cpus = cpus_, arena = arenaSubsystem_, func = std::move(func)]() mutable {
+          if (!cpus.empty()) {
+            NumaTopology::bindCurrentThread(cpus);
+          }
+          if (!arena.empty()) {
+            MemoryArenas::bindCurrentThread(arena);
+          }
+          func();
+        });
+  }
+
+ private:
+  std::vector<int> cpus_;
+  std::string arenaSubsystem_;
+};
+
+}  // namespace thread
+}  // namespace nebula
+
+#endif  // COMMON_THREAD_NUMATOPOLOGY_H_
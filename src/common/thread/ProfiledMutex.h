@@ -0,0 +1,160 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_THREAD_PROFILEDMUTEX_H_
+#define COMMON_THREAD_PROFILEDMUTEX_H_
+
+#include <execinfo.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nebula {
+namespace thread {
+
+/**
+ * @brief Collect where the threads wait for the profiled mutexes while a profile is running. The
+ * waits are aggregated by the lock and the stack of the waiter, the stacks are raw return
+ * addresses which are symbolized by the reader.
+ */
+class ContentionProfiler final {
+ public:
+  static constexpr int kMaxDepth = 32;
+  // Stop adding new stacks when there are so many, the waits of the known stacks are still added
+  static constexpr size_t kMaxStacks = 10000;
+
+  struct Sample {
+    std::string lock;
+    std::vector<uintptr_t> stack;
+    int64_t waitUs{0};
+    uint64_t count{0};
+  };
+
+  static ContentionProfiler& instance() {
+    static ContentionProfiler profiler;
+    return profiler;
+  }
+
+  bool active() const {
+    return active_.load(std::memory_order_relaxed);
+  }
+
+  // Return false if a profile is running
+  bool start() {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (active_.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    waits_.clear();
+    active_.store(true, std::memory_order_relaxed);
+    return true;
+  }
+
+  std::vector<Sample> stop() {
+    std::lock_guard<std::mutex> guard(lock_);
+    active_.store(false, std::memory_order_relaxed);
+    std::vector<Sample> samples;
+    samples.reserve(waits_.size());
+    for (auto& [key, wait] : waits_) {
+      samples.emplace_back(Sample{key.first, key.second, wait.first, wait.second});
+    }
+    waits_.clear();
+    return samples;
+  }
+
+  // The return addresses of the caller's stack, skipping the frames of this and its caller
+  static std::vector<uintptr_t> stack() {
+    void* frames[kMaxDepth];
+    auto depth = ::backtrace(frames, kMaxDepth);
+    std::vector<uintptr_t> stack;
+    for (int i = 2; i < depth; i++) {
+      stack.emplace_back(reinterpret_cast<uintptr_t>(frames[i]));
+    }
+    return stack;
+  }
+
+  void record(const char* lock, std::vector<uintptr_t>&& stack, int64_t waitUs) {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (!active_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    auto key = std::make_pair(std::string(lock), std::move(stack));
+    auto iter = waits_.find(key);
+    if (iter == waits_.end()) {
+      if (waits_.size() >= kMaxStacks) {
+        return;
+      }
+      iter = waits_.emplace(std::move(key), std::make_pair(0L, 0UL)).first;
+    }
+    iter->second.first += waitUs;
+    iter->second.second++;
+  }
+
+ private:
+  ContentionProfiler() = default;
+
+  std::atomic<bool> active_{false};
+  std::mutex lock_;
+  // {lock, stack} -> {wait in us, count}
+  std::map<std::pair<std::string, std::vector<uintptr_t>>, std::pair<int64_t, uint64_t>> waits_;
+};
+
+/**
+ * @brief A std::mutex whose waits are recorded while a contention profile is running. An
+ * uncontended lock costs a try_lock as before, and a contended one checks a flag more when no
+ * profile is running.
+ */
+class ProfiledMutex final {
+ public:
+  explicit ProfiledMutex(const char* name) : name_(name) {}
+
+  ProfiledMutex(const ProfiledMutex&) = delete;
+  ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+  void lock() {
+    if (mutex_.try_lock()) {
+      return;
+    }
+    auto& profiler = ContentionProfiler::instance();
+    if (!profiler.active()) {
+      mutex_.lock();
+      return;
+    }
+    // Walk the stack while waiting rather than holding the lock
+    auto stack = ContentionProfiler::stack();
+    auto start = std::chrono::steady_clock::now();
+    mutex_.lock();
+    auto waitUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+    profiler.record(name_, std::move(stack), waitUs);
+  }
+
+  bool try_lock() {
+    return mutex_.try_lock();
+  }
+
+  void unlock() {
+    mutex_.unlock();
+  }
+
+  const char* name() const {
+    return name_;
+  }
+
+ private:
+  const char* name_;
+  std::mutex mutex_;
+};
+
+}  // namespace thread
+}  // namespace nebula
+#endif  // COMMON_THREAD_PROFILEDMUTEX_H_
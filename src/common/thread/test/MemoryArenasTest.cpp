@@ -0,0 +1,63 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "common/thread/MemoryArenas.h"
+
+DECLARE_string(memory_arenas);
+
+namespace nebula {
+namespace thread {
+
+TEST(MemoryArenas, Init) {
+  FLAGS_memory_arenas = "";
+  EXPECT_TRUE(MemoryArenas::init().ok());
+  EXPECT_FALSE(MemoryArenas::arenaOf(MemoryArenas::kReader).has_value());
+
+  FLAGS_memory_arenas = "reader,no_such_subsystem";
+  EXPECT_FALSE(MemoryArenas::init().ok());
+  EXPECT_FALSE(MemoryArenas::arenaOf(MemoryArenas::kReader).has_value());
+
+  FLAGS_memory_arenas = "reader, block_cache";
+  EXPECT_TRUE(MemoryArenas::init().ok());
+  auto arena = MemoryArenas::arenaOf(MemoryArenas::kBlockCache);
+  if (!arena.has_value()) {
+    // Not linked with jemalloc
+    EXPECT_TRUE(MemoryArenas::stats().empty());
+    return;
+  }
+  EXPECT_NE(*arena, *MemoryArenas::arenaOf(MemoryArenas::kReader));
+  // Created once
+  EXPECT_TRUE(MemoryArenas::init().ok());
+  EXPECT_EQ(*arena, *MemoryArenas::arenaOf(MemoryArenas::kBlockCache));
+
+  auto* ptr = MemoryArenas::allocate(*arena, 1000);
+  ASSERT_NE(nullptr, ptr);
+  EXPECT_GE(MemoryArenas::usableSize(ptr), 1000);
+  auto stats = MemoryArenas::stats();
+  ASSERT_EQ(4, stats.size());
+  EXPECT_EQ("reader", stats[0].subsystem);
+  EXPECT_EQ("block_cache", stats[1].subsystem);
+  EXPECT_GE(stats[1].allocated, 1000);
+  EXPECT_EQ("other", stats[2].subsystem);
+  EXPECT_EQ("total", stats[3].subsystem);
+  EXPECT_GE(stats[3].allocated, stats[1].allocated);
+  MemoryArenas::deallocate(ptr);
+
+  // The allocations of a bound thread are from the arena of the subsystem
+  std::thread reader([] {
+    MemoryArenas::bindCurrentThread(MemoryArenas::kReader);
+    auto buffer = std::make_unique<char[]>(1 << 20);
+    auto readerStats = MemoryArenas::stats();
+    EXPECT_GE(readerStats[0].allocated, 1 << 20);
+  });
+  reader.join();
+}
+
+}  // namespace thread
+}  // namespace nebula
@@ -0,0 +1,55 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+#include <sched.h>
+
+#include "common/base/Base.h"
+#include "common/thread/GenericThreadPool.h"
+#include "common/thread/NumaTopology.h"
+
+namespace nebula {
+namespace thread {
+
+TEST(NumaTopology, ParseCpuList) {
+  EXPECT_EQ(std::vector<int>({0}), NumaTopology::parseCpuList("0"));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 8, 9}), NumaTopology::parseCpuList("0-3,8-9"));
+  EXPECT_EQ(std::vector<int>({1, 5, 6}), NumaTopology::parseCpuList("1,5-6"));
+  EXPECT_TRUE(NumaTopology::parseCpuList("").empty());
+  EXPECT_TRUE(NumaTopology::parseCpuList("a-b").empty());
+}
+
+TEST(NumaTopology, Nodes) {
+  const auto& topology = NumaTopology::instance();
+  ASSERT_GE(topology.numNodes(), 1);
+  size_t numCpus = 0;
+  for (size_t node = 0; node < topology.numNodes(); node++) {
+    numCpus += topology.cpusOf(node).size();
+  }
+  EXPECT_GT(numCpus, 0);
+}
+
+TEST(NumaTopology, BoundThreadPool) {
+  // Bound to one of the cpus the process could run on
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  ASSERT_EQ(0, ::sched_getaffinity(0, sizeof(set), &set));
+  int cpu = 0;
+  while (!CPU_ISSET(cpu, &set)) {
+    cpu++;
+  }
+
+  GenericThreadPool pool;
+  ASSERT_TRUE(pool.start(2, "bound", {cpu}));
+  for (auto i = 0; i < 4; i++) {
+    auto running = pool.addTask([] { return ::sched_getcpu(); }).get();
+    EXPECT_EQ(cpu, running);
+  }
+  pool.stop();
+  pool.wait();
+}
+
+}  // namespace thread
+}  // namespace nebula
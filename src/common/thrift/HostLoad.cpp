@@ -0,0 +1,168 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/thrift/HostLoad.h"
+
+#include "common/time/WallClock.h"
+
+DEFINE_uint32(client_max_inflight_per_host,
+              0,
+              "The max number of rpc in flight to a host, the others wait until some of them "
+              "are done. 0 means no limit");
+DEFINE_double(client_slow_host_latency_ratio,
+              3.0,
+              "A host is slow if its recent rpc latency is this times of the median of all the "
+              "hosts, the reads which could be served by followers avoid the slow hosts. 0 means "
+              "never treat a host as slow");
+DEFINE_uint32(client_tail_latency_percentile,
+              95,
+              "The percentile of the rpc latency of each host estimated as its tail latency");
+
+namespace nebula {
+namespace thrift {
+
+// The weight of the latest rpc in the moving average of latency
+static constexpr double kLatencyWeight = 0.1;
+// The step of the estimate of tail latency relative to itself
+static constexpr double kTailLatencyStep = 0.05;
+// A slow host is picked again if none of its rpc is done in such a while
+static constexpr int64_t kSlowHostExpiredMs = 10 * 1000;
+// The slow hosts are detected at most once in such a while
+static constexpr int64_t kDetectSlowHostsIntervalMs = 100;
+
+HostLoad::Load& HostLoad::loadOf(const HostAddr& host) {
+  {
+    std::shared_lock<std::shared_mutex> guard(lock_);
+    auto iter = loads_.find(host);
+    if (iter != loads_.end()) {
+      return *iter->second;
+    }
+  }
+  std::unique_lock<std::shared_mutex> guard(lock_);
+  auto& load = loads_[host];
+  if (load == nullptr) {
+    load = std::make_unique<Load>();
+  }
+  return *load;
+}
+
+const HostLoad::Load* HostLoad::findLoad(const HostAddr& host) const {
+  std::shared_lock<std::shared_mutex> guard(lock_);
+  auto iter = loads_.find(host);
+  return iter == loads_.end() ? nullptr : iter->second.get();
+}
+
+folly::SemiFuture<folly::Unit> HostLoad::acquire(const HostAddr& host) {
+  auto& load = loadOf(host);
+  std::lock_guard<std::mutex> guard(load.lock);
+  auto limit = FLAGS_client_max_inflight_per_host;
+  if (limit == 0 || load.inflight < limit) {
+    ++load.inflight;
+    return folly::makeSemiFuture();
+  }
+  load.waiters.emplace_back();
+  return load.waiters.back().getSemiFuture();
+}
+
+void HostLoad::release(const HostAddr& host, int64_t latencyUs) {
+  auto& load = loadOf(host);
+  std::optional<folly::Promise<folly::Unit>> next;
+  {
+    std::lock_guard<std::mutex> guard(load.lock);
+    if (load.latencyUs == 0) {
+      load.latencyUs = latencyUs;
+      load.tailLatencyUs = latencyUs;
+    } else {
+      load.latencyUs = load.latencyUs * (1 - kLatencyWeight) + latencyUs * kLatencyWeight;
+      // Moving up by p and down by 1 - p, the estimate stays where p of the latency is below it
+      auto p = std::min(FLAGS_client_tail_latency_percentile, 100U) / 100.0;
+      if (latencyUs > load.tailLatencyUs) {
+        load.tailLatencyUs *= 1 + kTailLatencyStep * p;
+      } else {
+        load.tailLatencyUs *= 1 - kTailLatencyStep * (1 - p);
+      }
+    }
+    load.updatedMs = time::WallClock::fastNowInMilliSec();
+    if (!load.waiters.empty()) {
+      // The slot is handed to the waiter directly
+      next = std::move(load.waiters.front());
+      load.waiters.pop_front();
+    } else if (load.inflight > 0) {
+      --load.inflight;
+    }
+  }
+  if (next.has_value()) {
+    next->setValue();
+  }
+  detectSlowHosts();
+}
+
+size_t HostLoad::inflight(const HostAddr& host) const {
+  auto* load = findLoad(host);
+  if (load == nullptr) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> guard(load->lock);
+  return load->inflight;
+}
+
+bool HostLoad::isSlow(const HostAddr& host) const {
+  auto* load = findLoad(host);
+  if (load == nullptr || !load->slow) {
+    return false;
+  }
+  return time::WallClock::fastNowInMilliSec() - load->updatedMs < kSlowHostExpiredMs;
+}
+
+int64_t HostLoad::tailLatencyUs(const HostAddr& host) const {
+  auto* load = findLoad(host);
+  if (load == nullptr) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> guard(load->lock);
+  return static_cast<int64_t>(load->tailLatencyUs);
+}
+
+void HostLoad::detectSlowHosts() {
+  auto now = time::WallClock::fastNowInMilliSec();
+  auto last = detectedMs_.load();
+  // Only one of the rpc done in an interval detects the slow hosts
+  if (now - last < kDetectSlowHostsIntervalMs ||
+      !detectedMs_.compare_exchange_strong(last, now)) {
+    return;
+  }
+
+  std::shared_lock<std::shared_mutex> guard(lock_);
+  auto ratio = FLAGS_client_slow_host_latency_ratio;
+  std::vector<std::pair<Load*, double>> latencies;
+  latencies.reserve(loads_.size());
+  for (const auto& load : loads_) {
+    // Only the hosts with some rpc done count
+    if (load.second->updatedMs > 0) {
+      std::lock_guard<std::mutex> loadGuard(load.second->lock);
+      latencies.emplace_back(load.second.get(), load.second->latencyUs);
+    }
+  }
+  if (ratio <= 0 || latencies.size() < 2) {
+    for (auto& load : loads_) {
+      load.second->slow = false;
+    }
+    return;
+  }
+  std::vector<double> sorted;
+  sorted.reserve(latencies.size());
+  for (const auto& latency : latencies) {
+    sorted.emplace_back(latency.second);
+  }
+  auto mid = sorted.begin() + (sorted.size() - 1) / 2;
+  std::nth_element(sorted.begin(), mid, sorted.end());
+  auto threshold = *mid * ratio;
+  for (auto& latency : latencies) {
+    latency.first->slow = *mid > 0 && latency.second > threshold;
+  }
+}
+
+}  // namespace thrift
+}  // namespace nebula
@@ -0,0 +1,100 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_THRIFT_HOSTLOAD_H_
+#define COMMON_THRIFT_HOSTLOAD_H_
+
+#include <folly/futures/Future.h>
+
+#include <shared_mutex>
+
+#include "common/base/Base.h"
+#include "common/datatypes/HostAddr.h"
+
+DECLARE_uint32(client_max_inflight_per_host);
+DECLARE_double(client_slow_host_latency_ratio);
+DECLARE_uint32(client_tail_latency_percentile);
+
+namespace nebula {
+namespace thrift {
+
+/**
+ * @brief The load of the hosts a client manager sends rpc to. It keeps the number of rpc in
+ * flight of each host, holds the rpc once a host has client_max_inflight_per_host in flight, and
+ * tells the hosts which are much slower than the others, so that the reads could be served by the
+ * other replicas.
+ *
+ * Each host is guarded by a lock of its own, so the rpc of different hosts don't contend, and the
+ * slow hosts are detected once in a while rather than by every rpc.
+ */
+class HostLoad final {
+ public:
+  /**
+   * @brief Take a slot of the host before sending an rpc to it
+   *
+   * @param host
+   * @return folly::SemiFuture<folly::Unit> Fulfilled once the host has less rpc than the limit in
+   * flight, and at once if there is no limit
+   */
+  folly::SemiFuture<folly::Unit> acquire(const HostAddr& host);
+
+  /**
+   * @brief Give back the slot once the rpc is done, the first one waiting for the host is sent
+   *
+   * @param host
+   * @param latencyUs Latency of the rpc, including the failed ones
+   */
+  void release(const HostAddr& host, int64_t latencyUs);
+
+  size_t inflight(const HostAddr& host) const;
+
+  /**
+   * @brief Whether the recent latency of the host is client_slow_host_latency_ratio times of the
+   * median of all the hosts. A host is not slow anymore if no rpc of it is done for a while, so
+   * that it could be picked again to find out whether it is recovered.
+   */
+  bool isSlow(const HostAddr& host) const;
+
+  /**
+   * @brief The estimated client_tail_latency_percentile percentile of the rpc latency of the host
+   *
+   * @param host
+   * @return int64_t The latency in us, 0 if no rpc of it is done yet
+   */
+  int64_t tailLatencyUs(const HostAddr& host) const;
+
+ private:
+  struct Load {
+    // Guards the fields below but the atomic ones
+    mutable std::mutex lock;
+    size_t inflight{0};
+    std::deque<folly::Promise<folly::Unit>> waiters;
+    // Moving average of the latency
+    double latencyUs{0};
+    // Estimate of the tail latency, which is moved up or down a little by each rpc
+    double tailLatencyUs{0};
+    std::atomic<int64_t> updatedMs{0};
+    std::atomic<bool> slow{false};
+  };
+
+  // The load of the host, which is added if it's not there yet
+  Load& loadOf(const HostAddr& host);
+
+  // The load of the host, nullptr if no rpc is sent to it yet
+  const Load* findLoad(const HostAddr& host) const;
+
+  // Mark the slow hosts by the latency of all the hosts, if it's not done for a while
+  void detectSlowHosts();
+
+  // Guards the map only, the loads are never removed once added
+  mutable std::shared_mutex lock_;
+  std::unordered_map<HostAddr, std::unique_ptr<Load>> loads_;
+  std::atomic<int64_t> detectedMs_{0};
+};
+
+}  // namespace thrift
+}  // namespace nebula
+
+#endif  // COMMON_THRIFT_HOSTLOAD_H_
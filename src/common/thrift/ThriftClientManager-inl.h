@@ -90,6 +90,11 @@ std::shared_ptr<ClientType> ThriftClientManager<ClientType>::client(const HostAd
   if (compatibility) {
     clientChannel->setProtocolId(apache::thrift::protocol::T_BINARY_PROTOCOL);
     //    clientChannel->setClientType(THRIFT_UNFRAMED_DEPRECATED);
+  } else {
+    clientChannel->setProtocolId(options_.protocolId);
+  }
+  if (options_.compression.has_value()) {
+    clientChannel->setDesiredCompressionConfig(*options_.compression);
   }
   std::shared_ptr<ClientType> client(new ClientType(std::move(clientChannel)), [evb](auto* p) {
     evb->runImmediatelyOrRunInEventBaseThreadAndWait([p] { delete p; });
@@ -8,3 +8,39 @@
 #include "common/base/Base.h"
 
 DEFINE_int32(conn_timeout_ms, 1000, "Connection timeout in milliseconds");
+
+namespace nebula {
+namespace thrift {
+
+StatusOr<ChannelOptions> ChannelOptions::make(const std::string& protocol,
+                                              const std::string& codec,
+                                              int64_t compressionSizeLimit) {
+  ChannelOptions options;
+  if (protocol == "compact") {
+    options.protocolId = apache::thrift::protocol::T_COMPACT_PROTOCOL;
+  } else if (protocol == "binary") {
+    options.protocolId = apache::thrift::protocol::T_BINARY_PROTOCOL;
+  } else {
+    return Status::Error("Unknown thrift protocol: %s", protocol.c_str());
+  }
+
+  if (codec == "none") {
+    return options;
+  }
+  apache::thrift::CodecConfig codecConfig;
+  if (codec == "zstd") {
+    codecConfig.set_zstdConfig(apache::thrift::ZstdCompressionCodecConfig());
+  } else if (codec == "zlib") {
+    codecConfig.set_zlibConfig(apache::thrift::ZlibCompressionCodecConfig());
+  } else {
+    return Status::Error("Unknown compression codec: %s", codec.c_str());
+  }
+  apache::thrift::CompressionConfig compression;
+  compression.codecConfig_ref() = std::move(codecConfig);
+  compression.compressionSizeLimit_ref() = compressionSizeLimit;
+  options.compression = std::move(compression);
+  return options;
+}
+
+}  // namespace thrift
+}  // namespace nebula
@@ -8,13 +8,38 @@
 
 #include <folly/io/async/AsyncSocket.h>
 #include <folly/io/async/EventBaseManager.h>
+#include <thrift/lib/cpp/protocol/TProtocolTypes.h>
+#include <thrift/lib/thrift/gen-cpp2/RpcMetadata_types.h>
 
 #include "common/base/Base.h"
+#include "common/base/StatusOr.h"
 #include "common/datatypes/HostAddr.h"
+#include "common/thrift/HostLoad.h"
 
 namespace nebula {
 namespace thrift {
 
+// The options of the channels created by a client manager
+struct ChannelOptions {
+  // The protocol to serialize the requests and the responses
+  uint16_t protocolId{apache::thrift::protocol::T_COMPACT_PROTOCOL};
+  // The compression asked for the responses, which are compressed by the server only if they
+  // are larger than the size limit in it. Not compressed if not set.
+  std::optional<apache::thrift::CompressionConfig> compression;
+
+  /**
+   * @brief Build the options by the name of the protocol and the codec of the compression
+   *
+   * @param protocol "compact" or "binary"
+   * @param codec "none", "zstd" or "zlib"
+   * @param compressionSizeLimit Responses no larger than it in bytes are not compressed
+   * @return StatusOr<ChannelOptions>
+   */
+  static StatusOr<ChannelOptions> make(const std::string& protocol,
+                                       const std::string& codec,
+                                       int64_t compressionSizeLimit);
+};
+
 template <class ClientType>
 class ThriftClientManager final {
  public:
@@ -27,10 +52,19 @@ class ThriftClientManager final {
     VLOG(3) << "~ThriftClientManager";
   }
 
-  explicit ThriftClientManager(bool enableSSL = false) : enableSSL_(enableSSL) {
+  explicit ThriftClientManager(bool enableSSL = false, ChannelOptions options = ChannelOptions())
+      : enableSSL_(enableSSL), options_(std::move(options)) {
     VLOG(3) << "ThriftClientManager";
   }
 
+  /**
+   * @brief The load of the hosts, the callers take a slot of the host before sending an rpc by
+   * the client, and give it back once done.
+   */
+  HostLoad& hostLoad() {
+    return hostLoad_;
+  }
+
  private:
   using ClientMap =
       std::unordered_map<std::pair<HostAddr, folly::EventBase*>, std::shared_ptr<ClientType>>;
@@ -38,6 +72,8 @@ class ThriftClientManager final {
   folly::ThreadLocal<ClientMap> clientMap_;
   // whether enable ssl
   bool enableSSL_{false};
+  ChannelOptions options_;
+  HostLoad hostLoad_;
 };
 
 }  // namespace thrift
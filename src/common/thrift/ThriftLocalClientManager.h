@@ -10,6 +10,7 @@
 
 #include "common/base/Base.h"
 #include "common/datatypes/HostAddr.h"
+#include "common/thrift/ThriftClientManager.h"
 namespace nebula {
 namespace thrift {
 
@@ -31,10 +32,18 @@ class LocalClientManager final {
     VLOG(3) << "~LocalClientManager";
   }
 
-  explicit LocalClientManager(bool enableSSL = false) {
+  explicit LocalClientManager(bool enableSSL = false, ChannelOptions options = ChannelOptions()) {
     UNUSED(enableSSL);
+    UNUSED(options);
     VLOG(3) << "LocalClientManager";
   }
+
+  HostLoad& hostLoad() {
+    return hostLoad_;
+  }
+
+ private:
+  HostLoad hostLoad_;
 };
 }  // namespace thrift
 }  // namespace nebula
@@ -0,0 +1,99 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "common/thrift/HostLoad.h"
+
+namespace nebula {
+namespace thrift {
+
+TEST(HostLoadTest, MaxInflight) {
+  gflags::FlagSaver saver;
+  FLAGS_client_max_inflight_per_host = 2;
+  HostLoad hostLoad;
+  HostAddr host1("127.0.0.1", 1);
+  HostAddr host2("127.0.0.1", 2);
+
+  auto f1 = hostLoad.acquire(host1);
+  auto f2 = hostLoad.acquire(host1);
+  auto f3 = hostLoad.acquire(host1);
+  EXPECT_TRUE(f1.isReady());
+  EXPECT_TRUE(f2.isReady());
+  EXPECT_FALSE(f3.isReady());
+  EXPECT_EQ(2, hostLoad.inflight(host1));
+  // The other hosts are not limited by it
+  EXPECT_TRUE(hostLoad.acquire(host2).isReady());
+  EXPECT_EQ(1, hostLoad.inflight(host2));
+
+  // The slot is handed to the one waiting
+  hostLoad.release(host1, 100);
+  EXPECT_TRUE(f3.isReady());
+  EXPECT_EQ(2, hostLoad.inflight(host1));
+  hostLoad.release(host1, 100);
+  hostLoad.release(host1, 100);
+  hostLoad.release(host2, 100);
+  EXPECT_EQ(0, hostLoad.inflight(host1));
+  EXPECT_EQ(0, hostLoad.inflight(host2));
+}
+
+TEST(HostLoadTest, SlowHost) {
+  gflags::FlagSaver saver;
+  FLAGS_client_slow_host_latency_ratio = 3.0;
+  HostLoad hostLoad;
+  std::vector<HostAddr> hosts = {
+      HostAddr("127.0.0.1", 1), HostAddr("127.0.0.1", 2), HostAddr("127.0.0.1", 3)};
+  for (int i = 0; i < 10; ++i) {
+    for (size_t j = 0; j < hosts.size(); ++j) {
+      hostLoad.acquire(hosts[j]);
+      hostLoad.release(hosts[j], j + 1 == hosts.size() ? 10000 : 100);
+    }
+  }
+  EXPECT_LT(0, hostLoad.tailLatencyUs(hosts[0]));
+  // The slow hosts are detected once in a while
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  hostLoad.acquire(hosts[0]);
+  hostLoad.release(hosts[0], 100);
+  EXPECT_FALSE(hostLoad.isSlow(hosts[0]));
+  EXPECT_FALSE(hostLoad.isSlow(hosts[1]));
+  EXPECT_TRUE(hostLoad.isSlow(hosts[2]));
+
+  FLAGS_client_slow_host_latency_ratio = 0;
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  hostLoad.acquire(hosts[0]);
+  hostLoad.release(hosts[0], 100);
+  EXPECT_FALSE(hostLoad.isSlow(hosts[2]));
+}
+
+TEST(HostLoadTest, Concurrent) {
+  gflags::FlagSaver saver;
+  FLAGS_client_max_inflight_per_host = 4;
+  HostLoad hostLoad;
+  std::vector<HostAddr> hosts;
+  for (int i = 0; i < 4; ++i) {
+    hosts.emplace_back("127.0.0.1", i);
+  }
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&hostLoad, &hosts, i]() {
+      const auto& host = hosts[i % hosts.size()];
+      for (int j = 0; j < 1000; ++j) {
+        auto future = hostLoad.acquire(host);
+        hostLoad.release(host, 100);
+        std::move(future).get();
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (const auto& host : hosts) {
+    EXPECT_EQ(0, hostLoad.inflight(host));
+  }
+}
+
+}  // namespace thrift
+}  // namespace nebula
@@ -5,6 +5,8 @@
 
 #include "common/time/TimeConversion.h"
 
+#include <limits>
+
 namespace nebula {
 namespace time {
 
@@ -61,6 +63,21 @@ const DateTime TimeConversion::kEpoch(1970, 1, 1, 0, 0, 0, 0);
   rem %= kSecondsOfHour;
   dt.minute = rem / kSecondsOfMinute;
   dt.sec = rem % kSecondsOfMinute;
+
+  // The times converted one after another, e.g. the timestamps of the events, are mostly in the
+  // same day, so the date of the last day converted by the thread is kept
+  struct LastDay {
+    int64_t days{std::numeric_limits<int64_t>::min()};
+    DateTime date;
+  };
+  static thread_local LastDay lastDay;
+  if (days == lastDay.days) {
+    dt.year = lastDay.date.year;
+    dt.month = lastDay.date.month;
+    dt.day = lastDay.date.day;
+    return dt;
+  }
+  lastDay.days = days;
   y = 1970;
 
 #define DIV(a, b) ((a) / (b) - ((a) % (b) < 0))
@@ -85,6 +102,7 @@ const DateTime TimeConversion::kEpoch(1970, 1, 1, 0, 0, 0, 0);
   days -= ip[y];
   dt.month = y + 1;
   dt.day = days + 1;
+  lastDay.date = dt;
   return dt;
 }
 
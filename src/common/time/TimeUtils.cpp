@@ -5,6 +5,7 @@
 
 #include "common/time/TimeUtils.h"
 
+#include <cctype>
 #include <limits>
 
 #include "common/fs/FileUtils.h"
@@ -17,6 +18,84 @@ namespace time {
 // The mainstream Linux kernel's implementation constrains this
 constexpr int64_t kMaxTimestamp = std::numeric_limits<int64_t>::max() / 1000000000;
 
+namespace {
+
+// Read exactly n digits
+bool readDigits(folly::StringPiece &str, size_t n, int32_t *value) {
+  if (str.size() < n) {
+    return false;
+  }
+  int32_t v = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (!std::isdigit(static_cast<unsigned char>(str[i]))) {
+      return false;
+    }
+    v = v * 10 + (str[i] - '0');
+  }
+  str.advance(n);
+  *value = v;
+  return true;
+}
+
+bool readChar(folly::StringPiece &str, char c) {
+  if (str.empty() || str.front() != c) {
+    return false;
+  }
+  str.advance(1);
+  return true;
+}
+
+// The fast paths of the canonical formats `YYYY-MM-DD' and `hh:mm:ss[.ffffff]' without the
+// timezone, which are most of the strings converted. The others, and the ones not obviously
+// valid, are left to DatetimeReader, so the results are the same as it.
+bool fastReadDate(folly::StringPiece &str, Date *date) {
+  int32_t year = 0;
+  int32_t month = 0;
+  int32_t day = 0;
+  if (!readDigits(str, 4, &year) || !readChar(str, '-') || !readDigits(str, 2, &month) ||
+      !readChar(str, '-') || !readDigits(str, 2, &day)) {
+    return false;
+  }
+  if (month < 1 || month > 12 || day < 1 || day > 31) {
+    return false;
+  }
+  *date = Date(year, month, day);
+  return TimeUtils::validateDate(*date).ok();
+}
+
+bool fastReadTime(folly::StringPiece &str, Time *time) {
+  int32_t hour = 0;
+  int32_t minute = 0;
+  int32_t sec = 0;
+  if (!readDigits(str, 2, &hour) || !readChar(str, ':') || !readDigits(str, 2, &minute) ||
+      !readChar(str, ':') || !readDigits(str, 2, &sec)) {
+    return false;
+  }
+  int32_t microsec = 0;
+  if (readChar(str, '.')) {
+    size_t digits = 0;
+    while (digits < str.size() && std::isdigit(static_cast<unsigned char>(str[digits]))) {
+      digits++;
+    }
+    if (digits == 0 || digits > 6 || !readDigits(str, digits, &microsec)) {
+      return false;
+    }
+    for (; digits < 6; digits++) {
+      microsec *= 10;
+    }
+  }
+  *time = Time(hour, minute, sec, microsec);
+  return TimeUtils::validateTime(*time).ok();
+}
+
+// The reader is reused by the thread, instead of building the scanner and the parser each time
+DatetimeReader &threadReader() {
+  static thread_local DatetimeReader reader;
+  return reader;
+}
+
+}  // namespace
+
 /*static*/ StatusOr<DateTime> TimeUtils::dateTimeFromMap(const Map &m) {
   // TODO(shylock) support timezone parameter
   DateTime dt;
@@ -205,22 +284,41 @@ StatusOr<Value> TimeUtils::toTimestamp(const Value &val) {
 }
 
 /*static*/ StatusOr<DateTime> TimeUtils::parseDateTime(const std::string &str) {
-  auto p = DatetimeReader();
-  auto result = p.readDatetime(str);
+  folly::StringPiece text(str);
+  Date date;
+  if (fastReadDate(text, &date)) {
+    if (text.empty()) {
+      return DateTime(date);
+    }
+    Time time;
+    if ((readChar(text, 'T') || readChar(text, ' ')) && fastReadTime(text, &time) &&
+        text.empty()) {
+      return DateTime(date, time);
+    }
+  }
+  auto result = threadReader().readDatetime(str);
   NG_RETURN_IF_ERROR(result);
   return result.value();
 }
 
 /*static*/ StatusOr<Date> TimeUtils::parseDate(const std::string &str) {
-  auto p = DatetimeReader();
-  auto result = p.readDate(str);
+  folly::StringPiece text(str);
+  Date date;
+  if (fastReadDate(text, &date) && text.empty()) {
+    return date;
+  }
+  auto result = threadReader().readDate(str);
   NG_RETURN_IF_ERROR(result);
   return result.value();
 }
 
 /*static*/ StatusOr<Time> TimeUtils::parseTime(const std::string &str) {
-  auto p = DatetimeReader();
-  return p.readTime(str);
+  folly::StringPiece text(str);
+  Time time;
+  if (fastReadTime(text, &time) && text.empty()) {
+    return time;
+  }
+  return threadReader().readTime(str);
 }
 
 }  // namespace time
@@ -39,6 +39,7 @@ class Timezone {
       return Status::Error("Not supported timezone `%s'.", region.c_str());
     }
     zoneInfo_ = zoneInfo;
+    utcOffsetSecs_ = zoneInfo_->base_utc_offset().total_seconds();
     return Status::OK();
   }
 
@@ -47,6 +48,7 @@ class Timezone {
   NG_MUST_USE_RESULT Status parsePosixTimezone(const std::string &posixTimezone) {
     try {
       zoneInfo_.reset(new ::boost::local_time::posix_time_zone(posixTimezone));
+      utcOffsetSecs_ = zoneInfo_->base_utc_offset().total_seconds();
     } catch (const std::exception &e) {
       return Status::Error(
           "Malformed timezone format: `%s', exception: `%s'.", posixTimezone.c_str(), e.what());
@@ -58,9 +60,10 @@ class Timezone {
     return DCHECK_NOTNULL(zoneInfo_)->std_zone_name();
   }
 
-  // offset in seconds
+  // offset in seconds, cached when the zone is loaded since it's read by each conversion of time
   int32_t utcOffsetSecs() const {
-    return DCHECK_NOTNULL(zoneInfo_)->base_utc_offset().total_seconds();
+    DCHECK(zoneInfo_ != nullptr);
+    return utcOffsetSecs_;
   }
 
   // TODO(shylock) Get Timzone info(I.E. GMT offset) directly from IANA tzdb
@@ -80,6 +83,7 @@ class Timezone {
 
   ::boost::shared_ptr<::boost::date_time::time_zone_base<::boost::posix_time::ptime, char>>
       zoneInfo_{nullptr};
+  int32_t utcOffsetSecs_{0};
 };
 
 }  // namespace time
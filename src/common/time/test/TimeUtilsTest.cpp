@@ -167,6 +167,56 @@ TEST(Time, Parse) {
     ASSERT_TRUE(result.ok());
     EXPECT_EQ(result.value(), DateTime(2019, 3, 4, 22, 0, 30, 0));
   }
+  {
+    auto result = time::TimeUtils::parseDateTime("2019-03-04T22:00:30.12");
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(result.value(), DateTime(2019, 3, 4, 22, 0, 30, 120000));
+  }
+  {
+    auto result = time::TimeUtils::parseDateTime("2019-03-04");
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(result.value(), DateTime(2019, 3, 4, 0, 0, 0, 0));
+  }
+  {
+    auto result = time::TimeUtils::parseDateTime("2019-02-30T22:00:30");
+    EXPECT_FALSE(result.ok());
+  }
+  {
+    auto result = time::TimeUtils::parseDateTime("2019-03-04T24:00:30");
+    EXPECT_FALSE(result.ok());
+  }
+  // date
+  {
+    auto result = time::TimeUtils::parseDate("2020-02-29");
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(result.value(), Date(2020, 2, 29));
+  }
+  {
+    auto result = time::TimeUtils::parseDate("2019-02-29");
+    EXPECT_FALSE(result.ok());
+  }
+  // time
+  {
+    auto result = time::TimeUtils::parseTime("22:00:30.000001");
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(result.value(), Time(22, 0, 30, 1));
+  }
+  {
+    auto result = time::TimeUtils::parseTime("22:00:30.");
+    EXPECT_FALSE(result.ok());
+  }
+}
+
+TEST(Time, ConvertAcrossDays) {
+  // The conversions of the same day are cached, so convert back and forth across the days
+  for (int64_t seconds : {0L, 86399L, 86400L, 86399L, 1600306518L, 1600306519L, -1L, 0L}) {
+    auto dt = time::TimeConversion::unixSecondsToDateTime(seconds);
+    EXPECT_EQ(seconds, time::TimeConversion::dateTimeToUnixSeconds(dt)) << dt;
+  }
+  EXPECT_EQ(time::TimeConversion::unixSecondsToDateTime(86399),
+            DateTime(1970, 1, 1, 23, 59, 59, 0));
+  EXPECT_EQ(time::TimeConversion::unixSecondsToDateTime(86400), DateTime(1970, 1, 2, 0, 0, 0, 0));
+  EXPECT_EQ(time::TimeConversion::unixSecondsToDateTime(-1), DateTime(1969, 12, 31, 23, 59, 59, 0));
 }
 
 }  // namespace nebula
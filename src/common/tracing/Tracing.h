@@ -0,0 +1,367 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_TRACING_TRACING_H_
+#define COMMON_TRACING_TRACING_H_
+
+#include <folly/Random.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nebula {
+namespace tracing {
+
+/**
+ * @brief The context of a span which is passed to another process, so that the spans there are
+ * the children of it. A zero trace id means the caller is not traced.
+ */
+struct TraceContext {
+  uint64_t traceIdHigh{0};
+  uint64_t traceIdLow{0};
+  uint64_t spanId{0};
+  bool sampled{false};
+
+  bool valid() const {
+    return traceIdHigh != 0 || traceIdLow != 0;
+  }
+};
+
+/**
+ * @brief A finished span, the times are in microseconds since epoch
+ */
+struct SpanData {
+  uint64_t traceIdHigh{0};
+  uint64_t traceIdLow{0};
+  uint64_t spanId{0};
+  uint64_t parentSpanId{0};
+  std::string name;
+  int64_t startUs{0};
+  int64_t endUs{0};
+  std::vector<std::pair<std::string, std::string>> attributes;
+};
+
+inline int64_t nowInUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief The process wide settings of tracing and the spans waiting to be exported.
+ *
+ * A request is traced if it is sampled by sample ratio, which is decided by the process receiving
+ * the request from client and passed along with the trace context. When the slow threshold is set,
+ * all the requests are traced, but the spans of a request which is not sampled are kept only if
+ * the request takes longer than the threshold in this process. Tracing is off until configured,
+ * then no span allocates anything.
+ */
+class Tracer final {
+ public:
+  static Tracer& instance() {
+    static Tracer tracer;
+    return tracer;
+  }
+
+  void configure(double sampleRatio, int64_t slowThresholdUs, size_t maxPendingSpans) {
+    enabled_.store(true, std::memory_order_relaxed);
+    sampleRatio_.store(sampleRatio, std::memory_order_relaxed);
+    slowThresholdUs_.store(slowThresholdUs, std::memory_order_relaxed);
+    maxPendingSpans_.store(maxPendingSpans, std::memory_order_relaxed);
+  }
+
+  bool enabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Whether to trace a request received from client
+  bool sample() const {
+    auto ratio = sampleRatio_.load(std::memory_order_relaxed);
+    return ratio >= 1.0 || (ratio > 0 && folly::Random::randDouble01() < ratio);
+  }
+
+  // Whether to trace a request which is not sampled, the spans are kept only if it is slow
+  bool recordUnsampled() const {
+    return slowThresholdUs_.load(std::memory_order_relaxed) > 0;
+  }
+
+  bool isSlow(int64_t durationUs) const {
+    auto threshold = slowThresholdUs_.load(std::memory_order_relaxed);
+    return threshold > 0 && durationUs >= threshold;
+  }
+
+  /**
+   * @brief Add the spans of a finished trace, which are dropped if there are too many spans not
+   * exported yet
+   */
+  void collect(std::vector<SpanData>&& spans) {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (pending_.size() + spans.size() > maxPendingSpans_.load(std::memory_order_relaxed)) {
+      dropped_ += spans.size();
+      return;
+    }
+    pending_.insert(pending_.end(),
+                    std::make_move_iterator(spans.begin()),
+                    std::make_move_iterator(spans.end()));
+  }
+
+  /**
+   * @brief Take the spans to export
+   *
+   * @param dropped The number of spans dropped since last time
+   */
+  std::vector<SpanData> drain(size_t* dropped = nullptr) {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (dropped != nullptr) {
+      *dropped = std::exchange(dropped_, 0);
+    }
+    return std::exchange(pending_, {});
+  }
+
+ private:
+  Tracer() = default;
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<double> sampleRatio_{0};
+  std::atomic<int64_t> slowThresholdUs_{0};
+  std::atomic<size_t> maxPendingSpans_{10000};
+  std::mutex lock_;
+  std::vector<SpanData> pending_;
+  size_t dropped_{0};
+};
+
+/**
+ * @brief The spans of a request in this process. They are handed to the tracer when the last span
+ * referring to the trace is gone, if the request is sampled or slow.
+ */
+class Trace final {
+ public:
+  Trace(uint64_t traceIdHigh, uint64_t traceIdLow, bool sampled)
+      : traceIdHigh_(traceIdHigh), traceIdLow_(traceIdLow), sampled_(sampled) {}
+
+  ~Trace() {
+    if (!spans_.empty() && (sampled_ || Tracer::instance().isSlow(rootDurationUs_))) {
+      Tracer::instance().collect(std::move(spans_));
+    }
+  }
+
+  uint64_t traceIdHigh() const {
+    return traceIdHigh_;
+  }
+
+  uint64_t traceIdLow() const {
+    return traceIdLow_;
+  }
+
+  bool sampled() const {
+    return sampled_;
+  }
+
+  void add(SpanData&& span, bool root) {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (root) {
+      rootDurationUs_ = std::max(rootDurationUs_, span.endUs - span.startUs);
+    }
+    spans_.emplace_back(std::move(span));
+  }
+
+ private:
+  const uint64_t traceIdHigh_;
+  const uint64_t traceIdLow_;
+  const bool sampled_;
+  std::mutex lock_;
+  std::vector<SpanData> spans_;
+  int64_t rootDurationUs_{0};
+};
+
+/**
+ * @brief Refer to a span to create its children, which could be copied to other threads
+ */
+struct SpanRef {
+  std::shared_ptr<Trace> trace;
+  uint64_t spanId{0};
+
+  bool valid() const {
+    return trace != nullptr;
+  }
+};
+
+/**
+ * @brief The span active on this thread, see Scope
+ */
+inline SpanRef& currentSpan() {
+  thread_local SpanRef current;
+  return current;
+}
+
+/**
+ * @brief A timed operation of a traced request, which ends when destroyed or end() is called. A
+ * span created when tracing is off or its parent is not traced does nothing.
+ */
+class Span final {
+ public:
+  Span() = default;
+
+  // A child of the span active on this thread
+  explicit Span(const char* name) : Span(name, currentSpan()) {}
+
+  Span(const char* name, const SpanRef& parent) {
+    if (parent.valid()) {
+      start(name, parent.trace, parent.spanId, false);
+    }
+  }
+
+  /**
+   * @brief The first span of a request in this process, which is a child of the span of the
+   * caller if the context is valid, otherwise it starts a new trace if the request is sampled or
+   * slow requests are traced.
+   */
+  static Span root(const char* name, const TraceContext& context = TraceContext()) {
+    Span span;
+    auto& tracer = Tracer::instance();
+    if (!tracer.enabled()) {
+      return span;
+    }
+    if (context.valid()) {
+      if (context.sampled || tracer.recordUnsampled()) {
+        auto trace =
+            std::make_shared<Trace>(context.traceIdHigh, context.traceIdLow, context.sampled);
+        span.start(name, std::move(trace), context.spanId, true);
+      }
+      return span;
+    }
+    auto sampled = tracer.sample();
+    if (sampled || tracer.recordUnsampled()) {
+      span.start(name, std::make_shared<Trace>(newId(), newId(), sampled), 0, true);
+    }
+    return span;
+  }
+
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+  Span(Span&& other) noexcept
+      : trace_(std::move(other.trace_)), data_(std::move(other.data_)), root_(other.root_) {}
+
+  Span& operator=(Span&& other) noexcept {
+    if (this != &other) {
+      end();
+      trace_ = std::move(other.trace_);
+      data_ = std::move(other.data_);
+      root_ = other.root_;
+    }
+    return *this;
+  }
+
+  ~Span() {
+    end();
+  }
+
+  bool active() const {
+    return trace_ != nullptr;
+  }
+
+  void setAttribute(std::string key, std::string value) {
+    if (active()) {
+      data_.attributes.emplace_back(std::move(key), std::move(value));
+    }
+  }
+
+  void setAttribute(std::string key, int64_t value) {
+    if (active()) {
+      data_.attributes.emplace_back(std::move(key), std::to_string(value));
+    }
+  }
+
+  void end() {
+    if (active()) {
+      data_.endUs = nowInUs();
+      auto trace = std::move(trace_);
+      trace->add(std::move(data_), root_);
+    }
+  }
+
+  SpanRef ref() const {
+    return SpanRef{trace_, data_.spanId};
+  }
+
+  // The context passed to other processes
+  TraceContext context() const {
+    TraceContext context;
+    if (active()) {
+      context.traceIdHigh = data_.traceIdHigh;
+      context.traceIdLow = data_.traceIdLow;
+      context.spanId = data_.spanId;
+      context.sampled = trace_->sampled();
+    }
+    return context;
+  }
+
+  // The context of the span active on this thread
+  static TraceContext currentContext() {
+    TraceContext context;
+    const auto& current = currentSpan();
+    if (current.valid()) {
+      context.traceIdHigh = current.trace->traceIdHigh();
+      context.traceIdLow = current.trace->traceIdLow();
+      context.spanId = current.spanId;
+      context.sampled = current.trace->sampled();
+    }
+    return context;
+  }
+
+ private:
+  static uint64_t newId() {
+    uint64_t id = 0;
+    while (id == 0) {
+      id = folly::Random::rand64();
+    }
+    return id;
+  }
+
+  void start(const char* name, std::shared_ptr<Trace> trace, uint64_t parentSpanId, bool root) {
+    data_.traceIdHigh = trace->traceIdHigh();
+    data_.traceIdLow = trace->traceIdLow();
+    data_.spanId = newId();
+    data_.parentSpanId = parentSpanId;
+    data_.name = name;
+    data_.startUs = nowInUs();
+    trace_ = std::move(trace);
+    root_ = root;
+  }
+
+ private:
+  std::shared_ptr<Trace> trace_;
+  SpanData data_;
+  bool root_{false};
+};
+
+/**
+ * @brief Make a span active on this thread until the scope is gone, so that the spans created by
+ * Span(name) and the requests sent to other processes on this thread are its children.
+ */
+class Scope final {
+ public:
+  explicit Scope(SpanRef span) : prev_(std::exchange(currentSpan(), std::move(span))) {}
+
+  ~Scope() {
+    currentSpan() = std::move(prev_);
+  }
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+ private:
+  SpanRef prev_;
+};
+
+}  // namespace tracing
+}  // namespace nebula
+#endif  // COMMON_TRACING_TRACING_H_
@@ -0,0 +1,118 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "common/base/Base.h"
+#include "common/tracing/Tracing.h"
+
+namespace nebula {
+namespace tracing {
+
+TEST(TracingTest, Disabled) {
+  ASSERT_FALSE(Tracer::instance().enabled());
+  auto root = Span::root("root");
+  ASSERT_FALSE(root.active());
+  Scope scope(root.ref());
+  Span child("child");
+  ASSERT_FALSE(child.active());
+  ASSERT_FALSE(Span::currentContext().valid());
+}
+
+TEST(TracingTest, Sampled) {
+  Tracer::instance().configure(1.0, 0, 100);
+  Tracer::instance().drain();
+  TraceContext context;
+  {
+    auto root = Span::root("root");
+    ASSERT_TRUE(root.active());
+    {
+      Scope scope(root.ref());
+      context = Span::currentContext();
+      Span child("child");
+      ASSERT_TRUE(child.active());
+      child.setAttribute("rows", 10);
+    }
+    ASSERT_FALSE(Span::currentContext().valid());
+  }
+  ASSERT_TRUE(context.valid());
+  ASSERT_TRUE(context.sampled);
+
+  auto spans = Tracer::instance().drain();
+  ASSERT_EQ(2, spans.size());
+  const auto& child = spans[0];
+  const auto& root = spans[1];
+  EXPECT_EQ("child", child.name);
+  EXPECT_EQ("root", root.name);
+  EXPECT_EQ(root.spanId, child.parentSpanId);
+  EXPECT_EQ(0, root.parentSpanId);
+  EXPECT_EQ(root.traceIdHigh, child.traceIdHigh);
+  EXPECT_EQ(root.traceIdLow, child.traceIdLow);
+  EXPECT_EQ(context.spanId, root.spanId);
+  ASSERT_EQ(1, child.attributes.size());
+  EXPECT_EQ("rows", child.attributes[0].first);
+  EXPECT_EQ("10", child.attributes[0].second);
+  EXPECT_LE(root.startUs, child.startUs);
+  EXPECT_LE(child.endUs, root.endUs);
+
+  // The request from another process is a part of the trace of the caller
+  {
+    auto remote = Span::root("remote", context);
+    ASSERT_TRUE(remote.active());
+  }
+  spans = Tracer::instance().drain();
+  ASSERT_EQ(1, spans.size());
+  EXPECT_EQ(context.traceIdHigh, spans[0].traceIdHigh);
+  EXPECT_EQ(context.traceIdLow, spans[0].traceIdLow);
+  EXPECT_EQ(context.spanId, spans[0].parentSpanId);
+}
+
+TEST(TracingTest, Slow) {
+  Tracer::instance().configure(0, 10000, 100);
+  Tracer::instance().drain();
+  {
+    auto fast = Span::root("fast");
+    ASSERT_TRUE(fast.active());
+    Span child("child", fast.ref());
+    ASSERT_TRUE(child.active());
+  }
+  ASSERT_TRUE(Tracer::instance().drain().empty());
+
+  {
+    auto slow = Span::root("slow");
+    Span child("child", slow.ref());
+    child.end();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  auto spans = Tracer::instance().drain();
+  ASSERT_EQ(2, spans.size());
+  EXPECT_EQ("child", spans[0].name);
+  EXPECT_EQ("slow", spans[1].name);
+
+  // The caller didn't sample it, it's traced here only if it's slow
+  TraceContext context{1, 2, 3, false};
+  {
+    auto remote = Span::root("remote", context);
+    ASSERT_TRUE(remote.active());
+  }
+  ASSERT_TRUE(Tracer::instance().drain().empty());
+}
+
+TEST(TracingTest, MaxPendingSpans) {
+  Tracer::instance().configure(1.0, 0, 2);
+  Tracer::instance().drain();
+  for (int i = 0; i < 3; i++) {
+    auto root = Span::root("root");
+  }
+  size_t dropped = 0;
+  auto spans = Tracer::instance().drain(&dropped);
+  EXPECT_EQ(2, spans.size());
+  EXPECT_EQ(1, dropped);
+}
+
+}  // namespace tracing
+}  // namespace nebula
@@ -0,0 +1,86 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_UTILS_BLOOMFILTER_H_
+#define COMMON_UTILS_BLOOMFILTER_H_
+
+#include <folly/Range.h>
+
+#include <cmath>
+
+#include "common/base/MurmurHash2.h"
+
+namespace nebula {
+
+/**
+ * A bloom filter of the byte strings, which is sent along with the requests, so both the bits and
+ * the hashing must be the same on all the hosts. The k bit positions of a key are derived from its
+ * MurmurHash2 by double hashing.
+ */
+class BloomFilter final {
+ public:
+  // A filter of bitsPerKey bits for each of the keys, about 1% false positives by 10 bits per key
+  static BloomFilter withKeys(size_t numKeys, size_t bitsPerKey = 10) {
+    auto numHashes = static_cast<int32_t>(std::lround(bitsPerKey * 0.69));
+    numHashes = std::min(std::max(numHashes, 1), 30);
+    auto numBits = std::max<size_t>(numKeys * bitsPerKey, 64);
+    return BloomFilter(std::string((numBits + 7) / 8, '\0'), numHashes);
+  }
+
+  BloomFilter(std::string bits, int32_t numHashes)
+      : bits_(std::move(bits)), numHashes_(numHashes) {}
+
+  void add(folly::StringPiece key) {
+    auto numBits = bits_.size() * 8;
+    if (numBits == 0) {
+      return;
+    }
+    auto hash = MurmurHash2()(key.data(), key.size());
+    auto delta = (hash >> 32) | (hash << 32);
+    for (int32_t i = 0; i < numHashes_; i++) {
+      auto bit = hash % numBits;
+      bits_[bit / 8] |= static_cast<char>(1 << (bit % 8));
+      hash += delta;
+    }
+  }
+
+  // Whether the key may have been added, there is no false negative. An empty filter matches all.
+  bool mayContain(folly::StringPiece key) const {
+    auto numBits = bits_.size() * 8;
+    if (numBits == 0 || numHashes_ <= 0) {
+      return true;
+    }
+    auto hash = MurmurHash2()(key.data(), key.size());
+    auto delta = (hash >> 32) | (hash << 32);
+    for (int32_t i = 0; i < numHashes_; i++) {
+      auto bit = hash % numBits;
+      if ((bits_[bit / 8] & static_cast<char>(1 << (bit % 8))) == 0) {
+        return false;
+      }
+      hash += delta;
+    }
+    return true;
+  }
+
+  const std::string& bits() const {
+    return bits_;
+  }
+
+  std::string&& moveBits() {
+    return std::move(bits_);
+  }
+
+  int32_t numHashes() const {
+    return numHashes_;
+  }
+
+ private:
+  std::string bits_;
+  int32_t numHashes_{0};
+};
+
+}  // namespace nebula
+
+#endif  // COMMON_UTILS_BLOOMFILTER_H_
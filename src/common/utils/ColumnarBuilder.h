@@ -0,0 +1,256 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_UTILS_COLUMNARBUILDER_H_
+#define COMMON_UTILS_COLUMNARBUILDER_H_
+
+#include "common/datatypes/DataSet.h"
+#include "common/datatypes/Value.h"
+#include "interface/gen-cpp2/common_types.h"
+
+namespace nebula {
+
+/**
+ * Append the values of a column in the layout of an arrow array, see ColumnarColumn. A value not
+ * of the type of the column is appended as null.
+ */
+class ColumnarBuilder final {
+ public:
+  using PropertyType = nebula::cpp2::PropertyType;
+
+  ColumnarBuilder(std::string name, PropertyType type)
+      : name_(std::move(name)), type_(type), width_(fixedWidth(type)) {
+    if (isVariable()) {
+      appendOffset();
+    }
+  }
+
+  /**
+   * @brief Convert a column of the DataSet, the values of which are all of one scalar type or
+   * null are in the arrow layout, and the others are boxed.
+   */
+  static nebula::cpp2::ColumnarColumn fromDataSet(const DataSet& data, size_t col) {
+    std::optional<Value::Type> type;
+    bool mixed = false;
+    for (const auto& row : data.rows) {
+      const auto& value = row.values[col];
+      if (value.empty() || value.isNull()) {
+        continue;
+      }
+      if (type.has_value() && *type != value.type()) {
+        mixed = true;
+        break;
+      }
+      type = value.type();
+    }
+    auto propType = mixed || !type.has_value() ? PropertyType::UNKNOWN : toPropertyType(*type);
+    if (propType == PropertyType::UNKNOWN) {
+      nebula::cpp2::ColumnarColumn column;
+      column.name_ref() = data.colNames[col];
+      column.type_ref() = PropertyType::UNKNOWN;
+      std::vector<Value> boxed;
+      boxed.reserve(data.rows.size());
+      for (const auto& row : data.rows) {
+        boxed.emplace_back(row.values[col]);
+      }
+      column.boxed_ref() = std::move(boxed);
+      return column;
+    }
+    ColumnarBuilder builder(data.colNames[col], propType);
+    for (const auto& row : data.rows) {
+      builder.append(row.values[col]);
+    }
+    return builder.finish();
+  }
+
+  void append(const Value& value) {
+    switch (type_) {
+      case PropertyType::BOOL:
+        if (!value.isBool()) {
+          break;
+        }
+        setValid(true);
+        if (value.getBool()) {
+          values_.back() |= static_cast<char>(1 << ((rows_ - 1) % 8));
+        }
+        return;
+      case PropertyType::INT8:
+      case PropertyType::INT16:
+      case PropertyType::INT32:
+      case PropertyType::INT64:
+      case PropertyType::TIMESTAMP:
+        if (value.isInt()) {
+          appendInt(value.getInt());
+          return;
+        }
+        break;
+      case PropertyType::FLOAT:
+      case PropertyType::DOUBLE:
+        if (value.isFloat()) {
+          setValid(true);
+          if (type_ == PropertyType::FLOAT) {
+            appendFixed(static_cast<float>(value.getFloat()));
+          } else {
+            appendFixed(value.getFloat());
+          }
+          return;
+        }
+        break;
+      case PropertyType::STRING:
+      case PropertyType::FIXED_STRING:
+        if (value.isStr()) {
+          appendBytes(value.getStr());
+          return;
+        }
+        break;
+      default:
+        if (!value.empty() && !value.isNull()) {
+          appendBytes(value.toString());
+          return;
+        }
+        break;
+    }
+    appendNull();
+  }
+
+  void appendInt(int64_t value) {
+    setValid(true);
+    switch (width_) {
+      case 1:
+        appendFixed(static_cast<int8_t>(value));
+        break;
+      case 2:
+        appendFixed(static_cast<int16_t>(value));
+        break;
+      case 4:
+        appendFixed(static_cast<int32_t>(value));
+        break;
+      default:
+        appendFixed(value);
+        break;
+    }
+  }
+
+  void appendBytes(folly::StringPiece bytes) {
+    setValid(true);
+    values_.append(bytes.data(), bytes.size());
+    appendOffset();
+  }
+
+  void appendNull() {
+    setValid(false);
+    if (isVariable()) {
+      appendOffset();
+    } else if (width_ > 0) {
+      values_.append(width_, '\0');
+    }
+  }
+
+  size_t bytes() const {
+    return values_.size() + offsets_.size() + validity_.size();
+  }
+
+  nebula::cpp2::ColumnarColumn finish() {
+    nebula::cpp2::ColumnarColumn column;
+    column.name_ref() = std::move(name_);
+    column.type_ref() = type_;
+    if (nulls_ > 0) {
+      column.validity_ref() = std::move(validity_);
+    }
+    column.values_ref() = std::move(values_);
+    if (isVariable()) {
+      column.offsets_ref() = std::move(offsets_);
+    }
+    return column;
+  }
+
+ private:
+  static size_t fixedWidth(PropertyType type) {
+    switch (type) {
+      case PropertyType::INT8:
+        return 1;
+      case PropertyType::INT16:
+        return 2;
+      case PropertyType::INT32:
+      case PropertyType::FLOAT:
+        return 4;
+      case PropertyType::INT64:
+      case PropertyType::TIMESTAMP:
+      case PropertyType::DOUBLE:
+        return 8;
+      default:
+        // BOOL is in bits, and the others are of variable width
+        return 0;
+    }
+  }
+
+  static PropertyType toPropertyType(Value::Type type) {
+    switch (type) {
+      case Value::Type::BOOL:
+        return PropertyType::BOOL;
+      case Value::Type::INT:
+        return PropertyType::INT64;
+      case Value::Type::FLOAT:
+        return PropertyType::DOUBLE;
+      case Value::Type::STRING:
+        return PropertyType::STRING;
+      case Value::Type::DATE:
+        return PropertyType::DATE;
+      case Value::Type::TIME:
+        return PropertyType::TIME;
+      case Value::Type::DATETIME:
+        return PropertyType::DATETIME;
+      case Value::Type::DURATION:
+        return PropertyType::DURATION;
+      case Value::Type::GEOGRAPHY:
+        return PropertyType::GEOGRAPHY;
+      default:
+        return PropertyType::UNKNOWN;
+    }
+  }
+
+  bool isVariable() const {
+    return width_ == 0 && type_ != PropertyType::BOOL;
+  }
+
+  void setValid(bool valid) {
+    auto bit = rows_ % 8;
+    if (bit == 0) {
+      validity_.push_back('\0');
+      if (type_ == PropertyType::BOOL) {
+        values_.push_back('\0');
+      }
+    }
+    if (valid) {
+      validity_.back() |= static_cast<char>(1 << bit);
+    } else {
+      nulls_++;
+    }
+    rows_++;
+  }
+
+  template <typename T>
+  void appendFixed(T value) {
+    values_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void appendOffset() {
+    auto offset = static_cast<int32_t>(values_.size());
+    offsets_.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+  }
+
+  std::string name_;
+  PropertyType type_;
+  size_t width_;
+  size_t rows_{0};
+  size_t nulls_{0};
+  std::string validity_;
+  std::string values_;
+  std::string offsets_;
+};
+
+}  // namespace nebula
+
+#endif  // COMMON_UTILS_COLUMNARBUILDER_H_
@@ -0,0 +1,91 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_UTILS_COMPACTOPTIONS_H_
+#define COMMON_UTILS_COMPACTOPTIONS_H_
+
+#include <folly/Conv.h>
+#include <folly/String.h>
+
+#include "common/base/StatusOr.h"
+#include "common/utils/Types.h"
+
+namespace nebula {
+
+/**
+ * The options of the ranges to compact in a compact job, e.g. "parts=1,2;data=edge;auto=true".
+ * They are checked by meta when the job is submitted, and parsed again by the compact task of
+ * storaged, so both must agree on them.
+ */
+struct CompactOptions {
+  std::unordered_set<PartitionID> parts;
+  std::vector<NebulaKeyType> keyTypes;
+  bool autoCompact{false};
+
+  bool ranged() const {
+    return !parts.empty() || !keyTypes.empty() || autoCompact;
+  }
+
+  // The key types of each type of data
+  static const std::unordered_map<std::string, std::vector<NebulaKeyType>>& dataKeyTypes() {
+    static const std::unordered_map<std::string, std::vector<NebulaKeyType>> types = {
+        {"tag", {NebulaKeyType::kTag_, NebulaKeyType::kVertex}},
+        {"edge", {NebulaKeyType::kEdge, NebulaKeyType::kDegree}},
+        {"index", {NebulaKeyType::kIndex, NebulaKeyType::kOperation}},
+        {"other", {NebulaKeyType::kKeyValue}}};
+    return types;
+  }
+
+  // The job takes at most one parameter, the options
+  static StatusOr<CompactOptions> parse(const std::vector<std::string>& paras) {
+    if (paras.size() > 1) {
+      return Status::Error("The compact job takes at most one parameter");
+    }
+    CompactOptions result;
+    for (const auto& para : paras) {
+      std::vector<folly::StringPiece> options;
+      folly::split(";", para, options, true);
+      for (auto option : options) {
+        folly::StringPiece name;
+        folly::StringPiece value;
+        if (!folly::split("=", option, name, value)) {
+          return Status::Error("Illegal compact option `%s'", option.str().c_str());
+        }
+        name = folly::trimWhitespace(name);
+        std::vector<folly::StringPiece> values;
+        folly::split(",", value, values, true);
+        if (name == "parts") {
+          for (auto v : values) {
+            auto part = folly::tryTo<PartitionID>(folly::trimWhitespace(v));
+            if (!part.hasValue() || part.value() <= 0) {
+              return Status::Error("Illegal part `%s' to compact", v.str().c_str());
+            }
+            result.parts.emplace(part.value());
+          }
+        } else if (name == "data") {
+          for (auto v : values) {
+            auto iter = dataKeyTypes().find(folly::trimWhitespace(v).str());
+            if (iter == dataKeyTypes().end()) {
+              return Status::Error("Illegal data `%s' to compact", v.str().c_str());
+            }
+            result.keyTypes.insert(result.keyTypes.end(), iter->second.begin(), iter->second.end());
+          }
+        } else if (name == "auto") {
+          auto enabled = folly::tryTo<bool>(folly::trimWhitespace(value));
+          if (!enabled.hasValue()) {
+            return Status::Error("Illegal auto `%s' to compact", value.str().c_str());
+          }
+          result.autoCompact = enabled.value();
+        } else {
+          return Status::Error("Unknown compact option `%s'", name.str().c_str());
+        }
+      }
+    }
+    return result;
+  }
+};
+
+}  // namespace nebula
+#endif  // COMMON_UTILS_COMPACTOPTIONS_H_
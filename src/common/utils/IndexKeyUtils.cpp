@@ -57,17 +57,7 @@ std::vector<std::string> IndexKeyUtils::encodeValues(std::vector<Value>&& values
     const auto& value = values.back();
     if (!value.isNull()) {
       DCHECK(value.type() == Value::Type::GEOGRAPHY);
-      geo::RegionCoverParams rc;
-      const auto* indexParams = indexItem->get_index_params();
-      if (indexParams) {
-        if (indexParams->s2_max_level_ref().has_value()) {
-          rc.maxCellLevel_ = indexParams->s2_max_level_ref().value();
-        }
-        if (indexParams->s2_max_cells_ref().has_value()) {
-          rc.maxCellNum_ = indexParams->s2_max_cells_ref().value();
-        }
-      }
-      indexes = encodeGeography(value.getGeography(), rc);
+      indexes = encodeGeography(value.getGeography(), regionCoverParams(indexItem));
     } else {
       nullableBitSet |= 0x8000;
       auto type = IndexKeyUtils::toValueType(cols.back().type.get_type());
@@ -83,6 +73,24 @@ std::vector<std::string> IndexKeyUtils::encodeValues(std::vector<Value>&& values
   return indexes;
 }
 
+// static
+geo::RegionCoverParams IndexKeyUtils::regionCoverParams(const meta::cpp2::IndexItem* indexItem) {
+  geo::RegionCoverParams rc;
+  const auto* indexParams = indexItem->get_index_params();
+  if (indexParams) {
+    if (indexParams->s2_min_level_ref().has_value()) {
+      rc.minCellLevel_ = indexParams->s2_min_level_ref().value();
+    }
+    if (indexParams->s2_max_level_ref().has_value()) {
+      rc.maxCellLevel_ = indexParams->s2_max_level_ref().value();
+    }
+    if (indexParams->s2_max_cells_ref().has_value()) {
+      rc.maxCellNum_ = indexParams->s2_max_cells_ref().value();
+    }
+  }
+  return rc;
+}
+
 // static
 std::vector<std::string> IndexKeyUtils::vertexIndexKeys(size_t vIdLen,
                                                         PartitionID partId,
@@ -170,6 +178,59 @@ Value IndexKeyUtils::parseIndexTTL(const folly::StringPiece& raw) {
   return value;
 }
 
+// static
+std::string IndexKeyUtils::indexVal(const Value& ttl, List included) {
+  auto val = indexVal(ttl);
+  if (included.empty()) {
+    return val;
+  }
+  std::string cVal;
+  apache::thrift::CompactSerializer::serialize(Value(std::move(included)), &cVal);
+  auto len = cVal.size();
+  val.reserve(val.size() + sizeof(size_t) + len);
+  val.append(reinterpret_cast<const char*>(&len), sizeof(size_t)).append(cVal);
+  return val;
+}
+
+// static
+List IndexKeyUtils::parseIndexIncluded(const folly::StringPiece& raw) {
+  if (raw.size() < sizeof(size_t)) {
+    return List();
+  }
+  // Skip the ttl value
+  auto offset = sizeof(size_t) + *reinterpret_cast<const size_t*>(raw.data());
+  if (raw.size() < offset + sizeof(size_t)) {
+    return List();
+  }
+  Value value;
+  auto len = *reinterpret_cast<const size_t*>(raw.data() + offset);
+  apache::thrift::CompactSerializer::deserialize(raw.subpiece(offset + sizeof(size_t), len),
+                                                 value);
+  if (!value.isList()) {
+    return List();
+  }
+  return value.moveList();
+}
+
+// static
+List IndexKeyUtils::collectIncludedValues(RowReader* reader,
+                                          const meta::cpp2::IndexItem* indexItem,
+                                          const meta::SchemaProviderIf* latestSchema) {
+  List values;
+  if (reader == nullptr || !indexItem->include_fields_ref().has_value()) {
+    return values;
+  }
+  for (const auto& col : *indexItem->include_fields_ref()) {
+    auto val = readValueWithLatestSche(reader, col.get_name(), latestSchema);
+    if (val.ok()) {
+      values.emplace_back(std::move(val).value());
+    } else {
+      values.emplace_back(NullType::__NULL__);
+    }
+  }
+  return values;
+}
+
 // static
 StatusOr<std::vector<std::string>> IndexKeyUtils::collectIndexValues(
     RowReader* reader,
@@ -311,6 +311,10 @@ class IndexKeyUtils final {
     return buf;
   }
 
+  // The covering params of the geography index, which the index keys are built and the index is
+  // queried with
+  static geo::RegionCoverParams regionCoverParams(const meta::cpp2::IndexItem* indexItem);
+
   static std::vector<std::string> encodeGeography(const nebula::Geography& gg,
                                                   const geo::RegionCoverParams& rc) {
     geo::GeoIndex geoIndex(rc);
@@ -494,7 +498,7 @@ class IndexKeyUtils final {
   static EdgeRanking getIndexRank(size_t vIdLen, const folly::StringPiece& rawKey) {
     CHECK_GE(rawKey.size(), kEdgeIndexLen + vIdLen * 2);
     auto offset = rawKey.size() - vIdLen - sizeof(EdgeRanking);
-    return IndexKeyUtils::decodeRank(rawKey.data() + offset);
+    return IndexKeyUtils::decodeRank(rawKey.subpiece(offset, sizeof(EdgeRanking)));
   }
 
   static bool isIndexKey(const folly::StringPiece& key) {
@@ -544,6 +548,26 @@ class IndexKeyUtils final {
 
   static Value parseIndexTTL(const folly::StringPiece& raw);
 
+  /**
+   * @brief Encode the index value of a covering index, which is the ttl value followed by the
+   * values of the columns included in the index. An empty ttl value means no ttl.
+   */
+  static std::string indexVal(const Value& ttl, List included);
+
+  /**
+   * @brief Decode the values of the included columns from the index value, in the order of the
+   * include_fields of the index. It's empty if the index value has no included values.
+   */
+  static List parseIndexIncluded(const folly::StringPiece& raw);
+
+  /**
+   * @brief Read the values of the columns included in the index, the columns unable to read are
+   * set to null
+   */
+  static List collectIncludedValues(RowReader* reader,
+                                    const meta::cpp2::IndexItem* indexItem,
+                                    const meta::SchemaProviderIf* latestSchema = nullptr);
+
   static StatusOr<std::vector<std::string>> collectIndexValues(
       RowReader* reader,
       const meta::cpp2::IndexItem* indexItem,
@@ -0,0 +1,133 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_UTILS_INDEXSTATSUTILS_H_
+#define COMMON_UTILS_INDEXSTATSUTILS_H_
+
+#include "common/algorithm/HyperLogLog.h"
+#include "common/utils/IndexKeyUtils.h"
+#include "interface/gen-cpp2/meta_types.h"
+
+namespace nebula {
+
+/**
+ * This class supply some utils to build and merge the statistics of index, which are used by the
+ * cost based optimizer to estimate the number of rows returned by an index scan.
+ * */
+class IndexStatsUtils final {
+ public:
+  // The max number of bounds of the histogram of the first index field
+  static constexpr size_t kMaxBounds = 64;
+
+  /**
+   * @brief Length of the encoded field in the index key, 0 if the type is unsupported.
+   */
+  static size_t fieldLength(const meta::cpp2::ColumnDef& field) {
+    switch (IndexKeyUtils::toValueType(field.get_type().get_type())) {
+      case Value::Type::BOOL:
+        return sizeof(bool);
+      case Value::Type::INT:
+        return sizeof(int64_t);
+      case Value::Type::FLOAT:
+        return sizeof(double);
+      case Value::Type::STRING: {
+        auto len = field.get_type().type_length_ref();
+        return len.has_value() ? static_cast<size_t>(*len) : 0;
+      }
+      case Value::Type::TIME:
+        return sizeof(int8_t) * 3 + sizeof(int32_t);
+      case Value::Type::DATE:
+        return sizeof(int8_t) * 2 + sizeof(int16_t);
+      case Value::Type::DATETIME:
+        return sizeof(int32_t) + sizeof(int16_t) + sizeof(int8_t) * 5;
+      default:
+        return 0;
+    }
+  }
+
+  /**
+   * @brief Collect the statistics of one index by scanning its keys in order.
+   *
+   * The bounds are sampled every `step_` entries, when there are too many of them, every other
+   * bound is dropped and the step is doubled, so that the bounds are always equi-depth.
+   */
+  class Collector final {
+   public:
+    // The leading field is the encoded first index field, which could be empty if it's unknown
+    void add(folly::StringPiece leading) {
+      if (!leading.empty()) {
+        sketch_.add(leading.data(), leading.size());
+        if (entries_ % step_ == 0) {
+          bounds_.emplace_back(leading.str());
+          if (bounds_.size() >= 2 * kMaxBounds) {
+            for (size_t i = 0; i < kMaxBounds; ++i) {
+              bounds_[i] = std::move(bounds_[i * 2 + 1]);
+            }
+            bounds_.resize(kMaxBounds);
+            step_ *= 2;
+          }
+        }
+      }
+      ++entries_;
+    }
+
+    meta::cpp2::IndexStats finish() {
+      meta::cpp2::IndexStats stats;
+      stats.entries_ref() = entries_;
+      stats.leading_ndv_ref() = static_cast<int64_t>(sketch_.estimate());
+      stats.leading_sketch_ref() = sketch_.toBinary();
+      stats.leading_bounds_ref() = std::move(bounds_);
+      return stats;
+    }
+
+   private:
+    int64_t entries_{0};
+    int64_t step_{1};
+    algorithm::HyperLogLog sketch_;
+    std::vector<std::string> bounds_;
+  };
+
+  /**
+   * @brief Merge the statistics of the same index from different parts or hosts.
+   *
+   * Each bound is assumed to stand for the same number of entries, which holds when data is
+   * evenly distributed among parts.
+   */
+  static void merge(meta::cpp2::IndexStats& lhs, const meta::cpp2::IndexStats& rhs) {
+    *lhs.entries_ref() += *rhs.entries_ref();
+
+    auto sketch = algorithm::HyperLogLog::fromBinary(*lhs.leading_sketch_ref());
+    sketch.merge(algorithm::HyperLogLog::fromBinary(*rhs.leading_sketch_ref()));
+    lhs.leading_ndv_ref() = static_cast<int64_t>(sketch.estimate());
+    lhs.leading_sketch_ref() = sketch.toBinary();
+
+    auto& bounds = *lhs.leading_bounds_ref();
+    bounds.insert(bounds.end(), rhs.get_leading_bounds().begin(), rhs.get_leading_bounds().end());
+    std::sort(bounds.begin(), bounds.end());
+    if (bounds.size() > kMaxBounds) {
+      std::vector<std::string> sampled;
+      sampled.reserve(kMaxBounds);
+      for (size_t i = 0; i < kMaxBounds; ++i) {
+        sampled.emplace_back(std::move(bounds[i * bounds.size() / kMaxBounds]));
+      }
+      bounds = std::move(sampled);
+    }
+  }
+
+  static void merge(std::unordered_map<IndexID, meta::cpp2::IndexStats>& lhs,
+                    const std::unordered_map<IndexID, meta::cpp2::IndexStats>& rhs) {
+    for (const auto& it : rhs) {
+      auto iter = lhs.find(it.first);
+      if (iter == lhs.end()) {
+        lhs.emplace(it.first, it.second);
+      } else {
+        merge(iter->second, it.second);
+      }
+    }
+  }
+};
+
+}  // namespace nebula
+#endif  // COMMON_UTILS_INDEXSTATSUTILS_H_
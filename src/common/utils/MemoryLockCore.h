@@ -6,16 +6,26 @@
 #ifndef COMMON_UTILS_MEMORYLOCKCORE_H
 #define COMMON_UTILS_MEMORYLOCKCORE_H
 
-#include <folly/concurrency/ConcurrentHashMap.h>
+#include <folly/hash/Hash.h>
+
+#include <condition_variable>
 
 #include "common/base/Base.h"
 
 namespace nebula {
 
+/**
+ * @brief The locks of keys in memory, which are split into shards by the hash of keys. The keys of
+ * a batch are grouped by their shards, so each shard is locked once for a batch, and the shards
+ * are visited in ascending order. A batch is locked all or nothing, so the batches never dead lock
+ * each other. The callers could wait a while for the conflict keys to be unlocked instead of
+ * failing at once.
+ */
 template <typename Key>
 class MemoryLockCore {
  public:
-  MemoryLockCore() = default;
+  explicit MemoryLockCore(size_t numShards = kDefaultShards)
+      : shards_(std::max<size_t>(numShards, 1)) {}
 
   ~MemoryLockCore() = default;
 
@@ -28,38 +38,77 @@ class MemoryLockCore {
   }
 
   bool try_lock(const Key& key) {
-    return hashMap_.insert(std::make_pair(key, 0)).second;
+    auto& shard = shards_[shardOf(key)];
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.keys.emplace(key).second;
   }
 
   void unlock(const Key& key) {
-    hashMap_.erase(key);
+    auto& shard = shards_[shardOf(key)];
+    std::lock_guard<std::mutex> guard(shard.lock);
+    shard.keys.erase(key);
+    if (shard.waiters > 0) {
+      shard.cond.notify_all();
+    }
   }
 
   template <class Iter>
   std::pair<Iter, bool> lockBatch(Iter begin, Iter end) {
-    Iter curr = begin;
-    bool inserted = false;
-    while (curr != end) {
-      std::tie(std::ignore, inserted) = hashMap_.insert(std::make_pair(*curr, 0));
-      if (!inserted) {
-        unlockBatch(begin, curr);
-        return std::make_pair(curr, false);
+    auto entries = groupByShard(begin, end);
+    size_t i = 0;
+    while (i < entries.size()) {
+      auto index = entries[i].first;
+      auto& shard = shards_[index];
+      std::unique_lock<std::mutex> guard(shard.lock);
+      for (; i < entries.size() && entries[i].first == index; ++i) {
+        if (!shard.keys.emplace(*entries[i].second).second) {
+          guard.unlock();
+          unlockEntries(entries, i);
+          return std::make_pair(entries[i].second, false);
+        }
       }
-      ++curr;
     }
     return std::make_pair(end, true);
   }
 
+  /**
+   * @brief Same as above, but if some key is locked by others, wait at most the given time for it
+   * to be unlocked and try again
+   */
+  template <class Iter>
+  std::pair<Iter, bool> lockBatch(Iter begin, Iter end, std::chrono::milliseconds wait) {
+    auto deadline = std::chrono::steady_clock::now() + wait;
+    while (true) {
+      auto ret = lockBatch(begin, end);
+      if (ret.second || std::chrono::steady_clock::now() >= deadline) {
+        return ret;
+      }
+      auto& shard = shards_[shardOf(*ret.first)];
+      std::unique_lock<std::mutex> guard(shard.lock);
+      ++shard.waiters;
+      auto unlocked = shard.cond.wait_until(
+          guard, deadline, [&]() { return shard.keys.count(*ret.first) == 0; });
+      --shard.waiters;
+      if (!unlocked) {
+        return ret;
+      }
+    }
+  }
+
   template <class Collection>
   auto lockBatch(Collection&& collection) {
     return lockBatch(collection.begin(), collection.end());
   }
 
+  template <class Collection>
+  auto lockBatch(Collection&& collection, std::chrono::milliseconds wait) {
+    return lockBatch(collection.begin(), collection.end(), wait);
+  }
+
   template <class Iter>
   void unlockBatch(Iter begin, Iter end) {
-    for (; begin != end; ++begin) {
-      hashMap_.erase(*begin);
-    }
+    auto entries = groupByShard(begin, end);
+    unlockEntries(entries, entries.size());
   }
 
   template <class Collection>
@@ -68,19 +117,76 @@ class MemoryLockCore {
   }
 
   void clear() {
-    hashMap_.clear();
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> guard(shard.lock);
+      shard.keys.clear();
+      if (shard.waiters > 0) {
+        shard.cond.notify_all();
+      }
+    }
   }
 
   size_t size() {
-    return hashMap_.size();
+    size_t size = 0;
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> guard(shard.lock);
+      size += shard.keys.size();
+    }
+    return size;
   }
 
   bool contains(const Key& key) {
-    return hashMap_.find(key) == hashMap_.end();
+    auto& shard = shards_[shardOf(key)];
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.keys.count(key) > 0;
   }
 
  protected:
-  folly::ConcurrentHashMap<Key, int> hashMap_;
+  static constexpr size_t kDefaultShards = 64;
+
+  struct Shard {
+    std::mutex lock;
+    std::condition_variable cond;
+    // The number of threads waiting for some key of the shard
+    size_t waiters{0};
+    std::unordered_set<Key> keys;
+  };
+
+  size_t shardOf(const Key& key) const {
+    return std::hash<Key>()(key) % shards_.size();
+  }
+
+  // The keys sorted by their shards, along with the index of their shards
+  template <class Iter>
+  std::vector<std::pair<size_t, Iter>> groupByShard(Iter begin, Iter end) const {
+    std::vector<std::pair<size_t, Iter>> entries;
+    for (auto iter = begin; iter != end; ++iter) {
+      entries.emplace_back(shardOf(*iter), iter);
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first < rhs.first;
+    });
+    return entries;
+  }
+
+  // Unlock the first count keys of the entries, which are sorted by their shards
+  template <class Iter>
+  void unlockEntries(const std::vector<std::pair<size_t, Iter>>& entries, size_t count) {
+    size_t i = 0;
+    while (i < count) {
+      auto index = entries[i].first;
+      auto& shard = shards_[index];
+      std::lock_guard<std::mutex> guard(shard.lock);
+      for (; i < count && entries[i].first == index; ++i) {
+        shard.keys.erase(*entries[i].second);
+      }
+      if (shard.waiters > 0) {
+        shard.cond.notify_all();
+      }
+    }
+  }
+
+  std::vector<Shard> shards_;
 };
 
 }  // namespace nebula
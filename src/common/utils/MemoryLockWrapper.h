@@ -19,17 +19,23 @@ class MemoryLockGuard {
   MemoryLockGuard(MemoryLockCore<Key>* lock, const Key& key)
       : MemoryLockGuard(lock, std::vector<Key>{key}) {}
 
+  // If wait is not zero, wait at most such a while for the keys locked by others
   MemoryLockGuard(MemoryLockCore<Key>* lock,
                   const std::vector<Key>& keys,
                   bool dedup = false,
-                  bool prepCheck = true)
+                  bool prepCheck = true,
+                  std::chrono::milliseconds wait = std::chrono::milliseconds(0))
       : lock_(lock), keys_(keys) {
     if (dedup) {
       std::sort(keys_.begin(), keys_.end());
       keys_.erase(unique(keys_.begin(), keys_.end()), keys_.end());
     }
     if (prepCheck) {
-      std::tie(iter_, locked_) = lock_->lockBatch(keys_);
+      if (wait.count() > 0) {
+        std::tie(iter_, locked_) = lock_->lockBatch(keys_, wait);
+      } else {
+        std::tie(iter_, locked_) = lock_->lockBatch(keys_);
+      }
     } else {
       locked_ = true;
     }
@@ -32,7 +32,9 @@ static const std::unordered_map<std::string, std::pair<std::string, bool>> syste
 
 // SystemInfo will always be backed up
 static const std::unordered_map<std::string, std::pair<std::string, bool>> systemInfoMaps{
-    {"autoIncrementId", {"__id__", true}}, {"lastUpdateTime", {"__last_update_time__", true}}};
+    {"autoIncrementId", {"__id__", true}},
+    {"lastUpdateTime", {"__last_update_time__", true}},
+    {"globalUpdateTime", {"__global_update_time__", true}}};
 
 // name => {prefix, parseSpaceid}, nullptr means that the backup should be skipped.
 static const std::unordered_map<
@@ -56,7 +58,8 @@ static const std::unordered_map<
                  {"ft_index", {"__ft_index__", nullptr}},
                  {"local_id", {"__local_id__", MetaKeyUtils::parseLocalIdSpace}},
                  {"disk_parts", {"__disk_parts__", MetaKeyUtils::parseDiskPartsSpace}},
-                 {"job_manager", {"__job_mgr__", nullptr}}};
+                 {"job_manager", {"__job_mgr__", nullptr}},
+                 {"space_update_time", {"__space_update_time__", nullptr}}};
 
 // clang-format off
 static const std::string kSpacesTable         = tableMaps.at("spaces").first;         // NOLINT
@@ -100,6 +103,7 @@ static const std::string kStatsTable          = tableMaps.at("stats").first;
 static const std::string kBalanceTaskTable    = tableMaps.at("balance_task").first;     // NOLINT
 static const std::string kBalancePlanTable    = tableMaps.at("balance_plan").first;     // NOLINT
 static const std::string kLocalIdTable        = tableMaps.at("local_id").first;         // NOLINT
+static const std::string kSpaceUpdateTimeTable = tableMaps.at("space_update_time").first; // NOLINT
 
 const std::string kFTIndexTable        = tableMaps.at("ft_index").first;         // NOLINT
 const std::string kServicesTable  = systemTableMaps.at("services").first;        // NOLINT
@@ -107,6 +111,7 @@ const std::string kSessionsTable = systemTableMaps.at("sessions").first;
 
 const std::string kIdKey = systemInfoMaps.at("autoIncrementId").first;                // NOLINT
 const std::string kLastUpdateTimeTable = systemInfoMaps.at("lastUpdateTime").first;   // NOLINT
+const std::string kGlobalUpdateTimeTable = systemInfoMaps.at("globalUpdateTime").first; // NOLINT
 
 // clang-format on
 
@@ -137,6 +142,27 @@ std::string MetaKeyUtils::lastUpdateTimeKey() {
   return key;
 }
 
+std::string MetaKeyUtils::globalUpdateTimeKey() {
+  return kGlobalUpdateTimeTable;
+}
+
+std::string MetaKeyUtils::spaceUpdateTimeKey(GraphSpaceID spaceId) {
+  std::string key;
+  key.reserve(kSpaceUpdateTimeTable.size() + sizeof(GraphSpaceID));
+  key.append(kSpaceUpdateTimeTable.data(), kSpaceUpdateTimeTable.size())
+      .append(reinterpret_cast<const char*>(&spaceId), sizeof(GraphSpaceID));
+  return key;
+}
+
+const std::string& MetaKeyUtils::spaceUpdateTimePrefix() {
+  return kSpaceUpdateTimeTable;
+}
+
+GraphSpaceID MetaKeyUtils::parseSpaceUpdateTimeSpace(folly::StringPiece rawData) {
+  auto offset = kSpaceUpdateTimeTable.size();
+  return *reinterpret_cast<const GraphSpaceID*>(rawData.data() + offset);
+}
+
 std::string MetaKeyUtils::lastUpdateTimeVal(const int64_t timeInMilliSec) {
   std::string val;
   val.reserve(sizeof(int64_t));
@@ -72,6 +72,16 @@ class MetaKeyUtils final {
 
   static std::string lastUpdateTimeVal(const int64_t timeInMilliSec);
 
+  // The last update time of the meta data not belonging to any space
+  static std::string globalUpdateTimeKey();
+
+  // The last update time of the schemas, indexes and listeners of the space
+  static std::string spaceUpdateTimeKey(GraphSpaceID spaceId);
+
+  static const std::string& spaceUpdateTimePrefix();
+
+  static GraphSpaceID parseSpaceUpdateTimeSpace(folly::StringPiece rawData);
+
   static std::string spaceKey(GraphSpaceID spaceId);
 
   static std::string spaceVal(const meta::cpp2::SpaceDesc& spaceDesc);
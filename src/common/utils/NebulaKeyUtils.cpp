@@ -258,12 +258,38 @@ std::vector<std::string> NebulaKeyUtils::snapshotPrefix(PartitionID partId) {
     result.emplace_back(edgePrefix(partId));
     result.emplace_back(IndexKeyUtils::indexPrefix(partId));
     result.emplace_back(kvPrefix(partId));
+    result.emplace_back(degreePrefix(partId));
     // kSystem will be written when balance data
     // kOperation will be blocked by jobmanager later
   }
   return result;
 }
 
+// static
+std::string NebulaKeyUtils::degreeKey(size_t vIdLen,
+                                      PartitionID partId,
+                                      const VertexID& vId,
+                                      EdgeType type) {
+  CHECK_GE(vIdLen, vId.size());
+  PartitionID item = (partId << kPartitionOffset) | static_cast<uint32_t>(NebulaKeyType::kDegree);
+  std::string key;
+  key.reserve(kDegreeLen + vIdLen);
+  key.append(reinterpret_cast<const char*>(&item), sizeof(PartitionID))
+      .append(vId.data(), vId.size())
+      .append(vIdLen - vId.size(), '\0')
+      .append(reinterpret_cast<const char*>(&type), sizeof(EdgeType));
+  return key;
+}
+
+// static
+std::string NebulaKeyUtils::degreePrefix(PartitionID partId) {
+  PartitionID item = (partId << kPartitionOffset) | static_cast<uint32_t>(NebulaKeyType::kDegree);
+  std::string key;
+  key.reserve(sizeof(PartitionID));
+  key.append(reinterpret_cast<const char*>(&item), sizeof(PartitionID));
+  return key;
+}
+
 std::string NebulaKeyUtils::systemPrefix() {
   int8_t type = static_cast<uint32_t>(NebulaKeyType::kSystem);
   std::string key;
@@ -112,6 +112,17 @@ class NebulaKeyUtils final {
 
   static std::string systemPrefix();
 
+  /**
+   * Generate the key of the degree of a vertex by an edge type, the in-degree is kept by the
+   * negative edge type in the part of the vertex, as its in-edges are
+   * */
+  static std::string degreeKey(size_t vIdLen,
+                               PartitionID partId,
+                               const VertexID& vId,
+                               EdgeType type);
+
+  static std::string degreePrefix(PartitionID partId);
+
   static std::vector<std::string> snapshotPrefix(PartitionID partId);
 
   static PartitionID getPart(const folly::StringPiece& rawKey) {
@@ -155,6 +166,15 @@ class NebulaKeyUtils final {
     return static_cast<NebulaKeyType>(type) == NebulaKeyType::kEdge;
   }
 
+  static bool isDegree(size_t vIdLen, const folly::StringPiece& rawKey) {
+    if (rawKey.size() != kDegreeLen + vIdLen) {
+      return false;
+    }
+    constexpr int32_t len = static_cast<int32_t>(sizeof(NebulaKeyType));
+    auto type = readInt<uint32_t>(rawKey.data(), len) & kTypeMask;
+    return static_cast<NebulaKeyType>(type) == NebulaKeyType::kDegree;
+  }
+
   static bool isLock(size_t vIdLen, const folly::StringPiece& rawKey) {
     return isEdge(vIdLen, rawKey, kLockVersion);
   }
@@ -233,7 +253,7 @@ class NebulaKeyUtils final {
       dumpBadKey(rawKey, kEdgeLen + (vIdLen << 1), vIdLen);
     }
     auto offset = sizeof(PartitionID) + vIdLen + sizeof(EdgeType);
-    return NebulaKeyUtils::decodeRank(rawKey.data() + offset);
+    return NebulaKeyUtils::decodeRank(rawKey.subpiece(offset, sizeof(EdgeRanking)));
   }
 
   static std::string encodeRank(EdgeRanking rank) {
@@ -309,5 +329,77 @@ class NebulaKeyUtils final {
   static constexpr char kEdgeVersion = 1;
 };
 
+/**
+ * The views of the tag and the edge keys. The offsets of the fields are fixed by the vid length,
+ * so the size of the key is checked once when the view is made, instead of by each getter of
+ * NebulaKeyUtils, which matters when several fields of a key are read, e.g. the props in the key
+ * of an edge. Like the getters, reading a field of a key of a wrong size is fatal.
+ * */
+class TagKeyView final {
+ public:
+  TagKeyView(size_t vIdLen, folly::StringPiece rawKey)
+      : vIdLen_(vIdLen), rawKey_(rawKey), valid_(rawKey.size() == kTagLen + vIdLen) {}
+
+  VertexIDSlice vertexId() const {
+    check();
+    return rawKey_.subpiece(sizeof(PartitionID), vIdLen_);
+  }
+
+  TagID tagId() const {
+    check();
+    return readInt<TagID>(rawKey_.data() + sizeof(PartitionID) + vIdLen_, sizeof(TagID));
+  }
+
+ private:
+  void check() const {
+    if (UNLIKELY(!valid_)) {
+      NebulaKeyUtils::dumpBadKey(rawKey_, kTagLen + vIdLen_, vIdLen_);
+    }
+  }
+
+  size_t vIdLen_;
+  folly::StringPiece rawKey_;
+  bool valid_;
+};
+
+class EdgeKeyView final {
+ public:
+  EdgeKeyView(size_t vIdLen, folly::StringPiece rawKey)
+      : vIdLen_(vIdLen), rawKey_(rawKey), valid_(rawKey.size() >= kEdgeLen + (vIdLen << 1)) {}
+
+  VertexIDSlice srcId() const {
+    check();
+    return rawKey_.subpiece(sizeof(PartitionID), vIdLen_);
+  }
+
+  EdgeType edgeType() const {
+    check();
+    return readInt<EdgeType>(rawKey_.data() + sizeof(PartitionID) + vIdLen_, sizeof(EdgeType));
+  }
+
+  EdgeRanking rank() const {
+    check();
+    auto offset = sizeof(PartitionID) + vIdLen_ + sizeof(EdgeType);
+    return NebulaKeyUtils::decodeRank(rawKey_.subpiece(offset, sizeof(EdgeRanking)));
+  }
+
+  VertexIDSlice dstId() const {
+    check();
+    auto offset = sizeof(PartitionID) + vIdLen_ + sizeof(EdgeType) + sizeof(EdgeRanking);
+    return rawKey_.subpiece(offset, vIdLen_);
+  }
+
+ private:
+  void check() const {
+    if (UNLIKELY(!valid_)) {
+      NebulaKeyUtils::dumpBadKey(rawKey_, kEdgeLen + (vIdLen_ << 1), vIdLen_);
+    }
+  }
+
+  size_t vIdLen_;
+  folly::StringPiece rawKey_;
+  bool valid_;
+};
+
 }  // namespace nebula
 #endif  // COMMON_UTILS_NEBULAKEYUTILS_H_
@@ -9,37 +9,78 @@
 
 namespace nebula {
 
+namespace {
+
+// The operations of one write are replayed in the order of their timestamps, so they are strictly
+// increasing, e.g. the delete of an index key is replayed before the put of it again
+int64_t nextOperationTs() {
+  static std::atomic<int64_t> last{0};
+  auto now = time::WallClock::fastNowInMicroSec();
+  auto prev = last.load(std::memory_order_relaxed);
+  int64_t ts;
+  do {
+    ts = std::max(now, prev + 1);
+  } while (!last.compare_exchange_weak(prev, ts, std::memory_order_relaxed));
+  return ts;
+}
+
+}  // namespace
+
 // static
 std::string OperationKeyUtils::modifyOperationKey(PartitionID part, const std::string& key) {
+  return operationKey(part, NebulaOperationType::kModify, key);
+}
+
+// static
+std::string OperationKeyUtils::deleteOperationKey(PartitionID part, const std::string& key) {
+  return operationKey(part, NebulaOperationType::kDelete, key);
+}
+
+// static
+std::string OperationKeyUtils::operationKey(PartitionID part,
+                                            NebulaOperationType type,
+                                            const std::string& key) {
   uint32_t item = (part << kPartitionOffset) | static_cast<uint32_t>(NebulaKeyType::kOperation);
-  int64_t ts = folly::Endian::big(time::WallClock::fastNowInMicroSec());
-  uint32_t type = static_cast<uint32_t>(NebulaOperationType::kModify);
-  int32_t keySize = key.size();
+  // The position in the raft log is unknown until the operation is committed
+  int64_t term = 0;
+  int64_t logId = 0;
+  int64_t ts = folly::Endian::big(nextOperationTs());
+  uint32_t opType = static_cast<uint32_t>(type);
   std::string result;
-  result.reserve(sizeof(int32_t) + sizeof(int64_t) + sizeof(NebulaOperationType) + keySize);
+  result.reserve(kOperationKeyOffset + key.size());
   result.append(reinterpret_cast<const char*>(&item), sizeof(PartitionID))
+      .append(reinterpret_cast<const char*>(&term), sizeof(int64_t))
+      .append(reinterpret_cast<const char*>(&logId), sizeof(int64_t))
       .append(reinterpret_cast<const char*>(&ts), sizeof(int64_t))
-      .append(reinterpret_cast<const char*>(&type), sizeof(NebulaOperationType))
+      .append(reinterpret_cast<const char*>(&opType), sizeof(NebulaOperationType))
       .append(key);
   return result;
 }
 
 // static
-std::string OperationKeyUtils::deleteOperationKey(PartitionID part) {
+bool OperationKeyUtils::isOperation(PartitionID part, const folly::StringPiece& rawKey) {
+  if (rawKey.size() < kOperationKeyOffset) {
+    return false;
+  }
   uint32_t item = (part << kPartitionOffset) | static_cast<uint32_t>(NebulaKeyType::kOperation);
-  int64_t ts = folly::Endian::big(time::WallClock::fastNowInMicroSec());
-  uint32_t type = static_cast<uint32_t>(NebulaOperationType::kDelete);
-  std::string result;
-  result.reserve(sizeof(int32_t) + sizeof(int64_t) + sizeof(NebulaOperationType));
-  result.append(reinterpret_cast<const char*>(&item), sizeof(PartitionID))
-      .append(reinterpret_cast<const char*>(&ts), sizeof(int64_t))
-      .append(reinterpret_cast<const char*>(&type), sizeof(NebulaOperationType));
+  return readInt<uint32_t>(rawKey.data(), sizeof(PartitionID)) == item;
+}
+
+// static
+std::string OperationKeyUtils::setLogPosition(const folly::StringPiece& rawKey,
+                                              int64_t term,
+                                              int64_t logId) {
+  std::string result = rawKey.str();
+  int64_t bigTerm = folly::Endian::big(term);
+  int64_t bigLogId = folly::Endian::big(logId);
+  memcpy(&result[sizeof(PartitionID)], &bigTerm, sizeof(int64_t));
+  memcpy(&result[sizeof(PartitionID) + sizeof(int64_t)], &bigLogId, sizeof(int64_t));
   return result;
 }
 
 // static
 bool OperationKeyUtils::isModifyOperation(const folly::StringPiece& rawKey) {
-  auto position = rawKey.data() + sizeof(PartitionID) + sizeof(int64_t);
+  auto position = rawKey.data() + kOperationTypeOffset;
   auto len = sizeof(NebulaOperationType);
   auto type = readInt<uint32_t>(position, len);
   return static_cast<uint32_t>(NebulaOperationType::kModify) == type;
@@ -47,7 +88,7 @@ bool OperationKeyUtils::isModifyOperation(const folly::StringPiece& rawKey) {
 
 // static
 bool OperationKeyUtils::isDeleteOperation(const folly::StringPiece& rawKey) {
-  auto position = rawKey.data() + sizeof(PartitionID) + sizeof(int64_t);
+  auto position = rawKey.data() + kOperationTypeOffset;
   auto len = sizeof(NebulaOperationType);
   auto type = readInt<uint32_t>(position, len);
   return static_cast<uint32_t>(NebulaOperationType::kDelete) == type;
@@ -55,8 +96,13 @@ bool OperationKeyUtils::isDeleteOperation(const folly::StringPiece& rawKey) {
 
 // static
 std::string OperationKeyUtils::getOperationKey(const folly::StringPiece& rawValue) {
-  auto offset = sizeof(int32_t) + sizeof(int64_t) + sizeof(NebulaOperationType);
-  return rawValue.subpiece(offset).toString();
+  return rawValue.subpiece(kOperationKeyOffset).toString();
+}
+
+// static
+int64_t OperationKeyUtils::getOperationTime(const folly::StringPiece& rawKey) {
+  auto position = rawKey.data() + kOperationTypeOffset - sizeof(int64_t);
+  return folly::Endian::big(readInt<int64_t>(position, sizeof(int64_t)));
 }
 
 // static
@@ -12,7 +12,15 @@ namespace nebula {
 
 /**
  * The OperationKeyUtils is use to generate the operation key when rebuilding
- * index.
+ * index, or when the index is maintained asynchronously.
+ *
+ * Operation key format:
+ * type(1) + partId(3) + term(8) + logId(8) + timestamp(8) + operation type(4) + key
+ *
+ * The operations are replayed in the order of their keys. The term and log id of the raft log which
+ * writes the operation are filled in by the part when the log is committed, so the operations of
+ * different writes are ordered as they are committed, regardless of the clocks of the leaders. The
+ * timestamp orders the operations of one write.
  * */
 class OperationKeyUtils final {
  public:
@@ -20,7 +28,15 @@ class OperationKeyUtils final {
 
   static std::string modifyOperationKey(PartitionID part, const std::string& key);
 
-  static std::string deleteOperationKey(PartitionID part);
+  // The key deleted is the value of the operation, it is a part of the operation key as well so
+  // that the deletes of the same time are not overwritten
+  static std::string deleteOperationKey(PartitionID part, const std::string& key);
+
+  // Whether the key written in the part is an operation key
+  static bool isOperation(PartitionID part, const folly::StringPiece& rawKey);
+
+  // Fill in the position of the raft log which writes the operation
+  static std::string setLogPosition(const folly::StringPiece& rawKey, int64_t term, int64_t logId);
 
   static bool isModifyOperation(const folly::StringPiece& rawKey);
 
@@ -28,10 +44,21 @@ class OperationKeyUtils final {
 
   static std::string getOperationKey(const folly::StringPiece& rawValue);
 
+  // The time in microseconds when the operation is written
+  static int64_t getOperationTime(const folly::StringPiece& rawKey);
+
   static std::string operationPrefix(PartitionID part);
 
  private:
   OperationKeyUtils() = delete;
+
+  static std::string operationKey(PartitionID part,
+                                  NebulaOperationType type,
+                                  const std::string& key);
+
+  static constexpr size_t kOperationTypeOffset = sizeof(PartitionID) + 3 * sizeof(int64_t);
+  static constexpr size_t kOperationKeyOffset =
+      kOperationTypeOffset + sizeof(NebulaOperationType);
 };
 
 }  // namespace nebula
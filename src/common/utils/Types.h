@@ -21,6 +21,7 @@ enum class NebulaKeyType : uint32_t {
   kVertex = 0x00000007,
   kPrime = 0x00000008,        // used in TOSS, if we write a lock succeed
   kDoublePrime = 0x00000009,  // used in TOSS, if we get RPC back from remote.
+  kDegree = 0x0000000A,       // the number of edges of a vertex by edge type
 };
 
 enum class NebulaSystemKeyType : uint32_t {
@@ -51,6 +52,9 @@ static constexpr int32_t kTagLen = sizeof(PartitionID) + sizeof(TagID);
 static constexpr int32_t kEdgeLen =
     sizeof(PartitionID) + sizeof(EdgeType) + sizeof(EdgeRanking) + sizeof(EdgeVerPlaceHolder);
 
+// size of degree key except vertexId
+static constexpr int32_t kDegreeLen = sizeof(PartitionID) + sizeof(EdgeType);
+
 static constexpr int32_t kSystemLen = sizeof(PartitionID) + sizeof(NebulaSystemKeyType);
 
 // The partition id offset in 4 Bytes
@@ -0,0 +1,53 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "common/utils/BloomFilter.h"
+
+namespace nebula {
+
+TEST(BloomFilter, NoFalseNegative) {
+  auto filter = BloomFilter::withKeys(1000);
+  for (int64_t i = 0; i < 1000; i++) {
+    filter.add(folly::to<std::string>("vid_", i));
+  }
+  for (int64_t i = 0; i < 1000; i++) {
+    EXPECT_TRUE(filter.mayContain(folly::to<std::string>("vid_", i)));
+  }
+  size_t falsePositives = 0;
+  for (int64_t i = 1000; i < 11000; i++) {
+    if (filter.mayContain(folly::to<std::string>("vid_", i))) {
+      falsePositives++;
+    }
+  }
+  // About 1% by 10 bits per key
+  EXPECT_LT(falsePositives, 300);
+}
+
+TEST(BloomFilter, Serialized) {
+  auto filter = BloomFilter::withKeys(2);
+  int64_t intVid = 42;
+  filter.add(folly::StringPiece(reinterpret_cast<const char*>(&intVid), sizeof(intVid)));
+  filter.add("Tim Duncan");
+  // Rebuilt from the bits sent along with the request
+  BloomFilter received(filter.bits(), filter.numHashes());
+  EXPECT_TRUE(
+      received.mayContain(folly::StringPiece(reinterpret_cast<const char*>(&intVid), 8)));
+  EXPECT_TRUE(received.mayContain("Tim Duncan"));
+  EXPECT_FALSE(received.mayContain("Tony Parker"));
+}
+
+TEST(BloomFilter, Empty) {
+  // A filter without bits matches all
+  BloomFilter filter("", 0);
+  EXPECT_TRUE(filter.mayContain("Tim Duncan"));
+  // A filter of no key matches none
+  auto none = BloomFilter::withKeys(0);
+  EXPECT_FALSE(none.mayContain("Tim Duncan"));
+}
+
+}  // namespace nebula
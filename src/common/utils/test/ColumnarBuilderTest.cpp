@@ -0,0 +1,87 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "common/utils/ColumnarBuilder.h"
+
+namespace nebula {
+
+using PropertyType = nebula::cpp2::PropertyType;
+
+TEST(ColumnarBuilder, FixedWidth) {
+  ColumnarBuilder builder("age", PropertyType::INT32);
+  builder.append(Value(1));
+  builder.append(Value::kNullValue);
+  builder.append(Value("not an int"));
+  builder.append(Value(4));
+  auto column = builder.finish();
+  EXPECT_EQ("age", column.get_name());
+  EXPECT_EQ(PropertyType::INT32, column.get_type());
+  ASSERT_EQ(4 * sizeof(int32_t), column.get_values().size());
+  const auto* values = reinterpret_cast<const int32_t*>(column.get_values().data());
+  EXPECT_EQ(1, values[0]);
+  EXPECT_EQ(4, values[3]);
+  ASSERT_EQ(1, column.get_validity().size());
+  EXPECT_EQ(0b1001, column.get_validity()[0]);
+  EXPECT_FALSE(column.offsets_ref().has_value());
+}
+
+TEST(ColumnarBuilder, Bool) {
+  ColumnarBuilder builder("playing", PropertyType::BOOL);
+  for (size_t i = 0; i < 10; i++) {
+    builder.append(Value(i % 3 == 0));
+  }
+  auto column = builder.finish();
+  // No null
+  EXPECT_TRUE(column.get_validity().empty());
+  ASSERT_EQ(2, column.get_values().size());
+  EXPECT_EQ(0b01001001, static_cast<uint8_t>(column.get_values()[0]));
+  EXPECT_EQ(0b10, static_cast<uint8_t>(column.get_values()[1]));
+}
+
+TEST(ColumnarBuilder, VariableWidth) {
+  ColumnarBuilder builder("name", PropertyType::STRING);
+  builder.append(Value("Tim"));
+  builder.append(Value());
+  builder.append(Value("Tony"));
+  auto column = builder.finish();
+  EXPECT_EQ("TimTony", column.get_values());
+  ASSERT_TRUE(column.offsets_ref().has_value());
+  ASSERT_EQ(4 * sizeof(int32_t), column.offsets_ref()->size());
+  const auto* offsets = reinterpret_cast<const int32_t*>(column.offsets_ref()->data());
+  EXPECT_EQ(0, offsets[0]);
+  EXPECT_EQ(3, offsets[1]);
+  EXPECT_EQ(3, offsets[2]);
+  EXPECT_EQ(7, offsets[3]);
+  EXPECT_EQ(0b101, column.get_validity()[0]);
+}
+
+TEST(ColumnarBuilder, FromDataSet) {
+  DataSet data({"name", "score", "mixed", "list"});
+  data.emplace_back(Row({"Tim", 1.5, 1, List({1, 2})}));
+  data.emplace_back(Row({"Tony", Value::kNullValue, "one", List()}));
+
+  auto name = ColumnarBuilder::fromDataSet(data, 0);
+  EXPECT_EQ(PropertyType::STRING, name.get_type());
+  EXPECT_EQ("TimTony", name.get_values());
+
+  auto score = ColumnarBuilder::fromDataSet(data, 1);
+  EXPECT_EQ(PropertyType::DOUBLE, score.get_type());
+  ASSERT_EQ(2 * sizeof(double), score.get_values().size());
+  EXPECT_EQ(1.5, *reinterpret_cast<const double*>(score.get_values().data()));
+  EXPECT_EQ(0b1, score.get_validity()[0]);
+
+  for (size_t col = 2; col < 4; col++) {
+    auto boxed = ColumnarBuilder::fromDataSet(data, col);
+    EXPECT_EQ(PropertyType::UNKNOWN, boxed.get_type());
+    ASSERT_TRUE(boxed.boxed_ref().has_value());
+    ASSERT_EQ(2, boxed.boxed_ref()->size());
+    EXPECT_EQ(data.rows[1].values[col], (*boxed.boxed_ref())[1]);
+  }
+}
+
+}  // namespace nebula
@@ -0,0 +1,51 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/utils/CompactOptions.h"
+
+namespace nebula {
+
+TEST(CompactOptionsTest, Parse) {
+  {
+    auto options = CompactOptions::parse({});
+    ASSERT_TRUE(options.ok()) << options.status();
+    EXPECT_FALSE(options.value().ranged());
+  }
+  {
+    auto options = CompactOptions::parse({"parts=1, 2;data=edge,index; auto = true"});
+    ASSERT_TRUE(options.ok()) << options.status();
+    const auto& value = options.value();
+    EXPECT_TRUE(value.ranged());
+    EXPECT_EQ((std::unordered_set<PartitionID>{1, 2}), value.parts);
+    EXPECT_EQ((std::vector<NebulaKeyType>{NebulaKeyType::kEdge,
+                                          NebulaKeyType::kDegree,
+                                          NebulaKeyType::kIndex,
+                                          NebulaKeyType::kOperation}),
+              value.keyTypes);
+    EXPECT_TRUE(value.autoCompact);
+  }
+  {
+    auto options = CompactOptions::parse({"auto=true"});
+    ASSERT_TRUE(options.ok()) << options.status();
+    EXPECT_TRUE(options.value().ranged());
+    EXPECT_TRUE(options.value().parts.empty());
+    EXPECT_TRUE(options.value().keyTypes.empty());
+  }
+}
+
+TEST(CompactOptionsTest, Illegal) {
+  // More than one parameter
+  EXPECT_FALSE(CompactOptions::parse({"parts=1", "data=tag"}).ok());
+  EXPECT_FALSE(CompactOptions::parse({"parts"}).ok());
+  EXPECT_FALSE(CompactOptions::parse({"parts=a"}).ok());
+  EXPECT_FALSE(CompactOptions::parse({"parts=0"}).ok());
+  EXPECT_FALSE(CompactOptions::parse({"data=vertex"}).ok());
+  EXPECT_FALSE(CompactOptions::parse({"auto=maybe"}).ok());
+  EXPECT_FALSE(CompactOptions::parse({"level=1"}).ok());
+}
+
+}  // namespace nebula
@@ -597,6 +597,30 @@ TEST(IndexKeyUtilsTest, getValueFromIndexKeyTest) {
   }
 }
 
+TEST(IndexKeyUtilsTest, includedValues) {
+  {
+    // The index value only has the ttl
+    auto val = IndexKeyUtils::indexVal(Value(1000L));
+    EXPECT_EQ(Value(1000L), IndexKeyUtils::parseIndexTTL(val));
+    EXPECT_TRUE(IndexKeyUtils::parseIndexIncluded(val).empty());
+    EXPECT_EQ(val, IndexKeyUtils::indexVal(Value(1000L), List()));
+  }
+  {
+    List included({Value("Tom"), Value(NullType::__NULL__), Value(3.14)});
+    auto val = IndexKeyUtils::indexVal(Value(1000L), included);
+    EXPECT_EQ(Value(1000L), IndexKeyUtils::parseIndexTTL(val));
+    EXPECT_EQ(included, IndexKeyUtils::parseIndexIncluded(val));
+  }
+  {
+    // No ttl
+    List included({Value(10L)});
+    auto val = IndexKeyUtils::indexVal(Value(), included);
+    EXPECT_TRUE(IndexKeyUtils::parseIndexTTL(val).empty());
+    EXPECT_EQ(included, IndexKeyUtils::parseIndexIncluded(val));
+  }
+  EXPECT_TRUE(IndexKeyUtils::parseIndexIncluded("").empty());
+}
+
 }  // namespace nebula
 
 int main(int argc, char** argv) {
@@ -28,6 +28,9 @@ class KeyUtilsTestBase : public ::testing::Test {
     ASSERT_EQ(partId, NebulaKeyUtils::getPart(tagKey));
     ASSERT_EQ(tagId, NebulaKeyUtils::getTagId(vIdLen_, tagKey));
     ASSERT_EQ(vId, NebulaKeyUtils::getVertexId(vIdLen_, tagKey).subpiece(0, actualSize));
+    TagKeyView view(vIdLen_, tagKey);
+    ASSERT_EQ(tagId, view.tagId());
+    ASSERT_EQ(vId, view.vertexId().subpiece(0, actualSize));
   }
 
   void verifyEdge(PartitionID partId,
@@ -53,6 +56,24 @@ class KeyUtilsTestBase : public ::testing::Test {
     ASSERT_EQ(dstId, NebulaKeyUtils::getDstId(vIdLen_, edgeKey).subpiece(0, actualSize));
     ASSERT_EQ(type, NebulaKeyUtils::getEdgeType(vIdLen_, edgeKey));
     ASSERT_EQ(rank, NebulaKeyUtils::getRank(vIdLen_, edgeKey));
+    EdgeKeyView view(vIdLen_, edgeKey);
+    ASSERT_EQ(srcId, view.srcId().subpiece(0, actualSize));
+    ASSERT_EQ(dstId, view.dstId().subpiece(0, actualSize));
+    ASSERT_EQ(type, view.edgeType());
+    ASSERT_EQ(rank, view.rank());
+  }
+
+  void verifyDegree(PartitionID partId, VertexID vId, EdgeType type) {
+    auto degreeKey = NebulaKeyUtils::degreeKey(vIdLen_, partId, vId, type);
+    ASSERT_EQ(degreeKey.size(), kDegreeLen + vIdLen_);
+    ASSERT_EQ(degreeKey.substr(0, sizeof(PartitionID)), NebulaKeyUtils::degreePrefix(partId));
+    ASSERT_TRUE(NebulaKeyUtils::isDegree(vIdLen_, degreeKey));
+    ASSERT_FALSE(NebulaKeyUtils::isTag(vIdLen_, degreeKey));
+    ASSERT_EQ(partId, NebulaKeyUtils::getPart(degreeKey));
+    auto tagKey = NebulaKeyUtils::tagKey(vIdLen_, partId, vId, type);
+    ASSERT_FALSE(NebulaKeyUtils::isDegree(vIdLen_, tagKey));
+    // The same layout as the tag key except the key type
+    ASSERT_EQ(degreeKey.substr(sizeof(PartitionID)), tagKey.substr(sizeof(PartitionID)));
   }
 
  protected:
@@ -133,6 +154,13 @@ TEST_F(V2ShortTest, NegativeEdgeTypeTest) {
   verifyEdge(partId, srcId, type, rank, dstId, edgeVersion, 10);
 }
 
+TEST_F(V2ShortTest, DegreeTest) {
+  PartitionID partId = 123;
+  verifyDegree(partId, "0123456789", 1010);
+  verifyDegree(partId, "0123456789", -1010);
+  verifyDegree(partId, "01234", 1010);
+}
+
 TEST_F(V2LongTest, SimpleTest) {
   PartitionID partId = 123;
   VertexID vId = "0123456789";
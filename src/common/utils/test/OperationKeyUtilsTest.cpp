@@ -18,8 +18,51 @@ TEST(OperationKeyUtilsTest, ModifyKeyTest) {
 
 TEST(OperationKeyUtilsTest, DeleteKeyTest) {
   PartitionID part = 1;
-  auto opKey = OperationKeyUtils::deleteOperationKey(part);
+  auto opKey = OperationKeyUtils::deleteOperationKey(part, "delete key");
   ASSERT_TRUE(OperationKeyUtils::isDeleteOperation(opKey));
+  ASSERT_EQ(OperationKeyUtils::getOperationKey(opKey), "delete key");
+}
+
+TEST(OperationKeyUtilsTest, OrderTest) {
+  PartitionID part = 1;
+  std::vector<std::string> opKeys;
+  for (int i = 0; i < 100; i++) {
+    opKeys.emplace_back(OperationKeyUtils::deleteOperationKey(part, "key"));
+    opKeys.emplace_back(OperationKeyUtils::modifyOperationKey(part, "key"));
+  }
+  // The operations are replayed in the order they are written
+  ASSERT_TRUE(std::is_sorted(opKeys.begin(), opKeys.end()));
+  ASSERT_EQ(opKeys.size(), std::set<std::string>(opKeys.begin(), opKeys.end()).size());
+  for (size_t i = 1; i < opKeys.size(); i++) {
+    ASSERT_LT(OperationKeyUtils::getOperationTime(opKeys[i - 1]),
+              OperationKeyUtils::getOperationTime(opKeys[i]));
+  }
+}
+
+TEST(OperationKeyUtilsTest, LogPositionTest) {
+  PartitionID part = 1;
+  auto modifyKey = OperationKeyUtils::modifyOperationKey(part, "modify key");
+  auto deleteKey = OperationKeyUtils::deleteOperationKey(part, "delete key");
+  ASSERT_TRUE(OperationKeyUtils::isOperation(part, modifyKey));
+  ASSERT_FALSE(OperationKeyUtils::isOperation(part + 1, modifyKey));
+  ASSERT_FALSE(OperationKeyUtils::isOperation(part, "modify key"));
+
+  // The operation written later in a former raft log is replayed first
+  auto laterDelete = OperationKeyUtils::setLogPosition(deleteKey, 1, 10);
+  auto earlierModify = OperationKeyUtils::setLogPosition(modifyKey, 1, 11);
+  ASSERT_LT(laterDelete, earlierModify);
+  // So is one in the log of a former term
+  ASSERT_LT(OperationKeyUtils::setLogPosition(deleteKey, 1, 12),
+            OperationKeyUtils::setLogPosition(modifyKey, 2, 11));
+  // The operations of one raft log are in the order they are written
+  ASSERT_LT(OperationKeyUtils::setLogPosition(modifyKey, 1, 10), laterDelete);
+
+  ASSERT_TRUE(OperationKeyUtils::isModifyOperation(earlierModify));
+  ASSERT_EQ("modify key", OperationKeyUtils::getOperationKey(earlierModify));
+  ASSERT_TRUE(OperationKeyUtils::isDeleteOperation(laterDelete));
+  ASSERT_EQ("delete key", OperationKeyUtils::getOperationKey(laterDelete));
+  ASSERT_EQ(OperationKeyUtils::getOperationTime(deleteKey),
+            OperationKeyUtils::getOperationTime(laterDelete));
 }
 
 }  // namespace nebula
@@ -16,11 +16,15 @@
 #include "common/ssl/SSLConfig.h"
 #include "common/time/TimezoneInfo.h"
 #include "daemons/SetupLogging.h"
+#include "daemons/SetupMemoryArenas.h"
+#include "daemons/SetupTracing.h"
 #include "graph/service/GraphFlags.h"
+#include "graph/service/GraphHttpQueriesHandler.h"
 #include "graph/service/GraphServer.h"
 #include "graph/service/GraphService.h"
 #include "graph/stats/GraphStats.h"
 #include "version/Version.h"
+#include "webservice/Router.h"
 #include "webservice/WebService.h"
 
 using nebula::ProcessUtils;
@@ -104,6 +108,20 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  // Setup tracing, whose exporter thread must be started after daemonizing
+  status = setupTracing(argv[0]);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+    return EXIT_FAILURE;
+  }
+
+  // Setup the memory arenas, before the thread pools bound to them are started
+  status = setupMemoryArenas();
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+    return EXIT_FAILURE;
+  }
+
   // Validate the IPv4 address or hostname
   status = NetworkUtils::validateHostOrIp(FLAGS_local_ip);
   if (!status.ok()) {
@@ -119,8 +137,13 @@ int main(int argc, char *argv[]) {
     return EXIT_FAILURE;
   }
 
+  auto graphServer = std::make_unique<nebula::graph::GraphServer>(localhost);
+
   LOG(INFO) << "Starting Graph HTTP Service";
   auto webSvc = std::make_unique<nebula::WebService>();
+  webSvc->router().get("/queries").handler([server = graphServer.get()](nebula::web::PathParams&&) {
+    return new nebula::graph::GraphHttpQueriesHandler(server);
+  });
   status = webSvc->start();
   if (!status.ok()) {
     return EXIT_FAILURE;
@@ -144,7 +167,6 @@ int main(int argc, char *argv[]) {
   }
   LOG(INFO) << "Number of worker threads: " << FLAGS_num_worker_threads;
 
-  auto graphServer = std::make_unique<nebula::graph::GraphServer>(localhost);
   // Setup the signal handlers
   status = setupSignalHandler(graphServer.get());
   if (!status.ok()) {
@@ -19,6 +19,7 @@
 #include "common/time/TimezoneInfo.h"
 #include "common/utils/MetaKeyUtils.h"
 #include "daemons/SetupLogging.h"
+#include "daemons/SetupTracing.h"
 #include "kvstore/NebulaStore.h"
 #include "kvstore/PartManager.h"
 #include "meta/ActiveHostsMan.h"
@@ -122,6 +123,13 @@ int main(int argc, char* argv[]) {
     }
   }
 
+  // Setup tracing, whose exporter thread must be started after daemonizing
+  status = setupTracing(argv[0]);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+    return EXIT_FAILURE;
+  }
+
   std::string hostName;
   if (FLAGS_local_ip.empty()) {
     hostName = nebula::network::NetworkUtils::getHostname();
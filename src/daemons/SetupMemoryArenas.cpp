@@ -0,0 +1,46 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "daemons/SetupMemoryArenas.h"
+
+#include "common/base/Base.h"
+#include "common/stats/StatsManager.h"
+#include "common/thread/MemoryArenas.h"
+
+DECLARE_string(memory_arenas);
+
+using nebula::Status;
+using nebula::stats::StatsManager;
+using nebula::thread::MemoryArenas;
+
+namespace {
+
+void collectGauges(std::vector<StatsManager::Gauge>& gauges) {
+  for (const auto& stats : MemoryArenas::stats()) {
+    std::vector<std::pair<std::string, std::string>> labels = {{"subsystem", stats.subsystem}};
+    auto add = [&](const char* name, int64_t value) {
+      gauges.emplace_back(StatsManager::Gauge{name, labels, static_cast<double>(value)});
+    };
+    add("memory_arena_allocated_bytes", stats.allocated);
+    add("memory_arena_active_bytes", stats.active);
+    add("memory_arena_dirty_bytes", stats.dirty);
+    add("memory_arena_resident_bytes", stats.resident);
+    add("memory_arena_mapped_bytes", stats.mapped);
+    add("memory_arena_retained_bytes", stats.retained);
+  }
+}
+
+}  // namespace
+
+Status setupMemoryArenas() {
+  auto status = MemoryArenas::init();
+  if (!status.ok()) {
+    return status;
+  }
+  if (!FLAGS_memory_arenas.empty()) {
+    StatsManager::registerGauges("memory_arenas", collectGauges);
+  }
+  return Status::OK();
+}
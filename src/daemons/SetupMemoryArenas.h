@@ -0,0 +1,17 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef SETUPMEMORYARENAS_H
+#define SETUPMEMORYARENAS_H
+
+#include "common/base/Status.h"
+/**
+ * \return wether successfully setupMemoryArenas.
+ *
+ * Create the jemalloc arenas of --memory_arenas, and export their stats as the gauges. It must be
+ * called before the thread pools bound to the arenas are started.
+ */
+nebula::Status setupMemoryArenas();
+#endif
@@ -0,0 +1,141 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "daemons/SetupTracing.h"
+
+#include <folly/Format.h>
+#include <folly/String.h>
+#include <folly/json.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "common/base/Base.h"
+#include "common/process/ProcessUtils.h"
+#include "common/thread/GenericWorker.h"
+#include "common/tracing/Tracing.h"
+
+DEFINE_double(trace_sample_ratio,
+              0,
+              "The ratio of the queries traced, the other services trace the requests sampled by "
+              "the caller");
+DEFINE_int64(trace_slow_threshold_us,
+             0,
+             "The requests not sampled are traced too, and their spans are exported if they take "
+             "longer than it in this process, 0 to disable");
+DEFINE_string(trace_otlp_endpoint,
+              "",
+              "The OTLP/HTTP endpoint of the collector the spans are exported to, e.g. "
+              "http://127.0.0.1:4318, tracing is off if it's empty");
+DEFINE_uint32(trace_export_interval_ms, 1000, "The interval to export the finished spans");
+DEFINE_uint32(trace_max_pending_spans,
+              10000,
+              "The spans not exported yet are dropped beyond it, e.g. when the collector is down");
+
+using nebula::ProcessUtils;
+using nebula::Status;
+using nebula::thread::GenericWorker;
+using nebula::tracing::SpanData;
+using nebula::tracing::Tracer;
+
+namespace {
+
+std::unique_ptr<GenericWorker> exporter;
+
+folly::dynamic attribute(const std::string &key, const std::string &value) {
+  return folly::dynamic::object("key", key)("value", folly::dynamic::object("stringValue", value));
+}
+
+folly::dynamic toOtlp(const std::string &service, const std::vector<SpanData> &spans) {
+  auto toNanos = [](int64_t us) { return folly::to<std::string>(us * 1000); };
+  auto otlpSpans = folly::dynamic::array();
+  for (const auto &span : spans) {
+    folly::dynamic otlpSpan = folly::dynamic::object();
+    otlpSpan["traceId"] = folly::sformat("{:016x}{:016x}", span.traceIdHigh, span.traceIdLow);
+    otlpSpan["spanId"] = folly::sformat("{:016x}", span.spanId);
+    if (span.parentSpanId != 0) {
+      otlpSpan["parentSpanId"] = folly::sformat("{:016x}", span.parentSpanId);
+    }
+    otlpSpan["name"] = span.name;
+    otlpSpan["startTimeUnixNano"] = toNanos(span.startUs);
+    otlpSpan["endTimeUnixNano"] = toNanos(span.endUs);
+    auto attributes = folly::dynamic::array();
+    for (const auto &attr : span.attributes) {
+      attributes.push_back(attribute(attr.first, attr.second));
+    }
+    otlpSpan["attributes"] = std::move(attributes);
+    otlpSpans.push_back(std::move(otlpSpan));
+  }
+
+  folly::dynamic scopeSpans = folly::dynamic::object();
+  scopeSpans["scope"] = folly::dynamic::object("name", "nebula");
+  scopeSpans["spans"] = std::move(otlpSpans);
+  folly::dynamic resourceSpans = folly::dynamic::object();
+  auto resourceAttributes = folly::dynamic::array(attribute("service.name", service));
+  resourceSpans["resource"] = folly::dynamic::object("attributes", std::move(resourceAttributes));
+  resourceSpans["scopeSpans"] = folly::dynamic::array(std::move(scopeSpans));
+  return folly::dynamic::object("resourceSpans", folly::dynamic::array(std::move(resourceSpans)));
+}
+
+// Post the spans in OTLP/JSON by curl, the payload is passed in a file to keep it out of the shell
+void exportSpans(const std::string &service, const std::string &payloadPath) {
+  size_t dropped = 0;
+  auto spans = Tracer::instance().drain(&dropped);
+  if (dropped > 0) {
+    LOG(WARNING) << "Dropped " << dropped << " spans not exported in time";
+  }
+  if (spans.empty()) {
+    return;
+  }
+  {
+    std::ofstream payload(payloadPath, std::ios::trunc);
+    payload << folly::toJson(toOtlp(service, spans));
+    if (!payload.good()) {
+      LOG(ERROR) << "Failed to write the spans to " << payloadPath;
+      return;
+    }
+  }
+  auto command = folly::stringPrintf(
+      "curl -s -o /dev/null -w '%%{http_code}' -X POST -H 'Content-Type: application/json' "
+      "--data-binary @'%s' '%s/v1/traces'",
+      payloadPath.c_str(),
+      FLAGS_trace_otlp_endpoint.c_str());
+  auto result = ProcessUtils::runCommand(command.c_str());
+  if (!result.ok()) {
+    LOG(ERROR) << "Failed to export " << spans.size() << " spans: " << result.status();
+  } else if (folly::trimWhitespace(result.value()) != "200") {
+    LOG(ERROR) << "Failed to export " << spans.size() << " spans, http code "
+               << folly::trimWhitespace(result.value());
+  }
+}
+
+}  // namespace
+
+Status setupTracing(const std::string &exe) {
+  if (FLAGS_trace_otlp_endpoint.empty()) {
+    return Status::OK();
+  }
+  if (FLAGS_trace_otlp_endpoint.find('\'') != std::string::npos) {
+    return Status::Error("Invalid trace_otlp_endpoint `%s'", FLAGS_trace_otlp_endpoint.c_str());
+  }
+  auto service = std::filesystem::path(exe).filename().string();
+  auto payloadPath = (std::filesystem::temp_directory_path() /
+                      folly::sformat("{}-{}-spans.json", service, ::getpid()))
+                         .string();
+
+  exporter = std::make_unique<GenericWorker>();
+  if (!exporter->start("trace-exporter")) {
+    return Status::Error("Failed to start the exporter of spans");
+  }
+  exporter->addRepeatTask(FLAGS_trace_export_interval_ms, exportSpans, service, payloadPath);
+  Tracer::instance().configure(
+      FLAGS_trace_sample_ratio, FLAGS_trace_slow_threshold_us, FLAGS_trace_max_pending_spans);
+  LOG(INFO) << "Export spans to " << FLAGS_trace_otlp_endpoint << ", sample ratio "
+            << FLAGS_trace_sample_ratio << ", slow threshold " << FLAGS_trace_slow_threshold_us
+            << "us";
+  return Status::OK();
+}
@@ -0,0 +1,20 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef SETUPTRACING_H
+#define SETUPTRACING_H
+
+#include <string>
+
+#include "common/base/Status.h"
+/**
+ * \param exe: program name, which is the service name of the spans exported.
+ * \return wether successfully setupTracing.
+ *
+ * Tracing stays off if trace_otlp_endpoint is empty. It must be called after daemonizing, since
+ * the spans are exported by a background thread.
+ */
+nebula::Status setupTracing(const std::string &exe);
+#endif
@@ -22,6 +22,8 @@
 #include "common/time/TimezoneInfo.h"
 #include "common/utils/MetaKeyUtils.h"
 #include "daemons/SetupLogging.h"
+#include "daemons/SetupMemoryArenas.h"
+#include "daemons/SetupTracing.h"
 #include "folly/ScopeGuard.h"
 #include "graph/service/GraphFlags.h"
 #include "graph/service/GraphService.h"
@@ -155,6 +157,20 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  // Setup tracing, whose exporter thread must be started after daemonizing
+  status = setupTracing(argv[0]);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+    return EXIT_FAILURE;
+  }
+
+  // Setup the memory arenas, before the thread pools bound to them are started
+  status = setupMemoryArenas();
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+    return EXIT_FAILURE;
+  }
+
   // Validate the IPv4 address or hostname
   status = NetworkUtils::validateHostOrIp(FLAGS_local_ip);
   if (!status.ok()) {
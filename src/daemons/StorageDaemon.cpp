@@ -13,6 +13,8 @@
 #include "common/process/ProcessUtils.h"
 #include "common/time/TimezoneInfo.h"
 #include "daemons/SetupLogging.h"
+#include "daemons/SetupMemoryArenas.h"
+#include "daemons/SetupTracing.h"
 #include "storage/StorageServer.h"
 #include "storage/stats/StorageStats.h"
 #include "version/Version.h"
@@ -111,6 +113,20 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  // Setup tracing, whose exporter thread must be started after daemonizing
+  status = setupTracing(argv[0]);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+    return EXIT_FAILURE;
+  }
+
+  // Setup the memory arenas, before the thread pools bound to them are started
+  status = setupMemoryArenas();
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+    return EXIT_FAILURE;
+  }
+
   if (FLAGS_data_path.empty()) {
     LOG(ERROR) << "Storage Data Path should not empty";
     return EXIT_FAILURE;
@@ -0,0 +1,797 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/context/BatchEvaluator.h"
+
+#include <cmath>
+
+#include "common/expression/ArithmeticExpression.h"
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/FunctionCallExpression.h"
+#include "common/expression/LogicalExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "common/expression/RelationalExpression.h"
+#include "common/expression/UnaryExpression.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+BatchVector::Kind kindOf(const Value& v) {
+  switch (v.type()) {
+    case Value::Type::BOOL:
+      return BatchVector::Kind::kBool;
+    case Value::Type::INT:
+      return BatchVector::Kind::kInt;
+    case Value::Type::FLOAT:
+      return BatchVector::Kind::kFloat;
+    case Value::Type::STRING:
+      return BatchVector::Kind::kString;
+    default:
+      return BatchVector::Kind::kValue;
+  }
+}
+
+bool isNumeric(BatchVector::Kind kind) {
+  return kind == BatchVector::Kind::kInt || kind == BatchVector::Kind::kFloat;
+}
+
+// Run `f(slot, l, r)' over all output slots, hoisting the constant operands
+// out of the loop so that the loop body stays branch free.
+template <typename L, typename R, typename F>
+void binaryLoop(const L* l, bool lc, const R* r, bool rc, size_t n, F&& f) {
+  if (lc && rc) {
+    for (size_t i = 0; i < n; ++i) f(i, l[0], r[0]);
+  } else if (lc) {
+    const L lv = l[0];
+    for (size_t i = 0; i < n; ++i) f(i, lv, r[i]);
+  } else if (rc) {
+    const R rv = r[0];
+    for (size_t i = 0; i < n; ++i) f(i, l[i], rv);
+  } else {
+    for (size_t i = 0; i < n; ++i) f(i, l[i], r[i]);
+  }
+}
+
+// The row-based semantics of the relational operators, see RelationalExpression::eval
+Value relationalValue(Expression::Kind kind, const Value& lhs, const Value& rhs) {
+  switch (kind) {
+    case Expression::Kind::kRelEQ:
+      return lhs.equal(rhs);
+    case Expression::Kind::kRelNE:
+      return !lhs.equal(rhs);
+    case Expression::Kind::kRelLT:
+      return lhs.lessThan(rhs);
+    case Expression::Kind::kRelLE:
+      return lhs.lessThan(rhs) || lhs.equal(rhs);
+    case Expression::Kind::kRelGT:
+      return !lhs.lessThan(rhs) && !lhs.equal(rhs);
+    case Expression::Kind::kRelGE:
+      return !lhs.lessThan(rhs) || lhs.equal(rhs);
+    default:
+      LOG(FATAL) << "Unsupported relational kind: " << static_cast<int>(kind);
+  }
+}
+
+// See ArithmeticExpression::eval
+Value arithmeticValue(Expression::Kind kind, const Value& lhs, const Value& rhs) {
+  switch (kind) {
+    case Expression::Kind::kAdd:
+      return lhs + rhs;
+    case Expression::Kind::kMinus:
+      return lhs - rhs;
+    case Expression::Kind::kMultiply:
+      return lhs * rhs;
+    case Expression::Kind::kDivision:
+      return lhs / rhs;
+    case Expression::Kind::kMod:
+      return lhs % rhs;
+    default:
+      LOG(FATAL) << "Unsupported arithmetic kind: " << static_cast<int>(kind);
+  }
+}
+
+// See LogicalExpression::evalAnd and LogicalExpression::evalOr
+Value logicalValue(Expression::Kind kind, const std::vector<BatchVector>& operands, size_t row) {
+  const bool isAnd = kind == Expression::Kind::kLogicalAnd;
+  Value result = isAnd;
+  for (const auto& operand : operands) {
+    auto value = operand.value(row);
+    if (value.isBadNull() || (value.isImplicitBool() && value.implicitBool() != isAnd)) {
+      return value;
+    }
+    if (!value.isImplicitBool()) {
+      if (value.isNull()) {
+        result = value;
+      } else if (value.empty() && !result.isNull()) {
+        result = value;
+      } else {
+        return Value::kNullBadType;
+      }
+    }
+  }
+  return result;
+}
+
+// See UnaryExpression::eval
+Value unaryValue(Expression::Kind kind, const Value& operand) {
+  switch (kind) {
+    case Expression::Kind::kUnaryPlus:
+      return operand;
+    case Expression::Kind::kUnaryNegate:
+      return -operand;
+    case Expression::Kind::kUnaryNot:
+      return !operand;
+    case Expression::Kind::kIsNull:
+      return operand.isNull();
+    case Expression::Kind::kIsNotNull:
+      return !operand.isNull();
+    case Expression::Kind::kIsEmpty:
+      return operand.empty();
+    case Expression::Kind::kIsNotEmpty:
+      return !operand.empty();
+    default:
+      LOG(FATAL) << "Unsupported unary kind: " << static_cast<int>(kind);
+  }
+}
+
+}  // namespace
+
+void BatchVector::init(Kind kind, size_t size, bool isConst) {
+  kind_ = kind;
+  size_ = size;
+  const_ = isConst;
+  auto n = slots();
+  switch (kind) {
+    case Kind::kBool:
+      bools_.resize(n);
+      break;
+    case Kind::kInt:
+      ints_.resize(n);
+      break;
+    case Kind::kFloat:
+      floats_.resize(n);
+      break;
+    case Kind::kString:
+      ownStrs_.resize(n);
+      break;
+    case Kind::kValue:
+      values_.resize(n);
+      break;
+  }
+}
+
+void BatchVector::setException(size_t slot, Value&& v) {
+  if (kind_ == Kind::kValue) {
+    values_[slot] = std::move(v);
+    return;
+  }
+  if (!hasException_) {
+    hasException_ = true;
+    except_.resize(slots());
+    values_.resize(slots());
+  }
+  except_.set(slot);
+  values_[slot] = std::move(v);
+}
+
+// static
+BatchVector BatchVector::constant(const Value& v, size_t size) {
+  BatchVector vec;
+  vec.init(kindOf(v), size, true);
+  switch (vec.kind_) {
+    case Kind::kBool:
+      vec.bools_[0] = v.getBool();
+      break;
+    case Kind::kInt:
+      vec.ints_[0] = v.getInt();
+      break;
+    case Kind::kFloat:
+      vec.floats_[0] = v.getFloat();
+      break;
+    case Kind::kString:
+      vec.ownStrs_[0] = v.getStr();
+      break;
+    case Kind::kValue:
+      vec.values_[0] = v;
+      break;
+  }
+  return vec;
+}
+
+// static
+BatchVector BatchVector::fromColumn(const Column& col) {
+  BatchVector vec;
+  vec.size_ = col.size();
+  switch (col.kind()) {
+    case Column::Kind::kBool: {
+      vec.kind_ = Kind::kBool;
+      const auto& bools = col.bools();
+      vec.bools_.assign(bools.begin(), bools.end());
+      break;
+    }
+    case Column::Kind::kInt:
+      vec.kind_ = Kind::kInt;
+      vec.ints_ = col.ints();
+      break;
+    case Column::Kind::kFloat:
+      vec.kind_ = Kind::kFloat;
+      vec.floats_ = col.floats();
+      break;
+    case Column::Kind::kString:
+      vec.kind_ = Kind::kString;
+      vec.strs_ = &col.strs();
+      break;
+    case Column::Kind::kGeneric:
+      vec.kind_ = Kind::kValue;
+      vec.values_ = col.generic();
+      return vec;
+  }
+  if (col.hasNull()) {
+    for (size_t i = 0; i < vec.size_; ++i) {
+      if (col.isNull(i)) {
+        vec.setException(i, Value(Value::kNullValue));
+      }
+    }
+  }
+  return vec;
+}
+
+// static
+BatchVector BatchVector::fromValues(std::vector<Value>&& values) {
+  BatchVector vec;
+  Kind kind = Kind::kValue;
+  for (const auto& v : values) {
+    if (!v.isNull() && !v.empty()) {
+      kind = kindOf(v);
+      break;
+    }
+  }
+  vec.init(kind, values.size(), false);
+  if (kind == Kind::kValue) {
+    vec.values_ = std::move(values);
+    return vec;
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto& v = values[i];
+    if (kindOf(v) != kind) {
+      vec.setException(i, std::move(v));
+      continue;
+    }
+    switch (kind) {
+      case Kind::kBool:
+        vec.bools_[i] = v.getBool();
+        break;
+      case Kind::kInt:
+        vec.ints_[i] = v.getInt();
+        break;
+      case Kind::kFloat:
+        vec.floats_[i] = v.getFloat();
+        break;
+      case Kind::kString:
+        vec.ownStrs_[i] = v.moveStr();
+        break;
+      case Kind::kValue:
+        break;
+    }
+  }
+  return vec;
+}
+
+Value BatchVector::value(size_t i) const {
+  auto slot = pos(i);
+  if (kind_ == Kind::kValue || (hasException_ && except_.test(slot))) {
+    return values_[slot];
+  }
+  switch (kind_) {
+    case Kind::kBool:
+      return static_cast<bool>(bools_[slot]);
+    case Kind::kInt:
+      return ints_[slot];
+    case Kind::kFloat:
+      return floats_[slot];
+    case Kind::kString:
+      return getStr(i);
+    case Kind::kValue:
+      break;
+  }
+  return Value::kNullBadType;
+}
+
+// static
+std::unique_ptr<BatchEvaluator> BatchEvaluator::compile(const Expression* expr) {
+  if (expr == nullptr) {
+    return nullptr;
+  }
+  std::unique_ptr<BatchEvaluator> evaluator(new BatchEvaluator());
+  if (!evaluator->compileExpr(expr)) {
+    return nullptr;
+  }
+  return evaluator;
+}
+
+bool BatchEvaluator::compileExpr(const Expression* expr) {
+  Instr instr;
+  instr.kind = expr->kind();
+  switch (expr->kind()) {
+    case Expression::Kind::kConstant: {
+      instr.constant = static_cast<const ConstantExpression*>(expr)->value();
+      break;
+    }
+    case Expression::Kind::kInputProperty:
+    case Expression::Kind::kVarProperty: {
+      // Both of them read the column of the current iterator,
+      // see QueryExpressionContext::getInputProp/getVarProp
+      instr.prop = static_cast<const PropertyExpression*>(expr)->prop();
+      break;
+    }
+    case Expression::Kind::kRelEQ:
+    case Expression::Kind::kRelNE:
+    case Expression::Kind::kRelLT:
+    case Expression::Kind::kRelLE:
+    case Expression::Kind::kRelGT:
+    case Expression::Kind::kRelGE:
+    case Expression::Kind::kAdd:
+    case Expression::Kind::kMinus:
+    case Expression::Kind::kMultiply:
+    case Expression::Kind::kDivision:
+    case Expression::Kind::kMod: {
+      auto* binary = static_cast<const BinaryExpression*>(expr);
+      if (!compileExpr(binary->left()) || !compileExpr(binary->right())) {
+        return false;
+      }
+      instr.numArgs = 2;
+      break;
+    }
+    case Expression::Kind::kLogicalAnd:
+    case Expression::Kind::kLogicalOr: {
+      auto* logical = static_cast<const LogicalExpression*>(expr);
+      for (auto* operand : logical->operands()) {
+        if (!compileExpr(operand)) {
+          return false;
+        }
+      }
+      instr.numArgs = logical->operands().size();
+      break;
+    }
+    case Expression::Kind::kUnaryPlus:
+    case Expression::Kind::kUnaryNegate:
+    case Expression::Kind::kUnaryNot:
+    case Expression::Kind::kIsNull:
+    case Expression::Kind::kIsNotNull:
+    case Expression::Kind::kIsEmpty:
+    case Expression::Kind::kIsNotEmpty: {
+      if (!compileExpr(static_cast<const UnaryExpression*>(expr)->operand())) {
+        return false;
+      }
+      instr.numArgs = 1;
+      break;
+    }
+    case Expression::Kind::kFunctionCall: {
+      auto* call = static_cast<const FunctionCallExpression*>(expr);
+      auto numArgs = call->args() == nullptr ? 0 : call->args()->numArgs();
+      // The impure functions(e.g. rand) are still evaluated row by row,
+      // but keep them in the row-based evaluation to be safe.
+      auto isPure = FunctionManager::getIsPure(call->name(), numArgs);
+      if (!isPure.ok() || !isPure.value()) {
+        return false;
+      }
+      auto func = FunctionManager::get(call->name(), numArgs);
+      if (!func.ok()) {
+        return false;
+      }
+      for (size_t i = 0; i < numArgs; ++i) {
+        if (!compileExpr(call->args()->args()[i])) {
+          return false;
+        }
+      }
+      instr.numArgs = numArgs;
+      instr.func = std::move(func).value();
+      break;
+    }
+    default:
+      return false;
+  }
+  program_.emplace_back(std::move(instr));
+  return true;
+}
+
+StatusOr<BatchVector> BatchEvaluator::eval(const ColumnBatch& batch) const {
+  const auto size = batch.numRows();
+  std::vector<BatchVector> stack;
+  for (const auto& instr : program_) {
+    DCHECK_GE(stack.size(), instr.numArgs);
+    std::vector<BatchVector> args;
+    args.reserve(instr.numArgs);
+    for (auto it = stack.end() - instr.numArgs; it != stack.end(); ++it) {
+      args.emplace_back(std::move(*it));
+    }
+    stack.resize(stack.size() - instr.numArgs);
+
+    switch (instr.kind) {
+      case Expression::Kind::kConstant:
+        stack.emplace_back(BatchVector::constant(instr.constant, size));
+        break;
+      case Expression::Kind::kInputProperty:
+      case Expression::Kind::kVarProperty: {
+        auto* col = batch.column(instr.prop);
+        if (col == nullptr) {
+          return Status::Error("Don't exist column `%s'.", instr.prop.c_str());
+        }
+        stack.emplace_back(BatchVector::fromColumn(*col));
+        break;
+      }
+      case Expression::Kind::kRelEQ:
+      case Expression::Kind::kRelNE:
+      case Expression::Kind::kRelLT:
+      case Expression::Kind::kRelLE:
+      case Expression::Kind::kRelGT:
+      case Expression::Kind::kRelGE:
+        stack.emplace_back(relational(instr.kind, args[0], args[1]));
+        break;
+      case Expression::Kind::kAdd:
+      case Expression::Kind::kMinus:
+      case Expression::Kind::kMultiply:
+      case Expression::Kind::kDivision:
+      case Expression::Kind::kMod:
+        stack.emplace_back(arithmetic(instr.kind, args[0], args[1]));
+        break;
+      case Expression::Kind::kLogicalAnd:
+      case Expression::Kind::kLogicalOr:
+        stack.emplace_back(logical(instr.kind, args));
+        break;
+      case Expression::Kind::kFunctionCall:
+        stack.emplace_back(functionCall(instr.func, args, size));
+        break;
+      default:
+        stack.emplace_back(unary(instr.kind, args[0]));
+        break;
+    }
+  }
+  DCHECK_EQ(stack.size(), 1UL);
+  return std::move(stack.back());
+}
+
+// static
+BatchVector BatchEvaluator::relational(Expression::Kind kind,
+                                       const BatchVector& l,
+                                       const BatchVector& r) {
+  const bool outConst = l.isConstant() && r.isConstant();
+  BatchVector out;
+  const bool typed = (isNumeric(l.kind()) && isNumeric(r.kind())) ||
+                     (l.kind() == r.kind() && (l.kind() == BatchVector::Kind::kString ||
+                                               l.kind() == BatchVector::Kind::kBool));
+  if (!typed) {
+    out.init(BatchVector::Kind::kValue, l.size(), outConst);
+    for (size_t i = 0; i < out.slots(); ++i) {
+      out.values_[i] = relationalValue(kind, l.value(i), r.value(i));
+    }
+    return out;
+  }
+
+  out.init(BatchVector::Kind::kBool, l.size(), outConst);
+  const auto n = out.slots();
+  auto* res = out.bools_.data();
+  // Combine the result of `==' and `<' as the row-based evaluation does
+  auto combine = [kind](bool eq, bool lt) -> bool {
+    switch (kind) {
+      case Expression::Kind::kRelEQ:
+        return eq;
+      case Expression::Kind::kRelNE:
+        return !eq;
+      case Expression::Kind::kRelLT:
+        return lt;
+      case Expression::Kind::kRelLE:
+        return lt || eq;
+      case Expression::Kind::kRelGT:
+        return !lt && !eq;
+      default:
+        return !lt || eq;
+    }
+  };
+  auto cmpFloat = [res, &combine](size_t i, double a, double b) {
+    bool eq = std::abs(a - b) < kEpsilon;
+    res[i] = combine(eq, !eq && a < b);
+  };
+  auto cmpExact = [res, &combine](size_t i, const auto& a, const auto& b) {
+    res[i] = combine(a == b, a < b);
+  };
+
+  using Kind = BatchVector::Kind;
+  if (l.kind() == Kind::kInt && r.kind() == Kind::kInt) {
+    binaryLoop(l.ints_.data(), l.isConstant(), r.ints_.data(), r.isConstant(), n, cmpExact);
+  } else if (l.kind() == Kind::kInt && r.kind() == Kind::kFloat) {
+    binaryLoop(l.ints_.data(), l.isConstant(), r.floats_.data(), r.isConstant(), n, cmpFloat);
+  } else if (l.kind() == Kind::kFloat && r.kind() == Kind::kInt) {
+    binaryLoop(l.floats_.data(), l.isConstant(), r.ints_.data(), r.isConstant(), n, cmpFloat);
+  } else if (l.kind() == Kind::kFloat) {
+    binaryLoop(l.floats_.data(), l.isConstant(), r.floats_.data(), r.isConstant(), n, cmpFloat);
+  } else if (l.kind() == Kind::kBool) {
+    binaryLoop(l.bools_.data(), l.isConstant(), r.bools_.data(), r.isConstant(), n, cmpExact);
+  } else {
+    for (size_t i = 0; i < n; ++i) {
+      const auto& a = l.getStr(i);
+      const auto& b = r.getStr(i);
+      res[i] = combine(a == b, a < b);
+    }
+  }
+
+  if (l.hasException() || r.hasException()) {
+    for (size_t i = 0; i < n; ++i) {
+      if (l.isException(i) || r.isException(i)) {
+        out.setException(i, relationalValue(kind, l.value(i), r.value(i)));
+      }
+    }
+  }
+  return out;
+}
+
+// static
+BatchVector BatchEvaluator::arithmetic(Expression::Kind kind,
+                                       const BatchVector& l,
+                                       const BatchVector& r) {
+  using Kind = BatchVector::Kind;
+  const bool outConst = l.isConstant() && r.isConstant();
+  BatchVector out;
+  if (!isNumeric(l.kind()) || !isNumeric(r.kind())) {
+    out.init(Kind::kValue, l.size(), outConst);
+    for (size_t i = 0; i < out.slots(); ++i) {
+      out.values_[i] = arithmeticValue(kind, l.value(i), r.value(i));
+    }
+    return out;
+  }
+
+  const auto n = outConst ? 1 : l.size();
+  // Rows that overflow or divide by zero are recomputed by Value operators
+  std::vector<uint8_t> bad(n, 0);
+  auto* b = bad.data();
+  if (l.kind() == Kind::kInt && r.kind() == Kind::kInt) {
+    out.init(Kind::kInt, l.size(), outConst);
+    auto* res = out.ints_.data();
+    auto op = [kind, res, b](size_t i, int64_t x, int64_t y) {
+      switch (kind) {
+        case Expression::Kind::kAdd:
+          b[i] = __builtin_add_overflow(x, y, &res[i]);
+          break;
+        case Expression::Kind::kMinus:
+          b[i] = __builtin_sub_overflow(x, y, &res[i]);
+          break;
+        case Expression::Kind::kMultiply:
+          b[i] = __builtin_mul_overflow(x, y, &res[i]);
+          break;
+        default: {
+          // Division and Mod
+          b[i] = y == 0 || (x == INT64_MIN && y == -1);
+          auto d = b[i] ? 1 : y;
+          res[i] = kind == Expression::Kind::kDivision ? x / d : x % d;
+          break;
+        }
+      }
+    };
+    binaryLoop(l.ints_.data(), l.isConstant(), r.ints_.data(), r.isConstant(), n, op);
+  } else {
+    out.init(Kind::kFloat, l.size(), outConst);
+    auto* res = out.floats_.data();
+    const bool intDenom = r.kind() == Kind::kInt;
+    auto op = [kind, res, b, intDenom](size_t i, double x, double y) {
+      switch (kind) {
+        case Expression::Kind::kAdd:
+          res[i] = x + y;
+          break;
+        case Expression::Kind::kMinus:
+          res[i] = x - y;
+          break;
+        case Expression::Kind::kMultiply:
+          res[i] = x * y;
+          break;
+        default: {
+          b[i] = intDenom ? y == 0 : !(std::abs(y) > kEpsilon);
+          auto d = b[i] ? 1.0 : y;
+          res[i] = kind == Expression::Kind::kDivision ? x / d : std::fmod(x, d);
+          break;
+        }
+      }
+    };
+    // Convert the int operand to double, as the Value operators do
+    std::vector<double> lf, rf;
+    const double* lp = l.floats_.data();
+    const double* rp = r.floats_.data();
+    if (l.kind() == Kind::kInt) {
+      lf.assign(l.ints_.begin(), l.ints_.end());
+      lp = lf.data();
+    }
+    if (r.kind() == Kind::kInt) {
+      rf.assign(r.ints_.begin(), r.ints_.end());
+      rp = rf.data();
+    }
+    binaryLoop(lp, l.isConstant(), rp, r.isConstant(), n, op);
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    if (b[i] || l.isException(i) || r.isException(i)) {
+      out.setException(i, arithmeticValue(kind, l.value(i), r.value(i)));
+    }
+  }
+  return out;
+}
+
+// static
+BatchVector BatchEvaluator::logical(Expression::Kind kind, std::vector<BatchVector>& operands) {
+  DCHECK(!operands.empty());
+  const auto size = operands.front().size();
+  bool outConst = true;
+  bool typed = true;
+  bool hasException = false;
+  for (const auto& operand : operands) {
+    outConst = outConst && operand.isConstant();
+    typed = typed && operand.kind() == BatchVector::Kind::kBool;
+    hasException = hasException || operand.hasException();
+  }
+
+  BatchVector out;
+  if (!typed) {
+    out.init(BatchVector::Kind::kValue, size, outConst);
+    for (size_t i = 0; i < out.slots(); ++i) {
+      out.values_[i] = logicalValue(kind, operands, i);
+    }
+    return out;
+  }
+
+  out.init(BatchVector::Kind::kBool, size, outConst);
+  const auto n = out.slots();
+  auto* res = out.bools_.data();
+  const bool isAnd = kind == Expression::Kind::kLogicalAnd;
+  std::fill(res, res + n, isAnd);
+  for (const auto& operand : operands) {
+    const auto* data = operand.bools_.data();
+    if (operand.isConstant()) {
+      const auto v = data[0];
+      for (size_t i = 0; i < n; ++i) res[i] = isAnd ? (res[i] & v) : (res[i] | v);
+    } else if (isAnd) {
+      for (size_t i = 0; i < n; ++i) res[i] &= data[i];
+    } else {
+      for (size_t i = 0; i < n; ++i) res[i] |= data[i];
+    }
+  }
+
+  if (hasException) {
+    for (size_t i = 0; i < n; ++i) {
+      for (const auto& operand : operands) {
+        if (operand.isException(i)) {
+          out.setException(i, logicalValue(kind, operands, i));
+          break;
+        }
+      }
+    }
+  }
+  return out;
+}
+
+// static
+BatchVector BatchEvaluator::unary(Expression::Kind kind, const BatchVector& operand) {
+  using Kind = BatchVector::Kind;
+  BatchVector out;
+  const auto size = operand.size();
+  const bool isConst = operand.isConstant();
+  switch (kind) {
+    case Expression::Kind::kIsNull:
+    case Expression::Kind::kIsNotNull:
+    case Expression::Kind::kIsEmpty:
+    case Expression::Kind::kIsNotEmpty: {
+      // Typed slots are never null nor empty
+      const bool typedResult = kind == Expression::Kind::kIsNotNull ||
+                               kind == Expression::Kind::kIsNotEmpty;
+      out.init(Kind::kBool, size, isConst);
+      std::fill(out.bools_.begin(), out.bools_.end(), typedResult);
+      if (operand.hasException()) {
+        for (size_t i = 0; i < out.slots(); ++i) {
+          if (operand.isException(i)) {
+            out.bools_[i] = unaryValue(kind, operand.value(i)).getBool();
+          }
+        }
+      }
+      return out;
+    }
+    case Expression::Kind::kUnaryNot:
+      if (operand.kind() == Kind::kBool) {
+        out.init(Kind::kBool, size, isConst);
+        for (size_t i = 0; i < out.slots(); ++i) out.bools_[i] = !operand.bools_[i];
+        break;
+      }
+      out.init(Kind::kValue, size, isConst);
+      break;
+    case Expression::Kind::kUnaryNegate:
+      if (operand.kind() == Kind::kInt) {
+        out.init(Kind::kInt, size, isConst);
+        for (size_t i = 0; i < out.slots(); ++i) {
+          // Negating INT64_MIN overflows, which is handled as exception below
+          auto v = operand.ints_[i];
+          out.ints_[i] = v == INT64_MIN ? 0 : -v;
+        }
+        for (size_t i = 0; i < out.slots(); ++i) {
+          if (operand.ints_[i] == INT64_MIN && !operand.isException(i)) {
+            out.setException(i, Value(Value::kNullOverflow));
+          }
+        }
+        break;
+      }
+      if (operand.kind() == Kind::kFloat) {
+        out.init(Kind::kFloat, size, isConst);
+        for (size_t i = 0; i < out.slots(); ++i) out.floats_[i] = -operand.floats_[i];
+        break;
+      }
+      out.init(Kind::kValue, size, isConst);
+      break;
+    default:
+      // kUnaryPlus
+      out.init(Kind::kValue, size, isConst);
+      break;
+  }
+
+  if (out.kind() == Kind::kValue) {
+    for (size_t i = 0; i < out.slots(); ++i) {
+      out.values_[i] = unaryValue(kind, operand.value(i));
+    }
+  } else if (operand.hasException()) {
+    for (size_t i = 0; i < out.slots(); ++i) {
+      if (operand.isException(i)) {
+        out.setException(i, unaryValue(kind, operand.value(i)));
+      }
+    }
+  }
+  return out;
+}
+
+// static
+BatchVector BatchEvaluator::functionCall(const FunctionManager::Function& func,
+                                         std::vector<BatchVector>& args,
+                                         size_t size) {
+  bool allConst = true;
+  for (const auto& arg : args) {
+    allConst = allConst && arg.isConstant();
+  }
+  const auto n = allConst ? 1 : size;
+  std::vector<Value> results;
+  results.reserve(n);
+  std::vector<Value> values(args.size());
+  std::vector<FunctionManager::ArgType> parameter;
+  parameter.reserve(args.size());
+  for (auto& v : values) {
+    parameter.emplace_back(v);
+  }
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < args.size(); ++j) {
+      values[j] = args[j].value(i);
+    }
+    results.emplace_back(func(parameter));
+  }
+  if (allConst) {
+    return BatchVector::constant(results.front(), size);
+  }
+  return BatchVector::fromValues(std::move(results));
+}
+
+// static
+Status BatchEvaluator::toFilterMask(const BatchVector& cond, std::vector<uint8_t>* keep) {
+  keep->resize(cond.size());
+  if (cond.kind() == BatchVector::Kind::kBool && !cond.hasException()) {
+    for (size_t i = 0; i < cond.size(); ++i) {
+      (*keep)[i] = cond.getBool(i);
+    }
+    return Status::OK();
+  }
+  for (size_t i = 0; i < cond.size(); ++i) {
+    auto val = cond.value(i);
+    if (val.isBadNull() || (!val.empty() && !val.isImplicitBool() && !val.isNull())) {
+      return Status::Error("Wrong type result, the type should be NULL, EMPTY, BOOL");
+    }
+    (*keep)[i] = !(val.empty() || val.isNull() || (val.isImplicitBool() && !val.implicitBool()));
+  }
+  return Status::OK();
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -0,0 +1,173 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_CONTEXT_BATCHEVALUATOR_H_
+#define GRAPH_CONTEXT_BATCHEVALUATOR_H_
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "common/base/StatusOr.h"
+#include "common/expression/Expression.h"
+#include "common/function/FunctionManager.h"
+#include "graph/context/ColumnBatch.h"
+
+namespace nebula {
+namespace graph {
+
+// The intermediate result of the batch evaluation, one value per row.
+//
+// Values of the dominant scalar type are kept in a typed vector, so that the
+// kernels are plain loops over contiguous memory which compilers are able to
+// auto-vectorize. The rows holding anything else (nulls, overflow, values of
+// other types...) are marked as exceptions and kept aside as Value, kernels
+// handle them with the same Value operators used by the row-based evaluation.
+class BatchVector final {
+ public:
+  enum class Kind : uint8_t {
+    kBool,
+    kInt,
+    kFloat,
+    kString,
+    // Every row is stored as Value
+    kValue,
+  };
+
+  BatchVector() = default;
+  BatchVector(BatchVector&&) = default;
+  BatchVector& operator=(BatchVector&&) = default;
+
+  // A constant vector stores only one slot for all rows
+  static BatchVector constant(const Value& v, size_t size);
+
+  // Borrow the data of the column, the column must outlive the vector
+  static BatchVector fromColumn(const Column& col);
+
+  static BatchVector fromValues(std::vector<Value>&& values);
+
+  Kind kind() const {
+    return kind_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool isConstant() const {
+    return const_;
+  }
+
+  bool hasException() const {
+    return kind_ == Kind::kValue || hasException_;
+  }
+
+  // Whether the i'th row is not stored in the typed slots
+  bool isException(size_t i) const {
+    return kind_ == Kind::kValue || (hasException_ && except_.test(pos(i)));
+  }
+
+  bool getBool(size_t i) const {
+    return bools_[pos(i)];
+  }
+
+  int64_t getInt(size_t i) const {
+    return ints_[pos(i)];
+  }
+
+  double getFloat(size_t i) const {
+    return floats_[pos(i)];
+  }
+
+  const std::string& getStr(size_t i) const {
+    return strs_ != nullptr ? (*strs_)[pos(i)] : ownStrs_[pos(i)];
+  }
+
+  Value value(size_t i) const;
+
+ private:
+  friend class BatchEvaluator;
+
+  BatchVector(const BatchVector&) = delete;
+  BatchVector& operator=(const BatchVector&) = delete;
+
+  size_t pos(size_t i) const {
+    return const_ ? 0 : i;
+  }
+
+  // Number of the physical slots
+  size_t slots() const {
+    return const_ ? 1 : size_;
+  }
+
+  void init(Kind kind, size_t size, bool isConst);
+
+  void setException(size_t slot, Value&& v);
+
+  Kind kind_{Kind::kValue};
+  size_t size_{0};
+  bool const_{false};
+  std::vector<uint8_t> bools_;
+  std::vector<int64_t> ints_;
+  std::vector<double> floats_;
+  // Borrowed from the column batch when not null
+  const std::vector<std::string>* strs_{nullptr};
+  std::vector<std::string> ownStrs_;
+  bool hasException_{false};
+  boost::dynamic_bitset<> except_;
+  std::vector<Value> values_;
+};
+
+// Evaluate an expression over a ColumnBatch column-at-a-time.
+//
+// The expression tree is compiled once into a postfix sequence of kernels
+// (constants, input properties, relational, arithmetic, logical, unary and
+// function calls). Expressions containing anything else are rejected by
+// compile() and callers should keep the row-based evaluation.
+class BatchEvaluator final {
+ public:
+  // Return nullptr if the expression is not supported
+  static std::unique_ptr<BatchEvaluator> compile(const Expression* expr);
+
+  StatusOr<BatchVector> eval(const ColumnBatch& batch) const;
+
+  // Convert the result of a filter condition to the rows to keep, with the
+  // same type checking as FilterExecutor.
+  static Status toFilterMask(const BatchVector& cond, std::vector<uint8_t>* keep);
+
+ private:
+  struct Instr {
+    Expression::Kind kind;
+    // Number of operands popped from the stack
+    size_t numArgs{0};
+    // For constant
+    Value constant;
+    // For input property
+    std::string prop;
+    // For function call
+    FunctionManager::Function func;
+  };
+
+  BatchEvaluator() = default;
+
+  bool compileExpr(const Expression* expr);
+
+  static BatchVector relational(Expression::Kind kind, const BatchVector& l, const BatchVector& r);
+
+  static BatchVector arithmetic(Expression::Kind kind, const BatchVector& l, const BatchVector& r);
+
+  static BatchVector logical(Expression::Kind kind, std::vector<BatchVector>& operands);
+
+  static BatchVector unary(Expression::Kind kind, const BatchVector& operand);
+
+  static BatchVector functionCall(const FunctionManager::Function& func,
+                                  std::vector<BatchVector>& args,
+                                  size_t size);
+
+  std::vector<Instr> program_;
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_CONTEXT_BATCHEVALUATOR_H_
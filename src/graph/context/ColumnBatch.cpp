@@ -0,0 +1,183 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/context/ColumnBatch.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+// Deduce the column kind from the values, return kGeneric if the column
+// can't be stored in a typed vector.
+Column::Kind deduceKind(const std::vector<Row>& rows, size_t colIdx) {
+  Value::Type type = Value::Type::__EMPTY__;
+  for (const auto& row : rows) {
+    if (colIdx >= row.values.size()) {
+      return Column::Kind::kGeneric;
+    }
+    const auto& v = row.values[colIdx];
+    if (v.isNull()) {
+      if (v.getNull() != NullType::__NULL__) {
+        return Column::Kind::kGeneric;
+      }
+      continue;
+    }
+    if (type == Value::Type::__EMPTY__) {
+      type = v.type();
+    } else if (type != v.type()) {
+      return Column::Kind::kGeneric;
+    }
+  }
+  switch (type) {
+    case Value::Type::BOOL:
+      return Column::Kind::kBool;
+    case Value::Type::INT:
+      return Column::Kind::kInt;
+    case Value::Type::FLOAT:
+      return Column::Kind::kFloat;
+    case Value::Type::STRING:
+      return Column::Kind::kString;
+    default:
+      // All nulls, EMPTY or composite values
+      return Column::Kind::kGeneric;
+  }
+}
+
+}  // namespace
+
+// static
+Column Column::fromRows(const std::vector<Row>& rows, size_t colIdx) {
+  Column col;
+  col.size_ = rows.size();
+  col.kind_ = deduceKind(rows, colIdx);
+  if (col.kind_ == Kind::kGeneric) {
+    col.toGeneric(rows, colIdx);
+    return col;
+  }
+
+  col.nulls_.resize(rows.size());
+  switch (col.kind_) {
+    case Kind::kBool:
+      col.bools_.resize(rows.size(), false);
+      break;
+    case Kind::kInt:
+      col.ints_.resize(rows.size(), 0);
+      break;
+    case Kind::kFloat:
+      col.floats_.resize(rows.size(), 0.0);
+      break;
+    case Kind::kString:
+      col.strs_.resize(rows.size());
+      break;
+    case Kind::kGeneric:
+      break;
+  }
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const auto& v = rows[i].values[colIdx];
+    if (v.isNull()) {
+      col.nulls_.set(i);
+      continue;
+    }
+    switch (col.kind_) {
+      case Kind::kBool:
+        col.bools_[i] = v.getBool();
+        break;
+      case Kind::kInt:
+        col.ints_[i] = v.getInt();
+        break;
+      case Kind::kFloat:
+        col.floats_[i] = v.getFloat();
+        break;
+      case Kind::kString:
+        col.strs_[i] = v.getStr();
+        break;
+      case Kind::kGeneric:
+        break;
+    }
+  }
+  return col;
+}
+
+void Column::toGeneric(const std::vector<Row>& rows, size_t colIdx) {
+  kind_ = Kind::kGeneric;
+  generic_.reserve(rows.size());
+  nulls_.resize(rows.size());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const auto& values = rows[i].values;
+    const auto& v = colIdx < values.size() ? values[colIdx] : Value::kEmpty;
+    if (v.isNull()) {
+      nulls_.set(i);
+    }
+    generic_.emplace_back(v);
+  }
+}
+
+Value Column::value(size_t i) const {
+  DCHECK_LT(i, size_);
+  if (kind_ == Kind::kGeneric) {
+    return generic_[i];
+  }
+  if (nulls_.test(i)) {
+    return Value::kNullValue;
+  }
+  switch (kind_) {
+    case Kind::kBool:
+      return static_cast<bool>(bools_[i]);
+    case Kind::kInt:
+      return ints_[i];
+    case Kind::kFloat:
+      return floats_[i];
+    case Kind::kString:
+      return strs_[i];
+    case Kind::kGeneric:
+      break;
+  }
+  return Value::kNullBadType;
+}
+
+// static
+ColumnBatch ColumnBatch::fromDataSet(const DataSet& ds) {
+  return fromRows(ds.colNames, ds.rows);
+}
+
+// static
+ColumnBatch ColumnBatch::fromRows(const std::vector<std::string>& colNames,
+                                  const std::vector<Row>& rows) {
+  ColumnBatch batch;
+  batch.colNames_ = colNames;
+  batch.numRows_ = rows.size();
+  batch.columns_.reserve(colNames.size());
+  for (size_t i = 0; i < colNames.size(); ++i) {
+    batch.columns_.emplace_back(Column::fromRows(rows, i));
+  }
+  return batch;
+}
+
+DataSet ColumnBatch::toDataSet() const {
+  DataSet ds(colNames_);
+  ds.rows.resize(numRows_);
+  for (auto& row : ds.rows) {
+    row.values.reserve(columns_.size());
+  }
+  for (const auto& col : columns_) {
+    for (size_t i = 0; i < numRows_; ++i) {
+      ds.rows[i].values.emplace_back(col.value(i));
+    }
+  }
+  return ds;
+}
+
+const Column* ColumnBatch::column(const std::string& name) const {
+  for (size_t i = 0; i < colNames_.size(); ++i) {
+    if (colNames_[i] == name) {
+      return &columns_[i];
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace graph
+}  // namespace nebula
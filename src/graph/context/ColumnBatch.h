@@ -0,0 +1,147 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_CONTEXT_COLUMNBATCH_H_
+#define GRAPH_CONTEXT_COLUMNBATCH_H_
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "common/datatypes/DataSet.h"
+#include "common/datatypes/Value.h"
+
+namespace nebula {
+namespace graph {
+
+// A column-major view of a DataSet.
+//
+// Each column keeps its values in a typed vector when all of its non-null
+// values share one scalar type (bool/int/float/string), and plain NULLs are
+// tracked in a null bitmap. Columns with mixed types, EMPTY values, special
+// null kinds (BAD_TYPE, DIV_BY_ZERO...) or composite values fall back to a
+// generic vector of Value, so converting back is always lossless.
+class Column final {
+ public:
+  enum class Kind : uint8_t {
+    kBool,
+    kInt,
+    kFloat,
+    kString,
+    kGeneric,
+  };
+
+  Column() = default;
+  Column(Column&&) = default;
+  Column& operator=(Column&&) = default;
+  Column(const Column&) = default;
+  Column& operator=(const Column&) = default;
+
+  // Build the column from the `colIdx'th value of each row
+  static Column fromRows(const std::vector<Row>& rows, size_t colIdx);
+
+  Kind kind() const {
+    return kind_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool isNull(size_t i) const {
+    return kind_ == Kind::kGeneric ? generic_[i].isNull() : nulls_.test(i);
+  }
+
+  bool hasNull() const {
+    return nulls_.any();
+  }
+
+  // Typed accessors, only valid for the corresponding kind. The slots of
+  // null entries hold a default value.
+  const std::vector<bool>& bools() const {
+    DCHECK(kind_ == Kind::kBool);
+    return bools_;
+  }
+
+  const std::vector<int64_t>& ints() const {
+    DCHECK(kind_ == Kind::kInt);
+    return ints_;
+  }
+
+  const std::vector<double>& floats() const {
+    DCHECK(kind_ == Kind::kFloat);
+    return floats_;
+  }
+
+  const std::vector<std::string>& strs() const {
+    DCHECK(kind_ == Kind::kString);
+    return strs_;
+  }
+
+  const std::vector<Value>& generic() const {
+    DCHECK(kind_ == Kind::kGeneric);
+    return generic_;
+  }
+
+  const boost::dynamic_bitset<>& nulls() const {
+    return nulls_;
+  }
+
+  // Materialize the i'th entry as Value
+  Value value(size_t i) const;
+
+ private:
+  void toGeneric(const std::vector<Row>& rows, size_t colIdx);
+
+  Kind kind_{Kind::kGeneric};
+  size_t size_{0};
+  boost::dynamic_bitset<> nulls_;
+  std::vector<bool> bools_;
+  std::vector<int64_t> ints_;
+  std::vector<double> floats_;
+  std::vector<std::string> strs_;
+  std::vector<Value> generic_;
+};
+
+// A batch of rows stored by column, the columnar counterpart of DataSet.
+class ColumnBatch final {
+ public:
+  ColumnBatch() = default;
+
+  static ColumnBatch fromDataSet(const DataSet& ds);
+
+  static ColumnBatch fromRows(const std::vector<std::string>& colNames,
+                              const std::vector<Row>& rows);
+
+  DataSet toDataSet() const;
+
+  const std::vector<std::string>& colNames() const {
+    return colNames_;
+  }
+
+  size_t numRows() const {
+    return numRows_;
+  }
+
+  size_t numColumns() const {
+    return columns_.size();
+  }
+
+  const Column& column(size_t i) const {
+    DCHECK_LT(i, columns_.size());
+    return columns_[i];
+  }
+
+  // Return nullptr if the column doesn't exist
+  const Column* column(const std::string& name) const;
+
+ private:
+  std::vector<std::string> colNames_;
+  std::vector<Column> columns_;
+  size_t numRows_{0};
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_CONTEXT_COLUMNBATCH_H_
@@ -48,7 +48,13 @@ void ExecutionContext::truncHistory(const std::string& name, size_t numVersionsT
       return;
     }
     // Only keep the latest N values
-    it->second.erase(it->second.begin(), it->second.end() - numVersionsToKeep);
+    auto end = it->second.end() - numVersionsToKeep;
+    if (FLAGS_enable_async_gc) {
+      std::vector<Result> garbage(std::make_move_iterator(it->second.begin()),
+                                  std::make_move_iterator(end));
+      GC::instance().clear(std::move(garbage));
+    }
+    it->second.erase(it->second.begin(), end);
   }
 }
 
@@ -94,5 +100,21 @@ const std::vector<Result>& ExecutionContext::getHistory(const std::string& name)
   }
 }
 
+std::unique_ptr<ExecutionContext> ExecutionContext::copy() const {
+  auto ectx = std::make_unique<ExecutionContext>();
+  for (auto& kv : valueMap_) {
+    auto& hist = ectx->valueMap_[kv.first];
+    hist.reserve(kv.second.size());
+    for (auto& result : kv.second) {
+      hist.emplace_back(ResultBuilder()
+                            .value(Value(result.value()))
+                            .iter(result.iter()->kind())
+                            .state(result.state())
+                            .build());
+    }
+  }
+  return ectx;
+}
+
 }  // namespace graph
 }  // namespace nebula
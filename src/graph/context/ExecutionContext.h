@@ -63,13 +63,16 @@ class ExecutionContext {
 
   void dropResult(const std::string& name);
 
-  // Only keep the last several versions of the Value
+  // Only keep the last several versions of the Value, the others are released like dropResult
   void truncHistory(const std::string& name, size_t numVersionsToKeep);
 
   bool exist(const std::string& name) const {
     return valueMap_.find(name) != valueMap_.end();
   }
 
+  // Deep copy of all the variables, which shares no value with this one
+  std::unique_ptr<ExecutionContext> copy() const;
+
  private:
   friend class QueryInstance;
   Value moveValue(const std::string& name);
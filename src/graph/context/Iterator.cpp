@@ -17,6 +17,15 @@ DECLARE_double(system_memory_high_watermark_ratio);
 namespace nebula {
 namespace graph {
 
+namespace {
+
+uint64_t nextDataSetIndexId() {
+  static std::atomic<uint64_t> id{0};
+  return ++id;
+}
+
+}  // namespace
+
 bool Iterator::hitsSysMemoryHighWatermark() const {
   if (checkMemory_) {
     if (numRowsModN_ >= FLAGS_num_rows_to_check_memory) {
@@ -58,8 +67,8 @@ void GetNeighborsIter::goToFirstEdge() {
     }
     for (currentRow_ = currentDs_->ds->rows.begin(); currentRow_ < currentDs_->ds->rows.end();
          ++currentRow_) {
-      colIdx_ = currentDs_->colLowerBound + 1;
-      while (colIdx_ < currentDs_->colUpperBound && !valid_) {
+      colIdx_ = currentDs_->layout->colLowerBound + 1;
+      while (colIdx_ < currentDs_->layout->colUpperBound && !valid_) {
         const auto& currentCol = currentRow_->operator[](colIdx_);
         if (!currentCol.isList() || currentCol.getList().empty()) {
           ++colIdx_;
@@ -108,23 +117,36 @@ Status GetNeighborsIter::processList(std::shared_ptr<Value> value) {
     ss << "Value type is not list, type: " << value->type();
     return Status::Error(ss.str());
   }
+  // The responses of the storage hosts have the same columns, so the layout is only parsed when
+  // the columns differ from the known ones
+  std::vector<std::shared_ptr<const DataSetLayout>> layouts;
   for (auto& val : value->getList().values) {
     if (UNLIKELY(!val.isDataSet())) {
       return Status::Error("There is a value in list which is not a data set.");
     }
-    auto status = makeDataSetIndex(val.getDataSet());
-    NG_RETURN_IF_ERROR(status);
-    dsIndices_.emplace_back(std::move(status).value());
+    const auto& ds = val.getDataSet();
+    auto found = std::find_if(layouts.begin(), layouts.end(), [&ds](const auto& layout) {
+      return layout->colNames == ds.colNames;
+    });
+    if (found == layouts.end()) {
+      auto status = makeDataSetLayout(ds);
+      NG_RETURN_IF_ERROR(status);
+      layouts.emplace_back(std::move(status).value());
+      found = layouts.end() - 1;
+    }
+    dsIndices_.emplace_back(DataSetIndex{&ds, *found});
   }
   return Status::OK();
 }
 
-StatusOr<GetNeighborsIter::DataSetIndex> GetNeighborsIter::makeDataSetIndex(const DataSet& ds) {
-  DataSetIndex dsIndex;
-  dsIndex.ds = &ds;
-  auto buildResult = buildIndex(&dsIndex);
+StatusOr<std::shared_ptr<const GetNeighborsIter::DataSetLayout>>
+GetNeighborsIter::makeDataSetLayout(const DataSet& ds) {
+  auto layout = std::make_shared<DataSetLayout>();
+  layout->id = nextDataSetIndexId();
+  layout->colNames = ds.colNames;
+  auto buildResult = buildIndex(layout.get());
   NG_RETURN_IF_ERROR(buildResult);
-  return dsIndex;
+  return layout;
 }
 
 bool checkColumnNames(const std::vector<std::string>& colNames) {
@@ -132,19 +154,19 @@ bool checkColumnNames(const std::vector<std::string>& colNames) {
          colNames.back().find("_expr") != 0;
 }
 
-StatusOr<int64_t> GetNeighborsIter::buildIndex(DataSetIndex* dsIndex) {
-  auto& colNames = dsIndex->ds->colNames;
+StatusOr<int64_t> GetNeighborsIter::buildIndex(DataSetLayout* layout) {
+  auto& colNames = layout->colNames;
   if (UNLIKELY(checkColumnNames(colNames))) {
     return Status::Error("Bad column names.");
   }
   int64_t edgeStartIndex = -1;
   for (size_t i = 0; i < colNames.size(); ++i) {
-    dsIndex->colIndices.emplace(colNames[i], i);
+    layout->colIndices.emplace(colNames[i], i);
     auto& colName = colNames[i];
     if (colName.find(nebula::kTag) == 0) {  // "_tag"
-      NG_RETURN_IF_ERROR(buildPropIndex(colName, i, false, dsIndex));
+      NG_RETURN_IF_ERROR(buildPropIndex(colName, i, false, layout));
     } else if (colName.find("_edge") == 0) {
-      NG_RETURN_IF_ERROR(buildPropIndex(colName, i, true, dsIndex));
+      NG_RETURN_IF_ERROR(buildPropIndex(colName, i, true, layout));
       if (edgeStartIndex < 0) {
         edgeStartIndex = i;
       }
@@ -155,15 +177,15 @@ StatusOr<int64_t> GetNeighborsIter::buildIndex(DataSetIndex* dsIndex) {
   if (edgeStartIndex == -1) {
     noEdge_ = true;
   }
-  dsIndex->colLowerBound = edgeStartIndex - 1;
-  dsIndex->colUpperBound = colNames.size() - 1;
+  layout->colLowerBound = edgeStartIndex - 1;
+  layout->colUpperBound = colNames.size() - 1;
   return edgeStartIndex;
 }
 
 Status GetNeighborsIter::buildPropIndex(const std::string& props,
                                         size_t columnId,
                                         bool isEdge,
-                                        DataSetIndex* dsIndex) {
+                                        DataSetLayout* layout) {
   std::vector<std::string> pieces;
   folly::split(":", props, pieces);
   if (UNLIKELY(pieces.size() < 2)) {
@@ -187,11 +209,11 @@ Status GetNeighborsIter::buildPropIndex(const std::string& props,
     if (UNLIKELY(name.empty() || (name[0] != '+' && name[0] != '-'))) {
       return Status::Error("Bad edge name: %s", name.c_str());
     }
-    dsIndex->tagEdgeNameIndices.emplace(columnId, name);
-    dsIndex->edgePropsMap.emplace(name, std::move(propIdx));
+    layout->tagEdgeNameIndices.emplace(columnId, name);
+    layout->edgePropsMap.emplace(name, std::move(propIdx));
   } else {
-    dsIndex->tagEdgeNameIndices.emplace(columnId, name);
-    dsIndex->tagPropsMap.emplace(name, std::move(propIdx));
+    layout->tagEdgeNameIndices.emplace(columnId, name);
+    layout->tagPropsMap.emplace(name, std::move(propIdx));
   }
 
   return Status::OK();
@@ -199,7 +221,7 @@ Status GetNeighborsIter::buildPropIndex(const std::string& props,
 
 bool GetNeighborsIter::valid() const {
   return Iterator::valid() && valid_ && currentDs_ < dsIndices_.end() &&
-         currentRow_ < rowsUpperBound_ && colIdx_ < currentDs_->colUpperBound;
+         currentRow_ < rowsUpperBound_ && colIdx_ < currentDs_->layout->colUpperBound;
 }
 
 void GetNeighborsIter::next() {
@@ -243,7 +265,7 @@ void GetNeighborsIter::next() {
 
     // go to next column
     while (++colIdx_) {
-      if (colIdx_ < currentDs_->colUpperBound) {
+      if (colIdx_ < currentDs_->layout->colUpperBound) {
         const auto& currentCol = currentRow_->operator[](colIdx_);
         if (!currentCol.isList() || currentCol.getList().empty()) {
           continue;
@@ -256,13 +278,13 @@ void GetNeighborsIter::next() {
       }
       // go to next row
       if (++currentRow_ < rowsUpperBound_) {
-        colIdx_ = currentDs_->colLowerBound;
+        colIdx_ = currentDs_->layout->colLowerBound;
         continue;
       }
 
       // go to next dataset
       if (++currentDs_ < dsIndices_.end()) {
-        colIdx_ = currentDs_->colLowerBound;
+        colIdx_ = currentDs_->layout->colLowerBound;
         currentRow_ = currentDs_->ds->begin();
         rowsUpperBound_ = currentDs_->ds->end();
         continue;
@@ -279,7 +301,7 @@ size_t GetNeighborsIter::size() const {
   size_t count = 0;
   for (const auto& dsIdx : dsIndices_) {
     for (const auto& row : dsIdx.ds->rows) {
-      for (const auto& edgeIdx : dsIdx.edgePropsMap) {
+      for (const auto& edgeIdx : dsIdx.layout->edgePropsMap) {
         const auto& cell = row[edgeIdx.second.colIdx];
         if (LIKELY(cell.isList())) {
           count += cell.getList().size();
@@ -328,7 +350,7 @@ const Value& GetNeighborsIter::getColumn(const std::string& col) const {
   if (!valid()) {
     return Value::kNullValue;
   }
-  auto& index = currentDs_->colIndices;
+  auto& index = currentDs_->layout->colIndices;
   auto found = index.find(col);
   if (found == index.end()) {
     return Value::kEmpty;
@@ -343,7 +365,7 @@ const Value& GetNeighborsIter::getColumn(int32_t index) const {
 }
 
 StatusOr<std::size_t> GetNeighborsIter::getColumnIndex(const std::string& col) const {
-  auto& index = currentDs_->colIndices;
+  auto& index = currentDs_->layout->colIndices;
   auto found = index.find(col);
   if (found == index.end()) {
     return Status::Error("Don't exist column `%s'.", col.c_str());
@@ -360,7 +382,7 @@ const Value& GetNeighborsIter::getTagProp(const std::string& tag, const std::str
   size_t propId = 0;
   auto& row = *currentRow_;
   if (tag == "*") {
-    for (auto& index : currentDs_->tagPropsMap) {
+    for (auto& index : currentDs_->layout->tagPropsMap) {
       auto propIndex = index.second.propIndices.find(prop);
       if (propIndex != index.second.propIndices.end()) {
         colId = index.second.colIdx;
@@ -369,6 +391,9 @@ const Value& GetNeighborsIter::getTagProp(const std::string& tag, const std::str
         if (row[colId].empty()) {
           continue;
         }
+        if (row[colId].isStr()) {
+          return decodedTagProp(index.first, index.second, propId, row[colId]);
+        }
         if (!row[colId].isList()) {
           return Value::kNullBadType;
         }
@@ -383,7 +408,7 @@ const Value& GetNeighborsIter::getTagProp(const std::string& tag, const std::str
     }
     return Value::kEmpty;
   } else {
-    auto& tagPropIndices = currentDs_->tagPropsMap;
+    auto& tagPropIndices = currentDs_->layout->tagPropsMap;
     auto index = tagPropIndices.find(tag);
     if (index == tagPropIndices.end()) {
       return Value::kEmpty;
@@ -398,6 +423,9 @@ const Value& GetNeighborsIter::getTagProp(const std::string& tag, const std::str
     if (row[colId].empty()) {
       return Value::kEmpty;
     }
+    if (row[colId].isStr()) {
+      return decodedTagProp(index->first, index->second, propId, row[colId]);
+    }
     if (!row[colId].isList()) {
       return Value::kNullBadType;
     }
@@ -406,6 +434,67 @@ const Value& GetNeighborsIter::getTagProp(const std::string& tag, const std::str
   }
 }
 
+const Value& GetNeighborsIter::decodedTagProp(const std::string& tag,
+                                              const PropIndex& index,
+                                              size_t propId,
+                                              const Value& cell) const {
+  if (tagRowDecoder_ == nullptr) {
+    return Value::kNullBadType;
+  }
+  auto& props = decodedTags_[&cell];
+  if (props.empty()) {
+    props.values.resize(index.propList.size());
+  }
+  auto& val = props.values[propId];
+  if (val.empty()) {
+    const auto& prop = index.propList[propId];
+    if (prop == nebula::kVid) {
+      val = getColumn(nebula::kVid);
+    } else {
+      val = tagRowDecoder_->decode(tag, prop, cell.getStr());
+    }
+  }
+  return val;
+}
+
+const Value& GetNeighborsIter::getTagPropBySlot(const std::string& tag,
+                                                const std::string& prop,
+                                                PropSlot* slot) const {
+  if (!valid() || tag == "*") {
+    return getTagProp(tag, prop);
+  }
+  if (slot->resultId != currentDs_->layout->id) {
+    slot->resultId = currentDs_->layout->id;
+    slot->exists = false;
+    auto index = currentDs_->layout->tagPropsMap.find(tag);
+    if (index != currentDs_->layout->tagPropsMap.end()) {
+      auto propIndex = index->second.propIndices.find(prop);
+      if (propIndex != index->second.propIndices.end()) {
+        slot->exists = true;
+        slot->col = index->second.colIdx;
+        slot->prop = propIndex->second;
+      }
+    }
+  }
+  if (!slot->exists) {
+    return Value::kEmpty;
+  }
+  auto& row = *currentRow_;
+  DCHECK_GT(row.size(), slot->col);
+  auto& val = row[slot->col];
+  if (val.empty()) {
+    return Value::kEmpty;
+  }
+  if (val.isStr()) {
+    // The props of the encoded row are decoded by their names
+    return getTagProp(tag, prop);
+  }
+  if (!val.isList()) {
+    return Value::kNullBadType;
+  }
+  return val.getList().values[slot->prop];
+}
+
 const Value& GetNeighborsIter::getEdgeProp(const std::string& edge, const std::string& prop) const {
   if (!valid()) {
     return Value::kNullValue;
@@ -420,8 +509,8 @@ const Value& GetNeighborsIter::getEdgeProp(const std::string& edge, const std::s
     VLOG(1) << "Current edge: " << currentEdgeName() << " Wanted: " << edge;
     return Value::kEmpty;
   }
-  auto index = currentDs_->edgePropsMap.find(currentEdge);
-  if (index == currentDs_->edgePropsMap.end()) {
+  auto index = currentDs_->layout->edgePropsMap.find(currentEdge);
+  if (index == currentDs_->layout->edgePropsMap.end()) {
     VLOG(1) << "No edge found: " << edge;
     VLOG(1) << "Current edge: " << currentEdge;
     return Value::kEmpty;
@@ -446,11 +535,24 @@ Value GetNeighborsIter::getVertex(const std::string& name) const {
   }
   Vertex vertex;
   vertex.vid = vidVal;
-  auto& tagPropMap = currentDs_->tagPropsMap;
+  auto& tagPropMap = currentDs_->layout->tagPropsMap;
   for (auto& tagProp : tagPropMap) {
     auto& row = *currentRow_;
     auto& tagPropNameList = tagProp.second.propList;
     auto tagColId = tagProp.second.colIdx;
+    if (row[tagColId].isStr()) {
+      Tag tag;
+      tag.name = tagProp.first;
+      for (size_t i = 0; i < tagPropNameList.size(); ++i) {
+        if (tagPropNameList[i] == nebula::kTag) {
+          continue;
+        }
+        tag.props.emplace(tagPropNameList[i],
+                          decodedTagProp(tagProp.first, tagProp.second, i, row[tagColId]));
+      }
+      vertex.tags.emplace_back(std::move(tag));
+      continue;
+    }
     if (UNLIKELY(!row[tagColId].isList())) {
       // Ignore the bad value.
       continue;
@@ -525,7 +627,7 @@ Value GetNeighborsIter::getEdge() const {
   }
   edge.ranking = rank.getInt();
 
-  auto& edgePropMap = currentDs_->edgePropsMap;
+  auto& edgePropMap = currentDs_->layout->edgePropsMap;
   auto edgeProp = edgePropMap.find(currentEdgeName());
   if (edgeProp == edgePropMap.end()) {
     return Value::kNullValue;
@@ -549,7 +651,7 @@ List GetNeighborsIter::getEdges() {
   for (; valid(); next()) {
     auto edge = getEdge();
     if (edge.isEdge()) {
-      const_cast<Edge&>(edge.getEdge()).format();
+      edge.mutableEdge().format();
     }
     edges.values.emplace_back(std::move(edge));
   }
@@ -565,7 +667,7 @@ void GetNeighborsIter::nextCol() {
 
   // go to next column
   while (++colIdx_) {
-    if (colIdx_ < currentDs_->colUpperBound) {
+    if (colIdx_ < currentDs_->layout->colUpperBound) {
       const auto& currentCol = currentRow_->operator[](colIdx_);
       if (!currentCol.isList() || currentCol.getList().empty()) {
         continue;
@@ -578,13 +680,13 @@ void GetNeighborsIter::nextCol() {
     }
     // go to next row
     if (++currentRow_ < rowsUpperBound_) {
-      colIdx_ = currentDs_->colLowerBound;
+      colIdx_ = currentDs_->layout->colLowerBound;
       continue;
     }
 
     // go to next dataset
     if (++currentDs_ < dsIndices_.end()) {
-      colIdx_ = currentDs_->colLowerBound;
+      colIdx_ = currentDs_->layout->colLowerBound;
       currentRow_ = currentDs_->ds->begin();
       rowsUpperBound_ = currentDs_->ds->end();
       continue;
@@ -665,10 +767,12 @@ void SequentialIter::next() {
 }
 
 void SequentialIter::erase() {
+  batch_.reset();
   iter_ = rows_->erase(iter_);
 }
 
 void SequentialIter::unstableErase() {
+  batch_.reset();
   std::swap(rows_->back(), *iter_);
   rows_->pop_back();
 }
@@ -677,6 +781,7 @@ void SequentialIter::eraseRange(size_t first, size_t last) {
   if (first >= last || first >= size()) {
     return;
   }
+  batch_.reset();
   if (last > size()) {
     rows_->erase(rows_->begin() + first, rows_->end());
   } else {
@@ -685,6 +790,33 @@ void SequentialIter::eraseRange(size_t first, size_t last) {
   reset();
 }
 
+void SequentialIter::markErased() {
+  if (erased_.empty()) {
+    erased_.resize(rows_->size(), false);
+  }
+  erased_[iter_ - rows_->begin()] = true;
+  next();
+}
+
+void SequentialIter::compact() {
+  if (!erased_.empty()) {
+    DCHECK_EQ(erased_.size(), rows_->size());
+    batch_.reset();
+    size_t kept = 0;
+    for (size_t i = 0; i < erased_.size(); ++i) {
+      if (!erased_[i]) {
+        if (kept != i) {
+          (*rows_)[kept] = std::move((*rows_)[i]);
+        }
+        ++kept;
+      }
+    }
+    rows_->erase(rows_->begin() + kept, rows_->end());
+    erased_.clear();
+  }
+  reset();
+}
+
 void SequentialIter::doReset(size_t pos) {
   DCHECK((pos == 0 && size() == 0) || (pos < size()));
   iter_ = rows_->begin() + pos;
@@ -716,6 +848,27 @@ StatusOr<std::size_t> SequentialIter::getColumnIndex(const std::string& col) con
   return index->second;
 }
 
+std::shared_ptr<const ColumnBatch> SequentialIter::columnBatch() const {
+  if (batch_ == nullptr) {
+    std::vector<std::string> colNames;
+    const auto& ds = value_->getDataSet();
+    if (!ds.colNames.empty()) {
+      colNames = ds.colNames;
+    } else {
+      // The union iterators don't keep column names in the dataset
+      colNames.resize(colIndices_.size());
+      for (const auto& col : colIndices_) {
+        if (col.second >= colNames.size()) {
+          colNames.resize(col.second + 1);
+        }
+        colNames[col.second] = col.first;
+      }
+    }
+    batch_ = std::make_shared<const ColumnBatch>(ColumnBatch::fromRows(colNames, *rows_));
+  }
+  return batch_;
+}
+
 Value SequentialIter::getVertex(const std::string& name) const {
   return getColumn(name);
 }
@@ -744,6 +897,7 @@ PropIter::PropIter(std::shared_ptr<Value> value, bool checkMemory)
 
 Status PropIter::makeDataSetIndex(const DataSet& ds) {
   dsIndex_.ds = &ds;
+  dsIndex_.id = nextDataSetIndexId();
   auto& colNames = ds.colNames;
   for (size_t i = 0; i < colNames.size(); ++i) {
     dsIndex_.colIndices.emplace(colNames[i], i);
@@ -833,21 +987,41 @@ const Value& PropIter::getProp(const std::string& name, const std::string& prop)
   }
 }
 
-Value PropIter::getVertex(const std::string& name) const {
-  UNUSED(name);
-  if (!valid()) {
-    return Value::kNullValue;
+const Value& PropIter::getTagPropBySlot(const std::string& tag,
+                                        const std::string& prop,
+                                        PropSlot* slot) const {
+  if (!valid() || tag == "*") {
+    return getProp(tag, prop);
+  }
+  if (slot->resultId != dsIndex_.id) {
+    slot->resultId = dsIndex_.id;
+    slot->exists = false;
+    auto index = dsIndex_.propsMap.find(tag);
+    if (index != dsIndex_.propsMap.end()) {
+      auto propIndex = index->second.find(prop);
+      if (propIndex != index->second.end()) {
+        slot->exists = true;
+        slot->col = propIndex->second;
+      }
+    }
   }
+  if (!slot->exists) {
+    // Not found, which is empty or null
+    return getProp(tag, prop);
+  }
+  DCHECK_GT(iter_->size(), slot->col);
+  return (*iter_)[slot->col];
+}
 
-  auto vidVal = getColumn(nebula::kVid);
-  if (!SchemaUtil::isValidVid(vidVal)) {
+// Build the vertex of the row, whose properties are moved if the row is mutable
+template <typename PropsMap, typename R>
+static Value buildVertex(const Value& vid, const PropsMap& tagPropsMap, R& row) {
+  if (!SchemaUtil::isValidVid(vid)) {
     return Value::kNullValue;
   }
   Vertex vertex;
-  vertex.vid = vidVal;
-  auto& tagPropsMap = dsIndex_.propsMap;
+  vertex.vid = vid;
   bool isVertexProps = true;
-  auto& row = *iter_;
   // tagPropsMap -> <std::string, std::unordered_map<std::string, size_t> >
   for (auto& tagProp : tagPropsMap) {
     // propIndex -> std::unordered_map<std::string, size_t>
@@ -867,8 +1041,10 @@ Value PropIter::getVertex(const std::string& name) const {
     for (auto& propIndex : tagProp.second) {
       if (propIndex.first == nebula::kTag) {  // "_tag"
         continue;
-      } else {
+      } else if constexpr (std::is_const_v<R>) {
         tag.props.emplace(propIndex.first, row[propIndex.second]);
+      } else {
+        tag.props.emplace(propIndex.first, std::move(row.values[propIndex.second]));
       }
     }
     vertex.tags.emplace_back(std::move(tag));
@@ -876,6 +1052,24 @@ Value PropIter::getVertex(const std::string& name) const {
   return Value(std::move(vertex));
 }
 
+Value PropIter::getVertex(const std::string& name) const {
+  UNUSED(name);
+  if (!valid()) {
+    return Value::kNullValue;
+  }
+  const auto& row = *iter_;
+  return buildVertex(getColumn(nebula::kVid), dsIndex_.propsMap, row);
+}
+
+Value PropIter::moveVertex() {
+  if (!valid()) {
+    return Value::kNullValue;
+  }
+  // The vid is copied since it's not a property of any tag
+  auto vid = getColumn(nebula::kVid);
+  return buildVertex(vid, dsIndex_.propsMap, *iter_);
+}
+
 Value PropIter::getEdge() const {
   if (!valid()) {
     return Value::kNullValue;
@@ -952,7 +1146,7 @@ List PropIter::getEdges() {
   for (; valid(); next()) {
     auto edge = getEdge();
     if (edge.isEdge()) {
-      const_cast<Edge&>(edge.getEdge()).format();
+      edge.mutableEdge().format();
     }
     edges.values.emplace_back(std::move(edge));
   }
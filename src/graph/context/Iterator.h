@@ -14,6 +14,8 @@
 #include "common/datatypes/DataSet.h"
 #include "common/datatypes/List.h"
 #include "common/datatypes/Value.h"
+#include "graph/context/ColumnBatch.h"
+#include "graph/context/TagRowDecoder.h"
 #include "parser/TraverseSentences.h"
 
 namespace nebula {
@@ -65,6 +67,19 @@ class Iterator {
   // Warning this will break the origin order of elements!
   virtual void unstableErase() = 0;
 
+  // Mark the current row erased and move to the next one. The marked rows are removed together by
+  // compact(), which keeps the order and moves each kept row at most once, instead of shifting or
+  // swapping the rows by each erase. The rows stay where they are until then, so the pointers to
+  // them are still valid. Don't mix it with the other ways of erasing before compact().
+  virtual void markErased() {
+    erase();
+  }
+
+  // Remove the rows marked erased, and reset the iterator
+  virtual void compact() {
+    reset();
+  }
+
   // remain the select data in range
   virtual void select(std::size_t offset, std::size_t count) = 0;
 
@@ -75,6 +90,12 @@ class Iterator {
 
   virtual Row moveRow() = 0;
 
+  // Take the value of the column out of the current row, the caller must own the iterated value
+  // exclusively. It's copied if the iterator could not hand out the values of its rows.
+  virtual Value moveColumn(int32_t index) {
+    return getColumn(index);
+  }
+
   // erase range, no include last position, if last > size(), erase to the end
   // position
   virtual void eraseRange(size_t first, size_t last) = 0;
@@ -140,6 +161,15 @@ class Iterator {
     return Value::kEmpty;
   }
 
+  // The same as getTagProp, but the position of the property is resolved by the names once for
+  // a dataset and cached in the slot, instead of looking up them for each row
+  virtual const Value& getTagPropBySlot(const std::string& tag,
+                                        const std::string& prop,
+                                        PropSlot* slot) const {
+    UNUSED(slot);
+    return getTagProp(tag, prop);
+  }
+
   virtual const Value& getEdgeProp(const std::string&, const std::string&) const {
     DLOG(FATAL) << "Shouldn't call the unimplemented method";
     return Value::kEmpty;
@@ -258,10 +288,17 @@ class GetNeighborsIter final : public Iterator {
 
   std::unique_ptr<Iterator> copy() const override {
     auto copy = std::make_unique<GetNeighborsIter>(*this);
+    copy->decodedTags_.clear();
     copy->reset();
     return copy;
   }
 
+  // The tag props of the encoded rows in the responses are decoded by it when they are read, see
+  // encoded_rows of RequestCommon
+  void setTagRowDecoder(std::shared_ptr<const TagRowDecoder> decoder) {
+    tagRowDecoder_ = std::move(decoder);
+  }
+
   bool valid() const override;
 
   void next() override;
@@ -317,6 +354,10 @@ class GetNeighborsIter final : public Iterator {
 
   const Value& getTagProp(const std::string& tag, const std::string& prop) const override;
 
+  const Value& getTagPropBySlot(const std::string& tag,
+                                const std::string& prop,
+                                PropSlot* slot) const override;
+
   const Value& getEdgeProp(const std::string& edge, const std::string& prop) const override;
 
   Value getVertex(const std::string& name = "") const override;
@@ -348,8 +389,9 @@ class GetNeighborsIter final : public Iterator {
   }
 
   inline const std::string& currentEdgeName() const {
-    DCHECK(currentDs_->tagEdgeNameIndices.find(colIdx_) != currentDs_->tagEdgeNameIndices.end());
-    return currentDs_->tagEdgeNameIndices.find(colIdx_)->second;
+    const auto& names = currentDs_->layout->tagEdgeNameIndices;
+    DCHECK(names.find(colIdx_) != names.end());
+    return names.find(colIdx_)->second;
   }
 
   bool colValid() {
@@ -367,8 +409,12 @@ class GetNeighborsIter final : public Iterator {
     std::unordered_map<std::string, size_t> propIndices;
   };
 
-  struct DataSetIndex {
-    const DataSet* ds;
+  // The columns of a response, which are the same in the responses of a request, so it's parsed
+  // once and shared by them
+  struct DataSetLayout {
+    // Unique in the process, to identify the layout the slots are resolved in
+    uint64_t id{0};
+    std::vector<std::string> colNames;
     // | _vid | _stats | _tag:t1:p1:p2 | _edge:e1:p1:p2 |
     // -> {_vid : 0, _stats : 1, _tag:t1:p1:p2 : 2, _edge:d1:p1:p2 : 3}
     std::unordered_map<std::string, size_t> colIndices;
@@ -384,20 +430,34 @@ class GetNeighborsIter final : public Iterator {
     int64_t colUpperBound{-1};
   };
 
+  struct DataSetIndex {
+    const DataSet* ds;
+    std::shared_ptr<const DataSetLayout> layout;
+  };
+
   Status processList(std::shared_ptr<Value> value);
 
   void goToFirstEdge();
 
-  StatusOr<int64_t> buildIndex(DataSetIndex* dsIndex);
+  StatusOr<int64_t> buildIndex(DataSetLayout* layout);
 
   Status buildPropIndex(const std::string& props,
                         size_t columnId,
                         bool isEdge,
-                        DataSetIndex* dsIndex);
+                        DataSetLayout* layout);
+
+  StatusOr<std::shared_ptr<const DataSetLayout>> makeDataSetLayout(const DataSet& ds);
 
-  StatusOr<DataSetIndex> makeDataSetIndex(const DataSet& ds);
+  // The prop of the tag in the cell of an encoded row, it's decoded on the first read and kept
+  // along with the other props of the cell read
+  const Value& decodedTagProp(const std::string& tag,
+                              const PropIndex& index,
+                              size_t propId,
+                              const Value& cell) const;
 
   FRIEND_TEST(IteratorTest, TestHead);
+  FRIEND_TEST(IteratorTest, SharedLayout);
+  FRIEND_TEST(IteratorTest, EncodedTagRows);
 
   bool valid_{false};
   std::vector<DataSetIndex> dsIndices_;
@@ -417,6 +477,10 @@ class GetNeighborsIter final : public Iterator {
 
   boost::dynamic_bitset<> bitset_;
   int64_t bitIdx_{-1};
+
+  std::shared_ptr<const TagRowDecoder> tagRowDecoder_;
+  // The cell of an encoded row => the props of it, which are empty until they are decoded
+  mutable std::unordered_map<const Value*, List> decodedTags_;
 };
 
 class SequentialIter : public Iterator {
@@ -445,6 +509,10 @@ class SequentialIter : public Iterator {
 
   void eraseRange(size_t first, size_t last) override;
 
+  void markErased() override;
+
+  void compact() override;
+
   void select(std::size_t offset, std::size_t count) override {
     auto size = this->size();
     if (size <= static_cast<size_t>(offset)) {
@@ -465,10 +533,12 @@ class SequentialIter : public Iterator {
     }
     *rows_ = std::move(sampler).samples();
     iter_ = rows_->begin();
+    batch_.reset();
   }
 
   void clear() override {
     rows_->clear();
+    batch_.reset();
     reset();
   }
 
@@ -502,6 +572,16 @@ class SequentialIter : public Iterator {
     return std::move(*iter_);
   }
 
+  Value moveColumn(int32_t index) override {
+    DCHECK_LT(static_cast<size_t>(index), iter_->values.size());
+    return std::move(iter_->values[index]);
+  }
+
+  // Columnar view of the remaining rows, built lazily and cached until the rows
+  // are erased through this iterator. Rows modified through other iterators
+  // sharing the same value are not tracked.
+  std::shared_ptr<const ColumnBatch> columnBatch() const;
+
  protected:
   const Row* row() const override {
     return &*iter_;
@@ -522,6 +602,9 @@ class SequentialIter : public Iterator {
   void init(std::vector<std::unique_ptr<Iterator>>&& iterators);
 
   std::unordered_map<std::string, size_t> colIndices_;
+  mutable std::shared_ptr<const ColumnBatch> batch_;
+  // The rows marked erased, empty if none
+  std::vector<bool> erased_;
 };
 
 class PropIter final : public SequentialIter {
@@ -547,6 +630,10 @@ class PropIter final : public SequentialIter {
 
   Value getVertex(const std::string& name = "") const override;
 
+  // Same as getVertex(), but the properties are moved out of the current row, the caller must own
+  // the iterated value exclusively
+  Value moveVertex();
+
   Value getEdge() const override;
 
   List getVertices();
@@ -559,6 +646,10 @@ class PropIter final : public SequentialIter {
     return getProp(tag, prop);
   }
 
+  const Value& getTagPropBySlot(const std::string& tag,
+                                const std::string& prop,
+                                PropSlot* slot) const override;
+
   const Value& getEdgeProp(const std::string& edge, const std::string& prop) const override {
     return getProp(edge, prop);
   }
@@ -570,6 +661,8 @@ class PropIter final : public SequentialIter {
 
   struct DataSetIndex {
     const DataSet* ds;
+    // Unique in the process, to identify the layout the slots are resolved in
+    uint64_t id{0};
     // vertex | _vid | tag1.prop1 | tag1.prop2 | tag2,prop1 | tag2,prop2 | ...
     //        |_vid : 0 | tag1.prop1 : 1 | tag1.prop2 : 2 | tag2.prop1 : 3 |...
     // edge   |_src | _type| _ranking | _dst | edge1.prop1 | edge1.prop2 |...
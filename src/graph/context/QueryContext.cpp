@@ -5,6 +5,8 @@
 
 #include "graph/context/QueryContext.h"
 
+#include "graph/service/GraphFlags.h"
+
 namespace nebula {
 namespace graph {
 
@@ -30,6 +32,9 @@ QueryContext::QueryContext() {
 void QueryContext::init() {
   objPool_ = std::make_unique<ObjectPool>();
   ep_ = std::make_unique<ExecutionPlan>();
+  initMemTracker();
+  initTimeout();
+  initResourceGroup();
   ectx_ = std::make_unique<ExecutionContext>();
   // copy parameterMap into ExecutionContext
   if (rctx_) {
@@ -42,5 +47,106 @@ void QueryContext::init() {
   vctx_ = std::make_unique<ValidateContext>(std::make_unique<AnonVarGenerator>(symTable_.get()));
 }
 
+void QueryContext::initMemTracker() {
+  auto parentTracker = MemoryTracker::process();
+  if (rctx_ != nullptr && rctx_->session() != nullptr) {
+    parentTracker = rctx_->session()->memTracker();
+  }
+  memTracker_ = std::make_shared<MemoryTracker>(folly::sformat("query {}", ep_->id()),
+                                                FLAGS_query_memory_limit_mb * 1024 * 1024,
+                                                std::move(parentTracker));
+}
+
+void QueryContext::initTimeout() {
+  timeoutMs_ = FLAGS_query_timeout_ms;
+  if (rctx_ != nullptr && rctx_->session() != nullptr) {
+    auto session = rctx_->session()->getSession();
+    auto& configs = session.get_configs();
+    auto iter = configs.find("query_timeout_ms");
+    if (iter != configs.end() && iter->second.isInt()) {
+      timeoutMs_ = iter->second.getInt();
+    }
+  }
+}
+
+void QueryContext::initResourceGroup() {
+  resourceGroup_ = FLAGS_storage_resource_group;
+  if (rctx_ != nullptr && rctx_->session() != nullptr) {
+    auto session = rctx_->session()->getSession();
+    auto& configs = session.get_configs();
+    auto iter = configs.find("resource_group");
+    if (iter != configs.end() && iter->second.isStr()) {
+      resourceGroup_ = iter->second.getStr();
+    }
+  }
+}
+
+int64_t QueryContext::remainingTimeMs() const {
+  if (timeoutMs_ <= 0 || rctx_ == nullptr) {
+    return 0;
+  }
+  auto remaining = timeoutMs_ - static_cast<int64_t>(rctx_->duration().elapsedInMSec());
+  // 0 is no timeout
+  return remaining == 0 ? -1 : remaining;
+}
+
+std::function<void()> QueryContext::markKilled() {
+  if (killed_.exchange(true)) {
+    return nullptr;
+  }
+  auto space = storageSpace_.load(std::memory_order_acquire);
+  if (space == kInvalidSpaceID || storageClient_ == nullptr) {
+    return nullptr;
+  }
+  // The query context may be gone by the time it's called
+  return [storageClient = storageClient_,
+          space,
+          session = storageSession_.load(std::memory_order_relaxed),
+          plan = ep_->id()]() { storageClient->killPlan(space, session, plan); };
+}
+
+void QueryContext::keepPlan(std::unique_ptr<Sentence> sentence) {
+  DCHECK(!planKept());
+  planSentence_ = std::move(sentence);
+  planEctx_ = ectx_->copy();
+  // The symbol table and the validate context refer to the pool, which is kept as it is
+  planPool_ = std::move(objPool_);
+  planPoolSize_ = planPool_->size();
+  objPool_ = std::make_unique<ObjectPool>();
+}
+
+void QueryContext::clearRequest() {
+  DCHECK(planKept());
+  // The executors and the results of the last run go first
+  objPool_ = std::make_unique<ObjectPool>();
+  ectx_.reset();
+  memTracker_.reset();
+  rctx_.reset();
+}
+
+void QueryContext::reset(RequestContextPtr rctx) {
+  DCHECK(planKept());
+  rctx_ = std::move(rctx);
+  initMemTracker();
+  initTimeout();
+  initResourceGroup();
+  ectx_ = planEctx_->copy();
+  symTable_->resetUserCount();
+  killed_.store(false);
+  storageSpace_.store(kInvalidSpaceID);
+  resourceUsage_.reset();
+}
+
+void QueryContext::bindConstantInput(const std::vector<Value>& vids) {
+  DCHECK_EQ(constantInputs_.size(), 1UL);
+  DataSet ds;
+  ds.colNames.emplace_back(kVid);
+  ds.rows.reserve(vids.size());
+  for (auto& vid : vids) {
+    ds.rows.emplace_back(Row({vid}));
+  }
+  ectx_->setResult(constantInputs_.front(), ResultBuilder().value(Value(std::move(ds))).build());
+}
+
 }  // namespace graph
 }  // namespace nebula
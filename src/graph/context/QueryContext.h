@@ -12,9 +12,12 @@
 #include "common/charset/Charset.h"
 #include "common/cpp/helpers.h"
 #include "common/datatypes/Value.h"
+#include "common/memory/MemoryTracker.h"
 #include "common/meta/IndexManager.h"
 #include "common/meta/SchemaManager.h"
+#include "common/tracing/Tracing.h"
 #include "graph/context/ExecutionContext.h"
+#include "graph/context/QueryResourceUsage.h"
 #include "graph/context/Symbols.h"
 #include "graph/context/ValidateContext.h"
 #include "graph/service/RequestContext.h"
@@ -128,21 +131,102 @@ class QueryContext {
     rctx_->resp().errorCode = ErrorCode::E_PARTIAL_SUCCEEDED;
   }
 
-  void markKilled() {
-    killed_.exchange(true);
-  }
+  // Return the call telling storage to give up the requests of the query, empty if none is sent or
+  // the query has been killed. It's called once the lock of the session is released.
+  std::function<void()> markKilled();
 
   bool isKilled() const {
     return killed_.load();
   }
 
+  // The time left of the query in milliseconds, 0 if the query has no timeout, and negative if it
+  // has timed out
+  int64_t remainingTimeMs() const;
+
+  bool isTimedOut() const {
+    return remainingTimeMs() < 0;
+  }
+
+  int64_t timeoutMs() const {
+    return timeoutMs_;
+  }
+
+  // The resource group of storaged to run the reads of the query, empty means the group of the
+  // space
+  const std::string& resourceGroup() const {
+    return resourceGroup_;
+  }
+
+  // Record the storage requests sent, so that storage is told when the query is killed
+  void onStorageRequest(GraphSpaceID space, SessionID session) {
+    storageSession_.store(session, std::memory_order_relaxed);
+    storageSpace_.store(space, std::memory_order_release);
+  }
+
+  // The memory tracker of the query, whose parent is the one of the session
+  const std::shared_ptr<MemoryTracker>& memTracker() const {
+    return memTracker_;
+  }
+
+  // The resources used by the query, shown in SHOW QUERIES and the slow query log
+  QueryResourceUsage& resourceUsage() {
+    return resourceUsage_;
+  }
+
+  // The span of the query, whose children are the spans of the executors
+  const tracing::SpanRef& traceSpan() const {
+    return traceSpan_;
+  }
+
+  void setTraceSpan(tracing::SpanRef span) {
+    traceSpan_ = std::move(span);
+  }
+
   bool existParameter(const std::string& param) const {
     return ectx_->exist(param) && (ectx_->getValue(param).type() != Value::Type::DATASET);
   }
 
+  // Keep the compiled plan, and the sentence it's compiled from, apart from the objects made at
+  // runtime, so that the plan could be run again for other requests, see PlanCache
+  void keepPlan(std::unique_ptr<Sentence> sentence);
+
+  bool planKept() const {
+    return planPool_ != nullptr;
+  }
+
+  // Whether the kept plan has grown too much to keep it. The expressions of the plan are cloned
+  // into the pool they're made in, i.e. the kept one, while running, e.g. by the filters.
+  bool planGrown() const {
+    return planPool_->size() > 2 * planPoolSize_;
+  }
+
+  // Drop all the states of the finished request except the kept plan
+  void clearRequest();
+
+  // Run the kept plan again for the request
+  void reset(RequestContextPtr rctx);
+
+  // Record the variable of the start vids given as the constants, which are set while planning
+  void addConstantInput(const std::string& var) {
+    constantInputs_.emplace_back(var);
+  }
+
+  const std::vector<std::string>& constantInputs() const {
+    return constantInputs_;
+  }
+
+  // Replace the vids of the only constant input, so that the kept plan runs from the other vids
+  void bindConstantInput(const std::vector<Value>& vids);
+
  private:
   void init();
 
+  void initMemTracker();
+
+  void initTimeout();
+
+  void initResourceGroup();
+
   RequestContextPtr rctx_;
   std::unique_ptr<ValidateContext> vctx_;
   std::unique_ptr<ExecutionContext> ectx_;
@@ -152,6 +236,15 @@ class QueryContext {
   storage::StorageClient* storageClient_{nullptr};
   meta::MetaClient* metaClient_{nullptr};
   CharsetInfo* charsetInfo_{nullptr};
+  std::shared_ptr<MemoryTracker> memTracker_;
+
+  // The objects of the kept plan, which are made before keepPlan()
+  std::unique_ptr<ObjectPool> planPool_;
+  size_t planPoolSize_{0};
+  // The variables set while planning, copied for each run of the kept plan
+  std::unique_ptr<ExecutionContext> planEctx_;
+  std::unique_ptr<Sentence> planSentence_;
+  std::vector<std::string> constantInputs_;
 
   // The Object Pool holds all internal generated objects.
   // e.g. expressions, plan nodes, executors
@@ -160,6 +253,15 @@ class QueryContext {
   std::unique_ptr<SymbolTable> symTable_;
 
   std::atomic<bool> killed_{false};
+  // The query is timed out after it since the request arrives, 0 means no limit
+  int64_t timeoutMs_{0};
+  std::string resourceGroup_;
+  // The space and the session of the storage requests sent, kept apart from the session, which
+  // is locked when the query is killed
+  std::atomic<GraphSpaceID> storageSpace_{kInvalidSpaceID};
+  std::atomic<SessionID> storageSession_{0};
+  tracing::SpanRef traceSpan_;
+  QueryResourceUsage resourceUsage_;
 };
 
 }  // namespace graph
@@ -44,6 +44,15 @@ Value QueryExpressionContext::getTagProp(const std::string& tag, const std::stri
   return iter_->getTagProp(tag, prop);
 }
 
+Value QueryExpressionContext::getTagPropBySlot(const std::string& tag,
+                                               const std::string& prop,
+                                               PropSlot* slot) const {
+  if (iter_ == nullptr) {
+    return Value::kEmpty;
+  }
+  return iter_->getTagPropBySlot(tag, prop, slot);
+}
+
 Value QueryExpressionContext::getEdgeProp(const std::string& edge, const std::string& prop) const {
   if (iter_ == nullptr) {
     return Value::kEmpty;
@@ -37,6 +37,10 @@ class QueryExpressionContext final : public ExpressionContext {
   // Get the specified property from the tag, such as tag.prop_name
   Value getTagProp(const std::string& tag, const std::string& prop) const override;
 
+  Value getTagPropBySlot(const std::string& tag,
+                         const std::string& prop,
+                         PropSlot* slot) const override;
+
   // Get the specified property from the edge, such as edge_type.prop_name
   Value getEdgeProp(const std::string& edge, const std::string& prop) const override;
 
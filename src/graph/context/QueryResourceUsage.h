@@ -0,0 +1,108 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_CONTEXT_QUERYRESOURCEUSAGE_H_
+#define GRAPH_CONTEXT_QUERYRESOURCEUSAGE_H_
+
+#include <folly/dynamic.h>
+#include <time.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "interface/gen-cpp2/meta_types.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * @brief The resources used by a query, which are added by the executors running in parallel.
+ * The counters are only added at the boundaries of executors and storage requests, so the
+ * accounting is cheap enough to be always on.
+ */
+class QueryResourceUsage final {
+ public:
+  // The CPU time consumed by this thread in microseconds
+  static int64_t threadCpuTimeUs() {
+    struct timespec ts;
+    if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+      return 0;
+    }
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+  }
+
+  void addCpuTime(int64_t us) {
+    cpuTimeUs_.fetch_add(us, std::memory_order_relaxed);
+  }
+
+  void addStorageRpcs(int64_t rpcs, int64_t responseBytes) {
+    storageRpcs_.fetch_add(rpcs, std::memory_order_relaxed);
+    storageResponseBytes_.fetch_add(responseBytes, std::memory_order_relaxed);
+  }
+
+  void addRowsScanned(int64_t rows) {
+    rowsScanned_.fetch_add(rows, std::memory_order_relaxed);
+  }
+
+  void addStageDuration(const std::string& stage, int64_t us) {
+    std::lock_guard<std::mutex> guard(stagesLock_);
+    stageDurationUs_[stage] += us;
+  }
+
+  int64_t cpuTimeUs() const {
+    return cpuTimeUs_.load(std::memory_order_relaxed);
+  }
+
+  meta::cpp2::QueryResources toThrift(int64_t peakMemory) const {
+    meta::cpp2::QueryResources resources;
+    resources.cpu_time_us_ref() = cpuTimeUs_.load(std::memory_order_relaxed);
+    resources.peak_memory_in_bytes_ref() = peakMemory;
+    resources.storage_rpcs_ref() = storageRpcs_.load(std::memory_order_relaxed);
+    resources.storage_response_bytes_ref() = storageResponseBytes_.load(std::memory_order_relaxed);
+    resources.rows_scanned_ref() = rowsScanned_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> guard(stagesLock_);
+    resources.stage_duration_us_ref() = stageDurationUs_;
+    return resources;
+  }
+
+  static folly::dynamic toJson(const meta::cpp2::QueryResources& resources) {
+    folly::dynamic stages = folly::dynamic::object();
+    for (const auto& stage : resources.get_stage_duration_us()) {
+      stages[stage.first] = stage.second;
+    }
+    folly::dynamic json = folly::dynamic::object();
+    json["cpu_time_us"] = resources.get_cpu_time_us();
+    json["peak_memory_in_bytes"] = resources.get_peak_memory_in_bytes();
+    json["storage_rpcs"] = resources.get_storage_rpcs();
+    json["storage_response_bytes"] = resources.get_storage_response_bytes();
+    json["rows_scanned"] = resources.get_rows_scanned();
+    json["stage_duration_us"] = std::move(stages);
+    return json;
+  }
+
+  // Clear the usage for the next run of a kept plan
+  void reset() {
+    cpuTimeUs_.store(0, std::memory_order_relaxed);
+    storageRpcs_.store(0, std::memory_order_relaxed);
+    storageResponseBytes_.store(0, std::memory_order_relaxed);
+    rowsScanned_.store(0, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> guard(stagesLock_);
+    stageDurationUs_.clear();
+  }
+
+ private:
+  std::atomic<int64_t> cpuTimeUs_{0};
+  std::atomic<int64_t> storageRpcs_{0};
+  std::atomic<int64_t> storageResponseBytes_{0};
+  std::atomic<int64_t> rowsScanned_{0};
+  mutable std::mutex stagesLock_;
+  std::map<std::string, int64_t> stageDurationUs_;
+};
+
+}  // namespace graph
+}  // namespace nebula
+#endif  // GRAPH_CONTEXT_QUERYRESOURCEUSAGE_H_
@@ -8,6 +8,7 @@
 
 #include <vector>
 
+#include "common/memory/MemoryTracker.h"
 #include "graph/context/Iterator.h"
 
 namespace nebula {
@@ -56,6 +57,22 @@ class Result final {
     return core_.iter.get();
   }
 
+  // Whether the value is only referred by the result and its iterator, i.e. it's not shared with
+  // the results of other executors
+  bool ownsValue() const {
+    return core_.value.use_count() <= 2;
+  }
+
+  // The memory reserved for the value, released when all copies of the result are destroyed
+  void setMemoryReservation(std::shared_ptr<MemoryReservation> memory) {
+    core_.memory = std::move(memory);
+  }
+
+  // The memory released once the result is destroyed, i.e. no other copy of it is alive
+  int64_t releasableMemory() const {
+    return core_.memory != nullptr && core_.memory.use_count() == 1 ? core_.memory->bytes() : 0;
+  }
+
   void checkMemory(bool checkMemory) {
     core_.checkMemory = checkMemory;
     if (core_.iter) {
@@ -84,6 +101,7 @@ class Result final {
         msg = c.msg;
         value = c.value;
         iter = c.iter->copy();
+        memory = c.memory;
       }
       return *this;
     }
@@ -93,6 +111,7 @@ class Result final {
     std::string msg;
     std::shared_ptr<Value> value;
     std::unique_ptr<Iterator> iter;
+    std::shared_ptr<MemoryReservation> memory;
   };
 
   explicit Result(Core&& core) : core_(std::move(core)) {}
@@ -133,5 +133,11 @@ StatusOr<std::string> SymbolTable::getAliasGeneratedBy(const std::string& alias)
     return found->second;
   }
 }
+
+void SymbolTable::resetUserCount() {
+  for (auto& var : vars_) {
+    var.second->userCount.store(0, std::memory_order_relaxed);
+  }
+}
 }  // namespace graph
 }  // namespace nebula
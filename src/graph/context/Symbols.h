@@ -6,6 +6,7 @@
 #ifndef GRAPH_CONTEXT_SYMBOLS_H_
 #define GRAPH_CONTEXT_SYMBOLS_H_
 
+#include <limits>
 #include <unordered_set>
 #include <vector>
 
@@ -48,6 +49,10 @@ struct Variable {
 
   // the count of use the variable
   std::atomic<uint64_t> userCount{0};
+
+  // The number of the latest versions read by the plan, the older ones are released once a new
+  // version is set, e.g. the results of the previous iterations of a loop
+  size_t versionsRead{std::numeric_limits<size_t>::max()};
 };
 
 class SymbolTable final {
@@ -76,6 +81,9 @@ class SymbolTable final {
 
   StatusOr<std::string> getAliasGeneratedBy(const std::string& alias);
 
+  // Forget the users counted by the last run of the plan
+  void resetUserCount();
+
   std::string toString() const;
 
  private:
@@ -0,0 +1,88 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/context/TagRowDecoder.h"
+
+#include "codec/RowReaderWrapper.h"
+#include "common/base/ObjectPool.h"
+#include "common/expression/Expression.h"
+#include "common/utils/DefaultValueContext.h"
+
+namespace nebula {
+namespace graph {
+
+TagRowDecoder::TagRowDecoder(meta::SchemaManager* schemaMng,
+                             GraphSpaceID space,
+                             const std::vector<TagID>& tags)
+    : schemaMng_(schemaMng), space_(space) {
+  for (auto tagId : tags) {
+    auto tagName = schemaMng_->toTagName(space_, tagId);
+    auto schema = schemaMng_->getTagSchema(space_, tagId);
+    if (!tagName.ok() || schema == nullptr) {
+      continue;
+    }
+    tags_.emplace(std::move(tagName).value(), TagSchema{tagId, std::move(schema)});
+  }
+}
+
+Value TagRowDecoder::decode(const std::string& tag,
+                            const std::string& prop,
+                            folly::StringPiece row) const {
+  auto found = tags_.find(tag);
+  if (found == tags_.end()) {
+    return Value::kNullBadData;
+  }
+  const auto& tagSchema = found->second;
+  if (prop == kTag) {
+    return tagSchema.id;
+  }
+  const auto* field = tagSchema.schema->field(prop);
+  if (field == nullptr) {
+    return Value::kNullUnknownProp;
+  }
+
+  SchemaVer schemaVer;
+  int32_t readerVer;
+  RowReaderWrapper::getVersions(row, schemaVer, readerVer);
+  if (schemaVer < 0) {
+    return Value::kNullBadData;
+  }
+  auto schema = tagSchema.schema;
+  if (schemaVer != schema->getVersion()) {
+    schema = schemaMng_->getTagSchema(space_, tagSchema.id, schemaVer);
+    if (schema == nullptr) {
+      return Value::kNullBadData;
+    }
+  }
+  RowReaderWrapper reader(schema.get(), row, readerVer);
+  auto value = reader.getValueByName(prop);
+
+  // The same as the props decoded by storaged, see QueryUtils::checkValue of storage
+  if (value.isNull()) {
+    auto nullType = value.getNull();
+    if (nullType == NullType::UNKNOWN_PROP) {
+      if (field->hasDefault()) {
+        DefaultValueContext expCtx;
+        ObjectPool pool;
+        auto& exprStr = field->defaultValue();
+        auto expr = Expression::decode(&pool, folly::StringPiece(exprStr.data(), exprStr.size()));
+        return Expression::eval(expr, expCtx);
+      } else if (field->nullable()) {
+        return Value::kNullValue;
+      }
+    } else if (nullType == NullType::__NULL__ && field->nullable()) {
+      return value;
+    }
+    return Value::kNullBadData;
+  }
+  if (field->type() == nebula::cpp2::PropertyType::FIXED_STRING) {
+    const auto& fixedStr = value.getStr();
+    return fixedStr.substr(0, fixedStr.find_first_of('\0'));
+  }
+  return value;
+}
+
+}  // namespace graph
+}  // namespace nebula
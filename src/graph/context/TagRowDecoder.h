@@ -0,0 +1,45 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_CONTEXT_TAGROWDECODER_H_
+#define GRAPH_CONTEXT_TAGROWDECODER_H_
+
+#include "common/base/Base.h"
+#include "common/datatypes/Value.h"
+#include "common/meta/NebulaSchemaProvider.h"
+#include "common/meta/SchemaManager.h"
+
+namespace nebula {
+namespace graph {
+
+// Decodes the props of the tags from the rows which storaged returns encoded, see encoded_rows of
+// RequestCommon. Each prop is decoded by itself when it's read, the other fields of the row are
+// left encoded.
+class TagRowDecoder final {
+ public:
+  // The schemas of the tags are resolved once, the rows of an older schema version than the
+  // latest one are decoded by the schema of their version
+  TagRowDecoder(meta::SchemaManager* schemaMng, GraphSpaceID space, const std::vector<TagID>& tags);
+
+  // Decode the prop of the tag from the row. The default value or null of the latest schema is
+  // returned if the row doesn't have the prop, and BAD_DATA if the row couldn't be decoded.
+  Value decode(const std::string& tag, const std::string& prop, folly::StringPiece row) const;
+
+ private:
+  struct TagSchema {
+    TagID id;
+    std::shared_ptr<const meta::NebulaSchemaProvider> schema;
+  };
+
+  meta::SchemaManager* schemaMng_{nullptr};
+  GraphSpaceID space_;
+  // tag name -> the id and the latest schema
+  std::unordered_map<std::string, TagSchema> tags_;
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_CONTEXT_TAGROWDECODER_H_
@@ -0,0 +1,148 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/base/ObjectPool.h"
+#include "common/expression/ArithmeticExpression.h"
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/FunctionCallExpression.h"
+#include "common/expression/LogicalExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "common/expression/RelationalExpression.h"
+#include "common/expression/UnaryExpression.h"
+#include "graph/context/BatchEvaluator.h"
+#include "graph/context/ExecutionContext.h"
+#include "graph/context/Iterator.h"
+#include "graph/context/QueryExpressionContext.h"
+
+namespace nebula {
+namespace graph {
+
+class BatchEvaluatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    DataSet ds({"a", "b", "f", "s", "flag", "mixed"});
+    for (int64_t i = 0; i < 100; ++i) {
+      Row row;
+      row.values.emplace_back(i % 7 == 0 ? Value::kNullValue : Value(i - 50));
+      row.values.emplace_back(i % 5);
+      row.values.emplace_back(static_cast<double>(i) / 3);
+      row.values.emplace_back(folly::to<std::string>(i % 10));
+      row.values.emplace_back(i % 11 == 0 ? Value::kNullValue : Value(i % 2 == 0));
+      row.values.emplace_back(i % 3 == 0 ? Value("str") : Value(i));
+      ds.rows.emplace_back(std::move(row));
+    }
+    ds.rows.back().values[1] = INT64_MIN;
+    ds_ = std::move(ds);
+  }
+
+  // Check the batch result against the row-based evaluation
+  void check(Expression* expr) {
+    auto evaluator = BatchEvaluator::compile(expr);
+    ASSERT_NE(evaluator, nullptr) << expr->toString();
+    auto batch = ColumnBatch::fromDataSet(ds_);
+    auto result = evaluator->eval(batch);
+    ASSERT_TRUE(result.ok()) << result.status();
+    ASSERT_EQ(result.value().size(), ds_.rows.size());
+
+    ExecutionContext ectx;
+    QueryExpressionContext ctx(&ectx);
+    SequentialIter iter(std::make_shared<Value>(ds_));
+    for (size_t i = 0; iter.valid(); iter.next(), ++i) {
+      auto expected = expr->eval(ctx(&iter));
+      EXPECT_EQ(result.value().value(i), expected) << expr->toString() << " at row " << i;
+      EXPECT_EQ(result.value().value(i).type(), expected.type()) << expr->toString();
+    }
+  }
+
+  Expression* prop(const std::string& name) {
+    return InputPropertyExpression::make(&pool_, name);
+  }
+
+  Expression* constant(Value v) {
+    return ConstantExpression::make(&pool_, std::move(v));
+  }
+
+  ObjectPool pool_;
+  DataSet ds_;
+};
+
+TEST_F(BatchEvaluatorTest, Relational) {
+  check(RelationalExpression::makeGT(&pool_, prop("a"), constant(10)));
+  check(RelationalExpression::makeLE(&pool_, prop("a"), prop("b")));
+  check(RelationalExpression::makeEQ(&pool_, prop("f"), constant(3)));
+  check(RelationalExpression::makeGE(&pool_, prop("b"), prop("f")));
+  check(RelationalExpression::makeNE(&pool_, prop("s"), constant("5")));
+  check(RelationalExpression::makeLT(&pool_, prop("s"), prop("s")));
+  check(RelationalExpression::makeEQ(&pool_, prop("flag"), constant(true)));
+  check(RelationalExpression::makeLT(&pool_, prop("mixed"), constant(10)));
+  check(RelationalExpression::makeEQ(&pool_, prop("s"), constant(1)));
+  check(RelationalExpression::makeEQ(&pool_, constant(1), constant(Value::kNullValue)));
+}
+
+TEST_F(BatchEvaluatorTest, Arithmetic) {
+  check(ArithmeticExpression::makeAdd(&pool_, prop("a"), prop("b")));
+  check(ArithmeticExpression::makeMinus(&pool_, prop("b"), constant(INT64_MAX)));
+  check(ArithmeticExpression::makeMultiply(&pool_, prop("b"), constant(-1)));
+  check(ArithmeticExpression::makeMultiply(&pool_, prop("a"), prop("f")));
+  check(ArithmeticExpression::makeDivision(&pool_, prop("a"), prop("b")));
+  check(ArithmeticExpression::makeDivision(&pool_, prop("f"), prop("b")));
+  check(ArithmeticExpression::makeMod(&pool_, prop("a"), prop("b")));
+  check(ArithmeticExpression::makeMod(&pool_, prop("f"), constant(0.5)));
+  check(ArithmeticExpression::makeAdd(&pool_, prop("s"), prop("a")));
+  check(ArithmeticExpression::makeAdd(&pool_, prop("mixed"), constant(1)));
+}
+
+TEST_F(BatchEvaluatorTest, LogicalAndUnary) {
+  auto* gt = RelationalExpression::makeGT(&pool_, prop("a"), constant(0));
+  auto* lt = RelationalExpression::makeLT(&pool_, prop("f"), constant(20.5));
+  check(LogicalExpression::makeAnd(&pool_, gt, lt));
+  check(LogicalExpression::makeOr(&pool_, gt->clone(), prop("flag")));
+  check(LogicalExpression::makeAnd(&pool_, prop("flag"), prop("a")));
+  check(UnaryExpression::makeNot(&pool_, prop("flag")));
+  check(UnaryExpression::makeNegate(&pool_, prop("b")));
+  check(UnaryExpression::makeNegate(&pool_, prop("s")));
+  check(UnaryExpression::makeIsNull(&pool_, prop("a")));
+  check(UnaryExpression::makeIsNotEmpty(&pool_, prop("mixed")));
+}
+
+TEST_F(BatchEvaluatorTest, FunctionCall) {
+  check(FunctionCallExpression::make(&pool_, "abs", {prop("a")}));
+  check(FunctionCallExpression::make(&pool_, "toString", {prop("b")}));
+  check(RelationalExpression::makeEQ(
+      &pool_, FunctionCallExpression::make(&pool_, "lower", {prop("s")}), constant("3")));
+}
+
+TEST_F(BatchEvaluatorTest, Unsupported) {
+  EXPECT_EQ(BatchEvaluator::compile(FunctionCallExpression::make(&pool_, "rand")), nullptr);
+  EXPECT_EQ(BatchEvaluator::compile(RelationalExpression::makeREG(&pool_, prop("s"), constant(".*"))),
+            nullptr);
+
+  auto evaluator = BatchEvaluator::compile(prop("nonexistent"));
+  ASSERT_NE(evaluator, nullptr);
+  EXPECT_FALSE(evaluator->eval(ColumnBatch::fromDataSet(ds_)).ok());
+}
+
+TEST_F(BatchEvaluatorTest, FilterMask) {
+  auto evaluator =
+      BatchEvaluator::compile(RelationalExpression::makeGT(&pool_, prop("a"), constant(0)));
+  auto cond = evaluator->eval(ColumnBatch::fromDataSet(ds_));
+  ASSERT_TRUE(cond.ok());
+  std::vector<uint8_t> keep;
+  ASSERT_TRUE(BatchEvaluator::toFilterMask(cond.value(), &keep).ok());
+  for (size_t i = 0; i < keep.size(); ++i) {
+    const auto& a = ds_.rows[i].values[0];
+    EXPECT_EQ(static_cast<bool>(keep[i]), !a.isNull() && a.getInt() > 0);
+  }
+
+  evaluator = BatchEvaluator::compile(prop("b"));
+  cond = evaluator->eval(ColumnBatch::fromDataSet(ds_));
+  ASSERT_TRUE(cond.ok());
+  EXPECT_FALSE(BatchEvaluator::toFilterMask(cond.value(), &keep).ok());
+}
+
+}  // namespace graph
+}  // namespace nebula
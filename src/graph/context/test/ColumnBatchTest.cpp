@@ -0,0 +1,83 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/datatypes/List.h"
+#include "graph/context/ColumnBatch.h"
+#include "graph/context/Iterator.h"
+
+namespace nebula {
+namespace graph {
+
+static DataSet makeDataSet() {
+  DataSet ds({"int", "float", "str", "bool", "mixed", "list"});
+  for (int64_t i = 0; i < 10; ++i) {
+    Row row;
+    row.values.emplace_back(i % 3 == 0 ? Value::kNullValue : Value(i));
+    row.values.emplace_back(static_cast<double>(i) / 2);
+    row.values.emplace_back(folly::to<std::string>(i));
+    row.values.emplace_back(i % 2 == 0);
+    row.values.emplace_back(i % 2 == 0 ? Value(i) : Value::kNullBadType);
+    row.values.emplace_back(List({i, i + 1}));
+    ds.rows.emplace_back(std::move(row));
+  }
+  return ds;
+}
+
+TEST(ColumnBatchTest, FromDataSet) {
+  auto ds = makeDataSet();
+  auto batch = ColumnBatch::fromDataSet(ds);
+  EXPECT_EQ(batch.numRows(), 10);
+  EXPECT_EQ(batch.numColumns(), 6);
+
+  const auto& ints = batch.column(0);
+  EXPECT_EQ(ints.kind(), Column::Kind::kInt);
+  EXPECT_TRUE(ints.hasNull());
+  for (size_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(ints.isNull(i), i % 3 == 0);
+    if (!ints.isNull(i)) {
+      EXPECT_EQ(ints.ints()[i], static_cast<int64_t>(i));
+    }
+  }
+  EXPECT_EQ(batch.column(1).kind(), Column::Kind::kFloat);
+  EXPECT_EQ(batch.column(2).kind(), Column::Kind::kString);
+  EXPECT_EQ(batch.column(3).kind(), Column::Kind::kBool);
+  // Special null kinds are kept by the generic column
+  EXPECT_EQ(batch.column(4).kind(), Column::Kind::kGeneric);
+  EXPECT_EQ(batch.column(4).value(1), Value::kNullBadType);
+  EXPECT_EQ(batch.column(5).kind(), Column::Kind::kGeneric);
+
+  EXPECT_EQ(batch.column("str"), &batch.column(2));
+  EXPECT_EQ(batch.column("nonexistent"), nullptr);
+}
+
+TEST(ColumnBatchTest, RoundTrip) {
+  auto ds = makeDataSet();
+  auto batch = ColumnBatch::fromDataSet(ds);
+  EXPECT_EQ(batch.toDataSet(), ds);
+
+  DataSet empty({"a", "b"});
+  EXPECT_EQ(ColumnBatch::fromDataSet(empty).toDataSet(), empty);
+}
+
+TEST(ColumnBatchTest, SequentialIter) {
+  auto val = std::make_shared<Value>(makeDataSet());
+  SequentialIter iter(val);
+  auto batch = iter.columnBatch();
+  ASSERT_NE(batch, nullptr);
+  EXPECT_EQ(batch->numRows(), 10);
+  // Cached until rows are erased
+  EXPECT_EQ(iter.columnBatch(), batch);
+
+  iter.erase();
+  auto erased = iter.columnBatch();
+  EXPECT_NE(erased, batch);
+  EXPECT_EQ(erased->numRows(), 9);
+  EXPECT_EQ(erased->column("int")->value(0), 1);
+}
+
+}  // namespace graph
+}  // namespace nebula
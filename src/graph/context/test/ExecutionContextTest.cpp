@@ -6,7 +6,10 @@
 #include <gtest/gtest.h>
 
 #include "common/base/Base.h"
+#include "common/memory/MemoryTracker.h"
 #include "graph/context/ExecutionContext.h"
+#include "graph/gc/GC.h"
+#include "graph/service/GraphFlags.h"
 
 namespace nebula {
 namespace graph {
@@ -59,5 +62,56 @@ TEST(ExecutionContextTest, TestResult) {
   EXPECT_TRUE(result.valuePtr()->isDataSet());
 }
 
+TEST(ExecutionContextTest, Copy) {
+  ExecutionContext ctx;
+  ctx.initVar("empty");
+  ctx.setValue("v1", 10);
+  DataSet ds({"col"});
+  ds.rows.emplace_back(Row({1}));
+  ctx.setResult(
+      "ds", ResultBuilder().value(Value(std::move(ds))).iter(Iterator::Kind::kSequential).build());
+
+  auto copied = ctx.copy();
+  EXPECT_TRUE(copied->exist("empty"));
+  EXPECT_EQ(0, copied->numVersions("empty"));
+  EXPECT_EQ(Value(10), copied->getValue("v1"));
+  auto& result = copied->getResult("ds");
+  EXPECT_EQ(Iterator::Kind::kSequential, result.iter()->kind());
+  EXPECT_NE(ctx.getResult("ds").valuePtr(), result.valuePtr());
+
+  // The values of the copy are not shared with the original ones
+  ctx.setValue("v1", 20);
+  EXPECT_EQ(Value(10), copied->getValue("v1"));
+  EXPECT_EQ(1, result.value().getDataSet().rowSize());
+}
+
+TEST(ExecutionContextTest, TruncHistoryToGC) {
+  gflags::FlagSaver saver;
+  FLAGS_enable_async_gc = true;
+  auto tracker = std::make_shared<MemoryTracker>("test", 0);
+  ExecutionContext ctx;
+  for (int i = 0; i < 3; ++i) {
+    auto result = ResultBuilder().value(Value(i)).build();
+    auto reservation = MemoryReservation::reserve(tracker, 100);
+    ASSERT_TRUE(reservation.ok());
+    result.setMemoryReservation(std::move(reservation).value());
+    ctx.setResult("v", std::move(result));
+  }
+  EXPECT_EQ(300, tracker->used());
+
+  ctx.truncHistory("v", 1);
+  EXPECT_EQ(1, ctx.numVersions("v"));
+  // The released versions are destroyed by this thread or by the worker woken before
+  GC::instance().collectPending();
+  for (int i = 0; i < 1000 && GC::instance().pendingBytes() > 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(0, GC::instance().pendingBytes());
+  EXPECT_EQ(100, tracker->used());
+  // Nothing is left to destroy
+  EXPECT_FALSE(GC::instance().collectPending());
+  EXPECT_EQ(Value(2), ctx.getValue("v"));
+}
+
 }  // namespace graph
 }  // namespace nebula
@@ -5,9 +5,11 @@
 
 #include <gtest/gtest.h>
 
+#include "codec/RowWriterV2.h"
 #include "common/datatypes/Edge.h"
 #include "common/datatypes/Vertex.h"
 #include "graph/context/Iterator.h"
+#include "graph/validator/test/MockSchemaManager.h"
 
 namespace nebula {
 namespace graph {
@@ -744,6 +746,163 @@ TEST(IteratorTest, VertexProp) {
   }
 }
 
+TEST(IteratorTest, TagPropBySlot) {
+  {
+    DataSet ds;
+    ds.colNames = {kVid, "tag1.prop1", "tag2.prop1"};
+    for (auto i = 0; i < 5; ++i) {
+      ds.rows.emplace_back(Row({folly::to<std::string>(i), i, Value()}));
+    }
+    auto val = std::make_shared<Value>(std::move(ds));
+    PropIter iter(val);
+    PropSlot slot, missing, unknown;
+    for (; iter.valid(); iter.next()) {
+      EXPECT_EQ(iter.getTagProp("tag1", "prop1"), iter.getTagPropBySlot("tag1", "prop1", &slot));
+      EXPECT_EQ(iter.getTagProp("tag1", "prop2"),
+                iter.getTagPropBySlot("tag1", "prop2", &missing));
+      EXPECT_EQ(iter.getTagProp("tag3", "prop1"),
+                iter.getTagPropBySlot("tag3", "prop1", &unknown));
+    }
+    EXPECT_TRUE(slot.exists);
+    EXPECT_FALSE(missing.exists);
+  }
+  {
+    // The tags are in different columns of the datasets
+    List datasets;
+    for (auto cols : {std::vector<std::string>{"_tag:tag1:prop1", "_tag:tag2:prop1:prop2"},
+                      std::vector<std::string>{"_tag:tag2:prop2:prop1", "_tag:tag1:prop1"}}) {
+      DataSet ds;
+      ds.colNames = {kVid, "_stats", cols[0], cols[1], "_edge:+edge1:prop1", "_expr"};
+      for (auto i = 0; i < 3; ++i) {
+        Row row;
+        row.values.emplace_back(folly::to<std::string>(i));
+        row.values.emplace_back(Value());
+        row.values.emplace_back(List({i}));
+        row.values.emplace_back(i == 0 ? Value() : Value(List({i * 10, i * 100})));
+        row.values.emplace_back(List(std::vector<Value>{List({i})}));
+        row.values.emplace_back(Value());
+        ds.rows.emplace_back(std::move(row));
+      }
+      datasets.values.emplace_back(std::move(ds));
+    }
+    GetNeighborsIter iter(std::make_shared<Value>(std::move(datasets)));
+    PropSlot slot1, slot2, missing;
+    size_t rows = 0;
+    for (; iter.valid(); iter.next(), ++rows) {
+      EXPECT_EQ(iter.getTagProp("tag1", "prop1"), iter.getTagPropBySlot("tag1", "prop1", &slot1));
+      EXPECT_EQ(iter.getTagProp("tag2", "prop2"), iter.getTagPropBySlot("tag2", "prop2", &slot2));
+      EXPECT_EQ(iter.getTagProp("tag1", "prop2"),
+                iter.getTagPropBySlot("tag1", "prop2", &missing));
+    }
+    EXPECT_EQ(6, rows);
+  }
+}
+
+TEST(IteratorTest, EncodedTagRows) {
+  // person(name string, age int8) of the space 1
+  auto schemaMng = MockSchemaManager::makeUnique();
+  auto schema = schemaMng->getTagSchema(1, 2);
+  auto encode = [&schema](int64_t i) {
+    RowWriterV2 writer(schema.get());
+    writer.setValue("name", folly::to<std::string>("name", i));
+    writer.setValue("age", i);
+    writer.finish();
+    return writer.moveEncodedStr();
+  };
+  DataSet ds;
+  ds.colNames = {kVid, "_stats", "_tag:person:name:age:_tag", "_edge:+like:_dst", "_expr"};
+  for (auto i = 0; i < 3; ++i) {
+    Row row;
+    row.values.emplace_back(folly::to<std::string>(i));
+    row.values.emplace_back(Value());
+    // The last vertex doesn't have the tag
+    row.values.emplace_back(i == 2 ? Value() : Value(encode(i)));
+    row.values.emplace_back(List(std::vector<Value>{List({folly::to<std::string>(i + 1)})}));
+    row.values.emplace_back(Value());
+    ds.rows.emplace_back(std::move(row));
+  }
+  List datasets;
+  datasets.values.emplace_back(std::move(ds));
+  auto val = std::make_shared<Value>(std::move(datasets));
+  {
+    // The rows couldn't be read without the decoder
+    GetNeighborsIter iter(val);
+    EXPECT_EQ(Value::kNullBadType, iter.getTagProp("person", "name"));
+  }
+  GetNeighborsIter iter(val);
+  iter.setTagRowDecoder(
+      std::make_shared<TagRowDecoder>(schemaMng.get(), 1, std::vector<TagID>{2}));
+  PropSlot slot;
+  size_t rows = 0;
+  for (; iter.valid(); iter.next(), ++rows) {
+    auto name = folly::to<std::string>("name", rows);
+    auto age = static_cast<int64_t>(rows);
+    if (rows == 2) {
+      EXPECT_EQ(Value::kEmpty, iter.getTagProp("person", "name"));
+      EXPECT_EQ(Value::kEmpty, iter.getTagPropBySlot("person", "age", &slot));
+      EXPECT_EQ(Value::kEmpty, iter.getTagProp("*", "age"));
+      continue;
+    }
+    // Only the props read are decoded
+    EXPECT_EQ(rows, iter.decodedTags_.size());
+    EXPECT_EQ(Value(name), iter.getTagProp("person", "name"));
+    ASSERT_EQ(rows + 1, iter.decodedTags_.size());
+    const auto& decoded = iter.decodedTags_.at(&iter.currentRow_->values[2]);
+    EXPECT_TRUE(decoded.values[1].empty());
+
+    EXPECT_EQ(Value(age), iter.getTagPropBySlot("person", "age", &slot));
+    EXPECT_EQ(Value(age), iter.getTagProp("*", "age"));
+    EXPECT_EQ(Value(2), iter.getTagProp("person", kTag));
+
+    Tag tag;
+    tag.name = "person";
+    tag.props = {{"name", name}, {"age", age}};
+    Vertex vertex;
+    vertex.vid = folly::to<std::string>(rows);
+    vertex.tags.emplace_back(std::move(tag));
+    EXPECT_EQ(Value(std::move(vertex)), iter.getVertex());
+  }
+  EXPECT_EQ(3, rows);
+}
+
+TEST(IteratorTest, SharedLayout) {
+  List datasets;
+  for (auto cols : {std::vector<std::string>{"_tag:tag1:prop1", "_tag:tag2:prop1:prop2"},
+                    std::vector<std::string>{"_tag:tag2:prop2:prop1", "_tag:tag1:prop1"},
+                    std::vector<std::string>{"_tag:tag1:prop1", "_tag:tag2:prop1:prop2"}}) {
+    DataSet ds;
+    ds.colNames = {kVid, "_stats", cols[0], cols[1], "_edge:+edge1:prop1", "_expr"};
+    auto tag2 = cols[1].find("tag2") != std::string::npos ? 3 : 2;
+    for (auto i = 0; i < 3; ++i) {
+      Row row;
+      row.values.emplace_back(folly::to<std::string>(i));
+      row.values.emplace_back(Value());
+      row.values.emplace_back(Value());
+      row.values.emplace_back(Value());
+      row.values[5 - tag2] = List({i});
+      row.values[tag2] = tag2 == 3 ? List({i * 10, i * 100}) : List({i * 100, i * 10});
+      row.values.emplace_back(List(std::vector<Value>{List({i})}));
+      row.values.emplace_back(Value());
+      ds.rows.emplace_back(std::move(row));
+    }
+    datasets.values.emplace_back(std::move(ds));
+  }
+  GetNeighborsIter iter(std::make_shared<Value>(std::move(datasets)));
+  ASSERT_EQ(3, iter.dsIndices_.size());
+  EXPECT_EQ(iter.dsIndices_[0].layout, iter.dsIndices_[2].layout);
+  EXPECT_NE(iter.dsIndices_[0].layout, iter.dsIndices_[1].layout);
+
+  PropSlot slot;
+  size_t rows = 0;
+  for (; iter.valid(); iter.next(), ++rows) {
+    auto i = static_cast<int64_t>(rows % 3);
+    EXPECT_EQ(i, iter.getTagProp("tag1", "prop1"));
+    EXPECT_EQ(i * 100, iter.getTagPropBySlot("tag2", "prop2", &slot));
+    EXPECT_EQ(i * 10, iter.getTagProp("tag2", "prop1"));
+  }
+  EXPECT_EQ(9, rows);
+}
+
 TEST(IteratorTest, EdgeProp) {
   DataSet ds;
   ds.colNames = {"like._src",
@@ -836,6 +995,44 @@ TEST(IteratorTest, EraseBySwap) {
   }
   EXPECT_EQ(result, expected);
 }
+
+TEST(IteratorTest, MarkErased) {
+  DataSet ds;
+  ds.colNames = {"col1", "col2"};
+  for (auto i = 0; i < 10; ++i) {
+    Row row;
+    row.values.emplace_back(i);
+    row.values.emplace_back(folly::to<std::string>(i));
+    ds.rows.emplace_back(std::move(row));
+  }
+  auto val = std::make_shared<Value>(std::move(ds));
+  SequentialIter iter(val);
+  const Row* last = nullptr;
+  while (iter.valid()) {
+    if (iter.getColumn("col1").getInt() % 3 != 0) {
+      iter.markErased();
+    } else {
+      last = iter.row();
+      iter.next();
+    }
+  }
+  // The rows stay until compacted
+  EXPECT_EQ(iter.size(), 10);
+  EXPECT_EQ(last->values[0], 9);
+
+  iter.compact();
+  EXPECT_EQ(iter.size(), 4);
+  std::vector<int64_t> result;
+  for (; iter.valid(); iter.next()) {
+    EXPECT_EQ(iter.getColumn("col2"), folly::to<std::string>(iter.getColumn("col1").getInt()));
+    result.emplace_back(iter.getColumn("col1").getInt());
+  }
+  EXPECT_EQ(result, std::vector<int64_t>({0, 3, 6, 9}));
+
+  // Nothing marked
+  iter.compact();
+  EXPECT_EQ(iter.size(), 4);
+}
 }  // namespace graph
 }  // namespace nebula
 
@@ -11,6 +11,7 @@
 #include <atomic>
 
 #include "common/base/ObjectPool.h"
+#include "common/memory/MemoryTracker.h"
 #include "common/memory/MemoryUtils.h"
 #include "common/stats/StatsManager.h"
 #include "graph/context/ExecutionContext.h"
@@ -32,6 +33,7 @@
 #include "graph/executor/admin/PartExecutor.h"
 #include "graph/executor/admin/RevokeRoleExecutor.h"
 #include "graph/executor/admin/SessionExecutor.h"
+#include "graph/executor/admin/ShowCardinalityFeedbackExecutor.h"
 #include "graph/executor/admin/ShowHostsExecutor.h"
 #include "graph/executor/admin/ShowMetaLeaderExecutor.h"
 #include "graph/executor/admin/ShowQueriesExecutor.h"
@@ -69,7 +71,9 @@
 #include "graph/executor/query/AssignExecutor.h"
 #include "graph/executor/query/DataCollectExecutor.h"
 #include "graph/executor/query/DedupExecutor.h"
+#include "graph/executor/query/ExpandIntersectExecutor.h"
 #include "graph/executor/query/FilterExecutor.h"
+#include "graph/executor/query/FilterProjectLimitExecutor.h"
 #include "graph/executor/query/GetEdgesExecutor.h"
 #include "graph/executor/query/GetNeighborsExecutor.h"
 #include "graph/executor/query/GetVerticesExecutor.h"
@@ -90,6 +94,7 @@
 #include "graph/executor/query/UnionAllVersionVarExecutor.h"
 #include "graph/executor/query/UnionExecutor.h"
 #include "graph/executor/query/UnwindExecutor.h"
+#include "graph/gc/GC.h"
 #include "graph/planner/plan/Admin.h"
 #include "graph/planner/plan/Logic.h"
 #include "graph/planner/plan/Maintain.h"
@@ -98,6 +103,7 @@
 #include "graph/planner/plan/Query.h"
 #include "graph/service/GraphFlags.h"
 #include "graph/stats/GraphStats.h"
+#include "graph/util/RowHashSet.h"
 #include "interface/gen-cpp2/graph_types.h"
 
 using folly::stringPrintf;
@@ -108,6 +114,91 @@ DECLARE_double(system_memory_high_watermark_ratio);
 namespace nebula {
 namespace graph {
 
+namespace {
+
+// Only some rows of a dataset are sampled to estimate its memory
+constexpr size_t kNumRowsToEstimateMemory = 64;
+
+int64_t estimateMemory(const Value &value);
+
+int64_t estimateMemory(const std::unordered_map<std::string, Value> &props) {
+  int64_t bytes = 0;
+  for (auto &prop : props) {
+    bytes += sizeof(prop) + prop.first.size() + estimateMemory(prop.second);
+  }
+  return bytes;
+}
+
+int64_t estimateMemory(const Vertex &vertex) {
+  int64_t bytes = sizeof(Vertex) + estimateMemory(vertex.vid);
+  for (auto &tag : vertex.tags) {
+    bytes += sizeof(Tag) + tag.name.size() + estimateMemory(tag.props);
+  }
+  return bytes;
+}
+
+int64_t estimateMemory(const DataSet &ds) {
+  int64_t bytes = sizeof(DataSet);
+  auto numRows = ds.rows.size();
+  if (numRows == 0) {
+    return bytes;
+  }
+  auto numSamples = std::min(numRows, kNumRowsToEstimateMemory);
+  int64_t sampleBytes = 0;
+  for (size_t i = 0; i < numSamples; ++i) {
+    // Sample the rows evenly
+    auto &row = ds.rows[i * numRows / numSamples];
+    sampleBytes += sizeof(Row);
+    for (auto &col : row.values) {
+      sampleBytes += estimateMemory(col);
+    }
+  }
+  return bytes + sampleBytes * numRows / numSamples;
+}
+
+// Approximate memory used by the value, including the Value itself
+int64_t estimateMemory(const Value &value) {
+  int64_t bytes = sizeof(Value);
+  switch (value.type()) {
+    case Value::Type::STRING:
+      return bytes + value.getStr().size();
+    case Value::Type::LIST:
+      for (auto &v : value.getList().values) {
+        bytes += estimateMemory(v);
+      }
+      return bytes + sizeof(List);
+    case Value::Type::SET:
+      for (auto &v : value.getSet().values) {
+        bytes += estimateMemory(v);
+      }
+      return bytes + sizeof(Set);
+    case Value::Type::MAP:
+      return bytes + sizeof(Map) + estimateMemory(value.getMap().kvs);
+    case Value::Type::VERTEX:
+      return bytes + estimateMemory(value.getVertex());
+    case Value::Type::EDGE: {
+      auto &edge = value.getEdge();
+      return bytes + sizeof(Edge) + estimateMemory(edge.src) + estimateMemory(edge.dst) +
+             edge.name.size() + estimateMemory(edge.props);
+    }
+    case Value::Type::PATH: {
+      auto &path = value.getPath();
+      bytes += sizeof(Path) + estimateMemory(path.src);
+      for (auto &step : path.steps) {
+        bytes += sizeof(Step) + estimateMemory(step.dst) + step.name.size() +
+                 estimateMemory(step.props);
+      }
+      return bytes;
+    }
+    case Value::Type::DATASET:
+      return bytes + estimateMemory(value.getDataSet());
+    default:
+      return bytes;
+  }
+}
+
+}  // namespace
+
 // static
 Executor *Executor::create(const PlanNode *node, QueryContext *qctx) {
   std::unordered_map<int64_t, Executor *> visited;
@@ -179,6 +270,9 @@ Executor *Executor::makeExecutor(QueryContext *qctx, const PlanNode *node) {
     case PlanNode::Kind::kFilter: {
       return pool->makeAndAdd<FilterExecutor>(node, qctx);
     }
+    case PlanNode::Kind::kFilterProjectLimit: {
+      return pool->makeAndAdd<FilterProjectLimitExecutor>(node, qctx);
+    }
     case PlanNode::Kind::kGetEdges: {
       return pool->makeAndAdd<GetEdgesExecutor>(node, qctx);
     }
@@ -436,6 +530,9 @@ Executor *Executor::makeExecutor(QueryContext *qctx, const PlanNode *node) {
     case PlanNode::Kind::kShowMetaLeader: {
       return pool->makeAndAdd<ShowMetaLeaderExecutor>(node, qctx);
     }
+    case PlanNode::Kind::kShowCardinalityFeedback: {
+      return pool->makeAndAdd<ShowCardinalityFeedbackExecutor>(node, qctx);
+    }
     case PlanNode::Kind::kShowParts: {
       return pool->makeAndAdd<ShowPartsExecutor>(node, qctx);
     }
@@ -526,6 +623,9 @@ Executor *Executor::makeExecutor(QueryContext *qctx, const PlanNode *node) {
     case PlanNode::Kind::kTraverse: {
       return pool->makeAndAdd<TraverseExecutor>(node, qctx);
     }
+    case PlanNode::Kind::kExpandIntersect: {
+      return pool->makeAndAdd<ExpandIntersectExecutor>(node, qctx);
+    }
     case PlanNode::Kind::kAppendVertices: {
       return pool->makeAndAdd<AppendVerticesExecutor>(node, qctx);
     }
@@ -563,7 +663,8 @@ Executor::Executor(const std::string &name, const PlanNode *node, QueryContext *
       name_(name),
       node_(DCHECK_NOTNULL(node)),
       qctx_(DCHECK_NOTNULL(qctx)),
-      ectx_(DCHECK_NOTNULL(qctx->ectx())) {
+      ectx_(DCHECK_NOTNULL(qctx->ectx())),
+      memTracker_(std::make_shared<MemoryTracker>(name, 0, qctx->memTracker())) {
   // Initialize the position in ExecutionContext for each executor before
   // execution plan starting to run. This will avoid lock something for thread
   // safety in real execution
@@ -580,25 +681,35 @@ Status Executor::open() {
             << "ep: " << qctx()->plan()->id() << "query: " << qctx()->rctx()->query();
     return Status::Error("Execution had been killed");
   }
+  if (qctx_->isTimedOut()) {
+    return Status::Error("Execution timed out after %ld ms", qctx_->timeoutMs());
+  }
 
   NG_RETURN_IF_ERROR(checkMemoryWatermark());
 
   numRows_ = 0;
   execTime_ = 0;
   totalDuration_.reset();
+  span_ = tracing::Span(name_.c_str(), qctx_->traceSpan());
   return Status::OK();
 }
 
 Status Executor::close() {
   ProfilingStats stats;
   stats.totalDurationInUs = totalDuration_.elapsedInUSec();
+  qctx()->resourceUsage().addStageDuration(name_, stats.totalDurationInUs);
   stats.rows = numRows_;
   stats.execDurationInUs = execTime_;
+  if (memTracker_->peak() > 0) {
+    otherStats_.emplace("peakMemoryInBytes", folly::to<std::string>(memTracker_->peak()));
+  }
   if (!otherStats_.empty()) {
     stats.otherStats =
         std::make_unique<std::unordered_map<std::string, std::string>>(std::move(otherStats_));
   }
   qctx()->plan()->addProfileStats(node_->id(), std::move(stats));
+  span_.setAttribute("rows", static_cast<int64_t>(numRows_));
+  span_.end();
   return Status::OK();
 }
 
@@ -712,7 +823,12 @@ Status Executor::finish(Result &&result) {
       node()->outputVarPtr()->userCount.load(std::memory_order_relaxed) != 0) {
     numRows_ = result.size();
     result.checkMemory(node()->isQueryNode());
+    NG_RETURN_IF_ERROR(reserveMemory(result));
     ectx_->setResult(node()->outputVar(), std::move(result));
+    if (FLAGS_enable_lifetime_optimize) {
+      // Release the versions not read any more, e.g. of the previous iterations of a loop
+      ectx_->truncHistory(node()->outputVar(), node()->outputVarPtr()->versionsRead);
+    }
   } else {
     VLOG(1) << "Drop variable " << node()->outputVar();
   }
@@ -726,6 +842,23 @@ Status Executor::finish(Value &&value) {
   return finish(ResultBuilder().value(std::move(value)).iter(Iterator::Kind::kDefault).build());
 }
 
+Status Executor::reserveMemory(Result &result) {
+  // The value shared with the inputs has been reserved by the executor creating it
+  if (result.valuePtr() == nullptr || !result.ownsValue()) {
+    return Status::OK();
+  }
+  auto bytes = estimateMemory(result.value());
+  auto reservation = MemoryReservation::reserve(memTracker_, bytes);
+  // The memory may be held by the garbage not destroyed yet, which is destroyed here instead of
+  // blocking the thread until the workers get to it
+  if (!reservation.ok() && FLAGS_enable_async_gc && GC::instance().collectPending()) {
+    reservation = MemoryReservation::reserve(memTracker_, bytes);
+  }
+  NG_RETURN_IF_ERROR(reservation);
+  result.setMemoryReservation(std::move(reservation).value());
+  return Status::OK();
+}
+
 folly::Executor *Executor::runner() const {
   if (!qctx() || !qctx()->rctx() || !qctx()->rctx()->runner()) {
     // This is just for test
@@ -734,6 +867,35 @@ folly::Executor *Executor::runner() const {
   return qctx()->rctx()->runner();
 }
 
+folly::Future<std::vector<size_t>> Executor::hashRows(Iterator *iter) {
+  auto hashJob = [](size_t begin, size_t end, Iterator *tmpIter) -> std::vector<size_t> {
+    std::vector<size_t> hashes;
+    hashes.reserve(end - begin);
+    for (; tmpIter->valid() && begin++ < end; tmpIter->next()) {
+      hashes.emplace_back(RowHashSet::hash(*tmpIter->row()));
+    }
+    return hashes;
+  };
+  if (FLAGS_max_job_size <= 1 || iter->size() <= static_cast<size_t>(FLAGS_min_batch_size)) {
+    auto copy = iter->copy();
+    return hashJob(0, iter->size(), copy.get());
+  }
+
+  auto gather = [](std::vector<std::vector<size_t>> &&results) {
+    std::vector<size_t> hashes;
+    size_t size = 0;
+    for (auto &r : results) {
+      size += r.size();
+    }
+    hashes.reserve(size);
+    for (auto &r : results) {
+      hashes.insert(hashes.end(), r.begin(), r.end());
+    }
+    return hashes;
+  };
+  return runMultiJobs(std::move(hashJob), std::move(gather), iter);
+}
+
 size_t Executor::getBatchSize(size_t totalSize) const {
   // batch size should be the greater one of FLAGS_min_batch_size and (totalSize/FLAGS_max_job_size)
   size_t jobSize = FLAGS_max_job_size;
@@ -8,6 +8,7 @@
 #include <boost/core/noncopyable.hpp>
 
 #include "common/cpp/helpers.h"
+#include "common/tracing/Tracing.h"
 #include "common/time/Duration.h"
 #include "common/time/ScopedTimer.h"
 #include "graph/context/ExecutionContext.h"
@@ -52,6 +53,11 @@ class Executor : private boost::noncopyable, private cpp::NonMovable {
     return node_;
   }
 
+  // The span of the running execution, which is a child of the span of the query
+  tracing::SpanRef traceSpan() const {
+    return span_.ref();
+  }
+
   const std::set<Executor *> &depends() const {
     return depends_;
   }
@@ -76,6 +82,9 @@ class Executor : private boost::noncopyable, private cpp::NonMovable {
   folly::Future<Status> error(Status status) const;
 
  protected:
+  // Runs the fused executors in place of their own execute
+  friend class Pipeline;
+
   static Executor *makeExecutor(const PlanNode *node,
                                 QueryContext *qctx,
                                 std::unordered_map<int64_t, Executor *> *visited);
@@ -106,6 +115,9 @@ class Executor : private boost::noncopyable, private cpp::NonMovable {
   // Store the default result which not used for later executor
   Status finish(Value &&value);
 
+  // Reserve the memory used by the value of result from the memory tracker
+  Status reserveMemory(Result &result);
+
   size_t getBatchSize(size_t totalSize) const;
 
   // ScatterFunc: A callback function that handle partial records of a dataset.
@@ -117,6 +129,10 @@ class Executor : private boost::noncopyable, private cpp::NonMovable {
       class GatherFunc>
   auto runMultiJobs(ScatterFunc &&scatter, GatherFunc &&gather, Iterator *iter);
 
+  // Compute the hashes of all rows of iter in order, by multiple jobs if there are enough rows.
+  // Used with RowHashSet by the executors deduplicating or matching rows.
+  folly::Future<std::vector<size_t>> hashRows(Iterator *iter);
+
   int64_t id_;
 
   // Executor name
@@ -138,6 +154,10 @@ class Executor : private boost::noncopyable, private cpp::NonMovable {
   uint64_t execTime_{0};
   time::Duration totalDuration_;
   std::unordered_map<std::string, std::string> otherStats_;
+  tracing::Span span_;
+
+  // Tracks the memory of the results, whose parent is the tracker of the query
+  std::shared_ptr<MemoryTracker> memTracker_;
 };
 
 template <class ScatterFunc, class ScatterResult, class GatherFunc>
@@ -152,7 +172,8 @@ auto Executor::runMultiJobs(ScatterFunc &&scatter, GatherFunc &&gather, Iterator
     end = begin + batchSize > totalSize ? totalSize : begin + batchSize;
     futures.emplace_back(folly::via(
         runner(),
-        [begin, end, tmpIter = iter->copy(), f = std::move(scatter)]() mutable -> ScatterResult {
+        // Each job has its own copy of the scatter function
+        [begin, end, tmpIter = iter->copy(), f = scatter]() mutable -> ScatterResult {
           // Since not all iterators are linear, so iterates to the begin pos
           size_t tmp = 0;
           for (; tmpIter->valid() && tmp < begin; ++tmp) {
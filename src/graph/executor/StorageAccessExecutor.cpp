@@ -5,9 +5,13 @@
 #include "graph/executor/StorageAccessExecutor.h"
 
 #include <folly/Format.h>
+#include <folly/container/F14Set.h>
 
+#include "common/utils/BloomFilter.h"
 #include "graph/context/Iterator.h"
 #include "graph/context/QueryExpressionContext.h"
+#include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 #include "graph/util/SchemaUtil.h"
 #include "graph/util/Utils.h"
 #include "interface/gen-cpp2/meta_types.h"
@@ -47,7 +51,7 @@ DataSet buildRequestDataSet(const SpaceInfo &space,
   auto s = iter->size();
   vertices.rows.reserve(s);
 
-  std::unordered_set<VidType> uniqueSet;
+  folly::F14FastSet<VidType> uniqueSet;
   uniqueSet.reserve(s);
 
   const auto &vidType = *(space.spaceDesc.vid_type_ref());
@@ -73,6 +77,63 @@ bool StorageAccessExecutor::isIntVidType(const SpaceInfo &space) const {
   return (*space.spaceDesc.vid_type_ref()).type == nebula::cpp2::PropertyType::INT64;
 }
 
+int64_t StorageAccessExecutor::maxReadStalenessMs() const {
+  auto session = qctx()->rctx()->session()->getSession();
+  auto &configs = session.get_configs();
+  auto iter = configs.find("max_read_staleness_ms");
+  if (iter != configs.end() && iter->second.isInt()) {
+    return iter->second.getInt();
+  }
+  return FLAGS_max_read_staleness_ms;
+}
+
+bool StorageAccessExecutor::readFromAnalyticsReplicas() const {
+  auto session = qctx()->rctx()->session()->getSession();
+  auto &configs = session.get_configs();
+  auto iter = configs.find("analytical");
+  if (iter != configs.end() && iter->second.isBool()) {
+    return iter->second.getBool();
+  }
+  return FLAGS_read_from_analytics_replicas;
+}
+
+void StorageAccessExecutor::setReadDeadline(
+    storage::StorageClient::CommonRequestParam &param) const {
+  auto remaining = qctx()->remainingTimeMs();
+  // The time may be used up just after the executor is opened
+  param.timeoutMs = remaining < 0 ? 1 : remaining;
+  param.resourceGroup = qctx()->resourceGroup();
+  qctx()->onStorageRequest(param.space, param.session);
+}
+
+std::shared_ptr<const storage::cpp2::VidFilter> StorageAccessExecutor::buildVidFilter(
+    const Explore *node) const {
+  const auto &var = node->vidFilterVar();
+  if (var.empty() || !ectx_->exist(var)) {
+    return nullptr;
+  }
+  auto iter = ectx_->getResult(var).iter();
+  if (static_cast<int64_t>(iter->size()) > FLAGS_max_join_vid_filter_keys) {
+    return nullptr;
+  }
+  auto filter = BloomFilter::withKeys(iter->size());
+  QueryExpressionContext ctx(ectx_);
+  for (; iter->valid(); iter->next()) {
+    const auto &vid = node->vidFilterKey()->eval(ctx(iter.get()));
+    if (vid.isStr()) {
+      filter.add(vid.getStr());
+    } else if (vid.isInt()) {
+      // The int vid is sent to storage in its 8 bytes
+      auto id = vid.getInt();
+      filter.add(folly::StringPiece(reinterpret_cast<const char *>(&id), sizeof(id)));
+    }
+  }
+  auto vidFilter = std::make_shared<storage::cpp2::VidFilter>();
+  vidFilter->num_hashes_ref() = filter.numHashes();
+  vidFilter->bits_ref() = filter.moveBits();
+  return vidFilter;
+}
+
 DataSet StorageAccessExecutor::buildRequestDataSetByVidType(Iterator *iter,
                                                             Expression *expr,
                                                             bool dedup) {
@@ -96,5 +157,26 @@ std::string StorageAccessExecutor::getStorageDetail(
   return "";
 }
 
+std::string StorageAccessExecutor::getStorageNodes(
+    optional_field_ref<const std::vector<storage::cpp2::NodeProfile> &> ref) const {
+  if (!ref.has_value() || ref->empty()) {
+    return "";
+  }
+  auto content = util::join(
+      *ref,
+      [](auto &node) -> std::string {
+        auto str = folly::sformat("  {}: rows: {}, exec: {}(us)",
+                                  node.get_name(),
+                                  node.get_rows(),
+                                  node.get_exec_duration_in_us());
+        for (const auto &stat : node.get_stats()) {
+          str.append(folly::sformat(", {}: {}", stat.first, stat.second));
+        }
+        return str;
+      },
+      "\n");
+  return "{\n" + content + "\n}";
+}
+
 }  // namespace graph
 }  // namespace nebula
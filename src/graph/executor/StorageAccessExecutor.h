@@ -17,10 +17,17 @@ class Expression;
 namespace graph {
 
 class Iterator;
+class Explore;
 struct SpaceInfo;
 
 // It's used for data write/update/query
 class StorageAccessExecutor : public Executor {
+ public:
+  Status close() override {
+    qctx()->resourceUsage().addRowsScanned(numRows_);
+    return Executor::close();
+  }
+
  protected:
   StorageAccessExecutor(const std::string &name, const PlanNode *node, QueryContext *qctx)
       : Executor(name, node, qctx) {}
@@ -32,6 +39,7 @@ class StorageAccessExecutor : public Executor {
   template <typename Resp>
   StatusOr<Result::State> handleCompleteness(const storage::StorageRpcResponse<Resp> &rpcResp,
                                              bool isPartialSuccessAccepted) const {
+    qctx()->resourceUsage().addStorageRpcs(rpcResp.requestsSent(), rpcResp.responseBytes());
     auto completeness = rpcResp.completeness();
     if (completeness != 100) {
       const auto &failedCodes = rpcResp.failedParts();
@@ -128,6 +136,9 @@ class StorageAccessExecutor : public Executor {
             "Storage Error: Part {} raft buffer is full. Please retry later.", partId));
       case nebula::cpp2::ErrorCode::E_RAFT_ATOMIC_OP_FAILED:
         return Status::Error("Storage Error: Atomic operation failed.");
+      case nebula::cpp2::ErrorCode::E_RESOURCE_GROUP_OVERLOADED:
+        return Status::Error(
+            "Storage Error: Too many reads in flight of the resource group. Please retry later.");
       default:
         auto status = Status::Error("Storage Error: part: %d, error: %s(%d).",
                                     partId,
@@ -150,14 +161,39 @@ class StorageAccessExecutor : public Executor {
       if (!detail.empty()) {
         stats.emplace("storage_detail", detail);
       }
+      auto nodes = getStorageNodes(resp.responses()[i].result_ref()->node_profiles_ref());
+      if (!nodes.empty()) {
+        stats.emplace(folly::sformat("{} storage_nodes", std::get<0>(info).toString()), nodes);
+      }
     }
   }
 
   std::string getStorageDetail(
       apache::thrift::optional_field_ref<const std::map<std::string, int32_t> &> ref) const;
 
+  // Render the stats of the nodes of the storage plan of a profiled request, one node per line
+  std::string getStorageNodes(
+      apache::thrift::optional_field_ref<const std::vector<storage::cpp2::NodeProfile> &> ref)
+      const;
+
   bool isIntVidType(const SpaceInfo &space) const;
 
+  // The max staleness in milliseconds accepted by the reads of the session, 0 means the reads
+  // are only served by the leader
+  int64_t maxReadStalenessMs() const;
+
+  // Whether the reads of the session are served by the analytics replicas of the parts, so the
+  // heavy scans don't slow down the online reads and writes on the replicas of raft
+  bool readFromAnalyticsReplicas() const;
+
+  // Set the time left of the query as the timeout of the read request, and the resource group to
+  // run it. Record the request so that storage is told if the query is killed
+  void setReadDeadline(storage::StorageClient::CommonRequestParam &param) const;
+
+  // The bloom filter of the vids of the vid filter of the node, nullptr if it has none, or there
+  // are more than --max_join_vid_filter_keys rows to build it from
+  std::shared_ptr<const storage::cpp2::VidFilter> buildVidFilter(const Explore *node) const;
+
   DataSet buildRequestDataSetByVidType(Iterator *iter, Expression *expr, bool dedup);
 };
 
@@ -0,0 +1,28 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/executor/admin/ShowCardinalityFeedbackExecutor.h"
+
+#include "graph/optimizer/CardinalityFeedback.h"
+
+namespace nebula {
+namespace graph {
+
+folly::Future<Status> ShowCardinalityFeedbackExecutor::execute() {
+  SCOPED_TIMER(&execTime_);
+  DataSet ds({"Plan Node", "Estimated Rows", "Actual Rows", "Correction", "Runs", "Last Query"});
+  for (auto& entry : opt::CardinalityFeedback::instance().misestimates()) {
+    ds.emplace_back(Row({std::move(entry.key),
+                         entry.estimated,
+                         entry.actual,
+                         entry.correction,
+                         entry.runs,
+                         std::move(entry.query)}));
+  }
+  return finish(ResultBuilder().value(Value(std::move(ds))).build());
+}
+
+}  // namespace graph
+}  // namespace nebula
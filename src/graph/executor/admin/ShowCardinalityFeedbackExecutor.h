@@ -0,0 +1,26 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_EXECUTOR_ADMIN_SHOWCARDINALITYFEEDBACKEXECUTOR_H_
+#define GRAPH_EXECUTOR_ADMIN_SHOWCARDINALITYFEEDBACKEXECUTOR_H_
+
+#include "graph/executor/Executor.h"
+
+namespace nebula {
+namespace graph {
+
+// Show the cardinality feedback of this graphd, the largest misestimates first
+class ShowCardinalityFeedbackExecutor final : public Executor {
+ public:
+  ShowCardinalityFeedbackExecutor(const PlanNode *node, QueryContext *qctx)
+      : Executor("ShowCardinalityFeedbackExecutor", node, qctx) {}
+
+  folly::Future<Status> execute() override;
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_EXECUTOR_ADMIN_SHOWCARDINALITYFEEDBACKEXECUTOR_H_
@@ -24,15 +24,28 @@ folly::Future<Status> ShowQueriesExecutor::execute() {
   }
 }
 
+// static
+const std::vector<std::string>& ShowQueriesExecutor::columnNames() {
+  static const std::vector<std::string> kColumnNames = {"SessionID",
+                                                        "ExecutionPlanID",
+                                                        "User",
+                                                        "Host",
+                                                        "StartTime",
+                                                        "DurationInUSec",
+                                                        "MemoryInBytes",
+                                                        "Status",
+                                                        "Query",
+                                                        "CpuTimeInUSec",
+                                                        "PeakMemoryInBytes",
+                                                        "StorageRpcs",
+                                                        "StorageResponseBytes",
+                                                        "RowsScanned",
+                                                        "StageDurationInUSec"};
+  return kColumnNames;
+}
+
 folly::Future<Status> ShowQueriesExecutor::showCurrentSessionQueries() {
-  DataSet dataSet({"SessionID",
-                   "ExecutionPlanID",
-                   "User",
-                   "Host",
-                   "StartTime",
-                   "DurationInUSec",
-                   "Status",
-                   "Query"});
+  DataSet dataSet(columnNames());
   auto* session = qctx()->rctx()->session();
   auto sessionInMeta = session->getSession();
 
@@ -50,14 +63,7 @@ folly::Future<Status> ShowQueriesExecutor::showAllSessionQueries() {
           return Status::Error("Show sessions failed: %s.", resp.status().toString().c_str());
         }
         auto sessions = resp.value().get_sessions();
-        DataSet dataSet({"SessionID",
-                         "ExecutionPlanID",
-                         "User",
-                         "Host",
-                         "StartTime",
-                         "DurationInUSec",
-                         "Status",
-                         "Query"});
+        DataSet dataSet(columnNames());
         for (auto& session : sessions) {
           addQueries(session, dataSet);
         }
@@ -81,8 +87,24 @@ void ShowQueriesExecutor::addQueries(const meta::cpp2::Session& session, DataSet
     dateTime.microsec = query.second.get_start_time() % 1000000;
     row.values.emplace_back(std::move(dateTime));
     row.values.emplace_back(query.second.get_duration());
+    row.values.emplace_back(query.second.get_memory_in_bytes());
     row.values.emplace_back(apache::thrift::util::enumNameSafe(query.second.get_status()));
     row.values.emplace_back(query.second.get_query());
+    // The resources are missing in the queries of the graph services not accounting them
+    meta::cpp2::QueryResources resources;
+    if (query.second.resources_ref().has_value()) {
+      resources = *query.second.resources_ref();
+    }
+    row.values.emplace_back(resources.get_cpu_time_us());
+    row.values.emplace_back(resources.get_peak_memory_in_bytes());
+    row.values.emplace_back(resources.get_storage_rpcs());
+    row.values.emplace_back(resources.get_storage_response_bytes());
+    row.values.emplace_back(resources.get_rows_scanned());
+    Map stages;
+    for (const auto& stage : resources.get_stage_duration_us()) {
+      stages.kvs.emplace(stage.first, stage.second);
+    }
+    row.values.emplace_back(std::move(stages));
     dataSet.rows.emplace_back(std::move(row));
   }
 }
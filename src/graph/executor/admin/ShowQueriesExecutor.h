@@ -16,6 +16,9 @@ class ShowQueriesExecutor final : public Executor {
 
   folly::Future<Status> execute() override;
 
+  // The columns of the queries, in the order addQueries fills a row
+  static const std::vector<std::string>& columnNames();
+
  private:
   friend class ShowQueriesTest_TestAddQueryAndTopN_Test;
   folly::Future<Status> showCurrentSessionQueries();
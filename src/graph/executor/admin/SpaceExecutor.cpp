@@ -38,7 +38,7 @@ folly::Future<Status> CreateSpaceAsExecutor::execute() {
   auto newSpace = csaNode->getNewSpaceName();
   return qctx()
       ->getMetaClient()
-      ->createSpaceAs(oldSpace, newSpace)
+      ->createSpaceAs(oldSpace, newSpace, csaNode->withData())
       .via(runner())
       .thenValue([](StatusOr<bool> resp) {
         if (!resp.ok()) {
@@ -20,7 +20,7 @@ folly::Future<Status> BatchShortestPath::execute(const std::unordered_set<Value>
   futures.reserve(rowSize);
   for (size_t rowNum = 0; rowNum < rowSize; ++rowNum) {
     resultDs_[rowNum].colNames = pathNode_->colNames();
-    futures.emplace_back(shortestPath(rowNum, 1));
+    futures.emplace_back(shortestPath(rowNum));
   }
   return folly::collect(futures)
       .via(qctx_->rctx()->runner())
@@ -42,6 +42,8 @@ size_t BatchShortestPath::init(const std::unordered_set<Value>& startVids,
 
   leftVids_.reserve(rowSize);
   rightVids_.reserve(rowSize);
+  leftStats_.resize(rowSize);
+  rightStats_.resize(rowSize);
   allLeftPathMaps_.resize(rowSize);
   allRightPathMaps_.resize(rowSize);
   currentLeftPathMaps_.reserve(rowSize);
@@ -94,23 +96,49 @@ size_t BatchShortestPath::init(const std::unordered_set<Value>& startVids,
   return rowSize;
 }
 
-folly::Future<Status> BatchShortestPath::shortestPath(size_t rowNum, size_t stepNum) {
+folly::Future<Status> BatchShortestPath::shortestPath(size_t rowNum) {
+  auto direction = nextDirection(rowNum);
   std::vector<folly::Future<Status>> futures;
-  futures.emplace_back(getNeighbors(rowNum, stepNum, false));
-  futures.emplace_back(getNeighbors(rowNum, stepNum, true));
+  if (direction != Direction::kReverse) {
+    nextStep(rowNum, false);
+    futures.emplace_back(getNeighbors(rowNum, false));
+  }
+  if (direction != Direction::kForward) {
+    if (direction == Direction::kBoth) {
+      // The left step is checked against the right one before the right side is expanded
+      preRightPathMaps_[rowNum] = currentRightPathMaps_[rowNum];
+    }
+    nextStep(rowNum, true);
+    futures.emplace_back(getNeighbors(rowNum, true));
+  }
   return folly::collect(futures)
       .via(qctx_->rctx()->runner())
-      .thenValue([this, rowNum, stepNum](auto&& resps) {
+      .thenValue([this, rowNum, direction](auto&& resps) {
         for (auto& resp : resps) {
           if (!resp.ok()) {
             return folly::makeFuture<Status>(std::move(resp));
           }
         }
-        return handleResponse(rowNum, stepNum);
+        return handleResponse(rowNum, direction);
       });
 }
 
-folly::Future<Status> BatchShortestPath::getNeighbors(size_t rowNum, size_t stepNum, bool reverse) {
+void BatchShortestPath::nextStep(size_t rowNum, bool reverse) {
+  // The origin is kept in the last step by the first expansion, which has no history to build
+  // the paths from
+  if ((reverse ? rightStats_[rowNum] : leftStats_[rowNum]).depth == 0) {
+    return;
+  }
+  auto& historyPathMap = reverse ? allRightPathMaps_[rowNum] : allLeftPathMaps_[rowNum];
+  auto& currentPathMap = reverse ? currentRightPathMaps_[rowNum] : currentLeftPathMaps_[rowNum];
+  for (auto& iter : currentPathMap) {
+    historyPathMap[iter.first].insert(std::make_move_iterator(iter.second.begin()),
+                                      std::make_move_iterator(iter.second.end()));
+  }
+  currentPathMap.clear();
+}
+
+folly::Future<Status> BatchShortestPath::getNeighbors(size_t rowNum, bool reverse) {
   StorageClient* storageClient = qctx_->getStorageClient();
   time::Duration getNbrTime;
   storage::StorageClient::CommonRequestParam param(pathNode_->space(),
@@ -118,6 +146,9 @@ folly::Future<Status> BatchShortestPath::getNeighbors(size_t rowNum, size_t step
                                                    qctx_->plan()->id(),
                                                    qctx_->plan()->isProfileEnabled());
   auto& inputRows = reverse ? rightVids_[rowNum].rows : leftVids_[rowNum].rows;
+  auto& stats = reverse ? rightStats_[rowNum] : leftStats_[rowNum];
+  stats.vertices += inputRows.size();
+  auto stepNum = stats.depth + 1;
   return storageClient
       ->getNeighbors(param,
                      {nebula::kVid},
@@ -145,9 +176,10 @@ Status BatchShortestPath::buildPath(size_t rowNum, RpcResponse&& resps, bool rev
   NG_RETURN_IF_ERROR(result);
   auto& responses = std::move(resps).responses();
   List list;
+  list.values.reserve(responses.size());
   for (auto& resp : responses) {
-    auto dataset = resp.get_vertices();
-    if (dataset == nullptr) {
+    auto dataset = resp.vertices_ref();
+    if (!dataset.has_value()) {
       LOG(INFO) << "Empty dataset in response";
       continue;
     }
@@ -161,12 +193,14 @@ Status BatchShortestPath::buildPath(size_t rowNum, RpcResponse&& resps, bool rev
 Status BatchShortestPath::doBuildPath(size_t rowNum, GetNeighborsIter* iter, bool reverse) {
   auto& historyPathMap = reverse ? allRightPathMaps_[rowNum] : allLeftPathMaps_[rowNum];
   auto& currentPathMap = reverse ? currentRightPathMaps_[rowNum] : currentLeftPathMaps_[rowNum];
+  auto& stats = reverse ? rightStats_[rowNum] : leftStats_[rowNum];
 
   for (; iter->valid(); iter->next()) {
     auto edgeVal = iter->getEdge();
     if (UNLIKELY(!edgeVal.isEdge())) {
       continue;
     }
+    ++stats.edges;
     auto& edge = edgeVal.getEdge();
     auto src = edge.src;
     auto dst = edge.dst;
@@ -250,26 +284,28 @@ Status BatchShortestPath::doBuildPath(size_t rowNum, GetNeighborsIter* iter, boo
   }
   // set nextVid
   setNextStepVid(currentPathMap, rowNum, reverse);
+  ++stats.depth;
   return Status::OK();
 }
 
-folly::Future<Status> BatchShortestPath::handleResponse(size_t rowNum, size_t stepNum) {
+folly::Future<Status> BatchShortestPath::handleResponse(size_t rowNum, Direction direction) {
+  // The steps expanded together are checked as if the left one was expanded before the right one.
+  // Every step is checked against the last step of the other side, so the first meeting of each
+  // pair of vertices is the shortest one, all the shorter ones have been checked before.
   return folly::makeFuture(Status::OK())
       .via(qctx_->rctx()->runner())
-      .thenValue([this, rowNum](auto&& status) {
-        // odd step
+      .thenValue([this, rowNum, direction](auto&& status) {
         UNUSED(status);
-        return conjunctPath(rowNum, true);
+        return conjunctPath(rowNum, direction == Direction::kBoth);
       })
-      .thenValue([this, rowNum, stepNum](auto&& terminate) {
-        // even Step
-        if (terminate || stepNum * 2 > maxStep_) {
-          return folly::makeFuture<bool>(true);
+      .thenValue([this, rowNum, direction](auto&& terminate) {
+        if (terminate || direction != Direction::kBoth) {
+          return folly::makeFuture<bool>(std::move(terminate));
         }
         return conjunctPath(rowNum, false);
       })
-      .thenValue([this, rowNum, stepNum](auto&& result) {
-        if (result || stepNum * 2 >= maxStep_) {
+      .thenValue([this, rowNum](auto&& result) {
+        if (result || leftStats_[rowNum].depth + rightStats_[rowNum].depth >= maxStep_) {
           return folly::makeFuture<Status>(Status::OK());
         }
         auto& leftVids = leftVids_[rowNum].rows;
@@ -277,28 +313,14 @@ folly::Future<Status> BatchShortestPath::handleResponse(size_t rowNum, size_t st
         if (leftVids.empty() || rightVids.empty()) {
           return folly::makeFuture<Status>(Status::OK());
         }
-        // update allPathMap
-        auto& leftPathMap = currentLeftPathMaps_[rowNum];
-        auto& rightPathMap = currentRightPathMaps_[rowNum];
-        preRightPathMaps_[rowNum] = rightPathMap;
-        for (auto& iter : leftPathMap) {
-          allLeftPathMaps_[rowNum][iter.first].insert(std::make_move_iterator(iter.second.begin()),
-                                                      std::make_move_iterator(iter.second.end()));
-        }
-        for (auto& iter : rightPathMap) {
-          allRightPathMaps_[rowNum][iter.first].insert(std::make_move_iterator(iter.second.begin()),
-                                                       std::make_move_iterator(iter.second.end()));
-        }
-        leftPathMap.clear();
-        rightPathMap.clear();
-        return shortestPath(rowNum, stepNum + 1);
+        return shortestPath(rowNum);
       });
 }
 
 folly::Future<std::vector<Value>> BatchShortestPath::getMeetVids(size_t rowNum,
-                                                                 bool oddStep,
+                                                                 bool preRight,
                                                                  std::vector<Value>& meetVids) {
-  if (!oddStep) {
+  if (!preRight) {
     return getMeetVidsProps(meetVids);
   }
   std::vector<Value> vertices;
@@ -328,9 +350,9 @@ folly::Future<std::vector<Value>> BatchShortestPath::getMeetVids(size_t rowNum,
   return folly::makeFuture<std::vector<Value>>(std::move(vertices));
 }
 
-folly::Future<bool> BatchShortestPath::conjunctPath(size_t rowNum, bool oddStep) {
+folly::Future<bool> BatchShortestPath::conjunctPath(size_t rowNum, bool preRight) {
   auto& _leftPathMaps = currentLeftPathMaps_[rowNum];
-  auto& _rightPathMaps = oddStep ? preRightPathMaps_[rowNum] : currentRightPathMaps_[rowNum];
+  auto& _rightPathMaps = preRight ? preRightPathMaps_[rowNum] : currentRightPathMaps_[rowNum];
 
   std::vector<Value> meetVids;
   meetVids.reserve(_leftPathMaps.size());
@@ -344,59 +366,61 @@ folly::Future<bool> BatchShortestPath::conjunctPath(size_t rowNum, bool oddStep)
     return folly::makeFuture<bool>(false);
   }
 
-  auto future = getMeetVids(rowNum, oddStep, meetVids);
-  return future.via(qctx_->rctx()->runner()).thenValue([this, rowNum, oddStep](auto&& vertices) {
-    if (vertices.empty()) {
-      return false;
-    }
-    std::unordered_map<Value, Value> verticesMap;
-    for (auto& vertex : vertices) {
-      verticesMap[vertex.getVertex().vid] = std::move(vertex);
-    }
-    auto& terminationMap = terminationMaps_[rowNum];
-    auto& leftPathMaps = currentLeftPathMaps_[rowNum];
-    auto& rightPathMaps = oddStep ? preRightPathMaps_[rowNum] : currentRightPathMaps_[rowNum];
-    for (const auto& leftPathMap : leftPathMaps) {
-      auto findCommonVid = rightPathMaps.find(leftPathMap.first);
-      if (findCommonVid == rightPathMaps.end()) {
-        continue;
-      }
-      auto findCommonVertex = verticesMap.find(findCommonVid->first);
-      if (findCommonVertex == verticesMap.end()) {
-        continue;
-      }
-      auto& rightPaths = findCommonVid->second;
-      for (const auto& srcPaths : leftPathMap.second) {
-        auto range = terminationMap.equal_range(srcPaths.first);
-        if (range.first == range.second) {
-          continue;
+  auto future = getMeetVids(rowNum, preRight, meetVids);
+  return future.via(qctx_->rctx()->runner())
+      .thenValue([this, rowNum, preRight](auto&& vertices) {
+        if (vertices.empty()) {
+          return false;
+        }
+        std::unordered_map<Value, Value> verticesMap;
+        for (auto& vertex : vertices) {
+          verticesMap[vertex.getVertex().vid] = std::move(vertex);
         }
-        for (const auto& dstPaths : rightPaths) {
-          for (auto found = range.first; found != range.second; ++found) {
-            if (found->second.first == dstPaths.first) {
-              if (singleShortest_ && !found->second.second) {
-                break;
+        auto& terminationMap = terminationMaps_[rowNum];
+        auto& leftPathMaps = currentLeftPathMaps_[rowNum];
+        auto& rightPathMaps = preRight ? preRightPathMaps_[rowNum] : currentRightPathMaps_[rowNum];
+        for (const auto& leftPathMap : leftPathMaps) {
+          auto findCommonVid = rightPathMaps.find(leftPathMap.first);
+          if (findCommonVid == rightPathMaps.end()) {
+            continue;
+          }
+          auto findCommonVertex = verticesMap.find(findCommonVid->first);
+          if (findCommonVertex == verticesMap.end()) {
+            continue;
+          }
+          auto& rightPaths = findCommonVid->second;
+          for (const auto& srcPaths : leftPathMap.second) {
+            auto range = terminationMap.equal_range(srcPaths.first);
+            if (range.first == range.second) {
+              continue;
+            }
+            for (const auto& dstPaths : rightPaths) {
+              for (auto found = range.first; found != range.second; ++found) {
+                if (found->second.first == dstPaths.first) {
+                  if (singleShortest_ && !found->second.second) {
+                    break;
+                  }
+                  doConjunctPath(
+                      srcPaths.second, dstPaths.second, findCommonVertex->second, rowNum);
+                  found->second.second = false;
+                }
               }
-              doConjunctPath(srcPaths.second, dstPaths.second, findCommonVertex->second, rowNum);
-              found->second.second = false;
             }
           }
         }
-      }
-    }
-    // update terminationMap
-    for (auto iter = terminationMap.begin(); iter != terminationMap.end();) {
-      if (!iter->second.second) {
-        iter = terminationMap.erase(iter);
-      } else {
-        ++iter;
-      }
-    }
-    if (terminationMap.empty()) {
-      return true;
-    }
-    return false;
-  });
+        // update terminationMap
+        for (auto iter = terminationMap.begin(); iter != terminationMap.end();) {
+          if (!iter->second.second) {
+            iter = terminationMap.erase(iter);
+          } else {
+            ++iter;
+          }
+        }
+        if (terminationMap.empty()) {
+          return true;
+        }
+        return false;
+      });
 }
 
 void BatchShortestPath::doConjunctPath(const std::vector<CustomPath>& leftPaths,
@@ -404,6 +428,24 @@ void BatchShortestPath::doConjunctPath(const std::vector<CustomPath>& leftPaths,
                                        const Value& commonVertex,
                                        size_t rowNum) {
   auto& resultDs = resultDs_[rowNum];
+  if (leftPaths.empty()) {
+    // The common vertex is the start vertex, met by the right side
+    for (const auto& rightPath : rightPaths) {
+      auto backwardPath = rightPath.values;
+      std::reverse(backwardPath.begin(), backwardPath.end());
+      auto dst = backwardPath.back();
+      backwardPath.pop_back();
+      Row row;
+      row.emplace_back(commonVertex);
+      row.emplace_back(List(std::move(backwardPath)));
+      row.emplace_back(std::move(dst));
+      resultDs.rows.emplace_back(std::move(row));
+      if (singleShortest_) {
+        return;
+      }
+    }
+    return;
+  }
   if (rightPaths.empty()) {
     for (const auto& leftPath : leftPaths) {
       auto forwardPath = leftPath.values;
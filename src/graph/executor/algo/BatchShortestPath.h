@@ -29,20 +29,25 @@ class BatchShortestPath final : public ShortestPathBase {
 
   size_t init(const std::unordered_set<Value>& startVids, const std::unordered_set<Value>& endVids);
 
-  folly::Future<Status> getNeighbors(size_t rowNum, size_t stepNum, bool reverse);
+  folly::Future<Status> getNeighbors(size_t rowNum, bool reverse);
 
-  folly::Future<Status> shortestPath(size_t rowNum, size_t stepNum);
+  folly::Future<Status> shortestPath(size_t rowNum);
 
-  folly::Future<Status> handleResponse(size_t rowNum, size_t stepNum);
+  // Move the last step of one side to its history before expanding it again
+  void nextStep(size_t rowNum, bool reverse);
+
+  folly::Future<Status> handleResponse(size_t rowNum, Direction direction);
 
   Status buildPath(size_t rowNum, RpcResponse&& resp, bool reverse);
 
   Status doBuildPath(size_t rowNum, GetNeighborsIter* iter, bool reverse);
 
-  folly::Future<bool> conjunctPath(size_t rowNum, bool oddStep);
+  // Check whether the last step of the left side meets the last step of the right side, or the
+  // one before it if preRight
+  folly::Future<bool> conjunctPath(size_t rowNum, bool preRight);
 
   folly::Future<std::vector<Value>> getMeetVids(size_t rowNum,
-                                                bool oddStep,
+                                                bool preRight,
                                                 std::vector<Value>& meetVids);
 
   void doConjunctPath(const std::vector<CustomPath>& leftPaths,
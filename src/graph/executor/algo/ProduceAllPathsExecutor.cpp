@@ -18,7 +18,7 @@ folly::Future<Status> ProduceAllPathsExecutor::execute() {
     for (; rIter->valid(); rIter->next()) {
       auto& vid = rIter->getColumn(0);
       if (rightVids.emplace(vid).second) {
-        preRightPaths_[vid].push_back({Path(Vertex(vid, {}), {})});
+        preRightPaths_[vidId(vid)].push_back(kNone);
       }
     }
   }
@@ -32,6 +32,9 @@ folly::Future<Status> ProduceAllPathsExecutor::execute() {
       .via(runner())
       .thenValue([this](auto&& status) {
         UNUSED(status);
+        // The ids are interned by both sides, which are only read after both are built
+        setNextStepVid(leftPaths_, pathNode_->leftVidVar());
+        setNextStepVid(rightPaths_, pathNode_->rightVidVar());
         return conjunctPath();
       })
       .thenValue([this](auto&& status) {
@@ -48,50 +51,38 @@ Status ProduceAllPathsExecutor::buildPath(bool reverse) {
   auto iter = reverse ? ectx_->getResult(pathNode_->rightInputVar()).iter()
                       : ectx_->getResult(pathNode_->leftInputVar()).iter();
   DCHECK(iter);
+  auto& nodes = reverse ? rightNodes_ : leftNodes_;
   auto& currentPaths = reverse ? rightPaths_ : leftPaths_;
-  if (step_ == 1) {
-    for (; iter->valid(); iter->next()) {
-      auto edgeVal = iter->getEdge();
-      if (UNLIKELY(!edgeVal.isEdge())) {
-        continue;
-      }
-      auto& edge = edgeVal.getEdge();
-      auto& src = edge.src;
-      auto& dst = edge.dst;
-      if (noLoop_ && src == dst) {
-        continue;
-      }
-      Path path;
-      path.src = Vertex(src, {});
-      path.steps.emplace_back(Step(Vertex(dst, {}), edge.type, edge.name, edge.ranking, {}));
-      currentPaths[dst].emplace_back(std::move(path));
+  auto& historyPaths = reverse ? preRightPaths_ : preLeftPaths_;
+  for (; iter->valid(); iter->next()) {
+    auto edgeVal = iter->getEdge();
+    if (UNLIKELY(!edgeVal.isEdge())) {
+      continue;
+    }
+    auto& edge = edgeVal.getEdge();
+    if (step_ == 1 && noLoop_ && edge.src == edge.dst) {
+      continue;
+    }
+    PathNode node{
+        kNone, vidId(edge.src), vidId(edge.dst), nameId(edge.name), edge.type, edge.ranking};
+    if (step_ == 1) {
+      currentPaths[node.dst].emplace_back(nodes.size());
+      nodes.emplace_back(node);
+      continue;
+    }
+    auto found = historyPaths.find(node.src);
+    if (found == historyPaths.end()) {
+      continue;
     }
-  } else {
-    auto& historyPaths = reverse ? preRightPaths_ : preLeftPaths_;
-    for (; iter->valid(); iter->next()) {
-      auto edgeVal = iter->getEdge();
-      if (UNLIKELY(!edgeVal.isEdge())) {
+    for (auto parent : found->second) {
+      if (isDuplicated(nodes, parent, node)) {
         continue;
       }
-      auto& edge = edgeVal.getEdge();
-      auto& src = edge.src;
-      auto& dst = edge.dst;
-      for (const auto& histPath : historyPaths[src]) {
-        Path path = histPath;
-        path.steps.emplace_back(Step(Vertex(dst, {}), edge.type, edge.name, edge.ranking, {}));
-        if (path.hasDuplicateEdges()) {
-          continue;
-        }
-        if (noLoop_ && path.hasDuplicateVertices()) {
-          continue;
-        }
-        currentPaths[dst].emplace_back(std::move(path));
-      }
+      node.parent = parent;
+      currentPaths[node.dst].emplace_back(nodes.size());
+      nodes.emplace_back(node);
     }
   }
-  // set nextVid
-  const auto& nextVidVar = reverse ? pathNode_->rightVidVar() : pathNode_->leftVidVar();
-  setNextStepVid(currentPaths, nextVidVar);
   return Status::OK();
 }
 
@@ -105,20 +96,13 @@ DataSet ProduceAllPathsExecutor::doConjunct(Interims::iterator startIter,
     if (found == rightPaths.end()) {
       continue;
     }
-    for (const auto& lPath : startIter->second) {
-      for (const auto& rPath : found->second) {
-        auto forwardPath = lPath;
-        auto backwardPath = rPath;
-        backwardPath.reverse();
-        forwardPath.append(std::move(backwardPath));
-        if (forwardPath.hasDuplicateEdges()) {
-          continue;
-        }
-        if (noLoop_ && forwardPath.hasDuplicateVertices()) {
+    for (auto left : startIter->second) {
+      for (auto right : found->second) {
+        if (isDuplicated(left, right)) {
           continue;
         }
         Row row;
-        row.values.emplace_back(std::move(forwardPath));
+        row.values.emplace_back(toPath(left, right));
         ds.rows.emplace_back(std::move(row));
       }
     }
@@ -179,11 +163,104 @@ void ProduceAllPathsExecutor::setNextStepVid(Interims& paths, const string& var)
   ds.colNames = {nebula::kVid};
   for (const auto& path : paths) {
     Row row;
-    row.values.emplace_back(path.first);
+    row.values.emplace_back(vids_[path.first]);
     ds.rows.emplace_back(std::move(row));
   }
   ectx_->setResult(var, ResultBuilder().value(std::move(ds)).build());
 }
 
+uint32_t ProduceAllPathsExecutor::vidId(const Value& vid) {
+  folly::SpinLockGuard g(lock_);
+  auto ret = vidIds_.emplace(vid, vids_.size());
+  if (ret.second) {
+    vids_.emplace_back(vid);
+  }
+  return ret.first->second;
+}
+
+uint32_t ProduceAllPathsExecutor::nameId(const std::string& name) {
+  folly::SpinLockGuard g(lock_);
+  auto ret = nameIds_.emplace(name, names_.size());
+  if (ret.second) {
+    names_.emplace_back(name);
+  }
+  return ret.first->second;
+}
+
+namespace {
+// The edge key of a step regardless of its direction
+std::tuple<uint32_t, uint32_t, EdgeType, EdgeRanking> edgeKey(uint32_t src,
+                                                             uint32_t dst,
+                                                             EdgeType type,
+                                                             EdgeRanking ranking) {
+  if (type > 0) {
+    return {src, dst, type, ranking};
+  }
+  return {dst, src, -type, ranking};
+}
+}  // namespace
+
+bool ProduceAllPathsExecutor::isDuplicated(const std::vector<PathNode>& nodes,
+                                           uint32_t node,
+                                           const PathNode& step) const {
+  auto key = edgeKey(step.src, step.dst, step.type, step.ranking);
+  for (auto i = node; i != kNone; i = nodes[i].parent) {
+    const auto& prev = nodes[i];
+    if (edgeKey(prev.src, prev.dst, prev.type, prev.ranking) == key) {
+      return true;
+    }
+    if (noLoop_ && (prev.src == step.dst || prev.dst == step.dst)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ProduceAllPathsExecutor::isDuplicated(uint32_t left, uint32_t right) const {
+  if (right == kNone) {
+    return false;
+  }
+  // Both paths have no duplicates themselves, and they meet at the last vertex of both
+  std::vector<std::tuple<uint32_t, uint32_t, EdgeType, EdgeRanking>> keys;
+  std::vector<uint32_t> vids;
+  for (auto i = left; i != kNone; i = leftNodes_[i].parent) {
+    const auto& node = leftNodes_[i];
+    keys.emplace_back(edgeKey(node.src, node.dst, node.type, node.ranking));
+    vids.emplace_back(node.src);
+  }
+  for (auto i = right; i != kNone; i = rightNodes_[i].parent) {
+    const auto& node = rightNodes_[i];
+    auto key = edgeKey(node.src, node.dst, node.type, node.ranking);
+    if (std::find(keys.begin(), keys.end(), key) != keys.end()) {
+      return true;
+    }
+    if (noLoop_ && std::find(vids.begin(), vids.end(), node.src) != vids.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Path ProduceAllPathsExecutor::toPath(uint32_t left, uint32_t right) const {
+  std::vector<uint32_t> chain;
+  for (auto i = left; i != kNone; i = leftNodes_[i].parent) {
+    chain.emplace_back(i);
+  }
+  Path path;
+  path.src = Vertex(vids_[leftNodes_[chain.back()].src], {});
+  for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+    const auto& node = leftNodes_[*it];
+    path.steps.emplace_back(
+        Step(Vertex(vids_[node.dst], {}), node.type, names_[node.name], node.ranking, {}));
+  }
+  // The right path is appended reversed
+  for (auto i = right; i != kNone; i = rightNodes_[i].parent) {
+    const auto& node = rightNodes_[i];
+    path.steps.emplace_back(
+        Step(Vertex(vids_[node.src], {}), -node.type, names_[node.name], node.ranking, {}));
+  }
+  return path;
+}
+
 }  // namespace graph
 }  // namespace nebula
@@ -5,6 +5,8 @@
 #ifndef GRAPH_EXECUTOR_ALGO_PRODUCEALLPATHSEXECUTOR_H_
 #define GRAPH_EXECUTOR_ALGO_PRODUCEALLPATHSEXECUTOR_H_
 
+#include <folly/SpinLock.h>
+
 #include "graph/executor/Executor.h"
 
 // ProduceAllPath has two inputs.  GetNeighbors(From) & GetNeighbors(To)
@@ -32,9 +34,14 @@
 // `setNextStepVid`: set the vid that needs to be expanded in the next step
 
 // Member:
+// The paths are kept as path trees, one for each side. Every node of a tree is the last step of
+// a path, whose previous steps are its ancestors. The vids and edge names are interned as dense
+// ids of the query, and a path is only materialized when it's produced, so extending a path
+// costs a node instead of a copy of the whole path.
+//
 // `preLeftPaths_` : is hash table (only keep the previous step)
-//    KEY   : the VID of the vertex
-//    VALUE : all paths(the destination is KEY)
+//    KEY   : the id of the VID of the vertex
+//    VALUE : the nodes of all paths(the destination is KEY)
 //
 // `preRightPaths_` : same as preLeftPaths_
 // `leftPaths_` : same as preLeftPaths_(only keep the current step)
@@ -51,14 +58,38 @@ class ProduceAllPathsExecutor final : public Executor {
   folly::Future<Status> execute() override;
 
  private:
-  // k: dst, v: paths to dst
-  using Interims = std::unordered_map<Value, std::vector<Path>>;
+  static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+  // The last step of a path in the path tree of its side
+  struct PathNode {
+    // The node of the previous step, or kNone if it's the first step
+    uint32_t parent;
+    uint32_t src;
+    uint32_t dst;
+    uint32_t name;
+    EdgeType type;
+    EdgeRanking ranking;
+  };
+
+  // k: id of dst, v: nodes of the paths to dst, kNone for the path without any step
+  using Interims = std::unordered_map<uint32_t, std::vector<uint32_t>>;
 
   Status buildPath(bool reverse);
   folly::Future<Status> conjunctPath();
   DataSet doConjunct(Interims::iterator startIter, Interims::iterator endIter, bool oddStep) const;
   void setNextStepVid(Interims& paths, const string& var);
 
+  uint32_t vidId(const Value& vid);
+  uint32_t nameId(const std::string& name);
+
+  // Whether extending the path ending at node by step repeats an edge, or a vertex if noLoop_
+  bool isDuplicated(const std::vector<PathNode>& nodes, uint32_t node, const PathNode& step) const;
+  // Whether the path concatenated by the left path and the reversed right path repeats an edge, or
+  // a vertex if noLoop_
+  bool isDuplicated(uint32_t left, uint32_t right) const;
+
+  Path toPath(uint32_t left, uint32_t right) const;
+
  private:
   const ProduceAllPaths* pathNode_{nullptr};
   bool noLoop_{false};
@@ -68,6 +99,15 @@ class ProduceAllPathsExecutor final : public Executor {
   Interims preRightPaths_;
   Interims rightPaths_;
   DataSet currentDs_;
+
+  std::vector<PathNode> leftNodes_;
+  std::vector<PathNode> rightNodes_;
+  // Both sides intern the ids concurrently
+  folly::SpinLock lock_;
+  std::unordered_map<Value, uint32_t> vidIds_;
+  std::vector<Value> vids_;
+  std::unordered_map<std::string, uint32_t> nameIds_;
+  std::vector<std::string> names_;
 };
 }  // namespace graph
 }  // namespace nebula
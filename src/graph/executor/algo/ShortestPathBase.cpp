@@ -10,8 +10,38 @@
 using apache::thrift::optional_field_ref;
 using nebula::storage::StorageClient;
 
+DEFINE_double(shortest_path_skew_ratio,
+              2.0,
+              "Only the cheaper side is expanded by the bidirectional shortest path search if the "
+              "estimated cost of the other side is more than this times of it, otherwise both");
+
 namespace nebula {
 namespace graph {
+ShortestPathBase::Direction ShortestPathBase::nextDirection(size_t rowNum) const {
+  auto cost = [](const ExpandStats& stats, size_t frontier) -> double {
+    // Take the degree as one before anything is expanded
+    if (stats.vertices == 0) {
+      return frontier;
+    }
+    return static_cast<double>(frontier) * stats.edges / stats.vertices;
+  };
+  const auto& left = leftStats_[rowNum];
+  const auto& right = rightStats_[rowNum];
+  auto leftCost = cost(left, leftVids_[rowNum].rows.size());
+  auto rightCost = cost(right, rightVids_[rowNum].rows.size());
+  auto ratio = std::max(FLAGS_shortest_path_skew_ratio, 1.0);
+  if (leftCost > rightCost * ratio) {
+    return Direction::kReverse;
+  }
+  if (rightCost > leftCost * ratio) {
+    return Direction::kForward;
+  }
+  if (left.depth + right.depth + 2 <= maxStep_) {
+    return Direction::kBoth;
+  }
+  return leftCost <= rightCost ? Direction::kForward : Direction::kReverse;
+}
+
 folly::Future<std::vector<Value>> ShortestPathBase::getMeetVidsProps(
     const std::vector<Value>& meetVids) {
   nebula::DataSet vertices({kVid});
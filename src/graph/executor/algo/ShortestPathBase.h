@@ -36,7 +36,28 @@ class ShortestPathBase {
   // save the starting vertex and the corresponding edge. eg [vertex(a), edge(a->b)]
   using CustomStep = Row;
 
+  // The sides to expand by the next step of the bidirectional search
+  enum class Direction : uint8_t {
+    kForward,
+    kReverse,
+    kBoth,
+  };
+
+  // The expansions done by one side of the bidirectional search
+  struct ExpandStats {
+    // Number of the steps expanded
+    size_t depth{0};
+    // Number of the vertices expanded, and of the edges returned by storage for them
+    size_t vertices{0};
+    size_t edges{0};
+  };
+
  protected:
+  // Choose the side whose frontier is estimated to be cheaper to expand, by the average degree of
+  // the vertices expanded by that side before. Both sides are expanded concurrently if neither is
+  // much cheaper than the other and the steps left allow it.
+  Direction nextDirection(size_t rowNum) const;
+
   folly::Future<std::vector<Value>> getMeetVidsProps(const std::vector<Value>& meetVids);
 
   std::vector<Value> handlePropResp(PropRpcResponse&& resps);
@@ -85,6 +106,8 @@ class ShortestPathBase {
   std::vector<DataSet> resultDs_;
   std::vector<DataSet> leftVids_;
   std::vector<DataSet> rightVids_;
+  std::vector<ExpandStats> leftStats_;
+  std::vector<ExpandStats> rightStats_;
 };
 
 }  // namespace graph
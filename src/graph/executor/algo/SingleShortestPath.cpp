@@ -19,7 +19,7 @@ folly::Future<Status> SingleShortestPath::execute(const std::unordered_set<Value
   futures.reserve(rowSize);
   for (size_t rowNum = 0; rowNum < rowSize; ++rowNum) {
     resultDs_[rowNum].colNames = pathNode_->colNames();
-    futures.emplace_back(shortestPath(rowNum, 1));
+    futures.emplace_back(shortestPath(rowNum));
   }
   return folly::collect(futures)
       .via(qctx_->rctx()->runner())
@@ -40,20 +40,24 @@ void SingleShortestPath::init(const std::unordered_set<Value>& startVids,
                               size_t rowSize) {
   leftVids_.reserve(rowSize);
   rightVids_.reserve(rowSize);
+  leftStats_.resize(rowSize);
+  rightStats_.resize(rowSize);
 
-  leftVisitedVids_.resize(rowSize);
-  rightVisitedVids_.resize(rowSize);
+  leftVisitedVids_.reserve(rowSize);
+  rightVisitedVids_.reserve(rowSize);
 
-  allLeftPaths_.resize(rowSize);
+  allLeftPaths_.reserve(rowSize);
   allRightPaths_.reserve(rowSize);
   resultDs_.resize(rowSize);
   for (const auto& startVid : startVids) {
     for (const auto& endVid : endVids) {
-      std::unordered_map<Value, std::vector<Row>> steps;
-      std::vector<Row> dummy;
-      steps.emplace(endVid, std::move(dummy));
-      HalfPath originRightPath({std::move(steps)});
-      allRightPaths_.emplace_back(std::move(originRightPath));
+      std::unordered_map<Value, std::vector<Row>> leftSteps, rightSteps;
+      leftSteps.emplace(startVid, std::vector<Row>());
+      rightSteps.emplace(endVid, std::vector<Row>());
+      allLeftPaths_.emplace_back(HalfPath({std::move(leftSteps)}));
+      allRightPaths_.emplace_back(HalfPath({std::move(rightSteps)}));
+      leftVisitedVids_.emplace_back(std::unordered_set<Value>({startVid}));
+      rightVisitedVids_.emplace_back(std::unordered_set<Value>({endVid}));
 
       DataSet startDs, endDs;
       startDs.rows.emplace_back(Row({startVid}));
@@ -64,26 +68,29 @@ void SingleShortestPath::init(const std::unordered_set<Value>& startVids,
   }
 }
 
-folly::Future<Status> SingleShortestPath::shortestPath(size_t rowNum, size_t stepNum) {
+folly::Future<Status> SingleShortestPath::shortestPath(size_t rowNum) {
+  auto direction = nextDirection(rowNum);
   std::vector<folly::Future<Status>> futures;
   futures.reserve(2);
-  futures.emplace_back(getNeighbors(rowNum, stepNum, false));
-  futures.emplace_back(getNeighbors(rowNum, stepNum, true));
+  if (direction != Direction::kReverse) {
+    futures.emplace_back(getNeighbors(rowNum, false));
+  }
+  if (direction != Direction::kForward) {
+    futures.emplace_back(getNeighbors(rowNum, true));
+  }
   return folly::collect(futures)
       .via(qctx_->rctx()->runner())
-      .thenValue([this, rowNum, stepNum](auto&& resps) {
+      .thenValue([this, rowNum, direction](auto&& resps) {
         for (auto& resp : resps) {
           if (!resp.ok()) {
             return folly::makeFuture<Status>(std::move(resp));
           }
         }
-        return handleResponse(rowNum, stepNum);
+        return handleResponse(rowNum, direction);
       });
 }
 
-folly::Future<Status> SingleShortestPath::getNeighbors(size_t rowNum,
-                                                       size_t stepNum,
-                                                       bool reverse) {
+folly::Future<Status> SingleShortestPath::getNeighbors(size_t rowNum, bool reverse) {
   StorageClient* storageClient = qctx_->getStorageClient();
   time::Duration getNbrTime;
   storage::StorageClient::CommonRequestParam param(pathNode_->space(),
@@ -91,6 +98,9 @@ folly::Future<Status> SingleShortestPath::getNeighbors(size_t rowNum,
                                                    qctx_->plan()->id(),
                                                    qctx_->plan()->isProfileEnabled());
   auto& inputRows = reverse ? rightVids_[rowNum].rows : leftVids_[rowNum].rows;
+  auto& stats = reverse ? rightStats_[rowNum] : leftStats_[rowNum];
+  stats.vertices += inputRows.size();
+  auto stepNum = stats.depth + 1;
   return storageClient
       ->getNeighbors(param,
                      {nebula::kVid},
@@ -118,9 +128,10 @@ Status SingleShortestPath::buildPath(size_t rowNum, RpcResponse&& resps, bool re
   NG_RETURN_IF_ERROR(result);
   auto& responses = std::move(resps).responses();
   List list;
+  list.values.reserve(responses.size());
   for (auto& resp : responses) {
-    auto dataset = resp.get_vertices();
-    if (dataset == nullptr) {
+    auto dataset = resp.vertices_ref();
+    if (!dataset.has_value()) {
       LOG(INFO) << "Empty dataset in response";
       continue;
     }
@@ -136,6 +147,7 @@ Status SingleShortestPath::doBuildPath(size_t rowNum, GetNeighborsIter* iter, bo
   auto& visitedVids = reverse ? rightVisitedVids_[rowNum] : leftVisitedVids_[rowNum];
   visitedVids.reserve(visitedVids.size() + iterSize);
   auto& allSteps = reverse ? allRightPaths_[rowNum] : allLeftPaths_[rowNum];
+  auto& stats = reverse ? rightStats_[rowNum] : leftStats_[rowNum];
   allSteps.emplace_back();
   auto& currentStep = allSteps.back();
 
@@ -150,6 +162,7 @@ Status SingleShortestPath::doBuildPath(size_t rowNum, GetNeighborsIter* iter, bo
     if (UNLIKELY(!edgeVal.isEdge())) {
       continue;
     }
+    ++stats.edges;
     auto& edge = edgeVal.getEdge();
     auto dst = edge.dst;
     if (visitedVids.find(dst) != visitedVids.end()) {
@@ -174,6 +187,7 @@ Status SingleShortestPath::doBuildPath(size_t rowNum, GetNeighborsIter* iter, bo
   }
   visitedVids.insert(std::make_move_iterator(uniqueDst.begin()),
                      std::make_move_iterator(uniqueDst.end()));
+  ++stats.depth;
   if (reverse) {
     rightVids_[rowNum].rows.swap(nextStepVids);
   } else {
@@ -182,15 +196,15 @@ Status SingleShortestPath::doBuildPath(size_t rowNum, GetNeighborsIter* iter, bo
   return Status::OK();
 }
 
-folly::Future<Status> SingleShortestPath::handleResponse(size_t rowNum, size_t stepNum) {
+folly::Future<Status> SingleShortestPath::handleResponse(size_t rowNum, Direction direction) {
   return folly::makeFuture<Status>(Status::OK())
       .via(qctx_->rctx()->runner())
-      .thenValue([this, rowNum, stepNum](auto&& status) {
+      .thenValue([this, rowNum, direction](auto&& status) {
         UNUSED(status);
-        return conjunctPath(rowNum, stepNum);
+        return conjunctPath(rowNum, direction);
       })
-      .thenValue([this, rowNum, stepNum](auto&& result) {
-        if (result || stepNum * 2 >= maxStep_) {
+      .thenValue([this, rowNum](auto&& result) {
+        if (result || leftStats_[rowNum].depth + rightStats_[rowNum].depth >= maxStep_) {
           return folly::makeFuture<Status>(Status::OK());
         }
         auto& leftVids = leftVids_[rowNum].rows;
@@ -198,169 +212,149 @@ folly::Future<Status> SingleShortestPath::handleResponse(size_t rowNum, size_t s
         if (leftVids.empty() || rightVids.empty()) {
           return folly::makeFuture<Status>(Status::OK());
         }
-        return shortestPath(rowNum, stepNum + 1);
+        return shortestPath(rowNum);
       });
 }
 
-folly::Future<bool> SingleShortestPath::conjunctPath(size_t rowNum, size_t stepNum) {
-  const auto& leftStep = allLeftPaths_[rowNum].back();
-  const auto& prevRightStep = allRightPaths_[rowNum][stepNum - 1];
-  std::vector<Value> meetVids;
-  for (const auto& step : leftStep) {
-    if (prevRightStep.find(step.first) != prevRightStep.end()) {
-      meetVids.push_back(step.first);
-      if (singleShortest_) {
-        break;
-      }
+folly::Future<bool> SingleShortestPath::conjunctPath(size_t rowNum, Direction direction) {
+  const auto& leftSteps = allLeftPaths_[rowNum];
+  const auto& rightSteps = allRightPaths_[rowNum];
+  auto leftDepth = leftSteps.size() - 1;
+  auto rightDepth = rightSteps.size() - 1;
+  // The steps expanded together are checked as if the left one was expanded before the right one.
+  // Every step is checked against the last step of the other side, so the first meeting is the
+  // shortest one, all the shorter ones have been checked before.
+  if (direction != Direction::kReverse) {
+    auto depth = direction == Direction::kBoth ? rightDepth - 1 : rightDepth;
+    auto meetVids = findMeetVids(leftSteps.back(), rightSteps[depth]);
+    if (!meetVids.empty()) {
+      return buildPaths(rowNum, leftDepth, depth, meetVids);
     }
   }
-  if (!meetVids.empty()) {
-    buildOddPath(rowNum, meetVids);
-    return folly::makeFuture<bool>(true);
-  }
-  if (stepNum * 2 > maxStep_) {
-    return folly::makeFuture<bool>(false);
+  if (direction != Direction::kForward) {
+    auto meetVids = findMeetVids(leftSteps.back(), rightSteps.back());
+    if (!meetVids.empty()) {
+      return buildPaths(rowNum, leftDepth, rightDepth, meetVids);
+    }
   }
+  return folly::makeFuture<bool>(false);
+}
 
-  const auto& rightStep = allRightPaths_[rowNum].back();
-  for (const auto& step : leftStep) {
-    if (rightStep.find(step.first) != rightStep.end()) {
+std::vector<Value> SingleShortestPath::findMeetVids(
+    const std::unordered_map<DstVid, std::vector<CustomStep>>& lhs,
+    const std::unordered_map<DstVid, std::vector<CustomStep>>& rhs) {
+  const auto& small = lhs.size() <= rhs.size() ? lhs : rhs;
+  const auto& large = lhs.size() <= rhs.size() ? rhs : lhs;
+  std::vector<Value> meetVids;
+  for (const auto& step : small) {
+    if (large.find(step.first) != large.end()) {
       meetVids.push_back(step.first);
       if (singleShortest_) {
         break;
       }
     }
   }
-  if (meetVids.empty()) {
-    return folly::makeFuture<bool>(false);
-  }
-  return buildEvenPath(rowNum, meetVids);
+  return meetVids;
 }
 
-void SingleShortestPath::buildOddPath(size_t rowNum, const std::vector<Value>& meetVids) {
-  for (auto& meetVid : meetVids) {
-    auto leftPaths = createLeftPath(rowNum, meetVid);
-    auto rightPaths = createRightPath(rowNum, meetVid, true);
-    for (auto& leftPath : leftPaths) {
-      for (auto& rightPath : rightPaths) {
-        Row path = leftPath;
-        auto& steps = path.values.back().mutableList().values;
-        steps.insert(steps.end(), rightPath.values.begin(), rightPath.values.end() - 1);
-        path.emplace_back(rightPath.values.back());
-        resultDs_[rowNum].rows.emplace_back(std::move(path));
-        if (singleShortest_) {
+folly::Future<bool> SingleShortestPath::buildPaths(size_t rowNum,
+                                                   size_t leftDepth,
+                                                   size_t rightDepth,
+                                                   const std::vector<Value>& meetVids) {
+  // A meet vertex is the source of the steps of the next depth if it's expanded by either side,
+  // otherwise its properties are fetched from storage
+  std::vector<Value> vertices;
+  vertices.reserve(meetVids.size());
+  std::unordered_set<Value> missing(meetVids.begin(), meetVids.end());
+  auto collect = [&vertices, &missing](const HalfPath& allSteps, size_t depth) {
+    if (depth + 1 >= allSteps.size()) {
+      return;
+    }
+    for (const auto& steps : allSteps[depth + 1]) {
+      for (const auto& step : steps.second) {
+        if (missing.empty()) {
           return;
         }
+        const auto& vertex = step.values.front();
+        if (missing.erase(vertex.getVertex().vid) > 0) {
+          vertices.emplace_back(vertex);
+        }
       }
     }
-  }
-}
+  };
+  collect(allLeftPaths_[rowNum], leftDepth);
+  collect(allRightPaths_[rowNum], rightDepth);
 
-folly::Future<bool> SingleShortestPath::buildEvenPath(size_t rowNum,
-                                                      const std::vector<Value>& meetVids) {
-  auto future = getMeetVidsProps(meetVids);
-  return future.via(qctx_->rctx()->runner()).thenValue([this, rowNum](auto&& vertices) {
-    if (vertices.empty()) {
-      return false;
-    }
-    for (auto& meetVertex : vertices) {
-      if (!meetVertex.isVertex()) {
-        continue;
-      }
-      auto meetVid = meetVertex.getVertex().vid;
-      auto leftPaths = createLeftPath(rowNum, meetVid);
-      auto rightPaths = createRightPath(rowNum, meetVid, false);
-      for (auto& leftPath : leftPaths) {
-        for (auto& rightPath : rightPaths) {
-          Row path = leftPath;
-          auto& steps = path.values.back().mutableList().values;
-          steps.emplace_back(meetVertex);
-          steps.insert(steps.end(), rightPath.values.begin(), rightPath.values.end() - 1);
-          path.emplace_back(rightPath.values.back());
-          resultDs_[rowNum].rows.emplace_back(std::move(path));
-          if (singleShortest_) {
-            return true;
+  auto future = missing.empty()
+                    ? folly::makeFuture<std::vector<Value>>(std::vector<Value>())
+                    : getMeetVidsProps(std::vector<Value>(missing.begin(), missing.end()));
+  return std::move(future)
+      .via(qctx_->rctx()->runner())
+      .thenValue([this, rowNum, leftDepth, rightDepth, vertices = std::move(vertices)](
+                     auto&& fetched) mutable {
+        vertices.insert(vertices.end(),
+                        std::make_move_iterator(fetched.begin()),
+                        std::make_move_iterator(fetched.end()));
+        auto& rows = resultDs_[rowNum].rows;
+        for (auto& meetVertex : vertices) {
+          if (!meetVertex.isVertex()) {
+            continue;
+          }
+          const auto& meetVid = meetVertex.getVertex().vid;
+          auto leftPaths = createHalfPath(allLeftPaths_[rowNum], meetVid, leftDepth);
+          auto rightPaths = createHalfPath(allRightPaths_[rowNum], meetVid, rightDepth);
+          for (auto& leftPath : leftPaths) {
+            for (auto& rightPath : rightPaths) {
+              std::vector<Value> steps = leftPath.values;
+              steps.emplace_back(meetVertex);
+              steps.insert(steps.end(), rightPath.values.rbegin(), rightPath.values.rend());
+              Row path;
+              path.emplace_back(std::move(steps.front()));
+              auto dst = std::move(steps.back());
+              steps.pop_back();
+              steps.erase(steps.begin());
+              path.emplace_back(List(std::move(steps)));
+              path.emplace_back(std::move(dst));
+              rows.emplace_back(std::move(path));
+              if (singleShortest_) {
+                return true;
+              }
+            }
           }
         }
-      }
-    }
-    return true;
-  });
+        return !rows.empty();
+      });
 }
 
-std::vector<Row> SingleShortestPath::createLeftPath(size_t rowNum, const Value& meetVid) {
-  auto& allSteps = allLeftPaths_[rowNum];
-  auto& lastSteps = allSteps.back();
-  auto findMeetVid = lastSteps.find(meetVid);
-  std::vector<Row> leftPaths(findMeetVid->second);
-  for (auto stepIter = allSteps.rbegin() + 1; stepIter != allSteps.rend(); ++stepIter) {
-    std::vector<Row> temp;
-    for (auto& leftPath : leftPaths) {
-      Value id = leftPath.values.front().getVertex().vid;
-      auto findId = stepIter->find(id);
-      for (auto& step : findId->second) {
-        auto newPath = leftPath;
-        newPath.values.insert(newPath.values.begin(), step.values.begin(), step.values.end());
-        temp.emplace_back(std::move(newPath));
-      }
-    }
-    leftPaths.swap(temp);
+// static
+std::vector<Row> SingleShortestPath::createHalfPath(const HalfPath& allSteps,
+                                                    const Value& meetVid,
+                                                    size_t depth) {
+  if (depth == 0) {
+    return {Row()};
   }
-  std::vector<Row> result;
-  result.reserve(leftPaths.size());
-  for (auto& path : leftPaths) {
-    Row row;
-    auto src = path.values.front();
-    path.values.erase(path.values.begin());
-    row.emplace_back(std::move(src));
-    row.emplace_back(std::move(path));
-    result.emplace_back(std::move(row));
-  }
-  return result;
-}
-
-std::vector<Row> SingleShortestPath::createRightPath(size_t rowNum,
-                                                     const Value& meetVid,
-                                                     bool oddStep) {
-  auto& allSteps = allRightPaths_[rowNum];
-  std::vector<Row> rightPaths;
-  auto& lastSteps = allSteps.back();
-  if (oddStep) {
-    for (auto& steps : lastSteps) {
-      bool flag = false;
-      for (auto& step : steps.second) {
-        auto& vertex = step.values.front();
-        if (vertex.getVertex().vid == meetVid) {
-          rightPaths.emplace_back(Row({vertex}));
-          flag = true;
-          break;
-        }
-      }
-      if (flag) {
-        break;
-      }
-    }
-  } else {
-    auto findMeetVid = lastSteps.find(meetVid);
-    rightPaths = findMeetVid->second;
+  auto findMeetVid = allSteps[depth].find(meetVid);
+  if (findMeetVid == allSteps[depth].end()) {
+    return {};
   }
-  for (auto stepIter = allSteps.rbegin() + 1; stepIter != allSteps.rend() - 1; ++stepIter) {
+  std::vector<Row> paths(findMeetVid->second);
+  for (size_t i = depth - 1; i > 0; --i) {
     std::vector<Row> temp;
-    for (auto& rightPath : rightPaths) {
-      Value id = rightPath.values.front().getVertex().vid;
-      auto findId = stepIter->find(id);
+    for (auto& path : paths) {
+      const auto& id = path.values.front().getVertex().vid;
+      auto findId = allSteps[i].find(id);
+      if (findId == allSteps[i].end()) {
+        continue;
+      }
       for (auto& step : findId->second) {
-        auto newPath = rightPath;
-        newPath.values.insert(newPath.values.begin(), step.values.begin(), step.values.end());
+        auto newPath = step;
+        newPath.values.insert(newPath.values.end(), path.values.begin(), path.values.end());
         temp.emplace_back(std::move(newPath));
       }
     }
-    rightPaths.swap(temp);
-  }
-  for (auto& path : rightPaths) {
-    std::reverse(path.values.begin(), path.values.end());
+    paths.swap(temp);
   }
-  return rightPaths;
+  return paths;
 }
 
 }  // namespace graph
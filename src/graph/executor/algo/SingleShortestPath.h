@@ -20,6 +20,7 @@ class SingleShortestPath final : public ShortestPathBase {
                                 const std::unordered_set<Value>& endVids,
                                 DataSet* result) override;
 
+  // The steps of one side, the i-th one of which is the vertices i steps away from the origin
   using HalfPath = std::vector<std::unordered_map<DstVid, std::vector<CustomStep>>>;
 
  private:
@@ -27,25 +28,34 @@ class SingleShortestPath final : public ShortestPathBase {
             const std::unordered_set<Value>& endVids,
             size_t rowSize);
 
-  folly::Future<Status> shortestPath(size_t rowNum, size_t stepNum);
+  folly::Future<Status> shortestPath(size_t rowNum);
 
-  folly::Future<Status> getNeighbors(size_t rowNum, size_t stepNum, bool reverse);
+  folly::Future<Status> getNeighbors(size_t rowNum, bool reverse);
 
   Status buildPath(size_t rowNum, RpcResponse&& resps, bool reverse);
 
   Status doBuildPath(size_t rowNum, GetNeighborsIter* iter, bool reverse);
 
-  folly::Future<Status> handleResponse(size_t rowNum, size_t stepNum);
+  folly::Future<Status> handleResponse(size_t rowNum, Direction direction);
 
-  folly::Future<bool> conjunctPath(size_t rowNum, size_t stepNum);
+  // Check whether the steps just expanded meet the other side, and build the paths if so
+  folly::Future<bool> conjunctPath(size_t rowNum, Direction direction);
 
-  folly::Future<bool> buildEvenPath(size_t rowNum, const std::vector<Value>& meetVids);
+  std::vector<Value> findMeetVids(const std::unordered_map<DstVid, std::vector<CustomStep>>& lhs,
+                                  const std::unordered_map<DstVid, std::vector<CustomStep>>& rhs);
 
-  void buildOddPath(size_t rowNum, const std::vector<Value>& meetVids);
+  // Build the paths through the meet vertices, which are leftDepth steps away from the start
+  // vertex and rightDepth steps away from the end vertex
+  folly::Future<bool> buildPaths(size_t rowNum,
+                                 size_t leftDepth,
+                                 size_t rightDepth,
+                                 const std::vector<Value>& meetVids);
 
-  std::vector<Row> createRightPath(size_t rowNum, const Value& meetVid, bool evenStep);
-
-  std::vector<Row> createLeftPath(size_t rowNum, const Value& meetVid);
+  // Build the paths from the origin of the half path to the meet vertex of the given depth, each
+  // of them is [vertex, edge, vertex, edge, ...] without the meet vertex
+  static std::vector<Row> createHalfPath(const HalfPath& allSteps,
+                                         const Value& meetVid,
+                                         size_t depth);
 
  private:
   std::vector<std::unordered_set<Value>> leftVisitedVids_;
@@ -27,7 +27,7 @@ folly::Future<Status> SubgraphExecutor::execute() {
   ResultBuilder builder;
   builder.value(iter->valuePtr());
 
-  std::unordered_map<Value, int64_t> currentVids;
+  VidMap<int64_t> currentVids;
   currentVids.reserve(gnSize);
   historyVids_.reserve(historyVids_.size() + gnSize);
   if (currentStep == 1) {
@@ -80,6 +80,16 @@ folly::Future<Status> SubgraphExecutor::execute() {
   // update historyVids
   historyVids_.insert(std::make_move_iterator(currentVids.begin()),
                       std::make_move_iterator(currentVids.end()));
+  // Only the edges among the visited vertices are kept in the last step, so storage is asked to
+  // return none of the others
+  if (currentStep + 1 == steps && !subgraph->dstFilterVar().empty()) {
+    Set visited;
+    visited.values.reserve(historyVids_.size());
+    for (const auto& vid : historyVids_) {
+      visited.values.emplace(vid.first);
+    }
+    ectx_->setValue(subgraph->dstFilterVar(), Value(std::move(visited)));
+  }
   return finish(ResultBuilder().value(Value(std::move(ds))).build());
 }
 
@@ -6,6 +6,7 @@
 #define GRAPH_EXECUTOR_ALGO_SUBGRAPHEXECUTOR_H_
 
 #include "graph/executor/Executor.h"
+#include "graph/util/VidHash.h"
 
 // Subgraph receive result from GetNeighbors
 // There are two Main functions
@@ -45,7 +46,7 @@ class SubgraphExecutor : public Executor {
   folly::Future<Status> execute() override;
 
  private:
-  std::unordered_map<Value, int64_t> historyVids_;
+  VidMap<int64_t> historyVids_;
 };
 
 }  // namespace graph
@@ -23,7 +23,8 @@ folly::Future<Status> CreateEdgeIndexExecutor::execute() {
                         ceiNode->getFields(),
                         ceiNode->getIfNotExists(),
                         ceiNode->getIndexParams(),
-                        ceiNode->getComment())
+                        ceiNode->getComment(),
+                        ceiNode->getIncludeFields())
       .via(runner())
       .thenValue([ceiNode, spaceId](StatusOr<IndexID> resp) {
         if (!resp.ok()) {
@@ -5,20 +5,41 @@
 #include "graph/executor/query/AggregateExecutor.h"
 
 #include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 
 namespace nebula {
 namespace graph {
 
+AggData* AggregateExecutor::GroupTable::find(List&& key, size_t numItems) {
+  auto res = groups.emplace(std::move(key), groups.size());
+  if (res.second) {
+    states.resize(states.size() + numItems);
+  }
+  return states.data() + res.first->second * numItems;
+}
+
 folly::Future<Status> AggregateExecutor::execute() {
   SCOPED_TIMER(&execTime_);
   auto* agg = asNode<Aggregate>(node());
-  auto groupKeys = agg->groupKeys();
-  auto groupItems = agg->groupItems();
   auto iter = ectx_->getResult(agg->inputVar()).iter();
   DCHECK(!!iter);
+
+  if (FLAGS_max_job_size > 1 && !iter->isGetNeighborsIter() &&
+      iter->size() > static_cast<size_t>(FLAGS_min_batch_size)) {
+    // GetNeighborsIter is not thread safe
+    return aggregateMultiJobs(iter.get());
+  }
+  return aggregate(iter.get());
+}
+
+Status AggregateExecutor::aggregate(Iterator* iter) {
+  auto* agg = asNode<Aggregate>(node());
+  auto groupKeys = agg->groupKeys();
+  auto groupItems = agg->groupItems();
   QueryExpressionContext ctx(ectx_);
 
-  std::unordered_map<List, std::vector<std::unique_ptr<AggData>>, std::hash<nebula::List>> result;
+  std::vector<GroupTable> tables(1);
+  auto& table = tables.front();
 
   // generate default result when input dataset is empty
   if (UNLIKELY(!iter->valid())) {
@@ -32,56 +53,132 @@ folly::Future<Status> AggregateExecutor::execute() {
       }
       AggData aggData;
       static_cast<AggregateExpression*>(item)->apply(&aggData, Value::kNullValue);
+      aggData.finish();
       defaultValues.emplace_back(aggData.result());
     }
     if (allAggItems) {
-      List dummyKey;
-      std::vector<std::unique_ptr<AggData>> cols;
+      auto* states = table.find(List(), groupItems.size());
       for (size_t i = 0; i < groupItems.size(); ++i) {
-        cols.emplace_back(new AggData());
-        cols[i]->setResult(defaultValues[i]);
+        states[i].setResult(std::move(defaultValues.values[i]));
       }
-      result.emplace(std::make_pair(dummyKey, std::move(cols)));
     }
   }
 
   for (; iter->valid(); iter->next()) {
     List list;
+    list.values.reserve(groupKeys.size());
     for (auto* key : groupKeys) {
-      list.values.emplace_back(key->eval(ctx(iter.get())));
-    }
-
-    auto it = result.find(list);
-    if (it == result.end()) {
-      std::vector<std::unique_ptr<AggData>> cols;
-      for (size_t i = 0; i < groupItems.size(); ++i) {
-        cols.emplace_back(new AggData());
-      }
-      result.emplace(std::make_pair(list, std::move(cols)));
-    } else {
-      DCHECK_EQ(it->second.size(), groupItems.size());
+      list.values.emplace_back(key->eval(ctx(iter)));
     }
 
+    auto* states = table.find(std::move(list), groupItems.size());
     for (size_t i = 0; i < groupItems.size(); ++i) {
       auto* item = groupItems[i];
       if (item->kind() == Expression::Kind::kAggregate) {
-        static_cast<AggregateExpression*>(item)->setAggData(result[list][i].get());
-        item->eval(ctx(iter.get()));
+        static_cast<AggregateExpression*>(item)->setAggData(&states[i]);
+        item->eval(ctx(iter));
       } else {
-        result[list][i]->setResult(item->eval(ctx(iter.get())));
+        states[i].setResult(item->eval(ctx(iter)));
       }
     }
   }
 
+  return finishGroups(tables);
+}
+
+folly::Future<Status> AggregateExecutor::aggregateMultiJobs(Iterator* iter) {
+  auto* agg = asNode<Aggregate>(node());
+  size_t num = FLAGS_max_job_size;
+
+  auto scatter = [this, agg, num](size_t begin, size_t end, Iterator* tmpIter) -> Partitions {
+    // The expressions could not be evaluated by multiple threads concurrently, and only the args
+    // of the aggregate items are evaluated here
+    std::vector<Expression*> keys;
+    keys.reserve(agg->groupKeys().size());
+    for (auto* key : agg->groupKeys()) {
+      keys.emplace_back(key->clone());
+    }
+    std::vector<Expression*> inputs;
+    inputs.reserve(agg->groupItems().size());
+    for (auto* item : agg->groupItems()) {
+      if (item->kind() == Expression::Kind::kAggregate) {
+        inputs.emplace_back(static_cast<AggregateExpression*>(item)->arg()->clone());
+      } else {
+        inputs.emplace_back(item->clone());
+      }
+    }
+
+    QueryExpressionContext ctx(ectx_);
+    Partitions partitions(num);
+    for (; tmpIter->valid() && begin++ < end; tmpIter->next()) {
+      List key;
+      key.values.reserve(keys.size());
+      for (auto* expr : keys) {
+        key.values.emplace_back(expr->eval(ctx(tmpIter)));
+      }
+      std::vector<Value> values;
+      values.reserve(inputs.size());
+      for (auto* expr : inputs) {
+        values.emplace_back(expr->eval(ctx(tmpIter)));
+      }
+      auto& part = partitions[std::hash<List>()(key) % num];
+      part.emplace_back(std::move(key), std::move(values));
+    }
+    return partitions;
+  };
+
+  auto gather = [this, agg, num](std::vector<Partitions>&& results) {
+    auto jobs = std::make_shared<std::vector<Partitions>>(std::move(results));
+    auto tables = std::make_shared<std::vector<GroupTable>>(num);
+    std::vector<folly::Future<folly::Unit>> futures;
+    futures.reserve(num);
+    for (size_t i = 0; i < num; ++i) {
+      futures.emplace_back(folly::via(runner(), [agg, jobs, i, &table = (*tables)[i]]() {
+        const auto& groupItems = agg->groupItems();
+        for (auto& job : *jobs) {
+          for (auto& [key, values] : job[i]) {
+            auto* states = table.find(std::move(key), groupItems.size());
+            for (size_t j = 0; j < groupItems.size(); ++j) {
+              auto* item = groupItems[j];
+              if (item->kind() == Expression::Kind::kAggregate) {
+                static_cast<AggregateExpression*>(item)->apply(&states[j], values[j]);
+              } else {
+                states[j].setResult(std::move(values[j]));
+              }
+            }
+          }
+        }
+      }));
+    }
+    return folly::collect(futures).via(runner()).thenValue([this, tables](auto&&) {
+      return finishGroups(*tables);
+    });
+  };
+
+  return runMultiJobs(std::move(scatter), std::move(gather), iter);
+}
+
+Status AggregateExecutor::finishGroups(std::vector<GroupTable>& tables) {
+  auto* agg = asNode<Aggregate>(node());
+  auto numItems = agg->groupItems().size();
   DataSet ds;
   ds.colNames = agg->colNames();
-  ds.rows.reserve(result.size());
-  for (auto& kv : result) {
-    Row row;
-    for (auto& v : kv.second) {
-      row.values.emplace_back(v->result());
+  size_t size = 0;
+  for (auto& table : tables) {
+    size += table.groups.size();
+  }
+  ds.rows.reserve(size);
+  for (auto& table : tables) {
+    for (auto& kv : table.groups) {
+      Row row;
+      row.values.reserve(numItems);
+      auto* states = table.states.data() + kv.second * numItems;
+      for (size_t i = 0; i < numItems; ++i) {
+        states[i].finish();
+        row.values.emplace_back(std::move(states[i].result()));
+      }
+      ds.rows.emplace_back(std::move(row));
     }
-    ds.rows.emplace_back(std::move(row));
   }
   return finish(ResultBuilder().value(Value(std::move(ds))).build());
 }
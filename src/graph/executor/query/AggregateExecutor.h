@@ -5,6 +5,8 @@
 #ifndef GRAPH_EXECUTOR_QUERY_AGGREGATEEXECUTOR_H_
 #define GRAPH_EXECUTOR_QUERY_AGGREGATEEXECUTOR_H_
 
+#include <folly/container/F14Map.h>
+
 #include "graph/executor/Executor.h"
 // calculate a set of data uniformly. use values ​​from multiple records as input
 // and convert those values ​​into one value to aggregate all records
@@ -17,6 +19,31 @@ class AggregateExecutor final : public Executor {
       : Executor("AggregateExecutor", node, qctx) {}
 
   folly::Future<Status> execute() override;
+
+ private:
+  // The aggregate states of groups. The states of all groups are kept in one vector, one slot
+  // for each group item, rather than allocated one by one for each group.
+  struct GroupTable {
+    folly::F14FastMap<List, size_t> groups;
+    std::vector<AggData> states;
+
+    // Get the states of the group of key, which are created if not exist
+    AggData *find(List &&key, size_t numItems);
+  };
+
+  // The group keys and the inputs of group items evaluated of a row, scattered into partitions
+  // by the hash of the group keys
+  using Partitions = std::vector<std::vector<std::pair<List, std::vector<Value>>>>;
+
+  Status aggregate(Iterator *iter);
+
+  // Aggregate by multiple jobs in two phases without any lock:
+  // 1. Each job evaluates the group keys and the inputs of group items of a range of rows, and
+  //    scatters them into partitions by the hash of the group keys.
+  // 2. Each partition is aggregated into its own group table by one job, in the order of rows.
+  folly::Future<Status> aggregateMultiJobs(Iterator *iter);
+
+  Status finishGroups(std::vector<GroupTable> &tables);
 };
 
 }  // namespace graph
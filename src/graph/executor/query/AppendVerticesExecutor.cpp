@@ -24,6 +24,42 @@ DataSet AppendVerticesExecutor::buildRequestDataSet(const AppendVertices *av) {
   return buildRequestDataSetByVidType(valueIter.get(), av->src(), av->dedup());
 }
 
+std::optional<GetPropResponse> AppendVerticesExecutor::takePrefetched(const AppendVertices *av,
+                                                                      DataSet *vertices) {
+  if (av->prefetchedVar().empty()) {
+    return std::nullopt;
+  }
+  // [the vertices read, the list of the vids looked up for them], see Traverse::dstVerticesVar
+  auto value = ectx_->moveValue(av->prefetchedVar());
+  if (!value.isList() || value.getList().values.size() != 2) {
+    return std::nullopt;
+  }
+  auto &values = value.mutableList().values;
+  if (!values[0].isDataSet() || !values[1].isList()) {
+    return std::nullopt;
+  }
+  const auto &fetched = values[1].getList().values;
+  std::unordered_set<Value> vids(fetched.begin(), fetched.end());
+  auto &rows = vertices->rows;
+  rows.erase(std::remove_if(rows.begin(),
+                            rows.end(),
+                            [&vids](const Row &row) { return vids.count(row.values.front()) > 0; }),
+             rows.end());
+  otherStats_.emplace("prefetched_vertices", folly::to<std::string>(vids.size()));
+  GetPropResponse resp;
+  resp.props_ref() = std::move(values[0].mutableDataSet());
+  return resp;
+}
+
+folly::Future<Status> AppendVerticesExecutor::handleResps(
+    StorageRpcResponse<GetPropResponse> &&rpcResp) {
+  if (FLAGS_max_job_size <= 1) {
+    return folly::makeFuture<Status>(handleResp(std::move(rpcResp)));
+  } else {
+    return handleRespMultiJobs(std::move(rpcResp));
+  }
+}
+
 folly::Future<Status> AppendVerticesExecutor::appendVertices() {
   SCOPED_TIMER(&execTime_);
 
@@ -34,11 +70,22 @@ folly::Future<Status> AppendVerticesExecutor::appendVertices() {
   if (vertices.rows.empty()) {
     return finish(ResultBuilder().value(Value(DataSet(av->colNames()))).build());
   }
+  // The vertices read by storage along with the edges are not read again
+  auto prefetched = takePrefetched(av, &vertices);
+  if (prefetched.has_value() && vertices.rows.empty()) {
+    StorageRpcResponse<GetPropResponse> rpcResp(1);
+    rpcResp.addResponse(std::move(*prefetched));
+    return handleResps(std::move(rpcResp));
+  }
 
   StorageClient::CommonRequestParam param(av->space(),
                                           qctx()->rctx()->session()->id(),
                                           qctx()->plan()->id(),
                                           qctx()->plan()->isProfileEnabled());
+  setReadDeadline(param);
+  param.maxStalenessMs = maxReadStalenessMs();
+  param.analytical = readFromAnalyticsReplicas();
+  param.vidFilter = buildVidFilter(av);
 
   time::Duration getPropsTime;
   return DCHECK_NOTNULL(storageClient)
@@ -56,14 +103,14 @@ folly::Future<Status> AppendVerticesExecutor::appendVertices() {
         SCOPED_TIMER(&execTime_);
         otherStats_.emplace("total_rpc", folly::sformat("{}(us)", getPropsTime.elapsedInUSec()));
       })
-      .thenValue([this](StorageRpcResponse<GetPropResponse> &&rpcResp) {
+      .thenValue([this, prefetched = std::move(prefetched)](
+                     StorageRpcResponse<GetPropResponse> &&rpcResp) mutable {
         SCOPED_TIMER(&execTime_);
         addStats(rpcResp, otherStats_);
-        if (FLAGS_max_job_size <= 1) {
-          return folly::makeFuture<Status>(handleResp(std::move(rpcResp)));
-        } else {
-          return handleRespMultiJobs(std::move(rpcResp));
+        if (prefetched.has_value()) {
+          rpcResp.addResponse(std::move(*prefetched));
         }
+        return handleResps(std::move(rpcResp));
       });
 }
 
@@ -94,10 +141,10 @@ Status AppendVerticesExecutor::handleResp(
         }
         if (!av->trackPrevPath()) {  // eg. MATCH (v:Person) RETURN v
           Row row;
-          row.values.emplace_back(iter.getVertex());
+          row.values.emplace_back(iter.moveVertex());
           ds.rows.emplace_back(std::move(row));
         } else {
-          map.emplace(iter.getColumn(kVid), iter.getVertex());
+          map.emplace(iter.getColumn(kVid), iter.moveVertex());
         }
       }
     }
@@ -128,6 +175,7 @@ folly::Future<Status> AppendVerticesExecutor::handleRespMultiJobs(
   auto *av = asNode<AppendVertices>(node());
 
   auto inputIter = qctx()->ectx()->getResult(av->inputVar()).iter();
+  mv_ = movable(av->inputVars().front());
   result_.colNames = av->colNames();
   result_.rows.reserve(inputIter->size());
 
@@ -207,7 +255,8 @@ DataSet AppendVerticesExecutor::buildVerticesResult(size_t begin, size_t end, It
       }
     }
     Row row;
-    row.values.emplace_back(iter->getVertex());
+    // The response is owned by this executor, so the properties are moved into the vertices
+    row.values.emplace_back(static_cast<PropIter *>(iter)->moveVertex());
     ds.rows.emplace_back(std::move(row));
   }
 
@@ -225,7 +274,7 @@ void AppendVerticesExecutor::buildMap(size_t begin, size_t end, Iterator *iter)
         continue;
       }
     }
-    dsts_.emplace(iter->getColumn(kVid), iter->getVertex());
+    dsts_.emplace(iter->getColumn(kVid), static_cast<PropIter *>(iter)->moveVertex());
   }
 }
 
@@ -241,7 +290,7 @@ DataSet AppendVerticesExecutor::handleJob(size_t begin, size_t end, Iterator *it
     if (dstFound == dsts_.end()) {
       continue;
     }
-    Row row = *iter->row();
+    Row row = mv_ ? iter->moveRow() : *iter->row();
     row.values.emplace_back(dstFound->second);
     ds.rows.emplace_back(std::move(row));
   }
@@ -24,8 +24,16 @@ class AppendVerticesExecutor final : public GetPropExecutor {
  private:
   DataSet buildRequestDataSet(const AppendVertices *gv);
 
+  // Take the vertices read by the Traverse before if there are, and remove their vids from the
+  // request
+  std::optional<storage::cpp2::GetPropResponse> takePrefetched(const AppendVertices *av,
+                                                               DataSet *vertices);
+
   folly::Future<Status> appendVertices();
 
+  folly::Future<Status> handleResps(
+      storage::StorageRpcResponse<storage::cpp2::GetPropResponse> &&rpcResp);
+
   Status handleResp(storage::StorageRpcResponse<storage::cpp2::GetPropResponse> &&rpcResp);
 
   folly::Future<Status> handleRespMultiJobs(
@@ -41,6 +49,8 @@ class AppendVerticesExecutor final : public GetPropExecutor {
   // DstId -> Vertex
   folly::ConcurrentHashMap<Value, Value> dsts_;
   DataSet result_;
+  // Whether the rows of the input could be moved
+  bool mv_{false};
 };
 
 }  // namespace graph
@@ -5,6 +5,7 @@
 #include "graph/executor/query/DataCollectExecutor.h"
 
 #include "graph/planner/plan/Query.h"
+#include "graph/util/RowHashSet.h"
 
 namespace nebula {
 namespace graph {
@@ -138,7 +139,7 @@ Status DataCollectExecutor::collectMToN(const std::vector<std::string>& vars,
   DataSet ds;
   ds.colNames = std::move(colNames_);
   DCHECK(!ds.colNames.empty());
-  std::unordered_set<const Row*> unique;
+  RowHashSet unique;
   // itersHolder keep life cycle of iters util this method return.
   std::vector<std::unique_ptr<Iterator>> itersHolder;
   for (auto& var : vars) {
@@ -151,8 +152,9 @@ Status DataCollectExecutor::collectMToN(const std::vector<std::string>& vars,
       if (iter->isSequentialIter()) {
         auto* seqIter = static_cast<SequentialIter*>(iter.get());
         while (seqIter->valid()) {
-          if (distinct && !unique.emplace(seqIter->row()).second) {
-            seqIter->unstableErase();
+          if (distinct && !unique.insert(seqIter->row())) {
+            // Only marked, the rows in the set must not be moved until all are visited
+            seqIter->markErased();
           } else {
             seqIter->next();
           }
@@ -169,7 +171,7 @@ Status DataCollectExecutor::collectMToN(const std::vector<std::string>& vars,
   for (auto& iter : itersHolder) {
     if (iter->isSequentialIter()) {
       auto* seqIter = static_cast<SequentialIter*>(iter.get());
-      for (seqIter->reset(); seqIter->valid(); seqIter->next()) {
+      for (seqIter->compact(); seqIter->valid(); seqIter->next()) {
         ds.rows.emplace_back(seqIter->moveRow());
       }
     }
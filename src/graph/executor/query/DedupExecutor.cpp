@@ -5,6 +5,8 @@
 #include "graph/executor/query/DedupExecutor.h"
 
 #include "graph/planner/plan/Query.h"
+#include "graph/util/RowHashSet.h"
+
 namespace nebula {
 namespace graph {
 folly::Future<Status> DedupExecutor::execute() {
@@ -21,17 +23,22 @@ folly::Future<Status> DedupExecutor::execute() {
   if (UNLIKELY(iter->isGetNeighborsIter() || iter->isDefaultIter())) {
     return Status::Error("Invalid iterator kind, %d", static_cast<uint16_t>(iter->kind()));
   }
-  std::unordered_set<const Row*> unique;
-  unique.reserve(iter->size());
-  while (iter->valid()) {
-    if (!unique.emplace(iter->row()).second) {
-      iter->unstableErase();
-    } else {
-      iter->next();
+  return hashRows(iter).thenValue([this, result = std::move(result)](
+                                       std::vector<size_t>&& hashes) mutable {
+    SCOPED_TIMER(&execTime_);
+    auto* rowIter = result.iterRef();
+    RowHashSet unique(hashes.size());
+    // The rows are only marked until compacted, so the rows in the set stay valid
+    for (size_t pos = 0; rowIter->valid(); ++pos) {
+      if (!unique.insert(rowIter->row(), hashes[pos])) {
+        rowIter->markErased();
+      } else {
+        rowIter->next();
+      }
     }
-  }
-  iter->reset();
-  return finish(std::move(result));
+    rowIter->compact();
+    return finish(std::move(result));
+  });
 }
 
 }  // namespace graph
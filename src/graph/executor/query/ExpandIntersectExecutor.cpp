@@ -0,0 +1,335 @@
+// Copyright (c) 2022 vesoft inc. All rights reserved.
+//
+// This source code is licensed under Apache 2.0 License.
+
+#include "graph/executor/query/ExpandIntersectExecutor.h"
+
+#include "graph/service/GraphFlags.h"
+#include "graph/util/SchemaUtil.h"
+
+using nebula::storage::StorageClient;
+using nebula::storage::StorageRpcResponse;
+using nebula::storage::cpp2::GetNeighborsResponse;
+using nebula::storage::cpp2::GetPropResponse;
+
+namespace nebula {
+namespace graph {
+
+// Whether the edge is in the lists of the edges of the row
+static bool hasSameEdge(const Row& row, const Edge& edge) {
+  for (const auto& v : row.values) {
+    if (!v.isList()) {
+      continue;
+    }
+    for (const auto& e : v.getList().values) {
+      if (e.isEdge() && e.getEdge().keyEqual(edge)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+folly::Future<Status> ExpandIntersectExecutor::execute() {
+  SCOPED_TIMER(&execTime_);
+  const auto& vidType = *(qctx()->rctx()->session()->space().spaceDesc.vid_type_ref());
+  input_ = ectx_->getResult(expand_->inputVar()).iter();
+  QueryExpressionContext ctx(ectx_);
+  for (; input_->valid(); input_->next()) {
+    const auto& src = expand_->src()->eval(ctx(input_.get()));
+    const auto& dst = expand_->dst()->eval(ctx(input_.get()));
+    if (!SchemaUtil::isValidVid(src, vidType) || !SchemaUtil::isValidVid(dst, vidType)) {
+      continue;
+    }
+    srcs_.emplace(src);
+    dsts_.emplace(dst);
+  }
+  if (srcs_.empty()) {
+    return finish(ResultBuilder().value(Value(DataSet(expand_->colNames()))).build());
+  }
+  return getSrcNeighbors();
+}
+
+Status ExpandIntersectExecutor::close() {
+  input_.reset();
+  srcs_.clear();
+  dsts_.clear();
+  srcNeighbors_.clear();
+  dstNeighbors_.clear();
+  candidates_.clear();
+  return StorageAccessExecutor::close();
+}
+
+ExpandIntersectExecutor::NeighborIt ExpandIntersectExecutor::seek(NeighborIt begin,
+                                                                  NeighborIt end,
+                                                                  const Value& vid) {
+  auto less = [](const Neighbor& n, const Value& v) { return n.vid < v; };
+  size_t step = 1;
+  auto lo = begin;
+  while (static_cast<size_t>(end - lo) > step && (lo + step)->vid < vid) {
+    lo += step;
+    step <<= 1;
+  }
+  auto hi = static_cast<size_t>(end - lo) > step ? lo + step + 1 : end;
+  return std::lower_bound(lo, hi, vid, less);
+}
+
+StorageClient::CommonRequestParam ExpandIntersectExecutor::requestParam() const {
+  StorageClient::CommonRequestParam param(expand_->space(),
+                                          qctx()->rctx()->session()->id(),
+                                          qctx()->plan()->id(),
+                                          qctx()->plan()->isProfileEnabled());
+  setReadDeadline(param);
+  param.maxStalenessMs = maxReadStalenessMs();
+  param.analytical = readFromAnalyticsReplicas();
+  return param;
+}
+
+static std::vector<Row> toRows(const VidSet& vids) {
+  std::vector<Row> rows;
+  rows.reserve(vids.size());
+  for (const auto& vid : vids) {
+    rows.emplace_back(Row({vid}));
+  }
+  return rows;
+}
+
+folly::Future<Status> ExpandIntersectExecutor::getSrcNeighbors() {
+  time::Duration getNbrTime;
+  return qctx()
+      ->getStorageClient()
+      ->getNeighbors(requestParam(),
+                     {kVid},
+                     toRows(srcs_),
+                     expand_->edgeTypes(),
+                     expand_->edgeDirection(),
+                     nullptr,
+                     expand_->vertexProps(),
+                     expand_->edgeProps(),
+                     nullptr)
+      .via(runner())
+      .ensure([this, getNbrTime]() {
+        SCOPED_TIMER(&execTime_);
+        otherStats_.emplace("src_rpc_time", folly::sformat("{}(us)", getNbrTime.elapsedInUSec()));
+      })
+      .thenValue([this](StorageRpcResponse<GetNeighborsResponse>&& resp) {
+        SCOPED_TIMER(&execTime_);
+        auto status = buildNeighbors(std::move(resp), false);
+        if (!status.ok()) {
+          return folly::makeFuture<Status>(std::move(status));
+        }
+        if (srcNeighbors_.empty()) {
+          return folly::makeFuture<Status>(
+              finish(ResultBuilder().value(Value(DataSet(expand_->colNames()))).build()));
+        }
+        return getDstNeighbors();
+      });
+}
+
+folly::Future<Status> ExpandIntersectExecutor::getDstNeighbors() {
+  // Only the edges of e2 read reversely from y
+  std::vector<EdgeType> edgeTypes;
+  if (expand_->dstEdgeProps() != nullptr) {
+    for (const auto& edgeProp : *expand_->dstEdgeProps()) {
+      edgeTypes.emplace_back(edgeProp.get_type());
+    }
+  }
+  time::Duration getNbrTime;
+  return qctx()
+      ->getStorageClient()
+      ->getNeighbors(requestParam(),
+                     {kVid},
+                     toRows(dsts_),
+                     std::move(edgeTypes),
+                     expand_->dstEdgeDirection(),
+                     nullptr,
+                     nullptr,
+                     expand_->dstEdgeProps(),
+                     nullptr)
+      .via(runner())
+      .ensure([this, getNbrTime]() {
+        SCOPED_TIMER(&execTime_);
+        otherStats_.emplace("dst_rpc_time", folly::sformat("{}(us)", getNbrTime.elapsedInUSec()));
+      })
+      .thenValue([this](StorageRpcResponse<GetNeighborsResponse>&& resp) {
+        SCOPED_TIMER(&execTime_);
+        auto status = buildNeighbors(std::move(resp), true);
+        if (!status.ok()) {
+          return folly::makeFuture<Status>(std::move(status));
+        }
+        return intersectAndAppend();
+      });
+}
+
+Status ExpandIntersectExecutor::buildNeighbors(StorageRpcResponse<GetNeighborsResponse>&& resp,
+                                               bool reversely) {
+  auto result = handleCompleteness(resp, FLAGS_accept_partial_success);
+  NG_RETURN_IF_ERROR(result);
+  updateState(result.value());
+
+  List list;
+  for (auto& r : resp.responses()) {
+    if (r.vertices_ref().has_value()) {
+      list.values.emplace_back(std::move(*r.vertices_ref()));
+    }
+  }
+  const auto& vidType = *(qctx()->rctx()->session()->space().spaceDesc.vid_type_ref());
+  auto* vFilter = reversely ? nullptr : expand_->vFilter();
+  auto* eFilter = reversely ? expand_->dstEdgeFilter() : expand_->eFilter();
+  auto& neighborsMap = reversely ? dstNeighbors_ : srcNeighbors_;
+  QueryExpressionContext ctx(ectx_);
+  GetNeighborsIter iter(std::make_shared<Value>(std::move(list)));
+  for (; iter.valid(); iter.next()) {
+    const auto& dst = iter.getEdgeProp("*", kDst);
+    if (!SchemaUtil::isValidVid(dst, vidType)) {
+      continue;
+    }
+    if (vFilter != nullptr) {
+      const auto& vFilterVal = vFilter->eval(ctx(&iter));
+      if (!vFilterVal.isBool() || !vFilterVal.getBool()) {
+        continue;
+      }
+    }
+    if (eFilter != nullptr) {
+      const auto& eFilterVal = eFilter->eval(ctx(&iter));
+      if (!eFilterVal.isBool() || !eFilterVal.getBool()) {
+        continue;
+      }
+    }
+    const auto& vid = iter.getColumn(kVid);
+    auto found = neighborsMap.find(vid);
+    if (found == neighborsMap.end()) {
+      found = neighborsMap.emplace(vid, Neighbors()).first;
+      if (!reversely) {
+        found->second.vertex = iter.getVertex();
+      }
+    }
+    auto edge = iter.getEdge();
+    if (reversely) {
+      // As the edge is read from z by Traverse
+      edge.mutableEdge().reverse();
+    }
+    found->second.neighbors.emplace_back(Neighbor{dst, std::move(edge)});
+  }
+  for (auto& kv : neighborsMap) {
+    auto& neighbors = kv.second.neighbors;
+    std::sort(neighbors.begin(), neighbors.end(), [](const Neighbor& a, const Neighbor& b) {
+      return a.vid < b.vid;
+    });
+  }
+  return Status::OK();
+}
+
+folly::Future<Status> ExpandIntersectExecutor::intersectAndAppend() {
+  auto mids = collectCandidates();
+  otherStats_.emplace("candidates", folly::to<std::string>(candidates_.size()));
+  if (candidates_.empty()) {
+    return finish(
+        ResultBuilder().value(Value(DataSet(expand_->colNames()))).state(state_).build());
+  }
+
+  DataSet vertices({kVid});
+  vertices.rows.reserve(mids.size());
+  for (auto& mid : mids) {
+    vertices.rows.emplace_back(Row({mid}));
+  }
+  time::Duration getPropsTime;
+  return qctx()
+      ->getStorageClient()
+      ->getProps(requestParam(), std::move(vertices), expand_->vertexProps(), nullptr, nullptr)
+      .via(runner())
+      .ensure([this, getPropsTime]() {
+        SCOPED_TIMER(&execTime_);
+        otherStats_.emplace("mid_rpc_time",
+                            folly::sformat("{}(us)", getPropsTime.elapsedInUSec()));
+      })
+      .thenValue([this](StorageRpcResponse<GetPropResponse>&& resp) {
+        SCOPED_TIMER(&execTime_);
+        return buildResult(std::move(resp));
+      });
+}
+
+VidSet ExpandIntersectExecutor::collectCandidates() {
+  QueryExpressionContext ctx(ectx_);
+  VidSet mids;
+  for (input_->reset(); input_->valid(); input_->next()) {
+    auto srcFound = srcNeighbors_.find(expand_->src()->eval(ctx(input_.get())));
+    if (srcFound == srcNeighbors_.end()) {
+      continue;
+    }
+    auto dstFound = dstNeighbors_.find(expand_->dst()->eval(ctx(input_.get())));
+    if (dstFound == dstNeighbors_.end()) {
+      continue;
+    }
+    const auto* row = input_->row();
+    const auto& src = srcFound->second;
+    intersect(src.neighbors,
+              dstFound->second.neighbors,
+              [&](NeighborIt begin, NeighborIt end, NeighborIt dstBegin, NeighborIt dstEnd) {
+                for (auto it = begin; it != end; ++it) {
+                  const auto& edge = it->edge.getEdge();
+                  if (hasSameEdge(*row, edge)) {
+                    continue;
+                  }
+                  for (auto dstIt = dstBegin; dstIt != dstEnd; ++dstIt) {
+                    const auto& dstEdge = dstIt->edge.getEdge();
+                    if (edge.keyEqual(dstEdge) || hasSameEdge(*row, dstEdge)) {
+                      continue;
+                    }
+                    candidates_.emplace_back(Candidate{row, &src.vertex, &it->edge, &dstIt->edge});
+                  }
+                }
+                mids.emplace(begin->vid);
+              });
+  }
+  return mids;
+}
+
+Status ExpandIntersectExecutor::buildResult(StorageRpcResponse<GetPropResponse>&& resp) {
+  auto result = handleCompleteness(resp, FLAGS_accept_partial_success);
+  NG_RETURN_IF_ERROR(result);
+  updateState(result.value());
+
+  auto* midVertexFilter = expand_->midVertexFilter();
+  QueryExpressionContext ctx(ectx_);
+  VidMap<Value> mids;
+  for (auto& r : resp.responses()) {
+    if (!r.props_ref().has_value()) {
+      continue;
+    }
+    PropIter iter(std::make_shared<Value>(std::move(*r.props_ref())));
+    for (; iter.valid(); iter.next()) {
+      if (midVertexFilter != nullptr) {
+        const auto& filterVal = midVertexFilter->eval(ctx(&iter));
+        if (!filterVal.isBool() || !filterVal.getBool()) {
+          continue;
+        }
+      }
+      mids.emplace(iter.getColumn(kVid), iter.getVertex());
+    }
+  }
+
+  DataSet ds;
+  ds.colNames = expand_->colNames();
+  ds.rows.reserve(candidates_.size());
+  for (const auto& candidate : candidates_) {
+    auto midFound = mids.find(candidate.edge->getEdge().dst);
+    if (midFound == mids.end()) {
+      continue;
+    }
+    // [x, [e1], z, [e2]] as the two single steps of Traverse
+    Row row;
+    if (expand_->trackPrevPath()) {
+      row = *candidate.row;
+    }
+    row.values.emplace_back(*candidate.src);
+    row.values.emplace_back(List({*candidate.edge}));
+    row.values.emplace_back(midFound->second);
+    row.values.emplace_back(List({*candidate.dstEdge}));
+    ds.rows.emplace_back(std::move(row));
+  }
+  return finish(ResultBuilder().value(Value(std::move(ds))).state(state_).build());
+}
+
+}  // namespace graph
+}  // namespace nebula
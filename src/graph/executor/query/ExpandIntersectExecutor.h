@@ -0,0 +1,129 @@
+// Copyright (c) 2022 vesoft inc. All rights reserved.
+//
+// This source code is licensed under Apache 2.0 License.
+
+#ifndef GRAPH_EXECUTOR_QUERY_EXPANDINTERSECTEXECUTOR_H_
+#define GRAPH_EXECUTOR_QUERY_EXPANDINTERSECTEXECUTOR_H_
+
+#include "clients/storage/StorageClient.h"
+#include "graph/executor/StorageAccessExecutor.h"
+#include "graph/planner/plan/Query.h"
+#include "graph/util/VidHash.h"
+// only used in match scenarios
+// Expand (x)-[e1]-(z)-[e2]-(y) for the rows of the input in which x and y are known, as a generic
+// join of the pattern: the neighbors of all the xs over e1 and of all the ys over e2 are read
+// from storage once and sorted by their vids, then the zs of each row are found by leapfrogging
+// the two sorted lists, each seeking the vid of the other by galloping. So the cost of a row is
+// bounded by the smaller list instead of the paths of x by e1 and e2, which is what blows up a
+// cyclic pattern on the vertices of high degrees. The zs are read by GetProp at last.
+//
+// Member:
+// `srcNeighbors_` : KEY is x, VALUE is the vertex of x and its neighbors over e1
+// `dstNeighbors_` : KEY is y, VALUE is its neighbors over e2, the edges of which are reversed to
+//  be read from z
+// `candidates_` : the rows of the input joined with the edges to the zs, before z is read
+// `state_` : the worst state of the responses
+namespace nebula {
+namespace graph {
+
+class ExpandIntersectExecutor final : public StorageAccessExecutor {
+ public:
+  ExpandIntersectExecutor(const PlanNode* node, QueryContext* qctx)
+      : StorageAccessExecutor("ExpandIntersectExecutor", node, qctx) {
+    expand_ = asNode<ExpandIntersect>(node);
+  }
+
+  folly::Future<Status> execute() override;
+
+  Status close() override;
+
+ private:
+  friend class ExpandIntersectTest_Intersect_Test;
+
+  struct Neighbor {
+    Value vid;
+    Value edge;
+  };
+
+  using NeighborIt = std::vector<Neighbor>::const_iterator;
+
+  struct Neighbors {
+    Value vertex;
+    std::vector<Neighbor> neighbors;
+  };
+
+  struct Candidate {
+    const Row* row;
+    const Value* src;
+    const Value* edge;
+    const Value* dstEdge;
+  };
+
+  // Call f(aBegin, aEnd, bBegin, bEnd) for each vid in both lists sorted by the vids, with the
+  // ranges of the neighbors of the vid in each of them
+  template <typename F>
+  static void intersect(const std::vector<Neighbor>& a, const std::vector<Neighbor>& b, F&& f);
+
+  // The first neighbor not less than the vid, by galloping from the begin
+  static NeighborIt seek(NeighborIt begin, NeighborIt end, const Value& vid);
+
+  storage::StorageClient::CommonRequestParam requestParam() const;
+
+  folly::Future<Status> getSrcNeighbors();
+
+  folly::Future<Status> getDstNeighbors();
+
+  Status buildNeighbors(storage::StorageRpcResponse<storage::cpp2::GetNeighborsResponse>&& resp,
+                        bool reversely);
+
+  folly::Future<Status> intersectAndAppend();
+
+  // Join the rows of the input with the edges to the zs, returns the zs to be read
+  VidSet collectCandidates();
+
+  Status buildResult(storage::StorageRpcResponse<storage::cpp2::GetPropResponse>&& resp);
+
+  void updateState(Result::State state) {
+    if (state != Result::State::kSuccess) {
+      state_ = state;
+    }
+  }
+
+  const ExpandIntersect* expand_{nullptr};
+  std::unique_ptr<Iterator> input_;
+  VidSet srcs_;
+  VidSet dsts_;
+  VidMap<Neighbors> srcNeighbors_;
+  VidMap<Neighbors> dstNeighbors_;
+  std::vector<Candidate> candidates_;
+  Result::State state_{Result::State::kSuccess};
+};
+
+template <typename F>
+void ExpandIntersectExecutor::intersect(const std::vector<Neighbor>& a,
+                                        const std::vector<Neighbor>& b,
+                                        F&& f) {
+  auto i = a.begin();
+  auto j = b.begin();
+  while (i != a.end() && j != b.end()) {
+    if (i->vid < j->vid) {
+      i = seek(i, a.end(), j->vid);
+      continue;
+    }
+    if (j->vid < i->vid) {
+      j = seek(j, b.end(), i->vid);
+      continue;
+    }
+    const auto& vid = i->vid;
+    auto iEnd = std::find_if(i, a.end(), [&vid](const Neighbor& n) { return n.vid != vid; });
+    auto jEnd = std::find_if(j, b.end(), [&vid](const Neighbor& n) { return n.vid != vid; });
+    f(i, iEnd, j, jEnd);
+    i = iEnd;
+    j = jEnd;
+  }
+}
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_EXECUTOR_QUERY_EXPANDINTERSECTEXECUTOR_H_
@@ -4,6 +4,8 @@
 
 #include "graph/executor/query/FilterExecutor.h"
 
+#include "common/expression/ExpressionProgram.h"
+#include "graph/context/BatchEvaluator.h"
 #include "graph/planner/plan/Query.h"
 #include "graph/service/GraphFlags.h"
 
@@ -61,9 +63,10 @@ StatusOr<DataSet> FilterExecutor::handleJob(size_t begin, size_t end, Iterator *
   auto *filter = asNode<Filter>(node());
   QueryExpressionContext ctx(ectx_);
   auto condition = filter->condition()->clone();
+  auto program = ExpressionProgram::compile(condition);
   DataSet ds;
   for (; iter->valid() && begin++ < end; iter->next()) {
-    auto val = condition->eval(ctx(iter));
+    const auto &val = program ? program->eval(ctx(iter)) : condition->eval(ctx(iter));
     if (val.isBadNull() || (!val.empty() && !val.isImplicitBool() && !val.isNull())) {
       return Status::Error("Wrong type result, the type should be NULL, EMPTY, BOOL");
     }
@@ -83,28 +86,66 @@ Status FilterExecutor::handleSingleJobFilter() {
 
   ResultBuilder builder;
   builder.value(result.valuePtr());
+  auto batched = handleBatchFilter(iter);
+  NG_RETURN_IF_ERROR(batched);
+  if (batched.value()) {
+    builder.iter(std::move(result).iter());
+    return finish(builder.build());
+  }
+
   QueryExpressionContext ctx(ectx_);
   auto condition = filter->condition();
+  auto program = ExpressionProgram::compile(condition);
   while (iter->valid()) {
-    auto val = condition->eval(ctx(iter));
+    const auto &val = program ? program->eval(ctx(iter)) : condition->eval(ctx(iter));
     if (val.isBadNull() || (!val.empty() && !val.isImplicitBool() && !val.isNull())) {
       return Status::Error("Wrong type result, the type should be NULL, EMPTY, BOOL");
     }
     if (val.empty() || val.isNull() || (val.isImplicitBool() && !val.implicitBool())) {
-      if (UNLIKELY(filter->needStableFilter())) {
-        iter->erase();
-      } else {
-        iter->unstableErase();
-      }
+      // Stable, so it serves the filters needing the stable order as well
+      iter->markErased();
     } else {
       iter->next();
     }
   }
 
-  iter->reset();
+  iter->compact();
   builder.iter(std::move(result).iter());
   return finish(builder.build());
 }
 
+StatusOr<bool> FilterExecutor::handleBatchFilter(Iterator *iter) {
+  if (!FLAGS_enable_batch_expression_eval || iter->kind() != Iterator::Kind::kSequential) {
+    return false;
+  }
+  auto *filter = asNode<Filter>(node());
+  auto evaluator = BatchEvaluator::compile(filter->condition());
+  if (evaluator == nullptr) {
+    return false;
+  }
+  auto *seqIter = static_cast<SequentialIter *>(iter);
+  auto cond = evaluator->eval(*seqIter->columnBatch());
+  if (!cond.ok()) {
+    return false;
+  }
+  std::vector<uint8_t> keep;
+  NG_RETURN_IF_ERROR(BatchEvaluator::toFilterMask(cond.value(), &keep));
+
+  // Stable compaction of the kept rows
+  auto rows = seqIter->begin();
+  size_t kept = 0;
+  for (size_t i = 0; i < keep.size(); ++i) {
+    if (keep[i]) {
+      if (kept != i) {
+        rows[kept] = std::move(rows[i]);
+      }
+      ++kept;
+    }
+  }
+  seqIter->eraseRange(kept, keep.size());
+  seqIter->reset();
+  return true;
+}
+
 }  // namespace graph
 }  // namespace nebula
@@ -22,6 +22,11 @@ class FilterExecutor final : public Executor {
   StatusOr<DataSet> handleJob(size_t begin, size_t end, Iterator *iter);
 
   Status handleSingleJobFilter();
+
+ private:
+  // Filter the sequential result column-at-a-time, return false if the
+  // condition is not supported by the batch evaluator.
+  StatusOr<bool> handleBatchFilter(Iterator *iter);
 };
 
 }  // namespace graph
@@ -0,0 +1,56 @@
+// Copyright (c) 2022 vesoft inc. All rights reserved.
+//
+// This source code is licensed under Apache 2.0 License.
+
+#include "graph/executor/query/FilterProjectLimitExecutor.h"
+
+#include "graph/planner/plan/Query.h"
+
+namespace nebula {
+namespace graph {
+
+folly::Future<Status> FilterProjectLimitExecutor::execute() {
+  SCOPED_TIMER(&execTime_);
+  auto *fpl = asNode<FilterProjectLimit>(node());
+  auto iter = ectx_->getResult(fpl->inputVar()).iter();
+  if (iter == nullptr || iter->isDefaultIter()) {
+    auto status = Status::Error("iterator is nullptr or DefaultIter");
+    LOG(ERROR) << status;
+    return status;
+  }
+
+  QueryExpressionContext ctx(ectx_);
+  auto *condition = fpl->condition();
+  const auto &columns = fpl->columns()->columns();
+  auto offset = fpl->offset();
+  auto count = fpl->count();
+
+  DataSet ds;
+  ds.colNames = fpl->colNames();
+  ds.rows.reserve(std::min(static_cast<size_t>(count), iter->size()));
+  for (; iter->valid() && count > 0; iter->next()) {
+    auto val = condition->eval(ctx(iter.get()));
+    if (val.isBadNull() || (!val.empty() && !val.isImplicitBool() && !val.isNull())) {
+      return Status::Error("Wrong type result, the type should be NULL, EMPTY, BOOL");
+    }
+    if (val.empty() || val.isNull() || (val.isImplicitBool() && !val.implicitBool())) {
+      continue;
+    }
+    if (offset > 0) {
+      --offset;
+      continue;
+    }
+    // Project the remained row into the output directly
+    Row row;
+    row.values.reserve(columns.size());
+    for (auto &col : columns) {
+      row.values.emplace_back(col->expr()->eval(ctx(iter.get())));
+    }
+    ds.rows.emplace_back(std::move(row));
+    --count;
+  }
+  return finish(ResultBuilder().value(Value(std::move(ds))).build());
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -0,0 +1,24 @@
+// Copyright (c) 2022 vesoft inc. All rights reserved.
+//
+// This source code is licensed under Apache 2.0 License.
+
+#ifndef GRAPH_EXECUTOR_QUERY_FILTERPROJECTLIMITEXECUTOR_H_
+#define GRAPH_EXECUTOR_QUERY_FILTERPROJECTLIMITEXECUTOR_H_
+
+#include "graph/executor/Executor.h"
+// filters, limits and projects the input in a single pass without copying the intermediate rows
+namespace nebula {
+namespace graph {
+
+class FilterProjectLimitExecutor final : public Executor {
+ public:
+  FilterProjectLimitExecutor(const PlanNode *node, QueryContext *qctx)
+      : Executor("FilterProjectLimitExecutor", node, qctx) {}
+
+  folly::Future<Status> execute() override;
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_EXECUTOR_QUERY_FILTERPROJECTLIMITEXECUTOR_H_
@@ -65,6 +65,9 @@ folly::Future<Status> GetEdgesExecutor::getEdges() {
                                           qctx()->rctx()->session()->id(),
                                           qctx()->plan()->id(),
                                           qctx()->plan()->isProfileEnabled());
+  setReadDeadline(param);
+  param.maxStalenessMs = maxReadStalenessMs();
+  param.analytical = readFromAnalyticsReplicas();
   return DCHECK_NOTNULL(client)
       ->getProps(param,
                  std::move(edges),
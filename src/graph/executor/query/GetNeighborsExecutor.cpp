@@ -37,6 +37,17 @@ folly::Future<Status> GetNeighborsExecutor::execute() {
                                           qctx()->rctx()->session()->id(),
                                           qctx()->plan()->id(),
                                           qctx()->plan()->isProfileEnabled());
+  setReadDeadline(param);
+  param.maxStalenessMs = maxReadStalenessMs();
+  param.analytical = readFromAnalyticsReplicas();
+  auto filter = buildFilter();
+  NG_RETURN_IF_ERROR(filter);
+  if (gn_->steps() > 1) {
+    return getNeighborsKHop(param, std::move(reqDs.rows), filter.value());
+  }
+  bool encodedRows = FLAGS_enable_encoded_tag_rows && gn_->vertexProps() != nullptr &&
+                     !gn_->vertexProps()->empty();
+  param.encodedRows = encodedRows;
   return storageClient
       ->getNeighbors(param,
                      std::move(reqDs.colNames),
@@ -51,13 +62,15 @@ folly::Future<Status> GetNeighborsExecutor::execute() {
                      gn_->random(),
                      gn_->orderBy(),
                      gn_->limit(qec),
-                     gn_->filter())
+                     filter.value(),
+                     gn_->statsOnly(),
+                     gn_->edgeBudget())
       .via(runner())
       .ensure([this, getNbrTime]() {
         SCOPED_TIMER(&execTime_);
         otherStats_.emplace("total_rpc_time", folly::sformat("{}(us)", getNbrTime.elapsedInUSec()));
       })
-      .thenValue([this](StorageRpcResponse<GetNeighborsResponse>&& resp) {
+      .thenValue([this, encodedRows](StorageRpcResponse<GetNeighborsResponse>&& resp) {
         SCOPED_TIMER(&execTime_);
         auto& hostLatency = resp.hostLatency();
         for (size_t i = 0; i < hostLatency.size(); ++i) {
@@ -70,16 +83,170 @@ folly::Future<Status> GetNeighborsExecutor::execute() {
           otherStats_.emplace(
               folly::sformat("{} exec/total/vertices", std::get<0>(info).toString()),
               folly::sformat("{}(us)/{}(us)/{},", std::get<1>(info), std::get<2>(info), size));
+          if (result.truncated_vertices_ref().has_value()) {
+            otherStats_.emplace(
+                folly::sformat("{} truncated vertices", std::get<0>(info).toString()),
+                folly::sformat("{}", (*result.truncated_vertices_ref()).size()));
+          }
           auto detail = getStorageDetail(result.result.latency_detail_us_ref());
           if (!detail.empty()) {
             otherStats_.emplace("storage_detail", detail);
           }
+          auto nodes = getStorageNodes(result.result.node_profiles_ref());
+          if (!nodes.empty()) {
+            otherStats_.emplace(
+                folly::sformat("{} storage_nodes", std::get<0>(info).toString()), nodes);
+          }
         }
-        return handleResponse(resp);
+        return handleResponse(resp, encodedRows);
       });
 }
 
-Status GetNeighborsExecutor::handleResponse(RpcResponse& resps) {
+StatusOr<const Expression*> GetNeighborsExecutor::buildFilter() {
+  const auto* filter = gn_->filter();
+  const auto& dstFilterVar = gn_->dstFilterVar();
+  if (dstFilterVar.empty() || !ectx_->exist(dstFilterVar)) {
+    return filter;
+  }
+  const auto& dsts = ectx_->getValue(dstFilterVar);
+  if (!dsts.isSet() || gn_->edgeProps() == nullptr) {
+    return filter;
+  }
+  // The dst of an edge could only be read by the name of its edge in storage, so the set is
+  // checked by the name of each edge to get
+  auto* pool = qctx()->objPool();
+  auto* dstSet = ConstantExpression::make(pool, dsts);
+  std::unordered_set<std::string> edgeNames;
+  std::vector<Expression*> operands;
+  for (const auto& edgeProp : *gn_->edgeProps()) {
+    auto edgeName = qctx()->schemaMng()->toEdgeName(gn_->space(), std::abs(edgeProp.get_type()));
+    NG_RETURN_IF_ERROR(edgeName);
+    if (!edgeNames.emplace(edgeName.value()).second) {
+      continue;
+    }
+    auto* dst = EdgeDstIdExpression::make(pool, edgeName.value());
+    operands.emplace_back(RelationalExpression::makeIn(pool, dst, dstSet));
+  }
+  if (operands.empty()) {
+    return filter;
+  }
+  Expression* dstFilter = operands.front();
+  if (operands.size() > 1) {
+    auto* orExpr = LogicalExpression::makeOr(pool);
+    orExpr->setOperands(std::move(operands));
+    dstFilter = orExpr;
+  }
+  if (filter == nullptr) {
+    return dstFilter;
+  }
+  return LogicalExpression::makeAnd(pool, filter->clone(), dstFilter);
+}
+
+folly::Future<Status> GetNeighborsExecutor::getNeighborsKHop(const CommonRequestParam& param,
+                                                             std::vector<Row> vertices,
+                                                             const Expression* filter) {
+  QueryExpressionContext qec(qctx()->ectx());
+  kHopSpec_.edge_types_ref() = gn_->edgeTypes();
+  kHopSpec_.edge_direction_ref() = gn_->edgeDirection();
+  kHopSpec_.dedup_ref() = gn_->dedup();
+  kHopSpec_.random_ref() = gn_->random();
+  if (gn_->statProps() != nullptr) {
+    kHopSpec_.stat_props_ref() = *gn_->statProps();
+  }
+  if (gn_->vertexProps() != nullptr) {
+    kHopSpec_.vertex_props_ref() = *gn_->vertexProps();
+  }
+  if (gn_->edgeProps() != nullptr) {
+    kHopSpec_.edge_props_ref() = *gn_->edgeProps();
+  }
+  if (gn_->exprs() != nullptr) {
+    kHopSpec_.expressions_ref() = *gn_->exprs();
+  }
+  if (!gn_->orderBy().empty()) {
+    kHopSpec_.order_by_ref() = gn_->orderBy();
+  }
+  kHopSpec_.limit_ref() = gn_->limit(qec);
+  if (filter != nullptr) {
+    kHopSpec_.filter_ref() = filter->encode();
+  }
+
+  time::Duration getNbrTime;
+  return expandKHop(param, std::move(vertices), gn_->steps())
+      .ensure([this, getNbrTime]() {
+        SCOPED_TIMER(&execTime_);
+        otherStats_.emplace("total_rpc_time", folly::sformat("{}(us)", getNbrTime.elapsedInUSec()));
+      })
+      .thenValue([this](StatusOr<KHopResult>&& result) {
+        SCOPED_TIMER(&execTime_);
+        NG_RETURN_IF_ERROR(result);
+        auto& kHop = result.value();
+        return finish(ResultBuilder()
+                          .state(kHop.state)
+                          .value(Value(std::move(kHop.list)))
+                          .iter(Iterator::Kind::kGetNeighbors)
+                          .build());
+      });
+}
+
+folly::Future<StatusOr<GetNeighborsExecutor::KHopResult>> GetNeighborsExecutor::expandKHop(
+    const CommonRequestParam& param, std::vector<Row> vertices, int32_t steps) {
+  StorageClient* storageClient = qctx_->getStorageClient();
+  return storageClient->getNeighborsKHop(param, {kVid}, vertices, kHopSpec_, steps)
+      .via(runner())
+      .thenValue([this, param, steps](
+                     KHopRpcResponse&& resp) -> folly::Future<StatusOr<KHopResult>> {
+        auto state = handleCompleteness(resp, FLAGS_accept_partial_success);
+        if (!state.ok()) {
+          return StatusOr<KHopResult>(state.status());
+        }
+        KHopResult result;
+        result.state = state.value();
+        // The hops expanded => the vertices pending after them, which are deduplicated across
+        // the hosts
+        std::map<int32_t, std::unordered_set<Value>> pending;
+        for (auto& r : resp.responses()) {
+          // Nothing is left to the last hop if there are no columns
+          if (r.vertices_ref().has_value() && !r.vertices_ref()->colNames.empty()) {
+            result.list.values.emplace_back(std::move(*r.vertices_ref()));
+          }
+          if (r.pending_ref().has_value()) {
+            for (auto& p : *r.pending_ref()) {
+              pending[p.first].insert(p.second.begin(), p.second.end());
+            }
+          }
+        }
+        if (pending.empty()) {
+          return StatusOr<KHopResult>(std::move(result));
+        }
+
+        std::vector<folly::Future<StatusOr<KHopResult>>> futures;
+        for (auto& p : pending) {
+          std::vector<Row> rows;
+          rows.reserve(p.second.size());
+          for (auto& vid : p.second) {
+            rows.emplace_back(Row({vid}));
+          }
+          futures.emplace_back(expandKHop(param, std::move(rows), steps - p.first));
+        }
+        return folly::collect(futures).via(runner()).thenValue(
+            [result = std::move(result)](
+                std::vector<StatusOr<KHopResult>>&& results) mutable -> StatusOr<KHopResult> {
+              for (auto& r : results) {
+                NG_RETURN_IF_ERROR(r);
+                auto& rest = r.value();
+                if (rest.state == Result::State::kPartialSuccess) {
+                  result.state = Result::State::kPartialSuccess;
+                }
+                std::move(rest.list.values.begin(),
+                          rest.list.values.end(),
+                          std::back_inserter(result.list.values));
+              }
+              return std::move(result);
+            });
+      });
+}
+
+Status GetNeighborsExecutor::handleResponse(RpcResponse& resps, bool encodedRows) {
   auto result = handleCompleteness(resps, FLAGS_accept_partial_success);
   NG_RETURN_IF_ERROR(result);
   ResultBuilder builder;
@@ -87,15 +254,26 @@ Status GetNeighborsExecutor::handleResponse(RpcResponse& resps) {
 
   auto& responses = resps.responses();
   List list;
+  list.values.reserve(responses.size());
   for (auto& resp : responses) {
-    auto dataset = resp.get_vertices();
-    if (dataset == nullptr) {
+    auto dataset = resp.vertices_ref();
+    if (!dataset.has_value()) {
       continue;
     }
 
     list.values.emplace_back(std::move(*dataset));
   }
-  builder.value(Value(std::move(list))).iter(Iterator::Kind::kGetNeighbors);
+  auto value = std::make_shared<Value>(std::move(list));
+  auto iter = std::make_unique<GetNeighborsIter>(value);
+  if (encodedRows) {
+    std::vector<TagID> tags;
+    for (const auto& vertexProp : *gn_->vertexProps()) {
+      tags.emplace_back(vertexProp.get_tag());
+    }
+    iter->setTagRowDecoder(
+        std::make_shared<TagRowDecoder>(qctx()->schemaMng(), gn_->space(), tags));
+  }
+  builder.value(std::move(value)).iter(std::move(iter));
   return finish(builder.build());
 }
 
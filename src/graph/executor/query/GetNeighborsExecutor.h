@@ -5,6 +5,7 @@
 #ifndef GRAPH_EXECUTOR_QUERY_GETNEIGHBORSEXECUTOR_H_
 #define GRAPH_EXECUTOR_QUERY_GETNEIGHBORSEXECUTOR_H_
 
+#include "clients/storage/StorageClient.h"
 #include "graph/executor/StorageAccessExecutor.h"
 #include "graph/planner/plan/Query.h"
 
@@ -25,10 +26,36 @@ class GetNeighborsExecutor final : public StorageAccessExecutor {
 
  private:
   using RpcResponse = storage::StorageRpcResponse<storage::cpp2::GetNeighborsResponse>;
-  Status handleResponse(RpcResponse& resps);
+  using KHopRpcResponse = storage::StorageRpcResponse<storage::cpp2::KHopGetNeighborsResponse>;
+  using CommonRequestParam = storage::StorageClient::CommonRequestParam;
+
+  // The neighbors of the last hop, in the datasets of the responses
+  struct KHopResult {
+    Result::State state{Result::State::kSuccess};
+    List list;
+  };
+
+  // The tag props of the responses are decoded by the iterator of the result when they are read
+  // if encodedRows
+  Status handleResponse(RpcResponse& resps, bool encodedRows);
+
+  // The filter of the plan node, with the dst of edges filtered by the set in dstFilterVar
+  StatusOr<const Expression*> buildFilter();
+
+  // Expand the vertices by the steps of the plan node inside storaged
+  folly::Future<Status> getNeighborsKHop(const CommonRequestParam& param,
+                                         std::vector<Row> vertices,
+                                         const Expression* filter);
+
+  // Expand the vertices by the steps, then the vertices left pending by storaged by the steps
+  // remaining to them, until none is left
+  folly::Future<StatusOr<KHopResult>> expandKHop(const CommonRequestParam& param,
+                                                 std::vector<Row> vertices,
+                                                 int32_t steps);
 
  private:
   const GetNeighbors* gn_;
+  storage::cpp2::TraverseSpec kHopSpec_;
 };
 
 }  // namespace graph
@@ -33,6 +33,9 @@ folly::Future<Status> GetVerticesExecutor::getVertices() {
                                           qctx()->rctx()->session()->id(),
                                           qctx()->plan()->id(),
                                           qctx()->plan()->isProfileEnabled());
+  setReadDeadline(param);
+  param.maxStalenessMs = maxReadStalenessMs();
+  param.analytical = readFromAnalyticsReplicas();
   return DCHECK_NOTNULL(storageClient)
       ->getProps(param,
                  std::move(vertices),
@@ -4,6 +4,7 @@
 
 #include "graph/executor/query/IndexScanExecutor.h"
 
+#include "graph/optimizer/CardinalityFeedback.h"
 #include "graph/service/GraphFlags.h"
 
 using nebula::storage::StorageClient;
@@ -36,6 +37,8 @@ folly::Future<Status> IndexScanExecutor::indexScan() {
                                           qctx()->rctx()->session()->id(),
                                           qctx()->plan()->id(),
                                           qctx()->plan()->isProfileEnabled());
+  setReadDeadline(param);
+  param.vidFilter = buildVidFilter(lookup);
   return storageClient
       ->lookupIndex(param,
                     ictxs,
@@ -43,7 +46,8 @@ folly::Future<Status> IndexScanExecutor::indexScan() {
                     lookup->schemaId(),
                     lookup->returnColumns(),
                     lookup->orderBy(),
-                    lookup->limit(qctx_))
+                    lookup->limit(qctx_),
+                    lookup->intersect())
       .via(runner())
       .thenValue([this](StorageRpcResponse<LookupIndexResp> &&rpcResp) {
         addStats(rpcResp, otherStats_);
@@ -76,6 +80,17 @@ Status IndexScanExecutor::handleResp(storage::StorageRpcResponse<Resp> &&rpcResp
     DCHECK_EQ(node()->colNames().size(), v.colNames.size());
     v.colNames = node()->colNames();
   }
+  // Only the scans of a single index estimated by the cost model are fed back, and a scan cut
+  // by the limit doesn't return all the rows matched
+  auto *lookup = asNode<IndexScan>(node());
+  const auto &ictxs = lookup->queryContext();
+  int64_t rows = v.rows.size();
+  if (FLAGS_enable_cardinality_feedback && lookup->cost() > 0 && ictxs.size() == 1 &&
+      state == Result::State::kSuccess && rows < lookup->limit(qctx_)) {
+    const auto &ictx = ictxs.front();
+    auto key = opt::CardinalityFeedback::indexScanKey(ictx.get_index_id(), ictx.get_column_hints());
+    opt::CardinalityFeedback::instance().record(key, qctx()->rctx()->query(), lookup->cost(), rows);
+  }
   return finish(
       ResultBuilder().value(std::move(v)).iter(Iterator::Kind::kProp).state(state).build());
 }
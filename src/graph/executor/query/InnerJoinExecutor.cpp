@@ -39,7 +39,7 @@ folly::Future<Status> InnerJoinExecutor::join(const std::vector<Expression*>& ha
   }
 
   if (hashKeys.size() == 1 && probeKeys.size() == 1) {
-    std::unordered_map<Value, std::vector<const Row*>> hashTable;
+    HashTable<Value> hashTable;
     hashTable.reserve(bucketSize);
     if (lhsIter_->size() < rhsIter_->size()) {
       buildSingleKeyHashTable(hashKeys.front(), lhsIter_.get(), hashTable);
@@ -52,7 +52,7 @@ folly::Future<Status> InnerJoinExecutor::join(const std::vector<Expression*>& ha
       result = singleKeyProbe(hashKeys.front(), lhsIter_.get(), hashTable);
     }
   } else {
-    std::unordered_map<List, std::vector<const Row*>> hashTable;
+    HashTable<List> hashTable;
     hashTable.reserve(bucketSize);
     if (lhsIter_->size() < rhsIter_->size()) {
       buildHashTable(hashKeys, lhsIter_.get(), hashTable);
@@ -72,7 +72,7 @@ folly::Future<Status> InnerJoinExecutor::join(const std::vector<Expression*>& ha
 DataSet InnerJoinExecutor::probe(
     const std::vector<Expression*>& probeKeys,
     Iterator* probeIter,
-    const std::unordered_map<List, std::vector<const Row*>>& hashTable) const {
+    const HashTable<List>& hashTable) const {
   DataSet ds;
   QueryExpressionContext ctx(ectx_);
   ds.rows.reserve(probeIter->size());
@@ -97,7 +97,7 @@ DataSet InnerJoinExecutor::probe(
 DataSet InnerJoinExecutor::singleKeyProbe(
     Expression* probeKey,
     Iterator* probeIter,
-    const std::unordered_map<Value, std::vector<const Row*>>& hashTable) const {
+    const HashTable<Value>& hashTable) const {
   DataSet ds;
   QueryExpressionContext ctx(ectx_);
   for (; probeIter->valid(); probeIter->next()) {
@@ -116,8 +116,6 @@ DataSet InnerJoinExecutor::singleKeyProbe(
 folly::Future<Status> InnerJoinExecutor::joinMultiJobs(const std::vector<Expression*>& hashKeys,
                                                        const std::vector<Expression*>& probeKeys,
                                                        const std::vector<std::string>& colNames) {
-  auto bucketSize = lhsIter_->size() > rhsIter_->size() ? rhsIter_->size() : lhsIter_->size();
-
   DCHECK_EQ(hashKeys.size(), probeKeys.size());
 
   if (lhsIter_->empty() || rhsIter_->empty()) {
@@ -127,36 +125,38 @@ folly::Future<Status> InnerJoinExecutor::joinMultiJobs(const std::vector<Express
   }
 
   if (hashKeys.size() == 1 && probeKeys.size() == 1) {
-    hashTable_.reserve(bucketSize);
     if (lhsIter_->size() < rhsIter_->size()) {
-      buildSingleKeyHashTable(hashKeys.front(), lhsIter_.get(), hashTable_);
-      return singleKeyProbe(probeKeys.front(), rhsIter_.get());
+      return buildSingleKeyHashTableMultiJobs(hashKeys.front(), lhsIter_.get())
+          .thenValue([this, probeKey = probeKeys.front()](auto&&) {
+            return singleKeyProbe(probeKey, rhsIter_.get());
+          });
     } else {
       exchange_ = true;
-      buildSingleKeyHashTable(probeKeys.front(), rhsIter_.get(), hashTable_);
-      return singleKeyProbe(hashKeys.front(), lhsIter_.get());
+      return buildSingleKeyHashTableMultiJobs(probeKeys.front(), rhsIter_.get())
+          .thenValue([this, probeKey = hashKeys.front()](auto&&) {
+            return singleKeyProbe(probeKey, lhsIter_.get());
+          });
     }
   } else {
-    listHashTable_.reserve(bucketSize);
     if (lhsIter_->size() < rhsIter_->size()) {
-      buildHashTable(hashKeys, lhsIter_.get(), listHashTable_);
-      return probe(probeKeys, rhsIter_.get());
+      return buildHashTableMultiJobs(hashKeys, lhsIter_.get())
+          .thenValue([this, probeKeys](auto&&) { return probe(probeKeys, rhsIter_.get()); });
     } else {
       exchange_ = true;
-      buildHashTable(probeKeys, rhsIter_.get(), listHashTable_);
-      return probe(hashKeys, lhsIter_.get());
+      return buildHashTableMultiJobs(probeKeys, rhsIter_.get())
+          .thenValue([this, hashKeys](auto&&) { return probe(hashKeys, lhsIter_.get()); });
     }
   }
 }
 
 folly::Future<Status> InnerJoinExecutor::probe(const std::vector<Expression*>& probeKeys,
                                                Iterator* probeIter) {
-  std::vector<Expression*> tmpProbeKeys;
-  std::for_each(probeKeys.begin(), probeKeys.end(), [&tmpProbeKeys](auto& e) {
-    tmpProbeKeys.emplace_back(e->clone());
-  });
-  auto scatter = [this, tmpProbeKeys = std::move(tmpProbeKeys)](
+  auto scatter = [this, probeKeys = probeKeys](
                      size_t begin, size_t end, Iterator* tmpIter) -> StatusOr<DataSet> {
+    std::vector<Expression*> tmpProbeKeys;
+    std::for_each(probeKeys.begin(), probeKeys.end(), [&tmpProbeKeys](auto& e) {
+      tmpProbeKeys.emplace_back(e->clone());
+    });
     DataSet ds;
     QueryExpressionContext ctx(ectx_);
     ds.rows.reserve(end - begin);
@@ -167,7 +167,7 @@ folly::Future<Status> InnerJoinExecutor::probe(const std::vector<Expression*>& p
         Value val = col->eval(ctx(tmpIter));
         list.values.emplace_back(std::move(val));
       }
-      buildNewRow<List>(listHashTable_, list, *tmpIter->row(), ds);
+      buildNewRow<List>(partition(listHashTables_, list), list, *tmpIter->row(), ds);
     }
     return ds;
   };
@@ -198,7 +198,7 @@ folly::Future<Status> InnerJoinExecutor::singleKeyProbe(Expression* probeKey, It
     ds.rows.reserve(end - begin);
     for (; tmpIter->valid() && begin++ < end; tmpIter->next()) {
       auto& val = tmpProbeKey->eval(ctx(tmpIter));
-      buildNewRow<Value>(hashTable_, val, *tmpIter->row(), ds);
+      buildNewRow<Value>(partition(hashTables_, val), val, *tmpIter->row(), ds);
     }
     return ds;
   };
@@ -221,7 +221,7 @@ folly::Future<Status> InnerJoinExecutor::singleKeyProbe(Expression* probeKey, It
 }
 
 template <class T>
-void InnerJoinExecutor::buildNewRow(const std::unordered_map<T, std::vector<const Row*>>& hashTable,
+void InnerJoinExecutor::buildNewRow(const HashTable<T>& hashTable,
                                     const T& val,
                                     Row rRow,
                                     DataSet& ds) const {
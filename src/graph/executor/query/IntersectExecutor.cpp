@@ -5,6 +5,7 @@
 #include "graph/executor/query/IntersectExecutor.h"
 
 #include "graph/planner/plan/Query.h"
+#include "graph/util/RowHashSet.h"
 
 namespace nebula {
 namespace graph {
@@ -14,36 +15,44 @@ folly::Future<Status> IntersectExecutor::execute() {
 
   NG_RETURN_IF_ERROR(checkInputDataSets());
 
-  auto left = getLeftInputData();
-  auto right = getRightInputData();
+  auto left = std::make_shared<Result>(getLeftInputData());
+  auto right = std::make_shared<Result>(getRightInputData());
 
-  std::unordered_set<const Row*> hashSet;
-  for (; right.iterRef()->valid(); right.iterRef()->next()) {
-    hashSet.insert(right.iterRef()->row());
-    // TODO: should test duplicate rows
-  }
-
-  auto* lIter = left.iterRef();
-  ResultBuilder builder;
-  if (hashSet.empty()) {
-    auto value = lIter->valuePtr();
+  if (right->iterRef()->empty()) {
+    auto value = left->iterRef()->valuePtr();
     DataSet ds;
     ds.colNames = value->getDataSet().colNames;
+    ResultBuilder builder;
     builder.value(Value(std::move(ds))).iter(Iterator::Kind::kSequential);
     return finish(builder.build());
   }
 
-  while (lIter->valid()) {
-    auto iter = hashSet.find(lIter->row());
-    if (iter == hashSet.end()) {
-      lIter->unstableErase();
-    } else {
-      lIter->next();
-    }
-  }
-
-  builder.value(left.valuePtr()).iter(std::move(left).iter());
-  return finish(builder.build());
+  return folly::collect(hashRows(right->iterRef()), hashRows(left->iterRef()))
+      .via(runner())
+      .thenValue([this, left, right](auto&& hashes) {
+        SCOPED_TIMER(&execTime_);
+        auto& rHashes = std::get<0>(hashes);
+        auto& lHashes = std::get<1>(hashes);
+        auto* rIter = right->iterRef();
+        RowHashSet hashSet(rHashes.size());
+        for (size_t i = 0; rIter->valid(); rIter->next(), ++i) {
+          hashSet.insert(rIter->row(), rHashes[i]);
+        }
+
+        auto* lIter = left->iterRef();
+        for (size_t pos = 0; lIter->valid(); ++pos) {
+          if (!hashSet.contains(lIter->row(), lHashes[pos])) {
+            lIter->markErased();
+          } else {
+            lIter->next();
+          }
+        }
+        lIter->compact();
+
+        ResultBuilder builder;
+        builder.value(left->valuePtr()).iter(std::move(*left).iter());
+        return finish(builder.build());
+      });
 }
 
 }  // namespace graph
@@ -5,14 +5,15 @@
 #include "graph/executor/query/JoinExecutor.h"
 
 #include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 
 namespace nebula {
 namespace graph {
 
 Status JoinExecutor::checkInputDataSets() {
   // Since the executors might reuse in loops, so manually clear the table here.
-  hashTable_.clear();
-  listHashTable_.clear();
+  hashTables_.clear();
+  listHashTables_.clear();
   auto* join = asNode<Join>(node());
   lhsIter_ = ectx_->getVersionedResult(join->leftVar().first, join->leftVar().second).iter();
   DCHECK(!!lhsIter_);
@@ -54,7 +55,7 @@ Status JoinExecutor::checkBiInputDataSets() {
 
 void JoinExecutor::buildHashTable(const std::vector<Expression*>& hashKeys,
                                   Iterator* iter,
-                                  std::unordered_map<List, std::vector<const Row*>>& hashTable) {
+                                  HashTable<List>& hashTable) {
   QueryExpressionContext ctx(ectx_);
   for (; iter->valid(); iter->next()) {
     List list;
@@ -69,10 +70,9 @@ void JoinExecutor::buildHashTable(const std::vector<Expression*>& hashKeys,
   }
 }
 
-void JoinExecutor::buildSingleKeyHashTable(
-    Expression* hashKey,
-    Iterator* iter,
-    std::unordered_map<Value, std::vector<const Row*>>& hashTable) {
+void JoinExecutor::buildSingleKeyHashTable(Expression* hashKey,
+                                           Iterator* iter,
+                                           HashTable<Value>& hashTable) {
   QueryExpressionContext ctx(ectx_);
   for (; iter->valid(); iter->next()) {
     auto& val = hashKey->eval(ctx(iter));
@@ -82,6 +82,97 @@ void JoinExecutor::buildSingleKeyHashTable(
   }
 }
 
+folly::Future<Status> JoinExecutor::buildHashTableMultiJobs(
+    const std::vector<Expression*>& hashKeys, Iterator* iter) {
+  if (iter->size() <= static_cast<size_t>(FLAGS_min_batch_size)) {
+    listHashTables_.resize(1);
+    listHashTables_.front().reserve(iter->size());
+    buildHashTable(hashKeys, iter, listHashTables_.front());
+    return Status::OK();
+  }
+  auto getKey = [](const std::vector<Expression*>& keys,
+                   QueryExpressionContext& ctx,
+                   Iterator* tmpIter) -> List {
+    List list;
+    list.values.reserve(keys.size());
+    for (auto& col : keys) {
+      list.values.emplace_back(col->eval(ctx(tmpIter)));
+    }
+    return list;
+  };
+  return buildPartitionedHashTables(hashKeys, std::move(getKey), iter, listHashTables_);
+}
+
+folly::Future<Status> JoinExecutor::buildSingleKeyHashTableMultiJobs(Expression* hashKey,
+                                                                     Iterator* iter) {
+  if (iter->size() <= static_cast<size_t>(FLAGS_min_batch_size)) {
+    hashTables_.resize(1);
+    hashTables_.front().reserve(iter->size());
+    buildSingleKeyHashTable(hashKey, iter, hashTables_.front());
+    return Status::OK();
+  }
+  auto getKey = [](const std::vector<Expression*>& keys,
+                   QueryExpressionContext& ctx,
+                   Iterator* tmpIter) -> Value { return keys.front()->eval(ctx(tmpIter)); };
+  return buildPartitionedHashTables({hashKey}, std::move(getKey), iter, hashTables_);
+}
+
+// The rows are built in two phases without any lock:
+// 1. Each job evaluates the keys of a range of rows, and scatters them into partitions by the
+//    hash of the key.
+// 2. Each partition is built into its own hash table by one job, in the order of rows.
+template <class T, class KeyFunc>
+folly::Future<Status> JoinExecutor::buildPartitionedHashTables(
+    const std::vector<Expression*>& hashKeys,
+    KeyFunc getKey,
+    Iterator* iter,
+    std::vector<HashTable<T>>& hashTables) {
+  size_t num = FLAGS_max_job_size;
+  hashTables.resize(num);
+  using Partitions = std::vector<std::vector<std::pair<T, const Row*>>>;
+
+  auto scatter = [this, num, hashKeys, getKey](
+                     size_t begin, size_t end, Iterator* tmpIter) -> StatusOr<Partitions> {
+    // The expressions could not be evaluated by multiple threads concurrently
+    std::vector<Expression*> keys;
+    keys.reserve(hashKeys.size());
+    for (auto* key : hashKeys) {
+      keys.emplace_back(key->clone());
+    }
+    QueryExpressionContext ctx(ectx_);
+    Partitions partitions(num);
+    for (; tmpIter->valid() && begin++ < end; tmpIter->next()) {
+      auto key = getKey(keys, ctx, tmpIter);
+      auto& part = partitions[std::hash<T>()(key) % num];
+      part.emplace_back(std::move(key), tmpIter->row());
+    }
+    return partitions;
+  };
+
+  auto gather = [this, &hashTables](std::vector<StatusOr<Partitions>>&& results) {
+    auto jobs = std::make_shared<std::vector<StatusOr<Partitions>>>(std::move(results));
+    std::vector<folly::Future<folly::Unit>> futures;
+    futures.reserve(hashTables.size());
+    for (size_t i = 0; i < hashTables.size(); ++i) {
+      futures.emplace_back(folly::via(runner(), [jobs, i, &hashTable = hashTables[i]]() {
+        size_t size = 0;
+        for (auto& job : *jobs) {
+          size += job.value()[i].size();
+        }
+        hashTable.reserve(size);
+        for (auto& job : *jobs) {
+          for (auto& entry : job.value()[i]) {
+            hashTable[std::move(entry.first)].emplace_back(entry.second);
+          }
+        }
+      }));
+    }
+    return folly::collect(futures).via(runner()).thenValue([](auto&&) { return Status::OK(); });
+  };
+
+  return runMultiJobs(std::move(scatter), std::move(gather), iter);
+}
+
 Row JoinExecutor::newRow(Row left, Row right) const {
   Row r;
   r.reserve(left.size() + right.size());
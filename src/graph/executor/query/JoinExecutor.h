@@ -5,6 +5,8 @@
 #ifndef GRAPH_EXECUTOR_QUERY_JOINEXECUTOR_H_
 #define GRAPH_EXECUTOR_QUERY_JOINEXECUTOR_H_
 
+#include <folly/container/F14Map.h>
+
 #include "graph/executor/Executor.h"
 
 namespace nebula {
@@ -15,6 +17,9 @@ class JoinExecutor : public Executor {
   JoinExecutor(const std::string& name, const PlanNode* node, QueryContext* qctx)
       : Executor(name, node, qctx) {}
 
+  template <class T>
+  using HashTable = folly::F14FastMap<T, std::vector<const Row*>>;
+
  protected:
   Status checkInputDataSets();
 
@@ -22,11 +27,26 @@ class JoinExecutor : public Executor {
 
   void buildHashTable(const std::vector<Expression*>& hashKeys,
                       Iterator* iter,
-                      std::unordered_map<List, std::vector<const Row*>>& hashTable);
+                      HashTable<List>& hashTable);
+
+  void buildSingleKeyHashTable(Expression* hashKey, Iterator* iter, HashTable<Value>& hashTable);
 
-  void buildSingleKeyHashTable(Expression* hashKey,
-                               Iterator* iter,
-                               std::unordered_map<Value, std::vector<const Row*>>& hashTable);
+  // Build listHashTables_/hashTables_ for the multi jobs join. The hash tables are built by
+  // multiple jobs if there are enough rows, see buildPartitionedHashTables.
+  folly::Future<Status> buildHashTableMultiJobs(const std::vector<Expression*>& hashKeys,
+                                                Iterator* iter);
+
+  folly::Future<Status> buildSingleKeyHashTableMultiJobs(Expression* hashKey, Iterator* iter);
+
+  // Get the partition of the hash tables which the key belongs to
+  template <class T>
+  static const HashTable<T>& partition(const std::vector<HashTable<T>>& hashTables,
+                                       const T& key) {
+    if (hashTables.size() == 1) {
+      return hashTables.front();
+    }
+    return hashTables[std::hash<T>()(key) % hashTables.size()];
+  }
 
   // concat rows
   Row newRow(Row left, Row right) const;
@@ -34,8 +54,16 @@ class JoinExecutor : public Executor {
   std::unique_ptr<Iterator> lhsIter_;
   std::unique_ptr<Iterator> rhsIter_;
   size_t colSize_{0};
-  std::unordered_map<Value, std::vector<const Row*>> hashTable_;
-  std::unordered_map<List, std::vector<const Row*>> listHashTable_;
+  // The hash tables partitioned by the hash of keys, used by the multi jobs join
+  std::vector<HashTable<Value>> hashTables_;
+  std::vector<HashTable<List>> listHashTables_;
+
+ private:
+  template <class T, class KeyFunc>
+  folly::Future<Status> buildPartitionedHashTables(const std::vector<Expression*>& hashKeys,
+                                                   KeyFunc getKey,
+                                                   Iterator* iter,
+                                                   std::vector<HashTable<T>>& hashTables);
 };
 }  // namespace graph
 }  // namespace nebula
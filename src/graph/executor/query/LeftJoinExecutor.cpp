@@ -35,7 +35,7 @@ folly::Future<Status> LeftJoinExecutor::join(const std::vector<Expression*>& has
   DCHECK_EQ(hashKeys.size(), probeKeys.size());
   DataSet result;
   if (hashKeys.size() == 1 && probeKeys.size() == 1) {
-    std::unordered_map<Value, std::vector<const Row*>> hashTable;
+    HashTable<Value> hashTable;
     hashTable.reserve(rhsIter_->empty() ? 1 : rhsIter_->size());
     if (!lhsIter_->empty()) {
       buildSingleKeyHashTable(probeKeys.front(), rhsIter_.get(), hashTable);
@@ -43,7 +43,7 @@ folly::Future<Status> LeftJoinExecutor::join(const std::vector<Expression*>& has
       result = singleKeyProbe(hashKeys.front(), lhsIter_.get(), hashTable);
     }
   } else {
-    std::unordered_map<List, std::vector<const Row*>> hashTable;
+    HashTable<List> hashTable;
     hashTable.reserve(rhsIter_->empty() ? 1 : rhsIter_->size());
     if (!lhsIter_->empty()) {
       buildHashTable(probeKeys, rhsIter_.get(), hashTable);
@@ -59,7 +59,7 @@ folly::Future<Status> LeftJoinExecutor::join(const std::vector<Expression*>& has
 DataSet LeftJoinExecutor::probe(
     const std::vector<Expression*>& probeKeys,
     Iterator* probeIter,
-    const std::unordered_map<List, std::vector<const Row*>>& hashTable) const {
+    const HashTable<List>& hashTable) const {
   DataSet ds;
   ds.rows.reserve(probeIter->size());
   QueryExpressionContext ctx(ectx_);
@@ -85,7 +85,7 @@ DataSet LeftJoinExecutor::probe(
 DataSet LeftJoinExecutor::singleKeyProbe(
     Expression* probeKey,
     Iterator* probeIter,
-    const std::unordered_map<Value, std::vector<const Row*>>& hashTable) const {
+    const HashTable<Value>& hashTable) const {
   DataSet ds;
   ds.rows.reserve(probeIter->size());
   QueryExpressionContext ctx(ectx_);
@@ -108,16 +108,16 @@ folly::Future<Status> LeftJoinExecutor::joinMultiJobs(const std::vector<Expressi
   DCHECK_EQ(hashKeys.size(), probeKeys.size());
   DataSet result;
   if (hashKeys.size() == 1 && probeKeys.size() == 1) {
-    hashTable_.reserve(rhsIter_->empty() ? 1 : rhsIter_->size());
     if (!lhsIter_->empty()) {
-      buildSingleKeyHashTable(probeKeys.front(), rhsIter_.get(), hashTable_);
-      return singleKeyProbe(hashKeys.front(), lhsIter_.get());
+      return buildSingleKeyHashTableMultiJobs(probeKeys.front(), rhsIter_.get())
+          .thenValue([this, hashKey = hashKeys.front()](auto&&) {
+            return singleKeyProbe(hashKey, lhsIter_.get());
+          });
     }
   } else {
-    listHashTable_.reserve(rhsIter_->empty() ? 1 : rhsIter_->size());
     if (!lhsIter_->empty()) {
-      buildHashTable(probeKeys, rhsIter_.get(), listHashTable_);
-      return probe(hashKeys, lhsIter_.get());
+      return buildHashTableMultiJobs(probeKeys, rhsIter_.get())
+          .thenValue([this, hashKeys](auto&&) { return probe(hashKeys, lhsIter_.get()); });
     }
   }
 
@@ -144,7 +144,7 @@ folly::Future<Status> LeftJoinExecutor::probe(const std::vector<Expression*>& pr
         list.values.emplace_back(std::move(val));
       }
 
-      buildNewRow<List>(listHashTable_, list, *tmpIter->row(), ds);
+      buildNewRow<List>(partition(listHashTables_, list), list, *tmpIter->row(), ds);
     }
     return ds;
   };
@@ -174,7 +174,7 @@ folly::Future<Status> LeftJoinExecutor::singleKeyProbe(Expression* probeKey, Ite
     ds.rows.reserve(end - begin);
     for (; tmpIter->valid() && begin++ < end; tmpIter->next()) {
       auto& val = tmpProbeKey->eval(ctx(tmpIter));
-      buildNewRow<Value>(hashTable_, val, *tmpIter->row(), ds);
+      buildNewRow<Value>(partition(hashTables_, val), val, *tmpIter->row(), ds);
     }
     return ds;
   };
@@ -197,7 +197,7 @@ folly::Future<Status> LeftJoinExecutor::singleKeyProbe(Expression* probeKey, Ite
 }
 
 template <class T>
-void LeftJoinExecutor::buildNewRow(const std::unordered_map<T, std::vector<const Row*>>& hashTable,
+void LeftJoinExecutor::buildNewRow(const HashTable<T>& hashTable,
                                    const T& val,
                                    Row lRow,
                                    DataSet& ds) const {
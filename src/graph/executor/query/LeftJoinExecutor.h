@@ -27,14 +27,14 @@ class LeftJoinExecutor : public JoinExecutor {
 
   DataSet probe(const std::vector<Expression*>& probeKeys,
                 Iterator* probeIter,
-                const std::unordered_map<List, std::vector<const Row*>>& hashTable) const;
+                const HashTable<List>& hashTable) const;
 
   DataSet singleKeyProbe(Expression* probeKey,
                          Iterator* probeIter,
-                         const std::unordered_map<Value, std::vector<const Row*>>& hashTable) const;
+                         const HashTable<Value>& hashTable) const;
 
   // joinMultiJobs/probe/singleKeyProbe implemented for multi jobs.
-  // For now, the InnerJoin implementation only implement the parallel processing on probe side.
+  // Both the hash tables building and the probing are processed by multiple jobs.
   folly::Future<Status> joinMultiJobs(const std::vector<Expression*>& hashKeys,
                                       const std::vector<Expression*>& probeKeys,
                                       const std::vector<std::string>& colNames);
@@ -44,7 +44,7 @@ class LeftJoinExecutor : public JoinExecutor {
   folly::Future<Status> singleKeyProbe(Expression* probeKey, Iterator* probeIter);
 
   template <class T>
-  void buildNewRow(const std::unordered_map<T, std::vector<const Row*>>& hashTable,
+  void buildNewRow(const HashTable<T>& hashTable,
                    const T& val,
                    Row lRow,
                    DataSet& ds) const;
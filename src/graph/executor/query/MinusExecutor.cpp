@@ -5,6 +5,7 @@
 #include "graph/executor/query/MinusExecutor.h"
 
 #include "graph/planner/plan/Query.h"
+#include "graph/util/RowHashSet.h"
 
 namespace nebula {
 namespace graph {
@@ -14,30 +15,41 @@ folly::Future<Status> MinusExecutor::execute() {
 
   NG_RETURN_IF_ERROR(checkInputDataSets());
 
-  auto left = getLeftInputData();
-  auto right = getRightInputData();
+  auto left = std::make_shared<Result>(getLeftInputData());
+  auto right = std::make_shared<Result>(getRightInputData());
 
-  std::unordered_set<const Row*> hashSet;
-  for (; right.iterRef()->valid(); right.iterRef()->next()) {
-    hashSet.insert(right.iterRef()->row());
-    // TODO: should test duplicate rows
+  if (right->iterRef()->empty()) {
+    ResultBuilder builder;
+    builder.value(left->valuePtr()).iter(std::move(*left).iter());
+    return finish(builder.build());
   }
 
-  auto* lIter = left.iterRef();
-  if (!hashSet.empty()) {
-    while (lIter->valid()) {
-      auto iter = hashSet.find(lIter->row());
-      if (iter == hashSet.end()) {
-        lIter->next();
-      } else {
-        lIter->unstableErase();
-      }
-    }
-  }
-
-  ResultBuilder builder;
-  builder.value(left.valuePtr()).iter(std::move(left).iter());
-  return finish(builder.build());
+  return folly::collect(hashRows(right->iterRef()), hashRows(left->iterRef()))
+      .via(runner())
+      .thenValue([this, left, right](auto&& hashes) {
+        SCOPED_TIMER(&execTime_);
+        auto& rHashes = std::get<0>(hashes);
+        auto& lHashes = std::get<1>(hashes);
+        auto* rIter = right->iterRef();
+        RowHashSet hashSet(rHashes.size());
+        for (size_t i = 0; rIter->valid(); rIter->next(), ++i) {
+          hashSet.insert(rIter->row(), rHashes[i]);
+        }
+
+        auto* lIter = left->iterRef();
+        for (size_t pos = 0; lIter->valid(); ++pos) {
+          if (hashSet.contains(lIter->row(), lHashes[pos])) {
+            lIter->markErased();
+          } else {
+            lIter->next();
+          }
+        }
+        lIter->compact();
+
+        ResultBuilder builder;
+        builder.value(left->valuePtr()).iter(std::move(*left).iter());
+        return finish(builder.build());
+      });
 }
 
 }  // namespace graph
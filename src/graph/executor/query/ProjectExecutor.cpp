@@ -4,6 +4,7 @@
 
 #include "graph/executor/query/ProjectExecutor.h"
 
+#include "graph/context/BatchEvaluator.h"
 #include "graph/planner/plan/Query.h"
 #include "graph/service/GraphFlags.h"
 
@@ -16,9 +17,13 @@ folly::Future<Status> ProjectExecutor::execute() {
   auto iter = ectx_->getResult(project->inputVar()).iter();
   DCHECK(!!iter);
   QueryExpressionContext ctx(ectx_);
+  mv_ = movable(node()->inputVars().front());
 
   if (FLAGS_max_job_size <= 1) {
-    auto ds = handleJob(0, iter->size(), iter.get());
+    DataSet ds;
+    if (!handleBatchJob(iter.get(), &ds)) {
+      ds = handleJob(0, iter->size(), iter.get());
+    }
     return finish(ResultBuilder().value(Value(std::move(ds))).build());
   } else {
     DataSet ds;
@@ -51,16 +56,91 @@ DataSet ProjectExecutor::handleJob(size_t begin, size_t end, Iterator *iter) {
   ds.colNames = project->colNames();
   QueryExpressionContext ctx(qctx()->ectx());
   ds.rows.reserve(end - begin);
+  const auto &cols = columns->columns();
+  auto moved = mv_ ? movedColumns(columns.get(), iter) : std::vector<int32_t>(cols.size(), -1);
   for (; iter->valid() && begin++ < end; iter->next()) {
     Row row;
-    for (auto &col : columns->columns()) {
-      Value val = col->expr()->eval(ctx(iter));
-      row.values.emplace_back(std::move(val));
+    row.values.resize(cols.size());
+    // Evaluate the columns before any value of the input row is moved away
+    for (size_t i = 0; i < cols.size(); ++i) {
+      if (moved[i] < 0) {
+        row.values[i] = cols[i]->expr()->eval(ctx(iter));
+      }
+    }
+    for (size_t i = 0; i < cols.size(); ++i) {
+      if (moved[i] >= 0) {
+        row.values[i] = iter->moveColumn(moved[i]);
+      }
     }
     ds.rows.emplace_back(std::move(row));
   }
   return ds;
 }
 
+// static
+std::vector<int32_t> ProjectExecutor::movedColumns(const YieldColumns *columns,
+                                                   const Iterator *iter) {
+  const auto &cols = columns->columns();
+  std::vector<int32_t> moved(cols.size(), -1);
+  if (iter->kind() != Iterator::Kind::kSequential && iter->kind() != Iterator::Kind::kProp) {
+    return moved;
+  }
+  // input column index -> the last projected column referencing it
+  std::unordered_map<size_t, size_t> referencedBy;
+  for (size_t i = 0; i < cols.size(); ++i) {
+    const auto *expr = cols[i]->expr();
+    if (expr->kind() != Expression::Kind::kInputProperty &&
+        expr->kind() != Expression::Kind::kVarProperty) {
+      continue;
+    }
+    // Both are evaluated as the column of the current row
+    auto index = iter->getColumnIndex(static_cast<const PropertyExpression *>(expr)->prop());
+    if (index.ok()) {
+      referencedBy[index.value()] = i;
+    }
+  }
+  for (auto &kv : referencedBy) {
+    moved[kv.second] = static_cast<int32_t>(kv.first);
+  }
+  return moved;
+}
+
+bool ProjectExecutor::handleBatchJob(Iterator *iter, DataSet *ds) {
+  if (!FLAGS_enable_batch_expression_eval || iter->kind() != Iterator::Kind::kSequential) {
+    return false;
+  }
+  auto *project = asNode<Project>(node());
+  std::vector<std::unique_ptr<BatchEvaluator>> evaluators;
+  for (auto &col : project->columns()->columns()) {
+    auto evaluator = BatchEvaluator::compile(col->expr());
+    if (evaluator == nullptr) {
+      return false;
+    }
+    evaluators.emplace_back(std::move(evaluator));
+  }
+
+  auto batch = static_cast<SequentialIter *>(iter)->columnBatch();
+  std::vector<BatchVector> columns;
+  columns.reserve(evaluators.size());
+  for (auto &evaluator : evaluators) {
+    auto col = evaluator->eval(*batch);
+    if (!col.ok()) {
+      return false;
+    }
+    columns.emplace_back(std::move(col).value());
+  }
+
+  ds->colNames = project->colNames();
+  ds->rows.resize(batch->numRows());
+  for (size_t i = 0; i < ds->rows.size(); ++i) {
+    auto &values = ds->rows[i].values;
+    values.reserve(columns.size());
+    for (auto &col : columns) {
+      values.emplace_back(col.value(i));
+    }
+  }
+  return true;
+}
+
 }  // namespace graph
 }  // namespace nebula
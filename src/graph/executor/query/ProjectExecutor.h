@@ -6,6 +6,7 @@
 #define GRAPH_EXECUTOR_QUERY_PROJECTEXECUTOR_H_
 
 #include "graph/executor/Executor.h"
+#include "parser/Clauses.h"
 // select user-specified columns from a table
 namespace nebula {
 namespace graph {
@@ -18,6 +19,20 @@ class ProjectExecutor final : public Executor {
   folly::Future<Status> execute() override;
 
   DataSet handleJob(size_t begin, size_t end, Iterator *iter);
+
+  // The index of the input column referenced by each projected column directly, whose value could
+  // be moved into the result if the input is owned exclusively, otherwise -1 for the projected
+  // columns to evaluate. The input column referenced by several projected columns is moved into
+  // the last one only.
+  static std::vector<int32_t> movedColumns(const YieldColumns *columns, const Iterator *iter);
+
+ private:
+  // Evaluate all columns column-at-a-time, return false if any column is not
+  // supported by the batch evaluator.
+  bool handleBatchJob(Iterator *iter, DataSet *ds);
+
+  // Whether the values of the input could be moved
+  bool mv_{false};
 };
 
 }  // namespace graph
@@ -33,8 +33,9 @@ folly::Future<Status> ScanEdgesExecutor::scanEdges() {
                                           qctx()->rctx()->session()->id(),
                                           qctx()->plan()->id(),
                                           qctx()->plan()->isProfileEnabled());
+  setReadDeadline(param);
   return DCHECK_NOTNULL(client)
-      ->scanEdge(param, *DCHECK_NOTNULL(se->props()), se->limit(), se->filter())
+      ->scanEdge(param, *DCHECK_NOTNULL(se->props()), se->limit(), se->filter(), se->orderBy())
       .via(runner())
       .ensure([this, scanEdgesTime]() {
         SCOPED_TIMER(&execTime_);
@@ -34,6 +34,7 @@ folly::Future<Status> ScanVerticesExecutor::scanVertices() {
                                           qctx()->rctx()->session()->id(),
                                           qctx()->plan()->id(),
                                           qctx()->plan()->isProfileEnabled());
+  setReadDeadline(param);
   return DCHECK_NOTNULL(storageClient)
       ->scanVertex(param, *DCHECK_NOTNULL(sv->props()), sv->limit(), sv->filter())
       .via(runner())
@@ -4,7 +4,12 @@
 
 #include "graph/executor/query/SortExecutor.h"
 
-#include "graph/planner/plan/Query.h"
+#include <folly/Endian.h>
+
+#include <numeric>
+#include <queue>
+
+#include "graph/service/GraphFlags.h"
 
 namespace nebula {
 namespace graph {
@@ -24,27 +29,197 @@ folly::Future<Status> SortExecutor::execute() {
     return Status::Error(ss.str());
   }
 
-  auto &factors = sort->factors();
-  auto comparator = [&factors](const Row &lhs, const Row &rhs) {
-    for (auto &item : factors) {
-      auto index = item.first;
-      auto orderType = item.second;
-      if (lhs[index] == rhs[index]) {
-        continue;
-      }
+  auto seqIter = static_cast<SequentialIter *>(iter);
+  auto size = seqIter->size();
+  if (FLAGS_max_job_size > 1 && size > static_cast<size_t>(FLAGS_min_batch_size)) {
+    return sortMultiJobs(std::move(result));
+  }
+  if (size > 1) {
+    std::vector<SortedRun> runs;
+    runs.emplace_back(sortRun(seqIter->begin(), 0, size));
+    mergeRuns(seqIter->begin(), runs);
+  }
+  return finish(ResultBuilder().value(result.valuePtr()).iter(std::move(result).iter()).build());
+}
+
+folly::Future<Status> SortExecutor::sortMultiJobs(Result &&result) {
+  auto res = std::make_shared<Result>(std::move(result));
+  auto rows = static_cast<SequentialIter *>(res->iterRef())->begin();
+
+  auto scatter = [this, rows](size_t begin, size_t end, Iterator *) -> SortedRun {
+    return sortRun(rows, begin, end);
+  };
+
+  auto gather = [this, res, rows](std::vector<SortedRun> &&runs) -> Status {
+    mergeRuns(rows, runs);
+    runs.clear();
+    return finish(ResultBuilder().value(res->valuePtr()).iter(std::move(*res).iter()).build());
+  };
 
-      if (orderType == OrderFactor::OrderType::ASCEND) {
-        return lhs[index] < rhs[index];
-      } else if (orderType == OrderFactor::OrderType::DESCEND) {
-        return lhs[index] > rhs[index];
+  return runMultiJobs(std::move(scatter), std::move(gather), res->iterRef());
+}
+
+bool SortExecutor::encodeSortKey(const Row &row, const Factors &factors, std::string &key) {
+  // The leading byte of each value keeps the order of the types in Value::operator<
+  static constexpr char kEmpty = 0x01;
+  static constexpr char kBool = 0x02;
+  static constexpr char kInt = 0x03;
+  static constexpr char kString = 0x05;
+  static constexpr char kNull = static_cast<char>(0xFF);
+
+  for (auto &factor : factors) {
+    auto start = key.size();
+    const auto &val = row[factor.first];
+    switch (val.type()) {
+      case Value::Type::__EMPTY__: {
+        key.push_back(kEmpty);
+        break;
+      }
+      case Value::Type::NULLVALUE: {
+        // The kinds of null are equal as values, but are kept apart in the key, ordered by kind
+        key.push_back(kNull);
+        key.push_back(static_cast<char>(val.getNull()));
+        break;
+      }
+      case Value::Type::BOOL: {
+        key.push_back(kBool);
+        key.push_back(val.getBool() ? 0x01 : 0x00);
+        break;
+      }
+      case Value::Type::INT: {
+        key.push_back(kInt);
+        // Flip the sign bit, so the negatives are ordered before the positives
+        uint64_t v = folly::Endian::big(static_cast<uint64_t>(val.getInt()) ^ (1ULL << 63));
+        key.append(reinterpret_cast<const char *>(&v), sizeof(v));
+        break;
+      }
+      case Value::Type::STRING: {
+        key.push_back(kString);
+        // Escape '\0' as "\0\1" and terminate with "\0\0", so a string is ordered before the ones
+        // it is a prefix of
+        for (auto c : val.getStr()) {
+          key.push_back(c);
+          if (c == '\0') {
+            key.push_back(0x01);
+          }
+        }
+        key.append(2, '\0');
+        break;
+      }
+      default: {
+        return false;
+      }
+    }
+    if (factor.second == OrderFactor::OrderType::DESCEND) {
+      for (auto i = start; i < key.size(); ++i) {
+        key[i] = ~key[i];
       }
     }
-    return false;
+  }
+  return true;
+}
+
+SortExecutor::SortedRun SortExecutor::sortRun(std::vector<Row>::iterator rows,
+                                              size_t begin,
+                                              size_t end) const {
+  auto &factors = asNode<Sort>(node())->factors();
+  SortedRun run;
+  run.begin = begin;
+  run.indices.resize(end - begin);
+  std::iota(run.indices.begin(), run.indices.end(), begin);
+
+  run.keys.resize(end - begin);
+  int64_t bytes = 0;
+  for (auto i = begin; i < end; ++i) {
+    auto &key = run.keys[i - begin];
+    if (!encodeSortKey(rows[i], factors, key)) {
+      run.keys.clear();
+      break;
+    }
+    bytes += key.capacity() + sizeof(std::string);
+  }
+  if (!run.keys.empty()) {
+    auto reservation = MemoryReservation::reserve(memTracker_, bytes);
+    if (reservation.ok()) {
+      run.reservation = std::move(reservation).value();
+    } else {
+      run.keys.clear();
+    }
+  }
+  run.keys.shrink_to_fit();
+
+  if (!run.keys.empty()) {
+    std::sort(run.indices.begin(), run.indices.end(), [&run](size_t lhs, size_t rhs) {
+      return run.keys[lhs - run.begin] < run.keys[rhs - run.begin];
+    });
+  } else {
+    std::sort(run.indices.begin(), run.indices.end(), [this, rows](size_t lhs, size_t rhs) {
+      return compareRows(rows[lhs], rows[rhs]);
+    });
+  }
+  return run;
+}
+
+void SortExecutor::mergeRuns(std::vector<Row>::iterator rows, std::vector<SortedRun> &runs) const {
+  size_t size = 0;
+  bool byKey = true;
+  for (auto &run : runs) {
+    size += run.indices.size();
+    byKey = byKey && !run.keys.empty();
+  }
+  // The rows sorted by keys are sorted by values as well
+  auto less = [this, rows, byKey, &runs](size_t lRun, size_t lPos, size_t rRun, size_t rPos) {
+    auto &l = runs[lRun];
+    auto &r = runs[rRun];
+    auto lIndex = l.indices[lPos];
+    auto rIndex = r.indices[rPos];
+    if (byKey) {
+      return l.keys[lIndex - l.begin] < r.keys[rIndex - r.begin];
+    }
+    return compareRows(rows[lIndex], rows[rIndex]);
   };
 
-  auto seqIter = static_cast<SequentialIter *>(iter);
-  std::sort(seqIter->begin(), seqIter->end(), comparator);
-  return finish(ResultBuilder().value(result.valuePtr()).iter(std::move(result).iter()).build());
+  // <run, position in the run>
+  using Cursor = std::pair<size_t, size_t>;
+  auto cmp = [&less](const Cursor &lhs, const Cursor &rhs) {
+    return less(rhs.first, rhs.second, lhs.first, lhs.second);
+  };
+  std::priority_queue<Cursor, std::vector<Cursor>, decltype(cmp)> heap(cmp);
+  for (size_t i = 0; i < runs.size(); ++i) {
+    if (!runs[i].indices.empty()) {
+      heap.emplace(i, 0);
+    }
+  }
+
+  std::vector<Row> sorted;
+  sorted.reserve(size);
+  while (!heap.empty()) {
+    auto cursor = heap.top();
+    heap.pop();
+    auto &run = runs[cursor.first];
+    sorted.emplace_back(std::move(rows[run.indices[cursor.second]]));
+    if (cursor.second + 1 < run.indices.size()) {
+      heap.emplace(cursor.first, cursor.second + 1);
+    }
+  }
+  std::move(sorted.begin(), sorted.end(), rows);
+}
+
+bool SortExecutor::compareRows(const Row &lhs, const Row &rhs) const {
+  for (auto &item : asNode<Sort>(node())->factors()) {
+    auto index = item.first;
+    auto orderType = item.second;
+    if (lhs[index] == rhs[index]) {
+      continue;
+    }
+
+    if (orderType == OrderFactor::OrderType::ASCEND) {
+      return lhs[index] < rhs[index];
+    } else if (orderType == OrderFactor::OrderType::DESCEND) {
+      return lhs[index] > rhs[index];
+    }
+  }
+  return false;
 }
 
 }  // namespace graph
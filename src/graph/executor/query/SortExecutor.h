@@ -5,7 +5,9 @@
 #ifndef GRAPH_EXECUTOR_QUERY_SORTEXECUTOR_H_
 #define GRAPH_EXECUTOR_QUERY_SORTEXECUTOR_H_
 
+#include "common/memory/MemoryTracker.h"
 #include "graph/executor/Executor.h"
+#include "graph/planner/plan/Query.h"
 
 namespace nebula {
 namespace graph {
@@ -14,6 +16,36 @@ class SortExecutor final : public Executor {
   SortExecutor(const PlanNode *node, QueryContext *qctx) : Executor("SortExecutor", node, qctx) {}
 
   folly::Future<Status> execute() override;
+
+  using Factors = std::vector<std::pair<size_t, OrderFactor::OrderType>>;
+
+  // Encode the sort columns of a row into a key, whose bytes are compared in the same order as
+  // the rows compared by values. Only empty, null, bool, int and string are encoded, since the
+  // floats are compared with an epsilon. Return false if the row has other types.
+  static bool encodeSortKey(const Row &row, const Factors &factors, std::string &key);
+
+ private:
+  // The rows of [begin, end) sorted
+  struct SortedRun {
+    size_t begin{0};
+    // The indices of the rows, in the sorted order
+    std::vector<size_t> indices;
+    // The sort keys of the rows indexed by index - begin, empty if sorted by the values
+    std::vector<std::string> keys;
+    std::shared_ptr<MemoryReservation> reservation;
+  };
+
+  // Sort the rows of [begin, end) by their sort keys if they could be encoded within the memory
+  // limit of the query, otherwise by the values.
+  SortedRun sortRun(std::vector<Row>::iterator rows, size_t begin, size_t end) const;
+
+  // Merge the sorted runs, and move the rows into their sorted positions
+  void mergeRuns(std::vector<Row>::iterator rows, std::vector<SortedRun> &runs) const;
+
+  bool compareRows(const Row &lhs, const Row &rhs) const;
+
+  // Sort the chunks of rows by multiple jobs, then merge them with a k-way merge
+  folly::Future<Status> sortMultiJobs(Result &&result);
 };
 
 }  // namespace graph
@@ -11,12 +11,28 @@
 using nebula::storage::StorageClient;
 using nebula::storage::StorageRpcResponse;
 using nebula::storage::cpp2::GetNeighborsResponse;
+using nebula::storage::cpp2::GetPropResponse;
 
 namespace nebula {
 namespace graph {
 
+// The vid in the request of GetNeighbors, in which an INT64 vid is in its binary form
+static Value reqVid(const Value& vid) {
+  if (vid.isInt()) {
+    auto id = vid.getInt();
+    return Value(std::string(reinterpret_cast<const char*>(&id), sizeof(id)));
+  }
+  return vid;
+}
+
 folly::Future<Status> TraverseExecutor::execute() {
   range_ = traverse_->stepRange();
+  auto numParts = qctx()->getMetaClient()->partsNum(traverse_->space());
+  if (!numParts.ok()) {
+    return error(std::move(numParts).status());
+  }
+  numParts_ = numParts.value();
+  pathLimit_ = traverse_->pathLimit();
   auto status = buildRequestDataSet();
   if (!status.ok()) {
     return error(std::move(status));
@@ -26,9 +42,19 @@ folly::Future<Status> TraverseExecutor::execute() {
 
 Status TraverseExecutor::close() {
   // clear the members
-  reqDs_.rows.clear();
-  uniqueDsts_.clear();
-  return Executor::close();
+  reqParts_.clear();
+  nextReqParts_.clear();
+  roots_.clear();
+  rootDsts_.clear();
+  steps_.clear();
+  zeroSteps_ = StepPaths();
+  vidFilter_.reset();
+  vidFilterBuilt_ = false;
+  dstVertices_ = DataSet();
+  fetchedDsts_.clear();
+  dstExists_.clear();
+  droppedPaths_ = 0;
+  return StorageAccessExecutor::close();
 }
 
 Status TraverseExecutor::buildRequestDataSet() {
@@ -39,12 +65,10 @@ Status TraverseExecutor::buildRequestDataSet() {
   auto inputIter = inputResult.iter();
   auto iter = static_cast<SequentialIter*>(inputIter.get());
 
-  reqDs_.colNames = {kVid};
-  reqDs_.rows.reserve(iter->size());
-
-  std::unordered_set<Value> uniqueSet;
-  uniqueSet.reserve(iter->size());
-  std::unordered_map<Value, Paths> prev;
+  roots_.reserve(iter->size());
+  rootDsts_.assign(1, DstPaths());
+  auto& rootDsts = rootDsts_.front();
+  rootDsts.reserve(iter->size());
   const auto& spaceInfo = qctx()->rctx()->session()->space();
   const auto& vidType = *(spaceInfo.spaceDesc.vid_type_ref());
   auto* src = traverse_->src();
@@ -59,27 +83,67 @@ Status TraverseExecutor::buildRequestDataSet() {
       continue;
     }
     // Need copy here, Argument executor may depends on this variable.
-    auto prePath = mv ? iter->moveRow() : *iter->row();
-    buildPath(prev, vid, std::move(prePath));
-    if (!uniqueSet.emplace(vid).second) {
-      continue;
+    auto& paths = rootDsts[vid];
+    paths.emplace_back(roots_.size());
+    roots_.emplace_back(mv ? iter->moveRow() : *iter->row());
+    if (paths.size() == 1) {
+      addRequestVid(vid, partOf(vid));
     }
-    reqDs_.emplace_back(Row({std::move(vid)}));
   }
-  paths_.emplace_back(std::move(prev));
   return Status::OK();
 }
 
 folly::Future<Status> TraverseExecutor::traverse() {
-  if (reqDs_.rows.empty()) {
+  if (!hasNextRequest() || pathLimit_ == 0) {
     DataSet emptyResult;
     return finish(ResultBuilder().value(Value(std::move(emptyResult))).build());
   }
+  return expandStep();
+}
+
+folly::Future<Status> TraverseExecutor::expandStep() {
+  currentStep_++;
+  stepRequests_ = 0;
+  reqParts_ = std::move(nextReqParts_);
+  nextReqParts_.clear();
+  steps_.emplace_back();
   return getNeighbors();
 }
 
+std::unordered_map<PartitionID, std::vector<Row>> TraverseExecutor::takeRequestBatch() {
+  std::unordered_map<PartitionID, std::vector<Row>> batch;
+  if (!limitedStep()) {
+    batch.swap(reqParts_);
+    return batch;
+  }
+  // Each vid is expected to extend a path at least, and the batches grow exponentially in case
+  // they extend fewer, so that a step takes a few requests at most
+  auto shift = std::min<size_t>(stepRequests_, 16);
+  size_t remaining = pathLimit_ - resultPathCount();
+  size_t batchSize = remaining > (std::numeric_limits<size_t>::max() >> shift)
+                         ? std::numeric_limits<size_t>::max()
+                         : remaining << shift;
+  size_t taken = 0;
+  for (auto it = reqParts_.begin(); it != reqParts_.end() && taken < batchSize;) {
+    auto& rows = it->second;
+    auto n = std::min(rows.size(), batchSize - taken);
+    taken += n;
+    if (n == rows.size()) {
+      batch.emplace(it->first, std::move(rows));
+      it = reqParts_.erase(it);
+    } else {
+      auto& partRows = batch[it->first];
+      partRows.insert(partRows.end(),
+                      std::make_move_iterator(rows.end() - n),
+                      std::make_move_iterator(rows.end()));
+      rows.resize(rows.size() - n);
+      ++it;
+    }
+  }
+  return batch;
+}
+
 folly::Future<Status> TraverseExecutor::getNeighbors() {
-  currentStep_++;
   time::Duration getNbrTime;
   StorageClient* storageClient = qctx_->getStorageClient();
   bool finalStep = isFinalStep();
@@ -87,10 +151,29 @@ folly::Future<Status> TraverseExecutor::getNeighbors() {
                                           qctx()->rctx()->session()->id(),
                                           qctx()->plan()->id(),
                                           qctx()->plan()->isProfileEnabled());
+  setReadDeadline(param);
+  param.maxStalenessMs = maxReadStalenessMs();
+  param.analytical = readFromAnalyticsReplicas();
+  if (finalStep) {
+    // The dsts of the final step are only read if they could be joined
+    if (!vidFilterBuilt_) {
+      vidFilter_ = buildVidFilter(traverse_);
+      vidFilterBuilt_ = true;
+    }
+    param.vidFilter = vidFilter_;
+    param.dstVertexProps = traverse_->dstVertexProps();
+  }
+  auto reqParts = takeRequestBatch();
+  stepRequests_++;
+  bool streamed = streamResponses();
+  storage::ResponseHandler<GetNeighborsResponse> onResponse;
+  if (streamed) {
+    onResponse = [this](GetNeighborsResponse& resp) { addChunk(resp); };
+  }
   return storageClient
       ->getNeighbors(param,
-                     reqDs_.colNames,
-                     std::move(reqDs_.rows),
+                     {kVid},
+                     std::move(reqParts),
                      traverse_->edgeTypes(),
                      traverse_->edgeDirection(),
                      finalStep ? traverse_->statProps() : nullptr,
@@ -101,15 +184,79 @@ folly::Future<Status> TraverseExecutor::getNeighbors() {
                      finalStep ? traverse_->random() : false,
                      finalStep ? traverse_->orderBy() : std::vector<storage::cpp2::OrderBy>(),
                      finalStep ? traverse_->limit(qctx()) : -1,
-                     selectFilter())
+                     selectFilter(),
+                     false,
+                     -1,
+                     std::move(onResponse))
       .via(runner())
-      .thenValue([this, getNbrTime](StorageRpcResponse<GetNeighborsResponse>&& resp) mutable {
+      .thenValue([this, getNbrTime, streamed](
+                     StorageRpcResponse<GetNeighborsResponse>&& resp) mutable {
         SCOPED_TIMER(&execTime_);
         addStats(resp, getNbrTime.elapsedInUSec());
-        return handleResponse(std::move(resp));
+        if (!streamed) {
+          return handleResponse(std::move(resp), false);
+        }
+        // Every response has been added as a chunk by now, wait for the last of them
+        return takeChunks().via(runner()).thenValue(
+            [this, resp = std::move(resp)](Status status) mutable -> folly::Future<Status> {
+              execTime_ += chunkTime_;
+              chunkTime_ = 0;
+              if (!status.ok()) {
+                return folly::makeFuture<Status>(std::move(status));
+              }
+              return handleResponse(std::move(resp), true);
+            });
       });
 }
 
+bool TraverseExecutor::streamResponses() const {
+  if (limitedStep() || (currentStep_ == 1 && zeroStep())) {
+    return false;
+  }
+  return FLAGS_max_job_size <= 1 || FLAGS_storage_client_get_neighbors_batch_size > 0;
+}
+
+void TraverseExecutor::addChunk(GetNeighborsResponse& resp) {
+  if (!resp.vertices_ref().has_value()) {
+    return;
+  }
+  // Called on the io threads, the paths are built on the runner
+  chunkRows_ += resp.vertices_ref()->size();
+  List list;
+  list.values.emplace_back(std::move(*resp.vertices_ref()));
+  std::optional<DataSet> dstVertices;
+  std::vector<Value> fetched;
+  if (resp.dst_vertices_ref().has_value() && resp.fetched_dsts_ref().has_value()) {
+    dstVertices = std::move(*resp.dst_vertices_ref());
+    fetched = std::move(*resp.fetched_dsts_ref());
+  }
+  std::lock_guard<std::mutex> guard(chunkLock_);
+  chunks_ = std::move(chunks_).via(runner()).thenValue(
+      [this,
+       list = std::move(list),
+       dstVertices = std::move(dstVertices),
+       fetched = std::move(fetched)](Status status) mutable {
+        if (!status.ok()) {
+          return status;
+        }
+        SCOPED_TIMER(&chunkTime_);
+        if (dstVertices.has_value() && dstVertices_.append(std::move(*dstVertices))) {
+          fetchedDsts_.insert(fetchedDsts_.end(),
+                              std::make_move_iterator(fetched.begin()),
+                              std::make_move_iterator(fetched.end()));
+        }
+        GetNeighborsIter iter(std::make_shared<Value>(std::move(list)));
+        return buildInterimPath(&iter);
+      });
+}
+
+folly::Future<Status> TraverseExecutor::takeChunks() {
+  std::lock_guard<std::mutex> guard(chunkLock_);
+  auto chunks = std::move(chunks_);
+  chunks_ = folly::makeFuture<Status>(Status::OK());
+  return chunks;
+}
+
 Expression* TraverseExecutor::selectFilter() {
   Expression* filter = nullptr;
   if (!(currentStep_ == 1 && zeroStep())) {
@@ -143,95 +290,188 @@ void TraverseExecutor::addStats(RpcResponse& resp, int64_t getNbrTimeInUSec) {
     if (!detail.empty()) {
       ss << folly::sformat("storage_detail: {}", detail);
     }
+    auto nodes = getStorageNodes(result.result.node_profiles_ref());
+    if (!nodes.empty()) {
+      ss << "\n" << folly::sformat("storage_nodes: {}", nodes);
+    }
     ss << "\n}";
   }
+  // The vertices of the responses handled as chunks have been taken out of them
+  auto chunkRows = chunkRows_.exchange(0);
+  if (chunkRows > 0) {
+    ss << "\n" << folly::sformat("chunk vertices: {}", chunkRows);
+  }
   ss << "\n}";
-  otherStats_.emplace(folly::sformat("step {}", currentStep_), ss.str());
+  auto key = stepRequests_ == 1 ? folly::sformat("step {}", currentStep_)
+                                : folly::sformat("step {} batch {}", currentStep_, stepRequests_);
+  otherStats_.emplace(std::move(key), ss.str());
 }
 
-folly::Future<Status> TraverseExecutor::handleResponse(RpcResponse&& resps) {
+folly::Future<Status> TraverseExecutor::handleResponse(RpcResponse&& resps, bool streamed) {
   auto result = handleCompleteness(resps, FLAGS_accept_partial_success);
   if (!result.ok()) {
     return folly::makeFuture<Status>(std::move(result).status());
   }
 
+  auto next = [this](Status status) -> folly::Future<Status> {
+    if (!status.ok()) {
+      return folly::makeFuture<Status>(std::move(status));
+    }
+    if (pathLimitReached()) {
+      return checkLimitDsts();
+    }
+    return continueTraverse();
+  };
+  if (streamed) {
+    return next(Status::OK());
+  }
+
   auto& responses = resps.responses();
   List list;
+  list.values.reserve(responses.size());
   for (auto& resp : responses) {
-    auto dataset = resp.get_vertices();
-    if (dataset == nullptr) {
+    // The dsts read by storage along with the edges of the final step
+    if (resp.dst_vertices_ref().has_value() && resp.fetched_dsts_ref().has_value() &&
+        dstVertices_.append(std::move(*resp.dst_vertices_ref()))) {
+      auto& fetched = *resp.fetched_dsts_ref();
+      fetchedDsts_.insert(fetchedDsts_.end(),
+                          std::make_move_iterator(fetched.begin()),
+                          std::make_move_iterator(fetched.end()));
+    }
+    auto dataset = resp.vertices_ref();
+    if (!dataset.has_value()) {
       continue;
     }
     list.values.emplace_back(std::move(*dataset));
   }
-  auto listVal = std::make_shared<Value>(std::move(list));
 
-  if (FLAGS_max_job_size <= 1) {
-    auto iter = std::make_unique<GetNeighborsIter>(listVal);
-    auto status = buildInterimPath(iter.get());
-    if (!status.ok()) {
-      return folly::makeFuture<Status>(std::move(status));
-    }
-    if (!isFinalStep()) {
-      if (reqDs_.rows.empty()) {
-        if (range_ != nullptr) {
-          return folly::makeFuture<Status>(buildResult());
-        } else {
-          return folly::makeFuture<Status>(Status::OK());
-        }
+  // The batches of a limited step are small, and are appended to the step one by one
+  if (FLAGS_max_job_size <= 1 || limitedStep()) {
+    GetNeighborsIter iter(std::make_shared<Value>(std::move(list)));
+    return next(buildInterimPath(&iter));
+  } else {
+    return buildInterimPathMultiJobs(std::move(list)).via(runner()).thenValue(std::move(next));
+  }
+}
+
+folly::Future<Status> TraverseExecutor::continueTraverse() {
+  // Expand the rest of the vids of the step
+  if (!reqParts_.empty()) {
+    return getNeighbors();
+  }
+  // The paths to the dsts of the previous step are never extended again
+  prevDsts().clear();
+  if (!isFinalStep()) {
+    if (!hasNextRequest()) {
+      if (range_ != nullptr) {
+        return folly::makeFuture<Status>(buildResult());
       } else {
-        return getNeighbors();
+        return folly::makeFuture<Status>(Status::OK());
       }
     } else {
-      return folly::makeFuture<Status>(buildResult());
+      return expandStep();
     }
   } else {
-    return std::move(buildInterimPathMultiJobs(std::make_unique<GetNeighborsIter>(listVal)))
-        .via(runner())
-        .thenValue([this](auto&& status) {
-          if (!status.ok()) {
-            return folly::makeFuture<Status>(std::move(status));
+    return folly::makeFuture<Status>(buildResult());
+  }
+}
+
+folly::Future<Status> TraverseExecutor::checkLimitDsts() {
+  const auto* props = traverse_->limitDstProps();
+  if (props == nullptr) {
+    return folly::makeFuture<Status>(buildResult());
+  }
+  DataSet vids({kVid});
+  if (minStep() == 0) {
+    for (size_t i = 0; i < zeroSteps_.nodes.size(); ++i) {
+      const auto& dst = pathDst(0, i);
+      if (dstExists_.emplace(dst, false).second) {
+        vids.rows.emplace_back(Row({dst}));
+      }
+    }
+  }
+  for (size_t step = std::max<size_t>(minStep(), 1); step <= steps_.size(); ++step) {
+    for (size_t i = 0; i < steps_[step - 1].nodes.size(); ++i) {
+      const auto& dst = pathDst(step, i);
+      if (dstExists_.emplace(dst, false).second) {
+        vids.rows.emplace_back(Row({dst}));
+      }
+    }
+  }
+  if (vids.rows.empty()) {
+    return handleLimitDsts();
+  }
+
+  time::Duration getPropsTime;
+  StorageClient::CommonRequestParam param(traverse_->space(),
+                                          qctx()->rctx()->session()->id(),
+                                          qctx()->plan()->id(),
+                                          qctx()->plan()->isProfileEnabled());
+  setReadDeadline(param);
+  param.maxStalenessMs = maxReadStalenessMs();
+  param.analytical = readFromAnalyticsReplicas();
+  auto numVids = vids.rows.size();
+  return qctx_->getStorageClient()
+      ->getProps(param, std::move(vids), props, nullptr, nullptr)
+      .via(runner())
+      .thenValue([this, getPropsTime, numVids](StorageRpcResponse<GetPropResponse>&& resps) {
+        SCOPED_TIMER(&execTime_);
+        otherStats_.emplace(folly::sformat("limit dsts of step {}", currentStep_),
+                            folly::sformat("{} vids in {}(us)",
+                                           numVids,
+                                           getPropsTime.elapsedInUSec()));
+        auto result = handleCompleteness(resps, FLAGS_accept_partial_success);
+        if (!result.ok()) {
+          return folly::makeFuture<Status>(std::move(result).status());
+        }
+        for (auto& resp : resps.responses()) {
+          if (!resp.props_ref().has_value()) {
+            continue;
           }
-          if (!isFinalStep()) {
-            if (reqDs_.rows.empty()) {
-              if (range_ != nullptr) {
-                return folly::makeFuture<Status>(buildResult());
-              } else {
-                return folly::makeFuture<Status>(Status::OK());
-              }
-            } else {
-              return getNeighbors();
-            }
-          } else {
-            return folly::makeFuture<Status>(buildResult());
+          PropIter iter(std::make_shared<Value>(std::move(*resp.props_ref())));
+          for (; iter.valid(); iter.next()) {
+            dstExists_[iter.getColumn(kVid)] = true;
           }
-        });
+        }
+        return handleLimitDsts();
+      });
+}
+
+folly::Future<Status> TraverseExecutor::handleLimitDsts() {
+  droppedPaths_ = 0;
+  if (minStep() == 0) {
+    for (size_t i = 0; i < zeroSteps_.nodes.size(); ++i) {
+      droppedPaths_ += dstDropped(0, i);
+    }
+  }
+  for (size_t step = std::max<size_t>(minStep(), 1); step <= steps_.size(); ++step) {
+    for (size_t i = 0; i < steps_[step - 1].nodes.size(); ++i) {
+      droppedPaths_ += dstDropped(step, i);
+    }
+  }
+  if (pathLimitReached()) {
+    return folly::makeFuture<Status>(buildResult());
   }
+  return continueTraverse();
 }
 
 Status TraverseExecutor::buildInterimPath(GetNeighborsIter* iter) {
   const auto& spaceInfo = qctx()->rctx()->session()->space();
-  DataSet reqDs;
-  reqDs.colNames = reqDs_.colNames;
-  size_t count = 0;
 
-  const std::unordered_map<Value, Paths>& prev = paths_.back();
   if (currentStep_ == 1 && zeroStep()) {
-    paths_.emplace_back();
-    NG_RETURN_IF_ERROR(handleZeroStep(prev, iter->getVertices(), paths_.back(), count));
-    // If 0..0 case, release memory and return immediately.
+    NG_RETURN_IF_ERROR(handleZeroStep(iter->getVertices()));
+    // If 0..0 case, return immediately.
     if (range_ != nullptr && range_->max() == 0) {
-      releasePrevPaths(count);
       return Status::OK();
     }
   }
-  paths_.emplace_back();
-  std::unordered_map<Value, Paths>& current = paths_.back();
+  const auto& prev = prevDsts();
+  auto& current = steps_.back();
+  bool finalStep = isFinalStep();
 
   auto* vFilter = traverse_->vFilter();
   auto* eFilter = traverse_->eFilter();
   QueryExpressionContext ctx(ectx_);
-  std::unordered_set<Value> uniqueDst;
 
   for (; iter->valid(); iter->next()) {
     auto& dst = iter->getEdgeProp("*", kDst);
@@ -253,115 +493,115 @@ Status TraverseExecutor::buildInterimPath(GetNeighborsIter* iter) {
     auto srcV = iter->getVertex();
     auto e = iter->getEdge();
     // Join on dst = src
-    auto pathToSrcFound = prev.find(srcV.getVertex().vid);
-    if (pathToSrcFound == prev.end()) {
+    const auto* pathsToSrc = findPrevPaths(prev, srcV.getVertex().vid);
+    if (pathsToSrc == nullptr) {
       return Status::Error("Can't find prev paths.");
     }
-    const auto& paths = pathToSrcFound->second;
-    for (auto& prevPath : paths) {
-      if (hasSameEdge(prevPath, e.getEdge())) {
+    for (auto parent : *pathsToSrc) {
+      if (hasSameEdge(currentStep_ - 1, parent, e.getEdge())) {
         continue;
       }
-      if (uniqueDst.emplace(dst).second) {
-        reqDs.rows.emplace_back(Row({std::move(dst)}));
-      }
-      if (currentStep_ == 1) {
-        Row path;
-        if (traverse_->trackPrevPath()) {
-          path = prevPath;
+      // The paths of the final step are never extended
+      if (!finalStep) {
+        auto& paths = current.dsts.front()[dst];
+        if (paths.empty()) {
+          addRequestVid(dst, partOf(dst));
         }
-        path.values.emplace_back(srcV);
-        List neighbors;
-        neighbors.values.emplace_back(e);
-        path.values.emplace_back(std::move(neighbors));
-        buildPath(current, dst, std::move(path));
-        ++count;
-      } else {
-        auto path = prevPath;
-        auto& eList = path.values.back().mutableList().values;
-        eList.emplace_back(srcV);
-        eList.emplace_back(e);
-        buildPath(current, dst, std::move(path));
-        ++count;
+        paths.emplace_back(current.nodes.size());
       }
-    }  // `prevPath'
+      current.nodes.emplace_back(PathNode{parent, srcV, e});
+    }  // `parent'
   }    // `iter'
-
-  releasePrevPaths(count);
-  reqDs_ = std::move(reqDs);
   return Status::OK();
 }
 
-folly::Future<Status> TraverseExecutor::buildInterimPathMultiJobs(
-    std::unique_ptr<GetNeighborsIter> iter) {
-  size_t pathCnt = 0;
-  const std::unordered_map<Value, Paths>* prev = &paths_.back();
+folly::Future<Status> TraverseExecutor::buildInterimPathMultiJobs(List&& list) {
+  auto listVal = std::make_shared<Value>(std::move(list));
   if (currentStep_ == 1 && zeroStep()) {
-    paths_.emplace_back();
-    NG_RETURN_IF_ERROR(handleZeroStep(*prev, iter->getVertices(), paths_.back(), pathCnt));
-    // If 0..0 case, release memory and return immediately.
+    GetNeighborsIter iter(listVal);
+    NG_RETURN_IF_ERROR(handleZeroStep(iter.getVertices()));
+    // If 0..0 case, return immediately.
     if (range_ != nullptr && range_->max() == 0) {
-      releasePrevPaths(pathCnt);
       return Status::OK();
     }
   }
-  paths_.emplace_back();
-
-  auto scatter = [this, prev](
-                     size_t begin, size_t end, Iterator* tmpIter) mutable -> StatusOr<JobResult> {
-    return handleJob(begin, end, tmpIter, *prev);
-  };
-
-  auto gather = [this, pathCnt](std::vector<StatusOr<JobResult>> results) mutable -> Status {
-    reqDs_.clear();
-    uniqueDsts_.clear();
-    std::unordered_map<Value, Paths>& current = paths_.back();
-    size_t mapCnt = 0;
-    for (auto& r : results) {
-      if (!r.ok()) {
-        return r.status();
-      } else {
-        mapCnt += r.value().newPaths.size();
+  auto& datasets = listVal->mutableList();
+
+  // Split the responses into the jobs by the number of the edges, each of which parses its own
+  // rows, so that neither the responses are parsed by one job nor the jobs skip the rows of others
+  size_t numEdges = 0;
+  auto rowEdges = [](const Row& row) {
+    size_t n = 1;
+    for (const auto& v : row.values) {
+      if (v.isList()) {
+        n += v.getList().size();
       }
     }
-    current.reserve(mapCnt);
-    for (auto& r : results) {
-      auto jobResult = std::move(r).value();
-      pathCnt += jobResult.pathCnt;
-      if (!jobResult.reqDs.rows.empty()) {
-        reqDs_.rows.insert(reqDs_.rows.end(),
-                           std::make_move_iterator(jobResult.reqDs.rows.begin()),
-                           std::make_move_iterator(jobResult.reqDs.rows.end()));
-      }
-      for (auto& kv : jobResult.newPaths) {
-        auto& paths = current[kv.first];
-        paths.insert(paths.end(),
-                     std::make_move_iterator(kv.second.begin()),
-                     std::make_move_iterator(kv.second.end()));
+    return n;
+  };
+  for (const auto& ds : datasets.values) {
+    for (const auto& row : ds.getDataSet().rows) {
+      numEdges += rowEdges(row);
+    }
+  }
+  auto batchSize = getBatchSize(numEdges);
+  std::vector<std::shared_ptr<Value>> batches;
+  auto addBatch = [&batches](DataSet&& batch) {
+    List batchList;
+    batchList.values.emplace_back(std::move(batch));
+    batches.emplace_back(std::make_shared<Value>(std::move(batchList)));
+  };
+  for (auto& ds : datasets.values) {
+    auto& rows = ds.mutableDataSet().rows;
+    DataSet batch(ds.getDataSet().colNames);
+    size_t batchEdges = 0;
+    for (auto& row : rows) {
+      batchEdges += rowEdges(row);
+      batch.rows.emplace_back(std::move(row));
+      if (batchEdges >= batchSize) {
+        addBatch(std::move(batch));
+        batch = DataSet(ds.getDataSet().colNames);
+        batchEdges = 0;
       }
     }
-    releasePrevPaths(pathCnt);
+    if (!batch.rows.empty()) {
+      addBatch(std::move(batch));
+    }
+  }
+  if (batches.empty()) {
     return Status::OK();
-  };
+  }
 
-  return runMultiJobs(std::move(scatter), std::move(gather), iter.get());
+  // The dsts are sharded by their parts, so the dsts of a part are always merged by one job
+  size_t numShards = std::min<size_t>(FLAGS_max_job_size, numParts_);
+  const auto* prev = &prevDsts();
+  std::vector<folly::Future<StatusOr<JobResult>>> futures;
+  futures.reserve(batches.size());
+  for (auto& batch : batches) {
+    futures.emplace_back(folly::via(
+        runner(), [this, prev, numShards, batch = std::move(batch)]() -> StatusOr<JobResult> {
+          GetNeighborsIter iter(batch);
+          return handleJob(&iter, *prev, numShards);
+        }));
+  }
+  return folly::collect(futures).via(runner()).thenValue(
+      [this, numShards](std::vector<StatusOr<JobResult>>&& results) {
+        return mergeJobResults(std::move(results), numShards);
+      });
 }
 
-StatusOr<JobResult> TraverseExecutor::handleJob(size_t begin,
-                                                size_t end,
-                                                Iterator* iter,
-                                                const std::unordered_map<Value, Paths>& prev) {
-  // Handle edges from begin to end, [begin, end)
+StatusOr<JobResult> TraverseExecutor::handleJob(Iterator* iter,
+                                                const std::vector<DstPaths>& prev,
+                                                size_t numShards) {
   JobResult jobResult;
-  size_t& pathCnt = jobResult.pathCnt;
-  DataSet& reqDs = jobResult.reqDs;
-  reqDs.colNames = reqDs_.colNames;
+  jobResult.shards.resize(numShards);
   QueryExpressionContext ctx(ectx_);
   auto* vFilter = traverse_->vFilter() ? traverse_->vFilter()->clone() : nullptr;
   auto* eFilter = traverse_->eFilter() ? traverse_->eFilter()->clone() : nullptr;
   const auto& spaceInfo = qctx()->rctx()->session()->space();
-  std::unordered_map<Value, Paths>& current = jobResult.newPaths;
-  for (; iter->valid() && begin++ < end; iter->next()) {
+  auto& nodes = jobResult.nodes;
+  bool finalStep = isFinalStep();
+  for (; iter->valid(); iter->next()) {
     auto& dst = iter->getEdgeProp("*", kDst);
     if (!SchemaUtil::isValidVid(dst, *(spaceInfo.spaceDesc.vid_type_ref()))) {
       continue;
@@ -381,54 +621,111 @@ StatusOr<JobResult> TraverseExecutor::handleJob(size_t begin,
     auto srcV = iter->getVertex();
     auto e = iter->getEdge();
     // Join on dst = src
-    auto pathToSrcFound = prev.find(srcV.getVertex().vid);
-    if (pathToSrcFound == prev.end()) {
+    const auto* pathsToSrc = findPrevPaths(prev, srcV.getVertex().vid);
+    if (pathsToSrc == nullptr) {
       return Status::Error("Can't find prev paths.");
     }
-    const auto& paths = pathToSrcFound->second;
-    for (auto& prevPath : paths) {
-      if (hasSameEdge(prevPath, e.getEdge())) {
+    std::optional<PartitionID> part;
+    for (auto parent : *pathsToSrc) {
+      if (hasSameEdge(currentStep_ - 1, parent, e.getEdge())) {
         continue;
       }
-      if (uniqueDsts_.emplace(dst, 0).second) {
-        reqDs.rows.emplace_back(Row({std::move(dst)}));
-      }
-      if (currentStep_ == 1) {
-        Row path;
-        if (traverse_->trackPrevPath()) {
-          path = prevPath;
+      // The paths of the final step are never extended
+      if (!finalStep) {
+        if (!part.has_value()) {
+          part = partOf(dst);
         }
-        path.values.emplace_back(srcV);
-        List neighbors;
-        neighbors.values.emplace_back(e);
-        path.values.emplace_back(std::move(neighbors));
-        buildPath(current, dst, std::move(path));
-        ++pathCnt;
-      } else {
-        auto path = prevPath;
-        auto& eList = path.values.back().mutableList().values;
-        eList.emplace_back(srcV);
-        eList.emplace_back(e);
-        buildPath(current, dst, std::move(path));
-        ++pathCnt;
+        jobResult.shards[*part % numShards].emplace_back(DstNode{*part, dst, nodes.size()});
       }
-    }  // `prevPath'
+      nodes.emplace_back(PathNode{parent, srcV, e});
+    }  // `parent'
   }    // `iter'
   return jobResult;
 }
 
-void TraverseExecutor::buildPath(std::unordered_map<Dst, std::vector<Row>>& currentPaths,
-                                 const Value& dst,
-                                 Row&& path) {
-  auto pathToDstFound = currentPaths.find(dst);
-  if (pathToDstFound == currentPaths.end()) {
-    Paths interimPaths;
-    interimPaths.emplace_back(std::move(path));
-    currentPaths.emplace(dst, std::move(interimPaths));
-  } else {
-    auto& interimPaths = pathToDstFound->second;
-    interimPaths.emplace_back(std::move(path));
+folly::Future<Status> TraverseExecutor::mergeJobResults(
+    std::vector<StatusOr<JobResult>>&& results, size_t numShards) {
+  struct MergeState {
+    std::vector<JobResult> jobs;
+    // The offsets of the nodes of the jobs in the step
+    std::vector<size_t> offsets;
+    StepPaths current;
+    // The request of the next step of each shard
+    std::vector<std::unordered_map<PartitionID, std::vector<Row>>> reqs;
+  };
+  auto state = std::make_shared<MergeState>();
+  state->jobs.reserve(results.size());
+  state->offsets.reserve(results.size());
+  size_t nodeCnt = 0;
+  for (auto& r : results) {
+    if (!r.ok()) {
+      return r.status();
+    }
+    state->offsets.emplace_back(nodeCnt);
+    nodeCnt += r.value().nodes.size();
+    state->jobs.emplace_back(std::move(r).value());
+  }
+  state->current.nodes.resize(nodeCnt);
+  state->current.dsts.resize(numShards);
+  state->reqs.resize(numShards);
+
+  // Each shard job merges the dsts of its shard, and moves the nodes of some of the jobs to the
+  // step at their offsets
+  std::vector<folly::Future<folly::Unit>> futures;
+  futures.reserve(numShards);
+  for (size_t shard = 0; shard < numShards; ++shard) {
+    futures.emplace_back(folly::via(runner(), [shard, numShards, state]() {
+      auto& dsts = state->current.dsts[shard];
+      auto& reqParts = state->reqs[shard];
+      for (size_t job = 0; job < state->jobs.size(); ++job) {
+        auto& jobResult = state->jobs[job];
+        for (auto& dstNode : jobResult.shards[shard]) {
+          auto& paths = dsts[dstNode.dst];
+          if (paths.empty()) {
+            reqParts[dstNode.part].emplace_back(Row({reqVid(dstNode.dst)}));
+          }
+          paths.emplace_back(state->offsets[job] + dstNode.node);
+        }
+        if (job % numShards == shard) {
+          std::move(jobResult.nodes.begin(),
+                    jobResult.nodes.end(),
+                    state->current.nodes.begin() + state->offsets[job]);
+        }
+      }
+    }));
+  }
+  return folly::collect(futures).via(runner()).thenValue([this, state](auto&&) {
+    // The parts of the shards are disjoint
+    for (auto& reqParts : state->reqs) {
+      for (auto& part : reqParts) {
+        nextReqParts_.emplace(part.first, std::move(part.second));
+      }
+    }
+    steps_.back() = std::move(state->current);
+    return Status::OK();
+  });
+}
+
+const std::vector<size_t>* TraverseExecutor::findPrevPaths(const std::vector<DstPaths>& prev,
+                                                           const Value& src) const {
+  const auto& dsts = prev.size() == 1 ? prev.front() : prev[partOf(src) % prev.size()];
+  auto found = dsts.find(src);
+  return found == dsts.end() ? nullptr : &found->second;
+}
+
+PartitionID TraverseExecutor::partOf(const Value& vid) const {
+  // The same as the part computed by the storage client, by the binary form of an INT64 vid
+  auto* metaClient = qctx()->getMetaClient();
+  if (vid.isInt()) {
+    auto id = vid.getInt();
+    return metaClient->partId(numParts_,
+                              std::string(reinterpret_cast<const char*>(&id), sizeof(id)));
   }
+  return metaClient->partId(numParts_, vid.getStr());
+}
+
+void TraverseExecutor::addRequestVid(const Value& vid, PartitionID part) {
+  nextReqParts_[part].emplace_back(Row({reqVid(vid)}));
 }
 
 Status TraverseExecutor::buildResult() {
@@ -437,19 +734,117 @@ Status TraverseExecutor::buildResult() {
     return finish(ResultBuilder().value(Value(DataSet())).build());
   }
 
+  // Only the paths in the step range are materialized, and no more than the limit
+  size_t pathCnt = resultPathCount();
+  if (pathLimit_ >= 0) {
+    pathCnt = std::min<size_t>(pathCnt, pathLimit_);
+  }
+
   DataSet result;
   result.colNames = traverse_->colNames();
-  result.rows.reserve(totalPathCnt_);
-  for (auto& currentStepPaths : paths_) {
-    for (auto& paths : currentStepPaths) {
-      std::move(paths.second.begin(), paths.second.end(), std::back_inserter(result.rows));
+  result.rows.reserve(pathCnt);
+  // The paths whose dsts are known to be missing are dropped by AppendVertices anyway
+  bool checked = !dstExists_.empty();
+  if (minStep() == 0) {
+    for (size_t i = 0; i < zeroSteps_.nodes.size() && result.rows.size() < pathCnt; ++i) {
+      if (checked && dstDropped(0, i)) {
+        continue;
+      }
+      result.rows.emplace_back(buildPathRow(0, i));
+    }
+  }
+  for (size_t step = std::max<size_t>(minStep(), 1); step <= steps_.size(); ++step) {
+    const auto& nodes = steps_[step - 1].nodes;
+    for (size_t i = 0; i < nodes.size() && result.rows.size() < pathCnt; ++i) {
+      if (checked && dstDropped(step, i)) {
+        continue;
+      }
+      result.rows.emplace_back(buildPathRow(step, i));
     }
   }
 
+  if (!traverse_->dstVerticesVar().empty() && !fetchedDsts_.empty()) {
+    List prefetched;
+    prefetched.values.emplace_back(std::move(dstVertices_));
+    prefetched.values.emplace_back(List(std::move(fetchedDsts_)));
+    ectx_->setResult(traverse_->dstVerticesVar(),
+                     ResultBuilder().value(Value(std::move(prefetched))).build());
+  }
   return finish(ResultBuilder().value(Value(std::move(result))).build());
 }
 
-bool TraverseExecutor::hasSameEdge(const Row& prevPath, const Edge& currentEdge) {
+size_t TraverseExecutor::resultPathCount() const {
+  size_t cnt = minStep() == 0 ? zeroSteps_.nodes.size() : 0;
+  for (size_t step = std::max<size_t>(minStep(), 1); step <= steps_.size(); ++step) {
+    cnt += steps_[step - 1].nodes.size();
+  }
+  return cnt - droppedPaths_;
+}
+
+const Value& TraverseExecutor::pathDst(size_t step, size_t index) const {
+  if (step == 0) {
+    return zeroSteps_.nodes[index].vertex.getVertex().vid;
+  }
+  return steps_[step - 1].nodes[index].edge.getEdge().dst;
+}
+
+bool TraverseExecutor::dstDropped(size_t step, size_t index) const {
+  auto found = dstExists_.find(pathDst(step, index));
+  return found != dstExists_.end() && !found->second;
+}
+
+Row TraverseExecutor::buildPathRow(size_t step, size_t index) const {
+  if (step == 0) {
+    const auto& node = zeroSteps_.nodes[index];
+    Row path;
+    if (traverse_->trackPrevPath()) {
+      path = roots_[node.parent];
+    }
+    path.values.emplace_back(node.vertex);
+    path.values.emplace_back(List({node.vertex}));
+    return path;
+  }
+  std::vector<const PathNode*> nodes;
+  nodes.reserve(step);
+  for (; step > 0; --step) {
+    const auto& node = steps_[step - 1].nodes[index];
+    nodes.emplace_back(&node);
+    index = node.parent;
+  }
+  Row path;
+  if (traverse_->trackPrevPath()) {
+    path = roots_[index];
+  }
+  // [src, [edge, vertex, edge, ..., edge]]
+  path.values.emplace_back(nodes.back()->vertex);
+  List steps;
+  steps.values.reserve(nodes.size() * 2 - 1);
+  for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+    if (it != nodes.rbegin()) {
+      steps.values.emplace_back((*it)->vertex);
+    }
+    steps.values.emplace_back((*it)->edge);
+  }
+  path.values.emplace_back(std::move(steps));
+  return path;
+}
+
+bool TraverseExecutor::hasSameEdge(size_t step, size_t index, const Edge& currentEdge) const {
+  for (; step > 0; --step) {
+    const auto& node = steps_[step - 1].nodes[index];
+    if (node.edge.getEdge().keyEqual(currentEdge)) {
+      return true;
+    }
+    index = node.parent;
+  }
+  // The edges of the previous path are only kept in the paths if tracked
+  if (currentStep_ == 1 || traverse_->trackPrevPath()) {
+    return hasSameEdge(roots_[index], currentEdge);
+  }
+  return false;
+}
+
+bool TraverseExecutor::hasSameEdge(const Row& prevPath, const Edge& currentEdge) const {
   for (const auto& v : prevPath.values) {
     if (v.isList()) {
       for (const auto& e : v.getList().values) {
@@ -462,52 +857,20 @@ bool TraverseExecutor::hasSameEdge(const Row& prevPath, const Edge& currentEdge)
   return false;
 }
 
-void TraverseExecutor::releasePrevPaths(size_t cnt) {
-  time::Duration dur;
-  if (range_ != nullptr) {
-    if (currentStep_ == range_->min() && paths_.size() > 1) {
-      auto rangeEnd = paths_.begin();
-      std::advance(rangeEnd, paths_.size() - 1);
-      paths_.erase(paths_.begin(), rangeEnd);
-    } else if (range_->min() == 0 && currentStep_ == 1 && paths_.size() > 1) {
-      paths_.pop_front();
-    }
-
-    if (currentStep_ >= range_->min()) {
-      totalPathCnt_ += cnt;
-    }
-  } else {
-    paths_.pop_front();
-    totalPathCnt_ = cnt;
-  }
-}
-
-Status TraverseExecutor::handleZeroStep(const std::unordered_map<Value, Paths>& prev,
-                                        List&& vertices,
-                                        std::unordered_map<Value, Paths>& zeroSteps,
-                                        size_t& count) {
-  std::unordered_set<Value> uniqueSrc;
+Status TraverseExecutor::handleZeroStep(List&& vertices) {
+  VidSet uniqueSrc;
+  uniqueSrc.reserve(vertices.size());
   for (auto& srcV : vertices.values) {
     auto src = srcV.getVertex().vid;
     if (!uniqueSrc.emplace(src).second) {
       continue;
     }
-    auto pathToSrcFound = prev.find(src);
-    if (pathToSrcFound == prev.end()) {
+    const auto* pathsToSrc = findPrevPaths(rootDsts_, src);
+    if (pathsToSrc == nullptr) {
       return Status::Error("Can't find prev paths.");
     }
-    const auto& paths = pathToSrcFound->second;
-    for (auto& p : paths) {
-      Row path;
-      if (traverse_->trackPrevPath()) {
-        path = p;
-      }
-      path.values.emplace_back(srcV);
-      List neighbors;
-      neighbors.values.emplace_back(srcV);
-      path.values.emplace_back(std::move(neighbors));
-      buildPath(zeroSteps, src, std::move(path));
-      ++count;
+    for (auto root : *pathsToSrc) {
+      zeroSteps_.add(src, PathNode{root, srcV, Value()});
     }
   }
   return Status::OK();
@@ -7,6 +7,7 @@
 
 #include "graph/executor/StorageAccessExecutor.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/util/VidHash.h"
 #include "interface/gen-cpp2/storage_types.h"
 // only used in match scenarios
 // invoke the getNeighbors interface, according to the number of times specified by the user,
@@ -18,31 +19,75 @@
 // `resDs_` : keep result dataSet
 //
 // Member:
-// `paths_` : hash table array, paths_[i] means that the length that paths in the i-th array
-//  element is i
-//    KEY in the hash table   : the vid of the destination Vertex
-//    VALUE in the hash table : collection of paths that destionation vid is `KEY`
+// `roots_` : the rows of the input, which are the paths of the step 0
+// `steps_` : steps_[i] keeps the paths of length i + 1 as path nodes, each of which is the last
+//  step of a path and points to the node of the path without it in the previous step, so that
+//  extending a path costs a node instead of a copy of the whole path. The paths are only
+//  materialized into rows for the steps in the result.
+//    `nodes` : the nodes of the step
+//    `dsts`  : KEY is the vid of the destination Vertex, VALUE is the nodes of the paths to KEY,
+//              which is released once the next step is expanded. In multi jobs mode it's
+//              sharded by the parts of the dsts, so that the jobs build and probe the shards
+//              without locks.
+// `zeroSteps_` : the paths of length 0, only used if the step range starts from 0
+// `reqParts_` : the vids of the current step not expanded yet, grouped by their parts
+// `nextReqParts_` : the vids to expand in the next step, grouped by their parts
+// `pathLimit_` : the max number of the paths to output, -1 for no limit. The steps in the result
+//  are expanded by batches of the vids then, and the traversal stops once the paths are enough.
 //
 // Functions:
-// `buildRequestDataSet` : constructs the input DataSet for getNeightbors
-// `buildInterimPath` : construct collection of paths after expanded and put it into the paths_
-// `getNeighbors` : invoke the getNeightbors interface
-// `releasePrevPaths` : deleted The path whose length does not meet the user-defined length
+// `buildRequestDataSet` : collect the vids of the input to expand by getNeightbors
+// `buildInterimPath` : construct the path nodes after expanded and put them into the steps_
+// `buildInterimPathMultiJobs` : the same as above, by the jobs handling the responses and the
+//  jobs merging the dsts of the shards
+// `expandStep` : start expanding the next step
+// `getNeighbors` : invoke the getNeightbors interface with the next batch of the vids of the step
+// `buildPathRow` : materialize a path node into a row
+// `checkLimitDsts` : look up the dsts of the paths once they reach the limit, so that the ones
+//  AppendVertices drops for their missing dsts are not counted
 // `hasSameEdge` : check if there are duplicate edges in path
 namespace nebula {
 namespace graph {
 
 using RpcResponse = storage::StorageRpcResponse<storage::cpp2::GetNeighborsResponse>;
 using Dst = Value;
-using Paths = std::vector<Row>;
+
+// The last step of a path
+struct PathNode {
+  // Index of the node of the path without this step in the previous step, or of the row in the
+  // roots for the first step
+  size_t parent;
+  // The source vertex and the edge of this step, the edge is empty for the zero step
+  Value vertex;
+  Value edge;
+};
+
+// KEY is the vid of the destination Vertex, VALUE is the nodes of the paths to KEY
+using DstPaths = VidMap<std::vector<size_t>>;
+
+struct StepPaths {
+  std::vector<PathNode> nodes;
+  // The shards of the paths to the dsts
+  std::vector<DstPaths> dsts = std::vector<DstPaths>(1);
+
+  void add(const Dst& dst, PathNode&& node) {
+    dsts.front()[dst].emplace_back(nodes.size());
+    nodes.emplace_back(std::move(node));
+  }
+};
+
+// The node of a newly traversed path and its dst
+struct DstNode {
+  PartitionID part;
+  Dst dst;
+  size_t node;
+};
 
 struct JobResult {
-  // Newly traversed paths size
-  size_t pathCnt{0};
-  // Request dataset for next traverse
-  DataSet reqDs;
-  // Newly traversed paths
-  std::unordered_map<Dst, Paths> newPaths;
+  // Newly traversed path nodes
+  std::vector<PathNode> nodes;
+  // The dsts of the nodes, bucketed by the shards of their parts
+  std::vector<std::vector<DstNode>> shards;
 };
 
 class TraverseExecutor final : public StorageAccessExecutor {
@@ -63,18 +108,70 @@ class TraverseExecutor final : public StorageAccessExecutor {
 
   void addStats(RpcResponse& resps, int64_t getNbrTimeInUSec);
 
+  folly::Future<Status> expandStep();
+
   folly::Future<Status> getNeighbors();
 
-  folly::Future<Status> handleResponse(RpcResponse&& resps);
+  // Take the vids of the current step to expand by the next request, all of them unless the
+  // paths of the step are limited
+  std::unordered_map<PartitionID, std::vector<Row>> takeRequestBatch();
+
+  // Whether the responses of the current request are handled one by one as they arrive, so that
+  // the paths are built while the others are still on the way. Not for the limited steps, whose
+  // batches are checked against the limit as a whole, or if the responses are split among the
+  // jobs and none of them is split by storage_client_get_neighbors_batch_size.
+  bool streamResponses() const;
+
+  // Take the neighbors out of the response, and build the paths of them once the previous ones
+  // are built
+  void addChunk(storage::cpp2::GetNeighborsResponse& resp);
+
+  // The future of the chunks added so far, which are all of the request once it's collected
+  folly::Future<Status> takeChunks();
+
+  // Build the paths of the neighbors, unless they have been built chunk by chunk
+  folly::Future<Status> handleResponse(RpcResponse&& resps, bool streamed);
+
+  // Expand the rest of the vids of the step, or the next step, or build the result if none left
+  folly::Future<Status> continueTraverse();
+
+  // Look up the dsts of the paths not known yet, see Traverse::limitDstProps, and stop once the
+  // paths kept are enough
+  folly::Future<Status> checkLimitDsts();
+
+  folly::Future<Status> handleLimitDsts();
 
   Status buildInterimPath(GetNeighborsIter* iter);
 
-  folly::Future<Status> buildInterimPathMultiJobs(std::unique_ptr<GetNeighborsIter> iter);
+  folly::Future<Status> buildInterimPathMultiJobs(List&& list);
 
-  StatusOr<JobResult> handleJob(size_t begin,
-                                size_t end,
-                                Iterator* iter,
-                                const std::unordered_map<Value, Paths>& prev);
+  StatusOr<JobResult> handleJob(Iterator* iter,
+                                const std::vector<DstPaths>& prev,
+                                size_t numShards);
+
+  // Merge the dsts of the jobs shard by shard, and build the request of the next step
+  folly::Future<Status> mergeJobResults(std::vector<StatusOr<JobResult>>&& results,
+                                        size_t numShards);
+
+  bool hasNextRequest() const {
+    return !nextReqParts_.empty();
+  }
+
+  size_t minStep() const {
+    return range_ == nullptr ? 1 : range_->min();
+  }
+
+  // The number of the paths in the step range traversed so far, except the ones dropped
+  size_t resultPathCount() const;
+
+  // Whether the paths of the current step are in the result and limited
+  bool limitedStep() const {
+    return pathLimit_ >= 0 && currentStep_ >= minStep();
+  }
+
+  bool pathLimitReached() const {
+    return pathLimit_ >= 0 && resultPathCount() >= static_cast<size_t>(pathLimit_);
+  }
 
   Status buildResult();
 
@@ -87,30 +184,71 @@ class TraverseExecutor final : public StorageAccessExecutor {
     return node_->asNode<Traverse>()->zeroStep();
   }
 
-  bool hasSameEdge(const Row& prevPath, const Edge& currentEdge);
+  // The paths to the dsts of the previous step
+  std::vector<DstPaths>& prevDsts() {
+    return currentStep_ == 1 ? rootDsts_ : steps_[currentStep_ - 2].dsts;
+  }
+
+  // The nodes of the paths to the src in the previous step, nullptr if there is none
+  const std::vector<size_t>* findPrevPaths(const std::vector<DstPaths>& prev,
+                                           const Value& src) const;
+
+  PartitionID partOf(const Value& vid) const;
+
+  // Add the vid to the request of the next step
+  void addRequestVid(const Value& vid, PartitionID part);
+
+  // Whether the path of the index-th node of the step has the edge already
+  bool hasSameEdge(size_t step, size_t index, const Edge& currentEdge) const;
+
+  bool hasSameEdge(const Row& prevPath, const Edge& currentEdge) const;
+
+  // Materialize the path of the index-th node of the step, or of the zero step if step is 0
+  Row buildPathRow(size_t step, size_t index) const;
 
-  void releasePrevPaths(size_t cnt);
+  // The dst of the path of the index-th node of the step, or of the zero step if step is 0
+  const Value& pathDst(size_t step, size_t index) const;
 
-  void buildPath(std::unordered_map<Value, std::vector<Row>>& currentPaths,
-                 const Value& dst,
-                 Row&& path);
+  // Whether the dst of the path is known to be missing
+  bool dstDropped(size_t step, size_t index) const;
 
-  Status handleZeroStep(const std::unordered_map<Value, Paths>& prev,
-                        List&& vertices,
-                        std::unordered_map<Value, Paths>& zeroSteps,
-                        size_t& count);
+  Status handleZeroStep(List&& vertices);
 
   Expression* selectFilter();
 
  private:
   ObjectPool objPool_;
-  DataSet reqDs_;
+  std::unordered_map<PartitionID, std::vector<Row>> reqParts_;
+  std::unordered_map<PartitionID, std::vector<Row>> nextReqParts_;
+  int32_t numParts_{0};
+  int64_t pathLimit_{-1};
+  // The number of the requests sent for the current step
+  size_t stepRequests_{0};
   const Traverse* traverse_{nullptr};
   MatchStepRange* range_{nullptr};
   size_t currentStep_{0};
-  std::list<std::unordered_map<Dst, Paths>> paths_;
-  size_t totalPathCnt_{0};
-  folly::ConcurrentHashMap<Dst, uint8_t> uniqueDsts_;
+  std::vector<Row> roots_;
+  std::vector<DstPaths> rootDsts_;
+  std::vector<StepPaths> steps_;
+  StepPaths zeroSteps_;
+  // The filter of the dsts of the final step, built once for all its requests
+  std::shared_ptr<const storage::cpp2::VidFilter> vidFilter_;
+  bool vidFilterBuilt_{false};
+  // The dsts of the final step read by storage, and the ones looked up for them, see
+  // Traverse::dstVerticesVar
+  DataSet dstVertices_;
+  std::vector<Value> fetchedDsts_;
+  // Whether the dsts of the paths exist, only looked up for the paths reaching the limit
+  std::unordered_map<Value, bool> dstExists_;
+  // The number of the paths in the step range whose dsts are known to be missing, counted when
+  // the dsts are looked up, so the paths to them traversed since are not included
+  size_t droppedPaths_{0};
+  // The chunks of the request handled one after another as their responses arrive, and the time
+  // spent on them, which is added to the execution time once they are done
+  std::mutex chunkLock_;
+  folly::Future<Status> chunks_{folly::makeFuture<Status>(Status::OK())};
+  uint64_t chunkTime_{0};
+  std::atomic<size_t> chunkRows_{0};
 };
 
 }  // namespace graph
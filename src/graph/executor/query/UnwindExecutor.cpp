@@ -22,33 +22,18 @@ folly::Future<Status> UnwindExecutor::execute() {
   DataSet ds;
   ds.colNames = unwind->colNames();
   for (; iter->valid(); iter->next()) {
-    const Value &list = unwindExpr->eval(ctx(iter.get()));
-    std::vector<Value> vals = extractList(list);
-    for (auto &v : vals) {
+    UnwindExecutor::unwind(unwindExpr, ctx(iter.get()), [&](const Value &v, bool) {
       Row row;
       if (!emptyInput) {
         row = *(iter->row());
       }
-      row.values.emplace_back(std::move(v));
+      row.values.emplace_back(v);
       ds.rows.emplace_back(std::move(row));
-    }
+      return true;
+    });
   }
   return finish(ResultBuilder().value(Value(std::move(ds))).build());
 }
 
-std::vector<Value> UnwindExecutor::extractList(const Value &val) {
-  std::vector<Value> ret;
-  if (val.isList()) {
-    auto &list = val.getList();
-    ret = list.values;
-  } else {
-    if (!(val.isNull() || val.empty())) {
-      ret.push_back(val);
-    }
-  }
-
-  return ret;
-}
-
 }  // namespace graph
 }  // namespace nebula
@@ -5,6 +5,7 @@
 #ifndef GRAPH_EXECUTOR_QUERY_UNWINDEXECUTOR_H_
 #define GRAPH_EXECUTOR_QUERY_UNWINDEXECUTOR_H_
 
+#include "common/expression/FunctionCallExpression.h"
 #include "graph/executor/Executor.h"
 // expand multiple columns of data into one column
 namespace nebula {
@@ -17,10 +18,62 @@ class UnwindExecutor final : public Executor {
 
   folly::Future<Status> execute() override;
 
- private:
-  std::vector<Value> extractList(const Value &val);
+  // Call f(value, last) for each value unwound from the expression until it returns false. The
+  // values of range() are generated one by one without building the list, and the ones of a list
+  // are not copied before f.
+  template <typename F>
+  static void unwind(Expression *expr, ExpressionContext &ctx, F &&f);
 };
 
+template <typename F>
+void UnwindExecutor::unwind(Expression *expr, ExpressionContext &ctx, F &&f) {
+  if (expr->kind() == Expression::Kind::kFunctionCall) {
+    auto *func = static_cast<FunctionCallExpression *>(expr);
+    const auto &args = func->args()->args();
+    if (func->isFunc("range") && (args.size() == 2 || args.size() == 3)) {
+      const auto &start = args[0]->eval(ctx);
+      if (!start.isInt()) {
+        return;
+      }
+      auto v = start.getInt();
+      const auto &end = args[1]->eval(ctx);
+      if (!end.isInt()) {
+        return;
+      }
+      auto last = end.getInt();
+      int64_t step = 1;
+      if (args.size() == 3) {
+        const auto &stepVal = args[2]->eval(ctx);
+        if (!stepVal.isInt() || stepVal.getInt() == 0) {
+          return;
+        }
+        step = stepVal.getInt();
+      }
+      while (step > 0 ? v <= last : v >= last) {
+        int64_t next = 0;
+        bool isLast =
+            __builtin_add_overflow(v, step, &next) || (step > 0 ? next > last : next < last);
+        if (!f(Value(v), isLast) || isLast) {
+          return;
+        }
+        v = next;
+      }
+      return;
+    }
+  }
+  const auto &val = expr->eval(ctx);
+  if (val.isList()) {
+    const auto &values = val.getList().values;
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (!f(values[i], i + 1 == values.size())) {
+        return;
+      }
+    }
+  } else if (!(val.isNull() || val.empty())) {
+    f(val, true);
+  }
+}
+
 }  // namespace graph
 }  // namespace nebula
 
@@ -8,6 +8,7 @@
 #include "graph/context/QueryContext.h"
 #include "graph/executor/query/AggregateExecutor.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 
 namespace nebula {
 namespace graph {
@@ -2177,5 +2178,54 @@ TEST_F(AggregateTest, BitXor) {
     TEST_AGG_4("BIT_XOR", "bit_xor", true)
   }
 }
+
+TEST_F(AggregateTest, AggregateMultiJobs) {
+  // Aggregate the 11 rows in 3 partitions
+  auto maxJobSize = FLAGS_max_job_size;
+  auto minBatchSize = FLAGS_min_batch_size;
+  FLAGS_max_job_size = 3;
+  FLAGS_min_batch_size = 1;
+
+  // key = col2
+  // items = col2, count(col1), collect(col1), count(distinct col3)
+  std::vector<Expression*> groupKeys;
+  std::vector<Expression*> groupItems;
+  auto expr = InputPropertyExpression::make(pool_, "col2");
+  groupKeys.emplace_back(expr);
+  groupItems.emplace_back(AggregateExpression::make(pool_, "", expr->clone(), false));
+  groupItems.emplace_back(
+      AggregateExpression::make(pool_, "COUNT", InputPropertyExpression::make(pool_, "col1")));
+  groupItems.emplace_back(
+      AggregateExpression::make(pool_, "COLLECT", InputPropertyExpression::make(pool_, "col1")));
+  groupItems.emplace_back(AggregateExpression::make(
+      pool_, "COUNT", InputPropertyExpression::make(pool_, "col3"), true));
+  auto* agg = Aggregate::make(qctx_.get(), nullptr, std::move(groupKeys), std::move(groupItems));
+  agg->setInputVar(*input_);
+  agg->setColNames(std::vector<std::string>{"col2", "count", "list", "count_distinct"});
+
+  auto aggExe = std::make_unique<AggregateExecutor>(agg, qctx_.get());
+  auto status = aggExe->execute().get();
+  EXPECT_TRUE(status.ok());
+  auto& result = qctx_->ectx()->getResult(agg->outputVar());
+  EXPECT_EQ(result.state(), Result::State::kSuccess);
+
+  std::unordered_map<Value, Row> expected;
+  expected.emplace(Value::kNullValue, Row({Value::kNullValue, 0, List(), 0}));
+  for (auto i = 0; i < 5; ++i) {
+    // the rows of a group are collected in order
+    expected.emplace(i, Row({i, 2, List({2 * i, 2 * i + 1}), 1}));
+  }
+  auto& ds = result.value().getDataSet();
+  ASSERT_EQ(expected.size(), ds.rows.size());
+  for (auto& row : ds.rows) {
+    auto found = expected.find(row.values[0]);
+    ASSERT_NE(found, expected.end());
+    EXPECT_EQ(found->second, row);
+  }
+
+  FLAGS_max_job_size = maxJobSize;
+  FLAGS_min_batch_size = minBatchSize;
+}
+
 }  // namespace graph
 }  // namespace nebula
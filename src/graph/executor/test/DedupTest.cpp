@@ -9,6 +9,7 @@
 #include "graph/executor/query/ProjectExecutor.h"
 #include "graph/executor/test/QueryTestBase.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 
 namespace nebula {
 namespace graph {
@@ -65,6 +66,27 @@ TEST_F(DedupTest, TestSequential) {
   DEDUP_RESULT_CHECK("input_sequential", "dedup_sequential", sentence, expected);
 }
 
+TEST_F(DedupTest, TestSequentialMultiJobs) {
+  // Hash the 6 rows by 3 jobs
+  auto maxJobSize = FLAGS_max_job_size;
+  auto minBatchSize = FLAGS_min_batch_size;
+  FLAGS_max_job_size = 3;
+  FLAGS_min_batch_size = 1;
+  DataSet expected({"vid", "name", "age", "dst", "start", "end"});
+  expected.emplace_back(Row({"Ann", "Ann", 18, "School1", 2010, 2014}));
+  expected.emplace_back(Row({"Joy", "Joy", Value::kNullValue, "School2", 2009, 2012}));
+  expected.emplace_back(Row({"Tom", "Tom", 20, "School2", 2008, 2012}));
+  expected.emplace_back(Row({"Kate", "Kate", 19, "School2", 2009, 2013}));
+  expected.emplace_back(Row({"Lily", "Lily", 20, "School2", 2009, 2012}));
+
+  auto sentence =
+      "YIELD DISTINCT $-.vid as vid, $-.v_name as name, $-.v_age as age, "
+      "$-.v_dst as dst, $-.e_start_year as start, $-.e_end_year as end";
+  [&]() { DEDUP_RESULT_CHECK("input_sequential", "dedup_multi_jobs", sentence, expected); }();
+  FLAGS_max_job_size = maxJobSize;
+  FLAGS_min_batch_size = minBatchSize;
+}
+
 TEST_F(DedupTest, TestEmpty) {
   DataSet expected({"name"});
   DEDUP_RESULT_CHECK("empty", "dedup_sequential", "YIELD DISTINCT $-.v_dst as name", expected);
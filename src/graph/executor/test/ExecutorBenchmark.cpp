@@ -0,0 +1,381 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+
+#include "common/expression/AggregateExpression.h"
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "common/expression/RelationalExpression.h"
+#include "graph/context/QueryContext.h"
+#include "graph/executor/algo/ProduceAllPathsExecutor.h"
+#include "graph/executor/query/AggregateExecutor.h"
+#include "graph/executor/query/DedupExecutor.h"
+#include "graph/executor/query/FilterExecutor.h"
+#include "graph/executor/query/InnerJoinExecutor.h"
+#include "graph/executor/query/ProjectExecutor.h"
+#include "graph/executor/query/SortExecutor.h"
+#include "graph/planner/plan/Algo.h"
+#include "graph/planner/plan/Logic.h"
+#include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
+#include "graph/session/ClientSession.h"
+
+DEFINE_int32(executor_bm_cols, 8, "The columns of the input rows, the first is the key");
+DEFINE_string(executor_bm_types,
+              "int,string,float",
+              "The types of the columns after the key in turn, of int, string, float and bool");
+DEFINE_int32(executor_bm_cardinality, 1000, "The distinct keys of the input rows");
+DEFINE_int32(executor_bm_string_size, 16, "The bytes of a string column");
+DEFINE_int32(executor_bm_fanout, 10, "The edges of a vertex when producing all paths");
+DEFINE_int32(executor_bm_threads, 8, "The threads and jobs of the multi jobs variants");
+
+DECLARE_bool(enable_lifetime_optimize);
+
+namespace nebula {
+namespace graph {
+
+/**
+ * The input of all operators is a synthetic dataset of the given rows, whose first column "c0" is
+ * an int key of executor_bm_cardinality distinct values, and the other columns are of the types
+ * of executor_bm_types in turn. The datasets of different sizes are made once and kept as the
+ * variables of one query context.
+ */
+class BenchContext {
+ public:
+  static BenchContext& instance() {
+    static BenchContext context;
+    return context;
+  }
+
+  QueryContext* qctx() {
+    return qctx_.get();
+  }
+
+  ObjectPool* pool() {
+    return qctx_->objPool();
+  }
+
+  // The variable of the input of the rows
+  const std::string& input(size_t rows) {
+    auto iter = inputs_.find(rows);
+    if (iter != inputs_.end()) {
+      return iter->second;
+    }
+    std::vector<std::string> types;
+    folly::split(",", FLAGS_executor_bm_types, types, true);
+    CHECK(!types.empty());
+    DataSet ds;
+    for (int32_t i = 0; i < FLAGS_executor_bm_cols; i++) {
+      ds.colNames.emplace_back(folly::sformat("c{}", i));
+    }
+    std::string str(FLAGS_executor_bm_string_size, 'x');
+    for (size_t r = 0; r < rows; r++) {
+      Row row;
+      row.values.emplace_back(static_cast<int64_t>(folly::Random::rand32(cardinality())));
+      for (int32_t i = 1; i < FLAGS_executor_bm_cols; i++) {
+        const auto& type = types[(i - 1) % types.size()];
+        if (type == "string") {
+          str[0] = 'a' + folly::Random::rand32(26);
+          row.values.emplace_back(str);
+        } else if (type == "float") {
+          row.values.emplace_back(folly::Random::randDouble01());
+        } else if (type == "bool") {
+          row.values.emplace_back(folly::Random::oneIn(2));
+        } else {
+          row.values.emplace_back(static_cast<int64_t>(folly::Random::rand32()));
+        }
+      }
+      ds.rows.emplace_back(std::move(row));
+    }
+    return setVariable(rows, folly::sformat("input_{}", rows), std::move(ds));
+  }
+
+  // The variable of the rows of {k, v} of every key, which the input is joined with
+  const std::string& keys() {
+    if (keys_.empty()) {
+      DataSet ds({"k", "v"});
+      for (int64_t k = 0; k < cardinality(); k++) {
+        ds.rows.emplace_back(Row({k, folly::sformat("key_{}", k)}));
+      }
+      keys_ = "keys";
+      qctx_->symTable()->newVariable(keys_);
+      qctx_->ectx()->setResult(keys_, ResultBuilder().value(Value(std::move(ds))).build());
+    }
+    return keys_;
+  }
+
+  /**
+   * @brief The get neighbors results of a step of finding all paths between the sources and the
+   * destinations, every source reaches executor_bm_fanout of the middle vertices, and every
+   * destination is reached from executor_bm_fanout of them
+   */
+  Value neighbors(size_t vertices, bool reverse) {
+    DataSet ds({kVid, "_stats", "_edge:+like:_type:_dst:_rank", "_expr"});
+    for (size_t i = 0; i < vertices; i++) {
+      Row row;
+      row.values.emplace_back(folly::sformat("{}{}", reverse ? "t" : "s", i));
+      row.values.emplace_back(Value());
+      List edges;
+      for (int32_t j = 0; j < FLAGS_executor_bm_fanout; j++) {
+        List edge;
+        edge.values.emplace_back(reverse ? -1 : 1);
+        edge.values.emplace_back(folly::sformat("m{}", folly::Random::rand32(vertices)));
+        edge.values.emplace_back(0);
+        edges.values.emplace_back(std::move(edge));
+      }
+      row.values.emplace_back(std::move(edges));
+      row.values.emplace_back(Value());
+      ds.rows.emplace_back(std::move(row));
+    }
+    List datasets;
+    datasets.values.emplace_back(std::move(ds));
+    return Value(std::move(datasets));
+  }
+
+  Value vids(size_t vertices, bool reverse) {
+    DataSet ds({kVid});
+    for (size_t i = 0; i < vertices; i++) {
+      ds.rows.emplace_back(Row({folly::sformat("{}{}", reverse ? "t" : "s", i)}));
+    }
+    return Value(std::move(ds));
+  }
+
+  // Run the operators by a single job or by multi jobs, of which the results are the same
+  void setMultiJobs(bool multiJobs) {
+    FLAGS_max_job_size = multiJobs ? FLAGS_executor_bm_threads : 1;
+  }
+
+  static int64_t cardinality() {
+    return std::max(FLAGS_executor_bm_cardinality, 1);
+  }
+
+ private:
+  BenchContext() {
+    // The inputs must be kept for the next run
+    FLAGS_enable_lifetime_optimize = false;
+    qctx_ = std::make_unique<QueryContext>();
+    auto rctx = std::make_unique<RequestContext<ExecutionResponse>>();
+    rctx->setSession(ClientSession::create(meta::cpp2::Session(), nullptr));
+    rctx->setRunner(std::make_unique<folly::CPUThreadPoolExecutor>(FLAGS_executor_bm_threads));
+    qctx_->setRCtx(std::move(rctx));
+  }
+
+  const std::string& setVariable(size_t rows, std::string var, DataSet ds) {
+    qctx_->symTable()->newVariable(var);
+    qctx_->ectx()->setResult(var, ResultBuilder().value(Value(std::move(ds))).build());
+    return inputs_.emplace(rows, std::move(var)).first->second;
+  }
+
+ private:
+  std::unique_ptr<QueryContext> qctx_;
+  std::unordered_map<size_t, std::string> inputs_;
+  std::string keys_;
+};
+
+template <typename ExecutorT, typename NodeT>
+void runExecutor(size_t iters, NodeT* node) {
+  auto* qctx = BenchContext::instance().qctx();
+  for (size_t i = 0; i < iters; i++) {
+    auto executor = std::make_unique<ExecutorT>(node, qctx);
+    auto status = executor->execute().get();
+    CHECK(status.ok()) << status;
+  }
+  BENCHMARK_SUSPEND {
+    qctx->ectx()->dropResult(node->outputVar());
+  }
+}
+
+void aggregate(size_t iters, size_t rows, bool multiJobs) {
+  Aggregate* agg = nullptr;
+  BENCHMARK_SUSPEND {
+    auto& context = BenchContext::instance();
+    context.setMultiJobs(multiJobs);
+    auto* pool = context.pool();
+    auto* key = InputPropertyExpression::make(pool, "c0");
+    std::vector<Expression*> groupKeys = {key};
+    std::vector<Expression*> groupItems = {
+        AggregateExpression::make(pool, "", key->clone(), false),
+        AggregateExpression::make(pool, "COUNT", ConstantExpression::make(pool, 1), false),
+        AggregateExpression::make(pool, "MAX", InputPropertyExpression::make(pool, "c1"), false)};
+    agg = Aggregate::make(context.qctx(), nullptr, std::move(groupKeys), std::move(groupItems));
+    agg->setInputVar(context.input(rows));
+    agg->setColNames({"c0", "count", "max"});
+  }
+  runExecutor<AggregateExecutor>(iters, agg);
+}
+
+void sort(size_t iters, size_t rows, bool multiJobs) {
+  auto& context = BenchContext::instance();
+  auto* qctx = context.qctx();
+  Sort* sort = nullptr;
+  DataSet input;
+  BENCHMARK_SUSPEND {
+    context.setMultiJobs(multiJobs);
+    input = qctx->ectx()->getResult(context.input(rows)).value().getDataSet();
+    sort = Sort::make(
+        qctx, nullptr, {{0, OrderFactor::OrderType::ASCEND}, {1, OrderFactor::OrderType::DESCEND}});
+    sort->setInputVar("sort_input");
+    qctx->symTable()->newVariable("sort_input");
+  }
+  for (size_t i = 0; i < iters; i++) {
+    BENCHMARK_SUSPEND {
+      // The rows are sorted in place, so each run sorts a copy of the input
+      qctx->ectx()->setResult("sort_input", ResultBuilder().value(Value(input)).build());
+    }
+    auto executor = std::make_unique<SortExecutor>(sort, qctx);
+    auto status = executor->execute().get();
+    CHECK(status.ok()) << status;
+  }
+}
+
+void dedup(size_t iters, size_t rows, bool multiJobs) {
+  Dedup* dedup = nullptr;
+  BENCHMARK_SUSPEND {
+    auto& context = BenchContext::instance();
+    context.setMultiJobs(multiJobs);
+    dedup = Dedup::make(context.qctx(), nullptr);
+    dedup->setInputVar(context.input(rows));
+  }
+  runExecutor<DedupExecutor>(iters, dedup);
+}
+
+void innerJoin(size_t iters, size_t rows, bool multiJobs) {
+  InnerJoin* join = nullptr;
+  BENCHMARK_SUSPEND {
+    auto& context = BenchContext::instance();
+    context.setMultiJobs(multiJobs);
+    auto* pool = context.pool();
+    const auto& input = context.input(rows);
+    const auto& keys = context.keys();
+    std::vector<Expression*> hashKeys = {VariablePropertyExpression::make(pool, keys, "k")};
+    std::vector<Expression*> probeKeys = {VariablePropertyExpression::make(pool, input, "c0")};
+    join = InnerJoin::make(
+        context.qctx(), nullptr, {keys, 0}, {input, 0}, std::move(hashKeys), std::move(probeKeys));
+    std::vector<std::string> colNames = {"k", "v"};
+    for (int32_t i = 0; i < FLAGS_executor_bm_cols; i++) {
+      colNames.emplace_back(folly::sformat("c{}", i));
+    }
+    join->setColNames(std::move(colNames));
+  }
+  runExecutor<InnerJoinExecutor>(iters, join);
+}
+
+void project(size_t iters, size_t rows, bool multiJobs) {
+  Project* project = nullptr;
+  BENCHMARK_SUSPEND {
+    auto& context = BenchContext::instance();
+    context.setMultiJobs(multiJobs);
+    auto* pool = context.pool();
+    auto* columns = pool->makeAndAdd<YieldColumns>();
+    std::vector<std::string> colNames;
+    for (int32_t i = 0; i < FLAGS_executor_bm_cols; i += 2) {
+      auto name = folly::sformat("c{}", i);
+      columns->addColumn(new YieldColumn(InputPropertyExpression::make(pool, name), name));
+      colNames.emplace_back(std::move(name));
+    }
+    project = Project::make(context.qctx(), nullptr, columns);
+    project->setInputVar(context.input(rows));
+    project->setColNames(std::move(colNames));
+  }
+  runExecutor<ProjectExecutor>(iters, project);
+}
+
+void filter(size_t iters, size_t rows, bool multiJobs) {
+  Filter* filter = nullptr;
+  BENCHMARK_SUSPEND {
+    auto& context = BenchContext::instance();
+    context.setMultiJobs(multiJobs);
+    auto* pool = context.pool();
+    // Half of the rows pass
+    auto* half = ConstantExpression::make(pool, BenchContext::cardinality() / 2);
+    auto* condition =
+        RelationalExpression::makeLT(pool, InputPropertyExpression::make(pool, "c0"), half);
+    filter = Filter::make(context.qctx(), nullptr, condition);
+    filter->setInputVar(context.input(rows));
+  }
+  runExecutor<FilterExecutor>(iters, filter);
+}
+
+// The first step of finding all paths between the sources and the destinations
+void produceAllPaths(size_t iters, size_t vertices) {
+  auto& context = BenchContext::instance();
+  auto* qctx = context.qctx();
+  ProduceAllPaths* path = nullptr;
+  BENCHMARK_SUSPEND {
+    auto left = folly::sformat("paths_left_{}", vertices);
+    auto right = folly::sformat("paths_right_{}", vertices);
+    for (const auto& var : {left, right, left + "_vid", right + "_vid"}) {
+      qctx->symTable()->newVariable(var);
+    }
+    for (auto reverse : {false, true}) {
+      ResultBuilder builder;
+      builder.value(context.neighbors(vertices, reverse)).iter(Iterator::Kind::kGetNeighbors);
+      qctx->ectx()->setResult(reverse ? right : left, builder.build());
+    }
+    path = ProduceAllPaths::make(qctx, StartNode::make(qctx), StartNode::make(qctx), 4, false);
+    path->setLeftVar(left);
+    path->setRightVar(right);
+    path->setLeftVidVar(left + "_vid");
+    path->setRightVidVar(right + "_vid");
+    path->setColNames({"path"});
+  }
+  for (size_t i = 0; i < iters; i++) {
+    BENCHMARK_SUSPEND {
+      // The vids are replaced by the ones of the next step
+      qctx->ectx()->setResult(path->leftVidVar(),
+                              ResultBuilder().value(context.vids(vertices, false)).build());
+      qctx->ectx()->setResult(path->rightVidVar(),
+                              ResultBuilder().value(context.vids(vertices, true)).build());
+    }
+    auto executor = std::make_unique<ProduceAllPathsExecutor>(path, qctx);
+    auto status = executor->execute().get();
+    CHECK(status.ok()) << status;
+  }
+}
+
+BENCHMARK_NAMED_PARAM(aggregate, 1K_single, 1000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(aggregate, 1K_multi, 1000, true)
+BENCHMARK_NAMED_PARAM(aggregate, 100K_single, 100000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(aggregate, 100K_multi, 100000, true)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(sort, 1K_single, 1000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(sort, 1K_multi, 1000, true)
+BENCHMARK_NAMED_PARAM(sort, 100K_single, 100000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(sort, 100K_multi, 100000, true)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(dedup, 1K_single, 1000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(dedup, 1K_multi, 1000, true)
+BENCHMARK_NAMED_PARAM(dedup, 100K_single, 100000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(dedup, 100K_multi, 100000, true)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(innerJoin, 1K_single, 1000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(innerJoin, 1K_multi, 1000, true)
+BENCHMARK_NAMED_PARAM(innerJoin, 100K_single, 100000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(innerJoin, 100K_multi, 100000, true)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(project, 1K_single, 1000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(project, 1K_multi, 1000, true)
+BENCHMARK_NAMED_PARAM(project, 100K_single, 100000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(project, 100K_multi, 100000, true)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(filter, 1K_single, 1000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(filter, 1K_multi, 1000, true)
+BENCHMARK_NAMED_PARAM(filter, 100K_single, 100000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(filter, 100K_multi, 100000, true)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(produceAllPaths, 100_vertices, 100)
+BENCHMARK_NAMED_PARAM(produceAllPaths, 10K_vertices, 10000)
+
+}  // namespace graph
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
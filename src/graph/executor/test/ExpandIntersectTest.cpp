@@ -0,0 +1,127 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/context/QueryContext.h"
+#include "graph/executor/query/ExpandIntersectExecutor.h"
+#include "graph/planner/plan/Query.h"
+
+namespace nebula {
+namespace graph {
+
+using storage::StorageRpcResponse;
+using storage::cpp2::GetNeighborsResponse;
+using storage::cpp2::GetPropResponse;
+
+class ExpandIntersectTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    qctx_ = std::make_unique<QueryContext>();
+    meta::cpp2::Session session;
+    session.session_id_ref() = 0;
+    session.user_name_ref() = "root";
+    auto clientSession = ClientSession::create(std::move(session), nullptr);
+    SpaceInfo spaceInfo;
+    spaceInfo.name = "test_space";
+    spaceInfo.id = 1;
+    spaceInfo.spaceDesc.space_name_ref() = "test_space";
+    meta::cpp2::ColumnTypeDef vidType;
+    vidType.type_ref() = nebula::cpp2::PropertyType::FIXED_STRING;
+    vidType.type_length_ref() = 8;
+    spaceInfo.spaceDesc.vid_type_ref() = std::move(vidType);
+    clientSession->setSpace(std::move(spaceInfo));
+    auto rctx = std::make_unique<RequestContext<ExecutionResponse>>();
+    rctx->setSession(std::move(clientSession));
+    qctx_->setRCtx(std::move(rctx));
+
+    // The rows of (x, y) to close the cycles of
+    DataSet ds({"x", "y"});
+    ds.emplace_back(Row({"a", "c"}));
+    ds.emplace_back(Row({"b", "c"}));
+    ds.emplace_back(Row({"d", "c"}));
+    qctx_->symTable()->newVariable("input");
+    qctx_->ectx()->setResult("input", ResultBuilder().value(Value(std::move(ds))).build());
+  }
+
+  // The edges over like of each vertex, by the sign of the edge type
+  static StorageRpcResponse<GetNeighborsResponse> neighbors(
+      const std::vector<std::pair<std::string, std::vector<std::string>>>& edges, int sign) {
+    std::string edgeCol = sign > 0 ? "_edge:+like" : "_edge:-like";
+    DataSet ds({kVid, "_stats", edgeCol + ":_type:_dst:_rank", "_expr"});
+    for (const auto& vertex : edges) {
+      List list;
+      for (const auto& dst : vertex.second) {
+        list.values.emplace_back(List({Value(sign * kLike), Value(dst), Value(0)}));
+      }
+      ds.emplace_back(Row({vertex.first, Value(), std::move(list), Value()}));
+    }
+    GetNeighborsResponse resp;
+    resp.vertices_ref() = std::move(ds);
+    StorageRpcResponse<GetNeighborsResponse> rpcResp(1);
+    rpcResp.addResponse(std::move(resp));
+    return rpcResp;
+  }
+
+  static StorageRpcResponse<GetPropResponse> props(const std::vector<std::string>& vids) {
+    DataSet ds({kVid, "player.name"});
+    for (const auto& vid : vids) {
+      ds.emplace_back(Row({vid, vid + "_name"}));
+    }
+    GetPropResponse resp;
+    resp.props_ref() = std::move(ds);
+    StorageRpcResponse<GetPropResponse> rpcResp(1);
+    rpcResp.addResponse(std::move(resp));
+    return rpcResp;
+  }
+
+  static Value like(const std::string& src, const std::string& dst) {
+    return Value(List({Edge(src, dst, kLike, "like", 0, {})}));
+  }
+
+  static Value player(const std::string& vid) {
+    return Value(Vertex(vid, {Tag("player", {{"name", Value(vid + "_name")}})}));
+  }
+
+  static constexpr EdgeType kLike = 1;
+  std::unique_ptr<QueryContext> qctx_;
+};
+
+TEST_F(ExpandIntersectTest, Intersect) {
+  auto* pool = qctx_->objPool();
+  auto* expand = ExpandIntersect::make(qctx_.get(), nullptr, 1);
+  expand->setSrc(InputPropertyExpression::make(pool, "x"));
+  expand->setDst(InputPropertyExpression::make(pool, "y"));
+  expand->setInputVar("input");
+  expand->setColNames({"x", "e1", "z", "e2"});
+
+  auto exe = std::make_unique<ExpandIntersectExecutor>(expand, qctx_.get());
+  exe->input_ = qctx_->ectx()->getResult("input").iter();
+  // a->m1, a->m2, a->m4, b->m2, d->m5
+  ASSERT_TRUE(
+      exe->buildNeighbors(neighbors({{"a", {"m4", "m1", "m2"}}, {"b", {"m2"}}, {"d", {"m5"}}}, 1),
+                          false)
+          .ok());
+  // m1->c, m2->c, m3->c, read reversely from c
+  ASSERT_TRUE(exe->buildNeighbors(neighbors({{"c", {"m3", "m2", "m1"}}}, -1), true).ok());
+
+  auto mids = exe->collectCandidates();
+  EXPECT_EQ(2, mids.size());
+  EXPECT_EQ(1, mids.count(Value("m1")));
+  EXPECT_EQ(1, mids.count(Value("m2")));
+
+  ASSERT_TRUE(exe->buildResult(props({"m1", "m2"})).ok());
+  auto& result = qctx_->ectx()->getResult(expand->outputVar());
+  ASSERT_TRUE(result.value().isDataSet());
+  // The rows of [x, [e1], z, [e2]] as the two single steps of Traverse
+  DataSet expected({"x", "e1", "z", "e2"});
+  expected.emplace_back(Row({Vertex("a", {}), like("a", "m1"), player("m1"), like("m1", "c")}));
+  expected.emplace_back(Row({Vertex("a", {}), like("a", "m2"), player("m2"), like("m2", "c")}));
+  expected.emplace_back(Row({Vertex("b", {}), like("b", "m2"), player("m2"), like("m2", "c")}));
+  EXPECT_EQ(expected, result.value().getDataSet());
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -6,6 +6,7 @@
 
 #include "graph/context/QueryContext.h"
 #include "graph/executor/query/FilterExecutor.h"
+#include "graph/executor/query/FilterProjectLimitExecutor.h"
 #include "graph/executor/query/ProjectExecutor.h"
 #include "graph/executor/test/QueryTestBase.h"
 #include "graph/planner/plan/Query.h"
@@ -86,5 +87,24 @@ TEST_F(FilterTest, TestEmpty) {
                       "YIELD $^.person.name AS name WHERE study.start_year >= 2010",
                       expected);
 }
+
+TEST_F(FilterTest, TestFilterProjectLimit) {
+  auto yieldSentence = getYieldSentence(
+      "YIELD $-.v_name AS name, $-.e_start_year AS start WHERE $-.e_start_year >= 2009",
+      qctx_.get());
+  auto* node = FilterProjectLimit::make(
+      qctx_.get(), nullptr, yieldSentence->where()->filter(), yieldSentence->yieldColumns(), 1, 3);
+  node->setInputVar("input_sequential");
+  auto exe = std::make_unique<FilterProjectLimitExecutor>(node, qctx_.get());
+  EXPECT_TRUE(exe->execute().get().ok());
+  auto& result = qctx_->ectx()->getResult(node->outputVar());
+  EXPECT_EQ(result.state(), Result::State::kSuccess);
+
+  DataSet expected({"name", "start"});
+  expected.emplace_back(Row({Value("Joy"), Value(2009)}));
+  expected.emplace_back(Row({Value("Kate"), Value(2009)}));
+  expected.emplace_back(Row({Value("Ann"), Value(2010)}));
+  EXPECT_EQ(result.value().getDataSet(), expected);
+}
 }  // namespace graph
 }  // namespace nebula
@@ -10,6 +10,7 @@
 #include "graph/executor/query/LeftJoinExecutor.h"
 #include "graph/executor/test/QueryTestBase.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 
 namespace nebula {
 namespace graph {
@@ -283,6 +284,46 @@ TEST_F(JoinTest, LeftJoin) {
   testLeftJoin("var1", "var2", expected, __LINE__);
 }
 
+TEST_F(JoinTest, JoinMultiJobs) {
+  // Build the hash tables of 5 rows in 3 partitions
+  auto maxJobSize = FLAGS_max_job_size;
+  auto minBatchSize = FLAGS_min_batch_size;
+  FLAGS_max_job_size = 3;
+  FLAGS_min_batch_size = 1;
+  {
+    DataSet expected;
+    expected.colNames = {"src", "dst", kVid, "tag_prop", "edge_prop", kDst};
+    for (auto i = 0; i < 10; ++i) {
+      Row row;
+      row.values.emplace_back(folly::to<std::string>(i / 2 + 11));
+      row.values.emplace_back(folly::to<std::string>(i / 2));
+      row.values.emplace_back(folly::to<std::string>(i / 2));
+      row.values.emplace_back(i);
+      row.values.emplace_back(i + 1);
+      row.values.emplace_back(folly::to<std::string>(i / 2 + 5 + i % 2));
+      expected.rows.emplace_back(std::move(row));
+    }
+    testInnerJoin("var2", "var1", expected, __LINE__);
+  }
+  {
+    DataSet expected;
+    expected.colNames = {kVid, "tag_prop", "edge_prop", kDst, "src", "dst"};
+    for (auto i = 0; i < 10; ++i) {
+      Row row;
+      row.values.emplace_back(folly::to<std::string>(i / 2));
+      row.values.emplace_back(i);
+      row.values.emplace_back(i + 1);
+      row.values.emplace_back(folly::to<std::string>(i / 2 + 5 + i % 2));
+      row.values.emplace_back(folly::to<std::string>(i / 2 + 11));
+      row.values.emplace_back(folly::to<std::string>(i / 2));
+      expected.rows.emplace_back(std::move(row));
+    }
+    testLeftJoin("var1", "var2", expected, __LINE__);
+  }
+  FLAGS_max_job_size = maxJobSize;
+  FLAGS_min_batch_size = minBatchSize;
+}
+
 TEST_F(JoinTest, LeftJoinTwice) {
   std::string joinOutput;
   {
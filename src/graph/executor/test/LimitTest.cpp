@@ -11,6 +11,8 @@
 #include "graph/executor/test/QueryTestBase.h"
 #include "graph/planner/plan/Logic.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/scheduler/Pipeline.h"
+#include "graph/service/GraphFlags.h"
 #include "graph/util/ExpressionUtils.h"
 
 namespace nebula {
@@ -72,5 +74,41 @@ TEST_F(LimitTest, getNeighborOutRange2) {
   DataSet expected({"name", "start"});
   LIMIT_RESULT_CHECK("limit_out_sequential2", 6, 2, expected);
 }
+
+TEST_F(LimitTest, Pipeline) {
+  auto enablePipeline = FLAGS_enable_pipeline_execution;
+  auto batchSize = FLAGS_pipeline_batch_size;
+  FLAGS_enable_pipeline_execution = true;
+  FLAGS_pipeline_batch_size = 2;
+
+  auto yieldSentence =
+      getYieldSentence("YIELD $-.v_name AS name WHERE $-.e_start_year >= 2009", qctx_.get());
+  auto start = StartNode::make(qctx_.get());
+  auto* filter = Filter::make(qctx_.get(), start, yieldSentence->where()->filter());
+  filter->setInputVar("input_sequential");
+  filter->setColNames({"vid", "v_name", "v_age", "v_dst", "e_start_year", "e_end_year"});
+  auto* project = Project::make(qctx_.get(), filter, yieldSentence->yieldColumns());
+  project->setColNames({"name"});
+  auto* limit = Limit::make(qctx_.get(), project, 1, 2);
+  limit->setColNames({"name"});
+
+  auto executors = Pipeline::fuse(Executor::create(limit, qctx_.get()), qctx_.get());
+  ASSERT_EQ(executors.size(), 3);
+  EXPECT_EQ(executors.front()->node(), filter);
+  EXPECT_EQ(executors.back()->node(), limit);
+  Pipeline pipeline(qctx_.get(), std::move(executors));
+  ASSERT_TRUE(pipeline.fusible());
+  EXPECT_TRUE(pipeline.execute().ok());
+
+  DataSet expected({"name"});
+  expected.emplace_back(Row({Value("Joy")}));
+  expected.emplace_back(Row({Value("Kate")}));
+  auto& result = qctx_->ectx()->getResult(limit->outputVar());
+  EXPECT_EQ(result.value().getDataSet(), expected);
+  EXPECT_EQ(result.state(), Result::State::kSuccess);
+
+  FLAGS_enable_pipeline_execution = enablePipeline;
+  FLAGS_pipeline_batch_size = batchSize;
+}
 }  // namespace graph
 }  // namespace nebula
@@ -10,8 +10,10 @@
 #include "graph/executor/logic/LoopExecutor.h"
 #include "graph/executor/logic/SelectExecutor.h"
 #include "graph/executor/logic/StartExecutor.h"
+#include "graph/executor/query/DedupExecutor.h"
 #include "graph/planner/plan/Logic.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/scheduler/Scheduler.h"
 
 namespace nebula {
 namespace graph {
@@ -99,5 +101,58 @@ TEST_F(LogicExecutorsTest, Select) {
     EXPECT_FALSE(value.getBool());
   }
 }
+
+TEST_F(LogicExecutorsTest, VersionsRead) {
+  constexpr size_t kAllVersions = std::numeric_limits<size_t>::max();
+  {
+    auto* start = StartNode::make(qctx_.get());
+    auto* dedup = Dedup::make(qctx_.get(), start);
+    auto* join =
+        InnerJoin::make(qctx_.get(), dedup, {dedup->outputVar(), 0}, {start->outputVar(), -2});
+    auto* dc = DataCollect::make(qctx_.get(), DataCollect::DCKind::kRowBasedMove);
+    dc->addDep(join);
+    dc->setInputVars({join->outputVar()});
+    Scheduler::analyzeLifetime(dc);
+    EXPECT_EQ(kAllVersions, join->outputVarPtr()->versionsRead);
+    EXPECT_EQ(1, dedup->outputVarPtr()->versionsRead);
+    // The latest one read by dedup and the one two versions before read by join
+    EXPECT_EQ(3, start->outputVarPtr()->versionsRead);
+    // Not read through the inputs of any node
+    EXPECT_EQ(kAllVersions, dc->outputVarPtr()->versionsRead);
+  }
+  {
+    // The positive versions count from the oldest one
+    auto* start = StartNode::make(qctx_.get());
+    auto* dedup = Dedup::make(qctx_.get(), start);
+    auto* join =
+        LeftJoin::make(qctx_.get(), dedup, {start->outputVar(), 1}, {dedup->outputVar(), 0});
+    Scheduler::analyzeLifetime(join);
+    EXPECT_EQ(kAllVersions, start->outputVarPtr()->versionsRead);
+    EXPECT_EQ(1, dedup->outputVarPtr()->versionsRead);
+  }
+}
+
+TEST_F(LogicExecutorsTest, TruncVersionsRead) {
+  auto* start = StartNode::make(qctx_.get());
+  auto* dedup = Dedup::make(qctx_.get(), start);
+  auto* join =
+      InnerJoin::make(qctx_.get(), start, {start->outputVar(), 0}, {dedup->outputVar(), -1});
+  Scheduler::analyzeLifetime(join);
+  ASSERT_EQ(2, dedup->outputVarPtr()->versionsRead);
+
+  auto dedupExe = std::make_unique<DedupExecutor>(dedup, qctx_.get());
+  for (int i = 0; i < 3; ++i) {
+    DataSet ds({"v"});
+    ds.emplace_back(Row({i}));
+    qctx_->ectx()->setResult(start->outputVar(),
+                             ResultBuilder().value(Value(std::move(ds))).build());
+    EXPECT_TRUE(dedupExe->execute().get().ok());
+  }
+  // Only the versions read by join are kept
+  const auto& history = qctx_->ectx()->getHistory(dedup->outputVar());
+  ASSERT_EQ(2, history.size());
+  EXPECT_EQ(Row({1}), history[0].value().getDataSet().rows.front());
+  EXPECT_EQ(Row({2}), history[1].value().getDataSet().rows.front());
+}
 }  // namespace graph
 }  // namespace nebula
@@ -119,5 +119,44 @@ TEST_F(ProjectTest, EmptyInput) {
   EXPECT_EQ(result.state(), Result::State::kSuccess);
 }
 
+TEST_F(ProjectTest, MoveInput) {
+  std::string input = "input_project";
+  auto yieldColumns = getYieldColumns(
+      "YIELD $input_project.vid AS vid, $input_project.vid + 1 AS next, $input_project.vid AS vid2",
+      qctx_.get());
+  auto* project = Project::make(qctx_.get(), start_, yieldColumns);
+  project->setInputVar(input);
+  project->setColNames(std::vector<std::string>{"vid", "next", "vid2"});
+
+  auto iter = qctx_->ectx()->getResult(input).iter();
+  auto moved = ProjectExecutor::movedColumns(yieldColumns, iter.get());
+  EXPECT_EQ(moved, (std::vector<int32_t>{-1, -1, 0}));
+
+  // The project is the only reader of its input
+  qctx_->symTable()->getVar(input)->userCount.store(1);
+  auto proExe = Executor::create(project, qctx_.get());
+  auto status = std::move(proExe->execute()).get();
+  EXPECT_TRUE(status.ok());
+  auto& result = qctx_->ectx()->getResult(project->outputVar());
+
+  DataSet expected;
+  expected.colNames = {"vid", "next", "vid2"};
+  for (auto i = 0; i < 10; ++i) {
+    Row row;
+    row.values.emplace_back(i);
+    row.values.emplace_back(i + 1);
+    row.values.emplace_back(i);
+    expected.rows.emplace_back(std::move(row));
+  }
+  EXPECT_EQ(result.value().getDataSet(), expected);
+
+  // The values referenced directly are moved out of the input
+  const auto& inputDs = qctx_->ectx()->getResult(input).value().getDataSet();
+  for (auto& row : inputDs.rows) {
+    EXPECT_TRUE(row.values[0].empty());
+    EXPECT_FALSE(row.values[1].empty());
+  }
+}
+
 }  // namespace graph
 }  // namespace nebula
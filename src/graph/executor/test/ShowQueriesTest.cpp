@@ -38,6 +38,15 @@ TEST_F(ShowQueriesTest, TestAddQueryAndTopN) {
     desc.start_time_ref() = 123;
     desc.status_ref() = meta::cpp2::QueryStatus::RUNNING;
     desc.duration_ref() = 200;
+    desc.memory_in_bytes_ref() = 1024;
+    meta::cpp2::QueryResources resources;
+    resources.cpu_time_us_ref() = 10;
+    resources.peak_memory_in_bytes_ref() = 2048;
+    resources.storage_rpcs_ref() = 3;
+    resources.storage_response_bytes_ref() = 4096;
+    resources.rows_scanned_ref() = 5;
+    resources.stage_duration_us_ref() = {{"GetNeighborsExecutor", 50}};
+    desc.resources_ref() = std::move(resources);
     desc.query_ref() = "";
     desc.graph_addr_ref() = HostAddr("127.0.0.1", 9669);
 
@@ -50,8 +59,15 @@ TEST_F(ShowQueriesTest, TestAddQueryAndTopN) {
                    "Host",
                    "StartTime",
                    "DurationInUSec",
+                   "MemoryInBytes",
                    "Status",
-                   "Query"});
+                   "Query",
+                   "CpuTimeInUSec",
+                   "PeakMemoryInBytes",
+                   "StorageRpcs",
+                   "StorageResponseBytes",
+                   "RowsScanned",
+                   "StageDurationInUSec"});
   DataSet expected = dataSet;
   {
     Row row;
@@ -63,8 +79,15 @@ TEST_F(ShowQueriesTest, TestAddQueryAndTopN) {
     dateTime.microsec = 123;
     row.emplace_back(std::move(dateTime));
     row.emplace_back(100);
+    row.emplace_back(0);
     row.emplace_back("RUNNING");
     row.emplace_back("");
+    row.emplace_back(0);
+    row.emplace_back(0);
+    row.emplace_back(0);
+    row.emplace_back(0);
+    row.emplace_back(0);
+    row.emplace_back(Map());
     expected.rows.emplace_back(std::move(row));
   }
   {
@@ -77,8 +100,15 @@ TEST_F(ShowQueriesTest, TestAddQueryAndTopN) {
     dateTime.microsec = 123;
     row.emplace_back(std::move(dateTime));
     row.emplace_back(200);
+    row.emplace_back(1024);
     row.emplace_back("RUNNING");
     row.emplace_back("");
+    row.emplace_back(10);
+    row.emplace_back(2048);
+    row.emplace_back(3);
+    row.emplace_back(4096);
+    row.emplace_back(5);
+    row.emplace_back(Map({{"GetNeighborsExecutor", 50}}));
     expected.rows.emplace_back(std::move(row));
   }
 
@@ -86,6 +116,11 @@ TEST_F(ShowQueriesTest, TestAddQueryAndTopN) {
   ShowQueriesExecutor exe(showQueries, qctx_.get());
   exe.addQueries(session, dataSet);
   EXPECT_EQ(expected.size(), dataSet.size());
+  // Each column is filled once
+  EXPECT_EQ(dataSet.colNames, ShowQueriesExecutor::columnNames());
+  for (auto& row : dataSet.rows) {
+    EXPECT_EQ(dataSet.colNames.size(), row.size());
+  }
   for (auto& row : expected) {
     EXPECT_TRUE(std::find(dataSet.rows.begin(), dataSet.rows.end(), row) != dataSet.rows.end());
   }
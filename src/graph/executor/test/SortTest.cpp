@@ -11,6 +11,7 @@
 #include "graph/executor/test/QueryTestBase.h"
 #include "graph/planner/plan/Logic.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 
 namespace nebula {
 namespace graph {
@@ -130,5 +131,83 @@ TEST_F(SortTest, sortTwoColDesDes_union) {
   factors.emplace_back(std::make_pair(4, OrderFactor::OrderType::DESCEND));
   SORT_RESULT_CHECK("union_sequential", "union_sort_two_cols_des_des", true, factors, expected);
 }
+
+TEST_F(SortTest, sortMultiJobs) {
+  // Sort the 6 rows in 3 runs, then merge them
+  auto maxJobSize = FLAGS_max_job_size;
+  auto minBatchSize = FLAGS_min_batch_size;
+  FLAGS_max_job_size = 3;
+  FLAGS_min_batch_size = 1;
+  DataSet expected({"age", "start_year"});
+  expected.emplace_back(Row({18, 2010}));
+  expected.emplace_back(Row({18, 2010}));
+  expected.emplace_back(Row({19, 2009}));
+  expected.emplace_back(Row({20, 2009}));
+  expected.emplace_back(Row({20, 2008}));
+  expected.emplace_back(Row({Value::kNullValue, 2009}));
+  std::vector<std::pair<size_t, OrderFactor::OrderType>> factors;
+  factors.emplace_back(std::make_pair(2, OrderFactor::OrderType::ASCEND));
+  factors.emplace_back(std::make_pair(4, OrderFactor::OrderType::DESCEND));
+  SORT_RESULT_CHECK("input_sequential", "sort_multi_jobs", true, factors, expected);
+  FLAGS_max_job_size = maxJobSize;
+  FLAGS_min_batch_size = minBatchSize;
+}
+
+TEST_F(SortTest, sortKey) {
+  std::vector<Value> values = {Value(),
+                               Value::kNullValue,
+                               false,
+                               true,
+                               std::numeric_limits<int64_t>::min(),
+                               -1,
+                               0,
+                               1,
+                               std::numeric_limits<int64_t>::max(),
+                               "",
+                               std::string("a\0", 2),
+                               "a",
+                               "ab",
+                               "b"};
+  for (auto orderType : {OrderFactor::OrderType::ASCEND, OrderFactor::OrderType::DESCEND}) {
+    SortExecutor::Factors factors = {{0, orderType}, {1, orderType}};
+    for (auto& l : values) {
+      for (auto& r : values) {
+        Row lhs({l, 1});
+        Row rhs({r, 2});
+        std::string lKey, rKey;
+        ASSERT_TRUE(SortExecutor::encodeSortKey(lhs, factors, lKey));
+        ASSERT_TRUE(SortExecutor::encodeSortKey(rhs, factors, rKey));
+        // the second column decides if the first ones are equal
+        auto asc = orderType == OrderFactor::OrderType::ASCEND;
+        auto less = l == r ? asc : (asc ? l < r : l > r);
+        EXPECT_EQ(less, lKey < rKey) << l << " " << r;
+      }
+    }
+  }
+  std::string key;
+  EXPECT_FALSE(SortExecutor::encodeSortKey(
+      Row({1.0}), {{0, OrderFactor::OrderType::ASCEND}}, key));
+
+  // The kinds of null have keys of their own, all ordered after the other values
+  std::vector<Value> nulls = {Value::kNullValue,
+                              Value::kNullNaN,
+                              Value::kNullBadData,
+                              Value::kNullBadType,
+                              Value::kNullOverflow,
+                              Value::kNullUnknownProp,
+                              Value::kNullDivByZero,
+                              Value::kNullOutOfRange};
+  SortExecutor::Factors factors = {{0, OrderFactor::OrderType::ASCEND}};
+  std::string maxKey;
+  ASSERT_TRUE(SortExecutor::encodeSortKey(Row({"b"}), factors, maxKey));
+  std::unordered_set<std::string> nullKeys;
+  for (const auto& null : nulls) {
+    std::string nullKey;
+    ASSERT_TRUE(SortExecutor::encodeSortKey(Row({null}), factors, nullKey));
+    EXPECT_LT(maxKey, nullKey) << null;
+    nullKeys.emplace(std::move(nullKey));
+  }
+  EXPECT_EQ(nulls.size(), nullKeys.size());
+}
 }  // namespace graph
 }  // namespace nebula
@@ -36,6 +36,16 @@ folly::Future<cpp2::GetNeighborsResponse> GraphStorageLocalServer::future_getNei
   LOCAL_RETURN_FUTURE(threadManager_, cpp2::GetNeighborsResponse, future_getNeighbors);
 }
 
+folly::Future<cpp2::KHopGetNeighborsResponse> GraphStorageLocalServer::future_getNeighborsKHop(
+    const cpp2::KHopGetNeighborsRequest& request) {
+  LOCAL_RETURN_FUTURE(threadManager_, cpp2::KHopGetNeighborsResponse, future_getNeighborsKHop);
+}
+
+folly::Future<cpp2::GetDegreesResponse> GraphStorageLocalServer::future_getDegrees(
+    const cpp2::GetDegreesRequest& request) {
+  LOCAL_RETURN_FUTURE(threadManager_, cpp2::GetDegreesResponse, future_getDegrees);
+}
+
 folly::Future<cpp2::ExecResponse> GraphStorageLocalServer::future_addVertices(
     const cpp2::AddVerticesRequest& request) {
   LOCAL_RETURN_FUTURE(threadManager_, cpp2::ExecResponse, future_addVertices);
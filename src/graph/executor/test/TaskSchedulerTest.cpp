@@ -0,0 +1,68 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+
+#include "graph/scheduler/TaskScheduler.h"
+
+namespace nebula {
+namespace graph {
+
+TEST(TaskSchedulerTest, RunAll) {
+  TaskScheduler scheduler(4);
+  std::atomic<size_t> count{0};
+  std::vector<folly::Future<folly::Unit>> futures;
+  for (size_t i = 0; i < 100; ++i) {
+    // Each task adds another one from the worker thread
+    futures.emplace_back(folly::via(&scheduler, [&count]() { ++count; })
+                             .via(&scheduler)
+                             .thenValue([&count](auto&&) { ++count; }));
+  }
+  folly::collectAll(futures).get();
+  EXPECT_EQ(count.load(), 200);
+}
+
+TEST(TaskSchedulerTest, Priority) {
+  TaskScheduler scheduler(1);
+  folly::Baton<> started;
+  folly::Baton<> blocked;
+  std::mutex lock;
+  std::vector<int8_t> order;
+  auto record = [&](int8_t priority) {
+    return [&, priority]() {
+      std::lock_guard<std::mutex> g(lock);
+      order.emplace_back(priority);
+    };
+  };
+  // Occupy the only worker until all the other tasks are queued
+  scheduler.add([&]() {
+    started.post();
+    blocked.wait();
+  });
+  started.wait();
+  scheduler.addWithPriority(record(folly::Executor::LO_PRI), folly::Executor::LO_PRI);
+  scheduler.addWithPriority(record(folly::Executor::MID_PRI), folly::Executor::MID_PRI);
+  scheduler.addWithPriority(record(folly::Executor::HI_PRI), folly::Executor::HI_PRI);
+  blocked.post();
+  scheduler.stop();
+
+  std::vector<int8_t> expected{
+      folly::Executor::HI_PRI, folly::Executor::MID_PRI, folly::Executor::LO_PRI};
+  EXPECT_EQ(order, expected);
+}
+
+TEST(TaskSchedulerTest, Runner) {
+  TaskScheduler scheduler(2);
+  auto runner = scheduler.makeRunner();
+  auto result = folly::via(runner.get(), []() { return 1; })
+                    .via(runner.get())
+                    .thenValue([](int v) { return v + 1; })
+                    .get();
+  EXPECT_EQ(result, 2);
+}
+
+}  // namespace graph
+}  // namespace nebula
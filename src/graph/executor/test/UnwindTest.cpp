@@ -10,6 +10,8 @@
 #include "graph/executor/test/QueryTestBase.h"
 #include "graph/planner/plan/Logic.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/scheduler/Pipeline.h"
+#include "graph/service/GraphFlags.h"
 
 namespace nebula {
 namespace graph {
@@ -23,7 +25,10 @@ class UnwindTest : public QueryTestBase {
   }
 
   void testUnwind(std::vector<Value> l) {
-    auto list = ConstantExpression::make(pool_, List(l));
+    testUnwind(ConstantExpression::make(pool_, List(l)), l);
+  }
+
+  void testUnwind(Expression* list, std::vector<Value> l) {
     auto* unwind = Unwind::make(qctx_.get(), start_, list, "items");
     unwind->setColNames(std::vector<std::string>{"items"});
 
@@ -65,5 +70,59 @@ TEST_F(UnwindTest, UnwindList) {
   TEST_UNWIND(testSuite["case2"]);
 }
 
+TEST_F(UnwindTest, UnwindRange) {
+  auto range = [this](std::vector<Expression*> args) {
+    return FunctionCallExpression::make(pool_, "range", args);
+  };
+  auto constant = [this](int64_t v) { return ConstantExpression::make(pool_, v); };
+  testUnwind(range({constant(1), constant(10), constant(3)}), {1, 4, 7, 10});
+  testUnwind(range({constant(5), constant(1), constant(-2)}), {5, 3, 1});
+  testUnwind(range({constant(1), constant(0)}), {});
+  testUnwind(range({constant(1), constant(3), constant(0)}), {});
+  // No overflow at the end of int64
+  auto max = std::numeric_limits<int64_t>::max();
+  testUnwind(range({constant(max - 1), constant(max)}), {max - 1, max});
+  testUnwind(range({constant(1), ConstantExpression::make(pool_, "a")}), {});
+}
+
+TEST_F(UnwindTest, PipelineStopsByLimit) {
+  auto enablePipeline = FLAGS_enable_pipeline_execution;
+  auto batchSize = FLAGS_pipeline_batch_size;
+  FLAGS_enable_pipeline_execution = true;
+  FLAGS_pipeline_batch_size = 2;
+
+  DataSet input({"c"});
+  input.emplace_back(Row({Value("a")}));
+  qctx_->symTable()->newVariable("input_unwind");
+  qctx_->ectx()->setResult("input_unwind", ResultBuilder().value(Value(std::move(input))).build());
+
+  // A range too large to be materialized
+  auto* range = FunctionCallExpression::make(
+      pool_,
+      "range",
+      {ConstantExpression::make(pool_, 1), ConstantExpression::make(pool_, 1000000000000L)});
+  auto* unwind = Unwind::make(qctx_.get(), start_, range, "x");
+  unwind->setInputVar("input_unwind");
+  unwind->setColNames({"c", "x"});
+  auto* limit = Limit::make(qctx_.get(), unwind, 1, 3);
+  limit->setColNames({"c", "x"});
+
+  auto executors = Pipeline::fuse(Executor::create(limit, qctx_.get()), qctx_.get());
+  ASSERT_EQ(executors.size(), 2);
+  Pipeline pipeline(qctx_.get(), std::move(executors));
+  ASSERT_TRUE(pipeline.fusible());
+  EXPECT_TRUE(pipeline.execute().ok());
+
+  DataSet expected({"c", "x"});
+  expected.emplace_back(Row({Value("a"), Value(2)}));
+  expected.emplace_back(Row({Value("a"), Value(3)}));
+  expected.emplace_back(Row({Value("a"), Value(4)}));
+  auto& result = qctx_->ectx()->getResult(limit->outputVar());
+  EXPECT_EQ(result.value().getDataSet(), expected);
+
+  FLAGS_enable_pipeline_execution = enablePipeline;
+  FLAGS_pipeline_batch_size = batchSize;
+}
+
 }  // namespace graph
 }  // namespace nebula
@@ -15,20 +15,60 @@ GC& GC::instance() {
 
 GC::GC() {
   if (FLAGS_gc_worker_size == 0) {
-    workers_.start(std::thread::hardware_concurrency(), "GC");
+    numWorkers_ = std::thread::hardware_concurrency();
   } else {
-    workers_.start(FLAGS_gc_worker_size, "GC");
+    numWorkers_ = FLAGS_gc_worker_size;
   }
+  workers_.start(numWorkers_, "GC");
+  // Collect the garbage missed by the woken workers
   workers_.addRepeatTaskForAll(50, &GC::periodicTask, this);
 }
 
 void GC::clear(std::vector<Result>&& garbage) {
-  queue_.enqueue(std::move(garbage));
+  if (garbage.empty()) {
+    return;
+  }
+  int64_t bytes = 0;
+  for (const auto& result : garbage) {
+    bytes += result.releasableMemory();
+  }
+  pendingBytes_.fetch_add(bytes, std::memory_order_release);
+  auto& queue = bytes >= FLAGS_gc_large_garbage_bytes ? largeQueue_ : smallQueue_;
+  queue.enqueue(Garbage{std::move(garbage), bytes});
+  auto collecting = collecting_.load(std::memory_order_relaxed);
+  while (collecting < numWorkers_) {
+    if (collecting_.compare_exchange_weak(collecting, collecting + 1)) {
+      workers_.addTask([this]() {
+        collect();
+        collecting_.fetch_sub(1);
+      });
+      break;
+    }
+  }
+}
+
+bool GC::collectPending() {
+  return collect() > 0;
 }
 
 void GC::periodicTask() {
-  // TODO: maybe could release by batch
-  queue_.try_dequeue();
+  collect();
 }
+
+int64_t GC::collect() {
+  int64_t released = 0;
+  Garbage garbage;
+  while (largeQueue_.try_dequeue(garbage) || smallQueue_.try_dequeue(garbage)) {
+    released += garbage.bytes;
+    destroy(std::move(garbage));
+  }
+  return released;
+}
+
+void GC::destroy(Garbage&& garbage) {
+  garbage.results.clear();
+  pendingBytes_.fetch_sub(garbage.bytes, std::memory_order_release);
+}
+
 }  // namespace graph
 }  // namespace nebula
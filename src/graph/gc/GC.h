@@ -15,6 +15,10 @@ namespace graph {
 // Clean the unused memory on background threads, this is helpful
 // for big queries since the memory release of interim results may
 // cost too much time.
+//
+// The garbage is destroyed by the idle workers as soon as it's cleared, the large ones go first
+// since they release more memory. The memory reserved for the garbage is still accounted until
+// it's destroyed, so the queries exceeding the memory limit could destroy the pending one first.
 class GC {
  public:
   static GC& instance();
@@ -25,10 +29,33 @@ class GC {
 
   void clear(std::vector<Result>&& garbage);
 
+  // The memory reserved for the garbage not destroyed yet
+  int64_t pendingBytes() const {
+    return pendingBytes_.load(std::memory_order_acquire);
+  }
+
+  // Destroy the queued garbage on the calling thread instead of waiting for the workers, return
+  // false if no memory is released by it
+  bool collectPending();
+
  private:
+  struct Garbage {
+    std::vector<Result> results;
+    int64_t bytes{0};
+  };
+
   GC();
   void periodicTask();
-  folly::UMPMCQueue<std::vector<Result>, false> queue_;
+  // Destroy all the queued garbage, return the memory released
+  int64_t collect();
+  void destroy(Garbage&& garbage);
+
+  size_t numWorkers_{0};
+  // The workers collecting the garbage, an idle one is woken up once the garbage is cleared
+  std::atomic<size_t> collecting_{0};
+  folly::UMPMCQueue<Garbage, false> largeQueue_;
+  folly::UMPMCQueue<Garbage, false> smallQueue_;
+  std::atomic<int64_t> pendingBytes_{0};
   thread::GenericThreadPool workers_;
 };
 }  // namespace graph
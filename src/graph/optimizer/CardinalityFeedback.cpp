@@ -0,0 +1,125 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/optimizer/CardinalityFeedback.h"
+
+#include <cmath>
+
+DEFINE_bool(enable_cardinality_feedback,
+            true,
+            "Correct the rows estimated by the optimizer with the rows returned by previous runs");
+DEFINE_uint32(cardinality_feedback_capacity,
+              4096,
+              "The max number of plan nodes whose cardinality feedback is kept by a graphd");
+
+using nebula::storage::cpp2::IndexColumnHint;
+using nebula::storage::cpp2::ScanType;
+
+namespace nebula {
+namespace opt {
+
+namespace {
+
+// The weight of the latest run in the correction
+constexpr double kSmoothing = 0.5;
+
+}  // namespace
+
+// static
+CardinalityFeedback& CardinalityFeedback::instance() {
+  static CardinalityFeedback feedback;
+  return feedback;
+}
+
+// static
+std::string CardinalityFeedback::indexScanKey(IndexID index,
+                                              const std::vector<IndexColumnHint>& hints) {
+  std::string key = folly::stringPrintf("index %d(", index);
+  for (size_t i = 0; i < hints.size(); ++i) {
+    const auto& hint = hints[i];
+    if (i > 0) {
+      key.append(", ");
+    }
+    key.append(hint.get_column_name());
+    if (hint.get_scan_type() == ScanType::PREFIX) {
+      key.append("==").append(hint.get_begin_value().toString());
+    } else {
+      key.append(" in ")
+          .append(hint.get_include_begin() ? "[" : "(")
+          .append(hint.get_begin_value().toString())
+          .append(", ")
+          .append(hint.get_end_value().toString())
+          .append(hint.get_include_end() ? "]" : ")");
+    }
+  }
+  key.append(")");
+  return key;
+}
+
+double CardinalityFeedback::correct(const std::string& key, double estimated) const {
+  if (!FLAGS_enable_cardinality_feedback) {
+    return estimated;
+  }
+  std::lock_guard<std::mutex> guard(lock_);
+  auto iter = index_.find(key);
+  return iter == index_.end() ? estimated : estimated * iter->second->correction;
+}
+
+void CardinalityFeedback::record(const std::string& key,
+                                 const std::string& query,
+                                 double estimated,
+                                 int64_t actual) {
+  if (!FLAGS_enable_cardinality_feedback || FLAGS_cardinality_feedback_capacity == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(lock_);
+  auto iter = index_.find(key);
+  if (iter == index_.end()) {
+    lru_.emplace_front(Entry{key, "", 0.0, 0, 1.0, 0});
+    iter = index_.emplace(key, lru_.begin()).first;
+    while (lru_.size() > FLAGS_cardinality_feedback_capacity) {
+      index_.erase(lru_.back().key);
+      lru_.pop_back();
+    }
+  } else {
+    lru_.splice(lru_.begin(), lru_, iter->second);
+  }
+  auto& entry = *iter->second;
+  // The node was estimated with the correction of then, which is the current one mostly
+  auto raw = estimated / entry.correction;
+  // Less than one row is taken as one, so an empty result doesn't make the correction zero
+  auto ratio = std::max<double>(actual, 1.0) / std::max(raw, 1.0);
+  if (entry.runs == 0) {
+    entry.correction = ratio;
+  } else {
+    entry.correction = std::exp((1 - kSmoothing) * std::log(entry.correction) +
+                                kSmoothing * std::log(ratio));
+  }
+  entry.query = query;
+  entry.estimated = raw;
+  entry.actual = actual;
+  entry.runs++;
+}
+
+std::vector<CardinalityFeedback::Entry> CardinalityFeedback::misestimates() const {
+  std::vector<Entry> entries;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    entries.assign(lru_.begin(), lru_.end());
+  }
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+    return std::abs(std::log(a.correction)) > std::abs(std::log(b.correction));
+  });
+  return entries;
+}
+
+void CardinalityFeedback::clear() {
+  std::lock_guard<std::mutex> guard(lock_);
+  index_.clear();
+  lru_.clear();
+}
+
+}  // namespace opt
+}  // namespace nebula
@@ -0,0 +1,79 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_OPTIMIZER_CARDINALITYFEEDBACK_H_
+#define GRAPH_OPTIMIZER_CARDINALITYFEEDBACK_H_
+
+#include <boost/core/noncopyable.hpp>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/base/Base.h"
+#include "common/thrift/ThriftTypes.h"
+#include "interface/gen-cpp2/storage_types.h"
+
+DECLARE_bool(enable_cardinality_feedback);
+
+namespace nebula {
+namespace opt {
+
+// Correct the rows estimated by the cost model with the rows actually returned by the same plan
+// nodes before, so that the estimates stay accurate on skewed data without collecting the stats
+// again.
+//
+// The feedback is kept in memory of each graphd, keyed by the shape of the plan node together
+// with the values it is bound to, e.g. the index and the column hints of an index scan. The
+// correction is the geometric moving average of the ratios of actual to estimated rows, and the
+// least recently used keys are evicted beyond cardinality_feedback_capacity.
+class CardinalityFeedback final : private boost::noncopyable {
+ public:
+  struct Entry {
+    std::string key;
+    // The last query run with the plan node
+    std::string query;
+    // The last rows estimated by the cost model, before the correction
+    double estimated{0.0};
+    // The last rows returned
+    int64_t actual{0};
+    // The estimated rows are multiplied by it
+    double correction{1.0};
+    int64_t runs{0};
+  };
+
+  static CardinalityFeedback& instance();
+
+  // The key of a scan of the index with the column hints, the index ids are unique among spaces
+  static std::string indexScanKey(IndexID index,
+                                  const std::vector<storage::cpp2::IndexColumnHint>& hints);
+
+  // The estimated rows multiplied by the correction of the key, if any
+  double correct(const std::string& key, double estimated) const;
+
+  /**
+   * @brief Record the rows returned by a plan node
+   *
+   * @param estimated The rows the plan node was estimated with, i.e. after the correction
+   */
+  void record(const std::string& key, const std::string& query, double estimated, int64_t actual);
+
+  // The entries of the largest misestimates first, i.e. the corrections farthest from 1
+  std::vector<Entry> misestimates() const;
+
+  void clear();
+
+ private:
+  CardinalityFeedback() = default;
+
+  mutable std::mutex lock_;
+  // The most recently used goes first
+  std::list<Entry> lru_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+}  // namespace opt
+}  // namespace nebula
+
+#endif  // GRAPH_OPTIMIZER_CARDINALITYFEEDBACK_H_
@@ -0,0 +1,101 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/optimizer/CostModel.h"
+
+#include "common/utils/IndexStatsUtils.h"
+#include "graph/optimizer/CardinalityFeedback.h"
+
+using nebula::storage::cpp2::IndexColumnHint;
+using nebula::storage::cpp2::ScanType;
+
+namespace nebula {
+namespace opt {
+
+StatusOr<double> CostModel::estimateIndexScanRows(
+    const meta::cpp2::IndexItem& index, const std::vector<IndexColumnHint>& hints) const {
+  const auto& indexStats = *stats_->index_stats_ref();
+  auto iter = indexStats.find(index.get_index_id());
+  if (iter == indexStats.end()) {
+    return Status::Error("No stats of index %s", index.get_index_name().c_str());
+  }
+  const auto& stats = iter->second;
+  const auto& fields = index.get_fields();
+
+  double rows = stats.get_entries();
+  for (size_t i = 0; i < hints.size(); ++i) {
+    const auto& hint = hints[i];
+    bool isLeading =
+        i == 0 && !fields.empty() && fields.front().get_name() == hint.get_column_name();
+    if (hint.get_scan_type() == ScanType::PREFIX) {
+      if (isLeading && stats.get_leading_ndv() > 0) {
+        rows /= stats.get_leading_ndv();
+      } else {
+        rows *= kDefaultEqualSelectivity;
+      }
+    } else {
+      rows *= isLeading ? rangeSelectivity(stats, fields.front(), hint) : kDefaultRangeSelectivity;
+    }
+  }
+  auto key = CardinalityFeedback::indexScanKey(index.get_index_id(), hints);
+  return CardinalityFeedback::instance().correct(key, rows);
+}
+
+StatusOr<double> CostModel::estimateIndexScanRows(
+    const storage::cpp2::IndexQueryContext& ictx,
+    const std::vector<std::shared_ptr<meta::cpp2::IndexItem>>& indexItems) const {
+  for (const auto& index : indexItems) {
+    if (index->get_index_id() == ictx.get_index_id()) {
+      return estimateIndexScanRows(*index, ictx.get_column_hints());
+    }
+  }
+  return Status::Error("Index %d not found", ictx.get_index_id());
+}
+
+StatusOr<int64_t> CostModel::leadingNdv(const meta::cpp2::IndexItem& index) const {
+  const auto& indexStats = *stats_->index_stats_ref();
+  auto iter = indexStats.find(index.get_index_id());
+  if (iter == indexStats.end() || iter->second.get_leading_ndv() <= 0) {
+    return Status::Error("No stats of index %s", index.get_index_name().c_str());
+  }
+  return iter->second.get_leading_ndv();
+}
+
+// static
+double CostModel::rangeSelectivity(const meta::cpp2::IndexStats& stats,
+                                   const meta::cpp2::ColumnDef& field,
+                                   const IndexColumnHint& hint) {
+  const auto& bounds = stats.get_leading_bounds();
+  auto len = IndexStatsUtils::fieldLength(field);
+  if (bounds.empty() || len == 0) {
+    return kDefaultRangeSelectivity;
+  }
+  auto type = IndexKeyUtils::toValueType(field.get_type().get_type());
+  const auto& beginValue = hint.get_begin_value();
+  const auto& endValue = hint.get_end_value();
+  if ((!beginValue.empty() && beginValue.type() != type) ||
+      (!endValue.empty() && endValue.type() != type)) {
+    return kDefaultRangeSelectivity;
+  }
+
+  // The encoded index values keep the order of the original values, so the bounds falling in
+  // the range approximate the proportion of entries in it.
+  auto begin = bounds.begin();
+  auto end = bounds.end();
+  if (!beginValue.empty()) {
+    auto str = IndexKeyUtils::encodeValue(beginValue, len);
+    begin = std::lower_bound(bounds.begin(), bounds.end(), str);
+  }
+  if (!endValue.empty()) {
+    auto str = IndexKeyUtils::encodeValue(endValue, len);
+    end = std::upper_bound(bounds.begin(), bounds.end(), str);
+  }
+  auto count = begin < end ? std::distance(begin, end) : 0;
+  // Each bound stands for a bucket, and count the partial bucket at the edge as a half
+  return std::min(1.0, (count + 0.5) / bounds.size());
+}
+
+}  // namespace opt
+}  // namespace nebula
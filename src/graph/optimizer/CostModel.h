@@ -0,0 +1,62 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_OPTIMIZER_COSTMODEL_H_
+#define GRAPH_OPTIMIZER_COSTMODEL_H_
+
+#include "common/base/StatusOr.h"
+#include "interface/gen-cpp2/meta_types.h"
+#include "interface/gen-cpp2/storage_types.h"
+
+namespace nebula {
+namespace opt {
+
+// Estimate the cardinality of plan nodes from the stats collected by the stats job.
+//
+// For an index scan, the selectivity of the first index field is computed from its number of
+// distinct values (equal) or its equi-depth histogram (range). The following fields are assumed
+// to be independent of each other and use the default selectivities since no stats are kept
+// for them.
+//
+// The estimates are corrected by the rows returned by the same index scans before, see
+// CardinalityFeedback.
+class CostModel final {
+ public:
+  static constexpr double kDefaultEqualSelectivity = 0.1;
+  static constexpr double kDefaultRangeSelectivity = 1.0 / 3;
+  // Reading the base data of an index entry to evaluate the filter costs about the same as
+  // scanning the index entries of this many
+  static constexpr double kBaseReadCost = 4.0;
+
+  explicit CostModel(std::shared_ptr<const meta::cpp2::StatsItem> stats)
+      : stats_(std::move(stats)) {}
+
+  // Estimate the number of rows returned by scanning the index with the column hints, fails if
+  // there are no stats of the index
+  StatusOr<double> estimateIndexScanRows(
+      const meta::cpp2::IndexItem& index,
+      const std::vector<storage::cpp2::IndexColumnHint>& hints) const;
+
+  // The same as above, the index is looked up from the `indexItems' by id
+  StatusOr<double> estimateIndexScanRows(
+      const storage::cpp2::IndexQueryContext& ictx,
+      const std::vector<std::shared_ptr<meta::cpp2::IndexItem>>& indexItems) const;
+
+  // The number of distinct values of the first field of the index, fails if there are no stats
+  // of the index
+  StatusOr<int64_t> leadingNdv(const meta::cpp2::IndexItem& index) const;
+
+ private:
+  static double rangeSelectivity(const meta::cpp2::IndexStats& stats,
+                                 const meta::cpp2::ColumnDef& field,
+                                 const storage::cpp2::IndexColumnHint& hint);
+
+  std::shared_ptr<const meta::cpp2::StatsItem> stats_;
+};
+
+}  // namespace opt
+}  // namespace nebula
+
+#endif  // GRAPH_OPTIMIZER_COSTMODEL_H_
@@ -7,14 +7,23 @@
 
 #include "common/base/Logging.h"
 #include "common/base/ObjectPool.h"
+#include "graph/context/QueryContext.h"
+#include "graph/optimizer/CostModel.h"
 #include "graph/optimizer/OptGroup.h"
 #include "graph/planner/Planner.h"
+#include "graph/planner/plan/PlanNode.h"
+
+DECLARE_bool(enable_optimizer_stats);
 
 namespace nebula {
 namespace opt {
 
 OptContext::OptContext(graph::QueryContext *qctx)
-    : qctx_(DCHECK_NOTNULL(qctx)), objPool_(std::make_unique<ObjectPool>()) {}
+    : qctx_(DCHECK_NOTNULL(qctx)),
+      objPool_(std::make_unique<ObjectPool>()),
+      costFunc_([](const graph::PlanNode *node) { return node->cost(); }) {}
+
+OptContext::~OptContext() = default;
 
 void OptContext::addPlanNodeAndOptGroupNode(int64_t planNodeId, const OptGroupNode *optGroupNode) {
   auto pair = planNodeToOptGroupNodeMap_.emplace(planNodeId, optGroupNode);
@@ -29,5 +38,21 @@ const OptGroupNode *OptContext::findOptGroupNodeByPlanNodeId(int64_t planNodeId)
   return found == planNodeToOptGroupNodeMap_.end() ? nullptr : found->second;
 }
 
+const CostModel *OptContext::costModel(GraphSpaceID space) {
+  if (!FLAGS_enable_optimizer_stats) {
+    return nullptr;
+  }
+  auto iter = costModels_.find(space);
+  if (iter == costModels_.end()) {
+    std::unique_ptr<CostModel> costModel;
+    auto stats = qctx_->getMetaClient()->getStatsFromCache(space);
+    if (stats.ok()) {
+      costModel = std::make_unique<CostModel>(std::move(stats).value());
+    }
+    iter = costModels_.emplace(space, std::move(costModel)).first;
+  }
+  return iter->second.get();
+}
+
 }  // namespace opt
 }  // namespace nebula
@@ -7,26 +7,34 @@
 #define GRAPH_OPTIMIZER_OPTCONTEXT_H_
 
 #include <boost/core/noncopyable.hpp>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 
 #include "common/cpp/helpers.h"
+#include "common/thrift/ThriftTypes.h"
 
 namespace nebula {
 
 class ObjectPool;
 
 namespace graph {
+class PlanNode;
 class QueryContext;
 }  // namespace graph
 
 namespace opt {
 
+class CostModel;
 class OptGroupNode;
 
 class OptContext final : private boost::noncopyable, private cpp::NonMovable {
  public:
+  // Return the cost of the plan node itself, excluding its dependencies
+  using CostFunc = std::function<double(const graph::PlanNode *)>;
+
   explicit OptContext(graph::QueryContext *qctx);
+  ~OptContext();
 
   graph::QueryContext *qctx() const {
     return qctx_;
@@ -47,6 +55,28 @@ class OptContext final : private boost::noncopyable, private cpp::NonMovable {
   void addPlanNodeAndOptGroupNode(int64_t planNodeId, const OptGroupNode *optGroupNode);
   const OptGroupNode *findOptGroupNodeByPlanNodeId(int64_t planNodeId) const;
 
+  // Return nullptr if no stats of the space are available for the cost based optimization
+  const CostModel *costModel(GraphSpaceID space);
+
+  const CostFunc &costFunc() const {
+    return costFunc_;
+  }
+
+  // Replace the default cost function which uses the estimated cost of plan node
+  void setCostFunc(CostFunc costFunc) {
+    costFunc_ = std::move(costFunc);
+    invalidateCosts();
+  }
+
+  // The costs are cached in the memo until it or the plan nodes in it are changed
+  int64_t costVersion() const {
+    return costVersion_;
+  }
+
+  void invalidateCosts() {
+    ++costVersion_;
+  }
+
  private:
   // A global flag to record whether this iteration caused a change to the plan
   bool changed_{true};
@@ -54,6 +84,10 @@ class OptContext final : private boost::noncopyable, private cpp::NonMovable {
   // Memo memory management in the Optimizer phase
   std::unique_ptr<ObjectPool> objPool_;
   std::unordered_map<int64_t, const OptGroupNode *> planNodeToOptGroupNodeMap_;
+  CostFunc costFunc_;
+  int64_t costVersion_{0};
+  // Cost model of each space, created on demand
+  std::unordered_map<GraphSpaceID, std::unique_ptr<CostModel>> costModels_;
 };
 
 }  // namespace opt
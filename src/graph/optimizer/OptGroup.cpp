@@ -20,6 +20,8 @@ using nebula::graph::QueryContext;
 using nebula::graph::Select;
 using nebula::graph::SingleDependencyNode;
 
+DECLARE_bool(enable_optimizer_exploration);
+
 namespace nebula {
 namespace opt {
 
@@ -51,6 +53,7 @@ void OptGroup::addGroupNode(OptGroupNode *groupNode) {
   }
   groupNodes_.emplace_back(groupNode);
   groupNode->node()->updateSymbols();
+  ctx_->invalidateCosts();
 }
 
 OptGroupNode *OptGroup::makeGroupNode(PlanNode *node) {
@@ -60,6 +63,7 @@ OptGroupNode *OptGroup::makeGroupNode(PlanNode *node) {
     DCHECK_EQ(outputVar_, node->outputVar());
   }
   groupNodes_.emplace_back(OptGroupNode::create(ctx_, node, this));
+  ctx_->invalidateCosts();
   return groupNodes_.back();
 }
 
@@ -79,6 +83,12 @@ Status OptGroup::explore(const OptRule *rule) {
     // Bottom to up exploration
     NG_RETURN_IF_ERROR(groupNode->explore(rule));
 
+    // The alternatives of this node have been generated by the rule
+    if (groupNode->isTransformed(rule)) {
+      ++iter;
+      continue;
+    }
+
     // Find more equivalents
     std::vector<OptGroup *> boundary;
     auto status = rule->match(ctx_, groupNode);
@@ -87,6 +97,8 @@ Status OptGroup::explore(const OptRule *rule) {
       continue;
     }
     ctx_->setChanged(true);
+    // The rule may change the plan nodes in place
+    ctx_->invalidateCosts();
     auto matched = std::move(status).value();
     matched.collectBoundary(boundary);
     auto resStatus = rule->transform(ctx_, matched);
@@ -114,7 +126,11 @@ Status OptGroup::explore(const OptRule *rule) {
       setUnexplored(rule);
     }
 
-    if (result.eraseCurr) {
+    if (result.eraseCurr && FLAGS_enable_optimizer_exploration && !result.newGroupNodes.empty()) {
+      // Keep the original node as an alternative and choose among them by cost later
+      groupNode->setTransformed(rule);
+      ++iter;
+    } else if (result.eraseCurr) {
       (*iter)->node()->releaseSymbols();
       iter = groupNodes_.erase(iter);
     } else {
@@ -138,16 +154,24 @@ Status OptGroup::exploreUntilMaxRound(const OptRule *rule) {
 }
 
 std::pair<double, const OptGroupNode *> OptGroup::findMinCostGroupNode() const {
+  auto version = ctx_->costVersion();
+  if (minCostVersion_ == version) {
+    return minCost_;
+  }
   double minCost = std::numeric_limits<double>::max();
   const OptGroupNode *minGroupNode = nullptr;
   for (auto &groupNode : groupNodes_) {
     double cost = groupNode->getCost();
-    if (minCost > cost) {
+    // Prefer the rewritten result to the original node of the same cost
+    if (minGroupNode == nullptr || minCost > cost ||
+        (minCost == cost && minGroupNode->isTransformed())) {
       minCost = cost;
       minGroupNode = groupNode;
     }
   }
-  return std::make_pair(minCost, minGroupNode);
+  minCost_ = std::make_pair(minCost, minGroupNode);
+  minCostVersion_ = version;
+  return minCost_;
 }
 
 double OptGroup::getCost() const {
@@ -160,6 +184,34 @@ const PlanNode *OptGroup::getPlan() const {
   return minGroupNode->getPlan();
 }
 
+void OptGroup::collectRejectedAlternatives(
+    std::unordered_map<int64_t, std::vector<std::string>> *alternatives) const {
+  const OptGroupNode *minGroupNode = findMinCostGroupNode().second;
+  DCHECK(minGroupNode != nullptr);
+  auto chosenId = minGroupNode->node()->id();
+  if (alternatives->find(chosenId) != alternatives->end()) {
+    // Visited
+    return;
+  }
+  auto &rejected = (*alternatives)[chosenId];
+  for (auto groupNode : groupNodes_) {
+    if (groupNode == minGroupNode) {
+      continue;
+    }
+    auto node = groupNode->node();
+    rejected.emplace_back(folly::stringPrintf("%s_%ld(cost: %f)",
+                                              PlanNode::toString(node->kind()),
+                                              node->id(),
+                                              groupNode->getCost()));
+  }
+  for (auto dep : minGroupNode->dependencies()) {
+    dep->collectRejectedAlternatives(alternatives);
+  }
+  for (auto body : minGroupNode->bodies()) {
+    body->collectRejectedAlternatives(alternatives);
+  }
+}
+
 OptGroupNode *OptGroupNode::create(OptContext *ctx, PlanNode *node, const OptGroup *group) {
   auto optGNode = ctx->objPool()->makeAndAdd<OptGroupNode>(node, group);
   ctx->addPlanNodeAndOptGroupNode(node->id(), optGNode);
@@ -204,7 +256,22 @@ Status OptGroupNode::explore(const OptRule *rule) {
 }
 
 double OptGroupNode::getCost() const {
-  return node_->cost();
+  auto *ctx = group_->ctx();
+  if (costVersion_ == ctx->costVersion()) {
+    return cost_;
+  }
+  // The cost of the whole subtree rooted at this node, so that the alternatives in a group are
+  // compared by their total cost rather than the cost of the root node alone
+  double cost = ctx->costFunc()(node_);
+  for (auto dep : dependencies_) {
+    cost += dep->getCost();
+  }
+  for (auto body : bodies_) {
+    cost += body->getCost();
+  }
+  cost_ = cost;
+  costVersion_ = ctx->costVersion();
+  return cost;
 }
 
 const PlanNode *OptGroupNode::getPlan() const {
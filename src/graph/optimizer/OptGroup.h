@@ -48,6 +48,15 @@ class OptGroup final {
     return outputVar_;
   }
 
+  OptContext *ctx() const {
+    return ctx_;
+  }
+
+  // Describe the group nodes not chosen by cost in the subtree of the best plan,
+  // key is the id of the chosen plan node.
+  void collectRejectedAlternatives(
+      std::unordered_map<int64_t, std::vector<std::string>> *alternatives) const;
+
  private:
   friend ObjectPool;
   explicit OptGroup(OptContext *ctx) noexcept;
@@ -58,6 +67,9 @@ class OptGroup final {
 
   OptContext *ctx_{nullptr};
   std::list<OptGroupNode *> groupNodes_;
+  // The cheapest group node cached for the cost version of the context
+  mutable int64_t minCostVersion_{-1};
+  mutable std::pair<double, const OptGroupNode *> minCost_{0.0, nullptr};
   std::vector<const OptRule *> exploredRules_;
   // The output variable should be same across the whole group.
   std::string outputVar_;
@@ -97,6 +109,21 @@ class OptGroupNode final {
 
   void setUnexplored(const OptRule *rule);
 
+  // Whether the node has been rewritten to equivalent alternatives by the rule, the rule won't
+  // be applied to it again
+  bool isTransformed(const OptRule *rule) const {
+    return std::find(transformedRules_.cbegin(), transformedRules_.cend(), rule) !=
+           transformedRules_.cend();
+  }
+
+  void setTransformed(const OptRule *rule) {
+    transformedRules_.emplace_back(rule);
+  }
+
+  bool isTransformed() const {
+    return !transformedRules_.empty();
+  }
+
   const OptGroup *group() const {
     return group_;
   }
@@ -118,6 +145,12 @@ class OptGroupNode final {
   std::vector<OptGroup *> dependencies_;
   std::vector<OptGroup *> bodies_;
   std::vector<const OptRule *> exploredRules_;
+  // The rules which have rewritten this node while it's kept as an alternative
+  std::vector<const OptRule *> transformedRules_;
+  // The cost cached for the cost version of the context, since the groups are shared by the
+  // group nodes depending on them
+  mutable int64_t costVersion_{-1};
+  mutable double cost_{0.0};
 };
 
 }  // namespace opt
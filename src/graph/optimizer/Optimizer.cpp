@@ -22,6 +22,10 @@ using nebula::graph::Select;
 using nebula::graph::SingleDependencyNode;
 
 DEFINE_bool(enable_optimizer_property_pruner_rule, true, "");
+DEFINE_bool(enable_optimizer_exploration,
+            false,
+            "Keep the original plan nodes as alternatives when rules rewrite them, and choose the "
+            "cheapest plan by cost");
 
 namespace nebula {
 namespace opt {
@@ -42,6 +46,15 @@ StatusOr<const PlanNode *> Optimizer::findBestPlan(QueryContext *qctx) {
 
   NG_RETURN_IF_ERROR(doExploration(optCtx.get(), rootGroup));
   auto *newRoot = rootGroup->getPlan();
+  if (FLAGS_enable_optimizer_exploration) {
+    std::unordered_map<int64_t, std::vector<std::string>> alternatives;
+    rootGroup->collectRejectedAlternatives(&alternatives);
+    for (auto &alt : alternatives) {
+      if (!alt.second.empty()) {
+        qctx->plan()->addRejectedAlternatives(alt.first, std::move(alt.second));
+      }
+    }
+  }
 
   auto status2 = postprocess(const_cast<PlanNode *>(newRoot), qctx, spaceID);
   if (!status2.ok()) {
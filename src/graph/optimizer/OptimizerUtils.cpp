@@ -7,6 +7,7 @@
 
 #include "common/base/Status.h"
 #include "common/datatypes/Value.h"
+#include "graph/optimizer/CostModel.h"
 #include "graph/planner/plan/Query.h"
 
 using nebula::meta::cpp2::ColumnDef;
@@ -16,6 +17,9 @@ using nebula::storage::cpp2::IndexQueryContext;
 
 using ExprKind = nebula::Expression::Kind;
 
+DECLARE_int64(max_skip_scan_leading_ndv);
+DECLARE_bool(enable_index_intersection);
+
 namespace nebula {
 namespace graph {
 namespace {
@@ -311,6 +315,102 @@ StatusOr<IndexResult> selectIndex(const Expression* expr, const IndexItem& index
   return Status::Error("Invalid expression kind.");
 }
 
+// Generate the index query context from the index result, return false if it's not worth to
+// scan the index
+bool toIndexQueryContext(const Expression* condition,
+                         const IndexResult& index,
+                         bool* isPrefixScan,
+                         IndexQueryContext* ictx) {
+  if (index.hints.empty()) {
+    return false;
+  }
+
+  *isPrefixScan = false;
+  std::vector<storage::cpp2::IndexColumnHint> hints;
+  hints.reserve(index.hints.size());
+  auto iter = index.hints.begin();
+
+  // Use full scan if the highest index score is NotEqual
+  if (iter->score == IndexScore::kNotEqual) {
+    return false;
+  }
+
+  for (; iter != index.hints.end(); ++iter) {
+    auto& hint = *iter;
+    if (hint.score == IndexScore::kPrefix) {
+      hints.emplace_back(hint.hint);
+      *isPrefixScan = true;
+      continue;
+    }
+    if (hint.score == IndexScore::kRange) {
+      hints.emplace_back(hint.hint);
+      // skip the case first range hint is the last hint
+      // when set filter in index query context
+      ++iter;
+    }
+    break;
+  }
+  // The filter can always be pushed down for lookup query
+  if (iter != index.hints.end() || !index.unusedExprs.empty()) {
+    ictx->filter_ref() = condition->encode();
+  }
+  ictx->index_id_ref() = index.index->get_index_id();
+  ictx->column_hints_ref() = std::move(hints);
+  return true;
+}
+
+// Whether all the hints of the index result are scanned, so the context of it needs the filter
+// only for the unused expressions
+bool allHintsScanned(const IndexResult& index) {
+  for (size_t i = 0; i < index.hints.size(); ++i) {
+    if (index.hints[i].score != IndexScore::kPrefix) {
+      return index.hints[i].score == IndexScore::kRange && i + 1 == index.hints.size();
+    }
+  }
+  return !index.hints.empty();
+}
+
+// Generate the context to scan the index for each value of its first field, which has no hint in
+// the condition but a few distinct values, by the hints on the following fields. The cost counts
+// a seek for each value of the first field.
+bool toSkipScanContext(const Expression* condition,
+                       const IndexItem& index,
+                       const opt::CostModel& costModel,
+                       bool* isPrefixScan,
+                       IndexQueryContext* ictx,
+                       double* rows,
+                       double* cost) {
+  const auto& fields = index.get_fields();
+  if (FLAGS_max_skip_scan_leading_ndv <= 0 || fields.size() < 2) {
+    return false;
+  }
+  // The values of the first field must be decoded from the index keys exactly
+  const auto& leading = fields.front();
+  auto type = leading.get_type().get_type();
+  if (leading.nullable_ref().value_or(false) || type == nebula::cpp2::PropertyType::STRING ||
+      type == nebula::cpp2::PropertyType::GEOGRAPHY) {
+    return false;
+  }
+  auto ndv = costModel.leadingNdv(index);
+  if (!ndv.ok() || ndv.value() > FLAGS_max_skip_scan_leading_ndv) {
+    return false;
+  }
+  IndexItem rest = index;
+  rest.fields_ref()->erase(rest.fields_ref()->begin());
+  auto result = selectIndex(condition, rest);
+  if (!result.ok() || !toIndexQueryContext(condition, result.value(), isPrefixScan, ictx)) {
+    return false;
+  }
+  auto estimated = costModel.estimateIndexScanRows(index, ictx->get_column_hints());
+  if (!estimated.ok()) {
+    return false;
+  }
+  ictx->skip_scan_ref() = true;
+  *rows = estimated.value();
+  *cost = *rows + ndv.value();
+  return true;
+}
+
 }  // namespace
 
 void OptimizerUtils::eraseInvalidIndexItems(
@@ -331,7 +431,9 @@ void OptimizerUtils::eraseInvalidIndexItems(
 bool OptimizerUtils::findOptimalIndex(const Expression* condition,
                                       const std::vector<std::shared_ptr<IndexItem>>& indexItems,
                                       bool* isPrefixScan,
-                                      IndexQueryContext* ictx) {
+                                      IndexQueryContext* ictx,
+                                      const opt::CostModel* costModel,
+                                      double* estimatedRows) {
   // Return directly if there is no valid index to use.
   if (indexItems.empty()) {
     return false;
@@ -345,48 +447,143 @@ bool OptimizerUtils::findOptimalIndex(const Expression* condition,
     }
   }
 
+  std::sort(results.begin(), results.end());
+
+  if (costModel != nullptr) {
+    // Choose the index returning the fewest rows when all candidates have stats, the score
+    // doesn't know how selective the index fields are.
+    bool hasStats = true;
+    double minRows = std::numeric_limits<double>::max();
+    IndexQueryContext bestCtx;
+    bool bestIsPrefix = false;
+    for (auto iter = results.rbegin(); iter != results.rend(); ++iter) {
+      IndexQueryContext candidate;
+      bool isPrefix = false;
+      if (!toIndexQueryContext(condition, *iter, &isPrefix, &candidate)) {
+        continue;
+      }
+      auto rows = costModel->estimateIndexScanRows(*iter->index, candidate.get_column_hints());
+      if (!rows.ok()) {
+        hasStats = false;
+        break;
+      }
+      if (rows.value() < minRows) {
+        minRows = rows.value();
+        bestCtx = std::move(candidate);
+        bestIsPrefix = isPrefix;
+      }
+    }
+    // The indexes without any hint on their first fields could be scanned by skip scan
+    double minCost = minRows;
+    for (auto& index : indexItems) {
+      if (!hasStats || std::any_of(results.begin(), results.end(), [&index](const auto& result) {
+            return result.index == index.get();
+          })) {
+        continue;
+      }
+      IndexQueryContext candidate;
+      bool isPrefix = false;
+      double rows = 0, cost = 0;
+      if (toSkipScanContext(
+              condition, *index, *costModel, &isPrefix, &candidate, &rows, &cost) &&
+          cost < minCost) {
+        minCost = cost;
+        minRows = rows;
+        bestCtx = std::move(candidate);
+        bestIsPrefix = isPrefix;
+      }
+    }
+    if (hasStats && minRows != std::numeric_limits<double>::max()) {
+      *isPrefixScan = bestIsPrefix;
+      *ictx = std::move(bestCtx);
+      if (estimatedRows != nullptr) {
+        *estimatedRows = minRows;
+      }
+      return true;
+    }
+  }
+
   if (results.empty()) {
     return false;
   }
-
-  std::sort(results.begin(), results.end());
-
-  auto& index = results.back();
-  if (index.hints.empty()) {
+  if (!toIndexQueryContext(condition, results.back(), isPrefixScan, ictx)) {
     return false;
   }
+  if (costModel != nullptr && estimatedRows != nullptr) {
+    auto rows = costModel->estimateIndexScanRows(*results.back().index, ictx->get_column_hints());
+    if (rows.ok()) {
+      *estimatedRows = rows.value();
+    }
+  }
+  return true;
+}
 
-  *isPrefixScan = false;
-  std::vector<storage::cpp2::IndexColumnHint> hints;
-  hints.reserve(index.hints.size());
-  auto iter = index.hints.begin();
-
-  // Use full scan if the highest index score is NotEqual
-  if (iter->score == IndexScore::kNotEqual) {
+bool OptimizerUtils::findIndexIntersection(
+    const Expression* condition,
+    const std::vector<std::shared_ptr<IndexItem>>& indexItems,
+    const opt::CostModel* costModel,
+    const IndexQueryContext& single,
+    double singleRows,
+    std::vector<IndexQueryContext>* ictxs,
+    double* estimatedRows) {
+  if (!FLAGS_enable_index_intersection || costModel == nullptr || singleRows < 0 ||
+      condition->kind() != ExprKind::kLogicalAnd || single.get_filter().empty()) {
     return false;
   }
-
-  for (; iter != index.hints.end(); ++iter) {
-    auto& hint = *iter;
-    if (hint.score == IndexScore::kPrefix) {
-      hints.emplace_back(std::move(hint.hint));
-      *isPrefixScan = true;
+  struct Candidate {
+    IndexResult result;
+    IndexQueryContext ictx;
+    double rows;
+  };
+  std::vector<Candidate> candidates;
+  for (auto& index : indexItems) {
+    auto resStatus = selectIndex(condition, *index);
+    if (!resStatus.ok() || !allHintsScanned(resStatus.value())) {
       continue;
     }
-    if (hint.score == IndexScore::kRange) {
-      hints.emplace_back(std::move(hint.hint));
-      // skip the case first range hint is the last hint
-      // when set filter in index query context
-      ++iter;
+    Candidate candidate;
+    candidate.result = std::move(resStatus).value();
+    bool isPrefix = false;
+    if (!toIndexQueryContext(condition, candidate.result, &isPrefix, &candidate.ictx)) {
+      continue;
     }
-    break;
+    auto rows = costModel->estimateIndexScanRows(*index, candidate.ictx.get_column_hints());
+    if (!rows.ok()) {
+      continue;
+    }
+    // The expressions unused by one index are answered by the other one
+    candidate.ictx.filter_ref() = "";
+    candidate.rows = rows.value();
+    candidates.emplace_back(std::move(candidate));
   }
-  // The filter can always be pushed down for lookup query
-  if (iter != index.hints.end() || !index.unusedExprs.empty()) {
-    ictx->filter_ref() = condition->encode();
+
+  // The single index scan reads the base data of its rows to evaluate the filter
+  double minCost = singleRows * (1 + opt::CostModel::kBaseReadCost);
+  const Candidate* first = nullptr;
+  const Candidate* second = nullptr;
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    for (size_t j = i + 1; j < candidates.size(); ++j) {
+      const auto& a = candidates[i];
+      const auto& b = candidates[j];
+      if (std::any_of(a.result.unusedExprs.begin(), a.result.unusedExprs.end(), [&b](auto expr) {
+            const auto& unused = b.result.unusedExprs;
+            return std::find(unused.begin(), unused.end(), expr) != unused.end();
+          })) {
+        continue;
+      }
+      if (a.rows + b.rows < minCost) {
+        minCost = a.rows + b.rows;
+        first = &a;
+        second = &b;
+      }
+    }
   }
-  ictx->index_id_ref() = index.index->get_index_id();
-  ictx->column_hints_ref() = std::move(hints);
+  if (first == nullptr) {
+    return false;
+  }
+  // The rows of the smaller scan bound the ones of the intersection
+  *estimatedRows = std::min(first->rows, second->rows);
+  *ictxs = {first->ictx, second->ictx};
   return true;
 }
 
@@ -429,6 +626,10 @@ void OptimizerUtils::copyIndexScanData(const nebula::graph::IndexScan* from,
   to->setLimit(from->limit(qctx));
   to->setFilter(from->filter() == nullptr ? nullptr : from->filter()->clone());
   to->setYieldColumns(from->yieldColumns());
+  to->setIntersect(from->intersect());
+  if (!from->vidFilterVar().empty()) {
+    to->setVidFilter(from->vidFilterVar(), from->vidFilterKey());
+  }
 }
 
 Status OptimizerUtils::compareAndSwapBound(std::pair<Value, bool>& a, std::pair<Value, bool>& b) {
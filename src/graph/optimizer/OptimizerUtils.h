@@ -24,6 +24,10 @@ class IndexQueryContext;
 }  // namespace cpp2
 }  // namespace storage
 
+namespace opt {
+class CostModel;
+}  // namespace opt
+
 namespace graph {
 
 class IndexScan;
@@ -63,11 +67,33 @@ class OptimizerUtils {
   // For logical `OR' condition expression, use above steps to generate
   // different `IndexQueryContext' for each operand of filter condition, nebula
   // storage will union all results of multiple index contexts
+  //
+  // If the cost model is given and all candidate indexes have stats, the index with the fewest
+  // estimated rows is selected instead of the largest score one, and the estimated rows are
+  // returned by `estimatedRows'. An index without any hint on its first field is a candidate
+  // too, which is scanned for each value of the first field by skip scan if there are no more
+  // than `--max_skip_scan_leading_ndv' values.
   static bool findOptimalIndex(
       const Expression* condition,
       const std::vector<std::shared_ptr<nebula::meta::cpp2::IndexItem>>& indexItems,
       bool* isPrefixScan,
-      nebula::storage::cpp2::IndexQueryContext* ictx);
+      nebula::storage::cpp2::IndexQueryContext* ictx,
+      const opt::CostModel* costModel = nullptr,
+      double* estimatedRows = nullptr);
+
+  // For the logical `AND' condition, find the two indexes whose scans are intersected by storage
+  // to answer the condition without any filter, e.g. `a == 1 AND b == 2' by the index of `a' and
+  // the index of `b'. It's used only if reading both of them is estimated cheaper than the
+  // `single' context of `singleRows' rows found by `findOptimalIndex', whose filter reads the
+  // base data of each row.
+  static bool findIndexIntersection(
+      const Expression* condition,
+      const std::vector<std::shared_ptr<nebula::meta::cpp2::IndexItem>>& indexItems,
+      const opt::CostModel* costModel,
+      const nebula::storage::cpp2::IndexQueryContext& single,
+      double singleRows,
+      std::vector<nebula::storage::cpp2::IndexQueryContext>* ictxs,
+      double* estimatedRows);
 
   static bool relExprHasIndex(
       const Expression* expr,
@@ -32,6 +32,22 @@ const Pattern& CollapseProjectRule::pattern() const {
   return pattern;
 }
 
+// The path built below is cheap to evaluate more than once, if only the length or the end nodes
+// of it are used above
+static bool onlyPathEndsOrLength(const Expression* colExpr,
+                                 const std::string& colName,
+                                 const std::vector<YieldColumn*>& colsAbove) {
+  if (colExpr->kind() != Expression::Kind::kPathBuild) {
+    return false;
+  }
+  for (auto* col : colsAbove) {
+    if (!graph::ExpressionUtils::onlyPathEndsOrLength(col->expr(), colName)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 StatusOr<OptRule::TransformResult> CollapseProjectRule::transform(
     OptContext* octx, const MatchedResult& matched) const {
   const auto* groupNodeAbove = matched.node;
@@ -81,7 +97,8 @@ StatusOr<OptRule::TransformResult> CollapseProjectRule::transform(
       auto colExpr = colsBelow[i]->expr();
       // disable this case to avoid the expression in ProjBelow being eval multiple
       // times
-      if (!graph::ExpressionUtils::isPropertyExpr(colExpr) && multiRefColNames.count(colNames[i])) {
+      if (!graph::ExpressionUtils::isPropertyExpr(colExpr) && multiRefColNames.count(colNames[i]) &&
+          !onlyPathEndsOrLength(colExpr, colNames[i], colsAbove)) {
         return TransformResult::noTransform();
       }
       rewriteMap[colNames[i]] = colExpr;
@@ -105,7 +122,8 @@ StatusOr<OptRule::TransformResult> CollapseProjectRule::transform(
   };
   for (auto col : colsAbove) {
     auto* newColExpr = graph::RewriteVisitor::transform(col->expr(), matcher, rewriter);
-    col->setExpr(newColExpr);
+    // The length and the end nodes of the paths are evaluated without building them
+    col->setExpr(graph::ExpressionUtils::rewritePathFunctions(newColExpr));
   }
 
   // 4. rebuild OptGroupNode
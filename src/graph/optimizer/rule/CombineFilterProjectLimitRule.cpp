@@ -0,0 +1,86 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/optimizer/rule/CombineFilterProjectLimitRule.h"
+
+#include "graph/optimizer/OptContext.h"
+#include "graph/optimizer/OptGroup.h"
+#include "graph/planner/plan/PlanNode.h"
+#include "graph/planner/plan/Query.h"
+#include "graph/util/ExpressionUtils.h"
+
+DEFINE_bool(enable_optimizer_combine_filter_project_limit_rule, true, "");
+
+using nebula::graph::Filter;
+using nebula::graph::FilterProjectLimit;
+using nebula::graph::Limit;
+using nebula::graph::PlanNode;
+using nebula::graph::Project;
+using nebula::graph::QueryContext;
+
+namespace nebula {
+namespace opt {
+
+std::unique_ptr<OptRule> CombineFilterProjectLimitRule::kInstance =
+    std::unique_ptr<CombineFilterProjectLimitRule>(new CombineFilterProjectLimitRule());
+
+CombineFilterProjectLimitRule::CombineFilterProjectLimitRule() {
+  RuleSet::QueryRules().addRule(this);
+}
+
+const Pattern &CombineFilterProjectLimitRule::pattern() const {
+  static Pattern pattern = Pattern::create(
+      PlanNode::Kind::kProject,
+      {Pattern::create(PlanNode::Kind::kLimit, {Pattern::create(PlanNode::Kind::kFilter)})});
+  return pattern;
+}
+
+StatusOr<OptRule::TransformResult> CombineFilterProjectLimitRule::transform(
+    OptContext *octx, const MatchedResult &matched) const {
+  auto *qctx = octx->qctx();
+  const auto *projGroupNode = matched.node;
+  const auto &limitMatched = matched.dependencies.front();
+  const auto *filterGroupNode = limitMatched.dependencies.front().node;
+
+  const auto *project = static_cast<const Project *>(projGroupNode->node());
+  const auto *limit = static_cast<const Limit *>(limitMatched.node->node());
+  const auto *filter = static_cast<const Filter *>(filterGroupNode->node());
+
+  if (!graph::ExpressionUtils::isEvaluableExpr(limit->countExpr())) {
+    return TransformResult::noTransform();
+  }
+  auto offset = std::max<int64_t>(limit->offset(), 0);
+  auto count = limit->count(qctx);
+  if (count < 0) {
+    return TransformResult::noTransform();
+  }
+
+  auto *cols = qctx->objPool()->add(project->columns()->clone().release());
+  auto *fpl =
+      FilterProjectLimit::make(qctx, nullptr, filter->condition()->clone(), cols, offset, count);
+  fpl->setInputVar(filter->inputVar());
+  fpl->setOutputVar(project->outputVar());
+  auto *fplGroupNode = OptGroupNode::create(octx, fpl, projGroupNode->group());
+  fplGroupNode->setDeps(filterGroupNode->dependencies());
+
+  TransformResult result;
+  result.eraseAll = true;
+  result.newGroupNodes.emplace_back(fplGroupNode);
+  return result;
+}
+
+bool CombineFilterProjectLimitRule::match(OptContext *octx, const MatchedResult &matched) const {
+  if (!FLAGS_enable_optimizer_combine_filter_project_limit_rule) {
+    return false;
+  }
+  return OptRule::match(octx, matched);
+}
+
+std::string CombineFilterProjectLimitRule::toString() const {
+  return "CombineFilterProjectLimitRule";
+}
+
+}  // namespace opt
+}  // namespace nebula
@@ -0,0 +1,66 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_OPTIMIZER_RULE_COMBINEFILTERPROJECTLIMITRULE_H_
+#define GRAPH_OPTIMIZER_RULE_COMBINEFILTERPROJECTLIMITRULE_H_
+
+#include "graph/optimizer/OptRule.h"
+
+DECLARE_bool(enable_optimizer_combine_filter_project_limit_rule);
+
+namespace nebula {
+namespace opt {
+
+//  Combines [[Project]], [[Limit]] and [[Filter]] into [[FilterProjectLimit]]
+//  Required conditions:
+//   1. Match the pattern
+//   2. The count of the limit is evaluable
+//  Benefits:
+//   1. Filter, limit and project the records in a single pass over the input, without copying the
+//      records between the nodes
+//
+//  Tranformation:
+//  Before:
+//
+//  +---------+---------+
+//  |      Project      |
+//  +---------+---------+
+//            |
+//  +---------+---------+
+//  |       Limit       |
+//  +---------+---------+
+//            |
+//  +---------+---------+
+//  |       Filter      |
+//  +---------+---------+
+//
+//  After:
+//
+//  +---------+---------+
+//  | FilterProjectLimit|
+//  +---------+---------+
+//
+//  Notice: The Limit above a Project is pushed down by PushLimitDownProjectRule before
+
+class CombineFilterProjectLimitRule final : public OptRule {
+ public:
+  const Pattern &pattern() const override;
+
+  StatusOr<TransformResult> transform(OptContext *ctx, const MatchedResult &matched) const override;
+
+  bool match(OptContext *ctx, const MatchedResult &matched) const override;
+
+  std::string toString() const override;
+
+ private:
+  CombineFilterProjectLimitRule();
+
+  static std::unique_ptr<OptRule> kInstance;
+};
+
+}  // namespace opt
+}  // namespace nebula
+
+#endif  // GRAPH_OPTIMIZER_RULE_COMBINEFILTERPROJECTLIMITRULE_H_
@@ -0,0 +1,168 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/optimizer/rule/EliminateCollectUnwindRule.h"
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "common/expression/AggregateExpression.h"
+#include "common/expression/LogicalExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "common/expression/UnaryExpression.h"
+#include "graph/optimizer/OptContext.h"
+#include "graph/optimizer/OptGroup.h"
+#include "graph/planner/plan/PlanNode.h"
+#include "graph/planner/plan/Query.h"
+#include "graph/util/ExpressionUtils.h"
+
+DEFINE_bool(enable_optimizer_eliminate_collect_unwind_rule, true, "");
+
+using nebula::graph::Aggregate;
+using nebula::graph::Dedup;
+using nebula::graph::Filter;
+using nebula::graph::PlanNode;
+using nebula::graph::Project;
+using nebula::graph::QueryContext;
+using nebula::graph::Unwind;
+
+namespace nebula {
+namespace opt {
+
+std::unique_ptr<OptRule> EliminateCollectUnwindRule::kInstance =
+    std::unique_ptr<EliminateCollectUnwindRule>(new EliminateCollectUnwindRule());
+
+EliminateCollectUnwindRule::EliminateCollectUnwindRule() {
+  RuleSet::QueryRules().addRule(this);
+}
+
+const Pattern &EliminateCollectUnwindRule::pattern() const {
+  static Pattern pattern = Pattern::create(
+      PlanNode::Kind::kProject,
+      {Pattern::create(PlanNode::Kind::kUnwind, {Pattern::create(PlanNode::Kind::kAggregate)})});
+  return pattern;
+}
+
+// Whether the expression refers to the column of the name
+static bool refersTo(const Expression *expr, const std::string &colName) {
+  auto refs = graph::ExpressionUtils::collectAll(
+      expr, {Expression::Kind::kVarProperty, Expression::Kind::kInputProperty});
+  for (const auto *ref : refs) {
+    if (static_cast<const PropertyExpression *>(ref)->prop() == colName) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool EliminateCollectUnwindRule::match(OptContext *octx, const MatchedResult &matched) const {
+  if (!FLAGS_enable_optimizer_eliminate_collect_unwind_rule || !OptRule::match(octx, matched)) {
+    return false;
+  }
+  const auto &unwindMatched = matched.dependencies.front();
+  const auto *project = static_cast<const Project *>(matched.node->node());
+  const auto *unwind = static_cast<const Unwind *>(unwindMatched.node->node());
+  const auto *agg = static_cast<const Aggregate *>(unwindMatched.dependencies.front().node->node());
+
+  if (!agg->groupKeys().empty() || agg->groupItems().size() != 1 || agg->colNames().size() != 1) {
+    return false;
+  }
+  auto *item = agg->groupItems().front();
+  if (item->kind() != Expression::Kind::kAggregate) {
+    return false;
+  }
+  if (!boost::iequals(static_cast<const AggregateExpression *>(item)->name(), "COLLECT")) {
+    return false;
+  }
+
+  // The Unwind unwinds the collected list only, and passes nothing else
+  const auto &listName = agg->colNames().front();
+  const auto &unwindColNames = unwind->colNames();
+  if (unwind->inputVar() != agg->outputVar() || unwindColNames.size() != 2 ||
+      unwindColNames.front() != listName) {
+    return false;
+  }
+  const auto *unwindExpr = unwind->unwindExpr();
+  if (unwindExpr->kind() != Expression::Kind::kVarProperty &&
+      unwindExpr->kind() != Expression::Kind::kInputProperty) {
+    return false;
+  }
+  if (static_cast<const PropertyExpression *>(unwindExpr)->prop() != listName) {
+    return false;
+  }
+
+  // Nobody reads the list after unwinding it
+  for (const auto *col : project->columns()->columns()) {
+    if (refersTo(col->expr(), listName)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+StatusOr<OptRule::TransformResult> EliminateCollectUnwindRule::transform(
+    OptContext *octx, const MatchedResult &matched) const {
+  auto *qctx = octx->qctx();
+  auto *pool = qctx->objPool();
+  const auto *projGroupNode = matched.node;
+  const auto &unwindMatched = matched.dependencies.front();
+  const auto *aggGroupNode = unwindMatched.dependencies.front().node;
+
+  const auto *project = static_cast<const Project *>(projGroupNode->node());
+  const auto *unwind = static_cast<const Unwind *>(unwindMatched.node->node());
+  const auto *agg = static_cast<const Aggregate *>(aggGroupNode->node());
+  auto *collect = static_cast<AggregateExpression *>(agg->groupItems().front());
+  const auto &alias = unwind->colNames().back();
+
+  // Evaluate the argument of collect() for each input row of the Aggregate
+  auto *cols = pool->makeAndAdd<YieldColumns>();
+  cols->addColumn(new YieldColumn(collect->arg()->clone(), alias));
+  auto *newProj = Project::make(qctx, nullptr, cols);
+  newProj->setInputVar(agg->inputVar());
+  newProj->setColNames({alias});
+  auto *newProjGroup = OptGroup::create(octx);
+  auto *newProjGroupNode = newProjGroup->makeGroupNode(newProj);
+  newProjGroupNode->setDeps(aggGroupNode->dependencies());
+
+  auto *notNull = UnaryExpression::makeIsNotNull(pool, InputPropertyExpression::make(pool, alias));
+  auto *notEmpty =
+      UnaryExpression::makeIsNotEmpty(pool, InputPropertyExpression::make(pool, alias));
+  auto *filter = Filter::make(qctx, nullptr, LogicalExpression::makeAnd(pool, notNull, notEmpty));
+  filter->setInputVar(newProj->outputVar());
+  filter->setColNames({alias});
+  auto *filterGroup = OptGroup::create(octx);
+  auto *filterGroupNode = filterGroup->makeGroupNode(filter);
+  filterGroupNode->dependsOn(newProjGroup);
+
+  const PlanNode *input = filter;
+  auto *inputGroup = filterGroup;
+  if (collect->distinct()) {
+    auto *dedup = Dedup::make(qctx, nullptr);
+    dedup->setInputVar(filter->outputVar());
+    dedup->setColNames({alias});
+    auto *dedupGroup = OptGroup::create(octx);
+    auto *dedupGroupNode = dedupGroup->makeGroupNode(dedup);
+    dedupGroupNode->dependsOn(filterGroup);
+    input = dedup;
+    inputGroup = dedupGroup;
+  }
+
+  auto *newProjAbove = static_cast<Project *>(project->clone());
+  newProjAbove->setOutputVar(project->outputVar());
+  newProjAbove->setInputVar(input->outputVar());
+  auto *newProjAboveGroupNode = OptGroupNode::create(octx, newProjAbove, projGroupNode->group());
+  newProjAboveGroupNode->dependsOn(inputGroup);
+
+  TransformResult result;
+  result.eraseAll = true;
+  result.newGroupNodes.emplace_back(newProjAboveGroupNode);
+  return result;
+}
+
+std::string EliminateCollectUnwindRule::toString() const {
+  return "EliminateCollectUnwindRule";
+}
+
+}  // namespace opt
+}  // namespace nebula
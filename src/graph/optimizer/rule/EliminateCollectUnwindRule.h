@@ -0,0 +1,80 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_OPTIMIZER_RULE_ELIMINATECOLLECTUNWINDRULE_H_
+#define GRAPH_OPTIMIZER_RULE_ELIMINATECOLLECTUNWINDRULE_H_
+
+#include "graph/optimizer/OptRule.h"
+
+DECLARE_bool(enable_optimizer_eliminate_collect_unwind_rule);
+
+namespace nebula {
+namespace opt {
+
+//  Eliminate the [[Aggregate]] collecting a list which is unwound by the [[Unwind]] right above,
+//  e.g. `WITH collect(x) AS xs UNWIND xs AS y`
+//  Required conditions:
+//   1. Match the pattern
+//   2. The Aggregate has no group key and the only group item is collect() or collect(DISTINCT)
+//   3. The Unwind unwinds the collected list exactly
+//   4. The Project above doesn't refer to the collected list
+//  Benefits:
+//   1. The list is neither built nor copied into each row unwound from it
+//
+//  Tranformation:
+//  Before:
+//
+//  +---------+---------+
+//  |      Project      |
+//  +---------+---------+
+//            |
+//  +---------+---------+
+//  |       Unwind      |
+//  +---------+---------+
+//            |
+//  +---------+---------+
+//  |     Aggregate     |
+//  +---------+---------+
+//
+//  After:
+//
+//  +---------+---------+
+//  |      Project      |
+//  +---------+---------+
+//            |
+//  +---------+---------+
+//  | Dedup (DISTINCT)  |
+//  +---------+---------+
+//            |
+//  +---------+---------+
+//  |       Filter      |
+//  +---------+---------+
+//            |
+//  +---------+---------+
+//  |      Project      |
+//  +---------+---------+
+//
+//  Notice: The Filter drops the null and empty values, which are skipped by collect()
+
+class EliminateCollectUnwindRule final : public OptRule {
+ public:
+  const Pattern &pattern() const override;
+
+  bool match(OptContext *ctx, const MatchedResult &matched) const override;
+
+  StatusOr<TransformResult> transform(OptContext *ctx, const MatchedResult &matched) const override;
+
+  std::string toString() const override;
+
+ private:
+  EliminateCollectUnwindRule();
+
+  static std::unique_ptr<OptRule> kInstance;
+};
+
+}  // namespace opt
+}  // namespace nebula
+
+#endif  // GRAPH_OPTIMIZER_RULE_ELIMINATECOLLECTUNWINDRULE_H_
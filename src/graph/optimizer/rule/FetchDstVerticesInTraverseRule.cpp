@@ -0,0 +1,100 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/optimizer/rule/FetchDstVerticesInTraverseRule.h"
+
+#include "graph/context/QueryContext.h"
+#include "graph/optimizer/OptContext.h"
+#include "graph/optimizer/OptGroup.h"
+#include "graph/planner/plan/PlanNode.h"
+#include "graph/planner/plan/Query.h"
+
+DEFINE_bool(enable_optimizer_fetch_dst_vertices_in_traverse_rule, true, "");
+
+using nebula::graph::AppendVertices;
+using nebula::graph::PlanNode;
+using nebula::graph::QueryContext;
+using nebula::graph::Traverse;
+
+namespace nebula {
+namespace opt {
+
+std::unique_ptr<OptRule> FetchDstVerticesInTraverseRule::kInstance =
+    std::unique_ptr<FetchDstVerticesInTraverseRule>(new FetchDstVerticesInTraverseRule());
+
+FetchDstVerticesInTraverseRule::FetchDstVerticesInTraverseRule() {
+  RuleSet::QueryRules().addRule(this);
+}
+
+const Pattern &FetchDstVerticesInTraverseRule::pattern() const {
+  static Pattern pattern = Pattern::create(PlanNode::Kind::kAppendVertices,
+                                           {Pattern::create(PlanNode::Kind::kTraverse)});
+  return pattern;
+}
+
+bool FetchDstVerticesInTraverseRule::match(OptContext *octx, const MatchedResult &matched) const {
+  if (!FLAGS_enable_optimizer_fetch_dst_vertices_in_traverse_rule ||
+      !OptRule::match(octx, matched)) {
+    return false;
+  }
+  const auto *av = static_cast<const AppendVertices *>(matched.planNode({0}));
+  const auto *traverse = static_cast<const Traverse *>(matched.planNode({0, 0}));
+  if (!traverse->dstVerticesVar().empty() || !av->prefetchedVar().empty()) {
+    return false;
+  }
+  // Only the dsts of the steps after the zero one are read by storage
+  const auto *range = traverse->stepRange();
+  if (range != nullptr && range->max() == 0) {
+    return false;
+  }
+  // The vertices read by storage are the same as the ones returned by GetProps only if nothing
+  // else is pushed down to it
+  return av->props() != nullptr && av->exprs() == nullptr && av->filter() == nullptr &&
+         av->orderBy().empty() && av->limit(octx->qctx()) < 0;
+}
+
+StatusOr<OptRule::TransformResult> FetchDstVerticesInTraverseRule::transform(
+    OptContext *octx, const MatchedResult &matched) const {
+  auto *qctx = octx->qctx();
+  auto avGroupNode = matched.node;
+  auto traverseGroupNode = matched.dependencies.front().node;
+  const auto *av = static_cast<const AppendVertices *>(avGroupNode->node());
+  const auto *traverse = static_cast<const Traverse *>(traverseGroupNode->node());
+
+  auto var = qctx->vctx()->anonVarGen()->getVar();
+  qctx->symTable()->newVariable(var);
+
+  auto newTraverse = static_cast<Traverse *>(traverse->clone());
+  newTraverse->setOutputVar(traverse->outputVar());
+  newTraverse->setDstVertexProps(
+      std::make_unique<std::vector<storage::cpp2::VertexProp>>(*av->props()));
+  newTraverse->setDstVerticesVar(var);
+  qctx->symTable()->writtenBy(var, newTraverse);
+  auto newTraverseGroup = OptGroup::create(octx);
+  auto newTraverseGroupNode = newTraverseGroup->makeGroupNode(newTraverse);
+  for (auto dep : traverseGroupNode->dependencies()) {
+    newTraverseGroupNode->dependsOn(dep);
+  }
+
+  auto newAv = static_cast<AppendVertices *>(av->clone());
+  newAv->setOutputVar(av->outputVar());
+  newAv->setInputVar(newTraverse->outputVar());
+  newAv->setPrefetchedVar(var);
+  qctx->symTable()->readBy(var, newAv);
+  auto newAvGroupNode = OptGroupNode::create(octx, newAv, avGroupNode->group());
+  newAvGroupNode->dependsOn(newTraverseGroup);
+
+  TransformResult result;
+  result.eraseAll = true;
+  result.newGroupNodes.emplace_back(newAvGroupNode);
+  return result;
+}
+
+std::string FetchDstVerticesInTraverseRule::toString() const {
+  return "FetchDstVerticesInTraverseRule";
+}
+
+}  // namespace opt
+}  // namespace nebula
@@ -0,0 +1,69 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_OPTIMIZER_RULE_FETCHDSTVERTICESINTRAVERSERULE_H_
+#define GRAPH_OPTIMIZER_RULE_FETCHDSTVERTICESINTRAVERSERULE_H_
+
+#include "graph/optimizer/OptRule.h"
+
+DECLARE_bool(enable_optimizer_fetch_dst_vertices_in_traverse_rule);
+
+namespace nebula {
+namespace opt {
+
+//  Read the props of the dsts appended by the [[AppendVertices]] along with the edges of the
+//  [[Traverse]] below it
+//  Required conditions:
+//   1. Match the pattern
+//   2. The AppendVertices reads the props of the vertices, without any filter, expression,
+//      order by or limit pushed down to storage
+//  Benefits:
+//   1. The dsts in the parts led by the same storaged as their srcs are read by GetNeighbors in
+//      place, and the AppendVertices only sends GetProps for the rest of them, which saves the
+//      round trip when all of them are read
+//
+//  Tranformation:
+//  Before:
+//
+//  +-----------+-----------+
+//  |    AppendVertices     |
+//  +-----------+-----------+
+//              |
+//  +-----------+-----------+
+//  |       Traverse        |
+//  +-----------+-----------+
+//
+//  After:
+//
+//  +-----------+-----------+
+//  |    AppendVertices     |
+//  | (prefetchedVar: var)  |
+//  +-----------+-----------+
+//              |
+//  +-----------+-----------+
+//  |       Traverse        |
+//  | (dstVerticesVar: var) |
+//  +-----------+-----------+
+
+class FetchDstVerticesInTraverseRule final : public OptRule {
+ public:
+  const Pattern &pattern() const override;
+
+  bool match(OptContext *ctx, const MatchedResult &matched) const override;
+
+  StatusOr<TransformResult> transform(OptContext *ctx, const MatchedResult &matched) const override;
+
+  std::string toString() const override;
+
+ private:
+  FetchDstVerticesInTraverseRule();
+
+  static std::unique_ptr<OptRule> kInstance;
+};
+
+}  // namespace opt
+}  // namespace nebula
+
+#endif  // GRAPH_OPTIMIZER_RULE_FETCHDSTVERTICESINTRAVERSERULE_H_
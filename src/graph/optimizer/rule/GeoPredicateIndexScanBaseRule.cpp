@@ -6,6 +6,7 @@
 #include "graph/optimizer/rule/GeoPredicateIndexScanBaseRule.h"
 
 #include "common/geo/GeoIndex.h"
+#include "common/utils/IndexKeyUtils.h"
 #include "graph/optimizer/OptContext.h"
 #include "graph/optimizer/OptGroup.h"
 #include "graph/optimizer/OptRule.h"
@@ -88,17 +89,7 @@ StatusOr<TransformResult> GeoPredicateIndexScanBaseRule::transform(
   bool isPointColumn = geoColumnTypeDef.geo_shape_ref().has_value() &&
                        geoColumnTypeDef.geo_shape_ref().value() == meta::cpp2::GeoShape::POINT;
 
-  geo::RegionCoverParams rc;
-  const auto* indexParams = indexItem->get_index_params();
-  if (indexParams) {
-    if (indexParams->s2_max_level_ref().has_value()) {
-      rc.maxCellLevel_ = indexParams->s2_max_level_ref().value();
-    }
-    if (indexParams->s2_max_cells_ref().has_value()) {
-      rc.maxCellNum_ = indexParams->s2_max_cells_ref().value();
-    }
-  }
-  geo::GeoIndex geoIndex(rc, isPointColumn);
+  geo::GeoIndex geoIndex(IndexKeyUtils::regionCoverParams(indexItem.get()), isPointColumn);
   std::vector<geo::ScanRange> scanRanges;
   if (geoPredicateName == "st_intersects") {
     scanRanges = geoIndex.intersects(geog);
@@ -131,8 +122,8 @@ StatusOr<TransformResult> GeoPredicateIndexScanBaseRule::transform(
   auto scanNode = IndexScan::make(ctx->qctx(), nullptr);
   OptimizerUtils::copyIndexScanData(scan, scanNode, ctx->qctx());
   scanNode->setIndexQueryContext(std::move(idxCtxs));
-  // TODO(jie): geo predicate's calculation is a little heavy,
-  // which is not suitable to push down to the storage
+  // The exact predicate is evaluated by the storage on the candidates of the ranges, after they
+  // are deduplicated
   scanNode->setOutputVar(filter->outputVar());
   scanNode->setColNames(filter->colNames());
   auto filterGroup = matched.node->group();
@@ -149,13 +149,22 @@ StatusOr<TransformResult> OptimizeTagIndexScanByFilterRule::transform(
 
   IndexQueryContext ictx;
   bool isPrefixScan = false;
-  if (!OptimizerUtils::findOptimalIndex(transformedExpr, indexItems, &isPrefixScan, &ictx)) {
+  double rows = -1;
+  auto costModel = ctx->costModel(scan->space());
+  if (!OptimizerUtils::findOptimalIndex(
+          transformedExpr, indexItems, &isPrefixScan, &ictx, costModel, &rows)) {
     return TransformResult::noTransform();
   }
 
   std::vector<IndexQueryContext> idxCtxs = {ictx};
+  bool intersect = OptimizerUtils::findIndexIntersection(
+      transformedExpr, indexItems, costModel, ictx, rows, &idxCtxs, &rows);
   auto scanNode = makeTagIndexScan(ctx->qctx(), scan, isPrefixScan);
+  if (rows >= 0) {
+    scanNode->setCost(rows);
+  }
   scanNode->setIndexQueryContext(std::move(idxCtxs));
+  scanNode->setIntersect(intersect);
   scanNode->setOutputVar(filter->outputVar());
   scanNode->setColNames(filter->colNames());
   auto filterGroup = matched.node->group();
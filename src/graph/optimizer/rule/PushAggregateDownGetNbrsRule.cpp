@@ -0,0 +1,406 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/optimizer/rule/PushAggregateDownGetNbrsRule.h"
+
+#include "common/expression/ArithmeticExpression.h"
+#include "common/expression/CaseExpression.h"
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/RelationalExpression.h"
+#include "common/expression/SubscriptExpression.h"
+#include "common/expression/VertexExpression.h"
+#include "graph/optimizer/OptContext.h"
+#include "graph/optimizer/OptGroup.h"
+#include "graph/planner/plan/PlanNode.h"
+#include "graph/planner/plan/Query.h"
+#include "graph/util/ExpressionUtils.h"
+
+DEFINE_bool(enable_optimizer_push_aggregate_down_get_nbrs_rule, true, "");
+
+using nebula::graph::Aggregate;
+using nebula::graph::Filter;
+using nebula::graph::GetNeighbors;
+using nebula::graph::PlanNode;
+using nebula::graph::Project;
+using nebula::graph::QueryContext;
+using nebula::storage::cpp2::StatType;
+
+namespace nebula {
+namespace opt {
+
+namespace {
+
+// Whether the expression is the id of the source vertex of the edge
+bool isSrcId(const Expression *expr) {
+  if (expr == nullptr) {
+    return false;
+  }
+  if (expr->kind() == Expression::Kind::kEdgeSrc) {
+    return true;
+  }
+  if (expr->kind() != Expression::Kind::kFunctionCall) {
+    return false;
+  }
+  auto *func = static_cast<const FunctionCallExpression *>(expr);
+  if (func->args()->numArgs() != 1) {
+    return false;
+  }
+  const auto *arg = func->args()->args().front();
+  if (func->isFunc("src")) {
+    return arg->kind() == Expression::Kind::kEdge;
+  }
+  if (func->isFunc("id")) {
+    return arg->kind() == Expression::Kind::kVertex &&
+           static_cast<const VertexExpression *>(arg)->name() == "$^";
+  }
+  return false;
+}
+
+bool isNumeric(nebula::cpp2::PropertyType type) {
+  switch (type) {
+    case nebula::cpp2::PropertyType::INT8:
+    case nebula::cpp2::PropertyType::INT16:
+    case nebula::cpp2::PropertyType::INT32:
+    case nebula::cpp2::PropertyType::INT64:
+    case nebula::cpp2::PropertyType::FLOAT:
+    case nebula::cpp2::PropertyType::DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The partial aggregate calculated by storage for a group item
+struct Partial {
+  // The function to merge the partials in graphd, empty for the group key
+  std::string func;
+  // Index of the stat, -1 for the count of all edges
+  int64_t stat{-1};
+  // Index of the count of the edges of the type, used by min/max/avg
+  int64_t count{-1};
+};
+
+}  // namespace
+
+std::unique_ptr<OptRule> PushAggregateDownGetNbrsRule::kInstance =
+    std::unique_ptr<PushAggregateDownGetNbrsRule>(new PushAggregateDownGetNbrsRule());
+
+PushAggregateDownGetNbrsRule::PushAggregateDownGetNbrsRule() {
+  RuleSet::QueryRules().addRule(this);
+}
+
+const Pattern &PushAggregateDownGetNbrsRule::pattern() const {
+  static Pattern pattern = Pattern::create(
+      graph::PlanNode::Kind::kAggregate,
+      {Pattern::create(graph::PlanNode::Kind::kProject,
+                       {Pattern::create(graph::PlanNode::Kind::kGetNeighbors)})});
+  return pattern;
+}
+
+bool PushAggregateDownGetNbrsRule::match(OptContext *ctx, const MatchedResult &matched) const {
+  if (!FLAGS_enable_optimizer_push_aggregate_down_get_nbrs_rule) {
+    return false;
+  }
+  return OptRule::match(ctx, matched);
+}
+
+StatusOr<OptRule::TransformResult> PushAggregateDownGetNbrsRule::transform(
+    OptContext *octx, const MatchedResult &matched) const {
+  auto *qctx = octx->qctx();
+  auto *pool = qctx->objPool();
+  auto aggGroupNode = matched.node;
+  auto projGroupNode = matched.dependencies.front().node;
+  auto gnGroupNode = matched.dependencies.front().dependencies.front().node;
+
+  const auto agg = static_cast<const Aggregate *>(aggGroupNode->node());
+  const auto proj = static_cast<const Project *>(projGroupNode->node());
+  const auto gn = static_cast<const GetNeighbors *>(gnGroupNode->node());
+
+  if (gn->random() || !gn->orderBy().empty() || gn->edgeProps() == nullptr ||
+      gn->edgeTypes().empty() || (gn->statProps() != nullptr && !gn->statProps()->empty()) ||
+      (gn->exprs() != nullptr && !gn->exprs()->empty())) {
+    return TransformResult::noTransform();
+  }
+  if (!graph::ExpressionUtils::isEvaluableExpr(gn->limitExpr()) || gn->limit(qctx) >= 0) {
+    return TransformResult::noTransform();
+  }
+  if (agg->groupKeys().size() > 1) {
+    return TransformResult::noTransform();
+  }
+
+  auto spaceId = gn->space();
+  auto *schemaMng = qctx->schemaMng();
+  auto statProps = std::make_unique<std::vector<storage::cpp2::StatProp>>();
+  auto addStat = [&statProps](const Expression *prop, StatType stat) -> int64_t {
+    storage::cpp2::StatProp statProp;
+    statProp.alias_ref() = folly::to<std::string>(statProps->size());
+    statProp.prop_ref() = prop->encode();
+    statProp.stat_ref() = stat;
+    statProps->emplace_back(std::move(statProp));
+    return statProps->size() - 1;
+  };
+
+  // Count the edges of each edge type, the stats are only calculated on the out-edges
+  std::unordered_map<EdgeType, int64_t> countStats;
+  std::vector<int64_t> counts;
+  for (auto type : gn->edgeTypes()) {
+    if (type <= 0) {
+      return TransformResult::noTransform();
+    }
+    if (countStats.find(type) != countStats.end()) {
+      continue;
+    }
+    auto edgeName = schemaMng->toEdgeName(spaceId, type);
+    if (!edgeName.ok()) {
+      return TransformResult::noTransform();
+    }
+    auto idx = addStat(EdgeRankExpression::make(pool, edgeName.value()), StatType::COUNT);
+    countStats.emplace(type, idx);
+    counts.emplace_back(idx);
+  }
+
+  std::unordered_map<std::string, const Expression *> columns;
+  const auto &projColNames = proj->colNames();
+  const auto &projCols = proj->columns()->columns();
+  for (size_t i = 0; i < projCols.size(); ++i) {
+    columns.emplace(projColNames[i], projCols[i]->expr());
+  }
+  // The column of the project referred by the expression
+  auto columnOf = [&columns](const Expression *expr) -> const Expression * {
+    if (expr->kind() != Expression::Kind::kInputProperty &&
+        expr->kind() != Expression::Kind::kVarProperty) {
+      return nullptr;
+    }
+    auto found = columns.find(static_cast<const PropertyExpression *>(expr)->prop());
+    return found == columns.end() ? nullptr : found->second;
+  };
+  // The type of the out-edge which the non-nullable property belongs to
+  auto edgeTypeOf = [&](const Expression *expr, bool numeric) -> StatusOr<EdgeType> {
+    if (expr == nullptr || expr->kind() != Expression::Kind::kEdgeProperty) {
+      return Status::Error("Not an edge property");
+    }
+    auto *prop = static_cast<const EdgePropertyExpression *>(expr);
+    auto type = schemaMng->toEdgeType(spaceId, prop->sym());
+    NG_RETURN_IF_ERROR(type);
+    if (countStats.find(type.value()) == countStats.end()) {
+      return Status::Error("Edge `%s' is not traversed", prop->sym().c_str());
+    }
+    auto schema = schemaMng->getEdgeSchema(spaceId, type.value());
+    auto *field = schema == nullptr ? nullptr : schema->field(prop->prop());
+    if (field == nullptr || field->nullable() || (numeric && !isNumeric(field->type()))) {
+      return Status::Error("Unsupported property `%s'", prop->toString().c_str());
+    }
+    return type.value();
+  };
+
+  // Only grouped by the source vertex
+  if (!agg->groupKeys().empty() && !isSrcId(columnOf(agg->groupKeys().front()))) {
+    return TransformResult::noTransform();
+  }
+
+  std::unordered_map<std::string, int64_t> propStats;
+  std::vector<Partial> partials;
+  bool hasAvg = false;
+  for (auto *item : agg->groupItems()) {
+    Partial partial;
+    if (item->kind() != Expression::Kind::kAggregate) {
+      // The group key
+      if (agg->groupKeys().empty() || *item != *agg->groupKeys().front()) {
+        return TransformResult::noTransform();
+      }
+      partials.emplace_back(std::move(partial));
+      continue;
+    }
+    auto *aggExpr = static_cast<AggregateExpression *>(item);
+    if (aggExpr->distinct() || aggExpr->arg() == nullptr) {
+      return TransformResult::noTransform();
+    }
+    auto func = aggExpr->name();
+    std::transform(func.begin(), func.end(), func.begin(), ::toupper);
+    if (func != "COUNT" && func != "SUM" && func != "AVG" && func != "MIN" && func != "MAX") {
+      return TransformResult::noTransform();
+    }
+    const auto *arg = aggExpr->arg();
+    if (func == "COUNT" && arg->kind() == Expression::Kind::kConstant) {
+      // count(*) is the count of all edges
+      const auto &val = static_cast<const ConstantExpression *>(arg)->value();
+      if (!val.isStr() || val.getStr() != "*") {
+        return TransformResult::noTransform();
+      }
+      partial.func = "SUM";
+      partials.emplace_back(std::move(partial));
+      continue;
+    }
+    auto *prop = columnOf(arg);
+    auto type = edgeTypeOf(prop, func != "COUNT");
+    if (!type.ok()) {
+      return TransformResult::noTransform();
+    }
+    partial.count = countStats[type.value()];
+    if (func == "COUNT") {
+      partial.func = "SUM";
+      partial.stat = partial.count;
+      partials.emplace_back(std::move(partial));
+      continue;
+    }
+    auto stat = func == "MIN" ? StatType::MIN : func == "MAX" ? StatType::MAX : StatType::SUM;
+    auto key = folly::stringPrintf("%d:%s", static_cast<int32_t>(stat), prop->toString().c_str());
+    auto found = propStats.find(key);
+    if (found == propStats.end()) {
+      found = propStats.emplace(key, addStat(prop, stat)).first;
+    }
+    partial.stat = found->second;
+    partial.func = func;
+    hasAvg = hasAvg || func == "AVG";
+    partials.emplace_back(std::move(partial));
+  }
+
+  // The stats are returned in one column, named after all stats
+  std::string statsColName = "_stats";
+  for (const auto &statProp : *statProps) {
+    statsColName += ":" + *statProp.alias_ref();
+  }
+  auto statExpr = [pool, &statsColName](int64_t idx) -> Expression * {
+    return SubscriptExpression::make(pool,
+                                     InputPropertyExpression::make(pool, statsColName),
+                                     ConstantExpression::make(pool, idx));
+  };
+  auto inputProp = [pool](const std::string &col) -> Expression * {
+    return InputPropertyExpression::make(pool, col);
+  };
+  auto *anonColGen = qctx->vctx()->anonColGen();
+
+  // Project the partials of each source vertex
+  auto *partialCols = pool->makeAndAdd<YieldColumns>();
+  std::string keyCol;
+  if (!agg->groupKeys().empty()) {
+    keyCol = anonColGen->getCol();
+    partialCols->addColumn(new YieldColumn(inputProp(kVid), keyCol));
+  }
+  auto totalCol = anonColGen->getCol();
+  Expression *total = nullptr;
+  for (auto idx : counts) {
+    total = total == nullptr ? statExpr(idx)
+                             : ArithmeticExpression::makeAdd(pool, total, statExpr(idx));
+  }
+  partialCols->addColumn(new YieldColumn(total, totalCol));
+
+  // Merge the partials of each group
+  std::vector<Expression *> groupKeys;
+  std::vector<Expression *> groupItems;
+  std::vector<std::string> aggColNames = agg->colNames();
+  std::vector<std::pair<std::string, std::string>> avgCols;
+  if (!keyCol.empty()) {
+    groupKeys.emplace_back(inputProp(keyCol));
+  }
+  for (size_t i = 0; i < partials.size(); ++i) {
+    const auto &partial = partials[i];
+    if (partial.func.empty()) {
+      groupItems.emplace_back(inputProp(keyCol));
+      continue;
+    }
+    std::string col = totalCol;
+    if (partial.stat >= 0) {
+      col = anonColGen->getCol();
+      Expression *expr = statExpr(partial.stat);
+      if (partial.func == "MIN" || partial.func == "MAX") {
+        // The min/max is meaningless if there is no edge of the type
+        auto *cases = CaseList::make(pool);
+        cases->add(RelationalExpression::makeGT(
+                       pool, statExpr(partial.count), ConstantExpression::make(pool, 0)),
+                   expr);
+        expr = CaseExpression::make(pool, cases);
+      }
+      partialCols->addColumn(new YieldColumn(expr, col));
+    }
+    std::string mergeFunc = partial.func == "AVG" ? "SUM" : partial.func;
+    groupItems.emplace_back(AggregateExpression::make(pool, mergeFunc, inputProp(col), false));
+    if (partial.func == "AVG") {
+      // The avg is merged by the sum and the count
+      auto countCol = anonColGen->getCol();
+      partialCols->addColumn(new YieldColumn(statExpr(partial.count), countCol));
+      groupItems.emplace_back(AggregateExpression::make(pool, "SUM", inputProp(countCol), false));
+      aggColNames[i] = anonColGen->getCol();
+      aggColNames.emplace_back(anonColGen->getCol());
+      avgCols.emplace_back(aggColNames[i], aggColNames.back());
+    }
+  }
+
+  auto newGn = static_cast<GetNeighbors *>(gn->clone());
+  newGn->setStatProps(std::move(statProps));
+  newGn->setStatsOnly(true);
+  auto newGnGroup = OptGroup::create(octx);
+  auto newGnGroupNode = newGnGroup->makeGroupNode(newGn);
+  newGnGroupNode->setDeps(gnGroupNode->dependencies());
+
+  auto newProj = Project::make(qctx, nullptr, partialCols);
+  newProj->setInputVar(newGn->outputVar());
+  auto newProjGroup = OptGroup::create(octx);
+  auto newProjGroupNode = newProjGroup->makeGroupNode(newProj);
+  newProjGroupNode->dependsOn(newGnGroup);
+
+  // Skip the vertices without any edge, which are not in the result of the original plan
+  auto *condition = RelationalExpression::makeGT(
+      pool, inputProp(totalCol), ConstantExpression::make(pool, 0));
+  auto newFilter = Filter::make(qctx, nullptr, condition);
+  newFilter->setInputVar(newProj->outputVar());
+  newFilter->setColNames(newProj->colNames());
+  auto newFilterGroup = OptGroup::create(octx);
+  auto newFilterGroupNode = newFilterGroup->makeGroupNode(newFilter);
+  newFilterGroupNode->dependsOn(newProjGroup);
+
+  auto newAgg = Aggregate::make(qctx, nullptr, std::move(groupKeys), std::move(groupItems));
+  newAgg->setColNames(aggColNames);
+  newAgg->setInputVar(newFilter->outputVar());
+
+  TransformResult result;
+  result.eraseAll = true;
+  if (!hasAvg) {
+    newAgg->setOutputVar(agg->outputVar());
+    auto newAggGroupNode = OptGroupNode::create(octx, newAgg, aggGroupNode->group());
+    newAggGroupNode->dependsOn(newFilterGroup);
+    result.newGroupNodes.emplace_back(newAggGroupNode);
+    return result;
+  }
+
+  auto newAggGroup = OptGroup::create(octx);
+  auto newAggGroupNode = newAggGroup->makeGroupNode(newAgg);
+  newAggGroupNode->dependsOn(newFilterGroup);
+
+  // Divide the sum by the count for the avg
+  auto *outputCols = pool->makeAndAdd<YieldColumns>();
+  size_t avgIdx = 0;
+  for (size_t i = 0; i < agg->colNames().size(); ++i) {
+    const auto &colName = agg->colNames()[i];
+    if (partials[i].func != "AVG") {
+      outputCols->addColumn(new YieldColumn(inputProp(colName), colName));
+      continue;
+    }
+    const auto &avgCol = avgCols[avgIdx++];
+    auto *avg = ArithmeticExpression::makeDivision(
+        pool,
+        TypeCastingExpression::make(pool, Value::Type::FLOAT, inputProp(avgCol.first)),
+        inputProp(avgCol.second));
+    auto *cases = CaseList::make(pool);
+    cases->add(RelationalExpression::makeGT(
+                   pool, inputProp(avgCol.second), ConstantExpression::make(pool, 0)),
+               avg);
+    outputCols->addColumn(new YieldColumn(CaseExpression::make(pool, cases), colName));
+  }
+  auto newOutput = Project::make(qctx, nullptr, outputCols);
+  newOutput->setInputVar(newAgg->outputVar());
+  newOutput->setOutputVar(agg->outputVar());
+  auto newOutputGroupNode = OptGroupNode::create(octx, newOutput, aggGroupNode->group());
+  newOutputGroupNode->dependsOn(newAggGroup);
+  result.newGroupNodes.emplace_back(newOutputGroupNode);
+  return result;
+}
+
+std::string PushAggregateDownGetNbrsRule::toString() const {
+  return "PushAggregateDownGetNbrsRule";
+}
+
+}  // namespace opt
+}  // namespace nebula
@@ -0,0 +1,88 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_OPTIMIZER_RULE_PUSHAGGREGATEDOWNGETNBRSRULE_H
+#define GRAPH_OPTIMIZER_RULE_PUSHAGGREGATEDOWNGETNBRSRULE_H
+
+#include "graph/optimizer/OptRule.h"
+
+DECLARE_bool(enable_optimizer_push_aggregate_down_get_nbrs_rule);
+
+namespace nebula {
+namespace opt {
+
+//  Calculate the aggregates of the edges of each source vertex in [[GetNeighbors]], so only the
+//  stats rather than the edges are returned by storage, and merge them in graphd.
+//  Required conditions:
+//   1. Match the pattern
+//   2. The aggregate is grouped by nothing or the source vertex
+//   3. The group items are the group key, or count(*) and non-distinct count/sum/avg/min/max of
+//      the non-nullable edge properties of the out-edges, the numeric ones for sum/avg/min/max
+//   4. No limit, order by or random in the GetNeighbors
+//  Benefits:
+//   1. Only one row for each source vertex is returned by storage
+//
+//  Tranformation:
+//  Before:
+//
+//  +--------------+---------------+
+//  |           Aggregate          |
+//  | ($-.src, count(*), sum($-.w))|
+//  +--------------+---------------+
+//                 |
+//  +--------------+---------------+
+//  |            Project           |
+//  | (src(edge) AS src, e.w AS w) |
+//  +--------------+---------------+
+//                 |
+//       +---------+---------+
+//       |    GetNeighbors   |
+//       +---------+---------+
+//
+//  After:
+//
+//  +--------------+---------------+
+//  |           Aggregate          |
+//  |($-.k, sum($-.c), sum($-.s))  |
+//  +--------------+---------------+
+//                 |
+//       +---------+---------+
+//       |       Filter      |
+//       |     ($-.c > 0)    |
+//       +---------+---------+
+//                 |
+//  +--------------+---------------+
+//  |            Project           |
+//  |($-._vid AS k, $-._stats[0] AS|
+//  | c, $-._stats[1] AS s)        |
+//  +--------------+---------------+
+//                 |
+//  +--------------+---------------+
+//  |          GetNeighbors        |
+//  |(statProps: count(e._rank),   |
+//  | sum(e.w), statsOnly: true)   |
+//  +--------------+---------------+
+//
+//  The avg is merged by the sum and the count, which are divided in a Project above the Aggregate.
+
+class PushAggregateDownGetNbrsRule final : public OptRule {
+ public:
+  const Pattern &pattern() const override;
+
+  bool match(OptContext *ctx, const MatchedResult &matched) const override;
+  StatusOr<OptRule::TransformResult> transform(OptContext *ctx,
+                                               const MatchedResult &matched) const override;
+
+  std::string toString() const override;
+
+ private:
+  PushAggregateDownGetNbrsRule();
+
+  static std::unique_ptr<OptRule> kInstance;
+};
+
+}  // namespace opt
+}  // namespace nebula
+#endif
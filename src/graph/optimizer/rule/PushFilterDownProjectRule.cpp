@@ -75,6 +75,11 @@ StatusOr<OptRule::TransformResult> PushFilterDownProjectRule::transform(
           rewriteMap[colName] = column->expr();
         }
         continue;
+      } else if (column->expr()->kind() == Expression::Kind::kPathBuild &&
+                 graph::ExpressionUtils::onlyPathEndsOrLength(e, colName)) {
+        // Filter on the length or the end nodes of the paths before building them
+        rewriteMap[colName] = column->expr();
+        continue;
       } else {
         return false;
       }
@@ -105,6 +110,7 @@ StatusOr<OptRule::TransformResult> PushFilterDownProjectRule::transform(
       rewriteMap.empty()
           ? filterPicked
           : graph::RewriteVisitor::transform(filterPicked, std::move(matcher), std::move(rewriter));
+  newFilterPicked = graph::ExpressionUtils::rewritePathFunctions(newFilterPicked);
 
   // produce new Filter node below
   auto* newBelowFilterNode = graph::Filter::make(
@@ -0,0 +1,105 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/optimizer/rule/PushLimitDownTraverseAppendVerticesRule.h"
+
+#include "graph/optimizer/OptContext.h"
+#include "graph/optimizer/OptGroup.h"
+#include "graph/planner/plan/PlanNode.h"
+#include "graph/planner/plan/Query.h"
+
+using nebula::graph::AppendVertices;
+using nebula::graph::Limit;
+using nebula::graph::PlanNode;
+using nebula::graph::QueryContext;
+using nebula::graph::Traverse;
+
+namespace nebula {
+namespace opt {
+
+// Limit->AppendVertices->Traverse ==> Limit->AppendVertices->Traverse(path limit)
+
+std::unique_ptr<OptRule> PushLimitDownTraverseAppendVerticesRule::kInstance =
+    std::unique_ptr<PushLimitDownTraverseAppendVerticesRule>(
+        new PushLimitDownTraverseAppendVerticesRule());
+
+PushLimitDownTraverseAppendVerticesRule::PushLimitDownTraverseAppendVerticesRule() {
+  RuleSet::QueryRules().addRule(this);
+}
+
+const Pattern &PushLimitDownTraverseAppendVerticesRule::pattern() const {
+  static Pattern pattern =
+      Pattern::create(graph::PlanNode::Kind::kLimit,
+                      {Pattern::create(graph::PlanNode::Kind::kAppendVertices,
+                                       {Pattern::create(graph::PlanNode::Kind::kTraverse)})});
+  return pattern;
+}
+
+bool PushLimitDownTraverseAppendVerticesRule::match(OptContext *ctx,
+                                                    const MatchedResult &matched) const {
+  if (!OptRule::match(ctx, matched)) {
+    return false;
+  }
+  auto av = static_cast<const AppendVertices *>(matched.planNode({0, 0}));
+  // Each path of the traverse is output as a row, unless the vertex of its dst is missing, which
+  // the traverse checks by the props of the dsts before it stops at the limit
+  if (!av->trackPrevPath() || av->props() == nullptr) {
+    return false;
+  }
+  // Limit can't push over the operations dropping the rows by their dsts
+  return av->filter() == nullptr && av->vFilter() == nullptr && av->orderBy().empty() &&
+         av->limit(ctx->qctx()) < 0 && av->vidFilterVar().empty();
+}
+
+StatusOr<OptRule::TransformResult> PushLimitDownTraverseAppendVerticesRule::transform(
+    OptContext *octx, const MatchedResult &matched) const {
+  auto limitGroupNode = matched.node;
+  auto appendVerticesGroupNode = matched.dependencies.front().node;
+  auto traverseGroupNode = matched.dependencies.front().dependencies.front().node;
+
+  const auto limit = static_cast<const Limit *>(limitGroupNode->node());
+  const auto appendVertices = static_cast<const AppendVertices *>(appendVerticesGroupNode->node());
+  const auto traverse = static_cast<const Traverse *>(traverseGroupNode->node());
+
+  int64_t limitRows = limit->offset() + limit->count();
+  if (traverse->pathLimit() >= 0 && limitRows >= traverse->pathLimit()) {
+    return TransformResult::noTransform();
+  }
+
+  auto newLimit = static_cast<Limit *>(limit->clone());
+  newLimit->setOutputVar(limit->outputVar());
+  auto newLimitGroupNode = OptGroupNode::create(octx, newLimit, limitGroupNode->group());
+
+  auto newAppendVertices = static_cast<AppendVertices *>(appendVertices->clone());
+  auto newAppendVerticesGroup = OptGroup::create(octx);
+  auto newAppendVerticesGroupNode = newAppendVerticesGroup->makeGroupNode(newAppendVertices);
+
+  auto newTraverse = static_cast<Traverse *>(traverse->clone());
+  newTraverse->setPathLimit(limitRows);
+  newTraverse->setLimitDstProps(
+      std::make_unique<std::vector<storage::cpp2::VertexProp>>(*appendVertices->props()));
+  auto newTraverseGroup = OptGroup::create(octx);
+  auto newTraverseGroupNode = newTraverseGroup->makeGroupNode(newTraverse);
+
+  newLimitGroupNode->dependsOn(newAppendVerticesGroup);
+  newLimit->setInputVar(newAppendVertices->outputVar());
+  newAppendVerticesGroupNode->dependsOn(newTraverseGroup);
+  newAppendVertices->setInputVar(newTraverse->outputVar());
+  for (auto dep : traverseGroupNode->dependencies()) {
+    newTraverseGroupNode->dependsOn(dep);
+  }
+
+  TransformResult result;
+  result.eraseAll = true;
+  result.newGroupNodes.emplace_back(newLimitGroupNode);
+  return result;
+}
+
+std::string PushLimitDownTraverseAppendVerticesRule::toString() const {
+  return "PushLimitDownTraverseAppendVerticesRule";
+}
+
+}  // namespace opt
+}  // namespace nebula
@@ -0,0 +1,72 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_OPTIMIZER_RULE_PUSHLIMITDOWNTRAVERSEAPPENDVERTICESRULE_H
+#define GRAPH_OPTIMIZER_RULE_PUSHLIMITDOWNTRAVERSEAPPENDVERTICESRULE_H
+
+#include "graph/optimizer/OptRule.h"
+
+namespace nebula {
+namespace opt {
+
+//  Embedding limit to [[Traverse]] as the max number of the paths it outputs
+//  Required conditions:
+//   1. Match the pattern
+//   2. All filters of [[AppendVertices]] must be nullptr
+//   3. [[AppendVertices]] appends the vertex to each path, i.e. tracks the previous path
+//  Benefits:
+//   1. Traverse stops expanding once it has enough paths, instead of traversing all the steps
+//
+//  Tranformation:
+//  Before:
+//
+//  +--------+--------+
+//  |      Limit      |
+//  |    (limit=3)    |
+//  +--------+--------+
+//           |
+// +---------+---------+
+// |   AppendVertices  |
+// +---------+---------+
+//           |
+// +---------+---------+
+// |      Traverse     |
+// +---------+---------+
+//
+//  After:
+//
+//  +--------+--------+
+//  |      Limit      |
+//  |    (limit=3)    |
+//  +--------+--------+
+//           |
+// +---------+---------+
+// |   AppendVertices  |
+// +---------+---------+
+//           |
+// +---------+---------+
+// |      Traverse     |
+// |   (path limit=3)  |
+// +---------+---------+
+
+class PushLimitDownTraverseAppendVerticesRule final : public OptRule {
+ public:
+  const Pattern &pattern() const override;
+
+  bool match(OptContext *ctx, const MatchedResult &matched) const override;
+  StatusOr<OptRule::TransformResult> transform(OptContext *ctx,
+                                               const MatchedResult &matched) const override;
+
+  std::string toString() const override;
+
+ private:
+  PushLimitDownTraverseAppendVerticesRule();
+
+  static std::unique_ptr<OptRule> kInstance;
+};
+
+}  // namespace opt
+}  // namespace nebula
+#endif
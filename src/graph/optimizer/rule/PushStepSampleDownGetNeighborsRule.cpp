@@ -5,10 +5,12 @@
 
 #include "graph/optimizer/rule/PushStepSampleDownGetNeighborsRule.h"
 
+#include "graph/context/QueryContext.h"
 #include "graph/optimizer/OptContext.h"
 #include "graph/optimizer/OptGroup.h"
 #include "graph/planner/plan/PlanNode.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 #include "graph/util/ExpressionUtils.h"
 
 using nebula::graph::GetNeighbors;
@@ -55,6 +57,7 @@ StatusOr<OptRule::TransformResult> PushStepSampleDownGetNeighborsRule::transform
   auto newGn = static_cast<GetNeighbors *>(gn->clone());
   newGn->setLimit(sample->countExpr()->clone());
   newGn->setRandom(true);
+  newGn->setEdgeBudget(edgeBudget(octx->qctx()));
   auto newGnGroup = OptGroup::create(octx);
   auto newGnGroupNode = newGnGroup->makeGroupNode(newGn);
 
@@ -70,6 +73,19 @@ StatusOr<OptRule::TransformResult> PushStepSampleDownGetNeighborsRule::transform
   return result;
 }
 
+int64_t PushStepSampleDownGetNeighborsRule::edgeBudget(QueryContext *qctx) const {
+  int64_t budget = FLAGS_adaptive_sample_edge_budget;
+  if (qctx->rctx() != nullptr) {
+    auto session = qctx->rctx()->session()->getSession();
+    auto &configs = session.get_configs();
+    auto iter = configs.find("adaptive_sample_edge_budget");
+    if (iter != configs.end() && iter->second.isInt()) {
+      budget = iter->second.getInt();
+    }
+  }
+  return budget > 0 ? budget : -1;
+}
+
 std::string PushStepSampleDownGetNeighborsRule::toString() const {
   return "PushStepSampleDownGetNeighborsRule";
 }
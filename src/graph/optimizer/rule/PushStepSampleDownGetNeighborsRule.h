@@ -54,6 +54,10 @@ class PushStepSampleDownGetNeighborsRule final : public OptRule {
  private:
   PushStepSampleDownGetNeighborsRule();
 
+  // The edge budget of each request, by the session config or the flag
+  // adaptive_sample_edge_budget, -1 if there is none
+  int64_t edgeBudget(graph::QueryContext *qctx) const;
+
   static std::unique_ptr<OptRule> kInstance;
 };
 
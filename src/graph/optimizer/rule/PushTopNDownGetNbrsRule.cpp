@@ -0,0 +1,121 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/optimizer/rule/PushTopNDownGetNbrsRule.h"
+
+#include "graph/optimizer/OptContext.h"
+#include "graph/optimizer/OptGroup.h"
+#include "graph/planner/plan/PlanNode.h"
+#include "graph/planner/plan/Query.h"
+
+using nebula::graph::GetNeighbors;
+using nebula::graph::PlanNode;
+using nebula::graph::Project;
+using nebula::graph::QueryContext;
+using nebula::graph::TopN;
+
+namespace nebula {
+namespace opt {
+
+std::unique_ptr<OptRule> PushTopNDownGetNbrsRule::kInstance =
+    std::unique_ptr<PushTopNDownGetNbrsRule>(new PushTopNDownGetNbrsRule());
+
+PushTopNDownGetNbrsRule::PushTopNDownGetNbrsRule() {
+  RuleSet::QueryRules().addRule(this);
+}
+
+const Pattern &PushTopNDownGetNbrsRule::pattern() const {
+  static Pattern pattern = Pattern::create(
+      graph::PlanNode::Kind::kTopN,
+      {Pattern::create(graph::PlanNode::Kind::kProject,
+                       {Pattern::create(graph::PlanNode::Kind::kGetNeighbors)})});
+  return pattern;
+}
+
+StatusOr<OptRule::TransformResult> PushTopNDownGetNbrsRule::transform(
+    OptContext *octx, const MatchedResult &matched) const {
+  auto *qctx = octx->qctx();
+  auto topNGroupNode = matched.node;
+  auto projectGroupNode = matched.dependencies.front().node;
+  auto gnGroupNode = matched.dependencies.front().dependencies.front().node;
+
+  const auto topN = static_cast<const TopN *>(topNGroupNode->node());
+  const auto project = static_cast<const Project *>(projectGroupNode->node());
+  const auto gn = static_cast<const GetNeighbors *>(gnGroupNode->node());
+
+  // The limit of GetNeighbors is of each vertex without an order by
+  if (gn->limit(qctx) >= 0 || !gn->orderBy().empty() || gn->random() || gn->dedup() ||
+      gn->statsOnly() || gn->edgeProps() == nullptr) {
+    return TransformResult::noTransform();
+  }
+
+  // The order by expressions are evaluated on each edge in storage
+  std::unordered_set<EdgeType> edgeTypes;
+  for (const auto &edgeProp : *gn->edgeProps()) {
+    edgeTypes.emplace(std::abs(edgeProp.get_type()));
+  }
+  auto *schemaMng = qctx->schemaMng();
+  const auto &columns = project->columns()->columns();
+  std::vector<storage::cpp2::OrderBy> orderBys;
+  orderBys.reserve(topN->factors().size());
+  for (const auto &factor : topN->factors()) {
+    const auto *expr = columns[factor.first]->expr();
+    switch (expr->kind()) {
+      case Expression::Kind::kEdgeProperty:
+      case Expression::Kind::kEdgeRank:
+      case Expression::Kind::kEdgeDst: {
+        const auto &edgeName = static_cast<const PropertyExpression *>(expr)->sym();
+        auto edgeType = schemaMng->toEdgeType(gn->space(), edgeName);
+        if (!edgeType.ok() || edgeTypes.find(edgeType.value()) == edgeTypes.end()) {
+          return TransformResult::noTransform();
+        }
+        break;
+      }
+      default:
+        return TransformResult::noTransform();
+    }
+    storage::cpp2::OrderBy orderBy;
+    orderBy.prop_ref() = expr->encode();
+    orderBy.direction_ref() = factor.second == OrderFactor::OrderType::ASCEND
+                                  ? storage::cpp2::OrderDirection::ASCENDING
+                                  : storage::cpp2::OrderDirection::DESCENDING;
+    orderBys.emplace_back(std::move(orderBy));
+  }
+
+  auto newTopN = static_cast<TopN *>(topN->clone());
+  newTopN->setOutputVar(topN->outputVar());
+  auto newTopNGroupNode = OptGroupNode::create(octx, newTopN, topNGroupNode->group());
+
+  auto newProject = static_cast<Project *>(project->clone());
+  auto newProjectGroup = OptGroup::create(octx);
+  auto newProjectGroupNode = newProjectGroup->makeGroupNode(newProject);
+
+  // The top edges of each part are returned, and merged by the TopN
+  auto newGn = static_cast<GetNeighbors *>(gn->clone());
+  newGn->setLimit(topN->offset() + topN->count());
+  newGn->setOrderBy(std::move(orderBys));
+  auto newGnGroup = OptGroup::create(octx);
+  auto newGnGroupNode = newGnGroup->makeGroupNode(newGn);
+
+  newTopNGroupNode->dependsOn(newProjectGroup);
+  newTopN->setInputVar(newProject->outputVar());
+  newProjectGroupNode->dependsOn(newGnGroup);
+  newProject->setInputVar(newGn->outputVar());
+  for (auto dep : gnGroupNode->dependencies()) {
+    newGnGroupNode->dependsOn(dep);
+  }
+
+  TransformResult result;
+  result.eraseAll = true;
+  result.newGroupNodes.emplace_back(newTopNGroupNode);
+  return result;
+}
+
+std::string PushTopNDownGetNbrsRule::toString() const {
+  return "PushTopNDownGetNbrsRule";
+}
+
+}  // namespace opt
+}  // namespace nebula
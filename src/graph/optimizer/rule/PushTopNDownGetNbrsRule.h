@@ -0,0 +1,71 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_OPTIMIZER_RULE_PUSHTOPNDOWNGETNBRSRULE_H
+#define GRAPH_OPTIMIZER_RULE_PUSHTOPNDOWNGETNBRSRULE_H
+
+#include "graph/optimizer/OptRule.h"
+
+namespace nebula {
+namespace opt {
+
+//  Embedding TopN factors into [[GetNeighbors]], so only the top edges of each part are returned
+//  by storage, and they are merged by the TopN in graphd.
+//  Required conditions:
+//   1. Match the pattern
+//   2. The sort columns are the properties, rank or destination of the traversed edges
+//   3. No limit, order by, random or dedup in the GetNeighbors, nor only the stats returned
+//  Benefits:
+//   1. Limit data early to optimize performance
+//
+//  Tranformation:
+//  Before:
+//
+//  +----------+----------+
+//  |        TopN         |
+//  +----------+----------+
+//             |
+//  +----------+----------+
+//  |       Project       |
+//  +----------+----------+
+//             |
+//   +---------+---------+
+//   |    GetNeighbors   |
+//   +---------+---------+
+//
+//  After:
+//
+//  +----------+----------+
+//  |        TopN         |
+//  +----------+----------+
+//             |
+//  +----------+----------+
+//  |       Project       |
+//  +----------+----------+
+//             |
+//   +---------+---------+
+//   |    GetNeighbors   |
+//   | (limit_=limitRows)|
+//   |(orderBy_=orderBys)|
+//   +---------+---------+
+
+class PushTopNDownGetNbrsRule final : public OptRule {
+ public:
+  const Pattern &pattern() const override;
+
+  StatusOr<OptRule::TransformResult> transform(OptContext *ctx,
+                                               const MatchedResult &matched) const override;
+
+  std::string toString() const override;
+
+ private:
+  PushTopNDownGetNbrsRule();
+
+  static std::unique_ptr<OptRule> kInstance;
+};
+
+}  // namespace opt
+}  // namespace nebula
+#endif
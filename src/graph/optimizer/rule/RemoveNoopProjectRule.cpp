@@ -45,6 +45,7 @@ namespace opt {
     PlanNode::Kind::kSort,
     PlanNode::Kind::kTopN,
     // PlanNode::Kind::kLimit, limit has no value in result
+    PlanNode::Kind::kFilterProjectLimit,
     PlanNode::Kind::kSample,
     PlanNode::Kind::kAggregate,
     // PlanNode::Kind::kDedup, dedup has no value in result
@@ -0,0 +1,84 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/optimizer/rule/SimplifyExprRule.h"
+
+#include "graph/optimizer/OptContext.h"
+#include "graph/optimizer/OptGroup.h"
+#include "graph/planner/plan/PlanNode.h"
+#include "graph/planner/plan/Query.h"
+#include "graph/util/ExpressionUtils.h"
+
+using nebula::graph::PlanNode;
+
+namespace nebula {
+namespace opt {
+
+std::unique_ptr<OptRule> SimplifyExprRule::kInstance =
+    std::unique_ptr<SimplifyExprRule>(new SimplifyExprRule());
+
+SimplifyExprRule::SimplifyExprRule() {
+  RuleSet::QueryRules().addRule(this);
+}
+
+const Pattern &SimplifyExprRule::pattern() const {
+  static Pattern pattern =
+      Pattern::create({graph::PlanNode::Kind::kFilter, graph::PlanNode::Kind::kProject});
+  return pattern;
+}
+
+StatusOr<OptRule::TransformResult> SimplifyExprRule::transform(
+    OptContext *octx, const MatchedResult &matched) const {
+  const auto *groupNode = matched.node;
+  const auto *node = groupNode->node();
+  PlanNode *newNode = nullptr;
+  if (node->kind() == PlanNode::Kind::kFilter) {
+    const auto *condition = static_cast<const graph::Filter *>(node)->condition();
+    auto *simplified = graph::ExpressionUtils::simplifyExpr(condition);
+    simplified = graph::ExpressionUtils::reduceUnaryNotExpr(simplified);
+    if (*simplified == *condition) {
+      return TransformResult::noTransform();
+    }
+    auto *newFilter = static_cast<graph::Filter *>(node->clone());
+    newFilter->setCondition(simplified);
+    newNode = newFilter;
+  } else {
+    DCHECK_EQ(node->kind(), PlanNode::Kind::kProject);
+    const auto &columns = static_cast<const graph::Project *>(node)->columns()->columns();
+    std::vector<Expression *> simplified;
+    simplified.reserve(columns.size());
+    bool changed = false;
+    for (const auto *col : columns) {
+      simplified.emplace_back(graph::ExpressionUtils::simplifyExpr(col->expr()));
+      changed = changed || *simplified.back() != *col->expr();
+    }
+    if (!changed) {
+      return TransformResult::noTransform();
+    }
+    auto *newProject = static_cast<graph::Project *>(node->clone());
+    const auto &newColumns = newProject->columns()->columns();
+    for (size_t i = 0; i < newColumns.size(); ++i) {
+      // The name of a column without alias is the text of its expression, which is kept
+      newColumns[i]->setAlias(newColumns[i]->name());
+      newColumns[i]->setExpr(simplified[i]);
+    }
+    newNode = newProject;
+  }
+  newNode->setOutputVar(node->outputVar());
+  auto *newGroupNode = OptGroupNode::create(octx, newNode, groupNode->group());
+  newGroupNode->setDeps(groupNode->dependencies());
+
+  TransformResult result;
+  result.eraseCurr = true;
+  result.newGroupNodes.emplace_back(newGroupNode);
+  return result;
+}
+
+std::string SimplifyExprRule::toString() const {
+  return "SimplifyExprRule";
+}
+
+}  // namespace opt
+}  // namespace nebula
@@ -0,0 +1,56 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_OPTIMIZER_RULE_SIMPLIFYEXPRRULE_H_
+#define GRAPH_OPTIMIZER_RULE_SIMPLIFYEXPRRULE_H_
+
+#include "graph/optimizer/OptRule.h"
+
+namespace nebula {
+namespace opt {
+
+//  Simplifies the condition of [[Filter]] and the columns of [[Project]], which are evaluated per
+//  row
+//  Required conditions:
+//   1. Match the pattern
+//   2. The expressions are changed by the simplification
+//  Benefits:
+//   1. The constants are folded once at plan time, e.g. v.age > 10 + 5  =>  v.age > 15
+//   2. The logical operands which don't change the result are removed, and so are the duplicated
+//      ones, e.g. A and true and A  =>  A
+//   3. The negations of the predicates are reduced, e.g. !(v.age > 15)  =>  v.age <= 15
+//
+//  Tranformation:
+//  Before:
+//
+//  +------+------+
+//  | Filter(A,A) |
+//  +------+------+
+//
+//  After:
+//
+//  +-----+-----+
+//  | Filter(A) |
+//  +-----+-----+
+//
+
+class SimplifyExprRule final : public OptRule {
+ public:
+  const Pattern &pattern() const override;
+
+  StatusOr<TransformResult> transform(OptContext *ctx, const MatchedResult &matched) const override;
+
+  std::string toString() const override;
+
+ private:
+  SimplifyExprRule();
+
+  static std::unique_ptr<OptRule> kInstance;
+};
+
+}  // namespace opt
+}  // namespace nebula
+
+#endif  // GRAPH_OPTIMIZER_RULE_SIMPLIFYEXPRRULE_H_
@@ -166,18 +166,27 @@ StatusOr<TransformResult> UnionAllIndexScanBaseRule::transform(OptContext* ctx,
 
   DCHECK(transformedExpr->kind() == ExprKind::kLogicalOr);
   std::vector<IndexQueryContext> idxCtxs;
+  auto costModel = ctx->costModel(scan->space());
+  // The sum of estimated rows of all index contexts, unknown if any of them has no stats
+  double totalRows = 0;
   auto logicalExpr = static_cast<const LogicalExpression*>(transformedExpr);
   for (auto operand : logicalExpr->operands()) {
     IndexQueryContext ictx;
     bool isPrefixScan = false;
-    if (!OptimizerUtils::findOptimalIndex(operand, indexItems, &isPrefixScan, &ictx)) {
+    double rows = -1;
+    if (!OptimizerUtils::findOptimalIndex(
+            operand, indexItems, &isPrefixScan, &ictx, costModel, &rows)) {
       return TransformResult::noTransform();
     }
+    totalRows = (rows < 0 || totalRows < 0) ? -1 : totalRows + rows;
     idxCtxs.emplace_back(std::move(ictx));
   }
 
   auto scanNode = IndexScan::make(qctx, nullptr);
   OptimizerUtils::copyIndexScanData(scan, scanNode, qctx);
+  if (costModel != nullptr && totalRows >= 0) {
+    scanNode->setCost(totalRows);
+  }
   scanNode->setIndexQueryContext(std::move(idxCtxs));
   scanNode->setOutputVar(filter->outputVar());
   scanNode->setColNames(filter->colNames());
@@ -0,0 +1,150 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/utils/IndexStatsUtils.h"
+#include "graph/optimizer/CardinalityFeedback.h"
+#include "graph/optimizer/CostModel.h"
+
+using nebula::cpp2::PropertyType;
+using nebula::storage::cpp2::IndexColumnHint;
+using nebula::storage::cpp2::ScanType;
+
+namespace nebula {
+namespace opt {
+
+class CostModelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    index_.index_id_ref() = 1;
+    index_.index_name_ref() = "idx";
+    std::vector<meta::cpp2::ColumnDef> cols;
+    for (auto name : {"col0", "col1"}) {
+      meta::cpp2::ColumnDef col;
+      col.name_ref() = name;
+      col.type.type_ref() = PropertyType::INT64;
+      cols.emplace_back(std::move(col));
+    }
+    index_.fields_ref() = std::move(cols);
+
+    // 10000 entries, col0 in [0, 100) and each value has 100 entries
+    IndexStatsUtils::Collector collector;
+    for (int64_t i = 0; i < 10000; ++i) {
+      auto leading = IndexKeyUtils::encodeValue(Value(i / 100));
+      collector.add(leading);
+    }
+    auto stats = std::make_shared<meta::cpp2::StatsItem>();
+    (*stats->index_stats_ref()).emplace(1, collector.finish());
+    costModel_ = std::make_unique<CostModel>(std::move(stats));
+  }
+
+  static IndexColumnHint prefixHint(const std::string& col, int64_t v) {
+    IndexColumnHint hint;
+    hint.column_name_ref() = col;
+    hint.scan_type_ref() = ScanType::PREFIX;
+    hint.begin_value_ref() = Value(v);
+    return hint;
+  }
+
+  static IndexColumnHint rangeHint(const std::string& col, Value begin, Value end) {
+    IndexColumnHint hint;
+    hint.column_name_ref() = col;
+    hint.scan_type_ref() = ScanType::RANGE;
+    if (!begin.empty()) {
+      hint.begin_value_ref() = std::move(begin);
+    }
+    if (!end.empty()) {
+      hint.end_value_ref() = std::move(end);
+    }
+    return hint;
+  }
+
+  meta::cpp2::IndexItem index_;
+  std::unique_ptr<CostModel> costModel_;
+};
+
+TEST_F(CostModelTest, EqualScan) {
+  auto rows = costModel_->estimateIndexScanRows(index_, {prefixHint("col0", 1)});
+  ASSERT_TRUE(rows.ok());
+  EXPECT_NEAR(100, rows.value(), 10);
+
+  rows = costModel_->estimateIndexScanRows(index_, {prefixHint("col0", 1), prefixHint("col1", 1)});
+  ASSERT_TRUE(rows.ok());
+  EXPECT_NEAR(100 * CostModel::kDefaultEqualSelectivity, rows.value(), 1);
+}
+
+TEST_F(CostModelTest, RangeScan) {
+  auto rows = costModel_->estimateIndexScanRows(index_, {rangeHint("col0", Value(50L), Value())});
+  ASSERT_TRUE(rows.ok());
+  EXPECT_NEAR(5000, rows.value(), 500);
+
+  rows = costModel_->estimateIndexScanRows(index_, {rangeHint("col0", Value(), Value(10L))});
+  ASSERT_TRUE(rows.ok());
+  EXPECT_NEAR(1000, rows.value(), 500);
+
+  // Mismatched type falls back to the default selectivity
+  rows = costModel_->estimateIndexScanRows(index_, {rangeHint("col0", Value("a"), Value())});
+  ASSERT_TRUE(rows.ok());
+  EXPECT_NEAR(10000 * CostModel::kDefaultRangeSelectivity, rows.value(), 1);
+}
+
+TEST_F(CostModelTest, NoStats) {
+  index_.index_id_ref() = 2;
+  auto rows = costModel_->estimateIndexScanRows(index_, {prefixHint("col0", 1)});
+  EXPECT_FALSE(rows.ok());
+}
+
+TEST_F(CostModelTest, CardinalityFeedback) {
+  auto& feedback = CardinalityFeedback::instance();
+  feedback.clear();
+  std::vector<IndexColumnHint> hints = {prefixHint("col0", 1)};
+  auto key = CardinalityFeedback::indexScanKey(1, hints);
+  EXPECT_EQ("index 1(col0==1)", key);
+
+  auto rows = costModel_->estimateIndexScanRows(index_, hints);
+  ASSERT_TRUE(rows.ok());
+  auto estimated = rows.value();
+  // The value is skewed, 10 times of the rows estimated are returned
+  std::string query = "LOOKUP ON t WHERE t.col0 == 1";
+  feedback.record(key, query, estimated, static_cast<int64_t>(estimated * 10));
+  rows = costModel_->estimateIndexScanRows(index_, hints);
+  ASSERT_TRUE(rows.ok());
+  EXPECT_NEAR(estimated * 10, rows.value(), 1);
+
+  // Smoothed with the previous runs, and other values are not affected
+  feedback.record(key, query, rows.value(), static_cast<int64_t>(estimated * 40));
+  rows = costModel_->estimateIndexScanRows(index_, hints);
+  ASSERT_TRUE(rows.ok());
+  EXPECT_NEAR(estimated * 20, rows.value(), 1);
+  rows = costModel_->estimateIndexScanRows(index_, {prefixHint("col0", 2)});
+  ASSERT_TRUE(rows.ok());
+  EXPECT_NEAR(estimated, rows.value(), 1);
+
+  auto entries = feedback.misestimates();
+  ASSERT_EQ(1, entries.size());
+  EXPECT_EQ(key, entries[0].key);
+  EXPECT_EQ(2, entries[0].runs);
+  EXPECT_NEAR(20, entries[0].correction, 0.1);
+  EXPECT_EQ(query, entries[0].query);
+  feedback.clear();
+}
+
+TEST_F(CostModelTest, MergeStats) {
+  IndexStatsUtils::Collector lhs, rhs;
+  for (int64_t i = 0; i < 1000; ++i) {
+    lhs.add(IndexKeyUtils::encodeValue(Value(i % 10)));
+    rhs.add(IndexKeyUtils::encodeValue(Value(i % 20)));
+  }
+  auto stats = lhs.finish();
+  IndexStatsUtils::merge(stats, rhs.finish());
+  EXPECT_EQ(2000, stats.get_entries());
+  EXPECT_NEAR(20, stats.get_leading_ndv(), 2);
+  EXPECT_LE(stats.get_leading_bounds().size(), IndexStatsUtils::kMaxBounds);
+  EXPECT_TRUE(std::is_sorted(stats.get_leading_bounds().begin(), stats.get_leading_bounds().end()));
+}
+
+}  // namespace opt
+}  // namespace nebula
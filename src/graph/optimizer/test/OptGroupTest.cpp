@@ -0,0 +1,81 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/context/QueryContext.h"
+#include "graph/optimizer/OptContext.h"
+#include "graph/optimizer/OptGroup.h"
+#include "graph/planner/plan/Logic.h"
+#include "graph/planner/plan/Query.h"
+
+using nebula::graph::PlanNode;
+using nebula::graph::QueryContext;
+using nebula::graph::StartNode;
+using nebula::graph::Union;
+
+namespace nebula {
+namespace opt {
+
+class OptGroupTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    qctx_ = std::make_unique<QueryContext>();
+    octx_ = std::make_unique<OptContext>(qctx_.get());
+    octx_->setCostFunc([this](const PlanNode*) {
+      ++numCosted_;
+      return 1.0;
+    });
+  }
+
+  // Each level unions the group of the level below with itself, so the number of the paths to
+  // the bottom doubles with each level
+  OptGroup* makeDiamonds(size_t levels) {
+    auto* start = StartNode::make(qctx_.get());
+    auto* group = OptGroup::create(octx_.get());
+    group->makeGroupNode(start);
+    PlanNode* below = start;
+    for (size_t i = 0; i < levels; ++i) {
+      auto* node = Union::make(qctx_.get(), below, below);
+      auto* upper = OptGroup::create(octx_.get());
+      auto* groupNode = upper->makeGroupNode(node);
+      groupNode->dependsOn(group);
+      groupNode->dependsOn(group);
+      group = upper;
+      below = node;
+    }
+    return group;
+  }
+
+  std::unique_ptr<QueryContext> qctx_;
+  std::unique_ptr<OptContext> octx_;
+  size_t numCosted_{0};
+};
+
+TEST_F(OptGroupTest, CostOfSharedGroups) {
+  auto* root = makeDiamonds(40);
+  // The cost of the whole tree, while each group node is costed once
+  EXPECT_DOUBLE_EQ(2199023255551.0, root->getCost());
+  EXPECT_EQ(41UL, numCosted_);
+  EXPECT_DOUBLE_EQ(2199023255551.0, root->getCost());
+  EXPECT_EQ(41UL, numCosted_);
+}
+
+TEST_F(OptGroupTest, InvalidateCosts) {
+  auto* root = makeDiamonds(2);
+  EXPECT_DOUBLE_EQ(7.0, root->getCost());
+  EXPECT_EQ(3UL, numCosted_);
+
+  // Costed again once the plan nodes are changed
+  octx_->invalidateCosts();
+  EXPECT_DOUBLE_EQ(7.0, root->getCost());
+  EXPECT_EQ(6UL, numCosted_);
+
+  octx_->setCostFunc([](const PlanNode*) { return 2.0; });
+  EXPECT_DOUBLE_EQ(14.0, root->getCost());
+}
+
+}  // namespace opt
+}  // namespace nebula
@@ -0,0 +1,130 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/context/QueryContext.h"
+#include "graph/optimizer/OptContext.h"
+#include "graph/optimizer/OptGroup.h"
+#include "graph/optimizer/rule/PushLimitDownTraverseAppendVerticesRule.h"
+#include "graph/planner/plan/Logic.h"
+#include "graph/planner/plan/Query.h"
+
+using nebula::graph::AppendVertices;
+using nebula::graph::Limit;
+using nebula::graph::QueryContext;
+using nebula::graph::StartNode;
+using nebula::graph::Traverse;
+using nebula::storage::cpp2::VertexProp;
+
+namespace nebula {
+namespace opt {
+
+class PushLimitDownTraverseRuleTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    qctx_ = std::make_unique<QueryContext>();
+    octx_ = std::make_unique<OptContext>(qctx_.get());
+
+    auto* start = StartNode::make(qctx_.get());
+    traverse_ = Traverse::make(qctx_.get(), start, 1);
+    av_ = AppendVertices::make(qctx_.get(), traverse_, 1);
+    av_->setInputVar(traverse_->outputVar());
+    VertexProp prop;
+    prop.tag_ref() = 1;
+    av_->setVertexProps(std::make_unique<std::vector<VertexProp>>(std::vector<VertexProp>{prop}));
+    limit_ = Limit::make(qctx_.get(), av_, 2, 3);
+    limit_->setInputVar(av_->outputVar());
+  }
+
+  // Build the memo of Limit->AppendVertices->Traverse
+  OptGroupNode* buildGroups() {
+    auto* traverseGroup = OptGroup::create(octx_.get());
+    traverseGroup->makeGroupNode(traverse_);
+    auto* avGroup = OptGroup::create(octx_.get());
+    avGroup->makeGroupNode(av_)->dependsOn(traverseGroup);
+    auto* limitGroup = OptGroup::create(octx_.get());
+    auto* limitGroupNode = limitGroup->makeGroupNode(limit_);
+    limitGroupNode->dependsOn(avGroup);
+    return limitGroupNode;
+  }
+
+  bool matches() {
+    return rule_->match(octx_.get(), buildGroups()).ok();
+  }
+
+  // The rule registered to the query rules
+  static const OptRule* findRule() {
+    for (const auto* rule : RuleSet::QueryRules().rules()) {
+      if (rule->toString() == "PushLimitDownTraverseAppendVerticesRule") {
+        return rule;
+      }
+    }
+    return nullptr;
+  }
+
+  const OptRule* rule_ = DCHECK_NOTNULL(findRule());
+  std::unique_ptr<QueryContext> qctx_;
+  std::unique_ptr<OptContext> octx_;
+  Traverse* traverse_{nullptr};
+  AppendVertices* av_{nullptr};
+  Limit* limit_{nullptr};
+};
+
+TEST_F(PushLimitDownTraverseRuleTest, Transform) {
+  auto matched = rule_->match(octx_.get(), buildGroups());
+  ASSERT_TRUE(matched.ok());
+  auto result = rule_->transform(octx_.get(), matched.value());
+  ASSERT_TRUE(result.ok());
+  ASSERT_EQ(1, result.value().newGroupNodes.size());
+
+  auto* limitGroupNode = result.value().newGroupNodes.front();
+  ASSERT_EQ(graph::PlanNode::Kind::kLimit, limitGroupNode->node()->kind());
+  auto* avGroupNode = limitGroupNode->dependencies().front()->groupNodes().front();
+  ASSERT_EQ(graph::PlanNode::Kind::kAppendVertices, avGroupNode->node()->kind());
+  auto* traverseGroupNode = avGroupNode->dependencies().front()->groupNodes().front();
+  auto* traverse = static_cast<const Traverse*>(traverseGroupNode->node());
+  ASSERT_EQ(graph::PlanNode::Kind::kTraverse, traverse->kind());
+  // The rows skipped by the offset are counted too
+  EXPECT_EQ(5, traverse->pathLimit());
+  // The dsts of the paths are checked by the props AppendVertices reads
+  ASSERT_NE(nullptr, traverse->limitDstProps());
+  ASSERT_EQ(1, traverse->limitDstProps()->size());
+  EXPECT_EQ(1, traverse->limitDstProps()->front().get_tag());
+}
+
+TEST_F(PushLimitDownTraverseRuleTest, Match) {
+  EXPECT_TRUE(matches());
+}
+
+TEST_F(PushLimitDownTraverseRuleTest, NotMatchVertexFilter) {
+  av_->setVertexFilter(ConstantExpression::make(qctx_->objPool(), Value(true)));
+  EXPECT_FALSE(matches());
+}
+
+TEST_F(PushLimitDownTraverseRuleTest, NotMatchFilter) {
+  av_->setFilter(ConstantExpression::make(qctx_->objPool(), Value(true)));
+  EXPECT_FALSE(matches());
+}
+
+TEST_F(PushLimitDownTraverseRuleTest, NotMatchPushedLimit) {
+  av_->setLimit(1);
+  EXPECT_FALSE(matches());
+}
+
+TEST_F(PushLimitDownTraverseRuleTest, NotMatchOrderBy) {
+  storage::cpp2::OrderBy orderBy;
+  orderBy.prop_ref() = "name";
+  av_->setOrderBy({orderBy});
+  EXPECT_FALSE(matches());
+}
+
+TEST_F(PushLimitDownTraverseRuleTest, NotMatchNoProps) {
+  av_->setVertexProps(nullptr);
+  EXPECT_FALSE(matches());
+}
+
+}  // namespace opt
+}  // namespace nebula
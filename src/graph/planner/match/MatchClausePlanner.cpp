@@ -10,6 +10,7 @@
 #include "graph/planner/match/SegmentsConnector.h"
 #include "graph/planner/match/ShortestPathPlanner.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 
 namespace nebula {
 namespace graph {
@@ -28,8 +29,10 @@ StatusOr<SubPlan> MatchClausePlanner::transform(CypherClauseContextBase* clauseC
   for (auto iter = pathInfos.begin(); iter < pathInfos.end(); ++iter) {
     auto& nodeInfos = iter->nodeInfos;
     SubPlan pathPlan;
+    MatchPathPlanner matchPathPlanner;
+    const MatchPathPlanner* pathPlanner = nullptr;
     if (iter->pathType == Path::PathType::kDefault) {
-      MatchPathPlanner matchPathPlanner;
+      pathPlanner = &matchPathPlanner;
       auto result = matchPathPlanner.transform(matchClauseCtx->qctx,
                                                matchClauseCtx->space.id,
                                                matchClauseCtx->where.get(),
@@ -49,8 +52,8 @@ StatusOr<SubPlan> MatchClausePlanner::transform(CypherClauseContextBase* clauseC
       NG_RETURN_IF_ERROR(result);
       pathPlan = std::move(result).value();
     }
-    NG_RETURN_IF_ERROR(
-        connectPathPlan(nodeInfos, matchClauseCtx, pathPlan, nodeAliasesSeen, matchClausePlan));
+    NG_RETURN_IF_ERROR(connectPathPlan(
+        nodeInfos, matchClauseCtx, pathPlan, pathPlanner, nodeAliasesSeen, matchClausePlan));
   }
   return matchClausePlan;
 }
@@ -58,6 +61,7 @@ StatusOr<SubPlan> MatchClausePlanner::transform(CypherClauseContextBase* clauseC
 Status MatchClausePlanner::connectPathPlan(const std::vector<NodeInfo>& nodeInfos,
                                            MatchClauseContext* matchClauseCtx,
                                            const SubPlan& subplan,
+                                           const MatchPathPlanner* pathPlanner,
                                            std::unordered_set<std::string>& nodeAliasesSeen,
                                            SubPlan& matchClausePlan) {
   std::unordered_set<std::string> intersectedAliases;
@@ -79,6 +83,18 @@ Status MatchClausePlanner::connectPathPlan(const std::vector<NodeInfo>& nodeInfo
       matchClausePlan =
           SegmentsConnector::cartesianProduct(matchClauseCtx->qctx, matchClausePlan, subplan);
     } else {
+      if (FLAGS_enable_join_vid_filter && intersectedAliases.size() == 1 &&
+          pathPlanner != nullptr && pathPlanner->startScan() != nullptr) {
+        const auto& alias = *intersectedAliases.begin();
+        auto readers = pathPlanner->vidReaders().find(alias);
+        if (readers != pathPlanner->vidReaders().end()) {
+          SegmentsConnector::passVidFilter(matchClauseCtx->qctx,
+                                           matchClausePlan,
+                                           pathPlanner->startScan(),
+                                           alias,
+                                           readers->second);
+        }
+      }
       // TODO: Actually a natural join would be much easy use.
       matchClausePlan = SegmentsConnector::innerJoin(
           matchClauseCtx->qctx, matchClausePlan, subplan, intersectedAliases);
@@ -10,6 +10,8 @@
 
 namespace nebula {
 namespace graph {
+class MatchPathPlanner;
+
 // The MatchClausePlanner generates plan for match clause;
 class MatchClausePlanner final : public CypherClausePlanner {
  public:
@@ -21,6 +23,7 @@ class MatchClausePlanner final : public CypherClausePlanner {
   Status connectPathPlan(const std::vector<NodeInfo>& nodeInfos,
                          MatchClauseContext* matchClauseCtx,
                          const SubPlan& subplan,
+                         const MatchPathPlanner* pathPlanner,
                          std::unordered_set<std::string>& nodeAliasesSeen,
                          SubPlan& matchClausePlan);
 };
@@ -12,6 +12,7 @@
 #include "graph/planner/plan/Algo.h"
 #include "graph/planner/plan/Logic.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 #include "graph/util/ExpressionUtils.h"
 #include "graph/util/SchemaUtil.h"
 #include "graph/visitor/RewriteVisitor.h"
@@ -56,6 +57,43 @@ static Expression* genEdgeFilter(const EdgeInfo& edge) {
   return edge.filter;
 }
 
+// Whether only the paths of the steps are returned, so the dsts of the last step are all of them
+static bool isFixedSteps(const EdgeInfo& edge) {
+  return edge.range == nullptr || (edge.range->min() > 0 && edge.range->min() == edge.range->max());
+}
+
+static bool isSingleStep(const EdgeInfo& edge) {
+  return edge.range == nullptr || (edge.range->min() == 1 && edge.range->max() == 1);
+}
+
+static MatchEdge::Direction reverseDirection(MatchEdge::Direction direction) {
+  switch (direction) {
+    case MatchEdge::Direction::OUT_EDGE:
+      return MatchEdge::Direction::IN_EDGE;
+    case MatchEdge::Direction::IN_EDGE:
+      return MatchEdge::Direction::OUT_EDGE;
+    default:
+      return direction;
+  }
+}
+
+static bool isScan(const PlanNode* node) {
+  switch (node->kind()) {
+    case PlanNode::Kind::kIndexScan:
+    case PlanNode::Kind::kTagIndexFullScan:
+    case PlanNode::Kind::kTagIndexPrefixScan:
+    case PlanNode::Kind::kTagIndexRangeScan:
+    case PlanNode::Kind::kEdgeIndexFullScan:
+    case PlanNode::Kind::kEdgeIndexPrefixScan:
+    case PlanNode::Kind::kEdgeIndexRangeScan:
+    case PlanNode::Kind::kScanVertices:
+    case PlanNode::Kind::kScanEdges:
+      return true;
+    default:
+      return false;
+  }
+}
+
 static Expression* nodeId(ObjectPool* pool, const NodeInfo& node) {
   return AttributeExpression::make(
       pool, InputPropertyExpression::make(pool, node.alias), ConstantExpression::make(pool, kVid));
@@ -135,6 +173,11 @@ Status MatchPathPlanner::findStarts(
           return plan.status();
         }
         matchClausePlan = std::move(plan).value();
+        auto* root = matchClausePlan.root;
+        if (root->kind() == PlanNode::Kind::kIndexScan &&
+            !static_cast<IndexScan*>(root)->isEdge()) {
+          vidReaders_[nodeInfos[i].alias].emplace_back(static_cast<Explore*>(root));
+        }
         startIndex = i;
         foundStart = true;
         initialExpr_ = nodeCtx.initialExpr->clone();
@@ -169,6 +212,9 @@ Status MatchPathPlanner::findStarts(
     return Status::SemanticError("Can't solve the start vids from the sentence.");
   }
 
+  if (isScan(matchClausePlan.tail)) {
+    startScan_ = matchClausePlan.tail;
+  }
   if (matchClausePlan.tail->isSingleInput()) {
     auto start = StartNode::make(qctx);
     matchClausePlan.tail->setDep(0, start);
@@ -280,6 +326,9 @@ Status MatchPathPlanner::leftExpandFromNode(
                             edge,
                             startIndex + 1 == nodeInfos.size() ? i != startIndex : true));
     subplan.root = traverse;
+    if (isFixedSteps(edge)) {
+      vidReaders_[dst.alias].emplace_back(traverse);
+    }
     nextTraverseStart = genNextTraverseStart(qctx->objPool(), edge);
     inputVar = traverse->outputVar();
     if (expandInto) {
@@ -307,6 +356,7 @@ Status MatchPathPlanner::leftExpandFromNode(
   appendV->setTrackPrevPath(!edgeInfos.empty());
   appendV->setColNames(genAppendVColNames(subplan.root->colNames(), node, !edgeInfos.empty()));
   subplan.root = appendV;
+  vidReaders_[node.alias].emplace_back(appendV);
 
   return Status::OK();
 }
@@ -330,6 +380,42 @@ Status MatchPathPlanner::rightExpandFromNode(
       nodeAliasesSeenInPattern.emplace(node.alias);
     }
     auto& edge = edgeInfos[i];
+    if (FLAGS_enable_match_expand_intersect && !expandInto && i + 1 < edgeInfos.size() &&
+        isSingleStep(edge) && isSingleStep(edgeInfos[i + 1])) {
+      auto& end = nodeInfos[i + 2];
+      if (end.alias != dst.alias &&
+          nodeAliasesSeenInPattern.find(end.alias) != nodeAliasesSeenInPattern.end()) {
+        // Pattern: (end)-...-(node)-[edge]-(dst)-[]-(end), the cycle is closed by intersecting
+        // the neighbors of node and end, instead of expanding all the paths of node
+        auto& dstEdge = edgeInfos[i + 1];
+        auto expand = ExpandIntersect::make(qctx, subplan.root, spaceId);
+        expand->setSrc(nextTraverseStart);
+        expand->setDst(nodeId(qctx->objPool(), end));
+        auto vertexProps = SchemaUtil::getAllVertexProp(qctx, spaceId, true);
+        NG_RETURN_IF_ERROR(vertexProps);
+        expand->setVertexProps(std::move(vertexProps).value());
+        expand->setEdgeProps(SchemaUtil::getEdgeProps(edge, reversely, qctx, spaceId));
+        expand->setEdgeDirection(edge.direction);
+        expand->setDstEdgeProps(SchemaUtil::getEdgeProps(dstEdge, !reversely, qctx, spaceId));
+        expand->setDstEdgeDirection(reverseDirection(dstEdge.direction));
+        expand->setVertexFilter(genVertexFilter(node));
+        expand->setEdgeFilter(genEdgeFilter(edge));
+        expand->setMidVertexFilter(genVertexFilter(dst));
+        expand->setDstEdgeFilter(genEdgeFilter(dstEdge));
+        expand->setTrackPrevPath(i != startIndex);
+        auto colNames =
+            genTraverseColNames(subplan.root->colNames(), node, edge, i != startIndex);
+        expand->setColNames(genTraverseColNames(colNames, dst, dstEdge, true));
+        subplan.root = expand;
+        if (!dst.anonymous) {
+          nodeAliasesSeenInPattern.emplace(dst.alias);
+        }
+        nextTraverseStart = genNextTraverseStart(qctx->objPool(), dstEdge);
+        inputVar = expand->outputVar();
+        ++i;
+        continue;
+      }
+    }
     auto traverse = Traverse::make(qctx, subplan.root, spaceId);
     traverse->setSrc(nextTraverseStart);
     auto vertexProps = SchemaUtil::getAllVertexProp(qctx, spaceId, true);
@@ -345,6 +431,9 @@ Status MatchPathPlanner::rightExpandFromNode(
     traverse->setColNames(
         genTraverseColNames(subplan.root->colNames(), node, edge, i != startIndex));
     subplan.root = traverse;
+    if (isFixedSteps(edge)) {
+      vidReaders_[dst.alias].emplace_back(traverse);
+    }
     nextTraverseStart = genNextTraverseStart(qctx->objPool(), edge);
     if (expandInto) {
       auto* startVid = nodeId(qctx->objPool(), dst);
@@ -370,6 +459,7 @@ Status MatchPathPlanner::rightExpandFromNode(
   appendV->setTrackPrevPath(!edgeInfos.empty());
   appendV->setColNames(genAppendVColNames(subplan.root->colNames(), node, !edgeInfos.empty()));
   subplan.root = appendV;
+  vidReaders_[node.alias].emplace_back(appendV);
 
   return Status::OK();
 }
@@ -8,6 +8,8 @@
 
 namespace nebula {
 namespace graph {
+class Explore;
+
 // The MatchPathPlanner generates plan for match clause;
 class MatchPathPlanner final {
  public:
@@ -20,6 +22,18 @@ class MatchPathPlanner final {
                               std::unordered_set<std::string> nodeAliasesSeen,
                               Path& path);
 
+  // The scan the plan starts from, nullptr if it starts from the input, e.g. the given vids
+  PlanNode* startScan() const {
+    return startScan_;
+  }
+
+  // The nodes of the plan reading the vids of each node alias, the rows of which are all dropped
+  // if the vid is not read, so that they could only read the vids of the alias in another plan
+  // joined with this one
+  const std::unordered_map<std::string, std::vector<Explore*>>& vidReaders() const {
+    return vidReaders_;
+  }
+
  private:
   Status findStarts(std::vector<NodeInfo>& nodeInfos,
                     std::vector<EdgeInfo>& edgeInfos,
@@ -76,6 +90,8 @@ class MatchPathPlanner final {
 
  private:
   Expression* initialExpr_{nullptr};
+  PlanNode* startScan_{nullptr};
+  std::unordered_map<std::string, std::vector<Explore*>> vidReaders_;
 };
 }  // namespace graph
 }  // namespace nebula
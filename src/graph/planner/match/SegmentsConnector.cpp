@@ -34,6 +34,21 @@ SubPlan SegmentsConnector::innerJoin(QueryContext* qctx,
   return newPlan;
 }
 
+void SegmentsConnector::passVidFilter(QueryContext* qctx,
+                                      const SubPlan& left,
+                                      PlanNode* rightStartScan,
+                                      const std::string& alias,
+                                      const std::vector<Explore*>& readers) {
+  // The scan reads nothing from its input, it only waits for the left plan now
+  rightStartScan->setDep(0, left.root);
+  auto pool = qctx->objPool();
+  for (auto* reader : readers) {
+    auto* args = ArgumentList::make(pool);
+    args->addArgument(InputPropertyExpression::make(pool, alias));
+    reader->setVidFilter(left.root->outputVar(), FunctionCallExpression::make(pool, "id", args));
+  }
+}
+
 SubPlan SegmentsConnector::leftJoin(QueryContext* qctx,
                                     const SubPlan& left,
                                     const SubPlan& right,
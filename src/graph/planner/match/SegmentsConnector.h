@@ -13,6 +13,8 @@
 
 namespace nebula {
 namespace graph {
+class Explore;
+
 // The SegmentsConnector is a util to help connecting the plan segment.
 class SegmentsConnector final {
  public:
@@ -26,6 +28,16 @@ class SegmentsConnector final {
                            const SubPlan& right,
                            const std::unordered_set<std::string>& intersectedAliases);
 
+  /**
+   * Read the right plan after the left one, from the scan it starts from, so that the readers of
+   * the vids of the alias in the right plan only read the vids of the alias in the left one.
+   */
+  static void passVidFilter(QueryContext* qctx,
+                            const SubPlan& left,
+                            PlanNode* rightStartScan,
+                            const std::string& alias,
+                            const std::vector<Explore*>& readers);
+
   /**
    * LeftJoin two plan on node id
    */
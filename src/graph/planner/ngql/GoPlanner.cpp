@@ -6,6 +6,7 @@
 #include "graph/planner/ngql/GoPlanner.h"
 
 #include "graph/planner/plan/Logic.h"
+#include "graph/service/GraphFlags.h"
 #include "graph/util/ExpressionUtils.h"
 #include "graph/util/PlannerUtil.h"
 
@@ -444,6 +445,23 @@ SubPlan GoPlanner::nStepsPlan(SubPlan& startVidPlan) {
   return subPlan;
 }
 
+SubPlan GoPlanner::kHopStepsPlan(SubPlan& startVidPlan) {
+  auto qctx = goCtx_->qctx;
+
+  auto* gn = GetNeighbors::make(qctx, startVidPlan.root, goCtx_->space.id);
+  gn->setSrc(goCtx_->from.src);
+  gn->setEdgeProps(buildEdgeProps(true));
+  gn->setInputVar(goCtx_->vidsVar);
+  gn->setSteps(goCtx_->steps.steps() - 1);
+
+  auto* getDst = PlannerUtil::extractDstFromGN(qctx, gn, goCtx_->vidsVar);
+
+  SubPlan subPlan;
+  subPlan.root = lastStep(getDst, nullptr);
+  subPlan.tail = startVidPlan.tail != nullptr ? startVidPlan.tail : gn;
+  return subPlan;
+}
+
 SubPlan GoPlanner::mToNStepsPlan(SubPlan& startVidPlan) {
   auto qctx = goCtx_->qctx;
   auto joinInput = goCtx_->joinInput;
@@ -538,6 +556,11 @@ StatusOr<SubPlan> GoPlanner::transform(AstContext* astCtx) {
   if (steps.steps() == 1) {
     return oneStepPlan(startPlan);
   }
+  // The start vids of each step have to be tracked to join the input, and the sample or limit
+  // of each step is applied by graphd
+  if (FLAGS_enable_khop_get_neighbors && !goCtx_->joinInput && goCtx_->limits.empty()) {
+    return kHopStepsPlan(startPlan);
+  }
   return nStepsPlan(startPlan);
 }
 
@@ -36,6 +36,9 @@ class GoPlanner final : public Planner {
 
   SubPlan nStepsPlan(SubPlan& startVidPlan);
 
+  // The steps before the last one are expanded inside storaged
+  SubPlan kHopStepsPlan(SubPlan& startVidPlan);
+
   SubPlan mToNStepsPlan(SubPlan& startVidPlan);
 
  private:
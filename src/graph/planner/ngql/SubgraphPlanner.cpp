@@ -67,6 +67,8 @@ StatusOr<SubPlan> SubgraphPlanner::nSteps(SubPlan& startVidPlan, const std::stri
   gn->setVertexProps(std::move(vertexProps).value());
   gn->setEdgeProps(std::move(edgeProps).value());
   gn->setInputVar(input);
+  auto dstFilterVar = qctx->vctx()->anonVarGen()->getVar();
+  gn->setDstFilterVar(dstFilterVar);
 
   auto resultVar = qctx->vctx()->anonVarGen()->getVar();
   auto loopSteps = qctx->vctx()->anonVarGen()->getVar();
@@ -74,6 +76,7 @@ StatusOr<SubPlan> SubgraphPlanner::nSteps(SubPlan& startVidPlan, const std::stri
   auto* subgraph = Subgraph::make(qctx, gn, resultVar, loopSteps, steps.steps() + 1);
   subgraph->setOutputVar(input);
   subgraph->setBiDirectEdgeTypes(subgraphCtx_->biDirectEdgeTypes);
+  subgraph->setDstFilterVar(dstFilterVar);
   subgraph->setColNames({nebula::kVid});
   uint32_t maxSteps = steps.steps();
   if (subgraphCtx_->getEdgeProp || subgraphCtx_->withProp) {
@@ -121,6 +121,18 @@ class ShowMetaLeaderNode final : public SingleDependencyNode {
       : SingleDependencyNode(qctx, Kind::kShowMetaLeader, dep) {}
 };
 
+class ShowCardinalityFeedback final : public SingleDependencyNode {
+ public:
+  static ShowCardinalityFeedback* make(QueryContext* qctx, PlanNode* dep) {
+    return qctx->objPool()->makeAndAdd<ShowCardinalityFeedback>(qctx, dep);
+  }
+
+ private:
+  friend ObjectPool;
+  ShowCardinalityFeedback(QueryContext* qctx, PlanNode* dep)
+      : SingleDependencyNode(qctx, Kind::kShowCardinalityFeedback, dep) {}
+};
+
 class CreateSpace final : public SingleDependencyNode {
  public:
   static CreateSpace* make(QueryContext* qctx,
@@ -162,8 +174,10 @@ class CreateSpaceAsNode final : public SingleDependencyNode {
   static CreateSpaceAsNode* make(QueryContext* qctx,
                                  PlanNode* input,
                                  const std::string& oldSpaceName,
-                                 const std::string& newSpaceName) {
-    return qctx->objPool()->makeAndAdd<CreateSpaceAsNode>(qctx, input, oldSpaceName, newSpaceName);
+                                 const std::string& newSpaceName,
+                                 bool withData = false) {
+    return qctx->objPool()->makeAndAdd<CreateSpaceAsNode>(
+        qctx, input, oldSpaceName, newSpaceName, withData);
   }
 
   std::unique_ptr<PlanNodeDescription> explain() const override;
@@ -177,16 +191,26 @@ class CreateSpaceAsNode final : public SingleDependencyNode {
     return newSpaceName_;
   }
 
+  bool withData() const {
+    return withData_;
+  }
+
  private:
   friend ObjectPool;
-  CreateSpaceAsNode(QueryContext* qctx, PlanNode* input, std::string oldName, std::string newName)
+  CreateSpaceAsNode(QueryContext* qctx,
+                    PlanNode* input,
+                    std::string oldName,
+                    std::string newName,
+                    bool withData)
       : SingleDependencyNode(qctx, Kind::kCreateSpaceAs, input),
         oldSpaceName_(std::move(oldName)),
-        newSpaceName_(std::move(newName)) {}
+        newSpaceName_(std::move(newName)),
+        withData_(withData) {}
 
  private:
   std::string oldSpaceName_;
   std::string newSpaceName_;
+  bool withData_{false};
 };
 
 class DropSpace final : public SingleDependencyNode {
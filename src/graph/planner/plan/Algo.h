@@ -285,6 +285,16 @@ class Subgraph final : public SingleInputNode {
     biDirectEdgeTypes_ = std::move(edgeTypes);
   }
 
+  const std::string& dstFilterVar() const {
+    return dstFilterVar_;
+  }
+
+  // The variable to set the visited vids to before the last step, which only needs the edges
+  // among them
+  void setDstFilterVar(std::string dstFilterVar) {
+    dstFilterVar_ = std::move(dstFilterVar);
+  }
+
  private:
   friend ObjectPool;
   Subgraph(QueryContext* qctx,
@@ -301,6 +311,7 @@ class Subgraph final : public SingleInputNode {
   std::string currentStepVar_;
   uint32_t steps_;
   std::unordered_set<EdgeType> biDirectEdgeTypes_;
+  std::string dstFilterVar_;
 };
 
 class BiCartesianProduct final : public BinaryInputNode {
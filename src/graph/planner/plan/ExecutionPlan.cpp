@@ -32,6 +32,15 @@ uint64_t ExecutionPlan::makePlanNodeDesc(const PlanNode* node) {
   auto& planNodeDesc = planDescription_->planNodeDescs.back();
   planNodeDesc.profiles = std::make_unique<std::vector<ProfilingStats>>();
 
+  auto alternatives = rejectedAlternatives_.find(node->id());
+  if (alternatives != rejectedAlternatives_.end()) {
+    if (planNodeDesc.description == nullptr) {
+      planNodeDesc.description = std::make_unique<std::vector<Pair>>();
+    }
+    planNodeDesc.description->emplace_back(
+        Pair{"rejectedAlternatives", folly::join(", ", alternatives->second)});
+  }
+
   if (node->kind() == PlanNode::Kind::kSelect) {
     auto select = static_cast<const Select*>(node);
     setPlanNodeDeps(select, &planNodeDesc);
@@ -7,6 +7,8 @@
 #define GRAPH_PLANNER_PLAN_EXECUTIONPLAN_H_
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace nebula {
 
@@ -47,6 +49,11 @@ class ExecutionPlan final {
 
   void addProfileStats(int64_t planNodeId, ProfilingStats&& profilingStats);
 
+  // The equivalent plan nodes rejected by the optimizer in favor of the plan node, shown in explain
+  void addRejectedAlternatives(int64_t planNodeId, std::vector<std::string> alternatives) {
+    rejectedAlternatives_[planNodeId] = std::move(alternatives);
+  }
+
   void describe(PlanDescription* planDesc);
 
   void setExplainFormat(const std::string& format) {
@@ -68,6 +75,7 @@ class ExecutionPlan final {
   // plan description for explain and profile query
   PlanDescription* planDescription_{nullptr};
   std::string explainFormat_;
+  std::unordered_map<int64_t, std::vector<std::string>> rejectedAlternatives_;
 };
 
 }  // namespace graph
@@ -55,6 +55,9 @@ std::unique_ptr<PlanNodeDescription> CreateIndexNode::explain() const {
   if (indexParams_) {
     addDescription("indexParams", folly::toJson(util::toJson(*indexParams_)), desc.get());
   }
+  if (!includeFields_.empty()) {
+    addDescription("includeFields", folly::toJson(util::toJson(includeFields_)), desc.get());
+  }
   return desc;
 }
 
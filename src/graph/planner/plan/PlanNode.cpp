@@ -81,6 +81,8 @@ const char* PlanNode::toString(PlanNode::Kind kind) {
       return "TopN";
     case Kind::kLimit:
       return "Limit";
+    case Kind::kFilterProjectLimit:
+      return "FilterProjectLimit";
     case Kind::kSample:
       return "Sample";
     case Kind::kAggregate:
@@ -218,6 +220,8 @@ const char* PlanNode::toString(PlanNode::Kind kind) {
       return "ShowHosts";
     case Kind::kShowMetaLeader:
       return "ShowMetaLeader";
+    case Kind::kShowCardinalityFeedback:
+      return "ShowCardinalityFeedback";
     case Kind::kShowParts:
       return "ShowParts";
     case Kind::kShowCharset:
@@ -286,6 +290,8 @@ const char* PlanNode::toString(PlanNode::Kind kind) {
       return "KillQuery";
     case Kind::kTraverse:
       return "Traverse";
+    case Kind::kExpandIntersect:
+      return "ExpandIntersect";
     case Kind::kAppendVertices:
       return "AppendVertices";
     case Kind::kBiLeftJoin:
@@ -28,6 +28,7 @@ class PlanNode {
     kGetVertices,
     kGetEdges,
     kTraverse,
+    kExpandIntersect,
     kAppendVertices,
     kShortestPath,
 
@@ -53,6 +54,7 @@ class PlanNode {
     kSort,
     kTopN,
     kLimit,
+    kFilterProjectLimit,
     kSample,
     kAggregate,
     kDedup,
@@ -153,6 +155,7 @@ class PlanNode {
     kSetConfig,
     kGetConfig,
     kShowMetaLeader,
+    kShowCardinalityFeedback,
 
     // zone related
     kShowZones,
@@ -287,6 +290,11 @@ class PlanNode {
     return cost_;
   }
 
+  // The estimated cost of this node only, excluding its dependencies
+  void setCost(double cost) {
+    cost_ = cost;
+  }
+
   void setLoopLayers(std::size_t c) {
     loopLayers_ = c;
   }
@@ -19,6 +19,7 @@ class PlanNodeVisitor {
   virtual void visit(PlanNode *node) = 0;
   virtual void visit(Filter *node) = 0;
   virtual void visit(Project *node) = 0;
+  virtual void visit(FilterProjectLimit *node) = 0;
   virtual void visit(Aggregate *node) = 0;
   virtual void visit(Traverse *node) = 0;
   virtual void visit(AppendVertices *node) = 0;
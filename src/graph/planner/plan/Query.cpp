@@ -35,6 +35,10 @@ std::unique_ptr<PlanNodeDescription> Explore::explain() const {
   std::string filter = filter_ == nullptr ? "" : filter_->toString();
   addDescription("filter", filter, desc.get());
   addDescription("orderBy", folly::toJson(util::toJson(orderBy_)), desc.get());
+  if (!vidFilterVar_.empty()) {
+    addDescription("vidFilterVar", vidFilterVar_, desc.get());
+    addDescription("vidFilterKey", vidFilterKey_->toString(), desc.get());
+  }
   return desc;
 }
 
@@ -46,6 +50,9 @@ void Explore::cloneMembers(const Explore& e) {
   limit_ = e.limit_;
   filter_ = e.filter_;
   orderBy_ = e.orderBy_;
+  // The var is read already, since the input vars are copied
+  vidFilterVar_ = e.vidFilterVar_;
+  vidFilterKey_ = e.vidFilterKey_;
 }
 
 std::unique_ptr<PlanNodeDescription> GetNeighbors::explain() const {
@@ -61,6 +68,18 @@ std::unique_ptr<PlanNodeDescription> GetNeighbors::explain() const {
       "statProps", statProps_ ? folly::toJson(util::toJson(*statProps_)) : "", desc.get());
   addDescription("exprs", exprs_ ? folly::toJson(util::toJson(*exprs_)) : "", desc.get());
   addDescription("random", folly::toJson(util::toJson(random_)), desc.get());
+  if (statsOnly_) {
+    addDescription("statsOnly", folly::toJson(util::toJson(statsOnly_)), desc.get());
+  }
+  if (edgeBudget_ >= 0) {
+    addDescription("edgeBudget", folly::toJson(util::toJson(edgeBudget_)), desc.get());
+  }
+  if (!dstFilterVar_.empty()) {
+    addDescription("dstFilterVar", dstFilterVar_, desc.get());
+  }
+  if (steps_ > 1) {
+    addDescription("steps", folly::to<std::string>(steps_), desc.get());
+  }
   return desc;
 }
 
@@ -77,6 +96,10 @@ void GetNeighbors::cloneMembers(const GetNeighbors& g) {
   setEdgeTypes(g.edgeTypes_);
   setEdgeDirection(g.edgeDirection_);
   setRandom(g.random_);
+  setStatsOnly(g.statsOnly_);
+  setEdgeBudget(g.edgeBudget_);
+  setDstFilterVar(g.dstFilterVar_);
+  setSteps(g.steps_);
   if (g.vertexProps_) {
     auto vertexProps = *g.vertexProps_;
     auto vertexPropsPtr = std::make_unique<decltype(vertexProps)>(vertexProps);
@@ -178,6 +201,9 @@ std::unique_ptr<PlanNodeDescription> IndexScan::explain() const {
   addDescription("isEdge", folly::toJson(util::toJson(isEdge_)), desc.get());
   addDescription("returnCols", folly::toJson(util::toJson(returnCols_)), desc.get());
   addDescription("indexCtx", folly::toJson(util::toJson(contexts_)), desc.get());
+  if (intersect_) {
+    addDescription("intersect", folly::toJson(util::toJson(intersect_)), desc.get());
+  }
   return desc;
 }
 
@@ -196,6 +222,7 @@ void IndexScan::cloneMembers(const IndexScan& g) {
   schemaId_ = g.schemaId();
   isEmptyResultSet_ = g.isEmptyResultSet();
   yieldColumns_ = g.yieldColumns();
+  intersect_ = g.intersect();
 }
 
 std::unique_ptr<PlanNodeDescription> ScanVertices::explain() const {
@@ -433,6 +460,62 @@ void Limit::cloneMembers(const Limit& l) {
   count_ = l.count_;
 }
 
+FilterProjectLimit::FilterProjectLimit(QueryContext* qctx,
+                                       PlanNode* input,
+                                       Expression* condition,
+                                       YieldColumns* cols,
+                                       int64_t offset,
+                                       int64_t count)
+    : SingleInputNode(qctx, Kind::kFilterProjectLimit, input),
+      condition_(condition),
+      cols_(cols),
+      offset_(offset),
+      count_(count) {
+  DCHECK_GE(offset, 0);
+  DCHECK_GE(count, 0);
+  if (cols_ != nullptr) {
+    setColNames(cols_->names());
+  }
+}
+
+std::unique_ptr<PlanNodeDescription> FilterProjectLimit::explain() const {
+  auto desc = SingleInputNode::explain();
+  addDescription("condition", condition_ ? condition_->toString() : "", desc.get());
+  auto columns = folly::dynamic::array();
+  if (cols_) {
+    for (const auto* col : cols_->columns()) {
+      DCHECK(col != nullptr);
+      columns.push_back(col->toString());
+    }
+  }
+  addDescription("columns", folly::toJson(columns), desc.get());
+  addDescription("offset", folly::to<std::string>(offset_), desc.get());
+  addDescription("count", folly::to<std::string>(count_), desc.get());
+  return desc;
+}
+
+void FilterProjectLimit::accept(PlanNodeVisitor* visitor) {
+  visitor->visit(this);
+}
+
+PlanNode* FilterProjectLimit::clone() const {
+  auto* newNode = FilterProjectLimit::make(qctx_, nullptr);
+  newNode->cloneMembers(*this);
+  return newNode;
+}
+
+void FilterProjectLimit::cloneMembers(const FilterProjectLimit& f) {
+  SingleInputNode::cloneMembers(f);
+
+  condition_ = f.condition()->clone();
+  cols_ = qctx_->objPool()->makeAndAdd<YieldColumns>();
+  for (const auto& col : f.columns()->columns()) {
+    cols_->addColumn(col->clone().release());
+  }
+  offset_ = f.offset_;
+  count_ = f.count_;
+}
+
 std::unique_ptr<PlanNodeDescription> TopN::explain() const {
   auto desc = SingleInputNode::explain();
   addDescription("factors", folly::toJson(util::toJson(factorsString())), desc.get());
@@ -741,6 +824,14 @@ void Traverse::cloneMembers(const Traverse& g) {
   if (g.firstStepFilter_ != nullptr) {
     setFirstStepFilter(g.firstStepFilter_->clone());
   }
+  setPathLimit(g.pathLimit_);
+  if (g.limitDstProps_ != nullptr) {
+    setLimitDstProps(std::make_unique<std::vector<VertexProp>>(*g.limitDstProps_));
+  }
+  if (g.dstVertexProps_ != nullptr) {
+    setDstVertexProps(std::make_unique<std::vector<VertexProp>>(*g.dstVertexProps_));
+  }
+  setDstVerticesVar(g.dstVerticesVar_);
 }
 
 std::unique_ptr<PlanNodeDescription> Traverse::explain() const {
@@ -752,6 +843,14 @@ std::unique_ptr<PlanNodeDescription> Traverse::explain() const {
   addDescription("first step filter",
                  firstStepFilter_ != nullptr ? firstStepFilter_->toString() : "",
                  desc.get());
+  addDescription("path limit", folly::to<std::string>(pathLimit_), desc.get());
+  addDescription("limitDstProps",
+                 limitDstProps_ ? folly::toJson(util::toJson(*limitDstProps_)) : "",
+                 desc.get());
+  addDescription("dstVertexProps",
+                 dstVertexProps_ ? folly::toJson(util::toJson(*dstVertexProps_)) : "",
+                 desc.get());
+  addDescription("dstVerticesVar", dstVerticesVar_, desc.get());
   return desc;
 }
 
@@ -759,6 +858,46 @@ void Traverse::accept(PlanNodeVisitor* visitor) {
   visitor->visit(this);
 }
 
+ExpandIntersect* ExpandIntersect::clone() const {
+  auto newEI = ExpandIntersect::make(qctx_, nullptr, space_);
+  newEI->cloneMembers(*this);
+  return newEI;
+}
+
+void ExpandIntersect::cloneMembers(const ExpandIntersect& e) {
+  GetNeighbors::cloneMembers(e);
+
+  setDst(e.dst_ != nullptr ? e.dst_->clone() : nullptr);
+  setDstEdgeDirection(e.dstEdgeDirection_);
+  if (e.dstEdgeProps_ != nullptr) {
+    setDstEdgeProps(std::make_unique<std::vector<EdgeProp>>(*e.dstEdgeProps_));
+  }
+  setVertexFilter(e.vFilter_ != nullptr ? e.vFilter_->clone() : nullptr);
+  setEdgeFilter(e.eFilter_ != nullptr ? e.eFilter_->clone() : nullptr);
+  setMidVertexFilter(e.midVertexFilter_ != nullptr ? e.midVertexFilter_->clone() : nullptr);
+  setDstEdgeFilter(e.dstEdgeFilter_ != nullptr ? e.dstEdgeFilter_->clone() : nullptr);
+  setTrackPrevPath(e.trackPrevPath_);
+}
+
+std::unique_ptr<PlanNodeDescription> ExpandIntersect::explain() const {
+  auto desc = GetNeighbors::explain();
+  addDescription("dst", dst_ != nullptr ? dst_->toString() : "", desc.get());
+  addDescription(
+      "dstEdgeDirection", apache::thrift::util::enumNameSafe(dstEdgeDirection_), desc.get());
+  addDescription("dstEdgeProps",
+                 dstEdgeProps_ ? folly::toJson(util::toJson(*dstEdgeProps_)) : "",
+                 desc.get());
+  addDescription("vertex filter", vFilter_ != nullptr ? vFilter_->toString() : "", desc.get());
+  addDescription("edge filter", eFilter_ != nullptr ? eFilter_->toString() : "", desc.get());
+  addDescription("mid vertex filter",
+                 midVertexFilter_ != nullptr ? midVertexFilter_->toString() : "",
+                 desc.get());
+  addDescription(
+      "dst edge filter", dstEdgeFilter_ != nullptr ? dstEdgeFilter_->toString() : "", desc.get());
+  addDescription("if_track_previous_path", folly::toJson(util::toJson(trackPrevPath_)), desc.get());
+  return desc;
+}
+
 AppendVertices* AppendVertices::clone() const {
   auto newAV = AppendVertices::make(qctx_, nullptr, space_);
   newAV->cloneMembers(*this);
@@ -774,12 +913,14 @@ void AppendVertices::cloneMembers(const AppendVertices& a) {
     setVertexFilter(nullptr);
   }
   setTrackPrevPath(a.trackPrevPath_);
+  setPrefetchedVar(a.prefetchedVar_);
 }
 
 std::unique_ptr<PlanNodeDescription> AppendVertices::explain() const {
   auto desc = GetVertices::explain();
   addDescription("vertex_filter", vFilter_ != nullptr ? vFilter_->toString() : "", desc.get());
   addDescription("if_track_previous_path", folly::toJson(util::toJson(trackPrevPath_)), desc.get());
+  addDescription("prefetchedVar", prefetchedVar_, desc.get());
   return desc;
 }
 
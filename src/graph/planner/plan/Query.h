@@ -80,6 +80,22 @@ class Explore : public SingleInputNode {
     orderBy_ = std::move(orderBy);
   }
 
+  const std::string& vidFilterVar() const {
+    return vidFilterVar_;
+  }
+
+  Expression* vidFilterKey() const {
+    return vidFilterKey_;
+  }
+
+  // Only read the vertices, or the edges whose dst, in the vids of the key evaluated on the rows of
+  // the var, which is read before this node
+  void setVidFilter(const std::string& var, Expression* key) {
+    vidFilterVar_ = var;
+    vidFilterKey_ = key;
+    readVariable(var);
+  }
+
   std::unique_ptr<PlanNodeDescription> explain() const override;
 
  protected:
@@ -126,6 +142,9 @@ class Explore : public SingleInputNode {
   Expression* limit_{nullptr};
   Expression* filter_{nullptr};
   std::vector<storage::cpp2::OrderBy> orderBy_;
+  // The rows of the other side of a join which the vid filter is built from
+  std::string vidFilterVar_;
+  Expression* vidFilterKey_{nullptr};
 };
 
 using VertexProp = nebula::storage::cpp2::VertexProp;
@@ -204,6 +223,22 @@ class GetNeighbors : public Explore {
     return random_;
   }
 
+  bool statsOnly() const {
+    return statsOnly_;
+  }
+
+  int64_t edgeBudget() const {
+    return edgeBudget_;
+  }
+
+  const std::string& dstFilterVar() const {
+    return dstFilterVar_;
+  }
+
+  int32_t steps() const {
+    return steps_;
+  }
+
   void setSrc(Expression* src) {
     src_ = src;
   }
@@ -236,6 +271,29 @@ class GetNeighbors : public Explore {
     random_ = random;
   }
 
+  // Only the stats are returned by storage, the edges are not
+  void setStatsOnly(bool statsOnly) {
+    statsOnly_ = statsOnly;
+  }
+
+  // The max edges returned by each request of the random sample, which is split across the
+  // vertices in proportion to their degrees. -1 means no budget, only the limit of each vertex
+  void setEdgeBudget(int64_t edgeBudget) {
+    edgeBudget_ = edgeBudget;
+  }
+
+  // The variable of a set of vids, only the edges to them are returned by storage. Nothing is
+  // filtered until the variable is set
+  void setDstFilterVar(std::string dstFilterVar) {
+    dstFilterVar_ = std::move(dstFilterVar);
+  }
+
+  // The hops expanded inside storaged by the edges only, only the neighbors of the last hop are
+  // returned
+  void setSteps(int32_t steps) {
+    steps_ = steps;
+  }
+
   PlanNode* clone() const override;
   std::unique_ptr<PlanNodeDescription> explain() const override;
 
@@ -257,6 +315,10 @@ class GetNeighbors : public Explore {
   std::unique_ptr<std::vector<StatProp>> statProps_;
   std::unique_ptr<std::vector<Expr>> exprs_;
   bool random_{false};
+  bool statsOnly_{false};
+  int64_t edgeBudget_{-1};
+  std::string dstFilterVar_;
+  int32_t steps_{1};
 };
 
 // Get property with given vertex keys.
@@ -523,6 +585,15 @@ class IndexScan : public Explore {
     yieldColumns_ = yieldColumns;
   }
 
+  // Whether the rows of all the contexts are intersected rather than united
+  bool intersect() const {
+    return intersect_;
+  }
+
+  void setIntersect(bool intersect) {
+    intersect_ = intersect;
+  }
+
   PlanNode* clone() const override;
   std::unique_ptr<PlanNodeDescription> explain() const override;
 
@@ -560,6 +631,7 @@ class IndexScan : public Explore {
   // TODO(yee): Generate special plan for this scenario
   bool isEmptyResultSet_{false};
   YieldColumns* yieldColumns_;
+  bool intersect_{false};
 };
 
 // Scan vertices
@@ -960,6 +1032,59 @@ class Limit final : public SingleInputNode {
   Expression* count_{nullptr};
 };
 
+// Filter the records with the condition, skip the first offset ones of the remained records, and
+// project at most count of the records following them with the columns, in a single pass.
+class FilterProjectLimit final : public SingleInputNode {
+ public:
+  static FilterProjectLimit* make(QueryContext* qctx,
+                                  PlanNode* input,
+                                  Expression* condition = nullptr,
+                                  YieldColumns* cols = nullptr,
+                                  int64_t offset = 0,
+                                  int64_t count = 0) {
+    return qctx->objPool()->makeAndAdd<FilterProjectLimit>(
+        qctx, input, condition, cols, offset, count);
+  }
+
+  Expression* condition() const {
+    return condition_;
+  }
+
+  const YieldColumns* columns() const {
+    return cols_;
+  }
+
+  int64_t offset() const {
+    return offset_;
+  }
+
+  int64_t count() const {
+    return count_;
+  }
+
+  PlanNode* clone() const override;
+  std::unique_ptr<PlanNodeDescription> explain() const override;
+
+  void accept(PlanNodeVisitor* visitor) override;
+
+ private:
+  friend ObjectPool;
+  FilterProjectLimit(QueryContext* qctx,
+                     PlanNode* input,
+                     Expression* condition,
+                     YieldColumns* cols,
+                     int64_t offset,
+                     int64_t count);
+
+  void cloneMembers(const FilterProjectLimit&);
+
+ private:
+  Expression* condition_{nullptr};
+  YieldColumns* cols_{nullptr};
+  int64_t offset_{0};
+  int64_t count_{0};
+};
+
 // Get the Top N record set.
 class TopN final : public SingleInputNode {
  public:
@@ -1519,6 +1644,38 @@ class Traverse final : public GetNeighbors {
     firstStepFilter_ = filter;
   }
 
+  int64_t pathLimit() const {
+    return pathLimit_;
+  }
+
+  void setPathLimit(int64_t limit) {
+    pathLimit_ = limit;
+  }
+
+  const std::vector<VertexProp>* dstVertexProps() const {
+    return dstVertexProps_.get();
+  }
+
+  void setDstVertexProps(VertexProps&& props) {
+    dstVertexProps_ = std::move(props);
+  }
+
+  const std::vector<VertexProp>* limitDstProps() const {
+    return limitDstProps_.get();
+  }
+
+  void setLimitDstProps(VertexProps&& props) {
+    limitDstProps_ = std::move(props);
+  }
+
+  const std::string& dstVerticesVar() const {
+    return dstVerticesVar_;
+  }
+
+  void setDstVerticesVar(std::string var) {
+    dstVerticesVar_ = std::move(var);
+  }
+
  private:
   friend ObjectPool;
   Traverse(QueryContext* qctx, PlanNode* input, GraphSpaceID space)
@@ -1535,6 +1692,119 @@ class Traverse final : public GetNeighbors {
   bool trackPrevPath_{true};
   // Push down filter in first step
   Expression* firstStepFilter_{nullptr};
+  // The max number of the paths to output, no more steps are traversed once they are enough.
+  // -1 for no limit.
+  int64_t pathLimit_{-1};
+  // The props of the dsts read by the AppendVertices above the path limit. AppendVertices drops
+  // the paths whose dsts have none of them, so the dsts of the paths are looked up by these props
+  // once the paths reach the limit, and the paths dropped are not counted in it.
+  VertexProps limitDstProps_;
+  // The props of the dsts of the last step read by storage along with the edges, they are set
+  // to dstVerticesVar_ as [the vertices in the layout of GetProp, the list of the dsts read], so
+  // AppendVertices doesn't need to read them again
+  VertexProps dstVertexProps_;
+  std::string dstVerticesVar_;
+};
+
+// Expand the two edges of (x)-[e1]-(z)-[e2]-(y), where both x and y are in the rows of the input,
+// by intersecting the neighbors of x over e1 with the ones of y over e2, which closes a cycle of
+// the pattern without expanding all the paths of x by e1 and e2. The members of GetNeighbors are
+// of e1 from x, and the dst ones are of e2 read reversely from y. Each row of the input is
+// appended with [x, [e1], z, [e2]] as if expanded by two single steps of Traverse.
+class ExpandIntersect final : public GetNeighbors {
+ public:
+  static ExpandIntersect* make(QueryContext* qctx, PlanNode* input, GraphSpaceID space) {
+    return qctx->objPool()->makeAndAdd<ExpandIntersect>(qctx, input, space);
+  }
+
+  std::unique_ptr<PlanNodeDescription> explain() const override;
+
+  ExpandIntersect* clone() const override;
+
+  Expression* dst() const {
+    return dst_;
+  }
+
+  storage::cpp2::EdgeDirection dstEdgeDirection() const {
+    return dstEdgeDirection_;
+  }
+
+  const std::vector<EdgeProp>* dstEdgeProps() const {
+    return dstEdgeProps_.get();
+  }
+
+  // The filter of x
+  Expression* vFilter() const {
+    return vFilter_;
+  }
+
+  // The filter of e1
+  Expression* eFilter() const {
+    return eFilter_;
+  }
+
+  // The filter of z
+  Expression* midVertexFilter() const {
+    return midVertexFilter_;
+  }
+
+  // The filter of e2
+  Expression* dstEdgeFilter() const {
+    return dstEdgeFilter_;
+  }
+
+  bool trackPrevPath() const {
+    return trackPrevPath_;
+  }
+
+  void setDst(Expression* dst) {
+    dst_ = dst;
+  }
+
+  void setDstEdgeDirection(storage::cpp2::EdgeDirection direction) {
+    dstEdgeDirection_ = direction;
+  }
+
+  void setDstEdgeProps(std::unique_ptr<std::vector<EdgeProp>> edgeProps) {
+    dstEdgeProps_ = std::move(edgeProps);
+  }
+
+  void setVertexFilter(Expression* vFilter) {
+    vFilter_ = vFilter;
+  }
+
+  void setEdgeFilter(Expression* eFilter) {
+    eFilter_ = eFilter;
+  }
+
+  void setMidVertexFilter(Expression* filter) {
+    midVertexFilter_ = filter;
+  }
+
+  void setDstEdgeFilter(Expression* filter) {
+    dstEdgeFilter_ = filter;
+  }
+
+  void setTrackPrevPath(bool track = true) {
+    trackPrevPath_ = track;
+  }
+
+ private:
+  friend ObjectPool;
+  ExpandIntersect(QueryContext* qctx, PlanNode* input, GraphSpaceID space)
+      : GetNeighbors(qctx, Kind::kExpandIntersect, input, space) {}
+
+ private:
+  void cloneMembers(const ExpandIntersect& e);
+
+  Expression* dst_{nullptr};
+  storage::cpp2::EdgeDirection dstEdgeDirection_{storage::cpp2::EdgeDirection::OUT_EDGE};
+  std::unique_ptr<std::vector<EdgeProp>> dstEdgeProps_;
+  Expression* vFilter_{nullptr};
+  Expression* eFilter_{nullptr};
+  Expression* midVertexFilter_{nullptr};
+  Expression* dstEdgeFilter_{nullptr};
+  bool trackPrevPath_{true};
 };
 
 // Append vertices to a path.
@@ -1566,6 +1836,14 @@ class AppendVertices final : public GetVertices {
     trackPrevPath_ = track;
   }
 
+  const std::string& prefetchedVar() const {
+    return prefetchedVar_;
+  }
+
+  void setPrefetchedVar(std::string var) {
+    prefetchedVar_ = std::move(var);
+  }
+
  private:
   friend ObjectPool;
   AppendVertices(QueryContext* qctx, PlanNode* input, GraphSpaceID space)
@@ -1586,6 +1864,8 @@ class AppendVertices final : public GetVertices {
   Expression* vFilter_;
 
   bool trackPrevPath_{true};
+  // The vertices already read by the Traverse before, see Traverse::dstVerticesVar
+  std::string prefetchedVar_;
 };
 
 // Binary Join that joins two results from two inputs.
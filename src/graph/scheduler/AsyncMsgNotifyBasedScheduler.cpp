@@ -5,6 +5,8 @@
 
 #include "graph/scheduler/AsyncMsgNotifyBasedScheduler.h"
 
+#include "graph/scheduler/Pipeline.h"
+
 DECLARE_bool(enable_lifetime_optimize);
 
 namespace nebula {
@@ -33,6 +35,8 @@ folly::Future<Status> AsyncMsgNotifyBasedScheduler::doSchedule(Executor* root) c
   std::queue<Executor*> queue;
   std::queue<Executor*> queue2;
   std::unordered_set<Executor*> visited;
+  // The executors fused into a pipeline, keyed by the top one
+  std::unordered_map<int64_t, std::vector<Executor*>> pipelines;
 
   auto* runner = qctx_->rctx()->runner();
   folly::Promise<Status> promiseForRoot;
@@ -56,7 +60,14 @@ folly::Future<Status> AsyncMsgNotifyBasedScheduler::doSchedule(Executor* root) c
         promises.emplace_back(std::move(p));
       }
     } else {
-      for (auto* dep : exe->depends()) {
+      auto* bottom = exe;
+      auto pipeline = Pipeline::fuse(exe, qctx_);
+      if (!pipeline.empty()) {
+        // The whole pipeline waits for the dependencies of its bottom executor
+        bottom = pipeline.front();
+        pipelines.emplace(exe->id(), std::move(pipeline));
+      }
+      for (auto* dep : bottom->depends()) {
         auto notVisited = visited.emplace(dep).second;
         if (notVisited) {
           queue.push(dep);
@@ -81,19 +92,22 @@ folly::Future<Status> AsyncMsgNotifyBasedScheduler::doSchedule(Executor* root) c
     DCHECK(currentPromisesFound != promiseMap.end());
     auto currentExePromises = std::move(currentPromisesFound->second);
 
-    scheduleExecutor(std::move(currentExeFutures), exe, runner)
-        .thenTry([this, pros = std::move(currentExePromises)](auto&& t) mutable {
-          if (t.hasException()) {
-            notifyError(pros, Status::Error(std::move(t).exception().what()));
-          } else {
-            auto v = std::move(t).value();
-            if (v.ok()) {
-              notifyOK(pros);
-            } else {
-              notifyError(pros, v);
-            }
-          }
-        });
+    auto pipelineFound = pipelines.find(exe->id());
+    auto future = pipelineFound == pipelines.end()
+                      ? scheduleExecutor(std::move(currentExeFutures), exe, runner)
+                      : runPipeline(std::move(currentExeFutures), pipelineFound->second, runner);
+    std::move(future).thenTry([this, pros = std::move(currentExePromises)](auto&& t) mutable {
+      if (t.hasException()) {
+        notifyError(pros, Status::Error(std::move(t).exception().what()));
+      } else {
+        auto v = std::move(t).value();
+        if (v.ok()) {
+          notifyOK(pros);
+        } else {
+          notifyError(pros, v);
+        }
+      }
+    });
   }
 
   return resultFuture;
@@ -159,6 +173,35 @@ folly::Future<Status> AsyncMsgNotifyBasedScheduler::runExecutor(
       });
 }
 
+folly::Future<Status> AsyncMsgNotifyBasedScheduler::runPipeline(
+    std::vector<folly::Future<Status>>&& futures,
+    std::vector<Executor*> executors,
+    folly::Executor* runner) const {
+  return folly::collect(futures).via(runner).thenValue(
+      [executors = std::move(executors), this](auto&& t) mutable -> folly::Future<Status> {
+        NG_RETURN_IF_ERROR(checkStatus(std::move(t)));
+        Pipeline pipeline(qctx_, executors);
+        if (pipeline.fusible()) {
+          // Execute in current thread.
+          return pipeline.execute();
+        }
+        return executeInOrder(std::move(executors), 0);
+      });
+}
+
+folly::Future<Status> AsyncMsgNotifyBasedScheduler::executeInOrder(std::vector<Executor*> executors,
+                                                                   size_t i) const {
+  auto* exe = executors[i];
+  return execute(exe).thenValue(
+      [executors = std::move(executors), i, this](Status s) mutable -> folly::Future<Status> {
+        NG_RETURN_IF_ERROR(s);
+        if (i + 1 == executors.size()) {
+          return Status::OK();
+        }
+        return executeInOrder(std::move(executors), i + 1);
+      });
+}
+
 folly::Future<Status> AsyncMsgNotifyBasedScheduler::runLeafExecutor(Executor* exe,
                                                                     folly::Executor* runner) const {
   return std::move(execute(exe)).via(runner);
@@ -218,7 +261,14 @@ folly::Future<Status> AsyncMsgNotifyBasedScheduler::execute(Executor* executor)
   if (!status.ok()) {
     return executor->error(std::move(status));
   }
-  return executor->execute().thenValue([executor](Status s) {
+  // The storage requests sent by the executor on this thread carry the span of it
+  tracing::Scope scope(executor->traceSpan());
+  // Most executors do their work in execute() on this thread, the rest is on the threads running
+  // their continuations
+  auto cpuStart = QueryResourceUsage::threadCpuTimeUs();
+  auto future = executor->execute();
+  qctx_->resourceUsage().addCpuTime(QueryResourceUsage::threadCpuTimeUs() - cpuStart);
+  return std::move(future).thenValue([executor](Status s) {
     NG_RETURN_IF_ERROR(s);
     return executor->close();
   });
@@ -48,6 +48,14 @@ class AsyncMsgNotifyBasedScheduler final : public Scheduler {
                                     Executor* exe,
                                     folly::Executor* runner) const;
 
+  // Run the executors fused into a pipeline, or one by one from the bottom if the input could not
+  // be iterated by the pipeline
+  folly::Future<Status> runPipeline(std::vector<folly::Future<Status>>&& futures,
+                                    std::vector<Executor*> executors,
+                                    folly::Executor* runner) const;
+
+  folly::Future<Status> executeInOrder(std::vector<Executor*> executors, size_t i) const;
+
   folly::Future<Status> runLeafExecutor(Executor* exe, folly::Executor* runner) const;
 
   folly::Future<Status> runLoop(std::vector<folly::Future<Status>>&& futures,
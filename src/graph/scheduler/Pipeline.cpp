@@ -0,0 +1,267 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/scheduler/Pipeline.h"
+
+#include "graph/executor/query/ProjectExecutor.h"
+#include "graph/executor/query/UnwindExecutor.h"
+#include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
+
+DECLARE_bool(enable_lifetime_optimize);
+
+namespace nebula {
+namespace graph {
+
+// static
+bool Pipeline::isStreaming(const PlanNode* node) {
+  switch (node->kind()) {
+    case PlanNode::Kind::kFilter:
+    case PlanNode::Kind::kProject:
+    case PlanNode::Kind::kUnwind:
+    case PlanNode::Kind::kLimit:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// static
+std::vector<Executor*> Pipeline::fuse(Executor* exe, QueryContext* qctx) {
+  std::vector<Executor*> executors;
+  if (!FLAGS_enable_pipeline_execution || !isStreaming(exe->node())) {
+    return executors;
+  }
+  auto* cur = exe;
+  executors.emplace_back(cur);
+  while (cur->depends().size() == 1) {
+    auto* dep = *cur->depends().begin();
+    const auto* depNode = dep->node();
+    if (!isStreaming(depNode) || dep->successors().size() != 1 ||
+        depNode->loopLayers() != cur->node()->loopLayers() ||
+        cur->node()->inputVar() != depNode->outputVar()) {
+      break;
+    }
+    // The result of dep is never materialized, so nobody else could read it
+    const auto* var = qctx->symTable()->getVar(depNode->outputVar());
+    if (var == nullptr || var->readBy.size() != 1) {
+      break;
+    }
+    executors.emplace_back(dep);
+    cur = dep;
+  }
+  if (executors.size() < 2) {
+    executors.clear();
+  }
+  std::reverse(executors.begin(), executors.end());
+  return executors;
+}
+
+Pipeline::Pipeline(QueryContext* qctx, std::vector<Executor*> executors) : qctx_(qctx) {
+  DCHECK(!executors.empty());
+  stages_.reserve(executors.size());
+  for (auto* exe : executors) {
+    stages_.emplace_back(Stage{exe});
+  }
+  iter_ = qctx_->ectx()->getResult(executors.front()->node()->inputVar()).iter();
+}
+
+bool Pipeline::fusible() const {
+  if (iter_ == nullptr) {
+    return false;
+  }
+  if (iter_->kind() == Iterator::Kind::kSequential) {
+    return true;
+  }
+  // A Project over other iterators produces sequential rows as well, while a Filter or a Limit
+  // keeps the kind of its input
+  return iter_->kind() != Iterator::Kind::kDefault &&
+         stages_.front().executor->node()->kind() == PlanNode::Kind::kProject;
+}
+
+Status Pipeline::execute() {
+  for (auto& stage : stages_) {
+    NG_RETURN_IF_ERROR(stage.executor->open());
+  }
+  auto* top = stages_.back().executor;
+  {
+    SCOPED_TIMER(&top->execTime_);
+    NG_RETURN_IF_ERROR(run());
+  }
+  for (auto& stage : stages_) {
+    NG_RETURN_IF_ERROR(stage.executor->close());
+  }
+  return Status::OK();
+}
+
+Status Pipeline::run() {
+  QueryExpressionContext qec(qctx_->ectx());
+  for (size_t i = 0; i < stages_.size(); ++i) {
+    auto& stage = stages_[i];
+    if (stage.executor->node()->kind() != PlanNode::Kind::kLimit) {
+      continue;
+    }
+    const auto* limit = Executor::asNode<Limit>(stage.executor->node());
+    auto offset = limit->offset();
+    auto count = limit->count(qec);
+    stage.offset = offset > 0 ? offset : 0;
+    if (count >= 0) {
+      stage.count = count;
+      if (count == 0) {
+        stopped_ = std::max(stopped_, i + 1);
+      }
+    }
+  }
+
+  auto* bottom = stages_.front().executor;
+  inputOwned_ = bottom->movable(bottom->node()->inputVars().front());
+
+  DataSet result;
+  result.colNames = stages_.back().executor->node()->colNames();
+  size_t batchSize = std::max(FLAGS_pipeline_batch_size, 1);
+  while (stopped_ == 0 && iter_->valid()) {
+    NG_RETURN_IF_ERROR(push(0, iter_.get(), batchSize, &result));
+  }
+
+  // The intermediate results are never stored, only their profiling stats and the lifetime of
+  // their inputs are kept as if the executors were run one by one
+  for (size_t i = 0; i + 1 < stages_.size(); ++i) {
+    auto* exe = stages_[i].executor;
+    exe->numRows_ = stages_[i].numRows;
+    if (FLAGS_enable_lifetime_optimize) {
+      exe->drop();
+    }
+  }
+  return stages_.back().executor->finish(ResultBuilder().value(Value(std::move(result))).build());
+}
+
+Status Pipeline::push(size_t i, Iterator* iter, size_t n, DataSet* result) {
+  if (stages_[i].executor->node()->kind() == PlanNode::Kind::kUnwind) {
+    return unwind(i, iter, n, result);
+  }
+  if (i + 1 == stages_.size()) {
+    auto size = result->rows.size();
+    NG_RETURN_IF_ERROR(process(i, iter, n, &result->rows));
+    stages_[i].numRows += result->rows.size() - size;
+    return Status::OK();
+  }
+
+  DataSet ds;
+  ds.colNames = stages_[i].executor->node()->colNames();
+  NG_RETURN_IF_ERROR(process(i, iter, n, &ds.rows));
+  auto size = ds.rows.size();
+  stages_[i].numRows += size;
+  if (size == 0) {
+    return Status::OK();
+  }
+  SequentialIter batch(std::make_shared<Value>(std::move(ds)));
+  return push(i + 1, &batch, size, result);
+}
+
+Status Pipeline::process(size_t i, Iterator* iter, size_t n, std::vector<Row>* rows) {
+  auto& stage = stages_[i];
+  const auto* node = stage.executor->node();
+  // The rows of the batches between the stages are owned by the pipeline, so they could be moved,
+  // and so could the rows of the input at the end of its lifetime
+  bool owned = i != 0 || inputOwned_;
+  auto take = [owned, iter]() -> Row { return owned ? iter->moveRow() : *iter->row(); };
+  std::vector<int32_t> moved;
+  if (owned && node->kind() == PlanNode::Kind::kProject) {
+    moved = ProjectExecutor::movedColumns(Executor::asNode<Project>(node)->columns(), iter);
+  }
+  QueryExpressionContext ctx(qctx_->ectx());
+  for (size_t k = 0; k < n && iter->valid() && stopped_ <= i; ++k, iter->next()) {
+    switch (node->kind()) {
+      case PlanNode::Kind::kFilter: {
+        auto val = Executor::asNode<Filter>(node)->condition()->eval(ctx(iter));
+        if (val.isBadNull() || (!val.empty() && !val.isImplicitBool() && !val.isNull())) {
+          return Status::Error("Wrong type result, the type should be NULL, EMPTY, BOOL");
+        }
+        if (!(val.empty() || val.isNull() || (val.isImplicitBool() && !val.implicitBool()))) {
+          rows->emplace_back(take());
+        }
+        break;
+      }
+      case PlanNode::Kind::kProject: {
+        const auto& columns = Executor::asNode<Project>(node)->columns()->columns();
+        Row row;
+        row.values.resize(columns.size());
+        for (size_t j = 0; j < columns.size(); ++j) {
+          if (moved.empty() || moved[j] < 0) {
+            row.values[j] = columns[j]->expr()->eval(ctx(iter));
+          }
+        }
+        for (size_t j = 0; j < moved.size(); ++j) {
+          if (moved[j] >= 0) {
+            row.values[j] = iter->moveColumn(moved[j]);
+          }
+        }
+        rows->emplace_back(std::move(row));
+        break;
+      }
+      case PlanNode::Kind::kLimit: {
+        if (stage.offset > 0) {
+          --stage.offset;
+          break;
+        }
+        rows->emplace_back(take());
+        if (--stage.count == 0) {
+          // Cancel the stages below, the rows already produced still flow to the stages above
+          stopped_ = std::max(stopped_, i + 1);
+        }
+        break;
+      }
+      default:
+        return Status::Error("Plan node `%s' could not be fused into a pipeline",
+                             PlanNode::toString(node->kind()));
+    }
+  }
+  return Status::OK();
+}
+
+Status Pipeline::unwind(size_t i, Iterator* iter, size_t n, DataSet* result) {
+  auto& stage = stages_[i];
+  const auto* node = stage.executor->node();
+  auto* expr = Executor::asNode<Unwind>(node)->unwindExpr();
+  bool owned = i != 0 || inputOwned_;
+  bool top = i + 1 == stages_.size();
+  auto batchSize = static_cast<size_t>(std::max(FLAGS_pipeline_batch_size, 1));
+  DataSet ds;
+  ds.colNames = node->colNames();
+  auto* rows = top ? &result->rows : &ds.rows;
+  auto flush = [&]() -> Status {
+    if (top || ds.rows.empty()) {
+      return Status::OK();
+    }
+    auto size = ds.rows.size();
+    SequentialIter batch(std::make_shared<Value>(std::move(ds)));
+    ds = DataSet();
+    ds.colNames = node->colNames();
+    return push(i + 1, &batch, size, result);
+  };
+
+  Status status;
+  QueryExpressionContext ctx(qctx_->ectx());
+  for (size_t k = 0; k < n && iter->valid() && stopped_ <= i; ++k, iter->next()) {
+    UnwindExecutor::unwind(expr, ctx(iter), [&](const Value& v, bool last) {
+      // Only the last produced row could take the input row away
+      Row row = owned && last ? iter->moveRow() : *iter->row();
+      row.values.emplace_back(v);
+      rows->emplace_back(std::move(row));
+      ++stage.numRows;
+      if (ds.rows.size() < batchSize) {
+        return true;
+      }
+      status = flush();
+      // Stop unwinding once a Limit above is filled
+      return status.ok() && stopped_ <= i;
+    });
+    NG_RETURN_IF_ERROR(status);
+  }
+  return flush();
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -0,0 +1,72 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_SCHEDULER_PIPELINE_H_
+#define GRAPH_SCHEDULER_PIPELINE_H_
+
+#include "graph/executor/Executor.h"
+
+namespace nebula {
+namespace graph {
+/**
+ * A pipeline fuses a chain of streaming executors (Filter, Project, Unwind and Limit), each of
+ * which is the only reader of the result of the one below it. The rows of the input of the bottom
+ * executor are pushed through all the stages batch by batch in the current thread, so the results
+ * between the stages are never materialized. Only the result of the top executor is stored in the
+ * execution context. Once a Limit is filled, the stages below it stop pulling more rows. An Unwind
+ * pushes the rows it produces in batches as well, so even a single huge list or range is never
+ * expanded at once.
+ */
+class Pipeline final {
+ public:
+  // Collect the executors fused with exe on top, ordered from the bottom to the top. Returns an
+  // empty vector if there is nothing to fuse.
+  static std::vector<Executor*> fuse(Executor* exe, QueryContext* qctx);
+
+  Pipeline(QueryContext* qctx, std::vector<Executor*> executors);
+
+  // Whether the input of the bottom executor could be iterated by the pipeline, otherwise the
+  // executors should be run one by one
+  bool fusible() const;
+
+  // Run all the executors of the pipeline, including opening and closing them
+  Status execute();
+
+ private:
+  struct Stage {
+    Executor* executor;
+    // Rows produced by this stage
+    size_t numRows{0};
+    // Rows still to skip and to take by a Limit stage
+    size_t offset{0};
+    size_t count{std::numeric_limits<size_t>::max()};
+  };
+
+  static bool isStreaming(const PlanNode* node);
+
+  Status run();
+
+  // Push at most n rows of iter through the stages from the i-th one
+  Status push(size_t i, Iterator* iter, size_t n, DataSet* result);
+
+  // Process at most n rows of iter by the i-th stage, and append the produced rows to rows
+  Status process(size_t i, Iterator* iter, size_t n, std::vector<Row>* rows);
+
+  // Unwind at most n rows of iter by the i-th stage, pushing the produced rows batch by batch
+  Status unwind(size_t i, Iterator* iter, size_t n, DataSet* result);
+
+  QueryContext* qctx_{nullptr};
+  std::vector<Stage> stages_;
+  // Iterator of the input of the bottom executor
+  std::unique_ptr<Iterator> iter_;
+  // Whether the input of the bottom executor is read by nobody else
+  bool inputOwned_{false};
+  // The number of the bottom stages which stop pulling rows since a Limit above them is filled
+  size_t stopped_{0};
+};
+
+}  // namespace graph
+}  // namespace nebula
+#endif  // GRAPH_SCHEDULER_PIPELINE_H_
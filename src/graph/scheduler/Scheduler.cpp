@@ -21,7 +21,41 @@
 namespace nebula {
 namespace graph {
 
+namespace {
+
+constexpr size_t kAllVersions = std::numeric_limits<size_t>::max();
+
+// The number of the latest versions of the input variable read by the node
+size_t versionsRead(const PlanNode* node, const Variable* var) {
+  switch (node->kind()) {
+    case PlanNode::Kind::kDataCollect:
+    case PlanNode::Kind::kUnionAllVersionVar:
+      return kAllVersions;
+    case PlanNode::Kind::kLeftJoin:
+    case PlanNode::Kind::kInnerJoin: {
+      const auto* join = static_cast<const Join*>(node);
+      size_t versions = 1;
+      for (const auto& joinVar : {join->leftVar(), join->rightVar()}) {
+        if (joinVar.first != var->name) {
+          continue;
+        }
+        // The positive versions count from the oldest one
+        if (joinVar.second > 0) {
+          return kAllVersions;
+        }
+        versions = std::max(versions, static_cast<size_t>(1 - joinVar.second));
+      }
+      return versions;
+    }
+    default:
+      return 1;
+  }
+}
+
+}  // namespace
+
 /*static*/ void Scheduler::analyzeLifetime(const PlanNode* root, std::size_t loopLayers) {
+  std::unordered_map<Variable*, size_t> versions;
   std::stack<std::tuple<const PlanNode*, std::size_t>> stack;
   stack.push(std::make_tuple(root, loopLayers));
   while (!stack.empty()) {
@@ -31,6 +65,8 @@ namespace graph {
     for (auto& inputVar : currentNode->inputVars()) {
       if (inputVar != nullptr) {
         inputVar->userCount.fetch_add(1, std::memory_order_relaxed);
+        auto& read = versions[inputVar];
+        read = std::max(read, versionsRead(currentNode, inputVar));
       }
     }
     auto* currentMutNode = const_cast<PlanNode*>(currentNode);
@@ -63,6 +99,10 @@ namespace graph {
         break;
     }
   }
+  // The variables only read by the expressions, e.g. the loop conditions, keep all the versions
+  for (auto& var : versions) {
+    var.first->versionsRead = var.second;
+  }
 }
 
 }  // namespace graph
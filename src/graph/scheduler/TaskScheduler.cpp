@@ -0,0 +1,161 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/scheduler/TaskScheduler.h"
+
+#include "graph/service/GraphFlags.h"
+#include "graph/stats/GraphStats.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+// The scheduler and the index of the worker running in current thread
+thread_local const TaskScheduler* tScheduler = nullptr;
+thread_local size_t tWorker = 0;
+
+// Adds the tasks of a query with the priority by the time they have taken
+class QueryRunner final : public folly::Executor {
+ public:
+  explicit QueryRunner(TaskScheduler* scheduler)
+      : scheduler_(scheduler), usedUs_(std::make_shared<std::atomic<uint64_t>>(0)) {}
+
+  void add(folly::Func func) override {
+    auto usedUs = usedUs_->load(std::memory_order_relaxed);
+    auto slice = static_cast<uint64_t>(std::max(FLAGS_task_time_slice_us, 1));
+    int8_t priority = usedUs < slice ? HI_PRI : usedUs < 10 * slice ? MID_PRI : LO_PRI;
+    // The task may outlive the runner, so it keeps the used time by itself
+    scheduler_->addWithPriority(
+        [func = std::move(func), usedUs = usedUs_]() mutable {
+          time::Duration duration;
+          func();
+          usedUs->fetch_add(duration.elapsedInUSec(), std::memory_order_relaxed);
+        },
+        priority);
+  }
+
+ private:
+  TaskScheduler* scheduler_{nullptr};
+  std::shared_ptr<std::atomic<uint64_t>> usedUs_;
+};
+
+}  // namespace
+
+TaskScheduler::TaskScheduler(size_t numThreads) {
+  DCHECK_GT(numThreads, 0);
+  workers_.reserve(numThreads);
+  for (size_t i = 0; i < numThreads; ++i) {
+    workers_.emplace_back(std::make_unique<Worker>());
+  }
+  // Start the threads after all the workers are created, since they steal from each other
+  for (size_t i = 0; i < numThreads; ++i) {
+    workers_[i]->thread = thread::NamedThread("task-sched", &TaskScheduler::loop, this, i);
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  stop();
+}
+
+void TaskScheduler::add(folly::Func func) {
+  addWithPriority(std::move(func), MID_PRI);
+}
+
+void TaskScheduler::addWithPriority(folly::Func func, int8_t priority) {
+  stats::StatsManager::addValue(kNumSchedulerTasks);
+  auto idx = tScheduler == this ? tWorker : next_.fetch_add(1) % workers_.size();
+  auto& worker = *workers_[idx];
+  {
+    std::lock_guard<std::mutex> g(worker.lock);
+    worker.queues[queueOf(priority)].emplace_back(Task{std::move(func), time::Duration()});
+  }
+  {
+    // Count under the lock, so no worker could miss it before waiting
+    std::lock_guard<std::mutex> g(lock_);
+    ++numPending_;
+  }
+  cond_.notify_one();
+}
+
+std::unique_ptr<folly::Executor> TaskScheduler::makeRunner() {
+  return std::make_unique<QueryRunner>(this);
+}
+
+void TaskScheduler::stop() {
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    if (stopped_) {
+      return;
+    }
+    stopped_ = true;
+  }
+  cond_.notify_all();
+  for (auto& worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+}
+
+// static
+size_t TaskScheduler::queueOf(int8_t priority) {
+  if (priority > MID_PRI) {
+    return 0;
+  }
+  return priority == MID_PRI ? 1 : 2;
+}
+
+bool TaskScheduler::pop(size_t idx, Task* task) {
+  auto size = workers_.size();
+  for (size_t q = 0; q < kNumPriorities; ++q) {
+    // The own tasks are run in order to be fair to the queries, the stolen ones are the latest
+    for (size_t i = 0; i < size; ++i) {
+      auto& worker = *workers_[(idx + i) % size];
+      std::lock_guard<std::mutex> g(worker.lock);
+      auto& queue = worker.queues[q];
+      if (queue.empty()) {
+        continue;
+      }
+      if (i == 0) {
+        *task = std::move(queue.front());
+        queue.pop_front();
+      } else {
+        *task = std::move(queue.back());
+        queue.pop_back();
+        stats::StatsManager::addValue(kNumSchedulerStolenTasks);
+      }
+      --numPending_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void TaskScheduler::loop(size_t idx) {
+  tScheduler = this;
+  tWorker = idx;
+  while (true) {
+    Task task;
+    if (pop(idx, &task)) {
+      stats::StatsManager::addValue(kSchedulerTaskWaitUs, task.duration.elapsedInUSec());
+      try {
+        task.func();
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Task of the scheduler threw an exception: " << e.what();
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> g(lock_);
+    cond_.wait(g, [this] { return numPending_ > 0 || stopped_; });
+    if (stopped_ && numPending_ == 0) {
+      break;
+    }
+  }
+  tScheduler = nullptr;
+}
+
+}  // namespace graph
+}  // namespace nebula
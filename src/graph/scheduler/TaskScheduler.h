@@ -0,0 +1,80 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_SCHEDULER_TASKSCHEDULER_H_
+#define GRAPH_SCHEDULER_TASKSCHEDULER_H_
+
+#include <folly/Executor.h>
+
+#include "common/base/Base.h"
+#include "common/thread/NamedThread.h"
+#include "common/time/Duration.h"
+
+namespace nebula {
+namespace graph {
+/**
+ * A work-stealing thread pool running the tasks of the executors, e.g. the jobs of runMultiJobs
+ * and the continuations of the storage responses. Each worker has its own queues, one for each
+ * priority. A task added by a worker goes to the queues of that worker, otherwise to the workers
+ * in turn. A worker always runs the task of the highest priority it could find, from its own
+ * queues first, and steals from the other workers when its own queues are empty.
+ *
+ * The tasks of a query are added through the runner made for it, which demotes the query to a
+ * lower priority once its tasks have taken more time than the time slices. So a long running query
+ * yields the workers to the short ones between its tasks, instead of occupying the whole pool.
+ */
+class TaskScheduler final : public folly::Executor {
+ public:
+  explicit TaskScheduler(size_t numThreads);
+
+  ~TaskScheduler() override;
+
+  void add(folly::Func func) override;
+
+  void addWithPriority(folly::Func func, int8_t priority) override;
+
+  uint8_t getNumPriorities() const override {
+    return kNumPriorities;
+  }
+
+  // Make the runner of a query, whose tasks are all scheduled by this
+  std::unique_ptr<folly::Executor> makeRunner();
+
+  // Stop the workers after all the queued tasks are done
+  void stop();
+
+ private:
+  static constexpr uint8_t kNumPriorities = 3;
+
+  struct Task {
+    folly::Func func;
+    // Since the task is queued
+    time::Duration duration;
+  };
+
+  struct Worker {
+    std::mutex lock;
+    // Ordered from the highest priority to the lowest
+    std::deque<Task> queues[kNumPriorities];
+    thread::NamedThread thread;
+  };
+
+  static size_t queueOf(int8_t priority);
+
+  bool pop(size_t idx, Task* task);
+
+  void loop(size_t idx);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> next_{0};
+  std::atomic<size_t> numPending_{0};
+  std::mutex lock_;
+  std::condition_variable cond_;
+  bool stopped_{false};
+};
+
+}  // namespace graph
+}  // namespace nebula
+#endif  // GRAPH_SCHEDULER_TASKSCHEDULER_H_
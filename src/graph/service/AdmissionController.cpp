@@ -0,0 +1,243 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/service/AdmissionController.h"
+
+#include "common/stats/StatsManager.h"
+#include "graph/service/GraphFlags.h"
+#include "graph/service/QueryInstance.h"
+#include "graph/stats/GraphStats.h"
+
+namespace nebula {
+namespace graph {
+
+static constexpr size_t kCheckQueueIntervalMs = 100;
+
+AdmissionController::Ticket::~Ticket() {
+  controller_->release(*this);
+}
+
+Status AdmissionController::init() {
+  timer_ = std::make_unique<thread::GenericWorker>();
+  if (!timer_->start("graph-admission")) {
+    return Status::Error("Fail to start admission controller background thread.");
+  }
+  timer_->addRepeatTask(kCheckQueueIntervalMs, [this]() { dispatch(); });
+  return Status::OK();
+}
+
+// static
+bool AdmissionController::enabled() {
+  return FLAGS_max_concurrent_queries_per_space > 0 || FLAGS_max_concurrent_queries_per_user > 0 ||
+         FLAGS_max_running_memory_mb_per_space > 0 || FLAGS_max_running_memory_mb_per_user > 0;
+}
+
+// static
+AdmissionController::Priority AdmissionController::priorityOf(const QueryInstance* instance) {
+  auto session = instance->qctx()->rctx()->session()->getSession();
+  auto& configs = session.get_configs();
+  auto iter = configs.find("query_priority");
+  if (iter != configs.end() && iter->second.isInt()) {
+    auto priority = iter->second.getInt();
+    return priority <= kLow ? kLow : priority >= kHigh ? kHigh : kNormal;
+  }
+  return kNormal;
+}
+
+void AdmissionController::admit(QueryInstance* instance) {
+  if (!enabled()) {
+    instance->execute();
+    return;
+  }
+
+  auto* session = instance->qctx()->rctx()->session();
+  admit(
+      session->spaceName(),
+      session->user(),
+      priorityOf(instance),
+      instance->qctx()->memTracker().get(),
+      instance->qctx()->rctx()->runner(),
+      [instance](std::unique_ptr<Ticket> ticket) {
+        instance->setTicket(std::move(ticket));
+        instance->execute();
+      },
+      [instance](Status status) { instance->reject(std::move(status)); });
+}
+
+void AdmissionController::admit(std::string space,
+                                std::string user,
+                                Priority priority,
+                                const MemoryTracker* memTracker,
+                                folly::Executor* runner,
+                                Execute execute,
+                                Reject reject) {
+  std::unique_ptr<Ticket> ticket;
+  {
+    std::lock_guard<std::mutex> lk(lock_);
+    if (!waitingBefore(space, user) && admissible(space, user)) {
+      ticket = acquire(space, user, memTracker);
+    } else if (numQueued_ < static_cast<size_t>(std::max(FLAGS_admission_queue_size, 0))) {
+      enqueue(priority,
+              Waiting{std::move(space),
+                      std::move(user),
+                      memTracker,
+                      runner,
+                      std::move(execute),
+                      std::move(reject),
+                      time::Duration()});
+      return;
+    }
+  }
+  if (ticket == nullptr) {
+    stats::StatsManager::addValue(kNumRejectedQueries);
+    reject(Status::Error("Too many queries waiting to be admitted, the queue size is %d",
+                         FLAGS_admission_queue_size));
+    return;
+  }
+  execute(std::move(ticket));
+}
+
+bool AdmissionController::waitingBefore(const std::string& space, const std::string& user) const {
+  if (numQueued_ == 0) {
+    return false;
+  }
+  bool spaceLimited =
+      FLAGS_max_concurrent_queries_per_space > 0 || FLAGS_max_running_memory_mb_per_space > 0;
+  bool userLimited =
+      FLAGS_max_concurrent_queries_per_user > 0 || FLAGS_max_running_memory_mb_per_user > 0;
+  return (spaceLimited && queuedSpaces_.count(space) != 0) ||
+         (userLimited && queuedUsers_.count(user) != 0);
+}
+
+void AdmissionController::enqueue(Priority priority, Waiting waiting) {
+  ++queuedSpaces_[waiting.space];
+  ++queuedUsers_[waiting.user];
+  queues_[priority].emplace_back(std::move(waiting));
+  ++numQueued_;
+  stats::StatsManager::addValue(kNumQueuedQueries);
+}
+
+void AdmissionController::dequeued(const Waiting& waiting) {
+  auto unref = [](auto& queued, const std::string& key) {
+    auto iter = queued.find(key);
+    DCHECK(iter != queued.end());
+    if (--iter->second == 0) {
+      queued.erase(iter);
+    }
+  };
+  unref(queuedSpaces_, waiting.space);
+  unref(queuedUsers_, waiting.user);
+  --numQueued_;
+  stats::StatsManager::addValue(kNumQueuedQueries, -1);
+}
+
+bool AdmissionController::admissible(const std::string& space, const std::string& user) const {
+  auto check = [](const auto& running, const std::string& key, int32_t maxQueries, int32_t maxMb) {
+    auto iter = running.find(key);
+    if (iter == running.end()) {
+      return true;
+    }
+    if (maxQueries > 0 && iter->second.numQueries >= static_cast<size_t>(maxQueries)) {
+      return false;
+    }
+    if (maxMb > 0) {
+      int64_t used = 0;
+      for (const auto* tracker : iter->second.memTrackers) {
+        used += tracker->used();
+      }
+      if (used >= static_cast<int64_t>(maxMb) * 1024 * 1024) {
+        return false;
+      }
+    }
+    return true;
+  };
+  return check(spaces_,
+               space,
+               FLAGS_max_concurrent_queries_per_space,
+               FLAGS_max_running_memory_mb_per_space) &&
+         check(users_,
+               user,
+               FLAGS_max_concurrent_queries_per_user,
+               FLAGS_max_running_memory_mb_per_user);
+}
+
+std::unique_ptr<AdmissionController::Ticket> AdmissionController::acquire(
+    const std::string& space, const std::string& user, const MemoryTracker* memTracker) {
+  for (auto* running : {&spaces_[space], &users_[user]}) {
+    ++running->numQueries;
+    running->memTrackers.emplace(memTracker);
+  }
+  return std::unique_ptr<Ticket>(new Ticket(this, space, user, memTracker));
+}
+
+void AdmissionController::release(const Ticket& ticket) {
+  {
+    std::lock_guard<std::mutex> lk(lock_);
+    auto unref = [&ticket](auto& running, const std::string& key) {
+      auto iter = running.find(key);
+      DCHECK(iter != running.end());
+      iter->second.memTrackers.erase(ticket.memTracker_);
+      if (--iter->second.numQueries == 0) {
+        running.erase(iter);
+      }
+    };
+    unref(spaces_, ticket.space_);
+    unref(users_, ticket.user_);
+    if (numQueued_ == 0) {
+      return;
+    }
+  }
+  dispatch();
+}
+
+void AdmissionController::dispatch() {
+  std::vector<std::pair<Waiting, std::unique_ptr<Ticket>>> admitted;
+  std::vector<Waiting> expired;
+  {
+    std::lock_guard<std::mutex> lk(lock_);
+    auto timeoutMs = static_cast<uint64_t>(std::max(FLAGS_admission_queue_timeout_ms, 0));
+    for (int p = kHigh; p >= kLow; --p) {
+      auto& queue = queues_[p];
+      for (auto iter = queue.begin(); iter != queue.end();) {
+        auto waitUs = iter->duration.elapsedInUSec();
+        bool admit = admissible(iter->space, iter->user);
+        if (!admit && (timeoutMs == 0 || waitUs < timeoutMs * 1000)) {
+          ++iter;
+          continue;
+        }
+        stats::StatsManager::addValue(kAdmissionWaitLatencyUs, waitUs);
+        dequeued(*iter);
+        if (admit) {
+          auto ticket = acquire(iter->space, iter->user, iter->memTracker);
+          admitted.emplace_back(std::move(*iter), std::move(ticket));
+        } else {
+          expired.emplace_back(std::move(*iter));
+        }
+        iter = queue.erase(iter);
+      }
+    }
+  }
+
+  for (auto& query : admitted) {
+    auto& waiting = query.first;
+    if (waiting.runner == nullptr) {
+      waiting.execute(std::move(query.second));
+      continue;
+    }
+    // Don't run the query in the thread of the finished one or of the timer
+    waiting.runner->add([execute = std::move(waiting.execute),
+                         ticket = std::move(query.second)]() mutable {
+      execute(std::move(ticket));
+    });
+  }
+  for (auto& waiting : expired) {
+    stats::StatsManager::addValue(kNumRejectedQueries);
+    waiting.reject(Status::Error("Query was not admitted in %d ms, too many queries running",
+                                 FLAGS_admission_queue_timeout_ms));
+  }
+}
+
+}  // namespace graph
+}  // namespace nebula
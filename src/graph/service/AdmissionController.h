@@ -0,0 +1,137 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_SERVICE_ADMISSIONCONTROLLER_H_
+#define GRAPH_SERVICE_ADMISSIONCONTROLLER_H_
+
+#include <folly/Executor.h>
+#include <folly/Function.h>
+
+#include <boost/core/noncopyable.hpp>
+
+#include "common/base/Base.h"
+#include "common/base/Status.h"
+#include "common/memory/MemoryTracker.h"
+#include "common/thread/GenericWorker.h"
+#include "common/time/Duration.h"
+
+namespace nebula {
+namespace graph {
+
+class QueryInstance;
+
+/**
+ * AdmissionController limits the queries running at the same time in each space and for each
+ * user, by the number of the queries and by the memory they are using. A query beyond the limits
+ * waits in a bounded queue until the running queries of its space and user finish, and fails if
+ * the queue is full or it has waited too long. A query within the limits is queued as well if a
+ * query queued before it is waiting for the same limited space or user, so it never overtakes
+ * them, while the queries of the other spaces and users are not held up. The queued queries of a
+ * higher priority class, given by the session config `query_priority', are admitted first.
+ */
+class AdmissionController final : public boost::noncopyable {
+ public:
+  // Holds the slot of an admitted query, released when the query is done
+  class Ticket final : public boost::noncopyable {
+   public:
+    ~Ticket();
+
+   private:
+    friend class AdmissionController;
+    Ticket(AdmissionController* controller,
+           std::string space,
+           std::string user,
+           const MemoryTracker* memTracker)
+        : controller_(controller),
+          space_(std::move(space)),
+          user_(std::move(user)),
+          memTracker_(memTracker) {}
+
+    AdmissionController* controller_{nullptr};
+    std::string space_;
+    std::string user_;
+    const MemoryTracker* memTracker_{nullptr};
+  };
+
+  enum Priority : int8_t {
+    kLow = 0,
+    kNormal = 1,
+    kHigh = 2,
+  };
+
+  using Execute = folly::Function<void(std::unique_ptr<Ticket>)>;
+  using Reject = folly::Function<void(Status)>;
+
+  Status init();
+
+  // Execute the query if it's admitted, otherwise queue or reject it
+  void admit(QueryInstance* instance);
+
+  // Call execute with the ticket of the query once it's admitted, or reject it. The queued query
+  // is executed in the runner, or in the thread admitting it if the runner is nullptr
+  void admit(std::string space,
+             std::string user,
+             Priority priority,
+             const MemoryTracker* memTracker,
+             folly::Executor* runner,
+             Execute execute,
+             Reject reject);
+
+ private:
+  struct Waiting {
+    std::string space;
+    std::string user;
+    const MemoryTracker* memTracker;
+    folly::Executor* runner;
+    Execute execute;
+    Reject reject;
+    time::Duration duration;
+  };
+
+  struct Running {
+    size_t numQueries{0};
+    std::unordered_set<const MemoryTracker*> memTrackers;
+  };
+
+  static bool enabled();
+
+  static Priority priorityOf(const QueryInstance* instance);
+
+  bool admissible(const std::string& space, const std::string& user) const;
+
+  // Whether a query queued is waiting for the same limited space or user, the caller must hold
+  // lock_
+  bool waitingBefore(const std::string& space, const std::string& user) const;
+
+  // Count the waiting query in or out of the queued ones, the caller must hold lock_
+  void enqueue(Priority priority, Waiting waiting);
+  void dequeued(const Waiting& waiting);
+
+  // Count a query as running, the caller must hold lock_
+  std::unique_ptr<Ticket> acquire(const std::string& space,
+                                  const std::string& user,
+                                  const MemoryTracker* memTracker);
+
+  void release(const Ticket& ticket);
+
+  // Admit the queued queries which are within the limits now, and reject the timeout ones
+  void dispatch();
+
+  mutable std::mutex lock_;
+  std::unordered_map<std::string, Running> spaces_;
+  std::unordered_map<std::string, Running> users_;
+  // Ordered from the lowest priority class to the highest
+  std::deque<Waiting> queues_[kHigh + 1];
+  size_t numQueued_{0};
+  // The number of the queued queries of each space and user
+  std::unordered_map<std::string, size_t> queuedSpaces_;
+  std::unordered_map<std::string, size_t> queuedUsers_;
+  std::unique_ptr<thread::GenericWorker> timer_;
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_SERVICE_ADMISSIONCONTROLLER_H_
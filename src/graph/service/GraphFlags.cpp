@@ -13,6 +13,10 @@ DEFINE_int32(client_idle_timeout_secs,
              "The number of seconds Nebula service waits before closing the idle connections");
 DEFINE_int32(session_idle_timeout_secs, 28800, "The number of seconds before idle sessions expire");
 DEFINE_int32(session_reclaim_interval_secs, 10, "Period we try to reclaim expired sessions");
+DEFINE_int32(session_running_queries_update_interval_secs,
+             60,
+             "Period we update the stats of the running queries of a session not changed otherwise "
+             "to meta, e.g. the durations shown by SHOW ALL QUERIES");
 DEFINE_int32(num_netio_threads,
              0,
              "The number of networking threads, 0 for number of physical CPU cores");
@@ -72,6 +76,74 @@ DEFINE_bool(disable_octal_escape_char,
 DEFINE_bool(enable_experimental_feature, false, "Whether to enable experimental feature");
 
 DEFINE_int32(num_rows_to_check_memory, 1024, "number rows to check memory");
+DEFINE_int64(query_memory_limit_mb,
+             0,
+             "Max memory in MB the results of a query could use, the query fails if exceeded. "
+             "0 means no limit");
+DEFINE_int64(session_memory_limit_mb,
+             0,
+             "Max memory in MB the running queries of a session could use. 0 means no limit");
+DEFINE_int64(max_read_staleness_ms,
+             0,
+             "The reads of GetNeighbors and GetProp could be served by the storage followers whose "
+             "data is at most max_read_staleness_ms behind the leader. It could be overridden by "
+             "the session config of the same name. 0 means only reading from the leader");
+DEFINE_bool(read_from_analytics_replicas,
+            false,
+            "The reads of GetNeighbors and GetProp are served by the ANALYTICS listeners of the "
+            "parts having one, which lag behind by the interval of listener applying logs. It "
+            "could be overridden by the session config `analytical'");
+DEFINE_int64(query_timeout_ms,
+             0,
+             "A query fails once it has run for so long, and its storage requests are given up by "
+             "storage. It could be overridden by the session config of the same name. 0 means no "
+             "limit");
+DEFINE_string(storage_resource_group,
+              "",
+              "The resource group of storaged to run the reads of the queries, see "
+              "--storage_resource_groups of storaged. It could be overridden by the session config "
+              "resource_group. Empty means the group of the space");
+DEFINE_int64(adaptive_sample_edge_budget,
+             0,
+             "If positive, the max edges returned by each GetNeighbors request of a GO step whose "
+             "sample count is pushed down to storage. The budget is split across the vertices in "
+             "proportion to their degrees, after the edges of each vertex are sampled by the "
+             "sample count. It could be overridden by the session config of the same name. 0 "
+             "means no budget");
+DEFINE_bool(enable_join_vid_filter,
+            false,
+            "If true, a pattern of MATCH joined with the previous ones on a node is read after "
+            "them, and the vids of the node read by them are sent to storage in a bloom filter, "
+            "so that the rows which the join drops are discarded by storage");
+DEFINE_int64(max_join_vid_filter_keys,
+             1000000,
+             "The bloom filter of the vids of a join is not sent if there are more rows to build "
+             "it from");
+DEFINE_bool(enable_match_expand_intersect,
+            false,
+            "If true, a cycle of a MATCH pattern closed by the two edges of a new node is expanded "
+            "by intersecting the sorted neighbors of the vertices on both ends of them, instead of "
+            "expanding all the paths of the two edges and filtering them by the end");
+DEFINE_bool(enable_khop_get_neighbors,
+            false,
+            "If true, the steps of GO N STEPS from the given vids are expanded inside storaged "
+            "except the last one, which saves the round trips of graphd for each step. It takes "
+            "no effect on a GO with a sample or limit on its steps, or from the piped vids");
+DEFINE_bool(enable_encoded_tag_rows,
+            false,
+            "If true, storaged returns the tag props of the one step GetNeighbors as the encoded "
+            "rows, which graphd decodes only when a prop is read, instead of decoding all of the "
+            "props of the vertices before sending them");
+DEFINE_int64(max_skip_scan_leading_ndv,
+             64,
+             "An index without any condition on its first field is scanned for each value of the "
+             "first field by the conditions on the following fields, if the first field has no "
+             "more distinct values than this in the stats, 0 to disable it");
+DEFINE_bool(enable_index_intersection,
+            true,
+            "If true, the AND condition of a lookup answered by two indexes together is scanned "
+            "by both of them and their rows are intersected by storage, when it's estimated "
+            "cheaper than filtering the rows of one of them by the stats");
 DEFINE_int32(max_sessions_per_ip_per_user,
              300,
              "Maximum number of sessions that can be created per IP and per user");
@@ -95,9 +167,88 @@ DEFINE_int32(min_batch_size,
              "The min batch size for handling dataset in multi job mode, only enabled when "
              "max_job_size is greater than 1.");
 DEFINE_int32(max_job_size, 1, "The max job size in multi job mode.");
+DEFINE_bool(enable_batch_expression_eval,
+            false,
+            "Whether to evaluate the filter and project expressions column-at-a-time over "
+            "sequential results, falling back to row-based evaluation if not supported.");
+DEFINE_bool(enable_pipeline_execution,
+            false,
+            "Whether to fuse the chains of Filter, Project, Unwind and Limit into pipelines, which "
+            "push the rows through all the operators batch by batch without materializing the "
+            "results between them.");
+DEFINE_int32(pipeline_batch_size, 1024, "The number of rows pushed through a pipeline at a time.");
+DEFINE_bool(enable_task_scheduler,
+            false,
+            "Whether to run the executors of the queries by the work-stealing task scheduler, "
+            "which prefers the tasks of the queries that have taken less time.");
+DEFINE_int32(num_task_scheduler_threads,
+             0,
+             "Number of threads of the task scheduler, 0 means the number of CPU cores.");
+DEFINE_int32(task_time_slice_us,
+             10000,
+             "The tasks of a query are demoted to the middle priority once they have taken this "
+             "much time in total, and to the low priority once they have taken ten times of it.");
+DEFINE_int32(max_concurrent_queries_per_space,
+             0,
+             "Max number of the queries running at the same time in a space, 0 means unlimited.");
+DEFINE_int32(max_concurrent_queries_per_user,
+             0,
+             "Max number of the queries running at the same time of a user, 0 means unlimited.");
+DEFINE_int32(max_running_memory_mb_per_space,
+             0,
+             "No more query of a space is admitted once its running queries have used this much "
+             "memory in MB, 0 means unlimited.");
+DEFINE_int32(max_running_memory_mb_per_user,
+             0,
+             "No more query of a user is admitted once its running queries have used this much "
+             "memory in MB, 0 means unlimited.");
+DEFINE_int32(admission_queue_size,
+             1024,
+             "Max number of the queries waiting to be admitted, the queries beyond it are "
+             "rejected.");
+DEFINE_int32(admission_queue_timeout_ms,
+             10000,
+             "A query fails if it's not admitted in this much time, 0 means waiting forever.");
+DEFINE_bool(enable_plan_cache,
+            false,
+            "Whether to cache the plans of the queries reading the graph, which are reused by the "
+            "queries of the same text, parameters, space and user. The single GO and FETCH "
+            "vertices queries only differing in the literal start vids share the plan.");
+DEFINE_int32(plan_cache_capacity, 1024, "Max number of the plans cached.");
+DEFINE_bool(enable_result_cache,
+            false,
+            "Whether to cache the results of the queries reading the graph which start with the "
+            "hint /*+ cache */ or /*+ cache(<ttl seconds>) */.");
+DEFINE_int64(result_cache_capacity_mb, 256, "Max size in MB of the results cached.");
+DEFINE_int32(result_cache_ttl_secs,
+             60,
+             "The time a result is cached if the hint doesn't specify it, which also bounds how "
+             "long the result stays stale after the writes seen by the other graphds only.");
+
+DEFINE_int32(cursor_batch_size,
+             10000,
+             "The number of rows returned at a time by the queries executed with cursors, if the "
+             "client doesn't specify it.");
+DEFINE_int32(max_cursors_per_session,
+             8,
+             "Max number of the open cursors of a session, whose rows not fetched yet are kept "
+             "in memory.");
+DEFINE_int32(cursor_idle_timeout_secs,
+             300,
+             "A cursor not fetched for so long is released, so the rows of the cursors abandoned "
+             "by the clients are not kept until their sessions expire.");
+DEFINE_int32(max_prepared_statements_per_session,
+             128,
+             "Max number of the statements prepared by a session.");
+DEFINE_int32(max_batch_statements,
+             256,
+             "Max number of the statements executed concurrently by a call of executeBatch.");
 
 DEFINE_bool(enable_async_gc, false, "If enable async gc.");
 DEFINE_uint32(
     gc_worker_size,
     0,
     "Background garbage clean workers, default number is 0 which means using hardware core size.");
+DEFINE_int64(gc_large_garbage_bytes,
+             1 << 20,
+             "The garbage reserving at least the bytes is destroyed before the smaller ones.");
@@ -12,6 +12,7 @@ DECLARE_int32(port);
 DECLARE_int32(client_idle_timeout_secs);
 DECLARE_int32(session_idle_timeout_secs);
 DECLARE_int32(session_reclaim_interval_secs);
+DECLARE_int32(session_running_queries_update_interval_secs);
 DECLARE_int32(num_netio_threads);
 DECLARE_int32(num_accept_threads);
 DECLARE_int32(num_worker_threads);
@@ -58,10 +59,47 @@ DECLARE_bool(enable_client_white_list);
 DECLARE_string(client_white_list);
 
 DECLARE_int32(num_rows_to_check_memory);
+DECLARE_int64(query_memory_limit_mb);
+DECLARE_int64(session_memory_limit_mb);
+DECLARE_int64(max_read_staleness_ms);
+DECLARE_bool(read_from_analytics_replicas);
+DECLARE_int64(query_timeout_ms);
+DECLARE_string(storage_resource_group);
+DECLARE_int64(adaptive_sample_edge_budget);
+DECLARE_bool(enable_join_vid_filter);
+DECLARE_int64(max_join_vid_filter_keys);
+DECLARE_bool(enable_match_expand_intersect);
+DECLARE_bool(enable_khop_get_neighbors);
+DECLARE_bool(enable_encoded_tag_rows);
+DECLARE_int64(max_skip_scan_leading_ndv);
+DECLARE_bool(enable_index_intersection);
 
 DECLARE_int32(min_batch_size);
 DECLARE_int32(max_job_size);
+DECLARE_bool(enable_batch_expression_eval);
+DECLARE_bool(enable_pipeline_execution);
+DECLARE_int32(pipeline_batch_size);
+DECLARE_bool(enable_task_scheduler);
+DECLARE_int32(num_task_scheduler_threads);
+DECLARE_int32(task_time_slice_us);
+DECLARE_int32(max_concurrent_queries_per_space);
+DECLARE_int32(max_concurrent_queries_per_user);
+DECLARE_int32(max_running_memory_mb_per_space);
+DECLARE_int32(max_running_memory_mb_per_user);
+DECLARE_int32(admission_queue_size);
+DECLARE_int32(admission_queue_timeout_ms);
+DECLARE_bool(enable_plan_cache);
+DECLARE_int32(plan_cache_capacity);
+DECLARE_bool(enable_result_cache);
+DECLARE_int64(result_cache_capacity_mb);
+DECLARE_int32(result_cache_ttl_secs);
+DECLARE_int32(cursor_batch_size);
+DECLARE_int32(max_cursors_per_session);
+DECLARE_int32(cursor_idle_timeout_secs);
+DECLARE_int32(max_prepared_statements_per_session);
+DECLARE_int32(max_batch_statements);
 
 DECLARE_bool(enable_async_gc);
 DECLARE_uint32(gc_worker_size);
+DECLARE_int64(gc_large_garbage_bytes);
 #endif  // GRAPH_GRAPHFLAGS_H_
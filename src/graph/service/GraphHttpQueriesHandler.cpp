@@ -0,0 +1,110 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/service/GraphHttpQueriesHandler.h"
+
+#include <proxygen/httpserver/RequestHandler.h>
+#include <proxygen/httpserver/ResponseBuilder.h>
+#include <proxygen/lib/http/ProxygenErrorEnum.h>
+#include <thrift/lib/cpp/util/EnumUtils.h>
+
+#include "common/time/WallClock.h"
+#include "graph/context/QueryResourceUsage.h"
+#include "graph/service/GraphServer.h"
+#include "graph/session/GraphSessionManager.h"
+
+namespace nebula {
+namespace graph {
+
+using proxygen::HTTPMessage;
+using proxygen::HTTPMethod;
+using proxygen::ProxygenError;
+using proxygen::ResponseBuilder;
+using proxygen::UpgradeProtocol;
+
+void GraphHttpQueriesHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
+  if (!headers->getMethod() || headers->getMethod().value() != HTTPMethod::GET) {
+    // Unsupported method
+    err_ = HttpCode::E_UNSUPPORTED_METHOD;
+    return;
+  }
+}
+
+void GraphHttpQueriesHandler::onBody(std::unique_ptr<folly::IOBuf>) noexcept {
+  // Do nothing, we only support GET
+}
+
+void GraphHttpQueriesHandler::onEOM() noexcept {
+  switch (err_) {
+    case HttpCode::E_UNSUPPORTED_METHOD:
+      ResponseBuilder(downstream_)
+          .status(WebServiceUtils::to(HttpStatusCode::METHOD_NOT_ALLOWED),
+                  WebServiceUtils::toString(HttpStatusCode::METHOD_NOT_ALLOWED))
+          .sendWithEOM();
+      return;
+    default:
+      break;
+  }
+
+  if (server_->sessionManager() == nullptr) {
+    ResponseBuilder(downstream_)
+        .status(WebServiceUtils::to(HttpStatusCode::FORBIDDEN),
+                WebServiceUtils::toString(HttpStatusCode::FORBIDDEN))
+        .body("The graph service is not running")
+        .sendWithEOM();
+    return;
+  }
+
+  ResponseBuilder(downstream_)
+      .status(WebServiceUtils::to(HttpStatusCode::OK),
+              WebServiceUtils::toString(HttpStatusCode::OK))
+      .body(folly::toJson(getQueries()))
+      .sendWithEOM();
+}
+
+void GraphHttpQueriesHandler::onUpgrade(UpgradeProtocol) noexcept {
+  // Do nothing
+}
+
+void GraphHttpQueriesHandler::requestComplete() noexcept {
+  delete this;
+}
+
+void GraphHttpQueriesHandler::onError(ProxygenError error) noexcept {
+  LOG(ERROR) << "Web service GraphHttpQueriesHandler got error: "
+             << proxygen::getErrorString(error);
+}
+
+folly::dynamic GraphHttpQueriesHandler::getQueries() const {
+  folly::dynamic queries = folly::dynamic::array();
+  auto* sessionManager = server_->sessionManager();
+  if (sessionManager == nullptr) {
+    return queries;
+  }
+  auto now = time::WallClock::fastNowInMicroSec();
+  for (const auto& session : sessionManager->getSessionFromLocalCache()) {
+    for (const auto& query : session.get_queries()) {
+      const auto& desc = query.second;
+      folly::dynamic json = folly::dynamic::object();
+      json["session_id"] = session.get_session_id();
+      json["plan_id"] = query.first;
+      json["user"] = session.get_user_name();
+      json["space"] = session.get_space_name();
+      json["start_time"] = desc.get_start_time();
+      json["duration_us"] = now - desc.get_start_time();
+      json["memory_in_bytes"] = desc.get_memory_in_bytes();
+      json["status"] = apache::thrift::util::enumNameSafe(desc.get_status());
+      json["query"] = desc.get_query();
+      if (desc.resources_ref().has_value()) {
+        json["resources"] = QueryResourceUsage::toJson(*desc.resources_ref());
+      }
+      queries.push_back(std::move(json));
+    }
+  }
+  return queries;
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -0,0 +1,49 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_SERVICE_GRAPHHTTPQUERIESHANDLER_H_
+#define GRAPH_SERVICE_GRAPHHTTPQUERIESHANDLER_H_
+
+#include <proxygen/httpserver/RequestHandler.h>
+
+#include "common/base/Base.h"
+#include "webservice/Common.h"
+
+namespace nebula {
+namespace graph {
+
+class GraphServer;
+
+/**
+ * @brief Show the queries running in this graph service with the resources they used so far in
+ * JSON, like SHOW LOCAL QUERIES
+ */
+class GraphHttpQueriesHandler : public proxygen::RequestHandler {
+ public:
+  explicit GraphHttpQueriesHandler(const GraphServer* server) : server_(server) {}
+
+  void onRequest(std::unique_ptr<proxygen::HTTPMessage> headers) noexcept override;
+
+  void onBody(std::unique_ptr<folly::IOBuf> body) noexcept override;
+
+  void onEOM() noexcept override;
+
+  void onUpgrade(proxygen::UpgradeProtocol protocol) noexcept override;
+
+  void requestComplete() noexcept override;
+
+  void onError(proxygen::ProxygenError error) noexcept override;
+
+ private:
+  folly::dynamic getQueries() const;
+
+ private:
+  const GraphServer* server_;
+  HttpCode err_{HttpCode::SUCCEEDED};
+};
+
+}  // namespace graph
+}  // namespace nebula
+#endif  // GRAPH_SERVICE_GRAPHHTTPQUERIESHANDLER_H_
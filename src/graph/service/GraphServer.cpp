@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "common/id/Snowflake.h"
+#include "common/thread/NumaTopology.h"
 #include "graph/service/GraphFlags.h"
 #include "graph/service/GraphService.h"
 namespace nebula {
@@ -20,7 +21,9 @@ GraphServer::~GraphServer() {
 }
 
 bool GraphServer::start() {
-  auto threadFactory = std::make_shared<folly::NamedThreadFactory>("graph-netio");
+  // The queries are run by the IO threads mostly
+  auto threadFactory = std::make_shared<thread::BoundThreadFactory>(
+      "graph-netio", std::vector<int>(), thread::MemoryArenas::kQuery);
   auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(FLAGS_num_netio_threads,
                                                                     std::move(threadFactory));
   int numThreads = FLAGS_num_worker_threads > 0 ? FLAGS_num_worker_threads
@@ -42,6 +45,7 @@ bool GraphServer::start() {
 
   // Init worker id for snowflake generating unique id
   nebula::Snowflake::initWorkerId(interface->metaClient_.get());
+  sessionManager_.store(interface->sessionManager());
 
   graphThread_ = std::make_unique<std::thread>([&] {
     thriftServer_->setPort(localHost_.port);
@@ -100,6 +104,7 @@ void GraphServer::stop() {
 
   ServiceStatus serverExpected = ServiceStatus::STATUS_RUNNING;
   serverStatus_.compare_exchange_strong(serverExpected, STATUS_STOPPED);
+  sessionManager_.store(nullptr);
 
   if (thriftServer_) {
     thriftServer_->stop();
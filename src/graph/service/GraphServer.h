@@ -13,6 +13,8 @@
 #include "common/network/NetworkUtils.h"
 namespace nebula {
 namespace graph {
+class GraphSessionManager;
+
 class GraphServer {
  public:
   explicit GraphServer(HostAddr localHost);
@@ -29,6 +31,11 @@ class GraphServer {
 
   void waitUntilStop();
 
+  // The sessions of the server, null if it's not running
+  GraphSessionManager* sessionManager() const {
+    return sessionManager_.load();
+  }
+
  private:
   HostAddr localHost_;
 
@@ -39,6 +46,7 @@ class GraphServer {
 
   enum ServiceStatus : uint8_t { STATUS_UNINITIALIZED = 0, STATUS_RUNNING = 1, STATUS_STOPPED = 2 };
   std::atomic<ServiceStatus> serverStatus_{STATUS_UNINITIALIZED};
+  std::atomic<GraphSessionManager*> sessionManager_{nullptr};
   std::mutex muStop_;
   std::condition_variable cvStop_;
 };
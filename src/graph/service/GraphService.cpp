@@ -11,14 +11,19 @@
 
 #include "clients/storage/StorageClient.h"
 #include "common/base/Base.h"
+#include "common/graph/JsonWriter.h"
 #include "common/stats/StatsManager.h"
 #include "common/time/Duration.h"
 #include "common/time/TimezoneInfo.h"
+#include "common/utils/ColumnarBuilder.h"
+#include "graph/context/QueryContext.h"
 #include "graph/service/CloudAuthenticator.h"
 #include "graph/service/GraphFlags.h"
 #include "graph/service/PasswordAuthenticator.h"
+#include "graph/service/PlanCache.h"
 #include "graph/service/RequestContext.h"
 #include "graph/stats/GraphStats.h"
+#include "parser/GQLParser.h"
 #include "version/Version.h"
 
 namespace nebula {
@@ -65,6 +70,14 @@ Status GraphService::init(std::shared_ptr<folly::IOThreadPoolExecutor> ioExecuto
                          initSessionMgrStatus.toString().c_str());
   }
 
+  if (FLAGS_enable_task_scheduler) {
+    size_t numThreads = FLAGS_num_task_scheduler_threads > 0
+                            ? static_cast<size_t>(FLAGS_num_task_scheduler_threads)
+                            : std::thread::hardware_concurrency();
+    LOG(INFO) << "Number of task scheduler threads: " << numThreads;
+    taskScheduler_ = std::make_unique<TaskScheduler>(numThreads);
+  }
+
   queryEngine_ = std::make_unique<QueryEngine>();
   return queryEngine_->init(std::move(ioExecutor), metaClient_.get());
 }
@@ -139,9 +152,21 @@ folly::Future<ExecutionResponse> GraphService::future_executeWithParameter(
     int64_t sessionId,
     const std::string& query,
     const std::unordered_map<std::string, Value>& parameterMap) {
+  return executeQuery(sessionId, query, parameterMap, 0);
+}
+
+folly::Future<ExecutionResponse> GraphService::executeQuery(
+    int64_t sessionId,
+    const std::string& query,
+    const std::unordered_map<std::string, Value>& parameterMap,
+    int64_t statementId) {
   auto ctx = std::make_unique<RequestContext<ExecutionResponse>>();
   ctx->setQuery(query);
-  ctx->setRunner(getThreadManager());
+  if (taskScheduler_ != nullptr) {
+    ctx->setRunner(taskScheduler_->makeRunner());
+  } else {
+    ctx->setRunner(getThreadManager());
+  }
   ctx->setSessionMgr(sessionManager_.get());
   auto future = ctx->future();
   // When the sessionId is 0, it means the clients to ping the connection is ok
@@ -151,7 +176,11 @@ folly::Future<ExecutionResponse> GraphService::future_executeWithParameter(
     ctx->finish();
     return future;
   }
-  auto cb = [this, sessionId, ctx = std::move(ctx), parameterMap = std::move(parameterMap)](
+  auto cb = [this,
+             sessionId,
+             statementId,
+             ctx = std::move(ctx),
+             parameterMap = std::move(parameterMap)](
                 StatusOr<std::shared_ptr<ClientSession>> ret) mutable {
     if (!ret.ok()) {
       LOG(ERROR) << "Get session for sessionId: " << sessionId << " failed: " << ret.status();
@@ -168,6 +197,17 @@ folly::Future<ExecutionResponse> GraphService::future_executeWithParameter(
           new std::string(folly::stringPrintf("SessionId[%ld] does not exist", sessionId)));
       return ctx->finish();
     }
+    if (statementId != 0) {
+      auto prepared = sessionPtr->preparedStatement(statementId);
+      if (prepared == nullptr) {
+        ctx->resp().errorCode = ErrorCode::E_EXECUTION_ERROR;
+        ctx->resp().errorMsg.reset(new std::string(
+            folly::stringPrintf("Prepared statement %ld does not exist", statementId)));
+        return ctx->finish();
+      }
+      ctx->setQuery(prepared->query);
+      ctx->setPrepared(std::move(prepared));
+    }
     stats::StatsManager::addValue(kNumQueries);
     stats::StatsManager::addValue(kNumActiveQueries);
     if (FLAGS_enable_space_level_metrics && sessionPtr->space().name != "") {
@@ -206,10 +246,201 @@ folly::Future<std::string> GraphService::future_executeJsonWithParameter(
     const std::string& query,
     const std::unordered_map<std::string, Value>& parameterMap) {
   return future_executeWithParameter(sessionId, query, parameterMap).thenValue([](auto&& resp) {
-    return folly::toJson(resp.toJson());
+    return JsonWriter::toJson(resp);
   });
 }
 
+folly::Future<cpp2::ExecutionCursorResponse> GraphService::future_executeWithCursor(
+    int64_t sessionId,
+    const std::string& query,
+    const std::unordered_map<std::string, Value>& parameterMap,
+    int32_t batchSize) {
+  size_t size = batchSize > 0 ? batchSize : std::max(FLAGS_cursor_batch_size, 1);
+  return future_executeWithParameter(sessionId, query, parameterMap)
+      .thenValue([this, sessionId, size](ExecutionResponse&& resp) {
+        cpp2::ExecutionCursorResponse cursorResp;
+        auto* data = resp.data.get();
+        if (data != nullptr && data->rows.size() > size) {
+          auto session = sessionManager_->findSessionFromCache(sessionId);
+          if (session == nullptr) {
+            resp.errorCode = ErrorCode::E_SESSION_INVALID;
+            resp.errorMsg.reset(
+                new std::string(folly::stringPrintf("SessionId[%ld] does not exist", sessionId)));
+            resp.data.reset();
+            cursorResp.resp_ref() = std::move(resp);
+            return cursorResp;
+          }
+          // Only the first batch is serialized and sent, the rest is kept for fetchNext()
+          DataSet rest(data->colNames);
+          rest.rows.reserve(data->rows.size() - size);
+          std::move(data->rows.begin() + size, data->rows.end(), std::back_inserter(rest.rows));
+          data->rows.resize(size);
+          auto cursorId = session->addCursor(std::move(rest));
+          if (!cursorId.ok()) {
+            resp.errorCode = ErrorCode::E_EXECUTION_ERROR;
+            resp.errorMsg.reset(new std::string(cursorId.status().toString()));
+            resp.data.reset();
+          } else {
+            cursorResp.cursor_id_ref() = cursorId.value();
+          }
+        }
+        cursorResp.resp_ref() = std::move(resp);
+        return cursorResp;
+      });
+}
+
+folly::Future<cpp2::FetchResponse> GraphService::future_fetchNext(int64_t sessionId,
+                                                                  int64_t cursorId,
+                                                                  int32_t batchSize) {
+  size_t size = batchSize > 0 ? batchSize : std::max(FLAGS_cursor_batch_size, 1);
+  return sessionManager_->findSession(sessionId, getThreadManager())
+      .thenValue([sessionId, cursorId, size](StatusOr<std::shared_ptr<ClientSession>> ret) {
+        cpp2::FetchResponse resp;
+        resp.has_more_ref() = false;
+        if (!ret.ok() || ret.value() == nullptr) {
+          resp.error_code_ref() = nebula::cpp2::ErrorCode::E_SESSION_INVALID;
+          resp.error_msg_ref() = folly::stringPrintf("SessionId[%ld] does not exist", sessionId);
+          return resp;
+        }
+        bool hasMore = false;
+        auto rows = ret.value()->fetchCursor(cursorId, size, &hasMore);
+        if (!rows.ok()) {
+          resp.error_code_ref() = nebula::cpp2::ErrorCode::E_EXECUTION_ERROR;
+          resp.error_msg_ref() = rows.status().toString();
+          return resp;
+        }
+        resp.error_code_ref() = nebula::cpp2::ErrorCode::SUCCEEDED;
+        resp.data_ref() = std::move(rows).value();
+        resp.has_more_ref() = hasMore;
+        return resp;
+      });
+}
+
+void GraphService::closeCursor(int64_t sessionId, int64_t cursorId) {
+  VLOG(2) << "Close cursor " << cursorId << " of session " << sessionId;
+  auto session = sessionManager_->findSessionFromCache(sessionId);
+  if (session != nullptr) {
+    session->closeCursor(cursorId);
+  }
+}
+
+folly::Future<cpp2::ExecutionColumnarResponse> GraphService::future_executeColumnar(
+    int64_t sessionId,
+    const std::string& query,
+    const std::unordered_map<std::string, Value>& parameterMap) {
+  return future_executeWithParameter(sessionId, query, parameterMap)
+      .thenValue([](ExecutionResponse&& resp) {
+        cpp2::ExecutionColumnarResponse columnarResp;
+        if (resp.data != nullptr) {
+          const auto& data = *resp.data;
+          cpp2::ColumnarDataSet columnar;
+          columnar.num_rows_ref() = data.rows.size();
+          for (size_t col = 0; col < data.colNames.size(); col++) {
+            columnar.columns_ref()->emplace_back(ColumnarBuilder::fromDataSet(data, col));
+          }
+          columnarResp.data_ref() = std::move(columnar);
+          resp.data.reset();
+        }
+        columnarResp.resp_ref() = std::move(resp);
+        return columnarResp;
+      });
+}
+
+folly::Future<cpp2::ExecutionBatchResponse> GraphService::future_executeBatch(
+    int64_t sessionId, const std::vector<cpp2::BatchStatement>& stmts) {
+  cpp2::ExecutionBatchResponse batchResp;
+  if (stmts.size() > static_cast<size_t>(std::max(FLAGS_max_batch_statements, 0))) {
+    batchResp.error_code_ref() = nebula::cpp2::ErrorCode::E_EXECUTION_ERROR;
+    batchResp.error_msg_ref() =
+        folly::stringPrintf("Too many statements in a batch: %zu, the max is %d",
+                            stmts.size(),
+                            FLAGS_max_batch_statements);
+    return folly::makeFuture<cpp2::ExecutionBatchResponse>(std::move(batchResp));
+  }
+  // Each statement is executed as a query of its own, so they run concurrently
+  std::vector<folly::Future<ExecutionResponse>> futures;
+  futures.reserve(stmts.size());
+  for (const auto& stmt : stmts) {
+    futures.emplace_back(executeQuery(sessionId, stmt.get_stmt(), stmt.get_parameter_map(), 0));
+  }
+  return folly::collectAll(std::move(futures))
+      .thenValue([batchResp = std::move(batchResp)](
+                     std::vector<folly::Try<ExecutionResponse>>&& tries) mutable {
+        batchResp.error_code_ref() = nebula::cpp2::ErrorCode::SUCCEEDED;
+        batchResp.responses_ref()->reserve(tries.size());
+        for (auto& t : tries) {
+          if (t.hasException()) {
+            ExecutionResponse resp;
+            resp.errorCode = ErrorCode::E_EXECUTION_ERROR;
+            resp.errorMsg = std::make_unique<std::string>(t.exception().what().toStdString());
+            batchResp.responses_ref()->emplace_back(std::move(resp));
+          } else {
+            batchResp.responses_ref()->emplace_back(std::move(t).value());
+          }
+        }
+        return std::move(batchResp);
+      });
+}
+
+folly::Future<cpp2::PrepareResponse> GraphService::future_prepare(int64_t sessionId,
+                                                                 const std::string& query) {
+  return sessionManager_->findSession(sessionId, getThreadManager())
+      .thenValue([sessionId, query](StatusOr<std::shared_ptr<ClientSession>> ret) {
+        cpp2::PrepareResponse resp;
+        if (!ret.ok() || ret.value() == nullptr) {
+          resp.error_code_ref() = nebula::cpp2::ErrorCode::E_SESSION_INVALID;
+          resp.error_msg_ref() = folly::stringPrintf("SessionId[%ld] does not exist", sessionId);
+          return resp;
+        }
+        // Only the syntax is checked, as the validation depends on the space and the parameters
+        QueryContext qctx;
+        GQLParser parser(&qctx);
+        auto sentence = parser.parse(query);
+        if (!sentence.ok()) {
+          resp.error_code_ref() = nebula::cpp2::ErrorCode::E_SYNTAX_ERROR;
+          resp.error_msg_ref() = sentence.status().toString();
+          return resp;
+        }
+        ClientSession::PreparedStatement stmt;
+        stmt.query = query;
+        stmt.text = PlanCache::normalize(query);
+        std::string templ;
+        if (PlanCache::templatize(stmt.text, &templ, &stmt.vids)) {
+          stmt.text = std::move(templ);
+        }
+        auto statementId = ret.value()->prepare(std::move(stmt));
+        if (!statementId.ok()) {
+          resp.error_code_ref() = nebula::cpp2::ErrorCode::E_EXECUTION_ERROR;
+          resp.error_msg_ref() = statementId.status().toString();
+          return resp;
+        }
+        resp.error_code_ref() = nebula::cpp2::ErrorCode::SUCCEEDED;
+        resp.statement_id_ref() = statementId.value();
+        return resp;
+      });
+}
+
+folly::Future<ExecutionResponse> GraphService::future_executePrepared(
+    int64_t sessionId,
+    int64_t statementId,
+    const std::unordered_map<std::string, Value>& parameterMap) {
+  if (statementId == 0) {
+    ExecutionResponse resp;
+    resp.errorCode = ErrorCode::E_EXECUTION_ERROR;
+    resp.errorMsg = std::make_unique<std::string>("Invalid prepared statement id");
+    return folly::makeFuture<ExecutionResponse>(std::move(resp));
+  }
+  return executeQuery(sessionId, "", parameterMap, statementId);
+}
+
+void GraphService::deallocatePrepared(int64_t sessionId, int64_t statementId) {
+  VLOG(2) << "Deallocate prepared statement " << statementId << " of session " << sessionId;
+  auto session = sessionManager_->findSessionFromCache(sessionId);
+  if (session != nullptr) {
+    session->deallocatePrepared(statementId);
+  }
+}
+
 Status GraphService::auth(const std::string& username, const std::string& password) {
   auto metaClient = queryEngine_->metaClient();
 
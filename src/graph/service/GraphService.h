@@ -8,6 +8,7 @@
 
 #include "common/base/Base.h"
 #include "graph/service/Authenticator.h"
+#include "graph/scheduler/TaskScheduler.h"
 #include "graph/service/QueryEngine.h"
 #include "graph/session/GraphSessionManager.h"
 #include "interface/gen-cpp2/GraphService.h"
@@ -48,16 +49,59 @@ class GraphService final : public cpp2::GraphServiceSvIf {
   folly::Future<std::string> future_executeJson(int64_t sessionId,
                                                 const std::string& stmt) override;
 
+  folly::Future<cpp2::ExecutionCursorResponse> future_executeWithCursor(
+      int64_t sessionId,
+      const std::string& stmt,
+      const std::unordered_map<std::string, Value>& parameterMap,
+      int32_t batchSize) override;
+
+  folly::Future<cpp2::FetchResponse> future_fetchNext(int64_t sessionId,
+                                                      int64_t cursorId,
+                                                      int32_t batchSize) override;
+
+  void closeCursor(int64_t sessionId, int64_t cursorId) override;
+
+  folly::Future<cpp2::ExecutionColumnarResponse> future_executeColumnar(
+      int64_t sessionId,
+      const std::string& stmt,
+      const std::unordered_map<std::string, Value>& parameterMap) override;
+
+  folly::Future<cpp2::ExecutionBatchResponse> future_executeBatch(
+      int64_t sessionId, const std::vector<cpp2::BatchStatement>& stmts) override;
+
+  folly::Future<cpp2::PrepareResponse> future_prepare(int64_t sessionId,
+                                                      const std::string& stmt) override;
+
+  folly::Future<ExecutionResponse> future_executePrepared(
+      int64_t sessionId,
+      int64_t statementId,
+      const std::unordered_map<std::string, Value>& parameterMap) override;
+
+  void deallocatePrepared(int64_t sessionId, int64_t statementId) override;
+
   folly::Future<cpp2::VerifyClientVersionResp> future_verifyClientVersion(
       const cpp2::VerifyClientVersionReq& req) override;
 
+  GraphSessionManager* sessionManager() const {
+    return sessionManager_.get();
+  }
+
   std::unique_ptr<meta::MetaClient> metaClient_;
 
  private:
   Status auth(const std::string& username, const std::string& password);
 
+  // Execute the query, or the statement prepared by the session if statementId is not 0
+  folly::Future<ExecutionResponse> executeQuery(
+      int64_t sessionId,
+      const std::string& query,
+      const std::unordered_map<std::string, Value>& parameterMap,
+      int64_t statementId);
+
   std::unique_ptr<GraphSessionManager> sessionManager_;
   std::unique_ptr<QueryEngine> queryEngine_;
+  // Runs the executors of the queries instead of the worker threads if enabled
+  std::unique_ptr<TaskScheduler> taskScheduler_;
 };
 
 }  // namespace graph
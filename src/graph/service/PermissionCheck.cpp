@@ -161,6 +161,7 @@ namespace graph {
     case Sentence::Kind::kShowGroups:
     case Sentence::Kind::kShowZones:
     case Sentence::Kind::kShowMetaLeader:
+    case Sentence::Kind::kShowCardinalityFeedback:
     case Sentence::Kind::kShowHosts: {
       /**
        * All roles can be show for above operations.
@@ -0,0 +1,409 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/service/PlanCache.h"
+
+#include "graph/service/GraphFlags.h"
+#include "graph/util/SchemaUtil.h"
+#include "parser/SequentialSentences.h"
+#include "parser/TraverseSentences.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+// Scan the normalized text of a query for the template, which has single blanks between the tokens
+class TemplateScanner final {
+ public:
+  explicit TemplateScanner(const std::string& text) : text_(text) {}
+
+  size_t pos() const {
+    return pos_;
+  }
+
+  bool atEnd() const {
+    return pos_ >= text_.size();
+  }
+
+  void skipBlank() {
+    if (!atEnd() && text_[pos_] == ' ') {
+      ++pos_;
+    }
+  }
+
+  // Consume the keyword followed by a blank, case insensitively
+  bool keyword(folly::StringPiece word) {
+    if (pos_ + word.size() >= text_.size() || text_[pos_ + word.size()] != ' ') {
+      return false;
+    }
+    for (size_t i = 0; i < word.size(); ++i) {
+      if (std::toupper(static_cast<unsigned char>(text_[pos_ + i])) != word[i]) {
+        return false;
+      }
+    }
+    pos_ += word.size() + 1;
+    return true;
+  }
+
+  // Consume a name, or a backquoted one
+  bool name() {
+    if (!atEnd() && text_[pos_] == '`') {
+      auto end = text_.find('`', pos_ + 1);
+      if (end == std::string::npos) {
+        return false;
+      }
+      pos_ = end + 1;
+      return true;
+    }
+    auto begin = pos_;
+    while (!atEnd() && isNameChar(text_[pos_])) {
+      ++pos_;
+    }
+    return pos_ > begin;
+  }
+
+  // Consume the names separated by the commas, e.g. the tags to fetch
+  bool names() {
+    do {
+      skipBlank();
+      if (!atEnd() && text_[pos_] == '*') {
+        ++pos_;
+      } else if (!name()) {
+        return false;
+      }
+      skipBlank();
+    } while (comma());
+    return true;
+  }
+
+  bool comma() {
+    if (!atEnd() && text_[pos_] == ',') {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  // Consume a literal vid, a quoted string without escapes or an integer
+  bool vid(std::vector<Value>* vids) {
+    if (atEnd()) {
+      return false;
+    }
+    auto quote = text_[pos_];
+    if (quote == '"' || quote == '\'') {
+      auto end = text_.find(quote, pos_ + 1);
+      if (end == std::string::npos) {
+        return false;
+      }
+      auto str = text_.substr(pos_ + 1, end - pos_ - 1);
+      if (str.find('\\') != std::string::npos) {
+        return false;
+      }
+      vids->emplace_back(std::move(str));
+      pos_ = end + 1;
+      return true;
+    }
+    auto begin = pos_;
+    if (text_[pos_] == '-') {
+      ++pos_;
+    }
+    // The integers with the leading zeros are octal
+    if (!atEnd() && text_[pos_] == '0' && pos_ + 1 < text_.size() &&
+        std::isdigit(static_cast<unsigned char>(text_[pos_ + 1]))) {
+      return false;
+    }
+    while (!atEnd() && std::isdigit(static_cast<unsigned char>(text_[pos_]))) {
+      ++pos_;
+    }
+    auto vid = folly::tryTo<int64_t>(folly::StringPiece(text_.data() + begin, pos_ - begin));
+    if (!vid.hasValue()) {
+      return false;
+    }
+    vids->emplace_back(vid.value());
+    return true;
+  }
+
+ private:
+  static bool isNameChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+  }
+
+  const std::string& text_;
+  size_t pos_{0};
+};
+
+// Whether a statement separator or a pipe is out of the quoted strings
+bool hasSeparator(const std::string& text) {
+  char quote = '\0';
+  for (size_t i = 0; i < text.size(); ++i) {
+    char c = text[i];
+    if (quote != '\0') {
+      if (c == '\\') {
+        ++i;
+      } else if (c == quote) {
+        quote = '\0';
+      }
+    } else if (c == '"' || c == '\'' || c == '`') {
+      quote = c;
+    } else if (c == ';' || c == '|') {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+// static
+bool PlanCache::cacheable(const Sentence* sentence) {
+  switch (sentence->kind()) {
+    case Sentence::Kind::kSequential: {
+      auto sentences = static_cast<const SequentialSentences*>(sentence)->sentences();
+      return std::all_of(sentences.begin(), sentences.end(), [](auto* s) { return cacheable(s); });
+    }
+    case Sentence::Kind::kPipe: {
+      auto* pipe = static_cast<const PipedSentence*>(sentence);
+      return cacheable(pipe->left()) && cacheable(pipe->right());
+    }
+    case Sentence::Kind::kSet: {
+      auto* set = static_cast<SetSentence*>(const_cast<Sentence*>(sentence));
+      return cacheable(set->left()) && cacheable(set->right());
+    }
+    case Sentence::Kind::kAssignment:
+      return cacheable(static_cast<const AssignmentSentence*>(sentence)->sentence());
+    case Sentence::Kind::kGo:
+    case Sentence::Kind::kMatch:
+    case Sentence::Kind::kLookup:
+    case Sentence::Kind::kFetchVertices:
+    case Sentence::Kind::kFetchEdges:
+    case Sentence::Kind::kFindPath:
+    case Sentence::Kind::kGetSubgraph:
+    case Sentence::Kind::kYield:
+    case Sentence::Kind::kOrderBy:
+    case Sentence::Kind::kLimit:
+    case Sentence::Kind::kGroupBy:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// static
+std::string PlanCache::normalize(const std::string& query) {
+  std::string text;
+  text.reserve(query.size());
+  char quote = '\0';
+  bool blank = false;
+  for (size_t i = 0; i < query.size(); ++i) {
+    char c = query[i];
+    if (quote != '\0') {
+      text.push_back(c);
+      if (c == '\\' && i + 1 < query.size()) {
+        text.push_back(query[++i]);
+      } else if (c == quote) {
+        quote = '\0';
+      }
+      continue;
+    }
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      blank = true;
+      continue;
+    }
+    // The comments are blanks too, as the scanner skips them
+    if (c == '#' || query.compare(i, 2, "//") == 0) {
+      auto end = query.find('\n', i);
+      i = end == std::string::npos ? query.size() : end;
+      blank = true;
+      continue;
+    }
+    if (query.compare(i, 2, "/*") == 0) {
+      auto end = query.find("*/", i + 2);
+      if (end != std::string::npos) {
+        i = end + 1;
+        blank = true;
+        continue;
+      }
+      // Unterminated, which fails the parsing, keep it as it is
+      if (blank && !text.empty()) {
+        text.push_back(' ');
+      }
+      text.append(query, i, std::string::npos);
+      break;
+    }
+    if (blank && !text.empty()) {
+      text.push_back(' ');
+    }
+    blank = false;
+    if (c == '"' || c == '\'' || c == '`') {
+      quote = c;
+    }
+    text.push_back(c);
+  }
+  return text;
+}
+
+// static
+bool PlanCache::templatize(const std::string& text,
+                           std::string* templ,
+                           std::vector<Value>* vids) {
+  if (hasSeparator(text)) {
+    return false;
+  }
+  TemplateScanner scanner(text);
+  folly::StringPiece next;
+  if (scanner.keyword("GO")) {
+    // Skip the steps
+    while (!scanner.keyword("FROM")) {
+      if (!scanner.name()) {
+        return false;
+      }
+      scanner.skipBlank();
+    }
+    next = "OVER";
+  } else if (scanner.keyword("FETCH") && scanner.keyword("PROP") && scanner.keyword("ON")) {
+    if (!scanner.names()) {
+      return false;
+    }
+    next = "YIELD";
+  } else {
+    return false;
+  }
+
+  auto begin = scanner.pos();
+  std::vector<Value> literals;
+  do {
+    scanner.skipBlank();
+    if (!scanner.vid(&literals)) {
+      return false;
+    }
+    scanner.skipBlank();
+  } while (scanner.comma());
+  auto end = scanner.pos();
+  // The vids of different types are rejected by the validator
+  auto type = literals.front().type();
+  if (!scanner.keyword(next) || text[end - 1] != ' ' ||
+      std::any_of(literals.begin(), literals.end(), [type](auto& v) { return v.type() != type; })) {
+    return false;
+  }
+  *templ = folly::sformat("{}{} {}",
+                          folly::StringPiece(text.data(), begin),
+                          type == Value::Type::INT ? "?int" : "?str",
+                          folly::StringPiece(text.data() + end, text.size() - end));
+  *vids = std::move(literals);
+  return true;
+}
+
+// static
+std::string PlanCache::key(const RequestContext<ExecutionResponse>* rctx,
+                           std::vector<Value>* vids) {
+  auto* session = rctx->session();
+  std::string text;
+  if (rctx->prepared() != nullptr) {
+    // Normalized and templatized once when it's prepared
+    text = rctx->prepared()->text;
+    *vids = rctx->prepared()->vids;
+  } else {
+    text = normalize(rctx->query());
+    std::string templ;
+    if (templatize(text, &templ, vids)) {
+      text = std::move(templ);
+    }
+  }
+  // The vids are bound to the cached plan without the validation, so the template is taken only if
+  // they pass it, otherwise the query is keyed by itself and the validator reports the error
+  auto vidType = session->space().spaceDesc.vid_type_ref()->get_type();
+  if (std::any_of(vids->begin(), vids->end(), [vidType](const auto& vid) {
+        return !SchemaUtil::isValidVid(vid, vidType);
+      })) {
+    text = normalize(rctx->prepared() != nullptr ? rctx->prepared()->query : rctx->query());
+    vids->clear();
+  }
+  auto key = folly::sformat("{}\n{}\n{}", session->space().id, session->user(), text);
+  std::vector<std::pair<std::string, const Value*>> params;
+  params.reserve(rctx->parameterMap().size());
+  for (auto& param : rctx->parameterMap()) {
+    params.emplace_back(param.first, &param.second);
+  }
+  std::sort(params.begin(), params.end());
+  for (auto& param : params) {
+    const auto* value = param.second;
+    auto type = static_cast<int>(value->type());
+    key.append(folly::sformat("\n{}:{}:{}", param.first, type, value->toString()));
+  }
+  return key;
+}
+
+std::unique_ptr<QueryContext> PlanCache::take(const std::string& key) {
+  std::vector<Entry> dropped;
+  std::unique_ptr<QueryContext> qctx;
+  {
+    std::lock_guard<std::mutex> lk(lock_);
+    checkVersion(&dropped);
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+      auto iter = found->second;
+      index_.erase(found);
+      qctx = std::move(iter->qctx);
+      lru_.erase(iter);
+    }
+  }
+  return qctx;
+}
+
+void PlanCache::put(const std::string& key, int64_t version, std::unique_ptr<QueryContext> qctx) {
+  DCHECK(qctx->planKept());
+  qctx->clearRequest();
+  // The plan compiled with the stale meta data is never cached
+  if (version != this->version() || qctx->planGrown()) {
+    return;
+  }
+  auto capacity = static_cast<size_t>(std::max(FLAGS_plan_cache_capacity, 0));
+  std::vector<Entry> dropped;
+  {
+    std::lock_guard<std::mutex> lk(lock_);
+    checkVersion(&dropped);
+    lru_.emplace_front(Entry{key, std::move(qctx)});
+    index_.emplace(key, lru_.begin());
+    while (lru_.size() > capacity) {
+      auto& last = lru_.back();
+      auto range = index_.equal_range(last.key);
+      for (auto iter = range.first; iter != range.second; ++iter) {
+        if (iter->second == std::prev(lru_.end())) {
+          index_.erase(iter);
+          break;
+        }
+      }
+      dropped.emplace_back(std::move(last));
+      lru_.pop_back();
+    }
+  }
+  // The dropped contexts are destroyed out of the lock
+}
+
+size_t PlanCache::size() const {
+  std::lock_guard<std::mutex> lk(lock_);
+  return lru_.size();
+}
+
+int64_t PlanCache::version() const {
+  return metaClient_->localDataLastUpdateTime();
+}
+
+void PlanCache::checkVersion(std::vector<Entry>* dropped) {
+  auto version = this->version();
+  if (version == version_) {
+    return;
+  }
+  version_ = version;
+  for (auto& entry : lru_) {
+    dropped->emplace_back(std::move(entry));
+  }
+  lru_.clear();
+  index_.clear();
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -0,0 +1,86 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_SERVICE_PLANCACHE_H_
+#define GRAPH_SERVICE_PLANCACHE_H_
+
+#include <boost/core/noncopyable.hpp>
+
+#include "common/base/Base.h"
+#include "graph/context/QueryContext.h"
+#include "parser/Sentence.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * PlanCache keeps the query contexts of the finished queries along with their compiled plans, so
+ * that a query with the same text could skip the parsing, the validation and the optimization.
+ *
+ * Since the validator folds the parameters into the plan, e.g. the start vertices of GO, a plan is
+ * keyed by the normalized query text and the parameter values, together with the space and the
+ * user, which the validation depends on. The only exception is the literal start vids of a single
+ * GO or FETCH vertices query, which are kept in a variable set while planning, so the plan is
+ * keyed by the template of the query and the variable is rebound to the vids of each run. All the
+ * plans are dropped once the meta data is reloaded, e.g. after a schema change. A cached context
+ * is taken out while running its plan, so the plan, whose expressions are stateful, is never
+ * shared by two running queries. The contexts are evicted in LRU order.
+ */
+class PlanCache final : public boost::noncopyable {
+ public:
+  using RequestContextPtr = QueryContext::RequestContextPtr;
+
+  explicit PlanCache(meta::MetaClient* metaClient) : metaClient_(metaClient) {}
+
+  // Only the queries reading the graph are cached
+  static bool cacheable(const Sentence* sentence);
+
+  // Collapse the blanks and the comments out of the quoted strings, and strip the leading and
+  // trailing ones
+  static std::string normalize(const std::string& query);
+
+  // Replace the literal start vids of a single GO or FETCH vertices query by a placeholder of
+  // their type, e.g. `GO FROM "a", "b" OVER e' to `GO FROM ?str OVER e', so the queries only
+  // differing in the vids share the plan. Return false if the normalized text is not the case.
+  static bool templatize(const std::string& text, std::string* templ, std::vector<Value>* vids);
+
+  // The vids are filled if the key is the template of the query, which are bound to the plan. The
+  // text of a prepared statement is taken as it is. The template is not taken if any of the vids
+  // doesn't match the vid type of the space.
+  static std::string key(const RequestContext<ExecutionResponse>* rctx, std::vector<Value>* vids);
+
+  // Take out the context of the plan cached for the key, or nullptr if not found
+  std::unique_ptr<QueryContext> take(const std::string& key);
+
+  // Put back the context whose plan is kept, which was compiled with the meta data of the version
+  void put(const std::string& key, int64_t version, std::unique_ptr<QueryContext> qctx);
+
+  // The version of the meta data the cached plans are compiled with
+  int64_t version() const;
+
+  size_t size() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    std::unique_ptr<QueryContext> qctx;
+  };
+
+  // Drop all the plans if the meta data has been reloaded, the caller must hold lock_
+  void checkVersion(std::vector<Entry>* dropped);
+
+  meta::MetaClient* metaClient_{nullptr};
+  mutable std::mutex lock_;
+  int64_t version_{-1};
+  // The most recently used goes first
+  std::list<Entry> lru_;
+  // There may be several contexts for the same key if the query ran concurrently
+  std::unordered_multimap<std::string, std::list<Entry>::iterator> index_;
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_SERVICE_PLANCACHE_H_
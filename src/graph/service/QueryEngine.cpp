@@ -7,6 +7,7 @@
 
 #include "common/base/Base.h"
 #include "common/memory/MemoryUtils.h"
+#include "common/stats/StatsManager.h"
 #include "common/meta/ServerBasedIndexManager.h"
 #include "common/meta/ServerBasedSchemaManager.h"
 #include "graph/context/QueryContext.h"
@@ -14,6 +15,7 @@
 #include "graph/planner/PlannersRegister.h"
 #include "graph/service/GraphFlags.h"
 #include "graph/service/QueryInstance.h"
+#include "graph/stats/GraphStats.h"
 #include "version/Version.h"
 
 DECLARE_bool(local_config);
@@ -41,19 +43,66 @@ Status QueryEngine::init(std::shared_ptr<folly::IOThreadPoolExecutor> ioExecutor
   }
   optimizer_ = std::make_unique<opt::Optimizer>(rulesets);
 
+  planCache_ = std::make_unique<PlanCache>(metaClient_);
+  resultCache_ = std::make_unique<ResultCache>(metaClient_, storage_.get());
+
+  admissionController_ = std::make_unique<AdmissionController>();
+  NG_RETURN_IF_ERROR(admissionController_->init());
+
   return setupMemoryMonitorThread();
 }
 
 // Create query context and query instance and execute it
 void QueryEngine::execute(RequestContextPtr rctx) {
-  auto qctx = std::make_unique<QueryContext>(std::move(rctx),
-                                             schemaManager_.get(),
-                                             indexManager_.get(),
-                                             storage_.get(),
-                                             metaClient_,
-                                             charsetInfo_);
+  std::string resultKey;
+  ResultCache::Version resultVersion;
+  auto resultTtl = FLAGS_enable_result_cache ? ResultCache::hintedTtl(rctx->query()) : 0;
+  if (resultTtl > 0) {
+    const auto& space = rctx->session()->space();
+    resultKey = ResultCache::key(rctx.get());
+    // Taken before running the query, so the writes during it are not missed
+    resultVersion = resultCache_->version(space.id);
+    auto hit = resultCache_->get(resultKey, space.id, &rctx->resp());
+    stats::StatsManager::addValue(hit ? kNumResultCacheHits : kNumResultCacheMisses);
+    if (hit) {
+      rctx->resp().spaceName = std::make_unique<std::string>(space.name);
+      rctx->resp().latencyInUs = rctx->duration().elapsedInUSec();
+      rctx->finish();
+      return;
+    }
+  }
+
+  std::unique_ptr<QueryContext> qctx;
+  std::string planKey;
+  std::vector<Value> planVids;
+  auto planVersion = planCache_->version();
+  bool cachePlan = FLAGS_enable_plan_cache;
+  if (cachePlan) {
+    planKey = PlanCache::key(rctx.get(), &planVids);
+    qctx = planCache_->take(planKey);
+    stats::StatsManager::addValue(qctx != nullptr ? kNumPlanCacheHits : kNumPlanCacheMisses);
+  }
+  if (qctx != nullptr) {
+    qctx->reset(std::move(rctx));
+    if (!planVids.empty()) {
+      qctx->bindConstantInput(planVids);
+    }
+  } else {
+    qctx = std::make_unique<QueryContext>(std::move(rctx),
+                                          schemaManager_.get(),
+                                          indexManager_.get(),
+                                          storage_.get(),
+                                          metaClient_,
+                                          charsetInfo_);
+  }
   auto* instance = new QueryInstance(std::move(qctx), optimizer_.get());
-  instance->execute();
+  if (cachePlan) {
+    instance->setPlanCache(planCache_.get(), std::move(planKey), planVersion, !planVids.empty());
+  }
+  if (resultTtl > 0) {
+    instance->setResultCache(resultCache_.get(), std::move(resultKey), resultVersion, resultTtl);
+  }
+  admissionController_->admit(instance);
 }
 
 Status QueryEngine::setupMemoryMonitorThread() {
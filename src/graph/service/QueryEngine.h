@@ -18,7 +18,10 @@
 #include "common/meta/SchemaManager.h"
 #include "common/network/NetworkUtils.h"
 #include "graph/optimizer/Optimizer.h"
+#include "graph/service/AdmissionController.h"
+#include "graph/service/PlanCache.h"
 #include "graph/service/RequestContext.h"
+#include "graph/service/ResultCache.h"
 #include "interface/gen-cpp2/GraphService.h"
 
 namespace nebula {
@@ -52,6 +55,9 @@ class QueryEngine final : public boost::noncopyable, public cpp::NonMovable {
   std::unique_ptr<storage::StorageClient> storage_;
   std::unique_ptr<opt::Optimizer> optimizer_;
   std::unique_ptr<thread::GenericWorker> memoryMonitorThread_;
+  std::unique_ptr<AdmissionController> admissionController_;
+  std::unique_ptr<PlanCache> planCache_;
+  std::unique_ptr<ResultCache> resultCache_;
   meta::MetaClient* metaClient_{nullptr};
   CharsetInfo* charsetInfo_{nullptr};
 };
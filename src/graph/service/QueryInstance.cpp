@@ -8,6 +8,7 @@
 #include "common/base/Base.h"
 #include "common/stats/StatsManager.h"
 #include "common/time/ScopedTimer.h"
+#include "common/time/WallClock.h"
 #include "graph/executor/ExecutionError.h"
 #include "graph/executor/Executor.h"
 #include "graph/optimizer/OptRule.h"
@@ -15,6 +16,7 @@
 #include "graph/planner/plan/PlanNode.h"
 #include "graph/scheduler/AsyncMsgNotifyBasedScheduler.h"
 #include "graph/scheduler/Scheduler.h"
+#include "graph/service/SlowQueryLog.h"
 #include "graph/stats/GraphStats.h"
 #include "graph/util/AstUtils.h"
 #include "graph/validator/Validator.h"
@@ -37,10 +39,18 @@ QueryInstance::QueryInstance(std::unique_ptr<QueryContext> qctx, Optimizer *opti
 }
 
 void QueryInstance::execute() {
-  Status status = validateAndOptimize();
-  if (!status.ok()) {
-    onError(std::move(status));
-    return;
+  span_ = tracing::Span::root("graph.query");
+  qctx_->setTraceSpan(span_.ref());
+  // Skip the compiling if the plan is taken from the cache
+  if (!qctx_->planKept()) {
+    Status status = validateAndOptimize();
+    if (!status.ok()) {
+      onError(std::move(status));
+      return;
+    }
+    if (planCache_ != nullptr && PlanCache::cacheable(sentence_.get())) {
+      qctx_->keepPlan(std::move(sentence_));
+    }
   }
 
   // Sentence is explain query, finish
@@ -102,7 +112,7 @@ Status QueryInstance::validateAndOptimize() {
 }
 
 bool QueryInstance::explainOrContinue() {
-  if (sentence_->kind() != Sentence::Kind::kExplain) {
+  if (sentence_ == nullptr || sentence_->kind() != Sentence::Kind::kExplain) {
     return true;
   }
   auto &resp = qctx_->rctx()->resp();
@@ -118,13 +128,27 @@ void QueryInstance::onFinish() {
   rctx->resp().spaceName = std::make_unique<std::string>(spaceName);
 
   fillRespData(&rctx->resp());
+  // The sentence is moved into the context if the plan is kept, which is only done for the reads
+  if (resultCache_ != nullptr && !qctx_->isKilled() &&
+      (qctx_->planKept() || (sentence_ != nullptr && PlanCache::cacheable(sentence_.get())))) {
+    resultCache_->put(resultKey_, resultVersion_, resultTtl_, rctx->resp());
+  }
 
   auto latency = rctx->duration().elapsedInUSec();
   rctx->resp().latencyInUs = latency;
   addSlowQueryStats(latency, spaceName);
+  logSlowQuery(latency, Status::OK());
+  endTrace(Status::OK());
   rctx->finish();
 
   rctx->session()->deleteQuery(qctx_.get());
+  // The plan killed is remembered by storage for a while, so it's not run again
+  if (planCache_ != nullptr && qctx_->planKept() && !qctx_->isKilled() &&
+      (!planTemplated_ || qctx_->constantInputs().size() == 1)) {
+    // The memory tracker of the query is gone with the request
+    ticket_.reset();
+    planCache_->put(planKey_, planVersion_, std::move(qctx_));
+  }
   // The `QueryInstance' is the root node holding all resources during the
   // execution. When the whole query process is done, it's safe to release this
   // object, as long as no other contexts have chances to access these resources
@@ -191,11 +215,50 @@ void QueryInstance::onError(Status status) {
         stats::StatsManager::counterWithLabels(kNumQueryErrors, {{"space", spaceName}}));
   }
   addSlowQueryStats(latency, spaceName);
+  logSlowQuery(latency, status);
+  endTrace(status);
   rctx->session()->deleteQuery(qctx_.get());
   rctx->finish();
   delete this;
 }
 
+void QueryInstance::logSlowQuery(uint64_t latency, const Status &status) const {
+  if (latency <= static_cast<uint64_t>(FLAGS_slow_query_threshold_us) ||
+      FLAGS_slow_query_log_file.empty()) {
+    return;
+  }
+  auto *rctx = qctx()->rctx();
+  auto *session = rctx->session();
+  folly::dynamic record = folly::dynamic::object();
+  record["time"] = time::WallClock::fastNowInSec();
+  record["session_id"] = session->id();
+  record["plan_id"] = qctx()->plan()->id();
+  record["user"] = session->user();
+  record["space"] = session->space().name;
+  record["latency_us"] = static_cast<int64_t>(latency);
+  record["query"] = rctx->query();
+  if (!status.ok()) {
+    record["error"] = status.toString();
+  }
+  const auto &memTracker = qctx()->memTracker();
+  auto peakMemory = memTracker != nullptr ? memTracker->peak() : 0;
+  record["resources"] = QueryResourceUsage::toJson(qctx()->resourceUsage().toThrift(peakMemory));
+  SlowQueryLog::instance().write(record);
+}
+
+void QueryInstance::endTrace(const Status &status) {
+  if (span_.active()) {
+    span_.setAttribute("session", qctx()->rctx()->session()->id());
+    span_.setAttribute("space", qctx()->rctx()->session()->space().name);
+    if (!status.ok()) {
+      span_.setAttribute("error", status.toString());
+    }
+    span_.end();
+  }
+  // The kept plan must not hold the trace, whose spans are exported when it's released
+  qctx_->setTraceSpan(tracing::SpanRef());
+}
+
 void QueryInstance::addSlowQueryStats(uint64_t latency, const std::string &spaceName) const {
   stats::StatsManager::addValue(kQueryLatencyUs, latency);
   if (FLAGS_enable_space_level_metrics && spaceName != "") {
@@ -10,9 +10,13 @@
 
 #include "common/base/Status.h"
 #include "common/cpp/helpers.h"
+#include "common/tracing/Tracing.h"
 #include "graph/context/QueryContext.h"
 #include "graph/optimizer/Optimizer.h"
 #include "graph/scheduler/Scheduler.h"
+#include "graph/service/AdmissionController.h"
+#include "graph/service/PlanCache.h"
+#include "graph/service/ResultCache.h"
 #include "parser/GQLParser.h"
 
 /**
@@ -36,6 +40,37 @@ class QueryInstance final : public boost::noncopyable, public cpp::NonMovable {
     return qctx_.get();
   }
 
+  // Hold the slot admitted by the AdmissionController until the query is done
+  void setTicket(std::unique_ptr<AdmissionController::Ticket> ticket) {
+    ticket_ = std::move(ticket);
+  }
+
+  // Fail the query without executing it
+  void reject(Status status) {
+    onError(std::move(status));
+  }
+
+  // Put the plan into the cache with the key once the query succeeds, if it's cacheable. The plan
+  // of a templated key must start from the only constant input, which is rebound for each run.
+  void setPlanCache(PlanCache* planCache, std::string key, int64_t version, bool templated) {
+    planCache_ = planCache;
+    planKey_ = std::move(key);
+    planVersion_ = version;
+    planTemplated_ = templated;
+  }
+
+  // Put the result into the cache with the key for ttlSecs once the query succeeds, if it reads
+  // the graph only and the data has not changed since the version
+  void setResultCache(ResultCache* resultCache,
+                      std::string key,
+                      const ResultCache::Version& version,
+                      int32_t ttlSecs) {
+    resultCache_ = resultCache;
+    resultKey_ = std::move(key);
+    resultVersion_ = version;
+    resultTtl_ = ttlSecs;
+  }
+
  private:
   /**
    * If the whole execution was done, `onFinish' would be invoked.
@@ -55,13 +90,27 @@ class QueryInstance final : public boost::noncopyable, public cpp::NonMovable {
   // Return true if continue to execute
   bool explainOrContinue();
   void addSlowQueryStats(uint64_t latency, const std::string& spaceName) const;
+  // Log the slow query with the resources it used to slow_query_log_file
+  void logSlowQuery(uint64_t latency, const Status& status) const;
   void fillRespData(ExecutionResponse* resp);
   Status findBestPlan();
+  void endTrace(const Status& status);
 
   std::unique_ptr<Sentence> sentence_;
   std::unique_ptr<QueryContext> qctx_;
   std::unique_ptr<Scheduler> scheduler_;
   opt::Optimizer* optimizer_{nullptr};
+  PlanCache* planCache_{nullptr};
+  std::string planKey_;
+  int64_t planVersion_{-1};
+  bool planTemplated_{false};
+  ResultCache* resultCache_{nullptr};
+  std::string resultKey_;
+  ResultCache::Version resultVersion_;
+  int32_t resultTtl_{0};
+  // Released before the query context, which its memory tracker belongs to
+  std::unique_ptr<AdmissionController::Ticket> ticket_;
+  tracing::Span span_;
 };
 
 }  // namespace graph
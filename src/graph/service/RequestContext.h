@@ -74,6 +74,12 @@ class RequestContext final : public boost::noncopyable, public cpp::NonMovable {
     runner_ = runner;
   }
 
+  // The runner made for this request only
+  void setRunner(std::unique_ptr<folly::Executor> runner) {
+    ownedRunner_ = std::move(runner);
+    runner_ = ownedRunner_.get();
+  }
+
   const time::Duration& duration() const {
     return duration_;
   }
@@ -98,6 +104,15 @@ class RequestContext final : public boost::noncopyable, public cpp::NonMovable {
     return parameterMap_;
   }
 
+  // The statement prepared by the session if the request executes it
+  void setPrepared(std::shared_ptr<const ClientSession::PreparedStatement> prepared) {
+    prepared_ = std::move(prepared);
+  }
+
+  const ClientSession::PreparedStatement* prepared() const {
+    return prepared_.get();
+  }
+
  private:
   time::Duration duration_;
   std::string query_;
@@ -105,8 +120,10 @@ class RequestContext final : public boost::noncopyable, public cpp::NonMovable {
   folly::Promise<Response> promise_;
   std::shared_ptr<ClientSession> session_;
   folly::Executor* runner_{nullptr};
+  std::unique_ptr<folly::Executor> ownedRunner_;
   GraphSessionManager* sessionMgr_{nullptr};
   std::unordered_map<std::string, Value> parameterMap_;
+  std::shared_ptr<const ClientSession::PreparedStatement> prepared_;
 };
 
 }  // namespace graph
@@ -0,0 +1,142 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/service/ResultCache.h"
+
+#include <thrift/lib/cpp2/protocol/CompactProtocol.h>
+
+#include "common/datatypes/DataSetOps-inl.h"
+#include "common/time/WallClock.h"
+#include "graph/service/GraphFlags.h"
+#include "graph/service/PlanCache.h"
+
+namespace nebula {
+namespace graph {
+
+int32_t ResultCache::hintedTtl(const std::string& query) {
+  auto text = folly::trimWhitespace(query);
+  if (!text.startsWith("/*+")) {
+    return 0;
+  }
+  auto end = text.find("*/");
+  if (end == folly::StringPiece::npos) {
+    return 0;
+  }
+  auto hint = folly::trimWhitespace(text.subpiece(3, end - 3)).str();
+  folly::toLowerAscii(hint);
+  if (hint == "cache") {
+    return std::max(FLAGS_result_cache_ttl_secs, 0);
+  }
+  folly::StringPiece ttl(hint);
+  if (!ttl.removePrefix("cache(") || !ttl.removeSuffix(")")) {
+    return 0;
+  }
+  auto secs = folly::tryTo<int32_t>(folly::trimWhitespace(ttl));
+  return secs.hasValue() ? std::max(secs.value(), 0) : 0;
+}
+
+std::string ResultCache::key(const RequestContext<ExecutionResponse>* rctx) {
+  std::vector<Value> vids;
+  auto key = PlanCache::key(rctx, &vids);
+  for (const auto& vid : vids) {
+    key.append(folly::sformat("\n{}", vid.toString()));
+  }
+  return key;
+}
+
+ResultCache::Version ResultCache::version(GraphSpaceID space) const {
+  Version version;
+  version.space = space;
+  version.meta = metaClient_->localDataLastUpdateTime();
+  version.data = storageClient_->dataVersion(space);
+  return version;
+}
+
+bool ResultCache::get(const std::string& key, GraphSpaceID space, ExecutionResponse* resp) {
+  auto current = version(space);
+  auto now = time::WallClock::fastNowInMilliSec();
+  std::shared_ptr<const DataSet> data;
+  std::vector<Entry> dropped;
+  {
+    std::lock_guard<std::mutex> lk(lock_);
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+      return false;
+    }
+    auto iter = found->second;
+    if (!(iter->version == current) || iter->expiration <= now) {
+      drop(iter, &dropped);
+      return false;
+    }
+    lru_.splice(lru_.begin(), lru_, iter);
+    data = iter->data;
+  }
+  // Copied out of the lock
+  resp->data = std::make_unique<DataSet>(*data);
+  return true;
+}
+
+void ResultCache::put(const std::string& key,
+                      const Version& version,
+                      int32_t ttlSecs,
+                      const ExecutionResponse& resp) {
+  if (ttlSecs <= 0 || resp.errorCode != ErrorCode::SUCCEEDED || resp.data == nullptr ||
+      resp.errorMsg != nullptr) {
+    return;
+  }
+  // The result read while the data was being changed may be half stale
+  if (!(version == this->version(version.space))) {
+    return;
+  }
+  apache::thrift::CompactProtocolWriter writer;
+  auto bytes = static_cast<int64_t>(
+      key.size() + apache::thrift::Cpp2Ops<DataSet>::serializedSize(&writer, resp.data.get()));
+  auto capacity = std::max<int64_t>(FLAGS_result_cache_capacity_mb, 0) << 20;
+  if (bytes > capacity) {
+    return;
+  }
+  Entry entry;
+  entry.key = key;
+  entry.version = version;
+  entry.expiration = time::WallClock::fastNowInMilliSec() + ttlSecs * 1000L;
+  entry.bytes = bytes;
+  entry.data = std::make_shared<const DataSet>(*resp.data);
+
+  std::vector<Entry> dropped;
+  {
+    std::lock_guard<std::mutex> lk(lock_);
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+      drop(found->second, &dropped);
+    }
+    lru_.emplace_front(std::move(entry));
+    index_.emplace(key, lru_.begin());
+    bytes_ += bytes;
+    while (bytes_ > capacity) {
+      drop(std::prev(lru_.end()), &dropped);
+    }
+  }
+  // The dropped results are destroyed out of the lock
+}
+
+size_t ResultCache::size() const {
+  std::lock_guard<std::mutex> lk(lock_);
+  return lru_.size();
+}
+
+int64_t ResultCache::bytes() const {
+  std::lock_guard<std::mutex> lk(lock_);
+  return bytes_;
+}
+
+void ResultCache::drop(std::list<Entry>::iterator iter, std::vector<Entry>* dropped) {
+  index_.erase(iter->key);
+  bytes_ -= iter->bytes;
+  dropped->emplace_back(std::move(*iter));
+  lru_.erase(iter);
+}
+
+}  // namespace graph
+}  // namespace nebula
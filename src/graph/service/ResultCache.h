@@ -0,0 +1,98 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_SERVICE_RESULTCACHE_H_
+#define GRAPH_SERVICE_RESULTCACHE_H_
+
+#include <boost/core/noncopyable.hpp>
+
+#include "clients/meta/MetaClient.h"
+#include "clients/storage/StorageClient.h"
+#include "common/base/Base.h"
+#include "common/graph/Response.h"
+#include "graph/service/RequestContext.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * ResultCache keeps the results of the queries reading the graph which start with the hint comment
+ * of `+ cache', so a query run again and again, e.g. by a dashboard, is answered from the memory of
+ * graphd without running its plan.
+ *
+ * A result is keyed the same as the plan in PlanCache, along with the start vids folded out of the
+ * template. It is valid until its TTL expires, the meta data is reloaded, or any storaged responds
+ * with a write epoch of the space not seen when the query started. A storaged bumps the epoch of
+ * a space on each write committed by it and returns the epoch in all its responses, so the writes
+ * of this graphd are seen at once, while the ones of the other graphds are seen by the next
+ * response from the leader writing them, or else bounded by the TTL. The results are evicted in
+ * LRU order to keep their size under result_cache_capacity_mb.
+ */
+class ResultCache final : public boost::noncopyable {
+ public:
+  // The versions of the data of the space a result is read from
+  struct Version {
+    GraphSpaceID space{-1};
+    int64_t meta{-1};
+    int64_t data{-1};
+
+    bool operator==(const Version& rhs) const {
+      return space == rhs.space && meta == rhs.meta && data == rhs.data;
+    }
+  };
+
+  ResultCache(meta::MetaClient* metaClient, storage::StorageClient* storageClient)
+      : metaClient_(metaClient), storageClient_(storageClient) {}
+
+  // The seconds to cache the result of the query hinted by `/*+ cache */' or `/*+ cache(ttl) */',
+  // or 0 if it's not hinted
+  static int32_t hintedTtl(const std::string& query);
+
+  static std::string key(const RequestContext<ExecutionResponse>* rctx);
+
+  Version version(GraphSpaceID space) const;
+
+  // Fill the data of the response by the result cached for the key, return false if there is no
+  // valid one
+  bool get(const std::string& key, GraphSpaceID space, ExecutionResponse* resp);
+
+  // Cache the data of the succeeded response read at the version for ttlSecs, unless the data has
+  // changed since
+  void put(const std::string& key,
+           const Version& version,
+           int32_t ttlSecs,
+           const ExecutionResponse& resp);
+
+  size_t size() const;
+
+  // The estimated size of the results cached
+  int64_t bytes() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    Version version;
+    // In milliseconds
+    int64_t expiration{0};
+    int64_t bytes{0};
+    std::shared_ptr<const DataSet> data;
+  };
+
+  // Drop the entry, the caller must hold lock_
+  void drop(std::list<Entry>::iterator iter, std::vector<Entry>* dropped);
+
+  meta::MetaClient* metaClient_{nullptr};
+  storage::StorageClient* storageClient_{nullptr};
+  mutable std::mutex lock_;
+  int64_t bytes_{0};
+  // The most recently used goes first
+  std::list<Entry> lru_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_SERVICE_RESULTCACHE_H_
@@ -0,0 +1,47 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/service/SlowQueryLog.h"
+
+#include <folly/json.h>
+
+#include "common/base/Base.h"
+#include "graph/stats/GraphStats.h"
+
+DECLARE_string(log_dir);
+
+namespace nebula {
+namespace graph {
+
+SlowQueryLog& SlowQueryLog::instance() {
+  static SlowQueryLog log;
+  return log;
+}
+
+void SlowQueryLog::write(const folly::dynamic& record) {
+  if (FLAGS_slow_query_log_file.empty()) {
+    return;
+  }
+  auto line = folly::toJson(record);
+  std::lock_guard<std::mutex> guard(lock_);
+  if (!opened_) {
+    opened_ = true;
+    auto path = FLAGS_slow_query_log_file;
+    if (path.front() != '/') {
+      path = FLAGS_log_dir + "/" + path;
+    }
+    file_.open(path, std::ios::app);
+    if (!file_.is_open()) {
+      LOG(ERROR) << "Failed to open the slow query log " << path;
+    }
+  }
+  if (file_.is_open()) {
+    file_ << line << '\n';
+    file_.flush();
+  }
+}
+
+}  // namespace graph
+}  // namespace nebula
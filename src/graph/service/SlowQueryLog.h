@@ -0,0 +1,37 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_SERVICE_SLOWQUERYLOG_H_
+#define GRAPH_SERVICE_SLOWQUERYLOG_H_
+
+#include <folly/dynamic.h>
+
+#include <fstream>
+#include <mutex>
+
+namespace nebula {
+namespace graph {
+
+/**
+ * @brief The log of the slow queries in slow_query_log_file, each query is a line of JSON, so the
+ * log could be loaded by the usual log collectors
+ */
+class SlowQueryLog final {
+ public:
+  static SlowQueryLog& instance();
+
+  void write(const folly::dynamic& record);
+
+ private:
+  SlowQueryLog() = default;
+
+  std::mutex lock_;
+  std::ofstream file_;
+  bool opened_{false};
+};
+
+}  // namespace graph
+}  // namespace nebula
+#endif  // GRAPH_SERVICE_SLOWQUERYLOG_H_
@@ -0,0 +1,149 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+
+#include "graph/service/AdmissionController.h"
+#include "graph/service/GraphFlags.h"
+
+namespace nebula {
+namespace graph {
+
+using Priority = AdmissionController::Priority;
+
+// A query holding its ticket once it's admitted
+struct Query {
+  std::unique_ptr<AdmissionController::Ticket> ticket;
+  bool executed{false};
+  Status status;
+  folly::Baton<> rejected;
+};
+
+class AdmissionControllerTest : public ::testing::Test {
+ protected:
+  void admit(Query& query,
+             const std::string& space,
+             const std::string& user,
+             Priority priority = AdmissionController::kNormal) {
+    controller_.admit(
+        space,
+        user,
+        priority,
+        nullptr,
+        nullptr,
+        [&query](std::unique_ptr<AdmissionController::Ticket> ticket) {
+          query.ticket = std::move(ticket);
+          query.executed = true;
+        },
+        [&query](Status status) {
+          query.status = std::move(status);
+          query.rejected.post();
+        });
+  }
+
+  AdmissionController controller_;
+};
+
+TEST_F(AdmissionControllerTest, SpaceLimit) {
+  gflags::FlagSaver saver;
+  FLAGS_max_concurrent_queries_per_space = 1;
+  FLAGS_admission_queue_size = 10;
+
+  Query q1, q2, q3;
+  admit(q1, "A", "u1");
+  EXPECT_TRUE(q1.executed);
+  admit(q2, "A", "u1");
+  EXPECT_FALSE(q2.executed);
+  // The queries of the other spaces are not held up by the queued one
+  admit(q3, "B", "u1");
+  EXPECT_TRUE(q3.executed);
+
+  q1.ticket.reset();
+  EXPECT_TRUE(q2.executed);
+  EXPECT_FALSE(q2.rejected.ready());
+}
+
+TEST_F(AdmissionControllerTest, NoOvertaking) {
+  gflags::FlagSaver saver;
+  FLAGS_max_concurrent_queries_per_space = 2;
+  FLAGS_max_concurrent_queries_per_user = 1;
+  FLAGS_admission_queue_size = 10;
+
+  Query q1, q2, q3, q4;
+  admit(q1, "A", "u1");
+  EXPECT_TRUE(q1.executed);
+  admit(q2, "A", "u1");
+  EXPECT_FALSE(q2.executed);
+  // Fits the budget, but a query queued before it is waiting for space A
+  admit(q3, "A", "u2");
+  EXPECT_FALSE(q3.executed);
+  // Neither its space nor its user has a query queued
+  admit(q4, "B", "u3");
+  EXPECT_TRUE(q4.executed);
+
+  q1.ticket.reset();
+  EXPECT_TRUE(q2.executed);
+  EXPECT_TRUE(q3.executed);
+}
+
+TEST_F(AdmissionControllerTest, QueueFull) {
+  gflags::FlagSaver saver;
+  FLAGS_max_concurrent_queries_per_user = 1;
+  FLAGS_admission_queue_size = 1;
+
+  Query q1, q2, q3;
+  admit(q1, "A", "u1");
+  admit(q2, "A", "u1");
+  admit(q3, "A", "u1");
+  EXPECT_TRUE(q1.executed);
+  EXPECT_FALSE(q2.executed);
+  EXPECT_FALSE(q2.rejected.ready());
+  EXPECT_FALSE(q3.executed);
+  ASSERT_TRUE(q3.rejected.ready());
+  EXPECT_FALSE(q3.status.ok());
+
+  q1.ticket.reset();
+  EXPECT_TRUE(q2.executed);
+}
+
+TEST_F(AdmissionControllerTest, Priority) {
+  gflags::FlagSaver saver;
+  FLAGS_max_concurrent_queries_per_user = 1;
+  FLAGS_admission_queue_size = 10;
+
+  Query q1, low, high;
+  admit(q1, "A", "u1");
+  admit(low, "A", "u1", AdmissionController::kLow);
+  admit(high, "A", "u1", AdmissionController::kHigh);
+  EXPECT_FALSE(low.executed);
+  EXPECT_FALSE(high.executed);
+
+  q1.ticket.reset();
+  EXPECT_TRUE(high.executed);
+  EXPECT_FALSE(low.executed);
+
+  high.ticket.reset();
+  EXPECT_TRUE(low.executed);
+}
+
+TEST_F(AdmissionControllerTest, Timeout) {
+  gflags::FlagSaver saver;
+  FLAGS_max_concurrent_queries_per_user = 1;
+  FLAGS_admission_queue_size = 10;
+  FLAGS_admission_queue_timeout_ms = 200;
+  ASSERT_TRUE(controller_.init().ok());
+
+  Query q1, q2;
+  admit(q1, "A", "u1");
+  admit(q2, "A", "u1");
+  EXPECT_TRUE(q1.executed);
+  ASSERT_TRUE(q2.rejected.try_wait_for(std::chrono::seconds(10)));
+  EXPECT_FALSE(q2.executed);
+  EXPECT_FALSE(q2.status.ok());
+}
+
+}  // namespace graph
+}  // namespace nebula
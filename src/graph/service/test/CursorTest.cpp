@@ -0,0 +1,101 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/service/GraphFlags.h"
+#include "graph/session/ClientSession.h"
+
+namespace nebula {
+namespace graph {
+
+class CursorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    meta::cpp2::Session session;
+    session.session_id_ref() = 1;
+    session.user_name_ref() = "root";
+    session_ = ClientSession::create(std::move(session), nullptr);
+  }
+
+  static DataSet rows(int64_t n) {
+    DataSet ds({"id"});
+    for (int64_t i = 0; i < n; ++i) {
+      ds.emplace_back(Row({i}));
+    }
+    return ds;
+  }
+
+  std::shared_ptr<ClientSession> session_;
+};
+
+TEST_F(CursorTest, FetchInBatches) {
+  auto cursorId = session_->addCursor(rows(5));
+  ASSERT_TRUE(cursorId.ok()) << cursorId.status();
+
+  bool hasMore = false;
+  auto batch = session_->fetchCursor(cursorId.value(), 2, &hasMore);
+  ASSERT_TRUE(batch.ok()) << batch.status();
+  EXPECT_EQ(std::vector<std::string>{"id"}, batch.value().colNames);
+  EXPECT_EQ((std::vector<Row>{Row({0}), Row({1})}), batch.value().rows);
+  EXPECT_TRUE(hasMore);
+
+  batch = session_->fetchCursor(cursorId.value(), 10, &hasMore);
+  ASSERT_TRUE(batch.ok()) << batch.status();
+  EXPECT_EQ((std::vector<Row>{Row({2}), Row({3}), Row({4})}), batch.value().rows);
+  EXPECT_FALSE(hasMore);
+
+  // Released after its last batch
+  EXPECT_FALSE(session_->fetchCursor(cursorId.value(), 10, &hasMore).ok());
+}
+
+TEST_F(CursorTest, Close) {
+  auto cursorId = session_->addCursor(rows(5));
+  ASSERT_TRUE(cursorId.ok()) << cursorId.status();
+  session_->closeCursor(cursorId.value());
+  bool hasMore = false;
+  EXPECT_FALSE(session_->fetchCursor(cursorId.value(), 1, &hasMore).ok());
+}
+
+TEST_F(CursorTest, MaxCursors) {
+  gflags::FlagSaver saver;
+  FLAGS_max_cursors_per_session = 2;
+  ASSERT_TRUE(session_->addCursor(rows(2)).ok());
+  auto second = session_->addCursor(rows(2));
+  ASSERT_TRUE(second.ok());
+  EXPECT_FALSE(session_->addCursor(rows(2)).ok());
+
+  session_->closeCursor(second.value());
+  EXPECT_TRUE(session_->addCursor(rows(2)).ok());
+}
+
+TEST_F(CursorTest, Expired) {
+  gflags::FlagSaver saver;
+  FLAGS_cursor_idle_timeout_secs = 1;
+  FLAGS_max_cursors_per_session = 2;
+  auto fetched = session_->addCursor(rows(5));
+  ASSERT_TRUE(fetched.ok());
+  auto abandoned = session_->addCursor(rows(5));
+  ASSERT_TRUE(abandoned.ok());
+  EXPECT_FALSE(session_->addCursor(rows(5)).ok());
+
+  bool hasMore = false;
+  std::this_thread::sleep_for(std::chrono::milliseconds(600));
+  // A fetch keeps the cursor alive
+  ASSERT_TRUE(session_->fetchCursor(fetched.value(), 1, &hasMore).ok());
+  std::this_thread::sleep_for(std::chrono::milliseconds(600));
+  EXPECT_EQ(1, session_->reclaimExpiredCursors());
+  EXPECT_TRUE(session_->fetchCursor(fetched.value(), 1, &hasMore).ok());
+  EXPECT_FALSE(session_->fetchCursor(abandoned.value(), 1, &hasMore).ok());
+
+  // An expired cursor is not fetched, and doesn't count in the max cursors
+  std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+  EXPECT_FALSE(session_->fetchCursor(fetched.value(), 1, &hasMore).ok());
+  EXPECT_TRUE(session_->addCursor(rows(5)).ok());
+  EXPECT_TRUE(session_->addCursor(rows(5)).ok());
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -0,0 +1,53 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/service/GraphFlags.h"
+#include "graph/service/GraphService.h"
+
+namespace nebula {
+namespace graph {
+
+static std::vector<cpp2::BatchStatement> batch(size_t num) {
+  std::vector<cpp2::BatchStatement> stmts(num);
+  for (size_t i = 0; i < num; i++) {
+    stmts[i].stmt_ref() = folly::sformat("YIELD {}", i);
+  }
+  return stmts;
+}
+
+TEST(GraphServiceTest, ExecuteBatch) {
+  GraphService service;
+  // The statements fail by their own responses, the session 0 is taken as a ping
+  auto resp = service.future_executeBatch(0, batch(3)).get();
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_error_code());
+  ASSERT_EQ(3, resp.get_responses().size());
+  for (const auto& stmtResp : resp.get_responses()) {
+    EXPECT_EQ(ErrorCode::E_SESSION_INVALID, stmtResp.errorCode);
+  }
+
+  resp = service.future_executeBatch(0, {}).get();
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_error_code());
+  EXPECT_TRUE(resp.get_responses().empty());
+}
+
+TEST(GraphServiceTest, ExecuteTooLargeBatch) {
+  gflags::FlagSaver saver;
+  FLAGS_max_batch_statements = 2;
+  GraphService service;
+  // Rejected as a whole before any statement is executed
+  auto resp = service.future_executeBatch(1, batch(3)).get();
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_EXECUTION_ERROR, resp.get_error_code());
+  EXPECT_TRUE(resp.get_responses().empty());
+  ASSERT_TRUE(resp.error_msg_ref().has_value());
+
+  FLAGS_max_batch_statements = 0;
+  resp = service.future_executeBatch(0, batch(1)).get();
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_EXECUTION_ERROR, resp.get_error_code());
+}
+
+}  // namespace graph
+}  // namespace nebula
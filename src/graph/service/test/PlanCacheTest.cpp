@@ -0,0 +1,171 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <gtest/gtest.h>
+
+#include "clients/meta/MetaClient.h"
+#include "common/expression/ConstantExpression.h"
+#include "graph/service/PlanCache.h"
+#include "graph/service/RequestContext.h"
+
+using nebula::cpp2::PropertyType;
+
+namespace nebula {
+namespace graph {
+
+class PlanCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    threadPool_ = std::make_shared<folly::IOThreadPoolExecutor>(1);
+    metaClient_ = std::make_unique<meta::MetaClient>(
+        threadPool_, std::vector<HostAddr>{HostAddr("127.0.0.1", 0)});
+    cache_ = std::make_unique<PlanCache>(metaClient_.get());
+  }
+
+  // A request of the session using a space of the vid type
+  std::unique_ptr<RequestContext<ExecutionResponse>> request(const std::string& query,
+                                                             PropertyType vidType) {
+    meta::cpp2::Session session;
+    session.session_id_ref() = 1;
+    session.user_name_ref() = "root";
+    auto clientSession = ClientSession::create(std::move(session), metaClient_.get());
+    SpaceInfo space;
+    space.name = "test";
+    space.id = 1;
+    meta::cpp2::ColumnTypeDef type;
+    type.type_ref() = vidType;
+    space.spaceDesc.vid_type_ref() = std::move(type);
+    clientSession->setSpace(std::move(space));
+    auto rctx = std::make_unique<RequestContext<ExecutionResponse>>();
+    rctx->setSession(std::move(clientSession));
+    rctx->setQuery(query);
+    return rctx;
+  }
+
+  // A context whose plan is kept, with an expression made before the plan is kept
+  std::unique_ptr<QueryContext> keptContext(Expression** expr) {
+    auto qctx = std::make_unique<QueryContext>();
+    *expr = ConstantExpression::make(qctx->objPool(), 1);
+    qctx->keepPlan(nullptr);
+    return qctx;
+  }
+
+  std::shared_ptr<folly::IOThreadPoolExecutor> threadPool_;
+  std::unique_ptr<meta::MetaClient> metaClient_;
+  std::unique_ptr<PlanCache> cache_;
+};
+
+TEST_F(PlanCacheTest, Normalize) {
+  EXPECT_EQ("GO FROM \"a\" OVER e", PlanCache::normalize("  GO FROM\t\"a\"\n  OVER e  "));
+  // The quoted blanks are kept
+  EXPECT_EQ("YIELD \"a  b\", 'c\\'  d'", PlanCache::normalize("YIELD  \"a  b\",  'c\\'  d'"));
+}
+
+TEST_F(PlanCacheTest, NormalizeComments) {
+  EXPECT_EQ("GO FROM \"a\" OVER e", PlanCache::normalize("GO FROM \"a\" # \"b\"\nOVER e"));
+  EXPECT_EQ("GO FROM \"a\" OVER e", PlanCache::normalize("GO FROM \"a\" // \"b\"\nOVER e"));
+  EXPECT_EQ("GO FROM \"a\" OVER e", PlanCache::normalize("GO FROM \"a\"/* \"b\" */OVER e"));
+  EXPECT_EQ("GO FROM \"a\" OVER e", PlanCache::normalize("GO FROM \"a\" OVER e # \"b\""));
+  // The queries differing in the literals of the comments share the key
+  EXPECT_EQ(PlanCache::normalize("YIELD 1 /* 2 */"), PlanCache::normalize("YIELD 1 /* 3 */"));
+  // Not the comments in the quoted strings
+  EXPECT_EQ("YIELD \"# a\", \"/* b */\"", PlanCache::normalize("YIELD \"# a\", \"/* b */\""));
+  // The unterminated comment is kept
+  EXPECT_EQ("YIELD 1 /* 2  3", PlanCache::normalize("YIELD 1  /* 2  3"));
+  EXPECT_NE(PlanCache::normalize("YIELD 1 /* 2"), PlanCache::normalize("YIELD 1"));
+}
+
+TEST_F(PlanCacheTest, Templatize) {
+  std::string templ;
+  std::vector<Value> vids;
+  auto text = PlanCache::normalize("GO FROM \"a\", \"b\" /* \"c\" */ OVER e");
+  ASSERT_TRUE(PlanCache::templatize(text, &templ, &vids));
+  EXPECT_EQ("GO FROM ?str OVER e", templ);
+  EXPECT_EQ((std::vector<Value>{"a", "b"}), vids);
+
+  vids.clear();
+  ASSERT_TRUE(PlanCache::templatize("FETCH PROP ON t 1, 2 YIELD t.p", &templ, &vids));
+  EXPECT_EQ("FETCH PROP ON t ?int YIELD t.p", templ);
+  EXPECT_EQ((std::vector<Value>{1, 2}), vids);
+
+  // The vids of different types
+  EXPECT_FALSE(PlanCache::templatize("GO FROM \"a\", 1 OVER e", &templ, &vids));
+  // More than one sentence
+  EXPECT_FALSE(PlanCache::templatize("GO FROM \"a\" OVER e; YIELD 1", &templ, &vids));
+}
+
+TEST_F(PlanCacheTest, Key) {
+  std::vector<Value> vids;
+  auto key = PlanCache::key(
+      request("GO FROM \"a\",  \"b\" OVER e", PropertyType::FIXED_STRING).get(), &vids);
+  EXPECT_EQ("1\nroot\nGO FROM ?str OVER e", key);
+  EXPECT_EQ((std::vector<Value>{"a", "b"}), vids);
+  // The queries differing in the vids share the key
+  std::vector<Value> otherVids;
+  EXPECT_EQ(key,
+            PlanCache::key(request("GO FROM \"c\" OVER e", PropertyType::FIXED_STRING).get(),
+                           &otherVids));
+  EXPECT_EQ((std::vector<Value>{"c"}), otherVids);
+
+  vids.clear();
+  key = PlanCache::key(request("GO FROM 1, 2 OVER e", PropertyType::INT64).get(), &vids);
+  EXPECT_EQ("1\nroot\nGO FROM ?int OVER e", key);
+  EXPECT_EQ((std::vector<Value>{1, 2}), vids);
+}
+
+TEST_F(PlanCacheTest, KeyOfInvalidVids) {
+  // The vids not matching the vid type of the space are left to the validator
+  std::vector<Value> vids;
+  auto key = PlanCache::key(request("GO FROM 1 OVER e", PropertyType::FIXED_STRING).get(), &vids);
+  EXPECT_EQ("1\nroot\nGO FROM 1 OVER e", key);
+  EXPECT_TRUE(vids.empty());
+
+  key = PlanCache::key(request("FETCH PROP ON t \"a\" YIELD t.p", PropertyType::INT64).get(),
+                       &vids);
+  EXPECT_EQ("1\nroot\nFETCH PROP ON t \"a\" YIELD t.p", key);
+  EXPECT_TRUE(vids.empty());
+
+  // Nor the ones of a prepared statement
+  auto rctx = request("", PropertyType::INT64);
+  auto stmt = std::make_shared<ClientSession::PreparedStatement>();
+  stmt->query = "GO FROM  \"a\" OVER e";
+  stmt->text = "GO FROM ?str OVER e";
+  stmt->vids = {"a"};
+  rctx->setPrepared(std::move(stmt));
+  key = PlanCache::key(rctx.get(), &vids);
+  EXPECT_EQ("1\nroot\nGO FROM \"a\" OVER e", key);
+  EXPECT_TRUE(vids.empty());
+}
+
+TEST_F(PlanCacheTest, PutAndTake) {
+  Expression* expr = nullptr;
+  cache_->put("key", cache_->version(), keptContext(&expr));
+  EXPECT_EQ(1UL, cache_->size());
+  EXPECT_EQ(nullptr, cache_->take("other"));
+  auto qctx = cache_->take("key");
+  ASSERT_NE(nullptr, qctx);
+  EXPECT_EQ(0UL, cache_->size());
+
+  // Compiled with the stale meta data
+  cache_->put("key", cache_->version() + 1, std::move(qctx));
+  EXPECT_EQ(0UL, cache_->size());
+}
+
+TEST_F(PlanCacheTest, PlanGrown) {
+  Expression* expr = nullptr;
+  auto qctx = keptContext(&expr);
+  EXPECT_FALSE(qctx->planGrown());
+  // Cloned into the kept pool while running
+  for (auto i = 0; i < 2; ++i) {
+    expr->clone();
+  }
+  EXPECT_TRUE(qctx->planGrown());
+  cache_->put("key", cache_->version(), std::move(qctx));
+  EXPECT_EQ(0UL, cache_->size());
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -0,0 +1,114 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/ScopeGuard.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <gtest/gtest.h>
+
+#include "clients/meta/MetaClient.h"
+#include "graph/service/GraphFlags.h"
+#include "graph/service/PlanCache.h"
+#include "graph/service/RequestContext.h"
+#include "graph/session/ClientSession.h"
+
+namespace nebula {
+namespace graph {
+
+class PreparedStatementTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    threadPool_ = std::make_shared<folly::IOThreadPoolExecutor>(1);
+    metaClient_ = std::make_unique<meta::MetaClient>(
+        threadPool_, std::vector<HostAddr>{HostAddr("127.0.0.1", 0)});
+    meta::cpp2::Session session;
+    session.session_id_ref() = 1;
+    session.user_name_ref() = "root";
+    session_ = ClientSession::create(std::move(session), metaClient_.get());
+    SpaceInfo space;
+    space.name = "test";
+    space.id = 1;
+    meta::cpp2::ColumnTypeDef type;
+    type.type_ref() = nebula::cpp2::PropertyType::FIXED_STRING;
+    space.spaceDesc.vid_type_ref() = std::move(type);
+    session_->setSpace(std::move(space));
+  }
+
+  // Prepare the query as GraphService::future_prepare does
+  StatusOr<int64_t> prepare(const std::string& query) {
+    ClientSession::PreparedStatement stmt;
+    stmt.query = query;
+    stmt.text = PlanCache::normalize(query);
+    std::string templ;
+    if (PlanCache::templatize(stmt.text, &templ, &stmt.vids)) {
+      stmt.text = std::move(templ);
+    }
+    return session_->prepare(std::move(stmt));
+  }
+
+  std::shared_ptr<folly::IOThreadPoolExecutor> threadPool_;
+  std::unique_ptr<meta::MetaClient> metaClient_;
+  std::shared_ptr<ClientSession> session_;
+};
+
+TEST_F(PreparedStatementTest, PrepareAndDeallocate) {
+  auto first = prepare("GO FROM \"a\" OVER e");
+  ASSERT_TRUE(first.ok());
+  auto second = prepare("YIELD 1");
+  ASSERT_TRUE(second.ok());
+  EXPECT_NE(first.value(), second.value());
+
+  auto stmt = session_->preparedStatement(first.value());
+  ASSERT_NE(nullptr, stmt);
+  EXPECT_EQ("GO FROM \"a\" OVER e", stmt->query);
+  EXPECT_EQ("GO FROM ?str OVER e", stmt->text);
+  EXPECT_EQ((std::vector<Value>{"a"}), stmt->vids);
+
+  session_->deallocatePrepared(first.value());
+  EXPECT_EQ(nullptr, session_->preparedStatement(first.value()));
+  EXPECT_NE(nullptr, session_->preparedStatement(second.value()));
+  // Deallocated again, or never prepared
+  session_->deallocatePrepared(first.value());
+  EXPECT_EQ(nullptr, session_->preparedStatement(12345));
+  // The statement taken out is kept by the running query
+  EXPECT_EQ("GO FROM \"a\" OVER e", stmt->query);
+}
+
+TEST_F(PreparedStatementTest, MaxPreparedStatements) {
+  auto max = FLAGS_max_prepared_statements_per_session;
+  FLAGS_max_prepared_statements_per_session = 2;
+  SCOPE_EXIT {
+    FLAGS_max_prepared_statements_per_session = max;
+  };
+  auto first = prepare("YIELD 1");
+  ASSERT_TRUE(first.ok());
+  ASSERT_TRUE(prepare("YIELD 2").ok());
+  EXPECT_FALSE(prepare("YIELD 3").ok());
+  // Room for another one once deallocated
+  session_->deallocatePrepared(first.value());
+  EXPECT_TRUE(prepare("YIELD 3").ok());
+}
+
+TEST_F(PreparedStatementTest, PlanKey) {
+  auto id = prepare("GO  FROM \"a\", \"b\" OVER e");
+  ASSERT_TRUE(id.ok());
+  RequestContext<ExecutionResponse> prepared;
+  prepared.setSession(session_);
+  prepared.setQuery(session_->preparedStatement(id.value())->query);
+  prepared.setPrepared(session_->preparedStatement(id.value()));
+  std::vector<Value> preparedVids;
+  auto preparedKey = PlanCache::key(&prepared, &preparedVids);
+
+  // The prepared statement shares the plan with the query of the same text
+  RequestContext<ExecutionResponse> query;
+  query.setSession(session_);
+  query.setQuery("GO FROM \"c\" OVER e");
+  std::vector<Value> vids;
+  EXPECT_EQ(PlanCache::key(&query, &vids), preparedKey);
+  EXPECT_EQ((std::vector<Value>{"a", "b"}), preparedVids);
+  EXPECT_EQ((std::vector<Value>{"c"}), vids);
+}
+
+}  // namespace graph
+}  // namespace nebula
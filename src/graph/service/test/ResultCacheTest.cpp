@@ -0,0 +1,176 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/ScopeGuard.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <gtest/gtest.h>
+
+#include "clients/meta/MetaClient.h"
+#include "clients/storage/StorageClient.h"
+#include "graph/service/GraphFlags.h"
+#include "graph/service/ResultCache.h"
+
+namespace nebula {
+namespace graph {
+
+// Exposes the write epochs recorded from the responses of storaged
+class TestStorageClient : public storage::StorageClient {
+ public:
+  using StorageClient::StorageClient;
+  using StorageClient::recordWriteEpoch;
+};
+
+class ResultCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    threadPool_ = std::make_shared<folly::IOThreadPoolExecutor>(1);
+    metaClient_ = std::make_unique<meta::MetaClient>(
+        threadPool_, std::vector<HostAddr>{HostAddr("127.0.0.1", 0)});
+    storageClient_ = std::make_unique<TestStorageClient>(threadPool_, metaClient_.get());
+    cache_ = std::make_unique<ResultCache>(metaClient_.get(), storageClient_.get());
+  }
+
+  // A response of a single row with a string of the size
+  static ExecutionResponse response(const std::string& value) {
+    ExecutionResponse resp;
+    resp.errorCode = ErrorCode::SUCCEEDED;
+    resp.data = std::make_unique<DataSet>(std::vector<std::string>{"v"});
+    resp.data->emplace_back(Row({value}));
+    return resp;
+  }
+
+  bool cached(const std::string& key, const std::string& value, GraphSpaceID space = kSpace) {
+    ExecutionResponse resp;
+    if (!cache_->get(key, space, &resp)) {
+      return false;
+    }
+    EXPECT_EQ(*response(value).data, *resp.data);
+    return true;
+  }
+
+  static constexpr GraphSpaceID kSpace = 1;
+
+  std::shared_ptr<folly::IOThreadPoolExecutor> threadPool_;
+  std::unique_ptr<meta::MetaClient> metaClient_;
+  std::unique_ptr<TestStorageClient> storageClient_;
+  std::unique_ptr<ResultCache> cache_;
+};
+
+TEST_F(ResultCacheTest, HintedTtl) {
+  auto ttl = FLAGS_result_cache_ttl_secs;
+  FLAGS_result_cache_ttl_secs = 60;
+  SCOPE_EXIT {
+    FLAGS_result_cache_ttl_secs = ttl;
+  };
+  EXPECT_EQ(60, ResultCache::hintedTtl("/*+ cache */ GO FROM \"a\" OVER e"));
+  EXPECT_EQ(60, ResultCache::hintedTtl("  /*+CACHE*/ GO FROM \"a\" OVER e"));
+  EXPECT_EQ(10, ResultCache::hintedTtl("/*+ cache(10) */ GO FROM \"a\" OVER e"));
+  EXPECT_EQ(10, ResultCache::hintedTtl("/*+ Cache( 10 ) */ GO FROM \"a\" OVER e"));
+  // Not hinted
+  EXPECT_EQ(0, ResultCache::hintedTtl("GO FROM \"a\" OVER e"));
+  EXPECT_EQ(0, ResultCache::hintedTtl("GO FROM \"a\" OVER e /*+ cache */"));
+  EXPECT_EQ(0, ResultCache::hintedTtl("/* cache */ GO FROM \"a\" OVER e"));
+  EXPECT_EQ(0, ResultCache::hintedTtl("/*+ nocache */ GO FROM \"a\" OVER e"));
+  // Malformed
+  EXPECT_EQ(0, ResultCache::hintedTtl("/*+ cache GO FROM \"a\" OVER e"));
+  EXPECT_EQ(0, ResultCache::hintedTtl("/*+ cache(ten) */ GO FROM \"a\" OVER e"));
+  EXPECT_EQ(0, ResultCache::hintedTtl("/*+ cache(10 */ GO FROM \"a\" OVER e"));
+  EXPECT_EQ(0, ResultCache::hintedTtl("/*+ cache(-1) */ GO FROM \"a\" OVER e"));
+
+  FLAGS_result_cache_ttl_secs = -1;
+  EXPECT_EQ(0, ResultCache::hintedTtl("/*+ cache */ GO FROM \"a\" OVER e"));
+}
+
+TEST_F(ResultCacheTest, PutAndGet) {
+  auto version = cache_->version(kSpace);
+  cache_->put("a", version, 60, response("1"));
+  EXPECT_EQ(1, cache_->size());
+  EXPECT_TRUE(cached("a", "1"));
+  EXPECT_FALSE(cached("b", "1"));
+  // Read from another space
+  EXPECT_FALSE(cached("a", "1", kSpace + 1));
+  EXPECT_EQ(0, cache_->size());
+
+  // Replaced by the later one
+  cache_->put("a", version, 60, response("1"));
+  cache_->put("a", version, 60, response("2"));
+  EXPECT_EQ(1, cache_->size());
+  EXPECT_TRUE(cached("a", "2"));
+
+  // Nothing is cached without a ttl, or for a failed response
+  cache_->put("b", version, 0, response("1"));
+  auto failed = response("1");
+  failed.errorCode = ErrorCode::E_EXECUTION_ERROR;
+  cache_->put("c", version, 60, failed);
+  EXPECT_EQ(1, cache_->size());
+}
+
+TEST_F(ResultCacheTest, Expiration) {
+  cache_->put("a", cache_->version(kSpace), 1, response("1"));
+  EXPECT_TRUE(cached("a", "1"));
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  EXPECT_FALSE(cached("a", "1"));
+  EXPECT_EQ(0, cache_->size());
+  EXPECT_EQ(0, cache_->bytes());
+}
+
+TEST_F(ResultCacheTest, Eviction) {
+  auto capacity = FLAGS_result_cache_capacity_mb;
+  FLAGS_result_cache_capacity_mb = 1;
+  SCOPE_EXIT {
+    FLAGS_result_cache_capacity_mb = capacity;
+  };
+  auto version = cache_->version(kSpace);
+  // Each one takes a bit more than 300KB, so three of them fit
+  auto value = [](char c) { return std::string(300 << 10, c); };
+  cache_->put("a", version, 60, response(value('a')));
+  cache_->put("b", version, 60, response(value('b')));
+  cache_->put("c", version, 60, response(value('c')));
+  EXPECT_EQ(3, cache_->size());
+
+  // The least recently used one is evicted
+  EXPECT_TRUE(cached("a", value('a')));
+  cache_->put("d", version, 60, response(value('d')));
+  EXPECT_EQ(3, cache_->size());
+  EXPECT_FALSE(cached("b", value('b')));
+  EXPECT_TRUE(cached("a", value('a')));
+  EXPECT_TRUE(cached("c", value('c')));
+  EXPECT_TRUE(cached("d", value('d')));
+  EXPECT_LE(cache_->bytes(), 1 << 20);
+
+  // A result larger than the capacity is never cached
+  cache_->put("e", version, 60, response(std::string(1 << 20, 'e')));
+  EXPECT_FALSE(cached("e", ""));
+  EXPECT_EQ(3, cache_->size());
+}
+
+TEST_F(ResultCacheTest, WriteEpoch) {
+  HostAddr host1("127.0.0.1", 1), host2("127.0.0.1", 2);
+  storageClient_->recordWriteEpoch(kSpace, host1, 1);
+  storageClient_->recordWriteEpoch(kSpace, host2, 1);
+  auto version = cache_->version(kSpace);
+  cache_->put("a", version, 60, response("1"));
+  // The epochs seen before
+  storageClient_->recordWriteEpoch(kSpace, host1, 1);
+  storageClient_->recordWriteEpoch(kSpace, host2, 1);
+  EXPECT_TRUE(cached("a", "1"));
+  // Written to another space
+  storageClient_->recordWriteEpoch(kSpace + 1, host1, 2);
+  EXPECT_TRUE(cached("a", "1"));
+
+  // Written by any host of the space
+  storageClient_->recordWriteEpoch(kSpace, host2, 2);
+  EXPECT_FALSE(cached("a", "1"));
+  EXPECT_EQ(0, cache_->size());
+
+  // The result read before the write is not cached
+  cache_->put("a", version, 60, response("1"));
+  EXPECT_EQ(0, cache_->size());
+  cache_->put("a", cache_->version(kSpace), 60, response("1"));
+  EXPECT_TRUE(cached("a", "1"));
+}
+
+}  // namespace graph
+}  // namespace nebula
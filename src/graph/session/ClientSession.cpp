@@ -7,6 +7,7 @@
 #include "common/stats/StatsManager.h"
 #include "common/time/WallClock.h"
 #include "graph/context/QueryContext.h"
+#include "graph/service/GraphFlags.h"
 #include "graph/stats/GraphStats.h"
 
 namespace nebula {
@@ -15,6 +16,10 @@ namespace graph {
 ClientSession::ClientSession(meta::cpp2::Session&& session, meta::MetaClient* metaClient) {
   session_ = std::move(session);
   metaClient_ = metaClient;
+  memTracker_ =
+      std::make_shared<MemoryTracker>(folly::sformat("session {}", session_.get_session_id()),
+                                      FLAGS_session_memory_limit_mb * 1024 * 1024,
+                                      MemoryTracker::process());
 }
 
 std::shared_ptr<ClientSession> ClientSession::create(meta::cpp2::Session&& session,
@@ -26,6 +31,7 @@ void ClientSession::charge() {
   folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
   idleDuration_.reset();
   session_.update_time_ref() = time::WallClock::fastNowInMicroSec();
+  version_++;
 }
 
 uint64_t ClientSession::idleSeconds() {
@@ -33,6 +39,42 @@ uint64_t ClientSession::idleSeconds() {
   return idleDuration_.elapsedInSec();
 }
 
+meta::cpp2::Session ClientSession::getSession() const {
+  folly::RWSpinLock::ReadHolder rHolder(rwSpinLock_);
+  auto session = session_;
+  for (auto& query : *session.queries_ref()) {
+    auto context = contexts_.find(query.first);
+    if (context != contexts_.end()) {
+      const auto& memTracker = context->second->memTracker();
+      query.second.memory_in_bytes_ref() = memTracker->used();
+      query.second.resources_ref() =
+          context->second->resourceUsage().toThrift(memTracker->peak());
+    }
+  }
+  return session;
+}
+
+std::optional<meta::cpp2::Session> ClientSession::sessionToSync(uint64_t* version) const {
+  {
+    folly::RWSpinLock::ReadHolder rHolder(rwSpinLock_);
+    auto interval = static_cast<uint64_t>(FLAGS_session_running_queries_update_interval_secs);
+    bool changed = version_ != syncedVersion_;
+    bool queriesStale = !contexts_.empty() && sinceSynced_.elapsedInSec() >= interval;
+    if (!changed && !queriesStale) {
+      return std::nullopt;
+    }
+    *version = version_;
+  }
+  // The changes after the version are sent again next time
+  return getSession();
+}
+
+void ClientSession::synced(uint64_t version) {
+  folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
+  syncedVersion_ = std::max(syncedVersion_, version);
+  sinceSynced_.reset();
+}
+
 void ClientSession::addQuery(QueryContext* qctx) {
   auto epId = qctx->plan()->id();
   meta::cpp2::QueryDesc queryDesc;
@@ -45,6 +87,7 @@ void ClientSession::addQuery(QueryContext* qctx) {
   folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
   contexts_.emplace(epId, qctx);
   session_.queries_ref()->emplace(epId, std::move(queryDesc));
+  version_++;
 }
 
 void ClientSession::deleteQuery(QueryContext* qctx) {
@@ -53,6 +96,7 @@ void ClientSession::deleteQuery(QueryContext* qctx) {
   folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
   contexts_.erase(epId);
   session_.queries_ref()->erase(epId);
+  version_++;
 }
 
 bool ClientSession::findQuery(nebula::ExecutionPlanID epId) const {
@@ -70,12 +114,23 @@ bool ClientSession::findQuery(nebula::ExecutionPlanID epId) const {
 }
 
 void ClientSession::markQueryKilled(nebula::ExecutionPlanID epId) {
-  folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
+  std::function<void()> killStoragePlan;
+  {
+    folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
+    killStoragePlan = markQueryKilledLocked(epId);
+  }
+  // The rpc to the storages are not sent under the spin lock
+  if (killStoragePlan) {
+    killStoragePlan();
+  }
+}
+
+std::function<void()> ClientSession::markQueryKilledLocked(nebula::ExecutionPlanID epId) {
   auto context = contexts_.find(epId);
   if (context == contexts_.end()) {
-    return;
+    return nullptr;
   }
-  context->second->markKilled();
+  auto killStoragePlan = context->second->markKilled();
   stats::StatsManager::addValue(kNumKilledQueries);
   if (FLAGS_enable_space_level_metrics && space_.name != "") {
     stats::StatsManager::addValue(
@@ -85,24 +140,131 @@ void ClientSession::markQueryKilled(nebula::ExecutionPlanID epId) {
 
   auto query = session_.queries_ref()->find(epId);
   if (query == session_.queries_ref()->end()) {
-    return;
+    return killStoragePlan;
   }
   query->second.status_ref() = meta::cpp2::QueryStatus::KILLING;
+  version_++;
   VLOG(1) << "Mark query killed in meta, epId: " << epId;
+  return killStoragePlan;
 }
 
 void ClientSession::markAllQueryKilled() {
-  folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
-  for (auto& context : contexts_) {
-    context.second->markKilled();
-    session_.queries_ref()->clear();
+  std::vector<std::function<void()>> killStoragePlans;
+  {
+    folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
+    for (auto& context : contexts_) {
+      auto killStoragePlan = context.second->markKilled();
+      if (killStoragePlan) {
+        killStoragePlans.emplace_back(std::move(killStoragePlan));
+      }
+      session_.queries_ref()->clear();
+    }
+    version_++;
+    stats::StatsManager::addValue(kNumKilledQueries, contexts_.size());
+    if (FLAGS_enable_space_level_metrics && space_.name != "") {
+      stats::StatsManager::addValue(
+          stats::StatsManager::counterWithLabels(kNumKilledQueries, {{"space", space_.name}}),
+          contexts_.size());
+    }
   }
-  stats::StatsManager::addValue(kNumKilledQueries, contexts_.size());
-  if (FLAGS_enable_space_level_metrics && space_.name != "") {
-    stats::StatsManager::addValue(
-        stats::StatsManager::counterWithLabels(kNumKilledQueries, {{"space", space_.name}}),
-        contexts_.size());
+  for (auto& killStoragePlan : killStoragePlans) {
+    killStoragePlan();
+  }
+}
+
+StatusOr<int64_t> ClientSession::addCursor(DataSet&& result) {
+  std::lock_guard<std::mutex> guard(cursorLock_);
+  // The cursors abandoned don't count
+  reclaimExpiredCursorsLocked();
+  if (cursors_.size() >= static_cast<size_t>(FLAGS_max_cursors_per_session)) {
+    return Status::Error("Too many open cursors in session %ld, max: %d",
+                         session_.get_session_id(),
+                         FLAGS_max_cursors_per_session);
   }
+  auto cursorId = nextCursorId_++;
+  auto& cursor = cursors_[cursorId];
+  cursor.result = std::move(result);
+  return cursorId;
+}
+
+StatusOr<DataSet> ClientSession::fetchCursor(int64_t cursorId, size_t batchSize, bool* hasMore) {
+  std::lock_guard<std::mutex> guard(cursorLock_);
+  auto found = cursors_.find(cursorId);
+  if (found == cursors_.end()) {
+    return Status::Error("Cursor %ld does not exist", cursorId);
+  }
+  auto& cursor = found->second;
+  if (cursor.expired()) {
+    cursors_.erase(found);
+    return Status::Error("Cursor %ld has expired", cursorId);
+  }
+  cursor.idleDuration.reset();
+  auto& rows = cursor.result.rows;
+  auto end = std::min(rows.size(), cursor.next + batchSize);
+  DataSet ds(cursor.result.colNames);
+  ds.rows.reserve(end - cursor.next);
+  // The rows moved out release their values
+  std::move(rows.begin() + cursor.next, rows.begin() + end, std::back_inserter(ds.rows));
+  cursor.next = end;
+  *hasMore = end < rows.size();
+  if (!*hasMore) {
+    cursors_.erase(found);
+  }
+  return ds;
+}
+
+void ClientSession::closeCursor(int64_t cursorId) {
+  std::lock_guard<std::mutex> guard(cursorLock_);
+  cursors_.erase(cursorId);
+}
+
+bool ClientSession::Cursor::expired() const {
+  return idleDuration.elapsedInMSec() >
+         static_cast<uint64_t>(FLAGS_cursor_idle_timeout_secs) * 1000;
+}
+
+size_t ClientSession::reclaimExpiredCursors() {
+  std::lock_guard<std::mutex> guard(cursorLock_);
+  return reclaimExpiredCursorsLocked();
+}
+
+size_t ClientSession::reclaimExpiredCursorsLocked() {
+  size_t reclaimed = 0;
+  for (auto iter = cursors_.begin(); iter != cursors_.end();) {
+    if (iter->second.expired()) {
+      VLOG(1) << "Cursor " << iter->first << " of session " << session_.get_session_id()
+              << " has expired";
+      iter = cursors_.erase(iter);
+      reclaimed++;
+    } else {
+      ++iter;
+    }
+  }
+  return reclaimed;
+}
+
+StatusOr<int64_t> ClientSession::prepare(PreparedStatement stmt) {
+  std::lock_guard<std::mutex> guard(preparedLock_);
+  if (prepared_.size() >= static_cast<size_t>(FLAGS_max_prepared_statements_per_session)) {
+    return Status::Error("Too many prepared statements in session %ld, max: %d",
+                         session_.get_session_id(),
+                         FLAGS_max_prepared_statements_per_session);
+  }
+  auto statementId = nextStatementId_++;
+  prepared_.emplace(statementId, std::make_shared<const PreparedStatement>(std::move(stmt)));
+  return statementId;
+}
+
+std::shared_ptr<const ClientSession::PreparedStatement> ClientSession::preparedStatement(
+    int64_t statementId) const {
+  std::lock_guard<std::mutex> guard(preparedLock_);
+  auto found = prepared_.find(statementId);
+  return found == prepared_.end() ? nullptr : found->second;
+}
+
+void ClientSession::deallocatePrepared(int64_t statementId) {
+  std::lock_guard<std::mutex> guard(preparedLock_);
+  prepared_.erase(statementId);
 }
 }  // namespace graph
 }  // namespace nebula
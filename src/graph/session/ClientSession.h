@@ -6,6 +6,7 @@
 #define GRAPH_SESSION_CLIENTSESSION_H_
 
 #include "clients/meta/MetaClient.h"
+#include "common/memory/MemoryTracker.h"
 #include "common/time/Duration.h"
 #include "interface/gen-cpp2/meta_types.h"
 
@@ -50,6 +51,7 @@ class ClientSession final {
       folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
       space_ = std::move(space);
       session_.space_name_ref() = space_.name;
+      version_++;
     }
   }
 
@@ -116,6 +118,7 @@ class ClientSession final {
     {
       folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
       session_.timezone_ref() = timezone;
+      version_++;
       // TODO: if support ngql to set client's timezone,
       //  need to update the timezone config to metad when timezone executor
     }
@@ -128,17 +131,30 @@ class ClientSession final {
         return;
       }
       session_.graph_addr_ref() = hostAddr;
+      version_++;
     }
   }
 
-  meta::cpp2::Session getSession() const {
-    folly::RWSpinLock::ReadHolder rHolder(rwSpinLock_);
-    return session_;
+  // Returns a copy of the session, with the memory used by the running queries.
+  meta::cpp2::Session getSession() const;
+
+  // Returns a copy of the session to update to meta if it is changed since the last update, or
+  // the stats of its running queries are not updated for a while. Otherwise returns none.
+  // version: the version of the copy, which is acknowledged by synced() once updated.
+  std::optional<meta::cpp2::Session> sessionToSync(uint64_t* version) const;
+
+  // Marks the session of the version updated to meta.
+  void synced(uint64_t version);
+
+  // The memory tracker of all running queries of the session.
+  const std::shared_ptr<MemoryTracker>& memTracker() const {
+    return memTracker_;
   }
 
   void updateSpaceName(const std::string& spaceName) {
     folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
     session_.space_name_ref() = spaceName;
+    version_++;
   }
 
   // Binds a query to the session.
@@ -160,17 +176,73 @@ class ClientSession final {
   // Marks all queries as killed.
   void markAllQueryKilled();
 
+  /**
+   * @brief Keep the rows of a result not fetched by the client yet
+   *
+   * @param result The rows to fetch later
+   * @return StatusOr<int64_t> The id of the cursor, or error if the session has too many cursors
+   */
+  StatusOr<int64_t> addCursor(DataSet&& result);
+
+  /**
+   * @brief Take the next rows of the cursor, which is released once all its rows are taken
+   *
+   * @param cursorId
+   * @param batchSize Max number of the rows to take
+   * @param hasMore Whether there are rows left in the cursor
+   * @return StatusOr<DataSet> The rows taken, or error if the cursor doesn't exist or has expired
+   */
+  StatusOr<DataSet> fetchCursor(int64_t cursorId, size_t batchSize, bool* hasMore);
+
+  void closeCursor(int64_t cursorId);
+
+  /**
+   * @brief Release the cursors not fetched for FLAGS_cursor_idle_timeout_secs
+   *
+   * @return size_t The number of the cursors released
+   */
+  size_t reclaimExpiredCursors();
+
+  // A statement prepared by the client, which is executed by its id
+  struct PreparedStatement {
+    std::string query;
+    // The normalized text of the query or its template, as the plan cache keys it
+    std::string text;
+    // The literal start vids of the template
+    std::vector<Value> vids;
+  };
+
+  /**
+   * @brief Keep the prepared statement until it's deallocated or the session is released
+   *
+   * @return StatusOr<int64_t> The id of the statement, or error if the session has too many
+   */
+  StatusOr<int64_t> prepare(PreparedStatement stmt);
+
+  // The prepared statement, or nullptr if it doesn't exist
+  std::shared_ptr<const PreparedStatement> preparedStatement(int64_t statementId) const;
+
+  void deallocatePrepared(int64_t statementId);
+
  private:
   ClientSession() = default;
 
   ClientSession(meta::cpp2::Session&& session, meta::MetaClient* metaClient);
 
+  // Return the call killing the plan of the query in storage, see QueryContext::markKilled
+  std::function<void()> markQueryKilledLocked(nebula::ExecutionPlanID epId);
+
  private:
   SpaceInfo space_;  // The space that the session is using.
   // When the idle time exceeds FLAGS_session_idle_timeout_secs,
   // the session will expire and then be reclaimed.
   time::Duration idleDuration_;
   meta::cpp2::Session session_;            // The session object used in RPC.
+  // Bumped by the changes of session_, and the version updated to meta last time, so only the
+  // changed sessions are sent to meta
+  uint64_t version_{1};
+  uint64_t syncedVersion_{0};
+  time::Duration sinceSynced_;
   meta::MetaClient* metaClient_{nullptr};  // The client of the meta server.
   mutable folly::RWSpinLock rwSpinLock_;
 
@@ -181,6 +253,28 @@ class ClientSession final {
   // An ExecutionPlanID represents a query.
   // A QueryContext also represents a query.
   std::unordered_map<ExecutionPlanID, QueryContext*> contexts_;
+  std::shared_ptr<MemoryTracker> memTracker_;
+
+  // The rows of a result not fetched yet, the rows before next are fetched and released
+  struct Cursor {
+    DataSet result;
+    size_t next{0};
+    // Since the cursor was opened or fetched last time
+    time::Duration idleDuration;
+
+    // Not fetched for FLAGS_cursor_idle_timeout_secs
+    bool expired() const;
+  };
+
+  size_t reclaimExpiredCursorsLocked();
+
+  std::mutex cursorLock_;
+  int64_t nextCursorId_{1};
+  std::unordered_map<int64_t, Cursor> cursors_;
+
+  mutable std::mutex preparedLock_;
+  int64_t nextStatementId_{1};
+  std::unordered_map<int64_t, std::shared_ptr<const PreparedStatement>> prepared_;
 };
 
 }  // namespace graph
@@ -187,6 +187,7 @@ void GraphSessionManager::removeSession(SessionID id) {
 
 void GraphSessionManager::threadFunc() {
   reclaimExpiredSessions();
+  killQueriesFromMeta();
   updateSessionsToMeta();
   scavenger_->addDelayTask(
       FLAGS_session_reclaim_interval_secs * 1000, &GraphSessionManager::threadFunc, this);
@@ -213,6 +214,7 @@ void GraphSessionManager::reclaimExpiredSessions() {
     int32_t idleSecs = iter->second->idleSeconds();
     VLOG(2) << "SessionId: " << iter->first << ", idleSecs: " << idleSecs;
     if (idleSecs < FLAGS_session_idle_timeout_secs) {
+      iter->second->reclaimExpiredCursors();
       ++iter;
       continue;
     }
@@ -237,19 +239,30 @@ void GraphSessionManager::reclaimExpiredSessions() {
 
 void GraphSessionManager::updateSessionsToMeta() {
   std::vector<meta::cpp2::Session> sessions;
+  // The versions of the sessions sent, acknowledged once updated
+  std::vector<std::pair<std::shared_ptr<ClientSession>, uint64_t>> versions;
   {
     if (activeSessions_.empty()) {
       return;
     }
 
+    // Only the sessions changed since the last update are sent, most are idle
     for (auto& ses : activeSessions_) {
-      VLOG(3) << "Add Update session id: " << ses.second->getSession().get_session_id();
-      auto sessionCopy = ses.second->getSession();
-      for (auto& query : *sessionCopy.queries_ref()) {
+      uint64_t version = 0;
+      auto sessionCopy = ses.second->sessionToSync(&version);
+      if (!sessionCopy.has_value()) {
+        continue;
+      }
+      VLOG(3) << "Add Update session id: " << sessionCopy->get_session_id();
+      for (auto& query : *sessionCopy->queries_ref()) {
         query.second.duration_ref() =
             time::WallClock::fastNowInMicroSec() - query.second.get_start_time();
       }
-      sessions.emplace_back(std::move(sessionCopy));
+      sessions.emplace_back(std::move(sessionCopy).value());
+      versions.emplace_back(ses.second, version);
+    }
+    if (sessions.empty()) {
+      return;
     }
   }
 
@@ -282,6 +295,24 @@ void GraphSessionManager::updateSessionsToMeta() {
   auto result = metaClient_->updateSessions(sessions).thenValue(handleKilledQueries).get();
   if (!result.ok()) {
     LOG(ERROR) << "Update sessions failed: " << result;
+    return;
+  }
+  for (auto& [session, version] : versions) {
+    session->synced(version);
+  }
+}
+
+void GraphSessionManager::killQueriesFromMeta() {
+  auto killedQueries = metaClient_->takeKilledQueries();
+  for (auto& [sessionId, epIds] : killedQueries) {
+    auto session = activeSessions_.find(sessionId);
+    if (session == activeSessions_.end()) {
+      continue;
+    }
+    for (auto epId : epIds) {
+      session->second->markQueryKilled(epId);
+      VLOG(1) << "Kill query, session: " << sessionId << " plan: " << epId;
+    }
   }
 }
 
@@ -95,9 +95,12 @@ class GraphSessionManager final : public SessionManager<ClientSession> {
   // All queries within the expired session will be marked as killed.
   void reclaimExpiredSessions();
 
-  // Updates sessions into to meta server.
+  // Updates the changed sessions into to meta server.
   void updateSessionsToMeta();
 
+  // Marks the queries killed, which are pushed by meta server in the heartbeats.
+  void killQueriesFromMeta();
+
   // Updates session info locally.
   // session: ClientSession which will be updated.
   void updateSessionInfo(ClientSession* session);
@@ -13,6 +13,10 @@ DEFINE_int32(slow_query_threshold_us,
              200000,
              "Any query slower than this threshold value will be considered"
              " as a slow query");
+DEFINE_string(slow_query_log_file,
+              "slow_query.log",
+              "The slow queries are logged to it in JSON lines with the resources they used, "
+              "relative to log_dir, empty to disable");
 DEFINE_bool(enable_space_level_metrics, false, "Whether to enable space level metrircs");
 
 namespace nebula {
@@ -34,6 +38,17 @@ stats::CounterId kNumAggregateExecutors;
 stats::CounterId kNumSortExecutors;
 stats::CounterId kNumIndexScanExecutors;
 
+stats::CounterId kNumSchedulerTasks;
+stats::CounterId kNumSchedulerStolenTasks;
+stats::CounterId kSchedulerTaskWaitUs;
+stats::CounterId kNumQueuedQueries;
+stats::CounterId kNumRejectedQueries;
+stats::CounterId kAdmissionWaitLatencyUs;
+stats::CounterId kNumPlanCacheHits;
+stats::CounterId kNumPlanCacheMisses;
+stats::CounterId kNumResultCacheHits;
+stats::CounterId kNumResultCacheMisses;
+
 stats::CounterId kNumOpenedSessions;
 stats::CounterId kNumAuthFailedSessions;
 stats::CounterId kNumAuthFailedSessionsBadUserNamePassword;
@@ -66,6 +81,24 @@ void initGraphStats() {
   kNumIndexScanExecutors =
       stats::StatsManager::registerStats("num_indexscan_executors", "rate, sum");
 
+  kNumSchedulerTasks = stats::StatsManager::registerStats("num_scheduler_tasks", "rate, sum");
+  kNumSchedulerStolenTasks =
+      stats::StatsManager::registerStats("num_scheduler_stolen_tasks", "rate, sum");
+  kSchedulerTaskWaitUs = stats::StatsManager::registerHisto(
+      "scheduler_task_wait_us", 1000, 0, 2000, "avg, p75, p95, p99, p999");
+
+  kNumQueuedQueries = stats::StatsManager::registerStats("num_queued_queries", "sum");
+  kNumRejectedQueries = stats::StatsManager::registerStats("num_rejected_queries", "rate, sum");
+  kAdmissionWaitLatencyUs = stats::StatsManager::registerHisto(
+      "admission_wait_latency_us", 1000, 0, 2000, "avg, p75, p95, p99, p999");
+
+  kNumPlanCacheHits = stats::StatsManager::registerStats("num_plan_cache_hits", "rate, sum");
+  kNumPlanCacheMisses = stats::StatsManager::registerStats("num_plan_cache_misses", "rate, sum");
+
+  kNumResultCacheHits = stats::StatsManager::registerStats("num_result_cache_hits", "rate, sum");
+  kNumResultCacheMisses =
+      stats::StatsManager::registerStats("num_result_cache_misses", "rate, sum");
+
   kNumOpenedSessions = stats::StatsManager::registerStats("num_opened_sessions", "rate, sum");
   kNumAuthFailedSessions =
       stats::StatsManager::registerStats("num_auth_failed_sessions", "rate, sum");
@@ -10,6 +10,7 @@
 #include "common/stats/StatsManager.h"
 
 DECLARE_int32(slow_query_threshold_us);
+DECLARE_string(slow_query_log_file);
 DECLARE_bool(enable_space_level_metrics);
 
 namespace nebula {
@@ -35,6 +36,24 @@ extern stats::CounterId kNumAggregateExecutors;
 extern stats::CounterId kNumSortExecutors;
 extern stats::CounterId kNumIndexScanExecutors;
 
+// Task scheduler
+extern stats::CounterId kNumSchedulerTasks;
+extern stats::CounterId kNumSchedulerStolenTasks;
+extern stats::CounterId kSchedulerTaskWaitUs;
+
+// Admission control
+extern stats::CounterId kNumQueuedQueries;
+extern stats::CounterId kNumRejectedQueries;
+extern stats::CounterId kAdmissionWaitLatencyUs;
+
+// Plan cache
+extern stats::CounterId kNumPlanCacheHits;
+extern stats::CounterId kNumPlanCacheMisses;
+
+// Result cache
+extern stats::CounterId kNumResultCacheHits;
+extern stats::CounterId kNumResultCacheMisses;
+
 // Server client traffic
 // extern stats::CounterId kReceivedBytes;
 // extern stats::CounterId kSentBytes;
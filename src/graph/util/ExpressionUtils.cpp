@@ -7,6 +7,7 @@
 #include "common/base/ObjectPool.h"
 #include "common/expression/ArithmeticExpression.h"
 #include "common/expression/Expression.h"
+#include "common/expression/PathBuildExpression.h"
 #include "common/expression/PropertyExpression.h"
 #include "common/function/AggFunctionManager.h"
 #include "graph/context/QueryContext.h"
@@ -612,6 +613,71 @@ StatusOr<Expression *> ExpressionUtils::filterTransform(const Expression *filter
   return rewrittenExpr;
 }
 
+Expression *ExpressionUtils::simplifyLogicalExpr(const Expression *expr) {
+  auto matcher = [](const Expression *e) -> bool {
+    return e->kind() == Expression::Kind::kLogicalAnd || e->kind() == Expression::Kind::kLogicalOr;
+  };
+
+  std::function<Expression *(const Expression *)> rewriter =
+      [&](const Expression *e) -> Expression * {
+    auto kind = e->kind();
+    auto isAnd = kind == Expression::Kind::kLogicalAnd;
+    auto *pool = e->getObjPool();
+    std::vector<Expression *> operands;
+    // Returns false if the operand decides the result, i.e. false for AND and true for OR
+    auto addOperand = [&](Expression *operand) -> bool {
+      if (operand->kind() == Expression::Kind::kConstant) {
+        const auto &val = static_cast<const ConstantExpression *>(operand)->value();
+        if (val.isBool()) {
+          return val.getBool() == isAnd;
+        }
+      }
+      // The rand functions return different values in each evaluation
+      auto duplicated = std::any_of(operands.begin(), operands.end(), [operand](auto *o) {
+        return *o == *operand;
+      });
+      if (!duplicated || findInnerRandFunction(operand)) {
+        operands.emplace_back(operand);
+      }
+      return true;
+    };
+    for (auto *operand : static_cast<const LogicalExpression *>(e)->operands()) {
+      auto *simplified = RewriteVisitor::transform(operand->clone(), matcher, rewriter);
+      if (simplified->kind() == kind) {
+        for (auto *inner : static_cast<LogicalExpression *>(simplified)->operands()) {
+          if (!addOperand(inner)) {
+            return ConstantExpression::make(pool, !isAnd);
+          }
+        }
+      } else if (!addOperand(simplified)) {
+        return ConstantExpression::make(pool, !isAnd);
+      }
+    }
+    if (operands.empty()) {
+      return ConstantExpression::make(pool, isAnd);
+    }
+    if (operands.size() == 1) {
+      return operands.front();
+    }
+    auto *logic = isAnd ? LogicalExpression::makeAnd(pool) : LogicalExpression::makeOr(pool);
+    logic->setOperands(std::move(operands));
+    return logic;
+  };
+
+  return RewriteVisitor::transform(expr->clone(), matcher, rewriter);
+}
+
+Expression *ExpressionUtils::simplifyExpr(const Expression *expr) {
+  auto folded = foldConstantExpr(expr);
+  if (!folded.ok()) {
+    return expr->clone();
+  }
+  auto *simplified = simplifyLogicalExpr(folded.value());
+  // The simplified logical expressions may make their parents constant, e.g. !(A or true)
+  auto refolded = foldConstantExpr(simplified);
+  return refolded.ok() ? refolded.value() : simplified;
+}
+
 void ExpressionUtils::pullAnds(Expression *expr) {
   DCHECK(expr->kind() == Expression::Kind::kLogicalAnd);
   auto *logic = static_cast<LogicalExpression *>(expr);
@@ -1234,6 +1300,68 @@ bool ExpressionUtils::checkExprDepth(const Expression *expr) {
   return true;
 }
 
+// The output of PathBuild to evaluate the path function called on it
+static std::optional<PathBuildExpression::Output> pathFunctionOutput(const Expression *expr) {
+  if (expr->kind() != Expression::Kind::kFunctionCall) {
+    return std::nullopt;
+  }
+  const auto *funcExpr = static_cast<const FunctionCallExpression *>(expr);
+  if (funcExpr->args()->numArgs() != 1) {
+    return std::nullopt;
+  }
+  if (funcExpr->isFunc("length")) {
+    return PathBuildExpression::Output::kLength;
+  }
+  if (funcExpr->isFunc("startNode")) {
+    return PathBuildExpression::Output::kStartNode;
+  }
+  if (funcExpr->isFunc("endNode")) {
+    return PathBuildExpression::Output::kEndNode;
+  }
+  return std::nullopt;
+}
+
+/*static*/ bool ExpressionUtils::onlyPathEndsOrLength(const Expression *expr,
+                                                       const std::string &colName) {
+  auto isCol = [&colName](const Expression *e) {
+    return (e->kind() == Expression::Kind::kInputProperty ||
+            e->kind() == Expression::Kind::kVarProperty) &&
+           static_cast<const PropertyExpression *>(e)->prop() == colName;
+  };
+  size_t numRefs = 0;
+  for (const auto *e : collectAll(
+           expr, {Expression::Kind::kInputProperty, Expression::Kind::kVarProperty})) {
+    numRefs += isCol(e);
+  }
+  size_t numPathRefs = 0;
+  for (const auto *e : collectAll(expr, {Expression::Kind::kFunctionCall})) {
+    if (pathFunctionOutput(e).has_value() &&
+        isCol(static_cast<const FunctionCallExpression *>(e)->args()->args().front())) {
+      ++numPathRefs;
+    }
+  }
+  return numRefs == numPathRefs;
+}
+
+/*static*/ Expression *ExpressionUtils::rewritePathFunctions(const Expression *expr) {
+  auto matcher = [](const Expression *e) -> bool {
+    if (!pathFunctionOutput(e).has_value()) {
+      return false;
+    }
+    const auto *arg = static_cast<const FunctionCallExpression *>(e)->args()->args().front();
+    return arg->kind() == Expression::Kind::kPathBuild &&
+           static_cast<const PathBuildExpression *>(arg)->output() ==
+               PathBuildExpression::Output::kPath;
+  };
+  auto rewriter = [](const Expression *e) -> Expression * {
+    const auto *arg = static_cast<const FunctionCallExpression *>(e)->args()->args().front();
+    auto *newPathBuild = static_cast<PathBuildExpression *>(arg->clone());
+    newPathBuild->setOutput(pathFunctionOutput(e).value());
+    return newPathBuild;
+  };
+  return RewriteVisitor::transform(expr, std::move(matcher), std::move(rewriter));
+}
+
 /*static*/ bool ExpressionUtils::isVidPredication(const Expression *expr) {
   if (DCHECK_NOTNULL(expr)->kind() != Expression::Kind::kRelIn &&
       expr->kind() != Expression::Kind::kRelEQ) {
@@ -124,6 +124,18 @@ class ExpressionUtils {
   // 3. reduce unary expression e.g. !(A and B) => !A or !B
   static StatusOr<Expression*> filterTransform(const Expression* expr);
 
+  // Clones and simplifies the logical AND/OR expressions, the constant operands which don't change
+  // the result are removed, and so are the duplicated operands
+  // Examples:
+  // A and true and A  =>  A
+  // A or (B or true)  =>  true
+  static Expression* simplifyLogicalExpr(const Expression* expr);
+
+  // Clones and simplifies the expression evaluated per row, by folding the constants and
+  // simplifying the logical expressions. If the constants could not be folded, e.g. an overflow
+  // happens, which is reported when the expression is evaluated, the original one is cloned.
+  static Expression* simplifyExpr(const Expression* expr);
+
   // Negates the given logical expr: (A && B) -> (!A || !B)
   static LogicalExpression* reverseLogicalExpr(LogicalExpression* expr);
 
@@ -214,6 +226,14 @@ class ExpressionUtils {
   // Whether the whole expression is vertex id predication
   // e.g. id(v) == 1, id(v) IN [...]
   static bool isVidPredication(const Expression* expr);
+
+  // Whether all the references to the column in the expression are the paths given to length(),
+  // startNode() or endNode(), which could be evaluated without building the paths
+  static bool onlyPathEndsOrLength(const Expression* expr, const std::string& colName);
+
+  // Rewrite length(), startNode() and endNode() of the paths built by PathBuild into the PathBuild
+  // evaluating them directly
+  static Expression* rewritePathFunctions(const Expression* expr);
 };
 
 }  // namespace graph
@@ -6,6 +6,8 @@
 
 #include <string>
 
+#include "common/geo/GeoIndex.h"
+
 namespace nebula {
 namespace graph {
 
@@ -14,6 +16,12 @@ Status IndexUtil::validateIndexParams(const std::vector<IndexParamItem *> &param
                                       meta::cpp2::IndexParams &indexParams) {
   for (auto *param : params) {
     switch (param->getParamType()) {
+      case IndexParamItem::S2_MIN_LEVEL: {
+        auto ret = param->getS2MinLevel();
+        NG_RETURN_IF_ERROR(ret);
+        indexParams.s2_min_level_ref() = std::move(ret).value();
+        break;
+      }
       case IndexParamItem::S2_MAX_LEVEL: {
         auto ret = param->getS2MaxLevel();
         NG_RETURN_IF_ERROR(ret);
@@ -26,8 +34,18 @@ Status IndexUtil::validateIndexParams(const std::vector<IndexParamItem *> &param
         indexParams.s2_max_cells_ref() = std::move(ret2).value();
         break;
       }
+      case IndexParamItem::ASYNC_MAINTAIN: {
+        auto ret3 = param->getAsyncMaintain();
+        NG_RETURN_IF_ERROR(ret3);
+        indexParams.async_maintain_ref() = std::move(ret3).value();
+        break;
+      }
     }
   }
+  if (indexParams.s2_min_level_ref().value_or(0) >
+      indexParams.s2_max_level_ref().value_or(geo::RegionCoverParams().maxCellLevel_)) {
+    return Status::Error("'s2_min_level' should not be greater than 's2_max_level'");
+  }
 
   return Status::OK();
 }
@@ -74,9 +92,23 @@ StatusOr<DataSet> IndexUtil::toShowCreateIndex(bool isTagIndex,
   }
   createStr += ")";
 
+  if (indexItem.include_fields_ref().has_value() && !indexItem.include_fields_ref()->empty()) {
+    std::vector<std::string> includes;
+    for (auto &col : *indexItem.include_fields_ref()) {
+      includes.emplace_back("`" + col.get_name() + "`");
+    }
+    createStr += " INCLUDE (";
+    createStr += folly::join(", ", includes);
+    createStr += ")";
+  }
+
   const auto *indexParams = indexItem.get_index_params();
   std::vector<std::string> params;
   if (indexParams) {
+    if (indexParams->s2_min_level_ref().has_value()) {
+      params.emplace_back("s2_min_level = " +
+                          std::to_string(indexParams->s2_min_level_ref().value()));
+    }
     if (indexParams->s2_max_level_ref().has_value()) {
       params.emplace_back("s2_max_level = " +
                           std::to_string(indexParams->s2_max_level_ref().value()));
@@ -85,6 +117,9 @@ StatusOr<DataSet> IndexUtil::toShowCreateIndex(bool isTagIndex,
       params.emplace_back("s2_max_cells = " +
                           std::to_string(indexParams->s2_max_cells_ref().value()));
     }
+    if (indexParams->async_maintain_ref().value_or(false)) {
+      params.emplace_back("async_maintain = true");
+    }
   }
   if (!params.empty()) {
     createStr += " WITH (";
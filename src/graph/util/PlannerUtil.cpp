@@ -23,6 +23,7 @@ void PlannerUtil::buildConstantInput(QueryContext* qctx, Starts& starts, std::st
     ds.rows.emplace_back(std::move(row));
   }
   qctx->ectx()->setResult(vidsVar, ResultBuilder().value(Value(std::move(ds))).build());
+  qctx->addConstantInput(vidsVar);
   auto* pool = qctx->objPool();
   // If possible, use column numbers in preference to column names,
   starts.src = ColumnExpression::make(pool, 0);
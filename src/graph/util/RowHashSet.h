@@ -0,0 +1,73 @@
+// Copyright (c) 2022 vesoft inc. All rights reserved.
+//
+// This source code is licensed under Apache 2.0 License.
+
+#ifndef GRAPH_UTIL_ROWHASHSET_H_
+#define GRAPH_UTIL_ROWHASHSET_H_
+
+#include <folly/container/F14Set.h>
+
+#include "common/datatypes/DataSet.h"
+
+namespace nebula {
+namespace graph {
+/**
+ * A set of rows with their hashes computed ahead, e.g. by multiple jobs. The entries of
+ * <hash, row> are kept inline in an open-addressing table, and the rows are only compared when
+ * their hashes are equal. The rows are not owned, and must not be moved while in the set.
+ */
+class RowHashSet final {
+ public:
+  explicit RowHashSet(size_t capacity = 0) {
+    set_.reserve(capacity);
+  }
+
+  static size_t hash(const Row& row) {
+    return std::hash<Row>()(row);
+  }
+
+  // Return false if an equal row is in the set already
+  bool insert(const Row* row, size_t hash) {
+    return set_.emplace(Entry{hash, row}).second;
+  }
+
+  bool insert(const Row* row) {
+    return insert(row, hash(*row));
+  }
+
+  bool contains(const Row* row, size_t hash) const {
+    return set_.find(Entry{hash, row}) != set_.end();
+  }
+
+  size_t size() const {
+    return set_.size();
+  }
+
+  bool empty() const {
+    return set_.empty();
+  }
+
+ private:
+  struct Entry {
+    size_t hash;
+    const Row* row;
+  };
+
+  struct EntryHash {
+    size_t operator()(const Entry& entry) const {
+      return entry.hash;
+    }
+  };
+
+  struct EntryEqual {
+    bool operator()(const Entry& lhs, const Entry& rhs) const {
+      return lhs.hash == rhs.hash && (lhs.row == rhs.row || *lhs.row == *rhs.row);
+    }
+  };
+
+  folly::F14ValueSet<Entry, EntryHash, EntryEqual> set_;
+};
+
+}  // namespace graph
+}  // namespace nebula
+#endif  // GRAPH_UTIL_ROWHASHSET_H_
@@ -148,12 +148,18 @@ folly::dynamic toJson(const meta::cpp2::SchemaProp &prop) {
 
 folly::dynamic toJson(const meta::cpp2::IndexParams &params) {
   folly::dynamic object = folly::dynamic::object();
+  if (params.s2_min_level_ref().has_value()) {
+    object.insert("s2_min_level", *params.s2_min_level_ref());
+  }
   if (params.s2_max_level_ref().has_value()) {
     object.insert("s2_max_level", *params.s2_max_level_ref());
   }
   if (params.s2_max_cells_ref().has_value()) {
     object.insert("s2_max_cells", *params.s2_max_cells_ref());
   }
+  if (params.async_maintain_ref().has_value()) {
+    object.insert("async_maintain", *params.async_maintain_ref());
+  }
   return object;
 }
 
@@ -290,6 +296,9 @@ folly::dynamic toJson(const storage::cpp2::IndexQueryContext &iqc) {
       iqc.get_filter().empty() ? "" : Expression::decode(&tempPool, iqc.get_filter())->toString();
   obj.insert("filter", filter);
   obj.insert("columnHints", toJson(iqc.get_column_hints()));
+  if (iqc.get_skip_scan()) {
+    obj.insert("skipScan", true);
+  }
   return obj;
 }
 
@@ -0,0 +1,57 @@
+// Copyright (c) 2022 vesoft inc. All rights reserved.
+//
+// This source code is licensed under Apache 2.0 License.
+
+#ifndef GRAPH_UTIL_VIDHASH_H_
+#define GRAPH_UTIL_VIDHASH_H_
+
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
+#include <folly/hash/Hash.h>
+
+#include "common/datatypes/Value.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * Hash of the vids, which are all INT64 or all FIXED_STRING in a space. The INT and STRING
+ * values are hashed directly without the dispatch of std::hash<Value>, and the hash is mixed
+ * so that the flat tables needn't mix it again.
+ */
+struct VidHash {
+  using folly_is_avalanching = std::true_type;
+
+  size_t operator()(const Value& vid) const noexcept {
+    if (vid.isInt()) {
+      return folly::hash::twang_mix64(static_cast<uint64_t>(vid.getInt()));
+    }
+    if (vid.isStr()) {
+      return folly::hasher<std::string>()(vid.getStr());
+    }
+    return folly::hash::twang_mix64(std::hash<Value>()(vid));
+  }
+};
+
+struct VidEqual {
+  bool operator()(const Value& lhs, const Value& rhs) const {
+    if (lhs.isInt() && rhs.isInt()) {
+      return lhs.getInt() == rhs.getInt();
+    }
+    if (lhs.isStr() && rhs.isStr()) {
+      return lhs.getStr() == rhs.getStr();
+    }
+    return lhs == rhs;
+  }
+};
+
+// The flat tables keyed by vids, the values are not stable across the insertions
+using VidSet = folly::F14FastSet<Value, VidHash, VidEqual>;
+
+template <typename T>
+using VidMap = folly::F14FastMap<Value, T, VidHash, VidEqual>;
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_UTIL_VIDHASH_H_
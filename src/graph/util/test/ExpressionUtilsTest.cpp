@@ -764,5 +764,59 @@ TEST_F(ExpressionUtilsTest, expandExpression) {
     ASSERT_EQ(expected, target->toString());
   }
 }
+
+TEST_F(ExpressionUtilsTest, simplifyLogicalExpr) {
+  {
+    auto filter = parse("t1.c1 == 1 and true and t1.c1 == 1");
+    auto target = ExpressionUtils::simplifyLogicalExpr(filter);
+    ASSERT_EQ("(t1.c1==1)", target->toString());
+  }
+  {
+    auto filter = parse("t1.c1 == 1 and (t1.c2 == 2 and t1.c3 == 3)");
+    auto target = ExpressionUtils::simplifyLogicalExpr(filter);
+    ASSERT_EQ("((t1.c1==1) AND (t1.c2==2) AND (t1.c3==3))", target->toString());
+  }
+  {
+    auto filter = parse("t1.c1 == 1 or (t1.c2 == 2 or true)");
+    auto target = ExpressionUtils::simplifyLogicalExpr(filter);
+    ASSERT_EQ("true", target->toString());
+  }
+  {
+    auto filter = parse("t1.c1 == 1 and (t1.c2 == 2 or false)");
+    auto target = ExpressionUtils::simplifyLogicalExpr(filter);
+    ASSERT_EQ("((t1.c1==1) AND (t1.c2==2))", target->toString());
+  }
+  {
+    // The rand functions are evaluated for each operand
+    auto filter = parse("rand32(10) == 1 and rand32(10) == 1");
+    auto target = ExpressionUtils::simplifyLogicalExpr(filter);
+    ASSERT_EQ("((rand32(10)==1) AND (rand32(10)==1))", target->toString());
+  }
+  {
+    // The original expression is not changed
+    auto filter = parse("t1.c1 == 1 and true");
+    ExpressionUtils::simplifyLogicalExpr(filter);
+    ASSERT_EQ("((t1.c1==1) AND true)", filter->toString());
+  }
+}
+
+TEST_F(ExpressionUtilsTest, simplifyExpr) {
+  {
+    auto filter = parse("t1.c1 > 10 + 5 and t1.c2 == 2 and t1.c2 == 2");
+    auto target = ExpressionUtils::simplifyExpr(filter);
+    ASSERT_EQ("((t1.c1>15) AND (t1.c2==2))", target->toString());
+  }
+  {
+    auto filter = parse("t1.c1 == 1 and 1 > 2");
+    auto target = ExpressionUtils::simplifyExpr(filter);
+    ASSERT_EQ("false", target->toString());
+  }
+  {
+    // The overflow is reported when the expression is evaluated
+    auto filter = parse("t1.c1 == 1 and 9223372036854775807 + 1 > 0");
+    auto target = ExpressionUtils::simplifyExpr(filter);
+    ASSERT_EQ(*filter, *target);
+  }
+}
 }  // namespace graph
 }  // namespace nebula
@@ -42,6 +42,7 @@ class AdminJobValidator final : public Validator {
           case meta::cpp2::JobType::DATA_BALANCE:
           case meta::cpp2::JobType::LEADER_BALANCE:
           case meta::cpp2::JobType::ZONE_BALANCE:
+          case meta::cpp2::JobType::ALGO:
             return true;
           case meta::cpp2::JobType::UNKNOWN:
             return false;
@@ -11,6 +11,7 @@
 #include "graph/planner/plan/Admin.h"
 #include "graph/planner/plan/Query.h"
 #include "graph/service/GraphFlags.h"
+#include "graph/util/SchemaUtil.h"
 #include "parser/MaintainSentences.h"
 
 namespace nebula {
@@ -152,30 +153,57 @@ Status CreateSpaceValidator::toPlan() {
   return Status::OK();
 }
 
-// Validate sentence to create space by clone existed one. Just clone meta data, don't clone data.
+// Validate sentence to create space by clone existed one. The data is cloned only if WITH DATA.
 Status CreateSpaceAsValidator::validateImpl() {
   auto sentence = static_cast<CreateSpaceAsSentence *>(sentence_);
   oldSpaceName_ = sentence->getOldSpaceName();
   newSpaceName_ = sentence->getNewSpaceName();
+  withData_ = sentence->withData();
   return Status::OK();
 }
 
 Status CreateSpaceAsValidator::toPlan() {
-  auto *doNode = CreateSpaceAsNode::make(qctx_, nullptr, oldSpaceName_, newSpaceName_);
+  auto *doNode = CreateSpaceAsNode::make(qctx_, nullptr, oldSpaceName_, newSpaceName_, withData_);
   root_ = doNode;
   tail_ = root_;
   return Status::OK();
 }
 
-// Alter options of space: zone
+// Alter options of space: zone, or the vertices split into more parts
 Status AlterSpaceValidator::validateImpl() {
+  auto sentence = static_cast<AlterSpaceSentence *>(sentence_);
+  if (sentence->alterSpaceOp() != meta::cpp2::AlterSpaceOp::SPLIT_VERTICES) {
+    paras_ = sentence->paras();
+    return Status::OK();
+  }
+  if (sentence->numParts() < 2) {
+    return Status::SemanticError("The vertices should be split into 2 parts at least.");
+  }
+  auto spaceId = qctx_->schemaMng()->toGraphSpaceID(sentence->spaceName());
+  NG_RETURN_IF_ERROR(spaceId);
+  auto vidType = qctx_->schemaMng()->getSpaceVidType(spaceId.value());
+  NG_RETURN_IF_ERROR(vidType);
+  auto valueType = SchemaUtil::propTypeToValueType(vidType.value());
+  paras_.emplace_back(folly::to<std::string>(sentence->numParts()));
+  for (auto *vid : sentence->vids()->vidList()) {
+    auto id = SchemaUtil::toVertexID(vid, valueType);
+    NG_RETURN_IF_ERROR(id);
+    // The same as the vid routed by the storage client, an INT64 vid in its binary form
+    const auto &value = id.value();
+    if (value.isInt()) {
+      auto intId = value.getInt();
+      paras_.emplace_back(reinterpret_cast<const char *>(&intId), sizeof(intId));
+    } else {
+      paras_.emplace_back(value.getStr());
+    }
+  }
   return Status::OK();
 }
 
 Status AlterSpaceValidator::toPlan() {
   auto sentence = static_cast<AlterSpaceSentence *>(sentence_);
-  auto *doNode = AlterSpace::make(
-      qctx_, nullptr, sentence->spaceName(), sentence->alterSpaceOp(), sentence->paras());
+  auto *doNode =
+      AlterSpace::make(qctx_, nullptr, sentence->spaceName(), sentence->alterSpaceOp(), paras_);
   root_ = doNode;
   tail_ = root_;
   return Status::OK();
@@ -412,6 +440,17 @@ Status ShowMetaLeaderValidator::toPlan() {
   return Status::OK();
 }
 
+Status ShowCardinalityFeedbackValidator::validateImpl() {
+  return Status::OK();
+}
+
+Status ShowCardinalityFeedbackValidator::toPlan() {
+  auto *node = ShowCardinalityFeedback::make(qctx_, nullptr);
+  root_ = node;
+  tail_ = root_;
+  return Status::OK();
+}
+
 Status ShowPartsValidator::validateImpl() {
   return Status::OK();
 }
@@ -623,8 +662,15 @@ Status ShowQueriesValidator::validateImpl() {
   outputs_.emplace_back("Host", Value::Type::STRING);
   outputs_.emplace_back("StartTime", Value::Type::DATETIME);
   outputs_.emplace_back("DurationInUSec", Value::Type::INT);
+  outputs_.emplace_back("MemoryInBytes", Value::Type::INT);
   outputs_.emplace_back("Status", Value::Type::STRING);
   outputs_.emplace_back("Query", Value::Type::STRING);
+  outputs_.emplace_back("CpuTimeInUSec", Value::Type::INT);
+  outputs_.emplace_back("PeakMemoryInBytes", Value::Type::INT);
+  outputs_.emplace_back("StorageRpcs", Value::Type::INT);
+  outputs_.emplace_back("StorageResponseBytes", Value::Type::INT);
+  outputs_.emplace_back("RowsScanned", Value::Type::INT);
+  outputs_.emplace_back("StageDurationInUSec", Value::Type::MAP);
   return Status::OK();
 }
 
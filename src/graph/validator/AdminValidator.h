@@ -47,6 +47,7 @@ class CreateSpaceAsValidator final : public Validator {
  private:
   std::string oldSpaceName_;
   std::string newSpaceName_;
+  bool withData_{false};
 };
 
 class AlterSpaceValidator final : public Validator {
@@ -59,6 +60,9 @@ class AlterSpaceValidator final : public Validator {
   Status validateImpl() override;
 
   Status toPlan() override;
+
+ private:
+  std::vector<std::string> paras_;
 };
 
 class DescSpaceValidator final : public Validator {
@@ -240,6 +244,19 @@ class ShowMetaLeaderValidator final : public Validator {
   Status toPlan() override;
 };
 
+class ShowCardinalityFeedbackValidator final : public Validator {
+ public:
+  ShowCardinalityFeedbackValidator(Sentence* sentence, QueryContext* ctx)
+      : Validator(sentence, ctx) {
+    setNoSpaceRequired();
+  }
+
+ private:
+  Status validateImpl() override;
+
+  Status toPlan() override;
+};
+
 class ShowPartsValidator final : public Validator {
  public:
   ShowPartsValidator(Sentence* sentence, QueryContext* context) : Validator(sentence, context) {}
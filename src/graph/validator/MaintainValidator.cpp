@@ -335,7 +335,8 @@ Status CreateTagIndexValidator::toPlan() {
                                       sentence->fields(),
                                       sentence->isIfNotExist(),
                                       std::move(indexParams_),
-                                      sentence->comment());
+                                      sentence->comment(),
+                                      sentence->includeFields());
   root_ = doNode;
   tail_ = root_;
   return Status::OK();
@@ -366,7 +367,8 @@ Status CreateEdgeIndexValidator::toPlan() {
                                        sentence->fields(),
                                        sentence->isIfNotExist(),
                                        std::move(indexParams_),
-                                       sentence->comment());
+                                       sentence->comment(),
+                                       sentence->includeFields());
   root_ = doNode;
   tail_ = root_;
   return Status::OK();
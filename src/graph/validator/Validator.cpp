@@ -164,6 +164,8 @@ std::unique_ptr<Validator> Validator::makeValidator(Sentence* sentence, QueryCon
       return std::make_unique<ShowHostsValidator>(sentence, context);
     case Sentence::Kind::kShowMetaLeader:
       return std::make_unique<ShowMetaLeaderValidator>(sentence, context);
+    case Sentence::Kind::kShowCardinalityFeedback:
+      return std::make_unique<ShowCardinalityFeedbackValidator>(sentence, context);
     case Sentence::Kind::kShowParts:
       return std::make_unique<ShowPartsValidator>(sentence, context);
     case Sentence::Kind::kShowCharset:
@@ -3,6 +3,10 @@
  * This source code is licensed under Apache 2.0 License.
  */
 
+#include <queue>
+
+#include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 #include "graph/validator/MatchValidator.h"
 #include "graph/validator/test/ValidatorTestBase.h"
 
@@ -71,6 +75,124 @@ TEST_F(MatchValidatorTest, SeekByEdgeIndex) {
   }
 }
 
+TEST_F(MatchValidatorTest, ExpandIntersect) {
+  auto enabled = FLAGS_enable_match_expand_intersect;
+  FLAGS_enable_match_expand_intersect = true;
+  // The cycle is closed by intersecting the neighbors of b and a
+  {
+    std::string query = "MATCH (a:person)-[:like]->(b)-[:like]->(c)-[:like]->(a) RETURN a, b, c";
+    std::vector<PlanNode::Kind> expected = {PlanNode::Kind::kProject,
+                                            PlanNode::Kind::kProject,
+                                            PlanNode::Kind::kAppendVertices,
+                                            PlanNode::Kind::kExpandIntersect,
+                                            PlanNode::Kind::kTraverse,
+                                            PlanNode::Kind::kIndexScan,
+                                            PlanNode::Kind::kStart};
+    EXPECT_TRUE(checkResult(query, expected));
+  }
+  // Not a cycle
+  {
+    std::string query = "MATCH (a:person)-[:like]->(b)-[:like]->(c) RETURN a, b, c";
+    std::vector<PlanNode::Kind> expected = {PlanNode::Kind::kProject,
+                                            PlanNode::Kind::kProject,
+                                            PlanNode::Kind::kAppendVertices,
+                                            PlanNode::Kind::kTraverse,
+                                            PlanNode::Kind::kTraverse,
+                                            PlanNode::Kind::kIndexScan,
+                                            PlanNode::Kind::kStart};
+    EXPECT_TRUE(checkResult(query, expected));
+  }
+  FLAGS_enable_match_expand_intersect = enabled;
+}
+
+// The nodes of the plan, each once
+static std::vector<const PlanNode*> planNodes(const PlanNode* root) {
+  std::vector<const PlanNode*> nodes;
+  std::unordered_set<const PlanNode*> visited;
+  std::queue<const PlanNode*> queue;
+  queue.emplace(root);
+  while (!queue.empty()) {
+    auto* node = queue.front();
+    queue.pop();
+    if (!visited.emplace(node).second) {
+      continue;
+    }
+    nodes.emplace_back(node);
+    for (size_t i = 0; i < node->numDeps(); ++i) {
+      queue.emplace(node->dep(i));
+    }
+  }
+  return nodes;
+}
+
+// The nodes of the plan reading the vids through the filter of the join
+static std::vector<const Explore*> vidFiltered(const PlanNode* root) {
+  std::vector<const Explore*> filtered;
+  for (auto* node : planNodes(root)) {
+    auto kind = node->kind();
+    if (kind == PlanNode::Kind::kIndexScan || kind == PlanNode::Kind::kTraverse ||
+        kind == PlanNode::Kind::kAppendVertices) {
+      auto* explore = static_cast<const Explore*>(node);
+      if (!explore->vidFilterVar().empty()) {
+        filtered.emplace_back(explore);
+      }
+    }
+  }
+  return filtered;
+}
+
+TEST_F(MatchValidatorTest, JoinVidFilter) {
+  gflags::FlagSaver saver;
+  // The patterns are joined on b
+  std::string query = "MATCH (a:person)-[:like]->(b), (c:person)-[:like]->(b) RETURN a, b, c";
+  {
+    FLAGS_enable_join_vid_filter = false;
+    auto result = validate(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+    EXPECT_TRUE(vidFiltered(result.value()->plan()->root()).empty());
+  }
+  {
+    FLAGS_enable_join_vid_filter = true;
+    auto result = validate(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+    auto* root = result.value()->plan()->root();
+    const BiInnerJoin* join = nullptr;
+    for (auto* node : planNodes(root)) {
+      if (node->kind() == PlanNode::Kind::kBiInnerJoin) {
+        join = static_cast<const BiInnerJoin*>(node);
+      }
+    }
+    ASSERT_NE(nullptr, join);
+    const auto* left = join->dep(0);
+    const auto* right = join->dep(1);
+
+    // Only the traverse to b and the vertices of b of the right pattern read the vids of b of
+    // the left one, not the scan of c
+    auto filtered = vidFiltered(root);
+    ASSERT_EQ(2, filtered.size());
+    std::unordered_set<PlanNode::Kind> kinds;
+    for (auto* node : filtered) {
+      kinds.emplace(node->kind());
+      EXPECT_EQ(left->outputVar(), node->vidFilterVar());
+      EXPECT_EQ("id($-.b)", node->vidFilterKey()->toString());
+    }
+    EXPECT_EQ(1, kinds.count(PlanNode::Kind::kTraverse));
+    EXPECT_EQ(1, kinds.count(PlanNode::Kind::kAppendVertices));
+
+    // The scan the right pattern starts from waits for the left one
+    const PlanNode* scan = nullptr;
+    for (auto* node : planNodes(right)) {
+      if (node->kind() == PlanNode::Kind::kIndexScan) {
+        scan = node;
+        break;
+      }
+    }
+    ASSERT_NE(nullptr, scan);
+    ASSERT_EQ(1, scan->numDeps());
+    EXPECT_EQ(left, scan->dep(0));
+  }
+}
+
 TEST_F(MatchValidatorTest, groupby) {
   {
     std::string query =
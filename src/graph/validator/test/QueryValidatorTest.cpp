@@ -4,6 +4,7 @@
  */
 
 #include "common/base/Base.h"
+#include "graph/service/GraphFlags.h"
 #include "graph/validator/test/ValidatorTestBase.h"
 
 DECLARE_uint32(max_allowed_statements);
@@ -140,6 +141,75 @@ TEST_F(QueryValidatorTest, GoNSteps) {
   }
 }
 
+TEST_F(QueryValidatorTest, GoKHopSteps) {
+  auto enabled = FLAGS_enable_khop_get_neighbors;
+  FLAGS_enable_khop_get_neighbors = true;
+  // Whether the steps are expanded by a loop of graphd
+  auto hasLoop = [](const PlanNode* root) {
+    std::vector<const PlanNode*> nodes = {root};
+    while (!nodes.empty()) {
+      auto* node = nodes.back();
+      nodes.pop_back();
+      if (node->kind() == PK::kLoop) {
+        return true;
+      }
+      nodes.insert(nodes.end(), node->dependencies().begin(), node->dependencies().end());
+    }
+    return false;
+  };
+  // The steps but the last one are expanded inside storaged
+  {
+    std::string query = "GO 3 STEPS FROM \"1\" OVER like YIELD $^ as src";
+    std::vector<PlanNode::Kind> expected = {PK::kProject,
+                                            PK::kGetNeighbors,
+                                            PK::kDedup,
+                                            PK::kProject,
+                                            PK::kGetNeighbors,
+                                            PK::kStart};
+    EXPECT_TRUE(checkResult(query, expected));
+    auto qctx = validate(query);
+    ASSERT_TRUE(qctx.ok());
+    auto* last = qctx.value()->plan()->root()->dep();
+    ASSERT_EQ(PK::kGetNeighbors, last->kind());
+    EXPECT_EQ(1, static_cast<const GetNeighbors*>(last)->steps());
+    auto* kHop = last->dep()->dep()->dep();
+    ASSERT_EQ(PK::kGetNeighbors, kHop->kind());
+    EXPECT_EQ(2, static_cast<const GetNeighbors*>(kHop)->steps());
+  }
+  {
+    std::string query =
+        "GO 3 STEPS FROM \"1\",\"2\" OVER like WHERE like.likeness > 90 YIELD like._dst AS id";
+    std::vector<PlanNode::Kind> expected = {PK::kProject,
+                                            PK::kFilter,
+                                            PK::kGetNeighbors,
+                                            PK::kDedup,
+                                            PK::kProject,
+                                            PK::kGetNeighbors,
+                                            PK::kStart};
+    EXPECT_TRUE(checkResult(query, expected));
+  }
+  // The start vids of each step are tracked to join the input
+  {
+    auto qctx = validate("GO FROM \"1\" OVER like YIELD like._dst AS id | "
+                         "GO 3 STEPS FROM $-.id OVER like YIELD $^ as src");
+    ASSERT_TRUE(qctx.ok());
+    EXPECT_TRUE(hasLoop(qctx.value()->plan()->root()));
+  }
+  // The sample or limit of each step
+  {
+    auto qctx = validate("GO 3 STEPS FROM \"1\" OVER like YIELD $$ as dst LIMIT [1, 2, 3]");
+    ASSERT_TRUE(qctx.ok());
+    EXPECT_TRUE(hasLoop(qctx.value()->plan()->root()));
+  }
+  FLAGS_enable_khop_get_neighbors = false;
+  {
+    auto qctx = validate("GO 3 STEPS FROM \"1\" OVER like YIELD $^ as src");
+    ASSERT_TRUE(qctx.ok());
+    EXPECT_TRUE(hasLoop(qctx.value()->plan()->root()));
+  }
+  FLAGS_enable_khop_get_neighbors = enabled;
+}
+
 TEST_F(QueryValidatorTest, GoWithPipe) {
   {
     std::string query =
@@ -787,8 +787,22 @@ void DeduceTypeVisitor::visitVertexPropertyExpr(PropertyExpression *expr) {
   type_ = SchemaUtil::propTypeToValueType(field->type());
 }
 
-void DeduceTypeVisitor::visit(PathBuildExpression *) {
-  type_ = Value::Type::PATH;
+void DeduceTypeVisitor::visit(PathBuildExpression *expr) {
+  switch (expr->output()) {
+    case PathBuildExpression::Output::kPath: {
+      type_ = Value::Type::PATH;
+      break;
+    }
+    case PathBuildExpression::Output::kLength: {
+      type_ = Value::Type::INT;
+      break;
+    }
+    case PathBuildExpression::Output::kStartNode:
+    case PathBuildExpression::Output::kEndNode: {
+      type_ = Value::Type::VERTEX;
+      break;
+    }
+  }
 }
 
 void DeduceTypeVisitor::visit(MatchPathPatternExpression *) {
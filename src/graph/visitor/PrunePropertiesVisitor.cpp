@@ -43,47 +43,70 @@ void PrunePropertiesVisitor::visitCurrent(Project *node) {
   // bool used = used_;
   used_ = false;
   if (node->columns()) {
-    const auto &columns = node->columns()->columns();
-    auto &colNames = node->colNames();
-    std::vector<bool> aliasExists(colNames.size(), false);
-    for (size_t i = 0; i < columns.size(); ++i) {
-      aliasExists[i] = propsUsed_.hasAlias(colNames[i]);
+    visitColumns(node->columns(), node->colNames());
+  }
+}
+
+void PrunePropertiesVisitor::visit(FilterProjectLimit *node) {
+  visitCurrent(node);
+  status_ = depsPruneProperties(node->dependencies());
+}
+
+void PrunePropertiesVisitor::visitCurrent(FilterProjectLimit *node) {
+  used_ = false;
+  // The columns are evaluated on the input records, the same as the condition
+  if (node->columns()) {
+    visitColumns(node->columns(), node->colNames());
+    if (!status_.ok()) {
+      return;
     }
-    for (size_t i = 0; i < columns.size(); ++i) {
-      auto *col = DCHECK_NOTNULL(columns[i]);
-      auto *expr = col->expr();
-      auto &alias = colNames[i];
-      // If the alias exists, try to rename alias
-      if (aliasExists[i]) {
-        if (expr->kind() == Expression::Kind::kInputProperty) {
-          auto *inputPropExpr = static_cast<InputPropertyExpression *>(expr);
-          auto &newAlias = inputPropExpr->prop();
-          status_ = propsUsed_.update(alias, newAlias);
-          if (!status_.ok()) {
-            return;
-          }
-        } else if (expr->kind() == Expression::Kind::kVarProperty) {
-          auto *varPropExpr = static_cast<VariablePropertyExpression *>(expr);
-          auto &newAlias = varPropExpr->prop();
-          status_ = propsUsed_.update(alias, newAlias);
-          if (!status_.ok()) {
-            return;
-          }
-        } else {  // eg. "PathBuild[$-.x,$-.__VAR_0,$-.y] AS p"
-          // How to handle this case?
-          propsUsed_.colsSet.erase(alias);
-          status_ = extractPropsFromExpr(expr);
-          if (!status_.ok()) {
-            return;
-          }
+  }
+  if (node->condition() != nullptr) {
+    status_ = extractPropsFromExpr(node->condition());
+  }
+}
+
+void PrunePropertiesVisitor::visitColumns(const YieldColumns *cols,
+                                          const std::vector<std::string> &colNames) {
+  const auto &columns = cols->columns();
+  std::vector<bool> aliasExists(colNames.size(), false);
+  for (size_t i = 0; i < columns.size(); ++i) {
+    aliasExists[i] = propsUsed_.hasAlias(colNames[i]);
+  }
+  for (size_t i = 0; i < columns.size(); ++i) {
+    auto *col = DCHECK_NOTNULL(columns[i]);
+    auto *expr = col->expr();
+    auto &alias = colNames[i];
+    // If the alias exists, try to rename alias
+    if (aliasExists[i]) {
+      if (expr->kind() == Expression::Kind::kInputProperty) {
+        auto *inputPropExpr = static_cast<InputPropertyExpression *>(expr);
+        auto &newAlias = inputPropExpr->prop();
+        status_ = propsUsed_.update(alias, newAlias);
+        if (!status_.ok()) {
+          return;
+        }
+      } else if (expr->kind() == Expression::Kind::kVarProperty) {
+        auto *varPropExpr = static_cast<VariablePropertyExpression *>(expr);
+        auto &newAlias = varPropExpr->prop();
+        status_ = propsUsed_.update(alias, newAlias);
+        if (!status_.ok()) {
+          return;
         }
-      } else {
-        // Otherwise, extract properties from the column expression
+      } else {  // eg. "PathBuild[$-.x,$-.__VAR_0,$-.y] AS p"
+        // How to handle this case?
+        propsUsed_.colsSet.erase(alias);
         status_ = extractPropsFromExpr(expr);
         if (!status_.ok()) {
           return;
         }
       }
+    } else {
+      // Otherwise, extract properties from the column expression
+      status_ = extractPropsFromExpr(expr);
+      if (!status_.ok()) {
+        return;
+      }
     }
   }
 }
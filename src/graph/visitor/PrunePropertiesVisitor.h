@@ -43,6 +43,11 @@ class PrunePropertiesVisitor final : public PlanNodeVisitor {
   // \param used, whether properties in current node are used
   void visitCurrent(Project *node);
 
+  void visit(FilterProjectLimit *node) override;
+  // \param node, the current node to visit
+  // \param used, whether properties in current node are used
+  void visitCurrent(FilterProjectLimit *node);
+
   void visit(Aggregate *node) override;
   // \param node, the current node to visit
   // \param used, whether properties in current node are used
@@ -68,6 +73,9 @@ class PrunePropertiesVisitor final : public PlanNodeVisitor {
   void visitCurrent(BiJoin *node);
 
  private:
+  // Rename the used aliases to the input columns, or extract the properties from the expressions
+  void visitColumns(const YieldColumns *cols, const std::vector<std::string> &colNames);
+
   Status depsPruneProperties(std::vector<const PlanNode *> &dependencies);
   Status extractPropsFromExpr(const Expression *expr, const std::string &entityAlias = "");
 
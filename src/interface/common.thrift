@@ -252,6 +252,9 @@ struct CheckpointInfo {
     2: map<PartitionID, LogInfo> (cpp.template = "std::unordered_map") parts,
     // storage checkpoint directory name
     3: binary                path,
+    // The files relative to path which are not in the base checkpoint, only set if the checkpoint
+    // is created incrementally. The others are hard links of the files of the base one.
+    4: optional list<binary> new_files,
 }
 
 // used for drainer
@@ -289,6 +292,25 @@ enum PropertyType {
     GEOGRAPHY = 31,
 } (cpp.enum_strict)
 
+// A column of rows in the layout of an arrow array, so that the columns are wrapped as the arrow
+//   record batches without copying the values
+struct ColumnarColumn {
+    1: binary                               name,
+    2: PropertyType                         type,
+    // One bit per row, 1 if the value is not null, the least significant bit first. It's empty if
+    //   no value is null
+    3: binary                               validity,
+    // The values of BOOL are one bit per row, the INT8/16/32/64, TIMESTAMP, FLOAT and DOUBLE are
+    //   in fixed width of little endian, and the others are the concatenated bytes, e.g. of the
+    //   STRING, while DATE, TIME, DATETIME, DURATION and GEOGRAPHY are in their string form
+    4: binary                               values,
+    // The int32 offsets of the values of variable width, one more than the rows
+    5: optional binary                      offsets,
+    // The values of a column of the mixed or the composite types, e.g. the vertices and the
+    //   lists, which are kept as they are, and the type is UNKNOWN
+    6: optional list<Value>                 boxed,
+}
+
 /*
  * ErrorCode for graphd, metad, storaged,raftd
  * -1xxx for graphd
@@ -457,6 +479,7 @@ enum ErrorCode {
     E_INVALID_TASK_PARA               = -3051,  // Invalid task parameter
     E_USER_CANCEL                     = -3052,  // The user canceled the task
     E_TASK_EXECUTION_FAILED           = -3053,  // Task execution failed
+    E_RESOURCE_GROUP_OVERLOADED       = -3054,  // Too many requests in flight of the resource group
     E_PLAN_IS_KILLED                  = -3060,  // Execution plan was cleared
 
     // toss
@@ -89,6 +89,61 @@ struct ExecutionResponse {
 } (cpp.type = "nebula::ExecutionResponse", cpp.noncopyable)
 
 
+// The response of a query executed with a cursor
+struct ExecutionCursorResponse {
+    // The response of the query, with the first batch of the rows only
+    1: required ExecutionResponse resp;
+    // Set if the rest of the rows are kept by graphd to fetch by fetchNext()
+    2: optional i64               cursor_id;
+} (cpp.noncopyable)
+
+
+struct PrepareResponse {
+    1: required common.ErrorCode error_code;
+    // The id of the statement kept by the session, to execute it by executePrepared()
+    2: optional i64              statement_id;
+    3: optional binary           error_msg;
+}
+
+
+struct FetchResponse {
+    1: required common.ErrorCode error_code;
+    2: optional common.DataSet   data;
+    // Whether there are rows of the cursor left, the cursor is released once there is none
+    3: required bool             has_more;
+    4: optional binary           error_msg;
+}
+
+
+// A statement of a batch executed by executeBatch
+struct BatchStatement {
+    1: required binary stmt;
+    2: map<binary, common.Value>(cpp.template = "std::unordered_map") parameter_map;
+}
+
+// The responses of the statements of a batch, in the same order
+struct ExecutionBatchResponse {
+    // Fails only if the batch is rejected as a whole, the statements fail by their own responses
+    1: required common.ErrorCode         error_code;
+    2: required list<ExecutionResponse>  responses;
+    3: optional binary                   error_msg;
+} (cpp.noncopyable)
+
+
+// The rows of the result in columns, so that they're wrapped as an arrow record batch without
+//   decoding the values one by one
+struct ColumnarDataSet {
+    1: required i64                               num_rows;
+    2: required list<common.ColumnarColumn>       columns;
+}
+
+// The response of a query executed by executeColumnar
+struct ExecutionColumnarResponse {
+    // The response of the query, without the data
+    1: required ExecutionResponse resp;
+    2: optional ColumnarDataSet   data;
+} (cpp.noncopyable)
+
 struct AuthResponse {
     1: required common.ErrorCode   error_code;
     2: optional binary             error_msg;
@@ -119,6 +174,29 @@ service GraphService {
     // Same as execute(), but response will be a json string
     binary executeJson(1: i64 sessionId, 2: binary stmt)
     binary executeJsonWithParameter(1: i64 sessionId, 2: binary stmt, 3: map<binary, common.Value>(cpp.template = "std::unordered_map") parameterMap)
+    // Same as executeWithParameter(), but only the first batchSize rows of the result are
+    // returned, the rest are kept by graphd and fetched batch by batch by fetchNext().
+    // The default batch size of graphd is used if batchSize is not positive.
+    ExecutionCursorResponse executeWithCursor(1: i64 sessionId, 2: binary stmt, 3: map<binary, common.Value>(cpp.template = "std::unordered_map") parameterMap, 4: i32 batchSize)
+    FetchResponse fetchNext(1: i64 sessionId, 2: i64 cursorId, 3: i32 batchSize)
+    // Release the rows of the cursor not fetched yet
+    oneway void closeCursor(1: i64 sessionId, 2: i64 cursorId)
+
+    // Same as executeWithParameter(), but the rows of the result are returned in columns
+    ExecutionColumnarResponse executeColumnar(1: i64 sessionId, 2: binary stmt, 3: map<binary, common.Value>(cpp.template = "std::unordered_map") parameterMap)
+
+    // Execute the independent statements concurrently in the session, and return all their
+    // responses in one reply. The statements must not depend on each other, e.g. on the space
+    // switched by another one of the batch.
+    ExecutionBatchResponse executeBatch(1: i64 sessionId, 2: list<BatchStatement> stmts)
+
+    // Parse the statement and keep it in the session, so that it's executed by its id later
+    // without sending the text again. The plan of a statement reading the graph is kept and
+    // reused by the executions with the same parameters, space and user.
+    PrepareResponse prepare(1: i64 sessionId, 2: binary stmt)
+    ExecutionResponse executePrepared(1: i64 sessionId, 2: i64 statementId, 3: map<binary, common.Value>(cpp.template = "std::unordered_map") parameterMap)
+    // Release the prepared statement
+    oneway void deallocatePrepared(1: i64 sessionId, 2: i64 statementId)
     
     VerifyClientVersionResp verifyClientVersion(1: VerifyClientVersionReq req)
 }
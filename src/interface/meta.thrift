@@ -115,6 +115,10 @@ struct SpaceDesc {
     7: list<binary>             zone_names,
     8: optional IsolationLevel  isolation_level,
     9: optional binary          comment,
+    // The vertices split into more than one part, KEY is the vid as the key of the parts, VALUE
+    // is the number of the consecutive parts from the part of the vid. The edges of a split vertex
+    // are spread among its parts by the other ends, and its tags are copied to all of them.
+    10: optional map<binary, i32> split_vertices,
 }
 
 struct SpaceItem {
@@ -144,6 +148,10 @@ struct EdgeItem {
 struct IndexParams {
     1: optional i32     s2_max_level,
     2: optional i32     s2_max_cells,
+    // The index is written by a background applier from the operation log of each part
+    3: optional bool    async_maintain,
+    // The coarsest level of the cells covering a geography, 0 by default
+    4: optional i32     s2_min_level,
 }
 
 struct IndexItem {
@@ -154,6 +162,9 @@ struct IndexItem {
     5: list<ColumnDef>      fields,
     6: optional binary      comment,
     7: optional IndexParams index_params,
+    // The non-key columns whose values are stored in the index value, so that they are
+    // read from the index without accessing the base data
+    8: optional list<ColumnDef> include_fields,
 }
 
 enum HostStatus {
@@ -210,7 +221,9 @@ struct ExecResp {
 }
 
 enum AlterSpaceOp {
-    ADD_ZONE    = 0x01,
+    ADD_ZONE        = 0x01,
+    // paras: the number of the parts, and the vids to split into them
+    SPLIT_VERTICES  = 0x02,
 } (cpp.enum_strict)
 
 struct AlterSpaceReq {
@@ -240,6 +253,7 @@ enum JobType {
     INGEST                   = 8,
     LEADER_BALANCE           = 9,
     ZONE_BALANCE             = 10,
+    ALGO                     = 11,
     UNKNOWN                  = 99,
 } (cpp.enum_strict)
 
@@ -308,6 +322,17 @@ struct Correlativity {
     2: double             proportion,
 }
 
+struct IndexStats {
+    // The number of entries of the index
+    1: i64                                    entries,
+    // The estimated number of distinct values of the first index field
+    2: i64                                    leading_ndv,
+    // The HyperLogLog registers of the first index field, used to merge leading_ndv
+    3: binary                                 leading_sketch,
+    // The equi-depth bounds of the encoded first index field in ascending order
+    4: list<binary>                           leading_bounds,
+}
+
 struct StatsItem {
     // The number of vertices of tagName
     1: map<binary, i64>
@@ -328,6 +353,9 @@ struct StatsItem {
     6: map<common.PartitionID, list<Correlativity>>
         (cpp.template = "std::unordered_map") negative_part_correlativity,
     7: JobStatus                              status,
+    // The statistics of each tag/edge index, used by the cost based optimizer
+    8: map<common.IndexID, IndexStats>
+        (cpp.template = "std::unordered_map") index_stats,
 }
 
 // Graph space related operations.
@@ -339,6 +367,8 @@ struct CreateSpaceReq {
 struct CreateSpaceAsReq {
     1: binary        old_space_name,
     2: binary        new_space_name,
+    // Clone the data of the old space as well, by the checkpoints of its engines on each storaged
+    3: bool          with_data = false,
 }
 
 struct DropSpaceReq {
@@ -544,6 +574,17 @@ struct HBResp {
     3: ClusterID        cluster_id,
     4: i64              last_update_time_in_ms,
     5: i32              meta_version,
+    // The last update time of the meta data not belonging to any space, and of the schemas,
+    //   indexes and listeners of each space. If the former is not changed, the clients only
+    //   reload the spaces changed
+    6: optional i64     global_update_time_in_ms,
+    7: optional map<common.GraphSpaceID, i64>
+        (cpp.template = "std::unordered_map")   space_update_time_in_ms,
+    // The queries being killed on the graph, so it needn't send the sessions running queries
+    //   to learn them
+    8: optional map<common.SessionID,
+                    set<common.ExecutionPlanID> (cpp.template = "std::unordered_set")>
+        (cpp.template = "std::unordered_map") killed_queries,
 }
 
 enum HostRole {
@@ -577,6 +618,10 @@ struct HBReq {
     7: optional common.DirInfo  dir,
     // version of binary
     8: optional binary          version,
+    // the recent requests of the parts served by a storage, used to balance the leaders by load
+    9: optional map<common.GraphSpaceID, map<common.PartitionID, i64>
+        (cpp.template = "std::unordered_map")>
+        (cpp.template = "std::unordered_map") part_loads,
 }
 
 // service(agent/metad/storaged/graphd) info
@@ -615,6 +660,7 @@ struct CreateTagIndexReq {
     5: bool                 if_not_exists,
     6: optional binary      comment,
     7: optional IndexParams index_params,
+    8: optional list<binary> include_fields,
 }
 
 struct DropTagIndexReq {
@@ -652,6 +698,7 @@ struct CreateEdgeIndexReq {
     5: bool                	if_not_exists,
     6: optional binary      comment,
     7: optional IndexParams index_params,
+    8: optional list<binary> include_fields,
 }
 
 struct DropEdgeIndexReq {
@@ -900,6 +947,10 @@ struct ListZonesResp {
 enum ListenerType {
     UNKNOWN       = 0x00,
     ELASTICSEARCH = 0x01,
+    // A read replica of the space for the analytical queries
+    ANALYTICS     = 0x02,
+    // Publish the changes of the space to Kafka
+    CDC           = 0x03,
 } (cpp.enum_strict)
 
 struct AddListenerReq {
@@ -962,11 +1013,16 @@ struct BackupMeta {
     4: bool                                       full,
     5: bool                                       all_spaces,
     6: i64                                        create_time,
+    // The backup this one is based on if it's not full
+    7: optional binary                            base_backup,
 }
 
 struct CreateBackupReq {
     // null means all spaces
     1: optional list<binary>  spaces,
+    // Create an incremental backup based on the valid backup of the name, whose checkpoints are
+    // still on the storage hosts, so only the new files need to be shipped
+    2: optional binary        base_backup,
 }
 
 struct CreateBackupResp {
@@ -1046,6 +1102,20 @@ enum QueryStatus {
     KILLING         = 0x02,
 } (cpp.enum_strict)
 
+// The resources used by a query so far
+struct QueryResources {
+    // The CPU time of the executors on the threads running them
+    1: i64 cpu_time_us,
+    2: i64 peak_memory_in_bytes,
+    3: i64 storage_rpcs,
+    // The serialized size of the responses from storage
+    4: i64 storage_response_bytes,
+    // The rows got from storage
+    5: i64 rows_scanned,
+    // The wall time of the executors of each kind
+    6: map<binary, i64> stage_duration_us,
+}
+
 struct QueryDesc {
     1: common.Timestamp start_time;
     2: QueryStatus status;
@@ -1054,6 +1124,9 @@ struct QueryDesc {
     // The session might transfer between query engines, but the query do not, we must
     // record which query engine the query belongs to
     5: common.HostAddr graph_addr,
+    // The memory used by the results of the query
+    6: i64 memory_in_bytes,
+    7: optional QueryResources resources,
 }
 
 struct Session {
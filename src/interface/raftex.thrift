@@ -115,6 +115,16 @@ struct HeartbeatResponse {
     7: TermID           last_log_term;
 }
 
+// Heartbeats of all the parts sent from one host to the same peer
+struct BatchHeartbeatRequest {
+    1: list<HeartbeatRequest> requests;
+}
+
+// The responses are in the same order as the requests
+struct BatchHeartbeatResponse {
+    1: list<HeartbeatResponse> responses;
+}
+
 struct SendSnapshotResponse {
     1: common.ErrorCode error_code;
     2: TermID           current_term;
@@ -142,5 +152,6 @@ service RaftexService {
     AppendLogResponse appendLog(1: AppendLogRequest req);
     SendSnapshotResponse sendSnapshot(1: SendSnapshotRequest req);
     HeartbeatResponse heartbeat(1: HeartbeatRequest req) (thread = 'eb');
+    BatchHeartbeatResponse batchHeartbeat(1: BatchHeartbeatRequest req) (thread = 'eb');
     GetStateResponse getState(1: GetStateRequest req);
 }
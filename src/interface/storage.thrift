@@ -21,10 +21,56 @@ include "meta.thrift"
  *
  */
 
+// The span of the caller, so that the spans of the request are its children
+struct TraceContext {
+    1: i64  trace_id_high,
+    2: i64  trace_id_low,
+    3: i64  span_id,
+    4: bool sampled,
+}
+
+// A bloom filter of the vids, see BloomFilter. The string vids are added as they are, and the int
+//   vids as their 8 bytes in the keys
+struct VidFilter {
+    1: binary bits,
+    2: i32 num_hashes,
+}
+
+// The plan of a query which a request is sent for
+struct PlanID {
+    1: common.SessionID         session_id,
+    2: common.ExecutionPlanID   plan_id,
+}
+
 struct RequestCommon {
     1: optional common.SessionID session_id,
     2: optional common.ExecutionPlanID plan_id,
     3: optional bool profile_detail,
+    // If it's set, the read request could be served by a follower whose data is at most
+    // max_staleness_ms milliseconds behind the leader
+    4: optional i64 max_staleness_ms,
+    5: optional TraceContext trace_context,
+    // The time left of the query when the request is sent, the storage gives up the request once
+    // it has run for so long
+    6: optional i64 timeout_ms,
+    // The resource group of storaged to run the read request, the group of the space is used if
+    // it's not set or not found
+    7: optional binary resource_group,
+    // If it's set, only the vertices, or the edges whose dst, may be in the filter are read. It's
+    //   used by GetNeighbors, GetProp and LookupIndex, so that the rows which the join in graphd
+    //   is going to drop are discarded before they are decoded
+    8: optional VidFilter vid_filter,
+    // The newest version of the packed encoding of DataSet the client reads, the DataSets in the
+    //   response are sent in it if they could be packed, or as rows if it's not set
+    9: optional i32 data_set_version,
+    // The plans of the requests of different queries which graphd coalesces into this one,
+    //   session_id and plan_id are those of the first of them. The request is only given up once
+    //   all of them are killed
+    10: optional list<PlanID> coalesced_plans,
+    // If it's set, the tag props of GetNeighbors are sent as the encoded rows read from the
+    //   store, with the schema version in their headers, instead of the lists of the decoded
+    //   props. The props are decoded by the client when they are read
+    11: optional bool encoded_rows,
 }
 
 struct PartitionResult {
@@ -35,12 +81,28 @@ struct PartitionResult {
 }
 
 
+// Execution stats of a node of the storage plan, only returned for the profiled requests
+struct NodeProfile {
+    1: binary                           name,
+    // Rows produced by the node
+    2: i64                              rows,
+    3: i64                              exec_duration_in_us,
+    // Other stats of the node, e.g. the time spent in decoding or filtering, and the block cache
+    // hits and the bytes read by the kvstore
+    4: map<binary, i64>                 stats,
+}
+
 struct ResponseCommon {
     // Only contains the partition that returns error
     1: required list<PartitionResult>   failed_parts,
     // Query latency from storage service
     2: required i64                     latency_in_us,
     3: optional map<string,i32>         latency_detail_us,
+    // The stats of the nodes of the same name, e.g. the ones of different parts, are added up
+    4: optional list<NodeProfile>       node_profiles,
+    // The epoch of the writes of the space on the host, which is changed by each write committed,
+    // so graphd knows whether the results it caches are stale
+    5: optional i64                     write_epoch,
 }
 
 
@@ -150,14 +212,28 @@ struct TraverseSpec {
     6: optional list<EdgeProp>                  edge_props,
     // A list of expressions which are evaluated on each edge
     7: optional list<Expr>                      expressions,
-    // A list of expressions used to sort the result
+    // A list of expressions used to sort the result, which are evaluated on each edge.
+    //   Only used combined with "limit"
     8: optional list<OrderBy>                   order_by,
     // Combined with "limit", the random flag makes the result of each query different
     9: optional bool                            random,
-    // Return the top/bottom N rows for each given vertex
+    // Return the top/bottom N rows for each given vertex. If "order_by" is given, the top N
+    //   edges of all the given vertices in each part are returned instead
     10: optional i64                            limit,
     // If provided, only the rows satisfied the given expression will be returned
     11: optional binary                         filter,
+    // If true, the edges are only iterated to calculate the stat_props, and no edge
+    //   column is returned. Used to push the aggregates of the neighbors down to storage
+    12: optional bool                           stats_only,
+    // Combined with "random", the max edges returned of all the given vertices. The
+    //   edges of each vertex are sampled by "limit" first, then the budget is split
+    //   across the vertices in proportion to their degrees. The vertices with only
+    //   part of their edges returned are in GetNeighborsResponse::truncated_vertices
+    13: optional i64                            edge_budget,
+    // The properties of the destinations to be read along with the edges. The ones in the
+    //   parts led by this host are read locally and returned in
+    //   GetNeighborsResponse::dst_vertices, so they need no other GetProps
+    14: optional list<VertexProp>               dst_vertex_props,
 }
 
 
@@ -230,12 +306,80 @@ struct GetNeighborsResponse {
     //   "_expr:<alias1>:<alias2>:..."
     //
     2: optional common.DataSet vertices,
+    // The ids of the vertices of which only part of the edges are returned due to
+    //   TraverseSpec::edge_budget
+    3: optional list<common.Value> truncated_vertices,
+    // The properties of the destinations read by TraverseSpec::dst_vertex_props, in the
+    //   same layout as GetPropResponse::props
+    4: optional common.DataSet dst_vertices,
+    // The destinations looked up for dst_vertices, including the ones without any tag. The
+    //   others are not read by this host
+    5: optional list<common.Value> fetched_dsts,
+}
+
+
+// Expand the given vertices by multiple hops inside the storage. The frontier of each hop
+//   which is led by this host is expanded locally, only the neighbors of the last hop are
+//   returned. The intermediate hops follow the edges in traverse_spec without the filter,
+//   and their destinations are deduplicated, just as the steps of GO N STEPS
+struct KHopGetNeighborsRequest {
+    1: common.GraphSpaceID                      space_id,
+    // Column names for input data. The first column name must be "_vid"
+    2: list<binary>                             column_names,
+    // partId => rows
+    3: map<common.PartitionID, list<common.Row>>
+        (cpp.template = "std::unordered_map")   parts,
+    4: TraverseSpec                             traverse_spec,
+    // The number of hops to expand, should be positive
+    5: i32                                      steps = 1,
+    6: optional RequestCommon                   common,
+}
+
+
+struct KHopGetNeighborsResponse {
+    1: required ResponseCommon result,
+    // The neighbors of the last hop, in the same layout as GetNeighborsResponse::vertices
+    2: optional common.DataSet vertices,
+    // The frontier vertices in the parts not led by this host, which should be expanded by
+    //   their own leaders with the remaining hops. The number of the hops already expanded
+    //   => the vertex ids
+    3: optional map<i32, list<common.Value>>
+        (cpp.template = "std::unordered_map")   pending,
+    // Same as GetNeighborsResponse::truncated_vertices of the last hop
+    4: optional list<common.Value> truncated_vertices,
 }
 /*
  * End of GetNeighbors section
  */
 
 
+/*
+ * Start of GetDegrees section
+ */
+// Read the degrees counted when enable_degree_counters is on, without scanning the edges
+struct GetDegreesRequest {
+    1: common.GraphSpaceID                      space_id,
+    // partId => vertex ids
+    2: map<common.PartitionID, list<common.Value>>
+        (cpp.template = "std::unordered_map")   parts,
+    // The edge types to count, a negative type for the in-degree. If it is empty, the out
+    //   and in degrees of all the edge types are returned
+    3: list<common.EdgeType>                    edge_types,
+    4: optional RequestCommon                   common,
+}
+
+
+struct GetDegreesResponse {
+    1: required ResponseCommon result,
+    // The first column is "_vid", and then one column of each edge type, e.g. "_degree:+like"
+    //   and "_degree:-like"
+    2: optional common.DataSet degrees,
+}
+/*
+ * End of GetDegrees section
+ */
+
+
 //
 // Response for data modification requests
 //
@@ -306,6 +450,9 @@ struct GetPropResponse {
 struct NewTag {
     1: common.TagID         tag_id,
     2: list<common.Value>   props,
+    // The props encoded by the client in the row format version 3 of the latest schema,
+    // e.g. by a bulk loader. The props above are ignored if it is set
+    3: optional binary      encoded_props,
 }
 
 
@@ -328,6 +475,8 @@ struct EdgeKey {
 struct NewEdge {
     1: EdgeKey              key,
     2: list<common.Value>   props,
+    // The same as encoded_props of NewTag
+    3: optional binary      encoded_props,
 }
 
 
@@ -481,6 +630,21 @@ struct GetUUIDResp {
  */
 
 
+/*
+ * Start of KillPlan section
+ */
+// Sent to the storage hosts by graphd when a query is killed, so the requests of its plan still
+// running or arriving later are given up without waiting for the kill to be synced by meta
+struct KillPlanRequest {
+    1: common.GraphSpaceID      space_id,
+    2: common.SessionID         session_id,
+    3: common.ExecutionPlanID   plan_id,
+}
+/*
+ * End of KillPlan section
+ */
+
+
 /*
  * Start of Index section
  */
@@ -527,6 +691,10 @@ struct IndexQueryContext {
     //    to be empty, At least one index column must be hit.
     // When the field size of index_id IndexItem is zero, the columns_hints must be empty.
     3: list<IndexColumnHint>    column_hints,
+    // If true, the column_hints start from the second field of the index, and they are scanned
+    // for each distinct value of the first field, which is skipped from value to value. Only for
+    // the index whose first field is neither nullable nor a variable length string.
+    4: bool                     skip_scan = false,
 }
 
 
@@ -534,6 +702,9 @@ struct IndexSpec {
     // In order to union multiple indices, multiple index hints are allowed
     1: required list<IndexQueryContext>   contexts,
     2: common.SchemaID                    schema_id,
+    // If true, only the rows returned by all the contexts are returned rather than by any of
+    // them, i.e. the index scans are intersected on the vids, or the keys of the edges
+    3: bool                               intersect = false,
 }
 
 
@@ -608,6 +779,9 @@ struct ScanEdgeRequest {
     // if set to false, forbid follower read
     9: bool                                enable_read_from_follower = true,
     10: optional RequestCommon              common,
+    // If given, the whole part is scanned and the top "limit" rows sorted by the columns are
+    //   returned, the column name is in the form of "edge_name.prop_name"
+    11: optional list<OrderBy>              order_by,
 }
 
 struct ScanResponse {
@@ -621,6 +795,55 @@ struct ScanResponse {
                                             cursors;
 }
 
+// Export all the vertices or edges of the parts in columnar batches, paged by the cursors like the
+//   scans. The rows of a part are read from a snapshot kept by storaged across the pages, so that
+//   the export of a part is consistent.
+struct ExportRequest {
+    1: common.GraphSpaceID                  space_id,
+    // The parts and the cursors to continue from, all the leader parts of the space on the host
+    //   if it's empty. The parts are exported in parallel
+    2: map<common.PartitionID, ScanCursor> (cpp.template = "std::unordered_map")
+                                            parts,
+    // Export the out edges instead of the vertices
+    3: bool                                 edge = false,
+    // The tags or edge types to export, all if it's empty
+    4: list<i32>                            schema_ids,
+    // max row count of each part in this response, negative means no limit
+    5: i64                                  limit,
+    // max row count of a batch
+    6: i32                                  batch_size = 4096,
+    // Return the encoded rows in the "_row" column instead of the columns of the props, the rows
+    //   are decoded by the client with the schema of the version in the row header
+    7: bool                                 raw_rows = false,
+    // The bytes per second of the batches of this request, 0 means no limit
+    8: i64                                  max_bytes_per_second = 0,
+    // The snapshot of the export returned by the first page, a new one is taken if it's not given
+    9: optional i64                         snapshot_id,
+    10: bool                                enable_read_from_follower = true,
+    11: optional RequestCommon              common,
+}
+
+struct ExportBatch {
+    1: common.PartitionID                   part_id,
+    // The tag id of the vertices, or the edge type of the edges
+    2: i32                                  schema_id,
+    3: i64                                  num_rows,
+    // "_vid" for the vertices, "_src", "_rank" and "_dst" for the edges, then the props or "_row"
+    4: list<common.ColumnarColumn>          columns,
+}
+
+struct ExportResponse {
+    1: required ResponseCommon              result,
+    2: list<ExportBatch>                    batches,
+    // The cursors of the parts not finished yet
+    3: map<common.PartitionID, ScanCursor> (cpp.template = "std::unordered_map")
+                                            cursors,
+    4: i64                                  snapshot_id,
+    // The error of the whole export, e.g. the space is not found or the host is overloaded, the
+    //   errors of the parts are in the failed_parts of result
+    5: common.ErrorCode                     code,
+}
+
 struct TaskPara {
     1: common.GraphSpaceID                  space_id,
     2: optional list<common.PartitionID>    parts,
@@ -662,6 +885,8 @@ struct KVRemoveRequest {
 
 service GraphStorageService {
     GetNeighborsResponse getNeighbors(1: GetNeighborsRequest req)
+    KHopGetNeighborsResponse getNeighborsKHop(1: KHopGetNeighborsRequest req)
+    GetDegreesResponse getDegrees(1: GetDegreesRequest req)
 
     // Get vertex or edge properties
     GetPropResponse getProps(1: GetPropRequest req);
@@ -678,9 +903,12 @@ service GraphStorageService {
 
     ScanResponse scanVertex(1: ScanVertexRequest req)
     ScanResponse scanEdge(1: ScanEdgeRequest req)
+    ExportResponse exportData(1: ExportRequest req)
 
     GetUUIDResp getUUID(1: GetUUIDReq req);
 
+    ExecResponse killPlan(1: KillPlanRequest req);
+
     // Interfaces for edge and vertex index scan
     LookupIndexResp lookupIndex(1: LookupIndexRequest req);
 
@@ -757,6 +985,11 @@ struct GetLeaderReq {
 struct CreateCPRequest {
     1: list<common.GraphSpaceID>  space_ids,
     2: binary                     name,
+    // The checkpoint created before, the files of the new one not in it are listed in new_files
+    3: optional binary            base_name,
+    // Clone the data of the only space in space_ids as the data of this new space, by a
+    // checkpoint created in place of the new space, instead of creating a checkpoint named name
+    4: optional common.GraphSpaceID clone_to_space,
 }
 
 struct CreateCPResp {
@@ -767,6 +1000,9 @@ struct CreateCPResp {
 struct DropCPRequest {
     1: list<common.GraphSpaceID>  space_ids,
     2: binary                     name,
+    // Remove the data cloned to the only space in space_ids by CreateCPRequest.clone_to_space,
+    // which is never added, instead of dropping the checkpoint named name
+    3: optional bool              drop_clone,
 }
 
 struct DropCPResp {
@@ -910,8 +1146,23 @@ struct ChainDeleteEdgesRequest {
     4: i64                                      term,
 }
 
+// Messages exchanged between the storage hosts running the same graph algorithm job
+struct AlgoMessagesRequest {
+    1: common.GraphSpaceID                  space_id,
+    2: i32                                  job_id,
+    3: i32                                  superstep,
+    // vertex id => message, the messages sent to the same vertex are combined by the sender
+    4: map<binary, common.Value> (cpp.template = "std::unordered_map")
+                                            messages,
+    // Whether it's the last batch of the superstep from the sender
+    5: bool                                 last = false,
+    // The number of the messages sent by the sender in the superstep, set in the last batch
+    6: i64                                  sent = 0,
+}
+
 service InternalStorageService {
     ExecResponse chainAddEdges(1: ChainAddEdgesRequest req);
     UpdateResponse chainUpdateEdge(1: ChainUpdateEdgeRequest req);
     ExecResponse chainDeleteEdges(1: ChainDeleteEdgesRequest req);
+    ExecResponse algoMessages(1: AlgoMessagesRequest req);
 }
@@ -15,6 +15,7 @@
 #include "common/datatypes/HostAddr.h"
 #include "common/thrift/ThriftTypes.h"
 #include "common/time/WallClock.h"
+#include "common/tracing/Tracing.h"
 #include "common/utils/Types.h"
 #include "interface/gen-cpp2/common_types.h"
 
@@ -43,6 +44,27 @@ class KVFilter {
   virtual bool filter(GraphSpaceID spaceId,
                       const folly::StringPiece& key,
                       const folly::StringPiece& val) const = 0;
+
+  /**
+   * @brief Rewrite the value of a key during compaction, only called when the key is not removed
+   *
+   * @param spaceId
+   * @param key
+   * @param val
+   * @param newVal The new value of the key
+   * @return true The value is rewritten in newVal
+   * @return false The value is kept
+   */
+  virtual bool rewrite(GraphSpaceID spaceId,
+                       const folly::StringPiece& key,
+                       const folly::StringPiece& val,
+                       std::string* newVal) const {
+    UNUSED(spaceId);
+    UNUSED(key);
+    UNUSED(val);
+    UNUSED(newVal);
+    return false;
+  }
 };
 
 /**
@@ -260,6 +282,23 @@ using KV = std::pair<std::string, std::string>;
 using KVCallback = folly::Function<void(nebula::cpp2::ErrorCode code)>;
 using NewLeaderCallback = folly::Function<void(HostAddr nLeader)>;
 
+/**
+ * @brief Wrap the callback of an async write to end the span of the write when it's done. The
+ * callback is returned as it is if the span is not traced.
+ */
+inline KVCallback traceCallback(tracing::Span span, KVCallback cb) {
+  if (!span.active()) {
+    return cb;
+  }
+  return [span = std::move(span), cb = std::move(cb)](nebula::cpp2::ErrorCode code) mutable {
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      span.setAttribute("code", static_cast<int64_t>(code));
+    }
+    span.end();
+    cb(code);
+  };
+}
+
 /**
  * @brief folly::StringPiece to rocksdb::Slice
  */
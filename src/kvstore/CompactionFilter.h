@@ -37,18 +37,24 @@ class KVCompactionFilter final : public rocksdb::CompactionFilter {
    * @param level Levels of key in rocksdb, not used for now
    * @param key Rocksdb key
    * @param val Rocksdb val
+   * @param newVal The new value if the value is rewritten
+   * @param valChanged Whether the value is rewritten
    * @return true Key will not be removed
    * @return false Key will be removed
    */
   bool Filter(int level,
               const rocksdb::Slice& key,
               const rocksdb::Slice& val,
-              std::string*,
-              bool*) const override {
+              std::string* newVal,
+              bool* valChanged) const override {
     UNUSED(level);
-    return kvFilter_->filter(spaceId_,
-                             folly::StringPiece(key.data(), key.size()),
-                             folly::StringPiece(val.data(), val.size()));
+    folly::StringPiece k(key.data(), key.size());
+    folly::StringPiece v(val.data(), val.size());
+    if (kvFilter_->filter(spaceId_, k, v)) {
+      return true;
+    }
+    *valChanged = kvFilter_->rewrite(spaceId_, k, v, newVal);
+    return false;
   }
 
   const char* Name() const override {
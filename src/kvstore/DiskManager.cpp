@@ -5,8 +5,21 @@
 
 #include "kvstore/DiskManager.h"
 
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#include <fstream>
+
+#include "common/stats/StatsManager.h"
+#include "common/time/WallClock.h"
+#include "kvstore/stats/KVStats.h"
+
 DEFINE_int32(disk_check_interval_secs, 10, "interval to check free space of data path");
 DEFINE_uint64(minimum_reserved_bytes, 1UL << 30, "minimum reserved bytes of each data path");
+DEFINE_int32(disk_busy_util_percent,
+             80,
+             "The io utilization of a disk over which the new parts are placed on the other data "
+             "paths if possible, 0 means the io load is not considered");
 
 namespace nebula {
 namespace kvstore {
@@ -17,6 +30,7 @@ DiskManager::DiskManager(const std::vector<std::string>& dataPaths,
   try {
     // atomic is not copy-constructible
     std::vector<std::atomic_uint64_t> freeBytes(dataPaths.size() + 1);
+    std::vector<std::atomic_int32_t> ioUtil(dataPaths.size());
     Paths* paths = new Paths();
     paths_.store(paths);
     size_t index = 0;
@@ -31,10 +45,15 @@ DiskManager::DiskManager(const std::vector<std::string>& dataPaths,
       }
       auto canonical = boost::filesystem::canonical(path);
       auto info = boost::filesystem::space(canonical);
+      struct stat st;
+      devices_.emplace_back(::stat(canonical.c_str(), &st) == 0 ? st.st_dev : 0);
+      ioUtil[index] = -1;
       paths->dataPaths_.emplace_back(std::move(canonical));
       freeBytes[index++] = info.available;
     }
     freeBytes_ = std::move(freeBytes);
+    ioUtil_ = std::move(ioUtil);
+    lastIo_.resize(dataPaths.size());
   } catch (boost::filesystem::filesystem_error& e) {
     LOG(FATAL) << "DataPath invalid: " << e.what();
   }
@@ -150,6 +169,65 @@ bool DiskManager::hasEnoughSpace(GraphSpaceID spaceId, PartitionID partId) const
   return freeBytes_[partIt->second].load(std::memory_order_relaxed) >= FLAGS_minimum_reserved_bytes;
 }
 
+size_t DiskManager::pickDataPath(GraphSpaceID spaceId) const {
+  folly::rcu_reader guard;
+  Paths* paths = paths_.load(std::memory_order_acquire);
+  CHECK(!paths->dataPaths_.empty());
+  std::vector<int32_t> partsNum(paths->dataPaths_.size(), 0);
+  auto spaceIt = paths->partIndex_.find(spaceId);
+  if (spaceIt != paths->partIndex_.end()) {
+    for (const auto& partEntry : spaceIt->second) {
+      partsNum[partEntry.second]++;
+    }
+  }
+
+  auto rank = [&](size_t index) {
+    bool full = freeBytes_[index].load(std::memory_order_relaxed) < FLAGS_minimum_reserved_bytes;
+    bool busy = FLAGS_disk_busy_util_percent > 0 && ioUtil(index) >= FLAGS_disk_busy_util_percent;
+    return std::make_tuple(full, busy, partsNum[index]);
+  };
+  size_t picked = 0;
+  for (size_t i = 1; i < paths->dataPaths_.size(); i++) {
+    if (rank(i) < rank(picked)) {
+      picked = i;
+    }
+  }
+  return picked;
+}
+
+bool DiskManager::readDiskStats(dev_t dev, DiskIoStats& stats, const std::string& file) {
+  std::ifstream in(file);
+  if (!in.is_open()) {
+    return false;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    // major minor name, then reads, reads merged, sectors read, ms reading, writes, writes
+    // merged, sectors written, ms writing, ios in progress, ms doing io, ...
+    std::istringstream iss(line);
+    uint32_t devMajor = 0;
+    uint32_t devMinor = 0;
+    std::string name;
+    if (!(iss >> devMajor >> devMinor >> name) || devMajor != major(dev) ||
+        devMinor != minor(dev)) {
+      continue;
+    }
+    std::vector<uint64_t> fields;
+    uint64_t field = 0;
+    while (fields.size() < 10 && iss >> field) {
+      fields.emplace_back(field);
+    }
+    if (fields.size() < 10) {
+      return false;
+    }
+    stats.readSectors = fields[2];
+    stats.writeSectors = fields[6];
+    stats.ioTicksMs = fields[9];
+    return true;
+  }
+  return false;
+}
+
 void DiskManager::refresh() {
   // refresh the available bytes of each data path, skip the dummy path
   folly::rcu_reader guard;
@@ -164,6 +242,41 @@ void DiskManager::refresh() {
       LOG(WARNING) << "Get filesystem info of " << paths->dataPaths_[i] << " failed";
     }
   }
+  refreshIo(paths->dataPaths_);
+}
+
+void DiskManager::refreshIo(const std::vector<boost::filesystem::path>& dataPaths) {
+  static constexpr uint64_t kSectorSize = 512;
+  auto now = time::WallClock::fastNowInMilliSec();
+  auto elapsedMs = now - lastIoTimeMs_;
+  lastIoTimeMs_ = now;
+  for (size_t i = 0; i < dataPaths.size(); i++) {
+    DiskIoStats io;
+    if (!readDiskStats(devices_[i], io)) {
+      // e.g. the path is on an overlay or network file system
+      lastIo_[i].reset();
+      continue;
+    }
+    if (lastIo_[i].has_value() && elapsedMs > 0) {
+      const auto& last = lastIo_[i].value();
+      auto util = std::min<int64_t>((io.ioTicksMs - last.ioTicksMs) * 100 / elapsedMs, 100);
+      ioUtil_[i] = util;
+      if (kDiskIoUtil.valid()) {
+        std::vector<std::pair<std::string, std::string>> labels = {
+            {"data_path", dataPaths[i].string()}};
+        stats::StatsManager::addValue(stats::StatsManager::counterWithLabels(kDiskIoUtil, labels),
+                                      util);
+        stats::StatsManager::addValue(
+            stats::StatsManager::counterWithLabels(kDiskReadBytes, labels),
+            (io.readSectors - last.readSectors) * kSectorSize);
+        stats::StatsManager::addValue(
+            stats::StatsManager::counterWithLabels(kDiskWriteBytes, labels),
+            (io.writeSectors - last.writeSectors) * kSectorSize);
+      }
+      VLOG(2) << "Io utilization of " << dataPaths[i] << " is " << util << "%";
+    }
+    lastIo_[i] = io;
+  }
 }
 
 }  // namespace kvstore
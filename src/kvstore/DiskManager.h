@@ -7,6 +7,7 @@
 #define KVSTORE_DISKMANAGER_H_
 
 #include <gtest/gtest_prod.h>
+#include <sys/types.h>
 
 #include <boost/filesystem.hpp>
 #include <boost/system/error_code.hpp>
@@ -26,11 +27,12 @@ using SpaceDiskPartsMap =
     std::unordered_map<GraphSpaceID, std::unordered_map<std::string, meta::cpp2::PartitionList>>;
 
 /**
- * @brief Monitor remaining spaces of each disk
+ * @brief Monitor remaining spaces and io load of each disk
  */
 class DiskManager {
   FRIEND_TEST(DiskManagerTest, AvailableTest);
   FRIEND_TEST(DiskManagerTest, WalNoSpaceTest);
+  FRIEND_TEST(DiskManagerTest, DiskStatsTest);
 
  public:
   /**
@@ -102,12 +104,56 @@ class DiskManager {
    */
   void getDiskParts(SpaceDiskPartsMap& diskParts) const;
 
+  /**
+   * @brief Pick the data path to place a new part of the space. The paths with enough space come
+   * first, then the ones not busy, i.e. whose io utilization is under disk_busy_util_percent, then
+   * the ones with less parts of the space.
+   *
+   * @param spaceId
+   * @return size_t Index of the path in `data_path`
+   */
+  size_t pickDataPath(GraphSpaceID spaceId) const;
+
+  /**
+   * @brief Return the io utilization in percent of the disk of a data path, sampled from
+   * /proc/diskstats every disk_check_interval_secs
+   *
+   * @param index Index of the path in `data_path`
+   * @return int32_t -1 if it's unknown
+   */
+  int32_t ioUtil(size_t index) const {
+    return ioUtil_[index].load(std::memory_order_relaxed);
+  }
+
  private:
+  // The accumulated io of a disk
+  struct DiskIoStats {
+    uint64_t readSectors{0};
+    uint64_t writeSectors{0};
+    // time spent doing io
+    uint64_t ioTicksMs{0};
+  };
+
   /**
-   * @brief Refresh free bytes of data path periodically
+   * @brief Read the io stats of the disk from the diskstats file
+   *
+   * @return Whether the disk is found
+   */
+  static bool readDiskStats(dev_t dev,
+                            DiskIoStats& stats,
+                            const std::string& file = "/proc/diskstats");
+
+  /**
+   * @brief Refresh free bytes and io load of data path periodically
    */
   void refresh();
 
+  /**
+   * @brief Refresh the io load of each data path, which is exported in disk_io_util,
+   * disk_read_bytes and disk_write_bytes labeled by the path
+   */
+  void refreshIo(const std::vector<boost::filesystem::path>& dataPaths);
+
   struct Paths {
     // canonical path of data_path flag
     std::vector<boost::filesystem::path> dataPaths_;
@@ -123,6 +169,12 @@ class DiskManager {
   std::atomic<Paths*> paths_;
   // free space available to a non-privileged process, in bytes
   std::vector<std::atomic_uint64_t> freeBytes_;
+  // device of each data path
+  std::vector<dev_t> devices_;
+  // the last sampled io of each data path, only accessed in the background thread
+  std::vector<std::optional<DiskIoStats>> lastIo_;
+  int64_t lastIoTimeMs_{0};
+  std::vector<std::atomic_int32_t> ioUtil_;
 
   // lock used to protect partPath_ and partIndex_
   std::mutex lock_;
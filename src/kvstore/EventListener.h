@@ -4,6 +4,7 @@
  */
 
 #include "common/base/Base.h"
+#include "kvstore/stats/KVStats.h"
 #include "rocksdb/db.h"
 #include "rocksdb/listener.h"
 
@@ -46,6 +47,10 @@ class EventListener : public rocksdb::EventListener {
    * @param info Flush job information passed by rocksdb
    */
   void OnFlushBegin(rocksdb::DB*, const rocksdb::FlushJobInfo& info) override {
+    if (info.flush_reason == rocksdb::FlushReason::kWriteBufferManager) {
+      // The memtables of all the spaces exceed rocksdb_memtable_budget
+      stats::StatsManager::addValue(kNumMemtableBudgetFlushes);
+    }
     VLOG(1) << "Rocksdb start flush column family: " << info.cf_name << " because of "
             << flushReasonString(info.flush_reason)
             << ", the newly created file: " << info.file_path
@@ -155,6 +160,10 @@ class EventListener : public rocksdb::EventListener {
    * @param info Current and previous status of whether write is stalled
    */
   void OnStallConditionsChanged(const rocksdb::WriteStallInfo& info) override {
+    if (info.condition.prev == rocksdb::WriteStallCondition::kNormal &&
+        info.condition.cur != rocksdb::WriteStallCondition::kNormal) {
+      stats::StatsManager::addValue(kNumWriteStalls);
+    }
     LOG(INFO) << "Stall conditions changed column family: " << info.cf_name
               << ", current condition: " << writeStallConditionString(info.condition.cur)
               << ", previous condition: " << writeStallConditionString(info.condition.prev);
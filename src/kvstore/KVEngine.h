@@ -11,6 +11,7 @@
 #include "common/base/Status.h"
 #include "kvstore/Common.h"
 #include "kvstore/KVIterator.h"
+#include "kvstore/LogEncoder.h"
 
 namespace nebula {
 namespace kvstore {
@@ -47,6 +48,26 @@ class WriteBatch {
    * @return nebula::cpp2::ErrorCode
    */
   virtual nebula::cpp2::ErrorCode removeRange(folly::StringPiece start, folly::StringPiece end) = 0;
+
+  /**
+   * @brief Encode the operation of merging an operand into the value of key into write batch
+   *
+   * @param key Key to merge
+   * @param operand Operand applied by the merge operator of engine
+   * @return nebula::cpp2::ErrorCode
+   */
+  virtual nebula::cpp2::ErrorCode merge(folly::StringPiece key, folly::StringPiece operand) = 0;
+
+  using Visitor = std::function<void(BatchLogType, folly::StringPiece, folly::StringPiece)>;
+
+  /**
+   * @brief Visit the writes encoded into the batch in order
+   *
+   * @param visitor Called with the type, the key and the value of each write. The value is the end
+   * key of a range remove, or the operand of a merge
+   * @return nebula::cpp2::ErrorCode
+   */
+  virtual nebula::cpp2::ErrorCode iterate(const Visitor& visitor) = 0;
 };
 
 /**
@@ -74,6 +95,15 @@ class KVEngine {
    */
   virtual const char* getWalRoot() const = 0;
 
+  /**
+   * @brief Return the only part of the engine if the engine is dedicated to a part
+   *
+   * @return PartitionID 0 if the engine is shared by the parts of the space on its data path
+   */
+  virtual PartitionID dedicatedPart() const {
+    return 0;
+  }
+
   /**
    * @brief return a WriteBatch object to do batch operation
    *
@@ -81,6 +111,18 @@ class KVEngine {
    */
   virtual std::unique_ptr<WriteBatch> startBatchWrite() = 0;
 
+  /**
+   * @brief Check whether the engine could take a write before it's proposed, since the writes
+   * committed by raft must not fail in the engine
+   *
+   * @param bytes The size of the write, 0 if it's unknown
+   * @return nebula::cpp2::ErrorCode E_WRITE_STALLED if there is no room for the write
+   */
+  virtual nebula::cpp2::ErrorCode admitWrite(size_t bytes) {
+    UNUSED(bytes);
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
   /**
    * @brief write the batch operation into kv engine
    *
@@ -138,11 +180,31 @@ class KVEngine {
    * @param start Start key, inclusive
    * @param end End key, exclusive
    * @param iter Iterator in range [start, end), returns by kv engine
+   * @param snapshot Snapshot from kv engine. nullptr means no snapshot.
    * @return nebula::cpp2::ErrorCode
    */
   virtual nebula::cpp2::ErrorCode range(const std::string& start,
                                         const std::string& end,
-                                        std::unique_ptr<KVIterator>* iter) = 0;
+                                        std::unique_ptr<KVIterator>* iter,
+                                        const void* snapshot = nullptr) = 0;
+
+  /**
+   * @brief Split the range [start, end) into at most num sub ranges of similar data size
+   *
+   * @param start Start key, inclusive
+   * @param end End key, exclusive
+   * @param num Max number of sub ranges
+   * @return std::vector<std::string> The boundaries between the sub ranges in order, empty if the
+   * range could not be split
+   */
+  virtual std::vector<std::string> splitRange(const std::string& start,
+                                              const std::string& end,
+                                              size_t num) {
+    UNUSED(start);
+    UNUSED(end);
+    UNUSED(num);
+    return {};
+  }
 
   /**
    * @brief Get all results with 'prefix' str as prefix.
@@ -310,6 +372,26 @@ class KVEngine {
    */
   virtual nebula::cpp2::ErrorCode compact() = 0;
 
+  /**
+   * @brief Compact the keys in [start, end] of the lsm tree, the range must be in one column
+   * family, e.g. the keys of one type of a part
+   *
+   * @param start The first key of the range
+   * @param end The last key of the range
+   * @return nebula::cpp2::ErrorCode
+   */
+  virtual nebula::cpp2::ErrorCode compactRange(const std::string& start,
+                                               const std::string& end) = 0;
+
+  /**
+   * @brief Get the key ranges of the data files of which the ratio of tombstones is no less than
+   * the given one, the overlapping ranges are merged
+   *
+   * @param ratio Ratio of the deletions to all the entries of a file
+   * @return std::vector<std::pair<std::string, std::string>> The first and last key of each range
+   */
+  virtual std::vector<std::pair<std::string, std::string>> tombstoneRanges(double ratio) = 0;
+
   /**
    * @brief Flush data in memtable into sst
    *
@@ -30,6 +30,18 @@ class KVIterator {
    */
   virtual void prev() = 0;
 
+  /**
+   * @brief Move forward to the first key not less than the target, the target should not be
+   * before the current key. The default one moves by next() one by one.
+   *
+   * @param target Key to seek
+   */
+  virtual void seek(folly::StringPiece target) {
+    while (valid() && key() < target) {
+      next();
+    }
+  }
+
   /**
    * @brief Return the key of iterator points to
    *
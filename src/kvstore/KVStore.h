@@ -89,6 +89,36 @@ class KVStore {
   virtual ErrorOr<nebula::cpp2::ErrorCode, HostAddr> partLeader(GraphSpaceID spaceId,
                                                                 PartitionID partID) = 0;
 
+  /**
+   * @brief Return whether the part is a follower on this host whose data is at most maxStalenessMs
+   * behind the leader, so that the reads accepting stale data could be served by it
+   *
+   * @param spaceId
+   * @param partId
+   * @param maxStalenessMs
+   */
+  virtual bool followerReadable(GraphSpaceID spaceId, PartitionID partId, int64_t maxStalenessMs) {
+    UNUSED(spaceId);
+    UNUSED(partId);
+    UNUSED(maxStalenessMs);
+    return false;
+  }
+
+  /**
+   * @brief Check whether the part on this host could serve linearizable reads as leader. The lease
+   * is used if it is still valid, otherwise the leadership is confirmed by the peers.
+   *
+   * @param spaceId
+   * @param partId
+   * @return folly::Future<nebula::cpp2::ErrorCode>
+   */
+  virtual folly::Future<nebula::cpp2::ErrorCode> readIndex(GraphSpaceID spaceId,
+                                                           PartitionID partId) {
+    UNUSED(spaceId);
+    UNUSED(partId);
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
   /**
    * @brief Return pointer of part manager
    *
@@ -164,6 +194,7 @@ class KVStore {
    * @param end End key, exclusive
    * @param iter Iterator in range [start, end), returns by kv engine
    * @param canReadFromFollower
+   * @param snapshot If set, read from snapshot.
    * @return nebula::cpp2::ErrorCode
    */
   virtual nebula::cpp2::ErrorCode range(GraphSpaceID spaceId,
@@ -171,7 +202,8 @@ class KVStore {
                                         const std::string& start,
                                         const std::string& end,
                                         std::unique_ptr<KVIterator>* iter,
-                                        bool canReadFromFollower = false) = 0;
+                                        bool canReadFromFollower = false,
+                                        const void* snapshot = nullptr) = 0;
 
   /**
    * @brief To forbid to pass rvalue via the 'range' parameter.
@@ -181,7 +213,32 @@ class KVStore {
                                         std::string&& start,
                                         std::string&& end,
                                         std::unique_ptr<KVIterator>* iter,
-                                        bool canReadFromFollower = false) = delete;
+                                        bool canReadFromFollower = false,
+                                        const void* snapshot = nullptr) = delete;
+
+  /**
+   * @brief Split the range [start, end) of a part into at most num sub ranges of similar data
+   * size, so that they could be scanned concurrently
+   *
+   * @param spaceId
+   * @param partId
+   * @param start Start key, inclusive
+   * @param end End key, exclusive
+   * @param num Max number of sub ranges
+   * @return std::vector<std::string> The boundaries between the sub ranges in order
+   */
+  virtual std::vector<std::string> splitRange(GraphSpaceID spaceId,
+                                              PartitionID partId,
+                                              const std::string& start,
+                                              const std::string& end,
+                                              size_t num) {
+    UNUSED(spaceId);
+    UNUSED(partId);
+    UNUSED(start);
+    UNUSED(end);
+    UNUSED(num);
+    return {};
+  }
 
   /**
    * @brief Get all results with 'prefix' str as prefix.
@@ -394,6 +451,31 @@ class KVStore {
    */
   virtual nebula::cpp2::ErrorCode dropCheckpoint(GraphSpaceID spaceId, const std::string& name) = 0;
 
+  /**
+   * @brief Clone the data of a space as the data of a new space not added yet, only used in
+   * rocksdb. The parts of the new space are loaded from the clone when they are added.
+   *
+   * @param spaceId Space to clone
+   * @param newSpaceId New space
+   * @return nebula::cpp2::ErrorCode
+   */
+  virtual nebula::cpp2::ErrorCode cloneSpace(GraphSpaceID spaceId, GraphSpaceID newSpaceId) {
+    UNUSED(spaceId);
+    UNUSED(newSpaceId);
+    return nebula::cpp2::ErrorCode::E_UNSUPPORTED;
+  }
+
+  /**
+   * @brief Remove the data cloned by cloneSpace, when the new space fails to be created
+   *
+   * @param newSpaceId New space, which must not be added
+   * @return nebula::cpp2::ErrorCode
+   */
+  virtual nebula::cpp2::ErrorCode dropClonedSpace(GraphSpaceID newSpaceId) {
+    UNUSED(newSpaceId);
+    return nebula::cpp2::ErrorCode::E_UNSUPPORTED;
+  }
+
   /**
    * @brief Set the write blocking flag
    *
@@ -8,6 +8,7 @@
 #include "codec/RowReaderWrapper.h"
 #include "common/time/WallClock.h"
 #include "kvstore/LogEncoder.h"
+#include "kvstore/stats/KVStats.h"
 
 DEFINE_int32(listener_commit_interval_secs, 1, "Listener commit interval");
 DEFINE_int32(listener_commit_batch_size, 1000, "Max batch size when listener commit");
@@ -43,7 +44,7 @@ Listener::Listener(GraphSpaceID spaceId,
       schemaMan_(schemaMan) {}
 
 void Listener::start(std::vector<HostAddr>&& peers, bool) {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
 
   init();
 
@@ -90,7 +91,7 @@ void Listener::start(std::vector<HostAddr>&& peers, bool) {
 void Listener::stop() {
   LOG(INFO) << "Stop listener [" << spaceId_ << ", " << partId_ << "] on " << addr_;
   {
-    std::unique_lock<std::mutex> lck(raftLock_);
+    std::unique_lock<thread::ProfiledMutex> lck(raftLock_);
     status_ = Status::STOPPED;
     leader_ = {"", 0};
   }
@@ -124,7 +125,7 @@ bool Listener::preProcessLog(LogID logId,
 }
 
 void Listener::cleanWal() {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   wal()->cleanWAL(lastApplyLogId_);
 }
 
@@ -150,16 +151,22 @@ void Listener::doApply() {
   if (needToCleanupSnapshot()) {
     cleanupSnapshot();
   }
-  // todo(doodle): only put is handled, all remove is ignored for now
+  // Only the puts are handled unless the listener applies all the changes
   folly::via(executor_.get(), [this] {
+    // Go on at once if the logs are left by the batch size, to catch up under heavy writes
+    bool pursue = false;
     SCOPE_EXIT {
-      bgWorkers_->addDelayTask(
-          FLAGS_listener_commit_interval_secs * 1000, &Listener::doApply, this);
+      if (pursue) {
+        bgWorkers_->addTask(&Listener::doApply, this);
+      } else {
+        bgWorkers_->addDelayTask(
+            FLAGS_listener_commit_interval_secs * 1000, &Listener::doApply, this);
+      }
     };
 
     std::unique_ptr<LogIterator> iter;
     {
-      std::lock_guard<std::mutex> guard(raftLock_);
+      std::lock_guard<thread::ProfiledMutex> guard(raftLock_);
       if (lastApplyLogId_ >= committedLogId_) {
         return;
       }
@@ -167,8 +174,23 @@ void Listener::doApply() {
     }
 
     LogID lastApplyId = -1;
+    bool all = appliesAllChanges();
     // the kv pair which can sync to remote safely
     std::vector<KV> data;
+    // all the changes in the order of logs, if the listener applies them
+    std::vector<BatchOp> batch;
+    auto put = [&](folly::StringPiece key, folly::StringPiece val) {
+      if (all) {
+        batch.emplace_back(BatchLogType::OP_BATCH_PUT, key.str(), val.str());
+      } else {
+        data.emplace_back(key, val);
+      }
+    };
+    auto change = [&](BatchLogType type, folly::StringPiece key, folly::StringPiece val) {
+      if (all) {
+        batch.emplace_back(type, key.str(), val.str());
+      }
+    };
     while (iter->valid()) {
       lastApplyId = iter->logId();
 
@@ -180,32 +202,51 @@ void Listener::doApply() {
       }
 
       DCHECK_GE(log.size(), sizeof(int64_t) + 1 + sizeof(uint32_t));
+      std::string decompressed;
+      if (isCompressedLog(log)) {
+        decompressed = decompressLog(log);
+        log = decompressed;
+      }
       switch (log[sizeof(int64_t)]) {
         case OP_PUT: {
           auto pieces = decodeMultiValues(log);
           DCHECK_EQ(2, pieces.size());
-          data.emplace_back(pieces[0], pieces[1]);
+          put(pieces[0], pieces[1]);
           break;
         }
         case OP_MULTI_PUT: {
           auto kvs = decodeMultiValues(log);
           DCHECK_EQ((kvs.size() + 1) / 2, kvs.size() / 2);
           for (size_t i = 0; i < kvs.size(); i += 2) {
-            data.emplace_back(kvs[i], kvs[i + 1]);
+            put(kvs[i], kvs[i + 1]);
           }
           break;
         }
-        case OP_REMOVE:
-        case OP_REMOVE_RANGE:
+        case OP_REMOVE: {
+          change(BatchLogType::OP_BATCH_REMOVE, decodeSingleValue(log), "");
+          break;
+        }
         case OP_MULTI_REMOVE: {
+          for (auto key : decodeMultiValues(log)) {
+            change(BatchLogType::OP_BATCH_REMOVE, key, "");
+          }
+          break;
+        }
+        case OP_REMOVE_RANGE: {
+          auto range = decodeMultiValues(log);
+          DCHECK_EQ(2, range.size());
+          change(BatchLogType::OP_BATCH_REMOVE_RANGE, range[0], range[1]);
           break;
         }
         case OP_BATCH_WRITE: {
-          auto batch = decodeBatchValue(log);
-          for (auto& op : batch) {
-            // OP_BATCH_PUT and OP_BATCH_REMOVE_RANGE is ignored
+          auto ops = decodeBatchValue(log);
+          for (auto& op : ops) {
+            // Only OP_BATCH_PUT is handled by apply. The merges only add to the numeric props,
+            // which are never in the full text indexes of ESListener, so they are not needed by it
             if (op.first == BatchLogType::OP_BATCH_PUT) {
-              data.emplace_back(op.second.first, op.second.second);
+              put(op.second.first, op.second.second);
+            } else {
+              change(op.first, op.second.first, op.second.second);
             }
           }
           break;
@@ -222,19 +263,27 @@ void Listener::doApply() {
         }
       }
 
-      if (static_cast<int32_t>(data.size()) > FLAGS_listener_commit_batch_size) {
+      if (static_cast<int32_t>(data.size() + batch.size()) > FLAGS_listener_commit_batch_size) {
         break;
       }
       ++(*iter);
     }
 
     // apply to state machine
-    if (lastApplyId != -1 && apply(data)) {
-      std::lock_guard<std::mutex> guard(raftLock_);
+    if (lastApplyId != -1 && (all ? applyBatch(batch, lastApplyId) : apply(data))) {
+      std::lock_guard<thread::ProfiledMutex> guard(raftLock_);
       lastApplyLogId_ = lastApplyId;
       persist(committedLogId_, term_, lastApplyLogId_);
       VLOG(2) << idStr_ << "Listener succeeded apply log to " << lastApplyLogId_;
       lastApplyTime_ = time::WallClock::fastNowInMilliSec();
+      pursue = iter->valid();
+      if (kListenerApplyLag.valid()) {
+        std::vector<std::pair<std::string, std::string>> labels = {
+            {"space", folly::to<std::string>(spaceId_)}, {"part", folly::to<std::string>(partId_)}};
+        stats::StatsManager::addValue(
+            stats::StatsManager::counterWithLabels(kListenerApplyLag, labels),
+            committedLogId_ - lastApplyLogId_);
+      }
     }
   });
 }
@@ -277,7 +326,7 @@ std::tuple<nebula::cpp2::ErrorCode, int64_t, int64_t> Listener::commitSnapshot(
 }
 
 void Listener::resetListener() {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   reset();
   LOG(INFO) << folly::sformat(
       "The listener has been reset : leaderCommitId={},"
@@ -290,7 +339,7 @@ void Listener::resetListener() {
 }
 
 bool Listener::pursueLeaderDone() {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   if (status_ != Status::RUNNING) {
     return false;
   }
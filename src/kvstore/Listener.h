@@ -9,6 +9,8 @@
 #include "common/base/Base.h"
 #include "common/meta/SchemaManager.h"
 #include "kvstore/Common.h"
+#include "kvstore/KVEngine.h"
+#include "kvstore/LogEncoder.h"
 #include "kvstore/raftex/Host.h"
 #include "kvstore/raftex/RaftPart.h"
 #include "kvstore/wal/FileBasedWal.h"
@@ -81,6 +83,10 @@ using RaftClient = thrift::ThriftClientManager<raftex::cpp2::RaftexServiceAsyncC
  *   // apply the kv to state machine
  *   bool apply(const std::vector<KV>& data)
  *
+ *   // or, if appliesAllChanges() returns true, apply the removes and merges in the order of logs
+ *   // along with the puts
+ *   bool applyBatch(const std::vector<BatchOp>& batch, LogID lastApplyLogId)
+ *
  *   // persist last commit log id/term and lastApplyId
  *   bool persist(LogID, TermID, LogID)
  *
@@ -167,6 +173,15 @@ class Listener : public raftex::RaftPart {
    */
   bool pursueLeaderDone();
 
+  /**
+   * @brief The engine to serve the reads from, if the listener keeps a copy of the data
+   *
+   * @return KVEngine* nullptr if it doesn't
+   */
+  virtual KVEngine* readEngine() {
+    return nullptr;
+  }
+
  protected:
   /**
    * @brief extra initialize work could do here
@@ -188,6 +203,30 @@ class Listener : public raftex::RaftPart {
    */
   virtual bool apply(const std::vector<KV>& data) = 0;
 
+  using BatchOp = std::tuple<BatchLogType, std::string, std::string>;
+
+  /**
+   * @brief Whether the listener applies all the changes by applyBatch, instead of only the puts by
+   * apply
+   */
+  virtual bool appliesAllChanges() const {
+    return false;
+  }
+
+  /**
+   * @brief Apply all the changes in the order of logs into listener's state machine
+   *
+   * @param batch The puts, removes, remove ranges and merges to apply
+   * @param lastApplyLogId The id of the last log in the batch
+   * @return True if succeed. False if failed.
+   */
+  virtual bool applyBatch(const std::vector<BatchOp>& batch, LogID lastApplyLogId) {
+    UNUSED(batch);
+    UNUSED(lastApplyLogId);
+    LOG(FATAL) << "Should not reach here";
+    return false;
+  }
+
   /**
    * @brief Persist commitLogId commitLogTerm and lastApplyLogId
    */
@@ -7,6 +7,8 @@
 #define KVSTORE_LISTENER_FACTORY_H_
 
 #include "kvstore/Listener.h"
+#include "kvstore/plugins/analytics/AnalyticsListener.h"
+#include "kvstore/plugins/cdc/CDCListener.h"
 #include "kvstore/plugins/elasticsearch/ESListener.h"
 
 namespace nebula {
@@ -29,6 +31,12 @@ class ListenerFactory {
     if (type == meta::cpp2::ListenerType::ELASTICSEARCH) {
       return std::make_shared<ESListener>(std::forward<Args>(args)...);
     }
+    if (type == meta::cpp2::ListenerType::ANALYTICS) {
+      return std::make_shared<AnalyticsListener>(std::forward<Args>(args)...);
+    }
+    if (type == meta::cpp2::ListenerType::CDC) {
+      return std::make_shared<CDCListener>(std::forward<Args>(args)...);
+    }
     LOG(FATAL) << "Should not reach here";
     return nullptr;
   }
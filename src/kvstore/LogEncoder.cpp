@@ -5,6 +5,7 @@
 
 #include "kvstore/LogEncoder.h"
 
+#include <folly/compression/Compression.h>
 #include <thrift/lib/cpp2/protocol/CompactProtocol.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
@@ -12,11 +13,41 @@
 #include "common/datatypes/HostAddrOps-inl.h"
 #include "common/time/WallClock.h"
 
+DEFINE_string(raft_log_compression,
+              "none",
+              "The compression of the large raft logs of writes, options: none, lz4, zstd. The "
+              "logs could not be read by the versions before, so enable it when all the storaged "
+              "are upgraded");
+DEFINE_int32(raft_log_compression_threshold,
+             64 * 1024,
+             "The raft logs of writes no smaller than it in bytes are compressed");
+
 namespace nebula {
 namespace kvstore {
 
 constexpr auto kHeadLen = sizeof(int64_t) + 1 + sizeof(uint32_t);
 
+namespace {
+
+// The codec of the compressed log, persisted in the wal
+enum LogCodec : char {
+  CODEC_LZ4 = 0x01,
+  CODEC_ZSTD = 0x02,
+};
+
+std::unique_ptr<folly::io::Codec> getLogCodec(char codec) {
+  switch (codec) {
+    case CODEC_LZ4:
+      return folly::io::getCodec(folly::io::CodecType::LZ4);
+    case CODEC_ZSTD:
+      return folly::io::getCodec(folly::io::CodecType::ZSTD);
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace
+
 std::string encodeKV(const folly::StringPiece& key, const folly::StringPiece& val) {
   uint32_t ksize = key.size();
   uint32_t vsize = val.size();
@@ -215,6 +246,159 @@ decodeBatchValue(folly::StringPiece encoded) {
   return batch;
 }
 
+namespace {
+
+void appendBatchOp(std::string& encoded,
+                   BatchLogType type,
+                   folly::StringPiece key,
+                   folly::StringPiece val) {
+  auto keySize = static_cast<uint32_t>(key.size());
+  auto valSize = static_cast<uint32_t>(val.size());
+  encoded.append(reinterpret_cast<char*>(&type), 1)
+      .append(reinterpret_cast<char*>(&keySize), sizeof(uint32_t))
+      .append(key.data(), keySize)
+      .append(reinterpret_cast<char*>(&valSize), sizeof(uint32_t))
+      .append(val.data(), valSize);
+}
+
+}  // namespace
+
+std::string mergeWriteLogs(const std::vector<std::string>& logs) {
+  auto type = LogType::OP_BATCH_WRITE;
+  std::string encoded;
+  size_t size = kHeadLen;
+  for (const auto& log : logs) {
+    size += log.size();
+  }
+  encoded.reserve(size);
+
+  // Timestamp (8 bytes)
+  int64_t ts = time::WallClock::fastNowInMilliSec();
+  encoded.append(reinterpret_cast<char*>(&ts), sizeof(int64_t));
+  // Log type
+  encoded.append(reinterpret_cast<char*>(&type), 1);
+  // Number of values, filled when all the logs are merged
+  uint32_t num = 0;
+  encoded.append(reinterpret_cast<char*>(&num), sizeof(uint32_t));
+  for (const auto& log : logs) {
+    DCHECK_GE(log.size(), kHeadLen);
+    switch (log[sizeof(int64_t)]) {
+      case OP_PUT:
+      case OP_MULTI_PUT: {
+        auto kvs = decodeMultiValues(log);
+        DCHECK_EQ(0, kvs.size() % 2);
+        for (size_t i = 0; i + 1 < kvs.size(); i += 2) {
+          appendBatchOp(encoded, OP_BATCH_PUT, kvs[i], kvs[i + 1]);
+          num++;
+        }
+        break;
+      }
+      case OP_REMOVE: {
+        appendBatchOp(encoded, OP_BATCH_REMOVE, decodeSingleValue(log), "");
+        num++;
+        break;
+      }
+      case OP_MULTI_REMOVE: {
+        for (auto key : decodeMultiValues(log)) {
+          appendBatchOp(encoded, OP_BATCH_REMOVE, key, "");
+          num++;
+        }
+        break;
+      }
+      case OP_REMOVE_RANGE: {
+        auto range = decodeMultiValues(log);
+        DCHECK_EQ(2, range.size());
+        appendBatchOp(encoded, OP_BATCH_REMOVE_RANGE, range[0], range[1]);
+        num++;
+        break;
+      }
+      case OP_BATCH_WRITE: {
+        for (const auto& op : decodeBatchValue(log)) {
+          appendBatchOp(encoded, op.first, op.second.first, op.second.second);
+          num++;
+        }
+        break;
+      }
+      default:
+        LOG(FATAL) << "Unexpected log type " << static_cast<int32_t>(log[sizeof(int64_t)]);
+    }
+  }
+  memcpy(&encoded[sizeof(int64_t) + 1], &num, sizeof(uint32_t));
+
+  return encoded;
+}
+
+std::string compressLog(std::string&& log) {
+  if (FLAGS_raft_log_compression == "none" || log.size() < kHeadLen ||
+      log.size() < static_cast<size_t>(FLAGS_raft_log_compression_threshold)) {
+    return std::move(log);
+  }
+  switch (log[sizeof(int64_t)]) {
+    case OP_PUT:
+    case OP_MULTI_PUT:
+    case OP_MULTI_REMOVE:
+    case OP_BATCH_WRITE:
+      break;
+    default:
+      // The logs of the membership changes are read before being committed
+      return std::move(log);
+  }
+  char codec;
+  if (FLAGS_raft_log_compression == "lz4") {
+    codec = CODEC_LZ4;
+  } else if (FLAGS_raft_log_compression == "zstd") {
+    codec = CODEC_ZSTD;
+  } else {
+    LOG(WARNING) << "Unsupported raft log compression: " << FLAGS_raft_log_compression;
+    return std::move(log);
+  }
+
+  std::string compressed;
+  try {
+    compressed = getLogCodec(codec)->compress(log);
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Compress raft log failed: " << e.what();
+    return std::move(log);
+  }
+  if (compressed.size() + kHeadLen + 1 >= log.size()) {
+    return std::move(log);
+  }
+
+  auto type = LogType::OP_COMPRESSED;
+  std::string encoded;
+  encoded.reserve(kHeadLen + 1 + compressed.size());
+  // Timestamp of the log (8 bytes)
+  encoded.append(log.data(), sizeof(int64_t));
+  // Log type
+  encoded.append(reinterpret_cast<char*>(&type), 1);
+  // Size of the log
+  auto len = static_cast<uint32_t>(log.size());
+  encoded.append(reinterpret_cast<char*>(&len), sizeof(uint32_t));
+  // Codec
+  encoded.append(&codec, 1);
+  // Compressed log
+  encoded.append(compressed);
+  return encoded;
+}
+
+bool isCompressedLog(folly::StringPiece log) {
+  return log.size() > kHeadLen && log[sizeof(int64_t)] == OP_COMPRESSED;
+}
+
+std::string decompressLog(folly::StringPiece encoded) {
+  CHECK(isCompressedLog(encoded));
+  // Skip the timestamp and the type byte
+  auto* p = encoded.begin() + sizeof(int64_t) + 1;
+  uint32_t len = *(reinterpret_cast<const uint32_t*>(p));
+  p += sizeof(uint32_t);
+  auto codec = getLogCodec(*p);
+  CHECK(codec != nullptr) << "Unknown raft log codec " << static_cast<int32_t>(*p);
+  p++;
+  auto log = codec->uncompress(folly::StringPiece(p, encoded.end()), len);
+  CHECK_EQ(len, log.size());
+  return log;
+}
+
 std::string encodeHost(LogType type, const HostAddr& host) {
   std::string encoded;
   int64_t ts = time::WallClock::fastNowInMilliSec();
@@ -7,9 +7,14 @@
 #define KVSTORE_LOGENCODER_H_
 #include <boost/core/noncopyable.hpp>
 
+#include <gflags/gflags_declare.h>
+
 #include "common/cpp/helpers.h"
 #include "kvstore/Common.h"
 
+DECLARE_string(raft_log_compression);
+DECLARE_int32(raft_log_compression_threshold);
+
 namespace nebula {
 namespace kvstore {
 
@@ -24,12 +29,15 @@ enum LogType : char {
   OP_ADD_PEER = 0x09,
   OP_REMOVE_PEER = 0x10,
   OP_BATCH_WRITE = 0x11,
+  // A log of writes compressed as a whole, see compressLog
+  OP_COMPRESSED = 0x12,
 };
 
 enum BatchLogType : char {
   OP_BATCH_PUT = 0x01,
   OP_BATCH_REMOVE = 0x02,
   OP_BATCH_REMOVE_RANGE = 0x03,
+  OP_BATCH_MERGE = 0x04,
 };
 
 /**
@@ -116,6 +124,40 @@ std::string encodeBatchValue(
 std::vector<std::pair<BatchLogType, std::pair<folly::StringPiece, folly::StringPiece>>>
 decodeBatchValue(folly::StringPiece encoded);
 
+/**
+ * @brief Merge the logs of writes into one log of OP_BATCH_WRITE, the operations are kept in the
+ * order of the logs. Only the logs of OP_PUT, OP_MULTI_PUT, OP_REMOVE, OP_MULTI_REMOVE,
+ * OP_REMOVE_RANGE and OP_BATCH_WRITE could be merged.
+ *
+ * @param logs Encoded wal logs
+ * @return std::string Encoded wal
+ */
+std::string mergeWriteLogs(const std::vector<std::string>& logs);
+
+/**
+ * @brief Compress the log of writes if raft_log_compression is enabled and it's no smaller than
+ * raft_log_compression_threshold. The compressed log is of OP_COMPRESSED, with the timestamp of
+ * the log, followed by the size of the log, the codec and the compressed log. The logs which
+ * could not be compressed smaller are returned as is.
+ *
+ * @param log Encoded wal log
+ * @return std::string Encoded wal, compressed or not
+ */
+std::string compressLog(std::string&& log);
+
+/**
+ * @brief Whether the log is compressed by compressLog
+ */
+bool isCompressedLog(folly::StringPiece log);
+
+/**
+ * @brief Decompress the log compressed by compressLog
+ *
+ * @param encoded Encoded wal of OP_COMPRESSED
+ * @return std::string The original log
+ */
+std::string decompressLog(folly::StringPiece encoded);
+
 /**
  * @brief Encode a host into wal log
  *
@@ -143,7 +185,7 @@ HostAddr decodeHost(LogType type, const folly::StringPiece& encoded);
 int64_t getTimestamp(const folly::StringPiece& log);
 
 /**
- * @brief A wrapper class of batchs of log, support put/remove/removeRange
+ * @brief A wrapper class of batchs of log, support put/remove/removeRange/merge
  */
 class BatchHolder : public boost::noncopyable, public nebula::cpp::NonMovable {
  public:
@@ -188,6 +230,21 @@ class BatchHolder : public boost::noncopyable, public nebula::cpp::NonMovable {
     batch_.emplace_back(std::move(op));
   }
 
+  /**
+   * @brief Add a merge operation to batch, the operand is applied to the value of key by the merge
+   * operator of the engine
+   *
+   * @param key Key to merge
+   * @param operand Merge operand
+   */
+  void merge(std::string&& key, std::string&& operand) {
+    size_ += key.size() + operand.size();
+    auto op = std::make_tuple(BatchLogType::OP_BATCH_MERGE,
+                              std::forward<std::string>(key),
+                              std::forward<std::string>(operand));
+    batch_.emplace_back(std::move(op));
+  }
+
   /**
    * @brief reserve spaces for batch
    */
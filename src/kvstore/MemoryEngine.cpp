@@ -0,0 +1,857 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "kvstore/MemoryEngine.h"
+
+#include <folly/ScopeGuard.h>
+#include <rocksdb/db.h>
+#include <rocksdb/sst_file_reader.h>
+#include <rocksdb/sst_file_writer.h>
+
+#include "common/fs/FileUtils.h"
+#include "common/utils/MetaKeyUtils.h"
+#include "common/utils/NebulaKeyUtils.h"
+
+DEFINE_int64(memory_engine_capacity_mb,
+             0,
+             "The memory could be used by the data of each in-memory space, no limit if it's not "
+             "positive, the writes are rejected with E_WRITE_STALLED before being proposed once "
+             "it's used up");
+
+namespace nebula {
+namespace kvstore {
+
+using fs::FileType;
+using fs::FileUtils;
+
+namespace {
+
+// The memory of a version besides its key and value, i.e. the node and the strings
+constexpr int64_t kEntryOverhead = 96;
+constexpr int kSkipListHeight = 8;
+// The keys of a batch when loading the sst files
+constexpr size_t kIngestBatchSize = 4096;
+// The shadowed versions are not collected before there are so many
+constexpr int64_t kMinGarbage = 1024;
+
+std::string partSubPath(PartitionID dedicatedPart) {
+  return dedicatedPart == 0 ? "" : folly::stringPrintf("/parts/%d", dedicatedPart);
+}
+
+}  // namespace
+
+/**
+ * Iterate the latest versions not after the sequence of the snapshot, the tombstones are skipped
+ */
+class MemoryIter final : public KVIterator {
+ public:
+  MemoryIter(MemoryEngine* engine,
+             const MemoryEngine::Snapshot* snapshot,
+             bool owned,
+             std::string start,
+             std::optional<std::string> end,
+             std::string prefix)
+      : engine_(engine),
+        snapshot_(snapshot),
+        owned_(owned),
+        start_(std::move(start)),
+        end_(std::move(end)),
+        prefix_(std::move(prefix)),
+        accessor_(engine->list_) {
+    seek(start_);
+  }
+
+  ~MemoryIter() override {
+    if (owned_) {
+      engine_->ReleaseSnapshot(snapshot_);
+    }
+  }
+
+  bool valid() const override {
+    return valid_;
+  }
+
+  void next() override {
+    skipKey();
+    settle();
+  }
+
+  /**
+   * @brief The versions are linked forward only, so it's found by scanning from the start again
+   */
+  void prev() override {
+    if (!valid_) {
+      return;
+    }
+    auto current = it_->key;
+    seek(start_);
+    std::string last;
+    bool found = false;
+    while (valid_ && it_->key < current) {
+      last = it_->key;
+      found = true;
+      next();
+    }
+    if (found) {
+      seek(last);
+    } else {
+      valid_ = false;
+    }
+  }
+
+  void seek(folly::StringPiece target) override {
+    MemoryEngine::Entry entry;
+    entry.key = target < start_ ? start_ : target.str();
+    entry.seq = snapshot_->seq;
+    it_ = accessor_.lower_bound(entry);
+    settle();
+  }
+
+  folly::StringPiece key() const override {
+    return it_->key;
+  }
+
+  folly::StringPiece val() const override {
+    return it_->value;
+  }
+
+ private:
+  bool inBound(const std::string& key) const {
+    return folly::StringPiece(key).startsWith(prefix_) && (!end_.has_value() || key < *end_);
+  }
+
+  // Move to the first version of the next key
+  void skipKey() {
+    auto it = it_;
+    while (it_ != accessor_.end() && it_->key == it->key) {
+      ++it_;
+    }
+  }
+
+  // Move to the first live version visible in the snapshot
+  void settle() {
+    while (true) {
+      if (it_ == accessor_.end() || !inBound(it_->key)) {
+        valid_ = false;
+        return;
+      }
+      if (it_->seq > snapshot_->seq) {
+        MemoryEngine::Entry entry;
+        entry.key = it_->key;
+        entry.seq = snapshot_->seq;
+        it_ = accessor_.lower_bound(entry);
+        continue;
+      }
+      if (it_->deleted) {
+        skipKey();
+        continue;
+      }
+      valid_ = true;
+      return;
+    }
+  }
+
+  MemoryEngine* engine_;
+  const MemoryEngine::Snapshot* snapshot_;
+  // Whether the snapshot is pinned by the iterator itself
+  bool owned_;
+  std::string start_;
+  // No upper bound if it's not there
+  std::optional<std::string> end_;
+  std::string prefix_;
+  MemoryEngine::SkipList::Accessor accessor_;
+  MemoryEngine::SkipList::iterator it_;
+  bool valid_{false};
+};
+
+MemoryEngine::MemoryEngine(GraphSpaceID spaceId,
+                           int32_t vIdLen,
+                           const std::string& dataPath,
+                           const std::string& walPath,
+                           std::shared_ptr<rocksdb::MergeOperator> mergeOp,
+                           PartitionID dedicatedPart)
+    : KVEngine(spaceId),
+      dedicatedPart_(dedicatedPart),
+      dataPath_(folly::stringPrintf("%s/nebula/%d", dataPath.c_str(), spaceId) +
+                partSubPath(dedicatedPart)),
+      mergeOp_(std::move(mergeOp)) {
+  UNUSED(vIdLen);
+  // set wal path as dataPath by default
+  if (walPath.empty()) {
+    walPath_ = dataPath_;
+  } else {
+    walPath_ =
+        folly::stringPrintf("%s/nebula/%d", walPath.c_str(), spaceId) + partSubPath(dedicatedPart);
+  }
+  auto path = folly::stringPrintf("%s/memory", dataPath_.c_str());
+  if (FileUtils::fileType(path.c_str()) == FileType::NOTEXIST && !FileUtils::makeDir(path)) {
+    LOG(FATAL) << "makeDir " << path << " failed";
+  }
+  if (FileUtils::fileType(path.c_str()) != FileType::DIRECTORY) {
+    LOG(FATAL) << path << " is not directory";
+  }
+  sstPath_ = path + "/data.sst";
+
+  // The capacity is checked when a write is admitted, the writes committed are always taken
+  capacity_ = FLAGS_memory_engine_capacity_mb * 1024 * 1024;
+  tracker_ = std::make_shared<MemoryTracker>(
+      folly::sformat("memory engine of space {}", spaceId), 0, MemoryTracker::process());
+  list_ = SkipList::createInstance(kSkipListHeight);
+  load();
+
+  if (spaceId_ != kDefaultSpaceId /* only for storage*/) {
+    std::string dataVersionValue;
+    if (get(NebulaKeyUtils::dataVersionKey(), &dataVersionValue) ==
+        nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
+      auto code = put(NebulaKeyUtils::dataVersionKey(), NebulaKeyUtils::dataVersionValue());
+      CHECK(code == nebula::cpp2::ErrorCode::SUCCEEDED);
+    }
+  }
+  partsNum_ = allParts().size();
+  LOG(INFO) << "open memory engine on " << path << " with " << numKeys_.load() << " keys";
+}
+
+void MemoryEngine::stop() {
+  flush();
+}
+
+void MemoryEngine::load() {
+  if (!FileUtils::exist(sstPath_)) {
+    return;
+  }
+  rocksdb::Options options;
+  rocksdb::SstFileReader reader(options);
+  auto status = reader.Open(sstPath_);
+  CHECK(status.ok()) << "Open " << sstPath_ << " failed: " << status.ToString();
+  std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+  SkipList::Accessor accessor(list_);
+  // The checkpoint is the first version of all the keys
+  lastSeq_ = 1;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    Entry entry;
+    entry.key = iter->key().ToString();
+    entry.seq = lastSeq_;
+    entry.value = iter->value().ToString();
+    tracker_->forceConsume(bytesOf(entry));
+    accessor.add(std::move(entry));
+    ++numKeys_;
+  }
+  CHECK(iter->status().ok()) << "Read " << sstPath_ << " failed: " << iter->status().ToString();
+  visibleSeq_.store(lastSeq_, std::memory_order_release);
+}
+
+int64_t MemoryEngine::bytesOf(const Entry& entry) {
+  return entry.key.size() + entry.value.size() + kEntryOverhead;
+}
+
+const MemoryEngine::Entry* MemoryEngine::find(const SkipList::Accessor& accessor,
+                                              const std::string& key,
+                                              uint64_t seq) const {
+  Entry entry;
+  entry.key = key;
+  entry.seq = seq;
+  auto it = accessor.lower_bound(entry);
+  if (it == accessor.end() || it->key != key) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::apply(const std::vector<MemoryWriteBatch::Op>& ops) {
+  // The final version of each key written by the batch
+  struct Staged {
+    Entry entry;
+    // The version visible before the batch
+    const Entry* prior{nullptr};
+  };
+
+  std::lock_guard<std::mutex> lk(writeLock_);
+  SkipList::Accessor accessor(list_);
+  auto visibleSeq = visibleSeq_.load(std::memory_order_relaxed);
+  std::map<std::string, Staged> staged;
+  auto stage = [&](const std::string& key) -> Entry& {
+    auto it = staged.find(key);
+    if (it == staged.end()) {
+      it = staged.emplace(key, Staged()).first;
+      it->second.prior = find(accessor, key, visibleSeq);
+      if (it->second.prior != nullptr) {
+        it->second.entry = *it->second.prior;
+      } else {
+        it->second.entry.key = key;
+        it->second.entry.deleted = true;
+      }
+    }
+    return it->second.entry;
+  };
+
+  for (const auto& op : ops) {
+    switch (op.type) {
+      case MemoryWriteBatch::OpType::kPut: {
+        auto& entry = stage(op.key);
+        entry.value = op.value;
+        entry.deleted = false;
+        break;
+      }
+      case MemoryWriteBatch::OpType::kRemove: {
+        auto& entry = stage(op.key);
+        entry.value.clear();
+        entry.deleted = true;
+        break;
+      }
+      case MemoryWriteBatch::OpType::kMerge: {
+        if (mergeOp_ == nullptr) {
+          LOG(WARNING) << "No merge operator of the memory engine of space " << spaceId_;
+          return nebula::cpp2::ErrorCode::E_UNSUPPORTED;
+        }
+        auto& entry = stage(op.key);
+        rocksdb::Slice existing(entry.value);
+        std::vector<rocksdb::Slice> operands{rocksdb::Slice(op.value)};
+        std::string merged;
+        rocksdb::Slice operand(nullptr, 0);
+        rocksdb::MergeOperator::MergeOperationOutput output(merged, operand);
+        rocksdb::MergeOperator::MergeOperationInput input(
+            rocksdb::Slice(op.key), entry.deleted ? nullptr : &existing, operands, nullptr);
+        if (!mergeOp_->FullMergeV2(input, &output)) {
+          LOG(WARNING) << "Failed to merge the key in space " << spaceId_;
+          return nebula::cpp2::ErrorCode::E_STORE_FAILURE;
+        }
+        entry.value = operand.data() != nullptr ? operand.ToString() : std::move(merged);
+        entry.deleted = false;
+        break;
+      }
+      case MemoryWriteBatch::OpType::kRemoveRange: {
+        Entry begin;
+        begin.key = op.key;
+        begin.seq = visibleSeq;
+        // All the versions are visible with the write lock held, the first one of a key is its
+        // latest version
+        std::vector<std::string> keys;
+        const std::string* current = nullptr;
+        for (auto it = accessor.lower_bound(begin); it != accessor.end() && it->key < op.value;
+             ++it) {
+          if (current != nullptr && *current == it->key) {
+            continue;
+          }
+          current = &it->key;
+          if (!it->deleted) {
+            keys.emplace_back(it->key);
+          }
+        }
+        for (auto it = staged.lower_bound(op.key); it != staged.end() && it->first < op.value;
+             ++it) {
+          keys.emplace_back(it->first);
+        }
+        for (const auto& key : keys) {
+          auto& entry = stage(key);
+          entry.value.clear();
+          entry.deleted = true;
+        }
+        break;
+      }
+    }
+  }
+
+  // The removes of the keys not there are dropped
+  int64_t bytes = 0;
+  int64_t garbage = 0;
+  int64_t keys = 0;
+  for (auto it = staged.begin(); it != staged.end();) {
+    const auto* prior = it->second.prior;
+    bool live = prior != nullptr && !prior->deleted;
+    if (it->second.entry.deleted && !live) {
+      it = staged.erase(it);
+      continue;
+    }
+    if (it->second.entry.deleted) {
+      --keys;
+      // The tombstone shadows the value, and is collected along with it
+      garbage += 2;
+    } else {
+      keys += live ? 0 : 1;
+      garbage += prior != nullptr ? 1 : 0;
+    }
+    bytes += bytesOf(it->second.entry);
+    ++it;
+  }
+  if (staged.empty()) {
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+  // The write has been admitted, it may go beyond the capacity a little along with the others
+  // admitted at the same time
+  tracker_->forceConsume(bytes);
+
+  // All the versions of the batch are of the same sequence, and seen once it's visible
+  auto seq = ++lastSeq_;
+  for (auto& [key, s] : staged) {
+    s.entry.seq = seq;
+    accessor.add(std::move(s.entry));
+  }
+  visibleSeq_.store(seq, std::memory_order_release);
+  numKeys_ += keys;
+  garbage_ += garbage;
+  if (garbage_ > std::max<int64_t>(numKeys_, kMinGarbage)) {
+    collectGarbage();
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+void MemoryEngine::collectGarbage() {
+  // Wait for the reads without a pinned sequence, the ones after it read the visible sequence
+  { folly::SharedMutex::WriteHolder barrier(gcLock_); }
+  // The sequences read by someone
+  std::set<uint64_t> readers;
+  {
+    std::lock_guard<std::mutex> lk(pinLock_);
+    readers.insert(pins_.begin(), pins_.end());
+  }
+  readers.insert(visibleSeq_.load(std::memory_order_relaxed));
+
+  SkipList::Accessor accessor(list_);
+  std::vector<Entry> removed;
+  int64_t bytes = 0;
+  auto it = accessor.begin();
+  while (it != accessor.end()) {
+    // A version is read by the readers from its sequence to the one of the newer version
+    std::vector<std::pair<const Entry*, bool>> versions;
+    uint64_t newer = std::numeric_limits<uint64_t>::max();
+    const auto& key = it->key;
+    for (; it != accessor.end() && it->key == key; ++it) {
+      auto reader = readers.lower_bound(it->seq);
+      versions.emplace_back(&*it, reader != readers.end() && *reader < newer);
+      newer = it->seq;
+    }
+    // The oldest tombstones shadow nothing
+    for (auto v = versions.rbegin(); v != versions.rend(); ++v) {
+      if (v->second) {
+        if (!v->first->deleted) {
+          break;
+        }
+        v->second = false;
+      }
+    }
+    for (const auto& [entry, kept] : versions) {
+      if (!kept) {
+        Entry dead;
+        dead.key = entry->key;
+        dead.seq = entry->seq;
+        removed.emplace_back(std::move(dead));
+        bytes += bytesOf(*entry);
+      }
+    }
+  }
+  for (const auto& entry : removed) {
+    accessor.remove(entry);
+  }
+  tracker_->release(bytes);
+  // The versions kept for the snapshots are counted again once they are released
+  garbage_ = 0;
+  VLOG(1) << "Collected " << removed.size() << " versions of space " << spaceId_ << ", "
+          << accessor.size() << " versions of " << numKeys_.load() << " keys left";
+}
+
+const MemoryEngine::Snapshot* MemoryEngine::pin() {
+  folly::SharedMutex::ReadHolder rh(gcLock_);
+  std::lock_guard<std::mutex> lk(pinLock_);
+  auto seq = visibleSeq_.load(std::memory_order_acquire);
+  return new Snapshot{seq, pins_.insert(seq)};
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::admitWrite(size_t bytes) {
+  if (capacity_ > 0 && tracker_->used() + static_cast<int64_t>(bytes) > capacity_) {
+    VLOG(1) << "The memory engine of space " << spaceId_ << " is full, used "
+            << tracker_->used() << " of " << capacity_ << " bytes";
+    return nebula::cpp2::ErrorCode::E_WRITE_STALLED;
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+const void* MemoryEngine::GetSnapshot() {
+  return pin();
+}
+
+void MemoryEngine::ReleaseSnapshot(const void* snapshot) {
+  const auto* snap = reinterpret_cast<const Snapshot*>(snapshot);
+  if (snap == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lk(pinLock_);
+    pins_.erase(snap->pin);
+  }
+  delete snap;
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::commitBatchWrite(std::unique_ptr<WriteBatch> batch,
+                                                       bool disableWAL,
+                                                       bool sync,
+                                                       bool wait) {
+  UNUSED(disableWAL);
+  UNUSED(sync);
+  UNUSED(wait);
+  auto* b = static_cast<MemoryWriteBatch*>(batch.get());
+  return apply(b->ops());
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::get(const std::string& key,
+                                          std::string* value,
+                                          const void* snapshot) {
+  SkipList::Accessor accessor(list_);
+  folly::SharedMutex::ReadHolder rh(gcLock_);
+  auto seq = snapshot != nullptr ? reinterpret_cast<const Snapshot*>(snapshot)->seq
+                                 : visibleSeq_.load(std::memory_order_acquire);
+  const auto* entry = find(accessor, key, seq);
+  if (entry == nullptr || entry->deleted) {
+    return nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND;
+  }
+  *value = entry->value;
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+std::vector<Status> MemoryEngine::multiGet(const std::vector<std::string>& keys,
+                                           std::vector<std::string>* values) {
+  values->resize(keys.size());
+  std::vector<Status> ret;
+  ret.reserve(keys.size());
+  SkipList::Accessor accessor(list_);
+  folly::SharedMutex::ReadHolder rh(gcLock_);
+  auto seq = visibleSeq_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < keys.size(); i++) {
+    const auto* entry = find(accessor, keys[i], seq);
+    if (entry != nullptr && !entry->deleted) {
+      (*values)[i] = entry->value;
+      ret.emplace_back(Status::OK());
+    } else {
+      ret.emplace_back(Status::KeyNotFound());
+    }
+  }
+  return ret;
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::newIter(std::string start,
+                                              std::optional<std::string> end,
+                                              std::string prefix,
+                                              const void* snapshot,
+                                              std::unique_ptr<KVIterator>* iter) {
+  const auto* snap = reinterpret_cast<const Snapshot*>(snapshot);
+  bool owned = snap == nullptr;
+  if (owned) {
+    snap = pin();
+  }
+  *iter = std::make_unique<MemoryIter>(
+      this, snap, owned, std::move(start), std::move(end), std::move(prefix));
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::range(const std::string& start,
+                                            const std::string& end,
+                                            std::unique_ptr<KVIterator>* iter,
+                                            const void* snapshot) {
+  return newIter(start, end, "", snapshot, iter);
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::prefix(const std::string& prefix,
+                                             std::unique_ptr<KVIterator>* iter,
+                                             const void* snapshot) {
+  return newIter(prefix, std::nullopt, prefix, snapshot, iter);
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::rangeWithPrefix(const std::string& start,
+                                                      const std::string& prefix,
+                                                      std::unique_ptr<KVIterator>* iter) {
+  return newIter(start, std::nullopt, prefix, nullptr, iter);
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::scan(std::unique_ptr<KVIterator>* storageIter) {
+  return newIter("", std::nullopt, "", nullptr, storageIter);
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::put(std::string key, std::string value) {
+  return apply({{MemoryWriteBatch::OpType::kPut, std::move(key), std::move(value)}});
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::multiPut(std::vector<KV> keyValues) {
+  std::vector<MemoryWriteBatch::Op> ops;
+  ops.reserve(keyValues.size());
+  for (auto& kv : keyValues) {
+    ops.emplace_back(MemoryWriteBatch::Op{
+        MemoryWriteBatch::OpType::kPut, std::move(kv.first), std::move(kv.second)});
+  }
+  return apply(ops);
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::remove(const std::string& key) {
+  return apply({{MemoryWriteBatch::OpType::kRemove, key, ""}});
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::multiRemove(std::vector<std::string> keys) {
+  std::vector<MemoryWriteBatch::Op> ops;
+  ops.reserve(keys.size());
+  for (auto& key : keys) {
+    ops.emplace_back(MemoryWriteBatch::Op{MemoryWriteBatch::OpType::kRemove, std::move(key), ""});
+  }
+  return apply(ops);
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::removeRange(const std::string& start,
+                                                  const std::string& end) {
+  return apply({{MemoryWriteBatch::OpType::kRemoveRange, start, end}});
+}
+
+void MemoryEngine::addPart(PartitionID partId, const Peers& raftPeers) {
+  auto ret = put(NebulaKeyUtils::systemPartKey(partId), "");
+  if (ret == nebula::cpp2::ErrorCode::SUCCEEDED) {
+    partsNum_++;
+    CHECK_GE(partsNum_, 0);
+  }
+
+  if (!raftPeers.allNormalPeers()) {
+    put(NebulaKeyUtils::systemBalanceKey(partId), raftPeers.toString());
+  }
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::updatePart(PartitionID partId, const Peer& raftPeer) {
+  std::string val;
+  auto ret = get(NebulaKeyUtils::systemBalanceKey(partId), &val);
+
+  Peers peers;
+  if (ret == nebula::cpp2::ErrorCode::SUCCEEDED) {
+    peers = Peers::fromString(val);
+  } else if (ret != nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
+    LOG(INFO) << "Update part failed when get, partId=" << partId;
+    return ret;
+  }
+
+  peers.addOrUpdate(raftPeer);
+  if (peers.allNormalPeers()) {
+    ret = remove(NebulaKeyUtils::systemBalanceKey(partId));
+  } else {
+    ret = put(NebulaKeyUtils::systemBalanceKey(partId), peers.toString());
+  }
+
+  if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    LOG(INFO) << "Update part failed when put back, partId=" << partId;
+  }
+  return ret;
+}
+
+void MemoryEngine::removePart(PartitionID partId) {
+  std::vector<std::string> sysKeysToDelete;
+  sysKeysToDelete.emplace_back(NebulaKeyUtils::systemPartKey(partId));
+  sysKeysToDelete.emplace_back(NebulaKeyUtils::systemBalanceKey(partId));
+  sysKeysToDelete.emplace_back(NebulaKeyUtils::systemCommitKey(partId));
+  auto code = multiRemove(sysKeysToDelete);
+  if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+    partsNum_--;
+    CHECK_GE(partsNum_, 0);
+  }
+}
+
+std::vector<PartitionID> MemoryEngine::allParts() {
+  std::unique_ptr<KVIterator> iter;
+  std::vector<PartitionID> parts;
+  static const std::string prefixStr = NebulaKeyUtils::systemPrefix();
+  auto retCode = this->prefix(prefixStr, &iter);
+  if (nebula::cpp2::ErrorCode::SUCCEEDED != retCode) {
+    return parts;
+  }
+
+  for (; iter->valid(); iter->next()) {
+    auto key = iter->key();
+    if (!NebulaKeyUtils::isSystemPart(key)) {
+      continue;
+    }
+    PartitionID partId = *reinterpret_cast<const PartitionID*>(key.data());
+    parts.emplace_back(partId >> 8);
+  }
+  return parts;
+}
+
+std::map<PartitionID, Peers> MemoryEngine::balancePartPeers() {
+  std::unique_ptr<KVIterator> iter;
+  std::map<PartitionID, Peers> partRaftPeers;
+  static const std::string prefixStr = NebulaKeyUtils::systemPrefix();
+  auto retCode = this->prefix(prefixStr, &iter);
+  if (nebula::cpp2::ErrorCode::SUCCEEDED != retCode) {
+    return partRaftPeers;
+  }
+
+  for (; iter->valid(); iter->next()) {
+    auto key = iter->key();
+    if (!NebulaKeyUtils::isSystemBalance(key)) {
+      continue;
+    }
+    PartitionID partId = *reinterpret_cast<const PartitionID*>(key.data());
+    partRaftPeers.emplace(partId >> 8, Peers::fromString(iter->val().toString()));
+  }
+  return partRaftPeers;
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::ingest(const std::vector<std::string>& files,
+                                             bool verifyFileChecksum) {
+  UNUSED(verifyFileChecksum);
+  rocksdb::Options options;
+  for (const auto& file : files) {
+    rocksdb::SstFileReader reader(options);
+    auto status = reader.Open(file);
+    if (!status.ok()) {
+      LOG(WARNING) << "Open sst file " << file << " failed: " << status.ToString();
+      return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+    std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+    std::vector<MemoryWriteBatch::Op> ops;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ops.emplace_back(MemoryWriteBatch::Op{
+          MemoryWriteBatch::OpType::kPut, iter->key().ToString(), iter->value().ToString()});
+      if (ops.size() >= kIngestBatchSize) {
+        auto code = apply(ops);
+        if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+          return code;
+        }
+        ops.clear();
+      }
+    }
+    if (!iter->status().ok()) {
+      LOG(WARNING) << "Read sst file " << file << " failed: " << iter->status().ToString();
+      return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+    auto code = apply(ops);
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::setOption(const std::string& configKey,
+                                                const std::string& configValue) {
+  LOG(WARNING) << "The memory engine has no option " << configKey << "=" << configValue;
+  return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::setDBOption(const std::string& configKey,
+                                                  const std::string& configValue) {
+  LOG(WARNING) << "The memory engine has no db option " << configKey << "=" << configValue;
+  return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+}
+
+ErrorOr<nebula::cpp2::ErrorCode, std::string> MemoryEngine::getProperty(
+    const std::string& property) {
+  if (property == "rocksdb.estimate-num-keys") {
+    return folly::to<std::string>(numKeys_.load());
+  } else if (property == "memory.used-bytes") {
+    return folly::to<std::string>(usedBytes());
+  }
+  return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::compact() {
+  std::lock_guard<std::mutex> lk(writeLock_);
+  collectGarbage();
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+int64_t MemoryEngine::writeSst(const std::string& path, const Snapshot* snapshot) {
+  MemoryIter iter(this, snapshot, false, "", std::nullopt, "");
+  if (!iter.valid()) {
+    return 0;
+  }
+  rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), rocksdb::Options());
+  auto status = writer.Open(path);
+  int64_t count = 0;
+  for (; status.ok() && iter.valid(); iter.next()) {
+    status = writer.Put(rocksdb::Slice(iter.key().data(), iter.key().size()),
+                        rocksdb::Slice(iter.val().data(), iter.val().size()));
+    ++count;
+  }
+  if (status.ok()) {
+    status = writer.Finish();
+  }
+  if (!status.ok()) {
+    LOG(WARNING) << "Write " << path << " failed: " << status.ToString();
+    ::unlink(path.c_str());
+    return -1;
+  }
+  return count;
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::flush() {
+  std::lock_guard<std::mutex> lk(flushLock_);
+  const auto* snapshot = pin();
+  SCOPE_EXIT {
+    ReleaseSnapshot(snapshot);
+  };
+  auto tmpPath = sstPath_ + ".tmp";
+  auto count = writeSst(tmpPath, snapshot);
+  if (count < 0) {
+    return nebula::cpp2::ErrorCode::E_STORE_FAILURE;
+  }
+  if (count == 0) {
+    ::unlink(sstPath_.c_str());
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+  if (::rename(tmpPath.c_str(), sstPath_.c_str()) != 0) {
+    LOG(WARNING) << "Failed to rename " << tmpPath << " to " << sstPath_ << ", errno " << errno;
+    ::unlink(tmpPath.c_str());
+    return nebula::cpp2::ErrorCode::E_STORE_FAILURE;
+  }
+  VLOG(1) << "Checkpointed " << count << " keys of space " << spaceId_ << " to " << sstPath_;
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode MemoryEngine::createCheckpoint(const std::string& checkpointPath) {
+  LOG(INFO) << "Target checkpoint data path : " << checkpointPath;
+  if (FileUtils::exist(checkpointPath) && !FileUtils::remove(checkpointPath.data(), true)) {
+    LOG(WARNING) << "Remove exist checkpoint data dir failed: " << checkpointPath;
+    return nebula::cpp2::ErrorCode::E_STORE_FAILURE;
+  }
+
+  const auto* snapshot = pin();
+  SCOPE_EXIT {
+    ReleaseSnapshot(snapshot);
+  };
+  auto sstPath = checkpointPath + ".sst";
+  SCOPE_EXIT {
+    ::unlink(sstPath.c_str());
+  };
+  auto count = writeSst(sstPath, snapshot);
+  if (count < 0) {
+    return nebula::cpp2::ErrorCode::E_FAILED_TO_CHECKPOINT;
+  }
+
+  // The checkpoint is a rocksdb instance, the same as the one of RocksEngine
+  rocksdb::Options options;
+  options.create_if_missing = true;
+  rocksdb::DB* db = nullptr;
+  auto status = rocksdb::DB::Open(options, checkpointPath, &db);
+  if (!status.ok()) {
+    LOG(WARNING) << "Create checkpoint Failed: " << status.ToString();
+    return nebula::cpp2::ErrorCode::E_FAILED_TO_CHECKPOINT;
+  }
+  std::unique_ptr<rocksdb::DB> guard(db);
+  if (count > 0) {
+    rocksdb::IngestExternalFileOptions ingestOptions;
+    ingestOptions.move_files = true;
+    status = db->IngestExternalFile({sstPath}, ingestOptions);
+    if (!status.ok()) {
+      LOG(WARNING) << "Create checkpoint Failed: " << status.ToString();
+      return nebula::cpp2::ErrorCode::E_FAILED_TO_CHECKPOINT;
+    }
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+ErrorOr<nebula::cpp2::ErrorCode, std::string> MemoryEngine::backupTable(
+    const std::string& path,
+    const std::string& tablePrefix,
+    std::function<bool(const folly::StringPiece& key)> filter) {
+  UNUSED(path);
+  UNUSED(tablePrefix);
+  UNUSED(filter);
+  LOG(WARNING) << "Backing up the tables of the memory engine is not supported";
+  return nebula::cpp2::ErrorCode::E_UNSUPPORTED;
+}
+
+}  // namespace kvstore
+}  // namespace nebula
@@ -0,0 +1,372 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef KVSTORE_MEMORYENGINE_H_
+#define KVSTORE_MEMORYENGINE_H_
+
+#include <folly/ConcurrentSkipList.h>
+#include <folly/SharedMutex.h>
+#include <rocksdb/merge_operator.h>
+
+#include <optional>
+
+#include "common/base/Base.h"
+#include "common/memory/MemoryTracker.h"
+#include "kvstore/KVEngine.h"
+#include "kvstore/KVIterator.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * @brief The operations of a batch, applied by MemoryEngine as a whole
+ */
+class MemoryWriteBatch : public WriteBatch {
+ public:
+  enum class OpType : uint8_t { kPut, kRemove, kRemoveRange, kMerge };
+
+  struct Op {
+    OpType type;
+    std::string key;
+    // The end of kRemoveRange, or the operand of kMerge
+    std::string value;
+  };
+
+  nebula::cpp2::ErrorCode put(folly::StringPiece key, folly::StringPiece value) override {
+    ops_.emplace_back(Op{OpType::kPut, key.str(), value.str()});
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+  nebula::cpp2::ErrorCode remove(folly::StringPiece key) override {
+    ops_.emplace_back(Op{OpType::kRemove, key.str(), ""});
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+  nebula::cpp2::ErrorCode removeRange(folly::StringPiece start, folly::StringPiece end) override {
+    ops_.emplace_back(Op{OpType::kRemoveRange, start.str(), end.str()});
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+  nebula::cpp2::ErrorCode merge(folly::StringPiece key, folly::StringPiece operand) override {
+    ops_.emplace_back(Op{OpType::kMerge, key.str(), operand.str()});
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+  nebula::cpp2::ErrorCode iterate(const Visitor& visitor) override {
+    for (const auto& op : ops_) {
+      switch (op.type) {
+        case OpType::kPut:
+          visitor(BatchLogType::OP_BATCH_PUT, op.key, op.value);
+          break;
+        case OpType::kRemove:
+          visitor(BatchLogType::OP_BATCH_REMOVE, op.key, op.value);
+          break;
+        case OpType::kRemoveRange:
+          visitor(BatchLogType::OP_BATCH_REMOVE_RANGE, op.key, op.value);
+          break;
+        case OpType::kMerge:
+          visitor(BatchLogType::OP_BATCH_MERGE, op.key, op.value);
+          break;
+      }
+    }
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+  const std::vector<Op>& ops() const {
+    return ops_;
+  }
+
+ private:
+  std::vector<Op> ops_;
+};
+
+/**
+ * MemoryEngine keeps all the data of a space in memory, for the small and hot spaces which don't
+ * gain from the block cache and the LSM tree of rocksdb, e.g. the sessions or the features read
+ * and written all the time.
+ *
+ * The data is kept in a concurrent skiplist of the versions of the keys, ordered by the key and
+ * then from the newest version. Each batch is written as new versions with increasing sequences
+ * and published at once by moving the visible sequence, so the reads see the whole batch or
+ * nothing without locking the writes. A snapshot or an iterator reads the versions not after its
+ * sequence, and the versions no reader sees are collected once there are as many shadowed versions
+ * as the live keys.
+ *
+ * The memory of the versions is charged to a tracker under the process one. The writes are
+ * rejected before being proposed once the data uses up memory_engine_capacity_mb, the ones
+ * committed are always applied. The data is checkpointed into an sst file by flush(), which is
+ * done before the wal is cleaned and when the engine stops, and loaded when the engine is opened
+ * again, the logs after it are replayed by raft as usual.
+ */
+class MemoryEngine : public KVEngine {
+ public:
+  /**
+   * @brief Construct a new MemoryEngine, load the checkpoint if any
+   *
+   * @param spaceId
+   * @param vIdLen Vertex id length, unused
+   * @param dataPath The checkpoint is kept in the same path as the rocksdb engine
+   * @param walPath Wal path of the parts
+   * @param mergeOp The merge operator, the same as the one of rocksdb
+   * @param dedicatedPart The only part of the engine if not 0
+   */
+  MemoryEngine(GraphSpaceID spaceId,
+               int32_t vIdLen,
+               const std::string& dataPath,
+               const std::string& walPath = "",
+               std::shared_ptr<rocksdb::MergeOperator> mergeOp = nullptr,
+               PartitionID dedicatedPart = 0);
+
+  /**
+   * @brief Checkpoint the data
+   */
+  void stop() override;
+
+  const char* getDataRoot() const override {
+    return dataPath_.c_str();
+  }
+
+  const char* getWalRoot() const override {
+    return walPath_.c_str();
+  }
+
+  PartitionID dedicatedPart() const override {
+    return dedicatedPart_;
+  }
+
+  std::unique_ptr<WriteBatch> startBatchWrite() override {
+    return std::make_unique<MemoryWriteBatch>();
+  }
+
+  /**
+   * @brief The write is rejected once the data uses up memory_engine_capacity_mb
+   */
+  nebula::cpp2::ErrorCode admitWrite(size_t bytes) override;
+
+  /**
+   * @brief Apply the batch as a whole, the options of rocksdb are ignored
+   */
+  nebula::cpp2::ErrorCode commitBatchWrite(std::unique_ptr<WriteBatch> batch,
+                                           bool disableWAL,
+                                           bool sync,
+                                           bool wait) override;
+
+  /**
+   * @brief Pin the versions visible now until the snapshot is released
+   */
+  const void* GetSnapshot() override;
+
+  void ReleaseSnapshot(const void* snapshot) override;
+
+  nebula::cpp2::ErrorCode get(const std::string& key,
+                              std::string* value,
+                              const void* snapshot = nullptr) override;
+
+  std::vector<Status> multiGet(const std::vector<std::string>& keys,
+                               std::vector<std::string>* values) override;
+
+  nebula::cpp2::ErrorCode range(const std::string& start,
+                                const std::string& end,
+                                std::unique_ptr<KVIterator>* iter,
+                                const void* snapshot = nullptr) override;
+
+  nebula::cpp2::ErrorCode prefix(const std::string& prefix,
+                                 std::unique_ptr<KVIterator>* iter,
+                                 const void* snapshot = nullptr) override;
+
+  nebula::cpp2::ErrorCode rangeWithPrefix(const std::string& start,
+                                          const std::string& prefix,
+                                          std::unique_ptr<KVIterator>* iter) override;
+
+  nebula::cpp2::ErrorCode scan(std::unique_ptr<KVIterator>* storageIter) override;
+
+  nebula::cpp2::ErrorCode put(std::string key, std::string value) override;
+
+  nebula::cpp2::ErrorCode multiPut(std::vector<KV> keyValues) override;
+
+  nebula::cpp2::ErrorCode remove(const std::string& key) override;
+
+  nebula::cpp2::ErrorCode multiRemove(std::vector<std::string> keys) override;
+
+  nebula::cpp2::ErrorCode removeRange(const std::string& start, const std::string& end) override;
+
+  void addPart(PartitionID partId, const Peers& raftPeers) override;
+
+  nebula::cpp2::ErrorCode updatePart(PartitionID partId, const Peer& raftPeer) override;
+
+  void removePart(PartitionID partId) override;
+
+  std::vector<PartitionID> allParts() override;
+
+  std::map<PartitionID, Peers> balancePartPeers() override;
+
+  int32_t totalPartsNum() override {
+    return partsNum_;
+  }
+
+  /**
+   * @brief Load the keys of the sst files
+   */
+  nebula::cpp2::ErrorCode ingest(const std::vector<std::string>& files,
+                                 bool verifyFileChecksum = false) override;
+
+  /**
+   * @brief There is no option of rocksdb to set
+   */
+  nebula::cpp2::ErrorCode setOption(const std::string& configKey,
+                                    const std::string& configValue) override;
+
+  nebula::cpp2::ErrorCode setDBOption(const std::string& configKey,
+                                      const std::string& configValue) override;
+
+  /**
+   * @brief Only the number of the keys and the memory used are there, as
+   * "rocksdb.estimate-num-keys" and "memory.used-bytes"
+   */
+  ErrorOr<nebula::cpp2::ErrorCode, std::string> getProperty(const std::string& property) override;
+
+  /**
+   * @brief Collect the versions no longer read
+   */
+  nebula::cpp2::ErrorCode compact() override;
+
+  nebula::cpp2::ErrorCode compactRange(const std::string& start, const std::string& end) override {
+    UNUSED(start);
+    UNUSED(end);
+    return compact();
+  }
+
+  std::vector<std::pair<std::string, std::string>> tombstoneRanges(double ratio) override {
+    UNUSED(ratio);
+    return {};
+  }
+
+  /**
+   * @brief Checkpoint the data into the sst file in the data path
+   */
+  nebula::cpp2::ErrorCode flush() override;
+
+  /**
+   * @brief Create a rocksdb checkpoint of the data in the path, the same as the one of RocksEngine
+   */
+  nebula::cpp2::ErrorCode createCheckpoint(const std::string& checkpointPath) override;
+
+  ErrorOr<nebula::cpp2::ErrorCode, std::string> backupTable(
+      const std::string& path,
+      const std::string& tablePrefix,
+      std::function<bool(const folly::StringPiece& key)> filter) override;
+
+  nebula::cpp2::ErrorCode backup() override {
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+  /**
+   * @brief The memory charged for the data
+   */
+  int64_t usedBytes() const {
+    return tracker_->used();
+  }
+
+  // A version of a key, which is a tombstone if deleted
+  struct Entry {
+    std::string key;
+    uint64_t seq{0};
+    std::string value;
+    bool deleted{false};
+  };
+
+  // By the key, then from the newest version
+  struct EntryComparator {
+    bool operator()(const Entry& lhs, const Entry& rhs) const {
+      auto cmp = lhs.key.compare(rhs.key);
+      return cmp != 0 ? cmp < 0 : lhs.seq > rhs.seq;
+    }
+  };
+
+  using SkipList = folly::ConcurrentSkipList<Entry, EntryComparator>;
+
+  // The sequence pinned by a snapshot or an iterator
+  struct Snapshot {
+    uint64_t seq{0};
+    std::multiset<uint64_t>::iterator pin;
+  };
+
+ private:
+  friend class MemoryIter;
+
+  nebula::cpp2::ErrorCode apply(const std::vector<MemoryWriteBatch::Op>& ops);
+
+  /**
+   * @brief Pin the sequence visible now, which must be released by ReleaseSnapshot
+   */
+  const Snapshot* pin();
+
+  /**
+   * @brief Iterate the keys from the start before the end which start with the prefix, the
+   * snapshot is pinned by the iterator if not given
+   */
+  nebula::cpp2::ErrorCode newIter(std::string start,
+                                  std::optional<std::string> end,
+                                  std::string prefix,
+                                  const void* snapshot,
+                                  std::unique_ptr<KVIterator>* iter);
+
+  /**
+   * @brief The version of the key visible at the sequence, nullptr if it's not there
+   */
+  const Entry* find(const SkipList::Accessor& accessor,
+                    const std::string& key,
+                    uint64_t seq) const;
+
+  /**
+   * @brief Remove the versions shadowed for all the readers, called with writeLock_ held
+   */
+  void collectGarbage();
+
+  /**
+   * @brief Write the data visible in the snapshot into the sst file, nothing is written if empty
+   *
+   * @return int64_t The number of the keys written, -1 if failed
+   */
+  int64_t writeSst(const std::string& path, const Snapshot* snapshot);
+
+  void load();
+
+  static int64_t bytesOf(const Entry& entry);
+
+ private:
+  PartitionID dedicatedPart_;
+  std::string dataPath_;
+  std::string walPath_;
+  // The checkpoint file
+  std::string sstPath_;
+  std::shared_ptr<rocksdb::MergeOperator> mergeOp_;
+  std::shared_ptr<MemoryTracker> tracker_;
+  // The bytes of the data to admit writes, no limit if it's not positive
+  int64_t capacity_{0};
+  std::shared_ptr<SkipList> list_;
+
+  // The writes are applied one by one
+  std::mutex writeLock_;
+  uint64_t lastSeq_{0};
+  std::atomic<uint64_t> visibleSeq_{0};
+  // The versions shadowed by the newer ones or the tombstones since the last collection
+  int64_t garbage_{0};
+  std::atomic<int64_t> numKeys_{0};
+
+  // The reads without a pinned sequence are done under the shared lock, so the versions they read
+  // are not collected meanwhile
+  folly::SharedMutex gcLock_;
+  std::mutex pinLock_;
+  std::multiset<uint64_t> pins_;
+
+  std::mutex flushLock_;
+  int32_t partsNum_{0};
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+
+#endif  // KVSTORE_MEMORYENGINE_H_
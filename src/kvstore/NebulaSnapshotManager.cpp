@@ -13,17 +13,27 @@ DEFINE_uint32(snapshot_part_rate_limit,
               1024 * 1024 * 10,
               "max bytes of pulling snapshot for each partition in one second");
 DEFINE_uint32(snapshot_batch_size, 1024 * 512, "batch size for snapshot, in bytes");
+DEFINE_int64(snapshot_host_rate_limit,
+             0,
+             "max bytes of sending snapshot for all partitions on this host in one second, the "
+             "parts are sent in parallel by snapshot_worker_threads, 0 means no limit. It could be "
+             "changed at runtime");
 
 namespace nebula {
 namespace kvstore {
 
 const int32_t kReserveNum = 1024 * 4;
 
-NebulaSnapshotManager::NebulaSnapshotManager(NebulaStore* kv) : store_(kv) {
+NebulaSnapshotManager::NebulaSnapshotManager(NebulaStore* kv)
+    : store_(kv) {
   // Snapshot rate is limited to FLAGS_snapshot_worker_threads * FLAGS_snapshot_part_rate_limit.
   // So by default, the total send rate is limited to 4 * 10Mb = 40Mb.
   LOG(INFO) << "Send snapshot is rate limited to " << FLAGS_snapshot_part_rate_limit
             << " for each part by default";
+  if (FLAGS_snapshot_host_rate_limit > 0) {
+    LOG(INFO) << "Send snapshot is rate limited to " << FLAGS_snapshot_host_rate_limit
+              << " for all parts";
+  }
 }
 
 void NebulaSnapshotManager::accessAllRowsInSnapshot(GraphSpaceID spaceId,
@@ -122,6 +132,8 @@ bool NebulaSnapshotManager::accessTable(GraphSpaceID spaceId,
       rateLimiter->consume(static_cast<double>(batchSize),                        // toConsume
                            static_cast<double>(FLAGS_snapshot_part_rate_limit),   // rate
                            static_cast<double>(FLAGS_snapshot_part_rate_limit));  // burstSize
+      // All parts sending snapshot share the budget of the host
+      BackgroundIoLimiter::instance()->consume(IoClass::kSnapshot, batchSize);
       if (cb(commitLogId,
              commitLogTerm,
              data,
@@ -14,18 +14,46 @@
 #include "common/fs/FileUtils.h"
 #include "common/network/NetworkUtils.h"
 #include "common/time/WallClock.h"
+#include "common/utils/MetaKeyUtils.h"
 #include "common/utils/NebulaKeyUtils.h"
+#include "kvstore/MemoryEngine.h"
 #include "kvstore/NebulaSnapshotManager.h"
 #include "kvstore/RocksEngine.h"
-
-DEFINE_string(engine_type, "rocksdb", "rocksdb, memory...");
+#include "kvstore/RocksEngineConfig.h"
+#include "kvstore/stats/KVStats.h"
+
+DEFINE_string(engine_type,
+              "rocksdb",
+              "The engine of the spaces, rocksdb or memory, the latter keeps all the data of the "
+              "spaces in memory");
+DEFINE_string(memory_engine_spaces,
+              "",
+              "The spaces kept in memory whatever the engine_type is, which are small and hot, "
+              "separated by comma, e.g. \"1,5\"");
 DEFINE_int32(custom_filter_interval_secs,
              24 * 3600,
              "interval to trigger custom compaction, < 0 means always do "
              "default minor compaction");
 DEFINE_int32(num_workers, 4, "Number of worker threads");
 DEFINE_int32(clean_wal_interval_secs, 600, "interval to trigger clean expired wal");
+DEFINE_int32(memtable_stats_interval_secs,
+             10,
+             "interval to report the memory usage of the memtables of all the spaces");
 DEFINE_bool(auto_remove_invalid_space, true, "whether remove data of invalid space when restart");
+DEFINE_bool(engine_per_part,
+            false,
+            "Whether to open an engine for each part, so that the compaction of a part doesn't "
+            "rewrite the data of others, and a removed part is dropped with its directory. The "
+            "engines opened before are still loaded after it's changed");
+DEFINE_int32(drop_engine_delay_secs,
+             60,
+             "Seconds to wait before closing the engine of a removed part, so that the reads "
+             "still using the engine or its iterators finish first");
+
+DEFINE_int32(metrics_max_part_series,
+             1000,
+             "The max number of parts whose raft state is exported as metrics of each part, the "
+             "metrics of each space are exported regardless");
 
 DECLARE_bool(rocksdb_disable_wal);
 DECLARE_int32(rocksdb_backup_interval_secs);
@@ -34,7 +62,28 @@ DECLARE_int32(wal_ttl);
 namespace nebula {
 namespace kvstore {
 
+namespace {
+
+// Whether the data of the space is kept by MemoryEngine
+bool inMemory(GraphSpaceID spaceId) {
+  if (FLAGS_engine_type == "memory") {
+    return true;
+  }
+  std::vector<folly::StringPiece> spaces;
+  folly::split(",", FLAGS_memory_engine_spaces, spaces, true);
+  for (auto space : spaces) {
+    auto id = folly::tryTo<GraphSpaceID>(folly::trimWhitespace(space));
+    if (id.hasValue() && id.value() == spaceId) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 NebulaStore::~NebulaStore() {
+  stats::StatsManager::removeGauges(gaugesOwner());
   stop();
   LOG(INFO) << "Cut off the relationship with meta client";
   options_.partMan_.reset();
@@ -75,8 +124,14 @@ bool NebulaStore::init() {
   storeWorker_->addDelayTask(FLAGS_clean_wal_interval_secs * 1000, &NebulaStore::cleanWAL, this);
   storeWorker_->addRepeatTask(
       FLAGS_rocksdb_backup_interval_secs * 1000, &NebulaStore::backup, this);
+  storeWorker_->addRepeatTask(
+      FLAGS_memtable_stats_interval_secs * 1000, &NebulaStore::reportMemtableStats, this);
   LOG(INFO) << "Register handler...";
   options_.partMan_->registerHandler(this);
+  stats::StatsManager::registerGauges(
+      gaugesOwner(), [this](std::vector<stats::StatsManager::Gauge>& gauges) {
+        collectGauges(gauges);
+      });
   return true;
 }
 
@@ -84,187 +139,221 @@ void NebulaStore::loadPartFromDataPath() {
   CHECK(!!options_.partMan_);
   LOG(INFO) << "Scan the local path, and init the spaces_";
   // avoid duplicate engine created
-  std::unordered_set<std::pair<GraphSpaceID, PartitionID>> partSet;
+  folly::Synchronized<std::unordered_set<std::pair<GraphSpaceID, PartitionID>>> partSet;
+  // The data paths are on different disks usually, so they are loaded in parallel
+  std::vector<std::thread> loaders;
   for (auto& path : options_.dataPaths_) {
-    auto rootPath = folly::stringPrintf("%s/nebula", path.c_str());
-    auto dirs = fs::FileUtils::listAllDirsInDir(rootPath.c_str());
-    for (auto& dir : dirs) {
-      LOG(INFO) << "Scan path \"" << rootPath << "/" << dir << "\"";
+    loaders.emplace_back([this, &path, &partSet] { loadDataPath(path, partSet); });
+  }
+  for (auto& loader : loaders) {
+    loader.join();
+  }
+}
+
+void NebulaStore::loadDataPath(
+    const std::string& path,
+    folly::Synchronized<std::unordered_set<std::pair<GraphSpaceID, PartitionID>>>& partSet) {
+  auto rootPath = folly::stringPrintf("%s/nebula", path.c_str());
+  auto dirs = fs::FileUtils::listAllDirsInDir(rootPath.c_str());
+  for (auto& dir : dirs) {
+    LOG(INFO) << "Scan path \"" << rootPath << "/" << dir << "\"";
+    try {
+      GraphSpaceID spaceId;
       try {
-        GraphSpaceID spaceId;
+        spaceId = folly::to<GraphSpaceID>(dir);
+      } catch (const std::exception& ex) {
+        LOG(ERROR) << folly::sformat("Data path {} invalid {}", dir, ex.what());
+        continue;
+      }
+
+      if (spaceId == 0) {
+        // skip the system space, only handle data space here.
+        continue;
+      }
+
+      loadEngine(spaceId, newEngine(spaceId, path, options_.walPath_), partSet);
+      // The engines dedicated to a part
+      auto partsDir = folly::stringPrintf("%s/%s/parts", rootPath.c_str(), dir.c_str());
+      auto partDirs = fs::FileUtils::exist(partsDir)
+                          ? fs::FileUtils::listAllDirsInDir(partsDir.c_str())
+                          : std::vector<std::string>();
+      for (auto& partDir : partDirs) {
+        PartitionID partId;
         try {
-          spaceId = folly::to<GraphSpaceID>(dir);
+          partId = folly::to<PartitionID>(partDir);
         } catch (const std::exception& ex) {
-          LOG(ERROR) << folly::sformat("Data path {} invalid {}", dir, ex.what());
+          LOG(ERROR) << folly::sformat("Part path {} invalid {}", partDir, ex.what());
           continue;
         }
+        loadEngine(spaceId, newEngine(spaceId, path, options_.walPath_, partId), partSet);
+      }
+      LOG(INFO) << "Load space " << spaceId << " complete";
+    } catch (std::exception& e) {
+      LOG(FATAL) << "Invalid data directory \"" << dir << "\"";
+    }
+  }
+}
 
-        if (spaceId == 0) {
-          // skip the system space, only handle data space here.
-          continue;
-        }
+void NebulaStore::loadEngine(
+    GraphSpaceID spaceId,
+    std::unique_ptr<KVEngine> engine,
+    folly::Synchronized<std::unordered_set<std::pair<GraphSpaceID, PartitionID>>>& partSet) {
+  std::map<PartitionID, Peers> partRaftPeers;
 
-        auto engine = newEngine(spaceId, path, options_.walPath_);
-        std::map<PartitionID, Peers> partRaftPeers;
+  // load balancing part info which persisted to local engine.
+  for (auto& [partId, raftPeers] : engine->balancePartPeers()) {
+    CHECK_NE(raftPeers.size(), 0);
 
-        // load balancing part info which persisted to local engine.
-        for (auto& [partId, raftPeers] : engine->balancePartPeers()) {
-          CHECK_NE(raftPeers.size(), 0);
+    if (raftPeers.isExpired()) {
+      LOG(INFO) << "Space: " << spaceId << ", part:" << partId
+                << " balancing info expired, ignore it.";
+      continue;
+    }
 
-          if (raftPeers.isExpired()) {
-            LOG(INFO) << "Space: " << spaceId << ", part:" << partId
-                      << " balancing info expired, ignore it.";
-            continue;
+    auto spacePart = std::make_pair(spaceId, partId);
+    if (partSet.wlock()->emplace(spacePart).second) {
+      // join the balancing peers with meta peers
+      auto metaStatus = options_.partMan_->partMeta(spaceId, partId);
+      if (!metaStatus.ok()) {
+        LOG(INFO) << "Space: " << spaceId << "; partId: " << partId
+                  << " does not exist in part manager when join balancing.";
+      } else {
+        auto partMeta = metaStatus.value();
+        for (auto& h : partMeta.hosts_) {
+          auto raftAddr = getRaftAddr(h);
+          if (!raftPeers.exist(raftAddr)) {
+            VLOG(1) << "Add raft peer " << raftAddr;
+            raftPeers.addOrUpdate(Peer(raftAddr));
           }
+        }
+      }
 
-          auto spacePart = std::make_pair(spaceId, partId);
-          if (partSet.find(spacePart) == partSet.end()) {
-            partSet.emplace(std::make_pair(spaceId, partId));
-
-            // join the balancing peers with meta peers
-            auto metaStatus = options_.partMan_->partMeta(spaceId, partId);
-            if (!metaStatus.ok()) {
-              LOG(INFO) << "Space: " << spaceId << "; partId: " << partId
-                        << " does not exist in part manager when join balancing.";
-            } else {
-              auto partMeta = metaStatus.value();
-              for (auto& h : partMeta.hosts_) {
-                auto raftAddr = getRaftAddr(h);
-                if (!raftPeers.exist(raftAddr)) {
-                  VLOG(1) << "Add raft peer " << raftAddr;
-                  raftPeers.addOrUpdate(Peer(raftAddr));
-                }
-              }
-            }
+      partRaftPeers.emplace(partId, raftPeers);
+    }
+  }
 
-            partRaftPeers.emplace(partId, raftPeers);
-          }
-        }
+  // load normal part ids which persisted to local engine.
+  for (auto& partId : engine->allParts()) {
+    // first priority: balancing
+    bool inBalancing = partRaftPeers.find(partId) != partRaftPeers.end();
+    if (inBalancing) {
+      continue;
+    }
 
-        // load normal part ids which persisted to local engine.
-        for (auto& partId : engine->allParts()) {
-          // first priority: balancing
-          bool inBalancing = partRaftPeers.find(partId) != partRaftPeers.end();
-          if (inBalancing) {
-            continue;
-          }
+    // second priority: meta
+    if (!options_.partMan_->partExist(storeSvcAddr_, spaceId, partId).ok()) {
+      LOG(INFO)
+          << "Part " << partId
+          << " is not in balancing and does not exist in meta any more, will remove it!";
+      engine->removePart(partId);
+      continue;
+    }
 
-          // second priority: meta
-          if (!options_.partMan_->partExist(storeSvcAddr_, spaceId, partId).ok()) {
-            LOG(INFO)
-                << "Part " << partId
-                << " is not in balancing and does not exist in meta any more, will remove it!";
-            engine->removePart(partId);
-            continue;
-          }
+    auto spacePart = std::make_pair(spaceId, partId);
+    if (partSet.wlock()->emplace(spacePart).second) {
+      // fill the peers
+      auto metaStatus = options_.partMan_->partMeta(spaceId, partId);
+      CHECK(metaStatus.ok());
+      auto partMeta = metaStatus.value();
+      Peers peers;
+      for (auto& h : partMeta.hosts_) {
+        VLOG(1) << "Add raft peer " << getRaftAddr(h);
+        peers.addOrUpdate(Peer(getRaftAddr(h)));
+      }
+      partRaftPeers.emplace(partId, peers);
+    }
+  }
 
-          auto spacePart = std::make_pair(spaceId, partId);
-          if (partSet.find(spacePart) == partSet.end()) {
-            partSet.emplace(spacePart);
-
-            // fill the peers
-            auto metaStatus = options_.partMan_->partMeta(spaceId, partId);
-            CHECK(metaStatus.ok());
-            auto partMeta = metaStatus.value();
-            Peers peers;
-            for (auto& h : partMeta.hosts_) {
-              VLOG(1) << "Add raft peer " << getRaftAddr(h);
-              peers.addOrUpdate(Peer(getRaftAddr(h)));
+  // there is no valid part in this engine, remove it
+  if (partRaftPeers.empty()) {
+    std::string engineDir = engine->getDataRoot();
+    bool dedicated = engine->dedicatedPart() != 0;
+    engine.reset();  // close engine
+    if (dedicated) {
+      // The part has been removed
+      removeSpaceDir(engineDir);
+    } else if (!options_.partMan_->spaceExist(storeSvcAddr_, spaceId).ok()) {
+      if (FLAGS_auto_remove_invalid_space) {
+        removeSpaceDir(engineDir);
+      }
+    }
+    return;
+  }
+
+  // add to spaces
+  KVEngine* enginePtr = nullptr;
+  {
+    folly::RWSpinLock::WriteHolder wh(&lock_);
+    auto spaceIt = this->spaces_.find(spaceId);
+    if (spaceIt == this->spaces_.end()) {
+      LOG(INFO) << "Load space " << spaceId << " from disk";
+      spaceIt = this->spaces_.emplace(spaceId, std::make_unique<SpacePartInfo>()).first;
+    }
+    spaceIt->second->engines_.emplace_back(std::move(engine));
+    enginePtr = spaceIt->second->engines_.back().get();
+  }
+
+  std::atomic<size_t> counter(partRaftPeers.size());
+  folly::Baton<true, std::atomic> baton;
+  LOG(INFO) << "Need to open " << partRaftPeers.size() << " parts of space " << spaceId;
+  for (auto& it : partRaftPeers) {
+    auto& partId = it.first;
+    Peers& raftPeers = it.second;
+
+    bgWorkers_->addTask(
+        [spaceId, partId, &raftPeers, enginePtr, &counter, &baton, this]() mutable {
+          // create part
+          bool isLearner = false;
+          std::vector<HostAddr> addrs;  // raft peers
+          for (auto& [addr, raftPeer] : raftPeers.getPeers()) {
+            if (addr == raftAddr_) {  // self
+              if (raftPeer.status == Peer::Status::kLearner) {
+                isLearner = true;
+              }
+            } else {  // others
+              if (raftPeer.status == Peer::Status::kNormalPeer ||
+                  raftPeer.status == Peer::Status::kPromotedPeer) {
+                addrs.emplace_back(addr);
+              }
             }
-            partRaftPeers.emplace(partId, peers);
           }
-        }
+          auto part = newPart(spaceId, partId, enginePtr, isLearner, addrs);
+          LOG(INFO) << "Load part " << spaceId << ", " << partId << " from disk";
+
+          // add learner peers
+          if (!isLearner) {
+            for (auto& [addr, raftPeer] : raftPeers.getPeers()) {
+              if (addr == raftAddr_) {
+                continue;
+              }
 
-        // there is no valid part in this engine, remove it
-        if (partRaftPeers.empty()) {
-          engine.reset();  // close engine
-          if (!options_.partMan_->spaceExist(storeSvcAddr_, spaceId).ok()) {
-            if (FLAGS_auto_remove_invalid_space) {
-              auto spaceDir = folly::stringPrintf("%s/%s", rootPath.c_str(), dir.c_str());
-              removeSpaceDir(spaceDir);
+              if (raftPeer.status == Peer::Status::kLearner) {
+                part->addLearner(addr, true);
+              }
             }
           }
-          continue;
-        }
 
-        // add to spaces
-        KVEngine* enginePtr = nullptr;
-        {
-          folly::RWSpinLock::WriteHolder wh(&lock_);
-          auto spaceIt = this->spaces_.find(spaceId);
-          if (spaceIt == this->spaces_.end()) {
-            LOG(INFO) << "Load space " << spaceId << " from disk";
-            spaceIt = this->spaces_.emplace(spaceId, std::make_unique<SpacePartInfo>()).first;
+          // add part to space
+          {
+            folly::RWSpinLock::WriteHolder holder(&lock_);
+            auto iter = spaces_.find(spaceId);
+            CHECK(iter != spaces_.end());
+            // Check if part already exists.
+            // Prevent the same part from existing on different dataPaths.
+            auto ret = iter->second->parts_.emplace(partId, part);
+            if (!ret.second) {
+              LOG(FATAL) << "Part already exists, partId " << partId;
+            }
           }
-          spaceIt->second->engines_.emplace_back(std::move(engine));
-          enginePtr = spaceIt->second->engines_.back().get();
-        }
-
-        std::atomic<size_t> counter(partRaftPeers.size());
-        folly::Baton<true, std::atomic> baton;
-        LOG(INFO) << "Need to open " << partRaftPeers.size() << " parts of space " << spaceId;
-        for (auto& it : partRaftPeers) {
-          auto& partId = it.first;
-          Peers& raftPeers = it.second;
-
-          bgWorkers_->addTask(
-              [spaceId, partId, &raftPeers, enginePtr, &counter, &baton, this]() mutable {
-                // create part
-                bool isLearner = false;
-                std::vector<HostAddr> addrs;  // raft peers
-                for (auto& [addr, raftPeer] : raftPeers.getPeers()) {
-                  if (addr == raftAddr_) {  // self
-                    if (raftPeer.status == Peer::Status::kLearner) {
-                      isLearner = true;
-                    }
-                  } else {  // others
-                    if (raftPeer.status == Peer::Status::kNormalPeer ||
-                        raftPeer.status == Peer::Status::kPromotedPeer) {
-                      addrs.emplace_back(addr);
-                    }
-                  }
-                }
-                auto part = newPart(spaceId, partId, enginePtr, isLearner, addrs);
-                LOG(INFO) << "Load part " << spaceId << ", " << partId << " from disk";
-
-                // add learner peers
-                if (!isLearner) {
-                  for (auto& [addr, raftPeer] : raftPeers.getPeers()) {
-                    if (addr == raftAddr_) {
-                      continue;
-                    }
-
-                    if (raftPeer.status == Peer::Status::kLearner) {
-                      part->addLearner(addr, true);
-                    }
-                  }
-                }
-
-                // add part to space
-                {
-                  folly::RWSpinLock::WriteHolder holder(&lock_);
-                  auto iter = spaces_.find(spaceId);
-                  CHECK(iter != spaces_.end());
-                  // Check if part already exists.
-                  // Prevent the same part from existing on different dataPaths.
-                  auto ret = iter->second->parts_.emplace(partId, part);
-                  if (!ret.second) {
-                    LOG(FATAL) << "Part already exists, partId " << partId;
-                  }
-                }
-                counter.fetch_sub(1);
-                if (counter.load() == 0) {
-                  baton.post();
-                }
-              });
-        }
-        baton.wait();
-        LOG(INFO) << "Load space " << spaceId << " complete";
-      } catch (std::exception& e) {
-        LOG(FATAL) << "Invalid data directory \"" << dir << "\"";
-      }
-    }
+          counter.fetch_sub(1);
+          if (counter.load() == 0) {
+            baton.post();
+          }
+        });
   }
+  baton.wait();
+  LOG(INFO) << "Load engine " << enginePtr->getDataRoot() << " of space " << spaceId
+            << " complete";
 }
 
 void NebulaStore::loadPartFromPartManager() {
@@ -331,15 +420,38 @@ void NebulaStore::stop() {
 
 std::unique_ptr<KVEngine> NebulaStore::newEngine(GraphSpaceID spaceId,
                                                  const std::string& dataPath,
-                                                 const std::string& walPath) {
-  if (FLAGS_engine_type == "rocksdb") {
+                                                 const std::string& walPath,
+                                                 PartitionID dedicatedPart) {
+  // The engine doesn't load the data kept by the other kind, e.g. the space is switched to be
+  // kept in memory after being written into rocksdb
+  auto root = folly::stringPrintf("%s/nebula/%d", dataPath.c_str(), spaceId) +
+              (dedicatedPart == 0 ? "" : folly::stringPrintf("/parts/%d", dedicatedPart));
+  auto rocksData = folly::stringPrintf("%s/data/CURRENT", root.c_str());
+  auto memoryData = folly::stringPrintf("%s/memory/data.sst", root.c_str());
+  // The meta data is always kept by rocksdb
+  if (spaceId != kDefaultSpaceId && inMemory(spaceId)) {
+    if (fs::FileUtils::exist(rocksData)) {
+      LOG(FATAL) << "The data of space " << spaceId << " in " << root
+                 << " is kept by rocksdb, it could not be loaded into memory";
+    }
+    return std::make_unique<MemoryEngine>(spaceId,
+                                          getSpaceVidLen(spaceId),
+                                          dataPath,
+                                          walPath,
+                                          options_.mergeOp_,
+                                          dedicatedPart);
+  } else if (FLAGS_engine_type == "rocksdb" || FLAGS_engine_type == "memory") {
+    if (fs::FileUtils::exist(memoryData) && !fs::FileUtils::exist(rocksData)) {
+      LOG(FATAL) << "The data of space " << spaceId << " in " << root
+                 << " is kept in memory, add it into memory_engine_spaces to load it";
+    }
     std::shared_ptr<KVCompactionFilterFactory> cfFactory = nullptr;
     if (options_.cffBuilder_ != nullptr) {
       cfFactory = options_.cffBuilder_->buildCfFactory(spaceId);
     }
     auto vIdLen = getSpaceVidLen(spaceId);
     return std::make_unique<RocksEngine>(
-        spaceId, vIdLen, dataPath, walPath, options_.mergeOp_, cfFactory);
+        spaceId, vIdLen, dataPath, walPath, options_.mergeOp_, cfFactory, false, dedicatedPart);
   } else {
     LOG(FATAL) << "Unknown engine type " << FLAGS_engine_type;
     return nullptr;
@@ -361,6 +473,25 @@ ErrorOr<nebula::cpp2::ErrorCode, HostAddr> NebulaStore::partLeader(GraphSpaceID
   return getStoreAddr(partIt->second->leader());
 }
 
+bool NebulaStore::followerReadable(GraphSpaceID spaceId,
+                                   PartitionID partId,
+                                   int64_t maxStalenessMs) {
+  auto ret = part(spaceId, partId);
+  if (!ok(ret)) {
+    return false;
+  }
+  return nebula::value(ret)->followerReadable(maxStalenessMs);
+}
+
+folly::Future<nebula::cpp2::ErrorCode> NebulaStore::readIndex(GraphSpaceID spaceId,
+                                                              PartitionID partId) {
+  auto ret = part(spaceId, partId);
+  if (!ok(ret)) {
+    return error(ret);
+  }
+  return nebula::value(ret)->readIndex();
+}
+
 void NebulaStore::addSpace(GraphSpaceID spaceId, bool isListener) {
   folly::RWSpinLock::WriteHolder wh(&lock_);
   if (!isListener) {
@@ -434,19 +565,39 @@ void NebulaStore::addPart(GraphSpaceID spaceId,
     return;
   }
 
-  int32_t minIndex = -1;
-  int32_t index = 0;
-  int32_t minPartsNum = 0x7FFFFFFF;
   auto& engines = spaceIt->second->engines_;
+  const auto& dataPath = options_.dataPaths_[diskMan_->pickDataPath(spaceId)];
+  KVEngine* targetEngine = nullptr;
+  // The part stays in the engine having its data already, e.g. the one cloned from another space
   for (auto& engine : engines) {
-    if (engine->totalPartsNum() < minPartsNum) {
-      minPartsNum = engine->totalPartsNum();
-      minIndex = index;
+    if (engine->dedicatedPart() != 0) {
+      continue;
+    }
+    auto parts = engine->allParts();
+    if (std::find(parts.begin(), parts.end(), partId) != parts.end()) {
+      targetEngine = engine.get();
+      break;
+    }
+  }
+  if (targetEngine == nullptr) {
+    // Part 0 of the meta space always stays in the shared engine
+    if (FLAGS_engine_per_part && partId != 0) {
+      // The engine of the part removed just now is still open in the same directory
+      closeDroppedEngine(
+          folly::stringPrintf("%s/nebula/%d/parts/%d", dataPath.c_str(), spaceId, partId));
+      engines.emplace_back(newEngine(spaceId, dataPath, options_.walPath_, partId));
+      targetEngine = engines.back().get();
+    } else {
+      auto root = folly::stringPrintf("%s/nebula/%d", dataPath.c_str(), spaceId);
+      for (auto& engine : engines) {
+        if (engine->dedicatedPart() == 0 && root == engine->getDataRoot()) {
+          targetEngine = engine.get();
+          break;
+        }
+      }
+      CHECK_NOTNULL(targetEngine);
     }
-    index++;
   }
-  CHECK_GE(minIndex, 0) << "engines number:" << engines.size();
-  const auto& targetEngine = engines[minIndex];
 
   Peers peersToPersist(raftPeers);
   if (asLearner) {
@@ -455,7 +606,7 @@ void NebulaStore::addPart(GraphSpaceID spaceId,
   targetEngine->addPart(partId, peersToPersist);
 
   spaceIt->second->parts_.emplace(
-      partId, newPart(spaceId, partId, targetEngine.get(), asLearner, raftPeers));
+      partId, newPart(spaceId, partId, targetEngine, asLearner, raftPeers));
   LOG(INFO) << "Space " << spaceId << ", part " << partId << " has been added, asLearner "
             << asLearner;
 }
@@ -490,7 +641,7 @@ std::shared_ptr<Part> NebulaStore::newPart(GraphSpaceID spaceId,
     func.second(part);
   }
   part->start(std::move(peersWithoutMe), asLearner);
-  diskMan_->addPartToPath(spaceId, partId, engine->getDataRoot());
+  diskMan_->addPartToPath(spaceId, partId, spaceRoot(engine));
   return part;
 }
 
@@ -520,8 +671,9 @@ void NebulaStore::removeSpace(GraphSpaceID spaceId, bool isListener) {
       }
       CHECK(spaceIt->second->parts_.empty());
       std::vector<std::string> enginePaths;
-      if (FLAGS_auto_remove_invalid_space) {
-        for (auto& engine : engines) {
+      for (auto& engine : engines) {
+        forgetSnapshots(engine.get());
+        if (FLAGS_auto_remove_invalid_space) {
           enginePaths.emplace_back(engine->getDataRoot());
         }
       }
@@ -575,10 +727,20 @@ void NebulaStore::removePart(GraphSpaceID spaceId, PartitionID partId, bool need
       auto* e = partIt->second->engine();
       CHECK_NOTNULL(e);
       raftService_->removePartition(partIt->second);
-      diskMan_->removePartFromPath(spaceId, partId, e->getDataRoot());
+      diskMan_->removePartFromPath(spaceId, partId, spaceRoot(e));
       partIt->second->resetPart();
       spaceIt->second->parts_.erase(partId);
       e->removePart(partId);
+      if (e->dedicatedPart() == partId) {
+        // Drop the whole engine instead of removing the data of the part by range
+        auto& engines = spaceIt->second->engines_;
+        auto engineIt = std::find_if(engines.begin(), engines.end(), [e](const auto& engine) {
+          return engine.get() == e;
+        });
+        auto engine = std::move(*engineIt);
+        engines.erase(engineIt);
+        dropEngine(std::move(engine));
+      }
     }
   }
   LOG(INFO) << "Space " << spaceId << ", part " << partId << " has been removed!";
@@ -629,6 +791,10 @@ std::shared_ptr<Listener> NebulaStore::newListener(GraphSpaceID spaceId,
                                                   nullptr,
                                                   nullptr,
                                                   options_.schemaMan_);
+  if (type == meta::cpp2::ListenerType::ANALYTICS) {
+    // The merges must be applied the same as by the parts
+    std::static_pointer_cast<AnalyticsListener>(listener)->setMergeOperator(options_.mergeOp_);
+  }
   raftService_->addPartition(listener);
   // add raft group as learner
   std::vector<HostAddr> raftPeers;
@@ -640,6 +806,26 @@ std::shared_ptr<Listener> NebulaStore::newListener(GraphSpaceID spaceId,
   return listener;
 }
 
+KVEngine* NebulaStore::analyticsEngine(GraphSpaceID spaceId, PartitionID partId) {
+  if (!isListener()) {
+    return nullptr;
+  }
+  folly::RWSpinLock::ReadHolder rh(&lock_);
+  auto spaceIt = spaceListeners_.find(spaceId);
+  if (spaceIt == spaceListeners_.end()) {
+    return nullptr;
+  }
+  auto partIt = spaceIt->second->listeners_.find(partId);
+  if (partIt == spaceIt->second->listeners_.end()) {
+    return nullptr;
+  }
+  auto listener = partIt->second.find(meta::cpp2::ListenerType::ANALYTICS);
+  if (listener == partIt->second.end()) {
+    return nullptr;
+  }
+  return listener->second->readEngine();
+}
+
 void NebulaStore::removeListener(GraphSpaceID spaceId,
                                  PartitionID partId,
                                  meta::cpp2::ListenerType type) {
@@ -702,6 +888,44 @@ void NebulaStore::updateSpaceOption(GraphSpaceID spaceId,
   });
 }
 
+std::string NebulaStore::spaceRoot(KVEngine* engine) {
+  if (engine->dedicatedPart() == 0) {
+    return engine->getDataRoot();
+  }
+  // The engine is rooted at parts/<partId> of the space
+  return boost::filesystem::path(engine->getDataRoot()).parent_path().parent_path().string();
+}
+
+void NebulaStore::dropEngine(std::unique_ptr<KVEngine> engine) {
+  std::string dir = engine->getDataRoot();
+  uint64_t seq = 0;
+  {
+    std::lock_guard<std::mutex> g(droppedLock_);
+    seq = ++droppedSeq_;
+    droppedEngines_[dir] = std::make_pair(seq, std::move(engine));
+  }
+  LOG(INFO) << "Engine " << dir << " will be closed in " << FLAGS_drop_engine_delay_secs << "s";
+  storeWorker_->addDelayTask(
+      FLAGS_drop_engine_delay_secs * 1000, &NebulaStore::closeDroppedEngine, this, dir, seq);
+}
+
+void NebulaStore::closeDroppedEngine(const std::string& dir, uint64_t seq) {
+  std::unique_ptr<KVEngine> engine;
+  {
+    std::lock_guard<std::mutex> g(droppedLock_);
+    auto it = droppedEngines_.find(dir);
+    // The engine has been closed, or it's another one dropped later in the same directory
+    if (it == droppedEngines_.end() || (seq != 0 && it->second.first != seq)) {
+      return;
+    }
+    engine = std::move(it->second.second);
+    droppedEngines_.erase(it);
+  }
+  forgetSnapshots(engine.get());
+  engine.reset();
+  removeSpaceDir(dir);
+}
+
 void NebulaStore::removeSpaceDir(const std::string& dir) {
   try {
     LOG(INFO) << "Try to remove space directory: " << dir;
@@ -719,6 +943,9 @@ nebula::cpp2::ErrorCode NebulaStore::get(GraphSpaceID spaceId,
                                          std::string* value,
                                          bool canReadFromFollower,
                                          const void* snapshot) {
+  if (auto* engine = analyticsEngine(spaceId, partId)) {
+    return engine->get(key, value, snapshot);
+  }
   auto ret = part(spaceId, partId);
   if (!ok(ret)) {
     return error(ret);
@@ -734,6 +961,9 @@ nebula::cpp2::ErrorCode NebulaStore::get(GraphSpaceID spaceId,
 const void* NebulaStore::GetSnapshot(GraphSpaceID spaceId,
                                      PartitionID partId,
                                      bool canReadFromFollower) {
+  if (auto* engine = analyticsEngine(spaceId, partId)) {
+    return engine->GetSnapshot();
+  }
   auto ret = part(spaceId, partId);
   if (!ok(ret)) {
     return nullptr;
@@ -742,18 +972,64 @@ const void* NebulaStore::GetSnapshot(GraphSpaceID spaceId,
   if (!checkLeader(part, canReadFromFollower)) {
     return nullptr;
   }
-  return part->engine()->GetSnapshot();
+  auto* engine = part->engine();
+  auto* snapshot = engine->GetSnapshot();
+  if (snapshot != nullptr) {
+    std::lock_guard<std::mutex> g(snapshotLock_);
+    snapshotEngines_[snapshot] = engine;
+  }
+  return snapshot;
 }
 
 void NebulaStore::ReleaseSnapshot(GraphSpaceID spaceId, PartitionID partId, const void* snapshot) {
-  auto ret = part(spaceId, partId);
-  if (!ok(ret)) {
+  if (auto* engine = analyticsEngine(spaceId, partId)) {
+    return engine->ReleaseSnapshot(snapshot);
+  }
+  KVEngine* engine = nullptr;
+  {
+    std::lock_guard<std::mutex> g(snapshotLock_);
+    auto it = snapshotEngines_.find(snapshot);
+    if (it != snapshotEngines_.end()) {
+      engine = it->second;
+      snapshotEngines_.erase(it);
+    }
+  }
+  if (engine == nullptr) {
     LOG(INFO) << "Failed to release snapshot for GraphSpaceID " << spaceId << " PartitionID"
               << partId;
     return;
   }
-  auto part = nebula::value(ret);
-  return part->engine()->ReleaseSnapshot(snapshot);
+  // The part may have been removed since, the snapshot is released by the engine which takes it,
+  // which is either still in the space or dropped but not closed yet
+  {
+    folly::RWSpinLock::ReadHolder rh(&lock_);
+    auto spaceIt = spaces_.find(spaceId);
+    if (spaceIt != spaces_.end()) {
+      const auto& engines = spaceIt->second->engines_;
+      if (std::any_of(engines.begin(), engines.end(), [engine](const auto& e) {
+            return e.get() == engine;
+          })) {
+        return engine->ReleaseSnapshot(snapshot);
+      }
+    }
+  }
+  std::lock_guard<std::mutex> g(droppedLock_);
+  for (const auto& dropped : droppedEngines_) {
+    if (dropped.second.second.get() == engine) {
+      return engine->ReleaseSnapshot(snapshot);
+    }
+  }
+}
+
+void NebulaStore::forgetSnapshots(KVEngine* engine) {
+  std::lock_guard<std::mutex> g(snapshotLock_);
+  for (auto it = snapshotEngines_.begin(); it != snapshotEngines_.end();) {
+    if (it->second == engine) {
+      it = snapshotEngines_.erase(it);
+    } else {
+      ++it;
+    }
+  }
 }
 
 std::pair<nebula::cpp2::ErrorCode, std::vector<Status>> NebulaStore::multiGet(
@@ -763,15 +1039,19 @@ std::pair<nebula::cpp2::ErrorCode, std::vector<Status>> NebulaStore::multiGet(
     std::vector<std::string>* values,
     bool canReadFromFollower) {
   std::vector<Status> status;
-  auto ret = part(spaceId, partId);
-  if (!ok(ret)) {
-    return {error(ret), status};
-  }
-  auto part = nebula::value(ret);
-  if (!checkLeader(part, canReadFromFollower)) {
-    return {nebula::cpp2::ErrorCode::E_LEADER_CHANGED, status};
+  auto* engine = analyticsEngine(spaceId, partId);
+  if (engine == nullptr) {
+    auto ret = part(spaceId, partId);
+    if (!ok(ret)) {
+      return {error(ret), status};
+    }
+    auto part = nebula::value(ret);
+    if (!checkLeader(part, canReadFromFollower)) {
+      return {nebula::cpp2::ErrorCode::E_LEADER_CHANGED, status};
+    }
+    engine = part->engine();
   }
-  status = part->engine()->multiGet(keys, values);
+  status = engine->multiGet(keys, values);
   auto allExist = std::all_of(status.begin(), status.end(), [](const auto& s) { return s.ok(); });
   if (allExist) {
     return {nebula::cpp2::ErrorCode::SUCCEEDED, status};
@@ -785,7 +1065,11 @@ nebula::cpp2::ErrorCode NebulaStore::range(GraphSpaceID spaceId,
                                            const std::string& start,
                                            const std::string& end,
                                            std::unique_ptr<KVIterator>* iter,
-                                           bool canReadFromFollower) {
+                                           bool canReadFromFollower,
+                                           const void* snapshot) {
+  if (auto* engine = analyticsEngine(spaceId, partId)) {
+    return engine->range(start, end, iter, snapshot);
+  }
   auto ret = part(spaceId, partId);
   if (!ok(ret)) {
     return error(ret);
@@ -794,7 +1078,19 @@ nebula::cpp2::ErrorCode NebulaStore::range(GraphSpaceID spaceId,
   if (!checkLeader(part, canReadFromFollower)) {
     return nebula::cpp2::ErrorCode::E_LEADER_CHANGED;
   }
-  return part->engine()->range(start, end, iter);
+  return part->engine()->range(start, end, iter, snapshot);
+}
+
+std::vector<std::string> NebulaStore::splitRange(GraphSpaceID spaceId,
+                                                 PartitionID partId,
+                                                 const std::string& start,
+                                                 const std::string& end,
+                                                 size_t num) {
+  auto ret = part(spaceId, partId);
+  if (!ok(ret)) {
+    return {};
+  }
+  return nebula::value(ret)->engine()->splitRange(start, end, num);
 }
 
 nebula::cpp2::ErrorCode NebulaStore::prefix(GraphSpaceID spaceId,
@@ -803,6 +1099,9 @@ nebula::cpp2::ErrorCode NebulaStore::prefix(GraphSpaceID spaceId,
                                             std::unique_ptr<KVIterator>* iter,
                                             bool canReadFromFollower,
                                             const void* snapshot) {
+  if (auto* engine = analyticsEngine(spaceId, partId)) {
+    return engine->prefix(prefix, iter, snapshot);
+  }
   auto ret = part(spaceId, partId);
   if (!ok(ret)) {
     return error(ret);
@@ -820,6 +1119,9 @@ nebula::cpp2::ErrorCode NebulaStore::rangeWithPrefix(GraphSpaceID spaceId,
                                                      const std::string& prefix,
                                                      std::unique_ptr<KVIterator>* iter,
                                                      bool canReadFromFollower) {
+  if (auto* engine = analyticsEngine(spaceId, partId)) {
+    return engine->rangeWithPrefix(start, prefix, iter);
+  }
   auto ret = part(spaceId, partId);
   if (!ok(ret)) {
     return error(ret);
@@ -860,7 +1162,10 @@ void NebulaStore::asyncAppendBatch(GraphSpaceID spaceId,
     return;
   }
   auto part = nebula::value(ret);
-  part->asyncAppendBatch(std::move(batch), std::move(cb));
+  tracing::Span span("kvstore.append_batch");
+  span.setAttribute("part", partId);
+  tracing::Scope scope(span.ref());
+  part->asyncAppendBatch(std::move(batch), traceCallback(std::move(span), std::move(cb)));
 }
 
 void NebulaStore::asyncMultiPut(GraphSpaceID spaceId,
@@ -873,7 +1178,10 @@ void NebulaStore::asyncMultiPut(GraphSpaceID spaceId,
     return;
   }
   auto part = nebula::value(ret);
-  part->asyncMultiPut(std::move(keyValues), std::move(cb));
+  tracing::Span span("kvstore.multi_put");
+  span.setAttribute("part", partId);
+  tracing::Scope scope(span.ref());
+  part->asyncMultiPut(std::move(keyValues), traceCallback(std::move(span), std::move(cb)));
 }
 
 void NebulaStore::asyncRemove(GraphSpaceID spaceId,
@@ -886,7 +1194,10 @@ void NebulaStore::asyncRemove(GraphSpaceID spaceId,
     return;
   }
   auto part = nebula::value(ret);
-  part->asyncRemove(key, std::move(cb));
+  tracing::Span span("kvstore.remove");
+  span.setAttribute("part", partId);
+  tracing::Scope scope(span.ref());
+  part->asyncRemove(key, traceCallback(std::move(span), std::move(cb)));
 }
 
 void NebulaStore::asyncMultiRemove(GraphSpaceID spaceId,
@@ -899,7 +1210,10 @@ void NebulaStore::asyncMultiRemove(GraphSpaceID spaceId,
     return;
   }
   auto part = nebula::value(ret);
-  part->asyncMultiRemove(std::move(keys), std::move(cb));
+  tracing::Span span("kvstore.multi_remove");
+  span.setAttribute("part", partId);
+  tracing::Scope scope(span.ref());
+  part->asyncMultiRemove(std::move(keys), traceCallback(std::move(span), std::move(cb)));
 }
 
 void NebulaStore::asyncRemoveRange(GraphSpaceID spaceId,
@@ -913,7 +1227,10 @@ void NebulaStore::asyncRemoveRange(GraphSpaceID spaceId,
     return;
   }
   auto part = nebula::value(ret);
-  part->asyncRemoveRange(start, end, std::move(cb));
+  tracing::Span span("kvstore.remove_range");
+  span.setAttribute("part", partId);
+  tracing::Scope scope(span.ref());
+  part->asyncRemoveRange(start, end, traceCallback(std::move(span), std::move(cb)));
 }
 
 void NebulaStore::asyncAtomicOp(GraphSpaceID spaceId,
@@ -926,7 +1243,10 @@ void NebulaStore::asyncAtomicOp(GraphSpaceID spaceId,
     return;
   }
   auto part = nebula::value(ret);
-  part->asyncAtomicOp(std::move(op), std::move(cb));
+  tracing::Span span("kvstore.atomic_op");
+  span.setAttribute("part", partId);
+  tracing::Scope scope(span.ref());
+  part->asyncAtomicOp(std::move(op), traceCallback(std::move(span), std::move(cb)));
 }
 
 ErrorOr<nebula::cpp2::ErrorCode, std::shared_ptr<Part>> NebulaStore::part(GraphSpaceID spaceId,
@@ -1170,6 +1490,64 @@ nebula::cpp2::ErrorCode NebulaStore::dropCheckpoint(GraphSpaceID spaceId, const
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
+nebula::cpp2::ErrorCode NebulaStore::cloneSpace(GraphSpaceID spaceId, GraphSpaceID newSpaceId) {
+  auto spaceRet = space(spaceId);
+  if (!ok(spaceRet)) {
+    return error(spaceRet);
+  }
+  if (ok(space(newSpaceId))) {
+    return nebula::cpp2::ErrorCode::E_EXISTED;
+  }
+  auto space = nebula::value(spaceRet);
+  std::vector<std::string> cloned;
+  auto fail = [this, &cloned](nebula::cpp2::ErrorCode code) {
+    for (const auto& root : cloned) {
+      removeSpaceDir(root);
+    }
+    return code;
+  };
+  for (auto& engine : space->engines_) {
+    // The engine of a dedicated part is opened by the path picked when adding the part, which
+    // might not be the one cloned to
+    if (engine->dedicatedPart() != 0) {
+      LOG(WARNING) << "Space " << spaceId << " with an engine for each part could not be cloned";
+      return fail(nebula::cpp2::ErrorCode::E_UNSUPPORTED);
+    }
+    // The root of an engine is {data_path}/nebula/{spaceId}
+    std::string root = engine->getDataRoot();
+    auto newRoot = folly::sformat("{}/{}", root.substr(0, root.rfind('/')), newSpaceId);
+    if (fs::FileUtils::exist(newRoot)) {
+      LOG(WARNING) << "The data of space " << newSpaceId << " exists in " << newRoot;
+      return fail(nebula::cpp2::ErrorCode::E_EXISTED);
+    }
+    if (!fs::FileUtils::makeDir(newRoot)) {
+      LOG(WARNING) << "Make dir " << newRoot << " failed";
+      return fail(nebula::cpp2::ErrorCode::E_FAILED_TO_CHECKPOINT);
+    }
+    cloned.emplace_back(newRoot);
+    auto code = engine->createCheckpoint(folly::sformat("{}/data", newRoot));
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return fail(code);
+    }
+    LOG(INFO) << "Cloned the data of space " << spaceId << " in " << root << " to " << newRoot;
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode NebulaStore::dropClonedSpace(GraphSpaceID newSpaceId) {
+  if (ok(space(newSpaceId))) {
+    LOG(WARNING) << "Space " << newSpaceId << " has been added, its data is not a clone";
+    return nebula::cpp2::ErrorCode::E_EXISTED;
+  }
+  for (const auto& dataPath : options_.dataPaths_) {
+    auto root = folly::stringPrintf("%s/nebula/%d", dataPath.c_str(), newSpaceId);
+    if (fs::FileUtils::exist(root)) {
+      removeSpaceDir(root);
+    }
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
 nebula::cpp2::ErrorCode NebulaStore::setWriteBlocking(GraphSpaceID spaceId, bool sign) {
   auto spaceRet = space(spaceId);
   if (!ok(spaceRet)) {
@@ -1271,7 +1649,8 @@ void NebulaStore::cleanWAL() {
     storeWorker_->addDelayTask(FLAGS_clean_wal_interval_secs * 1000, &NebulaStore::cleanWAL, this);
   };
   for (const auto& spaceEntry : spaces_) {
-    if (FLAGS_rocksdb_disable_wal) {
+    // The data in memory is checkpointed before its wal is cleaned
+    if (FLAGS_rocksdb_disable_wal || inMemory(spaceEntry.first)) {
       for (const auto& engine : spaceEntry.second->engines_) {
         engine->flush();
       }
@@ -1295,6 +1674,151 @@ void NebulaStore::cleanWAL() {
   }
 }
 
+void NebulaStore::reportMemtableStats() {
+  auto writeBufferManager = getWriteBufferManager();
+  if (writeBufferManager == nullptr) {
+    return;
+  }
+  stats::StatsManager::addValue(kMemtableUsageBytes, writeBufferManager->memory_usage());
+#if ROCKSDB_MAJOR >= 7
+  // The average is the ratio of the time the writes are stalled
+  stats::StatsManager::addValue(kMemtableBudgetStalled, writeBufferManager->IsStallActive());
+#endif
+}
+
+void NebulaStore::collectGauges(std::vector<stats::StatsManager::Gauge>& gauges) {
+  // The integer properties of rocksdb summed over the engines of a space
+  static const std::vector<std::pair<std::string, std::string>> kProperties = {
+      {"rocksdb.estimate-num-keys", "rocksdb_estimate_num_keys"},
+      {"rocksdb.live-sst-files-size", "rocksdb_live_sst_files_bytes"},
+      {"rocksdb.cur-size-all-mem-tables", "rocksdb_memtable_bytes"},
+      {"rocksdb.estimate-pending-compaction-bytes", "rocksdb_pending_compaction_bytes"},
+      {"rocksdb.num-running-compactions", "rocksdb_running_compactions"},
+  };
+  // The properties of the block cache shared by all the engines
+  static const std::vector<std::pair<std::string, std::string>> kBlockCacheProperties = {
+      {"rocksdb.block-cache-usage", "rocksdb_block_cache_usage_bytes"},
+      {"rocksdb.block-cache-pinned-usage", "rocksdb_block_cache_pinned_bytes"},
+  };
+  folly::RWSpinLock::ReadHolder rh(&lock_);
+  size_t numParts = 0;
+  for (const auto& space : spaces_) {
+    numParts += space.second->parts_.size();
+  }
+  bool partSeries = numParts <= static_cast<size_t>(FLAGS_metrics_max_part_series);
+  bool blockCacheCollected = false;
+  for (const auto& [spaceId, space] : spaces_) {
+    auto spaceLabel = std::make_pair(std::string("space"), folly::to<std::string>(spaceId));
+    size_t leaders = 0;
+    size_t walBytes = 0;
+    LogID maxCommitLag = 0;
+    LogID maxFollowerLag = 0;
+    size_t maxFollowerLagBytes = 0;
+    size_t pendingLogs = 0;
+    size_t pendingLogBytes = 0;
+    size_t sendingSnapshots = 0;
+    size_t receivingSnapshots = 0;
+    for (const auto& [partId, part] : space->parts_) {
+      auto stats = part->replicationStats();
+      leaders += stats.isLeader ? 1 : 0;
+      walBytes += stats.walBytes;
+      maxCommitLag = std::max(maxCommitLag, stats.commitLag);
+      maxFollowerLag = std::max(maxFollowerLag, stats.maxFollowerLag);
+      maxFollowerLagBytes = std::max(maxFollowerLagBytes, stats.maxFollowerLagBytes);
+      pendingLogs += stats.pendingLogs;
+      pendingLogBytes += stats.pendingLogBytes;
+      sendingSnapshots += stats.sendingSnapshots;
+      receivingSnapshots += stats.snapshotRowsReceived > 0 ? 1 : 0;
+      if (partSeries) {
+        std::vector<std::pair<std::string, std::string>> labels = {
+            spaceLabel, {"part", folly::to<std::string>(partId)}};
+        gauges.push_back({"raft_part_is_leader", labels, stats.isLeader ? 1.0 : 0.0});
+        gauges.push_back({"raft_part_commit_lag", labels, static_cast<double>(stats.commitLag)});
+        gauges.push_back(
+            {"raft_part_follower_lag", labels, static_cast<double>(stats.maxFollowerLag)});
+        gauges.push_back({"raft_part_follower_lag_bytes",
+                          labels,
+                          static_cast<double>(stats.maxFollowerLagBytes)});
+        gauges.push_back(
+            {"raft_part_heartbeat_rtt_us", labels, static_cast<double>(stats.maxHeartbeatRttUs)});
+        gauges.push_back(
+            {"raft_part_pending_logs", labels, static_cast<double>(stats.pendingLogs)});
+        gauges.push_back(
+            {"raft_part_pending_log_bytes", labels, static_cast<double>(stats.pendingLogBytes)});
+        gauges.push_back({"raft_part_snapshot_bytes_received",
+                          labels,
+                          static_cast<double>(stats.snapshotBytesReceived)});
+        gauges.push_back({"raft_part_wal_bytes", labels, static_cast<double>(stats.walBytes)});
+      }
+    }
+    gauges.push_back({"raft_parts", {spaceLabel}, static_cast<double>(space->parts_.size())});
+    gauges.push_back({"raft_leader_parts", {spaceLabel}, static_cast<double>(leaders)});
+    gauges.push_back({"raft_max_commit_lag", {spaceLabel}, static_cast<double>(maxCommitLag)});
+    gauges.push_back(
+        {"raft_max_follower_lag", {spaceLabel}, static_cast<double>(maxFollowerLag)});
+    gauges.push_back(
+        {"raft_max_follower_lag_bytes", {spaceLabel}, static_cast<double>(maxFollowerLagBytes)});
+    gauges.push_back({"raft_pending_logs", {spaceLabel}, static_cast<double>(pendingLogs)});
+    gauges.push_back(
+        {"raft_pending_log_bytes", {spaceLabel}, static_cast<double>(pendingLogBytes)});
+    gauges.push_back(
+        {"raft_sending_snapshots", {spaceLabel}, static_cast<double>(sendingSnapshots)});
+    gauges.push_back(
+        {"raft_receiving_snapshots", {spaceLabel}, static_cast<double>(receivingSnapshots)});
+    gauges.push_back({"raft_wal_bytes", {spaceLabel}, static_cast<double>(walBytes)});
+
+    for (const auto& [property, name] : kProperties) {
+      int64_t sum = 0;
+      for (const auto& engine : space->engines_) {
+        auto prop = engine->getProperty(property);
+        if (ok(prop)) {
+          sum += folly::tryTo<int64_t>(value(prop)).value_or(0);
+        }
+      }
+      gauges.push_back({name, {spaceLabel}, static_cast<double>(sum)});
+    }
+    if (!blockCacheCollected && !space->engines_.empty()) {
+      blockCacheCollected = true;
+      for (const auto& [property, name] : kBlockCacheProperties) {
+        auto prop = space->engines_.front()->getProperty(property);
+        if (ok(prop)) {
+          auto bytes = folly::tryTo<int64_t>(value(prop)).value_or(0);
+          gauges.push_back({name, {}, static_cast<double>(bytes)});
+        }
+      }
+    }
+  }
+}
+
+folly::dynamic NebulaStore::replicationStats(GraphSpaceID spaceId) {
+  folly::dynamic parts = folly::dynamic::array();
+  folly::RWSpinLock::ReadHolder rh(&lock_);
+  for (const auto& [id, space] : spaces_) {
+    if (spaceId > 0 && id != spaceId) {
+      continue;
+    }
+    for (const auto& [partId, part] : space->parts_) {
+      auto stats = part->replicationStats();
+      folly::dynamic entry = folly::dynamic::object();
+      entry["space"] = id;
+      entry["part"] = partId;
+      entry["is_leader"] = stats.isLeader;
+      entry["commit_lag"] = stats.commitLag;
+      entry["follower_lag"] = stats.maxFollowerLag;
+      entry["follower_lag_bytes"] = static_cast<int64_t>(stats.maxFollowerLagBytes);
+      entry["heartbeat_rtt_us"] = stats.maxHeartbeatRttUs;
+      entry["pending_logs"] = static_cast<int64_t>(stats.pendingLogs);
+      entry["pending_log_bytes"] = static_cast<int64_t>(stats.pendingLogBytes);
+      entry["sending_snapshots"] = static_cast<int64_t>(stats.sendingSnapshots);
+      entry["snapshot_rows_received"] = stats.snapshotRowsReceived;
+      entry["snapshot_bytes_received"] = stats.snapshotBytesReceived;
+      entry["wal_bytes"] = static_cast<int64_t>(stats.walBytes);
+      parts.push_back(std::move(entry));
+    }
+  }
+  return parts;
+}
+
 nebula::cpp2::ErrorCode NebulaStore::backup() {
   for (const auto& spaceEntry : spaces_) {
     for (const auto& engine : spaceEntry.second->engines_) {
@@ -1393,13 +1917,28 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> NebulaStore::getProperty(
   auto space = nebula::value(spaceRet);
 
   folly::dynamic obj = folly::dynamic::object;
+  bool compression = property == RocksEngine::kCompressionRatio;
+  int64_t rawBytes = 0;
+  int64_t dataBytes = 0;
   for (size_t i = 0; i < space->engines_.size(); i++) {
     auto val = space->engines_[i]->getProperty(property);
     if (!ok(val)) {
       return error(val);
     }
     auto eng = folly::stringPrintf("Engine %zu", i);
-    obj[eng] = std::move(value(val));
+    if (compression) {
+      auto stats = folly::parseJson(value(val));
+      rawBytes += stats["raw_bytes"].asInt();
+      dataBytes += stats["data_bytes"].asInt();
+      obj[eng] = std::move(stats);
+    } else {
+      obj[eng] = std::move(value(val));
+    }
+  }
+  if (compression) {
+    // The ratio of the whole space
+    obj["Space"] = folly::dynamic::object("raw_bytes", rawBytes)("data_bytes", dataBytes)(
+        "ratio", dataBytes == 0 ? 0.0 : static_cast<double>(rawBytes) / dataBytes);
   }
   return folly::toJson(obj);
 }
@@ -7,11 +7,14 @@
 #define KVSTORE_NEBULASTORE_H_
 
 #include <folly/RWSpinLock.h>
+#include <folly/Synchronized.h>
+#include <folly/dynamic.h>
 #include <folly/concurrency/ConcurrentHashMap.h>
 #include <gtest/gtest_prod.h>
 
 #include "common/base/Base.h"
 #include "common/ssl/SSLConfig.h"
+#include "common/stats/StatsManager.h"
 #include "common/utils/Utils.h"
 #include "interface/gen-cpp2/RaftexServiceAsyncClient.h"
 #include "kvstore/DiskManager.h"
@@ -162,6 +165,27 @@ class NebulaStore : public KVStore, public Handler {
   ErrorOr<nebula::cpp2::ErrorCode, HostAddr> partLeader(GraphSpaceID spaceId,
                                                         PartitionID partId) override;
 
+  /**
+   * @brief Return whether the part is a follower whose data is at most maxStalenessMs behind the
+   * leader
+   *
+   * @param spaceId
+   * @param partId
+   * @param maxStalenessMs
+   */
+  bool followerReadable(GraphSpaceID spaceId, PartitionID partId, int64_t maxStalenessMs) override;
+
+  /**
+   * @brief Check whether the part is a leader which could serve linearizable reads, the leadership
+   * is confirmed by heartbeat if the lease has expired
+   *
+   * @param spaceId
+   * @param partId
+   * @return folly::Future<nebula::cpp2::ErrorCode>
+   */
+  folly::Future<nebula::cpp2::ErrorCode> readIndex(GraphSpaceID spaceId,
+                                                   PartitionID partId) override;
+
   /**
    * @brief Return pointer of part manager
    *
@@ -200,7 +224,8 @@ class NebulaStore : public KVStore, public Handler {
                           bool canReadFromFollower = false) override;
 
   /**
-   * @brief Release snapshot from engine.
+   * @brief Release snapshot from engine, by the engine which takes it even if the part has been
+   * removed since.
    *
    * @param spaceId
    * @param partId
@@ -260,7 +285,8 @@ class NebulaStore : public KVStore, public Handler {
                                 const std::string& start,
                                 const std::string& end,
                                 std::unique_ptr<KVIterator>* iter,
-                                bool canReadFromFollower = false) override;
+                                bool canReadFromFollower = false,
+                                const void* snapshot = nullptr) override;
 
   /**
    * @brief To forbid to pass rvalue via the 'range' parameter.
@@ -270,7 +296,24 @@ class NebulaStore : public KVStore, public Handler {
                                 std::string&& start,
                                 std::string&& end,
                                 std::unique_ptr<KVIterator>* iter,
-                                bool canReadFromFollower = false) override = delete;
+                                bool canReadFromFollower = false,
+                                const void* snapshot = nullptr) override = delete;
+
+  /**
+   * @brief Split the range [start, end) of a part into at most num sub ranges of similar data size
+   *
+   * @param spaceId
+   * @param partId
+   * @param start Start key, inclusive
+   * @param end End key, exclusive
+   * @param num Max number of sub ranges
+   * @return std::vector<std::string> The boundaries between the sub ranges in order
+   */
+  std::vector<std::string> splitRange(GraphSpaceID spaceId,
+                                      PartitionID partId,
+                                      const std::string& start,
+                                      const std::string& end,
+                                      size_t num) override;
 
   /**
    * @brief Get all results with 'prefix' str as prefix.
@@ -504,6 +547,25 @@ class NebulaStore : public KVStore, public Handler {
    */
   nebula::cpp2::ErrorCode dropCheckpoint(GraphSpaceID spaceId, const std::string& name) override;
 
+  /**
+   * @brief Clone the data of a space by the checkpoint of each engine created in place of the
+   * engine of the new space, so the sst files are hard linked instead of copied. The raft wal is
+   * not cloned, the parts of the new space start from the logs committed in the checkpoints.
+   *
+   * @param spaceId Space to clone
+   * @param newSpaceId New space, which must not be added yet
+   * @return nebula::cpp2::ErrorCode
+   */
+  nebula::cpp2::ErrorCode cloneSpace(GraphSpaceID spaceId, GraphSpaceID newSpaceId) override;
+
+  /**
+   * @brief Remove the data cloned by cloneSpace in all the data paths
+   *
+   * @param newSpaceId New space, which must not be added
+   * @return nebula::cpp2::ErrorCode
+   */
+  nebula::cpp2::ErrorCode dropClonedSpace(GraphSpaceID newSpaceId) override;
+
   /**
    * @brief Set the write blocking flag, if blocked, only heartbeat can be replicated
    *
@@ -692,6 +754,13 @@ class NebulaStore : public KVStore, public Handler {
   ErrorOr<nebula::cpp2::ErrorCode, std::string> getProperty(GraphSpaceID spaceId,
                                                             const std::string& property) override;
 
+  /**
+   * @brief The replication state of the parts in json, see RaftPart::ReplicationStats
+   *
+   * @param spaceId Only the parts of the space if it is positive
+   */
+  folly::dynamic replicationStats(GraphSpaceID spaceId);
+
   /**
    * @brief Register callback when found new partition is added
    *
@@ -735,6 +804,28 @@ class NebulaStore : public KVStore, public Handler {
    */
   void loadPartFromDataPath();
 
+  /**
+   * @brief Load the engines of all spaces in a data path
+   *
+   * @param path
+   * @param partSet The parts loaded, to avoid loading a part on different data paths
+   */
+  void loadDataPath(
+      const std::string& path,
+      folly::Synchronized<std::unordered_set<std::pair<GraphSpaceID, PartitionID>>>& partSet);
+
+  /**
+   * @brief Load the parts of a kv engine, the engine is closed if it has no valid part
+   *
+   * @param spaceId
+   * @param engine
+   * @param partSet The parts loaded, to avoid loading a part on different data paths
+   */
+  void loadEngine(
+      GraphSpaceID spaceId,
+      std::unique_ptr<KVEngine> engine,
+      folly::Synchronized<std::unordered_set<std::pair<GraphSpaceID, PartitionID>>>& partSet);
+
   /**
    * @brief Load partitions from meta
    */
@@ -767,11 +858,13 @@ class NebulaStore : public KVStore, public Handler {
    * @param spaceId
    * @param dataPath
    * @param walPath
+   * @param dedicatedPart The only part of the engine, 0 if the engine is shared by the parts
    * @return std::unique_ptr<KVEngine>
    */
   std::unique_ptr<KVEngine> newEngine(GraphSpaceID spaceId,
                                       const std::string& dataPath,
-                                      const std::string& walPath);
+                                      const std::string& walPath,
+                                      PartitionID dedicatedPart = 0);
 
   /**
    * @brief Start a new part
@@ -803,6 +896,16 @@ class NebulaStore : public KVStore, public Handler {
                                         meta::cpp2::ListenerType type,
                                         const std::vector<HostAddr>& peers);
 
+  /**
+   * @brief Get the engine of the ANALYTICS listener of the part, whose reads are served without
+   * checking the leader
+   *
+   * @param spaceId
+   * @param partId
+   * @return KVEngine* nullptr if this is not a listener, or there is no such listener
+   */
+  KVEngine* analyticsEngine(GraphSpaceID spaceId, PartitionID partId);
+
   /**
    * @brief Get given partition's kv engine
    *
@@ -827,6 +930,24 @@ class NebulaStore : public KVStore, public Handler {
    */
   void cleanWAL();
 
+  /**
+   * @brief Report the memory usage of the memtables shared by all the spaces, and whether the
+   * writes are stalled by rocksdb_memtable_budget
+   */
+  void reportMemtableStats();
+
+  /**
+   * @brief Collect the gauges of raft and rocksdb for the metrics exporter. The gauges of each part
+   * are collected only if there are no more parts than metrics_max_part_series, the gauges of each
+   * space are always collected.
+   */
+  void collectGauges(std::vector<stats::StatsManager::Gauge>& gauges);
+
+  // The owner of the gauges registered in StatsManager
+  std::string gaugesOwner() const {
+    return "kvstore:" + raftAddr_.toString();
+  }
+
   /**
    * @brief Get the vertex id length of given space
    *
@@ -835,12 +956,37 @@ class NebulaStore : public KVStore, public Handler {
    */
   int32_t getSpaceVidLen(GraphSpaceID spaceId);
 
+  /**
+   * @brief Close the dedicated engine of a removed part and remove its directory after
+   * drop_engine_delay_secs, the reads may still hold the raw pointer of the engine or its iterators
+   * when the part is removed
+   */
+  void dropEngine(std::unique_ptr<KVEngine> engine);
+
+  /**
+   * @brief Close the engine dropped in the directory and remove the directory
+   *
+   * @param dir Data root of the engine
+   * @param seq The sequence of the drop to close, the engine is closed whatever the sequence is
+   * if it's 0
+   */
+  void closeDroppedEngine(const std::string& dir, uint64_t seq = 0);
+
   /**
    * @brief Remove a space's directory
    */
   void removeSpaceDir(const std::string& dir);
 
+  /**
+   * @brief Return the root of the space on the data path of the engine, e.g.
+   * "/DataPath/nebula/spaceId"
+   */
+  static std::string spaceRoot(KVEngine* engine);
+
  private:
+  // Forget the snapshots of the engine which is closed, they are gone with it
+  void forgetSnapshots(KVEngine* engine);
+
   // The lock used to protect spaces_
   folly::RWSpinLock lock_;
   std::unordered_map<GraphSpaceID, std::shared_ptr<SpacePartInfo>> spaces_;
@@ -861,6 +1007,16 @@ class NebulaStore : public KVStore, public Handler {
   folly::ConcurrentHashMap<std::string, std::function<void(std::shared_ptr<Part>&)>>
       onNewPartAdded_;
   std::function<void(GraphSpaceID)> beforeRemoveSpace_{nullptr};
+
+  // The engines of the removed parts to close later, by the data root
+  std::mutex droppedLock_;
+  uint64_t droppedSeq_{0};
+  std::unordered_map<std::string, std::pair<uint64_t, std::unique_ptr<KVEngine>>>
+      droppedEngines_;
+
+  // The engines which take the snapshots not released yet
+  std::mutex snapshotLock_;
+  std::unordered_map<const void*, KVEngine*> snapshotEngines_;
 };
 
 }  // namespace kvstore
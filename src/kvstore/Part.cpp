@@ -11,9 +11,18 @@
 #include "common/utils/OperationKeyUtils.h"
 #include "common/utils/Utils.h"
 #include "kvstore/LogEncoder.h"
+#include "kvstore/PendingRows.h"
 #include "kvstore/RocksEngineConfig.h"
+#include "kvstore/stats/KVStats.h"
 
 DEFINE_int32(cluster_id, 0, "A unique id for each cluster");
+DEFINE_bool(coalesce_part_writes,
+            false,
+            "Whether to merge the concurrent writes of a part into one raft log");
+DEFINE_uint32(max_coalesced_writes, 256, "The max number of writes merged into one raft log");
+DEFINE_uint64(max_coalesced_write_bytes,
+              4 * 1024 * 1024,
+              "The max bytes of the writes merged into one raft log");
 
 namespace nebula {
 namespace kvstore {
@@ -67,58 +76,182 @@ std::pair<LogID, TermID> Part::lastCommittedLogId() {
 void Part::asyncPut(folly::StringPiece key, folly::StringPiece value, KVCallback cb) {
   std::string log = encodeMultiValues(OP_PUT, key, value);
 
-  appendAsync(FLAGS_cluster_id, std::move(log))
-      .thenValue(
-          [callback = std::move(cb)](nebula::cpp2::ErrorCode code) mutable { callback(code); });
+  appendWrite(std::move(log), std::move(cb));
 }
 
 void Part::asyncAppendBatch(std::string&& batch, KVCallback cb) {
-  appendAsync(FLAGS_cluster_id, std::move(batch))
-      .thenValue(
-          [callback = std::move(cb)](nebula::cpp2::ErrorCode code) mutable { callback(code); });
+  appendWrite(std::move(batch), std::move(cb));
 }
 
 void Part::asyncMultiPut(const std::vector<KV>& keyValues, KVCallback cb) {
   std::string log = encodeMultiValues(OP_MULTI_PUT, keyValues);
 
-  appendAsync(FLAGS_cluster_id, std::move(log))
-      .thenValue(
-          [callback = std::move(cb)](nebula::cpp2::ErrorCode code) mutable { callback(code); });
+  appendWrite(std::move(log), std::move(cb));
 }
 
 void Part::asyncRemove(folly::StringPiece key, KVCallback cb) {
   std::string log = encodeSingleValue(OP_REMOVE, key);
 
-  appendAsync(FLAGS_cluster_id, std::move(log))
-      .thenValue(
-          [callback = std::move(cb)](nebula::cpp2::ErrorCode code) mutable { callback(code); });
+  appendWrite(std::move(log), std::move(cb));
 }
 
 void Part::asyncMultiRemove(const std::vector<std::string>& keys, KVCallback cb) {
   std::string log = encodeMultiValues(OP_MULTI_REMOVE, keys);
 
-  appendAsync(FLAGS_cluster_id, std::move(log))
-      .thenValue(
-          [callback = std::move(cb)](nebula::cpp2::ErrorCode code) mutable { callback(code); });
+  appendWrite(std::move(log), std::move(cb));
 }
 
 void Part::asyncRemoveRange(folly::StringPiece start, folly::StringPiece end, KVCallback cb) {
   std::string log = encodeMultiValues(OP_REMOVE_RANGE, start, end);
 
-  appendAsync(FLAGS_cluster_id, std::move(log))
-      .thenValue(
-          [callback = std::move(cb)](nebula::cpp2::ErrorCode code) mutable { callback(code); });
+  appendWrite(std::move(log), std::move(cb));
+}
+
+void Part::appendWrite(std::string&& log, KVCallback cb) {
+  auto code = engine_->admitWrite(log.size());
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    cb(code);
+    return;
+  }
+  // Traced from being appended to being committed, including the time waiting to be coalesced
+  tracing::Span span("raft.append");
+  span.setAttribute("log_bytes", static_cast<int64_t>(log.size()));
+  cb = traceCallback(std::move(span), std::move(cb));
+  std::unique_lock<std::mutex> lk(writesLock_);
+  if (!FLAGS_coalesce_part_writes && pendingWrites_.empty() && !proposing_) {
+    lk.unlock();
+    appendAsync(FLAGS_cluster_id, compressLog(std::move(log)))
+        .thenValue(
+            [callback = std::move(cb)](nebula::cpp2::ErrorCode c) mutable { callback(c); });
+    return;
+  }
+  pendingBytes_ += log.size();
+  pendingWrites_.emplace_back(PendingWrite{std::move(log), std::move(cb), nullptr});
+  proposeWrites(lk);
+}
+
+void Part::appendBarrier(folly::Function<void()> barrier) {
+  std::unique_lock<std::mutex> lk(writesLock_);
+  if (pendingWrites_.empty() && !proposing_) {
+    // All the writes before have been appended
+    lk.unlock();
+    barrier();
+    return;
+  }
+  numBarriers_++;
+  pendingWrites_.emplace_back(PendingWrite{"", nullptr, std::move(barrier)});
+  proposeWrites(lk);
+}
+
+bool Part::writesReady() const {
+  if (pendingWrites_.empty()) {
+    return false;
+  }
+  // Nothing waits for the log in flight if the feature is turned off meanwhile
+  return writesInFlight_ == 0 || numBarriers_ > 0 || !FLAGS_coalesce_part_writes ||
+         pendingWrites_.size() >= FLAGS_max_coalesced_writes ||
+         pendingBytes_ >= FLAGS_max_coalesced_write_bytes;
+}
+
+void Part::proposeWrites(std::unique_lock<std::mutex>& lk) {
+  // Only one thread appends the pending writes at a time, so they're appended in order
+  if (proposing_ || !writesReady()) {
+    return;
+  }
+  proposing_ = true;
+  do {
+    std::vector<std::string> logs;
+    std::vector<KVCallback> callbacks;
+    folly::Function<void()> barrier;
+    size_t bytes = 0;
+    size_t maxWrites = FLAGS_coalesce_part_writes ? FLAGS_max_coalesced_writes : 1;
+    while (!pendingWrites_.empty()) {
+      auto& write = pendingWrites_.front();
+      if (write.barrier) {
+        // Run after the writes before it are appended
+        if (logs.empty()) {
+          barrier = std::move(write.barrier);
+          numBarriers_--;
+          pendingWrites_.pop_front();
+        }
+        break;
+      }
+      if (!logs.empty() && (logs.size() >= maxWrites ||
+                            bytes + write.log.size() > FLAGS_max_coalesced_write_bytes)) {
+        break;
+      }
+      bytes += write.log.size();
+      logs.emplace_back(std::move(write.log));
+      callbacks.emplace_back(std::move(write.callback));
+      pendingWrites_.pop_front();
+    }
+    pendingBytes_ -= bytes;
+    if (!logs.empty()) {
+      writesInFlight_++;
+    }
+    lk.unlock();
+    if (barrier) {
+      barrier();
+    } else {
+      proposeWrites(std::move(logs), std::move(callbacks));
+    }
+    lk.lock();
+  } while (writesReady());
+  proposing_ = false;
+}
+
+void Part::onWritesDone() {
+  {
+    std::lock_guard<std::mutex> g(writesLock_);
+    writesInFlight_--;
+    // The proposing thread checks again before it stops
+    if (proposing_ || !writesReady()) {
+      return;
+    }
+    proposing_ = true;
+  }
+  // The callback of a log is called with the logsLock_ of raft held, so the pending logs are
+  // appended in another thread
+  bgWorkers_->addTask([self = shared_from_this(), this] {
+    std::unique_lock<std::mutex> lk(writesLock_);
+    proposing_ = false;
+    proposeWrites(lk);
+  });
+}
+
+void Part::proposeWrites(std::vector<std::string>&& logs, std::vector<KVCallback>&& callbacks) {
+  DCHECK_EQ(logs.size(), callbacks.size());
+  stats::StatsManager::addValue(kNumCoalescedWrites, logs.size());
+  auto log = logs.size() == 1 ? std::move(logs.front()) : mergeWriteLogs(logs);
+  appendAsync(FLAGS_cluster_id, compressLog(std::move(log)))
+      .thenValue([this, callbacks = std::move(callbacks)](nebula::cpp2::ErrorCode code) mutable {
+        onWritesDone();
+        for (auto& callback : callbacks) {
+          callback(code);
+        }
+      });
 }
 
 void Part::sync(KVCallback cb) {
-  sendCommandAsync("").thenValue(
-      [callback = std::move(cb)](nebula::cpp2::ErrorCode code) mutable { callback(code); });
+  // The writes before are replicated before the command
+  appendBarrier([this, cb = std::move(cb)]() mutable {
+    sendCommandAsync("").thenValue(
+        [callback = std::move(cb)](nebula::cpp2::ErrorCode code) mutable { callback(code); });
+  });
 }
 
 void Part::asyncAtomicOp(MergeableAtomicOp op, KVCallback cb) {
-  atomicOpAsync(std::move(op))
-      .thenValue(
-          [callback = std::move(cb)](nebula::cpp2::ErrorCode code) mutable { callback(code); });
+  auto code = engine_->admitWrite(0);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    cb(code);
+    return;
+  }
+  // The writes before are applied before the atomic op
+  appendBarrier([this, op = std::move(op), cb = std::move(cb)]() mutable {
+    atomicOpAsync(std::move(op))
+        .thenValue(
+            [callback = std::move(cb)](nebula::cpp2::ErrorCode c) mutable { callback(c); });
+  });
 }
 
 void Part::asyncAddLearner(const HostAddr& learner, KVCallback cb) {
@@ -218,6 +351,35 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
   auto batch = engine_->startBatchWrite();
   LogID lastId = kNoCommitLogId;
   TermID lastTerm = kNoCommitLogTerm;
+  PendingRows pendingRows(engine_, batch.get());
+  // The operation logs of the indexes are ordered by the raft logs which write them
+  auto put = [&](folly::StringPiece key, folly::StringPiece val) {
+    pendingRows.write(BatchLogType::OP_BATCH_PUT, key, val);
+    if (partId_ != 0 && OperationKeyUtils::isOperation(partId_, key)) {
+      return batch->put(OperationKeyUtils::setLogPosition(key, lastTerm, lastId), val);
+    }
+    return batch->put(key, val);
+  };
+  auto remove = [&](folly::StringPiece key) {
+    pendingRows.write(BatchLogType::OP_BATCH_REMOVE, key, "");
+    return batch->remove(key);
+  };
+  auto removeRange = [&](folly::StringPiece start, folly::StringPiece end) {
+    pendingRows.write(BatchLogType::OP_BATCH_REMOVE_RANGE, start, end);
+    return batch->removeRange(start, end);
+  };
+  // A merge into a missing row is skipped, which would leave an empty value
+  auto merge = [&](folly::StringPiece key, folly::StringPiece operand) {
+    auto ret = pendingRows.mergeable(key);
+    if (!nebula::ok(ret)) {
+      return nebula::error(ret);
+    }
+    if (!nebula::value(ret)) {
+      VLOG(3) << idStr_ << "Skip the merge into the missing row " << folly::hexlify(key);
+      return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+    return batch->merge(key, operand);
+  };
   while (iter->valid()) {
     lastId = iter->logId();
     lastTerm = iter->logTerm();
@@ -228,12 +390,18 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
       continue;
     }
     DCHECK_GE(log.size(), sizeof(int64_t) + 1 + sizeof(uint32_t));
+    // The compressed log is kept as is in the wal and the log buffer until it's committed
+    std::string decompressed;
+    if (isCompressedLog(log)) {
+      decompressed = decompressLog(log);
+      log = decompressed;
+    }
     // Skip the timestamp (type of int64_t)
     switch (log[sizeof(int64_t)]) {
       case OP_PUT: {
         auto pieces = decodeMultiValues(log);
         DCHECK_EQ(2, pieces.size());
-        auto code = batch->put(pieces[0], pieces[1]);
+        auto code = put(pieces[0], pieces[1]);
         if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
           VLOG(3) << idStr_ << "Failed to call WriteBatch::put()";
           return {code, kNoCommitLogId, kNoCommitLogTerm};
@@ -247,7 +415,7 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
         for (size_t i = 0; i < kvs.size(); i += 2) {
           VLOG(4) << "OP_MULTI_PUT " << folly::hexlify(kvs[i])
                   << ", val = " << folly::hexlify(kvs[i + 1]);
-          auto code = batch->put(kvs[i], kvs[i + 1]);
+          auto code = put(kvs[i], kvs[i + 1]);
           if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
             VLOG(3) << idStr_ << "Failed to call WriteBatch::put()";
             return {code, kNoCommitLogId, kNoCommitLogTerm};
@@ -257,7 +425,7 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
       }
       case OP_REMOVE: {
         auto key = decodeSingleValue(log);
-        auto code = batch->remove(key);
+        auto code = remove(key);
         if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
           VLOG(3) << idStr_ << "Failed to call WriteBatch::remove()";
           return {code, kNoCommitLogId, kNoCommitLogTerm};
@@ -267,7 +435,7 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
       case OP_MULTI_REMOVE: {
         auto keys = decodeMultiValues(log);
         for (auto k : keys) {
-          auto code = batch->remove(k);
+          auto code = remove(k);
           if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
             VLOG(3) << idStr_ << "Failed to call WriteBatch::remove()";
             return {code, kNoCommitLogId, kNoCommitLogTerm};
@@ -278,7 +446,7 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
       case OP_REMOVE_RANGE: {
         auto range = decodeMultiValues(log);
         DCHECK_EQ(2, range.size());
-        auto code = batch->removeRange(range[0], range[1]);
+        auto code = removeRange(range[0], range[1]);
         if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
           VLOG(3) << idStr_ << "Failed to call WriteBatch::removeRange()";
           return {code, kNoCommitLogId, kNoCommitLogTerm};
@@ -292,11 +460,13 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
                   << ", val = " << folly::hexlify(op.second.second);
           auto code = nebula::cpp2::ErrorCode::SUCCEEDED;
           if (op.first == BatchLogType::OP_BATCH_PUT) {
-            code = batch->put(op.second.first, op.second.second);
+            code = put(op.second.first, op.second.second);
           } else if (op.first == BatchLogType::OP_BATCH_REMOVE) {
-            code = batch->remove(op.second.first);
+            code = remove(op.second.first);
           } else if (op.first == BatchLogType::OP_BATCH_REMOVE_RANGE) {
-            code = batch->removeRange(op.second.first, op.second.second);
+            code = removeRange(op.second.first, op.second.second);
+          } else if (op.first == BatchLogType::OP_BATCH_MERGE) {
+            code = merge(op.second.first, op.second.second);
           }
           if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
             VLOG(3) << idStr_ << "Failed to call WriteBatch";
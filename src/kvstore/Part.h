@@ -192,7 +192,7 @@ class Part : public raftex::RaftPart {
    * @brief Clean up all data about this part.
    */
   void resetPart() {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     reset();
   }
 
@@ -202,7 +202,7 @@ class Part : public raftex::RaftPart {
    * @return nebula::cpp2::ErrorCode
    */
   nebula::cpp2::ErrorCode cleanupSafely() {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     return cleanup();
   }
 
@@ -313,6 +313,41 @@ class Part : public raftex::RaftPart {
    */
   nebula::cpp2::ErrorCode cleanup() override;
 
+  /**
+   * @brief Append a log of writes. With coalesce_part_writes, the logs appended while a log of
+   * writes is being replicated are merged into one log, which is appended when the former one is
+   * done, so the more concurrent the writes are, the more of them are merged. A merged log holds
+   * at most max_coalesced_writes writes of max_coalesced_write_bytes bytes, unless it has only one.
+   *
+   * @param log Encoded log of writes
+   * @param cb Callback when the log is committed or failed
+   */
+  void appendWrite(std::string&& log, KVCallback cb);
+
+  /**
+   * @brief Run the barrier once all the writes appended before are, e.g. to append an atomic op
+   */
+  void appendBarrier(folly::Function<void()> barrier);
+
+  /**
+   * @brief Whether the pending writes should be appended now, the caller must hold writesLock_
+   */
+  bool writesReady() const;
+
+  /**
+   * @brief Append the pending writes in order, unless another thread is doing it
+   *
+   * @param lk The lock of writesLock_, released while appending
+   */
+  void proposeWrites(std::unique_lock<std::mutex>& lk);
+
+  /**
+   * @brief Callback when a log of writes is done, the pending logs are appended then
+   */
+  void onWritesDone();
+
+  void proposeWrites(std::vector<std::string>&& logs, std::vector<KVCallback>&& callbacks);
+
  public:
   struct CallbackOptions {
     GraphSpaceID spaceId;
@@ -343,6 +378,22 @@ class Part : public raftex::RaftPart {
  private:
   KVEngine* engine_ = nullptr;
   int32_t vIdLen_;
+
+  // A pending log of writes, or a barrier
+  struct PendingWrite {
+    std::string log;
+    KVCallback callback;
+    folly::Function<void()> barrier;
+  };
+
+  std::mutex writesLock_;
+  // Number of the logs of writes being replicated
+  size_t writesInFlight_{0};
+  // Whether a thread is appending the pending writes
+  bool proposing_{false};
+  std::deque<PendingWrite> pendingWrites_;
+  size_t pendingBytes_{0};
+  size_t numBarriers_{0};
 };
 
 }  // namespace kvstore
@@ -0,0 +1,97 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef KVSTORE_PENDINGROWS_H_
+#define KVSTORE_PENDINGROWS_H_
+
+#include "common/base/Base.h"
+#include "common/base/ErrorOr.h"
+#include "kvstore/KVEngine.h"
+#include "kvstore/LogEncoder.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * @brief The rows written by a batch which is not committed to the engine yet. A merge must only
+ * be applied to an existing row, or it leaves an empty value behind, so the merges of the batch are
+ * checked against the rows of the engine and the ones written before them in the batch. The rows
+ * are only tracked since the first merge, the writes before it are read back from the batch.
+ *
+ * The check is done when the logs are applied, so all the replicas skip the same merges.
+ */
+class PendingRows final {
+ public:
+  PendingRows(KVEngine* engine, WriteBatch* batch) : engine_(engine), batch_(batch) {}
+
+  /**
+   * @brief Track a put, remove or range remove added to the batch
+   */
+  void write(BatchLogType type, folly::StringPiece key, folly::StringPiece value) {
+    if (!tracking_) {
+      return;
+    }
+    switch (type) {
+      case BatchLogType::OP_BATCH_PUT:
+        rows_[key.str()] = true;
+        break;
+      case BatchLogType::OP_BATCH_REMOVE:
+        rows_[key.str()] = false;
+        break;
+      case BatchLogType::OP_BATCH_REMOVE_RANGE:
+        rows_.erase(rows_.lower_bound(key.str()), rows_.lower_bound(value.str()));
+        removedRanges_.emplace_back(key.str(), value.str());
+        break;
+      case BatchLogType::OP_BATCH_MERGE:
+        break;
+    }
+  }
+
+  /**
+   * @brief Whether the row exists when the merge into it is applied
+   */
+  ErrorOr<nebula::cpp2::ErrorCode, bool> mergeable(folly::StringPiece key) {
+    if (!tracking_) {
+      tracking_ = true;
+      auto code = batch_->iterate(
+          [this](BatchLogType type, folly::StringPiece k, folly::StringPiece v) {
+            write(type, k, v);
+          });
+      if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        return code;
+      }
+    }
+    auto iter = rows_.find(key.str());
+    if (iter != rows_.end()) {
+      return iter->second;
+    }
+    for (const auto& range : removedRanges_) {
+      if (key >= range.first && key < range.second) {
+        return false;
+      }
+    }
+    std::string value;
+    auto code = engine_->get(key.str(), &value);
+    if (code == nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
+      return false;
+    } else if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+    return true;
+  }
+
+ private:
+  KVEngine* engine_{nullptr};
+  WriteBatch* batch_{nullptr};
+  bool tracking_{false};
+  // key => whether the last write of it is a put
+  std::map<std::string, bool> rows_;
+  std::vector<std::pair<std::string, std::string>> removedRanges_;
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+
+#endif  // KVSTORE_PENDINGROWS_H_
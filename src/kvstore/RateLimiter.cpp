@@ -8,3 +8,71 @@
 DEFINE_bool(skip_wait_in_rate_limiter,
             false,
             "skip the waiting of first second in rate limiter in CI");
+DEFINE_int64(background_io_rate_limit,
+             0,
+             "max bytes of the background io in one second, shared by snapshot, rebuild index, "
+             "stats, ingest and ranged compaction of all the parts on this host, 0 means no limit");
+DEFINE_int64(rebuild_index_host_rate_limit,
+             0,
+             "max bytes of rebuilding index for all the parts on this host in one second, 0 means "
+             "no limit");
+DEFINE_int64(stats_host_rate_limit,
+             0,
+             "max bytes scanned by the stats job for all the parts on this host in one second, 0 "
+             "means no limit");
+DEFINE_int64(ingest_host_rate_limit,
+             0,
+             "max bytes of the sst files ingested on this host in one second, 0 means no limit");
+DEFINE_int64(compact_host_rate_limit,
+             0,
+             "max bytes of the key ranges compacted by the ranged compact jobs on this host in one "
+             "second, 0 means no limit");
+
+DECLARE_int64(snapshot_host_rate_limit);
+
+namespace nebula {
+namespace kvstore {
+
+void BackgroundIoLimiter::consume(IoClass ioClass, int64_t bytes) {
+  if (bytes <= 0) {
+    return;
+  }
+  auto rate = classLimit(ioClass);
+  if (rate > 0) {
+    consume(classLimiters_[static_cast<size_t>(ioClass)], bytes, rate);
+  }
+  auto total = FLAGS_background_io_rate_limit;
+  if (total > 0) {
+    consume(totalLimiter_, bytes, total);
+  }
+}
+
+int64_t BackgroundIoLimiter::classLimit(IoClass ioClass) {
+  switch (ioClass) {
+    case IoClass::kSnapshot:
+      return FLAGS_snapshot_host_rate_limit;
+    case IoClass::kRebuildIndex:
+      return FLAGS_rebuild_index_host_rate_limit;
+    case IoClass::kStats:
+      return FLAGS_stats_host_rate_limit;
+    case IoClass::kIngest:
+      return FLAGS_ingest_host_rate_limit;
+    case IoClass::kCompact:
+      return FLAGS_compact_host_rate_limit;
+    default:
+      return 0;
+  }
+}
+
+void BackgroundIoLimiter::consume(RateLimiter& limiter, int64_t bytes, int64_t rate) {
+  while (bytes > 0) {
+    auto piece = std::min(bytes, rate);
+    limiter.consume(static_cast<double>(piece),  // toConsume
+                    static_cast<double>(rate),   // rate
+                    static_cast<double>(rate));  // burstSize
+    bytes -= piece;
+  }
+}
+
+}  // namespace kvstore
+}  // namespace nebula
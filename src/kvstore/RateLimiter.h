@@ -13,6 +13,11 @@
 #include "common/time/WallClock.h"
 
 DECLARE_bool(skip_wait_in_rate_limiter);
+DECLARE_int64(background_io_rate_limit);
+DECLARE_int64(rebuild_index_host_rate_limit);
+DECLARE_int64(stats_host_rate_limit);
+DECLARE_int64(ingest_host_rate_limit);
+DECLARE_int64(compact_host_rate_limit);
 
 namespace nebula {
 namespace kvstore {
@@ -53,6 +58,56 @@ class RateLimiter {
   std::unique_ptr<folly::DynamicTokenBucket> bucket_;
 };
 
+// The classes of the background io of storaged, which are throttled by BackgroundIoLimiter
+enum class IoClass : uint8_t {
+  kSnapshot = 0,
+  kRebuildIndex,
+  kStats,
+  kIngest,
+  kCompact,
+  kNum,
+};
+
+/**
+ * @brief Limit the background io of all the parts on this host, so that the admin tasks don't take
+ * the io of the foreground queries. Each class has its own cap, e.g. snapshot_host_rate_limit, and
+ * all the classes share the budget of background_io_rate_limit. The limits are read from the flags
+ * on each call, so they could be changed at runtime. The flush and compaction of rocksdb are
+ * limited by rocksdb_rate_limit instead, except that the ranges compacted by the compact jobs are
+ * paced by their sizes here as well. The foreground reads and writes are never throttled.
+ */
+class BackgroundIoLimiter final {
+ public:
+  static BackgroundIoLimiter* instance() {
+    static BackgroundIoLimiter limiter;
+    return &limiter;
+  }
+
+  /**
+   * @brief Consume the bytes of the class, wait until both the budget of the class and the total
+   * budget are enough.
+   *
+   * @param ioClass
+   * @param bytes Bytes read or written
+   */
+  void consume(IoClass ioClass, int64_t bytes);
+
+  /**
+   * @brief Max bytes per second of the class, 0 means no limit
+   */
+  static int64_t classLimit(IoClass ioClass);
+
+ private:
+  BackgroundIoLimiter() = default;
+
+  // Consume the bytes in pieces of no more than the rate, since a larger one is not waited for
+  static void consume(RateLimiter& limiter, int64_t bytes, int64_t rate);
+
+ private:
+  std::array<RateLimiter, static_cast<size_t>(IoClass::kNum)> classLimiters_;
+  RateLimiter totalLimiter_;
+};
+
 }  // namespace kvstore
 }  // namespace nebula
 #endif
@@ -6,15 +6,43 @@
 #include "kvstore/RocksEngine.h"
 
 #include <folly/String.h>
+#include <folly/json.h>
 #include <rocksdb/convenience.h>
+#include <rocksdb/sst_file_reader.h>
+#include <rocksdb/version.h>
+
+#include <numeric>
 
 #include "common/base/Base.h"
 #include "common/fs/FileUtils.h"
 #include "common/utils/MetaKeyUtils.h"
 #include "common/utils/NebulaKeyUtils.h"
 #include "kvstore/KVStore.h"
+#include "kvstore/RateLimiter.h"
+#include "kvstore/RocksScanMode.h"
 
 DEFINE_bool(move_files, false, "Move the SST files instead of copy when ingest into dataset");
+DEFINE_bool(ingest_behind,
+            false,
+            "Ingest the SST files into the bottommost level, so that they are not rewritten by "
+            "compaction, the existing keys take precedence over the ingested ones. It requires "
+            "allow_ingest_behind in rocksdb_db_options");
+DEFINE_bool(rocksdb_multiget_async_io,
+            true,
+            "Read the keys of a MultiGet from different files concurrently, it takes effect "
+            "since rocksdb 7.0");
+DEFINE_uint64(rocksdb_scan_readahead_bytes,
+              2 * 1024 * 1024,
+              "The bytes read ahead by the long scans, e.g. scanning the edges of a part, or "
+              "rebuilding the indexes, 0 means the readahead grows by itself as in rocksdb");
+DEFINE_bool(rocksdb_scan_async_io,
+            true,
+            "Prefetch the next blocks of the long scans asynchronously, it takes effect since "
+            "rocksdb 7.0");
+DEFINE_bool(rocksdb_long_scan_fill_cache,
+            true,
+            "Whether the blocks read by the long scans of the queries fill the block cache, the "
+            "ones read by the jobs and the exports never do");
 DEFINE_int64(balance_expired_sesc,
              86400,
              "The expired time of balancing part info persisted in the storaged");
@@ -25,6 +53,66 @@ namespace kvstore {
 using fs::FileType;
 using fs::FileUtils;
 
+namespace {
+
+// The bytes of a write batch when loading the sst files which could not be ingested directly
+constexpr size_t kIngestWriteBatchSize = 4 * 1024 * 1024;
+
+// Set the options of the iterator by the scan mode of the current thread
+void setScanOptions(rocksdb::ReadOptions* options) {
+  auto mode = ScanModeGuard::current();
+  if (mode == ScanMode::kDefault) {
+    return;
+  }
+  if (FLAGS_rocksdb_scan_readahead_bytes > 0) {
+    options->readahead_size = FLAGS_rocksdb_scan_readahead_bytes;
+  }
+#if ROCKSDB_MAJOR >= 7
+  options->adaptive_readahead = true;
+  options->async_io = FLAGS_rocksdb_scan_async_io;
+#endif
+  options->fill_cache = mode == ScanMode::kLong && FLAGS_rocksdb_long_scan_fill_cache;
+}
+
+// Rewrite a batch whose keys are all in the default column family into the separated ones
+class ColumnFamilyRouter final : public rocksdb::WriteBatch::Handler {
+ public:
+  ColumnFamilyRouter(const RocksColumnFamilies* cfs, rocksdb::WriteBatch* batch)
+      : cfs_(cfs), batch_(batch) {}
+
+  rocksdb::Status PutCF(uint32_t, const rocksdb::Slice& key, const rocksdb::Slice& value) override {
+    return batch_->Put(of(key), key, value);
+  }
+
+  rocksdb::Status DeleteCF(uint32_t, const rocksdb::Slice& key) override {
+    return batch_->Delete(of(key), key);
+  }
+
+  rocksdb::Status SingleDeleteCF(uint32_t, const rocksdb::Slice& key) override {
+    return batch_->SingleDelete(of(key), key);
+  }
+
+  rocksdb::Status DeleteRangeCF(uint32_t,
+                                const rocksdb::Slice& begin,
+                                const rocksdb::Slice& end) override {
+    return batch_->DeleteRange(of(begin), begin, end);
+  }
+
+  rocksdb::Status MergeCF(uint32_t, const rocksdb::Slice& key, const rocksdb::Slice& value) override {
+    return batch_->Merge(of(key), key, value);
+  }
+
+ private:
+  rocksdb::ColumnFamilyHandle* of(const rocksdb::Slice& key) {
+    return cfs_->of(folly::StringPiece(key.data(), key.size()));
+  }
+
+  const RocksColumnFamilies* cfs_;
+  rocksdb::WriteBatch* batch_;
+};
+
+}  // namespace
+
 /***************************************
  *
  * Implementation of RocksEngine
@@ -36,15 +124,17 @@ RocksEngine::RocksEngine(GraphSpaceID spaceId,
                          const std::string& walPath,
                          std::shared_ptr<rocksdb::MergeOperator> mergeOp,
                          std::shared_ptr<rocksdb::CompactionFilterFactory> cfFactory,
-                         bool readonly)
+                         bool readonly,
+                         PartitionID dedicatedPart)
     : KVEngine(spaceId),
       spaceId_(spaceId),
-      dataPath_(folly::stringPrintf("%s/nebula/%d", dataPath.c_str(), spaceId)) {
+      dedicatedPart_(dedicatedPart),
+      dataPath_(folly::stringPrintf("%s/nebula/%d", dataPath.c_str(), spaceId) + partSubPath()) {
   // set wal path as dataPath by default
   if (walPath.empty()) {
-    walPath_ = folly::stringPrintf("%s/nebula/%d", dataPath.c_str(), spaceId);
+    walPath_ = dataPath_;
   } else {
-    walPath_ = folly::stringPrintf("%s/nebula/%d", walPath.c_str(), spaceId);
+    walPath_ = folly::stringPrintf("%s/nebula/%d", walPath.c_str(), spaceId) + partSubPath();
   }
   auto path = folly::stringPrintf("%s/data", dataPath_.c_str());
   if (FileUtils::fileType(path.c_str()) == FileType::NOTEXIST) {
@@ -73,11 +163,25 @@ RocksEngine::RocksEngine(GraphSpaceID spaceId,
   if (cfFactory != nullptr) {
     options.compaction_filter_factory = cfFactory;
   }
+  if (!options.wal_dir.empty()) {
+    // The instances of a space could not share the wal dir
+    options.wal_dir += partSubPath();
+  }
 
-  if (readonly) {
-    status = rocksdb::DB::OpenForReadOnly(options, path, &db);
+  auto descriptors = columnFamilyDescriptors(options, path);
+  if (descriptors.empty()) {
+    if (readonly) {
+      status = rocksdb::DB::OpenForReadOnly(options, path, &db);
+    } else {
+      status = rocksdb::DB::Open(options, path, &db);
+    }
   } else {
-    status = rocksdb::DB::Open(options, path, &db);
+    options.create_missing_column_families = true;
+    if (readonly) {
+      status = rocksdb::DB::OpenForReadOnly(options, path, descriptors, &cfs_.handles, &db);
+    } else {
+      status = rocksdb::DB::Open(options, path, descriptors, &cfs_.handles, &db);
+    }
   }
   CHECK(status.ok()) << status.ToString();
   if (!readonly && spaceId_ != kDefaultSpaceId /* only for storage*/) {
@@ -93,12 +197,51 @@ RocksEngine::RocksEngine(GraphSpaceID spaceId,
   }
   db_.reset(db);
   extractorLen_ = sizeof(PartitionID) + vIdLen;
+  edgeExtractorLen_ = extractorLen_ + (edgeTypePrefixFilterEnabled() ? sizeof(EdgeType) : 0);
+#if ROCKSDB_LAZY_VALUE_SUPPORTED
+  lazyBlobValue_ = FLAGS_rocksdb_enable_kv_separation;
+#endif
   partsNum_ = allParts().size();
   LOG(INFO) << "open rocksdb on " << path;
 
   backup();
 }
 
+std::vector<rocksdb::ColumnFamilyDescriptor> RocksEngine::columnFamilyDescriptors(
+    const rocksdb::Options& options, const std::string& path) {
+  std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+  // Only the data of graph spaces are separated
+  if (spaceId_ == kDefaultSpaceId) {
+    return descriptors;
+  }
+  std::vector<std::string> existed;
+  auto status = rocksdb::DB::ListColumnFamilies(options, path, &existed);
+  if (existed.size() <= 1) {
+    if (!FLAGS_rocksdb_separate_column_families) {
+      return descriptors;
+    }
+    // The data of an existing db are all in the default column family, they would be invisible
+    // to the reads of the separate ones, so only a new db is separated
+    if (status.ok()) {
+      LOG(WARNING) << "The data of space " << spaceId_ << " in " << path
+                   << " are not separated, rocksdb_separate_column_families is ignored";
+      return descriptors;
+    }
+  }
+  for (size_t i = 0; i < RocksColumnFamilies::kNum; i++) {
+    const auto& name = RocksColumnFamilies::name(i);
+    rocksdb::ColumnFamilyOptions cfOpts(options);
+    if (i != RocksColumnFamilies::kDefault) {
+      status = initRocksdbColumnFamilyOptions(cfOpts, name, spaceId_);
+      CHECK(status.ok()) << status.ToString();
+    }
+    descriptors.emplace_back(name, cfOpts);
+  }
+  LOG(INFO) << "tag, edge and index data of space " << spaceId_
+            << " are in separate column families";
+  return descriptors;
+}
+
 void RocksEngine::stop() {
   if (db_) {
     // Because we trigger compaction in WebService, we need to stop all
@@ -108,7 +251,7 @@ void RocksEngine::stop() {
 }
 
 std::unique_ptr<WriteBatch> RocksEngine::startBatchWrite() {
-  return std::make_unique<RocksWriteBatch>();
+  return std::make_unique<RocksWriteBatch>(&cfs_);
 }
 
 nebula::cpp2::ErrorCode RocksEngine::commitBatchWrite(std::unique_ptr<WriteBatch> batch,
@@ -120,7 +263,19 @@ nebula::cpp2::ErrorCode RocksEngine::commitBatchWrite(std::unique_ptr<WriteBatch
   options.sync = sync;
   options.no_slowdown = !wait;
   auto* b = static_cast<RocksWriteBatch*>(batch.get());
-  rocksdb::Status status = db_->Write(options, b->data());
+  auto* data = b->data();
+  rocksdb::WriteBatch routed;
+  if (cfs_.separated() && b->columnFamilies() != &cfs_) {
+    // The batch is not built by this engine, route its keys to our column families
+    ColumnFamilyRouter router(&cfs_, &routed);
+    auto status = data->Iterate(&router);
+    if (!status.ok()) {
+      VLOG(3) << "Route the batch failed because of " << status.ToString();
+      return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+    data = &routed;
+  }
+  rocksdb::Status status = db_->Write(options, data);
   if (status.ok()) {
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   } else if (!wait && status.IsIncomplete()) {
@@ -137,7 +292,7 @@ nebula::cpp2::ErrorCode RocksEngine::get(const std::string& key,
   if (UNLIKELY(snapshot != nullptr)) {
     options.snapshot = reinterpret_cast<const rocksdb::Snapshot*>(snapshot);
   }
-  rocksdb::Status status = db_->Get(options, rocksdb::Slice(key), value);
+  rocksdb::Status status = db_->Get(options, cf(key), rocksdb::Slice(key), value);
   if (status.ok()) {
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   } else if (status.IsNotFound()) {
@@ -152,44 +307,119 @@ nebula::cpp2::ErrorCode RocksEngine::get(const std::string& key,
 std::vector<Status> RocksEngine::multiGet(const std::vector<std::string>& keys,
                                           std::vector<std::string>* values) {
   rocksdb::ReadOptions options;
+#if ROCKSDB_MAJOR >= 7
+  options.async_io = FLAGS_rocksdb_multiget_async_io;
+#endif
+  // Sort the keys by column family and key, so that the batched MultiGet doesn't sort them again,
+  // and the keys in the same block are read together
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::vector<rocksdb::ColumnFamilyHandle*> handles;
+  handles.reserve(keys.size());
+  for (const auto& key : keys) {
+    handles.emplace_back(cf(key));
+  }
+  std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    if (handles[lhs]->GetID() != handles[rhs]->GetID()) {
+      return handles[lhs]->GetID() < handles[rhs]->GetID();
+    }
+    return keys[lhs] < keys[rhs];
+  });
+
+  std::vector<rocksdb::ColumnFamilyHandle*> sortedHandles;
   std::vector<rocksdb::Slice> slices;
-  for (size_t index = 0; index < keys.size(); index++) {
+  sortedHandles.reserve(keys.size());
+  slices.reserve(keys.size());
+  for (auto index : order) {
+    sortedHandles.emplace_back(handles[index]);
     slices.emplace_back(keys[index]);
   }
-
-  auto status = db_->MultiGet(options, slices, values);
-  std::vector<Status> ret;
-  std::transform(status.begin(), status.end(), std::back_inserter(ret), [](const auto& s) {
+  std::vector<rocksdb::PinnableSlice> pinnables(keys.size());
+  std::vector<rocksdb::Status> statuses(keys.size());
+  db_->MultiGet(options,
+                keys.size(),
+                sortedHandles.data(),
+                slices.data(),
+                pinnables.data(),
+                statuses.data(),
+                true);
+
+  // Fill the values and status in the order of input keys
+  values->resize(keys.size());
+  std::vector<Status> ret(keys.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    auto index = order[i];
+    const auto& s = statuses[i];
     if (s.ok()) {
-      return Status::OK();
+      (*values)[index].assign(pinnables[i].data(), pinnables[i].size());
+      ret[index] = Status::OK();
     } else if (s.IsNotFound()) {
-      return Status::KeyNotFound();
+      ret[index] = Status::KeyNotFound();
     } else {
-      return Status::Error();
+      ret[index] = Status::Error();
     }
-  });
+  }
   return ret;
 }
 
 nebula::cpp2::ErrorCode RocksEngine::range(const std::string& start,
                                            const std::string& end,
-                                           std::unique_ptr<KVIterator>* storageIter) {
+                                           std::unique_ptr<KVIterator>* storageIter,
+                                           const void* snapshot) {
   rocksdb::ReadOptions options;
+  if (UNLIKELY(snapshot != nullptr)) {
+    options.snapshot = reinterpret_cast<const rocksdb::Snapshot*>(snapshot);
+  }
   options.total_order_seek = FLAGS_enable_rocksdb_prefix_filtering;
-  rocksdb::Iterator* iter = db_->NewIterator(options);
+  setScanOptions(&options);
+  auto bound = std::make_unique<RocksIterBound>(end);
+  options.iterate_upper_bound = &bound->slice;
+  rocksdb::Iterator* iter = db_->NewIterator(options, cf(start));
   if (iter) {
     iter->Seek(rocksdb::Slice(start));
   }
-  storageIter->reset(new RocksRangeIter(iter, start, end));
+  storageIter->reset(new RocksRangeIter(iter, start, end, std::move(bound)));
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
+std::vector<std::string> RocksEngine::splitRange(const std::string& start,
+                                                 const std::string& end,
+                                                 size_t num) {
+  std::vector<std::string> boundaries;
+  if (num <= 1) {
+    return boundaries;
+  }
+  // The sst files are of similar size, so the smallest keys of the files in the range split it
+  // into sub ranges of similar data size, the data in memtable is ignored
+  auto cfIndex = cfs_.separated() ? RocksColumnFamilies::indexOf(start)
+                                  : static_cast<size_t>(RocksColumnFamilies::kDefault);
+  const auto& cfName = RocksColumnFamilies::name(cfIndex);
+  std::vector<rocksdb::LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  std::vector<std::string> keys;
+  for (const auto& file : files) {
+    if (file.column_family_name == cfName && file.smallestkey > start && file.smallestkey < end) {
+      keys.emplace_back(file.smallestkey);
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  num = std::min(num, keys.size() + 1);
+  for (size_t i = 1; i < num; i++) {
+    boundaries.emplace_back(std::move(keys[i * keys.size() / num]));
+  }
+  return boundaries;
+}
+
 nebula::cpp2::ErrorCode RocksEngine::prefix(const std::string& prefix,
                                             std::unique_ptr<KVIterator>* storageIter,
                                             const void* snapshot) {
   // In fact, we don't need to check prefix.size() >= extractorLen_, which is caller's duty to make
   // sure the prefix bloom filter exists. But this is quite error-prone, so we do a check here.
-  if (FLAGS_enable_rocksdb_prefix_filtering && prefix.size() >= extractorLen_) {
+  auto extractorLen = RocksColumnFamilies::indexOf(prefix) == RocksColumnFamilies::kEdge
+                          ? edgeExtractorLen_
+                          : extractorLen_;
+  if (FLAGS_enable_rocksdb_prefix_filtering && prefix.size() >= extractorLen) {
     return prefixWithExtractor(prefix, snapshot, storageIter);
   } else {
     return prefixWithoutExtractor(prefix, snapshot, storageIter);
@@ -204,11 +434,19 @@ nebula::cpp2::ErrorCode RocksEngine::prefixWithExtractor(const std::string& pref
     options.snapshot = reinterpret_cast<const rocksdb::Snapshot*>(snapshot);
   }
   options.prefix_same_as_start = true;
-  rocksdb::Iterator* iter = db_->NewIterator(options);
+  setScanOptions(&options);
+  auto bound = RocksIterBound::ofPrefix(prefix);
+  if (bound != nullptr) {
+    options.iterate_upper_bound = &bound->slice;
+  }
+#if ROCKSDB_LAZY_VALUE_SUPPORTED
+  options.allow_unprepared_value = lazyBlobValue_;
+#endif
+  rocksdb::Iterator* iter = db_->NewIterator(options, cf(prefix));
   if (iter) {
     iter->Seek(rocksdb::Slice(prefix));
   }
-  storageIter->reset(new RocksPrefixIter(iter, prefix));
+  storageIter->reset(new RocksPrefixIter(iter, prefix, std::move(bound), lazyBlobValue_));
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
@@ -220,11 +458,19 @@ nebula::cpp2::ErrorCode RocksEngine::prefixWithoutExtractor(
   }
   // prefix_same_as_start is false by default
   options.total_order_seek = FLAGS_enable_rocksdb_prefix_filtering;
-  rocksdb::Iterator* iter = db_->NewIterator(options);
+  setScanOptions(&options);
+  auto bound = RocksIterBound::ofPrefix(prefix);
+  if (bound != nullptr) {
+    options.iterate_upper_bound = &bound->slice;
+  }
+#if ROCKSDB_LAZY_VALUE_SUPPORTED
+  options.allow_unprepared_value = lazyBlobValue_;
+#endif
+  rocksdb::Iterator* iter = db_->NewIterator(options, cf(prefix));
   if (iter) {
     iter->Seek(rocksdb::Slice(prefix));
   }
-  storageIter->reset(new RocksPrefixIter(iter, prefix));
+  storageIter->reset(new RocksPrefixIter(iter, prefix, std::move(bound), lazyBlobValue_));
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
@@ -234,17 +480,26 @@ nebula::cpp2::ErrorCode RocksEngine::rangeWithPrefix(const std::string& start,
   rocksdb::ReadOptions options;
   // prefix_same_as_start is false by default
   options.total_order_seek = FLAGS_enable_rocksdb_prefix_filtering;
-  rocksdb::Iterator* iter = db_->NewIterator(options);
+  setScanOptions(&options);
+  auto bound = RocksIterBound::ofPrefix(prefix);
+  if (bound != nullptr) {
+    options.iterate_upper_bound = &bound->slice;
+  }
+#if ROCKSDB_LAZY_VALUE_SUPPORTED
+  options.allow_unprepared_value = lazyBlobValue_;
+#endif
+  rocksdb::Iterator* iter = db_->NewIterator(options, cf(prefix));
   if (iter) {
     iter->Seek(rocksdb::Slice(start));
   }
-  storageIter->reset(new RocksPrefixIter(iter, prefix));
+  storageIter->reset(new RocksPrefixIter(iter, prefix, std::move(bound), lazyBlobValue_));
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
 nebula::cpp2::ErrorCode RocksEngine::scan(std::unique_ptr<KVIterator>* storageIter) {
   rocksdb::ReadOptions options;
   options.total_order_seek = true;
+  setScanOptions(&options);
   rocksdb::Iterator* iter = db_->NewIterator(options);
   iter->SeekToFirst();
   storageIter->reset(new RocksCommonIter(iter));
@@ -254,7 +509,7 @@ nebula::cpp2::ErrorCode RocksEngine::scan(std::unique_ptr<KVIterator>* storageIt
 nebula::cpp2::ErrorCode RocksEngine::put(std::string key, std::string value) {
   rocksdb::WriteOptions options;
   options.disableWAL = FLAGS_rocksdb_disable_wal;
-  rocksdb::Status status = db_->Put(options, key, value);
+  rocksdb::Status status = db_->Put(options, cf(key), key, value);
   if (status.ok()) {
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   } else {
@@ -266,7 +521,7 @@ nebula::cpp2::ErrorCode RocksEngine::put(std::string key, std::string value) {
 nebula::cpp2::ErrorCode RocksEngine::multiPut(std::vector<KV> keyValues) {
   rocksdb::WriteBatch updates(FLAGS_rocksdb_batch_size);
   for (size_t i = 0; i < keyValues.size(); i++) {
-    updates.Put(keyValues[i].first, keyValues[i].second);
+    updates.Put(cf(keyValues[i].first), keyValues[i].first, keyValues[i].second);
   }
   rocksdb::WriteOptions options;
   options.disableWAL = FLAGS_rocksdb_disable_wal;
@@ -282,7 +537,7 @@ nebula::cpp2::ErrorCode RocksEngine::multiPut(std::vector<KV> keyValues) {
 nebula::cpp2::ErrorCode RocksEngine::remove(const std::string& key) {
   rocksdb::WriteOptions options;
   options.disableWAL = FLAGS_rocksdb_disable_wal;
-  auto status = db_->Delete(options, key);
+  auto status = db_->Delete(options, cf(key), key);
   if (status.ok()) {
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   } else {
@@ -294,7 +549,7 @@ nebula::cpp2::ErrorCode RocksEngine::remove(const std::string& key) {
 nebula::cpp2::ErrorCode RocksEngine::multiRemove(std::vector<std::string> keys) {
   rocksdb::WriteBatch deletes(FLAGS_rocksdb_batch_size);
   for (size_t i = 0; i < keys.size(); i++) {
-    deletes.Delete(keys[i]);
+    deletes.Delete(cf(keys[i]), keys[i]);
   }
   rocksdb::WriteOptions options;
   options.disableWAL = FLAGS_rocksdb_disable_wal;
@@ -310,7 +565,7 @@ nebula::cpp2::ErrorCode RocksEngine::multiRemove(std::vector<std::string> keys)
 nebula::cpp2::ErrorCode RocksEngine::removeRange(const std::string& start, const std::string& end) {
   rocksdb::WriteOptions options;
   options.disableWAL = FLAGS_rocksdb_disable_wal;
-  auto status = db_->DeleteRange(options, db_->DefaultColumnFamily(), start, end);
+  auto status = db_->DeleteRange(options, cf(start), start, end);
   if (status.ok()) {
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   } else {
@@ -441,6 +696,21 @@ nebula::cpp2::ErrorCode RocksEngine::ingest(const std::vector<std::string>& file
   rocksdb::IngestExternalFileOptions options;
   options.move_files = FLAGS_move_files;
   options.verify_file_checksum = verifyFileChecksum;
+  if (FLAGS_ingest_behind) {
+    if (!db_->GetDBOptions().allow_ingest_behind) {
+      LOG(WARNING) << "Ingest behind requires allow_ingest_behind when rocksdb is opened";
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    options.ingest_behind = true;
+  }
+  int64_t bytes = 0;
+  for (const auto& file : files) {
+    bytes += fs::FileUtils::fileSize(file.c_str());
+  }
+  BackgroundIoLimiter::instance()->consume(IoClass::kIngest, bytes);
+  if (cfs_.separated()) {
+    return ingestIntoColumnFamilies(files, options);
+  }
   rocksdb::Status status = db_->IngestExternalFile(files, options);
   if (status.ok()) {
     return nebula::cpp2::ErrorCode::SUCCEEDED;
@@ -450,11 +720,100 @@ nebula::cpp2::ErrorCode RocksEngine::ingest(const std::vector<std::string>& file
   }
 }
 
+nebula::cpp2::ErrorCode RocksEngine::ingestIntoColumnFamilies(
+    const std::vector<std::string>& files, const rocksdb::IngestExternalFileOptions& options) {
+  // The files whose keys are all in one column family are ingested into it directly, the others
+  // are loaded by writing their keys
+  std::vector<rocksdb::IngestExternalFileArg> args(RocksColumnFamilies::kNum);
+  std::vector<std::string> mixed;
+  rocksdb::Options readerOptions;
+  for (const auto& file : files) {
+    rocksdb::SstFileReader reader(readerOptions);
+    auto status = reader.Open(file);
+    if (!status.ok()) {
+      LOG(WARNING) << "Open sst file " << file << " failed: " << status.ToString();
+      return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+    std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+    iter->SeekToFirst();
+    if (!iter->Valid()) {
+      continue;
+    }
+    // The keys are sorted by their type first, so all keys are of the same type if the first
+    // and the last one are
+    auto first = iter->key().ToString();
+    iter->SeekToLast();
+    auto last = iter->key().ToString();
+    if (first.empty() || last.empty() || first[0] == last[0]) {
+      args[RocksColumnFamilies::indexOf(first)].external_files.emplace_back(file);
+    } else {
+      mixed.emplace_back(file);
+    }
+  }
+
+  std::vector<rocksdb::IngestExternalFileArg> ingested;
+  for (size_t i = 0; i < args.size(); i++) {
+    if (args[i].external_files.empty()) {
+      continue;
+    }
+    args[i].column_family = cfs_.handles[i];
+    args[i].options = options;
+    ingested.emplace_back(std::move(args[i]));
+  }
+  if (!ingested.empty()) {
+    auto status = db_->IngestExternalFiles(ingested);
+    if (!status.ok()) {
+      LOG(WARNING) << "Ingest Failed: " << status.ToString();
+      return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+  }
+
+  for (const auto& file : mixed) {
+    LOG(INFO) << "Load sst file " << file << " whose keys are in several column families";
+    rocksdb::SstFileReader reader(readerOptions);
+    auto status = reader.Open(file);
+    if (!status.ok()) {
+      LOG(WARNING) << "Open sst file " << file << " failed: " << status.ToString();
+      return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+    std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+    rocksdb::WriteBatch batch(FLAGS_rocksdb_batch_size);
+    rocksdb::WriteOptions writeOptions;
+    writeOptions.disableWAL = FLAGS_rocksdb_disable_wal;
+    for (iter->SeekToFirst(); iter->Valid() && status.ok(); iter->Next()) {
+      auto key = iter->key();
+      batch.Put(cfs_.of(folly::StringPiece(key.data(), key.size())), key, iter->value());
+      if (batch.GetDataSize() >= kIngestWriteBatchSize) {
+        status = db_->Write(writeOptions, &batch);
+        batch.Clear();
+      }
+    }
+    if (status.ok()) {
+      status = db_->Write(writeOptions, &batch);
+    }
+    if (!status.ok()) {
+      LOG(WARNING) << "Load sst file " << file << " failed: " << status.ToString();
+      return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
 nebula::cpp2::ErrorCode RocksEngine::setOption(const std::string& configKey,
                                                const std::string& configValue) {
   std::unordered_map<std::string, std::string> configOptions = {{configKey, configValue}};
 
-  rocksdb::Status status = db_->SetOptions(configOptions);
+  rocksdb::Status status;
+  if (cfs_.separated()) {
+    for (auto* handle : cfs_.handles) {
+      status = db_->SetOptions(handle, configOptions);
+      if (!status.ok()) {
+        break;
+      }
+    }
+  } else {
+    status = db_->SetOptions(configOptions);
+  }
   if (status.ok()) {
     LOG(INFO) << "SetOption Succeeded: " << configKey << ":" << configValue;
     return nebula::cpp2::ErrorCode::SUCCEEDED;
@@ -480,7 +839,15 @@ nebula::cpp2::ErrorCode RocksEngine::setDBOption(const std::string& configKey,
 
 ErrorOr<nebula::cpp2::ErrorCode, std::string> RocksEngine::getProperty(
     const std::string& property) {
+  if (property == kCompressionRatio) {
+    return compressionRatio();
+  }
   std::string value;
+  uint64_t sum = 0;
+  // The integer properties are summed over all column families
+  if (cfs_.separated() && db_->GetAggregatedIntProperty(property, &sum)) {
+    return folly::to<std::string>(sum);
+  }
   if (!db_->GetProperty(property, &value)) {
     return nebula::cpp2::ErrorCode::E_INVALID_PARM;
   } else {
@@ -488,11 +855,47 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> RocksEngine::getProperty(
   }
 }
 
+ErrorOr<nebula::cpp2::ErrorCode, std::string> RocksEngine::compressionRatio() {
+  std::vector<rocksdb::ColumnFamilyHandle*> handles = cfs_.handles;
+  if (handles.empty()) {
+    handles.emplace_back(db_->DefaultColumnFamily());
+  }
+  int64_t rawBytes = 0;
+  int64_t dataBytes = 0;
+  for (auto* handle : handles) {
+    rocksdb::TablePropertiesCollection props;
+    auto status = db_->GetPropertiesOfAllTables(handle, &props);
+    if (!status.ok()) {
+      LOG(WARNING) << "Get table properties failed: " << status.ToString();
+      return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+    for (const auto& file : props) {
+      rawBytes += file.second->raw_key_size + file.second->raw_value_size;
+      dataBytes += file.second->data_size;
+    }
+  }
+  folly::dynamic obj = folly::dynamic::object;
+  obj["raw_bytes"] = rawBytes;
+  obj["data_bytes"] = dataBytes;
+  obj["ratio"] = dataBytes == 0 ? 0.0 : static_cast<double>(rawBytes) / dataBytes;
+  return folly::toJson(obj);
+}
+
 nebula::cpp2::ErrorCode RocksEngine::compact() {
   rocksdb::CompactRangeOptions options;
   options.change_level = FLAGS_rocksdb_compact_change_level;
   options.target_level = FLAGS_rocksdb_compact_target_level;
-  rocksdb::Status status = db_->CompactRange(options, nullptr, nullptr);
+  rocksdb::Status status;
+  if (cfs_.separated()) {
+    for (auto* handle : cfs_.handles) {
+      status = db_->CompactRange(options, handle, nullptr, nullptr);
+      if (!status.ok()) {
+        break;
+      }
+    }
+  } else {
+    status = db_->CompactRange(options, nullptr, nullptr);
+  }
   if (status.ok()) {
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   } else {
@@ -501,9 +904,69 @@ nebula::cpp2::ErrorCode RocksEngine::compact() {
   }
 }
 
+nebula::cpp2::ErrorCode RocksEngine::compactRange(const std::string& start,
+                                                  const std::string& end) {
+  auto* handle = cfs_.of(start);
+  if (handle == nullptr) {
+    handle = db_->DefaultColumnFamily();
+  }
+  rocksdb::Slice begin(start);
+  rocksdb::Slice last(end);
+  // Pace the compactions of the ranges by their sizes, so that a job compacting many ranges
+  // doesn't take all the background io
+  rocksdb::Range range(begin, last);
+  uint64_t size = 0;
+  auto status = db_->GetApproximateSizes(handle, &range, 1, &size);
+  if (status.ok()) {
+    BackgroundIoLimiter::instance()->consume(IoClass::kCompact, static_cast<int64_t>(size));
+  }
+
+  rocksdb::CompactRangeOptions options;
+  // The tombstones are only dropped once they reach the bottommost level
+  options.bottommost_level_compaction = rocksdb::BottommostLevelCompaction::kForceOptimized;
+  status = db_->CompactRange(options, handle, &begin, &last);
+  if (!status.ok()) {
+    LOG(WARNING) << "Compact range [" << folly::hexlify(start) << ", " << folly::hexlify(end)
+                 << "] failed: " << status.ToString();
+    return nebula::cpp2::ErrorCode::E_UNKNOWN;
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+std::vector<std::pair<std::string, std::string>> RocksEngine::tombstoneRanges(double ratio) {
+  std::vector<rocksdb::LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  files.erase(std::remove_if(files.begin(),
+                             files.end(),
+                             [ratio](const auto& file) {
+                               return file.num_entries == 0 ||
+                                      file.num_deletions < ratio * file.num_entries;
+                             }),
+              files.end());
+  std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) {
+    return std::tie(a.column_family_name, a.smallestkey) <
+           std::tie(b.column_family_name, b.smallestkey);
+  });
+
+  // The overlapping ranges of the same column family are compacted at once
+  std::vector<std::pair<std::string, std::string>> ranges;
+  const std::string* lastFamily = nullptr;
+  for (const auto& file : files) {
+    if (lastFamily != nullptr && *lastFamily == file.column_family_name &&
+        file.smallestkey <= ranges.back().second) {
+      ranges.back().second = std::max(ranges.back().second, file.largestkey);
+    } else {
+      ranges.emplace_back(file.smallestkey, file.largestkey);
+    }
+    lastFamily = &file.column_family_name;
+  }
+  return ranges;
+}
+
 nebula::cpp2::ErrorCode RocksEngine::flush() {
   rocksdb::FlushOptions options;
-  rocksdb::Status status = db_->Flush(options);
+  rocksdb::Status status =
+      cfs_.separated() ? db_->Flush(options, cfs_.handles) : db_->Flush(options);
   if (status.ok()) {
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   } else {
@@ -531,7 +994,8 @@ void RocksEngine::openBackupEngine(GraphSpaceID spaceId) {
   // If backup dir is not empty, set backup related options
   if (FLAGS_rocksdb_table_format == "PlainTable" && !FLAGS_rocksdb_backup_dir.empty()) {
     backupPath_ =
-        folly::stringPrintf("%s/rocksdb_backup/%d", FLAGS_rocksdb_backup_dir.c_str(), spaceId);
+        folly::stringPrintf("%s/rocksdb_backup/%d", FLAGS_rocksdb_backup_dir.c_str(), spaceId) +
+        partSubPath();
     if (FileUtils::fileType(backupPath_.c_str()) == FileType::NOTEXIST) {
       if (!FileUtils::makeDir(backupPath_)) {
         LOG(FATAL) << "makeDir " << backupPath_ << " failed";
@@ -548,7 +1012,8 @@ void RocksEngine::openBackupEngine(GraphSpaceID spaceId) {
     std::string dataPath = folly::stringPrintf("%s/data", dataPath_.c_str());
     auto walDir = dataPath;
     if (!FLAGS_rocksdb_wal_dir.empty()) {
-      walDir = folly::stringPrintf("%s/rocksdb_wal/%d", FLAGS_rocksdb_wal_dir.c_str(), spaceId);
+      walDir = folly::stringPrintf("%s/rocksdb_wal/%d", FLAGS_rocksdb_wal_dir.c_str(), spaceId) +
+               partSubPath();
     } else {
       LOG(WARNING) << "rocksdb wal is stored with data. If data_path is on tmpfs, the wal is "
                       "volatile as well";
@@ -10,22 +10,67 @@
 #include <rocksdb/db.h>
 #include <rocksdb/utilities/backup_engine.h>
 #include <rocksdb/utilities/checkpoint.h>
+#include <rocksdb/version.h>
 
 #include "common/base/Base.h"
+#include "common/utils/Types.h"
 #include "kvstore/KVEngine.h"
 #include "kvstore/KVIterator.h"
 #include "kvstore/RocksEngineConfig.h"
 
+// The values of the iterators are read on demand since rocksdb 9.4
+#define ROCKSDB_LAZY_VALUE_SUPPORTED \
+  (ROCKSDB_MAJOR > 9 || (ROCKSDB_MAJOR == 9 && ROCKSDB_MINOR >= 4))
+
 namespace nebula {
 namespace kvstore {
 
+/**
+ * @brief Upper bound of a rocksdb iterator, with which rocksdb stops at the bound instead of
+ * scanning over the tombstones after it. The bound is set in the read options by address, so it
+ * must outlive the iterator.
+ */
+struct RocksIterBound {
+  explicit RocksIterBound(std::string key) : key(std::move(key)), slice(this->key) {}
+
+  RocksIterBound(const RocksIterBound&) = delete;
+  RocksIterBound& operator=(const RocksIterBound&) = delete;
+
+  /**
+   * @brief Return the bound of the keys starting with the prefix, i.e. the prefix with the last
+   * byte not 0xFF increased by one
+   *
+   * @return std::unique_ptr<RocksIterBound> nullptr if there is no such bound
+   */
+  static std::unique_ptr<RocksIterBound> ofPrefix(folly::StringPiece prefix) {
+    std::string key = prefix.str();
+    while (!key.empty() && static_cast<uint8_t>(key.back()) == 0xFF) {
+      key.pop_back();
+    }
+    if (key.empty()) {
+      return nullptr;
+    }
+    key.back() = static_cast<char>(static_cast<uint8_t>(key.back()) + 1);
+    return std::make_unique<RocksIterBound>(std::move(key));
+  }
+
+  std::string key;
+  rocksdb::Slice slice;
+};
+
 /**
  * @brief Rocksdb range iterator, only scan data in range [start, end)
  */
 class RocksRangeIter : public KVIterator {
  public:
-  RocksRangeIter(rocksdb::Iterator* iter, rocksdb::Slice start, rocksdb::Slice end)
-      : iter_(iter), start_(start), end_(end) {}
+  RocksRangeIter(rocksdb::Iterator* iter,
+                 rocksdb::Slice start,
+                 rocksdb::Slice end,
+                 std::unique_ptr<RocksIterBound> bound = nullptr)
+      : bound_(std::move(bound)),
+        iter_(iter),
+        start_(start),
+        end_(bound_ != nullptr ? bound_->slice : end) {}
 
   ~RocksRangeIter() = default;
 
@@ -41,6 +86,10 @@ class RocksRangeIter : public KVIterator {
     iter_->Prev();
   }
 
+  void seek(folly::StringPiece target) override {
+    iter_->Seek(rocksdb::Slice(target.data(), target.size()));
+  }
+
   folly::StringPiece key() const override {
     return folly::StringPiece(iter_->key().data(), iter_->key().size());
   }
@@ -50,22 +99,40 @@ class RocksRangeIter : public KVIterator {
   }
 
  private:
+  // Destroyed after the iterator
+  std::unique_ptr<RocksIterBound> bound_;
   std::unique_ptr<rocksdb::Iterator> iter_;
   rocksdb::Slice start_;
+  // Refers to the bound if any, so the iterator doesn't depend on the end key of the caller
   rocksdb::Slice end_;
 };
 
 /**
- * @brief Rocksdb prefix iterator, only scan data starts with prefix
+ * @brief Rocksdb prefix iterator, only scan data starts with prefix. If the value is lazy, i.e. the
+ * iterator is created with allow_unprepared_value, the blob of a separated value is only read when
+ * the value is accessed, so the scans only reading the keys don't load the blobs.
  */
 class RocksPrefixIter : public KVIterator {
  public:
-  RocksPrefixIter(rocksdb::Iterator* iter, rocksdb::Slice prefix) : iter_(iter), prefix_(prefix) {}
+  RocksPrefixIter(rocksdb::Iterator* iter,
+                  rocksdb::Slice prefix,
+                  std::unique_ptr<RocksIterBound> bound = nullptr,
+                  bool lazyValue = false)
+      : bound_(std::move(bound)), iter_(iter), prefix_(prefix), lazyValue_(lazyValue) {}
 
   ~RocksPrefixIter() = default;
 
   bool valid() const override {
-    return !!iter_ && iter_->Valid() && (iter_->key().starts_with(prefix_));
+    if (!iter_ || !iter_->Valid()) {
+      return false;
+    }
+    // Moving forward from a key with the prefix, the keys are less than the upper bound of the
+    // prefix, at which the iterator stops by itself, so they have the prefix without comparing
+    if (bound_ != nullptr && inPrefix_) {
+      return true;
+    }
+    inPrefix_ = iter_->key().starts_with(prefix_);
+    return inPrefix_;
   }
 
   void next() override {
@@ -74,6 +141,12 @@ class RocksPrefixIter : public KVIterator {
 
   void prev() override {
     iter_->Prev();
+    inPrefix_ = false;
+  }
+
+  void seek(folly::StringPiece target) override {
+    iter_->Seek(rocksdb::Slice(target.data(), target.size()));
+    inPrefix_ = false;
   }
 
   folly::StringPiece key() const override {
@@ -81,12 +154,23 @@ class RocksPrefixIter : public KVIterator {
   }
 
   folly::StringPiece val() const override {
+#if ROCKSDB_LAZY_VALUE_SUPPORTED
+    if (lazyValue_ && !iter_->PrepareValue()) {
+      LOG(WARNING) << "Read the value failed: " << iter_->status().ToString();
+      return folly::StringPiece();
+    }
+#endif
     return folly::StringPiece(iter_->value().data(), iter_->value().size());
   }
 
  protected:
+  // Destroyed after the iterator
+  std::unique_ptr<RocksIterBound> bound_;
   std::unique_ptr<rocksdb::Iterator> iter_;
   rocksdb::Slice prefix_;
+  bool lazyValue_{false};
+  // Whether the current key is known to have the prefix
+  mutable bool inPrefix_{false};
 };
 
 /**
@@ -110,6 +194,10 @@ class RocksCommonIter : public KVIterator {
     iter_->Prev();
   }
 
+  void seek(folly::StringPiece target) override {
+    iter_->Seek(rocksdb::Slice(target.data(), target.size()));
+  }
+
   folly::StringPiece key() const override {
     return folly::StringPiece(iter_->key().data(), iter_->key().size());
   }
@@ -122,6 +210,65 @@ class RocksCommonIter : public KVIterator {
   std::unique_ptr<rocksdb::Iterator> iter_;
 };
 
+/**
+ * @brief The column families of a rocksdb instance. The tag, edge and index data of a space could
+ * be placed in separate column families, each with its own options and data path, the other keys
+ * are always in the default one. There is only the default column family if they are not
+ * separated.
+ */
+struct RocksColumnFamilies {
+  enum Index : size_t {
+    kDefault = 0,
+    kTag = 1,
+    kEdge = 2,
+    kIndex = 3,
+    kNum = 4,
+  };
+
+  /**
+   * @brief Return the name of the column family
+   */
+  static const std::string& name(size_t index) {
+    static const std::vector<std::string> names = {
+        rocksdb::kDefaultColumnFamilyName, "tag", "edge", "index"};
+    return names[index];
+  }
+
+  /**
+   * @brief Return the index of the column family which the key belongs to, the key type is the
+   * first byte of every key
+   */
+  static size_t indexOf(folly::StringPiece key) {
+    if (key.empty()) {
+      return kDefault;
+    }
+    switch (static_cast<NebulaKeyType>(static_cast<uint8_t>(key[0]))) {
+      case NebulaKeyType::kTag_:
+      case NebulaKeyType::kVertex:
+        return kTag;
+      case NebulaKeyType::kEdge:
+        return kEdge;
+      case NebulaKeyType::kIndex:
+        return kIndex;
+      default:
+        return kDefault;
+    }
+  }
+
+  bool separated() const {
+    return handles.size() > 1;
+  }
+
+  /**
+   * @brief Return the column family of the key, nullptr means the default column family
+   */
+  rocksdb::ColumnFamilyHandle* of(folly::StringPiece key) const {
+    return separated() ? handles[indexOf(key)] : nullptr;
+  }
+
+  std::vector<rocksdb::ColumnFamilyHandle*> handles;
+};
+
 /***************************************
  *
  * Implementation of WriteBatch
@@ -130,14 +277,24 @@ class RocksCommonIter : public KVIterator {
 class RocksWriteBatch : public WriteBatch {
  private:
   rocksdb::WriteBatch batch_;
+  // The column families which the keys are routed to, the keys are all written into the default
+  // column family if it is null
+  const RocksColumnFamilies* cfs_{nullptr};
+
+  rocksdb::ColumnFamilyHandle* cf(folly::StringPiece key) {
+    return cfs_ == nullptr ? nullptr : cfs_->of(key);
+  }
 
  public:
   RocksWriteBatch() : batch_(FLAGS_rocksdb_batch_size) {}
 
+  explicit RocksWriteBatch(const RocksColumnFamilies* cfs)
+      : batch_(FLAGS_rocksdb_batch_size), cfs_(cfs) {}
+
   virtual ~RocksWriteBatch() = default;
 
   nebula::cpp2::ErrorCode put(folly::StringPiece key, folly::StringPiece value) override {
-    if (batch_.Put(toSlice(key), toSlice(value)).ok()) {
+    if (batch_.Put(cf(key), toSlice(key), toSlice(value)).ok()) {
       return nebula::cpp2::ErrorCode::SUCCEEDED;
     } else {
       return nebula::cpp2::ErrorCode::E_UNKNOWN;
@@ -145,7 +302,7 @@ class RocksWriteBatch : public WriteBatch {
   }
 
   nebula::cpp2::ErrorCode remove(folly::StringPiece key) override {
-    if (batch_.Delete(toSlice(key)).ok()) {
+    if (batch_.Delete(cf(key), toSlice(key)).ok()) {
       return nebula::cpp2::ErrorCode::SUCCEEDED;
     } else {
       return nebula::cpp2::ErrorCode::E_UNKNOWN;
@@ -154,7 +311,62 @@ class RocksWriteBatch : public WriteBatch {
 
   // Remove all keys in the range [start, end)
   nebula::cpp2::ErrorCode removeRange(folly::StringPiece start, folly::StringPiece end) override {
-    if (batch_.DeleteRange(toSlice(start), toSlice(end)).ok()) {
+    if (batch_.DeleteRange(cf(start), toSlice(start), toSlice(end)).ok()) {
+      return nebula::cpp2::ErrorCode::SUCCEEDED;
+    } else {
+      return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+  }
+
+  nebula::cpp2::ErrorCode merge(folly::StringPiece key, folly::StringPiece operand) override {
+    if (batch_.Merge(cf(key), toSlice(key), toSlice(operand)).ok()) {
+      return nebula::cpp2::ErrorCode::SUCCEEDED;
+    } else {
+      return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+  }
+
+  nebula::cpp2::ErrorCode iterate(const Visitor& visitor) override {
+    class Handler : public rocksdb::WriteBatch::Handler {
+     public:
+      explicit Handler(const Visitor& visitor) : visitor_(visitor) {}
+
+      rocksdb::Status PutCF(uint32_t,
+                            const rocksdb::Slice& key,
+                            const rocksdb::Slice& value) override {
+        visitor_(BatchLogType::OP_BATCH_PUT, toPiece(key), toPiece(value));
+        return rocksdb::Status::OK();
+      }
+
+      rocksdb::Status DeleteCF(uint32_t, const rocksdb::Slice& key) override {
+        visitor_(BatchLogType::OP_BATCH_REMOVE, toPiece(key), "");
+        return rocksdb::Status::OK();
+      }
+
+      rocksdb::Status DeleteRangeCF(uint32_t,
+                                    const rocksdb::Slice& start,
+                                    const rocksdb::Slice& end) override {
+        visitor_(BatchLogType::OP_BATCH_REMOVE_RANGE, toPiece(start), toPiece(end));
+        return rocksdb::Status::OK();
+      }
+
+      rocksdb::Status MergeCF(uint32_t,
+                              const rocksdb::Slice& key,
+                              const rocksdb::Slice& operand) override {
+        visitor_(BatchLogType::OP_BATCH_MERGE, toPiece(key), toPiece(operand));
+        return rocksdb::Status::OK();
+      }
+
+     private:
+      static folly::StringPiece toPiece(const rocksdb::Slice& slice) {
+        return folly::StringPiece(slice.data(), slice.size());
+      }
+
+      const Visitor& visitor_;
+    };
+
+    Handler handler(visitor);
+    if (batch_.Iterate(&handler).ok()) {
       return nebula::cpp2::ErrorCode::SUCCEEDED;
     } else {
       return nebula::cpp2::ErrorCode::E_UNKNOWN;
@@ -164,6 +376,10 @@ class RocksWriteBatch : public WriteBatch {
   rocksdb::WriteBatch* data() {
     return &batch_;
   }
+
+  const RocksColumnFamilies* columnFamilies() const {
+    return cfs_;
+  }
 };
 /**
  * @brief An implementation of KVEngine based on Rocksdb
@@ -173,6 +389,10 @@ class RocksEngine : public KVEngine {
   FRIEND_TEST(RocksEngineTest, SimpleTest);
 
  public:
+  // Not a property of rocksdb, but the json of the raw bytes of the keys and values in the sst
+  // files, the bytes of the data blocks they are compressed into, and the ratio of the two
+  static constexpr const char* kCompressionRatio = "nebula.compression-ratio";
+
   /**
    * @brief Construct a new rocksdb instance
    *
@@ -183,6 +403,8 @@ class RocksEngine : public KVEngine {
    * @param mergeOp Rocksdb merge operation
    * @param cfFactory Rocksdb compaction filter factory
    * @param readonly Whether start as read only instance
+   * @param dedicatedPart The only part of the instance, which is rooted at parts/<partId> of the
+   * space. 0 means the instance is shared by the parts of the space on the data path
    */
   RocksEngine(GraphSpaceID spaceId,
               int32_t vIdLen,
@@ -190,9 +412,15 @@ class RocksEngine : public KVEngine {
               const std::string& walPath = "",
               std::shared_ptr<rocksdb::MergeOperator> mergeOp = nullptr,
               std::shared_ptr<rocksdb::CompactionFilterFactory> cfFactory = nullptr,
-              bool readonly = false);
+              bool readonly = false,
+              PartitionID dedicatedPart = 0);
 
   ~RocksEngine() {
+    if (cfs_.separated()) {
+      for (auto* handle : cfs_.handles) {
+        db_->DestroyColumnFamilyHandle(handle);
+      }
+    }
     LOG(INFO) << "Release rocksdb on " << dataPath_;
   }
 
@@ -213,6 +441,10 @@ class RocksEngine : public KVEngine {
     return walPath_.c_str();
   }
 
+  PartitionID dedicatedPart() const override {
+    return dedicatedPart_;
+  }
+
   /**
    * @brief Get the rocksdb snapshot
    *
@@ -284,11 +516,25 @@ class RocksEngine : public KVEngine {
    * @param start Start key, inclusive
    * @param end End key, exclusive
    * @param iter Iterator in range [start, end)
+   * @param snapshot Snapshot from rocksdb
    * @return nebula::cpp2::ErrorCode
    */
   nebula::cpp2::ErrorCode range(const std::string& start,
                                 const std::string& end,
-                                std::unique_ptr<KVIterator>* iter) override;
+                                std::unique_ptr<KVIterator>* iter,
+                                const void* snapshot = nullptr) override;
+
+  /**
+   * @brief Split the range [start, end) by the boundaries of the sst files in it
+   *
+   * @param start Start key, inclusive
+   * @param end End key, exclusive
+   * @param num Max number of sub ranges
+   * @return std::vector<std::string> The boundaries between the sub ranges in order
+   */
+  std::vector<std::string> splitRange(const std::string& start,
+                                      const std::string& end,
+                                      size_t num) override;
 
   /**
    * @brief Get all results with 'prefix' str as prefix.
@@ -468,7 +714,7 @@ class RocksEngine : public KVEngine {
   /**
    * @brief Get engine property
    *
-   * @param property Config name
+   * @param property Property name of rocksdb, or kCompressionRatio
    * @return ErrorOr<nebula::cpp2::ErrorCode, std::string>
    */
   ErrorOr<nebula::cpp2::ErrorCode, std::string> getProperty(const std::string& property) override;
@@ -480,6 +726,24 @@ class RocksEngine : public KVEngine {
    */
   nebula::cpp2::ErrorCode compact() override;
 
+  /**
+   * @brief Compact the keys in [start, end], which is paced by its approximate size
+   *
+   * @param start The first key of the range
+   * @param end The last key of the range
+   * @return nebula::cpp2::ErrorCode
+   */
+  nebula::cpp2::ErrorCode compactRange(const std::string& start, const std::string& end) override;
+
+  /**
+   * @brief Get the key ranges of the sst files of which the ratio of tombstones is no less than
+   * the given one
+   *
+   * @param ratio Ratio of the deletions to all the entries of a file
+   * @return std::vector<std::pair<std::string, std::string>> The first and last key of each range
+   */
+  std::vector<std::pair<std::string, std::string>> tombstoneRanges(double ratio) override;
+
   /**
    * @brief Flush data in memtable into sst
    *
@@ -543,15 +807,61 @@ class RocksEngine : public KVEngine {
    */
   void openBackupEngine(GraphSpaceID spaceId);
 
+  /**
+   * @brief Return the json of kCompressionRatio, summed over the table properties of all sst files
+   */
+  ErrorOr<nebula::cpp2::ErrorCode, std::string> compressionRatio();
+
+  /**
+   * @brief Return the sub path of the dedicated part, which is appended to the paths shared by the
+   * instances of the space
+   */
+  std::string partSubPath() const {
+    return dedicatedPart_ == 0 ? "" : folly::stringPrintf("/parts/%d", dedicatedPart_);
+  }
+
+  /**
+   * @brief Return the column family which the key belongs to
+   */
+  rocksdb::ColumnFamilyHandle* cf(folly::StringPiece key) {
+    auto* handle = cfs_.of(key);
+    return handle == nullptr ? db_->DefaultColumnFamily() : handle;
+  }
+
+  /**
+   * @brief Build the descriptors of the column families to open, the tag, edge and index data are
+   * separated if they have been separated before, or the db is new and
+   * rocksdb_separate_column_families is enabled
+   *
+   * @param options Rocksdb options, the base options of all column families
+   * @param path Rocksdb data path
+   * @return std::vector<rocksdb::ColumnFamilyDescriptor> Empty if data are not separated
+   */
+  std::vector<rocksdb::ColumnFamilyDescriptor> columnFamilyDescriptors(
+      const rocksdb::Options& options, const std::string& path);
+
+  /**
+   * @brief Ingest the sst files into the column families which their keys belong to
+   */
+  nebula::cpp2::ErrorCode ingestIntoColumnFamilies(const std::vector<std::string>& files,
+                                                  const rocksdb::IngestExternalFileOptions& options);
+
  private:
   GraphSpaceID spaceId_;
+  PartitionID dedicatedPart_{0};
   std::string dataPath_;
   std::string walPath_;
   std::unique_ptr<rocksdb::DB> db_{nullptr};
+  RocksColumnFamilies cfs_;
   std::string backupPath_;
   std::unique_ptr<rocksdb::BackupEngine> backupDb_{nullptr};
   int32_t partsNum_ = -1;
   size_t extractorLen_;
+  // Length of the prefix extractor of the edge keys, which covers the edge type if
+  // rocksdb_edge_type_prefix_filter is on
+  size_t edgeExtractorLen_;
+  // Whether the blobs of the separated values are read only when the values are accessed
+  bool lazyBlobValue_{false};
 };
 
 }  // namespace kvstore
@@ -10,15 +10,21 @@
 #include <rocksdb/convenience.h>
 #include <rocksdb/db.h>
 #include <rocksdb/filter_policy.h>
+#include <rocksdb/memory_allocator.h>
+#include <rocksdb/persistent_cache.h>
 #include <rocksdb/rate_limiter.h>
 #include <rocksdb/slice_transform.h>
 #include <rocksdb/utilities/options_util.h>
+#include <rocksdb/version.h>
+#include <rocksdb/write_buffer_manager.h>
 
 #include "common/base/Base.h"
 #include "common/conf/Configuration.h"
 #include "common/fs/FileUtils.h"
+#include "common/thread/MemoryArenas.h"
 #include "common/utils/NebulaKeyUtils.h"
 #include "kvstore/EventListener.h"
+#include "kvstore/SpaceCacheStatistics.h"
 
 // [WAL]
 DEFINE_bool(rocksdb_disable_wal, false, "Whether to disable the WAL in rocksdb");
@@ -38,6 +44,33 @@ DEFINE_string(rocksdb_block_based_table_options,
               "{}",
               "json string of BlockBasedTableOptions, all keys and values are string");
 
+// [CFOptions "tag"/"edge"/"index"]
+DEFINE_bool(rocksdb_separate_column_families,
+            false,
+            "Whether to place the tag, edge and index data of a new space in separate column "
+            "families, the existing spaces are not separated, and the data could not be merged "
+            "back once separated");
+
+DEFINE_string(rocksdb_tag_column_family_options,
+              "{}",
+              "json string of ColumnFamilyOptions of the tag data, which overrides the default "
+              "ones, e.g. {\"block_based_table_factory\":\"{block_size=8192;block_cache=1G}\"}");
+
+DEFINE_string(rocksdb_edge_column_family_options,
+              "{}",
+              "json string of ColumnFamilyOptions of the edge data, which overrides the default ones");
+
+DEFINE_string(rocksdb_index_column_family_options,
+              "{}",
+              "json string of ColumnFamilyOptions of the index data, which overrides the default "
+              "ones");
+
+DEFINE_string(rocksdb_column_family_paths,
+              "{}",
+              "json string of the data path of each separated column family, e.g. "
+              "{\"tag\":\"/nvme\",\"edge\":\"/ssd\"}, the column families not specified are "
+              "saved in the data path of the space");
+
 DEFINE_int32(rocksdb_batch_size, 4 * 1024, "default reserved bytes for one batch operation");
 
 /*
@@ -50,6 +83,46 @@ DEFINE_int64(rocksdb_block_cache,
              1024,
              "The default block cache size used in BlockBasedTable. The unit is MB");
 
+DEFINE_string(rocksdb_block_cache_type,
+              "lru",
+              "Type of the block cache, lru or hyper_clock. hyper_clock requires rocksdb 8 or "
+              "later");
+
+DEFINE_string(rocksdb_space_block_cache,
+              "",
+              "Block cache reserved for the spaces, e.g. \"1:1024,5:256\" reserves 1024MB for "
+              "space 1 and 256MB for space 5. The reserved caches are carved out of "
+              "rocksdb_block_cache, and the other spaces share the rest");
+
+DEFINE_bool(rocksdb_cache_index_and_filter_blocks,
+            false,
+            "Whether to charge the index and filter blocks to the block cache, instead of keeping "
+            "them in the memory of the table readers");
+
+DEFINE_int64(rocksdb_memtable_budget,
+             0,
+             "Total size of the memtables of all the spaces, which is charged to the shared block "
+             "cache if any. The memtables are flushed once the total exceeds the budget. The unit "
+             "is MB, 0 means the memtables of each space are bounded by their own options only");
+
+DEFINE_bool(rocksdb_memtable_allow_stall,
+            false,
+            "Whether to stall the writes of all the spaces once the memtables exceed "
+            "rocksdb_memtable_budget, until the flushes free enough memory");
+
+DEFINE_string(rocksdb_persistent_cache_path,
+              "",
+              "Path of the persistent block cache on flash, which is the secondary tier of the "
+              "block cache. Empty means no persistent cache");
+
+DEFINE_int64(rocksdb_persistent_cache_size,
+             0,
+             "Size of the persistent block cache. The unit is MB");
+
+DEFINE_bool(enable_space_block_cache_stats,
+            false,
+            "Whether to export the block cache hits and misses of each space");
+
 DEFINE_bool(disable_page_cache,
             false,
             "Disable page cache to better control memory used by rocksdb.");
@@ -78,6 +151,16 @@ DEFINE_string(rocksdb_compression_per_level,
               "e.g. \"no:no:lz4:lz4::zstd\" === "
               "\"no:no:lz4:lz4:lz4:snappy:zstd:snappy\"");
 
+DEFINE_int32(rocksdb_compression_dict_bytes,
+             0,
+             "The max bytes of the dictionary trained for the compression of each sst file, "
+             "which works with zstd, 0 means no dictionary, e.g. 16384");
+
+DEFINE_string(rocksdb_space_compression_dict_bytes,
+              "",
+              "The bytes of the compression dictionary of the spaces overriding "
+              "rocksdb_compression_dict_bytes, e.g. \"1:16384,5:0\"");
+
 DEFINE_bool(enable_rocksdb_statistics, false, "Whether or not to enable rocksdb's statistics");
 DEFINE_string(rocksdb_stats_level, "kExceptHistogramOrTimers", "rocksdb statistics level");
 
@@ -85,7 +168,32 @@ DEFINE_int32(num_compaction_threads, 0, "Number of total compaction threads. 0 m
 
 DEFINE_int32(rocksdb_rate_limit,
              0,
-             "write limit in bytes per sec. The unit is MB. 0 means unlimited.");
+             "write limit in bytes per sec. The unit is MB. 0 means unlimited. It could be changed "
+             "at runtime if it is enabled when storaged starts.");
+
+namespace {
+// The rate limiter of flush and compaction shared by all the rocksdb instances
+std::mutex rocksdbRateLimiterLock;
+std::shared_ptr<rocksdb::RateLimiter> rocksdbRateLimiter;
+
+bool updateRocksdbRateLimit(const char* flagName, int32_t value) {
+  std::lock_guard<std::mutex> guard(rocksdbRateLimiterLock);
+  if (rocksdbRateLimiter == nullptr) {
+    // Takes effect when the rocksdb instances are opened
+    return true;
+  }
+  if (value <= 0) {
+    LOG(WARNING) << "The rate limiter of rocksdb could not be removed at runtime, --" << flagName
+                 << " should be greater than 0";
+    return false;
+  }
+  rocksdbRateLimiter->SetBytesPerSecond(static_cast<int64_t>(value) * 1024 * 1024);
+  LOG(INFO) << "The rate limit of rocksdb is changed to " << value << "MB";
+  return true;
+}
+}  // namespace
+
+DEFINE_validator(rocksdb_rate_limit, &updateRocksdbRateLimit);
 
 DEFINE_bool(enable_rocksdb_whole_key_filtering,
             false,
@@ -95,6 +203,25 @@ DEFINE_bool(enable_rocksdb_prefix_filtering,
             true,
             "Whether or not to enable rocksdb's prefix bloom filter.");
 
+DEFINE_bool(rocksdb_edge_type_prefix_filter,
+            false,
+            "Whether the prefix bloom filter of the edges covers the edge type besides the source "
+            "vertex, so that reading the edges of one type skips the sst files without them. The "
+            "scans of all the edges of a vertex don't use the filter then. Only for "
+            "BlockBasedTable");
+
+DEFINE_bool(rocksdb_tag_whole_key_filtering,
+            false,
+            "Whether to build the whole key bloom filter for the tag column family, which speeds "
+            "up the point lookups of tags. Only when rocksdb_separate_column_families is true");
+
+DEFINE_string(rocksdb_filter_policy, "bloom", "Type of the sst filter, bloom or ribbon");
+
+DEFINE_int32(rocksdb_filter_bits_per_key,
+             10,
+             "Bits per key of the bloom filter, the ribbon filter has the same false positive "
+             "rate with about 30% less space");
+
 DEFINE_bool(rocksdb_compact_change_level,
             true,
             "If true, compacted files will be moved to the minimum level capable "
@@ -156,7 +283,58 @@ static const std::unordered_map<std::string, rocksdb::CompressionType> kCompress
     {"xpress", rocksdb::kXpressCompression},
     {"disable", rocksdb::kDisableCompressionOption}};
 
-static rocksdb::Status initRocksdbCompression(rocksdb::Options& baseOpts) {
+// Parse the flag of "space:value,space:value", the values must be no less than minValue
+static bool parseSpaceValues(const std::string& flag,
+                             int64_t minValue,
+                             std::unordered_map<GraphSpaceID, int64_t>& values) {
+  std::vector<folly::StringPiece> items;
+  folly::split(",", flag, items, true);
+  for (auto item : items) {
+    folly::StringPiece space;
+    folly::StringPiece value;
+    if (!folly::split(":", item, space, value)) {
+      return false;
+    }
+    auto spaceId = folly::tryTo<GraphSpaceID>(folly::trimWhitespace(space));
+    auto v = folly::tryTo<int64_t>(folly::trimWhitespace(value));
+    if (!spaceId.hasValue() || !v.hasValue() || v.value() < minValue) {
+      return false;
+    }
+    values[spaceId.value()] = v.value();
+  }
+  return true;
+}
+
+// The zstd dictionary of each sst file is trained by rocksdb from the samples of its data blocks
+// during flush and compaction, then stored in the file, which is worthwhile for the small and
+// similar values of a space, e.g. the rows of a few tags.
+static rocksdb::Status initRocksdbCompressionDict(rocksdb::Options& baseOpts,
+                                                  GraphSpaceID spaceId) {
+  std::unordered_map<GraphSpaceID, int64_t> spaceDictBytes;
+  if (!parseSpaceValues(FLAGS_rocksdb_space_compression_dict_bytes, 0, spaceDictBytes)) {
+    return rocksdb::Status::InvalidArgument("Illegal rocksdb_space_compression_dict_bytes",
+                                            FLAGS_rocksdb_space_compression_dict_bytes);
+  }
+  int64_t dictBytes = FLAGS_rocksdb_compression_dict_bytes;
+  auto found = spaceDictBytes.find(spaceId);
+  if (found != spaceDictBytes.end()) {
+    dictBytes = found->second;
+  }
+  if (dictBytes <= 0) {
+    return rocksdb::Status::OK();
+  }
+  dictBytes = std::min<int64_t>(dictBytes, std::numeric_limits<uint32_t>::max() / 100);
+  // The samples of 100 times the size of the dictionary are recommended by zstd
+  for (auto* opts : {&baseOpts.compression_opts, &baseOpts.bottommost_compression_opts}) {
+    opts->max_dict_bytes = static_cast<uint32_t>(dictBytes);
+    opts->zstd_max_train_bytes = static_cast<uint32_t>(dictBytes * 100);
+  }
+  baseOpts.bottommost_compression_opts.enabled = true;
+  LOG(INFO) << "Compression dictionary of space " << spaceId << ": " << dictBytes << " bytes";
+  return rocksdb::Status::OK();
+}
+
+static rocksdb::Status initRocksdbCompression(rocksdb::Options& baseOpts, GraphSpaceID spaceId) {
   // Set the general compression algorithm
   {
     auto it = kCompressionTypeMap.find(FLAGS_rocksdb_compression);
@@ -173,6 +351,10 @@ static rocksdb::Status initRocksdbCompression(rocksdb::Options& baseOpts) {
     }
     baseOpts.bottommost_compression = it->second;
   }
+  auto s = initRocksdbCompressionDict(baseOpts, spaceId);
+  if (!s.ok()) {
+    return s;
+  }
   if (FLAGS_rocksdb_compression_per_level.empty()) {
     return rocksdb::Status::OK();
   }
@@ -219,6 +401,201 @@ static rocksdb::Status initRocksdbKVSeparation(rocksdb::Options& baseOpts) {
   return rocksdb::Status::OK();
 }
 
+/**
+ * @brief The prefix extractor when rocksdb_edge_type_prefix_filter is on. The prefix of an edge key
+ * is the part id, source vertex and edge type, the prefix of the others is the part id and vertex
+ * as the capped one.
+ */
+class EdgeTypePrefixTransform : public rocksdb::SliceTransform {
+ public:
+  explicit EdgeTypePrefixTransform(size_t vertexPrefixLen)
+      : vertexPrefixLen_(vertexPrefixLen),
+        name_(folly::stringPrintf("nebula.EdgeTypePrefix.%zu", vertexPrefixLen)) {}
+
+  const char* Name() const override {
+    return name_.c_str();
+  }
+
+  rocksdb::Slice Transform(const rocksdb::Slice& key) const override {
+    return rocksdb::Slice(key.data(), std::min(key.size(), prefixLen(key)));
+  }
+
+  bool InDomain(const rocksdb::Slice&) const override {
+    return true;
+  }
+
+  bool SameResultWhenAppended(const rocksdb::Slice& prefix) const override {
+    return prefix.size() >= prefixLen(prefix);
+  }
+
+ private:
+  size_t prefixLen(const rocksdb::Slice& key) const {
+    bool isEdge = key.size() > 0 && static_cast<NebulaKeyType>(static_cast<uint8_t>(key[0])) ==
+                                        NebulaKeyType::kEdge;
+    return isEdge ? vertexPrefixLen_ + sizeof(EdgeType) : vertexPrefixLen_;
+  }
+
+  size_t vertexPrefixLen_;
+  std::string name_;
+};
+
+static rocksdb::Status newFilterPolicy(std::shared_ptr<const rocksdb::FilterPolicy>& policy) {
+  if (FLAGS_rocksdb_filter_policy == "bloom") {
+    policy.reset(rocksdb::NewBloomFilterPolicy(FLAGS_rocksdb_filter_bits_per_key, false));
+  } else if (FLAGS_rocksdb_filter_policy == "ribbon") {
+#if ROCKSDB_MAJOR >= 7
+    policy.reset(rocksdb::NewRibbonFilterPolicy(FLAGS_rocksdb_filter_bits_per_key));
+#else
+    LOG(WARNING) << "Ribbon filter requires rocksdb 7 or later, use bloom filter instead";
+    policy.reset(rocksdb::NewBloomFilterPolicy(FLAGS_rocksdb_filter_bits_per_key, false));
+#endif
+  } else {
+    return rocksdb::Status::InvalidArgument("Illegal filter policy", FLAGS_rocksdb_filter_policy);
+  }
+  return rocksdb::Status::OK();
+}
+
+bool edgeTypePrefixFilterEnabled() {
+  return FLAGS_enable_rocksdb_prefix_filtering && FLAGS_rocksdb_edge_type_prefix_filter &&
+         FLAGS_rocksdb_table_format == "BlockBasedTable";
+}
+
+// Allocate the blocks of the block cache from its own memory arena
+class ArenaMemoryAllocator final : public rocksdb::MemoryAllocator {
+ public:
+  explicit ArenaMemoryAllocator(unsigned arena) : arena_(arena) {}
+
+  const char* Name() const override {
+    return "ArenaMemoryAllocator";
+  }
+
+  void* Allocate(size_t size) override {
+    return thread::MemoryArenas::allocate(arena_, size);
+  }
+
+  void Deallocate(void* p) override {
+    thread::MemoryArenas::deallocate(p);
+  }
+
+  size_t UsableSize(void* p, size_t) const override {
+    return thread::MemoryArenas::usableSize(p);
+  }
+
+ private:
+  unsigned arena_;
+};
+
+static std::shared_ptr<rocksdb::MemoryAllocator> blockCacheAllocator() {
+  auto arena = thread::MemoryArenas::arenaOf(thread::MemoryArenas::kBlockCache);
+  if (!arena.has_value()) {
+    return nullptr;
+  }
+  // Shared by the block caches of the spaces
+  static auto allocator = std::make_shared<ArenaMemoryAllocator>(*arena);
+  return allocator;
+}
+
+static std::shared_ptr<rocksdb::Cache> newBlockCache(int64_t capacityMB, size_t blockSize) {
+  size_t capacity = capacityMB * 1024 * 1024;
+  if (FLAGS_rocksdb_block_cache_type == "hyper_clock") {
+#if ROCKSDB_MAJOR >= 8
+    rocksdb::HyperClockCacheOptions opts(capacity, blockSize, FLAGS_cache_bucket_exp);
+    opts.memory_allocator = blockCacheAllocator();
+    return opts.MakeSharedCache();
+#else
+    UNUSED(blockSize);
+    LOG(WARNING) << "HyperClockCache requires rocksdb 8 or later, use LRU cache instead";
+#endif
+  }
+  rocksdb::LRUCacheOptions opts;
+  opts.capacity = capacity;
+  opts.num_shard_bits = FLAGS_cache_bucket_exp;
+  opts.memory_allocator = blockCacheAllocator();
+  return rocksdb::NewLRUCache(opts);
+}
+
+namespace {
+// The block caches and the write buffer manager are created when they are first used, and live
+// until the process exits
+std::mutex blockCacheLock;
+std::shared_ptr<rocksdb::Cache> sharedBlockCache;
+std::unordered_map<GraphSpaceID, std::shared_ptr<rocksdb::Cache>> spaceBlockCaches;
+std::shared_ptr<rocksdb::WriteBufferManager> writeBufferManager;
+}  // namespace
+
+/**
+ * @brief Get the block cache of the space, which is either its reserved cache or the one shared by
+ * the other spaces.
+ */
+static rocksdb::Status getBlockCache(GraphSpaceID spaceId,
+                                     size_t blockSize,
+                                     std::shared_ptr<rocksdb::Cache>& cache) {
+  if (FLAGS_rocksdb_block_cache_type != "lru" && FLAGS_rocksdb_block_cache_type != "hyper_clock") {
+    return rocksdb::Status::InvalidArgument("Illegal block cache type",
+                                            FLAGS_rocksdb_block_cache_type);
+  }
+  std::unordered_map<GraphSpaceID, int64_t> reserved;
+  if (!parseSpaceValues(FLAGS_rocksdb_space_block_cache, 1, reserved)) {
+    return rocksdb::Status::InvalidArgument("Illegal rocksdb_space_block_cache",
+                                            FLAGS_rocksdb_space_block_cache);
+  }
+  int64_t sharedMB = FLAGS_rocksdb_block_cache;
+  for (const auto& space : reserved) {
+    sharedMB -= space.second;
+  }
+  if (sharedMB <= 0) {
+    return rocksdb::Status::InvalidArgument(
+        "The reserved block cache of the spaces exceeds rocksdb_block_cache");
+  }
+
+  std::lock_guard<std::mutex> guard(blockCacheLock);
+  // The shared cache is created even if the space has a reserved one, since the memtables of all
+  // the spaces are charged to it
+  if (sharedBlockCache == nullptr) {
+    sharedBlockCache = newBlockCache(sharedMB, blockSize);
+  }
+  auto iter = reserved.find(spaceId);
+  if (iter != reserved.end()) {
+    auto& spaceCache = spaceBlockCaches[spaceId];
+    if (spaceCache == nullptr) {
+      LOG(INFO) << "Reserve " << iter->second << "MB block cache for space " << spaceId;
+      spaceCache = newBlockCache(iter->second, blockSize);
+    }
+    cache = spaceCache;
+  } else {
+    cache = sharedBlockCache;
+  }
+  return rocksdb::Status::OK();
+}
+
+/**
+ * @brief Get the write buffer manager shared by the rocksdb instances of all the spaces, which is
+ * charged to the shared block cache if the block cache is enabled.
+ */
+static std::shared_ptr<rocksdb::WriteBufferManager> getSharedWriteBufferManager() {
+  std::lock_guard<std::mutex> guard(blockCacheLock);
+  if (writeBufferManager == nullptr) {
+    size_t budget = FLAGS_rocksdb_memtable_budget * 1024 * 1024;
+#if ROCKSDB_MAJOR >= 7
+    writeBufferManager = std::make_shared<rocksdb::WriteBufferManager>(
+        budget, sharedBlockCache, FLAGS_rocksdb_memtable_allow_stall);
+#else
+    if (FLAGS_rocksdb_memtable_allow_stall) {
+      LOG(WARNING) << "Stalling the writes by the memtable budget requires rocksdb 7 or later";
+    }
+    writeBufferManager = std::make_shared<rocksdb::WriteBufferManager>(budget, sharedBlockCache);
+#endif
+    LOG(INFO) << "The memtables of all the spaces are bounded by " << FLAGS_rocksdb_memtable_budget
+              << "MB" << (sharedBlockCache != nullptr ? ", charged to the shared block cache" : "");
+  }
+  return writeBufferManager;
+}
+
+std::shared_ptr<rocksdb::WriteBufferManager> getWriteBufferManager() {
+  std::lock_guard<std::mutex> guard(blockCacheLock);
+  return writeBufferManager;
+}
+
 rocksdb::Status initRocksdbOptions(rocksdb::Options& baseOpts,
                                    GraphSpaceID spaceId,
                                    int32_t vidLen) {
@@ -237,6 +614,9 @@ rocksdb::Status initRocksdbOptions(rocksdb::Options& baseOpts,
     return s;
   }
   std::shared_ptr<rocksdb::Statistics> stats = getDBStatistics();
+  if (FLAGS_enable_space_block_cache_stats) {
+    stats = std::make_shared<SpaceCacheStatistics>(spaceId, std::move(stats));
+  }
   if (stats) {
     dbOpts.statistics = std::move(stats);
     dbOpts.stats_dump_period_sec = 0;  // exposing statistics ourself
@@ -267,7 +647,7 @@ rocksdb::Status initRocksdbOptions(rocksdb::Options& baseOpts,
 
   baseOpts = rocksdb::Options(dbOpts, cfOpts);
 
-  s = initRocksdbCompression(baseOpts);
+  s = initRocksdbCompression(baseOpts, spaceId);
   if (!s.ok()) {
     return s;
   }
@@ -287,9 +667,12 @@ rocksdb::Status initRocksdbOptions(rocksdb::Options& baseOpts,
     baseOpts.compaction_thread_limiter = compaction_thread_limiter;
   }
   if (FLAGS_rocksdb_rate_limit > 0) {
-    static std::shared_ptr<rocksdb::RateLimiter> rate_limiter{
-        rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_rate_limit * 1024 * 1024)};
-    baseOpts.rate_limiter = rate_limiter;
+    std::lock_guard<std::mutex> guard(rocksdbRateLimiterLock);
+    if (rocksdbRateLimiter == nullptr) {
+      auto rate = static_cast<int64_t>(FLAGS_rocksdb_rate_limit) * 1024 * 1024;
+      rocksdbRateLimiter.reset(rocksdb::NewGenericRateLimiter(rate));
+    }
+    baseOpts.rate_limiter = rocksdbRateLimiter;
   }
 
   size_t prefixLength = sizeof(PartitionID) + vidLen;
@@ -308,9 +691,30 @@ rocksdb::Status initRocksdbOptions(rocksdb::Options& baseOpts,
     if (FLAGS_rocksdb_block_cache <= 0) {
       bbtOpts.no_block_cache = true;
     } else {
-      static std::shared_ptr<rocksdb::Cache> blockCache =
-          rocksdb::NewLRUCache(FLAGS_rocksdb_block_cache * 1024 * 1024, FLAGS_cache_bucket_exp);
-      bbtOpts.block_cache = blockCache;
+      s = getBlockCache(spaceId, bbtOpts.block_size, bbtOpts.block_cache);
+      if (!s.ok()) {
+        return s;
+      }
+      if (FLAGS_rocksdb_cache_index_and_filter_blocks) {
+        bbtOpts.cache_index_and_filter_blocks = true;
+        bbtOpts.cache_index_and_filter_blocks_with_high_priority = true;
+      }
+    }
+
+    if (!FLAGS_rocksdb_persistent_cache_path.empty() && FLAGS_rocksdb_persistent_cache_size > 0) {
+      static std::shared_ptr<rocksdb::PersistentCache> persistentCache;
+      static rocksdb::Status persistentCacheStatus =
+          rocksdb::NewPersistentCache(rocksdb::Env::Default(),
+                                      FLAGS_rocksdb_persistent_cache_path,
+                                      FLAGS_rocksdb_persistent_cache_size * 1024 * 1024,
+                                      nullptr,  // log
+                                      true,     // optimized_for_nvm
+                                      &persistentCache);
+      if (!persistentCacheStatus.ok()) {
+        LOG(ERROR) << "Create persistent cache failed: " << persistentCacheStatus.ToString();
+        return persistentCacheStatus;
+      }
+      bbtOpts.persistent_cache = persistentCache;
     }
 
     if (FLAGS_rocksdb_row_cache_num) {
@@ -319,7 +723,10 @@ rocksdb::Status initRocksdbOptions(rocksdb::Options& baseOpts,
       baseOpts.row_cache = rowCache;
     }
 
-    bbtOpts.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10, false));
+    s = newFilterPolicy(bbtOpts.filter_policy);
+    if (!s.ok()) {
+      return s;
+    }
     if (FLAGS_enable_partitioned_index_filter) {
       bbtOpts.index_type = rocksdb::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
       bbtOpts.partition_filters = true;
@@ -329,7 +736,9 @@ rocksdb::Status initRocksdbOptions(rocksdb::Options& baseOpts,
       bbtOpts.pin_l0_filter_and_index_blocks_in_cache =
           baseOpts.compaction_style == rocksdb::CompactionStyle::kCompactionStyleLevel;
     }
-    if (FLAGS_enable_rocksdb_prefix_filtering) {
+    if (edgeTypePrefixFilterEnabled()) {
+      baseOpts.prefix_extractor = std::make_shared<EdgeTypePrefixTransform>(prefixLength);
+    } else if (FLAGS_enable_rocksdb_prefix_filtering) {
       baseOpts.prefix_extractor.reset(rocksdb::NewCappedPrefixTransform(prefixLength));
     }
     bbtOpts.whole_key_filtering = FLAGS_enable_rocksdb_whole_key_filtering;
@@ -353,9 +762,64 @@ rocksdb::Status initRocksdbOptions(rocksdb::Options& baseOpts,
     return rocksdb::Status::NotSupported("Illegal table format");
   }
 
+  if (FLAGS_rocksdb_memtable_budget > 0) {
+    // The memtables of all the spaces share one budget, so that the memory of writing into many
+    // spaces at once is bounded. Being charged to the shared block cache, the total memory of the
+    // block cache and the memtables is bounded by rocksdb_block_cache as well
+    baseOpts.write_buffer_manager = getSharedWriteBufferManager();
+  }
   return s;
 }
 
+rocksdb::Status initRocksdbColumnFamilyOptions(rocksdb::ColumnFamilyOptions& cfOpts,
+                                               const std::string& name,
+                                               GraphSpaceID spaceId) {
+  static const std::unordered_map<std::string, const std::string*> kOptionsFlags = {
+      {"tag", &FLAGS_rocksdb_tag_column_family_options},
+      {"edge", &FLAGS_rocksdb_edge_column_family_options},
+      {"index", &FLAGS_rocksdb_index_column_family_options}};
+  auto flag = kOptionsFlags.find(name);
+  if (flag == kOptionsFlags.end()) {
+    return rocksdb::Status::InvalidArgument("Unknown column family " + name);
+  }
+
+  std::unordered_map<std::string, std::string> cfOptsMap;
+  if (!loadOptionsMap(cfOptsMap, *flag->second)) {
+    return rocksdb::Status::InvalidArgument();
+  }
+  rocksdb::ColumnFamilyOptions baseOpts = cfOpts;
+  auto s = GetColumnFamilyOptionsFromMap(baseOpts, cfOptsMap, &cfOpts, true);
+  if (!s.ok()) {
+    return s;
+  }
+
+  if (name == "tag" && FLAGS_rocksdb_tag_whole_key_filtering &&
+      FLAGS_rocksdb_table_format == "BlockBasedTable" && cfOpts.table_factory != nullptr) {
+    auto* bbtOpts = cfOpts.table_factory->GetOptions<rocksdb::BlockBasedTableOptions>();
+    if (bbtOpts != nullptr && !bbtOpts->whole_key_filtering) {
+      rocksdb::BlockBasedTableOptions tagBbtOpts = *bbtOpts;
+      tagBbtOpts.whole_key_filtering = true;
+      cfOpts.table_factory.reset(NewBlockBasedTableFactory(tagBbtOpts));
+    }
+  }
+
+  std::unordered_map<std::string, std::string> pathsMap;
+  if (!loadOptionsMap(pathsMap, FLAGS_rocksdb_column_family_paths)) {
+    return rocksdb::Status::InvalidArgument();
+  }
+  auto path = pathsMap.find(name);
+  if (path != pathsMap.end()) {
+    auto dir = folly::stringPrintf("%s/nebula/%d/%s", path->second.c_str(), spaceId, name.c_str());
+    if (fs::FileUtils::fileType(dir.c_str()) == fs::FileType::NOTEXIST &&
+        !fs::FileUtils::makeDir(dir)) {
+      return rocksdb::Status::IOError("makeDir failed", dir);
+    }
+    LOG(INFO) << "set column family " << name << " of space " << spaceId << " to " << dir;
+    cfOpts.cf_paths.emplace_back(dir, std::numeric_limits<uint64_t>::max());
+  }
+  return rocksdb::Status::OK();
+}
+
 bool loadOptionsMap(std::unordered_map<std::string, std::string>& map, const std::string& gflags) {
   conf::Configuration conf;
   auto status = conf.parseFromString(gflags);
@@ -7,6 +7,7 @@
 #define KVSTORE_ROCKSENGINECONFIG_H_
 
 #include <rocksdb/db.h>
+#include <rocksdb/write_buffer_manager.h>
 
 #include "common/base/Base.h"
 #include "common/thrift/ThriftTypes.h"
@@ -23,6 +24,13 @@ DECLARE_string(rocksdb_column_family_options);
 //  [TableOptions/BlockBasedTable "default"]
 DECLARE_string(rocksdb_block_based_table_options);
 
+// [CFOptions "tag"/"edge"/"index"]
+DECLARE_bool(rocksdb_separate_column_families);
+DECLARE_string(rocksdb_tag_column_family_options);
+DECLARE_string(rocksdb_edge_column_family_options);
+DECLARE_string(rocksdb_index_column_family_options);
+DECLARE_string(rocksdb_column_family_paths);
+
 // memtable_factory
 DECLARE_string(memtable_factory);
 
@@ -33,6 +41,14 @@ DECLARE_bool(rocksdb_wal_sync);
 
 // BlockBasedTable block_cache
 DECLARE_int64(rocksdb_block_cache);
+DECLARE_string(rocksdb_block_cache_type);
+DECLARE_string(rocksdb_space_block_cache);
+DECLARE_bool(rocksdb_cache_index_and_filter_blocks);
+DECLARE_int64(rocksdb_memtable_budget);
+DECLARE_bool(rocksdb_memtable_allow_stall);
+DECLARE_string(rocksdb_persistent_cache_path);
+DECLARE_int64(rocksdb_persistent_cache_size);
+DECLARE_bool(enable_space_block_cache_stats);
 
 DECLARE_int32(rocksdb_batch_size);
 
@@ -48,12 +64,18 @@ DECLARE_string(part_man_type);
 DECLARE_string(rocksdb_compression_per_level);
 DECLARE_string(rocksdb_compression);
 DECLARE_string(rocksdb_bottommost_compression);
+DECLARE_int32(rocksdb_compression_dict_bytes);
+DECLARE_string(rocksdb_space_compression_dict_bytes);
 
 DECLARE_bool(enable_rocksdb_statistics);
 DECLARE_string(rocksdb_stats_level);
 
 DECLARE_bool(enable_rocksdb_prefix_filtering);
 DECLARE_bool(enable_rocksdb_whole_key_filtering);
+DECLARE_bool(rocksdb_edge_type_prefix_filter);
+DECLARE_bool(rocksdb_tag_whole_key_filtering);
+DECLARE_string(rocksdb_filter_policy);
+DECLARE_int32(rocksdb_filter_bits_per_key);
 
 // rocksdb compact RangeOptions
 DECLARE_bool(rocksdb_compact_change_level);
@@ -82,6 +104,19 @@ rocksdb::Status initRocksdbOptions(rocksdb::Options &baseOpts,
                                    GraphSpaceID spaceId,
                                    int32_t vidLen = 8);
 
+/**
+ * @brief Build the options of a separated column family, the options in its gflag override the
+ * base ones
+ *
+ * @param cfOpts Column family options, which are the base options when passed in
+ * @param name Column family name, tag, edge or index
+ * @param spaceId
+ * @return rocksdb::Status
+ */
+rocksdb::Status initRocksdbColumnFamilyOptions(rocksdb::ColumnFamilyOptions &cfOpts,
+                                               const std::string &name,
+                                               GraphSpaceID spaceId);
+
 /**
  * @brief Load a gflag into map
  *
@@ -91,6 +126,18 @@ rocksdb::Status initRocksdbOptions(rocksdb::Options &baseOpts,
  */
 bool loadOptionsMap(std::unordered_map<std::string, std::string> &map, const std::string &gflags);
 
+/**
+ * @brief Whether the prefix extractor of the edge keys covers the edge type, the prefix seeks of
+ * the edges shorter than that could not use the prefix bloom filter
+ */
+bool edgeTypePrefixFilterEnabled();
+
+/**
+ * @brief Retrieve the write buffer manager shared by all the spaces, return nullptr if
+ * rocksdb_memtable_budget is not set or no rocksdb instance is opened yet
+ */
+std::shared_ptr<rocksdb::WriteBufferManager> getWriteBufferManager();
+
 /**
  * @brief Retrieve rocksdb statistics, return nullptr if not enabled
  */
@@ -0,0 +1,95 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef KVSTORE_ROCKSREADPROFILER_H_
+#define KVSTORE_ROCKSREADPROFILER_H_
+
+#include <rocksdb/iostats_context.h>
+#include <rocksdb/perf_context.h>
+#include <rocksdb/perf_level.h>
+#include <rocksdb/version.h>
+
+#include "common/base/Base.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * @brief Profile the reads of rocksdb on the current thread by the perf context of rocksdb, which
+ * is thread local. The reads between the construction and stats() are profiled, so the profiler
+ * must be used on the thread doing the reads, e.g. the one executing a storage plan.
+ */
+class RocksReadProfiler final {
+ public:
+  RocksReadProfiler() : level_(rocksdb::GetPerfLevel()) {
+    rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableTimeExceptForMutex);
+    rocksdb::get_perf_context()->Reset();
+    rocksdb::get_iostats_context()->Reset();
+  }
+
+  ~RocksReadProfiler() {
+    rocksdb::SetPerfLevel(level_);
+  }
+
+  /**
+   * @brief The stats of the reads since the construction, the time is in microseconds
+   */
+  std::map<std::string, int64_t> stats() const {
+    const auto* ctx = rocksdb::get_perf_context();
+    auto us = [](uint64_t nanos) { return static_cast<int64_t>(nanos / 1000); };
+    std::map<std::string, int64_t> stats;
+    stats.emplace("iterate_us", us(ctx->seek_internal_seek_time + ctx->find_next_user_entry_time));
+    stats.emplace("get_us", us(ctx->get_from_memtable_time + ctx->get_from_output_files_time));
+    stats.emplace("block_cache_hits", ctx->block_cache_hit_count);
+    stats.emplace("block_reads", ctx->block_read_count);
+    stats.emplace("block_read_bytes", ctx->block_read_byte);
+    stats.emplace("block_read_us", us(ctx->block_read_time));
+    stats.emplace("deleted_keys_skipped", ctx->internal_delete_skipped_count);
+    // A miss of the bloom filter saves the read of the sst file
+    stats.emplace("bloom_sst_hits", ctx->bloom_sst_hit_count);
+    stats.emplace("bloom_sst_misses", ctx->bloom_sst_miss_count);
+    stats.emplace("memtable_gets", ctx->get_from_memtable_count);
+    stats.emplace("memtable_seeks", ctx->seek_on_memtable_count);
+    stats.emplace("read_bytes", ctx->get_read_bytes + ctx->iter_read_bytes);
+    stats.emplace("file_read_bytes", rocksdb::get_iostats_context()->bytes_read);
+#if ROCKSDB_MAJOR >= 7
+    stats.emplace("seeks", ctx->iter_seek_count);
+    stats.emplace("blob_read_bytes", ctx->blob_read_byte);
+    stats.emplace("blob_read_us", us(ctx->blob_read_time));
+#endif
+    return stats;
+  }
+
+  // The names of the stats returned by stats()
+  static const std::vector<std::string>& statNames() {
+    static const std::vector<std::string> names = {"iterate_us",
+                                                   "get_us",
+                                                   "block_cache_hits",
+                                                   "block_reads",
+                                                   "block_read_bytes",
+                                                   "block_read_us",
+                                                   "deleted_keys_skipped",
+                                                   "bloom_sst_hits",
+                                                   "bloom_sst_misses",
+                                                   "memtable_gets",
+                                                   "memtable_seeks",
+                                                   "read_bytes",
+                                                   "file_read_bytes",
+#if ROCKSDB_MAJOR >= 7
+                                                   "seeks",
+                                                   "blob_read_bytes",
+                                                   "blob_read_us",
+#endif
+    };
+    return names;
+  }
+
+ private:
+  rocksdb::PerfLevel level_;
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+#endif  // KVSTORE_ROCKSREADPROFILER_H_
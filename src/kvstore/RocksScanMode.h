@@ -0,0 +1,61 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef KVSTORE_ROCKSSCANMODE_H_
+#define KVSTORE_ROCKSSCANMODE_H_
+
+#include "common/base/Base.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * @brief How the iterators created by the current thread read rocksdb.
+ */
+enum class ScanMode : uint8_t {
+  // The point reads and the short scans of the queries, with the default read options
+  kDefault = 0,
+  // The long scans of the queries, e.g. scanning the edges of a part, which read ahead
+  kLong = 1,
+  // The scans of the jobs and the exports, which read ahead and don't fill the block cache, so
+  // they don't evict the data read by the queries
+  kBackground = 2,
+};
+
+/**
+ * @brief Set the scan mode of the iterators created by the current thread until destructed, like
+ * RocksReadProfiler it must be used on the thread creating the iterators, e.g. the one executing
+ * a storage plan. The guards could be nested.
+ */
+class ScanModeGuard final {
+ public:
+  explicit ScanModeGuard(ScanMode mode) : prev_(mutableCurrent()) {
+    mutableCurrent() = mode;
+  }
+
+  ~ScanModeGuard() {
+    mutableCurrent() = prev_;
+  }
+
+  ScanModeGuard(const ScanModeGuard&) = delete;
+  ScanModeGuard& operator=(const ScanModeGuard&) = delete;
+
+  static ScanMode current() {
+    return mutableCurrent();
+  }
+
+ private:
+  static ScanMode& mutableCurrent() {
+    static thread_local ScanMode mode = ScanMode::kDefault;
+    return mode;
+  }
+
+  ScanMode prev_;
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+
+#endif  // KVSTORE_ROCKSSCANMODE_H_
@@ -0,0 +1,135 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef KVSTORE_SPACECACHESTATISTICS_H_
+#define KVSTORE_SPACECACHESTATISTICS_H_
+
+#include <rocksdb/statistics.h>
+#include <rocksdb/version.h>
+
+#include "common/base/Base.h"
+#include "common/thrift/ThriftTypes.h"
+#include "kvstore/stats/KVStats.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * @brief Statistics of the rocksdb instances of a space, which counts the block cache hits and
+ * misses of the space and exports them as block_cache_hit and block_cache_miss labeled by the
+ * space. All the tickers and histograms are forwarded to the statistics shared by all the spaces if
+ * enable_rocksdb_statistics is on, otherwise only the tickers are recorded.
+ */
+class SpaceCacheStatistics final : public rocksdb::Statistics {
+ public:
+  SpaceCacheStatistics(GraphSpaceID spaceId, std::shared_ptr<rocksdb::Statistics> shared)
+      : shared_(std::move(shared)) {
+    if (kBlockCacheHit.valid()) {
+      std::vector<std::pair<std::string, std::string>> labels = {
+          {"space", folly::to<std::string>(spaceId)}};
+      hitCounter_ = stats::StatsManager::counterWithLabels(kBlockCacheHit, labels);
+      missCounter_ = stats::StatsManager::counterWithLabels(kBlockCacheMiss, labels);
+    }
+    set_stats_level(shared_ != nullptr ? shared_->get_stats_level()
+                                       : rocksdb::StatsLevel::kExceptHistogramOrTimers);
+  }
+
+  ~SpaceCacheStatistics() override {
+    flush(hits_, hitCounter_);
+    flush(misses_, missCounter_);
+  }
+
+#if ROCKSDB_MAJOR >= 7
+  const char* Name() const override {
+    return "SpaceCacheStatistics";
+  }
+#endif
+
+  void recordTick(uint32_t tickerType, uint64_t count) override {
+    if (tickerType == rocksdb::BLOCK_CACHE_HIT) {
+      add(hits_, hitCounter_, count);
+    } else if (tickerType == rocksdb::BLOCK_CACHE_MISS) {
+      add(misses_, missCounter_, count);
+    }
+    if (shared_ != nullptr) {
+      shared_->recordTick(tickerType, count);
+    }
+  }
+
+  uint64_t getTickerCount(uint32_t tickerType) const override {
+    return shared_ != nullptr ? shared_->getTickerCount(tickerType) : 0;
+  }
+
+  void setTickerCount(uint32_t tickerType, uint64_t count) override {
+    if (shared_ != nullptr) {
+      shared_->setTickerCount(tickerType, count);
+    }
+  }
+
+  uint64_t getAndResetTickerCount(uint32_t tickerType) override {
+    return shared_ != nullptr ? shared_->getAndResetTickerCount(tickerType) : 0;
+  }
+
+  void histogramData(uint32_t type, rocksdb::HistogramData* const data) const override {
+    if (shared_ != nullptr) {
+      shared_->histogramData(type, data);
+    }
+  }
+
+  std::string getHistogramString(uint32_t type) const override {
+    return shared_ != nullptr ? shared_->getHistogramString(type) : "";
+  }
+
+  void recordInHistogram(uint32_t histogramType, uint64_t time) override {
+    if (shared_ != nullptr) {
+      shared_->recordInHistogram(histogramType, time);
+    }
+  }
+
+  bool HistEnabledForType(uint32_t type) const override {
+    // No time is measured for the histograms if they are not recorded
+    return shared_ != nullptr && shared_->HistEnabledForType(type);
+  }
+
+  rocksdb::Status Reset() override {
+    return shared_ != nullptr ? shared_->Reset() : rocksdb::Status::OK();
+  }
+
+  std::string ToString() const override {
+    return shared_ != nullptr ? shared_->ToString() : "";
+  }
+
+  bool getTickerMap(std::map<std::string, uint64_t>* stats) const override {
+    return shared_ != nullptr && shared_->getTickerMap(stats);
+  }
+
+ private:
+  // The ticks are added to the stats manager in batches, since they are recorded on each block read
+  static constexpr uint64_t kFlushTicks = 1024;
+
+  static void add(std::atomic<uint64_t>& pending, const stats::CounterId& counter, uint64_t count) {
+    if (pending.fetch_add(count, std::memory_order_relaxed) + count >= kFlushTicks) {
+      flush(pending, counter);
+    }
+  }
+
+  static void flush(std::atomic<uint64_t>& pending, const stats::CounterId& counter) {
+    auto ticks = pending.exchange(0, std::memory_order_relaxed);
+    if (ticks > 0 && counter.valid()) {
+      stats::StatsManager::addValue(counter, ticks);
+    }
+  }
+
+ private:
+  std::shared_ptr<rocksdb::Statistics> shared_;
+  stats::CounterId hitCounter_;
+  stats::CounterId missCounter_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+#endif  // KVSTORE_SPACECACHESTATISTICS_H_
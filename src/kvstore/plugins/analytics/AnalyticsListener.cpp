@@ -0,0 +1,222 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "kvstore/plugins/analytics/AnalyticsListener.h"
+
+#include <boost/filesystem.hpp>
+
+#include "common/utils/NebulaKeyUtils.h"
+#include "kvstore/PendingRows.h"
+#include "kvstore/RocksEngine.h"
+#include "kvstore/RocksEngineConfig.h"
+
+DEFINE_int32(analytics_csr_refresh_secs,
+             0,
+             "The interval to refresh the csr snapshot of the edges the analytics listeners serve "
+             "the reads from, 0 to serve them from the rocksdb of the listeners");
+
+namespace nebula {
+namespace kvstore {
+
+AnalyticsListener::AnalyticsListener(GraphSpaceID spaceId,
+                                     PartitionID partId,
+                                     HostAddr localAddr,
+                                     const std::string& walPath,
+                                     std::shared_ptr<folly::IOThreadPoolExecutor> ioPool,
+                                     std::shared_ptr<thread::GenericThreadPool> workers,
+                                     std::shared_ptr<folly::Executor> handlers,
+                                     std::shared_ptr<raftex::SnapshotManager> snapshotMan,
+                                     std::shared_ptr<RaftClient> clientMan,
+                                     std::shared_ptr<DiskManager> diskMan,
+                                     meta::SchemaManager* schemaMan)
+    : Listener(spaceId,
+               partId,
+               std::move(localAddr),
+               walPath,
+               ioPool,
+               workers,
+               handlers,
+               snapshotMan,
+               clientMan,
+               diskMan,
+               schemaMan),
+      dataPath_(boost::filesystem::path(walPath).parent_path().string()) {
+  CHECK(!!schemaMan);
+}
+
+void AnalyticsListener::init() {
+  auto vRet = schemaMan_->getSpaceVidLen(spaceId_);
+  if (!vRet.ok()) {
+    LOG(FATAL) << "vid length error";
+  }
+  // The directory of the listener is of the part already, so the engine holds only the part
+  engine_ = std::make_unique<RocksEngine>(spaceId_, vRet.value(), dataPath_, "", mergeOp_);
+  if (FLAGS_analytics_csr_refresh_secs > 0) {
+    csrEngine_ = std::make_unique<CsrEngine>(
+        spaceId_, partId_, vRet.value(), engine_.get(), dataPath_ + "/edges.csr");
+    bgWorkers_->addDelayTask(
+        FLAGS_analytics_csr_refresh_secs * 1000, &AnalyticsListener::refreshCsr, this);
+  }
+}
+
+void AnalyticsListener::refreshCsr() {
+  if (isStopped()) {
+    return;
+  }
+  // The snapshot is built in the handlers, as it scans all the edges of the part
+  folly::via(executor_.get(), [this] {
+    SCOPE_EXIT {
+      bgWorkers_->addDelayTask(
+          FLAGS_analytics_csr_refresh_secs * 1000, &AnalyticsListener::refreshCsr, this);
+    };
+    csrEngine_->refresh();
+  });
+}
+
+bool AnalyticsListener::apply(const std::vector<KV>& data) {
+  auto batch = engine_->startBatchWrite();
+  for (const auto& kv : data) {
+    if (batch->put(kv.first, kv.second) != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return false;
+    }
+  }
+  auto code = engine_->commitBatchWrite(
+      std::move(batch), FLAGS_rocksdb_disable_wal, FLAGS_rocksdb_wal_sync, true);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    LOG(WARNING) << idStr_ << "Failed to apply the snapshot, error "
+                 << apache::thrift::util::enumNameSafe(code);
+    return false;
+  }
+  return true;
+}
+
+bool AnalyticsListener::applyBatch(const std::vector<BatchOp>& batch, LogID lastApplyLogId) {
+  auto writeBatch = engine_->startBatchWrite();
+  // The merges into the missing rows are skipped as the part does
+  PendingRows pendingRows(engine_.get(), writeBatch.get());
+  for (const auto& op : batch) {
+    const auto& key = std::get<1>(op);
+    const auto& val = std::get<2>(op);
+    auto code = nebula::cpp2::ErrorCode::SUCCEEDED;
+    pendingRows.write(std::get<0>(op), key, val);
+    switch (std::get<0>(op)) {
+      case BatchLogType::OP_BATCH_PUT:
+        code = writeBatch->put(key, val);
+        break;
+      case BatchLogType::OP_BATCH_REMOVE:
+        code = writeBatch->remove(key);
+        break;
+      case BatchLogType::OP_BATCH_REMOVE_RANGE:
+        code = writeBatch->removeRange(key, val);
+        break;
+      case BatchLogType::OP_BATCH_MERGE: {
+        auto ret = pendingRows.mergeable(key);
+        if (!nebula::ok(ret)) {
+          code = nebula::error(ret);
+        } else if (nebula::value(ret)) {
+          code = writeBatch->merge(key, val);
+        }
+        break;
+      }
+    }
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return false;
+    }
+  }
+  // The apply id is written along with the data, so the merges are never applied twice
+  auto code = putAppliedId(writeBatch.get(),
+                           std::max(lastCommitId_, lastApplyLogId),
+                           lastCommitTerm_,
+                           lastApplyLogId);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return false;
+  }
+  code = engine_->commitBatchWrite(
+      std::move(writeBatch), FLAGS_rocksdb_disable_wal, FLAGS_rocksdb_wal_sync, true);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    LOG(WARNING) << idStr_ << "Failed to apply the logs to " << lastApplyLogId << ", error "
+                 << apache::thrift::util::enumNameSafe(code);
+    return false;
+  }
+  return true;
+}
+
+bool AnalyticsListener::persist(LogID lastId, TermID lastTerm, LogID lastApplyLogId) {
+  auto batch = engine_->startBatchWrite();
+  auto code = putAppliedId(batch.get(), lastId, lastTerm, lastApplyLogId);
+  if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+    code = engine_->commitBatchWrite(
+        std::move(batch), FLAGS_rocksdb_disable_wal, FLAGS_rocksdb_wal_sync, true);
+  }
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    LOG(FATAL) << "last apply ids write failed";
+  }
+  lastCommitId_ = lastId;
+  lastCommitTerm_ = lastTerm;
+  return true;
+}
+
+std::pair<LogID, TermID> AnalyticsListener::lastCommittedLogId() {
+  std::string val;
+  auto code = engine_->get(NebulaKeyUtils::systemCommitKey(partId_), &val);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    VLOG(3) << idStr_ << "Cannot fetch the last committed log id from the engine";
+    return {0, 0};
+  }
+  CHECK_EQ(val.size(), sizeof(LogID) * 2 + sizeof(TermID));
+  memcpy(reinterpret_cast<void*>(&lastCommitId_), val.data(), sizeof(LogID));
+  memcpy(reinterpret_cast<void*>(&lastCommitTerm_), val.data() + sizeof(LogID), sizeof(TermID));
+  return {lastCommitId_, lastCommitTerm_};
+}
+
+LogID AnalyticsListener::lastApplyLogId() {
+  std::string val;
+  auto code = engine_->get(NebulaKeyUtils::systemCommitKey(partId_), &val);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    VLOG(3) << idStr_ << "Cannot fetch the last apply log id from the engine";
+    return 0;
+  }
+  CHECK_EQ(val.size(), sizeof(LogID) * 2 + sizeof(TermID));
+  LogID logId;
+  auto offset = sizeof(LogID) + sizeof(TermID);
+  memcpy(reinterpret_cast<void*>(&logId), val.data() + offset, sizeof(LogID));
+  return logId;
+}
+
+nebula::cpp2::ErrorCode AnalyticsListener::cleanup() {
+  LOG(INFO) << idStr_ << "Clean the data of the analytics listener";
+  if (csrEngine_ != nullptr) {
+    csrEngine_->clear();
+  }
+  // All the keys of the part start with a byte of their type, which is less than the one of the
+  // data version key
+  auto batch = engine_->startBatchWrite();
+  auto code = batch->removeRange("", NebulaKeyUtils::dataVersionKey());
+  if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+    code = engine_->commitBatchWrite(
+        std::move(batch), FLAGS_rocksdb_disable_wal, FLAGS_rocksdb_wal_sync, true);
+  }
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    LOG(WARNING) << idStr_ << "Failed to clean the data, error "
+                 << apache::thrift::util::enumNameSafe(code);
+    return code;
+  }
+  return Listener::cleanup();
+}
+
+nebula::cpp2::ErrorCode AnalyticsListener::putAppliedId(WriteBatch* batch,
+                                                        LogID lastId,
+                                                        TermID lastTerm,
+                                                        LogID lastApplyLogId) {
+  std::string val;
+  val.reserve(sizeof(LogID) * 2 + sizeof(TermID));
+  val.append(reinterpret_cast<const char*>(&lastId), sizeof(LogID))
+      .append(reinterpret_cast<const char*>(&lastTerm), sizeof(TermID))
+      .append(reinterpret_cast<const char*>(&lastApplyLogId), sizeof(LogID));
+  return batch->put(NebulaKeyUtils::systemCommitKey(partId_), val);
+}
+
+}  // namespace kvstore
+}  // namespace nebula
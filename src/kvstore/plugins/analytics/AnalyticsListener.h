@@ -0,0 +1,150 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef KVSTORE_PLUGINS_ANALYTICS_LISTENER_H_
+#define KVSTORE_PLUGINS_ANALYTICS_LISTENER_H_
+
+#include <rocksdb/merge_operator.h>
+
+#include "kvstore/Listener.h"
+#include "kvstore/plugins/analytics/CsrEngine.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * A read replica of a part for the analytical queries. It applies all the changes of the logs to
+ * a RocksEngine of its own, which is tuned by the rocksdb flags of the listener storaged, and
+ * serves the reads without being a member of raft, so the heavy scans don't slow down the writes
+ * and the online reads on the peers.
+ *
+ * The logs are applied as a whole batch each time, so the reads see the state after some
+ * committed log, which lags behind the leader by about listener_commit_interval_secs.
+ *
+ * If analytics_csr_refresh_secs is positive, the reads are served from a CsrEngine instead, which
+ * is refreshed by the interval, so the traversals read the edges from a memory mapped csr snapshot
+ * at the cost of lagging behind by up to the interval more.
+ */
+class AnalyticsListener : public Listener {
+ public:
+  /**
+   * @brief Construct a new Analytics Listener, it is a derived class of Listener
+   *
+   * @param spaceId
+   * @param partId
+   * @param localAddr Listener ip/addr
+   * @param walPath Listener's wal path, the data is kept in its parent directory
+   * @param ioPool IOThreadPool for listener
+   * @param workers Background thread for listener
+   * @param handlers Worker thread for listener
+   * @param snapshotMan Snapshot manager
+   * @param clientMan Client manager
+   * @param diskMan Disk manager
+   * @param schemaMan Schema manager
+   */
+  AnalyticsListener(GraphSpaceID spaceId,
+                    PartitionID partId,
+                    HostAddr localAddr,
+                    const std::string& walPath,
+                    std::shared_ptr<folly::IOThreadPoolExecutor> ioPool,
+                    std::shared_ptr<thread::GenericThreadPool> workers,
+                    std::shared_ptr<folly::Executor> handlers,
+                    std::shared_ptr<raftex::SnapshotManager> snapshotMan,
+                    std::shared_ptr<RaftClient> clientMan,
+                    std::shared_ptr<DiskManager> diskMan,
+                    meta::SchemaManager* schemaMan);
+
+  /**
+   * @brief Set the merge operator of the engine, which must be the same as the one of the parts to
+   * apply the merges. Called before start.
+   */
+  void setMergeOperator(std::shared_ptr<rocksdb::MergeOperator> mergeOp) {
+    mergeOp_ = std::move(mergeOp);
+  }
+
+  /**
+   * @brief The engine serving the reads, the csr view of the engine keeping the data of the part
+   * if it's enabled
+   */
+  KVEngine* readEngine() override {
+    return csrEngine_ != nullptr ? csrEngine_.get() : engine_.get();
+  }
+
+  /**
+   * @brief Remove all the data of the part, called in RaftPart::reset
+   *
+   * @return nebula::cpp2::ErrorCode
+   */
+  nebula::cpp2::ErrorCode cleanup() override;
+
+ protected:
+  /**
+   * @brief Init work: get vid length, open the engine, and schedule the refresh of the csr view
+   */
+  void init() override;
+
+  /**
+   * @brief Put the data of the snapshot
+   *
+   * @param data Key/value to apply
+   * @return True if succeed. False if failed.
+   */
+  bool apply(const std::vector<KV>& data) override;
+
+  bool appliesAllChanges() const override {
+    return true;
+  }
+
+  /**
+   * @brief Write all the changes along with the last apply id in one batch
+   */
+  bool applyBatch(const std::vector<BatchOp>& batch, LogID lastApplyLogId) override;
+
+  /**
+   * @brief Persist commitLogId commitLogTerm and lastApplyLogId
+   */
+  bool persist(LogID lastId, TermID lastTerm, LogID lastApplyLogId) override;
+
+  /**
+   * @brief Get commit log id and commit log term from the engine, called in start()
+   *
+   * @return std::pair<LogID, TermID>
+   */
+  std::pair<LogID, TermID> lastCommittedLogId() override;
+
+  /**
+   * @brief Get last apply id from the engine, used in initialization
+   *
+   * @return LogID Last apply log id
+   */
+  LogID lastApplyLogId() override;
+
+ private:
+  /**
+   * @brief Refresh the csr view in the handlers, and schedule the next one
+   */
+  void refreshCsr();
+
+  /**
+   * @brief Add the commit log id and term, and the last apply id to the batch
+   */
+  nebula::cpp2::ErrorCode putAppliedId(WriteBatch* batch,
+                                       LogID lastId,
+                                       TermID lastTerm,
+                                       LogID lastApplyLogId);
+
+  std::string dataPath_;
+  std::shared_ptr<rocksdb::MergeOperator> mergeOp_{nullptr};
+  std::unique_ptr<KVEngine> engine_{nullptr};
+  // Destroyed before the engine it views
+  std::unique_ptr<CsrEngine> csrEngine_{nullptr};
+  // The commit log id and term persisted last time
+  LogID lastCommitId_{0};
+  TermID lastCommitTerm_{0};
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+#endif  // KVSTORE_PLUGINS_ANALYTICS_LISTENER_H_
@@ -0,0 +1,165 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "kvstore/plugins/analytics/CsrEngine.h"
+
+#include "common/time/Duration.h"
+
+namespace nebula {
+namespace kvstore {
+
+namespace {
+
+// An iterator keeping the version it reads alive
+class PinnedIterator final : public KVIterator {
+ public:
+  PinnedIterator(std::shared_ptr<const void> pin, std::unique_ptr<KVIterator> iter)
+      : pin_(std::move(pin)), iter_(std::move(iter)) {}
+
+  bool valid() const override {
+    return iter_->valid();
+  }
+
+  void next() override {
+    iter_->next();
+  }
+
+  void prev() override {
+    iter_->prev();
+  }
+
+  void seek(folly::StringPiece target) override {
+    iter_->seek(target);
+  }
+
+  folly::StringPiece key() const override {
+    return iter_->key();
+  }
+
+  folly::StringPiece val() const override {
+    return iter_->val();
+  }
+
+ private:
+  std::shared_ptr<const void> pin_;
+  std::unique_ptr<KVIterator> iter_;
+};
+
+}  // namespace
+
+bool CsrEngine::refresh() {
+  uint64_t epoch = 0;
+  {
+    std::lock_guard<std::mutex> lk(lock_);
+    epoch = epoch_;
+  }
+  time::Duration duration;
+  auto version = std::make_shared<Version>();
+  version->engine = engine_;
+  version->snapshot = engine_->GetSnapshot();
+  version->csr = CsrSnapshot::build(engine_, version->snapshot, partId_, vIdLen_, path_);
+  if (version->csr == nullptr) {
+    LOG(WARNING) << "Failed to build the csr snapshot of space " << spaceId_ << " part "
+                 << partId_;
+    return false;
+  }
+  auto numVertices = version->csr->numVertices();
+  auto numEdges = version->csr->numEdges();
+  std::shared_ptr<const Version> old = std::move(version);
+  {
+    std::lock_guard<std::mutex> lk(lock_);
+    if (epoch != epoch_) {
+      return false;
+    }
+    version_.swap(old);
+  }
+  LOG(INFO) << "Refreshed the csr snapshot of space " << spaceId_ << " part " << partId_
+            << " with " << numVertices << " vertices and " << numEdges << " edges in "
+            << duration.elapsedInMSec() << "ms";
+  return true;
+}
+
+void CsrEngine::clear() {
+  std::shared_ptr<const Version> old;
+  {
+    std::lock_guard<std::mutex> lk(lock_);
+    ++epoch_;
+    version_.swap(old);
+  }
+  ::unlink(path_.c_str());
+}
+
+nebula::cpp2::ErrorCode CsrEngine::get(const std::string& key,
+                                       std::string* value,
+                                       const void* snapshot) {
+  if (snapshot == nullptr) {
+    if (auto version = current()) {
+      return engine_->get(key, value, version->snapshot);
+    }
+  }
+  return engine_->get(key, value, snapshot);
+}
+
+std::vector<Status> CsrEngine::multiGet(const std::vector<std::string>& keys,
+                                        std::vector<std::string>* values) {
+  auto version = current();
+  if (version == nullptr) {
+    return engine_->multiGet(keys, values);
+  }
+  // The batched MultiGet of the engine doesn't read a snapshot
+  values->resize(keys.size());
+  std::vector<Status> ret;
+  ret.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    auto code = engine_->get(keys[i], &(*values)[i], version->snapshot);
+    if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+      ret.emplace_back(Status::OK());
+    } else if (code == nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
+      ret.emplace_back(Status::KeyNotFound());
+    } else {
+      ret.emplace_back(Status::Error());
+    }
+  }
+  return ret;
+}
+
+nebula::cpp2::ErrorCode CsrEngine::range(const std::string& start,
+                                         const std::string& end,
+                                         std::unique_ptr<KVIterator>* iter,
+                                         const void* snapshot) {
+  auto version = snapshot == nullptr ? current() : nullptr;
+  if (version == nullptr) {
+    return engine_->range(start, end, iter, snapshot);
+  }
+  std::unique_ptr<KVIterator> it;
+  auto code = engine_->range(start, end, &it, version->snapshot);
+  if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+    *iter = std::make_unique<PinnedIterator>(std::move(version), std::move(it));
+  }
+  return code;
+}
+
+nebula::cpp2::ErrorCode CsrEngine::prefix(const std::string& prefix,
+                                          std::unique_ptr<KVIterator>* iter,
+                                          const void* snapshot) {
+  auto version = snapshot == nullptr ? current() : nullptr;
+  if (version == nullptr) {
+    return engine_->prefix(prefix, iter, snapshot);
+  }
+  if (version->csr->covers(prefix)) {
+    auto it = version->csr->prefix(prefix);
+    *iter = std::make_unique<PinnedIterator>(std::move(version), std::move(it));
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+  std::unique_ptr<KVIterator> it;
+  auto code = engine_->prefix(prefix, &it, version->snapshot);
+  if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+    *iter = std::make_unique<PinnedIterator>(std::move(version), std::move(it));
+  }
+  return code;
+}
+
+}  // namespace kvstore
+}  // namespace nebula
@@ -0,0 +1,240 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef KVSTORE_PLUGINS_ANALYTICS_CSRENGINE_H_
+#define KVSTORE_PLUGINS_ANALYTICS_CSRENGINE_H_
+
+#include "kvstore/KVEngine.h"
+#include "kvstore/plugins/analytics/CsrSnapshot.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * A read only view of the engine of a part at the time of its last refresh, which serves the reads
+ * of the edges from a CsrSnapshot built then, and all the other reads from a snapshot of the engine
+ * taken along with it, so the traversals and the algorithm jobs see one consistent state of the
+ * graph.
+ *
+ * The reads given a snapshot of their own, rangeWithPrefix and scan go to the engine as they are,
+ * so do the writes. Before the first refresh, or after clear(), all the reads go to the engine.
+ */
+class CsrEngine : public KVEngine {
+ public:
+  /**
+   * @brief Construct a new view of the engine
+   *
+   * @param spaceId
+   * @param partId
+   * @param vIdLen
+   * @param engine The engine of the part, which must outlive the view
+   * @param path The path of the file of the snapshot
+   */
+  CsrEngine(GraphSpaceID spaceId,
+            PartitionID partId,
+            size_t vIdLen,
+            KVEngine* engine,
+            std::string path)
+      : KVEngine(spaceId),
+        partId_(partId),
+        vIdLen_(vIdLen),
+        engine_(engine),
+        path_(std::move(path)) {}
+
+  /**
+   * @brief Build a new snapshot from the latest data of the engine and switch the reads to it,
+   * the reads in flight go on with the old one
+   *
+   * @return True if switched
+   */
+  bool refresh();
+
+  /**
+   * @brief Drop the snapshot and read the engine as it is, the snapshot being built is dropped too
+   */
+  void clear();
+
+  void stop() override {}
+
+  const char* getDataRoot() const override {
+    return engine_->getDataRoot();
+  }
+
+  const char* getWalRoot() const override {
+    return engine_->getWalRoot();
+  }
+
+  std::unique_ptr<WriteBatch> startBatchWrite() override {
+    return engine_->startBatchWrite();
+  }
+
+  nebula::cpp2::ErrorCode commitBatchWrite(std::unique_ptr<WriteBatch> batch,
+                                           bool disableWAL,
+                                           bool sync,
+                                           bool wait) override {
+    return engine_->commitBatchWrite(std::move(batch), disableWAL, sync, wait);
+  }
+
+  const void* GetSnapshot() override {
+    return engine_->GetSnapshot();
+  }
+
+  void ReleaseSnapshot(const void* snapshot) override {
+    engine_->ReleaseSnapshot(snapshot);
+  }
+
+  nebula::cpp2::ErrorCode get(const std::string& key,
+                              std::string* value,
+                              const void* snapshot = nullptr) override;
+
+  std::vector<Status> multiGet(const std::vector<std::string>& keys,
+                               std::vector<std::string>* values) override;
+
+  nebula::cpp2::ErrorCode range(const std::string& start,
+                                const std::string& end,
+                                std::unique_ptr<KVIterator>* iter,
+                                const void* snapshot = nullptr) override;
+
+  /**
+   * @brief Iterate the prefix, from the csr snapshot if it's of the edges
+   */
+  nebula::cpp2::ErrorCode prefix(const std::string& prefix,
+                                 std::unique_ptr<KVIterator>* iter,
+                                 const void* snapshot = nullptr) override;
+
+  nebula::cpp2::ErrorCode rangeWithPrefix(const std::string& start,
+                                          const std::string& prefix,
+                                          std::unique_ptr<KVIterator>* iter) override {
+    return engine_->rangeWithPrefix(start, prefix, iter);
+  }
+
+  nebula::cpp2::ErrorCode scan(std::unique_ptr<KVIterator>* storageIter) override {
+    return engine_->scan(storageIter);
+  }
+
+  nebula::cpp2::ErrorCode put(std::string key, std::string value) override {
+    return engine_->put(std::move(key), std::move(value));
+  }
+
+  nebula::cpp2::ErrorCode multiPut(std::vector<KV> keyValues) override {
+    return engine_->multiPut(std::move(keyValues));
+  }
+
+  nebula::cpp2::ErrorCode remove(const std::string& key) override {
+    return engine_->remove(key);
+  }
+
+  nebula::cpp2::ErrorCode multiRemove(std::vector<std::string> keys) override {
+    return engine_->multiRemove(std::move(keys));
+  }
+
+  nebula::cpp2::ErrorCode removeRange(const std::string& start, const std::string& end) override {
+    return engine_->removeRange(start, end);
+  }
+
+  void addPart(PartitionID partId, const Peers& raftPeers) override {
+    engine_->addPart(partId, raftPeers);
+  }
+
+  nebula::cpp2::ErrorCode updatePart(PartitionID partId, const Peer& raftPeer) override {
+    return engine_->updatePart(partId, raftPeer);
+  }
+
+  void removePart(PartitionID partId) override {
+    engine_->removePart(partId);
+  }
+
+  std::vector<PartitionID> allParts() override {
+    return engine_->allParts();
+  }
+
+  std::map<PartitionID, Peers> balancePartPeers() override {
+    return engine_->balancePartPeers();
+  }
+
+  int32_t totalPartsNum() override {
+    return engine_->totalPartsNum();
+  }
+
+  nebula::cpp2::ErrorCode ingest(const std::vector<std::string>& files,
+                                 bool verifyFileChecksum = false) override {
+    return engine_->ingest(files, verifyFileChecksum);
+  }
+
+  nebula::cpp2::ErrorCode setOption(const std::string& configKey,
+                                    const std::string& configValue) override {
+    return engine_->setOption(configKey, configValue);
+  }
+
+  nebula::cpp2::ErrorCode setDBOption(const std::string& configKey,
+                                      const std::string& configValue) override {
+    return engine_->setDBOption(configKey, configValue);
+  }
+
+  ErrorOr<nebula::cpp2::ErrorCode, std::string> getProperty(const std::string& property) override {
+    return engine_->getProperty(property);
+  }
+
+  nebula::cpp2::ErrorCode compact() override {
+    return engine_->compact();
+  }
+
+  nebula::cpp2::ErrorCode compactRange(const std::string& start, const std::string& end) override {
+    return engine_->compactRange(start, end);
+  }
+
+  std::vector<std::pair<std::string, std::string>> tombstoneRanges(double ratio) override {
+    return engine_->tombstoneRanges(ratio);
+  }
+
+  nebula::cpp2::ErrorCode flush() override {
+    return engine_->flush();
+  }
+
+  nebula::cpp2::ErrorCode createCheckpoint(const std::string& checkpointPath) override {
+    return engine_->createCheckpoint(checkpointPath);
+  }
+
+  ErrorOr<nebula::cpp2::ErrorCode, std::string> backupTable(
+      const std::string& path,
+      const std::string& tablePrefix,
+      std::function<bool(const folly::StringPiece& key)> filter) override {
+    return engine_->backupTable(path, tablePrefix, std::move(filter));
+  }
+
+  nebula::cpp2::ErrorCode backup() override {
+    return engine_->backup();
+  }
+
+ private:
+  // The csr snapshot and the snapshot of the engine at the same time, released by the last read
+  struct Version {
+    ~Version() {
+      engine->ReleaseSnapshot(snapshot);
+    }
+
+    KVEngine* engine{nullptr};
+    const void* snapshot{nullptr};
+    std::shared_ptr<CsrSnapshot> csr;
+  };
+
+  std::shared_ptr<const Version> current() const {
+    std::lock_guard<std::mutex> lk(lock_);
+    return version_;
+  }
+
+  PartitionID partId_;
+  size_t vIdLen_;
+  KVEngine* engine_;
+  std::string path_;
+  mutable std::mutex lock_;
+  std::shared_ptr<const Version> version_;
+  // Bumped by clear(), so a snapshot built before it is not used
+  uint64_t epoch_{0};
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+#endif  // KVSTORE_PLUGINS_ANALYTICS_CSRENGINE_H_
@@ -0,0 +1,280 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "kvstore/plugins/analytics/CsrSnapshot.h"
+
+#include <folly/ScopeGuard.h>
+
+#include <fstream>
+
+#include "common/utils/NebulaKeyUtils.h"
+
+namespace nebula {
+namespace kvstore {
+
+namespace {
+
+// "NGCSR01" in little endian
+constexpr uint64_t kCsrMagic = 0x3130525343474eULL;
+
+struct FileHeader {
+  uint64_t magic{kCsrMagic};
+  int32_t partId{0};
+  uint32_t vIdLen{0};
+  uint64_t numVertices{0};
+  uint64_t numEdges{0};
+};
+
+// The sections of the file are aligned by 8 bytes, so the offsets are read in place
+size_t padded(size_t len) {
+  return (len + 7) & ~static_cast<size_t>(7);
+}
+
+// The first index in [lo, hi) where pred doesn't hold, pred holds for a prefix of the range
+template <typename Pred>
+size_t partitionPoint(size_t lo, size_t hi, Pred pred) {
+  while (lo < hi) {
+    auto mid = lo + (hi - lo) / 2;
+    if (pred(mid)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+}  // namespace
+
+class CsrIterator final : public KVIterator {
+ public:
+  CsrIterator(const CsrSnapshot* csr, size_t vertex, size_t begin, size_t end)
+      : csr_(csr), vertex_(vertex), begin_(begin), end_(end), edge_(begin) {
+    key_ = csr_->keyPrefix_;
+    key_.resize(key_.size() + csr_->vIdLen_ + csr_->suffixLen_);
+    load();
+  }
+
+  bool valid() const override {
+    return edge_ >= begin_ && edge_ < end_;
+  }
+
+  void next() override {
+    ++edge_;
+    load();
+  }
+
+  void prev() override {
+    if (edge_ == begin_) {
+      edge_ = end_;
+      return;
+    }
+    --edge_;
+    load();
+  }
+
+  folly::StringPiece key() const override {
+    return key_;
+  }
+
+  folly::StringPiece val() const override {
+    return csr_->valueAt(edge_);
+  }
+
+ private:
+  void load() {
+    if (!valid()) {
+      return;
+    }
+    // Each vertex kept has some edges, so the one of the edge is next to the last one
+    while (csr_->offsets_[vertex_ + 1] <= edge_) {
+      ++vertex_;
+    }
+    while (csr_->offsets_[vertex_] > edge_) {
+      --vertex_;
+    }
+    auto* pos = &key_[csr_->keyPrefix_.size()];
+    memcpy(pos, csr_->vidAt(vertex_).data(), csr_->vIdLen_);
+    memcpy(pos + csr_->vIdLen_, csr_->suffixAt(edge_).data(), csr_->suffixLen_);
+  }
+
+  const CsrSnapshot* csr_;
+  size_t vertex_;
+  size_t begin_;
+  size_t end_;
+  size_t edge_;
+  std::string key_;
+};
+
+CsrSnapshot::CsrSnapshot(PartitionID partId, size_t vIdLen)
+    : keyPrefix_(NebulaKeyUtils::edgePrefix(partId)),
+      vIdLen_(vIdLen),
+      suffixLen_(kEdgeLen + (vIdLen << 1) - keyPrefix_.size() - vIdLen) {}
+
+std::shared_ptr<CsrSnapshot> CsrSnapshot::build(KVEngine* engine,
+                                                const void* snapshot,
+                                                PartitionID partId,
+                                                size_t vIdLen,
+                                                const std::string& path) {
+  std::unique_ptr<KVIterator> iter;
+  auto code = engine->prefix(NebulaKeyUtils::edgePrefix(partId), &iter, snapshot);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    LOG(WARNING) << "Failed to scan the edges of part " << partId << ", error "
+                 << apache::thrift::util::enumNameSafe(code);
+    return nullptr;
+  }
+
+  // The props are written to a file of their own first, as they are the bulk of the data
+  auto valuesPath = path + ".values";
+  SCOPE_EXIT {
+    ::unlink(valuesPath.c_str());
+  };
+  std::ofstream values(valuesPath, std::ios::binary | std::ios::trunc);
+  auto keyLen = static_cast<size_t>(kEdgeLen) + (vIdLen << 1);
+  auto prefixLen = sizeof(PartitionID);
+  std::string vids;
+  std::vector<uint64_t> offsets;
+  std::string suffixes;
+  std::vector<uint64_t> valueOffsets{0};
+  for (; iter->valid(); iter->next()) {
+    auto key = iter->key();
+    auto val = iter->val();
+    if (key.size() != keyLen) {
+      LOG(WARNING) << "Unexpected edge key of " << key.size() << " bytes in part " << partId;
+      return nullptr;
+    }
+    auto src = key.subpiece(prefixLen, vIdLen);
+    if (offsets.empty() || folly::StringPiece(vids).subpiece(vids.size() - vIdLen) != src) {
+      vids.append(src.data(), src.size());
+      offsets.emplace_back(valueOffsets.size() - 1);
+    }
+    suffixes.append(key.data() + prefixLen + vIdLen, keyLen - prefixLen - vIdLen);
+    values.write(val.data(), val.size());
+    valueOffsets.emplace_back(valueOffsets.back() + val.size());
+  }
+  offsets.emplace_back(valueOffsets.size() - 1);
+  values.close();
+  if (!values) {
+    LOG(WARNING) << "Failed to write " << valuesPath;
+    return nullptr;
+  }
+
+  FileHeader header;
+  header.partId = partId;
+  header.vIdLen = vIdLen;
+  header.numVertices = offsets.size() - 1;
+  header.numEdges = valueOffsets.size() - 1;
+  auto tmpPath = path + ".tmp";
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    static const char kPadding[8] = {0};
+    auto write = [&out](const void* data, size_t len) {
+      out.write(reinterpret_cast<const char*>(data), len);
+      out.write(kPadding, padded(len) - len);
+    };
+    write(&header, sizeof(header));
+    write(vids.data(), vids.size());
+    write(offsets.data(), offsets.size() * sizeof(uint64_t));
+    write(suffixes.data(), suffixes.size());
+    write(valueOffsets.data(), valueOffsets.size() * sizeof(uint64_t));
+    if (valueOffsets.back() > 0) {
+      std::ifstream in(valuesPath, std::ios::binary);
+      out << in.rdbuf();
+    }
+    out.close();
+    if (!out) {
+      LOG(WARNING) << "Failed to write " << tmpPath;
+      ::unlink(tmpPath.c_str());
+      return nullptr;
+    }
+  }
+  // The file mapped by the old snapshot is kept until it's unmapped
+  if (::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Failed to rename " << tmpPath << " to " << path << ", errno " << errno;
+    ::unlink(tmpPath.c_str());
+    return nullptr;
+  }
+  return open(path, partId, vIdLen);
+}
+
+std::shared_ptr<CsrSnapshot> CsrSnapshot::open(const std::string& path,
+                                               PartitionID partId,
+                                               size_t vIdLen) {
+  std::shared_ptr<CsrSnapshot> csr(new CsrSnapshot(partId, vIdLen));
+  try {
+    csr->mapping_ = std::make_unique<folly::MemoryMapping>(path.c_str());
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Failed to map " << path << ": " << e.what();
+    return nullptr;
+  }
+  auto data = csr->mapping_->range();
+  FileHeader header;
+  if (data.size() < sizeof(header)) {
+    LOG(WARNING) << path << " is not a csr snapshot";
+    return nullptr;
+  }
+  memcpy(&header, data.data(), sizeof(header));
+  if (header.magic != kCsrMagic || header.partId != partId || header.vIdLen != vIdLen) {
+    LOG(WARNING) << path << " is not a csr snapshot of part " << partId;
+    return nullptr;
+  }
+
+  const auto* base = reinterpret_cast<const char*>(data.data());
+  size_t offset = padded(sizeof(header));
+  // The section of the length at the offset, nullptr if it's out of the file
+  auto take = [&](size_t len) -> const char* {
+    if (offset > data.size() || len > data.size() - offset) {
+      return nullptr;
+    }
+    const auto* section = base + offset;
+    offset += padded(len);
+    return section;
+  };
+  csr->numVertices_ = header.numVertices;
+  csr->numEdges_ = header.numEdges;
+  csr->vids_ = take(header.numVertices * vIdLen);
+  csr->offsets_ =
+      reinterpret_cast<const uint64_t*>(take((header.numVertices + 1) * sizeof(uint64_t)));
+  csr->suffixes_ = take(header.numEdges * csr->suffixLen_);
+  csr->valueOffsets_ =
+      reinterpret_cast<const uint64_t*>(take((header.numEdges + 1) * sizeof(uint64_t)));
+  csr->values_ = offset <= data.size() ? base + offset : nullptr;
+  if (csr->vids_ == nullptr || csr->offsets_ == nullptr || csr->suffixes_ == nullptr ||
+      csr->valueOffsets_ == nullptr || csr->values_ == nullptr ||
+      csr->offsets_[header.numVertices] != header.numEdges ||
+      csr->valueOffsets_[header.numEdges] != data.size() - offset) {
+    LOG(WARNING) << path << " is truncated";
+    return nullptr;
+  }
+  return csr;
+}
+
+bool CsrSnapshot::covers(folly::StringPiece prefix) const {
+  return prefix.startsWith(keyPrefix_);
+}
+
+std::unique_ptr<KVIterator> CsrSnapshot::prefix(folly::StringPiece prefix) const {
+  DCHECK(covers(prefix));
+  auto rest = prefix.subpiece(keyPrefix_.size());
+  // The vertices whose vids start with the prefix, only one if the whole vid is given
+  auto vid = rest.subpiece(0, vIdLen_);
+  auto vBegin = partitionPoint(
+      0, numVertices_, [&](size_t i) { return vidAt(i).subpiece(0, vid.size()) < vid; });
+  auto vEnd = partitionPoint(
+      vBegin, numVertices_, [&](size_t i) { return vidAt(i).subpiece(0, vid.size()) <= vid; });
+  size_t begin = offsets_[vBegin];
+  size_t end = offsets_[vEnd];
+  if (rest.size() > vIdLen_) {
+    auto suffix = rest.subpiece(vIdLen_);
+    begin = partitionPoint(
+        begin, end, [&](size_t i) { return suffixAt(i).subpiece(0, suffix.size()) < suffix; });
+    end = partitionPoint(
+        begin, end, [&](size_t i) { return suffixAt(i).subpiece(0, suffix.size()) <= suffix; });
+  }
+  return std::make_unique<CsrIterator>(this, vBegin, begin, end);
+}
+
+}  // namespace kvstore
+}  // namespace nebula
@@ -0,0 +1,116 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef KVSTORE_PLUGINS_ANALYTICS_CSRSNAPSHOT_H_
+#define KVSTORE_PLUGINS_ANALYTICS_CSRSNAPSHOT_H_
+
+#include <folly/system/MemoryMapping.h>
+
+#include "kvstore/KVEngine.h"
+
+namespace nebula {
+namespace kvstore {
+
+class CsrIterator;
+
+/**
+ * An immutable snapshot of the edges of a part in the compressed sparse row layout, kept in a
+ * memory mapped file, so the traversals read the neighbors of a vertex from a few contiguous
+ * arrays instead of seeking and decoding the blocks of rocksdb.
+ *
+ * The file holds the sorted vids of the vertices having edges, the offsets of their first edges,
+ * the keys of the edges after the src vid, i.e. the edge type, the rank, the dst and the version,
+ * and the encoded props of the edges with their offsets. The edges of a vertex are in the order of
+ * their keys, so a prefix is read in the same order as rocksdb, and RowReader decodes the props
+ * as they are.
+ */
+class CsrSnapshot final {
+ public:
+  /**
+   * @brief Build the snapshot of the edges of the part read from the engine at the given snapshot
+   * into the file of the path, replacing the old one if any
+   *
+   * @param engine
+   * @param snapshot Snapshot of the engine, nullptr to read the latest data
+   * @param partId
+   * @param vIdLen
+   * @param path
+   * @return std::shared_ptr<CsrSnapshot> nullptr if failed
+   */
+  static std::shared_ptr<CsrSnapshot> build(KVEngine* engine,
+                                            const void* snapshot,
+                                            PartitionID partId,
+                                            size_t vIdLen,
+                                            const std::string& path);
+
+  /**
+   * @brief Map the file of the path built before
+   *
+   * @return std::shared_ptr<CsrSnapshot> nullptr if it's not a valid snapshot of the part
+   */
+  static std::shared_ptr<CsrSnapshot> open(const std::string& path,
+                                           PartitionID partId,
+                                           size_t vIdLen);
+
+  /**
+   * @brief Whether all the keys of the prefix are in the snapshot, which is true for the prefixes
+   * of the edges of the part
+   */
+  bool covers(folly::StringPiece prefix) const;
+
+  /**
+   * @brief Iterate the edges of the prefix, the iterator is valid while the snapshot is
+   *
+   * @param prefix A prefix covered by the snapshot
+   * @return std::unique_ptr<KVIterator>
+   */
+  std::unique_ptr<KVIterator> prefix(folly::StringPiece prefix) const;
+
+  size_t numVertices() const {
+    return numVertices_;
+  }
+
+  size_t numEdges() const {
+    return numEdges_;
+  }
+
+ private:
+  friend class CsrIterator;
+
+  CsrSnapshot(PartitionID partId, size_t vIdLen);
+
+  folly::StringPiece vidAt(size_t vertex) const {
+    return folly::StringPiece(vids_ + vertex * vIdLen_, vIdLen_);
+  }
+
+  folly::StringPiece suffixAt(size_t edge) const {
+    return folly::StringPiece(suffixes_ + edge * suffixLen_, suffixLen_);
+  }
+
+  folly::StringPiece valueAt(size_t edge) const {
+    return folly::StringPiece(values_ + valueOffsets_[edge],
+                              valueOffsets_[edge + 1] - valueOffsets_[edge]);
+  }
+
+  // The edge key prefix of the part
+  std::string keyPrefix_;
+  size_t vIdLen_{0};
+  // The length of the key after the src vid
+  size_t suffixLen_{0};
+  std::unique_ptr<folly::MemoryMapping> mapping_;
+  size_t numVertices_{0};
+  size_t numEdges_{0};
+  const char* vids_{nullptr};
+  // numVertices_ + 1 offsets of the first edges of the vertices
+  const uint64_t* offsets_{nullptr};
+  const char* suffixes_{nullptr};
+  // numEdges_ + 1 offsets of the props of the edges
+  const uint64_t* valueOffsets_{nullptr};
+  const char* values_{nullptr};
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+#endif  // KVSTORE_PLUGINS_ANALYTICS_CSRSNAPSHOT_H_
@@ -0,0 +1,447 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "kvstore/plugins/cdc/CDCListener.h"
+
+#include <folly/FileUtil.h>
+#include <folly/compression/Compression.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/json.h>
+
+#include "codec/CounterOperand.h"
+#include "codec/RowReaderWrapper.h"
+#include "common/process/ProcessUtils.h"
+#include "common/utils/NebulaKeyUtils.h"
+
+DEFINE_string(cdc_kafka_endpoints,
+              "",
+              "The Kafka REST proxies to publish the changes by the CDC listeners, separated by "
+              "commas, e.g. http://127.0.0.1:8082");
+DEFINE_string(cdc_topic_prefix, "nebula_cdc_", "The topic of a space is the prefix + its name");
+DEFINE_int32(cdc_max_inflight_batches,
+             16,
+             "Max batches of a part being published, the listener waits for them before decoding "
+             "more");
+DEFINE_int64(cdc_record_bytes, 512 * 1024, "Max bytes of the events in a record");
+DEFINE_string(cdc_compression,
+              "gzip",
+              "The compression of the requests to the REST proxies, options: none, gzip");
+DEFINE_int32(cdc_publish_concurrency,
+             8,
+             "Max number of the requests sent concurrently by all the CDC listeners");
+DEFINE_uint32(cdc_request_retry_times, 3, "Retry times of a request to publish the changes");
+DEFINE_int32(cdc_request_timeout_secs, 10, "Timeout of a request to publish the changes");
+
+namespace nebula {
+namespace kvstore {
+
+namespace {
+
+// The requests block on curl, so they are sent by the threads of their own
+folly::Executor* publishExecutor() {
+  static auto* executor =
+      new folly::CPUThreadPoolExecutor(std::max(FLAGS_cdc_publish_concurrency, 1),
+                                       std::make_shared<folly::NamedThreadFactory>("cdc-publish"));
+  return executor;
+}
+
+}  // namespace
+
+CDCListener::CDCListener(GraphSpaceID spaceId,
+                         PartitionID partId,
+                         HostAddr localAddr,
+                         const std::string& walPath,
+                         std::shared_ptr<folly::IOThreadPoolExecutor> ioPool,
+                         std::shared_ptr<thread::GenericThreadPool> workers,
+                         std::shared_ptr<folly::Executor> handlers,
+                         std::shared_ptr<raftex::SnapshotManager> snapshotMan,
+                         std::shared_ptr<RaftClient> clientMan,
+                         std::shared_ptr<DiskManager> diskMan,
+                         meta::SchemaManager* schemaMan)
+    : Listener(spaceId,
+               partId,
+               std::move(localAddr),
+               walPath,
+               ioPool,
+               workers,
+               handlers,
+               snapshotMan,
+               clientMan,
+               diskMan,
+               schemaMan),
+      offsetFile_(folly::stringPrintf("%s/cdc_offset_%d", walPath.c_str(), partId)),
+      requestFile_(folly::stringPrintf("%s/cdc_request_%d", walPath.c_str(), partId)) {
+  CHECK(!!schemaMan);
+}
+
+CDCListener::~CDCListener() {
+  std::unique_lock<std::mutex> lk(lock_);
+  cv_.wait(lk, [this] { return inflight_ == 0; });
+}
+
+void CDCListener::init() {
+  auto vRet = schemaMan_->getSpaceVidLen(spaceId_);
+  if (!vRet.ok()) {
+    LOG(FATAL) << "vid length error";
+  }
+  vIdLen_ = vRet.value();
+  auto tRet = schemaMan_->getSpaceVidType(spaceId_);
+  if (!tRet.ok()) {
+    LOG(FATAL) << "vid type error";
+  }
+  isIntId_ = tRet.value() == nebula::cpp2::PropertyType::INT64;
+
+  auto sRet = schemaMan_->toGraphSpaceName(spaceId_);
+  if (!sRet.ok()) {
+    LOG(FATAL) << "space name error";
+  }
+  spaceName_ = sRet.value();
+  topic_ = FLAGS_cdc_topic_prefix + spaceName_;
+
+  std::vector<std::string> endpoints;
+  folly::split(',', FLAGS_cdc_kafka_endpoints, endpoints, true);
+  for (auto& endpoint : endpoints) {
+    auto trimmed = folly::trimWhitespace(endpoint);
+    trimmed.removeSuffix("/");
+    if (!trimmed.empty()) {
+      endpoints_.emplace_back(trimmed.str());
+    }
+  }
+  if (endpoints_.empty()) {
+    LOG(FATAL) << "cdc_kafka_endpoints is not set";
+  }
+}
+
+bool CDCListener::apply(const std::vector<KV>& data) {
+  {
+    std::unique_lock<std::mutex> lk(lock_);
+    cv_.wait(lk, [this] { return inflight_ == 0; });
+  }
+  std::vector<std::string> events;
+  for (const auto& kv : data) {
+    auto event = toEvent(BatchLogType::OP_BATCH_PUT, kv.first, kv.second);
+    if (!event.empty()) {
+      events.emplace_back(std::move(event));
+    }
+  }
+  // The last log of the snapshot is not known until it's committed, so it's 0 in the records
+  if (!events.empty() && !publish(buildRequest(events, 0))) {
+    return false;
+  }
+  snapshotPublished_ = true;
+  return true;
+}
+
+bool CDCListener::applyBatch(const std::vector<BatchOp>& batch, LogID lastApplyLogId) {
+  if (failed_) {
+    {
+      std::unique_lock<std::mutex> lk(lock_);
+      cv_.wait(lk, [this] { return inflight_ == 0; });
+    }
+    LOG(WARNING) << idStr_ << "Failed to publish the changes, apply again from the log "
+                 << publishedLogId_ + 1;
+    {
+      std::lock_guard<thread::ProfiledMutex> guard(raftLock_);
+      lastApplyLogId_ = publishedLogId_;
+    }
+    failed_ = false;
+    return false;
+  }
+
+  std::vector<std::string> events;
+  for (const auto& op : batch) {
+    auto event = toEvent(std::get<0>(op), std::get<1>(op), std::get<2>(op));
+    if (!event.empty()) {
+      events.emplace_back(std::move(event));
+    }
+  }
+  auto body = events.empty() ? "" : buildRequest(events, lastApplyLogId);
+
+  std::unique_lock<std::mutex> lk(lock_);
+  auto maxInflight = static_cast<size_t>(std::max(FLAGS_cdc_max_inflight_batches, 1));
+  cv_.wait(lk, [this, maxInflight] { return inflight_ < maxInflight; });
+  inflight_++;
+  tail_ = std::move(tail_)
+              .via(publishExecutor())
+              .thenValue([this, body = std::move(body), lastApplyLogId](folly::Unit) {
+                if (!failed_ && (body.empty() || publish(body))) {
+                  publishedLogId_ = lastApplyLogId;
+                } else {
+                  failed_ = true;
+                }
+                std::lock_guard<std::mutex> g(lock_);
+                inflight_--;
+                cv_.notify_all();
+              });
+  return true;
+}
+
+bool CDCListener::persist(LogID lastId, TermID lastTerm, LogID lastApplyLogId) {
+  // The snapshot is published as a whole before it's committed
+  if (snapshotPublished_.exchange(false)) {
+    publishedLogId_ = lastApplyLogId;
+  }
+  if (!writeOffset(lastId, lastTerm, std::min(lastApplyLogId, publishedLogId_.load()))) {
+    LOG(FATAL) << "last apply ids write failed";
+  }
+  return true;
+}
+
+std::pair<LogID, TermID> CDCListener::lastCommittedLogId() {
+  std::string raw;
+  if (!folly::readFile(offsetFile_.c_str(), raw) ||
+      raw.size() != sizeof(LogID) * 2 + sizeof(TermID)) {
+    VLOG(3) << "Invalid or nonexistent file : " << offsetFile_;
+    return {0, 0};
+  }
+  LogID logId;
+  TermID termId;
+  memcpy(&logId, raw.data(), sizeof(LogID));
+  memcpy(&termId, raw.data() + sizeof(LogID), sizeof(TermID));
+  return {logId, termId};
+}
+
+LogID CDCListener::lastApplyLogId() {
+  std::string raw;
+  if (!folly::readFile(offsetFile_.c_str(), raw) ||
+      raw.size() != sizeof(LogID) * 2 + sizeof(TermID)) {
+    VLOG(3) << "Invalid or nonexistent file : " << offsetFile_;
+    return 0;
+  }
+  LogID logId;
+  memcpy(&logId, raw.data() + sizeof(LogID) + sizeof(TermID), sizeof(LogID));
+  publishedLogId_ = logId;
+  return logId;
+}
+
+void CDCListener::cleanWal() {
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
+  wal()->cleanWAL(publishedLogId_);
+}
+
+nebula::cpp2::ErrorCode CDCListener::cleanup() {
+  {
+    std::unique_lock<std::mutex> lk(lock_);
+    cv_.wait(lk, [this] { return inflight_ == 0; });
+  }
+  publishedLogId_ = 0;
+  failed_ = false;
+  snapshotPublished_ = false;
+  return Listener::cleanup();
+}
+
+bool CDCListener::writeOffset(LogID lastId, TermID lastTerm, LogID publishedLogId) {
+  std::string raw;
+  raw.reserve(sizeof(LogID) * 2 + sizeof(TermID));
+  raw.append(reinterpret_cast<const char*>(&lastId), sizeof(LogID))
+      .append(reinterpret_cast<const char*>(&lastTerm), sizeof(TermID))
+      .append(reinterpret_cast<const char*>(&publishedLogId), sizeof(LogID));
+  if (folly::writeFileAtomicNoThrow(offsetFile_, raw) != 0) {
+    VLOG(3) << "Failed to write file \"" << offsetFile_ << "\" (errno: " << errno
+            << "): " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+std::string CDCListener::toEvent(BatchLogType type,
+                                 folly::StringPiece key,
+                                 folly::StringPiece val) const {
+  auto vid = [this](folly::StringPiece id) -> folly::dynamic {
+    if (isIntId_) {
+      return *reinterpret_cast<const int64_t*>(id.data());
+    }
+    return id.subpiece(0, id.find_first_of('\0')).str();
+  };
+
+  // The range removal of the tags of a vertex is published as the removal of all its tags, and any
+  // other range by its bounds, so no removal is missed by the consumers
+  if (type == BatchLogType::OP_BATCH_REMOVE_RANGE) {
+    folly::dynamic event = folly::dynamic::object("op", "remove");
+    auto prefixLen = sizeof(PartitionID) + vIdLen_;
+    if (NebulaKeyUtils::isTag(vIdLen_, key) && NebulaKeyUtils::isTag(vIdLen_, val) &&
+        key.subpiece(0, prefixLen) == val.subpiece(0, prefixLen)) {
+      event["type"] = "vertex";
+      event["vid"] = vid(NebulaKeyUtils::getVertexId(vIdLen_, key));
+    } else {
+      LOG(WARNING) << idStr_ << "Publish the removal of the range from " << folly::hexlify(key)
+                   << " to " << folly::hexlify(val) << " by its bounds";
+      event["op"] = "remove_range";
+      event["start"] = folly::hexlify(key);
+      event["end"] = folly::hexlify(val);
+    }
+    return folly::toJson(event);
+  }
+
+  bool put = type == BatchLogType::OP_BATCH_PUT;
+  bool merge = type == BatchLogType::OP_BATCH_MERGE;
+  auto props = [](RowReader* reader) -> folly::dynamic {
+    folly::dynamic props = folly::dynamic::object;
+    const auto* schema = reader->getSchema();
+    for (size_t i = 0; i < reader->numFields(); i++) {
+      props[schema->getFieldName(i)] = reader->getValueByIndex(i).toJson();
+    }
+    return props;
+  };
+
+  // The merge of a counter update is published as the deltas added to the props, since the row it
+  // is applied to is not known here
+  folly::dynamic deltas = folly::dynamic::object;
+  if (merge) {
+    auto operand = CounterOperand::decode(val);
+    if (!operand.has_value()) {
+      VLOG(3) << "decode merge operand failed, key " << folly::hexlify(key);
+      return "";
+    }
+    for (const auto& delta : operand->deltas) {
+      deltas[delta.first] = delta.second.toJson();
+    }
+  }
+
+  folly::dynamic event = folly::dynamic::object("op", put ? "put" : (merge ? "merge" : "remove"));
+  if (NebulaKeyUtils::isTag(vIdLen_, key)) {
+    auto tagId = NebulaKeyUtils::getTagId(vIdLen_, key);
+    auto name = schemaMan_->toTagName(spaceId_, tagId);
+    if (!name.ok()) {
+      VLOG(3) << "get tag name failed, tagID " << tagId;
+      return "";
+    }
+    event["type"] = "vertex";
+    event["vid"] = vid(NebulaKeyUtils::getVertexId(vIdLen_, key));
+    event["tag"] = std::move(name).value();
+    if (put) {
+      auto reader = RowReaderWrapper::getTagPropReader(schemaMan_, spaceId_, tagId, val);
+      if (reader == nullptr) {
+        VLOG(3) << "get tag reader failed, tagID " << tagId;
+        return "";
+      }
+      event["props"] = props(reader.get());
+    } else if (merge) {
+      event["deltas"] = deltas;
+    }
+  } else if (NebulaKeyUtils::isEdge(vIdLen_, key)) {
+    auto edgeType = NebulaKeyUtils::getEdgeType(vIdLen_, key);
+    // The in edges are the same as the out edges
+    if (edgeType <= 0) {
+      return "";
+    }
+    auto name = schemaMan_->toEdgeName(spaceId_, edgeType);
+    if (!name.ok()) {
+      VLOG(3) << "get edge name failed, schema ID " << edgeType;
+      return "";
+    }
+    event["type"] = "edge";
+    event["src"] = vid(NebulaKeyUtils::getSrcId(vIdLen_, key));
+    event["dst"] = vid(NebulaKeyUtils::getDstId(vIdLen_, key));
+    event["rank"] = NebulaKeyUtils::getRank(vIdLen_, key);
+    event["edge"] = std::move(name).value();
+    if (put) {
+      auto reader = RowReaderWrapper::getEdgePropReader(schemaMan_, spaceId_, edgeType, val);
+      if (reader == nullptr) {
+        VLOG(3) << "get edge reader failed, schema ID " << edgeType;
+        return "";
+      }
+      event["props"] = props(reader.get());
+    } else if (merge) {
+      event["deltas"] = deltas;
+    }
+  } else {
+    return "";
+  }
+  return folly::toJson(event);
+}
+
+std::string CDCListener::buildRequest(const std::vector<std::string>& events, LogID logId) const {
+  // {"records": [{"key": "space:part", "value": {"space": name, "part": part, "log_id": id,
+  //   "seq": 0, "events": [event, ...]}}, ...]}
+  auto recordHead = folly::sformat(R"({{"key":"{}:{}","value":{{"space":{},"part":{},"log_id":{})",
+                                   spaceId_,
+                                   partId_,
+                                   folly::toJson(spaceName_),
+                                   partId_,
+                                   logId);
+  std::string body = R"({"records":[)";
+  size_t seq = 0;
+  size_t bytes = 0;
+  for (size_t i = 0; i < events.size(); i++) {
+    if (i == 0 || bytes >= static_cast<size_t>(FLAGS_cdc_record_bytes)) {
+      if (i != 0) {
+        body.append("]}},");
+      }
+      body.append(recordHead).append(folly::sformat(R"(,"seq":{},"events":[)", seq++));
+      bytes = 0;
+    } else {
+      body.append(",");
+    }
+    body.append(events[i]);
+    bytes += events[i].size();
+  }
+  body.append("]}}]}");
+  return body;
+}
+
+bool CDCListener::publish(const std::string& body) const {
+  std::string compressed;
+  if (FLAGS_cdc_compression == "gzip") {
+    compressed = folly::io::getCodec(folly::io::CodecType::GZIP)->compress(body);
+  }
+  const auto& data = compressed.empty() ? body : compressed;
+  auto retryCnt = std::max<uint32_t>(FLAGS_cdc_request_retry_times, 1);
+  auto index = folly::Random::rand32(endpoints_.size());
+  for (uint32_t i = 0; i < retryCnt; i++) {
+    if (publishOnce(endpoints_[(index + i) % endpoints_.size()], data, !compressed.empty())) {
+      return true;
+    }
+    VLOG(3) << idStr_ << "publish failed. retry : " << retryCnt - i - 1;
+  }
+  LOG(WARNING) << idStr_ << "Failed to publish to kafka.";
+  return false;
+}
+
+bool CDCListener::publishOnce(const std::string& endpoint,
+                              const std::string& body,
+                              bool gzip) const {
+  if (!folly::writeFile(body, requestFile_.c_str())) {
+    LOG(WARNING) << idStr_ << "Failed to write " << requestFile_;
+    return false;
+  }
+  auto command = folly::sformat(
+      "/usr/bin/curl -s -m {} -X POST -H \"Content-Type: application/vnd.kafka.json.v2+json\"{} "
+      "--data-binary @{} -w \"\\n%{{http_code}}\" \"{}/topics/{}\"",
+      FLAGS_cdc_request_timeout_secs,
+      gzip ? " -H \"Content-Encoding: gzip\"" : "",
+      requestFile_,
+      endpoint,
+      topic_);
+  auto result = ProcessUtils::runCommand(command.c_str());
+  if (!result.ok()) {
+    return false;
+  }
+  // The response followed by the http code
+  folly::StringPiece out(result.value());
+  auto pos = out.rfind('\n');
+  if (pos == folly::StringPiece::npos || folly::trimWhitespace(out.subpiece(pos + 1)) != "200") {
+    VLOG(3) << idStr_ << "publish failed: " << out;
+    return false;
+  }
+  // Each record is acked by its offset, or an error
+  try {
+    auto resp = folly::parseJson(out.subpiece(0, pos));
+    for (const auto& offset : resp.at("offsets")) {
+      auto* code = offset.get_ptr("error_code");
+      if (code != nullptr && !code->isNull()) {
+        VLOG(3) << idStr_ << "publish failed: " << out;
+        return false;
+      }
+    }
+  } catch (const std::exception& e) {
+    VLOG(3) << idStr_ << "invalid response: " << e.what();
+    return false;
+  }
+  return true;
+}
+
+}  // namespace kvstore
+}  // namespace nebula
@@ -0,0 +1,176 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef KVSTORE_PLUGINS_CDC_LISTENER_H_
+#define KVSTORE_PLUGINS_CDC_LISTENER_H_
+
+#include <folly/futures/Future.h>
+
+#include <condition_variable>
+
+#include "kvstore/Listener.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * A listener publishing the changes of a part to Kafka, so the systems downstream could consume
+ * the changes of the graph instead of polling it by scans.
+ *
+ * The changes of the committed logs are decoded into the events of the vertices and edges, with
+ * the names of their tags or edge types and their props, or the deltas added to the props by the
+ * merges of the counter updates. The removal of all the tags of a vertex by range has no tag, and
+ * the other range removals are published by their bounds in hex. The events of each batch applied
+ * are sent to the topic of the space, `cdc_topic_prefix` + the space name, through the Kafka REST
+ * proxies in cdc_kafka_endpoints, as the records keyed by the space and the part, so the ones of
+ * a part go to the same partition in order. Each record carries the id of the last log of the
+ * batch and its sequence in the batch.
+ *
+ * The batches are published in the background one after another, and the listener goes on to
+ * decode the next batches while at most cdc_max_inflight_batches of them are not acked yet. The
+ * offset persisted is the last log published, not the last one applied, so the batches not acked
+ * yet are published again after a restart, or once a publish fails. A consumer which drops the
+ * records of a part not after the last log id and sequence it has seen gets each change once.
+ */
+class CDCListener : public Listener {
+ public:
+  /**
+   * @brief Construct a new CDC Listener, it is a derived class of Listener
+   *
+   * @param spaceId
+   * @param partId
+   * @param localAddr Listener ip/addr
+   * @param walPath Listener's wal path
+   * @param ioPool IOThreadPool for listener
+   * @param workers Background thread for listener
+   * @param handlers Worker thread for listener
+   * @param snapshotMan Snapshot manager
+   * @param clientMan Client manager
+   * @param diskMan Disk manager
+   * @param schemaMan Schema manager
+   */
+  CDCListener(GraphSpaceID spaceId,
+              PartitionID partId,
+              HostAddr localAddr,
+              const std::string& walPath,
+              std::shared_ptr<folly::IOThreadPoolExecutor> ioPool,
+              std::shared_ptr<thread::GenericThreadPool> workers,
+              std::shared_ptr<folly::Executor> handlers,
+              std::shared_ptr<raftex::SnapshotManager> snapshotMan,
+              std::shared_ptr<RaftClient> clientMan,
+              std::shared_ptr<DiskManager> diskMan,
+              meta::SchemaManager* schemaMan);
+
+  /**
+   * @brief Wait for the batches in flight
+   */
+  ~CDCListener() override;
+
+  /**
+   * @brief Clean the wal before the last log published, the ones after it may be published again
+   */
+  void cleanWal() override;
+
+  /**
+   * @brief Reset the offset along with the listener, called in RaftPart::reset
+   *
+   * @return nebula::cpp2::ErrorCode
+   */
+  nebula::cpp2::ErrorCode cleanup() override;
+
+ protected:
+  /**
+   * @brief Init work: get vid length and type, the space name and the topic
+   */
+  void init() override;
+
+  /**
+   * @brief Publish the data of the snapshot, which is done before the snapshot is committed
+   *
+   * @param data Key/value to apply
+   * @return True if succeed. False if failed.
+   */
+  bool apply(const std::vector<KV>& data) override;
+
+  bool appliesAllChanges() const override {
+    return true;
+  }
+
+  /**
+   * @brief Decode the changes and publish them in the background, or rewind to the last log
+   * published if any batch failed
+   *
+   * @return True if the batch is accepted. False if the listener should apply again from the last
+   * log published.
+   */
+  bool applyBatch(const std::vector<BatchOp>& batch, LogID lastApplyLogId) override;
+
+  /**
+   * @brief Persist commitLogId commitLogTerm and the last log published as lastApplyLogId
+   */
+  bool persist(LogID lastId, TermID lastTerm, LogID lastApplyLogId) override;
+
+  /**
+   * @brief Get commit log id and commit log term from persistance storage, called in start()
+   *
+   * @return std::pair<LogID, TermID>
+   */
+  std::pair<LogID, TermID> lastCommittedLogId() override;
+
+  /**
+   * @brief Get the last log published from persistance storage, used in initialization
+   *
+   * @return LogID Last apply log id
+   */
+  LogID lastApplyLogId() override;
+
+ private:
+  /**
+   * @brief Decode the change of a vertex or an edge, or a range removal, into an event in json,
+   * empty if it's of none of them
+   */
+  std::string toEvent(BatchLogType type, folly::StringPiece key, folly::StringPiece val) const;
+
+  /**
+   * @brief The body of the request to publish the events as the records of the log, each record
+   * is no larger than about cdc_record_bytes
+   */
+  std::string buildRequest(const std::vector<std::string>& events, LogID logId) const;
+
+  /**
+   * @brief Publish the request, which is retried up to cdc_request_retry_times
+   */
+  bool publish(const std::string& body) const;
+
+  bool publishOnce(const std::string& endpoint, const std::string& body, bool gzip) const;
+
+  bool writeOffset(LogID lastId, TermID lastTerm, LogID publishedLogId);
+
+ private:
+  std::string offsetFile_;
+  // The file to send the body of the request from, the requests of a part are sent one by one
+  std::string requestFile_;
+  std::string spaceName_;
+  std::string topic_;
+  std::vector<std::string> endpoints_;
+  int32_t vIdLen_{0};
+  bool isIntId_{false};
+
+  std::mutex lock_;
+  std::condition_variable cv_;
+  // The batches are chained to be published in order
+  folly::Future<folly::Unit> tail_{folly::makeFuture()};
+  size_t inflight_{0};
+  std::atomic<LogID> publishedLogId_{0};
+  // Nothing is published once a batch fails, until the listener applies again from the last one
+  std::atomic<bool> failed_{false};
+  // Whether the data of a snapshot is published, of which the last log is known when it's
+  // committed
+  std::atomic<bool> snapshotPublished_{false};
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+#endif  // KVSTORE_PLUGINS_CDC_LISTENER_H_
@@ -5,14 +5,38 @@
 
 #include "kvstore/plugins/elasticsearch/ESListener.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
+
 #include "common/plugin/fulltext/elasticsearch/ESStorageAdapter.h"
 #include "common/utils/NebulaKeyUtils.h"
 
 DECLARE_uint32(ft_request_retry_times);
 DECLARE_int32(ft_bulk_batch_size);
+DEFINE_int64(ft_bulk_batch_bytes,
+             5 * 1024 * 1024,
+             "Max bytes of the docs in a bulk insert, besides ft_bulk_batch_size");
+DEFINE_int32(ft_bulk_concurrency,
+             4,
+             "Max number of the bulk inserts sent concurrently by all the listeners");
 
 namespace nebula {
 namespace kvstore {
+
+namespace {
+
+// The bulk inserts block on the http client, so they are sent by the threads of their own
+folly::Executor* bulkExecutor() {
+  static auto* executor =
+      new folly::CPUThreadPoolExecutor(std::max(FLAGS_ft_bulk_concurrency, 1),
+                                       std::make_shared<folly::NamedThreadFactory>("es-bulk"));
+  return executor;
+}
+
+size_t docBytes(const DocItem& item) {
+  return item.index.size() + item.column.size() + item.val.size();
+}
+
+}  // namespace
 void ESListener::init() {
   auto vRet = schemaMan_->getSpaceVidLen(spaceId_);
   if (!vRet.ok()) {
@@ -43,27 +67,46 @@ void ESListener::init() {
 }
 
 bool ESListener::apply(const std::vector<KV>& data) {
-  std::vector<nebula::plugin::DocItem> docItems;
+  // Split the docs into the bulks limited by both the number and the bytes
+  std::vector<std::vector<DocItem>> bulks(1);
+  size_t bytes = 0;
   for (const auto& kv : data) {
     if (!nebula::NebulaKeyUtils::isTag(vIdLen_, kv.first) &&
         !nebula::NebulaKeyUtils::isEdge(vIdLen_, kv.first)) {
       continue;
     }
+    auto& docItems = bulks.back();
+    auto size = docItems.size();
     if (!appendDocItem(docItems, kv)) {
       return false;
     }
-    if (docItems.size() >= static_cast<size_t>(FLAGS_ft_bulk_batch_size)) {
-      auto suc = writeData(docItems);
-      if (!suc) {
-        return suc;
-      }
-      docItems.clear();
+    for (auto i = size; i < docItems.size(); i++) {
+      bytes += docBytes(docItems[i]);
+    }
+    if (docItems.size() >= static_cast<size_t>(FLAGS_ft_bulk_batch_size) ||
+        bytes >= static_cast<size_t>(FLAGS_ft_bulk_batch_bytes)) {
+      bulks.emplace_back();
+      bytes = 0;
     }
   }
-  if (!docItems.empty()) {
-    return writeData(docItems);
+  if (bulks.back().empty()) {
+    bulks.pop_back();
   }
-  return true;
+  if (bulks.size() <= 1) {
+    return bulks.empty() || writeData(bulks.front());
+  }
+
+  // The doc id is derived from the content, so the bulks could be written in any order, and the
+  // whole batch is applied again if any of them fails
+  std::vector<folly::Future<bool>> futures;
+  futures.reserve(bulks.size());
+  for (const auto& bulk : bulks) {
+    futures.emplace_back(folly::via(bulkExecutor(), [this, &bulk] { return writeData(bulk); }));
+  }
+  auto results = folly::collectAll(futures).get();
+  return std::all_of(results.begin(), results.end(), [](const auto& result) {
+    return result.hasValue() && result.value();
+  });
 }
 
 bool ESListener::persist(LogID lastId, TermID lastTerm, LogID lastApplyLogId) {
@@ -0,0 +1,87 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "kvstore/raftex/HeartbeatBatcher.h"
+
+#include <folly/io/async/EventBase.h>
+
+DEFINE_uint32(raft_heartbeat_batch_window_ms,
+              0,
+              "The max milliseconds to buffer the heartbeats to the same peer, so that they "
+              "are sent in one rpc, 0 means sending them one by one. Only enable it when all "
+              "the storaged support batchHeartbeat");
+
+DECLARE_int32(raft_rpc_timeout_ms);
+
+namespace nebula {
+namespace raftex {
+
+folly::Future<cpp2::HeartbeatResponse> HeartbeatBatcher::send(
+    const HostAddr& addr,
+    cpp2::HeartbeatRequest req,
+    std::shared_ptr<RaftClient> clientMan,
+    folly::EventBase* eb) {
+  folly::Promise<cpp2::HeartbeatResponse> promise;
+  auto future = promise.getFuture();
+  bool first = false;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    auto& batch = batches_[addr];
+    first = batch.requests.empty();
+    batch.requests.emplace_back(std::move(req));
+    batch.promises.emplace_back(std::move(promise));
+  }
+  if (first) {
+    // The first heartbeat of a batch schedules the flush, the later ones just wait for it
+    eb->runAfterDelay(
+        [self = shared_from_this(), addr, clientMan = std::move(clientMan), eb]() mutable {
+          self->flush(addr, std::move(clientMan), eb);
+        },
+        FLAGS_raft_heartbeat_batch_window_ms);
+  }
+  return future;
+}
+
+void HeartbeatBatcher::flush(const HostAddr& addr,
+                             std::shared_ptr<RaftClient> clientMan,
+                             folly::EventBase* eb) {
+  Batch batch;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    auto iter = batches_.find(addr);
+    if (iter == batches_.end()) {
+      return;
+    }
+    batch = std::move(iter->second);
+    batches_.erase(iter);
+  }
+  VLOG(4) << "Send " << batch.requests.size() << " heartbeats to " << addr;
+  cpp2::BatchHeartbeatRequest req;
+  req.requests_ref() = std::move(batch.requests);
+  auto client = clientMan->client(addr, eb, false, FLAGS_raft_rpc_timeout_ms);
+  client->future_batchHeartbeat(req).via(eb).then(
+      [promises = std::move(batch.promises)](
+          folly::Try<cpp2::BatchHeartbeatResponse>&& t) mutable {
+        if (t.hasException()) {
+          for (auto& promise : promises) {
+            promise.setException(t.exception());
+          }
+          return;
+        }
+        auto& resps = *t.value().responses_ref();
+        for (size_t i = 0; i < promises.size(); i++) {
+          if (i < resps.size()) {
+            promises[i].setValue(std::move(resps[i]));
+          } else {
+            cpp2::HeartbeatResponse resp;
+            resp.error_code_ref() = nebula::cpp2::ErrorCode::E_RAFT_RPC_EXCEPTION;
+            promises[i].setValue(std::move(resp));
+          }
+        }
+      });
+}
+
+}  // namespace raftex
+}  // namespace nebula
@@ -0,0 +1,74 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef RAFTEX_HEARTBEATBATCHER_H_
+#define RAFTEX_HEARTBEATBATCHER_H_
+
+#include <folly/futures/Future.h>
+
+#include "common/base/Base.h"
+#include "common/thrift/ThriftClientManager.h"
+#include "interface/gen-cpp2/RaftexServiceAsyncClient.h"
+#include "interface/gen-cpp2/raftex_types.h"
+
+DECLARE_uint32(raft_heartbeat_batch_window_ms);
+
+namespace folly {
+class EventBase;
+}  // namespace folly
+
+namespace nebula {
+namespace raftex {
+
+/**
+ * @brief Coalesce the heartbeats of all the parts on this host which are bound for the same
+ * peer. The heartbeats are buffered for at most raft_heartbeat_batch_window_ms, and then sent in
+ * one batchHeartbeat rpc, the responses are fanned back out to each part. It is shared by all
+ * parts registered to the same RaftexService.
+ */
+class HeartbeatBatcher final : public std::enable_shared_from_this<HeartbeatBatcher> {
+ public:
+  using RaftClient = thrift::ThriftClientManager<cpp2::RaftexServiceAsyncClient>;
+
+  /**
+   * @brief Whether the heartbeats should be batched
+   */
+  static bool enabled() {
+    return FLAGS_raft_heartbeat_batch_window_ms > 0;
+  }
+
+  /**
+   * @brief Buffer the heartbeat to the peer, it will be sent with the others to the same peer
+   *
+   * @param addr The peer address
+   * @param req The heartbeat request
+   * @param clientMan Client manager used to send the batch
+   * @param eb The eventbase to send rpc, must be the one of current thread
+   * @return folly::Future<cpp2::HeartbeatResponse>
+   */
+  folly::Future<cpp2::HeartbeatResponse> send(const HostAddr& addr,
+                                              cpp2::HeartbeatRequest req,
+                                              std::shared_ptr<RaftClient> clientMan,
+                                              folly::EventBase* eb);
+
+ private:
+  struct Batch {
+    std::vector<cpp2::HeartbeatRequest> requests;
+    std::vector<folly::Promise<cpp2::HeartbeatResponse>> promises;
+  };
+
+  /**
+   * @brief Send the heartbeats buffered for the peer
+   */
+  void flush(const HostAddr& addr, std::shared_ptr<RaftClient> clientMan, folly::EventBase* eb);
+
+  std::mutex lock_;
+  std::unordered_map<HostAddr, Batch> batches_;
+};
+
+}  // namespace raftex
+}  // namespace nebula
+
+#endif  // RAFTEX_HEARTBEATBATCHER_H_
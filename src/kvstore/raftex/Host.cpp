@@ -12,6 +12,7 @@
 #include "common/network/NetworkUtils.h"
 #include "common/stats/StatsManager.h"
 #include "common/time/WallClock.h"
+#include "kvstore/raftex/HeartbeatBatcher.h"
 #include "kvstore/raftex/RaftPart.h"
 #include "kvstore/stats/KVStats.h"
 #include "kvstore/wal/FileBasedWal.h"
@@ -20,6 +21,11 @@ DEFINE_uint32(max_appendlog_batch_size,
               128,
               "The max number of logs in each appendLog request batch");
 DEFINE_uint32(max_outstanding_requests, 1024, "The max number of outstanding appendLog requests");
+DEFINE_uint32(max_inflight_appendlog_requests,
+              1,
+              "The max number of appendLog requests in flight to each peer, the logs are sent in "
+              "a pipeline if it's greater than 1, otherwise the next batch is sent after the "
+              "previous one is responded");
 DEFINE_int32(raft_rpc_timeout_ms, 1000, "rpc timeout for raft client");
 
 DECLARE_bool(trace_raft);
@@ -84,7 +90,7 @@ folly::Future<cpp2::AppendLogResponse> Host::appendLogs(folly::EventBase* eb,
   VLOG(4) << idStr_ << "Entering Host::appendLogs()";
 
   auto ret = folly::Future<cpp2::AppendLogResponse>::makeEmpty();
-  std::shared_ptr<cpp2::AppendLogRequest> req;
+  std::vector<std::shared_ptr<cpp2::AppendLogRequest>> reqs;
   {
     std::lock_guard<std::mutex> g(lock_);
 
@@ -124,17 +130,23 @@ folly::Future<cpp2::AppendLogResponse> Host::appendLogs(folly::EventBase* eb,
     logTermToSend_ = term;
     logIdToSend_ = logId;
     committedLogId_ = committedLogId;
+    lastLogIdDispatched_ = lastLogIdSent_;
+    lastLogTermDispatched_ = lastLogTermSent_;
 
     auto result = prepareAppendLogRequest();
     if (ok(result)) {
       VLOG_IF(1, FLAGS_trace_raft) << idStr_ << "Sending the pending request in the queue"
                                    << ", from " << lastLogIdSent_ + 1 << " to " << logIdToSend_;
-      req = std::move(value(result));
+      reqs.emplace_back(std::move(value(result)));
+      ++numInFlight_;
       pendingReq_ = std::make_tuple(0, 0, 0);
       promise_ = std::move(cachingPromise_);
       cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
       ret = promise_.getFuture();
       requestOnGoing_ = true;
+      // Fill the pipeline if there are more logs
+      auto more = prepareAppendLogRequests();
+      std::move(more.begin(), more.end(), std::back_inserter(reqs));
     } else {
       // target host is waiting for a snapshot or wal not found
       cpp2::AppendLogResponse r;
@@ -144,21 +156,130 @@ folly::Future<cpp2::AppendLogResponse> Host::appendLogs(folly::EventBase* eb,
   }
 
   // Get a new promise
-  appendLogsInternal(eb, std::move(req));
+  for (auto& req : reqs) {
+    appendLogsInternal(eb, std::move(req));
+  }
 
   return ret;
 }
 
 void Host::setResponse(const cpp2::AppendLogResponse& r) {
   CHECK(!lock_.try_lock());
+  CHECK_EQ(0, numInFlight_) << idStr_;
   promise_.setValue(r);
+  promise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
   cachingPromise_.setValue(r);
   cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
   pendingReq_ = std::make_tuple(0, 0, 0);
   requestOnGoing_ = false;
+  pipelineBroken_ = false;
   noMoreRequestCV_.notify_all();
 }
 
+void Host::stopPipeline(const cpp2::AppendLogResponse& r) {
+  CHECK(!lock_.try_lock());
+  if (numInFlight_ > 0) {
+    // Wait for the other requests in flight before giving up
+    pipelineBroken_ = true;
+    return;
+  }
+  setResponse(r);
+}
+
+std::vector<std::shared_ptr<cpp2::AppendLogRequest>> Host::handleAppendLogResponse(
+    const cpp2::AppendLogResponse& resp) {
+  CHECK(!lock_.try_lock());
+  auto res = canAppendLog();
+  if (res != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    cpp2::AppendLogResponse r;
+    r.error_code_ref() = res;
+    stopPipeline(r);
+    return {};
+  }
+  switch (resp.get_error_code()) {
+    case nebula::cpp2::ErrorCode::SUCCEEDED:
+    case nebula::cpp2::ErrorCode::E_RAFT_LOG_GAP:
+    case nebula::cpp2::ErrorCode::E_RAFT_LOG_STALE: {
+      VLOG(3) << idStr_ << "AppendLog request sent successfully";
+      // When it's the only request in flight, follow the matched log of the follower. Otherwise
+      // the responses may come out of order, so only move forward. A gap means the follower
+      // doesn't have the logs after the matched one, so rewind to it in any case, or the logs
+      // after the gap would be sent again and again.
+      bool stopAndWait = numInFlight_ == 0 && !pipelineBroken_;
+      bool gap = resp.get_error_code() == nebula::cpp2::ErrorCode::E_RAFT_LOG_GAP;
+      if (stopAndWait || gap || resp.get_last_matched_log_id() > lastLogIdSent_) {
+        lastLogIdSent_ = resp.get_last_matched_log_id();
+        lastLogTermSent_ = resp.get_last_matched_log_term();
+      }
+      if (stopAndWait || resp.get_committed_log_id() > followerCommittedLogId_) {
+        followerCommittedLogId_ = resp.get_committed_log_id();
+      }
+      if (resp.get_error_code() != nebula::cpp2::ErrorCode::SUCCEEDED && !stopAndWait) {
+        // The logs in the pipeline are mismatched, stop sending new logs and fall back to stop
+        // and wait from the matched log when all the requests in flight are responded
+        pipelineBroken_ = true;
+      }
+      if (pipelineBroken_) {
+        if (numInFlight_ > 0) {
+          return {};
+        }
+        pipelineBroken_ = false;
+      }
+      if (numInFlight_ == 0 || lastLogIdSent_ > lastLogIdDispatched_) {
+        lastLogIdDispatched_ = lastLogIdSent_;
+        lastLogTermDispatched_ = lastLogTermSent_;
+      }
+
+      if (lastLogIdSent_ < logIdToSend_) {
+        // More to send
+        VLOG(3) << idStr_ << "There are more logs to send";
+        return prepareAppendLogRequests();
+      }
+      // lastLogIdSent_ >= logIdToSend_
+      // All logs up to logIdToSend_ has been sent, fulfill the promise
+      promise_.setValue(resp);
+      promise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
+      // Check if there are any pending request:
+      // Eithor send pending requst if any, or set Host to vacant
+      return getPendingReqIfAny();
+    }
+    // Usually the peer is not in proper state, for example:
+    // E_RAFT_UNKNOWN_PART/E_RAFT_STOPPED/E_RAFT_NOT_READY/E_RAFT_WAITING_SNAPSHOT
+    // In this case, nothing changed, just return the error
+    default: {
+      VLOG_EVERY_N(2, 1000) << idStr_ << "Failed to append logs to the host (Err: "
+                            << apache::thrift::util::enumNameSafe(resp.get_error_code()) << ")";
+      stopPipeline(resp);
+      return {};
+    }
+  }
+}
+
+std::vector<std::shared_ptr<cpp2::AppendLogRequest>> Host::prepareAppendLogRequests() {
+  CHECK(!lock_.try_lock());
+  std::vector<std::shared_ptr<cpp2::AppendLogRequest>> reqs;
+  size_t window = std::max(1U, FLAGS_max_inflight_appendlog_requests);
+  while (numInFlight_ < window && !pipelineBroken_) {
+    // Only the first request could be empty, e.g. to tell the follower the committed log id
+    if (numInFlight_ > 0 && lastLogIdDispatched_ >= logIdToSend_) {
+      break;
+    }
+    auto result = prepareAppendLogRequest();
+    if (!ok(result)) {
+      if (numInFlight_ == 0) {
+        cpp2::AppendLogResponse r;
+        r.error_code_ref() = error(result);
+        setResponse(r);
+      }
+      // Otherwise the requests in flight will try again when they are responded
+      break;
+    }
+    reqs.emplace_back(std::move(value(result)));
+    ++numInFlight_;
+  }
+  return reqs;
+}
+
 void Host::appendLogsInternal(folly::EventBase* eb, std::shared_ptr<cpp2::AppendLogRequest> req) {
   using TransportException = apache::thrift::transport::TTransportException;
   auto beforeRpcUs = time::WallClock::fastNowInMicroSec();
@@ -173,65 +294,14 @@ void Host::appendLogsInternal(folly::EventBase* eb, std::shared_ptr<cpp2::Append
             << resp.get_current_term() << ", lastLogTerm " << resp.get_last_matched_log_term()
             << ", commitLogId " << resp.get_committed_log_id() << ", lastLogIdSent_ "
             << self->lastLogIdSent_ << ", lastLogTermSent_ " << self->lastLogTermSent_;
-        switch (resp.get_error_code()) {
-          case nebula::cpp2::ErrorCode::SUCCEEDED:
-          case nebula::cpp2::ErrorCode::E_RAFT_LOG_GAP:
-          case nebula::cpp2::ErrorCode::E_RAFT_LOG_STALE: {
-            VLOG(3) << self->idStr_ << "AppendLog request sent successfully";
-
-            std::shared_ptr<cpp2::AppendLogRequest> newReq;
-            {
-              std::lock_guard<std::mutex> g(self->lock_);
-              auto res = self->canAppendLog();
-              if (res != nebula::cpp2::ErrorCode::SUCCEEDED) {
-                cpp2::AppendLogResponse r;
-                r.error_code_ref() = res;
-                self->setResponse(r);
-                return;
-              }
-              // Host is working
-              self->lastLogIdSent_ = resp.get_last_matched_log_id();
-              self->lastLogTermSent_ = resp.get_last_matched_log_term();
-              self->followerCommittedLogId_ = resp.get_committed_log_id();
-              if (self->lastLogIdSent_ < self->logIdToSend_) {
-                // More to send
-                VLOG(3) << self->idStr_ << "There are more logs to send";
-                auto result = self->prepareAppendLogRequest();
-                if (ok(result)) {
-                  newReq = std::move(value(result));
-                } else {
-                  cpp2::AppendLogResponse r;
-                  r.error_code_ref() = error(result);
-                  self->setResponse(r);
-                  return;
-                }
-              } else {
-                // resp.get_last_matched_log_id() >= self->logIdToSend_
-                // All logs up to logIdToSend_ has been sent, fulfill the promise
-                self->promise_.setValue(resp);
-                // Check if there are any pending request:
-                // Eithor send pending requst if any, or set Host to vacant
-                newReq = self->getPendingReqIfAny(self);
-              }
-            }
-            if (newReq) {
-              self->appendLogsInternal(eb, newReq);
-            }
-            return;
-          }
-          // Usually the peer is not in proper state, for example:
-          // E_RAFT_UNKNOWN_PART/E_RAFT_STOPPED/E_RAFT_NOT_READY/E_RAFT_WAITING_SNAPSHOT
-          // In this case, nothing changed, just return the error
-          default: {
-            VLOG_EVERY_N(2, 1000) << self->idStr_ << "Failed to append logs to the host (Err: "
-                                  << apache::thrift::util::enumNameSafe(resp.get_error_code())
-                                  << ")";
-            {
-              std::lock_guard<std::mutex> g(self->lock_);
-              self->setResponse(resp);
-            }
-            return;
-          }
+        std::vector<std::shared_ptr<cpp2::AppendLogRequest>> newReqs;
+        {
+          std::lock_guard<std::mutex> g(self->lock_);
+          --self->numInFlight_;
+          newReqs = self->handleAppendLogResponse(resp);
+        }
+        for (auto& newReq : newReqs) {
+          self->appendLogsInternal(eb, std::move(newReq));
         }
       })
       .thenError(folly::tag_t<TransportException>{},
@@ -241,6 +311,7 @@ void Host::appendLogsInternal(folly::EventBase* eb, std::shared_ptr<cpp2::Append
                    r.error_code_ref() = nebula::cpp2::ErrorCode::E_RAFT_RPC_EXCEPTION;
                    {
                      std::lock_guard<std::mutex> g(self->lock_);
+                     --self->numInFlight_;
                      if (ex.getType() == TransportException::TIMED_OUT) {
                        VLOG_IF(1, FLAGS_trace_raft)
                            << self->idStr_ << "append log time out"
@@ -252,7 +323,7 @@ void Host::appendLogsInternal(folly::EventBase* eb, std::shared_ptr<cpp2::Append
                            << self->logIdToSend_ << ", logs size "
                            << req->get_log_str_list().size();
                      }
-                     self->setResponse(r);
+                     self->stopPipeline(r);
                    }
                    // a new raft log or heartbeat will trigger another appendLogs in Host
                    return;
@@ -263,7 +334,8 @@ void Host::appendLogsInternal(folly::EventBase* eb, std::shared_ptr<cpp2::Append
         r.error_code_ref() = nebula::cpp2::ErrorCode::E_RAFT_RPC_EXCEPTION;
         {
           std::lock_guard<std::mutex> g(self->lock_);
-          self->setResponse(r);
+          --self->numInFlight_;
+          self->stopPipeline(r);
         }
         // a new raft log or heartbeat will trigger another appendLogs in Host
         return;
@@ -273,7 +345,7 @@ void Host::appendLogsInternal(folly::EventBase* eb, std::shared_ptr<cpp2::Append
 ErrorOr<nebula::cpp2::ErrorCode, std::shared_ptr<cpp2::AppendLogRequest>>
 Host::prepareAppendLogRequest() {
   CHECK(!lock_.try_lock());
-  VLOG(3) << idStr_ << "Prepare AppendLogs request from Log " << lastLogIdSent_ + 1 << " to "
+  VLOG(3) << idStr_ << "Prepare AppendLogs request from Log " << lastLogIdDispatched_ + 1 << " to "
           << logIdToSend_;
 
   auto makeReq = [this]() -> std::shared_ptr<cpp2::AppendLogRequest> {
@@ -284,29 +356,29 @@ Host::prepareAppendLogRequest() {
     req->committed_log_id_ref() = committedLogId_;
     req->leader_addr_ref() = part_->address().host;
     req->leader_port_ref() = part_->address().port;
-    req->last_log_term_sent_ref() = lastLogTermSent_;
-    req->last_log_id_sent_ref() = lastLogIdSent_;
+    req->last_log_term_sent_ref() = lastLogTermDispatched_;
+    req->last_log_id_sent_ref() = lastLogIdDispatched_;
     return req;
   };
 
-  // We need to use lastLogIdSent_ + 1 to check whether need to send snapshot
-  if (UNLIKELY(lastLogIdSent_ + 1 < part_->wal()->firstLogId())) {
+  // We need to use lastLogIdDispatched_ + 1 to check whether need to send snapshot
+  if (UNLIKELY(lastLogIdDispatched_ + 1 < part_->wal()->firstLogId())) {
     return startSendSnapshot();
   }
 
-  if (lastLogIdSent_ == logIdToSend_) {
+  if (lastLogIdDispatched_ == logIdToSend_) {
     auto req = makeReq();
     return req;
   }
 
-  if (lastLogIdSent_ + 1 > part_->wal()->lastLogId()) {
+  if (lastLogIdDispatched_ + 1 > part_->wal()->lastLogId()) {
     VLOG_IF(1, FLAGS_trace_raft) << idStr_ << "My lastLogId in wal is " << part_->wal()->lastLogId()
-                                 << ", but you are seeking " << lastLogIdSent_ + 1
+                                 << ", but you are seeking " << lastLogIdDispatched_ + 1
                                  << ", so i have nothing to send, logIdToSend_ = " << logIdToSend_;
     return nebula::cpp2::ErrorCode::E_RAFT_NO_WAL_FOUND;
   }
 
-  auto it = part_->wal()->iterator(lastLogIdSent_ + 1, logIdToSend_);
+  auto it = part_->wal()->iterator(lastLogIdDispatched_ + 1, logIdToSend_);
   if (it->valid()) {
     auto req = makeReq();
     std::vector<cpp2::RaftLogEntry> logs;
@@ -317,13 +389,17 @@ Host::prepareAppendLogRequest() {
       entry.log_term_ref() = it->logTerm();
       logs.emplace_back(std::move(entry));
     }
-    // the last log entry's id is (lastLogIdSent_ + cnt), when iterator is invalid and last log
-    // entry's id is not logIdToSend_, which means the log has been rollbacked
-    if (!it->valid() && (lastLogIdSent_ + static_cast<int64_t>(logs.size()) != logIdToSend_)) {
+    // the last log entry's id is (lastLogIdDispatched_ + cnt), when iterator is invalid and last
+    // log entry's id is not logIdToSend_, which means the log has been rollbacked
+    if (!it->valid() &&
+        (lastLogIdDispatched_ + static_cast<int64_t>(logs.size()) != logIdToSend_)) {
       VLOG_IF(1, FLAGS_trace_raft)
           << idStr_ << "Can't find log in wal, logIdToSend_ = " << logIdToSend_;
       return nebula::cpp2::ErrorCode::E_RAFT_NO_WAL_FOUND;
     }
+    // The next request in the pipeline starts after this one
+    lastLogIdDispatched_ += logs.size();
+    lastLogTermDispatched_ = logs.back().get_log_term();
     req->log_str_list_ref() = std::move(logs);
     return req;
   } else {
@@ -404,10 +480,11 @@ folly::Future<cpp2::HeartbeatResponse> Host::sendHeartbeat(
   req->last_log_id_sent_ref() = lastLogId;
   folly::Promise<cpp2::HeartbeatResponse> promise;
   auto future = promise.getFuture();
+  auto beforeRpcUs = time::WallClock::fastNowInMicroSec();
   sendHeartbeatRequest(eb, std::move(req))
       .via(eb)
-      .then([self = shared_from_this(),
-             pro = std::move(promise)](folly::Try<cpp2::HeartbeatResponse>&& t) mutable {
+      .then([self = shared_from_this(), pro = std::move(promise), beforeRpcUs](
+                folly::Try<cpp2::HeartbeatResponse>&& t) mutable {
         VLOG(4) << self->idStr_ << "heartbeat call got response";
         if (t.hasException()) {
           cpp2::HeartbeatResponse resp;
@@ -415,6 +492,12 @@ folly::Future<cpp2::HeartbeatResponse> Host::sendHeartbeat(
           pro.setValue(std::move(resp));
           return;
         } else {
+          auto rttUs = static_cast<int64_t>(time::WallClock::fastNowInMicroSec() - beforeRpcUs);
+          stats::StatsManager::addValue(self->part_->heartbeatRttUs_, rttUs);
+          {
+            std::lock_guard<std::mutex> g(self->lock_);
+            self->heartbeatRttUs_ = rttUs;
+          }
           pro.setValue(std::move(t.value()));
         }
       });
@@ -442,6 +525,9 @@ folly::Future<cpp2::HeartbeatResponse> Host::sendHeartbeatRequest(
                                << req->get_committed_log_id() << ", last_log_term_sent "
                                << req->get_last_log_term_sent() << ", last_log_id_sent "
                                << req->get_last_log_id_sent();
+  if (part_->heartbeatBatcher_ != nullptr && HeartbeatBatcher::enabled()) {
+    return part_->heartbeatBatcher_->send(addr_, *req, part_->clientMan_, eb);
+  }
   // Get client connection
   auto client = part_->clientMan_->client(addr_, eb, false, FLAGS_raft_rpc_timeout_ms);
   return client->future_heartbeat(*req);
@@ -453,39 +539,33 @@ bool Host::noRequest() const {
   return pendingReq_ == emptyTup;
 }
 
-std::shared_ptr<cpp2::AppendLogRequest> Host::getPendingReqIfAny(std::shared_ptr<Host> self) {
-  CHECK(!self->lock_.try_lock());
-  CHECK(self->requestOnGoing_) << self->idStr_;
+std::vector<std::shared_ptr<cpp2::AppendLogRequest>> Host::getPendingReqIfAny() {
+  CHECK(!lock_.try_lock());
+  CHECK(requestOnGoing_) << idStr_;
 
   // Check if there are any pending request to send
-  if (self->noRequest()) {
-    self->noMoreRequestCV_.notify_all();
-    self->requestOnGoing_ = false;
-    return nullptr;
+  if (noRequest()) {
+    // The round is over when all the requests in flight are responded
+    if (numInFlight_ == 0) {
+      noMoreRequestCV_.notify_all();
+      requestOnGoing_ = false;
+    }
+    return {};
   }
 
   // there is pending request
-  auto& tup = self->pendingReq_;
-  self->logTermToSend_ = std::get<0>(tup);
-  self->logIdToSend_ = std::get<1>(tup);
-  self->committedLogId_ = std::get<2>(tup);
-
-  VLOG_IF(1, FLAGS_trace_raft) << self->idStr_ << "Sending the pending request in the queue"
-                               << ", from " << self->lastLogIdSent_ + 1 << " to "
-                               << self->logIdToSend_;
-  self->pendingReq_ = std::make_tuple(0, 0, 0);
-  self->promise_ = std::move(self->cachingPromise_);
-  self->cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
-
-  auto result = self->prepareAppendLogRequest();
-  if (ok(result)) {
-    return value(result);
-  } else {
-    cpp2::AppendLogResponse r;
-    r.error_code_ref() = error(result);
-    self->setResponse(r);
-    return nullptr;
-  }
+  auto& tup = pendingReq_;
+  logTermToSend_ = std::get<0>(tup);
+  logIdToSend_ = std::get<1>(tup);
+  committedLogId_ = std::get<2>(tup);
+
+  VLOG_IF(1, FLAGS_trace_raft) << idStr_ << "Sending the pending request in the queue"
+                               << ", from " << lastLogIdSent_ + 1 << " to " << logIdToSend_;
+  pendingReq_ = std::make_tuple(0, 0, 0);
+  promise_ = std::move(cachingPromise_);
+  cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
+
+  return prepareAppendLogRequests();
 }
 
 }  // namespace raftex
@@ -89,9 +89,13 @@ class Host final : public std::enable_shared_from_this<Host> {
     logTermToSend_ = 0;
     lastLogIdSent_ = 0;
     lastLogTermSent_ = 0;
+    lastLogIdDispatched_ = 0;
+    lastLogTermDispatched_ = 0;
+    pipelineBroken_ = false;
     committedLogId_ = 0;
     sendingSnapshot_ = false;
     followerCommittedLogId_ = 0;
+    heartbeatRttUs_ = 0;
   }
 
   /**
@@ -162,6 +166,29 @@ class Host final : public std::enable_shared_from_this<Host> {
     return addr_;
   }
 
+  /**
+   * @brief Return the last log id committed by the peer as far as the leader knows
+   */
+  LogID followerCommittedLogId() const {
+    std::lock_guard<std::mutex> g(lock_);
+    return followerCommittedLogId_;
+  }
+
+  /**
+   * @brief The replication progress of the follower, which is exported as metrics
+   */
+  struct Progress {
+    LogID committedLogId{0};
+    // The round trip time of the last heartbeat responded
+    int64_t heartbeatRttUs{0};
+    bool sendingSnapshot{false};
+  };
+
+  Progress progress() const {
+    std::lock_guard<std::mutex> g(lock_);
+    return Progress{followerCommittedLogId_, heartbeatRttUs_, sendingSnapshot_};
+  }
+
  private:
   /**
    * @brief Whether Host can send rpc to the peer
@@ -186,6 +213,15 @@ class Host final : public std::enable_shared_from_this<Host> {
    */
   void appendLogsInternal(folly::EventBase* eb, std::shared_ptr<cpp2::AppendLogRequest> req);
 
+  /**
+   * @brief Handle the response of an append log request
+   *
+   * @param resp RPC response
+   * @return std::vector<std::shared_ptr<cpp2::AppendLogRequest>> The requests to send next
+   */
+  std::vector<std::shared_ptr<cpp2::AppendLogRequest>> handleAppendLogResponse(
+      const cpp2::AppendLogResponse& resp);
+
   folly::Future<cpp2::HeartbeatResponse> sendHeartbeatRequest(
       folly::EventBase* eb, std::shared_ptr<cpp2::HeartbeatRequest> req);
 
@@ -197,6 +233,14 @@ class Host final : public std::enable_shared_from_this<Host> {
   ErrorOr<nebula::cpp2::ErrorCode, std::shared_ptr<cpp2::AppendLogRequest>>
   prepareAppendLogRequest();
 
+  /**
+   * @brief Build the append log requests until the pipeline is full or all logs are dispatched.
+   * If none could be built and no request is in flight, the error is set as the response.
+   *
+   * @return std::vector<std::shared_ptr<cpp2::AppendLogRequest>>
+   */
+  std::vector<std::shared_ptr<cpp2::AppendLogRequest>> prepareAppendLogRequests();
+
   /**
    * @brief Begin to start snapshot when we don't have the log in wal file
    *
@@ -217,13 +261,20 @@ class Host final : public std::enable_shared_from_this<Host> {
   void setResponse(const cpp2::AppendLogResponse& resp);
 
   /**
-   * @brief If there are more logs to send, build the append log request
+   * @brief Notify the RaftPart of the failure when no request is in flight, otherwise stop
+   * sending new requests and wait for the ones in flight
    *
-   * @param self Shared ptr of Host itself
-   * @return std::shared_ptr<cpp2::AppendLogRequest> The request if there are logs to send, return
-   * nullptr there are none
+   * @param resp RPC response
    */
-  std::shared_ptr<cpp2::AppendLogRequest> getPendingReqIfAny(std::shared_ptr<Host> self);
+  void stopPipeline(const cpp2::AppendLogResponse& resp);
+
+  /**
+   * @brief If there are more logs to send, build the append log requests
+   *
+   * @return std::vector<std::shared_ptr<cpp2::AppendLogRequest>> The requests if there are logs to
+   * send, return empty if there are none
+   */
+  std::vector<std::shared_ptr<cpp2::AppendLogRequest>> getPendingReqIfAny();
 
  private:
   // <term, logId, committedLogId>
@@ -241,6 +292,10 @@ class Host final : public std::enable_shared_from_this<Host> {
 
   // whether there is a batch of logs for target host in on going
   bool requestOnGoing_{false};
+  // number of append log requests in flight, only when it's 0 could requestOnGoing_ be false
+  size_t numInFlight_{0};
+  // whether the pipeline is stopped, because of mismatched or failed requests
+  bool pipelineBroken_{false};
   // whether there is a snapshot for target host in on going
   bool sendingSnapshot_{false};
 
@@ -258,10 +313,16 @@ class Host final : public std::enable_shared_from_this<Host> {
   LogID lastLogIdSent_{0};
   TermID lastLogTermSent_{0};
 
+  // The last log in the requests in flight, the next request will be sent after it
+  LogID lastLogIdDispatched_{0};
+  TermID lastLogTermDispatched_{0};
+
   LogID committedLogId_{0};
 
   // CommittedLogId of follower
   LogID followerCommittedLogId_{0};
+
+  int64_t heartbeatRttUs_{0};
 };
 
 }  // namespace raftex
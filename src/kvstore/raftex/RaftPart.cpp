@@ -12,6 +12,7 @@
 
 #include "common/base/Base.h"
 #include "common/base/CollectNSucceeded.h"
+#include "common/fs/FileUtils.h"
 #include "common/network/NetworkUtils.h"
 #include "common/stats/StatsManager.h"
 #include "common/thread/NamedThread.h"
@@ -25,6 +26,7 @@
 #include "kvstore/raftex/RaftLogIterator.h"
 #include "kvstore/stats/KVStats.h"
 #include "kvstore/wal/FileBasedWal.h"
+#include "kvstore/wal/SharedWal.h"
 
 DEFINE_uint32(raft_heartbeat_interval_secs, 5, "Seconds between each heartbeat");
 
@@ -42,11 +44,13 @@ DECLARE_bool(wal_sync);
 namespace nebula {
 namespace raftex {
 
+using nebula::fs::FileUtils;
 using nebula::network::NetworkUtils;
 using nebula::thrift::ThriftClientManager;
 using nebula::wal::FileBasedWal;
 using nebula::wal::FileBasedWalInfo;
 using nebula::wal::FileBasedWalPolicy;
+using nebula::wal::SharedWal;
 
 using OpProcessor = folly::Function<std::optional<std::string>(AtomicOp op)>;
 
@@ -99,6 +103,14 @@ class AppendLogsIterator final : public LogIterator {
     }
   }
 
+  // Add the latency from being buffered to being committed of each log to the histogram
+  void addAppendToCommitLatency(const stats::CounterId& id) const {
+    auto now = time::WallClock::fastNowInMicroSec();
+    for (const auto& log : logs_) {
+      stats::StatsManager::addValue(id, now - std::get<5>(log));
+    }
+  }
+
   void commit(nebula::cpp2::ErrorCode code = nebula::cpp2::ErrorCode::SUCCEEDED) {
     for (auto it = logs_.begin(); it != logs_.end(); ++it) {
       auto& promiseRef = std::get<4>(*it);
@@ -202,7 +214,12 @@ class AppendLogsIteratorFactory {
         if (log.empty()) {
           return MergeAbleCode::MERGE_BOTH;
         }
-        decode(log, updateSet, ranges);
+        // The keys are copied into memLock before the decompressed log is released
+        std::string decompressed;
+        if (nebula::kvstore::isCompressedLog(log)) {
+          decompressed = nebula::kvstore::decompressLog(log);
+        }
+        decode(decompressed.empty() ? log : decompressed, updateSet, ranges);
         for (auto& key : updateSet) {
           memLock.insert(key.str());
         }
@@ -302,6 +319,8 @@ class AppendLogsIteratorFactory {
             updateSet.push_back(op.second.first);
           } else if (op.first == nebula::kvstore::BatchLogType::OP_BATCH_REMOVE) {
             updateSet.push_back(op.second.first);
+          } else if (op.first == nebula::kvstore::BatchLogType::OP_BATCH_MERGE) {
+            updateSet.push_back(op.second.first);
           } else if (op.first == nebula::kvstore::BatchLogType::OP_BATCH_REMOVE_RANGE) {
             auto begin = op.second.first;
             auto end = op.second.second;
@@ -363,19 +382,34 @@ RaftPart::RaftPart(
   info.idStr_ = idStr_;
   info.spaceId_ = spaceId_;
   info.partId_ = partId_;
-  wal_ = FileBasedWal::getWal(
-      walRoot,
-      std::move(info),
-      std::move(policy),
-      [this](LogID logId, TermID logTermId, ClusterID logClusterId, const std::string& log) {
-        return this->preProcessLog(logId, logTermId, logClusterId, log);
-      },
-      diskMan);
+  auto preProcessor = [this](LogID logId,
+                             TermID logTermId,
+                             ClusterID logClusterId,
+                             const std::string& log) {
+    return this->preProcessLog(logId, logTermId, logClusterId, log);
+  };
+  if (FLAGS_enable_shared_wal) {
+    // The parts whose wal are under the same directory share one segmented log
+    auto sharedRoot = FileUtils::joinPath(
+        FileUtils::dirname(walRoot.toString().c_str()), "shared");
+    wal_ = SharedWal::getWal(
+        sharedRoot, std::move(info), std::move(policy), std::move(preProcessor), diskMan);
+  } else {
+    wal_ = FileBasedWal::getWal(
+        walRoot, std::move(info), std::move(policy), std::move(preProcessor), diskMan);
+  }
   CHECK(!!executor_) << idStr_ << "Should not be nullptr";
+  if (kRaftAppendToCommitLatencyUs.valid()) {
+    std::vector<std::pair<std::string, std::string>> labels = {
+        {"space", folly::to<std::string>(spaceId_)}};
+    appendToCommitLatencyUs_ =
+        stats::StatsManager::histoWithLabels(kRaftAppendToCommitLatencyUs, labels);
+    heartbeatRttUs_ = stats::StatsManager::histoWithLabels(kRaftHeartbeatRttUs, labels);
+  }
 }
 
 RaftPart::~RaftPart() {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
 
   // Make sure the partition has stopped
   CHECK(status_ == Status::STOPPED);
@@ -399,7 +433,7 @@ const char* RaftPart::roleStr(Role role) const {
 }
 
 void RaftPart::start(std::vector<HostAddr>&& peers, bool asLearner) {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
 
   // There are some rare cases that the part start as learner, but wal is not empty. For example,
   // the node is dead, and one partition is removed from raft group (majority still alive). However,
@@ -459,7 +493,7 @@ void RaftPart::stop() {
 
   decltype(hosts_) hosts;
   {
-    std::lock_guard<std::mutex> lck(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> lck(raftLock_);
     status_ = Status::STOPPED;
     leader_ = {"", 0};
     role_ = Role::FOLLOWER;
@@ -485,7 +519,7 @@ void RaftPart::stop() {
 }
 
 void RaftPart::cleanWal() {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   wal()->cleanWAL(committedLogId_);
 }
 
@@ -532,7 +566,7 @@ void RaftPart::addLearner(const HostAddr& addr, bool needLock) {
     }
   };
   if (needLock) {
-    std::lock_guard<std::mutex> guard(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> guard(raftLock_);
     addLearner();
   } else {
     addLearner();
@@ -550,7 +584,7 @@ void RaftPart::preProcessTransLeader(const HostAddr& target) {
         VLOG(1) << idStr_ << "I will be the new leader, trigger leader election now!";
         bgWorkers_->addTask([self = shared_from_this()] {
           {
-            std::lock_guard<std::mutex> lck(self->raftLock_);
+            std::lock_guard<thread::ProfiledMutex> lck(self->raftLock_);
             self->role_ = Role::CANDIDATE;
             self->leader_ = HostAddr("", 0);
           }
@@ -602,7 +636,7 @@ void RaftPart::commitTransLeader(const HostAddr& target, bool needLock) {
     }
   };
   if (needLock) {
-    std::lock_guard<std::mutex> guard(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> guard(raftLock_);
     transfer();
   } else {
     transfer();
@@ -686,7 +720,7 @@ nebula::cpp2::ErrorCode RaftPart::checkPeer(const HostAddr& candidate) {
 }
 
 void RaftPart::addListenerPeer(const HostAddr& listener) {
-  std::lock_guard<std::mutex> guard(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> guard(raftLock_);
   if (listener == addr_) {
     VLOG(1) << idStr_ << "I am already in the raft group";
     return;
@@ -705,7 +739,7 @@ void RaftPart::addListenerPeer(const HostAddr& listener) {
 }
 
 void RaftPart::removeListenerPeer(const HostAddr& listener) {
-  std::lock_guard<std::mutex> guard(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> guard(raftLock_);
   if (listener == addr_) {
     VLOG(1) << idStr_ << "Remove myself from the raft group";
     return;
@@ -741,7 +775,7 @@ void RaftPart::commitRemovePeer(const HostAddr& peer, bool needLock) {
     removePeer(peer);
   };
   if (needLock) {
-    std::lock_guard<std::mutex> guard(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> guard(raftLock_);
     remove();
   } else {
     remove();
@@ -802,7 +836,12 @@ folly::Future<nebula::cpp2::ErrorCode> RaftPart::appendLogAsync(ClusterID source
     DCHECK_GE(source, 0);
     folly::Promise<nebula::cpp2::ErrorCode> promise;
     retFuture = promise.getFuture();
-    logs_.emplace_back(source, logType, std::move(log), std::move(op), std::move(promise));
+    logs_.emplace_back(source,
+                       logType,
+                       std::move(log),
+                       std::move(op),
+                       std::move(promise),
+                       time::WallClock::fastNowInMicroSec());
 
     bool expected = false;
     if (replicatingLogs_.compare_exchange_strong(expected, true)) {
@@ -819,7 +858,7 @@ folly::Future<nebula::cpp2::ErrorCode> RaftPart::appendLogAsync(ClusterID source
   TermID termId = 0;
   nebula::cpp2::ErrorCode res;
   {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     res = canAppendLogs();
     if (res == nebula::cpp2::ErrorCode::SUCCEEDED) {
       firstId = lastLogId_ + 1;
@@ -859,7 +898,7 @@ void RaftPart::appendLogsInternal(AppendLogsIterator iter, TermID termId) {
   LogID lastId = 0;
   nebula::cpp2::ErrorCode res = nebula::cpp2::ErrorCode::SUCCEEDED;
   do {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     res = canAppendLogs(termId);
     if (res != nebula::cpp2::ErrorCode::SUCCEEDED) {
       break;
@@ -907,7 +946,7 @@ void RaftPart::replicateLogs(folly::EventBase* eb,
   decltype(hosts_) hosts;
   nebula::cpp2::ErrorCode res = nebula::cpp2::ErrorCode::SUCCEEDED;
   do {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     res = canAppendLogs(currTerm);
     if (res != nebula::cpp2::ErrorCode::SUCCEEDED) {
       lastLogId_ = wal_->lastLogId();
@@ -1001,7 +1040,7 @@ void RaftPart::processAppendLogResponses(const AppendLogResponses& resps,
 
   nebula::cpp2::ErrorCode res = nebula::cpp2::ErrorCode::SUCCEEDED;
   {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     if (highestTerm > term_) {
       term_ = highestTerm;
       role_ = Role::FOLLOWER;
@@ -1026,7 +1065,7 @@ void RaftPart::processAppendLogResponses(const AppendLogResponses& resps,
     VLOG(4) << idStr_ << numSucceeded << " hosts have accepted the logs";
 
     do {
-      std::lock_guard<std::mutex> g(raftLock_);
+      std::lock_guard<thread::ProfiledMutex> g(raftLock_);
       res = canAppendLogs(currTerm);
       if (res != nebula::cpp2::ErrorCode::SUCCEEDED) {
         lastLogId_ = wal_->lastLogId();
@@ -1058,7 +1097,7 @@ void RaftPart::processAppendLogResponses(const AppendLogResponses& resps,
       auto [code, lastCommitId, lastCommitTerm] = commitLogs(std::move(walIt), true, true);
       if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
         stats::StatsManager::addValue(kCommitLogLatencyUs, execTime_);
-        std::lock_guard<std::mutex> g(raftLock_);
+        std::lock_guard<thread::ProfiledMutex> g(raftLock_);
         CHECK_EQ(lastLogId, lastCommitId);
         committedLogId_ = lastCommitId;
         committedLogTerm_ = lastCommitTerm;
@@ -1078,6 +1117,7 @@ void RaftPart::processAppendLogResponses(const AppendLogResponses& resps,
 
     // at this monment, we have confidence logs should be succeeded replicated
     LogID firstId = 0;
+    iter.addAppendToCommitLatency(appendToCommitLatencyUs_);
     {
       std::lock_guard<std::mutex> lck(logsLock_);
       CHECK(replicatingLogs_);
@@ -1112,12 +1152,12 @@ void RaftPart::processAppendLogResponses(const AppendLogResponses& resps,
 }
 
 bool RaftPart::needToSendHeartbeat() {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   return status_ == Status::RUNNING && role_ == Role::LEADER;
 }
 
 bool RaftPart::needToStartElection() {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   if (status_ == Status::RUNNING && role_ == Role::FOLLOWER &&
       (lastMsgRecvDur_.elapsedInMSec() >= FLAGS_raft_heartbeat_interval_secs * 1000 ||
        isBlindFollower_)) {
@@ -1133,7 +1173,7 @@ bool RaftPart::needToStartElection() {
 bool RaftPart::prepareElectionRequest(cpp2::AskForVoteRequest& req,
                                       std::vector<std::shared_ptr<Host>>& hosts,
                                       bool isPreVote) {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
 
   // Make sure the partition is running
   if (status_ != Status::RUNNING) {
@@ -1171,7 +1211,7 @@ bool RaftPart::prepareElectionRequest(cpp2::AskForVoteRequest& req,
 }
 
 void RaftPart::getState(cpp2::GetStateResponse& resp) {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   resp.term_ref() = term_;
   resp.role_ref() = role_;
   resp.is_leader_ref() = role_ == Role::LEADER;
@@ -1195,7 +1235,7 @@ bool RaftPart::processElectionResponses(const RaftPart::ElectionResponses& resul
                                         std::vector<std::shared_ptr<Host>> hosts,
                                         TermID proposedTerm,
                                         bool isPreVote) {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
 
   if (UNLIKELY(status_ == Status::STOPPED)) {
     VLOG(3) << idStr_ << "The part has been stopped, skip the request";
@@ -1287,7 +1327,7 @@ folly::Future<bool> RaftPart::leaderElection(bool isPreVote) {
     // Because C is in Candidate, so it will reject the snapshot request from B.
     // Infinite loop begins.
     // So we need to go back to the follower state to avoid the case.
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     role_ = Role::FOLLOWER;
     leader_ = HostAddr("", 0);
     inElection_ = false;
@@ -1352,7 +1392,7 @@ bool RaftPart::handleElectionResponses(const ElectionResponses& resps,
   if (!isPreVote && elected) {
     std::vector<std::shared_ptr<Host>> hosts;
     {
-      std::lock_guard<std::mutex> g(raftLock_);
+      std::lock_guard<thread::ProfiledMutex> g(raftLock_);
       if (status_ == Status::RUNNING) {
         leader_ = addr_;
         hosts = hosts_;
@@ -1375,7 +1415,7 @@ bool RaftPart::handleElectionResponses(const ElectionResponses& resps,
 
 void RaftPart::statusPolling(int64_t startTime) {
   {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     // If startTime is not same as the time when `statusPolling` is add to event
     // loop, it means the part has been restarted (it only happens in ut for
     // now), so don't add another `statusPolling`.
@@ -1401,7 +1441,7 @@ void RaftPart::statusPolling(int64_t startTime) {
     cleanupSnapshot();
   }
   {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     if (status_ == Status::RUNNING || status_ == Status::WAITING_SNAPSHOT) {
       VLOG(4) << idStr_ << "Schedule new task";
       bgWorkers_->addDelayTask(
@@ -1411,7 +1451,7 @@ void RaftPart::statusPolling(int64_t startTime) {
 }
 
 bool RaftPart::needToCleanupSnapshot() {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   return status_ == Status::WAITING_SNAPSHOT && role_ != Role::LEADER &&
          lastSnapshotRecvDur_.elapsedInSec() >= FLAGS_raft_snapshot_timeout;
 }
@@ -1420,12 +1460,12 @@ void RaftPart::cleanupSnapshot() {
   VLOG(1) << idStr_
           << "Snapshot has not been received for a long time, convert to running so we can receive "
              "another snapshot";
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   status_ = Status::RUNNING;
 }
 
 bool RaftPart::needToCleanWal() {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   if (status_ == Status::STARTING || status_ == Status::WAITING_SNAPSHOT) {
     return false;
   }
@@ -1446,7 +1486,7 @@ void RaftPart::processAskForVoteRequest(const cpp2::AskForVoteRequest& req,
           << ", lastLogTerm = " << req.get_last_log_term()
           << ", isPreVote = " << req.get_is_pre_vote();
 
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   resp.current_term_ref() = term_;
 
   // Make sure the partition is running
@@ -1605,7 +1645,7 @@ void RaftPart::processAppendLogRequest(const cpp2::AppendLogRequest& req,
                                << ", local committedLogId = " << committedLogId_
                                << ", local current term = " << term_
                                << ", wal lastLogId = " << wal_->lastLogId();
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
 
   resp.current_term_ref() = term_;
   resp.leader_addr_ref() = leader_.host;
@@ -1801,6 +1841,9 @@ void RaftPart::processAppendLogRequest(const cpp2::AppendLogRequest& req,
   } else {
     resp.error_code_ref() = nebula::cpp2::ErrorCode::SUCCEEDED;
   }
+  if (committedLogId_ >= req.get_committed_log_id()) {
+    lastCaughtUpTime_ = time::WallClock::fastNowInMilliSec();
+  }
 
   // Reset the timeout timer again in case wal and commit takes longer time than
   // expected
@@ -1888,7 +1931,7 @@ void RaftPart::processHeartbeatRequest(const cpp2::HeartbeatRequest& req,
                                << ", local lastLogTerm = " << lastLogTerm_
                                << ", local committedLogId = " << committedLogId_
                                << ", local current term = " << term_;
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
 
   // As for heartbeat, last_log_id and last_log_term is not checked by leader, follower only verify
   // whether leader is legal, just return lastLogId_ and lastLogTerm_ in resp. And we don't do any
@@ -1926,6 +1969,9 @@ void RaftPart::processHeartbeatRequest(const cpp2::HeartbeatRequest& req,
 
   // Reset the timeout timer
   lastMsgRecvDur_.reset();
+  if (committedLogId_ >= req.get_committed_log_id()) {
+    lastCaughtUpTime_ = time::WallClock::fastNowInMilliSec();
+  }
 
   // As for heartbeat, return ok after verifyLeader
   resp.error_code_ref() = nebula::cpp2::ErrorCode::SUCCEEDED;
@@ -1940,7 +1986,7 @@ void RaftPart::processSendSnapshotRequest(const cpp2::SendSnapshotRequest& req,
           << req.get_total_count() << " logs of size " << req.get_total_size() << ", finished "
           << req.get_done();
 
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   // Check status
   if (UNLIKELY(status_ == Status::STOPPED)) {
     VLOG(3) << idStr_ << "The part has been stopped, skip the request";
@@ -1962,6 +2008,17 @@ void RaftPart::processSendSnapshotRequest(const cpp2::SendSnapshotRequest& req,
     resp.error_code_ref() = err;
     return;
   }
+  if (lastSnapshotCommitId_ == req.get_committed_log_id() &&
+      lastSnapshotCommitTerm_ == req.get_committed_log_term() &&
+      lastTotalCount_ == req.get_total_count() && lastTotalSize_ == req.get_total_size() &&
+      (!req.get_rows().empty() || (req.get_done() && status_ != Status::WAITING_SNAPSHOT))) {
+    // The leader resends the batch which has been persisted because the response is lost, just
+    // acknowledge it so that the leader resumes from the next key
+    VLOG(2) << idStr_ << "The snapshot batch has been received, total count "
+            << req.get_total_count() << ", total size " << req.get_total_size();
+    resp.error_code_ref() = nebula::cpp2::ErrorCode::SUCCEEDED;
+    return;
+  }
   if (status_ != Status::WAITING_SNAPSHOT) {
     VLOG(2) << idStr_ << "Begin to receive the snapshot";
     reset();
@@ -2023,7 +2080,10 @@ void RaftPart::sendHeartbeat() {
       appendLogAsync(clusterId_, LogType::NORMAL, std::move(log));
     });
   }
+  confirmLeadership();
+}
 
+folly::Future<bool> RaftPart::confirmLeadership() {
   using namespace folly;  // NOLINT since the fancy overload of | operator
   VLOG(2) << idStr_ << "Send heartbeat";
   TermID currTerm = 0;
@@ -2033,7 +2093,7 @@ void RaftPart::sendHeartbeat() {
   size_t replica = 0;
   decltype(hosts_) hosts;
   {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     currTerm = term_;
     commitLogId = committedLogId_;
     prevLogTerm = lastLogTerm_;
@@ -2043,7 +2103,7 @@ void RaftPart::sendHeartbeat() {
   }
   auto eb = ioThreadPool_->getEventBase();
   auto startMs = time::WallClock::fastNowInMilliSec();
-  collectNSucceeded(
+  return collectNSucceeded(
       gen::from(hosts) |
           gen::map([self = shared_from_this(), eb, currTerm, commitLogId, prevLogId, prevLogTerm](
                        std::shared_ptr<Host> hostPtr) {
@@ -2073,24 +2133,97 @@ void RaftPart::sendHeartbeat() {
           highestTerm = std::max(highestTerm, resp.second.get_current_term());
         }
         {
-          std::lock_guard<std::mutex> g(raftLock_);
+          std::lock_guard<thread::ProfiledMutex> g(raftLock_);
           if (highestTerm > term_) {
             term_ = highestTerm;
             role_ = Role::FOLLOWER;
             leader_ = HostAddr("", 0);
-            return;
+            return false;
           }
         }
         if (numSucceeded >= replica) {
           VLOG(4) << idStr_ << "Heartbeat is accepted by quorum";
-          std::lock_guard<std::mutex> g(raftLock_);
+          std::lock_guard<thread::ProfiledMutex> g(raftLock_);
+          // The leadership is only confirmed if we are still the leader of the same term
+          if (role_ != Role::LEADER || term_ != currTerm) {
+            return false;
+          }
           auto now = time::WallClock::fastNowInMilliSec();
           lastMsgAcceptedCostMs_ = now - startMs;
           lastMsgAcceptedTime_ = now;
+          return true;
         }
+        return false;
       });
 }
 
+folly::Future<nebula::cpp2::ErrorCode> RaftPart::readIndex() {
+  {
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
+    if (status_ != Status::RUNNING || role_ != Role::LEADER) {
+      return nebula::cpp2::ErrorCode::E_LEADER_CHANGED;
+    }
+  }
+  if (leaseValid()) {
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+  {
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
+    // The committed id could only be served after leader has committed a log in its term
+    if (!commitInThisTerm_) {
+      return nebula::cpp2::ErrorCode::E_LEADER_LEASE_FAILED;
+    }
+  }
+  // The lease is expired, confirm the leadership by a round of heartbeat, which renews the lease
+  // as well if it is accepted by quorum
+  VLOG(2) << idStr_ << "Lease is expired, confirm leadership by heartbeat";
+  return confirmLeadership().thenValue([](bool confirmed) {
+    return confirmed ? nebula::cpp2::ErrorCode::SUCCEEDED
+                     : nebula::cpp2::ErrorCode::E_LEADER_LEASE_FAILED;
+  });
+}
+
+RaftPart::ReplicationStats RaftPart::replicationStats() const {
+  ReplicationStats stats;
+  std::vector<std::shared_ptr<Host>> hosts;
+  LogID lastLogId = 0;
+  {
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
+    stats.isLeader = role_ == Role::LEADER;
+    stats.commitLag = lastLogId_ - committedLogId_;
+    lastLogId = lastLogId_;
+    if (stats.isLeader) {
+      hosts = followers();
+    }
+    if (status_ == Status::WAITING_SNAPSHOT) {
+      stats.snapshotRowsReceived = lastTotalCount_;
+      stats.snapshotBytesReceived = lastTotalSize_;
+    }
+  }
+  for (const auto& host : hosts) {
+    auto progress = host->progress();
+    stats.maxFollowerLag = std::max(stats.maxFollowerLag, lastLogId - progress.committedLogId);
+    stats.maxHeartbeatRttUs = std::max(stats.maxHeartbeatRttUs, progress.heartbeatRttUs);
+    stats.sendingSnapshots += progress.sendingSnapshot ? 1 : 0;
+  }
+  if (stats.isLeader) {
+    std::lock_guard<std::mutex> lck(logsLock_);
+    stats.pendingLogs = logs_.size();
+    for (const auto& log : logs_) {
+      stats.pendingLogBytes += std::get<2>(log).size();
+    }
+  }
+  if (wal_ != nullptr) {
+    stats.walBytes = wal_->sizeInBytes();
+    auto walLogs = wal_->lastLogId() - wal_->firstLogId() + 1;
+    if (walLogs > 0 && stats.maxFollowerLag > 0) {
+      stats.maxFollowerLagBytes =
+          stats.walBytes / static_cast<size_t>(walLogs) * static_cast<size_t>(stats.maxFollowerLag);
+    }
+  }
+  return stats;
+}
+
 std::vector<std::shared_ptr<Host>> RaftPart::followers() const {
   CHECK(!raftLock_.try_lock());
   decltype(hosts_) hosts;
@@ -2103,7 +2236,7 @@ std::vector<std::shared_ptr<Host>> RaftPart::followers() const {
 }
 
 std::vector<HostAddr> RaftPart::peers() const {
-  std::lock_guard<std::mutex> lck(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> lck(raftLock_);
   std::vector<HostAddr> peer{addr_};
   for (auto& host : hosts_) {
     peer.emplace_back(host->address());
@@ -2112,7 +2245,7 @@ std::vector<HostAddr> RaftPart::peers() const {
 }
 
 std::set<HostAddr> RaftPart::listeners() const {
-  std::lock_guard<std::mutex> lck(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> lck(raftLock_);
   return listeners_;
 }
 
@@ -2153,7 +2286,7 @@ void RaftPart::reset() {
 }
 
 nebula::cpp2::ErrorCode RaftPart::isCatchedUp(const HostAddr& peer) {
-  std::lock_guard<std::mutex> lck(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> lck(raftLock_);
   VLOG(2) << idStr_ << "Check whether I catch up";
   if (role_ != Role::LEADER) {
     VLOG(2) << idStr_ << "I am not the leader";
@@ -2180,12 +2313,12 @@ nebula::cpp2::ErrorCode RaftPart::isCatchedUp(const HostAddr& peer) {
 
 bool RaftPart::linkCurrentWAL(const char* newPath) {
   CHECK_NOTNULL(newPath);
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   return wal_->linkCurrentWAL(newPath);
 }
 
 void RaftPart::checkAndResetPeers(const std::vector<HostAddr>& peers) {
-  std::lock_guard<std::mutex> lck(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> lck(raftLock_);
   // To avoid the iterator invalid, we use another container for it.
   decltype(hosts_) hosts = hosts_;
   for (auto& h : hosts) {
@@ -2220,8 +2353,16 @@ void RaftPart::checkRemoteListeners(const std::set<HostAddr>& expected) {
   }
 }
 
+bool RaftPart::followerReadable(int64_t maxStalenessMs) {
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
+  if (status_ != Status::RUNNING || (role_ != Role::FOLLOWER && role_ != Role::LEARNER)) {
+    return false;
+  }
+  return time::WallClock::fastNowInMilliSec() - lastCaughtUpTime_ <= maxStalenessMs;
+}
+
 bool RaftPart::leaseValid() {
-  std::lock_guard<std::mutex> g(raftLock_);
+  std::lock_guard<thread::ProfiledMutex> g(raftLock_);
   if (hosts_.empty()) {
     return true;
   }
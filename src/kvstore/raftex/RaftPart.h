@@ -11,7 +11,9 @@
 #include <gtest/gtest_prod.h>
 
 #include "common/base/Base.h"
+#include "common/stats/StatsManager.h"
 #include "common/thread/GenericThreadPool.h"
+#include "common/thread/ProfiledMutex.h"
 #include "common/time/Duration.h"
 #include "common/utils/LogIterator.h"
 #include "interface/gen-cpp2/RaftexServiceAsyncClient.h"
@@ -29,7 +31,7 @@ class EventBase;
 namespace nebula {
 
 namespace wal {
-class FileBasedWal;
+class Wal;
 }  // namespace wal
 
 namespace raftex {
@@ -57,6 +59,7 @@ enum class LogType {
 };
 
 class Host;
+class HeartbeatBatcher;
 class AppendLogsIterator;
 
 /**
@@ -81,7 +84,7 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
    * @brief Return whether RaftPart is running
    */
   bool isRunning() const {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     return status_ == Status::RUNNING;
   }
 
@@ -89,7 +92,7 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
    * @brief Return whether RaftPart is stopped
    */
   bool isStopped() const {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     return status_ == Status::STOPPED;
   }
 
@@ -97,7 +100,7 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
    * @brief Return whether RaftPart is leader
    */
   bool isLeader() const {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     return role_ == Role::LEADER;
   }
 
@@ -105,7 +108,7 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
    * @brief Return whether RaftPart is follower
    */
   bool isFollower() const {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     return role_ == Role::FOLLOWER;
   }
 
@@ -113,7 +116,7 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
    * @brief Return whether RaftPart is learner
    */
   bool isLearner() const {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     return role_ == Role::LEARNER;
   }
 
@@ -149,7 +152,7 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
    * @brief Return the leader address of RaftPart
    */
   HostAddr leader() const {
-    std::lock_guard<std::mutex> g(raftLock_);
+    std::lock_guard<thread::ProfiledMutex> g(raftLock_);
     return leader_;
   }
 
@@ -168,10 +171,39 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
   /**
    * @brief Return the wal
    */
-  std::shared_ptr<wal::FileBasedWal> wal() const {
+  std::shared_ptr<wal::Wal> wal() const {
     return wal_;
   }
 
+  /**
+   * @brief The replication state of the part which is exported as metrics
+   */
+  struct ReplicationStats {
+    bool isLeader{false};
+    // The number of logs received but not committed yet
+    LogID commitLag{0};
+    // The max number of logs a follower has not committed, only for leader
+    LogID maxFollowerLag{0};
+    // The bytes of the logs of maxFollowerLag, estimated by the average size of logs in the wal
+    size_t maxFollowerLagBytes{0};
+    // The max round trip time of the last heartbeat to each follower, only for leader
+    int64_t maxHeartbeatRttUs{0};
+    // The logs appended by clients waiting in the buffer to be replicated, only for leader
+    size_t pendingLogs{0};
+    size_t pendingLogBytes{0};
+    // The number of followers being sent a snapshot, only for leader
+    size_t sendingSnapshots{0};
+    // The rows and bytes of the snapshot received so far, only when waiting for a snapshot
+    int64_t snapshotRowsReceived{0};
+    int64_t snapshotBytesReceived{0};
+    size_t walBytes{0};
+  };
+
+  /**
+   * @brief Return the replication state of the part
+   */
+  ReplicationStats replicationStats() const;
+
   /**
    * @brief Add a raft learner to its peers
    *
@@ -336,12 +368,14 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
   void processAskForVoteRequest(const cpp2::AskForVoteRequest& req, cpp2::AskForVoteResponse& resp);
 
   /**
-   * @brief Process append log request
+   * @brief Process append log request, virtual so that a benchmark could inject the latency of
+   * network
    *
    * @param req
    * @param resp
    */
-  void processAppendLogRequest(const cpp2::AppendLogRequest& req, cpp2::AppendLogResponse& resp);
+  virtual void processAppendLogRequest(const cpp2::AppendLogRequest& req,
+                                       cpp2::AppendLogResponse& resp);
 
   /**
    * @brief Process send snapshot request
@@ -365,11 +399,37 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
    */
   bool leaseValid();
 
+  /**
+   * @brief Check whether the leader could serve a linearizable read. It returns immediately if the
+   * lease is still valid, otherwise the leadership is confirmed by a round of heartbeat.
+   *
+   * @return folly::Future<nebula::cpp2::ErrorCode> SUCCEEDED if the leadership is confirmed,
+   * E_LEADER_CHANGED if not leader, E_LEADER_LEASE_FAILED if not confirmed by quorum
+   */
+  folly::Future<nebula::cpp2::ErrorCode> readIndex();
+
+  /**
+   * @brief Return whether the part is a follower which could serve reads whose staleness is
+   * bounded. The follower is regarded as caught up when its committed log id reaches the one of
+   * the leader carried in appendLog or heartbeat, so the staleness is the duration since then.
+   *
+   * @param maxStalenessMs Max staleness in milliseconds
+   */
+  bool followerReadable(int64_t maxStalenessMs);
+
   /**
    * @brief Return whether we need to clean expired wal
    */
   bool needToCleanWal();
 
+  /**
+   * @brief Set the batcher shared by the parts of the raft service, which is used to send
+   * heartbeats when batching is enabled. It should be set before the part starts.
+   */
+  void setHeartbeatBatcher(std::shared_ptr<HeartbeatBatcher> batcher) {
+    heartbeatBatcher_ = std::move(batcher);
+  }
+
   /**
    * @brief Get the address of node which has the partition, local address and all peers address
    *
@@ -576,12 +636,13 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
   using AppendLogResponses = std::vector<std::pair<size_t, cpp2::AppendLogResponse>>;
   using HeartbeatResponses = std::vector<std::pair<size_t, cpp2::HeartbeatResponse>>;
 
-  // <source, logType, log, result(promise), atomic>
+  // <source, logType, log, atomic, result(promise), the microseconds when it is buffered>
   using LogCacheItem = std::tuple<ClusterID,
                                   LogType,
                                   std::string,
                                   kvstore::MergeableAtomicOp,
-                                  folly::Promise<nebula::cpp2::ErrorCode>>;
+                                  folly::Promise<nebula::cpp2::ErrorCode>,
+                                  uint64_t>;
   using LogCache = std::deque<LogCacheItem>;
 
   /****************************************************
@@ -631,6 +692,13 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
    */
   void sendHeartbeat();
 
+  /**
+   * @brief Send a heartbeat to all peers, the lease is renewed if it is accepted by quorum
+   *
+   * @return folly::Future<bool> Whether the heartbeat is accepted by quorum in current term
+   */
+  folly::Future<bool> confirmLeadership();
+
   /**
    * @brief Return whether need to trigger leader election
    */
@@ -813,7 +881,7 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
   LogCache sendingLogs_;
 
   // Partition level lock to synchronize the access of the partition
-  mutable std::mutex raftLock_;
+  mutable thread::ProfiledMutex raftLock_{"raft"};
 
   Status status_;
   Role role_;
@@ -863,7 +931,7 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
   bool commitInThisTerm_{false};
 
   // Write-ahead Log
-  std::shared_ptr<wal::FileBasedWal> wal_;
+  std::shared_ptr<wal::Wal> wal_;
 
   // IO Thread pool
   std::shared_ptr<folly::IOThreadPoolExecutor> ioThreadPool_;
@@ -874,6 +942,8 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
 
   std::shared_ptr<SnapshotManager> snapshot_;
 
+  std::shared_ptr<HeartbeatBatcher> heartbeatBatcher_;
+
   std::shared_ptr<thrift::ThriftClientManager<cpp2::RaftexServiceAsyncClient>> clientMan_;
   // Used in snapshot, record the commitLogId and commitLogTerm of the snapshot, as well as
   // last total count and total size received from request
@@ -881,6 +951,8 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
   TermID lastSnapshotCommitTerm_ = 0;
   int64_t lastTotalCount_ = 0;
   int64_t lastTotalSize_ = 0;
+  // The last time in milliseconds when the follower has committed all logs the leader committed
+  int64_t lastCaughtUpTime_ = 0;
   time::Duration lastSnapshotRecvDur_;
 
   // Check if disk has enough space before write wal
@@ -893,6 +965,9 @@ class RaftPart : public std::enable_shared_from_this<RaftPart> {
 
   // For stats info
   uint64_t execTime_{0};
+  // The histograms labeled by the space, see initKVStats
+  stats::CounterId appendToCommitLatencyUs_;
+  stats::CounterId heartbeatRttUs_;
 };
 
 }  // namespace raftex
@@ -10,6 +10,7 @@
 #include "common/base/Base.h"
 #include "common/base/ErrorOr.h"
 #include "common/ssl/SSLConfig.h"
+#include "kvstore/raftex/HeartbeatBatcher.h"
 #include "kvstore/raftex/RaftPart.h"
 
 namespace nebula {
@@ -20,6 +21,8 @@ namespace raftex {
  * Implementation of RaftexService
  *
  ******************************************************/
+RaftexService::RaftexService() : heartbeatBatcher_(std::make_shared<HeartbeatBatcher>()) {}
+
 std::shared_ptr<RaftexService> RaftexService::createService(
     std::shared_ptr<folly::IOThreadPoolExecutor> ioPool,
     std::shared_ptr<folly::Executor> workers,
@@ -81,6 +84,7 @@ void RaftexService::stop() {
 void RaftexService::addPartition(std::shared_ptr<RaftPart> part) {
   // todo(doodle): If we need to start both listener and normal replica on same
   // hosts, this class need to be aware of type.
+  part->setHeartbeatBatcher(heartbeatBatcher_);
   folly::RWSpinLock::WriteHolder wh(partsLock_);
   parts_.emplace(std::make_pair(part->spaceId(), part->partitionId()), part);
 }
@@ -174,5 +178,24 @@ void RaftexService::async_eb_heartbeat(
   callback->result(resp);
 }
 
+void RaftexService::async_eb_batchHeartbeat(
+    std::unique_ptr<apache::thrift::HandlerCallback<cpp2::BatchHeartbeatResponse>> callback,
+    const cpp2::BatchHeartbeatRequest& req) {
+  cpp2::BatchHeartbeatResponse resp;
+  auto& requests = req.get_requests();
+  auto& responses = *resp.responses_ref();
+  responses.resize(requests.size());
+  for (size_t i = 0; i < requests.size(); i++) {
+    auto part = findPart(requests[i].get_space(), requests[i].get_part());
+    if (!part) {
+      // Not found
+      responses[i].error_code_ref() = nebula::cpp2::ErrorCode::E_RAFT_UNKNOWN_PART;
+      continue;
+    }
+    part->processHeartbeatRequest(requests[i], responses[i]);
+  }
+  callback->result(resp);
+}
+
 }  // namespace raftex
 }  // namespace nebula
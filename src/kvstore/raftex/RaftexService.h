@@ -16,6 +16,7 @@ namespace nebula {
 namespace raftex {
 
 class RaftPart;
+class HeartbeatBatcher;
 class IOThreadPoolObserver;
 
 /**
@@ -111,6 +112,16 @@ class RaftexService : public cpp2::RaftexServiceSvIf {
       std::unique_ptr<apache::thrift::HandlerCallback<cpp2::HeartbeatResponse>> callback,
       const cpp2::HeartbeatRequest& req) override;
 
+  /**
+   * @brief Handle the heartbeats of multiple parts in io thread
+   *
+   * @param callback Thrift callback
+   * @param req
+   */
+  void async_eb_batchHeartbeat(
+      std::unique_ptr<apache::thrift::HandlerCallback<cpp2::BatchHeartbeatResponse>> callback,
+      const cpp2::BatchHeartbeatRequest& req) override;
+
   /**
    * @brief Register the RaftPart to the service
    */
@@ -131,13 +142,16 @@ class RaftexService : public cpp2::RaftexServiceSvIf {
   std::shared_ptr<RaftPart> findPart(GraphSpaceID spaceId, PartitionID partId);
 
  private:
-  RaftexService() = default;
+  RaftexService();
 
   std::unique_ptr<apache::thrift::ThriftServer> server_;
   uint32_t serverPort_;
 
   folly::RWSpinLock partsLock_;
   std::unordered_map<std::pair<GraphSpaceID, PartitionID>, std::shared_ptr<RaftPart>> parts_;
+
+  // Shared by all the parts to batch their heartbeats
+  std::shared_ptr<HeartbeatBatcher> heartbeatBatcher_;
 };
 
 }  // namespace raftex
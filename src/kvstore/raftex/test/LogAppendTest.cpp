@@ -17,6 +17,9 @@
 
 DECLARE_uint32(raft_heartbeat_interval_secs);
 DECLARE_uint32(max_batch_size);
+DECLARE_uint32(raft_heartbeat_batch_window_ms);
+DECLARE_uint32(max_appendlog_batch_size);
+DECLARE_uint32(max_inflight_appendlog_requests);
 
 namespace nebula {
 namespace raftex {
@@ -63,6 +66,68 @@ TEST(LogAppend, SimpleAppendWithThreeCopies) {
   finishRaft(services, copies, workers, leader);
 }
 
+TEST(LogAppend, FollowerReadable) {
+  fs::TempDir walRoot("/tmp/follower_readable.XXXXXX");
+  std::shared_ptr<thread::GenericThreadPool> workers;
+  std::vector<std::string> wals;
+  std::vector<HostAddr> allHosts;
+  std::vector<std::shared_ptr<RaftexService>> services;
+  std::vector<std::shared_ptr<test::TestShard>> copies;
+
+  std::shared_ptr<test::TestShard> leader;
+  setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+
+  // Check all hosts agree on the same leader
+  checkLeadership(copies, leader);
+
+  std::vector<std::string> msgs;
+  appendLogs(0, 99, leader, msgs);
+  checkConsensus(copies, 0, 99, msgs);
+
+  // The followers catch up with the leader's committed log id by the next heartbeat
+  sleep(FLAGS_raft_heartbeat_interval_secs + 1);
+  auto maxStalenessMs = FLAGS_raft_heartbeat_interval_secs * 2 * 1000;
+  for (auto& c : copies) {
+    if (c->isLeader()) {
+      // The leader is read through the lease instead
+      EXPECT_FALSE(c->followerReadable(maxStalenessMs));
+    } else {
+      EXPECT_TRUE(c->followerReadable(maxStalenessMs));
+    }
+  }
+
+  finishRaft(services, copies, workers, leader);
+}
+
+TEST(LogAppend, ReadIndex) {
+  fs::TempDir walRoot("/tmp/read_index.XXXXXX");
+  std::shared_ptr<thread::GenericThreadPool> workers;
+  std::vector<std::string> wals;
+  std::vector<HostAddr> allHosts;
+  std::vector<std::shared_ptr<RaftexService>> services;
+  std::vector<std::shared_ptr<test::TestShard>> copies;
+
+  std::shared_ptr<test::TestShard> leader;
+  setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+
+  // Check all hosts agree on the same leader
+  checkLeadership(copies, leader);
+
+  std::vector<std::string> msgs;
+  appendLogs(0, 9, leader, msgs);
+  checkConsensus(copies, 0, 9, msgs);
+
+  for (auto& c : copies) {
+    if (c->isLeader()) {
+      EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, c->readIndex().get());
+    } else {
+      EXPECT_EQ(nebula::cpp2::ErrorCode::E_LEADER_CHANGED, c->readIndex().get());
+    }
+  }
+
+  finishRaft(services, copies, workers, leader);
+}
+
 TEST(LogAppend, MultiThreadAppend) {
   fs::TempDir walRoot("/tmp/multi_thread_append.XXXXXX");
   std::shared_ptr<thread::GenericThreadPool> workers;
@@ -131,6 +196,94 @@ TEST(LogAppend, MultiThreadAppend) {
   finishRaft(services, copies, workers, leader);
 }
 
+TEST(LogAppend, PipelinedAppendWithThreeCopies) {
+  // Small batches so that there are several requests in flight
+  FLAGS_max_appendlog_batch_size = 4;
+  FLAGS_max_inflight_appendlog_requests = 8;
+  fs::TempDir walRoot("/tmp/pipelined_append_with_three_copies.XXXXXX");
+  std::shared_ptr<thread::GenericThreadPool> workers;
+  std::vector<std::string> wals;
+  std::vector<HostAddr> allHosts;
+  std::vector<std::shared_ptr<RaftexService>> services;
+  std::vector<std::shared_ptr<test::TestShard>> copies;
+
+  std::shared_ptr<test::TestShard> leader;
+  setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+
+  // Check all hosts agree on the same leader
+  checkLeadership(copies, leader);
+
+  std::vector<std::string> msgs;
+  appendLogs(0, 999, leader, msgs, true);
+  checkConsensus(copies, 0, 999, msgs);
+
+  finishRaft(services, copies, workers, leader);
+  FLAGS_max_appendlog_batch_size = 128;
+  FLAGS_max_inflight_appendlog_requests = 1;
+}
+
+TEST(LogAppend, AppendWithBatchedHeartbeat) {
+  FLAGS_raft_heartbeat_batch_window_ms = 10;
+  fs::TempDir walRoot("/tmp/append_with_batched_heartbeat.XXXXXX");
+  std::shared_ptr<thread::GenericThreadPool> workers;
+  std::vector<std::string> wals;
+  std::vector<HostAddr> allHosts;
+  std::vector<std::shared_ptr<RaftexService>> services;
+  std::vector<std::shared_ptr<test::TestShard>> copies;
+
+  std::shared_ptr<test::TestShard> leader;
+  setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+
+  // Check all hosts agree on the same leader
+  checkLeadership(copies, leader);
+
+  std::vector<std::string> msgs;
+  appendLogs(0, 99, leader, msgs);
+  checkConsensus(copies, 0, 99, msgs);
+
+  // The leadership is kept by the batched heartbeats
+  sleep(FLAGS_raft_heartbeat_interval_secs);
+  checkLeadership(copies, leader);
+
+  finishRaft(services, copies, workers, leader);
+  FLAGS_raft_heartbeat_batch_window_ms = 0;
+}
+
+TEST(LogAppend, ReplicationStats) {
+  fs::TempDir walRoot("/tmp/replication_stats.XXXXXX");
+  std::shared_ptr<thread::GenericThreadPool> workers;
+  std::vector<std::string> wals;
+  std::vector<HostAddr> allHosts;
+  std::vector<std::shared_ptr<RaftexService>> services;
+  std::vector<std::shared_ptr<test::TestShard>> copies;
+
+  std::shared_ptr<test::TestShard> leader;
+  setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+  checkLeadership(copies, leader);
+
+  std::vector<std::string> msgs;
+  appendLogs(0, 99, leader, msgs);
+  checkConsensus(copies, 0, 99, msgs);
+
+  auto stats = leader->replicationStats();
+  EXPECT_TRUE(stats.isLeader);
+  // All the logs appended are committed, none is left in the buffer
+  EXPECT_EQ(0, stats.pendingLogs);
+  EXPECT_EQ(0, stats.pendingLogBytes);
+  EXPECT_EQ(0, stats.sendingSnapshots);
+  EXPECT_LT(0, stats.walBytes);
+  for (const auto& copy : copies) {
+    if (copy != leader) {
+      auto followerStats = copy->replicationStats();
+      EXPECT_FALSE(followerStats.isLeader);
+      EXPECT_EQ(0, followerStats.pendingLogs);
+      EXPECT_EQ(0, followerStats.snapshotRowsReceived);
+    }
+  }
+
+  finishRaft(services, copies, workers, leader);
+}
+
 }  // namespace raftex
 }  // namespace nebula
 
@@ -0,0 +1,321 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/String.h>
+#include <folly/futures/Future.h>
+#include <folly/init/Init.h>
+
+#include "common/base/Base.h"
+#include "common/fs/FileUtils.h"
+#include "common/fs/TempDir.h"
+#include "common/thread/GenericThreadPool.h"
+#include "common/time/WallClock.h"
+#include "kvstore/raftex/RaftPart.h"
+#include "kvstore/raftex/RaftexService.h"
+#include "kvstore/raftex/test/RaftexTestBase.h"
+
+DEFINE_int32(raft_bench_replicas, 3, "The replicas of each part");
+DEFINE_string(raft_bench_parts, "1,8", "The numbers of parts to run with, e.g. 1,8,32");
+DEFINE_string(raft_bench_batch_sizes,
+              "1,16,128",
+              "The numbers of logs appended together by each part to run with, they are sent by "
+              "raft in the same append log requests");
+DEFINE_string(raft_bench_wal_sync, "false", "The wal sync modes to run with, e.g. false,true");
+DEFINE_int32(raft_bench_logs_per_part, 20000, "The logs appended to each part in a run");
+DEFINE_int32(raft_bench_log_size, 128, "The bytes of a log");
+DEFINE_int32(raft_bench_rpc_delay_us,
+             0,
+             "The latency injected to each append log request received by a follower, to model "
+             "the network between hosts");
+
+DECLARE_bool(wal_sync);
+DECLARE_bool(enable_ssl);
+
+namespace nebula {
+namespace raftex {
+
+/**
+ * @brief A part of which the state machine only counts the logs committed, so the benchmark
+ * measures raft and the wal alone
+ */
+class BenchShard : public RaftPart {
+ public:
+  BenchShard(PartitionID partId,
+             HostAddr addr,
+             const std::string& walRoot,
+             std::shared_ptr<RaftexService> service,
+             std::shared_ptr<thread::GenericThreadPool> workers,
+             std::shared_ptr<SnapshotManager> snapshotMan,
+             std::shared_ptr<thrift::ThriftClientManager<cpp2::RaftexServiceAsyncClient>> clientMan)
+      : RaftPart(1,  // clusterId
+                 1,  // spaceId
+                 partId,
+                 addr,
+                 walRoot,
+                 service->getIOThreadPool(),
+                 workers,
+                 service->getThreadManager(),
+                 snapshotMan,
+                 clientMan,
+                 nullptr) {}
+
+  bool ready() const {
+    return ready_.load();
+  }
+
+  void processAppendLogRequest(const cpp2::AppendLogRequest& req,
+                               cpp2::AppendLogResponse& resp) override {
+    if (FLAGS_raft_bench_rpc_delay_us > 0) {
+      usleep(FLAGS_raft_bench_rpc_delay_us);
+    }
+    RaftPart::processAppendLogRequest(req, resp);
+  }
+
+  std::pair<LogID, TermID> lastCommittedLogId() override {
+    return {committedId_.load(), committedTerm_.load()};
+  }
+
+  void onLostLeadership(TermID) override {
+    ready_ = false;
+  }
+
+  void onElected(TermID) override {}
+
+  void onLeaderReady(TermID) override {
+    ready_ = true;
+  }
+
+  void onDiscoverNewLeader(HostAddr) override {}
+
+  std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> commitLogs(std::unique_ptr<LogIterator> iter,
+                                                                bool,
+                                                                bool) override {
+    LogID lastId = kNoCommitLogId;
+    TermID lastTerm = kNoCommitLogTerm;
+    while (iter->valid()) {
+      lastId = iter->logId();
+      lastTerm = iter->logTerm();
+      ++(*iter);
+    }
+    if (lastId != kNoCommitLogId) {
+      committedId_ = lastId;
+      committedTerm_ = lastTerm;
+    }
+    return {nebula::cpp2::ErrorCode::SUCCEEDED, lastId, lastTerm};
+  }
+
+  bool preProcessLog(LogID, TermID, ClusterID, const std::string&) override {
+    return true;
+  }
+
+  std::tuple<nebula::cpp2::ErrorCode, int64_t, int64_t> commitSnapshot(
+      const std::vector<std::string>& data, LogID, TermID, bool) override {
+    return {nebula::cpp2::ErrorCode::SUCCEEDED, static_cast<int64_t>(data.size()), 0};
+  }
+
+  nebula::cpp2::ErrorCode cleanup() override {
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+ private:
+  std::atomic<bool> ready_{false};
+  std::atomic<LogID> committedId_{0};
+  std::atomic<TermID> committedTerm_{0};
+};
+
+/**
+ * @brief The replicas of some parts, each replica is a raft service on loopback
+ */
+class BenchCluster {
+ public:
+  BenchCluster(int32_t replicas, int32_t parts, const std::string& walRoot) {
+    workers_ = std::make_shared<thread::GenericThreadPool>();
+    workers_->start(4);
+    auto clientMan = std::make_shared<thrift::ThriftClientManager<cpp2::RaftexServiceAsyncClient>>(
+        FLAGS_enable_ssl);
+    for (int32_t i = 0; i < replicas; i++) {
+      services_.emplace_back(RaftexService::createService(nullptr, nullptr));
+      hosts_.emplace_back("127.0.0.1", services_.back()->getServerPort());
+    }
+    auto snapshotMans = snapshots(services_);
+    for (PartitionID part = 1; part <= parts; part++) {
+      for (int32_t i = 0; i < replicas; i++) {
+        auto wal = folly::stringPrintf("%s/copy%d/part%d", walRoot.c_str(), i, part);
+        CHECK(fs::FileUtils::makeDir(wal));
+        auto shard = std::make_shared<BenchShard>(
+            part, hosts_[i], wal, services_[i], workers_, snapshotMans[i], clientMan);
+        services_[i]->addPartition(shard);
+        shard->start(getPeers(hosts_, hosts_[i]));
+        shards_.emplace_back(std::move(shard));
+      }
+    }
+  }
+
+  ~BenchCluster() {
+    shards_.clear();
+    // Stopping a service stops its parts
+    for (auto& service : services_) {
+      service->stop();
+    }
+    workers_->stop();
+    workers_->wait();
+  }
+
+  // The leader of each part once all parts have one which is ready
+  std::vector<std::shared_ptr<BenchShard>> waitForLeaders() {
+    while (true) {
+      std::vector<std::shared_ptr<BenchShard>> leaders;
+      for (auto& shard : shards_) {
+        if (shard->isLeader() && shard->ready()) {
+          leaders.emplace_back(shard);
+        }
+      }
+      if (leaders.size() * hosts_.size() == shards_.size()) {
+        return leaders;
+      }
+      usleep(100000);
+    }
+  }
+
+ private:
+  std::shared_ptr<thread::GenericThreadPool> workers_;
+  std::vector<std::shared_ptr<RaftexService>> services_;
+  std::vector<HostAddr> hosts_;
+  std::vector<std::shared_ptr<BenchShard>> shards_;
+};
+
+struct RunResult {
+  double logsPerSec;
+  double mbPerSec;
+  int64_t p50Us;
+  int64_t p99Us;
+  int64_t maxUs;
+  int64_t errors;
+};
+
+// Append the logs to a part by batches, the latency of a log is from append to commit
+void appendToPart(std::shared_ptr<BenchShard> leader,
+                  int32_t batchSize,
+                  std::vector<int64_t>& latencies,
+                  std::atomic<int64_t>& errors) {
+  std::string log(FLAGS_raft_bench_log_size, 'x');
+  latencies.reserve(FLAGS_raft_bench_logs_per_part);
+  std::mutex lock;
+  for (int32_t i = 0; i < FLAGS_raft_bench_logs_per_part; i += batchSize) {
+    std::vector<folly::Future<folly::Unit>> futures;
+    auto n = std::min(batchSize, FLAGS_raft_bench_logs_per_part - i);
+    for (int32_t j = 0; j < n; j++) {
+      auto start = time::WallClock::fastNowInMicroSec();
+      futures.emplace_back(leader->appendAsync(0, log).thenValue([&, start](auto code) {
+        if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+          errors++;
+          return;
+        }
+        auto latency = time::WallClock::fastNowInMicroSec() - start;
+        std::lock_guard<std::mutex> guard(lock);
+        latencies.emplace_back(latency);
+      }));
+    }
+    folly::collectAll(futures).wait();
+  }
+}
+
+RunResult runOnce(int32_t parts, int32_t batchSize, bool walSync) {
+  FLAGS_wal_sync = walSync;
+  fs::TempDir walRoot("/tmp/raft_benchmark.XXXXXX");
+  BenchCluster cluster(FLAGS_raft_bench_replicas, parts, walRoot.path());
+  auto leaders = cluster.waitForLeaders();
+
+  std::vector<std::vector<int64_t>> latencies(leaders.size());
+  std::atomic<int64_t> errors{0};
+  auto start = time::WallClock::fastNowInMicroSec();
+  std::vector<std::thread> writers;
+  for (size_t i = 0; i < leaders.size(); i++) {
+    writers.emplace_back(
+        appendToPart, leaders[i], batchSize, std::ref(latencies[i]), std::ref(errors));
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  auto elapsedUs = std::max<int64_t>(time::WallClock::fastNowInMicroSec() - start, 1);
+
+  std::vector<int64_t> all;
+  for (auto& partLatencies : latencies) {
+    all.insert(all.end(), partLatencies.begin(), partLatencies.end());
+  }
+  std::sort(all.begin(), all.end());
+  if (all.empty()) {
+    all.emplace_back(0);
+  }
+  auto logs = static_cast<double>(all.size());
+  RunResult result;
+  result.logsPerSec = logs * 1000000 / elapsedUs;
+  result.mbPerSec = result.logsPerSec * FLAGS_raft_bench_log_size / (1 << 20);
+  result.p50Us = all[all.size() / 2];
+  result.p99Us = all[static_cast<size_t>((all.size() - 1) * 0.99)];
+  result.maxUs = all.back();
+  result.errors = errors.load();
+  return result;
+}
+
+template <typename T>
+std::vector<T> parseList(const std::string& flag) {
+  std::vector<std::string> entries;
+  folly::split(",", flag, entries, true);
+  std::vector<T> values;
+  for (const auto& entry : entries) {
+    values.emplace_back(folly::to<T>(folly::trimWhitespace(entry)));
+  }
+  return values;
+}
+
+}  // namespace raftex
+}  // namespace nebula
+
+/**
+ * Measures the throughput of appending logs to raft, and the latency from append to commit,
+ * versus the number of parts, the logs appended together, the wal sync mode and the network
+ * latency. All replicas run in this process and talk over loopback, e.g.
+ *
+ * raft_benchmark --raft_bench_parts=1,16 --raft_bench_batch_sizes=1,64 \
+ *   --raft_bench_wal_sync=false,true --raft_bench_rpc_delay_us=200
+ */
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  using nebula::raftex::parseList;
+  LOG(INFO) << folly::sformat("replicas {}, logs per part {}, log size {}, rpc delay {}us",
+                              FLAGS_raft_bench_replicas,
+                              FLAGS_raft_bench_logs_per_part,
+                              FLAGS_raft_bench_log_size,
+                              FLAGS_raft_bench_rpc_delay_us);
+  LOG(INFO) << folly::sformat("{:>6}{:>8}{:>8}{:>12}{:>10}{:>10}{:>10}{:>10}{:>8}",
+                              "parts",
+                              "batch",
+                              "sync",
+                              "logs/s",
+                              "MB/s",
+                              "p50(us)",
+                              "p99(us)",
+                              "max(us)",
+                              "errors");
+  for (auto walSync : parseList<bool>(FLAGS_raft_bench_wal_sync)) {
+    for (auto parts : parseList<int32_t>(FLAGS_raft_bench_parts)) {
+      for (auto batchSize : parseList<int32_t>(FLAGS_raft_bench_batch_sizes)) {
+        auto result = nebula::raftex::runOnce(parts, std::max(batchSize, 1), walSync);
+        LOG(INFO) << folly::sformat("{:>6}{:>8}{:>8}{:>12.0f}{:>10.2f}{:>10}{:>10}{:>10}{:>8}",
+                                    parts,
+                                    batchSize,
+                                    walSync,
+                                    result.logsPerSec,
+                                    result.mbPerSec,
+                                    result.p50Us,
+                                    result.p99Us,
+                                    result.maxUs,
+                                    result.errors);
+      }
+    }
+  }
+  return 0;
+}
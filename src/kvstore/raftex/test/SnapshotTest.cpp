@@ -0,0 +1,119 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include "kvstore/raftex/RaftexService.h"
+#include "kvstore/raftex/test/RaftexTestBase.h"
+#include "kvstore/raftex/test/TestShard.h"
+
+namespace nebula {
+namespace raftex {
+
+class SnapshotTest : public RaftexTestFixture {
+ public:
+  SnapshotTest() : RaftexTestFixture("snapshot_test") {}
+
+ protected:
+  // Build a snapshot batch sent by the leader, with the rows in [start, end)
+  cpp2::SendSnapshotRequest snapshotBatch(int32_t start, int32_t end, bool done) {
+    cpp2::SendSnapshotRequest req;
+    req.space_ref() = leader_->spaceId();
+    req.part_ref() = leader_->partitionId();
+    req.current_term_ref() = leader_->termId();
+    auto commitLogIdAndTerm = leader_->lastCommittedLogId();
+    req.committed_log_id_ref() = commitLogIdAndTerm.first;
+    req.committed_log_term_ref() = commitLogIdAndTerm.second;
+    req.leader_addr_ref() = leader_->address().host;
+    req.leader_port_ref() = leader_->address().port;
+    std::vector<std::string> rows;
+    for (auto i = start; i < end; i++) {
+      rows.emplace_back(test::encodeSnapshotRow(i, folly::stringPrintf("row_%d", i)));
+      sentCount_++;
+      sentSize_ += rows.back().size();
+    }
+    req.rows_ref() = std::move(rows);
+    req.total_count_ref() = sentCount_;
+    req.total_size_ref() = sentSize_;
+    req.done_ref() = done;
+    return req;
+  }
+
+  std::shared_ptr<test::TestShard> follower() {
+    for (auto& copy : copies_) {
+      if (copy != leader_) {
+        return copy;
+      }
+    }
+    LOG(FATAL) << "No follower";
+    return nullptr;
+  }
+
+  int64_t sentCount_{0};
+  int64_t sentSize_{0};
+};
+
+TEST_F(SnapshotTest, ResendPersistedBatch) {
+  auto part = follower();
+  auto first = snapshotBatch(0, 10, false);
+  {
+    cpp2::SendSnapshotResponse resp;
+    part->processSendSnapshotRequest(first, resp);
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_error_code());
+    ASSERT_EQ(10, part->getNumLogs());
+    ASSERT_FALSE(part->isRunning());
+  }
+  {
+    // The response of the first batch is lost, and the leader sends it again. It is acknowledged
+    // without being persisted twice, and the follower is still waiting for the rest
+    cpp2::SendSnapshotResponse resp;
+    part->processSendSnapshotRequest(first, resp);
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_error_code());
+    ASSERT_EQ(10, part->getNumLogs());
+    ASSERT_FALSE(part->isRunning());
+  }
+  {
+    // The snapshot is not reset, so the next batch matches the total count and size
+    cpp2::SendSnapshotResponse resp;
+    part->processSendSnapshotRequest(snapshotBatch(10, 20, false), resp);
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_error_code());
+    ASSERT_EQ(20, part->getNumLogs());
+    ASSERT_FALSE(part->isRunning());
+  }
+  auto last = snapshotBatch(20, 20, true);
+  {
+    cpp2::SendSnapshotResponse resp;
+    part->processSendSnapshotRequest(last, resp);
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_error_code());
+    ASSERT_EQ(20, part->getNumLogs());
+    ASSERT_TRUE(part->isRunning());
+  }
+  {
+    // The last batch is resent as well, which doesn't start a new snapshot
+    cpp2::SendSnapshotResponse resp;
+    part->processSendSnapshotRequest(last, resp);
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_error_code());
+    ASSERT_EQ(20, part->getNumLogs());
+    ASSERT_TRUE(part->isRunning());
+  }
+  for (int32_t i = 0; i < 20; i++) {
+    folly::StringPiece msg;
+    ASSERT_TRUE(part->getLogMsg(i, msg));
+    EXPECT_EQ(folly::stringPrintf("row_%d", i), msg.str());
+  }
+}
+
+}  // namespace raftex
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+
+  return RUN_ALL_TESTS();
+}
@@ -19,6 +19,21 @@ stats::CounterId kTransferLeaderLatencyUs;
 stats::CounterId kNumStartElect;
 stats::CounterId kNumGrantVotes;
 stats::CounterId kNumSendSnapshot;
+stats::CounterId kNumWalBufferHit;
+stats::CounterId kNumWalBufferMiss;
+stats::CounterId kNumCoalescedWrites;
+stats::CounterId kRaftAppendToCommitLatencyUs;
+stats::CounterId kRaftHeartbeatRttUs;
+stats::CounterId kDiskIoUtil;
+stats::CounterId kDiskReadBytes;
+stats::CounterId kDiskWriteBytes;
+stats::CounterId kBlockCacheHit;
+stats::CounterId kBlockCacheMiss;
+stats::CounterId kMemtableUsageBytes;
+stats::CounterId kNumMemtableBudgetFlushes;
+stats::CounterId kMemtableBudgetStalled;
+stats::CounterId kNumWriteStalls;
+stats::CounterId kListenerApplyLag;
 
 void initKVStats() {
   kCommitLogLatencyUs = stats::StatsManager::registerHisto(
@@ -36,6 +51,26 @@ void initKVStats() {
   kNumStartElect = stats::StatsManager::registerStats("num_start_elect", "rate, sum");
   kNumGrantVotes = stats::StatsManager::registerStats("num_grant_votes", "rate, sum");
   kNumSendSnapshot = stats::StatsManager::registerStats("num_send_snapshot", "rate, sum");
+  kNumWalBufferHit = stats::StatsManager::registerStats("num_wal_buffer_hit", "rate, sum");
+  kNumWalBufferMiss = stats::StatsManager::registerStats("num_wal_buffer_miss", "rate, sum");
+  kNumCoalescedWrites = stats::StatsManager::registerHisto(
+      "num_coalesced_writes", 1, 1, 256, "avg, p75, p95, p99, p999");
+  kRaftAppendToCommitLatencyUs = stats::StatsManager::registerHisto(
+      "raft_append_to_commit_latency_us", 1000, 0, 2000, "avg, p75, p95, p99, p999");
+  kRaftHeartbeatRttUs = stats::StatsManager::registerHisto(
+      "raft_heartbeat_rtt_us", 1000, 0, 2000, "avg, p75, p95, p99, p999");
+  kDiskIoUtil = stats::StatsManager::registerStats("disk_io_util", "avg, max");
+  kDiskReadBytes = stats::StatsManager::registerStats("disk_read_bytes", "rate, sum");
+  kDiskWriteBytes = stats::StatsManager::registerStats("disk_write_bytes", "rate, sum");
+  kBlockCacheHit = stats::StatsManager::registerStats("block_cache_hit", "rate, sum");
+  kBlockCacheMiss = stats::StatsManager::registerStats("block_cache_miss", "rate, sum");
+  kMemtableUsageBytes = stats::StatsManager::registerStats("memtable_usage_bytes", "avg, max");
+  kNumMemtableBudgetFlushes =
+      stats::StatsManager::registerStats("num_memtable_budget_flushes", "rate, sum");
+  kMemtableBudgetStalled =
+      stats::StatsManager::registerStats("memtable_budget_stalled", "avg, max");
+  kNumWriteStalls = stats::StatsManager::registerStats("num_write_stalls", "rate, sum");
+  kListenerApplyLag = stats::StatsManager::registerStats("listener_apply_lag", "avg, max");
 }
 
 }  // namespace nebula
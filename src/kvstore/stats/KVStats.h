@@ -21,6 +21,26 @@ extern stats::CounterId kTransferLeaderLatencyUs;
 extern stats::CounterId kNumStartElect;
 extern stats::CounterId kNumGrantVotes;
 extern stats::CounterId kNumSendSnapshot;
+extern stats::CounterId kNumWalBufferHit;
+extern stats::CounterId kNumWalBufferMiss;
+extern stats::CounterId kNumCoalescedWrites;
+// Raft related histograms labeled by the space
+extern stats::CounterId kRaftAppendToCommitLatencyUs;
+extern stats::CounterId kRaftHeartbeatRttUs;
+// Disk related stats, labeled by the data path
+extern stats::CounterId kDiskIoUtil;
+extern stats::CounterId kDiskReadBytes;
+extern stats::CounterId kDiskWriteBytes;
+// Block cache related stats, labeled by the space
+extern stats::CounterId kBlockCacheHit;
+extern stats::CounterId kBlockCacheMiss;
+// Memtable related stats of all the spaces
+extern stats::CounterId kMemtableUsageBytes;
+extern stats::CounterId kNumMemtableBudgetFlushes;
+extern stats::CounterId kMemtableBudgetStalled;
+extern stats::CounterId kNumWriteStalls;
+// The committed logs not applied by a listener yet, labeled by the space and the part
+extern stats::CounterId kListenerApplyLag;
 
 void initKVStats();
 
@@ -0,0 +1,136 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include "common/utils/NebulaKeyUtils.h"
+#include "kvstore/RocksEngine.h"
+#include "kvstore/plugins/analytics/CsrEngine.h"
+
+namespace nebula {
+namespace kvstore {
+
+const int32_t kDefaultVIdLen = 8;
+
+static std::vector<KV> edges(PartitionID partId) {
+  std::vector<KV> data;
+  for (int32_t src = 1; src <= 10; src += 2) {
+    for (EdgeType type : {-2, 1, 2}) {
+      for (EdgeRanking rank = 0; rank < 2; rank++) {
+        for (int32_t dst = 20; dst < 23; dst++) {
+          auto key = NebulaKeyUtils::edgeKey(kDefaultVIdLen,
+                                             partId,
+                                             std::to_string(src),
+                                             type,
+                                             rank,
+                                             std::to_string(dst));
+          data.emplace_back(std::move(key), folly::sformat("{}_{}_{}_{}", src, type, rank, dst));
+        }
+      }
+    }
+  }
+  return data;
+}
+
+static std::vector<KV> collect(std::unique_ptr<KVIterator> iter) {
+  std::vector<KV> data;
+  for (; iter->valid(); iter->next()) {
+    data.emplace_back(iter->key().str(), iter->val().str());
+  }
+  return data;
+}
+
+TEST(CsrEngineTest, PrefixTest) {
+  fs::TempDir rootPath("/tmp/CsrEngineTest.PrefixTest.XXXXXX");
+  auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiPut(edges(1)));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiPut(edges(2)));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+            engine->put(NebulaKeyUtils::tagKey(kDefaultVIdLen, 1, "1", 3), "tag"));
+
+  auto path = folly::stringPrintf("%s/edges.csr", rootPath.path());
+  auto csr = CsrSnapshot::build(engine.get(), nullptr, 1, kDefaultVIdLen, path);
+  ASSERT_NE(nullptr, csr);
+  EXPECT_EQ(5, csr->numVertices());
+  EXPECT_EQ(90, csr->numEdges());
+  EXPECT_FALSE(csr->covers(NebulaKeyUtils::tagPrefix(1)));
+  EXPECT_FALSE(csr->covers(NebulaKeyUtils::edgePrefix(2)));
+
+  std::vector<std::string> prefixes = {
+      NebulaKeyUtils::edgePrefix(1),
+      NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "1"),
+      NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "5", 2),
+      NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "9", -2),
+      NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "7", 1, 1, "21"),
+      // Not any edge
+      NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "2"),
+      NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "3", 3),
+  };
+  for (const auto& prefix : prefixes) {
+    ASSERT_TRUE(csr->covers(prefix));
+    std::unique_ptr<KVIterator> iter;
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->prefix(prefix, &iter));
+    EXPECT_EQ(collect(std::move(iter)), collect(csr->prefix(prefix)));
+  }
+
+  // Mapped again from the file
+  csr = CsrSnapshot::open(path, 1, kDefaultVIdLen);
+  ASSERT_NE(nullptr, csr);
+  EXPECT_EQ(90, collect(csr->prefix(NebulaKeyUtils::edgePrefix(1))).size());
+  EXPECT_EQ(nullptr, CsrSnapshot::open(path, 2, kDefaultVIdLen));
+}
+
+TEST(CsrEngineTest, RefreshTest) {
+  fs::TempDir rootPath("/tmp/CsrEngineTest.RefreshTest.XXXXXX");
+  auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiPut(edges(1)));
+  CsrEngine csrEngine(
+      0, 1, kDefaultVIdLen, engine.get(), folly::stringPrintf("%s/edges.csr", rootPath.path()));
+
+  auto prefix = NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "1");
+  auto tagKey = NebulaKeyUtils::tagKey(kDefaultVIdLen, 1, "1", 3);
+  auto count = [&]() {
+    std::unique_ptr<KVIterator> iter;
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, csrEngine.prefix(prefix, &iter));
+    return collect(std::move(iter)).size();
+  };
+  ASSERT_TRUE(csrEngine.refresh());
+  EXPECT_EQ(18, count());
+
+  // The changes are seen after the next refresh
+  auto edgeKey = NebulaKeyUtils::edgeKey(kDefaultVIdLen, 1, "1", 1, 5, "30");
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->put(edgeKey, "new"));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->put(tagKey, "tag"));
+  std::unique_ptr<KVIterator> iter;
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, csrEngine.prefix(prefix, &iter));
+  std::string val;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND, csrEngine.get(tagKey, &val));
+  EXPECT_EQ(18, count());
+
+  ASSERT_TRUE(csrEngine.refresh());
+  EXPECT_EQ(19, count());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, csrEngine.get(tagKey, &val));
+  EXPECT_EQ("tag", val);
+  // The iterator got before goes on with the old snapshot
+  EXPECT_EQ(18, collect(std::move(iter)).size());
+
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->remove(edgeKey));
+  EXPECT_EQ(19, count());
+  csrEngine.clear();
+  EXPECT_EQ(18, count());
+}
+
+}  // namespace kvstore
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+
+  return RUN_ALL_TESTS();
+}
@@ -5,6 +5,9 @@
  */
 
 #include <gtest/gtest.h>
+#include <sys/sysmacros.h>
+
+#include <fstream>
 
 #include "common/base/Base.h"
 #include "common/fs/FileUtils.h"
@@ -178,6 +181,46 @@ TEST(DiskManagerTest, GetDiskPartsTest) {
   ASSERT_EQ(10, diskParts[spaceId2][path3].get_part_list().size());
 }
 
+TEST(DiskManagerTest, DiskStatsTest) {
+  fs::TempDir dir("/tmp/disk_man_test.XXXXXX");
+  auto file = folly::stringPrintf("%s/diskstats", dir.path());
+  {
+    std::ofstream out(file);
+    out << "   8       0 sda 100 0 2000 50 300 0 4000 60 0 700 110 0 0 0 0\n"
+        << " 259       1 nvme0n1p1 10 1 20 3 40 5 60 7 1 900 1000\n";
+  }
+  DiskManager::DiskIoStats stats;
+  ASSERT_TRUE(DiskManager::readDiskStats(makedev(259, 1), stats, file));
+  EXPECT_EQ(20, stats.readSectors);
+  EXPECT_EQ(60, stats.writeSectors);
+  EXPECT_EQ(900, stats.ioTicksMs);
+  ASSERT_TRUE(DiskManager::readDiskStats(makedev(8, 0), stats, file));
+  EXPECT_EQ(2000, stats.readSectors);
+  EXPECT_EQ(4000, stats.writeSectors);
+  EXPECT_EQ(700, stats.ioTicksMs);
+  EXPECT_FALSE(DiskManager::readDiskStats(makedev(8, 1), stats, file));
+
+  GraphSpaceID spaceId = 1;
+  fs::TempDir disk1("/tmp/disk_man_test.XXXXXX");
+  auto path1 = folly::stringPrintf("%s/nebula/%d", disk1.path(), spaceId);
+  boost::filesystem::create_directories(path1);
+  fs::TempDir disk2("/tmp/disk_man_test.XXXXXX");
+  auto path2 = folly::stringPrintf("%s/nebula/%d", disk2.path(), spaceId);
+  boost::filesystem::create_directories(path2);
+  DiskManager diskMan({disk1.path(), disk2.path()});
+  diskMan.freeBytes_[0] = FLAGS_minimum_reserved_bytes;
+  diskMan.freeBytes_[1] = FLAGS_minimum_reserved_bytes;
+  diskMan.addPartToPath(spaceId, 1, path1);
+  // The path with less parts
+  EXPECT_EQ(1, diskMan.pickDataPath(spaceId));
+  // The path not busy
+  diskMan.ioUtil_[1] = 100;
+  EXPECT_EQ(0, diskMan.pickDataPath(spaceId));
+  // The path with enough space
+  diskMan.freeBytes_[0] = 0;
+  EXPECT_EQ(1, diskMan.pickDataPath(spaceId));
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
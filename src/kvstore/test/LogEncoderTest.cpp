@@ -130,6 +130,7 @@ TEST(LogEncoderTest, BatchTest) {
   helper->put("put_key", "put_value");
   helper->rangeRemove("begin", "end");
   helper->put("put_key_again", "put_value_again");
+  helper->merge("merge_key", "operand");
 
   auto encoded = encodeBatchValue(helper->getBatch());
   auto decoded = decodeBatchValue(encoded.c_str());
@@ -144,9 +145,72 @@ TEST(LogEncoderTest, BatchTest) {
   expected.emplace_back(
       OP_BATCH_PUT,
       std::pair<folly::StringPiece, folly::StringPiece>("put_key_again", "put_value_again"));
+  expected.emplace_back(OP_BATCH_MERGE,
+                        std::pair<folly::StringPiece, folly::StringPiece>("merge_key", "operand"));
   ASSERT_EQ(expected, decoded);
 }
 
+TEST(LogEncoderTest, MergeTest) {
+  std::vector<std::string> logs;
+  logs.emplace_back(encodeMultiValues(OP_PUT, "put_key", "put_value"));
+  std::vector<KV> kvs = {{"k1", "v1"}, {"k2", "v2"}};
+  logs.emplace_back(encodeMultiValues(OP_MULTI_PUT, kvs));
+  logs.emplace_back(encodeSingleValue(OP_REMOVE, "remove"));
+  std::vector<std::string> keys = {"r1", "r2"};
+  logs.emplace_back(encodeMultiValues(OP_MULTI_REMOVE, keys));
+  logs.emplace_back(encodeMultiValues(OP_REMOVE_RANGE, "begin", "end"));
+  auto helper = std::make_unique<BatchHolder>();
+  helper->put("put_key", "put_value_again");
+  helper->merge("merge_key", "operand");
+  logs.emplace_back(encodeBatchValue(helper->getBatch()));
+
+  auto merged = mergeWriteLogs(logs);
+  ASSERT_EQ(OP_BATCH_WRITE, merged[sizeof(int64_t)]);
+  auto decoded = decodeBatchValue(merged);
+
+  using Op = std::pair<BatchLogType, std::pair<folly::StringPiece, folly::StringPiece>>;
+  std::vector<Op> expected = {
+      {OP_BATCH_PUT, {"put_key", "put_value"}},
+      {OP_BATCH_PUT, {"k1", "v1"}},
+      {OP_BATCH_PUT, {"k2", "v2"}},
+      {OP_BATCH_REMOVE, {"remove", ""}},
+      {OP_BATCH_REMOVE, {"r1", ""}},
+      {OP_BATCH_REMOVE, {"r2", ""}},
+      {OP_BATCH_REMOVE_RANGE, {"begin", "end"}},
+      {OP_BATCH_PUT, {"put_key", "put_value_again"}},
+      {OP_BATCH_MERGE, {"merge_key", "operand"}},
+  };
+  ASSERT_EQ(expected, decoded);
+}
+
+TEST(LogEncoderTest, CompressTest) {
+  std::vector<KV> kvs;
+  for (int32_t i = 0; i < 1000; i++) {
+    kvs.emplace_back(folly::stringPrintf("key_%d", i), std::string(100, 'v'));
+  }
+  auto log = encodeMultiValues(OP_MULTI_PUT, kvs);
+  FLAGS_raft_log_compression_threshold = 1024;
+  for (auto codec : {"lz4", "zstd"}) {
+    FLAGS_raft_log_compression = codec;
+    auto compressed = compressLog(std::string(log));
+    ASSERT_TRUE(isCompressedLog(compressed));
+    EXPECT_LT(compressed.size(), log.size());
+    EXPECT_EQ(getTimestamp(log), getTimestamp(compressed));
+    EXPECT_EQ(log, decompressLog(compressed));
+  }
+
+  // The small logs and the logs of the membership changes are not compressed
+  auto small = encodeMultiValues(OP_PUT, "key", "value");
+  EXPECT_EQ(small, compressLog(std::string(small)));
+  FLAGS_raft_log_compression_threshold = 0;
+  auto host = encodeHost(OP_ADD_LEARNER, HostAddr("1.1.1.1", 1));
+  EXPECT_EQ(host, compressLog(std::string(host)));
+
+  FLAGS_raft_log_compression = "none";
+  EXPECT_FALSE(isCompressedLog(compressLog(std::string(log))));
+  FLAGS_raft_log_compression_threshold = 64 * 1024;
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
@@ -0,0 +1,234 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/ScopeGuard.h>
+#include <gtest/gtest.h>
+#include <rocksdb/db.h>
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include "common/utils/NebulaKeyUtils.h"
+#include "kvstore/MemoryEngine.h"
+
+DECLARE_int64(memory_engine_capacity_mb);
+
+namespace nebula {
+namespace kvstore {
+
+const int32_t kDefaultVIdLen = 8;
+
+static std::vector<KV> collect(std::unique_ptr<KVIterator> iter) {
+  std::vector<KV> data;
+  for (; iter->valid(); iter->next()) {
+    data.emplace_back(iter->key().str(), iter->val().str());
+  }
+  return data;
+}
+
+static std::vector<KV> data(int32_t from, int32_t to, const std::string& suffix = "") {
+  std::vector<KV> kvs;
+  for (auto i = from; i < to; i++) {
+    kvs.emplace_back(folly::sformat("key_{:03}", i), folly::sformat("val_{}{}", i, suffix));
+  }
+  return kvs;
+}
+
+TEST(MemoryEngineTest, SimpleTest) {
+  fs::TempDir rootPath("/tmp/MemoryEngineTest.SimpleTest.XXXXXX");
+  MemoryEngine engine(0, kDefaultVIdLen, rootPath.path());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.put("key", "val"));
+  std::string val;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.get("key", &val));
+  EXPECT_EQ("val", val);
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.put("key", "new"));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.get("key", &val));
+  EXPECT_EQ("new", val);
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.remove("key"));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND, engine.get("key", &val));
+
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.multiPut(data(0, 10)));
+  std::vector<std::string> values;
+  auto status = engine.multiGet({"key_001", "key_100", "key_009"}, &values);
+  ASSERT_EQ(3, status.size());
+  EXPECT_TRUE(status[0].ok());
+  EXPECT_EQ("val_1", values[0]);
+  EXPECT_TRUE(status[1].isKeyNotFound());
+  EXPECT_TRUE(status[2].ok());
+  EXPECT_EQ("val_9", values[2]);
+  EXPECT_GT(engine.usedBytes(), 0);
+}
+
+TEST(MemoryEngineTest, RangeTest) {
+  fs::TempDir rootPath("/tmp/MemoryEngineTest.RangeTest.XXXXXX");
+  MemoryEngine engine(0, kDefaultVIdLen, rootPath.path());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.multiPut(data(0, 30)));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.put("other", "val"));
+
+  std::unique_ptr<KVIterator> iter;
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.range("key_005", "key_015", &iter));
+  EXPECT_EQ(data(5, 15), collect(std::move(iter)));
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.prefix("key_01", &iter));
+  EXPECT_EQ(data(10, 20), collect(std::move(iter)));
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.rangeWithPrefix("key_025", "key_", &iter));
+  EXPECT_EQ(data(25, 30), collect(std::move(iter)));
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.scan(&iter));
+  EXPECT_EQ(31, collect(std::move(iter)).size());
+
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.prefix("key_", &iter));
+  iter->seek("key_017");
+  ASSERT_TRUE(iter->valid());
+  EXPECT_EQ("key_017", iter->key());
+  iter->prev();
+  ASSERT_TRUE(iter->valid());
+  EXPECT_EQ("key_016", iter->key());
+
+  // The removed keys are skipped
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.removeRange("key_010", "key_020"));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.remove("key_025"));
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.prefix("key_", &iter));
+  auto expected = data(0, 10);
+  auto rest = data(20, 30);
+  rest.erase(rest.begin() + 5);
+  expected.insert(expected.end(), rest.begin(), rest.end());
+  EXPECT_EQ(expected, collect(std::move(iter)));
+}
+
+TEST(MemoryEngineTest, BatchTest) {
+  fs::TempDir rootPath("/tmp/MemoryEngineTest.BatchTest.XXXXXX");
+  MemoryEngine engine(0, kDefaultVIdLen, rootPath.path());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.multiPut(data(0, 10)));
+  auto batch = engine.startBatchWrite();
+  batch->put("key_100", "val_100");
+  batch->removeRange("key_000", "key_005");
+  batch->remove("key_100");
+  batch->put("key_003", "new");
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+            engine.commitBatchWrite(std::move(batch), false, false, true));
+
+  std::unique_ptr<KVIterator> iter;
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.prefix("key_", &iter));
+  auto expected = data(5, 10);
+  expected.insert(expected.begin(), KV("key_003", "new"));
+  EXPECT_EQ(expected, collect(std::move(iter)));
+
+  // Nothing is written without a merge operator
+  batch = engine.startBatchWrite();
+  batch->put("key_200", "val");
+  batch->merge("key_003", "operand");
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_UNSUPPORTED,
+            engine.commitBatchWrite(std::move(batch), false, false, true));
+  std::string val;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND, engine.get("key_200", &val));
+}
+
+TEST(MemoryEngineTest, SnapshotTest) {
+  fs::TempDir rootPath("/tmp/MemoryEngineTest.SnapshotTest.XXXXXX");
+  MemoryEngine engine(0, kDefaultVIdLen, rootPath.path());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.multiPut(data(0, 10)));
+  const auto* snapshot = engine.GetSnapshot();
+  std::unique_ptr<KVIterator> iter;
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.prefix("key_", &iter));
+
+  // Overwrite the keys many times, the versions read by the snapshot are kept
+  for (int32_t round = 0; round < 300; round++) {
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+              engine.multiPut(data(0, 10, folly::sformat("_{}", round))));
+  }
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.removeRange("key_000", "key_005"));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.compact());
+
+  std::string val;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.get("key_001", &val, snapshot));
+  EXPECT_EQ("val_1", val);
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND, engine.get("key_001", &val));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.get("key_007", &val));
+  EXPECT_EQ("val_7_299", val);
+  EXPECT_EQ(data(0, 10), collect(std::move(iter)));
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+            engine.range("key_000", "key_100", &iter, snapshot));
+  EXPECT_EQ(data(0, 10), collect(std::move(iter)));
+
+  // Only the latest versions are left once the snapshot is released
+  auto used = engine.usedBytes();
+  engine.ReleaseSnapshot(snapshot);
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.compact());
+  EXPECT_LT(engine.usedBytes(), used);
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.prefix("key_", &iter));
+  EXPECT_EQ(data(5, 10, "_299"), collect(std::move(iter)));
+  auto numKeys = engine.getProperty("rocksdb.estimate-num-keys");
+  ASSERT_TRUE(ok(numKeys));
+  EXPECT_EQ("5", value(numKeys));
+}
+
+TEST(MemoryEngineTest, CapacityTest) {
+  FLAGS_memory_engine_capacity_mb = 1;
+  SCOPE_EXIT {
+    FLAGS_memory_engine_capacity_mb = 0;
+  };
+  fs::TempDir rootPath("/tmp/MemoryEngineTest.CapacityTest.XXXXXX");
+  MemoryEngine engine(0, kDefaultVIdLen, rootPath.path());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.admitWrite(1024));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.put("small", "val"));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_WRITE_STALLED, engine.admitWrite(2 * 1024 * 1024));
+
+  // The writes admitted before are always applied, even if they go beyond the capacity
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+            engine.put("large", std::string(2 * 1024 * 1024, 'x')));
+  std::string val;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.get("large", &val));
+  EXPECT_LT(1024 * 1024, engine.usedBytes());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_WRITE_STALLED, engine.admitWrite(0));
+
+  // The writes are admitted again once the memory is freed
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.remove("large"));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.compact());
+  EXPECT_GT(1024 * 1024, engine.usedBytes());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.admitWrite(1024));
+}
+
+TEST(MemoryEngineTest, RecoverTest) {
+  fs::TempDir rootPath("/tmp/MemoryEngineTest.RecoverTest.XXXXXX");
+  {
+    MemoryEngine engine(1, kDefaultVIdLen, rootPath.path());
+    engine.addPart(1, Peers());
+    engine.addPart(2, Peers());
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.multiPut(data(0, 100)));
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.remove("key_050"));
+    engine.stop();
+    // The writes after the checkpoint are replayed from the wal
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.put("key_200", "val"));
+  }
+  MemoryEngine engine(1, kDefaultVIdLen, rootPath.path());
+  EXPECT_EQ(2, engine.totalPartsNum());
+  std::string val;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.get(NebulaKeyUtils::dataVersionKey(), &val));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND, engine.get("key_200", &val));
+  std::unique_ptr<KVIterator> iter;
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.prefix("key_", &iter));
+  auto expected = data(0, 100);
+  expected.erase(expected.begin() + 50);
+  EXPECT_EQ(expected, collect(std::move(iter)));
+
+  // The checkpoint is a rocksdb instance
+  auto checkpointPath = folly::sformat("{}/checkpoint", rootPath.path());
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine.createCheckpoint(checkpointPath));
+  rocksdb::DB* db = nullptr;
+  ASSERT_TRUE(rocksdb::DB::OpenForReadOnly(rocksdb::Options(), checkpointPath, &db).ok());
+  std::unique_ptr<rocksdb::DB> guard(db);
+  EXPECT_TRUE(db->Get(rocksdb::ReadOptions(), "key_099", &val).ok());
+  EXPECT_EQ("val_99", val);
+  EXPECT_TRUE(db->Get(rocksdb::ReadOptions(), "key_050", &val).IsNotFound());
+}
+
+}  // namespace kvstore
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+
+  return RUN_ALL_TESTS();
+}
@@ -15,6 +15,7 @@
 #include "kvstore/NebulaStore.h"
 #include "kvstore/PartManager.h"
 #include "kvstore/wal/AtomicLogBuffer.h"
+#include "kvstore/wal/FileBasedWal.h"
 #include "meta/ActiveHostsMan.h"
 
 DECLARE_uint32(raft_heartbeat_interval_secs);
@@ -559,7 +560,7 @@ TEST_P(ListenerAdvanceTest, ListenerResetBySnapshotTest) {
     // leader has trigger cleanWAL at this point, so firstLogId in wal will > 1
     CHECK_GT(part->wal()->firstLogId(), 1);
     // clean the wal buffer to make sure snapshot will be pulled
-    part->wal()->buffer()->reset();
+    std::dynamic_pointer_cast<wal::FileBasedWal>(part->wal())->buffer()->reset();
   }
 
   for (int32_t partId = 1; partId <= partCount_; partId++) {
@@ -634,7 +635,7 @@ TEST_P(ListenerSnapshotTest, SnapshotRateLimitTest) {
     // leader has trigger cleanWAL at this point, so firstLogId in wal will > 1
     CHECK_GT(part->wal()->firstLogId(), 1);
     // clean the wal buffer to make sure snapshot will be pulled
-    part->wal()->buffer()->reset();
+    std::dynamic_pointer_cast<wal::FileBasedWal>(part->wal())->buffer()->reset();
   }
 
   for (int32_t partId = 1; partId <= partCount_; partId++) {
@@ -3,6 +3,7 @@
  * This source code is licensed under Apache 2.0 License.
  */
 
+#include <folly/ScopeGuard.h>
 #include <gtest/gtest.h>
 #include <rocksdb/db.h>
 #include <thrift/lib/cpp/concurrency/ThreadManager.h>
@@ -14,7 +15,11 @@
 #include "common/fs/TempDir.h"
 #include "common/meta/Common.h"
 #include "common/network/NetworkUtils.h"
+#include "common/time/WallClock.h"
+#include "common/utils/NebulaKeyUtils.h"
+#include "common/utils/OperationKeyUtils.h"
 #include "kvstore/LogEncoder.h"
+#include "kvstore/NebulaSnapshotManager.h"
 #include "kvstore/NebulaStore.h"
 #include "kvstore/PartManager.h"
 #include "kvstore/RocksEngine.h"
@@ -23,6 +28,16 @@
 
 DECLARE_uint32(raft_heartbeat_interval_secs);
 DECLARE_bool(auto_remove_invalid_space);
+DECLARE_bool(engine_per_part);
+DECLARE_int32(drop_engine_delay_secs);
+DECLARE_string(memory_engine_spaces);
+DECLARE_int64(memory_engine_capacity_mb);
+DECLARE_bool(coalesce_part_writes);
+DECLARE_uint32(max_coalesced_writes);
+DECLARE_uint64(max_coalesced_write_bytes);
+DECLARE_uint32(snapshot_part_rate_limit);
+DECLARE_uint32(snapshot_batch_size);
+DECLARE_int64(snapshot_host_rate_limit);
 const int32_t kDefaultVidLen = 8;
 using nebula::meta::PartHosts;
 
@@ -1165,6 +1180,315 @@ TEST(NebulaStoreTest, RemoveInvalidSpaceTest) {
   CHECK(boost::filesystem::exists(space2));
 }
 
+TEST(NebulaStoreTest, CloneSpaceTest) {
+  fs::TempDir dataPath("/tmp/nebula_clone_space_test.XXXXXX");
+  auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+  auto initStore = [&](const std::vector<GraphSpaceID>& spaces) {
+    auto partMan = std::make_unique<MemPartManager>();
+    for (auto spaceId : spaces) {
+      for (auto partId = 1; partId <= 2; partId++) {
+        partMan->partsMap_[spaceId][partId] = PartHosts();
+      }
+    }
+    KVOptions options;
+    options.dataPaths_ = {dataPath.path()};
+    options.partMan_ = std::move(partMan);
+    HostAddr local = {"", 0};
+    auto store =
+        std::make_unique<NebulaStore>(std::move(options), ioThreadPool, local, getHandlers());
+    store->init();
+    sleep(1);
+    return store;
+  };
+  auto put = [](NebulaStore* store, GraphSpaceID spaceId, PartitionID partId, std::string val) {
+    folly::Baton<true, std::atomic> baton;
+    store->asyncMultiPut(
+        spaceId, partId, {{"key", std::move(val)}}, [&](nebula::cpp2::ErrorCode code) {
+          EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+          baton.post();
+        });
+    baton.wait();
+  };
+  auto get = [](NebulaStore* store, GraphSpaceID spaceId, PartitionID partId) {
+    std::string val;
+    auto code = store->get(spaceId, partId, "key", &val);
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+    return val;
+  };
+
+  {
+    auto store = initStore({1});
+    put(store.get(), 1, 1, "val_1");
+    put(store.get(), 1, 2, "val_2");
+
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, store->cloneSpace(1, 2));
+    // The data of space 2 has been cloned
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_EXISTED, store->cloneSpace(1, 2));
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_SPACE_NOT_FOUND, store->cloneSpace(3, 4));
+
+    // A clone which is not added as a space could be dropped
+    auto space3 = folly::stringPrintf("%s/nebula/%d", dataPath.path(), 3);
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, store->cloneSpace(1, 3));
+    CHECK(boost::filesystem::exists(space3));
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, store->dropClonedSpace(3));
+    CHECK(!boost::filesystem::exists(space3));
+    // The data of an added space is never dropped as a clone
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_EXISTED, store->dropClonedSpace(1));
+    CHECK(boost::filesystem::exists(folly::stringPrintf("%s/nebula/%d", dataPath.path(), 1)));
+  }
+  {
+    // The cloned space is opened with the data of the old one at restart
+    auto store = initStore({1, 2});
+    EXPECT_EQ(2, store->spaces_.size());
+    EXPECT_EQ("val_1", get(store.get(), 2, 1));
+    EXPECT_EQ("val_2", get(store.get(), 2, 2));
+
+    put(store.get(), 2, 1, "new_val");
+    EXPECT_EQ("new_val", get(store.get(), 2, 1));
+    EXPECT_EQ("val_1", get(store.get(), 1, 1));
+  }
+}
+
+TEST(NebulaStoreTest, CoalescedWritesTest) {
+  FLAGS_coalesce_part_writes = true;
+  FLAGS_max_coalesced_writes = 8;
+  FLAGS_max_coalesced_write_bytes = 4096;
+  SCOPE_EXIT {
+    FLAGS_coalesce_part_writes = false;
+    FLAGS_max_coalesced_writes = 256;
+    FLAGS_max_coalesced_write_bytes = 4 * 1024 * 1024;
+  };
+  auto partMan = std::make_unique<MemPartManager>();
+  auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+  partMan->partsMap_[1][1] = PartHosts();
+
+  fs::TempDir dataPath("/tmp/nebula_coalesced_writes_test.XXXXXX");
+  KVOptions options;
+  options.dataPaths_ = {dataPath.path()};
+  options.partMan_ = std::move(partMan);
+  HostAddr local = {"", 0};
+  auto store =
+      std::make_unique<NebulaStore>(std::move(options), ioThreadPool, local, getHandlers());
+  store->init();
+  sleep(FLAGS_raft_heartbeat_interval_secs);
+
+  // The writes to the same key are issued without waiting, some of them larger than the byte cap
+  const int32_t kWrites = 200;
+  std::atomic<int32_t> succeeded{0};
+  folly::Baton<true, std::atomic> baton;
+  auto callback = [&](nebula::cpp2::ErrorCode code) {
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+    if (++succeeded == kWrites + 1) {
+      baton.post();
+    }
+  };
+  auto value = [](int32_t i) {
+    auto val = folly::stringPrintf("val_%d", i);
+    if (i % 50 == 0) {
+      val.append(8192, 'v');
+    }
+    return val;
+  };
+  for (auto i = 0; i < kWrites; i++) {
+    auto val = value(i);
+    std::vector<KV> kvs = {{"key", val}, {folly::stringPrintf("key_%d", i), val}};
+    store->asyncMultiPut(1, 1, std::move(kvs), callback);
+  }
+  // The atomic op is applied after all the writes before it
+  std::string seen;
+  store->asyncAtomicOp(
+      1,
+      1,
+      [&] {
+        MergeableAtomicOpResult ret;
+        ret.code = store->get(1, 1, "key", &seen);
+        BatchHolder batchHolder;
+        batchHolder.put("key", "atomic");
+        ret.batch = encodeBatchValue(batchHolder.getBatch());
+        return ret;
+      },
+      callback);
+  baton.wait();
+  EXPECT_EQ(value(kWrites - 1), seen);
+
+  std::string val;
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, store->get(1, 1, "key", &val));
+  EXPECT_EQ("atomic", val);
+  for (auto i = 0; i < kWrites; i++) {
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+              store->get(1, 1, folly::stringPrintf("key_%d", i), &val));
+    EXPECT_EQ(value(i), val);
+  }
+}
+
+TEST(NebulaStoreTest, OperationLogOrderTest) {
+  auto partMan = std::make_unique<MemPartManager>();
+  auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+  partMan->partsMap_[1][1] = PartHosts();
+
+  fs::TempDir dataPath("/tmp/nebula_operation_log_test.XXXXXX");
+  KVOptions options;
+  options.dataPaths_ = {dataPath.path()};
+  options.partMan_ = std::move(partMan);
+  HostAddr local = {"", 0};
+  auto store =
+      std::make_unique<NebulaStore>(std::move(options), ioThreadPool, local, getHandlers());
+  store->init();
+  sleep(1);
+
+  auto write = [&store](std::string opKey, std::string val) {
+    BatchHolder batchHolder;
+    batchHolder.put(std::move(opKey), std::move(val));
+    folly::Baton<true, std::atomic> baton;
+    store->asyncAppendBatch(
+        1, 1, encodeBatchValue(batchHolder.getBatch()), [&baton](nebula::cpp2::ErrorCode code) {
+          EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+          baton.post();
+        });
+    baton.wait();
+  };
+  // The operation generated earlier is committed later, e.g. by a leader with a faster clock
+  auto first = OperationKeyUtils::modifyOperationKey(1, "first");
+  auto second = OperationKeyUtils::deleteOperationKey(1, "second");
+  ASSERT_LT(first, second);
+  write(second, "second");
+  write(first, "first");
+
+  std::unique_ptr<KVIterator> iter;
+  auto code = store->prefix(1, 1, OperationKeyUtils::operationPrefix(1), &iter);
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+  // The operations are replayed in the order they are committed
+  std::vector<std::string> vals;
+  for (; iter->valid(); iter->next()) {
+    vals.emplace_back(iter->val().str());
+  }
+  EXPECT_EQ((std::vector<std::string>{"second", "first"}), vals);
+}
+
+TEST(NebulaStoreTest, EnginePerPartTest) {
+  FLAGS_engine_per_part = true;
+  FLAGS_drop_engine_delay_secs = 1;
+  GraphSpaceID spaceId = 1;
+  fs::TempDir dataPath("/tmp/nebula_store_test.XXXXXX");
+  auto partDir = [&](PartitionID partId) {
+    return folly::stringPrintf("%s/nebula/%d/parts/%d", dataPath.path(), spaceId, partId);
+  };
+
+  auto test = [&](const std::vector<PartitionID>& parts, bool insertData) {
+    auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+    auto partMan = std::make_unique<MemPartManager>();
+    for (auto partId : parts) {
+      partMan->partsMap_[spaceId][partId] = PartHosts();
+    }
+
+    KVOptions options;
+    options.dataPaths_ = {dataPath.path()};
+    options.partMan_ = std::move(partMan);
+    HostAddr local = {"", 0};
+    auto store =
+        std::make_unique<NebulaStore>(std::move(options), ioThreadPool, local, getHandlers());
+    store->init();
+    while (true) {
+      std::unordered_map<GraphSpaceID, std::vector<meta::cpp2::LeaderInfo>> leaderIds;
+      if (store->allLeader(leaderIds) == static_cast<int32_t>(parts.size())) {
+        break;
+      }
+      usleep(100000);
+    }
+
+    // The shared engine of the data path and one for each part
+    ASSERT_EQ(parts.size() + 1, store->spaces_[spaceId]->engines_.size());
+    for (auto partId : parts) {
+      auto* engine = nebula::value(store->part(spaceId, partId))->engine();
+      EXPECT_EQ(partId, engine->dedicatedPart());
+      EXPECT_EQ(partDir(partId), engine->getDataRoot());
+      EXPECT_EQ(1, engine->totalPartsNum());
+    }
+
+    if (insertData) {
+      folly::Baton<true, std::atomic> baton;
+      store->asyncMultiPut(spaceId, 1, {{"key", "val"}}, [&](nebula::cpp2::ErrorCode code) {
+        EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+        baton.post();
+      });
+      baton.wait();
+
+      // The part is dropped with its engine, which is closed after the reads using it finish
+      std::unique_ptr<KVIterator> iter;
+      std::string prefix = NebulaKeyUtils::tagPrefix(parts.back());
+      ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+                store->prefix(spaceId, parts.back(), prefix, &iter));
+      store->removePart(spaceId, parts.back());
+      EXPECT_EQ(parts.size(), store->spaces_[spaceId]->engines_.size());
+      EXPECT_TRUE(fs::FileUtils::exist(partDir(parts.back())));
+      for (; iter->valid(); iter->next()) {
+      }
+      iter.reset();
+      sleep(FLAGS_drop_engine_delay_secs + 1);
+      EXPECT_FALSE(fs::FileUtils::exist(partDir(parts.back())));
+    }
+
+    std::string value;
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, store->get(spaceId, 1, "key", &value));
+    EXPECT_EQ("val", value);
+  };
+
+  test({1, 2, 3}, true);
+  // The engines of the parts are loaded from the data path
+  test({1, 2}, false);
+
+  FLAGS_engine_per_part = false;
+}
+
+TEST(NebulaStoreTest, MemorySpaceFullTest) {
+  FLAGS_memory_engine_spaces = "1";
+  FLAGS_memory_engine_capacity_mb = 1;
+  SCOPE_EXIT {
+    FLAGS_memory_engine_spaces = "";
+    FLAGS_memory_engine_capacity_mb = 0;
+  };
+  GraphSpaceID spaceId = 1;
+  fs::TempDir dataPath("/tmp/nebula_store_test.XXXXXX");
+  auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+  auto partMan = std::make_unique<MemPartManager>();
+  partMan->partsMap_[spaceId][1] = PartHosts();
+
+  KVOptions options;
+  options.dataPaths_ = {dataPath.path()};
+  options.partMan_ = std::move(partMan);
+  HostAddr local = {"", 0};
+  auto store =
+      std::make_unique<NebulaStore>(std::move(options), ioThreadPool, local, getHandlers());
+  store->init();
+  while (true) {
+    std::unordered_map<GraphSpaceID, std::vector<meta::cpp2::LeaderInfo>> leaderIds;
+    if (store->allLeader(leaderIds) == 1) {
+      break;
+    }
+    usleep(100000);
+  }
+
+  auto put = [&](std::vector<KV> data) {
+    folly::Baton<true, std::atomic> baton;
+    auto ret = nebula::cpp2::ErrorCode::SUCCEEDED;
+    store->asyncMultiPut(spaceId, 1, std::move(data), [&](nebula::cpp2::ErrorCode code) {
+      ret = code;
+      baton.post();
+    });
+    baton.wait();
+    return ret;
+  };
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, put({{"small", "val"}}));
+  // The write is rejected before being proposed, instead of failing when it's committed
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_WRITE_STALLED,
+            put({{"large", std::string(2 * 1024 * 1024, 'x')}}));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, put({{"another", "val"}}));
+
+  std::string value;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, store->get(spaceId, 1, "another", &value));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND, store->get(spaceId, 1, "large", &value));
+}
+
 TEST(NebulaStoreTest, BackupRestoreTest) {
   GraphSpaceID spaceId = 1;
   PartitionID partId = 1;
@@ -1248,6 +1572,76 @@ TEST(NebulaStoreTest, BackupRestoreTest) {
   FLAGS_rocksdb_backup_dir = "";
 }
 
+TEST(NebulaStoreTest, SnapshotHostRateLimitTest) {
+  gflags::FlagSaver flagSaver;
+  auto partMan = std::make_unique<MemPartManager>();
+  auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+  // space id : 1 , part id : 1, 2
+  partMan->partsMap_[1][1] = PartHosts();
+  partMan->partsMap_[1][2] = PartHosts();
+
+  fs::TempDir rootPath("/tmp/nebula_store_test.XXXXXX");
+  std::vector<std::string> paths;
+  paths.emplace_back(folly::stringPrintf("%s/disk1", rootPath.path()));
+
+  KVOptions options;
+  options.dataPaths_ = std::move(paths);
+  options.partMan_ = std::move(partMan);
+  HostAddr local = {"", 0};
+  auto store =
+      std::make_unique<NebulaStore>(std::move(options), ioThreadPool, local, getHandlers());
+  store->init();
+  sleep(FLAGS_raft_heartbeat_interval_secs);
+
+  // Put about 2.5MB into each part
+  for (PartitionID partId = 1; partId <= 2; partId++) {
+    std::vector<KV> data;
+    for (auto i = 0; i < 250; i++) {
+      data.emplace_back(NebulaKeyUtils::kvKey(partId, folly::stringPrintf("key_%d", i)),
+                        std::string(10 * 1024, 'v'));
+    }
+    folly::Baton<true, std::atomic> baton;
+    store->asyncMultiPut(1, partId, std::move(data), [&](nebula::cpp2::ErrorCode code) {
+      EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+      baton.post();
+    });
+    baton.wait();
+  }
+
+  // Each part alone is far below the part limit, but both of them share the host limit
+  FLAGS_snapshot_batch_size = 100 * 1024;
+  FLAGS_snapshot_part_rate_limit = 100 * 1024 * 1024;
+  FLAGS_snapshot_host_rate_limit = 1024 * 1024;
+  NebulaSnapshotManager snapshotMan(store.get());
+  auto now = time::WallClock::fastNowInSec();
+  std::vector<std::thread> threads;
+  std::array<int64_t, 2> sentCount{0, 0};
+  for (PartitionID partId = 1; partId <= 2; partId++) {
+    threads.emplace_back([&snapshotMan, &sentCount, partId] {
+      snapshotMan.accessAllRowsInSnapshot(
+          1,
+          partId,
+          [&sentCount, partId](LogID,
+                               TermID,
+                               const std::vector<std::string>&,
+                               int64_t totalCount,
+                               int64_t,
+                               raftex::SnapshotStatus status) {
+            EXPECT_NE(raftex::SnapshotStatus::FAILED, status);
+            sentCount[partId - 1] = totalCount;
+            return true;
+          });
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(250, sentCount[0]);
+  EXPECT_EQ(250, sentCount[1]);
+  // One part alone takes about 1.5 seconds after the burst, both of them take about 4 seconds
+  EXPECT_GE(time::WallClock::fastNowInSec() - now, 3);
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
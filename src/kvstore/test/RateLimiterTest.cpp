@@ -52,6 +52,63 @@ TEST(RateLimiter, RateLessThanBurst) {
   EXPECT_GE(time::WallClock::fastNowInSec() - now, 5);
 }
 
+TEST(RateLimiter, SharedByThreads) {
+  RateLimiter limiter;
+  auto now = time::WallClock::fastNowInSec();
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i < 2; i++) {
+    threads.emplace_back([&limiter] {
+      int64_t count = 0;
+      while (count++ < 25) {
+        limiter.consume(FLAGS_snapshot_part_rate_limit / 10,  // toConsume
+                        FLAGS_snapshot_part_rate_limit,       // rate
+                        FLAGS_snapshot_part_rate_limit);      // burstSize
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  // The budget is shared, so the two threads take as long as one thread consuming all
+  EXPECT_GE(time::WallClock::fastNowInSec() - now, 5);
+}
+
+TEST(RateLimiter, BackgroundIoLimiter) {
+  auto* limiter = BackgroundIoLimiter::instance();
+  {
+    // No limit by default
+    auto now = time::WallClock::fastNowInSec();
+    limiter->consume(IoClass::kStats, 1024L * 1024 * 1024);
+    EXPECT_LE(time::WallClock::fastNowInSec() - now, 1);
+  }
+  {
+    // A consume larger than the rate is waited for in pieces
+    FLAGS_stats_host_rate_limit = 1024 * 1024;
+    auto now = time::WallClock::fastNowInSec();
+    limiter->consume(IoClass::kStats, 5 * 1024 * 1024);
+    EXPECT_GE(time::WallClock::fastNowInSec() - now, 4);
+    FLAGS_stats_host_rate_limit = 0;
+  }
+  {
+    // The classes share the total budget
+    FLAGS_background_io_rate_limit = 1024 * 1024;
+    auto now = time::WallClock::fastNowInSec();
+    std::vector<std::thread> threads;
+    for (auto ioClass : {IoClass::kSnapshot, IoClass::kIngest}) {
+      threads.emplace_back([limiter, ioClass] {
+        for (int32_t i = 0; i < 25; i++) {
+          limiter->consume(ioClass, 1024 * 1024 / 10);
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    EXPECT_GE(time::WallClock::fastNowInSec() - now, 4);
+    FLAGS_background_io_rate_limit = 0;
+  }
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
@@ -208,6 +208,155 @@ TEST(RocksEngineConfigTest, KeyValueSeparationTest) {
   ASSERT_EQ(value, read_value);
 }
 
+TEST(RocksEngineConfigTest, SpaceBlockCacheTest) {
+  auto blockCache = [](const rocksdb::Options& options) {
+    return options.table_factory->GetOptions<rocksdb::BlockBasedTableOptions>()->block_cache;
+  };
+  {
+    FLAGS_rocksdb_space_block_cache = "100:abc";
+    rocksdb::Options options;
+    auto status = initRocksdbOptions(options, 100);
+    ASSERT_EQ(rocksdb::Status::kInvalidArgument, status.code());
+  }
+  {
+    // The reserved caches exceed the total one
+    FLAGS_rocksdb_space_block_cache = "100:64,101:4096";
+    rocksdb::Options options;
+    auto status = initRocksdbOptions(options, 100);
+    ASSERT_EQ(rocksdb::Status::kInvalidArgument, status.code());
+  }
+  {
+    FLAGS_rocksdb_space_block_cache = "100:64,101:32";
+    FLAGS_enable_space_block_cache_stats = true;
+    rocksdb::Options options100;
+    auto status = initRocksdbOptions(options100, 100);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    rocksdb::Options options101;
+    status = initRocksdbOptions(options101, 101);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    rocksdb::Options options102;
+    status = initRocksdbOptions(options102, 102);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    rocksdb::Options options103;
+    status = initRocksdbOptions(options103, 103);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+
+    EXPECT_EQ(64 * 1024 * 1024, blockCache(options100)->GetCapacity());
+    EXPECT_EQ(32 * 1024 * 1024, blockCache(options101)->GetCapacity());
+    // The spaces without reserved cache share the same one
+    EXPECT_EQ(blockCache(options102), blockCache(options103));
+    EXPECT_NE(blockCache(options100), blockCache(options102));
+    EXPECT_NE(nullptr, options100.statistics);
+
+    // The rocksdb instance could be opened with its own cache
+    rocksdb::DB* db = nullptr;
+    SCOPE_EXIT {
+      delete db;
+    };
+    fs::TempDir rootPath("/tmp/SpaceBlockCacheTest.XXXXXX");
+    status = rocksdb::DB::Open(options100, rootPath.path(), &db);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    ASSERT_TRUE(db->Put(rocksdb::WriteOptions(), "key", "value").ok());
+    ASSERT_TRUE(db->Flush(rocksdb::FlushOptions()).ok());
+    std::string value;
+    ASSERT_TRUE(db->Get(rocksdb::ReadOptions(), "key", &value).ok());
+    EXPECT_EQ("value", value);
+  }
+  FLAGS_rocksdb_space_block_cache = "";
+  FLAGS_enable_space_block_cache_stats = false;
+}
+
+TEST(RocksEngineConfigTest, CompressionDictTest) {
+  FLAGS_rocksdb_compression = "zstd";
+  FLAGS_rocksdb_compression_per_level = "";
+  {
+    FLAGS_rocksdb_space_compression_dict_bytes = "1:-1";
+    rocksdb::Options options;
+    auto status = initRocksdbOptions(options, 1);
+    ASSERT_EQ(rocksdb::Status::kInvalidArgument, status.code());
+  }
+  {
+    FLAGS_rocksdb_compression_dict_bytes = 16384;
+    FLAGS_rocksdb_space_compression_dict_bytes = "1:4096,2:0";
+    rocksdb::Options options1;
+    auto status = initRocksdbOptions(options1, 1);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    EXPECT_EQ(4096, options1.compression_opts.max_dict_bytes);
+    EXPECT_EQ(4096 * 100, options1.compression_opts.zstd_max_train_bytes);
+    EXPECT_EQ(4096, options1.bottommost_compression_opts.max_dict_bytes);
+    EXPECT_TRUE(options1.bottommost_compression_opts.enabled);
+    rocksdb::Options options2;
+    status = initRocksdbOptions(options2, 2);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    EXPECT_EQ(0, options2.compression_opts.max_dict_bytes);
+    rocksdb::Options options3;
+    status = initRocksdbOptions(options3, 3);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    EXPECT_EQ(16384, options3.compression_opts.max_dict_bytes);
+
+    // The sst files are written with the dictionaries trained
+    rocksdb::DB* db = nullptr;
+    SCOPE_EXIT {
+      delete db;
+    };
+    options1.create_if_missing = true;
+    fs::TempDir rootPath("/tmp/CompressionDictTest.XXXXXX");
+    status = rocksdb::DB::Open(options1, rootPath.path(), &db);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    for (int32_t i = 0; i < 1000; i++) {
+      auto key = folly::stringPrintf("key_%d", i);
+      ASSERT_TRUE(db->Put(rocksdb::WriteOptions(), key, "value_" + key).ok());
+    }
+    ASSERT_TRUE(db->Flush(rocksdb::FlushOptions()).ok());
+    ASSERT_TRUE(db->CompactRange(rocksdb::CompactRangeOptions(), nullptr, nullptr).ok());
+    std::string value;
+    ASSERT_TRUE(db->Get(rocksdb::ReadOptions(), "key_1", &value).ok());
+    EXPECT_EQ("value_key_1", value);
+  }
+  FLAGS_rocksdb_compression_dict_bytes = 0;
+  FLAGS_rocksdb_space_compression_dict_bytes = "";
+  FLAGS_rocksdb_compression = "snappy";
+}
+
+TEST(RocksEngineConfigTest, MemtableBudgetTest) {
+  FLAGS_rocksdb_memtable_budget = 16;
+  // The first space to create the write buffer manager has a reserved cache
+  FLAGS_rocksdb_space_block_cache = "1:16";
+  rocksdb::Options options1;
+  auto status = initRocksdbOptions(options1, 1);
+  ASSERT_TRUE(status.ok()) << status.ToString();
+  rocksdb::Options options2;
+  status = initRocksdbOptions(options2, 2);
+  ASSERT_TRUE(status.ok()) << status.ToString();
+
+  // The memtables of all the spaces share one budget, which is charged to the block cache
+  auto writeBufferManager = getWriteBufferManager();
+  ASSERT_NE(nullptr, writeBufferManager);
+  EXPECT_EQ(writeBufferManager, options1.write_buffer_manager);
+  EXPECT_EQ(writeBufferManager, options2.write_buffer_manager);
+  EXPECT_EQ(16 * 1024 * 1024, writeBufferManager->buffer_size());
+  EXPECT_TRUE(writeBufferManager->cost_to_cache());
+
+  rocksdb::DB* db = nullptr;
+  SCOPE_EXIT {
+    delete db;
+  };
+  fs::TempDir rootPath("/tmp/MemtableBudgetTest.XXXXXX");
+  status = rocksdb::DB::Open(options1, rootPath.path(), &db);
+  ASSERT_TRUE(status.ok()) << status.ToString();
+  ASSERT_TRUE(db->Put(rocksdb::WriteOptions(), "key", "value").ok());
+  EXPECT_GT(writeBufferManager->memory_usage(), 0);
+  // The memtables are charged to the shared cache, not to the reserved cache of the space
+  auto blockCache = [](const rocksdb::Options& options) {
+    return options.table_factory->GetOptions<rocksdb::BlockBasedTableOptions>()->block_cache;
+  };
+  ASSERT_NE(blockCache(options1), blockCache(options2));
+  EXPECT_EQ(0, blockCache(options1)->GetUsage());
+  EXPECT_GT(blockCache(options2)->GetUsage(), 0);
+  FLAGS_rocksdb_memtable_budget = 0;
+  FLAGS_rocksdb_space_block_cache = "";
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
@@ -3,6 +3,7 @@
  * This source code is licensed under Apache 2.0 License.
  */
 
+#include <folly/json.h>
 #include <folly/lang/Bits.h>
 #include <gtest/gtest.h>
 #include <rocksdb/db.h>
@@ -13,6 +14,7 @@
 #include "common/utils/NebulaKeyUtils.h"
 #include "kvstore/RocksEngine.h"
 #include "kvstore/RocksEngineConfig.h"
+#include "kvstore/RocksScanMode.h"
 
 namespace nebula {
 namespace kvstore {
@@ -77,6 +79,67 @@ TEST_P(RocksEngineTest, RangeTest) {
   checkRange(1, 15, 10, 5);
 }
 
+TEST_P(RocksEngineTest, RangeBoundTest) {
+  fs::TempDir rootPath("/tmp/rocksdb_engine_RangeBoundTest.XXXXXX");
+  auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+  std::vector<KV> data;
+  for (int32_t i = 10; i < 20; i++) {
+    data.emplace_back(folly::stringPrintf("key_%d", i), folly::stringPrintf("val_%d", i));
+  }
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiPut(std::move(data)));
+
+  // The bounds of the caller are gone before the iteration
+  std::unique_ptr<KVIterator> iter;
+  {
+    std::string start = "key_12";
+    std::string end = "key_15";
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->range(start, end, &iter));
+    start.assign(start.size(), '\xFF');
+    end.assign(end.size(), '\xFF');
+  }
+  std::vector<std::string> keys;
+  for (; iter->valid(); iter->next()) {
+    keys.emplace_back(iter->key().str());
+  }
+  EXPECT_EQ((std::vector<std::string>{"key_12", "key_13", "key_14"}), keys);
+}
+
+TEST_P(RocksEngineTest, ScanModeTest) {
+  fs::TempDir rootPath("/tmp/rocksdb_engine_ScanModeTest.XXXXXX");
+  auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+  std::vector<KV> data;
+  for (int32_t i = 0; i < 1000; i++) {
+    data.emplace_back(folly::stringPrintf("key_%04d", i), std::string(1024, 'v'));
+  }
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiPut(std::move(data)));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->flush());
+
+  auto count = [&]() {
+    std::unique_ptr<KVIterator> iter;
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->prefix("key_", &iter));
+    int32_t num = 0;
+    for (; iter->valid(); iter->next()) {
+      EXPECT_EQ(folly::stringPrintf("key_%04d", num), iter->key());
+      num++;
+    }
+    return num;
+  };
+  EXPECT_EQ(ScanMode::kDefault, ScanModeGuard::current());
+  {
+    ScanModeGuard longScan(ScanMode::kLong);
+    EXPECT_EQ(ScanMode::kLong, ScanModeGuard::current());
+    EXPECT_EQ(1000, count());
+    {
+      ScanModeGuard background(ScanMode::kBackground);
+      EXPECT_EQ(ScanMode::kBackground, ScanModeGuard::current());
+      EXPECT_EQ(1000, count());
+    }
+    EXPECT_EQ(ScanMode::kLong, ScanModeGuard::current());
+  }
+  EXPECT_EQ(ScanMode::kDefault, ScanModeGuard::current());
+  EXPECT_EQ(1000, count());
+}
+
 TEST_P(RocksEngineTest, PrefixTest) {
   fs::TempDir rootPath("/tmp/rocksdb_engine_PrefixTest.XXXXXX");
   auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
@@ -116,6 +179,49 @@ TEST_P(RocksEngineTest, PrefixTest) {
   checkPrefix("c", 20, 20);
 }
 
+TEST_P(RocksEngineTest, PrefixBoundTest) {
+  EXPECT_EQ("ab", RocksIterBound::ofPrefix("aa")->key);
+  EXPECT_EQ("b", RocksIterBound::ofPrefix("a\xFF\xFF")->key);
+  EXPECT_EQ(nullptr, RocksIterBound::ofPrefix("\xFF\xFF"));
+  EXPECT_EQ(nullptr, RocksIterBound::ofPrefix(""));
+
+  fs::TempDir rootPath("/tmp/rocksdb_engine_PrefixBoundTest.XXXXXX");
+  auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+  std::vector<KV> data;
+  for (int32_t i = 0; i < 10; i++) {
+    data.emplace_back(folly::stringPrintf("a\xFF%d", i), folly::stringPrintf("val_%d", i));
+    data.emplace_back(folly::stringPrintf("b_%d", i), folly::stringPrintf("val_%d", i));
+  }
+  data.emplace_back("\xFF\xFF", "last");
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiPut(std::move(data)));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->removeRange("b_0", "b_5"));
+
+  auto count = [](std::unique_ptr<KVIterator>& iter) {
+    int32_t num = 0;
+    for (; iter->valid(); iter->next()) {
+      num++;
+    }
+    return num;
+  };
+  std::unique_ptr<KVIterator> iter;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->prefix("a\xFF", &iter));
+  EXPECT_EQ(10, count(iter));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->prefix("b", &iter));
+  EXPECT_EQ(5, count(iter));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->prefix("\xFF", &iter));
+  EXPECT_EQ(1, count(iter));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->range("a", "b_7", &iter));
+  EXPECT_EQ(12, count(iter));
+
+  // The keys out of the prefix reached by seek and prev are still invalid
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->prefix("b", &iter));
+  EXPECT_TRUE(iter->valid());
+  iter->prev();
+  EXPECT_FALSE(iter->valid());
+  iter->seek("a");
+  EXPECT_FALSE(iter->valid());
+}
+
 TEST_P(RocksEngineTest, RemoveTest) {
   fs::TempDir rootPath("/tmp/rocksdb_engine_RemoveTest.XXXXXX");
   auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
@@ -198,6 +304,100 @@ TEST_P(RocksEngineTest, CompactTest) {
   EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->compact());
 }
 
+TEST_P(RocksEngineTest, CompactRangeTest) {
+  fs::TempDir rootPath("/tmp/rocksdb_engine_CompactRangeTest.XXXXXX");
+  auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+  std::vector<KV> data;
+  std::vector<std::string> keys;
+  for (auto dst = 0; dst < 10; dst++) {
+    auto key = NebulaKeyUtils::edgeKey(kDefaultVIdLen, 1, "1", 101, 0, std::to_string(dst));
+    data.emplace_back(key, "");
+    keys.emplace_back(std::move(key));
+  }
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiPut(std::move(data)));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->flush());
+  EXPECT_TRUE(engine->tombstoneRanges(0.3).empty());
+
+  // The file of the deletions is full of tombstones
+  keys.resize(5);
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiRemove(keys));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->flush());
+  if (FLAGS_rocksdb_table_format != "BlockBasedTable") {
+    return;
+  }
+  auto ranges = engine->tombstoneRanges(0.3);
+  ASSERT_EQ(1, ranges.size());
+  EXPECT_EQ(keys.front(), ranges.front().first);
+  EXPECT_EQ(keys.back(), ranges.front().second);
+
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+            engine->compactRange(ranges.front().first, ranges.front().second));
+  EXPECT_TRUE(engine->tombstoneRanges(0.3).empty());
+  std::unique_ptr<KVIterator> iter;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+            engine->prefix(NebulaKeyUtils::edgePrefix(1), &iter));
+  int32_t num = 0;
+  for (; iter->valid(); iter->next()) {
+    num++;
+  }
+  EXPECT_EQ(5, num);
+}
+
+TEST_P(RocksEngineTest, CompressionRatioTest) {
+  fs::TempDir rootPath("/tmp/rocksdb_engine_CompressionRatioTest.XXXXXX");
+  auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+  std::vector<KV> data;
+  for (int32_t i = 0; i < 1000; i++) {
+    data.emplace_back(folly::stringPrintf("key_%d", i), std::string(100, 'v'));
+  }
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiPut(std::move(data)));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->flush());
+  auto ret = engine->getProperty(RocksEngine::kCompressionRatio);
+  ASSERT_TRUE(ok(ret));
+  auto stats = folly::parseJson(value(ret));
+  EXPECT_LT(100 * 1000, stats["raw_bytes"].asInt());
+  EXPECT_LT(0, stats["data_bytes"].asInt());
+  EXPECT_LT(0.0, stats["ratio"].asDouble());
+}
+
+TEST_P(RocksEngineTest, KeyValueSeparationTest) {
+  if (FLAGS_rocksdb_table_format == "PlainTable") {
+    return;
+  }
+  FLAGS_rocksdb_enable_kv_separation = true;
+  FLAGS_rocksdb_kv_separation_threshold = 0;
+  fs::TempDir rootPath("/tmp/rocksdb_engine_KeyValueSeparationTest.XXXXXX");
+  auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+  std::vector<KV> data;
+  for (auto dst = 0; dst < 10; dst++) {
+    data.emplace_back(NebulaKeyUtils::edgeKey(kDefaultVIdLen, 1, "1", 101, 0, std::to_string(dst)),
+                      folly::stringPrintf("val_%d", dst));
+  }
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiPut(std::move(data)));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->flush());
+
+  // The values are stored in the blob files, the scans only reading the keys skip them
+  auto prefix = NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "1", 101);
+  std::unique_ptr<KVIterator> iter;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->prefix(prefix, &iter));
+  int32_t num = 0;
+  for (; iter->valid(); iter->next()) {
+    num++;
+  }
+  EXPECT_EQ(10, num);
+
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->prefix(prefix, &iter));
+  for (auto dst = 0; dst < 10; dst++, iter->next()) {
+    ASSERT_TRUE(iter->valid());
+    EXPECT_EQ(NebulaKeyUtils::edgeKey(kDefaultVIdLen, 1, "1", 101, 0, std::to_string(dst)),
+              iter->key());
+    EXPECT_EQ(folly::stringPrintf("val_%d", dst), iter->val());
+  }
+  EXPECT_FALSE(iter->valid());
+  FLAGS_rocksdb_enable_kv_separation = false;
+  FLAGS_rocksdb_kv_separation_threshold = 100;
+}
+
 TEST_P(RocksEngineTest, IngestTest) {
   if (FLAGS_rocksdb_table_format == "PlainTable") {
     return;
@@ -227,6 +427,136 @@ TEST_P(RocksEngineTest, IngestTest) {
   EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND, engine->get("key_not_exist", &result));
 }
 
+TEST_P(RocksEngineTest, SeparateColumnFamiliesTest) {
+  if (FLAGS_rocksdb_table_format == "PlainTable") {
+    return;
+  }
+  FLAGS_rocksdb_separate_column_families = true;
+  fs::TempDir rootPath("/tmp/rocksdb_engine_SeparateColumnFamiliesTest.XXXXXX");
+  GraphSpaceID spaceId = 1;
+  PartitionID partId = 1;
+  auto tagKey = NebulaKeyUtils::tagKey(kDefaultVIdLen, partId, "vertex", 1);
+  auto edgeKey = NebulaKeyUtils::edgeKey(kDefaultVIdLen, partId, "src", 1, 0, "dst");
+  auto otherTagKey = NebulaKeyUtils::tagKey(kDefaultVIdLen, partId, "other", 1);
+  auto otherEdgeKey = NebulaKeyUtils::edgeKey(kDefaultVIdLen, partId, "other", 1, 0, "dst");
+
+  auto countPrefix = [](RocksEngine* engine, const std::string& prefix) {
+    std::unique_ptr<KVIterator> iter;
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->prefix(prefix, &iter));
+    size_t num = 0;
+    for (; iter->valid(); iter->next()) {
+      num++;
+    }
+    return num;
+  };
+
+  {
+    auto engine = std::make_unique<RocksEngine>(spaceId, kDefaultVIdLen, rootPath.path());
+    engine->addPart(partId, Peers());
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->put(tagKey, "tag"));
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->put(edgeKey, "edge"));
+    EXPECT_EQ(1, countPrefix(engine.get(), NebulaKeyUtils::tagPrefix(partId)));
+    EXPECT_EQ(1, countPrefix(engine.get(), NebulaKeyUtils::edgePrefix(partId)));
+    EXPECT_EQ(std::vector<PartitionID>{partId}, engine->allParts());
+
+    // A batch not built by the engine is routed to the column families as well
+    auto batch = std::make_unique<RocksWriteBatch>();
+    batch->remove(tagKey);
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+              engine->commitBatchWrite(std::move(batch), false, false, true));
+    EXPECT_EQ(0, countPrefix(engine.get(), NebulaKeyUtils::tagPrefix(partId)));
+
+    // An sst file with both tag and edge keys
+    rocksdb::Options options;
+    rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), options);
+    auto file = folly::stringPrintf("%s/%s", rootPath.path(), "data.sst");
+    ASSERT_TRUE(writer.Open(file).ok());
+    ASSERT_TRUE(writer.Put(otherTagKey, "tag").ok());
+    ASSERT_TRUE(writer.Put(otherEdgeKey, "edge").ok());
+    writer.Finish();
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->ingest({file}));
+    EXPECT_EQ(1, countPrefix(engine.get(), NebulaKeyUtils::tagPrefix(partId)));
+    EXPECT_EQ(2, countPrefix(engine.get(), NebulaKeyUtils::edgePrefix(partId)));
+  }
+
+  std::vector<std::string> names;
+  auto path = folly::stringPrintf("%s/nebula/%d/data", rootPath.path(), spaceId);
+  ASSERT_TRUE(rocksdb::DB::ListColumnFamilies(rocksdb::Options(), path, &names).ok());
+  EXPECT_EQ(RocksColumnFamilies::kNum, names.size());
+
+  // The column families are still opened once separated
+  FLAGS_rocksdb_separate_column_families = false;
+  auto engine = std::make_unique<RocksEngine>(spaceId, kDefaultVIdLen, rootPath.path());
+  std::string val;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->get(edgeKey, &val));
+  EXPECT_EQ("edge", val);
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->get(otherTagKey, &val));
+  EXPECT_EQ("tag", val);
+}
+
+TEST_P(RocksEngineTest, SeparateExistingColumnFamiliesTest) {
+  if (FLAGS_rocksdb_table_format == "PlainTable") {
+    return;
+  }
+  fs::TempDir rootPath("/tmp/rocksdb_engine_SeparateExistingColumnFamiliesTest.XXXXXX");
+  GraphSpaceID spaceId = 1;
+  PartitionID partId = 1;
+  auto tagKey = NebulaKeyUtils::tagKey(kDefaultVIdLen, partId, "vertex", 1);
+  {
+    FLAGS_rocksdb_separate_column_families = false;
+    auto engine = std::make_unique<RocksEngine>(spaceId, kDefaultVIdLen, rootPath.path());
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->put(tagKey, "tag"));
+  }
+
+  // The existing data are still in the default column family and visible
+  FLAGS_rocksdb_separate_column_families = true;
+  auto engine = std::make_unique<RocksEngine>(spaceId, kDefaultVIdLen, rootPath.path());
+  std::string val;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->get(tagKey, &val));
+  EXPECT_EQ("tag", val);
+  FLAGS_rocksdb_separate_column_families = false;
+
+  std::vector<std::string> names;
+  auto path = folly::stringPrintf("%s/nebula/%d/data", rootPath.path(), spaceId);
+  ASSERT_TRUE(rocksdb::DB::ListColumnFamilies(rocksdb::Options(), path, &names).ok());
+  EXPECT_EQ(1, names.size());
+}
+
+TEST_P(RocksEngineTest, MultiGetTest) {
+  if (FLAGS_rocksdb_table_format == "PlainTable") {
+    return;
+  }
+  FLAGS_rocksdb_separate_column_families = true;
+  fs::TempDir rootPath("/tmp/rocksdb_engine_MultiGetTest.XXXXXX");
+  PartitionID partId = 1;
+  auto engine = std::make_unique<RocksEngine>(1, kDefaultVIdLen, rootPath.path());
+  engine->addPart(partId, Peers());
+  auto tagKey1 = NebulaKeyUtils::tagKey(kDefaultVIdLen, partId, "1", 1);
+  auto tagKey2 = NebulaKeyUtils::tagKey(kDefaultVIdLen, partId, "2", 1);
+  auto edgeKey = NebulaKeyUtils::edgeKey(kDefaultVIdLen, partId, "1", 1, 0, "2");
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->put(tagKey1, "tag1"));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->put(tagKey2, "tag2"));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->put(edgeKey, "edge"));
+  FLAGS_rocksdb_separate_column_families = false;
+
+  // The keys are neither sorted nor in the same column family, the results are in input order
+  auto missed = NebulaKeyUtils::tagKey(kDefaultVIdLen, partId, "3", 1);
+  std::vector<std::string> keys = {tagKey2, edgeKey, missed, tagKey1, tagKey2};
+  std::vector<std::string> values;
+  auto status = engine->multiGet(keys, &values);
+  ASSERT_EQ(keys.size(), status.size());
+  ASSERT_EQ(keys.size(), values.size());
+  std::vector<std::string> expected = {"tag2", "edge", "", "tag1", "tag2"};
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (i == 2) {
+      EXPECT_TRUE(status[i].isKeyNotFound());
+    } else {
+      EXPECT_TRUE(status[i].ok());
+      EXPECT_EQ(expected[i], values[i]);
+    }
+  }
+}
+
 TEST_P(RocksEngineTest, BackupRestoreTable) {
   if (FLAGS_rocksdb_table_format == "PlainTable") {
     return;
@@ -529,6 +859,45 @@ TEST_P(RocksEngineTest, PrefixBloomTest) {
   }
 }
 
+TEST_P(RocksEngineTest, EdgeTypePrefixBloomTest) {
+  FLAGS_rocksdb_edge_type_prefix_filter = true;
+  SCOPE_EXIT {
+    FLAGS_rocksdb_edge_type_prefix_filter = false;
+  };
+  fs::TempDir rootPath("/tmp/rocksdb_engine_EdgeTypePrefixBloomTest.XXXXXX");
+  auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+
+  // Each edge type of the vertex is flushed into its own sst file
+  for (EdgeType edgeType = 101; edgeType <= 103; edgeType++) {
+    std::vector<KV> data;
+    for (auto dst = 0; dst < 10; dst++) {
+      data.emplace_back(
+          NebulaKeyUtils::edgeKey(kDefaultVIdLen, 1, "1", edgeType, 0, std::to_string(dst)), "");
+    }
+    data.emplace_back(NebulaKeyUtils::tagKey(kDefaultVIdLen, 1, "1", edgeType), "");
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiPut(std::move(data)));
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->flush());
+  }
+
+  auto count = [&engine](const std::string& prefix) {
+    std::unique_ptr<KVIterator> iter;
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->prefix(prefix, &iter));
+    int32_t num = 0;
+    for (; iter->valid(); iter->next()) {
+      num++;
+    }
+    return num;
+  };
+  for (EdgeType edgeType = 101; edgeType <= 103; edgeType++) {
+    EXPECT_EQ(10, count(NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "1", edgeType)));
+  }
+  EXPECT_EQ(0, count(NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "1", 104)));
+  // The prefixes shorter than the extractor don't use the filter
+  EXPECT_EQ(30, count(NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "1")));
+  EXPECT_EQ(30, count(NebulaKeyUtils::edgePrefix(1)));
+  EXPECT_EQ(3, count(NebulaKeyUtils::tagPrefix(kDefaultVIdLen, 1, "1")));
+}
+
 INSTANTIATE_TEST_SUITE_P(EnablePrefixExtractor_EnableWholeKeyFilter_TableFormat,
                          RocksEngineTest,
                          ::testing::Values(std::make_tuple(false, false, "BlockBasedTable"),
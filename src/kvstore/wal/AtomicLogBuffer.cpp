@@ -5,13 +5,62 @@
 
 #include "kvstore/wal/AtomicLogBuffer.h"
 
+#include "common/time/WallClock.h"
+
 DEFINE_int32(max_log_buffer_size,
              16 * 1024 * 1024,
              "Max atomic log buffer size, if the size exceeds it, will trigger gc");
+DEFINE_int64(wal_buffer_pool_size,
+             0,
+             "Max total bytes of the wal buffers of all parts, the buffered logs of the parts "
+             "written least recently are evicted when it's exceeded, 0 means no limit");
 
 namespace nebula {
 namespace wal {
 
+void LogBufferPool::add(AtomicLogBuffer* buffer) {
+  std::lock_guard<std::mutex> g(lock_);
+  buffers_.emplace(buffer);
+}
+
+void LogBufferPool::remove(AtomicLogBuffer* buffer) {
+  std::lock_guard<std::mutex> g(lock_);
+  buffers_.erase(buffer);
+}
+
+void LogBufferPool::evictIfNeeded() {
+  auto limit = FLAGS_wal_buffer_pool_size;
+  if (limit <= 0 || used() <= limit) {
+    return;
+  }
+  std::unique_lock<std::mutex> g(lock_, std::try_to_lock);
+  if (!g.owns_lock()) {
+    // Some one else is evicting
+    return;
+  }
+  std::vector<std::pair<int64_t, AtomicLogBuffer*>> buffers;
+  buffers.reserve(buffers_.size());
+  for (auto* buffer : buffers_) {
+    buffers.emplace_back(buffer->lastPushTime_.load(std::memory_order_relaxed), buffer);
+  }
+  std::sort(buffers.begin(), buffers.end());
+  int64_t evicted = 0;
+  size_t numBuffers = 0;
+  for (auto& buffer : buffers) {
+    if (used() <= limit) {
+      break;
+    }
+    // The buffers are not destroyed during eviction since they are unregistered first
+    auto bytes = buffer.second->evict();
+    if (bytes > 0) {
+      evicted += bytes;
+      numBuffers++;
+    }
+  }
+  VLOG(2) << "Evict " << evicted << " bytes of " << numBuffers << " wal buffers, " << used()
+          << " bytes are used now";
+}
+
 LogIterator& AtomicLogBuffer::Iterator::operator++() {
   currIndex_++;
   currLogId_++;
@@ -54,6 +103,8 @@ void AtomicLogBuffer::Iterator::seek(LogID logId) {
 }
 
 AtomicLogBuffer::~AtomicLogBuffer() {
+  LogBufferPool::instance().remove(this);
+  LogBufferPool::instance().update(-size_.load(std::memory_order_relaxed));
   auto refs = refs_.load(std::memory_order_acquire);
   CHECK_EQ(0, refs);
   auto* curr = head_.load(std::memory_order_relaxed);
@@ -69,6 +120,16 @@ AtomicLogBuffer::~AtomicLogBuffer() {
 }
 
 void AtomicLogBuffer::push(LogID logId, Record&& record) {
+  {
+    std::lock_guard<std::mutex> g(writeLock_);
+    pushInternal(logId, std::move(record));
+  }
+  lastPushTime_.store(time::WallClock::fastNowInMilliSec(), std::memory_order_relaxed);
+  // Evict after releasing the lock, so that the writers never wait for each other
+  LogBufferPool::instance().evictIfNeeded();
+}
+
+void AtomicLogBuffer::pushInternal(LogID logId, Record&& record) {
   auto* head = head_.load(std::memory_order_relaxed);
   auto recSize = record.size();
   if (head == nullptr || head->isFull() || head->markDeleted_.load(std::memory_order_relaxed)) {
@@ -84,41 +145,70 @@ void AtomicLogBuffer::push(LogID logId, Record&& record) {
     } else if (head != nullptr) {
       head->prev_.store(newNode, std::memory_order_release);
     }
-    size_.fetch_add(recSize, std::memory_order_relaxed);
+    updateSize(recSize);
     head_.store(newNode, std::memory_order_relaxed);
     return;
   }
   if (size_ + recSize > capacity_) {
-    auto* tail = tail_.load(std::memory_order_relaxed);
-    // todo(doodle): there is a potential problem is that: since Node::isFull
+    dropTail(head);
+  }
+  updateSize(recSize);
+  head->push_back(std::move(record));
+}
+
+bool AtomicLogBuffer::dropTail(Node* head) {
+  auto* tail = tail_.load(std::memory_order_relaxed);
+  // todo(doodle): there is a potential problem is that: since Node::isFull
     // is judged by log count, we can only add new node when previous node
     // has enough logs. So when tail is equal to head, we need to wait tail is
     // full, after head moves forward, at then tail can be marked as deleted.
     // So the log buffer would takes up more memory than its capacity. Since
-    // it does not affect correctness, we could fix it later if necessary.
-    if (tail != head) {
-      // We have more than one nodes in current list.
-      // So we mark the tail to be deleted.
-      bool expected = false;
-      VLOG(5) << "Mark node " << tail->firstLogId_ << " to be deleted!";
-      auto marked =
-          tail->markDeleted_.compare_exchange_strong(expected, true, std::memory_order_relaxed);
-      auto* prev = tail->prev_.load(std::memory_order_relaxed);
-      firstLogId_.store(prev->firstLogId_, std::memory_order_relaxed);
-      // All operations above SHOULD NOT be reordered.
-      tail_.store(tail->prev_, std::memory_order_release);
-      if (marked) {
-        size_.fetch_sub(tail->size_, std::memory_order_relaxed);
-        // dirtyNodes_ changes SHOULD after the tail move.
-        dirtyNodes_.fetch_add(1, std::memory_order_release);
-      }
+  // it does not affect correctness, we could fix it later if necessary.
+  if (tail == nullptr || tail == head) {
+    return false;
+  }
+  // We have more than one nodes in current list.
+  // So we mark the tail to be deleted.
+  bool expected = false;
+  VLOG(5) << "Mark node " << tail->firstLogId_ << " to be deleted!";
+  auto marked =
+      tail->markDeleted_.compare_exchange_strong(expected, true, std::memory_order_relaxed);
+  auto* prev = tail->prev_.load(std::memory_order_relaxed);
+  firstLogId_.store(prev->firstLogId_, std::memory_order_relaxed);
+  // All operations above SHOULD NOT be reordered.
+  tail_.store(tail->prev_, std::memory_order_release);
+  if (marked) {
+    updateSize(-tail->size_);
+    // dirtyNodes_ changes SHOULD after the tail move.
+    dirtyNodes_.fetch_add(1, std::memory_order_release);
+  }
+  return true;
+}
+
+int32_t AtomicLogBuffer::evict() {
+  int32_t bytes = 0;
+  {
+    std::unique_lock<std::mutex> g(writeLock_, std::try_to_lock);
+    if (!g.owns_lock()) {
+      // The buffer is being written, so it is not the cold one
+      return 0;
+    }
+    auto before = size_.load(std::memory_order_relaxed);
+    auto* head = head_.load(std::memory_order_relaxed);
+    while (dropTail(head)) {
     }
+    bytes = before - size_.load(std::memory_order_relaxed);
   }
-  size_.fetch_add(recSize, std::memory_order_relaxed);
-  head->push_back(std::move(record));
+  if (bytes > 0) {
+    // Delete the dropped nodes as a reader does if there is no other readers
+    addRef();
+    releaseRef(true);
+  }
+  return bytes;
 }
 
 void AtomicLogBuffer::reset() {
+  std::lock_guard<std::mutex> g(writeLock_);
   auto* p = head_.load(std::memory_order_relaxed);
   int32_t count = 0;
   while (p != nullptr) {
@@ -130,7 +220,7 @@ void AtomicLogBuffer::reset() {
     p = p->next_;
     ++count;
   }
-  size_.store(0, std::memory_order_relaxed);
+  LogBufferPool::instance().update(-size_.exchange(0, std::memory_order_relaxed));
   firstLogId_.store(0, std::memory_order_relaxed);
   dirtyNodes_.fetch_add(count, std::memory_order_release);
 }
@@ -164,7 +254,7 @@ Node* AtomicLogBuffer::seek(LogID logId) {
   return p->markDeleted_ ? nullptr : p;
 }
 
-void AtomicLogBuffer::releaseRef() {
+void AtomicLogBuffer::releaseRef(bool forceGc) {
   // All operations following SHOULD NOT reordered before tail.load()
   // so we could ensure the tail used in GC is older than new coming readers.
   auto* tail = tail_.load(std::memory_order_acquire);
@@ -184,7 +274,7 @@ void AtomicLogBuffer::releaseRef() {
   auto dirtyNodes = dirtyNodes_.load(std::memory_order_relaxed);
   bool gcRunning = false;
 
-  if (dirtyNodes > dirtyNodesLimit_ || size_ > FLAGS_max_log_buffer_size) {
+  if (forceGc || dirtyNodes > dirtyNodesLimit_ || size_ > FLAGS_max_log_buffer_size) {
     if (gcOnGoing_.compare_exchange_strong(gcRunning, true, std::memory_order_acquire)) {
       VLOG(4) << "GC begins!";
       // It means no readers on the deleted nodes.
@@ -9,14 +9,72 @@
 #include <folly/lang/Aligned.h>
 #include <gtest/gtest_prod.h>
 
+#include <mutex>
+#include <unordered_set>
+
 #include "common/thrift/ThriftTypes.h"
 #include "common/utils/LogIterator.h"
 
+DECLARE_int64(wal_buffer_pool_size);
+
 namespace nebula {
 namespace wal {
 
 constexpr int32_t kMaxLength = 64;
 
+class AtomicLogBuffer;
+
+/**
+ * @brief Account the memory of all the AtomicLogBuffer in the process against a global budget,
+ * which is wal_buffer_pool_size. When it is exceeded, the logs in the buffers of the coldest parts,
+ * i.e. the ones pushed least recently, are evicted until the total size fits the budget again.
+ * The evicted logs are still read from the wal files.
+ */
+class LogBufferPool final {
+ public:
+  static LogBufferPool& instance() {
+    static LogBufferPool pool;
+    return pool;
+  }
+
+  /**
+   * @brief Register a buffer to the pool
+   */
+  void add(AtomicLogBuffer* buffer);
+
+  /**
+   * @brief Unregister a buffer, it will not be evicted after it returns
+   */
+  void remove(AtomicLogBuffer* buffer);
+
+  /**
+   * @brief Account the size of the buffer changed
+   */
+  void update(int64_t delta) {
+    used_.fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Evict the coldest buffers if the budget is exceeded. Only one thread evicts at a time,
+   * the others return immediately.
+   */
+  void evictIfNeeded();
+
+  /**
+   * @brief Return the total size of the logs in all buffers
+   */
+  int64_t used() const {
+    return used_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  LogBufferPool() = default;
+
+  std::atomic<int64_t> used_{0};
+  std::mutex lock_;
+  std::unordered_set<AtomicLogBuffer*> buffers_;
+};
+
 /**
  * @brief Wal record in each Node, it is wrapper calls of wal log
  */
@@ -111,13 +169,16 @@ struct Node {
 };
 
 /**
- * @brief A wait-free log buffer for single writer, multi readers When deleting the extra node, to
+ * @brief A wait-free log buffer for multi readers, the writes are serialized by a lock which is
+ * only contended when the LogBufferPool is evicting the buffer. When deleting the extra node, to
  * avoid read the dangling one, we just mark it to be deleted, and delete it when no readers using
  * it. For write, most of time, it is o(1) For seek, it is o(n), n is the number of nodes inside
  * current list, but in most cases, the seeking log is in the head node, so it equals o(1)
  */
 class AtomicLogBuffer : public std::enable_shared_from_this<AtomicLogBuffer> {
   FRIEND_TEST(AtomicLogBufferTest, ResetThenPushExceedLimit);
+  FRIEND_TEST(AtomicLogBufferTest, EvictColdestBuffers);
+  friend class LogBufferPool;
 
  public:
   /**
@@ -250,7 +311,9 @@ class AtomicLogBuffer : public std::enable_shared_from_this<AtomicLogBuffer> {
    * @return std::shared_ptr<AtomicLogBuffer>
    */
   static std::shared_ptr<AtomicLogBuffer> instance(int32_t capacity = 8 * 1024 * 1024) {
-    return std::shared_ptr<AtomicLogBuffer>(new AtomicLogBuffer(capacity));
+    auto buffer = std::shared_ptr<AtomicLogBuffer>(new AtomicLogBuffer(capacity));
+    LogBufferPool::instance().add(buffer.get());
+    return buffer;
   }
 
   /**
@@ -334,6 +397,36 @@ class AtomicLogBuffer : public std::enable_shared_from_this<AtomicLogBuffer> {
    */
   Node* seek(LogID logId);
 
+  /**
+   * @brief Add the wal record with the writeLock_ held
+   */
+  void pushInternal(LogID logId, Record&& record);
+
+  /**
+   * @brief Mark the tail node to be deleted if there are more than one nodes, the caller should
+   * hold the writeLock_
+   *
+   * @param head Current head node
+   * @return Whether the tail is moved
+   */
+  bool dropTail(Node* head);
+
+  /**
+   * @brief Drop all nodes except the head one, and delete them if no readers using them. It is
+   * called by LogBufferPool, the buffer is skipped if it is being written.
+   *
+   * @return int32_t The bytes dropped
+   */
+  int32_t evict();
+
+  /**
+   * @brief Add the delta to the size of the buffer and the pool
+   */
+  void updateSize(int32_t delta) {
+    size_.fetch_add(delta, std::memory_order_relaxed);
+    LogBufferPool::instance().update(delta);
+  }
+
   /**
    * @brief Add a refernce count of how many iterator exists
    *
@@ -346,8 +439,9 @@ class AtomicLogBuffer : public std::enable_shared_from_this<AtomicLogBuffer> {
   /**
    * @brief Release the node if there are two many dirty nodes
    *
+   * @param forceGc Release the dirty nodes no matter how many they are
    */
-  void releaseRef();
+  void releaseRef(bool forceGc = false);
 
  private:
   std::atomic<Node*> head_{nullptr};
@@ -364,6 +458,10 @@ class AtomicLogBuffer : public std::enable_shared_from_this<AtomicLogBuffer> {
   std::atomic<bool> gcOnGoing_{false};
   std::atomic<int32_t> dirtyNodes_{0};
   int32_t dirtyNodesLimit_{5};
+  // Serialize the writer and the eviction of LogBufferPool
+  std::mutex writeLock_;
+  // The last time in milliseconds when a log is pushed, used to find the coldest buffers
+  std::atomic<int64_t> lastPushTime_{0};
 };
 
 }  // namespace wal
@@ -5,23 +5,32 @@
 
 #include "kvstore/wal/FileBasedWal.h"
 
+#include <folly/FileUtil.h>
 #include <utime.h>
 
 #include "common/base/Base.h"
 #include "common/fs/FileUtils.h"
 #include "common/time/WallClock.h"
+#include "kvstore/stats/KVStats.h"
 #include "kvstore/wal/WalFileIterator.h"
 
 DEFINE_int32(wal_ttl, 14400, "Default wal ttl");
 DEFINE_int64(wal_file_size, 16 * 1024 * 1024, "Default wal file size");
 DEFINE_int32(wal_buffer_size, 8 * 1024 * 1024, "Default wal buffer size");
 DEFINE_bool(wal_sync, false, "Whether fsync needs to be called every write");
+DEFINE_bool(wal_index,
+            true,
+            "Whether to write the last log id, term and size of each wal file to an index when "
+            "the wal is closed, so a restart doesn't need to scan the wal files unchanged since");
 
 namespace nebula {
 namespace wal {
 
 using nebula::fs::FileUtils;
 
+static constexpr folly::StringPiece kIndexFile = "wal.index";
+static constexpr folly::StringPiece kIndexVersion = "v1";
+
 /**********************************************
  *
  * Implementation of FileBasedWal
@@ -79,10 +88,70 @@ FileBasedWal::~FileBasedWal() {
   // moment, there should have no other thread holding this WAL object
   // Close the last file
   closeCurrFile();
+  if (FLAGS_wal_index) {
+    writeIndex();
+  }
   VLOG(2) << idStr_ << "~FileBasedWal, dir = " << dir_;
 }
 
+std::unordered_map<LogID, WalFileInfoPtr> FileBasedWal::takeIndex() {
+  std::unordered_map<LogID, WalFileInfoPtr> index;
+  auto path = FileUtils::joinPath(dir_, kIndexFile);
+  std::string content;
+  if (!folly::readFile(path.c_str(), content)) {
+    return index;
+  }
+  unlink(path.c_str());
+
+  // Each line is "<first log id> <last log id> <last log term> <size>" after the version
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', content, lines, true);
+  if (lines.empty() || lines[0] != kIndexVersion) {
+    LOG(WARNING) << idStr_ << "Ignore the wal index of unknown version in " << dir_;
+    return index;
+  }
+  for (size_t i = 1; i < lines.size(); i++) {
+    LogID firstId;
+    LogID lastId;
+    TermID lastTerm;
+    size_t size;
+    if (!folly::split(' ', lines[i], firstId, lastId, lastTerm, size)) {
+      LOG(WARNING) << idStr_ << "Ignore the bad wal index in " << dir_;
+      index.clear();
+      return index;
+    }
+    auto info = std::make_shared<WalFileInfo>("", firstId);
+    info->setLastId(lastId);
+    info->setLastTerm(lastTerm);
+    info->setSize(size);
+    index.emplace(firstId, std::move(info));
+  }
+  return index;
+}
+
+void FileBasedWal::writeIndex() {
+  std::lock_guard<std::mutex> g(walFilesMutex_);
+  // The wal might have been removed with its directory
+  if (walFiles_.empty() || !FileUtils::exist(dir_)) {
+    return;
+  }
+  std::string content = kIndexVersion.str() + "\n";
+  for (const auto& [firstId, info] : walFiles_) {
+    content += folly::sformat(
+        "{} {} {} {}\n", firstId, info->lastId(), info->lastTerm(), info->size());
+  }
+  auto path = FileUtils::joinPath(dir_, kIndexFile);
+  // The index is written after the wal files are synced by closeCurrFile()
+  if (folly::writeFileAtomicNoThrow(path, content, 0644, folly::SyncType::WITH_SYNC) != 0) {
+    LOG(WARNING) << idStr_ << "Failed to write the wal index " << path;
+  }
+}
+
 void FileBasedWal::scanAllWalFiles() {
+  // A file of the same size as indexed is the same as when it was closed, since the wal files
+  // are only appended or truncated, and the index is removed before any change
+  auto index = takeIndex();
+  std::unordered_set<LogID> indexedFiles;
   std::vector<std::string> files = FileUtils::listAllFilesInDir(dir_.c_str(), false, "*.wal");
   for (auto& fn : files) {
     // Split the file name
@@ -123,6 +192,15 @@ void FileBasedWal::scanAllWalFiles() {
       continue;
     }
 
+    auto indexed = index.find(startIdFromName);
+    if (indexed != index.end() && indexed->second->size() == info->size() &&
+        indexed->second->lastId() > 0) {
+      info->setLastId(indexed->second->lastId());
+      info->setLastTerm(indexed->second->lastTerm());
+      indexedFiles.emplace(startIdFromName);
+      continue;
+    }
+
     // Open the file
     int32_t fd = open(info->path(), O_RDONLY);
     if (fd < 0) {
@@ -227,7 +305,9 @@ void FileBasedWal::scanAllWalFiles() {
   if (!walFiles_.empty()) {
     auto it = walFiles_.rbegin();
     // Try to scan last wal, if it is invalid or empty, scan the previous one
-    scanLastWal(it->second, it->second->firstId());
+    if (indexedFiles.count(it->first) == 0) {
+      scanLastWal(it->second, it->second->firstId());
+    }
     if (it->second->lastId() <= 0) {
       unlink(it->second->path());
       walFiles_.erase(it->first);
@@ -439,9 +519,11 @@ void FileBasedWal::scanLastWal(WalFileInfoPtr info, LogID firstId) {
   close(fd);
 }
 
-bool FileBasedWal::appendLogInternal(LogID id, TermID term, ClusterID cluster, std::string msg) {
-  if (lastLogId_ != 0 && firstLogId_ != 0 && id != lastLogId_ + 1) {
-    VLOG(3) << idStr_ << "There is a gap in the log id. The last log id is " << lastLogId_
+bool FileBasedWal::appendLogInternal(
+    LogID id, TermID term, ClusterID cluster, std::string msg, PendingLogs& pending) {
+  auto lastLogId = pending.logs.empty() ? lastLogId_ : std::get<0>(pending.logs.back());
+  if (lastLogId != 0 && (firstLogId_ != 0 || !pending.logs.empty()) && id != lastLogId + 1) {
+    VLOG(3) << idStr_ << "There is a gap in the log id. The last log id is " << lastLogId
             << ", and the id being appended is " << id;
     return false;
   }
@@ -451,50 +533,64 @@ bool FileBasedWal::appendLogInternal(LogID id, TermID term, ClusterID cluster, s
     return false;
   }
 
-  // Write to the WAL file first
-  std::string strBuf;
-  strBuf.reserve(sizeof(LogID) + sizeof(TermID) + sizeof(ClusterID) + msg.size() +
-                 2 * sizeof(int32_t));
-  strBuf.append(reinterpret_cast<char*>(&id), sizeof(LogID));
-  strBuf.append(reinterpret_cast<char*>(&term), sizeof(TermID));
-  int32_t len = msg.size();
-  strBuf.append(reinterpret_cast<char*>(&len), sizeof(int32_t));
-  strBuf.append(reinterpret_cast<char*>(&cluster), sizeof(ClusterID));
-  strBuf.append(reinterpret_cast<const char*>(msg.data()), msg.size());
-  strBuf.append(reinterpret_cast<char*>(&len), sizeof(int32_t));
-
+  auto size =
+      sizeof(LogID) + sizeof(TermID) + sizeof(ClusterID) + msg.size() + 2 * sizeof(int32_t);
   // Prepare the WAL file if it's not opened
   if (currFd_ < 0) {
     prepareNewFile(id);
-  } else if (currInfo_->size() + strBuf.size() > policy_.fileSize) {
-    // Need to roll over
+  } else if (currInfo_->size() + pending.buf.size() + size > policy_.fileSize) {
+    // Need to roll over, the pending logs belong to current file
+    flushLogs(pending);
     closeCurrFile();
 
     std::lock_guard<std::mutex> g(walFilesMutex_);
     prepareNewFile(id);
   }
 
+  auto& strBuf = pending.buf;
+  strBuf.reserve(strBuf.size() + size);
+  strBuf.append(reinterpret_cast<char*>(&id), sizeof(LogID));
+  strBuf.append(reinterpret_cast<char*>(&term), sizeof(TermID));
+  int32_t len = msg.size();
+  strBuf.append(reinterpret_cast<char*>(&len), sizeof(int32_t));
+  strBuf.append(reinterpret_cast<char*>(&cluster), sizeof(ClusterID));
+  strBuf.append(reinterpret_cast<const char*>(msg.data()), msg.size());
+  strBuf.append(reinterpret_cast<char*>(&len), sizeof(int32_t));
+  pending.logs.emplace_back(id, term, cluster, std::move(msg));
+  return true;
+}
+
+void FileBasedWal::flushLogs(PendingLogs& pending) {
+  if (pending.logs.empty()) {
+    return;
+  }
+  auto& strBuf = pending.buf;
   ssize_t bytesWritten = write(currFd_, strBuf.data(), strBuf.size());
   if (bytesWritten != (ssize_t)strBuf.size()) {
     LOG(FATAL) << idStr_ << "bytesWritten:" << bytesWritten << ", expected:" << strBuf.size()
                << ", error:" << strerror(errno);
   }
 
-  if (policy_.sync && ::fsync(currFd_) == -1) {
+  if (policy_.sync && ::fdatasync(currFd_) == -1) {
     LOG(WARNING) << "sync wal \"" << currInfo_->path() << "\" failed, error: " << strerror(errno);
   }
+  auto& last = pending.logs.back();
   currInfo_->setSize(currInfo_->size() + strBuf.size());
-  currInfo_->setLastId(id);
-  currInfo_->setLastTerm(term);
+  currInfo_->setLastId(std::get<0>(last));
+  currInfo_->setLastTerm(std::get<1>(last));
 
-  lastLogId_ = id;
-  lastLogTerm_ = term;
+  lastLogId_ = std::get<0>(last);
+  lastLogTerm_ = std::get<1>(last);
   if (firstLogId_ == 0) {
-    firstLogId_ = id;
+    firstLogId_ = std::get<0>(pending.logs.front());
   }
 
-  logBuffer_->push(id, term, cluster, std::move(msg));
-  return true;
+  for (auto& log : pending.logs) {
+    logBuffer_->push(
+        std::get<0>(log), std::get<1>(log), std::get<2>(log), std::move(std::get<3>(log)));
+  }
+  strBuf.clear();
+  pending.logs.clear();
 }
 
 bool FileBasedWal::appendLog(LogID id, TermID term, ClusterID cluster, std::string msg) {
@@ -502,10 +598,12 @@ bool FileBasedWal::appendLog(LogID id, TermID term, ClusterID cluster, std::stri
     VLOG_EVERY_N(2, 1000) << idStr_ << "Failed to appendLogs because of no more space";
     return false;
   }
-  if (!appendLogInternal(id, term, cluster, std::move(msg))) {
+  PendingLogs pending;
+  if (!appendLogInternal(id, term, cluster, std::move(msg), pending)) {
     VLOG(3) << "Failed to append log for logId " << id;
     return false;
   }
+  flushLogs(pending);
   return true;
 }
 
@@ -514,13 +612,18 @@ bool FileBasedWal::appendLogs(LogIterator& iter) {
     VLOG_EVERY_N(2, 1000) << idStr_ << "Failed to appendLogs because of no more space";
     return false;
   }
+  // All logs are written and synced together, except the ones written before rolling over
+  PendingLogs pending;
   for (; iter.valid(); ++iter) {
     if (!appendLogInternal(
-            iter.logId(), iter.logTerm(), iter.logSource(), iter.logMsg().toString())) {
+            iter.logId(), iter.logTerm(), iter.logSource(), iter.logMsg().toString(), pending)) {
       VLOG(3) << idStr_ << "Failed to append log for logId " << iter.logId();
+      // The logs before the failed one are appended as before
+      flushLogs(pending);
       return false;
     }
   }
+  flushLogs(pending);
 
   return true;
 }
@@ -528,8 +631,10 @@ bool FileBasedWal::appendLogs(LogIterator& iter) {
 std::unique_ptr<LogIterator> FileBasedWal::iterator(LogID firstLogId, LogID lastLogId) {
   auto iter = logBuffer_->iterator(firstLogId, lastLogId);
   if (iter->valid()) {
+    stats::StatsManager::addValue(kNumWalBufferHit);
     return iter;
   }
+  stats::StatsManager::addValue(kNumWalBufferMiss);
   return std::make_unique<WalFileIterator>(shared_from_this(), firstLogId, lastLogId);
 }
 
@@ -718,6 +823,15 @@ size_t FileBasedWal::accessAllWalInfo(std::function<bool(WalFileInfoPtr info)> f
   return count;
 }
 
+size_t FileBasedWal::sizeInBytes() const {
+  std::lock_guard<std::mutex> g(walFilesMutex_);
+  size_t size = 0;
+  for (const auto& file : walFiles_) {
+    size += file.second->size();
+  }
+  return size;
+}
+
 TermID FileBasedWal::getLogTerm(LogID id) {
   TermID term = INVALID_TERM;
   auto iter = iterator(id, id);
@@ -44,6 +44,7 @@ class FileBasedWal final : public Wal, public std::enable_shared_from_this<FileB
   FRIEND_TEST(FileBasedWal, CheckLastWalTest);
   FRIEND_TEST(FileBasedWal, LinkTest);
   FRIEND_TEST(FileBasedWal, CleanWalBeforeIdTest);
+  FRIEND_TEST(FileBasedWal, IndexTest);
   FRIEND_TEST(WalFileIter, MultiFilesReadTest);
   friend class FileBasedWalIterator;
   friend class WalFileIterator;
@@ -176,6 +177,11 @@ class FileBasedWal final : public Wal, public std::enable_shared_from_this<FileB
    */
   size_t accessAllWalInfo(std::function<bool(WalFileInfoPtr info)> fn) const;
 
+  /**
+   * @brief Return the total size of the wal files
+   */
+  size_t sizeInBytes() const override;
+
   /**
    * @brief Return the log buffer in memory
    */
@@ -206,10 +212,24 @@ class FileBasedWal final : public Wal, public std::enable_shared_from_this<FileB
                std::shared_ptr<kvstore::DiskManager> diskMan);
 
   /**
-   * @brief Scan all WAL files
+   * @brief Scan all WAL files, the files in the index written at the last close are not read
    */
   void scanAllWalFiles();
 
+  /**
+   * @brief Read and remove the index written at the last close, so it doesn't outlive the files
+   * written after it
+   *
+   * @return The first log id of each file indexed -> its info
+   */
+  std::unordered_map<LogID, WalFileInfoPtr> takeIndex();
+
+  /**
+   * @brief Write the last log id, term and size of each wal file to the index, so the next open
+   * needs not read the files
+   */
+  void writeIndex();
+
   /**
    * @brief Scan the last wal file by each wal log
    *
@@ -238,16 +258,34 @@ class FileBasedWal final : public Wal, public std::enable_shared_from_this<FileB
    */
   void rollbackInFile(WalFileInfoPtr info, LogID logId);
 
+  // The logs encoded but not written yet, so that the logs appended together are written by one
+  // write and synced once
+  struct PendingLogs {
+    std::string buf;
+    std::vector<std::tuple<LogID, TermID, ClusterID, std::string>> logs;
+  };
+
   /**
-   * @brief The actaul implementation of appendLog()
+   * @brief The actaul implementation of appendLog(), the log is encoded into pending logs, which
+   * should be flushed by flushLogs() later
    *
    * @param id Log id to append
    * @param term Log term to append
    * @param cluster Cluster id in log to append
    * @param msg Log messgage to append
+   * @param pending The logs not written yet
    * @return Wheter append succeed
    */
-  bool appendLogInternal(LogID id, TermID term, ClusterID cluster, std::string msg);
+  bool appendLogInternal(
+      LogID id, TermID term, ClusterID cluster, std::string msg, PendingLogs& pending);
+
+  /**
+   * @brief Write the pending logs into current wal file, sync it if necessary, and then make the
+   * logs visible
+   *
+   * @param pending The logs not written yet, it's empty after flushed
+   */
+  void flushLogs(PendingLogs& pending);
 
  private:
   using WalFiles = std::map<LogID, WalFileInfoPtr>;
@@ -0,0 +1,751 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "kvstore/wal/SharedWal.h"
+
+#include "common/fs/FileUtils.h"
+#include "common/time/WallClock.h"
+#include "kvstore/stats/KVStats.h"
+
+DEFINE_bool(enable_shared_wal,
+            false,
+            "Whether the parts of a space on the same disk share one segmented wal instead of "
+            "one wal for each part. The existing wal is not migrated when it's changed, the logs "
+            "are pulled from the leader or by snapshot again");
+
+DECLARE_int32(wal_ttl);
+
+namespace nebula {
+namespace wal {
+
+using nebula::fs::FileUtils;
+
+namespace {
+
+template <typename T>
+T readValue(const char* data) {
+  T val;
+  memcpy(&val, data, sizeof(T));
+  return val;
+}
+
+}  // namespace
+
+/*********************************************
+ *
+ * Implementation of SharedWalStore
+ *
+ *********************************************/
+// static
+std::shared_ptr<SharedWalStore> SharedWalStore::getStore(const std::string& dir,
+                                                         const FileBasedWalPolicy& policy) {
+  static std::mutex storesLock;
+  static std::unordered_map<std::string, std::weak_ptr<SharedWalStore>> stores;
+  std::lock_guard<std::mutex> g(storesLock);
+  auto store = stores[dir].lock();
+  if (store == nullptr) {
+    store = std::shared_ptr<SharedWalStore>(new SharedWalStore(dir, policy));
+    stores[dir] = store;
+  }
+  return store;
+}
+
+SharedWalStore::SharedWalStore(std::string dir, FileBasedWalPolicy policy)
+    : dir_(std::move(dir)), policy_(std::move(policy)) {
+  if (FileUtils::fileType(dir_.c_str()) == fs::FileType::NOTEXIST) {
+    if (!FileUtils::makeDir(dir_)) {
+      LOG(FATAL) << "MakeDIR " << dir_ << " failed";
+    }
+  }
+  openTime_ = time::WallClock::fastNowInSec();
+  recover();
+}
+
+SharedWalStore::~SharedWalStore() {
+  for (auto& segment : segments_) {
+    if (segment.second.readFd >= 0) {
+      ::close(segment.second.readFd);
+    }
+  }
+  if (currFd_ >= 0) {
+    if (!policy_.sync && ::fsync(currFd_) == -1) {
+      LOG(WARNING) << "sync wal \"" << segmentPath(currSegment_)
+                   << "\" failed, error: " << strerror(errno);
+    }
+    ::close(currFd_);
+  }
+}
+
+std::string SharedWalStore::segmentPath(int64_t segment) const {
+  return FileUtils::joinPath(dir_, folly::stringPrintf("%019ld.swal", segment));
+}
+
+// static
+void SharedWalStore::encode(std::string& buf,
+                            RecordType type,
+                            GraphSpaceID spaceId,
+                            PartitionID partId,
+                            LogID id,
+                            TermID term,
+                            ClusterID cluster,
+                            folly::StringPiece msg) {
+  buf.reserve(buf.size() + kHeaderSize + msg.size() + sizeof(int32_t));
+  buf.append(reinterpret_cast<const char*>(&type), sizeof(RecordType));
+  buf.append(reinterpret_cast<const char*>(&spaceId), sizeof(GraphSpaceID));
+  buf.append(reinterpret_cast<const char*>(&partId), sizeof(PartitionID));
+  buf.append(reinterpret_cast<const char*>(&id), sizeof(LogID));
+  buf.append(reinterpret_cast<const char*>(&term), sizeof(TermID));
+  int32_t len = msg.size();
+  buf.append(reinterpret_cast<const char*>(&len), sizeof(int32_t));
+  buf.append(reinterpret_cast<const char*>(&cluster), sizeof(ClusterID));
+  buf.append(msg.data(), msg.size());
+  buf.append(reinterpret_cast<const char*>(&len), sizeof(int32_t));
+}
+
+void SharedWalStore::recover() {
+  auto files = FileUtils::listAllFilesInDir(dir_.c_str(), false, "*.swal");
+  for (auto& fn : files) {
+    std::vector<std::string> parts;
+    folly::split('.', fn, parts);
+    if (parts.size() != 2 || !folly::tryTo<int64_t>(parts[0]).hasValue()) {
+      LOG(WARNING) << "Ignore bad file name \"" << fn << "\"";
+      continue;
+    }
+    segments_[folly::to<int64_t>(parts[0])].path = FileUtils::joinPath(dir_, fn);
+  }
+
+  for (auto it = segments_.begin(); it != segments_.end(); ++it) {
+    auto segment = it->first;
+    auto& info = it->second;
+    std::string data;
+    if (!folly::readFile(info.path.c_str(), data)) {
+      LOG(FATAL) << "Failed to read the wal \"" << info.path << "\": " << strerror(errno);
+    }
+    struct stat st;
+    if (stat(info.path.c_str(), &st) == 0) {
+      info.mtime = st.st_mtime;
+    }
+    size_t pos = 0;
+    while (pos + kHeaderSize + sizeof(int32_t) <= data.size()) {
+      const char* p = data.data() + pos;
+      auto type = readValue<RecordType>(p);
+      p += sizeof(RecordType);
+      auto spaceId = readValue<GraphSpaceID>(p);
+      p += sizeof(GraphSpaceID);
+      auto partId = readValue<PartitionID>(p);
+      p += sizeof(PartitionID);
+      auto id = readValue<LogID>(p);
+      p += sizeof(LogID);
+      auto term = readValue<TermID>(p);
+      p += sizeof(TermID);
+      auto len = readValue<int32_t>(p);
+      auto size = kHeaderSize + len + sizeof(int32_t);
+      if (len < 0 || pos + size > data.size() ||
+          readValue<int32_t>(data.data() + pos + size - sizeof(int32_t)) != len) {
+        // The tail of the last segment is not written completely
+        break;
+      }
+
+      auto& entries = recovered_[std::make_pair(spaceId, partId)];
+      switch (type) {
+        case RecordType::kLog:
+          // The log rewritten later replaces the old one
+          while (!entries.empty() && entries.back().id >= id) {
+            segments_[entries.back().segment].refs--;
+            entries.pop_back();
+          }
+          entries.emplace_back(Entry{id, term, segment, pos, size});
+          info.refs++;
+          break;
+        case RecordType::kRollback:
+          while (!entries.empty() && entries.back().id > id) {
+            segments_[entries.back().segment].refs--;
+            entries.pop_back();
+          }
+          break;
+        case RecordType::kReset:
+          for (auto& entry : entries) {
+            segments_[entry.segment].refs--;
+          }
+          entries.clear();
+          break;
+        default:
+          LOG(WARNING) << "Unknown record type " << static_cast<int32_t>(type) << " in "
+                       << info.path;
+          break;
+      }
+      pos += size;
+    }
+    info.size = pos;
+    if (pos != data.size()) {
+      LOG(WARNING) << "Truncate the incomplete tail of \"" << info.path << "\" at " << pos;
+      if (::truncate(info.path.c_str(), pos) != 0) {
+        LOG(FATAL) << "Failed to truncate \"" << info.path << "\": " << strerror(errno);
+      }
+    }
+  }
+
+  for (auto it = recovered_.begin(); it != recovered_.end();) {
+    if (it->second.empty()) {
+      it = recovered_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (!segments_.empty()) {
+    currSegment_ = segments_.rbegin()->first;
+    auto& info = segments_.rbegin()->second;
+    currFd_ = open(info.path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (currFd_ < 0) {
+      LOG(FATAL) << "Failed to open the file \"" << info.path << "\" (" << errno
+                 << "): " << strerror(errno);
+    }
+  }
+  removeSegments();
+  LOG(INFO) << "Recovered " << recovered_.size() << " parts from " << segments_.size()
+            << " wal segments in " << dir_;
+}
+
+std::deque<SharedWalStore::Entry> SharedWalStore::claim(GraphSpaceID spaceId, PartitionID partId) {
+  std::lock_guard<std::mutex> g(lock_);
+  auto released = released_.find(std::make_pair(spaceId, partId));
+  if (released != released_.end()) {
+    auto entries = std::move(released->second);
+    released_.erase(released);
+    return entries;
+  }
+  auto it = recovered_.find(std::make_pair(spaceId, partId));
+  if (it == recovered_.end()) {
+    return {};
+  }
+  auto entries = std::move(it->second);
+  recovered_.erase(it);
+  return entries;
+}
+
+void SharedWalStore::release(GraphSpaceID spaceId,
+                             PartitionID partId,
+                             std::deque<Entry> entries) {
+  if (entries.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> g(lock_);
+  released_[std::make_pair(spaceId, partId)] = std::move(entries);
+}
+
+std::pair<int64_t, size_t> SharedWalStore::write(const std::string& buf, int64_t numLogs) {
+  std::lock_guard<std::mutex> g(lock_);
+  if (currFd_ < 0 || segments_[currSegment_].size + buf.size() > policy_.fileSize) {
+    // Roll over
+    if (currFd_ >= 0) {
+      if (!policy_.sync && ::fsync(currFd_) == -1) {
+        LOG(WARNING) << "sync wal \"" << segmentPath(currSegment_)
+                     << "\" failed, error: " << strerror(errno);
+      }
+      ::close(currFd_);
+      ++currSegment_;
+    }
+    auto& info = segments_[currSegment_];
+    info.path = segmentPath(currSegment_);
+    currFd_ = open(info.path.c_str(),
+                   O_CREAT | O_EXCL | O_WRONLY | O_APPEND | O_CLOEXEC | O_LARGEFILE,
+                   0644);
+    if (currFd_ < 0) {
+      LOG(FATAL) << "Failed to open file \"" << info.path << "\" (errno: " << errno
+                 << "): " << strerror(errno);
+    }
+    // The segments only referred by the logs being rolled back could be removed now
+    removeSegments();
+  }
+
+  auto& info = segments_[currSegment_];
+  ssize_t bytesWritten = ::write(currFd_, buf.data(), buf.size());
+  if (bytesWritten != static_cast<ssize_t>(buf.size())) {
+    LOG(FATAL) << "bytesWritten:" << bytesWritten << ", expected:" << buf.size()
+               << ", error:" << strerror(errno);
+  }
+  if (policy_.sync && ::fdatasync(currFd_) == -1) {
+    LOG(WARNING) << "sync wal \"" << info.path << "\" failed, error: " << strerror(errno);
+  }
+  auto offset = info.size;
+  info.size += buf.size();
+  info.mtime = time::WallClock::fastNowInSec();
+  info.refs += numLogs;
+  return std::make_pair(currSegment_, offset);
+}
+
+bool SharedWalStore::read(const Entry& entry, TermID& term, ClusterID& cluster, std::string& msg) {
+  std::string buf(entry.size, '\0');
+  {
+    // The segment is not removed while reading it
+    std::lock_guard<std::mutex> g(lock_);
+    auto it = segments_.find(entry.segment);
+    if (it == segments_.end()) {
+      return false;
+    }
+    auto& info = it->second;
+    if (info.readFd < 0) {
+      info.readFd = open(info.path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (info.readFd < 0) {
+        LOG(ERROR) << "Failed to open the file \"" << info.path << "\": " << strerror(errno);
+        return false;
+      }
+    }
+    if (pread(info.readFd, &buf[0], entry.size, entry.offset) !=
+        static_cast<ssize_t>(entry.size)) {
+      LOG(ERROR) << "Failed to read the log " << entry.id << " in \"" << info.path
+                 << "\": " << strerror(errno);
+      return false;
+    }
+  }
+  const char* p = buf.data() + sizeof(RecordType) + sizeof(GraphSpaceID) + sizeof(PartitionID) +
+                  sizeof(LogID);
+  term = readValue<TermID>(p);
+  p += sizeof(TermID);
+  auto len = readValue<int32_t>(p);
+  p += sizeof(int32_t);
+  cluster = readValue<ClusterID>(p);
+  p += sizeof(ClusterID);
+  msg.assign(p, len);
+  return true;
+}
+
+void SharedWalStore::unref(int64_t segment, int64_t count) {
+  std::lock_guard<std::mutex> g(lock_);
+  auto it = segments_.find(segment);
+  CHECK(it != segments_.end());
+  it->second.refs -= count;
+  CHECK_GE(it->second.refs, 0);
+  if (it == segments_.begin()) {
+    removeSegments();
+  }
+}
+
+void SharedWalStore::removeSegments() {
+  // Remove in order, so that the rollback and reset records are removed after the logs in the
+  // older segments they apply to
+  while (!segments_.empty() && segments_.begin()->first != currSegment_ &&
+         segments_.begin()->second.refs == 0) {
+    auto& info = segments_.begin()->second;
+    VLOG(2) << "Remove wal segment " << info.path;
+    if (info.readFd >= 0) {
+      ::close(info.readFd);
+    }
+    unlink(info.path.c_str());
+    segments_.erase(segments_.begin());
+  }
+}
+
+int64_t SharedWalStore::mtime(int64_t segment) {
+  std::lock_guard<std::mutex> g(lock_);
+  auto it = segments_.find(segment);
+  return it == segments_.end() ? 0 : it->second.mtime;
+}
+
+int64_t SharedWalStore::currentSegment() {
+  std::lock_guard<std::mutex> g(lock_);
+  return currSegment_;
+}
+
+void SharedWalStore::dropUnclaimed() {
+  std::lock_guard<std::mutex> g(lock_);
+  if (recovered_.empty() || time::WallClock::fastNowInSec() - openTime_ <= FLAGS_wal_ttl) {
+    return;
+  }
+  for (auto& part : recovered_) {
+    VLOG(1) << "Drop the wal of space " << part.first.first << ", part " << part.first.second
+            << " which is not claimed";
+    for (auto& entry : part.second) {
+      segments_[entry.segment].refs--;
+    }
+  }
+  recovered_.clear();
+  removeSegments();
+}
+
+/*********************************************
+ *
+ * Implementation of SharedWal
+ *
+ *********************************************/
+// static
+std::shared_ptr<SharedWal> SharedWal::getWal(const folly::StringPiece dir,
+                                             FileBasedWalInfo info,
+                                             FileBasedWalPolicy policy,
+                                             PreProcessor preProcessor,
+                                             std::shared_ptr<kvstore::DiskManager> diskMan) {
+  return std::shared_ptr<SharedWal>(new SharedWal(
+      dir, std::move(info), std::move(policy), std::move(preProcessor), std::move(diskMan)));
+}
+
+SharedWal::SharedWal(const folly::StringPiece dir,
+                     FileBasedWalInfo info,
+                     FileBasedWalPolicy policy,
+                     PreProcessor preProcessor,
+                     std::shared_ptr<kvstore::DiskManager> diskMan)
+    : idStr_(info.idStr_),
+      spaceId_(info.spaceId_),
+      partId_(info.partId_),
+      policy_(std::move(policy)),
+      preProcessor_(std::move(preProcessor)),
+      diskMan_(std::move(diskMan)) {
+  store_ = SharedWalStore::getStore(dir.toString(), policy_);
+  logBuffer_ = AtomicLogBuffer::instance(policy_.bufferSize);
+  entries_ = store_->claim(spaceId_, partId_);
+  for (const auto& entry : entries_) {
+    bytes_ += entry.size;
+  }
+  if (!entries_.empty()) {
+    VLOG(2) << idStr_ << "lastLogId in wal is " << entries_.back().id << ", lastLogTerm is "
+            << entries_.back().term << ", firstLogId is " << entries_.front().id;
+  }
+}
+
+SharedWal::~SharedWal() {
+  // The logs are kept for the part opened again, they are only dropped by reset, rollback or clean
+  store_->release(spaceId_, partId_, std::move(entries_));
+}
+
+LogID SharedWal::firstLogId() const {
+  std::lock_guard<std::mutex> g(lock_);
+  return entries_.empty() ? 0 : entries_.front().id;
+}
+
+size_t SharedWal::sizeInBytes() const {
+  std::lock_guard<std::mutex> g(lock_);
+  return bytes_;
+}
+
+LogID SharedWal::lastLogId() const {
+  std::lock_guard<std::mutex> g(lock_);
+  return entries_.empty() ? 0 : entries_.back().id;
+}
+
+TermID SharedWal::lastLogTerm() const {
+  std::lock_guard<std::mutex> g(lock_);
+  return entries_.empty() ? 0 : entries_.back().term;
+}
+
+TermID SharedWal::getLogTerm(LogID id) {
+  std::lock_guard<std::mutex> g(lock_);
+  if (entries_.empty() || id < entries_.front().id || id > entries_.back().id) {
+    return FileBasedWal::INVALID_TERM;
+  }
+  // The log ids are continuous
+  return entries_[id - entries_.front().id].term;
+}
+
+bool SharedWal::appendLog(LogID id, TermID term, ClusterID cluster, std::string msg) {
+  if (diskMan_ && !diskMan_->hasEnoughSpace(spaceId_, partId_)) {
+    VLOG_EVERY_N(2, 1000) << idStr_ << "Failed to appendLogs because of no more space";
+    return false;
+  }
+  auto lastId = lastLogId();
+  if (lastId != 0 && id != lastId + 1) {
+    VLOG(3) << idStr_ << "There is a gap in the log id. The last log id is " << lastId
+            << ", and the id being appended is " << id;
+    return false;
+  }
+  if (!preProcessor_(id, term, cluster, msg)) {
+    VLOG(3) << idStr_ << "Pre process failed for log " << id;
+    return false;
+  }
+  std::string buf;
+  SharedWalStore::encode(
+      buf, SharedWalStore::RecordType::kLog, spaceId_, partId_, id, term, cluster, msg);
+  std::vector<std::tuple<LogID, TermID, ClusterID, std::string>> logs;
+  logs.emplace_back(id, term, cluster, std::move(msg));
+  write(buf, logs);
+  return true;
+}
+
+bool SharedWal::appendLogs(LogIterator& iter) {
+  if (diskMan_ && !diskMan_->hasEnoughSpace(spaceId_, partId_)) {
+    VLOG_EVERY_N(2, 1000) << idStr_ << "Failed to appendLogs because of no more space";
+    return false;
+  }
+  // All logs are written into the store together
+  std::string buf;
+  std::vector<std::tuple<LogID, TermID, ClusterID, std::string>> logs;
+  auto lastId = lastLogId();
+  bool succeeded = true;
+  for (; iter.valid(); ++iter) {
+    auto id = iter.logId();
+    if (lastId != 0 && id != lastId + 1) {
+      VLOG(3) << idStr_ << "There is a gap in the log id. The last log id is " << lastId
+              << ", and the id being appended is " << id;
+      succeeded = false;
+      break;
+    }
+    auto msg = iter.logMsg().toString();
+    if (!preProcessor_(id, iter.logTerm(), iter.logSource(), msg)) {
+      VLOG(3) << idStr_ << "Pre process failed for log " << id;
+      succeeded = false;
+      break;
+    }
+    SharedWalStore::encode(buf,
+                           SharedWalStore::RecordType::kLog,
+                           spaceId_,
+                           partId_,
+                           id,
+                           iter.logTerm(),
+                           iter.logSource(),
+                           msg);
+    logs.emplace_back(id, iter.logTerm(), iter.logSource(), std::move(msg));
+    lastId = id;
+  }
+  // The logs before the failed one are appended as before
+  if (!logs.empty()) {
+    write(buf, logs);
+  }
+  return succeeded;
+}
+
+void SharedWal::write(const std::string& buf,
+                      std::vector<std::tuple<LogID, TermID, ClusterID, std::string>>& logs) {
+  auto [segment, offset] = store_->write(buf, logs.size());
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    for (auto& log : logs) {
+      auto size =
+          SharedWalStore::kHeaderSize + std::get<3>(log).size() + sizeof(int32_t);
+      entries_.emplace_back(
+          SharedWalStore::Entry{std::get<0>(log), std::get<1>(log), segment, offset, size});
+      offset += size;
+      bytes_ += size;
+    }
+  }
+  for (auto& log : logs) {
+    logBuffer_->push(
+        std::get<0>(log), std::get<1>(log), std::get<2>(log), std::move(std::get<3>(log)));
+  }
+}
+
+bool SharedWal::rollbackToLog(LogID id) {
+  auto firstId = firstLogId();
+  auto lastId = lastLogId();
+  if (id < firstId - 1 || id > lastId) {
+    VLOG(4) << idStr_ << "Rollback target id " << id << " is not in the range of [" << firstId
+            << "," << lastId << "] of WAL";
+    return false;
+  }
+  std::string buf;
+  SharedWalStore::encode(
+      buf, SharedWalStore::RecordType::kRollback, spaceId_, partId_, id, 0, 0, "");
+  store_->write(buf, 0);
+  std::vector<int64_t> segments;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    while (!entries_.empty() && entries_.back().id > id) {
+      segments.emplace_back(entries_.back().segment);
+      bytes_ -= entries_.back().size;
+      entries_.pop_back();
+    }
+  }
+  for (auto segment : segments) {
+    store_->unref(segment);
+  }
+  logBuffer_->reset();
+  return true;
+}
+
+bool SharedWal::linkCurrentWAL(const char* newPath) {
+  if (FileUtils::exist(newPath) && !FileUtils::remove(newPath, true)) {
+    VLOG(3) << "Remove exist dir failed of wal : " << newPath;
+    return false;
+  }
+  auto firstId = firstLogId();
+  auto lastId = lastLogId();
+  FileBasedWalInfo info;
+  info.idStr_ = idStr_;
+  info.spaceId_ = spaceId_;
+  info.partId_ = partId_;
+  auto wal = FileBasedWal::getWal(
+      newPath, std::move(info), policy_, [](LogID, TermID, ClusterID, const std::string&) {
+        return true;
+      });
+  if (lastId == 0) {
+    return true;
+  }
+  auto iter = iterator(firstId, lastId);
+  if (!wal->appendLogs(*iter) || wal->lastLogId() != lastId) {
+    VLOG(3) << idStr_ << "Failed to copy the wal to " << newPath;
+    return false;
+  }
+  return true;
+}
+
+bool SharedWal::reset() {
+  std::string buf;
+  SharedWalStore::encode(buf, SharedWalStore::RecordType::kReset, spaceId_, partId_, 0, 0, 0, "");
+  store_->write(buf, 0);
+  std::deque<SharedWalStore::Entry> entries;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    entries.swap(entries_);
+    bytes_ = 0;
+  }
+  for (auto& entry : entries) {
+    store_->unref(entry.segment);
+  }
+  logBuffer_->reset();
+  return true;
+}
+
+void SharedWal::dropExpired(size_t n) {
+  auto now = time::WallClock::fastNowInSec();
+  auto current = store_->currentSegment();
+  std::vector<int64_t> segments;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    while (segments.size() < n && !entries_.empty()) {
+      auto segment = entries_.front().segment;
+      if (segment == current || now - store_->mtime(segment) <= FLAGS_wal_ttl) {
+        break;
+      }
+      segments.emplace_back(segment);
+      bytes_ -= entries_.front().size;
+      entries_.pop_front();
+    }
+  }
+  for (auto segment : segments) {
+    store_->unref(segment);
+  }
+}
+
+void SharedWal::cleanWAL() {
+  store_->dropUnclaimed();
+  SharedWalStore::Entry last;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    if (entries_.empty()) {
+      return;
+    }
+    last = entries_.back();
+  }
+  auto now = time::WallClock::fastNowInSec();
+  if (last.segment != store_->currentSegment() &&
+      now - store_->mtime(last.segment) > FLAGS_wal_ttl) {
+    // Rewrite the last log into the current segment, the part is idle so there is no race with
+    // appending
+    TermID term;
+    ClusterID cluster;
+    std::string msg;
+    if (store_->read(last, term, cluster, msg)) {
+      std::string buf;
+      SharedWalStore::encode(
+          buf, SharedWalStore::RecordType::kLog, spaceId_, partId_, last.id, term, cluster, msg);
+      auto [segment, offset] = store_->write(buf, 1);
+      bool rewritten = false;
+      {
+        std::lock_guard<std::mutex> g(lock_);
+        if (!entries_.empty() && entries_.back().id == last.id) {
+          entries_.back().segment = segment;
+          entries_.back().offset = offset;
+          rewritten = true;
+        }
+      }
+      // Release the reference of the old location, or of the new one if the log has changed
+      store_->unref(rewritten ? last.segment : segment);
+    }
+  }
+  // Keep the last log at least
+  size_t size;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    size = entries_.size();
+  }
+  if (size > 1) {
+    dropExpired(size - 1);
+  }
+}
+
+void SharedWal::cleanWAL(LogID id) {
+  size_t n = 0;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    if (entries_.empty() || entries_.back().id < id) {
+      VLOG(3) << "Try to clean wal not existed " << id;
+      return;
+    }
+    n = id - entries_.front().id;
+  }
+  dropExpired(n);
+}
+
+/**
+ * @brief Iterate the logs of a part in the shared wal
+ */
+class SharedWalIterator final : public LogIterator {
+ public:
+  SharedWalIterator(std::shared_ptr<SharedWalStore> store,
+                    std::vector<SharedWalStore::Entry> entries)
+      : store_(std::move(store)), entries_(std::move(entries)) {
+    read();
+  }
+
+  LogIterator& operator++() override {
+    ++idx_;
+    read();
+    return *this;
+  }
+
+  bool valid() const override {
+    return valid_;
+  }
+
+  LogID logId() const override {
+    return entries_[idx_].id;
+  }
+
+  TermID logTerm() const override {
+    return term_;
+  }
+
+  ClusterID logSource() const override {
+    return cluster_;
+  }
+
+  folly::StringPiece logMsg() const override {
+    return msg_;
+  }
+
+ private:
+  void read() {
+    valid_ = idx_ < entries_.size() && store_->read(entries_[idx_], term_, cluster_, msg_);
+  }
+
+  std::shared_ptr<SharedWalStore> store_;
+  std::vector<SharedWalStore::Entry> entries_;
+  size_t idx_{0};
+  bool valid_{false};
+  TermID term_{0};
+  ClusterID cluster_{0};
+  std::string msg_;
+};
+
+std::unique_ptr<LogIterator> SharedWal::iterator(LogID firstLogId, LogID lastLogId) {
+  auto iter = logBuffer_->iterator(firstLogId, lastLogId);
+  if (iter->valid()) {
+    stats::StatsManager::addValue(kNumWalBufferHit);
+    return iter;
+  }
+  stats::StatsManager::addValue(kNumWalBufferMiss);
+  std::vector<SharedWalStore::Entry> entries;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    if (!entries_.empty() && firstLogId >= entries_.front().id && firstLogId <= lastLogId) {
+      auto start = entries_.begin() + (firstLogId - entries_.front().id);
+      auto end = lastLogId >= entries_.back().id
+                     ? entries_.end()
+                     : entries_.begin() + (lastLogId - entries_.front().id + 1);
+      entries.assign(start, end);
+    }
+  }
+  return std::make_unique<SharedWalIterator>(store_, std::move(entries));
+}
+
+}  // namespace wal
+}  // namespace nebula
@@ -0,0 +1,269 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef WAL_SHAREDWAL_H_
+#define WAL_SHAREDWAL_H_
+
+#include <gtest/gtest_prod.h>
+
+#include "common/base/Base.h"
+#include "kvstore/DiskManager.h"
+#include "kvstore/wal/AtomicLogBuffer.h"
+#include "kvstore/wal/FileBasedWal.h"
+#include "kvstore/wal/Wal.h"
+
+DECLARE_bool(enable_shared_wal);
+
+namespace nebula {
+namespace wal {
+
+/**
+ * @brief The segmented log shared by the parts whose wal are in the same directory, e.g. the parts
+ * of a space on the same disk. The logs of all parts are appended to the last segment file, so the
+ * writes are sequential, and a segment is removed once no part refers to it and all the older ones
+ * are removed.
+ *
+ * Each record is encoded as:
+ * | type(int8) | space(int32) | part(int32) | id(LogID) | term(TermID) | len(int32) |
+ * | cluster(ClusterID) | msg | len(int32) |
+ *
+ * Besides the logs, the rollback and reset of a part are recorded as well, so that the index of
+ * each part could be rebuilt by replaying all the segments in order when the store is opened.
+ */
+class SharedWalStore final {
+ public:
+  // The location of a log record
+  struct Entry {
+    LogID id;
+    TermID term;
+    int64_t segment;
+    size_t offset;
+    size_t size;
+  };
+
+  enum class RecordType : int8_t {
+    kLog = 0,
+    // All logs after the id are rolled back
+    kRollback = 1,
+    // All logs are removed
+    kReset = 2,
+  };
+
+  static constexpr size_t kHeaderSize = sizeof(RecordType) + sizeof(GraphSpaceID) +
+                                        sizeof(PartitionID) + sizeof(LogID) + sizeof(TermID) +
+                                        sizeof(int32_t) + sizeof(ClusterID);
+
+  /**
+   * @brief Return the store of the directory, the stores are shared by the wal in the same
+   * directory
+   *
+   * @param dir Directory to save the segments
+   * @param policy Wal config, the fileSize is the size of each segment
+   */
+  static std::shared_ptr<SharedWalStore> getStore(const std::string& dir,
+                                                  const FileBasedWalPolicy& policy);
+
+  ~SharedWalStore();
+
+  /**
+   * @brief Encode a record and append it to the buffer
+   */
+  static void encode(std::string& buf,
+                     RecordType type,
+                     GraphSpaceID spaceId,
+                     PartitionID partId,
+                     LogID id,
+                     TermID term,
+                     ClusterID cluster,
+                     folly::StringPiece msg);
+
+  /**
+   * @brief Take the log entries of the part recovered from the segments, the references of the
+   * segments are taken as well
+   */
+  std::deque<Entry> claim(GraphSpaceID spaceId, PartitionID partId);
+
+  /**
+   * @brief Give back the log entries of a part which is closed, the segments are still referred by
+   * them until the part claims them again, so the logs persisted are kept when a part is closed or
+   * reopened. The logs are only released by the reset, rollback and clean of the part.
+   */
+  void release(GraphSpaceID spaceId, PartitionID partId, std::deque<Entry> entries);
+
+  /**
+   * @brief Write the encoded records of one part into the last segment
+   *
+   * @param buf Encoded records
+   * @param numLogs The number of log records in the buffer, the segment is referred by them
+   * @return std::pair<int64_t, size_t> The segment and the offset where the buffer is written
+   */
+  std::pair<int64_t, size_t> write(const std::string& buf, int64_t numLogs);
+
+  /**
+   * @brief Read a log record, return false if the segment has been removed
+   */
+  bool read(const Entry& entry, TermID& term, ClusterID& cluster, std::string& msg);
+
+  /**
+   * @brief Release the references of the segment, the segments no longer referred are removed
+   */
+  void unref(int64_t segment, int64_t count = 1);
+
+  /**
+   * @brief Return the last modified time of the segment in seconds
+   */
+  int64_t mtime(int64_t segment);
+
+  /**
+   * @brief Return the segment being written
+   */
+  int64_t currentSegment();
+
+  /**
+   * @brief Drop the logs recovered but not claimed by any part after the wal ttl is expired, e.g.
+   * the logs of parts which had been removed when the service was down
+   */
+  void dropUnclaimed();
+
+ private:
+  struct Segment {
+    std::string path;
+    size_t size{0};
+    int64_t mtime{0};
+    int64_t refs{0};
+    int32_t readFd{-1};
+  };
+
+  SharedWalStore(std::string dir, FileBasedWalPolicy policy);
+
+  // Replay all the segments in order to rebuild the entries of each part
+  void recover();
+
+  // Remove the segments not referred from the oldest one
+  void removeSegments();
+
+  std::string segmentPath(int64_t segment) const;
+
+  const std::string dir_;
+  const FileBasedWalPolicy policy_;
+  int64_t openTime_{0};
+
+  std::mutex lock_;
+  std::map<int64_t, Segment> segments_;
+  int64_t currSegment_{0};
+  int32_t currFd_{-1};
+  std::unordered_map<std::pair<GraphSpaceID, PartitionID>, std::deque<Entry>> recovered_;
+  // The entries of the parts closed, which are not dropped as the unclaimed ones
+  std::unordered_map<std::pair<GraphSpaceID, PartitionID>, std::deque<Entry>> released_;
+};
+
+/**
+ * @brief Wal of one part whose logs are saved in the SharedWalStore. The locations of the logs
+ * are indexed in memory, and the recent logs are cached in the AtomicLogBuffer as FileBasedWal
+ * does.
+ */
+class SharedWal final : public Wal, public std::enable_shared_from_this<SharedWal> {
+  FRIEND_TEST(SharedWal, CleanWalTest);
+
+ public:
+  /**
+   * @brief Build the shared wal of a part
+   *
+   * @param dir Directory of the SharedWalStore
+   * @param info Wal info
+   * @param policy Wal config
+   * @param preProcessor The pre-process fuction
+   * @param diskMan Disk manager to monitor remaining spaces
+   * @return std::shared_ptr<SharedWal>
+   */
+  static std::shared_ptr<SharedWal> getWal(
+      const folly::StringPiece dir,
+      FileBasedWalInfo info,
+      FileBasedWalPolicy policy,
+      PreProcessor preProcessor,
+      std::shared_ptr<kvstore::DiskManager> diskMan = nullptr);
+
+  ~SharedWal();
+
+  LogID firstLogId() const override;
+
+  LogID lastLogId() const override;
+
+  TermID lastLogTerm() const override;
+
+  /**
+   * @brief Return the size of the records of this part in the segments
+   */
+  size_t sizeInBytes() const override;
+
+  TermID getLogTerm(LogID id) override;
+
+  bool appendLog(LogID id, TermID term, ClusterID cluster, std::string msg) override;
+
+  bool appendLogs(LogIterator& iter) override;
+
+  bool rollbackToLog(LogID id) override;
+
+  /**
+   * @brief The logs of the part are copied as a FileBasedWal in the new path
+   */
+  bool linkCurrentWAL(const char* newPath) override;
+
+  bool reset() override;
+
+  /**
+   * @brief Clean the logs in the segments whose ttl is expired, the last log is rewritten into the
+   * current segment if it's expired, so that an idle part doesn't keep the old segments
+   */
+  void cleanWAL() override;
+
+  /**
+   * @brief Clean the logs before the id whose ttl is expired
+   */
+  void cleanWAL(LogID id) override;
+
+  std::unique_ptr<LogIterator> iterator(LogID firstLogId, LogID lastLogId) override;
+
+  /**
+   * @brief Return the log buffer in memory
+   */
+  std::shared_ptr<AtomicLogBuffer> buffer() {
+    return logBuffer_;
+  }
+
+ private:
+  SharedWal(const folly::StringPiece dir,
+            FileBasedWalInfo info,
+            FileBasedWalPolicy policy,
+            PreProcessor preProcessor,
+            std::shared_ptr<kvstore::DiskManager> diskMan);
+
+  // Write the records into the store, and index the logs in them
+  void write(const std::string& buf,
+             std::vector<std::tuple<LogID, TermID, ClusterID, std::string>>& logs);
+
+  // Drop the entries whose segments are expired, the first n entries at most are dropped
+  void dropExpired(size_t n);
+
+  std::string idStr_;
+  GraphSpaceID spaceId_;
+  PartitionID partId_;
+  FileBasedWalPolicy policy_;
+  PreProcessor preProcessor_;
+  std::shared_ptr<kvstore::DiskManager> diskMan_;
+  std::shared_ptr<SharedWalStore> store_;
+  std::shared_ptr<AtomicLogBuffer> logBuffer_;
+
+  // The entries are protected by the lock, the logs are only appended by one thread
+  mutable std::mutex lock_;
+  std::deque<SharedWalStore::Entry> entries_;
+  // The total size of the entries
+  size_t bytes_{0};
+};
+
+}  // namespace wal
+}  // namespace nebula
+
+#endif  // WAL_SHAREDWAL_H_
@@ -100,6 +100,11 @@ class Wal {
    * @return std::unique_ptr<LogIterator>
    */
   virtual std::unique_ptr<LogIterator> iterator(LogID firstLogId, LogID lastLogId) = 0;
+
+  /**
+   * @brief Return the bytes of the logs kept in the WAL
+   */
+  virtual size_t sizeInBytes() const = 0;
 };
 
 }  // namespace wal
@@ -13,6 +13,17 @@
 namespace nebula {
 namespace wal {
 
+void checkIteratorSize(std::shared_ptr<AtomicLogBuffer> logBuffer,
+                       LogID from,
+                       LogID to,
+                       int32_t expected) {
+  int32_t count = 0;
+  for (auto iter = logBuffer->iterator(from, to); iter->valid(); ++(*iter)) {
+    count++;
+  }
+  EXPECT_EQ(expected, count);
+}
+
 void checkIterator(std::shared_ptr<AtomicLogBuffer> logBuffer,
                    LogID from,
                    LogID to,
@@ -146,6 +157,39 @@ TEST(AtomicLogBufferTest, ResetThenPushExceedLimit) {
   CHECK(logBuffer->seek(logId) != nullptr);
 }
 
+TEST(AtomicLogBufferTest, EvictColdestBuffers) {
+  auto poolSize = FLAGS_wal_buffer_pool_size;
+  // Each record is 8 + 8 + 8 = 24 bytes, each node holds kMaxLength logs
+  FLAGS_wal_buffer_pool_size = 24 * kMaxLength * 5;
+  auto base = LogBufferPool::instance().used();
+  auto cold = AtomicLogBuffer::instance();
+  auto hot = AtomicLogBuffer::instance();
+  for (LogID logId = 0; logId < kMaxLength * 3; logId++) {
+    cold->push(logId, Record(0, 0, std::string(8, 'a')));
+  }
+  EXPECT_EQ(24 * kMaxLength * 3, LogBufferPool::instance().used() - base);
+  // Make sure the buffers have different push time
+  usleep(10 * 1000);
+  for (LogID logId = 0; logId < kMaxLength * 3; logId++) {
+    hot->push(logId, Record(0, 0, std::string(8, 'a')));
+  }
+  // Only the head node of the cold buffer is kept
+  EXPECT_EQ(kMaxLength * 2, cold->firstLogId());
+  EXPECT_EQ(24 * kMaxLength, cold->size_.load());
+  EXPECT_EQ(0, hot->firstLogId());
+  EXPECT_LE(LogBufferPool::instance().used() - base, FLAGS_wal_buffer_pool_size);
+  {
+    auto iter = cold->iterator(0, kMaxLength * 3 - 1);
+    EXPECT_FALSE(iter->valid());
+  }
+  checkIteratorSize(cold, kMaxLength * 2, kMaxLength * 3 - 1, kMaxLength);
+
+  cold.reset();
+  hot.reset();
+  EXPECT_EQ(base, LogBufferPool::instance().used());
+  FLAGS_wal_buffer_pool_size = poolSize;
+}
+
 }  // namespace wal
 }  // namespace nebula
 
@@ -120,6 +120,58 @@ TEST(FileBasedWal, CacheOverflow) {
   EXPECT_EQ(10001, id);
 }
 
+TEST(FileBasedWal, AppendLogsInBatch) {
+  FileBasedWalInfo info;
+  FileBasedWalPolicy policy;
+  policy.fileSize = 1024L * 1024L;
+  policy.sync = true;
+
+  TempDir srcDir("/tmp/testWal.XXXXXX");
+  auto src = FileBasedWal::getWal(
+      srcDir.path(), info, policy, [](LogID, TermID, ClusterID, const std::string&) {
+        return true;
+      });
+  for (int i = 1; i <= 3000; i++) {
+    ASSERT_TRUE(
+        src->appendLog(i /*id*/, 1 /*term*/, 0 /*cluster*/, folly::stringPrintf(kLongMsg, i)));
+  }
+
+  // The logs are appended together, and the wal is rolled over in the middle of the batch
+  TempDir walDir("/tmp/testWal.XXXXXX");
+  auto wal = FileBasedWal::getWal(
+      walDir.path(), info, policy, [](LogID, TermID, ClusterID, const std::string&) {
+        return true;
+      });
+  auto srcIt = src->iterator(1, 3000);
+  ASSERT_TRUE(wal->appendLogs(*srcIt));
+  ASSERT_EQ(3000, wal->lastLogId());
+  ASSERT_EQ(1, wal->firstLogId());
+
+  // A gap in the batch fails the append, and the logs before it are kept
+  srcIt = src->iterator(2999, 3000);
+  ASSERT_FALSE(wal->appendLogs(*srcIt));
+  ASSERT_EQ(3000, wal->lastLogId());
+
+  wal.reset();
+  auto files = FileUtils::listAllFilesInDir(walDir.path());
+  ASSERT_EQ(4, files.size());
+
+  wal = FileBasedWal::getWal(
+      walDir.path(), info, policy, [](LogID, TermID, ClusterID, const std::string&) {
+        return true;
+      });
+  EXPECT_EQ(3000, wal->lastLogId());
+  auto it = wal->iterator(1, 3000);
+  LogID id = 1;
+  while (it->valid()) {
+    ASSERT_EQ(id, it->logId());
+    ASSERT_EQ(folly::stringPrintf(kLongMsg, id), it->logMsg());
+    ++(*it);
+    ++id;
+  }
+  EXPECT_EQ(3001, id);
+}
+
 TEST(FileBasedWal, Rollback) {
   // Force to make each file 1MB, each buffer is 1MB, and there are two
   // buffers at most
@@ -503,6 +555,67 @@ TEST(FileBasedWal, CheckLastWalTest) {
   }
 }
 
+TEST(FileBasedWal, IndexTest) {
+  FileBasedWalInfo info;
+  FileBasedWalPolicy policy;
+  policy.fileSize = 1024L * 1024L;
+  TempDir walDir("/tmp/testWal.XXXXXX");
+  auto indexPath = FileUtils::joinPath(walDir.path(), "wal.index");
+
+  auto wal = FileBasedWal::getWal(
+      walDir.path(), info, policy, [](LogID, TermID, ClusterID, const std::string&) {
+        return true;
+      });
+  for (int i = 1; i <= 1000; i++) {
+    auto term = i / 100;
+    EXPECT_TRUE(wal->appendLog(i /*id*/, term, 0 /*cluster*/, folly::stringPrintf(kLongMsg, i)));
+  }
+  ASSERT_GT(wal->walFiles_.size(), 1);
+  wal.reset();
+  // The index is written on close
+  ASSERT_TRUE(FileUtils::exist(indexPath));
+
+  {
+    // The files are not read when they are unchanged, and the index is taken
+    wal = FileBasedWal::getWal(
+        walDir.path(), info, policy, [](LogID, TermID, ClusterID, const std::string&) {
+          return true;
+        });
+    EXPECT_FALSE(FileUtils::exist(indexPath));
+    EXPECT_EQ(1, wal->firstLogId());
+    EXPECT_EQ(1000, wal->lastLogId());
+    EXPECT_EQ(10, wal->lastLogTerm());
+    LogID expected = 1;
+    for (auto iter = wal->iterator(1, 1000); iter->valid(); ++iter) {
+      EXPECT_EQ(expected++, iter->logId());
+    }
+    EXPECT_EQ(1001, expected);
+
+    // Append more logs, the index is not valid any more if the wal crashes
+    for (int i = 1001; i <= 1100; i++) {
+      EXPECT_TRUE(
+          wal->appendLog(i /*id*/, 11 /*term*/, 0 /*cluster*/, folly::stringPrintf(kLongMsg, i)));
+    }
+    wal.reset();
+  }
+  {
+    // A file changed after the index is written is scanned
+    std::vector<std::string> files = FileUtils::listAllFilesInDir(walDir.path(), true, "*.wal");
+    std::sort(files.begin(), files.end());
+    size_t size = FileUtils::fileSize(files.back().c_str());
+    auto fd = open(files.back().c_str(), O_WRONLY | O_APPEND);
+    ASSERT_EQ(0, ftruncate(fd, size - sizeof(int32_t)));
+    close(fd);
+
+    wal = FileBasedWal::getWal(
+        walDir.path(), info, policy, [](LogID, TermID, ClusterID, const std::string&) {
+          return true;
+        });
+    EXPECT_EQ(1099, wal->lastLogId());
+    EXPECT_EQ(11, wal->lastLogTerm());
+  }
+}
+
 TEST(FileBasedWal, LinkTest) {
   TempDir walDir("/tmp/testWal.XXXXXX");
   FileBasedWalInfo info;
@@ -0,0 +1,175 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include "kvstore/wal/SharedWal.h"
+
+DECLARE_int32(wal_ttl);
+
+namespace nebula {
+namespace wal {
+
+using nebula::fs::FileUtils;
+using nebula::fs::TempDir;
+
+namespace {
+
+std::shared_ptr<SharedWal> openWal(const char* dir, PartitionID partId, size_t fileSize = 1024) {
+  FileBasedWalInfo info;
+  info.idStr_ = folly::stringPrintf("[part %d] ", partId);
+  info.spaceId_ = 1;
+  info.partId_ = partId;
+  FileBasedWalPolicy policy;
+  policy.fileSize = fileSize;
+  return SharedWal::getWal(
+      dir, info, policy, [](LogID, TermID, ClusterID, const std::string&) { return true; });
+}
+
+void checkLogs(std::shared_ptr<SharedWal> wal, LogID first, LogID last, PartitionID partId) {
+  EXPECT_EQ(first, wal->firstLogId());
+  EXPECT_EQ(last, wal->lastLogId());
+  auto id = first;
+  for (auto iter = wal->iterator(first, last); iter->valid(); ++(*iter)) {
+    EXPECT_EQ(id, iter->logId());
+    EXPECT_EQ(folly::stringPrintf("Part %d log %03ld", partId, id), iter->logMsg().toString());
+    id++;
+  }
+  EXPECT_EQ(last + 1, id);
+}
+
+}  // namespace
+
+TEST(SharedWal, AppendLogsOfParts) {
+  TempDir walDir("/tmp/testSharedWal.XXXXXX");
+  {
+    auto wal1 = openWal(walDir.path(), 1);
+    auto wal2 = openWal(walDir.path(), 2);
+    EXPECT_EQ(0, wal1->lastLogId());
+    EXPECT_EQ(0, wal2->lastLogId());
+    for (int32_t i = 1; i <= 100; i++) {
+      EXPECT_TRUE(wal1->appendLog(i, 1, 0, folly::stringPrintf("Part 1 log %03d", i)));
+      EXPECT_TRUE(wal2->appendLog(i, 2, 0, folly::stringPrintf("Part 2 log %03d", i)));
+    }
+    // There is a gap
+    EXPECT_FALSE(wal1->appendLog(102, 1, 0, "Part 1 log 102"));
+    EXPECT_EQ(2, wal2->getLogTerm(50));
+    EXPECT_EQ(FileBasedWal::INVALID_TERM, wal2->getLogTerm(101));
+    // Both parts write into the same segments
+    EXPECT_LT(1, FileUtils::listAllFilesInDir(walDir.path(), false, "*.swal").size());
+    checkLogs(wal1, 1, 100, 1);
+    checkLogs(wal2, 1, 100, 2);
+  }
+
+  // Reopen the wal, all logs are recovered from the segments
+  auto wal1 = openWal(walDir.path(), 1);
+  auto wal2 = openWal(walDir.path(), 2);
+  EXPECT_EQ(1, wal1->lastLogTerm());
+  EXPECT_EQ(2, wal2->lastLogTerm());
+  checkLogs(wal1, 1, 100, 1);
+  checkLogs(wal2, 1, 100, 2);
+}
+
+TEST(SharedWal, CloseAndReopen) {
+  TempDir walDir("/tmp/testSharedWal.XXXXXX");
+  auto wal2 = openWal(walDir.path(), 2);
+  {
+    auto wal1 = openWal(walDir.path(), 1);
+    for (int32_t i = 1; i <= 100; i++) {
+      EXPECT_TRUE(wal1->appendLog(i, 1, 0, folly::stringPrintf("Part 1 log %03d", i)));
+    }
+  }
+  // The store is kept by part 2, the segments of part 1 are not removed when it's closed
+  EXPECT_TRUE(wal2->appendLog(1, 1, 0, "Part 2 log 001"));
+  EXPECT_LT(1, FileUtils::listAllFilesInDir(walDir.path(), false, "*.swal").size());
+  {
+    auto wal1 = openWal(walDir.path(), 1);
+    checkLogs(wal1, 1, 100, 1);
+  }
+
+  // Close all the parts and the store, then reopen them
+  wal2.reset();
+  auto wal1 = openWal(walDir.path(), 1);
+  wal2 = openWal(walDir.path(), 2);
+  checkLogs(wal1, 1, 100, 1);
+  checkLogs(wal2, 1, 1, 2);
+}
+
+TEST(SharedWal, RollbackAndReset) {
+  TempDir walDir("/tmp/testSharedWal.XXXXXX");
+  {
+    auto wal1 = openWal(walDir.path(), 1);
+    auto wal2 = openWal(walDir.path(), 2);
+    for (int32_t i = 1; i <= 100; i++) {
+      EXPECT_TRUE(wal1->appendLog(i, 1, 0, folly::stringPrintf("Part 1 log %03d", i)));
+      EXPECT_TRUE(wal2->appendLog(i, 1, 0, folly::stringPrintf("Part 2 log %03d", i)));
+    }
+    EXPECT_FALSE(wal1->rollbackToLog(101));
+    EXPECT_TRUE(wal1->rollbackToLog(50));
+    checkLogs(wal1, 1, 50, 1);
+    checkLogs(wal2, 1, 100, 2);
+    // Append the logs after rollback
+    for (int32_t i = 51; i <= 60; i++) {
+      EXPECT_TRUE(wal1->appendLog(i, 3, 0, folly::stringPrintf("Part 1 log %03d", i)));
+    }
+    EXPECT_TRUE(wal2->reset());
+    EXPECT_EQ(0, wal2->lastLogId());
+  }
+
+  auto wal1 = openWal(walDir.path(), 1);
+  auto wal2 = openWal(walDir.path(), 2);
+  checkLogs(wal1, 1, 60, 1);
+  EXPECT_EQ(3, wal1->lastLogTerm());
+  EXPECT_EQ(1, wal1->getLogTerm(50));
+  EXPECT_EQ(0, wal2->firstLogId());
+  EXPECT_EQ(0, wal2->lastLogId());
+}
+
+TEST(SharedWal, CleanWalTest) {
+  auto ttl = FLAGS_wal_ttl;
+  FLAGS_wal_ttl = 1;
+  TempDir walDir("/tmp/testSharedWal.XXXXXX");
+  auto wal1 = openWal(walDir.path(), 1);
+  auto wal2 = openWal(walDir.path(), 2);
+  for (int32_t i = 1; i <= 100; i++) {
+    EXPECT_TRUE(wal1->appendLog(i, 1, 0, folly::stringPrintf("Part 1 log %03d", i)));
+    EXPECT_TRUE(wal2->appendLog(i, 1, 0, folly::stringPrintf("Part 2 log %03d", i)));
+  }
+  auto numSegments = FileUtils::listAllFilesInDir(walDir.path(), false, "*.swal").size();
+  EXPECT_LT(1, numSegments);
+  sleep(FLAGS_wal_ttl + 1);
+
+  // The segments are still referred by part 2
+  wal1->cleanWAL();
+  EXPECT_EQ(100, wal1->firstLogId());
+  EXPECT_EQ(100, wal1->lastLogId());
+  EXPECT_EQ(numSegments, FileUtils::listAllFilesInDir(walDir.path(), false, "*.swal").size());
+
+  // Only the logs before 50 could be removed
+  wal2->cleanWAL(50);
+  EXPECT_EQ(50, wal2->firstLogId());
+  checkLogs(wal2, 50, 100, 2);
+  wal2->cleanWAL();
+  EXPECT_EQ(100, wal2->firstLogId());
+  // The last logs are rewritten into the current segment, the others are removed
+  EXPECT_EQ(1, FileUtils::listAllFilesInDir(walDir.path(), false, "*.swal").size());
+  checkLogs(wal1, 100, 100, 1);
+  checkLogs(wal2, 100, 100, 2);
+  EXPECT_EQ(wal1->store_->currentSegment(), wal1->entries_.front().segment);
+  FLAGS_wal_ttl = ttl;
+}
+
+}  // namespace wal
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+
+  return RUN_ALL_TESTS();
+}
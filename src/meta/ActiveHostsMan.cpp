@@ -23,6 +23,7 @@ nebula::cpp2::ErrorCode ActiveHostsMan::updateHostInfo(kvstore::KVStore* kv,
                                                        std::vector<kvstore::KV>& data,
                                                        const AllLeaders* allLeaders) {
   CHECK_NOTNULL(kv);
+  auto size = data.size();
   std::vector<std::string> leaderKeys;
   std::vector<int64_t> terms;
   if (allLeaders != nullptr) {
@@ -61,12 +62,13 @@ nebula::cpp2::ErrorCode ActiveHostsMan::updateHostInfo(kvstore::KVStore* kv,
     }
   }
   // indicate whether any leader info is updated
-  bool hasUpdate = !data.empty();
+  bool hasUpdate = data.size() > size;
   data.emplace_back(MetaKeyUtils::hostKey(hostAddr.host, hostAddr.port), HostInfo::encodeV2(info));
 
   if (hasUpdate) {
     auto timeInMilliSec = time::WallClock::fastNowInMilliSec();
-    LastUpdateTimeMan::update(data, timeInMilliSec);
+    // The leaders are reloaded by the clients whenever the last update time changes
+    LastUpdateTimeMan::touch(data, timeInMilliSec);
   }
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
@@ -262,13 +264,151 @@ ErrorOr<nebula::cpp2::ErrorCode, HostInfo> ActiveHostsMan::getHostInfo(kvstore::
 }
 
 void LastUpdateTimeMan::update(std::vector<kvstore::KV>& data, const int64_t timeInMilliSec) {
-  data.emplace_back(MetaKeyUtils::lastUpdateTimeKey(),
+  touch(data, timeInMilliSec);
+  data.emplace_back(MetaKeyUtils::globalUpdateTimeKey(),
                     MetaKeyUtils::lastUpdateTimeVal(timeInMilliSec));
 }
 
 void LastUpdateTimeMan::update(kvstore::BatchHolder* batchHolder, const int64_t timeInMilliSec) {
   batchHolder->put(MetaKeyUtils::lastUpdateTimeKey(),
                    MetaKeyUtils::lastUpdateTimeVal(timeInMilliSec));
+  batchHolder->put(MetaKeyUtils::globalUpdateTimeKey(),
+                   MetaKeyUtils::lastUpdateTimeVal(timeInMilliSec));
+}
+
+void LastUpdateTimeMan::update(std::vector<kvstore::KV>& data,
+                               GraphSpaceID spaceId,
+                               const int64_t timeInMilliSec) {
+  touch(data, timeInMilliSec);
+  data.emplace_back(MetaKeyUtils::spaceUpdateTimeKey(spaceId),
+                    MetaKeyUtils::lastUpdateTimeVal(timeInMilliSec));
+}
+
+void LastUpdateTimeMan::update(kvstore::BatchHolder* batchHolder,
+                               GraphSpaceID spaceId,
+                               const int64_t timeInMilliSec) {
+  batchHolder->put(MetaKeyUtils::lastUpdateTimeKey(),
+                   MetaKeyUtils::lastUpdateTimeVal(timeInMilliSec));
+  batchHolder->put(MetaKeyUtils::spaceUpdateTimeKey(spaceId),
+                   MetaKeyUtils::lastUpdateTimeVal(timeInMilliSec));
+}
+
+void LastUpdateTimeMan::touch(std::vector<kvstore::KV>& data, const int64_t timeInMilliSec) {
+  data.emplace_back(MetaKeyUtils::lastUpdateTimeKey(),
+                    MetaKeyUtils::lastUpdateTimeVal(timeInMilliSec));
+}
+
+namespace {
+
+struct PartLoadReport {
+  int64_t timeInMilliSec;
+  PartLoadMan::PartLoads loads;
+};
+
+std::mutex& partLoadLock() {
+  static std::mutex lock;
+  return lock;
+}
+
+std::unordered_map<HostAddr, PartLoadReport>& partLoadReports() {
+  static std::unordered_map<HostAddr, PartLoadReport> reports;
+  return reports;
+}
+
+}  // namespace
+
+void PartLoadMan::update(const HostAddr& host, PartLoads loads) {
+  std::lock_guard<std::mutex> guard(partLoadLock());
+  partLoadReports()[host] = PartLoadReport{time::WallClock::fastNowInMilliSec(), std::move(loads)};
+}
+
+std::unordered_map<PartitionID, int64_t> PartLoadMan::get(GraphSpaceID spaceId) {
+  int64_t threshold = FLAGS_heartbeat_interval_secs * FLAGS_expired_time_factor * 1000;
+  auto now = time::WallClock::fastNowInMilliSec();
+  std::unordered_map<PartitionID, int64_t> loads;
+  std::lock_guard<std::mutex> guard(partLoadLock());
+  for (const auto& [host, report] : partLoadReports()) {
+    if (now - report.timeInMilliSec >= threshold) {
+      continue;
+    }
+    auto iter = report.loads.find(spaceId);
+    if (iter == report.loads.end()) {
+      continue;
+    }
+    for (const auto& [partId, load] : iter->second) {
+      loads[partId] += load;
+    }
+  }
+  return loads;
+}
+
+void PartLoadMan::clear() {
+  std::lock_guard<std::mutex> guard(partLoadLock());
+  partLoadReports().clear();
+}
+
+namespace {
+
+std::mutex& killedQueryLock() {
+  static std::mutex lock;
+  return lock;
+}
+
+// The graph of each query being killed
+std::unordered_map<SessionID, std::unordered_map<ExecutionPlanID, HostAddr>>& killedQueries() {
+  static std::unordered_map<SessionID, std::unordered_map<ExecutionPlanID, HostAddr>> queries;
+  return queries;
+}
+
+}  // namespace
+
+void KilledQueryMan::add(SessionID sessionId, ExecutionPlanID epId, const HostAddr& graph) {
+  std::lock_guard<std::mutex> guard(killedQueryLock());
+  killedQueries()[sessionId][epId] = graph;
+}
+
+void KilledQueryMan::ack(const cpp2::Session& session) {
+  std::lock_guard<std::mutex> guard(killedQueryLock());
+  auto iter = killedQueries().find(session.get_session_id());
+  if (iter == killedQueries().end()) {
+    return;
+  }
+  const auto& queries = session.get_queries();
+  auto& killing = iter->second;
+  for (auto query = killing.begin(); query != killing.end();) {
+    auto found = queries.find(query->first);
+    if (found == queries.end() || found->second.get_status() == cpp2::QueryStatus::KILLING) {
+      query = killing.erase(query);
+    } else {
+      ++query;
+    }
+  }
+  if (killing.empty()) {
+    killedQueries().erase(iter);
+  }
+}
+
+void KilledQueryMan::remove(SessionID sessionId) {
+  std::lock_guard<std::mutex> guard(killedQueryLock());
+  killedQueries().erase(sessionId);
+}
+
+KilledQueryMan::KilledQueries KilledQueryMan::get(const HostAddr& graph) {
+  KilledQueries result;
+  std::lock_guard<std::mutex> guard(killedQueryLock());
+  for (const auto& [sessionId, queries] : killedQueries()) {
+    for (const auto& [epId, host] : queries) {
+      if (host == graph) {
+        result[sessionId].emplace(epId);
+      }
+    }
+  }
+  return result;
+}
+
+void KilledQueryMan::clear() {
+  std::lock_guard<std::mutex> guard(killedQueryLock());
+  killedQueries().clear();
 }
 
 }  // namespace meta
@@ -214,14 +214,105 @@ class LastUpdateTimeMan final {
  public:
   ~LastUpdateTimeMan() = default;
 
+  /**
+   * @brief Update the last update time for the changes not belonging to any space, the clients
+   * reload all the meta data
+   */
   static void update(std::vector<kvstore::KV>& data, const int64_t timeInMilliSec);
 
   static void update(kvstore::BatchHolder* batchHolder, const int64_t timeInMilliSec);
 
+  /**
+   * @brief Update the last update time for the changes of schemas, indexes or listeners of the
+   * space, the clients only reload the space and the meta data not belonging to any space
+   */
+  static void update(std::vector<kvstore::KV>& data,
+                     GraphSpaceID spaceId,
+                     const int64_t timeInMilliSec);
+
+  static void update(kvstore::BatchHolder* batchHolder,
+                     GraphSpaceID spaceId,
+                     const int64_t timeInMilliSec);
+
+  /**
+   * @brief Only update the last update time, for the changes reloaded by the clients anyway,
+   * i.e. the leaders
+   */
+  static void touch(std::vector<kvstore::KV>& data, const int64_t timeInMilliSec);
+
  protected:
   LastUpdateTimeMan() = default;
 };
 
+/**
+ * @brief The recent requests of the parts reported by the heartbeats of the storages. They are
+ * only kept in the memory of the meta leader, and used to balance the leaders by load.
+ */
+class PartLoadMan final {
+ public:
+  using PartLoads = std::unordered_map<GraphSpaceID, std::unordered_map<PartitionID, int64_t>>;
+
+  ~PartLoadMan() = default;
+
+  /**
+   * @brief Replace the loads reported by the host
+   *
+   * @param host
+   * @param loads
+   */
+  static void update(const HostAddr& host, PartLoads loads);
+
+  /**
+   * @brief The loads of the parts of the space summed over the hosts, which have reported within
+   * the expired time, the part served by several leaders recently is counted by all of them
+   *
+   * @param spaceId
+   * @return
+   */
+  static std::unordered_map<PartitionID, int64_t> get(GraphSpaceID spaceId);
+
+  static void clear();
+
+ protected:
+  PartLoadMan() = default;
+};
+
+/**
+ * @brief The queries being killed, which are pushed to their graphs by the heartbeats until the
+ * graphs update the sessions with them killed or finished. They are only kept in the memory of
+ * the meta leader, the status persisted in the sessions is still returned when updating them.
+ */
+class KilledQueryMan final {
+ public:
+  using KilledQueries = std::unordered_map<SessionID, std::unordered_set<ExecutionPlanID>>;
+
+  ~KilledQueryMan() = default;
+
+  static void add(SessionID sessionId, ExecutionPlanID epId, const HostAddr& graph);
+
+  /**
+   * @brief Remove the queries of the session updated by the graph, which are killed or finished
+   *
+   * @param session
+   */
+  static void ack(const cpp2::Session& session);
+
+  static void remove(SessionID sessionId);
+
+  /**
+   * @brief The queries to kill on the graph
+   *
+   * @param graph
+   * @return
+   */
+  static KilledQueries get(const HostAddr& graph);
+
+  static void clear();
+
+ protected:
+  KilledQueryMan() = default;
+};
+
 }  // namespace meta
 }  // namespace nebula
 
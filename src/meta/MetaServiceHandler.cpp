@@ -93,7 +93,7 @@ folly::Future<cpp2::ExecResp> MetaServiceHandler::future_alterSpace(
 
 folly::Future<cpp2::ExecResp> MetaServiceHandler::future_createSpaceAs(
     const cpp2::CreateSpaceAsReq& req) {
-  auto* processor = CreateSpaceAsProcessor::instance(kvstore_);
+  auto* processor = CreateSpaceAsProcessor::instance(kvstore_, adminClient_.get());
   RETURN_FUTURE(processor);
 }
 
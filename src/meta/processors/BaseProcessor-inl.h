@@ -446,11 +446,15 @@ nebula::cpp2::ErrorCode BaseProcessor<RESP>::indexCheck(
           *tagItem.op_ref() == nebula::meta::cpp2::AlterSchemaOp::DROP) {
         const auto& tagCols = tagItem.get_schema().get_columns();
         const auto& indexCols = index.get_fields();
+        const auto* includeCols = index.get_include_fields();
         for (const auto& tCol : tagCols) {
-          auto it = std::find_if(indexCols.begin(), indexCols.end(), [&](const auto& iCol) {
-            return tCol.name == iCol.name;
-          });
-          if (it != indexCols.end()) {
+          auto sameName = [&](const auto& iCol) { return tCol.name == iCol.name; };
+          auto it = std::find_if(indexCols.begin(), indexCols.end(), sameName);
+          // The values of the included columns are saved in the index as well
+          if (it != indexCols.end() ||
+              (includeCols != nullptr &&
+               std::find_if(includeCols->begin(), includeCols->end(), sameName) !=
+                   includeCols->end())) {
             LOG(INFO) << "Index conflict, index :" << index.get_index_name()
                       << ", column : " << tCol.name;
             return nebula::cpp2::ErrorCode::E_CONFLICT;
@@ -498,6 +502,37 @@ bool BaseProcessor<RESP>::checkIndexExist(const std::vector<cpp2::IndexFieldDef>
   return true;
 }
 
+template <typename RESP>
+ErrorOr<nebula::cpp2::ErrorCode, std::vector<cpp2::ColumnDef>>
+BaseProcessor<RESP>::getIncludeColumns(const std::vector<std::string>& names,
+                                       const std::vector<cpp2::IndexFieldDef>& fields,
+                                       const std::vector<cpp2::ColumnDef>& schemaCols) {
+  std::set<std::string> nameSet;
+  std::vector<cpp2::ColumnDef> columns;
+  for (const auto& name : names) {
+    if (!nameSet.emplace(name).second) {
+      LOG(INFO) << "Conflict include field " << name;
+      return nebula::cpp2::ErrorCode::E_CONFLICT;
+    }
+    auto indexed = std::find_if(fields.begin(), fields.end(), [&name](const auto& field) {
+      return field.get_name() == name;
+    });
+    if (indexed != fields.end()) {
+      LOG(INFO) << "Include field " << name << " is indexed already";
+      return nebula::cpp2::ErrorCode::E_CONFLICT;
+    }
+    auto iter = std::find_if(schemaCols.begin(), schemaCols.end(), [&name](const auto& col) {
+      return col.get_name() == name;
+    });
+    if (iter == schemaCols.end()) {
+      LOG(INFO) << "Include field " << name << " not found";
+      return nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND;
+    }
+    columns.emplace_back(*iter);
+  }
+  return columns;
+}
+
 template <typename RESP>
 nebula::cpp2::ErrorCode BaseProcessor<RESP>::zoneExist(const std::string& zoneName) {
   auto zoneKey = MetaKeyUtils::zoneKey(zoneName);
@@ -388,6 +388,21 @@ class BaseProcessor {
    */
   bool checkIndexExist(const std::vector<cpp2::IndexFieldDef>& fields, const cpp2::IndexItem& item);
 
+  /**
+   * @brief Get the definitions of the columns included in the index value, the included columns
+   * must be in the schema and not be any indexed field.
+   *
+   * @tparam RESP
+   * @param names Names of the included columns
+   * @param fields Indexed fields
+   * @param schemaCols Columns of the latest schema
+   * @return ErrorOr<nebula::cpp2::ErrorCode, std::vector<cpp2::ColumnDef>>
+   */
+  ErrorOr<nebula::cpp2::ErrorCode, std::vector<cpp2::ColumnDef>> getIncludeColumns(
+      const std::vector<std::string>& names,
+      const std::vector<cpp2::IndexFieldDef>& fields,
+      const std::vector<cpp2::ColumnDef>& schemaCols);
+
   /**
    * @brief Check if given zone exist.
    *
@@ -688,7 +688,10 @@ folly::Future<Status> AdminClient::getLeaderDist(HostLeaderMap* result) {
 }
 
 folly::Future<StatusOr<cpp2::HostBackupInfo>> AdminClient::createSnapshot(
-    const std::set<GraphSpaceID>& spaceIds, const std::string& name, const HostAddr& host) {
+    const std::set<GraphSpaceID>& spaceIds,
+    const std::string& name,
+    const HostAddr& host,
+    const std::string& baseName) {
   folly::Promise<StatusOr<cpp2::HostBackupInfo>> pro;
   auto f = pro.getFuture();
 
@@ -697,6 +700,9 @@ folly::Future<StatusOr<cpp2::HostBackupInfo>> AdminClient::createSnapshot(
   std::vector<GraphSpaceID> idList(spaceIds.begin(), spaceIds.end());
   req.space_ids_ref() = idList;
   req.name_ref() = name;
+  if (!baseName.empty()) {
+    req.base_name_ref() = baseName;
+  }
   getResponseFromHost(
       adminAddr,
       std::move(req),
@@ -716,6 +722,55 @@ folly::Future<StatusOr<cpp2::HostBackupInfo>> AdminClient::createSnapshot(
   return f;
 }
 
+folly::Future<Status> AdminClient::cloneSpaceData(GraphSpaceID spaceId,
+                                                  GraphSpaceID newSpaceId,
+                                                  const HostAddr& host) {
+  folly::Promise<Status> pro;
+  auto f = pro.getFuture();
+  auto adminAddr = Utils::getAdminAddrFromStoreAddr(host);
+  storage::cpp2::CreateCPRequest req;
+  req.space_ids_ref() = {spaceId};
+  req.name_ref() = folly::sformat("clone_{}", newSpaceId);
+  req.clone_to_space_ref() = newSpaceId;
+  getResponseFromHost(
+      adminAddr,
+      std::move(req),
+      [](auto client, auto request) { return client->future_createCheckpoint(request); },
+      [](storage::cpp2::CreateCPResp&& resp) -> Status {
+        if (resp.get_code() == nebula::cpp2::ErrorCode::SUCCEEDED) {
+          return Status::OK();
+        }
+        return Status::Error("Clone space failed: %s",
+                             apache::thrift::util::enumNameSafe(resp.get_code()).c_str());
+      },
+      std::move(pro));
+  return f;
+}
+
+folly::Future<Status> AdminClient::dropClonedSpaceData(GraphSpaceID newSpaceId,
+                                                       const HostAddr& host) {
+  folly::Promise<Status> pro;
+  auto f = pro.getFuture();
+  auto adminAddr = Utils::getAdminAddrFromStoreAddr(host);
+  storage::cpp2::DropCPRequest req;
+  req.space_ids_ref() = {newSpaceId};
+  req.name_ref() = folly::sformat("clone_{}", newSpaceId);
+  req.drop_clone_ref() = true;
+  getResponseFromHost(
+      adminAddr,
+      std::move(req),
+      [](auto client, auto request) { return client->future_dropCheckpoint(request); },
+      [](storage::cpp2::DropCPResp&& resp) -> Status {
+        if (resp.get_code() == nebula::cpp2::ErrorCode::SUCCEEDED) {
+          return Status::OK();
+        }
+        return Status::Error("Drop cloned space failed: %s",
+                             apache::thrift::util::enumNameSafe(resp.get_code()).c_str());
+      },
+      std::move(pro));
+  return f;
+}
+
 folly::Future<StatusOr<bool>> AdminClient::dropSnapshot(const std::set<GraphSpaceID>& spaceIds,
                                                         const std::string& name,
                                                         const HostAddr& host) {
@@ -175,10 +175,38 @@ class AdminClient {
    * @param spaceIds spaces to create snapshot
    * @param name snapshot name
    * @param host storage host
+   * @param baseName the snapshot created before, the files not in it are listed in the result if
+   * it's not empty
    * @return folly::Future<StatusOr<cpp2::HostBackupInfo>>
    */
   virtual folly::Future<StatusOr<cpp2::HostBackupInfo>> createSnapshot(
-      const std::set<GraphSpaceID>& spaceIds, const std::string& name, const HostAddr& host);
+      const std::set<GraphSpaceID>& spaceIds,
+      const std::string& name,
+      const HostAddr& host,
+      const std::string& baseName = "");
+
+  /**
+   * @brief Clone the data of a space on the host as the data of a new space, which is not created
+   * yet. The storaged creates a checkpoint of the space in place of the new space.
+   *
+   * @param spaceId space to clone
+   * @param newSpaceId new space
+   * @param host storage host
+   * @return folly::Future<Status>
+   */
+  virtual folly::Future<Status> cloneSpaceData(GraphSpaceID spaceId,
+                                               GraphSpaceID newSpaceId,
+                                               const HostAddr& host);
+
+  /**
+   * @brief Remove the data cloned by cloneSpaceData on the host, when the new space fails to be
+   * created
+   *
+   * @param newSpaceId new space
+   * @param host storage host
+   * @return folly::Future<Status>
+   */
+  virtual folly::Future<Status> dropClonedSpaceData(GraphSpaceID newSpaceId, const HostAddr& host);
 
   /**
    * @brief Drop snapshots of given spaces in given host with specified snapshot name
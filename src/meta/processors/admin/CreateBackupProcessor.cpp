@@ -124,6 +124,21 @@ void CreateBackupProcessor::process(const cpp2::CreateBackupReq& req) {
   }
   auto spaces = nebula::value(spaceIdRet);
 
+  // The base of an incremental backup must be a valid one, whose checkpoints are still kept
+  std::string baseBackup;
+  if (req.base_backup_ref().has_value() && !req.base_backup_ref()->empty()) {
+    baseBackup = *req.base_backup_ref();
+    auto baseRet = doGet(MetaKeyUtils::snapshotKey(baseBackup));
+    if (!nebula::ok(baseRet) ||
+        MetaKeyUtils::parseSnapshotStatus(nebula::value(baseRet)) !=
+            cpp2::SnapshotStatus::VALID) {
+      LOG(INFO) << "Base backup " << baseBackup << " is not found or not valid";
+      handleErrorCode(nebula::cpp2::ErrorCode::E_BACKUP_FAILED);
+      onFinished();
+      return;
+    }
+  }
+
   // The entire process follows mostly snapshot logic.
   // step 1 : write a flag key to handle backup failed
   std::vector<kvstore::KV> data;
@@ -154,7 +169,7 @@ void CreateBackupProcessor::process(const cpp2::CreateBackupReq& req) {
   }
 
   // step 3 : Create checkpoint for all storage engines.
-  auto sret = Snapshot::instance(kvstore_, client_)->createSnapshot(backupName);
+  auto sret = Snapshot::instance(kvstore_, client_)->createSnapshot(backupName, baseBackup);
   if (!nebula::ok(sret)) {
     LOG(INFO) << "Checkpoint create error on storage engine: "
               << apache::thrift::util::enumNameSafe(nebula::error(sret));
@@ -241,7 +256,10 @@ void CreateBackupProcessor::process(const cpp2::CreateBackupReq& req) {
   backup.meta_files_ref() = std::move(nebula::value(backupFiles));
   backup.space_backups_ref() = std::move(backups);
   backup.backup_name_ref() = std::move(backupName);
-  backup.full_ref() = true;
+  backup.full_ref() = baseBackup.empty();
+  if (!baseBackup.empty()) {
+    backup.base_backup_ref() = std::move(baseBackup);
+  }
   bool allSpaces = backupSpaces == nullptr || backupSpaces->empty();
   backup.all_spaces_ref() = allSpaces;
   backup.create_time_ref() = time::WallClock::fastNowInMilliSec();
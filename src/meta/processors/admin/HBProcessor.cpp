@@ -10,6 +10,13 @@
 #include "meta/KVBasedClusterIdMan.h"
 #include "meta/MetaVersionMan.h"
 
+DECLARE_int32(heartbeat_interval_secs);
+DECLARE_uint32(expired_time_factor);
+DEFINE_int32(host_info_persist_interval_secs,
+             20,
+             "The interval in seconds to persist the last heartbeat time of a host if nothing else "
+             "of it changes, at most half of the time a host is regarded as expired");
+
 namespace nebula {
 namespace meta {
 
@@ -56,6 +63,10 @@ void HBProcessor::process(const cpp2::HBReq& req) {
       return;
     }
 
+    if (req.part_loads_ref().has_value()) {
+      PartLoadMan::update(host, *req.part_loads_ref());
+    }
+
     // set disk parts map
     if (req.disk_parts_ref().has_value()) {
       for (const auto& [spaceId, partDiskMap] : *req.get_disk_parts()) {
@@ -80,6 +91,15 @@ void HBProcessor::process(const cpp2::HBReq& req) {
     onFinished();
     return;
   }
+  // Most heartbeats change nothing but the time, of which the writes through raft under the lock
+  // of meta would serialize hundreds of hosts, so the time is persisted less often
+  if (hostInfoFresh(host, info)) {
+    auto hostKey = MetaKeyUtils::hostKey(host.host, host.port);
+    data.erase(std::remove_if(data.begin(),
+                              data.end(),
+                              [&hostKey](const auto& kv) { return kv.first == hostKey; }),
+               data.end());
+  }
 
   // update host dir info
   if (req.get_role() == cpp2::HostRole::STORAGE || req.get_role() == cpp2::HostRole::GRAPH) {
@@ -104,17 +124,68 @@ void HBProcessor::process(const cpp2::HBReq& req) {
     resp_.last_update_time_in_ms_ref() = 0;
   }
 
+  // The update times of the changes not belonging to any space and of each space, so that the
+  // clients could only reload the spaces changed
+  int64_t globalUpdateTime = 0;
+  auto globalUpdateTimeRet = doGet(MetaKeyUtils::globalUpdateTimeKey());
+  if (nebula::ok(globalUpdateTimeRet)) {
+    globalUpdateTime = *reinterpret_cast<const int64_t*>(nebula::value(globalUpdateTimeRet).data());
+  }
+  auto spaceUpdateTimesRet = doPrefix(MetaKeyUtils::spaceUpdateTimePrefix());
+  bool found = nebula::ok(globalUpdateTimeRet) ||
+               nebula::error(globalUpdateTimeRet) == nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND;
+  if (found && nebula::ok(spaceUpdateTimesRet)) {
+    std::unordered_map<GraphSpaceID, int64_t> spaceUpdateTimes;
+    auto iter = nebula::value(spaceUpdateTimesRet).get();
+    while (iter->valid()) {
+      spaceUpdateTimes.emplace(MetaKeyUtils::parseSpaceUpdateTimeSpace(iter->key()),
+                               *reinterpret_cast<const int64_t*>(iter->val().data()));
+      iter->next();
+    }
+    resp_.global_update_time_in_ms_ref() = globalUpdateTime;
+    resp_.space_update_time_in_ms_ref() = std::move(spaceUpdateTimes);
+  }
+
   auto version = metaVersion_.load();
   if (version == -1) {
     metaVersion_.store(static_cast<int64_t>(MetaVersionMan::getMetaVersionFromKV(kvstore_)));
   }
 
   resp_.meta_version_ref() = metaVersion_.load();
-  ret = doSyncPut(std::move(data));
+  if (role == cpp2::HostRole::GRAPH) {
+    auto killedQueries = KilledQueryMan::get(host);
+    if (!killedQueries.empty()) {
+      resp_.killed_queries_ref() = std::move(killedQueries);
+    }
+  }
+  if (!data.empty()) {
+    ret = doSyncPut(std::move(data));
+  }
   handleErrorCode(ret);
   onFinished();
 }
 
+bool HBProcessor::hostInfoFresh(const HostAddr& host, const HostInfo& info) {
+  auto ret = doGet(MetaKeyUtils::hostKey(host.host, host.port));
+  if (!nebula::ok(ret)) {
+    return false;
+  }
+  const auto& value = nebula::value(ret);
+  auto persisted = HostInfo::decode(value);
+  // Compare all but the time as encoded, so that any change of the info or of its encoding is
+  // persisted at once
+  HostInfo unchanged = info;
+  unchanged.lastHBTimeInMilliSec_ = persisted.lastHBTimeInMilliSec_;
+  if (HostInfo::encodeV2(unchanged) != value) {
+    return false;
+  }
+  int64_t expiredMs = FLAGS_heartbeat_interval_secs * FLAGS_expired_time_factor * 1000;
+  auto intervalMs =
+      std::min(static_cast<int64_t>(FLAGS_host_info_persist_interval_secs) * 1000, expiredMs / 2);
+  auto elapsedMs = info.lastHBTimeInMilliSec_ - persisted.lastHBTimeInMilliSec_;
+  return elapsedMs >= 0 && elapsedMs < intervalMs;
+}
+
 void HBProcessor::setLeaderInfo() {
   auto leaderRet = kvstore_->partLeader(kDefaultSpaceId, kDefaultPartId);
   if (ok(leaderRet)) {
@@ -9,6 +9,7 @@
 #include <gtest/gtest_prod.h>
 
 #include "common/stats/StatsManager.h"
+#include "meta/ActiveHostsMan.h"
 #include "meta/processors/BaseProcessor.h"
 
 namespace nebula {
@@ -60,6 +61,9 @@ class HBProcessor : public BaseProcessor<cpp2::HBResp> {
 
   void setLeaderInfo();
 
+  // Whether the persisted info of the host is recent enough to skip writing the new one
+  bool hostInfoFresh(const HostAddr& host, const HostInfo& info);
+
   ClusterID clusterId_{0};
   const HBCounters* counters_{nullptr};
   static std::atomic<int64_t> metaVersion_;
@@ -16,7 +16,7 @@ namespace nebula {
 namespace meta {
 ErrorOr<nebula::cpp2::ErrorCode,
         std::unordered_map<GraphSpaceID, std::vector<cpp2::HostBackupInfo>>>
-Snapshot::createSnapshot(const std::string& name) {
+Snapshot::createSnapshot(const std::string& name, const std::string& baseName) {
   auto hostSpacesRet = getHostSpaces();
   if (!nebula::ok(hostSpacesRet)) {
     auto retcode = nebula::error(hostSpacesRet);
@@ -31,7 +31,7 @@ Snapshot::createSnapshot(const std::string& name) {
 
   auto hostSpaces = nebula::value(hostSpacesRet);
   for (auto const& [host, spaces] : hostSpaces) {
-    auto snapshotRet = client_->createSnapshot(spaces, name, host).get();
+    auto snapshotRet = client_->createSnapshot(spaces, name, host, baseName).get();
     if (!snapshotRet.ok()) {
       return nebula::cpp2::ErrorCode::E_RPC_FAILURE;
     }
@@ -35,9 +35,15 @@ class Snapshot {
     spaces_ = std::move(spaces);
   }
 
+  /**
+   * @brief Create the checkpoints of the spaces on all the storage hosts
+   *
+   * @param name snapshot name
+   * @param baseName the snapshot the new files are listed against, empty for a full one
+   */
   ErrorOr<nebula::cpp2::ErrorCode,
           std::unordered_map<GraphSpaceID, std::vector<cpp2::HostBackupInfo>>>
-  createSnapshot(const std::string& name);
+  createSnapshot(const std::string& name, const std::string& baseName = "");
 
   /**
    * @brief Drop specified snapshot in given storage hosts
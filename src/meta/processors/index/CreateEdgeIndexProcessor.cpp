@@ -176,6 +176,17 @@ void CreateEdgeIndexProcessor::process(const cpp2::CreateEdgeIndexReq& req) {
   }
 
   // add index item
+  std::vector<cpp2::ColumnDef> includeColumns;
+  if (req.include_fields_ref().has_value()) {
+    auto includeRet = getIncludeColumns(*req.include_fields_ref(), fields, schemaCols);
+    if (!nebula::ok(includeRet)) {
+      handleErrorCode(nebula::error(includeRet));
+      onFinished();
+      return;
+    }
+    includeColumns = std::move(nebula::value(includeRet));
+  }
+
   std::vector<kvstore::KV> data;
   auto edgeIndexRet = autoIncrementIdInSpace(space);
   if (!nebula::ok(edgeIndexRet)) {
@@ -200,13 +211,16 @@ void CreateEdgeIndexProcessor::process(const cpp2::CreateEdgeIndexReq& req) {
   if (req.comment_ref().has_value()) {
     item.comment_ref() = *req.comment_ref();
   }
+  if (!includeColumns.empty()) {
+    item.include_fields_ref() = std::move(includeColumns);
+  }
   data.emplace_back(MetaKeyUtils::indexIndexKey(space, indexName),
                     std::string(reinterpret_cast<const char*>(&edgeIndex), sizeof(IndexID)));
   data.emplace_back(MetaKeyUtils::indexKey(space, edgeIndex), MetaKeyUtils::indexVal(item));
   LOG(INFO) << "Create Edge Index " << indexName << ", edgeIndex " << edgeIndex;
   resp_.id_ref() = to(edgeIndex, EntryType::INDEX);
   auto timeInMilliSec = time::WallClock::fastNowInMilliSec();
-  LastUpdateTimeMan::update(data, timeInMilliSec);
+  LastUpdateTimeMan::update(data, space, timeInMilliSec);
   auto result = doSyncPut(std::move(data));
   handleErrorCode(result);
   onFinished();
@@ -174,6 +174,17 @@ void CreateTagIndexProcessor::process(const cpp2::CreateTagIndexReq& req) {
     columns.emplace_back(col);
   }
 
+  std::vector<cpp2::ColumnDef> includeColumns;
+  if (req.include_fields_ref().has_value()) {
+    auto includeRet = getIncludeColumns(*req.include_fields_ref(), fields, schemaCols);
+    if (!nebula::ok(includeRet)) {
+      handleErrorCode(nebula::error(includeRet));
+      onFinished();
+      return;
+    }
+    includeColumns = std::move(nebula::value(includeRet));
+  }
+
   std::vector<kvstore::KV> data;
   auto tagIndexRet = autoIncrementIdInSpace(space);
   if (!nebula::ok(tagIndexRet)) {
@@ -198,6 +209,9 @@ void CreateTagIndexProcessor::process(const cpp2::CreateTagIndexReq& req) {
   if (req.comment_ref().has_value()) {
     item.comment_ref() = *req.comment_ref();
   }
+  if (!includeColumns.empty()) {
+    item.include_fields_ref() = std::move(includeColumns);
+  }
 
   data.emplace_back(MetaKeyUtils::indexIndexKey(space, indexName),
                     std::string(reinterpret_cast<const char*>(&tagIndex), sizeof(IndexID)));
@@ -205,7 +219,7 @@ void CreateTagIndexProcessor::process(const cpp2::CreateTagIndexReq& req) {
   LOG(INFO) << "Create Tag Index " << indexName << ", tagIndex " << tagIndex;
   resp_.id_ref() = to(tagIndex, EntryType::INDEX);
   auto timeInMilliSec = time::WallClock::fastNowInMilliSec();
-  LastUpdateTimeMan::update(data, timeInMilliSec);
+  LastUpdateTimeMan::update(data, space, timeInMilliSec);
   auto result = doSyncPut(std::move(data));
   handleErrorCode(result);
   onFinished();
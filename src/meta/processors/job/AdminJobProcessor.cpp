@@ -7,6 +7,7 @@
 
 #include "common/base/StatusOr.h"
 #include "common/stats/StatsManager.h"
+#include "common/utils/CompactOptions.h"
 #include "meta/processors/job/JobDescription.h"
 
 namespace nebula {
@@ -123,6 +124,15 @@ nebula::cpp2::ErrorCode AdminJobProcessor::addJobProcess(const cpp2::AdminJobReq
   auto type = req.get_type();
   auto paras = req.get_paras();
 
+  // Reject the illegal options now rather than failing the tasks on every storaged
+  if (type == cpp2::JobType::COMPACT) {
+    auto options = CompactOptions::parse(paras);
+    if (!options.ok()) {
+      LOG(INFO) << options.status();
+      return nebula::cpp2::ErrorCode::E_INVALID_JOB;
+    }
+  }
+
   // Check if job not exists
   JobID jId = 0;
   auto runningJobExist = jobMgr_->checkOnRunningJobExist(spaceId_, type, paras, jId);
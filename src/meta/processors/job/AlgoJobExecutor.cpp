@@ -0,0 +1,80 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "meta/processors/job/AlgoJobExecutor.h"
+
+#include "meta/processors/admin/AdminClient.h"
+
+namespace nebula {
+namespace meta {
+
+nebula::cpp2::ErrorCode AlgoJobExecutor::check() {
+  if (paras_.size() < 3 || paras_.size() > 4) {
+    return nebula::cpp2::ErrorCode::E_INVALID_JOB;
+  }
+  auto algo = paras_[0];
+  folly::toLowerAscii(algo);
+  if (algo != "pagerank" && algo != "wcc" && algo != "lpa" && algo != "kcore") {
+    return nebula::cpp2::ErrorCode::E_INVALID_JOB;
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode AlgoJobExecutor::prepare() {
+  auto spaceRet = spaceExist();
+  if (spaceRet != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    LOG(INFO) << "Can't find the space, spaceId " << space_;
+    return spaceRet;
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+ErrOrHosts AlgoJobExecutor::targetHosts() {
+  auto hosts = StorageJobExecutor::targetHosts();
+  if (nebula::ok(hosts)) {
+    assignment_ = encodeAssignment(nebula::value(hosts));
+  }
+  return hosts;
+}
+
+// static
+std::string AlgoJobExecutor::encodeAssignment(const std::vector<PartsOfHost>& hosts) {
+  std::vector<std::string> items;
+  for (const auto& [host, parts] : hosts) {
+    items.emplace_back(folly::sformat("{}:{}={}", host.host, host.port, folly::join(',', parts)));
+  }
+  return folly::join(';', items);
+}
+
+folly::Future<Status> AlgoJobExecutor::executeInternal(HostAddr&& address,
+                                                       std::vector<PartitionID>&& parts) {
+  folly::Promise<Status> pro;
+  auto f = pro.getFuture();
+  // The options are empty if not given, followed by the parts of all the hosts
+  auto paras = paras_;
+  paras.resize(4);
+  paras.emplace_back(assignment_);
+  adminClient_
+      ->addTask(cpp2::JobType::ALGO,
+                jobId_,
+                taskId_++,
+                space_,
+                std::move(address),
+                paras,
+                std::move(parts))
+      .then([pro = std::move(pro)](auto&& t) mutable {
+        CHECK(!t.hasException());
+        auto status = std::move(t).value();
+        if (status.ok()) {
+          pro.setValue(Status::OK());
+        } else {
+          pro.setValue(status.status());
+        }
+      });
+  return f;
+}
+
+}  // namespace meta
+}  // namespace nebula
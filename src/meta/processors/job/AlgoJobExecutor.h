@@ -0,0 +1,56 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef META_ALGOJOBEXECUTOR_H_
+#define META_ALGOJOBEXECUTOR_H_
+
+#include "meta/processors/job/StorageJobExecutor.h"
+
+namespace nebula {
+namespace meta {
+
+/**
+ * @brief Executor for the graph algorithm jobs, always called by job manager.
+ *
+ * The parameters are the algorithm, the tag and the property to write the results, and the
+ * optional options. A task is sent to the leader of each part, and the tasks exchange messages
+ * with each other in storage until the algorithm converges. The parts assigned to all the hosts
+ * are sent along with the parameters, so the tasks send the messages of a part to the host
+ * running it, and wait for all the hosts running the job.
+ */
+class AlgoJobExecutor : public StorageJobExecutor {
+ public:
+  AlgoJobExecutor(GraphSpaceID space,
+                  JobID jobId,
+                  kvstore::KVStore* kvstore,
+                  AdminClient* adminClient,
+                  const std::vector<std::string>& paras)
+      : StorageJobExecutor(space, jobId, kvstore, adminClient, paras) {
+    toHost_ = TargetHosts::LEADER;
+  }
+
+  nebula::cpp2::ErrorCode check() override;
+
+  nebula::cpp2::ErrorCode prepare() override;
+
+  folly::Future<Status> executeInternal(HostAddr&& address,
+                                        std::vector<PartitionID>&& parts) override;
+
+  /**
+   * @brief Encode the parts of the hosts as "host:port=part,part;host:port=part"
+   */
+  static std::string encodeAssignment(const std::vector<PartsOfHost>& hosts);
+
+ protected:
+  ErrOrHosts targetHosts() override;
+
+ private:
+  std::string assignment_;
+};
+
+}  // namespace meta
+}  // namespace nebula
+
+#endif  // META_ALGOJOBEXECUTOR_H_
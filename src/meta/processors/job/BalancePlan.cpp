@@ -11,6 +11,14 @@
 #include "meta/processors/Common.h"
 
 DEFINE_uint32(task_concurrency, 10, "The tasks number could be invoked simultaneously");
+DEFINE_uint32(balance_host_send_slots,
+              0,
+              "The balance tasks moving parts out of a host which could run simultaneously, "
+              "0 means no limit other than task_concurrency");
+DEFINE_uint32(balance_host_recv_slots,
+              0,
+              "The balance tasks moving parts into a host which could run simultaneously, "
+              "0 means no limit other than task_concurrency");
 
 namespace nebula {
 namespace meta {
@@ -41,101 +49,128 @@ void BalancePlan::invoke() {
   for (size_t i = 0; i < buckets_.size(); i++) {
     for (size_t j = 0; j < buckets_[i].size(); j++) {
       auto taskIndex = buckets_[i][j];
-      tasks_[taskIndex].onFinished_ = [this, i, j]() {
-        bool finished = false;
-        bool stopped = false;
-        {
-          std::lock_guard<std::mutex> lg(lock_);
-          finishedTaskNum_++;
-          LOG(INFO) << "Balance " << id() << " has completed " << finishedTaskNum_ << " task";
-          if (finishedTaskNum_ == tasks_.size()) {
-            finished = true;
-            if (status() == meta::cpp2::JobStatus::RUNNING) {
-              setStatus(meta::cpp2::JobStatus::FINISHED);
-              LOG(INFO) << "Balance " << id() << " succeeded!";
-            }
-          }
-          stopped = stopped_;
-        }
-        if (finished) {
-          CHECK_EQ(j, buckets_[i].size() - 1);
-          saveInStore();
-          onFinished_(stopped ? meta::cpp2::JobStatus::STOPPED
-                              : (failed_ ? meta::cpp2::JobStatus::FAILED
-                                         : meta::cpp2::JobStatus::FINISHED));
-        } else if (j + 1 < buckets_[i].size()) {
-          auto& task = tasks_[buckets_[i][j + 1]];
-          if (stopped) {
-            task.ret_ = BalanceTaskResult::INVALID;
-          }
-          task.invoke();
-        } else {
-          size_t index = curIndex_.fetch_add(1, std::memory_order_relaxed);
-          if (index < buckets_.size()) {
-            Bucket& bucket = buckets_[index];
-            if (!bucket.empty()) {
-              auto& task = tasks_[bucket[0]];
-              if (stopped) {
-                task.ret_ = BalanceTaskResult::INVALID;
-              }
-              task.invoke();
-            }
-          }
-        }
-      };  // onFinished
-      tasks_[taskIndex].onError_ = [this, i, j]() {
-        bool finished = false;
-        bool stopped = false;
-        {
-          std::lock_guard<std::mutex> lg(lock_);
-          finishedTaskNum_++;
-          failed_ = true;
-          LOG(INFO) << "Balance " << id() << " has completed " << finishedTaskNum_ << " task";
-          setStatus(meta::cpp2::JobStatus::FAILED);
-          if (finishedTaskNum_ == tasks_.size()) {
-            finished = true;
-            LOG(INFO) << "Balance " << id() << " failed!";
-          }
-          stopped = stopped_;
-        }
-        if (finished) {
-          CHECK_EQ(j, buckets_[i].size() - 1);
-          onFinished_(stopped ? meta::cpp2::JobStatus::STOPPED : meta::cpp2::JobStatus::FAILED);
-        } else if (j + 1 < buckets_[i].size()) {
-          auto& task = tasks_[buckets_[i][j + 1]];
-          LOG(INFO) << "Skip the task for the same partId " << task.partId_;
-          if (stopped) {
-            task.ret_ = BalanceTaskResult::INVALID;
-          } else {
-            task.ret_ = BalanceTaskResult::FAILED;
-          }
-          task.invoke();
-        } else {
-          size_t index = curIndex_.fetch_add(1, std::memory_order_relaxed);
-          if (index < buckets_.size()) {
-            Bucket& bucket = buckets_[index];
-            if (!bucket.empty()) {
-              auto& task = tasks_[bucket[0]];
-              if (stopped) {
-                task.ret_ = BalanceTaskResult::INVALID;
-              }
-              task.invoke();
-            }
-          }
-        }
-      };  // onError
-    }     // for (auto j = 0; j < buckets_[i].size(); j++)
-  }       // for (auto i = 0; i < buckets_.size(); i++)
+      tasks_[taskIndex].onFinished_ = [this, i, j]() { onTaskDone(i, j, true); };
+      tasks_[taskIndex].onError_ = [this, i, j]() { onTaskDone(i, j, false); };
+    }
+  }
 
   saveInStore();
-  uint32 bucketSize = buckets_.size();
-  int32_t concurrency = std::min(FLAGS_task_concurrency, bucketSize);
-  curIndex_.store(concurrency, std::memory_order_relaxed);
-  for (int32_t i = 0; i < concurrency; i++) {
-    if (!buckets_[i].empty()) {
-      tasks_[buckets_[i][0]].invoke();
+  std::vector<BalanceTask*> ready;
+  {
+    std::lock_guard<std::mutex> lg(lock_);
+    for (size_t i = 0; i < buckets_.size(); i++) {
+      if (!buckets_[i].empty()) {
+        pending_.emplace_back(i, 0);
+      }
+    }
+    ready = pickTasks();
+  }
+  for (auto* task : ready) {
+    task->invoke();
+  }
+}
+
+void BalancePlan::onTaskDone(size_t bucketIndex, size_t taskIndex, bool succeeded) {
+  bool finished = false;
+  bool stopped = false;
+  std::vector<BalanceTask*> ready;
+  {
+    std::lock_guard<std::mutex> lg(lock_);
+    finishedTaskNum_++;
+    auto& task = tasks_[buckets_[bucketIndex][taskIndex]];
+    releaseHosts(task);
+    if (task.endTimeMs_ > task.startTimeMs_ && task.startTimeMs_ > 0) {
+      finishedTaskSecs_ += task.endTimeMs_ - task.startTimeMs_;
+      timedTaskNum_++;
     }
+    if (!succeeded) {
+      failed_ = true;
+      setStatus(meta::cpp2::JobStatus::FAILED);
+    }
+    LOG(INFO) << "Balance " << id() << " has completed " << finishedTaskNum_ << "/"
+              << tasks_.size() << " task, " << remainingSecs() << " seconds left";
+    if (finishedTaskNum_ == tasks_.size()) {
+      finished = true;
+      if (status() == meta::cpp2::JobStatus::RUNNING) {
+        setStatus(meta::cpp2::JobStatus::FINISHED);
+        LOG(INFO) << "Balance " << id() << " succeeded!";
+      } else if (failed_) {
+        LOG(INFO) << "Balance " << id() << " failed!";
+      }
+    }
+    stopped = stopped_;
+    if (!finished && taskIndex + 1 < buckets_[bucketIndex].size()) {
+      // The tasks of the same part run one by one, and the next one goes before the other parts
+      if (!succeeded) {
+        auto& next = tasks_[buckets_[bucketIndex][taskIndex + 1]];
+        LOG(INFO) << "Skip the task for the same partId " << next.partId_;
+        next.ret_ = BalanceTaskResult::FAILED;
+      }
+      pending_.emplace_front(bucketIndex, taskIndex + 1);
+    }
+    if (!finished) {
+      ready = pickTasks();
+    }
+  }
+  if (finished) {
+    CHECK_EQ(taskIndex, buckets_[bucketIndex].size() - 1);
+    if (succeeded) {
+      saveInStore();
+    }
+    onFinished_(stopped ? meta::cpp2::JobStatus::STOPPED
+                        : (failed_ ? meta::cpp2::JobStatus::FAILED
+                                   : meta::cpp2::JobStatus::FINISHED));
+    return;
+  }
+  for (auto* task : ready) {
+    task->invoke();
+  }
+}
+
+std::vector<BalanceTask*> BalancePlan::pickTasks() {
+  std::vector<BalanceTask*> ready;
+  auto concurrency = std::max<size_t>(FLAGS_task_concurrency, 1);
+  // A host never waits for a slot if it has none busy, so the plan always makes progress
+  auto hasSlot = [](const auto& busy, const HostAddr& host, uint32_t slots) {
+    auto it = busy.find(host);
+    return slots == 0 || it == busy.end() || it->second < slots;
+  };
+  for (auto it = pending_.begin(); it != pending_.end() && running_ < concurrency;) {
+    auto& task = tasks_[buckets_[it->first][it->second]];
+    if (!hasSlot(sending_, task.src_, FLAGS_balance_host_send_slots) ||
+        !hasSlot(receiving_, task.dst_, FLAGS_balance_host_recv_slots)) {
+      ++it;
+      continue;
+    }
+    sending_[task.src_]++;
+    receiving_[task.dst_]++;
+    running_++;
+    if (stopped_) {
+      task.ret_ = BalanceTaskResult::INVALID;
+    }
+    ready.emplace_back(&task);
+    it = pending_.erase(it);
+  }
+  return ready;
+}
+
+void BalancePlan::releaseHosts(const BalanceTask& task) {
+  running_--;
+  if (--sending_[task.src_] == 0) {
+    sending_.erase(task.src_);
+  }
+  if (--receiving_[task.dst_] == 0) {
+    receiving_.erase(task.dst_);
+  }
+}
+
+int64_t BalancePlan::remainingSecs() const {
+  auto left = tasks_.size() - finishedTaskNum_;
+  if (timedTaskNum_ == 0 || left == 0) {
+    return 0;
   }
+  auto parallel = std::min<size_t>(std::max<size_t>(FLAGS_task_concurrency, 1), left);
+  return finishedTaskSecs_ * left / timedTaskNum_ / parallel;
 }
 
 nebula::cpp2::ErrorCode BalancePlan::saveInStore() {
@@ -17,7 +17,9 @@ namespace nebula {
 namespace meta {
 
 /**
- * @brief A balance plan contains some balance tasks, and could parallel run the tasks across parts
+ * @brief A balance plan contains some balance tasks, and could parallel run the tasks across parts.
+ * The tasks of a part run one by one, and the tasks of different parts run simultaneously within
+ * the task concurrency and the slots of the hosts sending and receiving the parts.
  */
 class BalancePlan {
   friend class DataBalanceJobExecutor;
@@ -31,6 +33,7 @@ class BalancePlan {
   FRIEND_TEST(BalanceTest, RecoveryTest);
   FRIEND_TEST(BalanceTest, DispatchTasksTest);
   FRIEND_TEST(BalanceTest, StopPlanTest);
+  FRIEND_TEST(BalanceTest, HostSlotsTest);
 
  public:
   BalancePlan(JobDescription jobDescription, kvstore::KVStore* kv, AdminClient* client)
@@ -146,6 +149,32 @@ class BalancePlan {
   }
 
  private:
+  /**
+   * @brief Called when a task finished or failed, start the tasks which could run now
+   *
+   * @param bucketIndex
+   * @param taskIndex The index of the task in the bucket
+   * @param succeeded
+   */
+  void onTaskDone(size_t bucketIndex, size_t taskIndex, bool succeeded);
+
+  /**
+   * @brief Take the pending tasks in order, as long as the plan and their source and destination
+   * hosts have free slots, the caller should hold lock_ and invoke them after releasing it
+   *
+   * @return
+   */
+  std::vector<BalanceTask*> pickTasks();
+
+  void releaseHosts(const BalanceTask& task);
+
+  /**
+   * @brief Estimate the seconds left by the average time of the finished tasks
+   *
+   * @return
+   */
+  int64_t remainingSecs() const;
+
   JobDescription jobDescription_;
   kvstore::KVStore* kv_ = nullptr;
   AdminClient* client_ = nullptr;
@@ -159,7 +188,16 @@ class BalancePlan {
   // List of task index in tasks_;
   using Bucket = std::vector<int32_t>;
   std::vector<Bucket> buckets_;
-  std::atomic<int32_t> curIndex_;
+
+  // The tasks waiting for the slots of their hosts, by the bucket index and the index in it
+  std::deque<std::pair<size_t, size_t>> pending_;
+  // The running tasks moving parts out of or into each host
+  std::unordered_map<HostAddr, uint32_t> sending_;
+  std::unordered_map<HostAddr, uint32_t> receiving_;
+  size_t running_{0};
+  // The time taken by the finished tasks, to estimate the time left
+  int64_t finishedTaskSecs_{0};
+  size_t timedTaskNum_{0};
 };
 
 }  // namespace meta
@@ -5,6 +5,8 @@
 
 #include "meta/processors/job/CompactJobExecutor.h"
 
+#include "common/utils/CompactOptions.h"
+
 namespace nebula {
 namespace meta {
 
@@ -15,6 +17,15 @@ CompactJobExecutor::CompactJobExecutor(GraphSpaceID space,
                                        const std::vector<std::string>& paras)
     : SimpleConcurrentJobExecutor(space, jobId, kvstore, adminClient, paras) {}
 
+nebula::cpp2::ErrorCode CompactJobExecutor::check() {
+  auto options = CompactOptions::parse(paras_);
+  if (!options.ok()) {
+    LOG(INFO) << options.status();
+    return nebula::cpp2::ErrorCode::E_INVALID_JOB;
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
 folly::Future<Status> CompactJobExecutor::executeInternal(HostAddr&& address,
                                                           std::vector<PartitionID>&& parts) {
   folly::Promise<Status> pro;
@@ -25,7 +36,7 @@ folly::Future<Status> CompactJobExecutor::executeInternal(HostAddr&& address,
                 taskId_++,
                 space_,
                 std::move(address),
-                {},
+                paras_,
                 std::move(parts))
       .then([pro = std::move(pro)](auto&& t) mutable {
         CHECK(!t.hasException());
@@ -22,6 +22,14 @@ class CompactJobExecutor : public SimpleConcurrentJobExecutor {
                      AdminClient* adminClient,
                      const std::vector<std::string>& params);
 
+  /**
+   * @brief The job takes at most one parameter, the options of the ranges to compact, e.g.
+   * "parts=1,2;data=edge;auto=true", see CompactOptions
+   *
+   * @return nebula::cpp2::ErrorCode
+   */
+  nebula::cpp2::ErrorCode check() override;
+
   /**
    * @brief
    *
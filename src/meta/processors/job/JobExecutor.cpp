@@ -12,6 +12,7 @@
 #include "meta/ActiveHostsMan.h"
 #include "meta/processors/Common.h"
 #include "meta/processors/admin/AdminClient.h"
+#include "meta/processors/job/AlgoJobExecutor.h"
 #include "meta/processors/job/CompactJobExecutor.h"
 #include "meta/processors/job/DataBalanceJobExecutor.h"
 #include "meta/processors/job/DownloadJobExecutor.h"
@@ -85,6 +86,9 @@ std::unique_ptr<JobExecutor> JobExecutorFactory::createJobExecutor(const JobDesc
     case cpp2::JobType::STATS:
       ret.reset(new StatsJobExecutor(jd.getSpace(), jd.getJobId(), store, client, jd.getParas()));
       break;
+    case cpp2::JobType::ALGO:
+      ret.reset(new AlgoJobExecutor(jd.getSpace(), jd.getJobId(), store, client, jd.getParas()));
+      break;
     default:
       break;
   }
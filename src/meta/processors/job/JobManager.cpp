@@ -27,6 +27,11 @@
 
 DEFINE_int32(job_check_intervals, 5000, "job intervals in us");
 DEFINE_double(job_expired_secs, 7 * 24 * 60 * 60, "job expired intervals in sec");
+DEFINE_uint32(max_running_jobs_per_space,
+              3,
+              "The max number of jobs running in a space at the same time, the jobs run together "
+              "only if they don't conflict, e.g. stats and compact along with rebuild index. "
+              "1 means the jobs of a space run one by one");
 
 using nebula::kvstore::KVIterator;
 
@@ -155,7 +160,7 @@ void JobManager::scheduleThread() {
                                        jobDesc.getStopTime(),
                                        jobDesc.getErrorCode());
     save(jobKey, jobVal);
-    spaceRunningJobs_.insert_or_assign(spaceId, true);
+    markRunning(spaceId, jodId, jobDesc.getJobType());
     auto code = runJobInternal(jobDesc, jobOp);
     if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
       jobFinished(spaceId, jodId, cpp2::JobStatus::FAILED, code);
@@ -250,7 +255,7 @@ nebula::cpp2::ErrorCode JobManager::jobFinished(
       // there is a rare condition, that when job finished,
       // the job description is deleted(default more than a week)
       // but stop an invalid job should not set status to idle.
-      spaceRunningJobs_.insert_or_assign(spaceId, false);
+      markFinished(spaceId, jobId);
     }
     return nebula::error(optJobDescRet);
   }
@@ -293,7 +298,7 @@ nebula::cpp2::ErrorCode JobManager::jobFinished(
     optJobDesc.setErrorCode(nebula::cpp2::ErrorCode::SUCCEEDED);
   }
 
-  spaceRunningJobs_.insert_or_assign(spaceId, false);
+  markFinished(spaceId, jobId);
   auto jobKey = MetaKeyUtils::jobKey(optJobDesc.getSpace(), optJobDesc.getJobId());
   auto jobVal = MetaKeyUtils::jobVal(optJobDesc.getJobType(),
                                      optJobDesc.getParas(),
@@ -473,29 +478,45 @@ nebula::cpp2::ErrorCode JobManager::addJob(JobDescription& jobDesc, AdminClient*
 }
 
 size_t JobManager::jobSize() const {
+  std::lock_guard<std::mutex> guard(queueLock_);
   size_t size = 0;
-  for (auto iter = priorityQueues_.begin(); iter != priorityQueues_.end(); ++iter) {
-    size += iter->second->size();
+  for (const auto& [spaceId, queues] : priorityQueues_) {
+    for (const auto& queue : queues) {
+      size += queue.size();
+    }
   }
   return size;
 }
 
 // Execute jobs concurrently between spaces
-// Execute jobs according to priority within the space
+// Execute jobs according to priority within the space, and concurrently if they don't conflict
 bool JobManager::tryDequeue(std::tuple<JbOp, JobID, GraphSpaceID>& opJobId) {
-  for (auto queueIter = priorityQueues_.begin(); queueIter != priorityQueues_.end(); ++queueIter) {
-    auto spaceId = queueIter->first;
-    auto runningJobIter = spaceRunningJobs_.find(spaceId);
-    if (runningJobIter != spaceRunningJobs_.end() && runningJobIter->second) {
-      continue;
-    }
-    if (queueIter->second == nullptr) {
-      spaceRunningJobs_.insert_or_assign(spaceId, false);
-      continue;
+  std::lock_guard<std::mutex> guard(queueLock_);
+  for (auto& [spaceId, queues] : priorityQueues_) {
+    // The types of the running jobs and of the jobs queued before the current one
+    std::vector<cpp2::JobType> before;
+    auto runningIter = spaceRunningJobs_.find(spaceId);
+    if (runningIter != spaceRunningJobs_.end()) {
+      if (runningIter->second.size() >= std::max(FLAGS_max_running_jobs_per_space, 1U)) {
+        continue;
+      }
+      for (const auto& [jobId, jobType] : runningIter->second) {
+        before.emplace_back(jobType);
+      }
     }
-    auto ret = queueIter->second->try_dequeue(opJobId);
-    if (ret) {
-      return true;
+    for (auto& queue : queues) {
+      for (auto iter = queue.begin(); iter != queue.end(); ++iter) {
+        auto jobType = iter->jobType;
+        bool runnable = std::all_of(before.begin(), before.end(), [jobType](auto type) {
+          return canRunTogether(type, jobType);
+        });
+        if (runnable) {
+          opJobId = std::make_tuple(iter->op, iter->jobId, iter->spaceId);
+          queue.erase(iter);
+          return true;
+        }
+        before.emplace_back(jobType);
+      }
     }
   }
   return false;
@@ -505,21 +526,47 @@ void JobManager::enqueue(GraphSpaceID space,
                          JobID jobId,
                          const JbOp& op,
                          const cpp2::JobType& jobType) {
-  static const size_t priorityCount = 2;
-  auto iter = priorityQueues_.find(space);
-  if (iter == priorityQueues_.end()) {
-    std::unique_ptr<PriorityQueue> priQueue = std::make_unique<PriorityQueue>(priorityCount);
-    priorityQueues_.emplace(space, std::move(priQueue));
-  }
-  iter = priorityQueues_.find(space);
-  CHECK(iter != priorityQueues_.end());
-  if (jobType == cpp2::JobType::LEADER_BALANCE) {
-    iter->second->at_priority(static_cast<size_t>(JbPriority::kHIGH))
-        .enqueue(std::make_tuple(op, jobId, space));
+  // The short jobs go first, so they aren't stuck behind the long ones
+  auto priority = JbPriority::kLOW;
+  if (jobType == cpp2::JobType::LEADER_BALANCE || jobType == cpp2::JobType::STATS ||
+      jobType == cpp2::JobType::FLUSH) {
+    priority = JbPriority::kHIGH;
+  }
+  std::lock_guard<std::mutex> guard(queueLock_);
+  priorityQueues_[space][static_cast<size_t>(priority)].emplace_back(
+      QueuedJob{op, jobId, space, jobType});
+}
 
-  } else {
-    iter->second->at_priority(static_cast<size_t>(JbPriority::kLOW))
-        .enqueue(std::make_tuple(op, jobId, space));
+bool JobManager::canRunTogether(cpp2::JobType lhs, cpp2::JobType rhs) {
+  auto isLight = [](cpp2::JobType type) {
+    return type == cpp2::JobType::STATS || type == cpp2::JobType::COMPACT ||
+           type == cpp2::JobType::FLUSH;
+  };
+  auto isExclusive = [](cpp2::JobType type) {
+    return type == cpp2::JobType::DATA_BALANCE || type == cpp2::JobType::ZONE_BALANCE ||
+           type == cpp2::JobType::LEADER_BALANCE || type == cpp2::JobType::DOWNLOAD ||
+           type == cpp2::JobType::INGEST;
+  };
+  if (lhs == rhs || isExclusive(lhs) || isExclusive(rhs)) {
+    return false;
+  }
+  return isLight(lhs) || isLight(rhs);
+}
+
+void JobManager::markRunning(GraphSpaceID spaceId, JobID jobId, cpp2::JobType jobType) {
+  std::lock_guard<std::mutex> guard(queueLock_);
+  spaceRunningJobs_[spaceId][jobId] = jobType;
+}
+
+void JobManager::markFinished(GraphSpaceID spaceId, JobID jobId) {
+  std::lock_guard<std::mutex> guard(queueLock_);
+  auto iter = spaceRunningJobs_.find(spaceId);
+  if (iter == spaceRunningJobs_.end()) {
+    return;
+  }
+  iter->second.erase(jobId);
+  if (iter->second.empty()) {
+    spaceRunningJobs_.erase(iter);
   }
 }
 
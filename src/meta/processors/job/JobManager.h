@@ -7,9 +7,9 @@
 #define META_JOBMANAGER_H_
 
 #include <folly/concurrency/ConcurrentHashMap.h>
-#include <folly/concurrency/PriorityUnboundedQueueSet.h>
 #include <gtest/gtest_prod.h>
 
+#include <array>
 #include <boost/core/noncopyable.hpp>
 
 #include "common/base/Base.h"
@@ -32,6 +32,7 @@ class JobManager : public boost::noncopyable, public nebula::cpp::NonMovable {
   FRIEND_TEST(JobManagerTest, AddJob);
   FRIEND_TEST(JobManagerTest, StatsJob);
   FRIEND_TEST(JobManagerTest, JobPriority);
+  FRIEND_TEST(JobManagerTest, ConcurrentJobsInSpace);
   FRIEND_TEST(JobManagerTest, JobDeduplication);
   FRIEND_TEST(JobManagerTest, LoadJobDescription);
   FRIEND_TEST(JobManagerTest, ShowJobs);
@@ -190,8 +191,9 @@ class JobManager : public boost::noncopyable, public nebula::cpp::NonMovable {
   size_t jobSize() const;
 
   /**
-   * @brief Traverse from priorityQueues_, and find the priorityQueue of the space
-   * that is not executing the job. Then take a job from the queue according to the priority.
+   * @brief Traverse from priorityQueues_, and take the first job by the priority of a space which
+   * could run along with the running jobs of the space, and with the jobs queued before it, so it
+   * doesn't overtake a job it conflicts with.
    *
    * @param opJobId
    * @return return true if the element is obtained, otherwise return false.
@@ -285,14 +287,37 @@ class JobManager : public boost::noncopyable, public nebula::cpp::NonMovable {
    */
   void compareChangeStatus(JbmgrStatus expected, JbmgrStatus desired);
 
- private:
-  using PriorityQueue = folly::PriorityUMPSCQueueSet<std::tuple<JbOp, JobID, GraphSpaceID>, true>;
-  // Each PriorityQueue contains high and low priority queues.
-  // The lower the value, the higher the priority.
-  folly::ConcurrentHashMap<GraphSpaceID, std::unique_ptr<PriorityQueue>> priorityQueues_;
+  /**
+   * @brief Whether the jobs of the types could run in a space at the same time. The jobs which
+   * only read the data or rewrite the files, i.e. stats, compact and flush, could run along with
+   * any job but the balances, download and ingest, which move or replace the data.
+   *
+   * @param lhs
+   * @param rhs
+   * @return
+   */
+  static bool canRunTogether(cpp2::JobType lhs, cpp2::JobType rhs);
 
-  // Identify whether the current space is running a job
-  folly::ConcurrentHashMap<GraphSpaceID, std::atomic<bool>> spaceRunningJobs_;
+  void markRunning(GraphSpaceID spaceId, JobID jobId, cpp2::JobType jobType);
+
+  void markFinished(GraphSpaceID spaceId, JobID jobId);
+
+ private:
+  struct QueuedJob {
+    JbOp op;
+    JobID jobId;
+    GraphSpaceID spaceId;
+    cpp2::JobType jobType;
+  };
+  // Each space has the high and low priority queues.
+  // The lower the index, the higher the priority.
+  using PriorityQueue = std::array<std::deque<QueuedJob>, 2>;
+  // Protect priorityQueues_ and spaceRunningJobs_
+  mutable std::mutex queueLock_;
+  std::map<GraphSpaceID, PriorityQueue> priorityQueues_;
+
+  // The running jobs of each space and their types
+  std::unordered_map<GraphSpaceID, std::unordered_map<JobID, cpp2::JobType>> spaceRunningJobs_;
 
   folly::ConcurrentHashMap<JobID, std::unique_ptr<JobExecutor>> runningJobs_;
   // The job in running or queue
@@ -14,6 +14,15 @@ DEFINE_double(leader_balance_deviation,
               0.05,
               "after leader balance, leader count should in range "
               "[avg * (1 - deviation), avg * (1 + deviation)]");
+DEFINE_bool(leader_balance_by_load,
+            false,
+            "After balancing the leader counts, move the leaders from the hosts of the most recent "
+            "requests of their parts, reported by the storages, so the counts may be uneven");
+DEFINE_double(leader_balance_load_threshold,
+              0.1,
+              "A leader is moved by load only if the load of the most loaded host drops by more "
+              "than so much of the average host load, which keeps the leaders from moving back and "
+              "forth as the loads change slightly");
 
 namespace nebula {
 namespace meta {
@@ -417,9 +426,95 @@ ErrorOr<nebula::cpp2::ErrorCode, bool> LeaderBalanceJobExecutor::buildLeaderBala
       break;
     }
   }
+
+  if (FLAGS_leader_balance_by_load) {
+    balanceLeadersByLoad(leaderHostParts, peersMap, activeHosts, plan, spaceId);
+  }
   return true;
 }
 
+int32_t LeaderBalanceJobExecutor::balanceLeadersByLoad(
+    HostParts& leaderHostParts,
+    PartAllocation& peersMap,
+    const std::unordered_set<HostAddr>& activeHosts,
+    LeaderBalancePlan& plan,
+    GraphSpaceID spaceId) {
+  auto partLoads = PartLoadMan::get(spaceId);
+  if (partLoads.empty()) {
+    LOG(INFO) << "No load reported of space " << spaceId;
+    return 0;
+  }
+  // The parts without requests still count a little, so their leaders spread as well
+  auto loadOf = [&partLoads](PartitionID partId) {
+    auto iter = partLoads.find(partId);
+    return std::max<int64_t>(iter == partLoads.end() ? 0 : iter->second, 1);
+  };
+  // Only the active peers of the parts could lead them, the other hosts, e.g. the ones just added
+  // to the zones of the space, are left out of the average load
+  std::unordered_map<HostAddr, int64_t> hostLoads;
+  for (const auto& [partId, peers] : peersMap) {
+    for (const auto& peer : peers) {
+      if (activeHosts.count(peer) != 0) {
+        hostLoads.emplace(peer, 0);
+      }
+    }
+  }
+  if (hostLoads.empty()) {
+    return 0;
+  }
+  int64_t totalLoad = 0;
+  for (auto& [host, load] : hostLoads) {
+    for (auto partId : leaderHostParts[host]) {
+      load += loadOf(partId);
+    }
+    totalLoad += load;
+  }
+  auto threshold = std::max<int64_t>(static_cast<double>(totalLoad) / hostLoads.size() *
+                                         FLAGS_leader_balance_load_threshold,
+                                     0);
+
+  // Move a leader off the most loaded host at a time, to the peer where the max of their loads
+  // is the lowest. Every move lowers the sum of the squared loads, so it ends.
+  int32_t taskCount = 0;
+  while (true) {
+    auto source = std::max_element(hostLoads.begin(),
+                                   hostLoads.end(),
+                                   [](const auto& l, const auto& r) { return l.second < r.second; })
+                      ->first;
+    auto sourceLoad = hostLoads[source];
+    int64_t bestGain = threshold;
+    std::optional<std::pair<PartitionID, HostAddr>> best;
+    for (auto partId : leaderHostParts[source]) {
+      auto load = loadOf(partId);
+      for (const auto& target : peersMap[partId]) {
+        if (target == source || hostLoads.count(target) == 0) {
+          continue;
+        }
+        auto gain = sourceLoad - std::max(sourceLoad - load, hostLoads[target] + load);
+        if (gain > bestGain) {
+          bestGain = gain;
+          best = std::make_pair(partId, target);
+        }
+      }
+    }
+    if (!best.has_value()) {
+      break;
+    }
+
+    auto [partId, target] = *best;
+    auto& sourceLeaders = leaderHostParts[source];
+    sourceLeaders.erase(std::find(sourceLeaders.begin(), sourceLeaders.end(), partId));
+    leaderHostParts[target].emplace_back(partId);
+    hostLoads[source] -= loadOf(partId);
+    hostLoads[target] += loadOf(partId);
+    plan.emplace_back(spaceId, partId, source, target);
+    LOG(INFO) << "load plan trans leader space: " << spaceId << " part: " << partId << " load "
+              << loadOf(partId) << " from " << source << " to " << target;
+    ++taskCount;
+  }
+  return taskCount;
+}
+
 int32_t LeaderBalanceJobExecutor::acquireLeaders(HostParts& allHostParts,
                                                  HostParts& leaderHostParts,
                                                  PartAllocation& peersMap,
@@ -538,10 +633,13 @@ void LeaderBalanceJobExecutor::simplifyLeaderBalancePlan(GraphSpaceID spaceId,
   }
   plan.clear();
   for (const auto& partEntry : buckets) {
-    plan.emplace_back(spaceId,
-                      partEntry.first,
-                      std::get<2>(partEntry.second.front()),
-                      std::get<3>(partEntry.second.back()));
+    const auto& source = std::get<2>(partEntry.second.front());
+    const auto& target = std::get<3>(partEntry.second.back());
+    // The leader moved by count could be moved back by load
+    if (source == target) {
+      continue;
+    }
+    plan.emplace_back(spaceId, partEntry.first, source, target);
   }
 }
 
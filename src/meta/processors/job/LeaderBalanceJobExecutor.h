@@ -26,6 +26,7 @@ class LeaderBalanceJobExecutor : public MetaJobExecutor {
   FRIEND_TEST(BalanceTest, LeaderBalanceWithZoneTest);
   FRIEND_TEST(BalanceTest, LeaderBalanceWithLargerZoneTest);
   FRIEND_TEST(BalanceTest, LeaderBalanceWithComplexZoneTest);
+  FRIEND_TEST(BalanceTest, LeaderBalanceByLoadTest);
 
  public:
   LeaderBalanceJobExecutor(GraphSpaceID space,
@@ -89,6 +90,23 @@ class LeaderBalanceJobExecutor : public MetaJobExecutor {
                         LeaderBalancePlan& plan,
                         GraphSpaceID spaceId);
 
+  /**
+   * @brief Move the leaders from the most loaded host to its peers, by the recent requests of the
+   * parts reported, as long as the max load drops by more than the threshold
+   *
+   * @param leaderHostParts
+   * @param peersMap
+   * @param activeHosts
+   * @param plan
+   * @param spaceId
+   * @return
+   */
+  int32_t balanceLeadersByLoad(HostParts& leaderHostParts,
+                               PartAllocation& peersMap,
+                               const std::unordered_set<HostAddr>& activeHosts,
+                               LeaderBalancePlan& plan,
+                               GraphSpaceID spaceId);
+
   void simplifyLeaderBalancePlan(GraphSpaceID spaceId, LeaderBalancePlan& plan);
 
   nebula::cpp2::ErrorCode getAllSpaces(
@@ -5,6 +5,7 @@
 
 #include "meta/processors/job/StatsJobExecutor.h"
 
+#include "common/utils/IndexStatsUtils.h"
 #include "common/utils/MetaKeyUtils.h"
 #include "common/utils/Utils.h"
 #include "meta/processors/Common.h"
@@ -103,6 +104,8 @@ void StatsJobExecutor::addStats(cpp2::StatsItem& lhs, const cpp2::StatsItem& rhs
   *lhs.space_vertices_ref() += *rhs.space_vertices_ref();
   *lhs.space_edges_ref() += *rhs.space_edges_ref();
 
+  IndexStatsUtils::merge(*lhs.index_stats_ref(), *rhs.index_stats_ref());
+
   (*lhs.positive_part_correlativity_ref())
       .insert((*rhs.positive_part_correlativity_ref()).begin(),  // NOLINT
               (*rhs.positive_part_correlativity_ref()).end());
@@ -127,23 +127,20 @@ ErrOrHosts StorageJobExecutor::getListenerHost(GraphSpaceID space, cpp2::Listene
   return hosts;
 }
 
-nebula::cpp2::ErrorCode StorageJobExecutor::execute() {
-  ErrOrHosts addressesRet;
+ErrOrHosts StorageJobExecutor::targetHosts() {
   switch (toHost_) {
-    case TargetHosts::LEADER: {
-      addressesRet = getLeaderHost(space_);
-      break;
-    }
-    case TargetHosts::LISTENER: {
-      addressesRet = getListenerHost(space_, cpp2::ListenerType::ELASTICSEARCH);
-      break;
-    }
-    case TargetHosts::DEFAULT: {
-      addressesRet = getTargetHost(space_);
-      break;
-    }
+    case TargetHosts::LEADER:
+      return getLeaderHost(space_);
+    case TargetHosts::LISTENER:
+      return getListenerHost(space_, cpp2::ListenerType::ELASTICSEARCH);
+    case TargetHosts::DEFAULT:
+      return getTargetHost(space_);
   }
+  return nebula::cpp2::ErrorCode::E_INVALID_JOB;
+}
 
+nebula::cpp2::ErrorCode StorageJobExecutor::execute() {
+  auto addressesRet = targetHosts();
   if (!nebula::ok(addressesRet)) {
     LOG(INFO) << "Can't get hosts";
     return nebula::error(addressesRet);
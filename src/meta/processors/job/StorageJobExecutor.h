@@ -87,6 +87,11 @@ class StorageJobExecutor : public JobExecutor {
   }
 
  protected:
+  /**
+   * @brief The hosts to run the tasks and the parts of each, by toHost_
+   */
+  virtual ErrOrHosts targetHosts();
+
   ErrOrHosts getTargetHost(GraphSpaceID space);
 
   ErrOrHosts getLeaderHost(GraphSpaceID space);
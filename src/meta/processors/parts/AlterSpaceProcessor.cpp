@@ -22,6 +22,15 @@ void AlterSpaceProcessor::process(const cpp2::AlterSpaceReq& req) {
       }
       break;
     }
+    case cpp2::AlterSpaceOp::SPLIT_VERTICES: {
+      auto ret = splitVertices(spaceName, req.get_paras());
+      if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        handleErrorCode(ret);
+        onFinished();
+        return;
+      }
+      break;
+    }
     default:
       break;
   }
@@ -71,10 +80,67 @@ nebula::cpp2::ErrorCode AlterSpaceProcessor::addZones(const std::string& spaceNa
   std::vector<kvstore::KV> data;
   data.emplace_back(MetaKeyUtils::spaceKey(spaceId), MetaKeyUtils::spaceVal(properties));
   auto timeInMilliSec = time::WallClock::fastNowInMilliSec();
-  LastUpdateTimeMan::update(data, timeInMilliSec);
+  LastUpdateTimeMan::update(data, spaceId, timeInMilliSec);
   auto ret = doSyncPut(std::move(data));
   return ret;
 }
 
+nebula::cpp2::ErrorCode AlterSpaceProcessor::splitVertices(const std::string& spaceName,
+                                                           const std::vector<std::string>& paras) {
+  if (paras.size() < 2) {
+    LOG(INFO) << "No vertex to split";
+    return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+  }
+  auto num = folly::tryTo<int32_t>(paras[0]);
+  if (!num.hasValue()) {
+    LOG(INFO) << "Invalid number of the parts: " << paras[0];
+    return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+  }
+  auto spaceRet = getSpaceId(spaceName);
+  if (!nebula::ok(spaceRet)) {
+    return nebula::error(spaceRet);
+  }
+  auto spaceId = nebula::value(spaceRet);
+  std::string spaceVal;
+  auto retCode =
+      kvstore_->get(kDefaultSpaceId, kDefaultPartId, MetaKeyUtils::spaceKey(spaceId), &spaceVal);
+  if (retCode != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return retCode;
+  }
+  auto properties = MetaKeyUtils::parseSpace(spaceVal);
+  if (num.value() < 2 || num.value() > properties.get_partition_num()) {
+    LOG(INFO) << "The number of the parts should be in [2, " << properties.get_partition_num()
+              << "], but " << num.value();
+    return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+  }
+  int64_t vidLen = properties.get_vid_type().type_length_ref().value_or(8);
+  std::map<std::string, int32_t> splitVertices;
+  if (properties.split_vertices_ref().has_value()) {
+    splitVertices = *properties.split_vertices_ref();
+  }
+  for (size_t i = 1; i < paras.size(); i++) {
+    const auto& vid = paras[i];
+    if (vid.empty() || static_cast<int64_t>(vid.size()) > vidLen) {
+      LOG(INFO) << "Invalid vid to split: " << vid;
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    auto found = splitVertices.find(vid);
+    if (found != splitVertices.end()) {
+      if (found->second != num.value()) {
+        LOG(INFO) << "The vertex " << vid << " has been split into " << found->second << " parts";
+        return nebula::cpp2::ErrorCode::E_CONFLICT;
+      }
+      continue;
+    }
+    splitVertices.emplace(vid, num.value());
+  }
+
+  properties.split_vertices_ref() = std::move(splitVertices);
+  std::vector<kvstore::KV> data;
+  data.emplace_back(MetaKeyUtils::spaceKey(spaceId), MetaKeyUtils::spaceVal(properties));
+  LastUpdateTimeMan::update(data, spaceId, time::WallClock::fastNowInMilliSec());
+  return doSyncPut(std::move(data));
+}
+
 }  // namespace meta
 }  // namespace nebula
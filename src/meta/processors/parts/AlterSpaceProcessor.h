@@ -12,7 +12,7 @@ namespace nebula {
 namespace meta {
 
 /**
- * @brief Alter space properties, only support altering zones now.
+ * @brief Alter space properties, support adding zones and splitting vertices into parts now.
  *
  */
 class AlterSpaceProcessor : public BaseProcessor<cpp2::ExecResp> {
@@ -27,6 +27,14 @@ class AlterSpaceProcessor : public BaseProcessor<cpp2::ExecResp> {
   nebula::cpp2::ErrorCode addZones(const std::string& spaceName,
                                    const std::vector<std::string>& zones);
 
+  /**
+   * @brief Split the vertices into the number of the consecutive parts from their own parts,
+   *        paras[0] is the number and the rest are the vids. The number of a vertex already
+   *        split can't be changed, as its edges have been spread by it.
+   */
+  nebula::cpp2::ErrorCode splitVertices(const std::string& spaceName,
+                                        const std::vector<std::string>& paras);
+
  private:
   explicit AlterSpaceProcessor(kvstore::KVStore* kvstore)
       : BaseProcessor<cpp2::ExecResp>(kvstore) {}
@@ -18,78 +18,105 @@ void CreateSpaceAsProcessor::process(const cpp2::CreateSpaceAsReq &req) {
     onFinished();
   };
 
-  folly::SharedMutex::WriteHolder holder(LockUtils::lock());
   auto oldSpaceName = req.get_old_space_name();
   auto newSpaceName = req.get_new_space_name();
-  auto oldSpaceId = getSpaceId(oldSpaceName);
-  auto newSpaceId = getSpaceId(newSpaceName);
+  GraphSpaceID oldSpaceId = -1;
+  GraphSpaceID newSpaceId = -1;
+  std::vector<kvstore::KV> data;
+  {
+    folly::SharedMutex::WriteHolder holder(LockUtils::lock());
+    auto oldSpaceRet = getSpaceId(oldSpaceName);
+    if (!nebula::ok(oldSpaceRet)) {
+      rc_ = nebula::error(oldSpaceRet);
+      LOG(INFO) << "Create Space [" << newSpaceName << "] as [" << oldSpaceName
+                << "] failed. Old space does not exists. rc = "
+                << apache::thrift::util::enumNameSafe(rc_);
+      return;
+    }
+    oldSpaceId = nebula::value(oldSpaceRet);
 
-  if (!nebula::ok(oldSpaceId)) {
-    rc_ = nebula::error(oldSpaceId);
-    LOG(INFO) << "Create Space [" << newSpaceName << "] as [" << oldSpaceName
-              << "] failed. Old space does not exists. rc = "
-              << apache::thrift::util::enumNameSafe(rc_);
-    return;
-  }
+    if (nebula::ok(getSpaceId(newSpaceName))) {
+      rc_ = nebula::cpp2::ErrorCode::E_EXISTED;
+      LOG(INFO) << "Create Space [" << newSpaceName << "] as [" << oldSpaceName
+                << "] failed. New space already exists.";
+      return;
+    }
 
-  if (nebula::ok(newSpaceId)) {
-    rc_ = nebula::cpp2::ErrorCode::E_EXISTED;
-    LOG(INFO) << "Create Space [" << newSpaceName << "] as [" << oldSpaceName
-              << "] failed. New space already exists.";
-    return;
-  }
+    auto newSpaceRet = autoIncrementId();
+    if (!nebula::ok(newSpaceRet)) {
+      rc_ = nebula::error(newSpaceRet);
+      LOG(INFO) << "Create Space Failed : Generate new space id failed";
+      return;
+    }
+    newSpaceId = nebula::value(newSpaceRet);
 
-  newSpaceId = autoIncrementId();
-  if (!nebula::ok(newSpaceId)) {
-    rc_ = nebula::error(newSpaceId);
-    LOG(INFO) << "Create Space Failed : Generate new space id failed";
-    return;
-  }
+    auto newSpaceData = makeNewSpaceData(oldSpaceId, newSpaceId, newSpaceName);
+    if (nebula::ok(newSpaceData)) {
+      data.insert(
+          data.end(), nebula::value(newSpaceData).begin(), nebula::value(newSpaceData).end());
+    } else {
+      rc_ = nebula::error(newSpaceData);
+      LOG(INFO) << "Make new space data failed, " << apache::thrift::util::enumNameSafe(rc_);
+      return;
+    }
 
-  std::vector<kvstore::KV> data;
-  auto newSpaceData =
-      makeNewSpaceData(nebula::value(oldSpaceId), nebula::value(newSpaceId), newSpaceName);
-  if (nebula::ok(newSpaceData)) {
-    data.insert(data.end(), nebula::value(newSpaceData).begin(), nebula::value(newSpaceData).end());
-  } else {
-    rc_ = nebula::error(newSpaceData);
-    LOG(INFO) << "Make new space data failed, " << apache::thrift::util::enumNameSafe(rc_);
-    return;
-  }
+    auto newTags = makeNewTags(oldSpaceId, newSpaceId);
+    if (nebula::ok(newTags)) {
+      data.insert(data.end(), nebula::value(newTags).begin(), nebula::value(newTags).end());
+    } else {
+      rc_ = nebula::error(newTags);
+      LOG(INFO) << "Make new tags failed, " << apache::thrift::util::enumNameSafe(rc_);
+      return;
+    }
 
-  auto newTags = makeNewTags(nebula::value(oldSpaceId), nebula::value(newSpaceId));
-  if (nebula::ok(newTags)) {
-    data.insert(data.end(), nebula::value(newTags).begin(), nebula::value(newTags).end());
-  } else {
-    rc_ = nebula::error(newTags);
-    LOG(INFO) << "Make new tags failed, " << apache::thrift::util::enumNameSafe(rc_);
-    return;
+    auto newEdges = makeNewEdges(oldSpaceId, newSpaceId);
+    if (nebula::ok(newEdges)) {
+      data.insert(data.end(), nebula::value(newEdges).begin(), nebula::value(newEdges).end());
+    } else {
+      rc_ = nebula::error(newEdges);
+      LOG(INFO) << "Make new edges failed, " << apache::thrift::util::enumNameSafe(rc_);
+      return;
+    }
+
+    auto newIndexes = makeNewIndexes(oldSpaceId, newSpaceId);
+    if (nebula::ok(newIndexes)) {
+      data.insert(data.end(), nebula::value(newIndexes).begin(), nebula::value(newIndexes).end());
+    } else {
+      rc_ = nebula::error(newIndexes);
+      LOG(INFO) << "Make new indexes failed, " << apache::thrift::util::enumNameSafe(rc_);
+      return;
+    }
   }
 
-  auto newEdges = makeNewEdges(nebula::value(oldSpaceId), nebula::value(newSpaceId));
-  if (nebula::ok(newEdges)) {
-    data.insert(data.end(), nebula::value(newEdges).begin(), nebula::value(newEdges).end());
-  } else {
-    rc_ = nebula::error(newEdges);
-    LOG(INFO) << "Make new edges failed, " << apache::thrift::util::enumNameSafe(rc_);
-    return;
+  // The data is cloned before the new space is seen by the storageds, which load its parts from
+  // the clones when they add them. It waits for the checkpoints on all the hosts, so the lock of
+  // meta is not held, but the one of the snapshots, as they are created the same way.
+  if (req.get_with_data()) {
+    folly::SharedMutex::WriteHolder holder(LockUtils::snapshotLock());
+    rc_ = cloneData(oldSpaceId, newSpaceId);
+    if (rc_ != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      LOG(INFO) << "Clone the data of space " << oldSpaceName << " failed, "
+                << apache::thrift::util::enumNameSafe(rc_);
+      return;
+    }
   }
 
-  auto newIndexes = makeNewIndexes(nebula::value(oldSpaceId), nebula::value(newSpaceId));
-  if (nebula::ok(newIndexes)) {
-    data.insert(data.end(), nebula::value(newIndexes).begin(), nebula::value(newIndexes).end());
-  } else {
-    rc_ = nebula::error(newIndexes);
-    LOG(INFO) << "Make new indexes failed, " << apache::thrift::util::enumNameSafe(rc_);
+  folly::SharedMutex::WriteHolder holder(LockUtils::lock());
+  // The name might be taken while cloning
+  if (nebula::ok(getSpaceId(newSpaceName))) {
+    rc_ = nebula::cpp2::ErrorCode::E_EXISTED;
+    LOG(INFO) << "Create Space [" << newSpaceName << "] as [" << oldSpaceName
+              << "] failed. New space already exists.";
+    dropClonedData(newSpaceId);
     return;
   }
-
-  resp_.id_ref() = to(nebula::value(newSpaceId), EntryType::SPACE);
+  resp_.id_ref() = to(newSpaceId, EntryType::SPACE);
   auto timeInMilliSec = time::WallClock::fastNowInMilliSec();
   LastUpdateTimeMan::update(data, timeInMilliSec);
   rc_ = doSyncPut(std::move(data));
   if (rc_ != nebula::cpp2::ErrorCode::SUCCEEDED) {
     LOG(INFO) << "Update last update time error, " << apache::thrift::util::enumNameSafe(rc_);
+    dropClonedData(newSpaceId);
     return;
   }
   LOG(INFO) << "Created space " << newSpaceName;
@@ -126,6 +153,63 @@ ErrorOr<nebula::cpp2::ErrorCode, std::vector<kvstore::KV>> CreateSpaceAsProcesso
   return data;
 }
 
+nebula::cpp2::ErrorCode CreateSpaceAsProcessor::cloneData(GraphSpaceID oldSpaceId,
+                                                          GraphSpaceID newSpaceId) {
+  if (adminClient_ == nullptr) {
+    return nebula::cpp2::ErrorCode::E_UNSUPPORTED;
+  }
+  auto partPrefix = doPrefix(MetaKeyUtils::partPrefix(oldSpaceId));
+  if (!nebula::ok(partPrefix)) {
+    return nebula::error(partPrefix);
+  }
+  std::set<HostAddr> hosts;
+  for (auto iter = nebula::value(partPrefix).get(); iter->valid(); iter->next()) {
+    for (auto& host : MetaKeyUtils::parsePartVal(iter->val())) {
+      hosts.emplace(std::move(host));
+    }
+  }
+
+  std::vector<folly::Future<Status>> futures;
+  for (const auto& host : hosts) {
+    futures.emplace_back(adminClient_->cloneSpaceData(oldSpaceId, newSpaceId, host));
+  }
+  clonedHosts_ = std::move(hosts);
+  auto tries = folly::collectAll(std::move(futures)).get();
+  for (size_t i = 0; i < tries.size(); i++) {
+    if (tries[i].hasException() || !tries[i].value().ok()) {
+      LOG(INFO) << "Clone space " << oldSpaceId << " failed: "
+                << (tries[i].hasException() ? tries[i].exception().what().toStdString()
+                                            : tries[i].value().toString());
+      dropClonedData(newSpaceId);
+      return nebula::cpp2::ErrorCode::E_FAILED_TO_CHECKPOINT;
+    }
+  }
+  LOG(INFO) << "Cloned the data of space " << oldSpaceId << " to " << newSpaceId << " on "
+            << clonedHosts_.size() << " hosts";
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+void CreateSpaceAsProcessor::dropClonedData(GraphSpaceID newSpaceId) {
+  if (clonedHosts_.empty()) {
+    return;
+  }
+  // The hosts failed to clone are asked as well, which might have cloned a part of the engines
+  std::vector<folly::Future<Status>> futures;
+  for (const auto& host : clonedHosts_) {
+    futures.emplace_back(adminClient_->dropClonedSpaceData(newSpaceId, host));
+  }
+  // The clones failed to remove here are removed by auto_remove_invalid_space at restart, as the
+  // new space is never created
+  auto tries = folly::collectAll(std::move(futures)).get();
+  for (auto& t : tries) {
+    if (t.hasException() || !t.value().ok()) {
+      LOG(INFO) << "Remove the data cloned to space " << newSpaceId << " failed: "
+                << (t.hasException() ? t.exception().what().toStdString() : t.value().toString());
+    }
+  }
+  clonedHosts_.clear();
+}
+
 ErrorOr<nebula::cpp2::ErrorCode, std::vector<kvstore::KV>> CreateSpaceAsProcessor::makeNewTags(
     GraphSpaceID oldSpaceId, GraphSpaceID newSpaceId) {
   auto prefix = MetaKeyUtils::schemaTagsPrefix(oldSpaceId);
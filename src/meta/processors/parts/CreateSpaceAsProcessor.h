@@ -6,6 +6,7 @@
 #define META_PROCESSORS_PARTS_CREATESPACEASPROCESSOR_H
 
 #include "meta/processors/BaseProcessor.h"
+#include "meta/processors/admin/AdminClient.h"
 
 namespace nebula {
 namespace meta {
@@ -20,12 +21,20 @@ using Hosts = std::vector<HostAddr>;
  *        - tags
  *        - edges
  *        - indexes
+ *        - the data, only if with_data is set
  *
+ * The data is cloned by each storaged holding the parts of the existing space, which creates a
+ * checkpoint of the space in place of the new one, so the sst files are hard linked instead of
+ * copied. As the parts of the new space are on the same hosts, each of them is loaded from the
+ * clone when it's added, and the replicas cloned at slightly different logs are caught up by raft.
+ * The clones are removed from all the hosts if any of them fails, or the new space fails to be
+ * created.
  */
 class CreateSpaceAsProcessor : public BaseProcessor<cpp2::ExecResp> {
  public:
-  static CreateSpaceAsProcessor* instance(kvstore::KVStore* kvstore) {
-    return new CreateSpaceAsProcessor(kvstore);
+  static CreateSpaceAsProcessor* instance(kvstore::KVStore* kvstore,
+                                          AdminClient* adminClient = nullptr) {
+    return new CreateSpaceAsProcessor(kvstore, adminClient);
   }
 
   void process(const cpp2::CreateSpaceAsReq& req);
@@ -43,11 +52,20 @@ class CreateSpaceAsProcessor : public BaseProcessor<cpp2::ExecResp> {
   ErrorOr<nebula::cpp2::ErrorCode, std::vector<kvstore::KV>> makeNewIndexes(
       GraphSpaceID oldSpaceId, GraphSpaceID newSpaceId);
 
+  // Clone the data of the old space on all the hosts of its parts, before the new space is created
+  nebula::cpp2::ErrorCode cloneData(GraphSpaceID oldSpaceId, GraphSpaceID newSpaceId);
+
+  // Remove the clones on all the hosts asked to clone, if the new space fails to be created
+  void dropClonedData(GraphSpaceID newSpaceId);
+
   nebula::cpp2::ErrorCode rc_{nebula::cpp2::ErrorCode::SUCCEEDED};
+  std::set<HostAddr> clonedHosts_;
 
  private:
-  explicit CreateSpaceAsProcessor(kvstore::KVStore* kvstore)
-      : BaseProcessor<cpp2::ExecResp>(kvstore) {}
+  CreateSpaceAsProcessor(kvstore::KVStore* kvstore, AdminClient* adminClient)
+      : BaseProcessor<cpp2::ExecResp>(kvstore), adminClient_(adminClient) {}
+
+  AdminClient* adminClient_{nullptr};
 };
 
 }  // namespace meta
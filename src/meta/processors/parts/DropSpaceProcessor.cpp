@@ -129,6 +129,9 @@ void DropSpaceProcessor::process(const cpp2::DropSpaceReq& req) {
   auto localIdkey = MetaKeyUtils::localIdKey(spaceId);
   batchHolder->remove(std::move(localIdkey));
 
+  // 8. Delete the last update time of the space
+  batchHolder->remove(MetaKeyUtils::spaceUpdateTimeKey(spaceId));
+
   auto timeInMilliSec = time::WallClock::fastNowInMilliSec();
   LastUpdateTimeMan::update(batchHolder.get(), timeInMilliSec);
   auto batch = encodeBatchValue(std::move(batchHolder)->getBatch());
@@ -85,7 +85,7 @@ void DropEdgeProcessor::process(const cpp2::DropEdgeReq& req) {
   batchHolder->remove(std::move(indexKey));
 
   auto timeInMilliSec = time::WallClock::fastNowInMilliSec();
-  LastUpdateTimeMan::update(batchHolder.get(), timeInMilliSec);
+  LastUpdateTimeMan::update(batchHolder.get(), spaceId, timeInMilliSec);
   auto batch = encodeBatchValue(std::move(batchHolder)->getBatch());
   doBatchOperation(std::move(batch));
   LOG(INFO) << "Drop Edge " << edgeName;
@@ -5,9 +5,33 @@
 
 #include "meta/processors/session/SessionManagerProcessor.h"
 
+#include "meta/ActiveHostsMan.h"
+
+DEFINE_int32(session_persist_interval_secs,
+             60,
+             "The interval to persist the update time of a session, of which nothing else but the "
+             "stats of the running queries changed");
+
 namespace nebula {
 namespace meta {
 
+namespace {
+
+// Whether nothing but the update time and the stats of the queries are changed
+bool onlyStatsChanged(cpp2::Session saved, cpp2::Session session) {
+  for (auto* s : {&saved, &session}) {
+    s->update_time_ref() = 0;
+    for (auto& [epId, query] : *s->queries_ref()) {
+      query.duration_ref() = 0;
+      query.memory_in_bytes_ref() = 0;
+      query.resources_ref().reset();
+    }
+  }
+  return saved == session;
+}
+
+}  // namespace
+
 void CreateSessionProcessor::process(const cpp2::CreateSessionReq& req) {
   folly::SharedMutex::WriteHolder holder(LockUtils::sessionLock());
   const auto& user = req.get_user();
@@ -62,6 +86,9 @@ void UpdateSessionsProcessor::process(const cpp2::UpdateSessionsReq& req) {
       return;
     }
 
+    // The graph has learned the queries killed or finished before they are marked below
+    KilledQueryMan::ack(session);
+
     // update sessions to be saved if query is being killed, and return them to
     // client.
     auto& newQueries = *session.queries_ref();
@@ -89,11 +116,22 @@ void UpdateSessionsProcessor::process(const cpp2::UpdateSessionsReq& req) {
               << ", the old update time: " << sessionInMeta.get_update_time();
       continue;
     }
+    // The running queries are shown with the stats a little stale, rather than writing them
+    // through raft at each update
+    auto persistInterval = static_cast<int64_t>(FLAGS_session_persist_interval_secs) * 1000000;
+    if (session.get_update_time() - sessionInMeta.get_update_time() < persistInterval &&
+        onlyStatsChanged(sessionInMeta, session)) {
+      VLOG(3) << "Skip persisting the session id: " << sessionId;
+      continue;
+    }
 
     data.emplace_back(MetaKeyUtils::sessionKey(sessionId), MetaKeyUtils::sessionVal(session));
   }
 
-  auto ret = doSyncPut(std::move(data));
+  auto ret = nebula::cpp2::ErrorCode::SUCCEEDED;
+  if (!data.empty()) {
+    ret = doSyncPut(std::move(data));
+  }
   if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
     LOG(INFO) << "Put data error on meta server, errorCode: "
               << apache::thrift::util::enumNameSafe(ret);
@@ -171,6 +209,7 @@ void RemoveSessionProcessor::process(const cpp2::RemoveSessionReq& req) {
     return;
   }
 
+  KilledQueryMan::remove(sessionId);
   handleErrorCode(nebula::cpp2::ErrorCode::SUCCEEDED);
   doRemove(sessionKey);
 }
@@ -180,6 +219,7 @@ void KillQueryProcessor::process(const cpp2::KillQueryReq& req) {
   auto& killQueries = req.get_kill_queries();
 
   std::vector<kvstore::KV> data;
+  std::vector<std::tuple<SessionID, ExecutionPlanID, HostAddr>> killing;
   for (auto& kv : killQueries) {
     auto sessionId = kv.first;
     auto sessionKey = MetaKeyUtils::sessionKey(sessionId);
@@ -204,6 +244,7 @@ void KillQueryProcessor::process(const cpp2::KillQueryReq& req) {
         return;
       }
       query->second.status_ref() = cpp2::QueryStatus::KILLING;
+      killing.emplace_back(sessionId, epId, query->second.get_graph_addr());
     }
 
     data.emplace_back(MetaKeyUtils::sessionKey(sessionId), MetaKeyUtils::sessionVal(session));
@@ -213,6 +254,11 @@ void KillQueryProcessor::process(const cpp2::KillQueryReq& req) {
   if (putRet != nebula::cpp2::ErrorCode::SUCCEEDED) {
     LOG(INFO) << "Put data error on meta server, errorCode: "
               << apache::thrift::util::enumNameSafe(putRet);
+  } else {
+    // Push them to the graphs by the heartbeats
+    for (const auto& [sessionId, epId, graph] : killing) {
+      KilledQueryMan::add(sessionId, epId, graph);
+    }
   }
   handleErrorCode(putRet);
   onFinished();
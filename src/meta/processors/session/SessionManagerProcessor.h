@@ -32,7 +32,8 @@ class CreateSessionProcessor : public BaseProcessor<cpp2::CreateSessionResp> {
 
 /**
  * @brief Update sessions and get killed queries. Then the graph can kill
- *        its queries by the reponse.
+ *        its queries by the reponse. A session of which only the update time
+ *        and the stats of the queries changed is persisted lazily.
  *
  */
 class UpdateSessionsProcessor : public BaseProcessor<cpp2::UpdateSessionsResp> {
@@ -100,7 +101,8 @@ class RemoveSessionProcessor : public BaseProcessor<cpp2::ExecResp> {
 };
 
 /**
- * @brief Mark given queries killed in their sessions.
+ * @brief Mark given queries killed in their sessions, and push them to
+ *        their graphs by the heartbeats.
  *
  */
 class KillQueryProcessor : public BaseProcessor<cpp2::ExecResp> {
@@ -18,9 +18,13 @@
 #include "meta/test/TestUtils.h"
 
 DECLARE_uint32(task_concurrency);
+DECLARE_uint32(balance_host_send_slots);
+DECLARE_uint32(balance_host_recv_slots);
 DECLARE_int32(heartbeat_interval_secs);
 DECLARE_uint32(expired_time_factor);
 DECLARE_double(leader_balance_deviation);
+DECLARE_bool(leader_balance_by_load);
+DECLARE_double(leader_balance_load_threshold);
 
 namespace nebula {
 namespace meta {
@@ -659,6 +663,47 @@ TEST(BalanceTest, BalancePlanTest) {
   }
 }
 
+TEST(BalanceTest, HostSlotsTest) {
+  fs::TempDir rootPath("/tmp/HostSlotsTest.XXXXXX");
+  auto store = MockCluster::initMetaKV(rootPath.path());
+  auto* kv = dynamic_cast<kvstore::KVStore*>(store.get());
+  std::vector<HostAddr> hosts;
+  for (int i = 0; i < 10; i++) {
+    hosts.emplace_back(std::to_string(i), 0);
+  }
+  hosts.emplace_back("new", 0);
+  TestUtils::createSomeHosts(kv, hosts);
+  TestUtils::registerHB(kv, hosts);
+  DefaultValue<folly::Future<Status>>::SetFactory(
+      [] { return folly::Future<Status>(Status::OK()); });
+
+  FLAGS_balance_host_send_slots = 1;
+  FLAGS_balance_host_recv_slots = 1;
+  NiceMock<MockAdminClient> client;
+  JobDescription jd(
+      0, testJobId.fetch_add(1, std::memory_order_relaxed), cpp2::JobType::DATA_BALANCE, {});
+  BalancePlan plan(jd, kv, &client);
+  // All the parts move into the same host, and two tasks of each part
+  for (int i = 0; i < 10; i++) {
+    HostAddr src(std::to_string(i), 0);
+    plan.addTask(BalanceTask(plan.id(), 0, i, src, HostAddr("new", 0), kv, &client));
+    plan.addTask(BalanceTask(plan.id(), 0, i, src, HostAddr("new", 1), kv, &client));
+  }
+  folly::Baton<true, std::atomic> b;
+  plan.onFinished_ = [&plan, &b](meta::cpp2::JobStatus) {
+    ASSERT_EQ(meta::cpp2::JobStatus::FINISHED, plan.status());
+    ASSERT_EQ(20, plan.finishedTaskNum_);
+    b.post();
+  };
+  plan.invoke();
+  b.wait();
+  ASSERT_EQ(0, plan.running_);
+  ASSERT_TRUE(plan.sending_.empty());
+  ASSERT_TRUE(plan.receiving_.empty());
+  FLAGS_balance_host_send_slots = 0;
+  FLAGS_balance_host_recv_slots = 0;
+}
+
 void verifyBalanceTask(kvstore::KVStore* kv,
                        JobID jobId,
                        BalanceTaskStatus status,
@@ -1509,6 +1554,74 @@ TEST(BalanceTest, LeaderBalanceWithComplexZoneTest) {
   }
 }
 
+TEST(BalanceTest, LeaderBalanceByLoadTest) {
+  fs::TempDir rootPath("/tmp/LeaderBalanceByLoadTest.XXXXXX");
+  auto store = MockCluster::initMetaKV(rootPath.path());
+  auto* kv = dynamic_cast<kvstore::KVStore*>(store.get());
+  std::vector<HostAddr> hosts = {{"0", 0}, {"1", 1}, {"2", 2}};
+  TestUtils::createSomeHosts(kv, hosts);
+  GraphSpaceID space = 1;
+  TestUtils::assembleSpace(kv, space, 9, 3, 3);
+
+  // The leader counts are even, but two hot parts are led by the same host
+  PartLoadMan::PartLoads loads;
+  for (PartitionID partId = 1; partId <= 9; partId++) {
+    loads[space][partId] = partId <= 2 ? 1000 : 10;
+  }
+  PartLoadMan::update(HostAddr("0", 0), loads);
+  FLAGS_leader_balance_by_load = true;
+
+  NiceMock<MockAdminClient> client;
+  LeaderBalanceJobExecutor balancer(
+      space, testJobId.fetch_add(1, std::memory_order_relaxed), kv, &client, {});
+  HostLeaderMap hostLeaderMap;
+  hostLeaderMap[HostAddr("0", 0)][1] = {1, 2, 3};
+  hostLeaderMap[HostAddr("1", 1)][1] = {4, 5, 6};
+  hostLeaderMap[HostAddr("2", 2)][1] = {7, 8, 9};
+  {
+    auto leaderMap = hostLeaderMap;
+    LeaderBalancePlan plan;
+    auto result = balancer.buildLeaderBalancePlan(&leaderMap, space, 3, false, plan, false);
+    ASSERT_TRUE(nebula::ok(result) && nebula::value(result));
+    balancer.simplifyLeaderBalancePlan(space, plan);
+    ASSERT_EQ(1, plan.size());
+    ASSERT_EQ(HostAddr("0", 0), std::get<2>(plan[0]));
+    ASSERT_TRUE(std::get<1>(plan[0]) == 1 || std::get<1>(plan[0]) == 2);
+  }
+  {
+    // Not worth moving if the max load drops by less than the threshold
+    FLAGS_leader_balance_load_threshold = 2;
+    auto leaderMap = hostLeaderMap;
+    LeaderBalancePlan plan;
+    auto result = balancer.buildLeaderBalancePlan(&leaderMap, space, 3, false, plan, false);
+    ASSERT_TRUE(nebula::ok(result) && nebula::value(result));
+    ASSERT_TRUE(plan.empty());
+    FLAGS_leader_balance_load_threshold = 0.1;
+  }
+  {
+    // The average load is of the peers of the space only, the move dropping the max load by 980
+    // is under the threshold of 1.6 * 2070 / 3, though not of 1.6 * 2070 / 4 with the other host
+    FLAGS_leader_balance_load_threshold = 1.6;
+    HostParts leaderHostParts;
+    PartAllocation peersMap;
+    for (const auto& [host, leaders] : hostLeaderMap) {
+      leaderHostParts[host] = leaders.at(space);
+    }
+    for (PartitionID partId = 1; partId <= 9; partId++) {
+      peersMap[partId] = hosts;
+    }
+    std::unordered_set<HostAddr> activeHosts(hosts.begin(), hosts.end());
+    activeHosts.emplace("3", 3);
+    LeaderBalancePlan plan;
+    ASSERT_EQ(0,
+              balancer.balanceLeadersByLoad(leaderHostParts, peersMap, activeHosts, plan, space));
+    ASSERT_TRUE(plan.empty());
+    FLAGS_leader_balance_load_threshold = 0.1;
+  }
+  FLAGS_leader_balance_by_load = false;
+  PartLoadMan::clear();
+}
+
 }  // namespace meta
 }  // namespace nebula
 
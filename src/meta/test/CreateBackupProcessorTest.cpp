@@ -223,6 +223,26 @@ TEST(ProcessorTest, CreateBackupTest) {
         ASSERT_EQ(logInfo.get_term_id(), termId);
       }
     }
+
+    // Incremental backup based on the one above
+    cpp2::CreateBackupReq incReq;
+    incReq.spaces_ref() = std::vector<std::string>{"test_space"};
+    incReq.base_backup_ref() = meta.get_backup_name();
+    auto* incProcessor = CreateBackupProcessor::instance(kv.get(), client.get());
+    auto incFuture = incProcessor->getFuture();
+    incProcessor->process(incReq);
+    auto incResp = std::move(incFuture).get();
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, incResp.get_code());
+    ASSERT_FALSE(incResp.get_meta().get_full());
+    ASSERT_EQ(meta.get_backup_name(), *incResp.get_meta().get_base_backup());
+
+    // The base backup must exist
+    incReq.base_backup_ref() = "BACKUP_NOT_EXISTS";
+    incProcessor = CreateBackupProcessor::instance(kv.get(), client.get());
+    incFuture = incProcessor->getFuture();
+    incProcessor->process(incReq);
+    incResp = std::move(incFuture).get();
+    ASSERT_EQ(nebula::cpp2::ErrorCode::E_BACKUP_FAILED, incResp.get_code());
     jobMgr->shutDown();
   }
 }
@@ -9,6 +9,7 @@
 #include "common/fs/TempDir.h"
 #include "common/utils/MetaKeyUtils.h"
 #include "meta/processors/admin/HBProcessor.h"
+#include "meta/processors/schema/CreateTagProcessor.h"
 #include "meta/test/TestUtils.h"
 
 namespace nebula {
@@ -63,6 +64,129 @@ TEST(HBProcessorTest, HBTest) {
   }
 }
 
+TEST(HBProcessorTest, UpdateTimeTest) {
+  fs::TempDir rootPath("/tmp/UpdateTimeTest.XXXXXX");
+  std::unique_ptr<kvstore::KVStore> kv(MockCluster::initMetaKV(rootPath.path()));
+  TestUtils::doPut(kv.get(), {{nebula::MetaKeyUtils::machineKey("0", 0), ""}});
+  TestUtils::assembleSpace(kv.get(), 1, 1);
+
+  const ClusterID kClusterId = 10;
+  auto heartbeat = [&]() {
+    cpp2::HBReq req;
+    req.host_ref() = HostAddr("0", 0);
+    req.cluster_id_ref() = kClusterId;
+    req.role_ref() = cpp2::HostRole::GRAPH;
+    auto* processor = HBProcessor::instance(kv.get(), nullptr, kClusterId);
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+    return resp;
+  };
+
+  auto resp = heartbeat();
+  ASSERT_TRUE(resp.global_update_time_in_ms_ref().has_value());
+  auto globalUpdateTime = *resp.global_update_time_in_ms_ref();
+  ASSERT_TRUE(resp.space_update_time_in_ms_ref().has_value());
+  ASSERT_EQ(0, resp.space_update_time_in_ms_ref()->count(1));
+  {
+    // The schema change only updates the time of the space
+    cpp2::CreateTagReq req;
+    req.space_id_ref() = 1;
+    req.tag_name_ref() = "tag";
+    req.schema_ref() = cpp2::Schema();
+    auto* processor = CreateTagProcessor::instance(kv.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, std::move(f).get().get_code());
+
+    resp = heartbeat();
+    ASSERT_EQ(globalUpdateTime, *resp.global_update_time_in_ms_ref());
+    const auto& spaceUpdateTimes = *resp.space_update_time_in_ms_ref();
+    ASSERT_EQ(1, spaceUpdateTimes.count(1));
+    ASSERT_EQ(resp.get_last_update_time_in_ms(), spaceUpdateTimes.at(1));
+  }
+  {
+    // The others update the global time
+    std::vector<kvstore::KV> data;
+    LastUpdateTimeMan::update(data, globalUpdateTime + 1);
+    TestUtils::doPut(kv.get(), std::move(data));
+
+    resp = heartbeat();
+    ASSERT_EQ(globalUpdateTime + 1, *resp.global_update_time_in_ms_ref());
+    ASSERT_EQ(globalUpdateTime + 1, resp.get_last_update_time_in_ms());
+  }
+}
+
+TEST(HBProcessorTest, PersistTest) {
+  fs::TempDir rootPath("/tmp/HBPersistTest.XXXXXX");
+  std::unique_ptr<kvstore::KVStore> kv(MockCluster::initMetaKV(rootPath.path()));
+  TestUtils::doPut(kv.get(), {{nebula::MetaKeyUtils::machineKey("0", 0), ""}});
+
+  const ClusterID kClusterId = 10;
+  auto heartbeat = [&](const std::string& gitInfoSha, TermID term) {
+    cpp2::HBReq req;
+    req.host_ref() = HostAddr("0", 0);
+    req.cluster_id_ref() = kClusterId;
+    req.role_ref() = cpp2::HostRole::STORAGE;
+    req.git_info_sha_ref() = gitInfoSha;
+    cpp2::LeaderInfo leader;
+    leader.part_id_ref() = 1;
+    leader.term_ref() = term;
+    std::unordered_map<GraphSpaceID, std::vector<cpp2::LeaderInfo>> leaders;
+    leaders[1].emplace_back(std::move(leader));
+    req.leader_partIds_ref() = std::move(leaders);
+    auto* processor = HBProcessor::instance(kv.get(), nullptr, kClusterId);
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+  };
+  auto persisted = [&]() { return nebula::value(ActiveHostsMan::getHostInfo(kv.get(), {"0", 0})); };
+  auto lastUpdateTime = [&]() {
+    std::string val;
+    auto code = kv->get(kDefaultSpaceId, kDefaultPartId, MetaKeyUtils::lastUpdateTimeKey(), &val);
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+    return *reinterpret_cast<const int64_t*>(val.data());
+  };
+
+  heartbeat("sha", 1);
+  auto info = persisted();
+  auto updateTime = lastUpdateTime();
+
+  // Nothing changes, the time of the first heartbeat is kept
+  sleep(1);
+  heartbeat("sha", 1);
+  ASSERT_EQ(info.lastHBTimeInMilliSec_, persisted().lastHBTimeInMilliSec_);
+  ASSERT_EQ(updateTime, lastUpdateTime());
+
+  // The host info is persisted once it changes
+  heartbeat("other", 1);
+  ASSERT_LT(info.lastHBTimeInMilliSec_, persisted().lastHBTimeInMilliSec_);
+  ASSERT_EQ("other", persisted().gitInfoSha_);
+
+  // So is the leader with a greater term, which touches the update time
+  heartbeat("other", 2);
+  ASSERT_LT(updateTime, lastUpdateTime());
+
+  // The info persisted in the old encoding is rewritten though nothing decoded from it changes
+  auto hostKey = MetaKeyUtils::hostKey("0", 0);
+  int64_t now = time::WallClock::fastNowInMilliSec();
+  TestUtils::doPut(kv.get(), {{hostKey, std::string(reinterpret_cast<const char*>(&now), 8)}});
+  heartbeat("", 2);
+  std::string val;
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+            kv->get(kDefaultSpaceId, kDefaultPartId, hostKey, &val));
+  ASSERT_EQ(HostInfo::encodeV2(persisted()), val);
+  ASSERT_NE(sizeof(int64_t), val.size());
+
+  // So is the info persisted ahead of the time of the heartbeat
+  auto ahead = HostInfo(now + 3600 * 1000, cpp2::HostRole::STORAGE, "");
+  TestUtils::doPut(kv.get(), {{hostKey, HostInfo::encodeV2(ahead)}});
+  heartbeat("", 2);
+  ASSERT_GT(ahead.lastHBTimeInMilliSec_, persisted().lastHBTimeInMilliSec_);
+}
+
 }  // namespace meta
 }  // namespace nebula
 
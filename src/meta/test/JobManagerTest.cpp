@@ -11,6 +11,8 @@
 #include "common/fs/TempDir.h"
 #include "kvstore/Common.h"
 #include "meta/ActiveHostsMan.h"
+#include "meta/processors/job/AdminJobProcessor.h"
+#include "meta/processors/job/CompactJobExecutor.h"
 #include "meta/processors/job/DownloadJobExecutor.h"
 #include "meta/processors/job/IngestJobExecutor.h"
 #include "meta/processors/job/JobManager.h"
@@ -188,6 +190,32 @@ TEST_F(JobManagerTest, IngestJob) {
   ASSERT_EQ(code, nebula::cpp2::ErrorCode::SUCCEEDED);
 }
 
+TEST_F(JobManagerTest, CompactJob) {
+  GraphSpaceID space = 1;
+  JobID jobId = 11;
+  auto check = [&](std::vector<std::string> paras) {
+    CompactJobExecutor executor(space, jobId, kv_.get(), adminClient_.get(), paras);
+    return executor.check();
+  };
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, check({}));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, check({"parts=1;data=edge,index;auto=true"}));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_INVALID_JOB, check({"parts=1", "data=edge"}));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_INVALID_JOB, check({"data=vertex"}));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_INVALID_JOB, check({"level=1"}));
+
+  // The illegal options are rejected when the job is submitted
+  cpp2::AdminJobReq req;
+  req.op_ref() = cpp2::JobOp::ADD;
+  req.type_ref() = cpp2::JobType::COMPACT;
+  req.space_id_ref() = space;
+  req.paras_ref() = {"parts=a"};
+  auto* processor = AdminJobProcessor::instance(kv_.get(), adminClient_.get());
+  auto f = processor->getFuture();
+  processor->process(req);
+  auto resp = std::move(f).get();
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_INVALID_JOB, resp.get_code());
+}
+
 TEST_F(JobManagerTest, StatsJob) {
   std::unique_ptr<JobManager, std::function<void(JobManager*)>> jobMgr = getJobManager();
   // For preventing job schedule in JobManager
@@ -252,7 +280,7 @@ TEST_F(JobManagerTest, JobPriority) {
   ASSERT_EQ(14, std::get<1>(opJobId));
   ASSERT_EQ(spaceId, std::get<2>(opJobId));
   // Suppose job starts executing
-  jobMgr->spaceRunningJobs_.insert_or_assign(spaceId, true);
+  jobMgr->markRunning(spaceId, 14, cpp2::JobType::LEADER_BALANCE);
 
   ASSERT_EQ(2, jobMgr->jobSize());
 
@@ -261,17 +289,17 @@ TEST_F(JobManagerTest, JobPriority) {
   ASSERT_EQ(15, std::get<1>(opJobId));
   ASSERT_EQ(spaceId2, std::get<2>(opJobId));
   // Suppose job starts executing
-  jobMgr->spaceRunningJobs_.insert_or_assign(spaceId2, true);
+  jobMgr->markRunning(spaceId2, 15, cpp2::JobType::STATS);
 
   ASSERT_EQ(1, jobMgr->jobSize());
 
   result = jobMgr->tryDequeue(opJobId);
-  // Because all spaces are running jobs
+  // Because the compact job can't run along with the leader balance job
   ASSERT_FALSE(result);
 
   // Suppose the job execution is complete
-  jobMgr->spaceRunningJobs_.insert_or_assign(spaceId, false);
-  jobMgr->spaceRunningJobs_.insert_or_assign(spaceId2, false);
+  jobMgr->markFinished(spaceId, 14);
+  jobMgr->markFinished(spaceId2, 15);
   ASSERT_EQ(1, jobMgr->jobSize());
   result = jobMgr->tryDequeue(opJobId);
   ASSERT_TRUE(result);
@@ -280,6 +308,43 @@ TEST_F(JobManagerTest, JobPriority) {
   ASSERT_EQ(0, jobMgr->jobSize());
 }
 
+TEST_F(JobManagerTest, ConcurrentJobsInSpace) {
+  std::unique_ptr<JobManager, std::function<void(JobManager*)>> jobMgr = getJobManager();
+  // For preventing job schedule in JobManager
+  jobMgr->status_ = JobManager::JbmgrStatus::STOPPED;
+  jobMgr->bgThread_.join();
+  ASSERT_EQ(0, jobMgr->jobSize());
+
+  GraphSpaceID spaceId = 1;
+  JobDescription jobDesc1(spaceId, 13, cpp2::JobType::REBUILD_TAG_INDEX, {"tag_index_name"});
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, jobMgr->addJob(jobDesc1, adminClient_.get()));
+  JobDescription jobDesc2(spaceId, 14, cpp2::JobType::REBUILD_EDGE_INDEX, {"edge_index_name"});
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, jobMgr->addJob(jobDesc2, adminClient_.get()));
+  JobDescription jobDesc3(spaceId, 15, cpp2::JobType::STATS);
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, jobMgr->addJob(jobDesc3, adminClient_.get()));
+  ASSERT_EQ(3, jobMgr->jobSize());
+
+  std::tuple<JobManager::JbOp, JobID, GraphSpaceID> opJobId;
+  // The stats job is of high priority
+  ASSERT_TRUE(jobMgr->tryDequeue(opJobId));
+  ASSERT_EQ(15, std::get<1>(opJobId));
+  jobMgr->markRunning(spaceId, 15, cpp2::JobType::STATS);
+
+  // Rebuilding the index could run along with the stats job
+  ASSERT_TRUE(jobMgr->tryDequeue(opJobId));
+  ASSERT_EQ(13, std::get<1>(opJobId));
+  jobMgr->markRunning(spaceId, 13, cpp2::JobType::REBUILD_TAG_INDEX);
+
+  // But the two rebuilding jobs can't run together
+  ASSERT_FALSE(jobMgr->tryDequeue(opJobId));
+  ASSERT_EQ(1, jobMgr->jobSize());
+
+  jobMgr->markFinished(spaceId, 13);
+  ASSERT_TRUE(jobMgr->tryDequeue(opJobId));
+  ASSERT_EQ(14, std::get<1>(opJobId));
+  ASSERT_EQ(0, jobMgr->jobSize());
+}
+
 TEST_F(JobManagerTest, JobDeduplication) {
   std::unique_ptr<JobManager, std::function<void(JobManager*)>> jobMgr = getJobManager();
   // For preventing job schedule in JobManager
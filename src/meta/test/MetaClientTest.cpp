@@ -2792,6 +2792,65 @@ TEST(MetaClientTest, RocksdbOptionsTest) {
   cluster.stop();
 }
 
+TEST(MetaClientTest, SplitVerticesTest) {
+  FLAGS_heartbeat_interval_secs = 1;
+  fs::TempDir rootPath("/tmp/SplitVerticesTest.XXXXXX");
+
+  mock::MockCluster cluster;
+  cluster.startMeta(rootPath.path());
+  cluster.initMetaClient();
+  auto* client = cluster.metaClient_.get();
+  {
+    std::vector<HostAddr> hosts = {{"0", 0}};
+    auto result = client->addHosts(hosts).get();
+    EXPECT_TRUE(result.ok());
+    TestUtils::registerHB(cluster.metaKV_.get(), hosts);
+  }
+  meta::cpp2::SpaceDesc spaceDesc;
+  spaceDesc.space_name_ref() = "default_space";
+  spaceDesc.partition_num_ref() = 8;
+  spaceDesc.replica_factor_ref() = 1;
+  auto ret = client->createSpace(spaceDesc).get();
+  ASSERT_TRUE(ret.ok()) << ret.status();
+  auto spaceId = ret.value();
+  auto splitRet =
+      client->alterSpace("default_space", cpp2::AlterSpaceOp::SPLIT_VERTICES, {"4", "hub"}).get();
+  ASSERT_TRUE(splitRet.ok()) << splitRet.status();
+  sleep(FLAGS_heartbeat_interval_secs + 1);
+
+  const int32_t numParts = 8;
+  ASSERT_EQ(4, client->splitParts(spaceId, "hub"));
+  ASSERT_EQ(1, client->splitParts(spaceId, "leaf"));
+  auto own = client->partId(numParts, "hub");
+  auto leafPart = client->partId(numParts, "leaf");
+  std::set<PartitionID> used;
+  for (int32_t i = 0; i < 100; i++) {
+    auto dst = folly::stringPrintf("dst_%d", i);
+    // The edges of hub are written into one of the 4 consecutive parts from its own part
+    auto part = client->edgePart(spaceId, numParts, "hub", dst);
+    ASSERT_LT((part - own + numParts) % numParts, 4);
+    used.emplace(part);
+    // And they are read and deleted from its own part as well, which holds the edges written
+    // before the split
+    std::vector<PartitionID> parts;
+    client->edgeParts(spaceId, numParts, "hub", dst, &parts);
+    std::vector<PartitionID> expected = {part};
+    if (part != own) {
+      expected.emplace_back(own);
+    }
+    ASSERT_EQ(expected, parts);
+
+    // The edges of a vertex not split are in its own part only
+    parts.clear();
+    client->edgeParts(spaceId, numParts, "leaf", dst, &parts);
+    expected = {leafPart};
+    ASSERT_EQ(expected, parts);
+    ASSERT_EQ(leafPart, client->edgePart(spaceId, numParts, "leaf", dst));
+  }
+  ASSERT_EQ(4, used.size());
+  cluster.stop();
+}
+
 }  // namespace meta
 }  // namespace nebula
 
@@ -28,10 +28,13 @@ class MockAdminClient : public AdminClient {
   MOCK_METHOD3(removePart, folly::Future<Status>(GraphSpaceID, PartitionID, const HostAddr&));
   MOCK_METHOD2(checkPeers, folly::Future<Status>(GraphSpaceID, PartitionID));
   MOCK_METHOD1(getLeaderDist, folly::Future<Status>(HostLeaderMap*));
-  MOCK_METHOD3(createSnapshot,
+  MOCK_METHOD4(createSnapshot,
                folly::Future<StatusOr<cpp2::HostBackupInfo>>(const std::set<GraphSpaceID>&,
                                                              const std::string&,
-                                                             const HostAddr&));
+                                                             const HostAddr&,
+                                                             const std::string&));
+  MOCK_METHOD3(cloneSpaceData, folly::Future<Status>(GraphSpaceID, GraphSpaceID, const HostAddr&));
+  MOCK_METHOD2(dropClonedSpaceData, folly::Future<Status>(GraphSpaceID, const HostAddr&));
   MOCK_METHOD3(dropSnapshot,
                folly::Future<StatusOr<bool>>(const std::set<GraphSpaceID>&,
                                              const std::string&,
@@ -8,6 +8,7 @@
 #include "common/fs/TempDir.h"
 #include "meta/processors/admin/CreateBackupProcessor.h"
 #include "meta/processors/parts/AlterSpaceProcessor.h"
+#include "meta/processors/parts/CreateSpaceAsProcessor.h"
 #include "meta/processors/parts/CreateSpaceProcessor.h"
 #include "meta/processors/parts/DropSpaceProcessor.h"
 #include "meta/processors/parts/GetPartsAllocProcessor.h"
@@ -33,6 +34,7 @@
 #include "meta/processors/zone/ListZonesProcessor.h"
 #include "meta/processors/zone/MergeZoneProcessor.h"
 #include "meta/processors/zone/RenameZoneProcessor.h"
+#include "meta/test/MockAdminClient.h"
 #include "meta/test/TestUtils.h"
 
 DECLARE_int32(expired_threshold_sec);
@@ -43,6 +45,8 @@ namespace nebula {
 namespace meta {
 
 using nebula::cpp2::PropertyType;
+using ::testing::_;
+using ::testing::Invoke;
 
 TEST(ProcessorTest, ListHostsTest) {
   fs::TempDir rootPath("/tmp/ListHostsTest.XXXXXX");
@@ -2704,6 +2708,100 @@ TEST(ProcessorTest, SessionManagerTest) {
   }
 }
 
+TEST(ProcessorTest, SessionKilledQueriesPushTest) {
+  fs::TempDir rootPath("/tmp/SessionKilledQueriesPushTest.XXXXXX");
+  std::unique_ptr<kvstore::KVStore> kv(MockCluster::initMetaKV(rootPath.path()));
+  KilledQueryMan::clear();
+  HostAddr graph("127.0.0.1", 3699);
+  SessionID sessionId = 0;
+  ExecutionPlanID epId = 1;
+  {
+    cpp2::CreateUserReq req;
+    req.if_not_exists_ref() = false;
+    req.account_ref() = "test_user";
+    req.encoded_pwd_ref() = "password";
+    auto* processor = CreateUserProcessor::instance(kv.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+  }
+  {
+    cpp2::CreateSessionReq req;
+    req.user_ref() = "test_user";
+    req.graph_addr_ref() = graph;
+    auto* processor = CreateSessionProcessor::instance(kv.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+    sessionId = resp.get_session().get_session_id();
+  }
+  auto updateTime = time::WallClock::fastNowInMicroSec();
+  auto update = [&](cpp2::QueryStatus status, int64_t time, int64_t duration) {
+    cpp2::QueryDesc query;
+    query.status_ref() = status;
+    query.graph_addr_ref() = graph;
+    query.duration_ref() = duration;
+    cpp2::Session session;
+    session.session_id_ref() = sessionId;
+    session.graph_addr_ref() = graph;
+    session.update_time_ref() = time;
+    session.queries_ref()->emplace(epId, std::move(query));
+    cpp2::UpdateSessionsReq req;
+    req.sessions_ref() = {session};
+    auto* processor = UpdateSessionsProcessor::instance(kv.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    return std::move(f).get();
+  };
+  auto getUpdateTime = [&]() {
+    cpp2::GetSessionReq req;
+    req.session_id_ref() = sessionId;
+    auto* processor = GetSessionProcessor::instance(kv.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+    return resp.get_session().get_update_time();
+  };
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+            update(cpp2::QueryStatus::RUNNING, updateTime, 0).get_code());
+  ASSERT_EQ(updateTime, getUpdateTime());
+
+  // Only the stats of the query changed, which is not persisted for a while
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+            update(cpp2::QueryStatus::RUNNING, updateTime + 1000000, 1000000).get_code());
+  ASSERT_EQ(updateTime, getUpdateTime());
+  ASSERT_TRUE(KilledQueryMan::get(graph).empty());
+
+  {
+    cpp2::KillQueryReq req;
+    std::unordered_map<SessionID, std::unordered_set<ExecutionPlanID>> killQueries;
+    killQueries[sessionId].emplace(epId);
+    req.kill_queries_ref() = std::move(killQueries);
+    auto* processor = KillQueryProcessor::instance(kv.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+  }
+  // The killed query is pushed to its graph, but not to the others
+  auto killed = KilledQueryMan::get(graph);
+  ASSERT_EQ(1, killed.size());
+  ASSERT_EQ(1, killed[sessionId].count(epId));
+  ASSERT_TRUE(KilledQueryMan::get(HostAddr("127.0.0.1", 3700)).empty());
+
+  // Still pushed until the graph updates the session with the query killed
+  auto resp = update(cpp2::QueryStatus::RUNNING, updateTime + 2000000, 2000000);
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+  ASSERT_EQ(1, resp.get_killed_queries().size());
+  ASSERT_EQ(1, KilledQueryMan::get(graph).size());
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+            update(cpp2::QueryStatus::KILLING, updateTime + 3000000, 3000000).get_code());
+  ASSERT_TRUE(KilledQueryMan::get(graph).empty());
+}
+
 TEST(ProcessorTest, TagIdAndEdgeTypeInSpaceRangeTest) {
   fs::TempDir rootPath("/tmp/TagIdAndEdgeTypeInSpaceRangeTest.XXXXXX");
   auto kv = MockCluster::initMetaKV(rootPath.path());
@@ -4767,6 +4865,96 @@ TEST(ProcessorTest, AlterSpaceTest) {
   }
 }
 
+TEST(ProcessorTest, AlterSpaceSplitVerticesTest) {
+  fs::TempDir rootPath("/tmp/AlterSpaceSplitVerticesTest.XXXXXX");
+  auto store = MockCluster::initMetaKV(rootPath.path());
+  auto* kv = dynamic_cast<kvstore::KVStore*>(store.get());
+  TestUtils::assembleSpaceWithZone(kv, 1, 8, 1, 8, 8);
+  auto splitVertices = [kv](std::vector<std::string> paras) {
+    AlterSpaceProcessor* processor = AlterSpaceProcessor::instance(kv);
+    meta::cpp2::AlterSpaceReq req;
+    req.space_name_ref() = "test_space";
+    req.op_ref() = meta::cpp2::AlterSpaceOp::SPLIT_VERTICES;
+    req.paras_ref() = std::move(paras);
+    auto f = processor->getFuture();
+    processor->process(req);
+    return std::move(f).get().get_code();
+  };
+  // More parts than the space has
+  ASSERT_EQ(nebula::cpp2::ErrorCode::E_INVALID_PARM, splitVertices({"9", "a"}));
+  ASSERT_EQ(nebula::cpp2::ErrorCode::E_INVALID_PARM, splitVertices({"1", "a"}));
+  ASSERT_EQ(nebula::cpp2::ErrorCode::E_INVALID_PARM, splitVertices({"4"}));
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, splitVertices({"4", "a", "b"}));
+  // Split again by the same number
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, splitVertices({"4", "b", "c"}));
+  // The edges of a have been spread by 4 parts
+  ASSERT_EQ(nebula::cpp2::ErrorCode::E_CONFLICT, splitVertices({"2", "a"}));
+
+  std::string spaceVal;
+  kv->get(kDefaultSpaceId, kDefaultPartId, MetaKeyUtils::spaceKey(1), &spaceVal);
+  auto properties = MetaKeyUtils::parseSpace(spaceVal);
+  ASSERT_TRUE(properties.split_vertices_ref().has_value());
+  std::map<std::string, int32_t> expected = {{"a", 4}, {"b", 4}, {"c", 4}};
+  ASSERT_EQ(expected, *properties.split_vertices_ref());
+}
+
+TEST(ProcessorTest, CreateSpaceAsWithDataTest) {
+  fs::TempDir rootPath("/tmp/CreateSpaceAsWithDataTest.XXXXXX");
+  auto store = MockCluster::initMetaKV(rootPath.path());
+  auto* kv = dynamic_cast<kvstore::KVStore*>(store.get());
+  // The parts of space 1 are on 2 hosts
+  TestUtils::assembleSpaceWithZone(kv, 1, 4, 1, 2, 2);
+  auto createSpaceAs = [kv](AdminClient* client, const std::string& newSpaceName) {
+    auto* processor = CreateSpaceAsProcessor::instance(kv, client);
+    cpp2::CreateSpaceAsReq req;
+    req.old_space_name_ref() = "test_space";
+    req.new_space_name_ref() = newSpaceName;
+    req.with_data_ref() = true;
+    auto f = processor->getFuture();
+    processor->process(req);
+    return std::move(f).get();
+  };
+  auto spaceExists = [kv](const std::string& spaceName) {
+    std::string val;
+    auto key = MetaKeyUtils::indexSpaceKey(spaceName);
+    auto code = kv->get(kDefaultSpaceId, kDefaultPartId, key, &val);
+    return code == nebula::cpp2::ErrorCode::SUCCEEDED;
+  };
+  {
+    // The data is cloned on all the hosts of the old space
+    MockAdminClient client;
+    EXPECT_CALL(client, cloneSpaceData(1, _, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([](auto, auto, auto) { return folly::makeFuture(Status::OK()); }));
+    EXPECT_CALL(client, dropClonedSpaceData(_, _)).Times(0);
+    auto resp = createSpaceAs(&client, "clone_space");
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+    ASSERT_TRUE(spaceExists("clone_space"));
+  }
+  {
+    // A failed clone on any host removes the cloned data on all the hosts
+    MockAdminClient client;
+    std::atomic<int> calls{0};
+    EXPECT_CALL(client, cloneSpaceData(1, _, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([&calls](auto, auto, auto) {
+          return folly::makeFuture(calls++ == 0 ? Status::Error("clone failed") : Status::OK());
+        }));
+    EXPECT_CALL(client, dropClonedSpaceData(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([](auto, auto) { return folly::makeFuture(Status::OK()); }));
+    auto resp = createSpaceAs(&client, "failed_space");
+    ASSERT_EQ(nebula::cpp2::ErrorCode::E_FAILED_TO_CHECKPOINT, resp.get_code());
+    ASSERT_FALSE(spaceExists("failed_space"));
+  }
+  {
+    // Cloning the data needs the admin client
+    auto resp = createSpaceAs(nullptr, "no_client_space");
+    ASSERT_EQ(nebula::cpp2::ErrorCode::E_UNSUPPORTED, resp.get_code());
+    ASSERT_FALSE(spaceExists("no_client_space"));
+  }
+}
+
 }  // namespace meta
 }  // namespace nebula
 
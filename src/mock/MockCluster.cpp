@@ -13,6 +13,7 @@
 #include "mock/MockData.h"
 #include "storage/CompactionFilter.h"
 #include "storage/GraphStorageServiceHandler.h"
+#include "storage/MergeOperator.h"
 #include "storage/StorageAdminServiceHandler.h"
 #include "storage/transaction/TransactionManager.h"
 
@@ -200,6 +201,7 @@ void MockCluster::initStorageKV(const char* dataPath,
         new storage::StorageCompactionFilterFactoryBuilder(schemaMan_.get(), indexMan_.get()));
     options.cffBuilder_ = std::move(cffBuilder);
   }
+  options.mergeOp_ = std::make_shared<storage::NebulaOperator>(schemaMan_.get());
   storageKV_ = initKV(std::move(options), addr);
   waitUntilAllElected(storageKV_.get(), 1, parts);
 
@@ -21,6 +21,10 @@ std::string ShowMetaLeaderSentence::toString() const {
   return std::string("SHOW META LEADER");
 }
 
+std::string ShowCardinalityFeedbackSentence::toString() const {
+  return std::string("SHOW CARDINALITY FEEDBACK");
+}
+
 std::string ShowSpacesSentence::toString() const {
   return std::string("SHOW SPACES");
 }
@@ -117,6 +121,9 @@ std::string CreateSpaceSentence::toString() const {
 
 std::string CreateSpaceAsSentence::toString() const {
   auto buf = folly::sformat("CREATE SPACE {} AS {}", *newSpaceName_, *oldSpaceName_);
+  if (withData_) {
+    buf += " WITH DATA";
+  }
   return buf;
 }
 
@@ -129,6 +136,12 @@ std::string ClearSpaceSentence::toString() const {
 }
 
 std::string AlterSpaceSentence::toString() const {
+  if (op_ == meta::cpp2::AlterSpaceOp::SPLIT_VERTICES) {
+    return folly::stringPrintf("ALTER SPACE %s VERTEX %s INTO %ld PARTS",
+                               spaceName_.get()->c_str(),
+                               vids_->toString().c_str(),
+                               numParts_);
+  }
   std::string zones = paras_.front();
   for (size_t i = 1; i < paras_.size(); i++) {
     zones += "," + paras_[i];
@@ -214,6 +227,12 @@ std::string AddListenerSentence::toString() const {
     case meta::cpp2::ListenerType::ELASTICSEARCH:
       buf += "ELASTICSEARCH ";
       break;
+    case meta::cpp2::ListenerType::ANALYTICS:
+      buf += "ANALYTICS ";
+      break;
+    case meta::cpp2::ListenerType::CDC:
+      buf += "CDC ";
+      break;
     case meta::cpp2::ListenerType::UNKNOWN:
       LOG(FATAL) << "Unknown listener type.";
       break;
@@ -230,6 +249,12 @@ std::string RemoveListenerSentence::toString() const {
     case meta::cpp2::ListenerType::ELASTICSEARCH:
       buf += "ELASTICSEARCH ";
       break;
+    case meta::cpp2::ListenerType::ANALYTICS:
+      buf += "ANALYTICS ";
+      break;
+    case meta::cpp2::ListenerType::CDC:
+      buf += "CDC ";
+      break;
     case meta::cpp2::ListenerType::UNKNOWN:
       DLOG(FATAL) << "Unknown listener type.";
       break;
@@ -246,7 +271,10 @@ std::string AdminJobSentence::toString() const {
     case meta::cpp2::JobOp::ADD: {
       switch (type_) {
         case meta::cpp2::JobType::COMPACT:
-          return "SUBMIT JOB COMPACT";
+          if (paras_.empty()) {
+            return "SUBMIT JOB COMPACT";
+          }
+          return folly::stringPrintf("SUBMIT JOB COMPACT \"%s\"", paras_[0].c_str());
         case meta::cpp2::JobType::FLUSH:
           return "SUBMIT JOB FLUSH";
         case meta::cpp2::JobType::REBUILD_TAG_INDEX:
@@ -285,6 +313,16 @@ std::string AdminJobSentence::toString() const {
           }
         case meta::cpp2::JobType::LEADER_BALANCE:
           return "SUBMIT JOB BALANCE LEADER";
+        case meta::cpp2::JobType::ALGO: {
+          auto str = folly::stringPrintf("SUBMIT JOB ALGO %s ON %s.%s",
+                                         paras_[0].c_str(),
+                                         paras_[1].c_str(),
+                                         paras_[2].c_str());
+          if (paras_.size() > 3) {
+            str += folly::stringPrintf(" \"%s\"", paras_[3].c_str());
+          }
+          return str;
+        }
         case meta::cpp2::JobType::UNKNOWN:
           return folly::stringPrintf("Unsupported JobType: %s",
                                      apache::thrift::util::enumNameSafe(type_).c_str());
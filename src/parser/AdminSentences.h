@@ -43,6 +43,15 @@ class ShowMetaLeaderSentence : public Sentence {
   std::string toString() const override;
 };
 
+class ShowCardinalityFeedbackSentence : public Sentence {
+ public:
+  ShowCardinalityFeedbackSentence() {
+    kind_ = Kind::kShowCardinalityFeedback;
+  }
+
+  std::string toString() const override;
+};
+
 class ShowSpacesSentence : public Sentence {
  public:
   ShowSpacesSentence() {
@@ -381,11 +390,21 @@ class CreateSpaceAsSentence final : public CreateSentence {
     return *newSpaceName_;
   }
 
+  // Clone the data of the old space as well
+  void setWithData() {
+    withData_ = true;
+  }
+
+  bool withData() const {
+    return withData_;
+  }
+
   std::string toString() const override;
 
  private:
   std::unique_ptr<std::string> newSpaceName_;
   std::unique_ptr<std::string> oldSpaceName_;
+  bool withData_{false};
 };
 
 class DropSpaceSentence final : public DropSentence {
@@ -463,12 +482,28 @@ class AlterSpaceSentence final : public Sentence {
     return op_;
   }
 
+  // The vertices to split and the number of the parts to split them into, of SPLIT_VERTICES
+  void setSplitVertices(VertexIDList* vids, int64_t numParts) {
+    vids_.reset(vids);
+    numParts_ = numParts;
+  }
+
+  const VertexIDList* vids() const {
+    return vids_.get();
+  }
+
+  int64_t numParts() const {
+    return numParts_;
+  }
+
   std::string toString() const override;
 
  private:
   meta::cpp2::AlterSpaceOp op_;
   std::unique_ptr<std::string> spaceName_;
   std::vector<std::string> paras_;
+  std::unique_ptr<VertexIDList> vids_;
+  int64_t numParts_{0};
 };
 
 class DescribeSpaceSentence final : public Sentence {
@@ -234,10 +234,14 @@ std::string DropEdgeSentence::toString() const {
 
 std::string IndexParamItem::toString() const {
   switch (paramType_) {
+    case S2_MIN_LEVEL:
+      return folly::stringPrintf("s2_min_level = %ld", paramValue_.getInt());
     case S2_MAX_LEVEL:
       return folly::stringPrintf("s2_max_level = %ld", paramValue_.getInt());
     case S2_MAX_CELLS:
       return folly::stringPrintf("s2_max_cells = \"%ld\"", paramValue_.getInt());
+    case ASYNC_MAINTAIN:
+      return folly::stringPrintf("async_maintain = %s", paramValue_.getBool() ? "true" : "false");
   }
   DLOG(FATAL) << "Index param type illegal";
   return "Unknown";
@@ -280,6 +284,11 @@ std::string CreateTagIndexSentence::toString() const {
   folly::join(", ", fieldDefs, fields);
   buf += fields;
   buf += ")";
+  if (includeFields_ != nullptr) {
+    buf += " INCLUDE (";
+    buf += includeFields_->toString();
+    buf += ")";
+  }
   std::string params;
   if (indexParams_ != nullptr) {
     params = indexParams_->toString();
@@ -319,6 +328,11 @@ std::string CreateEdgeIndexSentence::toString() const {
   folly::join(", ", fieldDefs, fields);
   buf += fields;
   buf += ")";
+  if (includeFields_ != nullptr) {
+    buf += " INCLUDE (";
+    buf += includeFields_->toString();
+    buf += ")";
+  }
   std::string params;
   if (indexParams_ != nullptr) {
     params = indexParams_->toString();
@@ -572,7 +572,7 @@ class IndexFieldList final {
 
 class IndexParamItem final {
  public:
-  enum ParamType : uint8_t { S2_MAX_LEVEL, S2_MAX_CELLS };
+  enum ParamType : uint8_t { S2_MAX_LEVEL, S2_MAX_CELLS, ASYNC_MAINTAIN, S2_MIN_LEVEL };
 
   IndexParamItem(ParamType op, Value val) {
     paramType_ = op;
@@ -583,6 +583,14 @@ class IndexParamItem final {
     return paramType_;
   }
 
+  StatusOr<int> getS2MinLevel() {
+    if (paramType_ == S2_MIN_LEVEL) {
+      return paramValue_.getInt();
+    } else {
+      return Status::Error("Not exists s2_min_level.");
+    }
+  }
+
   StatusOr<int> getS2MaxLevel() {
     if (paramType_ == S2_MAX_LEVEL) {
       return paramValue_.getInt();
@@ -599,6 +607,14 @@ class IndexParamItem final {
     }
   }
 
+  StatusOr<bool> getAsyncMaintain() {
+    if (paramType_ == ASYNC_MAINTAIN) {
+      return paramValue_.getBool();
+    } else {
+      return Status::Error("Not exists async_maintain.");
+    }
+  }
+
   std::string toString() const;
 
  private:
@@ -633,7 +649,8 @@ class CreateTagIndexSentence final : public CreateSentence {
                          IndexFieldList *fields,
                          bool ifNotExists,
                          IndexParamList *indexParams,
-                         std::string *comment)
+                         std::string *comment,
+                         NameLabelList *includeFields = nullptr)
       : CreateSentence(ifNotExists) {
     indexName_.reset(indexName);
     tagName_.reset(tagName);
@@ -644,6 +661,7 @@ class CreateTagIndexSentence final : public CreateSentence {
     }
     indexParams_.reset(indexParams);
     comment_.reset(comment);
+    includeFields_.reset(includeFields);
     kind_ = Kind::kCreateTagIndex;
   }
 
@@ -674,12 +692,23 @@ class CreateTagIndexSentence final : public CreateSentence {
     return comment_.get();
   }
 
+  std::vector<std::string> includeFields() const {
+    std::vector<std::string> result;
+    if (includeFields_ != nullptr) {
+      for (auto *label : includeFields_->labels()) {
+        result.emplace_back(*label);
+      }
+    }
+    return result;
+  }
+
  private:
   std::unique_ptr<std::string> indexName_;
   std::unique_ptr<std::string> tagName_;
   std::unique_ptr<IndexFieldList> fields_;
   std::unique_ptr<IndexParamList> indexParams_;
   std::unique_ptr<std::string> comment_;
+  std::unique_ptr<NameLabelList> includeFields_;
 };
 
 class CreateEdgeIndexSentence final : public CreateSentence {
@@ -689,7 +718,8 @@ class CreateEdgeIndexSentence final : public CreateSentence {
                           IndexFieldList *fields,
                           bool ifNotExists,
                           IndexParamList *indexParams,
-                          std::string *comment)
+                          std::string *comment,
+                          NameLabelList *includeFields = nullptr)
       : CreateSentence(ifNotExists) {
     indexName_.reset(indexName);
     edgeName_.reset(edgeName);
@@ -700,6 +730,7 @@ class CreateEdgeIndexSentence final : public CreateSentence {
     }
     indexParams_.reset(indexParams);
     comment_.reset(comment);
+    includeFields_.reset(includeFields);
     kind_ = Kind::kCreateEdgeIndex;
   }
 
@@ -730,12 +761,23 @@ class CreateEdgeIndexSentence final : public CreateSentence {
     return comment_.get();
   }
 
+  std::vector<std::string> includeFields() const {
+    std::vector<std::string> result;
+    if (includeFields_ != nullptr) {
+      for (auto *label : includeFields_->labels()) {
+        result.emplace_back(*label);
+      }
+    }
+    return result;
+  }
+
  private:
   std::unique_ptr<std::string> indexName_;
   std::unique_ptr<std::string> edgeName_;
   std::unique_ptr<IndexFieldList> fields_;
   std::unique_ptr<IndexParamList> indexParams_;
   std::unique_ptr<std::string> comment_;
+  std::unique_ptr<NameLabelList> includeFields_;
 };
 
 class DescribeTagIndexSentence final : public Sentence {
@@ -130,6 +130,7 @@ class Sentence {
     kShowQueries,
     kKillQuery,
     kShowMetaLeader,
+    kShowCardinalityFeedback,
     kAlterSpace,
     kClearSpace,
   };
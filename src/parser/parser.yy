@@ -179,7 +179,7 @@ using namespace nebula;
 %token KW_NO KW_OVERWRITE KW_IN KW_DESCRIBE KW_DESC KW_SHOW KW_HOST KW_HOSTS KW_PART KW_PARTS KW_ADD
 %token KW_PARTITION_NUM KW_REPLICA_FACTOR KW_CHARSET KW_COLLATE KW_COLLATION KW_VID_TYPE
 %token KW_ATOMIC_EDGE
-%token KW_COMMENT KW_S2_MAX_LEVEL KW_S2_MAX_CELLS
+%token KW_COMMENT KW_S2_MIN_LEVEL KW_S2_MAX_LEVEL KW_S2_MAX_CELLS KW_ASYNC_MAINTAIN KW_INCLUDE
 %token KW_DROP KW_CLEAR KW_REMOVE KW_SPACES KW_INGEST KW_INDEX KW_INDEXES
 %token KW_IF KW_NOT KW_EXISTS KW_WITH
 %token KW_BY KW_DOWNLOAD KW_HDFS KW_UUID KW_CONFIGS KW_FORCE
@@ -193,6 +193,7 @@ using namespace nebula;
 %token KW_IS KW_NULL KW_DEFAULT
 %token KW_SNAPSHOT KW_SNAPSHOTS KW_LOOKUP
 %token KW_JOBS KW_JOB KW_RECOVER KW_FLUSH KW_COMPACT KW_REBUILD KW_SUBMIT KW_STATS KW_STATUS
+%token KW_ALGO
 %token KW_BIDIRECT
 %token KW_USER KW_USERS KW_ACCOUNT
 %token KW_PASSWORD KW_CHANGE KW_ROLE KW_ROLES
@@ -204,7 +205,7 @@ using namespace nebula;
 %token KW_UNWIND KW_SKIP KW_OPTIONAL
 %token KW_CASE KW_THEN KW_ELSE KW_END
 %token KW_GROUP KW_ZONE KW_GROUPS KW_ZONES KW_INTO KW_NEW
-%token KW_LISTENER KW_ELASTICSEARCH KW_FULLTEXT KW_HTTPS KW_HTTP
+%token KW_LISTENER KW_ELASTICSEARCH KW_ANALYTICS KW_CDC KW_FULLTEXT KW_HTTPS KW_HTTP
 %token KW_AUTO KW_FUZZY KW_PREFIX KW_REGEXP KW_WILDCARD
 %token KW_TEXT KW_SEARCH KW_CLIENTS KW_SIGN KW_SERVICE KW_TEXT_SEARCH
 %token KW_ANY KW_SINGLE KW_NONE
@@ -212,6 +213,7 @@ using namespace nebula;
 %token KW_LOCAL
 %token KW_SESSIONS KW_SESSION
 %token KW_KILL KW_QUERY KW_QUERIES KW_TOP
+%token KW_CARDINALITY KW_FEEDBACK
 %token KW_GEOGRAPHY KW_POINT KW_LINESTRING KW_POLYGON
 %token KW_LIST KW_MAP
 %token KW_MERGE KW_DIVIDE KW_RENAME
@@ -357,7 +359,7 @@ using namespace nebula;
 %type <role_type_clause> role_type_clause
 %type <acl_item_clause> acl_item_clause
 
-%type <name_label_list> name_label_list
+%type <name_label_list> name_label_list opt_index_include_list
 %type <index_field> index_field
 %type <index_field_list> index_field_list opt_index_field_list
 
@@ -543,8 +545,11 @@ unreserved_keyword
     | KW_ZONES              { $$ = new std::string("zones"); }
     | KW_LISTENER           { $$ = new std::string("listener"); }
     | KW_ELASTICSEARCH      { $$ = new std::string("elasticsearch"); }
+    | KW_ANALYTICS          { $$ = new std::string("analytics"); }
+    | KW_CDC                { $$ = new std::string("cdc"); }
     | KW_FULLTEXT           { $$ = new std::string("fulltext"); }
     | KW_STATS              { $$ = new std::string("stats"); }
+    | KW_ALGO               { $$ = new std::string("algo"); }
     | KW_STATUS             { $$ = new std::string("status"); }
     | KW_AUTO               { $$ = new std::string("auto"); }
     | KW_FUZZY              { $$ = new std::string("fuzzy"); }
@@ -560,14 +565,19 @@ unreserved_keyword
     | KW_RESET              { $$ = new std::string("reset"); }
     | KW_PLAN               { $$ = new std::string("plan"); }
     | KW_COMMENT            { $$ = new std::string("comment"); }
+    | KW_S2_MIN_LEVEL       { $$ = new std::string("s2_min_level"); }
     | KW_S2_MAX_LEVEL       { $$ = new std::string("s2_max_level"); }
     | KW_S2_MAX_CELLS       { $$ = new std::string("s2_max_cells"); }
+    | KW_ASYNC_MAINTAIN     { $$ = new std::string("async_maintain"); }
     | KW_SESSION            { $$ = new std::string("session"); }
     | KW_SESSIONS           { $$ = new std::string("sessions"); }
     | KW_LOCAL              { $$ = new std::string("local"); }
     | KW_SAMPLE             { $$ = new std::string("sample"); }
     | KW_QUERIES            { $$ = new std::string("queries"); }
     | KW_QUERY              { $$ = new std::string("query"); }
+    | KW_CARDINALITY        { $$ = new std::string("cardinality"); }
+    | KW_FEEDBACK           { $$ = new std::string("feedback"); }
+    | KW_INCLUDE            { $$ = new std::string("include"); }
     | KW_KILL               { $$ = new std::string("kill"); }
     | KW_TOP                { $$ = new std::string("top"); }
     | KW_POINT              { $$ = new std::string("point"); }
@@ -2686,14 +2696,14 @@ opt_index_field_list
     ;
 
 create_tag_index_sentence
-    : KW_CREATE KW_TAG KW_INDEX opt_if_not_exists name_label KW_ON name_label L_PAREN opt_index_field_list R_PAREN opt_with_index_param_list opt_comment_prop {
-        $$ = new CreateTagIndexSentence($5, $7, $9, $4, $11, $12);
+    : KW_CREATE KW_TAG KW_INDEX opt_if_not_exists name_label KW_ON name_label L_PAREN opt_index_field_list R_PAREN opt_index_include_list opt_with_index_param_list opt_comment_prop {
+        $$ = new CreateTagIndexSentence($5, $7, $9, $4, $12, $13, $11);
     }
     ;
 
 create_edge_index_sentence
-    : KW_CREATE KW_EDGE KW_INDEX opt_if_not_exists name_label KW_ON name_label L_PAREN opt_index_field_list R_PAREN opt_with_index_param_list opt_comment_prop {
-        $$ = new CreateEdgeIndexSentence($5, $7, $9, $4, $11, $12);
+    : KW_CREATE KW_EDGE KW_INDEX opt_if_not_exists name_label KW_ON name_label L_PAREN opt_index_field_list R_PAREN opt_index_include_list opt_with_index_param_list opt_comment_prop {
+        $$ = new CreateEdgeIndexSentence($5, $7, $9, $4, $12, $13, $11);
     }
     ;
 
@@ -2749,6 +2759,15 @@ opt_comment_prop
     }
     ;
 
+opt_index_include_list
+    : %empty {
+        $$ = nullptr;
+    }
+    | KW_INCLUDE L_PAREN name_label_list R_PAREN {
+        $$ = $3;
+    }
+    ;
+
 opt_with_index_param_list
     : %empty {
         $$ = nullptr;
@@ -2770,7 +2789,13 @@ index_param_list
     ;
 
 index_param_item
-    : KW_S2_MAX_LEVEL ASSIGN legal_integer {
+    : KW_S2_MIN_LEVEL ASSIGN legal_integer {
+        if ($3 < 0 || $3 > 30) {
+            throw nebula::GraphParser::syntax_error(@3, "'s2_min_level' value must be between 0 and 30 inclusive");
+        }
+        $$ = new IndexParamItem(IndexParamItem::S2_MIN_LEVEL, $3);
+    }
+    | KW_S2_MAX_LEVEL ASSIGN legal_integer {
         if ($3 < 0 || $3 > 30) {
             throw nebula::GraphParser::syntax_error(@3, "'s2_max_level' value must be between 0 and 30 inclusive");
         }
@@ -2782,6 +2807,9 @@ index_param_item
         }
         $$ = new IndexParamItem(IndexParamItem::S2_MAX_CELLS, $3);
     }
+    | KW_ASYNC_MAINTAIN ASSIGN BOOL {
+        $$ = new IndexParamItem(IndexParamItem::ASYNC_MAINTAIN, $3);
+    }
     ;
 
 
@@ -3282,6 +3310,13 @@ admin_job_sentence
                                              meta::cpp2::JobType::COMPACT);
         $$ = sentence;
     }
+    | KW_SUBMIT KW_JOB KW_COMPACT STRING {
+        auto sentence = new AdminJobSentence(meta::cpp2::JobOp::ADD,
+                                             meta::cpp2::JobType::COMPACT);
+        sentence->addPara(*$4);
+        $$ = sentence;
+        delete $4;
+    }
     | KW_SUBMIT KW_JOB KW_FLUSH {
         auto sentence = new AdminJobSentence(meta::cpp2::JobOp::ADD,
                                              meta::cpp2::JobType::FLUSH);
@@ -3304,6 +3339,30 @@ admin_job_sentence
                                              meta::cpp2::JobType::STATS);
         $$ = sentence;
     }
+    | KW_SUBMIT KW_JOB KW_ALGO name_label KW_ON name_label DOT name_label {
+        auto sentence = new AdminJobSentence(meta::cpp2::JobOp::ADD,
+                                             meta::cpp2::JobType::ALGO);
+        sentence->addPara(*$4);
+        sentence->addPara(*$6);
+        sentence->addPara(*$8);
+        $$ = sentence;
+        delete $4;
+        delete $6;
+        delete $8;
+    }
+    | KW_SUBMIT KW_JOB KW_ALGO name_label KW_ON name_label DOT name_label STRING {
+        auto sentence = new AdminJobSentence(meta::cpp2::JobOp::ADD,
+                                             meta::cpp2::JobType::ALGO);
+        sentence->addPara(*$4);
+        sentence->addPara(*$6);
+        sentence->addPara(*$8);
+        sentence->addPara(*$9);
+        $$ = sentence;
+        delete $4;
+        delete $6;
+        delete $8;
+        delete $9;
+    }
     | KW_SHOW KW_JOBS {
         auto sentence = new AdminJobSentence(meta::cpp2::JobOp::SHOW_All);
         $$ = sentence;
@@ -3467,6 +3526,9 @@ show_sentence
     | KW_SHOW KW_META KW_LEADER {
         $$ = new ShowMetaLeaderSentence();
     }
+    | KW_SHOW KW_CARDINALITY KW_FEEDBACK {
+        $$ = new ShowCardinalityFeedbackSentence();
+    }
     ;
 
 list_host_type
@@ -3537,6 +3599,12 @@ alter_space_sentence
         delete nl;
         $$ = sentence;
     }
+    | KW_ALTER KW_SPACE name_label KW_VERTEX vid_list KW_INTO legal_integer KW_PARTS {
+        auto sentence = new AlterSpaceSentence($3, meta::cpp2::AlterSpaceOp::SPLIT_VERTICES);
+        sentence->setSplitVertices($5, $7);
+        $$ = sentence;
+    }
+    ;
 
 create_space_sentence
     : KW_CREATE KW_SPACE opt_if_not_exists name_label {
@@ -3587,6 +3655,11 @@ create_space_sentence
         auto sentence = new CreateSpaceAsSentence($6, $4, $3);
         $$ = sentence;
     }
+    | KW_CREATE KW_SPACE opt_if_not_exists name_label KW_AS name_label KW_WITH KW_DATA {
+        auto sentence = new CreateSpaceAsSentence($6, $4, $3);
+        sentence->setWithData();
+        $$ = sentence;
+    }
     ;
 
 describe_space_sentence
@@ -3822,12 +3895,24 @@ add_listener_sentence
     : KW_ADD KW_LISTENER KW_ELASTICSEARCH host_list {
         $$ = new AddListenerSentence(meta::cpp2::ListenerType::ELASTICSEARCH, $4);
     }
+    | KW_ADD KW_LISTENER KW_ANALYTICS host_list {
+        $$ = new AddListenerSentence(meta::cpp2::ListenerType::ANALYTICS, $4);
+    }
+    | KW_ADD KW_LISTENER KW_CDC host_list {
+        $$ = new AddListenerSentence(meta::cpp2::ListenerType::CDC, $4);
+    }
     ;
 
 remove_listener_sentence
     : KW_REMOVE KW_LISTENER KW_ELASTICSEARCH {
         $$ = new RemoveListenerSentence(meta::cpp2::ListenerType::ELASTICSEARCH);
     }
+    | KW_REMOVE KW_LISTENER KW_ANALYTICS {
+        $$ = new RemoveListenerSentence(meta::cpp2::ListenerType::ANALYTICS);
+    }
+    | KW_REMOVE KW_LISTENER KW_CDC {
+        $$ = new RemoveListenerSentence(meta::cpp2::ListenerType::CDC);
+    }
     ;
 
 list_listener_sentence
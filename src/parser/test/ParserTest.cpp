@@ -218,6 +218,25 @@ TEST_F(ParserTest, SpaceOperation) {
     auto result = parse(query);
     ASSERT_TRUE(result.ok()) << result.status();
   }
+  {
+    std::string query = "CREATE SPACE new_space AS default_space";
+    auto result = parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+    ASSERT_EQ(result.value()->toString(), "CREATE SPACE new_space AS default_space");
+  }
+  {
+    std::string query = "CREATE SPACE new_space AS default_space WITH DATA";
+    auto result = parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+    ASSERT_EQ(result.value()->toString(), "CREATE SPACE new_space AS default_space WITH DATA");
+  }
+  {
+    std::string query = "ALTER SPACE default_space VERTEX \"a\", \"b\" INTO 4 PARTS";
+    auto result = parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+    ASSERT_EQ(result.value()->toString(),
+              "ALTER SPACE default_space VERTEX \"a\",\"b\" INTO 4 PARTS");
+  }
   {
     std::string query = "SHOW CREATE SPACE default_space";
     auto result = parse(query);
@@ -658,6 +677,36 @@ TEST_F(ParserTest, IndexOperation) {
     auto& sentence = result.value();
     EXPECT_EQ(query, sentence->toString());
   }
+  {
+    std::string query = "CREATE TAG INDEX name_index ON person(name(10)) INCLUDE (age,city)";
+    auto result = parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+    auto& sentence = result.value();
+    EXPECT_EQ(query, sentence->toString());
+  }
+  {
+    std::string query = "CREATE EDGE INDEX like_index ON service(like) INCLUDE (score)";
+    auto result = parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+    auto& sentence = result.value();
+    EXPECT_EQ(query, sentence->toString());
+  }
+  {
+    std::string query = "CREATE TAG INDEX name_index ON person(name(10)) INCLUDE ()";
+    auto result = parse(query);
+    ASSERT_FALSE(result.ok());
+  }
+  {
+    std::string query =
+        "CREATE TAG INDEX name_index ON person(name(10)) WITH (ASYNC_MAINTAIN = true)";
+    auto result = parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+  }
+  {
+    std::string query = "CREATE EDGE INDEX like_index ON service(like) WITH (async_maintain = 1)";
+    auto result = parse(query);
+    ASSERT_FALSE(result.ok());
+  }
   {
     std::string query = "DROP TAG INDEX name_index";
     auto result = parse(query);
@@ -3163,6 +3212,44 @@ TEST_F(ParserTest, FullTextServiceTest) {
   }
 }
 
+TEST_F(ParserTest, AnalyticsListenerTest) {
+  {
+    std::string query = "ADD LISTENER ANALYTICS 127.0.0.1:12000, 127.0.0.1:12001";
+    auto result = parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+  }
+  {
+    std::string query = "REMOVE LISTENER ANALYTICS";
+    auto result = parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+  }
+  {
+    // Still usable as a name
+    std::string query = "CREATE TAG analytics(name string)";
+    auto result = parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+  }
+}
+
+TEST_F(ParserTest, CDCListenerTest) {
+  {
+    std::string query = "ADD LISTENER CDC 127.0.0.1:12000, 127.0.0.1:12001";
+    auto result = parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+  }
+  {
+    std::string query = "REMOVE LISTENER CDC";
+    auto result = parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+  }
+  {
+    // Still usable as a name
+    std::string query = "CREATE TAG cdc(name string)";
+    auto result = parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+  }
+}
+
 TEST_F(ParserTest, SessionTest) {
   {
     std::string query = "SHOW SESSIONS";
@@ -3191,6 +3278,8 @@ TEST_F(ParserTest, JobTest) {
     ASSERT_EQ(result.value()->toString(), expectedStr);
   };
   checkTest("SUBMIT JOB COMPACT", "SUBMIT JOB COMPACT");
+  checkTest("SUBMIT JOB COMPACT \"parts=1,2;data=edge;auto=true\"",
+            "SUBMIT JOB COMPACT \"parts=1,2;data=edge;auto=true\"");
   checkTest("SUBMIT JOB FLUSH", "SUBMIT JOB FLUSH");
 
   checkTest("SUBMIT JOB DOWNLOAD HDFS \"hdfs://127.0.0.1:9090/data\"",
@@ -3199,6 +3288,9 @@ TEST_F(ParserTest, JobTest) {
   checkTest("SUBMIT JOB INGEST", "SUBMIT JOB INGEST");
 
   checkTest("SUBMIT JOB STATS", "SUBMIT JOB STATS");
+  checkTest("SUBMIT JOB ALGO pagerank ON rank.value", "SUBMIT JOB ALGO pagerank ON rank.value");
+  checkTest("SUBMIT JOB ALGO kcore ON core.in_core \"k=3, edges=follow|like\"",
+            "SUBMIT JOB ALGO kcore ON core.in_core \"k=3, edges=follow|like\"");
   checkTest("SUBMIT JOB BALANCE LEADER", "SUBMIT JOB BALANCE LEADER");
   checkTest("SHOW JOBS", "SHOW JOBS");
   checkTest("SHOW JOB 111", "SHOW JOB 111");
@@ -3227,6 +3319,12 @@ TEST_F(ParserTest, ShowAndKillQueryTest) {
     ASSERT_TRUE(result.ok()) << result.status();
     ASSERT_EQ(result.value()->toString(), "SHOW LOCAL QUERIES");
   }
+  {
+    std::string query = "SHOW CARDINALITY FEEDBACK";
+    auto result = parse(query);
+    ASSERT_TRUE(result.ok()) << result.status();
+    ASSERT_EQ(result.value()->toString(), "SHOW CARDINALITY FEEDBACK");
+  }
   {
     std::string query = "KILL QUERY (plan=123)";
     auto result = parse(query);
@@ -470,6 +470,9 @@ TEST(Scanner, Basic) {
       CHECK_SEMANTIC_TYPE("STATS", TokenType::KW_STATS),
       CHECK_SEMANTIC_TYPE("Stats", TokenType::KW_STATS),
       CHECK_SEMANTIC_TYPE("stats", TokenType::KW_STATS),
+      CHECK_SEMANTIC_TYPE("ALGO", TokenType::KW_ALGO),
+      CHECK_SEMANTIC_TYPE("Algo", TokenType::KW_ALGO),
+      CHECK_SEMANTIC_TYPE("algo", TokenType::KW_ALGO),
       CHECK_SEMANTIC_TYPE("ANY", TokenType::KW_ANY),
       CHECK_SEMANTIC_TYPE("any", TokenType::KW_ANY),
       CHECK_SEMANTIC_TYPE("SINGLE", TokenType::KW_SINGLE),
@@ -497,9 +500,20 @@ TEST(Scanner, Basic) {
       CHECK_SEMANTIC_TYPE("QUERY", TokenType::KW_QUERY),
       CHECK_SEMANTIC_TYPE("Query", TokenType::KW_QUERY),
       CHECK_SEMANTIC_TYPE("query", TokenType::KW_QUERY),
+      CHECK_SEMANTIC_TYPE("ASYNC_MAINTAIN", TokenType::KW_ASYNC_MAINTAIN),
+      CHECK_SEMANTIC_TYPE("async_maintain", TokenType::KW_ASYNC_MAINTAIN),
+      CHECK_SEMANTIC_TYPE("INCLUDE", TokenType::KW_INCLUDE),
+      CHECK_SEMANTIC_TYPE("Include", TokenType::KW_INCLUDE),
+      CHECK_SEMANTIC_TYPE("include", TokenType::KW_INCLUDE),
       CHECK_SEMANTIC_TYPE("QUERIES", TokenType::KW_QUERIES),
       CHECK_SEMANTIC_TYPE("Queries", TokenType::KW_QUERIES),
       CHECK_SEMANTIC_TYPE("queries", TokenType::KW_QUERIES),
+      CHECK_SEMANTIC_TYPE("CARDINALITY", TokenType::KW_CARDINALITY),
+      CHECK_SEMANTIC_TYPE("Cardinality", TokenType::KW_CARDINALITY),
+      CHECK_SEMANTIC_TYPE("cardinality", TokenType::KW_CARDINALITY),
+      CHECK_SEMANTIC_TYPE("FEEDBACK", TokenType::KW_FEEDBACK),
+      CHECK_SEMANTIC_TYPE("Feedback", TokenType::KW_FEEDBACK),
+      CHECK_SEMANTIC_TYPE("feedback", TokenType::KW_FEEDBACK),
       CHECK_SEMANTIC_TYPE("KILL", TokenType::KW_KILL),
       CHECK_SEMANTIC_TYPE("Kill", TokenType::KW_KILL),
       CHECK_SEMANTIC_TYPE("kill", TokenType::KW_KILL),
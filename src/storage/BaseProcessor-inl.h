@@ -46,6 +46,11 @@ void BaseProcessor<RESP>::handleAsync(GraphSpaceID spaceId,
   {
     std::lock_guard<std::mutex> lg(this->lock_);
     handleErrorCode(code, spaceId, partId);
+    // The processor could be destroyed once callingNum_ reaches 0, so evict before that. Evict
+    // even if the write failed, since it may be committed anyway.
+    evictCache(env_->vertexCache_.get(), verticesToEvict_, spaceId, partId);
+    evictCache(env_->adjacencyCache_.get(), edgesToEvict_, spaceId, partId);
+    env_->bumpWriteEpoch(spaceId);
     this->callingNum_--;
     if (this->callingNum_ == 0) {
       finished = true;
@@ -57,6 +62,64 @@ void BaseProcessor<RESP>::handleAsync(GraphSpaceID spaceId,
   }
 }
 
+template <typename RESP>
+void BaseProcessor<RESP>::addVertexToEvict(PartitionID partId, const VertexID& vId) {
+  if (env_->vertexCache_ == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lg(this->lock_);
+  verticesToEvict_[partId].emplace_back(vId);
+}
+
+template <typename RESP>
+void BaseProcessor<RESP>::addEdgeToEvict(PartitionID partId, const VertexID& srcId) {
+  if (env_->adjacencyCache_ == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lg(this->lock_);
+  edgesToEvict_[partId].emplace_back(srcId);
+}
+
+template <typename RESP>
+void BaseProcessor<RESP>::addHotWrites(const char* kind,
+                                       GraphSpaceID spaceId,
+                                       PartitionID partId,
+                                       const std::vector<kvstore::KV>& data) {
+  if (env_->hotKeys_ == nullptr) {
+    return;
+  }
+  auto* hotKeys = env_->hotKeys_->tracker(kind);
+  uint64_t bytes = 0;
+  for (const auto& [key, value] : data) {
+    auto size = key.size() + value.size();
+    bytes += size;
+    if (NebulaKeyUtils::isTag(spaceVidLen_, key)) {
+      auto vId = NebulaKeyUtils::getVertexId(spaceVidLen_, key);
+      hotKeys->addVertex(spaceId, partId, vId.str(), size);
+    } else if (NebulaKeyUtils::isEdge(spaceVidLen_, key)) {
+      auto srcId = NebulaKeyUtils::getSrcId(spaceVidLen_, key);
+      hotKeys->addVertex(spaceId, partId, srcId.str(), size);
+    }
+  }
+  hotKeys->addPart(spaceId, partId, bytes);
+}
+
+template <typename RESP>
+void BaseProcessor<RESP>::evictCache(
+    VertexCache* cache,
+    std::unordered_map<PartitionID, std::vector<VertexID>>& toEvict,
+    GraphSpaceID spaceId,
+    PartitionID partId) {
+  auto iter = toEvict.find(partId);
+  if (iter == toEvict.end()) {
+    return;
+  }
+  for (const auto& vId : iter->second) {
+    cache->evict(spaceId, partId, vId);
+  }
+  toEvict.erase(iter);
+}
+
 template <typename RESP>
 meta::cpp2::ColumnDef BaseProcessor<RESP>::columnDef(std::string name,
                                                      nebula::cpp2::PropertyType type) {
@@ -117,6 +180,31 @@ void BaseProcessor<RESP>::doPut(GraphSpaceID spaceId,
       });
 }
 
+template <typename RESP>
+ErrorOr<nebula::cpp2::ErrorCode, std::vector<std::string>> BaseProcessor<RESP>::findOldValues(
+    GraphSpaceID spaceId, PartitionID partId, const std::vector<std::string>& keys) {
+  std::vector<std::string> values;
+  if (keys.empty()) {
+    return values;
+  }
+  auto [code, status] = this->env_->kvstore_->multiGet(spaceId, partId, keys, &values);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED &&
+      code != nebula::cpp2::ErrorCode::E_PARTIAL_RESULT) {
+    LOG(ERROR) << "Error! ret = " << apache::thrift::util::enumNameSafe(code) << ", spaceId "
+               << spaceId;
+    return code;
+  }
+  for (size_t i = 0; i < status.size(); i++) {
+    if (status[i].isKeyNotFound()) {
+      values[i].clear();
+    } else if (!status[i].ok()) {
+      LOG(ERROR) << "Read the old value failed, spaceId " << spaceId << ", partId " << partId;
+      return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+  }
+  return values;
+}
+
 template <typename RESP>
 void BaseProcessor<RESP>::doRemove(GraphSpaceID spaceId,
                                    PartitionID partId,
@@ -167,7 +255,54 @@ StatusOr<std::string> BaseProcessor<RESP>::encodeRowVal(const meta::NebulaSchema
     return Status::Error("Add field failed");
   }
 
-  return std::move(rowWrite).moveEncodedStr();
+  auto row = std::move(rowWrite).moveEncodedStr();
+  if (FLAGS_row_format_version == 3) {
+    wRet = RowWriterV3::upgrade(schema, row);
+    if (wRet != WriteResult::SUCCEEDED) {
+      return Status::Error("Encode row failed");
+    }
+  }
+  return row;
+}
+
+template <typename RESP>
+StatusOr<std::string> BaseProcessor<RESP>::checkEncodedRowVal(
+    const meta::NebulaSchemaProvider* schema, const std::string& encoded, WriteResult& wRet) {
+  // Only V3 rows are accepted, whose reader checks the bounds of the fields
+  SchemaVer schemaVer;
+  int32_t readerVer;
+  RowReaderWrapper::getVersions(encoded, schemaVer, readerVer);
+  if (readerVer != 3 || schemaVer != schema->getVersion()) {
+    wRet = WriteResult::INCORRECT_VALUE;
+    return Status::Error("Bad version of encoded row");
+  }
+  auto reader = RowReaderWrapper::getRowReader(schema, encoded);
+  auto numNullables = schema->getNumNullableFields();
+  auto numNullBytes = numNullables > 0 ? ((numNullables - 1) >> 3) + 1 : 0;
+  if (reader == nullptr || encoded.size() < reader->headerLen() + numNullBytes + sizeof(int64_t)) {
+    wRet = WriteResult::INCORRECT_VALUE;
+    return Status::Error("Encoded row too short");
+  }
+
+  std::vector<Value> props;
+  props.reserve(schema->getNumFields());
+  for (size_t i = 0; i < schema->getNumFields(); i++) {
+    auto value = reader->getValueByIndex(i);
+    if (value.isBadNull()) {
+      wRet = WriteResult::INCORRECT_VALUE;
+      return Status::Error("Broken field in encoded row");
+    }
+    props.emplace_back(std::move(value));
+  }
+  if (FLAGS_row_format_version != 3) {
+    return encodeRowVal(schema, {}, props, wRet);
+  }
+  std::string row;
+  wRet = RowWriterV3::encode(*reader, row);
+  if (wRet != WriteResult::SUCCEEDED) {
+    return Status::Error("Encode row failed");
+  }
+  return row;
 }
 
 template <typename RESP>
@@ -13,11 +13,15 @@
 
 #include "codec/RowReaderWrapper.h"
 #include "codec/RowWriterV2.h"
+#include "codec/RowWriterV3.h"
 #include "common/base/Base.h"
 #include "common/stats/StatsManager.h"
 #include "common/time/Duration.h"
+#include "common/tracing/Tracing.h"
 #include "common/utils/IndexKeyUtils.h"
+#include "common/utils/NebulaKeyUtils.h"
 #include "storage/CommonUtils.h"
+#include "storage/StorageFlags.h"
 
 namespace nebula {
 namespace storage {
@@ -26,7 +30,7 @@ template <typename RESP>
 class BaseProcessor {
  public:
   explicit BaseProcessor(StorageEnv* env, const ProcessorCounters* counters = nullptr)
-      : env_(env), counters_(counters) {}
+      : env_(env), counters_(counters), readsSampled_(counters != nullptr && sampleReads()) {}
 
   virtual ~BaseProcessor() = default;
 
@@ -34,6 +38,44 @@ class BaseProcessor {
     return promise_.getFuture();
   }
 
+  /**
+   * @brief Start the span of the request, which is a child of the span of the caller if the
+   * request carries its context. The span ends when the request is finished.
+   *
+   * @return tracing::SpanRef The span to make active while the request is processed
+   */
+  template <typename REQ>
+  tracing::SpanRef traceRequest(const char* name, const REQ& req) {
+    tracing::TraceContext context;
+    if (req.common_ref().has_value() && req.get_common()->trace_context_ref().has_value()) {
+      const auto& trace = *req.get_common()->trace_context_ref();
+      context.traceIdHigh = static_cast<uint64_t>(trace.get_trace_id_high());
+      context.traceIdLow = static_cast<uint64_t>(trace.get_trace_id_low());
+      context.spanId = static_cast<uint64_t>(trace.get_span_id());
+      context.sampled = trace.get_sampled();
+    }
+    span_ = tracing::Span::root(name, context);
+    span_.setAttribute("space", req.get_space_id());
+    return span_.ref();
+  }
+
+  // Return the write epoch of the space in the response, see StorageEnv::writeEpoch
+  void reportWriteEpoch(GraphSpaceID spaceId) {
+    epochSpace_ = spaceId;
+  }
+
+  /**
+   * @brief Fail all the parts of the request without processing it, e.g. when the resource group
+   * to run it is full. The processor is deleted after.
+   */
+  template <typename REQ>
+  void reject(nebula::cpp2::ErrorCode code, const REQ& req) {
+    for (const auto& part : req.get_parts()) {
+      pushResultCode(code, partIdOf(part));
+    }
+    onFinished();
+  }
+
  protected:
   virtual void onFinished() {
     if (counters_) {
@@ -47,12 +89,34 @@ class BaseProcessor {
     if (!profileDetail_.empty()) {
       this->result_.latency_detail_us_ref() = std::move(profileDetail_);
     }
+    if (profileDetailFlag_ && !readStats_.empty()) {
+      // The reads of the kvstore, of which the time is a part of the time of the nodes reading
+      std::lock_guard<std::mutex> lck(profileMut_);
+      profileNode("kvstore", 0, readStats_["iterate_us"] + readStats_["get_us"], readStats_);
+    }
+    if (!nodeProfiles_.empty()) {
+      this->result_.node_profiles_ref() = std::move(nodeProfiles_);
+    }
     this->result_.failed_parts_ref() = this->codes_;
+    if (epochSpace_.has_value()) {
+      // Read after the writes of the request are done, so the epoch covers them
+      this->result_.write_epoch_ref() = env_->writeEpoch(*epochSpace_);
+    }
+    span_.setAttribute("failed_parts", static_cast<int64_t>(this->codes_.size()));
+    span_.end();
     this->resp_.result_ref() = std::move(this->result_);
     this->promise_.setValue(std::move(this->resp_));
 
     if (counters_) {
       stats::StatsManager::addValue(counters_->latency_, this->duration_.elapsedInUSec());
+      if (readsSampled_) {
+        for (const auto& [name, value] : readStats_) {
+          auto iter = counters_->rocksdbReads_.find(name);
+          if (iter != counters_->rocksdbReads_.end()) {
+            stats::StatsManager::addValue(iter->second, value);
+          }
+        }
+      }
     }
 
     delete this;
@@ -83,6 +147,16 @@ class BaseProcessor {
                      const std::string& start,
                      const std::string& end);
 
+  /**
+   * @brief Read the current values of the keys of a part in one multiGet, which reads the keys in
+   * order and is much cheaper than getting them one by one
+   *
+   * @return ErrorOr<nebula::cpp2::ErrorCode, std::vector<std::string>> Values in the order of the
+   * keys, empty for the keys not found
+   */
+  ErrorOr<nebula::cpp2::ErrorCode, std::vector<std::string>> findOldValues(
+      GraphSpaceID spaceId, PartitionID partId, const std::vector<std::string>& keys);
+
   nebula::cpp2::ErrorCode writeResultTo(WriteResult code, bool isEdge);
 
   nebula::meta::cpp2::ColumnDef columnDef(std::string name, nebula::cpp2::PropertyType type);
@@ -97,6 +171,27 @@ class BaseProcessor {
 
   void handleAsync(GraphSpaceID spaceId, PartitionID partId, nebula::cpp2::ErrorCode code);
 
+  /**
+   * @brief Evict the vertex from vertex cache when the write of its part is done in handleAsync,
+   * must be called before the write is submitted.
+   */
+  void addVertexToEvict(PartitionID partId, const VertexID& vId);
+
+  /**
+   * @brief Evict the adjacency lists of the source vertex from adjacency cache when the write of
+   * its part is done in handleAsync, must be called before the write is submitted.
+   */
+  void addEdgeToEvict(PartitionID partId, const VertexID& srcId);
+
+  /**
+   * @brief Count the tags or edges written to the part in the hot keys of the kind, by the
+   * vertex or source vertex of each key and the bytes of the key and value.
+   */
+  void addHotWrites(const char* kind,
+                    GraphSpaceID spaceId,
+                    PartitionID partId,
+                    const std::vector<kvstore::KV>& data);
+
   nebula::cpp2::ErrorCode checkStatType(const meta::SchemaProviderIf::Field& field,
                                         cpp2::StatType statType);
 
@@ -105,6 +200,20 @@ class BaseProcessor {
                                      const std::vector<Value>& props,
                                      WriteResult& wRet);
 
+  /**
+   * @brief Check the row encoded by the client, which must be in version 3 and of the latest
+   * schema. The row is re-encoded in the format of row_format_version, so a malformed one never
+   * reaches the engine.
+   */
+  StatusOr<std::string> checkEncodedRowVal(const meta::NebulaSchemaProvider* schema,
+                                           const std::string& encoded,
+                                           WriteResult& wRet);
+
+  static void evictCache(VertexCache* cache,
+                         std::unordered_map<PartitionID, std::vector<VertexID>>& toEvict,
+                         GraphSpaceID spaceId,
+                         PartitionID partId);
+
   virtual void profileDetail(const std::string& name, int32_t latency) {
     if (!profileDetail_.count(name)) {
       profileDetail_[name] = latency;
@@ -113,6 +222,64 @@ class BaseProcessor {
     }
   }
 
+  // Whether the reads of the kvstore are profiled, for PROFILE or as a sampled request
+  bool profileReads() const {
+    return profileDetailFlag_ || readsSampled_;
+  }
+
+  /**
+   * @brief Add up the stats of the reads of the kvstore by a RocksReadProfiler, which are
+   * attached to the profile as the "kvstore" node and added to the rocksdb_read_* histograms
+   * when the request is finished. It may be called by the threads of different parts.
+   */
+  void addReadStats(const std::map<std::string, int64_t>& stats) {
+    std::lock_guard<std::mutex> lck(profileMut_);
+    for (const auto& stat : stats) {
+      readStats_[stat.first] += stat.second;
+    }
+  }
+
+  // Add up the stats of the reads done for the request by the other threads, empty if the reads
+  // are not profiled
+  std::function<void(const std::map<std::string, int64_t>&)> readStatsAdder() {
+    if (!profileReads()) {
+      return nullptr;
+    }
+    return [this](const std::map<std::string, int64_t>& stats) { addReadStats(stats); };
+  }
+
+  // One of every rocksdb_perf_context_sample_interval requests of the thread is sampled
+  static bool sampleReads() {
+    auto interval = FLAGS_rocksdb_perf_context_sample_interval;
+    if (interval == 0) {
+      return false;
+    }
+    thread_local uint64_t requests = 0;
+    return ++requests % interval == 0;
+  }
+
+  /**
+   * @brief Add the stats of a node of a profiled plan, the stats of the nodes of the same name,
+   * e.g. the ones of different parts, are added up. Must be called with profileMut_ held.
+   */
+  void profileNode(const std::string& name,
+                   int64_t rows,
+                   int64_t durationUs,
+                   const std::map<std::string, int64_t>& stats) {
+    auto iter = std::find_if(nodeProfiles_.begin(),
+                             nodeProfiles_.end(),
+                             [&name](const auto& node) { return node.get_name() == name; });
+    if (iter == nodeProfiles_.end()) {
+      iter = nodeProfiles_.emplace(nodeProfiles_.end());
+      iter->name_ref() = name;
+    }
+    iter->rows_ref() = iter->get_rows() + rows;
+    iter->exec_duration_in_us_ref() = iter->get_exec_duration_in_us() + durationUs;
+    for (const auto& stat : stats) {
+      (*iter->stats_ref())[stat.first] += stat.second;
+    }
+  }
+
  protected:
   StorageEnv* env_{nullptr};
   const ProcessorCounters* counters_;
@@ -125,11 +292,20 @@ class BaseProcessor {
   std::vector<cpp2::PartitionResult> codes_;
   std::mutex lock_;
   int32_t callingNum_{0};
+  std::unordered_map<PartitionID, std::vector<VertexID>> verticesToEvict_;
+  std::unordered_map<PartitionID, std::vector<VertexID>> edgesToEvict_;
   int32_t spaceVidLen_;
   bool isIntId_;
   std::map<std::string, int32_t> profileDetail_;
+  // The nodes in the order they are profiled first
+  std::vector<cpp2::NodeProfile> nodeProfiles_;
   std::mutex profileMut_;
   bool profileDetailFlag_{false};
+  bool readsSampled_{false};
+  // The stats of the reads of the kvstore, see addReadStats
+  std::map<std::string, int64_t> readStats_;
+  tracing::Span span_;
+  std::optional<GraphSpaceID> epochSpace_;
 };
 
 }  // namespace storage
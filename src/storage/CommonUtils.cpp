@@ -5,11 +5,42 @@
 
 #include "storage/CommonUtils.h"
 
+#include "clients/meta/MetaClient.h"
+#include "codec/RowReaderWrapper.h"
 #include "common/time/WallClock.h"
+#include "common/utils/IndexKeyUtils.h"
 
 namespace nebula {
 namespace storage {
 
+bool StorageEnv::isMirrorVertex(GraphSpaceID space, PartitionID partId, folly::StringPiece vId) {
+  if (metaClient_ == nullptr) {
+    return false;
+  }
+  // The vid of a FIXED_STRING space read from a key is padded
+  auto id = vId.str();
+  auto vidType = metaClient_->getSpaceVidType(space);
+  if (vidType.ok() && vidType.value() != nebula::cpp2::PropertyType::INT64) {
+    id.erase(id.find_last_not_of('\0') + 1);
+  }
+  if (metaClient_->splitParts(space, id) <= 1) {
+    return false;
+  }
+  auto numParts = metaClient_->partsNum(space);
+  return numParts.ok() && metaClient_->partId(numParts.value(), id) != partId;
+}
+
+int64_t StorageEnv::writeEpoch(GraphSpaceID space) {
+  static const int64_t kStartEpoch = time::WallClock::fastNowInMicroSec();
+  auto epochs = writeEpochs_.rlock();
+  auto iter = epochs->find(space);
+  return kStartEpoch + (iter == epochs->end() ? 0 : iter->second);
+}
+
+void StorageEnv::bumpWriteEpoch(GraphSpaceID space) {
+  (*writeEpochs_.wlock())[space]++;
+}
+
 bool CommonUtils::checkDataExpiredForTTL(const meta::SchemaProviderIf* schema,
                                          RowReader* reader,
                                          const std::string& ttlCol,
@@ -38,6 +69,18 @@ bool CommonUtils::checkDataExpiredForTTL(const meta::SchemaProviderIf* schema,
   return false;
 }
 
+bool CommonUtils::checkRowExpiredForTTL(const meta::SchemaProviderIf* schema,
+                                        folly::StringPiece row,
+                                        int64_t ttlDuration) {
+  SchemaVer schemaVer;
+  int64_t ttlValue;
+  if (!RowReaderWrapper::getTtlValue(row, schemaVer, ttlValue) ||
+      schemaVer != schema->getVersion()) {
+    return false;
+  }
+  return time::WallClock::fastNowInSec() > ttlValue + ttlDuration;
+}
+
 std::pair<bool, std::pair<int64_t, std::string>> CommonUtils::ttlProps(
     const meta::SchemaProviderIf* schema) {
   DCHECK(schema != nullptr);
@@ -64,5 +107,17 @@ StatusOr<Value> CommonUtils::ttlValue(const meta::SchemaProviderIf* schema, RowR
   return reader->getValueByName(std::move(ttlProp).second.second);
 }
 
+std::string CommonUtils::indexVal(const meta::SchemaProviderIf* schema,
+                                  RowReader* reader,
+                                  const meta::cpp2::IndexItem* index) {
+  auto ttl = ttlValue(schema, reader);
+  auto included = IndexKeyUtils::collectIncludedValues(reader, index, schema);
+  if (included.empty()) {
+    return ttl.ok() ? IndexKeyUtils::indexVal(std::move(ttl).value()) : "";
+  }
+  return IndexKeyUtils::indexVal(ttl.ok() ? std::move(ttl).value() : Value(),
+                                 std::move(included));
+}
+
 }  // namespace storage
 }  // namespace nebula
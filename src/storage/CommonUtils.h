@@ -6,18 +6,25 @@
 #ifndef STORAGE_COMMON_H_
 #define STORAGE_COMMON_H_
 
+#include <folly/Synchronized.h>
 #include <folly/concurrency/ConcurrentHashMap.h>
 
 #include "codec/RowReader.h"
 #include "common/base/Base.h"
-#include "common/base/ConcurrentLRUCache.h"
 #include "common/meta/IndexManager.h"
 #include "common/meta/SchemaManager.h"
 #include "common/stats/StatsManager.h"
+#include "common/utils/BloomFilter.h"
 #include "common/utils/MemoryLockWrapper.h"
 #include "interface/gen-cpp2/storage_types.h"
 #include "kvstore/KVEngine.h"
 #include "kvstore/KVStore.h"
+#include "kvstore/RocksReadProfiler.h"
+#include "storage/KilledPlans.h"
+#include "storage/cache/VertexCache.h"
+#include "storage/stats/HotKeys.h"
+
+DECLARE_int32(check_plan_killed_frequency);
 
 namespace nebula {
 namespace storage {
@@ -26,6 +33,8 @@ struct ProcessorCounters {
   stats::CounterId numCalls_;
   stats::CounterId numErrors_;
   stats::CounterId latency_;
+  // The histograms of the stats of rocksdb reads of the sampled requests, by the name of stat
+  std::unordered_map<std::string, stats::CounterId> rocksdbReads_;
 
   virtual ~ProcessorCounters() = default;
 
@@ -36,6 +45,12 @@ struct ProcessorCounters {
           stats::StatsManager::registerStats("num_" + counterName + "_errors", "rate, sum");
       latency_ = stats::StatsManager::registerHisto(
           counterName + "_latency_us", 1000, 0, 20000, "avg, p75, p95, p99");
+      for (const auto& name : kvstore::RocksReadProfiler::statNames()) {
+        auto id = stats::StatsManager::registerHisto(
+            "rocksdb_read_" + name, 1000, 0, 20000, "avg, p75, p95, p99");
+        auto labelled = stats::StatsManager::histoWithLabels(id, {{"processor", counterName}});
+        rocksdbReads_.emplace(name, labelled);
+      }
       VLOG(1) << "Succeeded in initializing the ProcessorCounters instance";
     } else {
       VLOG(1) << "ProcessorCounters instance has been initialized";
@@ -51,7 +66,6 @@ enum class IndexState {
   FINISHED,  // The part is building index successfully.
 };
 
-using VertexCache = ConcurrentLRUCache<std::pair<VertexID, TagID>, std::string>;
 using IndexKey = std::tuple<GraphSpaceID, PartitionID>;
 using IndexGuard = folly::ConcurrentHashMap<IndexKey, IndexState>;
 
@@ -62,6 +76,7 @@ using EdgesMemLock = MemoryLockCore<EMLI>;
 
 class TransactionManager;
 class InternalStorageClient;
+class IndexLogApplier;
 
 // unify TagID, EdgeType
 using SchemaID = TagID;
@@ -80,7 +95,19 @@ class StorageEnv {
   std::unique_ptr<VerticesMemLock> verticesML_{nullptr};
   std::unique_ptr<EdgesMemLock> edgesML_{nullptr};
   std::unique_ptr<kvstore::KVEngine> adminStore_{nullptr};
+  // Only created when FLAGS_enable_vertex_cache is on
+  std::unique_ptr<VertexCache> vertexCache_{nullptr};
+  // Cache the edges of supernodes, only created when FLAGS_enable_adjacency_cache is on
+  std::unique_ptr<VertexCache> adjacencyCache_{nullptr};
+  // Replays the operation logs of the indexes maintained asynchronously, if it is not set the
+  // indexes are all maintained synchronously
+  IndexLogApplier* indexLogApplier_{nullptr};
+  // The hot vertices and parts of requests, only created when FLAGS_enable_hot_keys is on
+  HotKeys* hotKeys_{nullptr};
+  // The plans killed by graphd, null if the kills are only synced by meta
+  std::unique_ptr<KilledPlans> killedPlans_{nullptr};
   int32_t adminSeqId_{0};
+  folly::Synchronized<std::unordered_map<GraphSpaceID, int64_t>> writeEpochs_;
 
   IndexState getIndexState(GraphSpaceID space, PartitionID part) {
     auto key = std::make_tuple(space, part);
@@ -98,6 +125,52 @@ class StorageEnv {
   bool checkIndexLocked(IndexState indexState) {
     return indexState == IndexState::LOCKED;
   }
+
+  /**
+   * @brief Whether the changes of the index are appended to the operation log of the part instead
+   * of written to the index, which is the case when the part is rebuilding the indexes or the index
+   * is maintained asynchronously. The changes are refused when the part is locked anyway.
+   */
+  bool checkIndexLogged(IndexState indexState, const meta::cpp2::IndexItem& index) {
+    if (checkRebuilding(indexState)) {
+      return true;
+    }
+    return !checkIndexLocked(indexState) && indexLogApplier_ != nullptr && isAsyncIndex(index);
+  }
+
+  static bool isAsyncIndex(const meta::cpp2::IndexItem& index) {
+    const auto* params = index.get_index_params();
+    return params != nullptr && params->async_maintain_ref().value_or(false);
+  }
+
+  /**
+   * @brief Whether the vertex in the part is a copy of the vertex split into more parts by ALTER
+   * SPACE. The tags of a split vertex are copied to all its parts, but the indexes of them are only
+   * maintained in its own part, or a lookup would return the vertex once for each copy.
+   */
+  bool isMirrorVertex(GraphSpaceID space, PartitionID partId, folly::StringPiece vId);
+
+  /**
+   * @brief The epoch of the writes of the space on this host, which is bumped by each write of the
+   * space committed. It starts from the time the host starts, so it doesn't go back after a
+   * restart.
+   */
+  int64_t writeEpoch(GraphSpaceID space);
+
+  void bumpWriteEpoch(GraphSpaceID space);
+
+  bool hasAsyncIndex(GraphSpaceID space) {
+    for (auto isEdge : {false, true}) {
+      auto indexes = isEdge ? indexMan_->getEdgeIndexes(space) : indexMan_->getTagIndexes(space);
+      if (indexes.ok() &&
+          std::any_of(indexes.value().begin(), indexes.value().end(), [](const auto& index) {
+            return isAsyncIndex(*index);
+          })) {
+        return true;
+      }
+    }
+    return false;
+  }
 };
 
 class IndexCountWrapper {
@@ -136,6 +209,16 @@ enum class ResultStatus {
   FILTER_OUT = -2,
 };
 
+// The parts of a request are either a list of the part ids, or a map keyed by them
+inline PartitionID partIdOf(PartitionID partId) {
+  return partId;
+}
+
+template <typename T>
+PartitionID partIdOf(const std::pair<const PartitionID, T>& part) {
+  return part.first;
+}
+
 struct PropContext;
 
 // PlanContext stores information **unchanged** during the process.
@@ -163,7 +246,37 @@ class PlanContext {
       auto& common = commonRef.value();
       sessionId_ = common.session_id_ref().value_or(0);
       planId_ = common.plan_id_ref().value_or(0);
+      maxStalenessMs_ = common.max_staleness_ms_ref().value_or(0);
+      auto timeoutMs = common.timeout_ms_ref().value_or(0);
+      if (timeoutMs > 0) {
+        deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+      }
+      if (common.vid_filter_ref().has_value()) {
+        const auto& filter = *common.vid_filter_ref();
+        vidFilter_.emplace(filter.get_bits(), filter.get_num_hashes());
+      }
+      packDataSet_ = common.data_set_version_ref().value_or(0) >= DataSet::kPackedVersion;
+      encodedRows_ = common.encoded_rows_ref().value_or(false);
+      if (common.coalesced_plans_ref().has_value()) {
+        for (const auto& plan : *common.coalesced_plans_ref()) {
+          coalescedPlans_.emplace_back(plan.get_session_id(), plan.get_plan_id());
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Whether the vid may be in the vid filter of the request, always true if there is no
+   * filter. The string vid could be padded as in the keys.
+   */
+  bool mayContainVid(folly::StringPiece vId) const {
+    if (!vidFilter_.has_value()) {
+      return true;
+    }
+    if (!isIntId_) {
+      vId = vId.subpiece(0, vId.find('\0'));
     }
+    return vidFilter_->mayContain(vId);
   }
 
   StorageEnv* env_;
@@ -172,6 +285,19 @@ class PlanContext {
   ExecutionPlanID planId_;
   size_t vIdLen_;
   bool isIntId_;
+  // The max staleness accepted if the request is served by a follower, 0 means only the leader
+  // could serve it
+  int64_t maxStalenessMs_ = 0;
+  // The request is given up once it's passed, if it's set
+  std::optional<std::chrono::steady_clock::time_point> deadline_;
+  // Only the vertices, or the edges whose dst, may be in it are read
+  std::optional<BloomFilter> vidFilter_;
+  // Whether the DataSets of the response are written in the packed encoding
+  bool packDataSet_ = false;
+  // Whether the tag props of GetNeighbors are returned as the encoded rows
+  bool encodedRows_ = false;
+  // The plans of the requests coalesced into this one, it's killed only if all of them are
+  std::vector<std::pair<SessionID, ExecutionPlanID>> coalescedPlans_;
 
   // used in lookup only
   bool isEdge_ = false;
@@ -179,8 +305,8 @@ class PlanContext {
   // used for toss version
   int64_t defaultEdgeVer_ = 0L;
 
-  // will be true if query is killed during execution
-  bool isKilled_ = false;
+  // will be true if query is killed or timed out during execution, set by any of the parts
+  std::atomic<bool> isKilled_{false};
 
   // Manage expressions
   ObjectPool objPool_;
@@ -213,16 +339,62 @@ struct RuntimeContext {
     return planContext_->isEdge_;
   }
 
+  bool encodedRows() const {
+    return planContext_->encodedRows_;
+  }
+
   ObjectPool* objPool() {
     return &planContext_->objPool_;
   }
 
+  /**
+   * @brief Whether the part is read as a follower, only if the request accepts stale data and the
+   * follower is not too far behind the leader
+   */
+  bool readFromFollower(PartitionID partId) const {
+    auto maxStalenessMs = planContext_->maxStalenessMs_;
+    return maxStalenessMs > 0 && env() != nullptr &&
+           env()->kvstore_->followerReadable(spaceId(), partId, maxStalenessMs);
+  }
+
+  /**
+   * @brief Whether the query is killed, by meta or graphd, or has run out of its time. It's called
+   * for every row, so the deadline and the kills of graphd are checked once every
+   * 1 << check_plan_killed_frequency calls, the first one included, as meta client does.
+   */
   bool isPlanKilled() {
+    if (planContext_->isKilled_.load(std::memory_order_relaxed)) {
+      return true;
+    }
     if (env() == nullptr) {
       return false;
     }
-    return env()->metaClient_ &&
-           env()->metaClient_->checkIsPlanKilled(planContext_->sessionId_, planContext_->planId_);
+    auto sessionId = planContext_->sessionId_;
+    auto planId = planContext_->planId_;
+    bool killed = false;
+    bool timeout = false;
+    if (killCheckCounter_ == 0) {
+      const auto& deadline = planContext_->deadline_;
+      timeout = deadline.has_value() && std::chrono::steady_clock::now() >= *deadline;
+      killed = env()->killedPlans_ != nullptr && env()->killedPlans_->contains(sessionId, planId);
+    }
+    killCheckCounter_ = (killCheckCounter_ + 1) & ((1 << FLAGS_check_plan_killed_frequency) - 1);
+    killed = killed ||
+             (env()->metaClient_ && env()->metaClient_->checkIsPlanKilled(sessionId, planId));
+    if (killed && !planContext_->coalescedPlans_.empty()) {
+      // The request coalesced from several queries goes on until all of them are killed
+      const auto& plans = planContext_->coalescedPlans_;
+      killed = std::all_of(plans.begin(), plans.end(), [this](const auto& plan) {
+        return (env()->killedPlans_ != nullptr &&
+                env()->killedPlans_->contains(plan.first, plan.second)) ||
+               (env()->metaClient_ && env()->metaClient_->isPlanKilled(plan.first, plan.second));
+      });
+    }
+    killed = killed || timeout;
+    if (killed) {
+      planContext_->isKilled_.store(true, std::memory_order_relaxed);
+    }
+    return killed;
   }
 
   PlanContext* planContext_;
@@ -246,6 +418,9 @@ struct RuntimeContext {
   bool filterInvalidResultOut = false;
 
   ResultStatus resultStat_{ResultStatus::NORMAL};
+
+  // Counts the calls of isPlanKilled
+  int32_t killCheckCounter_{0};
 };
 
 class CommonUtils final {
@@ -260,10 +435,29 @@ class CommonUtils final {
                                      const std::string& ttlCol,
                                      int64_t ttlDuration);
 
+  /**
+   * @brief Check whether the row is expired by the value of the ttl column kept in its header, so
+   * that the expired rows are skipped without decoding them
+   *
+   * @param schema The latest schema, the value is only used if the row is in the same version
+   * @return Whether the row is known to be expired, false if it's unknown
+   */
+  static bool checkRowExpiredForTTL(const meta::SchemaProviderIf* schema,
+                                    folly::StringPiece row,
+                                    int64_t ttlDuration);
+
   static std::pair<bool, std::pair<int64_t, std::string>> ttlProps(
       const meta::SchemaProviderIf* schema);
 
   static StatusOr<Value> ttlValue(const meta::SchemaProviderIf* schema, RowReader* reader);
+
+  /**
+   * @brief Build the value of an index entry, which holds the ttl value and the values of the
+   * columns included in the index. It's empty if there is neither of them.
+   */
+  static std::string indexVal(const meta::SchemaProviderIf* schema,
+                              RowReader* reader,
+                              const meta::cpp2::IndexItem* index);
 };
 
 }  // namespace storage
@@ -7,6 +7,7 @@
 #define STORAGE_COMPACTIONFILTER_H_
 
 #include "codec/RowReaderWrapper.h"
+#include "codec/RowWriterV3.h"
 #include "common/base/Base.h"
 #include "common/meta/NebulaSchemaProvider.h"
 #include "common/utils/IndexKeyUtils.h"
@@ -14,6 +15,7 @@
 #include "common/utils/OperationKeyUtils.h"
 #include "kvstore/CompactionFilter.h"
 #include "storage/CommonUtils.h"
+#include "storage/StorageFlags.h"
 
 namespace nebula {
 namespace storage {
@@ -45,6 +47,37 @@ class StorageCompactionFilter final : public kvstore::KVFilter {
     return false;
   }
 
+  bool rewrite(GraphSpaceID spaceId,
+               const folly::StringPiece& key,
+               const folly::StringPiece& val,
+               std::string* newVal) const override {
+    if (FLAGS_row_format_version != 3 || val.empty()) {
+      return false;
+    }
+    // Upgrade the rows encoded in the older versions
+    SchemaVer schemaVer;
+    int32_t readerVer;
+    RowReaderWrapper::getVersions(val, schemaVer, readerVer);
+    if (schemaVer < 0 || readerVer >= 3) {
+      return false;
+    }
+    std::shared_ptr<const meta::NebulaSchemaProvider> schema;
+    if (NebulaKeyUtils::isTag(vIdLen_, key)) {
+      schema = schemaMan_->getTagSchema(spaceId, NebulaKeyUtils::getTagId(vIdLen_, key), schemaVer);
+    } else if (NebulaKeyUtils::isEdge(vIdLen_, key)) {
+      schema = schemaMan_->getEdgeSchema(
+          spaceId, std::abs(NebulaKeyUtils::getEdgeType(vIdLen_, key)), schemaVer);
+    }
+    if (schema == nullptr) {
+      return false;
+    }
+    auto reader = RowReaderWrapper::getRowReader(schema.get(), val);
+    if (reader == nullptr) {
+      return false;
+    }
+    return RowWriterV3::encode(*reader, *newVal) == WriteResult::SUCCEEDED;
+  }
+
  private:
   bool tagValid(GraphSpaceID spaceId,
                 const folly::StringPiece& key,
@@ -55,6 +88,10 @@ class StorageCompactionFilter final : public kvstore::KVFilter {
       VLOG(3) << "Space " << spaceId << ", Tag " << tagId << " invalid";
       return false;
     }
+    if (rowExpired(schema.get(), val)) {
+      VLOG(3) << "Ttl expired";
+      return false;
+    }
     auto reader = RowReaderWrapper::getTagPropReader(schemaMan_, spaceId, tagId, val);
     if (reader == nullptr) {
       VLOG(3) << "Remove the bad format vertex";
@@ -80,6 +117,10 @@ class StorageCompactionFilter final : public kvstore::KVFilter {
       VLOG(3) << "Space " << spaceId << ", EdgeType " << edgeType << " invalid";
       return false;
     }
+    if (rowExpired(schema.get(), val)) {
+      VLOG(3) << "Ttl expired";
+      return false;
+    }
     auto reader = RowReaderWrapper::getEdgePropReader(schemaMan_, spaceId, std::abs(edgeType), val);
     if (reader == nullptr) {
       VLOG(3) << "Remove the bad format edge!";
@@ -102,6 +143,12 @@ class StorageCompactionFilter final : public kvstore::KVFilter {
     return true;
   }
 
+  // Check the ttl by the value kept in the header of the row, without decoding it
+  bool rowExpired(const meta::SchemaProviderIf* schema, const folly::StringPiece& val) const {
+    auto ttl = CommonUtils::ttlProps(schema);
+    return ttl.first && CommonUtils::checkRowExpiredForTTL(schema, val, ttl.second.first);
+  }
+
   // TODO(panda) Optimize the method in the future
   bool ttlExpired(const meta::SchemaProviderIf* schema, nebula::RowReader* reader) const {
     if (schema == nullptr) {
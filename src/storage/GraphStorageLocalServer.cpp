@@ -24,6 +24,11 @@ using folly::exception_wrapper;
   });                                                                                            \
   return f;
 
+// The read processors are run in the reader pool of storage by themselves, so the handler is
+// called in the current thread directly, which saves a thread switch and a copy of the request
+#define LOCAL_READ_RETURN_FUTURE(callFunc) \
+  return std::dynamic_pointer_cast<GraphStorageServiceHandler>(handler_)->callFunc(request);
+
 namespace nebula::storage {
 
 std::mutex mutex_;
@@ -41,7 +46,17 @@ void GraphStorageLocalServer::setInterface(
 
 folly::Future<cpp2::GetNeighborsResponse> GraphStorageLocalServer::future_getNeighbors(
     const cpp2::GetNeighborsRequest& request) {
-  LOCAL_RETURN_FUTURE(cpp2::GetNeighborsResponse, future_getNeighbors);
+  LOCAL_READ_RETURN_FUTURE(future_getNeighbors);
+}
+
+folly::Future<cpp2::KHopGetNeighborsResponse> GraphStorageLocalServer::future_getNeighborsKHop(
+    const cpp2::KHopGetNeighborsRequest& request) {
+  LOCAL_READ_RETURN_FUTURE(future_getNeighborsKHop);
+}
+
+folly::Future<cpp2::GetDegreesResponse> GraphStorageLocalServer::future_getDegrees(
+    const cpp2::GetDegreesRequest& request) {
+  LOCAL_READ_RETURN_FUTURE(future_getDegrees);
 }
 
 folly::Future<cpp2::ExecResponse> GraphStorageLocalServer::future_addVertices(
@@ -61,7 +76,7 @@ folly::Future<cpp2::ExecResponse> GraphStorageLocalServer::future_addEdges(
 
 folly::Future<cpp2::GetPropResponse> GraphStorageLocalServer::future_getProps(
     const cpp2::GetPropRequest& request) {
-  LOCAL_RETURN_FUTURE(cpp2::GetPropResponse, future_getProps);
+  LOCAL_READ_RETURN_FUTURE(future_getProps);
 }
 
 folly::Future<cpp2::ExecResponse> GraphStorageLocalServer::future_deleteEdges(
@@ -104,9 +119,15 @@ folly::Future<cpp2::GetUUIDResp> GraphStorageLocalServer::future_getUUID(
   LOCAL_RETURN_FUTURE(cpp2::GetUUIDResp, future_getUUID);
 }
 
+folly::Future<cpp2::ExecResponse> GraphStorageLocalServer::future_killPlan(
+    const cpp2::KillPlanRequest& request) {
+  // It only records the plan, so it's called in the current thread as well
+  LOCAL_READ_RETURN_FUTURE(future_killPlan);
+}
+
 folly::Future<cpp2::LookupIndexResp> GraphStorageLocalServer::future_lookupIndex(
     const cpp2::LookupIndexRequest& request) {
-  LOCAL_RETURN_FUTURE(cpp2::LookupIndexResp, future_lookupIndex);
+  LOCAL_READ_RETURN_FUTURE(future_lookupIndex);
 }
 
 folly::Future<cpp2::GetNeighborsResponse> GraphStorageLocalServer::future_lookupAndTraverse(
@@ -116,12 +137,12 @@ folly::Future<cpp2::GetNeighborsResponse> GraphStorageLocalServer::future_lookup
 
 folly::Future<cpp2::ScanResponse> GraphStorageLocalServer::future_scanVertex(
     const cpp2::ScanVertexRequest& request) {
-  LOCAL_RETURN_FUTURE(cpp2::ScanResponse, future_scanVertex);
+  LOCAL_READ_RETURN_FUTURE(future_scanVertex);
 }
 
 folly::Future<cpp2::ScanResponse> GraphStorageLocalServer::future_scanEdge(
     const cpp2::ScanEdgeRequest& request) {
-  LOCAL_RETURN_FUTURE(cpp2::ScanResponse, future_scanEdge);
+  LOCAL_READ_RETURN_FUTURE(future_scanEdge);
 }
 
 folly::Future<cpp2::KVGetResponse> GraphStorageLocalServer::future_get(
@@ -29,6 +29,9 @@ class GraphStorageLocalServer final : public boost::noncopyable, public nebula::
  public:
   folly::Future<cpp2::GetNeighborsResponse> future_getNeighbors(
       const cpp2::GetNeighborsRequest& request);
+  folly::Future<cpp2::KHopGetNeighborsResponse> future_getNeighborsKHop(
+      const cpp2::KHopGetNeighborsRequest& request);
+  folly::Future<cpp2::GetDegreesResponse> future_getDegrees(const cpp2::GetDegreesRequest& request);
   folly::Future<cpp2::ExecResponse> future_addVertices(const cpp2::AddVerticesRequest& request);
   folly::Future<cpp2::ExecResponse> future_chainAddEdges(const cpp2::AddEdgesRequest& request);
   folly::Future<cpp2::ExecResponse> future_addEdges(const cpp2::AddEdgesRequest& request);
@@ -44,6 +47,7 @@ class GraphStorageLocalServer final : public boost::noncopyable, public nebula::
       const cpp2::UpdateEdgeRequest& request);
   folly::Future<cpp2::UpdateResponse> future_updateEdge(const cpp2::UpdateEdgeRequest& request);
   folly::Future<cpp2::GetUUIDResp> future_getUUID(const cpp2::GetUUIDReq& request);
+  folly::Future<cpp2::ExecResponse> future_killPlan(const cpp2::KillPlanRequest& request);
   folly::Future<cpp2::LookupIndexResp> future_lookupIndex(const cpp2::LookupIndexRequest& request);
   folly::Future<cpp2::GetNeighborsResponse> future_lookupAndTraverse(
       const cpp2::LookupAndTraverseRequest& request);
@@ -18,6 +18,9 @@
 #include "storage/mutate/UpdateVertexProcessor.h"
 #include "storage/query/GetNeighborsProcessor.h"
 #include "storage/query/GetPropProcessor.h"
+#include "storage/query/GetDegreesProcessor.h"
+#include "storage/query/KHopGetNeighborsProcessor.h"
+#include "storage/query/ExportProcessor.h"
 #include "storage/query/ScanEdgeProcessor.h"
 #include "storage/query/ScanVertexProcessor.h"
 #include "storage/transaction/ChainAddEdgesGroupProcessor.h"
@@ -29,24 +32,32 @@
   processor->process(req);         \
   return f;
 
+// The request is processed with its span active, so the writes it submits are its children
+#define RETURN_TRACED_FUTURE(processor, name)               \
+  auto f = processor->getFuture();                          \
+  processor->reportWriteEpoch(req.get_space_id());          \
+  tracing::Scope scope(processor->traceRequest(name, req)); \
+  processor->process(req);                                  \
+  return f;
+
+// The read is run by the threads of its resource group, or failed at once if the group is full
+#define RETURN_GROUPED_FUTURE(processor, group, name)                                \
+  auto f = processor->getFuture();                                                 \
+  if (!group->admit()) {                                                           \
+    processor->reject(nebula::cpp2::ErrorCode::E_RESOURCE_GROUP_OVERLOADED, req);  \
+    return f;                                                                      \
+  }                                                                                \
+  processor->reportWriteEpoch(req.get_space_id());                                 \
+  tracing::Scope scope(processor->traceRequest(name, req));                        \
+  processor->process(req);                                                         \
+  return std::move(f).ensure([group] { group->release(); });
+
 namespace nebula {
 namespace storage {
 
 GraphStorageServiceHandler::GraphStorageServiceHandler(StorageEnv* env) : env_(env) {
-  if (FLAGS_reader_handlers_type == "io") {
-    auto tf = std::make_shared<folly::NamedThreadFactory>("reader-pool");
-    readerPool_ =
-        std::make_shared<folly::IOThreadPoolExecutor>(FLAGS_reader_handlers, std::move(tf));
-  } else {
-    if (FLAGS_reader_handlers_type != "cpu") {
-      LOG(WARNING) << "Unknown value for --reader_handlers_type, using `cpu'";
-    }
-    using TM = apache::thrift::concurrency::PriorityThreadManager;
-    auto pool = TM::newPriorityThreadManager(FLAGS_reader_handlers);
-    pool->setNamePrefix("reader-pool");
-    pool->start();
-    readerPool_ = std::move(pool);
-  }
+  auto readerPools = ResourceGroups::makePools("reader-pool", FLAGS_reader_handlers);
+  resourceGroups_ = std::make_unique<ResourceGroups>(std::move(readerPools), env_);
 
   // Initialize all counters
   kAddVerticesCounters.init("add_vertices");
@@ -57,10 +68,13 @@ GraphStorageServiceHandler::GraphStorageServiceHandler(StorageEnv* env) : env_(e
   kUpdateVertexCounters.init("update_vertex");
   kUpdateEdgeCounters.init("update_edge");
   kGetNeighborsCounters.init("get_neighbors");
+  kKHopGetNeighborsCounters.init("get_neighbors_khop");
+  kGetDegreesCounters.init("get_degrees");
   kGetPropCounters.init("get_prop");
   kLookupCounters.init("lookup");
   kScanVertexCounters.init("scan_vertex");
   kScanEdgeCounters.init("scan_edge");
+  kExportCounters.init("export");
   kPutCounters.init("kv_put");
   kGetCounters.init("kv_get");
   kRemoveCounters.init("kv_remove");
@@ -70,45 +84,48 @@ GraphStorageServiceHandler::GraphStorageServiceHandler(StorageEnv* env) : env_(e
 folly::Future<cpp2::ExecResponse> GraphStorageServiceHandler::future_addVertices(
     const cpp2::AddVerticesRequest& req) {
   auto* processor = AddVerticesProcessor::instance(env_, &kAddVerticesCounters);
-  RETURN_FUTURE(processor);
+  RETURN_TRACED_FUTURE(processor, "storage.add_vertices");
 }
 
 folly::Future<cpp2::ExecResponse> GraphStorageServiceHandler::future_deleteVertices(
     const cpp2::DeleteVerticesRequest& req) {
   auto* processor = DeleteVerticesProcessor::instance(env_, &kDelVerticesCounters);
-  RETURN_FUTURE(processor);
+  RETURN_TRACED_FUTURE(processor, "storage.delete_vertices");
 }
 
 folly::Future<cpp2::ExecResponse> GraphStorageServiceHandler::future_deleteTags(
     const cpp2::DeleteTagsRequest& req) {
   auto* processor = DeleteTagsProcessor::instance(env_, &kDelTagsCounters);
-  RETURN_FUTURE(processor);
+  RETURN_TRACED_FUTURE(processor, "storage.delete_tags");
 }
 
 folly::Future<cpp2::UpdateResponse> GraphStorageServiceHandler::future_updateVertex(
     const cpp2::UpdateVertexRequest& req) {
-  auto* processor =
-      UpdateVertexProcessor::instance(env_, &kUpdateVertexCounters, readerPool_.get());
-  RETURN_FUTURE(processor);
+  auto node = resourceGroups_->numaNode(req.get_space_id(), req.get_part_id());
+  auto* executor = resourceGroups_->defaultGroup()->executor(node);
+  auto* processor = UpdateVertexProcessor::instance(env_, &kUpdateVertexCounters, executor);
+  RETURN_TRACED_FUTURE(processor, "storage.update_vertex");
 }
 
 // Edge section
 folly::Future<cpp2::ExecResponse> GraphStorageServiceHandler::future_addEdges(
     const cpp2::AddEdgesRequest& req) {
   auto* processor = AddEdgesProcessor::instance(env_, &kAddEdgesCounters);
-  RETURN_FUTURE(processor);
+  RETURN_TRACED_FUTURE(processor, "storage.add_edges");
 }
 
 folly::Future<cpp2::ExecResponse> GraphStorageServiceHandler::future_deleteEdges(
     const cpp2::DeleteEdgesRequest& req) {
   auto* processor = DeleteEdgesProcessor::instance(env_, &kDelEdgesCounters);
-  RETURN_FUTURE(processor);
+  RETURN_TRACED_FUTURE(processor, "storage.delete_edges");
 }
 
 folly::Future<cpp2::UpdateResponse> GraphStorageServiceHandler::future_updateEdge(
     const cpp2::UpdateEdgeRequest& req) {
-  auto* processor = UpdateEdgeProcessor::instance(env_, &kUpdateEdgeCounters, readerPool_.get());
-  RETURN_FUTURE(processor);
+  auto node = resourceGroups_->numaNode(req.get_space_id(), req.get_part_id());
+  auto* executor = resourceGroups_->defaultGroup()->executor(node);
+  auto* processor = UpdateEdgeProcessor::instance(env_, &kUpdateEdgeCounters, executor);
+  RETURN_TRACED_FUTURE(processor, "storage.update_edge");
 }
 
 folly::Future<cpp2::UpdateResponse> GraphStorageServiceHandler::future_chainUpdateEdge(
@@ -119,33 +136,66 @@ folly::Future<cpp2::UpdateResponse> GraphStorageServiceHandler::future_chainUpda
 
 folly::Future<cpp2::GetNeighborsResponse> GraphStorageServiceHandler::future_getNeighbors(
     const cpp2::GetNeighborsRequest& req) {
-  auto* processor =
-      GetNeighborsProcessor::instance(env_, &kGetNeighborsCounters, readerPool_.get());
-  RETURN_FUTURE(processor);
+  auto* group = resourceGroups_->pick(req);
+  auto* executor = group->executor(resourceGroups_->numaNode(req));
+  auto* processor = GetNeighborsProcessor::instance(env_, &kGetNeighborsCounters, executor);
+  RETURN_GROUPED_FUTURE(processor, group, "storage.get_neighbors");
+}
+
+folly::Future<cpp2::KHopGetNeighborsResponse> GraphStorageServiceHandler::future_getNeighborsKHop(
+    const cpp2::KHopGetNeighborsRequest& req) {
+  auto* group = resourceGroups_->pick(req);
+  auto* executor = group->executor(resourceGroups_->numaNode(req));
+  auto* processor = KHopGetNeighborsProcessor::instance(env_, &kKHopGetNeighborsCounters, executor);
+  RETURN_GROUPED_FUTURE(processor, group, "storage.get_neighbors_khop");
+}
+
+folly::Future<cpp2::GetDegreesResponse> GraphStorageServiceHandler::future_getDegrees(
+    const cpp2::GetDegreesRequest& req) {
+  auto* group = resourceGroups_->pick(req);
+  auto* executor = group->executor(resourceGroups_->numaNode(req));
+  auto* processor = GetDegreesProcessor::instance(env_, &kGetDegreesCounters, executor);
+  RETURN_GROUPED_FUTURE(processor, group, "storage.get_degrees");
 }
 
 folly::Future<cpp2::GetPropResponse> GraphStorageServiceHandler::future_getProps(
     const cpp2::GetPropRequest& req) {
-  auto* processor = GetPropProcessor::instance(env_, &kGetPropCounters, readerPool_.get());
-  RETURN_FUTURE(processor);
+  auto* group = resourceGroups_->pick(req);
+  auto* executor = group->executor(resourceGroups_->numaNode(req));
+  auto* processor = GetPropProcessor::instance(env_, &kGetPropCounters, executor);
+  RETURN_GROUPED_FUTURE(processor, group, "storage.get_prop");
 }
 
 folly::Future<cpp2::LookupIndexResp> GraphStorageServiceHandler::future_lookupIndex(
     const cpp2::LookupIndexRequest& req) {
-  auto* processor = LookupProcessor::instance(env_, &kLookupCounters, readerPool_.get());
-  RETURN_FUTURE(processor);
+  auto* group = resourceGroups_->pick(req);
+  auto* executor = group->executor(resourceGroups_->numaNode(req));
+  auto* processor = LookupProcessor::instance(env_, &kLookupCounters, executor);
+  RETURN_GROUPED_FUTURE(processor, group, "storage.lookup");
 }
 
 folly::Future<cpp2::ScanResponse> GraphStorageServiceHandler::future_scanVertex(
     const cpp2::ScanVertexRequest& req) {
-  auto* processor = ScanVertexProcessor::instance(env_, &kScanVertexCounters, readerPool_.get());
-  RETURN_FUTURE(processor);
+  auto* group = resourceGroups_->pick(req);
+  auto* executor = group->executor(resourceGroups_->numaNode(req));
+  auto* processor = ScanVertexProcessor::instance(env_, &kScanVertexCounters, executor);
+  RETURN_GROUPED_FUTURE(processor, group, "storage.scan_vertex");
 }
 
 folly::Future<cpp2::ScanResponse> GraphStorageServiceHandler::future_scanEdge(
     const cpp2::ScanEdgeRequest& req) {
-  auto* processor = ScanEdgeProcessor::instance(env_, &kScanEdgeCounters, readerPool_.get());
-  RETURN_FUTURE(processor);
+  auto* group = resourceGroups_->pick(req);
+  auto* executor = group->executor(resourceGroups_->numaNode(req));
+  auto* processor = ScanEdgeProcessor::instance(env_, &kScanEdgeCounters, executor);
+  RETURN_GROUPED_FUTURE(processor, group, "storage.scan_edge");
+}
+
+folly::Future<cpp2::ExportResponse> GraphStorageServiceHandler::future_exportData(
+    const cpp2::ExportRequest& req) {
+  auto* group = resourceGroups_->pick(req);
+  auto* executor = group->executor(resourceGroups_->numaNode(req));
+  auto* processor = ExportProcessor::instance(env_, &kExportCounters, executor);
+  RETURN_GROUPED_FUTURE(processor, group, "storage.export");
 }
 
 folly::Future<cpp2::GetUUIDResp> GraphStorageServiceHandler::future_getUUID(
@@ -155,15 +205,30 @@ folly::Future<cpp2::GetUUIDResp> GraphStorageServiceHandler::future_getUUID(
   return ret;
 }
 
+folly::Future<cpp2::ExecResponse> GraphStorageServiceHandler::future_killPlan(
+    const cpp2::KillPlanRequest& req) {
+  // The requests of the plan check it by themselves, so it's only recorded
+  if (env_->killedPlans_ != nullptr) {
+    env_->killedPlans_->add(req.get_session_id(), req.get_plan_id());
+    VLOG(1) << "Plan killed by graphd, session: " << req.get_session_id()
+            << ", plan: " << req.get_plan_id();
+  }
+  cpp2::ExecResponse resp;
+  resp.result_ref()->latency_in_us_ref() = 0;
+  return resp;
+}
+
 folly::Future<cpp2::ExecResponse> GraphStorageServiceHandler::future_chainAddEdges(
     const cpp2::AddEdgesRequest& req) {
   auto* processor = ChainAddEdgesGroupProcessor::instance(env_);
+  processor->reportWriteEpoch(req.get_space_id());
   RETURN_FUTURE(processor);
 }
 
 folly::Future<cpp2::ExecResponse> GraphStorageServiceHandler::future_chainDeleteEdges(
     const cpp2::DeleteEdgesRequest& req) {
   auto* processor = ChainDeleteEdgesGroupProcessor::instance(env_);
+  processor->reportWriteEpoch(req.get_space_id());
   RETURN_FUTURE(processor);
 }
 
@@ -11,6 +11,7 @@
 #include "common/base/Base.h"
 #include "interface/gen-cpp2/GraphStorageService.h"
 #include "storage/CommonUtils.h"
+#include "storage/ResourceGroups.h"
 #include "storage/StorageFlags.h"
 
 namespace nebula {
@@ -45,6 +46,12 @@ class GraphStorageServiceHandler final : public cpp2::GraphStorageServiceSvIf {
   folly::Future<cpp2::GetNeighborsResponse> future_getNeighbors(
       const cpp2::GetNeighborsRequest& req) override;
 
+  folly::Future<cpp2::KHopGetNeighborsResponse> future_getNeighborsKHop(
+      const cpp2::KHopGetNeighborsRequest& req) override;
+
+  folly::Future<cpp2::GetDegreesResponse> future_getDegrees(
+      const cpp2::GetDegreesRequest& req) override;
+
   folly::Future<cpp2::GetPropResponse> future_getProps(const cpp2::GetPropRequest& req) override;
 
   folly::Future<cpp2::LookupIndexResp> future_lookupIndex(
@@ -62,8 +69,12 @@ class GraphStorageServiceHandler final : public cpp2::GraphStorageServiceSvIf {
 
   folly::Future<cpp2::ScanResponse> future_scanEdge(const cpp2::ScanEdgeRequest& req) override;
 
+  folly::Future<cpp2::ExportResponse> future_exportData(const cpp2::ExportRequest& req) override;
+
   folly::Future<cpp2::GetUUIDResp> future_getUUID(const cpp2::GetUUIDReq& req) override;
 
+  folly::Future<cpp2::ExecResponse> future_killPlan(const cpp2::KillPlanRequest& req) override;
+
   folly::Future<cpp2::ExecResponse> future_put(const cpp2::KVPutRequest& req) override;
 
   folly::Future<cpp2::KVGetResponse> future_get(const cpp2::KVGetRequest& req) override;
@@ -72,7 +83,9 @@ class GraphStorageServiceHandler final : public cpp2::GraphStorageServiceSvIf {
 
  private:
   StorageEnv* env_{nullptr};
-  std::shared_ptr<folly::Executor> readerPool_;
+  // The reads are run by the threads of their groups, the default one is of the reader handlers,
+  // which also runs the updates
+  std::unique_ptr<ResourceGroups> resourceGroups_;
 };
 
 }  // namespace storage
@@ -5,6 +5,7 @@
 
 #include "storage/InternalStorageServiceHandler.h"
 
+#include "storage/admin/AlgoMailbox.h"
 #include "storage/transaction/ChainAddEdgesRemoteProcessor.h"
 #include "storage/transaction/ChainDeleteEdgesRemoteProcessor.h"
 #include "storage/transaction/ChainUpdateEdgeRemoteProcessor.h"
@@ -37,5 +38,13 @@ folly::Future<cpp2::ExecResponse> InternalStorageServiceHandler::future_chainDel
   RETURN_FUTURE(processor);
 }
 
+folly::Future<cpp2::ExecResponse> InternalStorageServiceHandler::future_algoMessages(
+    const cpp2::AlgoMessagesRequest& req) {
+  AlgoMailbox::instance()->deliver(req);
+  cpp2::ExecResponse resp;
+  resp.result_ref() = cpp2::ResponseCommon();
+  return resp;
+}
+
 }  // namespace storage
 }  // namespace nebula
@@ -31,6 +31,9 @@ class InternalStorageServiceHandler final : public cpp2::InternalStorageServiceS
   folly::Future<cpp2::ExecResponse> future_chainDeleteEdges(
       const cpp2::ChainDeleteEdgesRequest& p_req) override;
 
+  folly::Future<cpp2::ExecResponse> future_algoMessages(
+      const cpp2::AlgoMessagesRequest& p_req) override;
+
  private:
   StorageEnv* env_{nullptr};
 };
@@ -0,0 +1,37 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/KilledPlans.h"
+
+#include "common/time/WallClock.h"
+#include "storage/StorageFlags.h"
+
+namespace nebula {
+namespace storage {
+
+void KilledPlans::add(SessionID sessionId, ExecutionPlanID planId) {
+  auto now = time::WallClock::fastNowInSec();
+  auto plans = plans_.wlock();
+  for (auto iter = plans->begin(); iter != plans->end();) {
+    if (now - iter->second >= FLAGS_killed_plans_retention_secs) {
+      iter = plans->erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  (*plans)[std::make_pair(sessionId, planId)] = now;
+  size_.store(plans->size(), std::memory_order_release);
+}
+
+bool KilledPlans::contains(SessionID sessionId, ExecutionPlanID planId) const {
+  if (size_.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  auto plans = plans_.rlock();
+  return plans->find(std::make_pair(sessionId, planId)) != plans->end();
+}
+
+}  // namespace storage
+}  // namespace nebula
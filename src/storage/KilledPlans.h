@@ -0,0 +1,41 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_KILLEDPLANS_H_
+#define STORAGE_KILLEDPLANS_H_
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+#include "common/base/Base.h"
+#include "common/thrift/ThriftTypes.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief The plans killed by graphd through the killPlan interface. It's only a shortcut of the
+ * killed plans synced by meta, so a plan is forgotten after killed_plans_retention_secs, by when
+ * meta has synced it or its requests are over.
+ */
+class KilledPlans final {
+ public:
+  void add(SessionID sessionId, ExecutionPlanID planId);
+
+  bool contains(SessionID sessionId, ExecutionPlanID planId) const;
+
+ private:
+  using PlanKey = std::pair<SessionID, ExecutionPlanID>;
+
+  // The plans and when they are killed, in seconds
+  folly::Synchronized<folly::F14FastMap<PlanKey, int64_t>> plans_;
+  // So that the usual case of no plan killed doesn't take the lock
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // STORAGE_KILLEDPLANS_H_
@@ -8,13 +8,33 @@
 
 #include <rocksdb/merge_operator.h>
 
+#include "codec/CounterOperand.h"
+#include "codec/RowReaderWrapper.h"
+#include "codec/RowWriterV3.h"
 #include "common/base/Base.h"
+#include "common/meta/SchemaManager.h"
+#include "storage/StorageFlags.h"
+#include "storage/exec/QueryUtils.h"
 
 namespace nebula {
 namespace storage {
 
+/**
+ * @brief Merge operator applying the CounterOperand to the rows. The operands are written by the
+ * updates in the form of `SET x = x + 1`, so that they are replicated without reading the row
+ * first. The operands are applied to the latest schema of the row when it is read or compacted.
+ *
+ * A merge must not fail, since a failure breaks the reads and the compaction of the key. So the row
+ * is kept unchanged if an operand could not be applied. The merges into the missing rows are
+ * skipped when the logs are applied, see PendingRows, so the empty value left by such a merge is
+ * only a fallback.
+ */
 class NebulaOperator : public rocksdb::MergeOperator {
  public:
+  explicit NebulaOperator(meta::SchemaManager* schemaMan) : schemaMan_(schemaMan) {
+    CHECK_NOTNULL(schemaMan_);
+  }
+
   const char* Name() const override {
     return "NebulaMergeOperator";
   }
@@ -22,10 +42,16 @@ class NebulaOperator : public rocksdb::MergeOperator {
  private:
   bool FullMergeV2(const MergeOperationInput& merge_in,
                    MergeOperationOutput* merge_out) const override {
-    UNUSED(merge_in);
-    UNUSED(merge_out);
-    LOG(ERROR) << "NebulaMergeOperator not supported yet";
-    return false;
+    if (merge_in.existing_value == nullptr) {
+      VLOG(3) << "Merge into a missing row, key " << folly::hexlify(toPiece(merge_in.key));
+      merge_out->new_value.clear();
+      return true;
+    }
+    auto existing = toPiece(*merge_in.existing_value);
+    if (!apply(existing, merge_in.operand_list, &merge_out->new_value)) {
+      merge_out->new_value.assign(existing.data(), existing.size());
+    }
+    return true;
   }
 
   bool PartialMerge(const rocksdb::Slice& key,
@@ -34,13 +60,100 @@ class NebulaOperator : public rocksdb::MergeOperator {
                     std::string* new_value,
                     rocksdb::Logger* logger) const override {
     UNUSED(key);
-    UNUSED(left_operand);
-    UNUSED(right_operand);
-    UNUSED(new_value);
     UNUSED(logger);
-    LOG(ERROR) << "NebulaMergeOperator not supported yet";
-    return false;
+    auto left = CounterOperand::decode(toPiece(left_operand));
+    auto right = CounterOperand::decode(toPiece(right_operand));
+    if (!left.has_value() || !right.has_value() || left->spaceId != right->spaceId ||
+        left->isEdge != right->isEdge || left->schemaId != right->schemaId) {
+      return false;
+    }
+    for (auto& delta : right->deltas) {
+      auto iter = std::find_if(left->deltas.begin(), left->deltas.end(), [&delta](const auto& d) {
+        return d.first == delta.first;
+      });
+      if (iter == left->deltas.end()) {
+        left->deltas.emplace_back(std::move(delta));
+      } else if (!CounterOperand::add(iter->second, delta.second)) {
+        return false;
+      }
+    }
+    *new_value = left->encode();
+    return true;
+  }
+
+  bool apply(folly::StringPiece existing,
+             const std::vector<rocksdb::Slice>& operands,
+             std::string* newValue) const {
+    std::optional<CounterOperand> first;
+    std::unordered_map<std::string, std::vector<Value>> deltas;
+    for (const auto& slice : operands) {
+      auto operand = CounterOperand::decode(toPiece(slice));
+      if (!operand.has_value()) {
+        LOG(ERROR) << "Bad merge operand " << folly::hexlify(toPiece(slice));
+        return false;
+      }
+      for (auto& delta : operand->deltas) {
+        deltas[delta.first].emplace_back(std::move(delta.second));
+      }
+      if (!first.has_value()) {
+        first = std::move(operand);
+      }
+    }
+    if (!first.has_value()) {
+      return false;
+    }
+
+    auto spaceId = first->spaceId;
+    auto schema = first->isEdge ? schemaMan_->getEdgeSchema(spaceId, first->schemaId)
+                                : schemaMan_->getTagSchema(spaceId, first->schemaId);
+    if (schema == nullptr) {
+      return false;
+    }
+    auto reader =
+        first->isEdge
+            ? RowReaderWrapper::getEdgePropReader(schemaMan_, spaceId, first->schemaId, existing)
+            : RowReaderWrapper::getTagPropReader(schemaMan_, spaceId, first->schemaId, existing);
+    if (reader == nullptr) {
+      return false;
+    }
+
+    RowWriterV2 writer(schema.get());
+    for (size_t i = 0; i < schema->getNumFields(); i++) {
+      auto name = std::string(schema->getFieldName(i));
+      auto value = QueryUtils::readValue(reader.get(), name, schema.get());
+      if (!value.ok()) {
+        return false;
+      }
+      auto iter = deltas.find(name);
+      if (iter != deltas.end()) {
+        for (const auto& delta : iter->second) {
+          if (!CounterOperand::add(value.value(), delta)) {
+            LOG(WARNING) << "Skip the delta " << delta << " of prop " << name << ", value "
+                         << value.value();
+          }
+        }
+      }
+      if (writer.setValue(name, std::move(value).value()) != WriteResult::SUCCEEDED) {
+        return false;
+      }
+    }
+    if (writer.finish() != WriteResult::SUCCEEDED) {
+      return false;
+    }
+    *newValue = std::move(writer).moveEncodedStr();
+    if (FLAGS_row_format_version == 3 &&
+        RowWriterV3::upgrade(schema.get(), *newValue) != WriteResult::SUCCEEDED) {
+      return false;
+    }
+    return true;
+  }
+
+  static folly::StringPiece toPiece(const rocksdb::Slice& slice) {
+    return folly::StringPiece(slice.data(), slice.size());
   }
+
+ private:
+  meta::SchemaManager* schemaMan_{nullptr};
 };
 
 }  // namespace storage
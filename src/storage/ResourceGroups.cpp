@@ -0,0 +1,192 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/ResourceGroups.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <thrift/lib/cpp/concurrency/ThreadManager.h>
+
+#include "common/thread/NumaTopology.h"
+#include "kvstore/Part.h"
+#include "storage/StorageFlags.h"
+#include "storage/stats/StorageStats.h"
+
+namespace nebula {
+namespace storage {
+
+ResourceGroup::ResourceGroup(std::string name,
+                             std::vector<std::shared_ptr<folly::Executor>> pools,
+                             size_t maxInflight)
+    : name_(std::move(name)), pools_(std::move(pools)), maxInflight_(maxInflight) {
+  DCHECK(!pools_.empty());
+  std::vector<std::pair<std::string, std::string>> labels = {{"group", name_}};
+  if (kNumResourceGroupRequests.valid()) {
+    numRequests_ = stats::StatsManager::counterWithLabels(kNumResourceGroupRequests, labels);
+  }
+  if (kNumResourceGroupRejected.valid()) {
+    numRejected_ = stats::StatsManager::counterWithLabels(kNumResourceGroupRejected, labels);
+  }
+}
+
+bool ResourceGroup::admit() {
+  if (numRequests_.has_value()) {
+    stats::StatsManager::addValue(*numRequests_);
+  }
+  auto inflight = inflight_.fetch_add(1, std::memory_order_relaxed);
+  if (maxInflight_ == 0 || inflight < maxInflight_) {
+    return true;
+  }
+  inflight_.fetch_sub(1, std::memory_order_relaxed);
+  if (numRejected_.has_value()) {
+    stats::StatsManager::addValue(*numRejected_);
+  }
+  return false;
+}
+
+void ResourceGroup::release() {
+  inflight_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+ResourceGroups::ResourceGroups(std::vector<std::shared_ptr<folly::Executor>> defaultPools,
+                               StorageEnv* env)
+    : env_(env), numaAware_(defaultPools.size() > 1) {
+  auto defaultGroup = std::make_unique<ResourceGroup>(kDefaultGroup, std::move(defaultPools), 0);
+  defaultGroup_ = defaultGroup.get();
+  groups_.emplace(kDefaultGroup, std::move(defaultGroup));
+
+  // The bad items are skipped, so that a typo doesn't stop storaged
+  std::vector<folly::StringPiece> items;
+  folly::split(",", FLAGS_storage_resource_groups, items, true);
+  for (auto item : items) {
+    std::vector<std::string> fields;
+    folly::split(":", folly::trimWhitespace(item), fields, true);
+    if (fields.size() < 2 || fields.size() > 3 || groups_.count(fields[0]) != 0) {
+      LOG(ERROR) << "Invalid resource group in --storage_resource_groups: " << item;
+      continue;
+    }
+    auto threads = folly::tryTo<int32_t>(fields[1]);
+    auto maxInflight = folly::tryTo<int64_t>(fields.size() == 3 ? fields[2] : "0");
+    if (!threads.hasValue() || threads.value() <= 0 || !maxInflight.hasValue() ||
+        maxInflight.value() < 0) {
+      LOG(ERROR) << "Invalid resource group in --storage_resource_groups: " << item;
+      continue;
+    }
+    auto pools = makePools(folly::sformat("rg-{}", fields[0]), threads.value());
+    auto rg = std::make_unique<ResourceGroup>(fields[0], std::move(pools), maxInflight.value());
+    groups_.emplace(fields[0], std::move(rg));
+    LOG(INFO) << "Resource group " << fields[0] << ", threads: " << threads.value()
+              << ", max inflight: " << maxInflight.value();
+  }
+
+  items.clear();
+  folly::split(",", FLAGS_space_resource_groups, items, true);
+  for (auto item : items) {
+    std::vector<std::string> fields;
+    folly::split(":", folly::trimWhitespace(item), fields, true);
+    auto* found = fields.size() == 2 ? group(fields[1]) : nullptr;
+    if (found == nullptr) {
+      LOG(ERROR) << "Invalid space resource group in --space_resource_groups: " << item;
+      continue;
+    }
+    spaceGroups_[fields[0]] = found;
+  }
+}
+
+// static
+std::vector<std::shared_ptr<folly::Executor>> ResourceGroups::makePools(const std::string& prefix,
+                                                                        int32_t threads) {
+  const auto& topology = thread::NumaTopology::instance();
+  auto numNodes = topology.numNodes();
+  if (!FLAGS_numa_aware || numNodes <= 1) {
+    return {makePool(prefix, threads)};
+  }
+  // The threads are shared evenly by the nodes, as the disks are usually, the first nodes take one
+  // more thread each for the remainder
+  std::vector<std::shared_ptr<folly::Executor>> pools;
+  for (size_t node = 0; node < numNodes; node++) {
+    auto nodeThreads = std::max<int32_t>(1, threads / numNodes + (node < threads % numNodes));
+    pools.emplace_back(
+        makePool(folly::sformat("{}-n{}", prefix, node), nodeThreads, topology.cpusOf(node)));
+  }
+  return pools;
+}
+
+// static
+std::shared_ptr<folly::Executor> ResourceGroups::makePool(const std::string& prefix,
+                                                          int32_t threads,
+                                                          const std::vector<int>& cpus) {
+  if (FLAGS_reader_handlers_type != "io" && FLAGS_reader_handlers_type != "cpu") {
+    LOG(WARNING) << "Unknown value for --reader_handlers_type, using `cpu'";
+  }
+  if (!cpus.empty() || thread::MemoryArenas::arenaOf(thread::MemoryArenas::kReader).has_value()) {
+    // The thread manager of thrift doesn't take a folly thread factory to bind the threads
+    auto tf =
+        std::make_shared<thread::BoundThreadFactory>(prefix, cpus, thread::MemoryArenas::kReader);
+    if (FLAGS_reader_handlers_type == "io") {
+      return std::make_shared<folly::IOThreadPoolExecutor>(threads, std::move(tf));
+    }
+    return std::make_shared<folly::CPUThreadPoolExecutor>(threads, std::move(tf));
+  }
+  if (FLAGS_reader_handlers_type == "io") {
+    auto tf = std::make_shared<folly::NamedThreadFactory>(prefix);
+    return std::make_shared<folly::IOThreadPoolExecutor>(threads, std::move(tf));
+  }
+  using TM = apache::thrift::concurrency::PriorityThreadManager;
+  auto pool = TM::newPriorityThreadManager(threads);
+  pool->setNamePrefix(prefix);
+  pool->start();
+  return pool;
+}
+
+ResourceGroup* ResourceGroups::pick(GraphSpaceID spaceId, const std::string* name) {
+  if (name != nullptr) {
+    auto* found = group(*name);
+    if (found != nullptr) {
+      return found;
+    }
+  }
+  if (!spaceGroups_.empty() && env_ != nullptr && env_->schemaMan_ != nullptr) {
+    auto spaceName = env_->schemaMan_->toGraphSpaceName(spaceId);
+    if (spaceName.ok()) {
+      auto iter = spaceGroups_.find(spaceName.value());
+      if (iter != spaceGroups_.end()) {
+        return iter->second;
+      }
+    }
+  }
+  return defaultGroup_;
+}
+
+ResourceGroup* ResourceGroups::group(const std::string& name) const {
+  auto iter = groups_.find(name);
+  return iter == groups_.end() ? nullptr : iter->second.get();
+}
+
+int ResourceGroups::numaNode(GraphSpaceID spaceId, PartitionID partId) {
+  if (!numaAware_ || env_ == nullptr || env_->kvstore_ == nullptr) {
+    return -1;
+  }
+  auto part = env_->kvstore_->part(spaceId, partId);
+  if (!nebula::ok(part)) {
+    return -1;
+  }
+  std::string dataRoot = nebula::value(part)->engine()->getDataRoot();
+  {
+    auto nodes = dataRootNodes_.rlock();
+    auto iter = nodes->find(dataRoot);
+    if (iter != nodes->end()) {
+      return iter->second;
+    }
+  }
+  // Only the first read of an engine looks up sysfs
+  auto node = thread::NumaTopology::instance().nodeOfPath(dataRoot);
+  LOG(INFO) << "The NUMA node of the data root " << dataRoot << " is " << node;
+  dataRootNodes_.wlock()->emplace(std::move(dataRoot), node);
+  return node;
+}
+
+}  // namespace storage
+}  // namespace nebula
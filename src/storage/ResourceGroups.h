@@ -0,0 +1,136 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_RESOURCEGROUPS_H_
+#define STORAGE_RESOURCEGROUPS_H_
+
+#include <folly/Executor.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+#include "common/base/Base.h"
+#include "common/stats/StatsManager.h"
+#include "interface/gen-cpp2/storage_types.h"
+#include "storage/CommonUtils.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief A named pool of threads running the reads, so that the reads of different groups don't
+ * queue behind each other. At most maxInflight reads are running or queued in the group, the
+ * others are failed at once, 0 means no limit.
+ *
+ * With --numa_aware, the threads are split into one pool per NUMA node, bound to its cpus.
+ */
+class ResourceGroup final {
+ public:
+  ResourceGroup(std::string name,
+                std::vector<std::shared_ptr<folly::Executor>> pools,
+                size_t maxInflight);
+
+  const std::string& name() const {
+    return name_;
+  }
+
+  // The pool of the NUMA node, the pools are taken in turn if the node is unknown, i.e. -1
+  folly::Executor* executor(int node = -1) {
+    if (pools_.size() == 1) {
+      return pools_.front().get();
+    }
+    if (node < 0 || static_cast<size_t>(node) >= pools_.size()) {
+      node = next_.fetch_add(1, std::memory_order_relaxed) % pools_.size();
+    }
+    return pools_[node].get();
+  }
+
+  // Take a slot of the group for a read, return false if the group is full
+  bool admit();
+
+  // Give back the slot when the read is finished
+  void release();
+
+  size_t inflight() const {
+    return inflight_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::string name_;
+  std::vector<std::shared_ptr<folly::Executor>> pools_;
+  std::atomic<size_t> next_{0};
+  size_t maxInflight_;
+  std::atomic<size_t> inflight_{0};
+  std::optional<stats::CounterId> numRequests_;
+  std::optional<stats::CounterId> numRejected_;
+};
+
+/**
+ * @brief The resource groups given by --storage_resource_groups, and the default group of the
+ * reader handlers. A read is run by the group named in its request, or the group of its space by
+ * --space_resource_groups, or the default group.
+ */
+class ResourceGroups final {
+ public:
+  static constexpr char kDefaultGroup[] = "default";
+
+  ResourceGroups(std::vector<std::shared_ptr<folly::Executor>> defaultPools, StorageEnv* env);
+
+  /**
+   * @brief The pools of a group of the threads, one per NUMA node with --numa_aware, or else only
+   * one. The threads are named by the prefix.
+   */
+  static std::vector<std::shared_ptr<folly::Executor>> makePools(const std::string& prefix,
+                                                                 int32_t threads);
+
+  // The pool of the reader handlers type, of which the threads are bound to the cpus if given, and
+  // to the memory arena of the reads if it has one
+  static std::shared_ptr<folly::Executor> makePool(const std::string& prefix,
+                                                   int32_t threads,
+                                                   const std::vector<int>& cpus = {});
+
+  template <typename REQ>
+  ResourceGroup* pick(const REQ& req) {
+    const std::string* name = nullptr;
+    if (req.common_ref().has_value() && req.get_common()->resource_group_ref().has_value()) {
+      name = &*req.get_common()->resource_group_ref();
+    }
+    return pick(req.get_space_id(), name);
+  }
+
+  // The group of the name if it's given and found, otherwise the group of the space
+  ResourceGroup* pick(GraphSpaceID spaceId, const std::string* name);
+
+  ResourceGroup* group(const std::string& name) const;
+
+  ResourceGroup* defaultGroup() const {
+    return defaultGroup_;
+  }
+
+  // The NUMA node of the disk of the first part of the request, -1 if it's unknown
+  template <typename REQ>
+  int numaNode(const REQ& req) {
+    if (!numaAware_ || req.get_parts().empty()) {
+      return -1;
+    }
+    return numaNode(req.get_space_id(), partIdOf(*req.get_parts().begin()));
+  }
+
+  int numaNode(GraphSpaceID spaceId, PartitionID partId);
+
+ private:
+  StorageEnv* env_{nullptr};
+  folly::F14FastMap<std::string, std::unique_ptr<ResourceGroup>> groups_;
+  // The space name to the group
+  folly::F14FastMap<std::string, ResourceGroup*> spaceGroups_;
+  ResourceGroup* defaultGroup_{nullptr};
+  bool numaAware_{false};
+  // The NUMA nodes of the data roots of the engines
+  folly::Synchronized<folly::F14FastMap<std::string, int>> dataRootNodes_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // STORAGE_RESOURCEGROUPS_H_
@@ -28,6 +28,11 @@ DEFINE_uint32(rebuild_index_part_rate_limit,
 
 DEFINE_uint32(rebuild_index_batch_size, 1024 * 128, "batch size for rebuild index, in bytes");
 
+DEFINE_uint32(rebuild_index_part_concurrency,
+              1,
+              "The number of threads to rebuild the index of a part, each of which scans a range "
+              "of the part, the rate limit of the part is shared by them");
+
 DEFINE_int32(reader_handlers, 32, "Total reader handlers");
 
 DEFINE_uint64(default_mvcc_ver,
@@ -46,3 +51,148 @@ DEFINE_bool(query_concurrently,
             false,
             "whether to run query of each part concurrently, only lookup and "
             "go are supported");
+
+DEFINE_uint32(lookup_sub_ranges_per_part,
+              1,
+              "The max number of sub ranges which the index range of a part is split into, so "
+              "that a part is scanned concurrently by lookup, only used if query_concurrently "
+              "is true");
+
+DEFINE_uint32(max_lookup_concurrency,
+              0,
+              "The max number of threads used by one lookup request, 0 means one thread for "
+              "each part or sub range");
+
+DEFINE_uint32(index_log_apply_interval_ms,
+              100,
+              "The interval to apply the operation logs of the indexes maintained asynchronously "
+              "to the indexes, 0 means the indexes are all maintained synchronously");
+
+DEFINE_uint32(index_log_apply_batch_size,
+              4096,
+              "The max number of the operations of a part applied in one write");
+
+DEFINE_uint32(lookup_index_barrier_ms,
+              0,
+              "The max time a lookup on an index maintained asynchronously waits for the "
+              "operations logged before it to be applied, 0 means the lookup never waits and "
+              "might miss the latest writes");
+
+DEFINE_uint32(get_prop_batch_read_threshold,
+              2,
+              "Read the tags of the vertices of a part in one batched multiGet when fetching the "
+              "props or the neighbors of at least so many vertices, 0 means always reading them "
+              "one by one");
+
+DEFINE_bool(read_tags_concurrently,
+            true,
+            "Whether the tags of the vertices read in a batch are read concurrently by the reader "
+            "handlers, one multiGet for each tag, only used if the batch read is enabled by "
+            "get_prop_batch_read_threshold");
+
+DEFINE_int32(row_format_version,
+             2,
+             "The format version to encode the props of tags and edges, 2 or 3. The rows of "
+             "version 3 are more compact, and the older rows are re-encoded during compaction. "
+             "Only enable it when all the storaged could read version 3");
+
+DEFINE_bool(enable_vertex_cache, false, "whether to cache the tag properties of vertex");
+
+DEFINE_int64(vertex_cache_capacity_mb, 64, "memory limit of vertex cache of each space in MB");
+
+DEFINE_uint32(vertex_cache_buckets_power,
+              4,
+              "there are 2^vertex_cache_buckets_power buckets of vertex and adjacency cache "
+              "for each space");
+
+DEFINE_bool(enable_adjacency_cache, false, "whether to cache the edges of supernodes");
+
+DEFINE_int64(adjacency_cache_capacity_mb,
+             256,
+             "memory limit of adjacency cache of each space in MB");
+
+DEFINE_uint32(adjacency_cache_min_degree,
+              1000,
+              "only cache the edges of a vertex of an edge type when there are at least so many");
+
+DEFINE_uint32(adjacency_cache_hot_min_degree,
+              100,
+              "cache the edges of a hot vertex of an edge type when there are at least so many, "
+              "see hot_key_min_requests");
+
+DEFINE_bool(enable_hot_keys, true, "whether to track the hot vertices and parts of requests");
+
+DEFINE_uint32(hot_keys_capacity,
+              256,
+              "the number of keys counted by each shard of the hot keys of a kind of request");
+
+DEFINE_uint32(hot_keys_sample_interval,
+              16,
+              "only one of so many vertices of requests is counted for the hot keys");
+
+DEFINE_uint32(hot_keys_decay_secs, 60, "the counts of hot keys are halved every so many seconds");
+
+DEFINE_uint32(hot_key_min_requests,
+              1000,
+              "a vertex is hot when it is read by at least so many recent requests of get "
+              "neighbors");
+
+DEFINE_bool(enable_degree_counters,
+            false,
+            "whether to keep the number of edges of each vertex by edge type, which makes "
+            "inserting and deleting edges read the edges first. Only the edges written after "
+            "enabling it on all storaged are counted");
+
+DEFINE_uint32(update_lock_wait_ms,
+              0,
+              "The max milliseconds an update waits for the vertex or edge being updated by "
+              "others, instead of failing at once with a data conflict error. 0 means no wait");
+
+DEFINE_bool(update_counter_merge,
+            false,
+            "Whether the updates only adding constants to numeric props, e.g. SET x = x + 1, are "
+            "written as merge operands without the read-modify-write");
+
+DEFINE_bool(scan_edge_by_index,
+            true,
+            "Whether a scan of one edge type reads the edges by the keys of an index without "
+            "fields of the type, instead of scanning all the edges of the part");
+
+DEFINE_double(compact_tombstone_ratio,
+              0.3,
+              "The ratio of the deletions to all the entries of an sst file, from which the file "
+              "is compacted by a compact job with the auto option");
+
+DEFINE_uint32(rocksdb_perf_context_sample_interval,
+              100,
+              "The reads of rocksdb of one of every so many requests of each processor are "
+              "profiled by the perf context, into the rocksdb_read_* histograms labelled by the "
+              "processor. 0 means no sampling");
+
+DEFINE_string(storage_resource_groups,
+              "",
+              "The resource groups of the reads, separated by comma, each is name:threads or "
+              "name:threads:max_inflight, e.g. oltp:16,batch:4:64. A group runs the reads on its "
+              "own threads, and fails the reads beyond max_inflight at once. The reads not in "
+              "any group are run by the reader handlers");
+
+DEFINE_string(space_resource_groups,
+              "",
+              "The resource groups of the spaces, separated by comma, each is space_name:group. "
+              "The group in the request sent by graphd takes precedence");
+
+DEFINE_bool(numa_aware,
+            false,
+            "Whether the threads of each resource group are split into the pools of the NUMA "
+            "nodes and bound to their cpus, and a read is run by the pool of the node of the disk "
+            "of its parts");
+
+DEFINE_int32(killed_plans_retention_secs,
+             600,
+             "How long a plan killed by graphd is remembered, its requests arriving in the time "
+             "are given up. The plans killed are synced by meta as well");
+
+DEFINE_int32(export_snapshot_ttl_secs,
+             600,
+             "The snapshot of a part kept for an export is released once the part is exported, or "
+             "if the next page of the part is not requested in the time");
@@ -22,16 +22,80 @@ DECLARE_uint32(rebuild_index_part_rate_limit);
 
 DECLARE_uint32(rebuild_index_batch_size);
 
+DECLARE_uint32(rebuild_index_part_concurrency);
+
 DECLARE_int32(reader_handlers);
 
 DECLARE_uint64(default_mvcc_ver);
 
 DECLARE_string(reader_handlers_type);
 
+DECLARE_string(storage_resource_groups);
+
+DECLARE_string(space_resource_groups);
+
+DECLARE_bool(numa_aware);
+
 DECLARE_bool(trace_toss);
 
 DECLARE_int32(max_edge_returned_per_vertex);
 
 DECLARE_bool(query_concurrently);
 
+DECLARE_uint32(lookup_sub_ranges_per_part);
+
+DECLARE_uint32(max_lookup_concurrency);
+
+DECLARE_uint32(index_log_apply_interval_ms);
+
+DECLARE_uint32(index_log_apply_batch_size);
+
+DECLARE_uint32(lookup_index_barrier_ms);
+
+DECLARE_uint32(get_prop_batch_read_threshold);
+
+DECLARE_bool(read_tags_concurrently);
+
+DECLARE_int32(row_format_version);
+
+DECLARE_bool(enable_vertex_cache);
+
+DECLARE_int64(vertex_cache_capacity_mb);
+
+DECLARE_uint32(vertex_cache_buckets_power);
+
+DECLARE_bool(enable_adjacency_cache);
+
+DECLARE_int64(adjacency_cache_capacity_mb);
+
+DECLARE_uint32(adjacency_cache_min_degree);
+
+DECLARE_uint32(adjacency_cache_hot_min_degree);
+
+DECLARE_bool(enable_hot_keys);
+
+DECLARE_uint32(hot_keys_capacity);
+
+DECLARE_uint32(hot_keys_sample_interval);
+
+DECLARE_uint32(hot_keys_decay_secs);
+
+DECLARE_uint32(hot_key_min_requests);
+
+DECLARE_bool(enable_degree_counters);
+
+DECLARE_uint32(update_lock_wait_ms);
+
+DECLARE_bool(update_counter_merge);
+
+DECLARE_bool(scan_edge_by_index);
+
+DECLARE_double(compact_tombstone_ratio);
+
+DECLARE_uint32(rocksdb_perf_context_sample_interval);
+
+DECLARE_int32(killed_plans_retention_secs);
+
+DECLARE_int32(export_snapshot_ttl_secs);
+
 #endif  // STORAGE_STORAGEFLAGS_H_
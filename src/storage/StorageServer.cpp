@@ -16,6 +16,7 @@
 #include "common/network/NetworkUtils.h"
 #include "common/ssl/SSLConfig.h"
 #include "common/thread/GenericThreadPool.h"
+#include "common/thread/NumaTopology.h"
 #include "common/time/TimezoneInfo.h"
 #include "common/utils/Utils.h"
 #include "kvstore/PartManager.h"
@@ -25,10 +26,13 @@
 #include "storage/GraphStorageLocalServer.h"
 #include "storage/GraphStorageServiceHandler.h"
 #include "storage/InternalStorageServiceHandler.h"
+#include "storage/MergeOperator.h"
 #include "storage/StorageAdminServiceHandler.h"
 #include "storage/StorageFlags.h"
 #include "storage/http/StorageHttpAdminHandler.h"
+#include "storage/http/StorageHttpHotKeysHandler.h"
 #include "storage/http/StorageHttpPropertyHandler.h"
+#include "storage/http/StorageHttpRaftHandler.h"
 #include "storage/http/StorageHttpStatsHandler.h"
 #include "storage/transaction/TransactionManager.h"
 #include "version/Version.h"
@@ -74,6 +78,8 @@ std::unique_ptr<kvstore::KVStore> StorageServer::getStoreInstance() {
   if (!FLAGS_storage_kv_mode) {
     options.cffBuilder_ =
         std::make_unique<StorageCompactionFilterFactoryBuilder>(schemaMan_.get(), indexMan_.get());
+    // Always set, since the operands written when update_counter_merge was on must be readable
+    options.mergeOp_ = std::make_shared<NebulaOperator>(schemaMan_.get());
   }
   options.schemaMan_ = schemaMan_.get();
   if (FLAGS_store_type == "nebula") {
@@ -110,6 +116,12 @@ bool StorageServer::initWebService() {
   router.get("/rocksdb_property").handler([this](web::PathParams&&) {
     return new storage::StorageHttpPropertyHandler(schemaMan_.get(), kvstore_.get());
   });
+  router.get("/hot_keys").handler([this](web::PathParams&&) {
+    return new storage::StorageHttpHotKeysHandler(schemaMan_.get(), hotKeys_.get());
+  });
+  router.get("/raft").handler([this](web::PathParams&&) {
+    return new storage::StorageHttpRaftHandler(schemaMan_.get(), kvstore_.get());
+  });
 
 #ifndef BUILD_STANDALONE
   auto status = webSvc_->start();
@@ -144,8 +156,42 @@ int32_t StorageServer::getAdminStoreSeqId() {
   return curSeqId;
 }
 
+void StorageServer::registerCacheEviction(const std::string& name, VertexCache* cache) {
+  auto evictPart = [cache](const kvstore::Part::CallbackOptions& opt) {
+    cache->evictPart(opt.spaceId, opt.partId);
+  };
+  std::vector<std::pair<GraphSpaceID, PartitionID>> existParts;
+  static_cast<kvstore::NebulaStore*>(kvstore_.get())
+      ->registerOnNewPartAdded(
+          name,
+          [evictPart](std::shared_ptr<kvstore::Part>& part) {
+            part->registerOnLeaderReady(evictPart);
+            part->registerOnLeaderLost(evictPart);
+          },
+          existParts);
+}
+
+void StorageServer::registerLeaderReport() {
+  auto report = [metaClient = metaClient_.get()](const kvstore::Part::CallbackOptions&) {
+    metaClient->reportLeadersSoon();
+  };
+  std::vector<std::pair<GraphSpaceID, PartitionID>> existParts;
+  static_cast<kvstore::NebulaStore*>(kvstore_.get())
+      ->registerOnNewPartAdded(
+          "LeaderReport",
+          [report](std::shared_ptr<kvstore::Part>& part) {
+            part->registerOnLeaderReady(report);
+            part->registerOnLeaderLost(report);
+          },
+          existParts);
+}
+
 bool StorageServer::start() {
-  ioThreadPool_ = std::make_shared<folly::IOThreadPoolExecutor>(FLAGS_num_io_threads);
+  // The name is the default one of the IO thread pool
+  auto ioThreadFactory = std::make_shared<thread::BoundThreadFactory>(
+      "IOThreadPool", std::vector<int>(), thread::MemoryArenas::kRpc);
+  ioThreadPool_ =
+      std::make_shared<folly::IOThreadPoolExecutor>(FLAGS_num_io_threads, ioThreadFactory);
 #ifndef BUILD_STANDALONE
   const int32_t numWorkerThreads = FLAGS_num_worker_threads;
 #else
@@ -156,6 +202,11 @@ bool StorageServer::start() {
   workers_->setNamePrefix("executor");
   workers_->start();
 
+  // The hot keys are created before the meta client, which reports the loads of the parts
+  if (FLAGS_enable_hot_keys) {
+    hotKeys_ = std::make_unique<HotKeys>();
+  }
+
   // Meta client
   meta::MetaClientOptions options;
   options.localHost_ = localHost_;
@@ -169,6 +220,11 @@ bool StorageServer::start() {
   options.gitInfoSHA_ = gitInfoSha();
   options.rootPath_ = boost::filesystem::current_path().string();
   options.dataPaths_ = dataPaths_;
+  if (hotKeys_ != nullptr && listenerPath_.empty()) {
+    options.partLoadsFetcher_ = [hotKeys = hotKeys_.get()](meta::PartLoadsMap& loads) {
+      hotKeys->partLoads(loads);
+    };
+  }
 
   metaClient_ = std::make_unique<meta::MetaClient>(ioThreadPool_, metaAddrs_, options);
 
@@ -255,10 +311,33 @@ bool StorageServer::start() {
   }
   env_->txnMan_ = txnMan_.get();
 
+  if (FLAGS_index_log_apply_interval_ms > 0) {
+    indexLogApplier_ = std::make_unique<IndexLogApplier>(env_.get());
+    if (!indexLogApplier_->start()) {
+      LOG(ERROR) << "Start index log applier failed!";
+      return false;
+    }
+    env_->indexLogApplier_ = indexLogApplier_.get();
+  }
+
   env_->verticesML_ = std::make_unique<VerticesMemLock>();
   env_->edgesML_ = std::make_unique<EdgesMemLock>();
   env_->adminStore_ = getAdminStoreInstance();
   env_->adminSeqId_ = getAdminStoreSeqId();
+  if (FLAGS_enable_vertex_cache) {
+    env_->vertexCache_ = std::make_unique<VertexCache>(FLAGS_vertex_cache_capacity_mb * 1024 * 1024,
+                                                       FLAGS_vertex_cache_buckets_power);
+    registerCacheEviction("VertexCache", env_->vertexCache_.get());
+  }
+  if (FLAGS_enable_adjacency_cache) {
+    env_->adjacencyCache_ = std::make_unique<VertexCache>(
+        FLAGS_adjacency_cache_capacity_mb * 1024 * 1024, FLAGS_vertex_cache_buckets_power);
+    registerCacheEviction("AdjacencyCache", env_->adjacencyCache_.get());
+  }
+  env_->hotKeys_ = hotKeys_.get();
+  env_->killedPlans_ = std::make_unique<KilledPlans>();
+  // Let graphd know the new leaders before its requests to the old ones fail
+  registerLeaderReport();
   taskMgr_ = AdminTaskManager::instance(env_.get());
   if (!taskMgr_->init()) {
     LOG(ERROR) << "Init task manager failed!";
@@ -331,6 +410,9 @@ void StorageServer::stop() {
     txnMan_->stop();
     txnMan_->join();
   }
+  if (indexLogApplier_) {
+    indexLogApplier_->stop();
+  }
   if (taskMgr_) {
     taskMgr_->shutdown();
   }
@@ -18,6 +18,7 @@
 #include "storage/CommonUtils.h"
 #include "storage/GraphStorageLocalServer.h"
 #include "storage/admin/AdminTaskManager.h"
+#include "storage/index/IndexLogApplier.h"
 #include "storage/transaction/TransactionManager.h"
 #include "webservice/WebService.h"
 
@@ -64,6 +65,18 @@ class StorageServer final {
    */
   int32_t getAdminStoreSeqId();
 
+  /**
+   * @brief Evict the cached vertices of a part whenever its leadership changes, since the
+   * writes applied as a follower don't evict the cache.
+   */
+  void registerCacheEviction(const std::string& name, VertexCache* cache);
+
+  /**
+   * @brief Report the leaders to metad by an extra heartbeat once the leadership of a part
+   * changes, so graphd could learn the new leaders from metad soon.
+   */
+  void registerLeaderReport();
+
   bool initWebService();
 
   /**
@@ -118,6 +131,9 @@ class StorageServer final {
 
   AdminTaskManager* taskMgr_{nullptr};
   std::unique_ptr<TransactionManager> txnMan_{nullptr};
+  std::unique_ptr<IndexLogApplier> indexLogApplier_{nullptr};
+  // Only created when FLAGS_enable_hot_keys is on
+  std::unique_ptr<HotKeys> hotKeys_{nullptr};
   // used for communicate between one storaged to another
   std::unique_ptr<InternalStorageClient> interClient_;
 
@@ -5,6 +5,7 @@
 
 #include "storage/admin/AdminTask.h"
 
+#include "storage/admin/AlgoTask.h"
 #include "storage/admin/CompactTask.h"
 #include "storage/admin/DownloadTask.h"
 #include "storage/admin/FlushTask.h"
@@ -45,6 +46,9 @@ std::shared_ptr<AdminTask> AdminTaskFactory::createAdminTask(StorageEnv* env, Ta
     case meta::cpp2::JobType::INGEST:
       ret = std::make_shared<IngestTask>(env, std::move(ctx));
       break;
+    case meta::cpp2::JobType::ALGO:
+      ret = std::make_shared<AlgoTask>(env, std::move(ctx));
+      break;
     default:
       break;
   }
@@ -0,0 +1,54 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/admin/AlgoMailbox.h"
+
+namespace nebula {
+namespace storage {
+
+void AlgoMailbox::deliver(const cpp2::AlgoMessagesRequest& req) {
+  std::lock_guard<std::mutex> guard(lock_);
+  auto& inbox = inboxes_[req.get_job_id()][req.get_superstep()];
+  for (const auto& msg : req.get_messages()) {
+    inbox.messages[msg.first].emplace_back(msg.second);
+  }
+  if (req.get_last()) {
+    inbox.sent += req.get_sent();
+    ++inbox.finished;
+    cond_.notify_all();
+  }
+}
+
+bool AlgoMailbox::receive(JobID jobId,
+                          int32_t superstep,
+                          size_t numSenders,
+                          std::chrono::milliseconds timeout,
+                          Inbox* inbox) {
+  std::unique_lock<std::mutex> guard(lock_);
+  auto ready = cond_.wait_for(guard, timeout, [&]() {
+    auto job = inboxes_.find(jobId);
+    if (job == inboxes_.end()) {
+      return false;
+    }
+    auto step = job->second.find(superstep);
+    return step != job->second.end() && step->second.finished >= numSenders;
+  });
+  if (!ready) {
+    return false;
+  }
+  auto& steps = inboxes_[jobId];
+  auto step = steps.find(superstep);
+  *inbox = std::move(step->second);
+  steps.erase(step);
+  return true;
+}
+
+void AlgoMailbox::drop(JobID jobId) {
+  std::lock_guard<std::mutex> guard(lock_);
+  inboxes_.erase(jobId);
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,67 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_ADMIN_ALGOMAILBOX_H_
+#define STORAGE_ADMIN_ALGOMAILBOX_H_
+
+#include "common/base/Base.h"
+#include "interface/gen-cpp2/storage_types.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief Messages received by the graph algorithm jobs running on this host, kept by job and
+ * superstep. The messages could arrive before the local task reaches the superstep, or even
+ * before it starts, so they are kept until the task takes them.
+ */
+class AlgoMailbox final {
+ public:
+  struct Inbox {
+    // vertex id => the messages from each sender
+    std::unordered_map<std::string, std::vector<Value>> messages;
+    // The number of the messages sent by all the senders
+    int64_t sent{0};
+    // The number of the senders which have sent their last batches
+    size_t finished{0};
+  };
+
+  static AlgoMailbox* instance() {
+    static AlgoMailbox sAlgoMailbox;
+    return &sAlgoMailbox;
+  }
+
+  void deliver(const cpp2::AlgoMessagesRequest& req);
+
+  /**
+   * @brief Wait until the last batches of the superstep from all the senders arrive
+   *
+   * @param jobId
+   * @param superstep
+   * @param numSenders
+   * @param timeout
+   * @param inbox Messages received in the superstep
+   * @return Whether all the senders finished the superstep in time
+   */
+  bool receive(JobID jobId,
+               int32_t superstep,
+               size_t numSenders,
+               std::chrono::milliseconds timeout,
+               Inbox* inbox);
+
+  // Drop all the messages of the job
+  void drop(JobID jobId);
+
+ private:
+  AlgoMailbox() = default;
+
+  std::mutex lock_;
+  std::condition_variable cond_;
+  std::unordered_map<JobID, std::map<int32_t, Inbox>> inboxes_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_ADMIN_ALGOMAILBOX_H_
@@ -0,0 +1,602 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/admin/AlgoTask.h"
+
+#include <folly/synchronization/Baton.h>
+
+#include "clients/storage/InternalStorageClient.h"
+#include "codec/RowReaderWrapper.h"
+#include "codec/RowWriterV2.h"
+#include "codec/RowWriterV3.h"
+#include "common/base/MurmurHash2.h"
+#include "common/utils/NebulaKeyUtils.h"
+#include "storage/StorageFlags.h"
+#include "storage/exec/QueryUtils.h"
+
+DEFINE_uint32(algo_message_batch_size,
+              10000,
+              "Max number of the messages sent to a host in one batch by the graph algorithm jobs");
+DEFINE_uint32(algo_superstep_timeout_secs,
+              600,
+              "Max seconds to wait for the other hosts to finish a superstep of the graph "
+              "algorithm jobs");
+
+namespace nebula {
+namespace storage {
+
+bool AlgoTask::check() {
+  return env_->kvstore_ != nullptr && env_->schemaMan_ != nullptr && env_->indexMan_ != nullptr &&
+         env_->interClient_ != nullptr;
+}
+
+ErrorOr<nebula::cpp2::ErrorCode, std::vector<AdminSubTask>> AlgoTask::genSubTasks() {
+  auto ret = prepare();
+  if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return ret;
+  }
+  std::vector<AdminSubTask> tasks;
+  tasks.emplace_back([this]() {
+    auto code = run();
+    AlgoMailbox::instance()->drop(ctx_.jobId_);
+    return code;
+  });
+  return tasks;
+}
+
+nebula::cpp2::ErrorCode AlgoTask::prepare() {
+  spaceId_ = *ctx_.parameters_.space_id_ref();
+  auto vIdLen = env_->schemaMan_->getSpaceVidLen(spaceId_);
+  auto vIdType = env_->schemaMan_->getSpaceVidType(spaceId_);
+  auto numParts = env_->schemaMan_->getPartsNum(spaceId_);
+  if (!vIdLen.ok() || !vIdType.ok() || !numParts.ok()) {
+    return nebula::cpp2::ErrorCode::E_SPACE_NOT_FOUND;
+  }
+  vIdLen_ = vIdLen.value();
+  isIntId_ = vIdType.value() == nebula::cpp2::PropertyType::INT64;
+  numParts_ = numParts.value();
+  if (ctx_.parameters_.parts_ref().has_value()) {
+    parts_.insert(ctx_.parameters_.parts_ref()->begin(), ctx_.parameters_.parts_ref()->end());
+  }
+
+  // algorithm, tag, property, options and the parts of the hosts
+  auto paras = ctx_.parameters_.task_specific_paras_ref().value_or(std::vector<std::string>());
+  if (paras.size() != 5) {
+    return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+  }
+  auto algo = paras[0];
+  folly::toLowerAscii(algo);
+  if (algo == "pagerank") {
+    algo_ = Algo::kPageRank;
+    maxIterations_ = 10;
+  } else if (algo == "wcc") {
+    algo_ = Algo::kWcc;
+    maxIterations_ = 1000;
+  } else if (algo == "lpa") {
+    algo_ = Algo::kLpa;
+    maxIterations_ = 10;
+  } else if (algo == "kcore") {
+    algo_ = Algo::kKCore;
+    maxIterations_ = 1000;
+  } else {
+    return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+  }
+
+  auto tagId = env_->schemaMan_->toTagID(spaceId_, paras[1]);
+  if (!tagId.ok()) {
+    return nebula::cpp2::ErrorCode::E_TAG_NOT_FOUND;
+  }
+  tagId_ = tagId.value();
+  auto schema = env_->schemaMan_->getTagSchema(spaceId_, tagId_);
+  if (schema == nullptr || schema->getFieldIndex(paras[2]) < 0) {
+    return nebula::cpp2::ErrorCode::E_TAG_PROP_NOT_FOUND;
+  }
+  prop_ = paras[2];
+  // The results are written without maintaining the indexes
+  auto indexes = env_->indexMan_->getTagIndexes(spaceId_);
+  if (!indexes.ok()) {
+    return nebula::cpp2::ErrorCode::E_SPACE_NOT_FOUND;
+  }
+  for (const auto& index : indexes.value()) {
+    if (index->get_schema_id().get_tag_id() == tagId_) {
+      LOG(INFO) << "The result tag of the graph algorithm job should not be indexed";
+      return nebula::cpp2::ErrorCode::E_UNSUPPORTED;
+    }
+  }
+
+  auto ret = parseOptions(paras[3]);
+  if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return ret;
+  }
+  return parseAssignment(paras[4]);
+}
+
+nebula::cpp2::ErrorCode AlgoTask::parseAssignment(const std::string& assignment) {
+  std::vector<folly::StringPiece> items;
+  folly::split(';', assignment, items, true);
+  for (auto item : items) {
+    folly::StringPiece addr, parts;
+    if (!folly::split('=', item, addr, parts)) {
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    auto pos = addr.rfind(':');
+    if (pos == folly::StringPiece::npos) {
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    auto port = folly::tryTo<Port>(addr.subpiece(pos + 1));
+    if (!port.hasValue()) {
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    HostAddr host(addr.subpiece(0, pos).str(), port.value());
+    std::vector<PartitionID> ids;
+    try {
+      folly::split(',', parts, ids, true);
+    } catch (const std::exception& e) {
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    for (auto partId : ids) {
+      hostOfPart_[partId] = host;
+    }
+    hosts_.emplace(std::move(host));
+  }
+  // The messages to each part are sent to the host running it
+  for (PartitionID partId = 1; partId <= numParts_; ++partId) {
+    if (hostOfPart_.count(partId) == 0) {
+      LOG(INFO) << "Part " << partId << " is not assigned to any host";
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode AlgoTask::parseOptions(const std::string& options) {
+  std::vector<folly::StringPiece> items;
+  folly::split(',', options, items, true);
+  for (auto item : items) {
+    folly::StringPiece key, val;
+    if (!folly::split('=', item, key, val)) {
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    key = folly::trimWhitespace(key);
+    val = folly::trimWhitespace(val);
+    if (key == "iterations") {
+      auto iterations = folly::tryTo<int32_t>(val);
+      if (!iterations.hasValue() || iterations.value() <= 0) {
+        return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+      }
+      maxIterations_ = iterations.value();
+    } else if (key == "damping") {
+      auto damping = folly::tryTo<double>(val);
+      if (!damping.hasValue() || damping.value() <= 0.0 || damping.value() >= 1.0) {
+        return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+      }
+      damping_ = damping.value();
+    } else if (key == "k") {
+      auto k = folly::tryTo<int64_t>(val);
+      if (!k.hasValue() || k.value() <= 0) {
+        return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+      }
+      k_ = k.value();
+    } else if (key == "edges") {
+      // Edge names separated by '|'
+      std::vector<folly::StringPiece> names;
+      folly::split('|', val, names, true);
+      for (auto name : names) {
+        auto edgeType = env_->schemaMan_->toEdgeType(spaceId_, folly::trimWhitespace(name));
+        if (!edgeType.ok()) {
+          return nebula::cpp2::ErrorCode::E_EDGE_NOT_FOUND;
+        }
+        edgeTypes_.emplace_back(edgeType.value());
+      }
+    } else {
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+  }
+  if (edgeTypes_.empty()) {
+    auto edges = env_->schemaMan_->getAllVerEdgeSchema(spaceId_);
+    if (!edges.ok()) {
+      return nebula::cpp2::ErrorCode::E_SPACE_NOT_FOUND;
+    }
+    for (const auto& edge : edges.value()) {
+      edgeTypes_.emplace_back(edge.first);
+    }
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode AlgoTask::run() {
+  auto ret = loadGraph();
+  if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return ret;
+  }
+  LOG(INFO) << "Graph algorithm job " << ctx_.jobId_ << " loaded " << vIds_.size()
+            << " vertices, running with " << hosts_.size() << " hosts";
+
+  auto timeout = std::chrono::seconds(FLAGS_algo_superstep_timeout_secs);
+  AlgoMailbox::Inbox inbox;
+  // All the hosts see the same number of messages sent in each superstep, so they stop together
+  for (int32_t superstep = 0; superstep <= maxIterations_; ++superstep) {
+    if (UNLIKELY(canceled_)) {
+      LOG(INFO) << "Graph algorithm task is canceled";
+      return nebula::cpp2::ErrorCode::E_USER_CANCEL;
+    }
+    Outbox outbox;
+    compute(superstep, std::move(inbox), &outbox);
+    ret = send(superstep, std::move(outbox));
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return ret;
+    }
+    inbox = AlgoMailbox::Inbox();
+    if (!AlgoMailbox::instance()->receive(ctx_.jobId_, superstep, hosts_.size(), timeout, &inbox)) {
+      LOG(INFO) << "Timeout to wait for the other hosts to finish superstep " << superstep;
+      return nebula::cpp2::ErrorCode::E_RPC_FAILURE;
+    }
+    if (inbox.sent == 0) {
+      break;
+    }
+  }
+  return writeResult();
+}
+
+nebula::cpp2::ErrorCode AlgoTask::loadGraph() {
+  bool undirected = algo_ != Algo::kPageRank;
+  std::unordered_set<EdgeType> edgeTypes(edgeTypes_.begin(), edgeTypes_.end());
+  for (auto partId : parts_) {
+    // The vertices without any edge
+    // The graph is loaded from the local replica, the part may have lost its leadership since meta
+    // assigned it
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto prefix = NebulaKeyUtils::vertexPrefix(partId);
+    auto ret = env_->kvstore_->prefix(spaceId_, partId, prefix, &iter, true);
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return ret;
+    }
+    for (; iter && iter->valid(); iter->next()) {
+      vertexIndex(NebulaKeyUtils::getVertexId(vIdLen_, iter->key()));
+    }
+    prefix = NebulaKeyUtils::edgePrefix(partId);
+    ret = env_->kvstore_->prefix(spaceId_, partId, prefix, &iter, true);
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return ret;
+    }
+    for (; iter && iter->valid(); iter->next()) {
+      if (UNLIKELY(canceled_)) {
+        return nebula::cpp2::ErrorCode::E_USER_CANCEL;
+      }
+      auto key = iter->key();
+      if (!NebulaKeyUtils::isEdge(vIdLen_, key)) {
+        continue;
+      }
+      auto edgeType = NebulaKeyUtils::getEdgeType(vIdLen_, key);
+      if (edgeTypes.count(std::abs(edgeType)) == 0 || (!undirected && edgeType < 0)) {
+        continue;
+      }
+      // Each edge is stored in the parts of both its ends, so the undirected neighbors are
+      // the destinations of both the out-edges and the in-edges
+      auto src = vertexIndex(NebulaKeyUtils::getSrcId(vIdLen_, key));
+      auto dst = vertexIndex(NebulaKeyUtils::getDstId(vIdLen_, key));
+      neighbors_[src].emplace_back(dst);
+    }
+  }
+  for (auto& neighbors : neighbors_) {
+    if (undirected) {
+      std::sort(neighbors.begin(), neighbors.end());
+      neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+    }
+    neighbors.shrink_to_fit();
+  }
+  values_.resize(vIds_.size());
+  alive_.resize(vIds_.size(), true);
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+uint32_t AlgoTask::vertexIndex(folly::StringPiece vId) {
+  auto it = vIdIndex_.find(vId.str());
+  if (it != vIdIndex_.end()) {
+    return it->second;
+  }
+  uint32_t index = vIds_.size();
+  vIds_.emplace_back(vId.str());
+  vIdIndex_.emplace(vId.str(), index);
+  local_.emplace_back(parts_.count(partOf(vIds_.back())) != 0);
+  neighbors_.emplace_back();
+  return index;
+}
+
+void AlgoTask::compute(int32_t superstep, AlgoMailbox::Inbox&& inbox, Outbox* outbox) {
+  std::vector<Value> received(vIds_.size());
+  for (auto& msgs : inbox.messages) {
+    auto it = vIdIndex_.find(msgs.first);
+    if (it == vIdIndex_.end() || !local_[it->second]) {
+      continue;
+    }
+    for (auto& msg : msgs.second) {
+      combine(received[it->second], std::move(msg));
+    }
+  }
+  inbox.messages.clear();
+
+  auto sendToNeighbors = [&](uint32_t v, const Value& msg) {
+    for (auto u : neighbors_[v]) {
+      combine((*outbox)[u], Value(msg));
+    }
+  };
+  bool last = superstep == maxIterations_;
+  for (uint32_t v = 0; v < vIds_.size(); ++v) {
+    if (!local_[v]) {
+      continue;
+    }
+    auto& msg = received[v];
+    switch (algo_) {
+      case Algo::kPageRank: {
+        double rank = 1.0 - damping_;
+        if (msg.isFloat()) {
+          rank += damping_ * msg.getFloat();
+        }
+        values_[v] = rank;
+        if (!last && !neighbors_[v].empty()) {
+          sendToNeighbors(v, Value(rank / neighbors_[v].size()));
+        }
+        break;
+      }
+      case Algo::kWcc: {
+        if (superstep == 0) {
+          values_[v] = userVid(vIds_[v]);
+        } else if (msg.empty() || !(msg < values_[v])) {
+          break;
+        } else {
+          values_[v] = std::move(msg);
+        }
+        if (!last) {
+          sendToNeighbors(v, values_[v]);
+        }
+        break;
+      }
+      case Algo::kLpa: {
+        if (superstep == 0) {
+          values_[v] = userVid(vIds_[v]);
+        } else if (msg.isList()) {
+          // The most frequent label of the neighbors, the smallest one on ties
+          std::unordered_map<Value, size_t> counts;
+          const Value* label = nullptr;
+          size_t max = 0;
+          for (const auto& l : msg.getList().values) {
+            auto count = ++counts[l];
+            if (count > max || (count == max && l < *label)) {
+              max = count;
+              label = &l;
+            }
+          }
+          values_[v] = *label;
+        }
+        if (!last) {
+          sendToNeighbors(v, Value(List({values_[v]})));
+        }
+        break;
+      }
+      case Algo::kKCore: {
+        if (superstep == 0) {
+          values_[v] = static_cast<int64_t>(neighbors_[v].size());
+        } else if (alive_[v] && msg.isInt()) {
+          values_[v] = values_[v].getInt() - msg.getInt();
+        }
+        // Peel the vertex off and decrease the degrees of its neighbors
+        if (alive_[v] && values_[v].getInt() < k_) {
+          alive_[v] = false;
+          sendToNeighbors(v, Value(1L));
+        }
+        break;
+      }
+    }
+  }
+}
+
+void AlgoTask::combine(Value& combined, Value&& msg) const {
+  if (combined.empty()) {
+    combined = std::move(msg);
+    return;
+  }
+  switch (algo_) {
+    case Algo::kPageRank:
+      combined = combined.getFloat() + msg.getFloat();
+      break;
+    case Algo::kWcc:
+      if (msg < combined) {
+        combined = std::move(msg);
+      }
+      break;
+    case Algo::kLpa: {
+      auto& labels = combined.mutableList().values;
+      auto& other = msg.mutableList().values;
+      labels.insert(labels.end(),
+                    std::make_move_iterator(other.begin()),
+                    std::make_move_iterator(other.end()));
+      break;
+    }
+    case Algo::kKCore:
+      combined = combined.getInt() + msg.getInt();
+      break;
+  }
+}
+
+nebula::cpp2::ErrorCode AlgoTask::send(int32_t superstep, Outbox&& outbox) {
+  auto newRequest = [&]() {
+    cpp2::AlgoMessagesRequest req;
+    req.space_id_ref() = spaceId_;
+    req.job_id_ref() = ctx_.jobId_;
+    req.superstep_ref() = superstep;
+    return req;
+  };
+  auto wait = [](std::vector<folly::Future<nebula::cpp2::ErrorCode>>&& futures) {
+    auto codes = folly::collectAll(futures).get();
+    for (auto& code : codes) {
+      if (code.hasException() || code.value() != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        return code.hasException() ? nebula::cpp2::ErrorCode::E_RPC_FAILURE : code.value();
+      }
+    }
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  };
+
+  int64_t sent = outbox.size();
+  std::unordered_map<HostAddr, cpp2::AlgoMessagesRequest> batches;
+  std::vector<folly::Future<nebula::cpp2::ErrorCode>> futures;
+  for (auto& msg : outbox) {
+    const auto& vId = vIds_[msg.first];
+    const auto& host = hostOfPart_[partOf(vId)];
+    auto it = batches.find(host);
+    if (it == batches.end()) {
+      it = batches.emplace(host, newRequest()).first;
+    }
+    it->second.messages_ref()->emplace(vId, std::move(msg.second));
+    if (it->second.get_messages().size() >= FLAGS_algo_message_batch_size) {
+      futures.emplace_back(env_->interClient_->algoMessages(host, it->second));
+      it->second = newRequest();
+    }
+  }
+  outbox.clear();
+  for (auto& batch : batches) {
+    if (!batch.second.get_messages().empty()) {
+      futures.emplace_back(env_->interClient_->algoMessages(batch.first, batch.second));
+    }
+  }
+  auto ret = wait(std::move(futures));
+  if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return ret;
+  }
+  futures.clear();
+
+  // All the messages have arrived, tell every host that this host finished the superstep
+  for (const auto& host : hosts_) {
+    auto req = newRequest();
+    req.last_ref() = true;
+    req.sent_ref() = sent;
+    futures.emplace_back(env_->interClient_->algoMessages(host, req));
+  }
+  return wait(std::move(futures));
+}
+
+nebula::cpp2::ErrorCode AlgoTask::writeResult() {
+  std::unordered_map<PartitionID, std::vector<kvstore::KV>> data;
+  auto flush = [this](PartitionID partId, std::vector<kvstore::KV>&& kvs) {
+    folly::Baton<true, std::atomic> baton;
+    auto result = nebula::cpp2::ErrorCode::SUCCEEDED;
+    env_->kvstore_->asyncMultiPut(
+        spaceId_, partId, std::move(kvs), [&result, &baton](nebula::cpp2::ErrorCode code) {
+          result = code;
+          baton.post();
+        });
+    baton.wait();
+    return result;
+  };
+  for (uint32_t v = 0; v < vIds_.size(); ++v) {
+    if (!local_[v]) {
+      continue;
+    }
+    auto value = algo_ == Algo::kKCore ? Value(static_cast<bool>(alive_[v])) : values_[v];
+    const auto& vId = vIds_[v];
+    auto partId = partOf(vId);
+    std::optional<std::string> row;
+    auto ret = updateRow(partId, vId, value, &row);
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return ret;
+    }
+    if (!row.has_value()) {
+      continue;
+    }
+    auto& kvs = data[partId];
+    kvs.emplace_back(NebulaKeyUtils::tagKey(vIdLen_, partId, vId, tagId_), std::move(row).value());
+    if (kvs.size() >= FLAGS_algo_message_batch_size) {
+      ret = flush(partId, std::move(kvs));
+      if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        return ret;
+      }
+      kvs.clear();
+    }
+  }
+  for (auto& kvs : data) {
+    if (!kvs.second.empty()) {
+      auto ret = flush(kvs.first, std::move(kvs.second));
+      if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        return ret;
+      }
+    }
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode AlgoTask::updateRow(PartitionID partId,
+                                            const std::string& vId,
+                                            const Value& result,
+                                            std::optional<std::string>* row) {
+  auto schema = env_->schemaMan_->getTagSchema(spaceId_, tagId_);
+  if (schema == nullptr) {
+    return nebula::cpp2::ErrorCode::E_TAG_NOT_FOUND;
+  }
+  std::string val;
+  auto key = NebulaKeyUtils::tagKey(vIdLen_, partId, vId, tagId_);
+  auto ret = env_->kvstore_->get(spaceId_, partId, key, &val);
+  if (ret == nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
+    // The vertex only seen as an end of the edges, or without the tag
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  } else if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return ret;
+  }
+  auto reader = RowReaderWrapper::getTagPropReader(env_->schemaMan_, spaceId_, tagId_, val);
+  if (reader == nullptr) {
+    return nebula::cpp2::ErrorCode::E_INVALID_DATA;
+  }
+
+  // The row is written in the latest schema, with the other properties kept
+  RowWriterV2 writer(schema.get());
+  for (size_t i = 0; i < schema->getNumFields(); ++i) {
+    std::string name = schema->getFieldName(i);
+    if (name == prop_) {
+      if (writer.setValue(name, result) != WriteResult::SUCCEEDED) {
+        LOG(INFO) << "Failed to write the result " << result << " to property " << prop_;
+        return nebula::cpp2::ErrorCode::E_DATA_TYPE_MISMATCH;
+      }
+      continue;
+    }
+    auto prop = QueryUtils::readValue(reader.get(), name, schema.get());
+    if (!prop.ok() || writer.setValue(name, std::move(prop).value()) != WriteResult::SUCCEEDED) {
+      return nebula::cpp2::ErrorCode::E_INVALID_DATA;
+    }
+  }
+  if (writer.finish() != WriteResult::SUCCEEDED) {
+    return nebula::cpp2::ErrorCode::E_INVALID_DATA;
+  }
+  auto encoded = std::move(writer).moveEncodedStr();
+  if (FLAGS_row_format_version == 3 &&
+      RowWriterV3::upgrade(schema.get(), encoded) != WriteResult::SUCCEEDED) {
+    return nebula::cpp2::ErrorCode::E_INVALID_DATA;
+  }
+  *row = std::move(encoded);
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+PartitionID AlgoTask::partOf(const std::string& vId) const {
+  uint64_t id = 0;
+  if (isIntId_) {
+    memcpy(static_cast<void*>(&id), vId.data(), 8);
+  } else {
+    MurmurHash2 hash;
+    id = hash(vId.data());
+  }
+  return id % numParts_ + 1;
+}
+
+Value AlgoTask::userVid(const std::string& vId) const {
+  if (isIntId_) {
+    int64_t id = 0;
+    memcpy(static_cast<void*>(&id), vId.data(), 8);
+    return id;
+  }
+  // The string vids are padded to the vid length in keys
+  auto end = vId.find('\0');
+  return end == std::string::npos ? vId : vId.substr(0, end);
+}
+
+}  // namespace storage
+}  // namespace nebula
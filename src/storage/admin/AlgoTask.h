@@ -0,0 +1,113 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_ADMIN_ALGOTASK_H_
+#define STORAGE_ADMIN_ALGOTASK_H_
+
+#include "common/base/Base.h"
+#include "storage/admin/AdminTask.h"
+#include "storage/admin/AlgoMailbox.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief Task to run an iterative graph algorithm over the parts led by this host.
+ *
+ * The parameters are the name of the algorithm (pagerank, wcc, lpa or kcore), the tag and the
+ * property to write the results back, the options in the form of "k1=v1,k2=v2", and the parts
+ * meta assigned to all the hosts running the job. The edges of the local parts are loaded into
+ * memory, then all the hosts compute in supersteps. The messages of each superstep to the vertices
+ * of other hosts are sent to the hosts running their parts, and a host moves to the next superstep
+ * once all the hosts finished sending. The job stops when no message is sent in a superstep.
+ *
+ * The result is written into the property of the existing tag rows, the other properties are kept
+ * and the vertices without the tag are skipped.
+ */
+class AlgoTask : public AdminTask {
+ public:
+  AlgoTask(StorageEnv* env, TaskContext&& ctx) : AdminTask(env, std::move(ctx)) {}
+
+  bool check() override;
+
+  /**
+   * @brief The whole algorithm runs in one sub task, since all the parts are computed in each
+   * superstep together.
+   *
+   * @return ErrorOr<nebula::cpp2::ErrorCode, std::vector<AdminSubTask>> Task vector or errorcode.
+   */
+  ErrorOr<nebula::cpp2::ErrorCode, std::vector<AdminSubTask>> genSubTasks() override;
+
+ private:
+  enum class Algo : uint8_t { kPageRank, kWcc, kLpa, kKCore };
+
+  // vertex index => the message combined for it
+  using Outbox = std::unordered_map<uint32_t, Value>;
+
+  nebula::cpp2::ErrorCode prepare();
+
+  nebula::cpp2::ErrorCode parseOptions(const std::string& options);
+
+  // Parse the parts assigned to the hosts, "host:port=part,part;host:port=part"
+  nebula::cpp2::ErrorCode parseAssignment(const std::string& assignment);
+
+  // Encode the tag row of the vertex with the result, nothing if the vertex has no tag row
+  nebula::cpp2::ErrorCode updateRow(PartitionID partId,
+                                    const std::string& vId,
+                                    const Value& result,
+                                    std::optional<std::string>* row);
+
+  nebula::cpp2::ErrorCode run();
+
+  nebula::cpp2::ErrorCode loadGraph();
+
+  // Update the local vertices by the messages received in the last superstep, and generate the
+  // messages of the superstep
+  void compute(int32_t superstep, AlgoMailbox::Inbox&& inbox, Outbox* outbox);
+
+  nebula::cpp2::ErrorCode send(int32_t superstep, Outbox&& outbox);
+
+  nebula::cpp2::ErrorCode writeResult();
+
+  void combine(Value& combined, Value&& msg) const;
+
+  uint32_t vertexIndex(folly::StringPiece vId);
+
+  PartitionID partOf(const std::string& vId) const;
+
+  // The vid returned to users of the raw one in keys
+  Value userVid(const std::string& vId) const;
+
+ private:
+  GraphSpaceID spaceId_;
+  size_t vIdLen_{0};
+  bool isIntId_{false};
+  int32_t numParts_{0};
+  std::unordered_set<PartitionID> parts_;
+  // The hosts running the parts of the space, as meta assigned
+  std::unordered_map<PartitionID, HostAddr> hostOfPart_;
+  std::unordered_set<HostAddr> hosts_;
+
+  Algo algo_{Algo::kPageRank};
+  TagID tagId_;
+  std::string prop_;
+  std::vector<EdgeType> edgeTypes_;
+  int32_t maxIterations_{0};
+  double damping_{0.85};
+  int64_t k_{1};
+
+  // All the vertices met, including the neighbors in other hosts
+  std::vector<std::string> vIds_;
+  std::unordered_map<std::string, uint32_t> vIdIndex_;
+  std::vector<bool> local_;
+  std::vector<std::vector<uint32_t>> neighbors_;
+  // The value of each local vertex: rank, component, label or degree
+  std::vector<Value> values_;
+  std::vector<bool> alive_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_ADMIN_ALGOTASK_H_
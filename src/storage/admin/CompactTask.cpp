@@ -6,19 +6,58 @@
 #include "storage/admin/CompactTask.h"
 
 #include "common/base/Logging.h"
+#include "storage/StorageFlags.h"
 
 namespace nebula {
 namespace storage {
 
+namespace {
+
+// The first and the last key of one type of a part
+std::pair<std::string, std::string> partRange(PartitionID part, NebulaKeyType type) {
+  PartitionID item = (part << kPartitionOffset) | static_cast<uint32_t>(type);
+  std::string start(reinterpret_cast<const char*>(&item), sizeof(PartitionID));
+  // The first byte is the key type, so the carry always stops before it
+  std::string end = start;
+  for (auto i = end.size(); i-- > 0;) {
+    if (static_cast<uint8_t>(end[i]) != 0xFF) {
+      end[i]++;
+      break;
+    }
+    end[i] = 0;
+  }
+  return {std::move(start), std::move(end)};
+}
+
+}  // namespace
+
 bool CompactTask::check() {
   return env_->kvstore_ != nullptr;
 }
 
+bool CompactTask::parseOptions() {
+  auto paras = ctx_.parameters_.task_specific_paras_ref();
+  if (!paras.has_value()) {
+    return true;
+  }
+  auto options = CompactOptions::parse(*paras);
+  if (!options.ok()) {
+    LOG(ERROR) << options.status();
+    return false;
+  }
+  options_ = std::move(options).value();
+  return true;
+}
+
 ErrorOr<nebula::cpp2::ErrorCode, std::vector<AdminSubTask>> CompactTask::genSubTasks() {
   std::vector<AdminSubTask> ret;
   if (!env_->kvstore_) {
     return ret;
   }
+  if (!parseOptions()) {
+    LOG(ERROR) << "Illegal options of the compact task " << ctx_.jobId_ << ":" << ctx_.taskId_;
+    return nebula::cpp2::ErrorCode::E_INVALID_TASK_PARA;
+  }
 
   auto* store = dynamic_cast<kvstore::NebulaStore*>(env_->kvstore_);
   auto errOrSpace = store->space(*ctx_.parameters_.space_id_ref());
@@ -35,8 +74,64 @@ ErrorOr<nebula::cpp2::ErrorCode, std::vector<AdminSubTask>> CompactTask::genSubT
   return ret;
 }
 
+std::vector<std::pair<std::string, std::string>> CompactTask::selectedRanges(
+    kvstore::KVEngine* engine) {
+  std::vector<NebulaKeyType> keyTypes = options_.keyTypes;
+  if (keyTypes.empty()) {
+    for (const auto& data : CompactOptions::dataKeyTypes()) {
+      keyTypes.insert(keyTypes.end(), data.second.begin(), data.second.end());
+    }
+  }
+  std::vector<std::pair<std::string, std::string>> ranges;
+  for (auto part : engine->allParts()) {
+    if (!options_.parts.empty() && options_.parts.count(part) == 0) {
+      continue;
+    }
+    for (auto type : keyTypes) {
+      ranges.emplace_back(partRange(part, type));
+    }
+  }
+  return ranges;
+}
+
 nebula::cpp2::ErrorCode CompactTask::subTask(kvstore::KVEngine* engine) {
-  return engine->compact();
+  if (!options_.ranged()) {
+    return engine->compact();
+  }
+
+  std::vector<std::pair<std::string, std::string>> ranges;
+  if (options_.autoCompact && options_.parts.empty() && options_.keyTypes.empty()) {
+    ranges = engine->tombstoneRanges(FLAGS_compact_tombstone_ratio);
+  } else if (options_.autoCompact) {
+    // Only the parts of the sst files full of tombstones within the selected ranges
+    auto tombstones = engine->tombstoneRanges(FLAGS_compact_tombstone_ratio);
+    for (const auto& selected : selectedRanges(engine)) {
+      for (const auto& tombstone : tombstones) {
+        const auto& start = std::max(selected.first, tombstone.first);
+        const auto& end = std::min(selected.second, tombstone.second);
+        if (start <= end) {
+          ranges.emplace_back(start, end);
+        }
+      }
+    }
+  } else {
+    ranges = selectedRanges(engine);
+  }
+
+  LOG(INFO) << "Compact " << ranges.size() << " ranges of space "
+            << *ctx_.parameters_.space_id_ref() << " in task " << ctx_.jobId_ << ":"
+            << ctx_.taskId_;
+  for (const auto& range : ranges) {
+    if (UNLIKELY(canceled_)) {
+      LOG(INFO) << "Compact task " << ctx_.jobId_ << ":" << ctx_.taskId_ << " is canceled";
+      return nebula::cpp2::ErrorCode::E_USER_CANCEL;
+    }
+    auto code = engine->compactRange(range.first, range.second);
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
 }  // namespace storage
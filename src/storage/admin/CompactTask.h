@@ -6,6 +6,7 @@
 #ifndef STORAGE_ADMIN_COMPACTTASK_H_
 #define STORAGE_ADMIN_COMPACTTASK_H_
 
+#include "common/utils/CompactOptions.h"
 #include "kvstore/KVEngine.h"
 #include "kvstore/NebulaStore.h"
 #include "storage/admin/AdminTask.h"
@@ -14,8 +15,14 @@ namespace nebula {
 namespace storage {
 
 /**
- * @brief Task class to do compact tasks.
- *
+ * @brief Compact the data of a space. Without any option the whole key space of each engine is
+ * compacted, otherwise only the ranges selected by the options, which are given in the form of
+ * "parts=1,2;data=tag,edge;auto=true":
+ *   - parts: compact the data of the given parts only
+ *   - data: compact the given types of data only, the types are tag, edge, index and other
+ *   - auto: compact the sst files of which the ratio of tombstones is no less than
+ *     compact_tombstone_ratio, within the ranges selected by the other options
+ * The ranges are compacted one by one, and paced by compact_host_rate_limit.
  */
 class CompactTask : public AdminTask {
  public:
@@ -31,6 +38,21 @@ class CompactTask : public AdminTask {
   ErrorOr<nebula::cpp2::ErrorCode, std::vector<AdminSubTask>> genSubTasks() override;
 
   nebula::cpp2::ErrorCode subTask(nebula::kvstore::KVEngine* engine);
+
+ private:
+  /**
+   * @brief Parse the options in the task specific parameters
+   */
+  bool parseOptions();
+
+  /**
+   * @brief The ranges of the engine selected by the parts and data options, each range is the keys
+   * of one type of a part
+   */
+  std::vector<std::pair<std::string, std::string>> selectedRanges(kvstore::KVEngine* engine);
+
+ private:
+  CompactOptions options_;
 };
 
 }  // namespace storage
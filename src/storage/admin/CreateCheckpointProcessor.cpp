@@ -5,6 +5,8 @@
 
 #include "storage/admin/CreateCheckpointProcessor.h"
 
+#include "common/fs/FileUtils.h"
+
 namespace nebula {
 namespace storage {
 
@@ -12,6 +14,16 @@ void CreateCheckpointProcessor::process(const cpp2::CreateCPRequest& req) {
   CHECK_NOTNULL(env_);
   auto spaceIdList = req.get_space_ids();
   auto& name = req.get_name();
+  auto* baseName = req.get_base_name();
+  if (req.clone_to_space_ref().has_value()) {
+    if (spaceIdList.size() != 1) {
+      resp_.code_ref() = nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    } else {
+      resp_.code_ref() = env_->kvstore_->cloneSpace(spaceIdList.front(), *req.clone_to_space_ref());
+    }
+    onFinished();
+    return;
+  }
 
   std::vector<nebula::cpp2::CheckpointInfo> ckInfoList;
   for (auto& spaceId : spaceIdList) {
@@ -28,6 +40,20 @@ void CreateCheckpointProcessor::process(const cpp2::CreateCPRequest& req) {
     }
 
     auto spaceCkList = std::move(nebula::value(ckRet));
+    if (baseName != nullptr && !baseName->empty()) {
+      for (auto& ckInfo : spaceCkList) {
+        // The checkpoints of an engine are in the same directory
+        const auto& path = ckInfo.get_path();
+        auto basePath = fs::FileUtils::joinPath(fs::FileUtils::dirname(path.c_str()), *baseName);
+        if (!fs::FileUtils::exist(basePath)) {
+          LOG(INFO) << "Base checkpoint " << basePath << " is not found, " << path << " is full";
+          continue;
+        }
+        std::vector<std::string> files;
+        collectNewFiles(path, basePath, "", &files);
+        ckInfo.new_files_ref() = std::move(files);
+      }
+    }
     ckInfoList.insert(ckInfoList.end(), spaceCkList.begin(), spaceCkList.end());
   }
 
@@ -36,6 +62,32 @@ void CreateCheckpointProcessor::process(const cpp2::CreateCPRequest& req) {
   onFinished();
 }
 
+void CreateCheckpointProcessor::collectNewFiles(const std::string& path,
+                                                const std::string& basePath,
+                                                const std::string& dir,
+                                                std::vector<std::string>* files) {
+  auto absDir = dir.empty() ? path : fs::FileUtils::joinPath(path, dir);
+  for (auto& file : fs::FileUtils::listAllFilesInDir(absDir.c_str())) {
+    auto relative = dir.empty() ? file : fs::FileUtils::joinPath(dir, file);
+    // The sst files of rocksdb never reuse a name, and the wal files are sealed once they are
+    // linked into a checkpoint, so a file of the same name and size is the same one. The others,
+    // e.g. CURRENT and MANIFEST, are always shipped.
+    folly::StringPiece name(file);
+    if (name.endsWith(".sst") || name.endsWith(".wal")) {
+      auto baseFile = fs::FileUtils::joinPath(basePath, relative);
+      if (fs::FileUtils::exist(baseFile) &&
+          fs::FileUtils::fileSize(baseFile.c_str()) ==
+              fs::FileUtils::fileSize(fs::FileUtils::joinPath(absDir, file).c_str())) {
+        continue;
+      }
+    }
+    files->emplace_back(std::move(relative));
+  }
+  for (auto& sub : fs::FileUtils::listAllDirsInDir(absDir.c_str())) {
+    collectNewFiles(path, basePath, dir.empty() ? sub : fs::FileUtils::joinPath(dir, sub), files);
+  }
+}
+
 void CreateCheckpointProcessor::onFinished() {
   this->promise_.setValue(std::move(resp_));
   delete this;
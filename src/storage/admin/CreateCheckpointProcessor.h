@@ -42,6 +42,19 @@ class CreateCheckpointProcessor {
 
   void onFinished();
 
+  /**
+   * @brief Collect the files under the dir of the checkpoint which are not in the base one.
+   *
+   * @param path Checkpoint path
+   * @param basePath Base checkpoint path
+   * @param dir Sub dir relative to the checkpoint path, empty for the checkpoint itself
+   * @param files The new files relative to the checkpoint path
+   */
+  static void collectNewFiles(const std::string& path,
+                              const std::string& basePath,
+                              const std::string& dir,
+                              std::vector<std::string>* files);
+
   StorageEnv* env_{nullptr};
   folly::Promise<cpp2::CreateCPResp> promise_;
   cpp2::CreateCPResp resp_;
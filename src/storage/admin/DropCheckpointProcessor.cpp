@@ -12,6 +12,15 @@ void DropCheckpointProcessor::process(const cpp2::DropCPRequest& req) {
   CHECK_NOTNULL(env_);
   auto spaceIdList = req.get_space_ids();
   auto& name = req.get_name();
+  if (req.drop_clone_ref().value_or(false)) {
+    if (spaceIdList.size() != 1) {
+      resp_.code_ref() = nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    } else {
+      resp_.code_ref() = env_->kvstore_->dropClonedSpace(spaceIdList.front());
+    }
+    onFinished();
+    return;
+  }
   for (auto spaceId : spaceIdList) {
     auto code = env_->kvstore_->dropCheckpoint(spaceId, std::move(name));
 
@@ -6,6 +6,7 @@
 #include "storage/admin/IngestTask.h"
 
 #include "common/fs/FileUtils.h"
+#include "storage/admin/StatsTask.h"
 
 namespace nebula {
 namespace storage {
@@ -14,6 +15,27 @@ bool IngestTask::check() {
   return env_->kvstore_ != nullptr;
 }
 
+nebula::cpp2::ErrorCode IngestTask::ingestPart(kvstore::KVEngine* engine,
+                                               GraphSpaceID spaceId,
+                                               PartitionID part,
+                                               const std::vector<VertexCache*>& caches) {
+  auto path = folly::stringPrintf("%s/download/%d", engine->getDataRoot(), part);
+  if (!fs::FileUtils::exist(path)) {
+    LOG(INFO) << path << " not existed";
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+  auto files = nebula::fs::FileUtils::listAllFilesInDir(path.c_str(), true, "*.sst");
+  LOG(INFO) << "Ingest files of space " << spaceId << " part " << part << ": " << files.size();
+  auto code = engine->ingest(std::vector<std::string>(files));
+  // The ingested files bypass the write path, so the cached vertices may be stale
+  for (auto* cache : caches) {
+    cache->evictPart(spaceId, part);
+  }
+  StatsTask::evictPart(spaceId, part);
+  return code;
+}
+
 ErrorOr<nebula::cpp2::ErrorCode, std::vector<AdminSubTask>> IngestTask::genSubTasks() {
   std::vector<AdminSubTask> results;
   auto* store = dynamic_cast<kvstore::NebulaStore*>(env_->kvstore_);
@@ -24,26 +46,44 @@ ErrorOr<nebula::cpp2::ErrorCode, std::vector<AdminSubTask>> IngestTask::genSubTa
   }
 
   auto space = nebula::value(errOrSpace);
-  results.emplace_back([space = space]() {
-    for (auto& engine : space->engines_) {
-      auto parts = engine->allParts();
-      for (auto part : parts) {
-        auto path = folly::stringPrintf("%s/download/%d", engine->getDataRoot(), part);
-        if (!fs::FileUtils::exist(path)) {
-          LOG(INFO) << path << " not existed";
-          continue;
-        }
+  auto spaceId = *ctx_.parameters_.space_id_ref();
+  std::vector<VertexCache*> caches;
+  for (auto* cache : {env_->vertexCache_.get(), env_->adjacencyCache_.get()}) {
+    if (cache != nullptr) {
+      caches.emplace_back(cache);
+    }
+  }
+  // Each part is ingested by one subtask, the subtasks are interleaved among the data paths, so
+  // that the concurrent ones, which are limited by max_concurrent_subtasks, are spread over disks
+  std::vector<std::vector<std::pair<kvstore::KVEngine*, PartitionID>>> partsOfEngines;
+  size_t total = 0;
+  for (auto& engine : space->engines_) {
+    std::vector<std::pair<kvstore::KVEngine*, PartitionID>> parts;
+    for (auto part : engine->allParts()) {
+      parts.emplace_back(engine.get(), part);
+    }
+    total += parts.size();
+    partsOfEngines.emplace_back(std::move(parts));
+  }
 
-        auto files = nebula::fs::FileUtils::listAllFilesInDir(path.c_str(), true, "*.sst");
-        LOG(INFO) << "Ingest files: " << files.size();
-        auto code = engine->ingest(std::vector<std::string>(files));
-        if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
-          return code;
-        }
+  auto finished = std::make_shared<std::atomic<size_t>>(0);
+  for (size_t i = 0; results.size() < total; i++) {
+    for (auto& parts : partsOfEngines) {
+      if (i >= parts.size()) {
+        continue;
       }
+      auto* engine = parts[i].first;
+      auto part = parts[i].second;
+      results.emplace_back([engine, spaceId, part, caches, finished, total, space = space]() {
+        auto code = ingestPart(engine, spaceId, part, caches);
+        if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+          LOG(INFO) << folly::sformat(
+              "Ingest space {} progress: {}/{} parts", spaceId, ++(*finished), total);
+        }
+        return code;
+      });
     }
-    return nebula::cpp2::ErrorCode::SUCCEEDED;
-  });
+  }
   return results;
 }
 
@@ -21,7 +21,19 @@ class IngestTask : public AdminTask {
 
   bool check() override;
 
+  /**
+   * @brief Generate one subtask for each part, so that the parts are ingested concurrently
+   */
   ErrorOr<nebula::cpp2::ErrorCode, std::vector<AdminSubTask>> genSubTasks() override;
+
+ private:
+  /**
+   * @brief Ingest the downloaded sst files of a part into the engine
+   */
+  static nebula::cpp2::ErrorCode ingestPart(kvstore::KVEngine* engine,
+                                            GraphSpaceID spaceId,
+                                            PartitionID part,
+                                            const std::vector<VertexCache*>& caches);
 };
 
 }  // namespace storage
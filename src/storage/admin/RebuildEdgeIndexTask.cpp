@@ -7,6 +7,7 @@
 
 #include "codec/RowReaderWrapper.h"
 #include "common/utils/IndexKeyUtils.h"
+#include "kvstore/RocksScanMode.h"
 #include "storage/StorageFlags.h"
 
 namespace nebula {
@@ -23,10 +24,17 @@ StatusOr<std::shared_ptr<meta::cpp2::IndexItem>> RebuildEdgeIndexTask::getIndex(
   return env_->indexMan_->getEdgeIndex(space, index);
 }
 
-nebula::cpp2::ErrorCode RebuildEdgeIndexTask::buildIndexGlobal(GraphSpaceID space,
-                                                               PartitionID part,
-                                                               const IndexItems& items,
-                                                               kvstore::RateLimiter* rateLimiter) {
+std::string RebuildEdgeIndexTask::scanPrefix(PartitionID part) {
+  return NebulaKeyUtils::edgePrefix(part);
+}
+
+nebula::cpp2::ErrorCode RebuildEdgeIndexTask::buildIndexOnRange(GraphSpaceID space,
+                                                                PartitionID part,
+                                                                const IndexItems& items,
+                                                                const std::string& start,
+                                                                const std::string& end,
+                                                                const void* snapshot,
+                                                                kvstore::RateLimiter* rateLimiter) {
   if (UNLIKELY(canceled_)) {
     LOG(INFO) << "Rebuild Edge Index is Canceled";
     return nebula::cpp2::ErrorCode::E_USER_CANCEL;
@@ -52,8 +60,8 @@ nebula::cpp2::ErrorCode RebuildEdgeIndexTask::buildIndexGlobal(GraphSpaceID spac
   auto schemas = schemasRet.value();
   auto vidSize = vidSizeRet.value();
   std::unique_ptr<kvstore::KVIterator> iter;
-  const auto& prefix = NebulaKeyUtils::edgePrefix(part);
-  auto ret = env_->kvstore_->prefix(space, part, prefix, &iter);
+  kvstore::ScanModeGuard scanMode(kvstore::ScanMode::kBackground);
+  auto ret = env_->kvstore_->range(space, part, start, end, &iter, false, snapshot);
   if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
     LOG(INFO) << "Processing Part " << part << " Failed";
     return ret;
@@ -126,14 +134,6 @@ nebula::cpp2::ErrorCode RebuildEdgeIndexTask::buildIndexGlobal(GraphSpaceID spac
       continue;
     }
 
-    std::string indexVal = "";
-    if (ttlProp.first) {
-      auto ttlValRet = CommonUtils::ttlValue(schema, reader.get());
-      if (ttlValRet.ok()) {
-        indexVal = IndexKeyUtils::indexVal(std::move(ttlValRet).value());
-      }
-    }
-
     for (const auto& item : items) {
       if (item->get_schema_id().get_edge_type() == edgeType) {
         auto valuesRet = IndexKeyUtils::collectIndexValues(reader.get(), item.get(), schema);
@@ -141,6 +141,7 @@ nebula::cpp2::ErrorCode RebuildEdgeIndexTask::buildIndexGlobal(GraphSpaceID spac
           LOG(INFO) << "Collect index value failed";
           continue;
         }
+        auto indexVal = CommonUtils::indexVal(schema, reader.get(), item.get());
         auto indexKeys = IndexKeyUtils::edgeIndexKeys(vidSize,
                                                       part,
                                                       item->get_index_id(),
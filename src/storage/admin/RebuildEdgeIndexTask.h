@@ -26,10 +26,15 @@ class RebuildEdgeIndexTask : public RebuildIndexTask {
   StatusOr<std::shared_ptr<meta::cpp2::IndexItem>> getIndex(GraphSpaceID space,
                                                             IndexID index) override;
 
-  nebula::cpp2::ErrorCode buildIndexGlobal(GraphSpaceID space,
-                                           PartitionID part,
-                                           const IndexItems& items,
-                                           kvstore::RateLimiter* rateLimiter) override;
+  std::string scanPrefix(PartitionID part) override;
+
+  nebula::cpp2::ErrorCode buildIndexOnRange(GraphSpaceID space,
+                                            PartitionID part,
+                                            const IndexItems& items,
+                                            const std::string& start,
+                                            const std::string& end,
+                                            const void* snapshot,
+                                            kvstore::RateLimiter* rateLimiter) override;
 };
 
 }  // namespace storage
@@ -5,6 +5,8 @@
 
 #include "storage/admin/RebuildIndexTask.h"
 
+#include <folly/ScopeGuard.h>
+
 #include "common/utils/OperationKeyUtils.h"
 #include "kvstore/Common.h"
 #include "storage/StorageFlags.h"
@@ -81,7 +83,12 @@ nebula::cpp2::ErrorCode RebuildIndexTask::invoke(GraphSpaceID space,
                                                  const IndexItems& items) {
   auto rateLimiter = std::make_unique<kvstore::RateLimiter>();
   // TaskManager will make sure that there won't be cocurrent invoke of a given part
-  auto result = removeLegacyLogs(space, part);
+  auto result = nebula::cpp2::ErrorCode::SUCCEEDED;
+  // The logs of the indexes maintained asynchronously are not applied yet, which are replayed
+  // after the indexes are built as well
+  if (!env_->hasAsyncIndex(space)) {
+    result = removeLegacyLogs(space, part);
+  }
   if (result != nebula::cpp2::ErrorCode::SUCCEEDED) {
     LOG(INFO) << "Remove legacy logs at part: " << part << " failed";
     return nebula::cpp2::ErrorCode::E_REBUILD_INDEX_FAILED;
@@ -116,6 +123,56 @@ nebula::cpp2::ErrorCode RebuildIndexTask::invoke(GraphSpaceID space,
   return result;
 }
 
+nebula::cpp2::ErrorCode RebuildIndexTask::buildIndexGlobal(GraphSpaceID space,
+                                                           PartitionID part,
+                                                           const IndexItems& items,
+                                                           kvstore::RateLimiter* rateLimiter) {
+  // The rows written after the snapshot are in the operation logs
+  const auto* snapshot = env_->kvstore_->GetSnapshot(space, part);
+  if (snapshot == nullptr) {
+    LOG(INFO) << folly::sformat("Get snapshot failed, space={}, part={}", space, part);
+    return nebula::cpp2::ErrorCode::E_LEADER_CHANGED;
+  }
+  SCOPE_EXIT {
+    env_->kvstore_->ReleaseSnapshot(space, part, snapshot);
+  };
+
+  auto start = scanPrefix(part);
+  // The keys of the prefix are less than the prefix with its last byte increased
+  auto end = start;
+  end.back()++;
+  auto boundaries = env_->kvstore_->splitRange(
+      space, part, start, end, std::max(FLAGS_rebuild_index_part_concurrency, 1U));
+  boundaries.emplace_back(std::move(end));
+  std::vector<std::pair<std::string, std::string>> ranges;
+  for (auto& boundary : boundaries) {
+    ranges.emplace_back(std::move(start), boundary);
+    start = std::move(boundary);
+  }
+  LOG(INFO) << folly::sformat(
+      "Building index of {} ranges, space={}, part={}", ranges.size(), space, part);
+
+  std::vector<nebula::cpp2::ErrorCode> codes(ranges.size(), nebula::cpp2::ErrorCode::SUCCEEDED);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < ranges.size(); i++) {
+    threads.emplace_back([&, i] {
+      codes[i] = buildIndexOnRange(
+          space, part, items, ranges[i].first, ranges[i].second, snapshot, rateLimiter);
+    });
+  }
+  codes[0] = buildIndexOnRange(
+      space, part, items, ranges[0].first, ranges[0].second, snapshot, rateLimiter);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto code : codes) {
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
 nebula::cpp2::ErrorCode RebuildIndexTask::buildIndexOnOperations(
     GraphSpaceID space, PartitionID part, kvstore::RateLimiter* rateLimiter) {
   if (canceled_) {
@@ -229,6 +286,7 @@ nebula::cpp2::ErrorCode RebuildIndexTask::writeData(GraphSpaceID space,
   rateLimiter->consume(static_cast<double>(batchSize),                             // toConsume
                        static_cast<double>(FLAGS_rebuild_index_part_rate_limit),   // rate
                        static_cast<double>(FLAGS_rebuild_index_part_rate_limit));  // burstSize
+  kvstore::BackgroundIoLimiter::instance()->consume(kvstore::IoClass::kRebuildIndex, batchSize);
   env_->kvstore_->asyncMultiPut(
       space, part, std::move(data), [&result, &baton](nebula::cpp2::ErrorCode code) {
         if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -250,6 +308,8 @@ nebula::cpp2::ErrorCode RebuildIndexTask::writeOperation(GraphSpaceID space,
   rateLimiter->consume(static_cast<double>(batchHolder->size()),                   // toConsume
                        static_cast<double>(FLAGS_rebuild_index_part_rate_limit),   // rate
                        static_cast<double>(FLAGS_rebuild_index_part_rate_limit));  // burstSize
+  kvstore::BackgroundIoLimiter::instance()->consume(kvstore::IoClass::kRebuildIndex,
+                                                    batchHolder->size());
   env_->kvstore_->asyncAppendBatch(
       space, part, std::move(encoded), [&result, &baton](nebula::cpp2::ErrorCode code) {
         if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
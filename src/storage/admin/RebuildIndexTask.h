@@ -44,10 +44,27 @@ class RebuildIndexTask : public AdminTask {
   virtual StatusOr<std::shared_ptr<meta::cpp2::IndexItem>> getIndex(GraphSpaceID space,
                                                                     IndexID index) = 0;
 
-  virtual nebula::cpp2::ErrorCode buildIndexGlobal(GraphSpaceID space,
-                                                   PartitionID part,
-                                                   const IndexItems& items,
-                                                   kvstore::RateLimiter* rateLimiter) = 0;
+  // Prefix of the keys of the rows to build the indexes from
+  virtual std::string scanPrefix(PartitionID part) = 0;
+
+  // Build the indexes of the rows in the range [start, end) of the snapshot
+  virtual nebula::cpp2::ErrorCode buildIndexOnRange(GraphSpaceID space,
+                                                    PartitionID part,
+                                                    const IndexItems& items,
+                                                    const std::string& start,
+                                                    const std::string& end,
+                                                    const void* snapshot,
+                                                    kvstore::RateLimiter* rateLimiter) = 0;
+
+  /**
+   * @brief Build the indexes of the rows in a snapshot of the part. The keys of the part are split
+   * into rebuild_index_part_concurrency ranges of similar data size, each of which is scanned by a
+   * thread, sharing the rate limit of the part.
+   */
+  nebula::cpp2::ErrorCode buildIndexGlobal(GraphSpaceID space,
+                                           PartitionID part,
+                                           const IndexItems& items,
+                                           kvstore::RateLimiter* rateLimiter);
 
   nebula::cpp2::ErrorCode buildIndexOnOperations(GraphSpaceID space,
                                                  PartitionID part,
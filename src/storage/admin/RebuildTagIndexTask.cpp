@@ -7,6 +7,7 @@
 
 #include "codec/RowReaderWrapper.h"
 #include "common/utils/IndexKeyUtils.h"
+#include "kvstore/RocksScanMode.h"
 #include "storage/StorageFlags.h"
 
 namespace nebula {
@@ -23,10 +24,17 @@ StatusOr<std::shared_ptr<meta::cpp2::IndexItem>> RebuildTagIndexTask::getIndex(G
   return env_->indexMan_->getTagIndex(space, index);
 }
 
-nebula::cpp2::ErrorCode RebuildTagIndexTask::buildIndexGlobal(GraphSpaceID space,
-                                                              PartitionID part,
-                                                              const IndexItems& items,
-                                                              kvstore::RateLimiter* rateLimiter) {
+std::string RebuildTagIndexTask::scanPrefix(PartitionID part) {
+  return NebulaKeyUtils::tagPrefix(part);
+}
+
+nebula::cpp2::ErrorCode RebuildTagIndexTask::buildIndexOnRange(GraphSpaceID space,
+                                                               PartitionID part,
+                                                               const IndexItems& items,
+                                                               const std::string& start,
+                                                               const std::string& end,
+                                                               const void* snapshot,
+                                                               kvstore::RateLimiter* rateLimiter) {
   if (UNLIKELY(canceled_)) {
     LOG(INFO) << "Rebuild Tag Index is Canceled";
     return nebula::cpp2::ErrorCode::E_USER_CANCEL;
@@ -52,8 +60,8 @@ nebula::cpp2::ErrorCode RebuildTagIndexTask::buildIndexGlobal(GraphSpaceID space
 
   auto vidSize = vidSizeRet.value();
   std::unique_ptr<kvstore::KVIterator> iter;
-  auto prefix = NebulaKeyUtils::tagPrefix(part);
-  auto ret = env_->kvstore_->prefix(space, part, prefix, &iter);
+  kvstore::ScanModeGuard scanMode(kvstore::ScanMode::kBackground);
+  auto ret = env_->kvstore_->range(space, part, start, end, &iter, false, snapshot);
   if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
     LOG(INFO) << "Processing Part " << part << " Failed";
     return ret;
@@ -117,14 +125,6 @@ nebula::cpp2::ErrorCode RebuildTagIndexTask::buildIndexGlobal(GraphSpaceID space
       continue;
     }
 
-    std::string indexVal = "";
-    if (ttlProp.first) {
-      auto ttlValRet = CommonUtils::ttlValue(schema, reader.get());
-      if (ttlValRet.ok()) {
-        indexVal = IndexKeyUtils::indexVal(std::move(ttlValRet).value());
-      }
-    }
-
     for (const auto& item : items) {
       if (item->get_schema_id().get_tag_id() == tagID) {
         auto valuesRet = IndexKeyUtils::collectIndexValues(reader.get(), item.get(), schema);
@@ -132,6 +132,7 @@ nebula::cpp2::ErrorCode RebuildTagIndexTask::buildIndexGlobal(GraphSpaceID space
           LOG(INFO) << "Collect index value failed";
           continue;
         }
+        auto indexVal = CommonUtils::indexVal(schema, reader.get(), item.get());
         auto indexKeys = IndexKeyUtils::vertexIndexKeys(
             vidSize, part, item->get_index_id(), vertex.toString(), std::move(valuesRet).value());
         for (auto& indexKey : indexKeys) {
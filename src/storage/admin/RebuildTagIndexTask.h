@@ -40,18 +40,29 @@ class RebuildTagIndexTask : public RebuildIndexTask {
                                                             IndexID index) override;
 
   /**
-   * @brief Rebuilding index.
+   * @brief Prefix of the keys of the tags in the part
+   */
+  std::string scanPrefix(PartitionID part) override;
+
+  /**
+   * @brief Rebuilding index of the tags in the range.
    *
    * @param space space id.
    * @param part Partition id.
    * @param items Index items.
+   * @param start Start key of the range, inclusive.
+   * @param end End key of the range, exclusive.
+   * @param snapshot Snapshot of the part to scan.
    * @param rateLimiter Rate limiter of kvstore.
    * @return nebula::cpp2::ErrorCode Errorcode.
    */
-  nebula::cpp2::ErrorCode buildIndexGlobal(GraphSpaceID space,
-                                           PartitionID part,
-                                           const IndexItems& items,
-                                           kvstore::RateLimiter* rateLimiter) override;
+  nebula::cpp2::ErrorCode buildIndexOnRange(GraphSpaceID space,
+                                            PartitionID part,
+                                            const IndexItems& items,
+                                            const std::string& start,
+                                            const std::string& end,
+                                            const void* snapshot,
+                                            kvstore::RateLimiter* rateLimiter) override;
 };
 
 }  // namespace storage
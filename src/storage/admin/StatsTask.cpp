@@ -8,12 +8,43 @@
 #include <thrift/lib/cpp/util/EnumUtils.h>
 
 #include "common/base/MurmurHash2.h"
+#include "common/utils/IndexStatsUtils.h"
 #include "common/utils/NebulaKeyUtils.h"
 #include "kvstore/Common.h"
+#include "kvstore/RateLimiter.h"
+#include "kvstore/RocksScanMode.h"
+
+DEFINE_bool(stats_reuse_unchanged_parts,
+            true,
+            "Whether the stats job reuses the statistics of the parts counted last time, if no log "
+            "is committed to them since then, instead of scanning them again");
 
 namespace nebula {
 namespace storage {
 
+namespace {
+
+// The statistics of a part, and what they are counted at
+struct CachedStats {
+  std::pair<LogID, TermID> logId;
+  std::unordered_map<TagID, std::string> tags;
+  std::unordered_map<EdgeType, std::string> edges;
+  std::vector<IndexID> indexes;
+  nebula::meta::cpp2::StatsItem item;
+};
+
+std::mutex& cachedStatsLock() {
+  static std::mutex lock;
+  return lock;
+}
+
+std::map<std::pair<GraphSpaceID, PartitionID>, CachedStats>& cachedStats() {
+  static std::map<std::pair<GraphSpaceID, PartitionID>, CachedStats> stats;
+  return stats;
+}
+
+}  // namespace
+
 bool StatsTask::check() {
   return env_->kvstore_ != nullptr && env_->schemaMan_ != nullptr;
 }
@@ -31,6 +62,9 @@ nebula::cpp2::ErrorCode StatsTask::getSchemas(GraphSpaceID spaceId) {
 
   for (auto tag : tags.value()) {
     auto tagId = tag.first;
+    if (!tag.second.empty() && tag.second.back()->getTTLInfo().ok()) {
+      hasTTL_ = true;
+    }
     auto tagNameRet = env_->schemaMan_->toTagName(spaceId, tagId);
     if (!tagNameRet.ok()) {
       VLOG(1) << "Can't find spaceId " << spaceId << " tagId " << tagId;
@@ -41,6 +75,9 @@ nebula::cpp2::ErrorCode StatsTask::getSchemas(GraphSpaceID spaceId) {
 
   for (auto edge : edges.value()) {
     auto edgeType = edge.first;
+    if (!edge.second.empty() && edge.second.back()->getTTLInfo().ok()) {
+      hasTTL_ = true;
+    }
     auto edgeNameRet = env_->schemaMan_->toEdgeName(spaceId, std::abs(edgeType));
     if (!edgeNameRet.ok()) {
       VLOG(1) << "Can't find spaceId " << spaceId << " edgeType " << std::abs(edgeType);
@@ -48,9 +85,113 @@ nebula::cpp2::ErrorCode StatsTask::getSchemas(GraphSpaceID spaceId) {
     }
     edges_.emplace(edgeType, std::move(edgeNameRet.value()));
   }
+
+  // The index statistics are optional, skip them if the indexes are unavailable
+  if (env_->indexMan_ != nullptr) {
+    auto tagIndexes = env_->indexMan_->getTagIndexes(spaceId);
+    if (tagIndexes.ok()) {
+      indexes_ = std::move(tagIndexes).value();
+    }
+    auto edgeIndexes = env_->indexMan_->getEdgeIndexes(spaceId);
+    if (edgeIndexes.ok()) {
+      auto& items = edgeIndexes.value();
+      indexes_.insert(indexes_.end(), items.begin(), items.end());
+    }
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode StatsTask::genIndexStats(
+    GraphSpaceID spaceId,
+    PartitionID part,
+    std::unordered_map<IndexID, nebula::meta::cpp2::IndexStats>* indexStats) {
+  // The first index field starts after the partId and indexId in index key
+  static constexpr size_t kFieldOffset = sizeof(PartitionID) + sizeof(IndexID);
+  for (const auto& index : indexes_) {
+    auto indexId = index->get_index_id();
+    const auto& fields = index->get_fields();
+    auto len = fields.empty() ? 0 : IndexStatsUtils::fieldLength(fields.front());
+
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto prefix = IndexKeyUtils::indexPrefix(part, indexId);
+    auto ret = env_->kvstore_->prefix(spaceId, part, prefix, &iter, true);
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      LOG(INFO) << "Stats index " << indexId << " failed";
+      return ret;
+    }
+    IndexStatsUtils::Collector collector;
+    while (iter && iter->valid()) {
+      if (UNLIKELY(canceled_)) {
+        LOG(INFO) << "Stats task is canceled";
+        return nebula::cpp2::ErrorCode::E_USER_CANCEL;
+      }
+      auto key = iter->key();
+      if (len != 0 && key.size() >= kFieldOffset + len) {
+        collector.add(key.subpiece(kFieldOffset, len));
+      } else {
+        collector.add(folly::StringPiece());
+      }
+      iter->next();
+    }
+    indexStats->emplace(indexId, collector.finish());
+  }
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
+std::optional<std::pair<LogID, TermID>> StatsTask::committedLogId(GraphSpaceID spaceId,
+                                                                  PartitionID part) {
+  if (!FLAGS_stats_reuse_unchanged_parts || hasTTL_) {
+    return std::nullopt;
+  }
+  auto partRet = env_->kvstore_->part(spaceId, part);
+  if (!nebula::ok(partRet)) {
+    return std::nullopt;
+  }
+  auto logId = nebula::value(partRet)->lastCommittedLogId();
+  if (logId.first == 0) {
+    return std::nullopt;
+  }
+  return logId;
+}
+
+bool StatsTask::reuseStats(GraphSpaceID spaceId,
+                           PartitionID part,
+                           const std::pair<LogID, TermID>& logId) {
+  std::vector<IndexID> indexes;
+  for (const auto& index : indexes_) {
+    indexes.emplace_back(index->get_index_id());
+  }
+  std::lock_guard<std::mutex> guard(cachedStatsLock());
+  auto iter = cachedStats().find({spaceId, part});
+  if (iter == cachedStats().end()) {
+    return false;
+  }
+  const auto& cached = iter->second;
+  if (cached.logId != logId || cached.tags != tags_ || cached.edges != edges_ ||
+      cached.indexes != indexes) {
+    return false;
+  }
+  statistics_.emplace(part, cached.item);
+  return true;
+}
+
+void StatsTask::cacheStats(GraphSpaceID spaceId,
+                           PartitionID part,
+                           const std::pair<LogID, TermID>& logId,
+                           const nebula::meta::cpp2::StatsItem& item) {
+  CachedStats cached{logId, tags_, edges_, {}, item};
+  for (const auto& index : indexes_) {
+    cached.indexes.emplace_back(index->get_index_id());
+  }
+  std::lock_guard<std::mutex> guard(cachedStatsLock());
+  cachedStats()[{spaceId, part}] = std::move(cached);
+}
+
+void StatsTask::evictPart(GraphSpaceID spaceId, PartitionID part) {
+  std::lock_guard<std::mutex> guard(cachedStatsLock());
+  cachedStats().erase({spaceId, part});
+}
+
 ErrorOr<nebula::cpp2::ErrorCode, std::vector<AdminSubTask>> StatsTask::genSubTasks() {
   spaceId_ = *ctx_.parameters_.space_id_ref();
   auto parts = *ctx_.parameters_.parts_ref();
@@ -79,6 +220,8 @@ nebula::cpp2::ErrorCode StatsTask::genSubTask(GraphSpaceID spaceId,
     LOG(INFO) << "Stats task is canceled";
     return nebula::cpp2::ErrorCode::E_USER_CANCEL;
   }
+  // The whole part is scanned, keep it out of the block cache
+  kvstore::ScanModeGuard scanMode(kvstore::ScanMode::kBackground);
 
   auto vIdLenRet = env_->schemaMan_->getSpaceVidLen(spaceId);
   if (!vIdLenRet.ok()) {
@@ -101,6 +244,13 @@ nebula::cpp2::ErrorCode StatsTask::genSubTask(GraphSpaceID spaceId,
   }
 
   auto partitionNum = partitionNumRet.value();
+  // Read before scanning, so the logs committed during the scan are counted again next time
+  auto logId = committedLogId(spaceId, part);
+  if (logId.has_value() && reuseStats(spaceId, part, *logId)) {
+    LOG(INFO) << "Reuse the stats of space " << spaceId << " part " << part << " at log "
+              << logId->first;
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
   LOG(INFO) << "Start stats task";
   auto tagPrefix = NebulaKeyUtils::tagPrefix(part);
   std::unique_ptr<kvstore::KVIterator> tagIter;
@@ -141,6 +291,17 @@ nebula::cpp2::ErrorCode StatsTask::genSubTask(GraphSpaceID spaceId,
     edgetypeEdges[edge.first] = 0;
   }
 
+  // The bytes scanned are consumed from the io budget of the stats job in batches
+  static constexpr int64_t kScanBatchBytes = 1024 * 1024;
+  int64_t scanned = 0;
+  auto throttle = [&scanned](kvstore::KVIterator* iter) {
+    scanned += iter->key().size() + iter->val().size();
+    if (scanned >= kScanBatchBytes) {
+      kvstore::BackgroundIoLimiter::instance()->consume(kvstore::IoClass::kStats, scanned);
+      scanned = 0;
+    }
+  };
+
   // Only stats valid vertex data, no multi version
   // For example
   // Vid  tagId
@@ -154,6 +315,7 @@ nebula::cpp2::ErrorCode StatsTask::genSubTask(GraphSpaceID spaceId,
       LOG(INFO) << "Stats task is canceled";
       return nebula::cpp2::ErrorCode::E_USER_CANCEL;
     }
+    throttle(tagIter.get());
 
     auto key = tagIter->key();
     auto vId = NebulaKeyUtils::getVertexId(vIdLen, key).str();
@@ -180,6 +342,7 @@ nebula::cpp2::ErrorCode StatsTask::genSubTask(GraphSpaceID spaceId,
       LOG(INFO) << "Stats task is canceled";
       return nebula::cpp2::ErrorCode::E_USER_CANCEL;
     }
+    throttle(edgeIter.get());
 
     auto key = edgeIter->key();
 
@@ -218,6 +381,7 @@ nebula::cpp2::ErrorCode StatsTask::genSubTask(GraphSpaceID spaceId,
     edgeIter->next();
   }
   while (vertexIter && vertexIter->valid()) {
+    throttle(vertexIter.get());
     spaceVertices++;
     vertexIter->next();
   }
@@ -239,6 +403,11 @@ nebula::cpp2::ErrorCode StatsTask::genSubTask(GraphSpaceID spaceId,
 
   statsItem.space_vertices_ref() = spaceVertices;
   statsItem.space_edges_ref() = spaceEdges;
+
+  ret = genIndexStats(spaceId, part, &(*statsItem.index_stats_ref()));
+  if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return ret;
+  }
   using Correlativities = std::vector<nebula::meta::cpp2::Correlativity>;
   Correlativities positiveCorrelativity;
   for (const auto& entry : positiveRelevancy) {
@@ -276,6 +445,9 @@ nebula::cpp2::ErrorCode StatsTask::genSubTask(GraphSpaceID spaceId,
   negativePartCorrelativities[part] = negativeCorrelativity;
   statsItem.negative_part_correlativity_ref() = std::move(negativePartCorrelativities);
 
+  if (logId.has_value()) {
+    cacheStats(spaceId, part, *logId, statsItem);
+  }
   statistics_.emplace(part, std::move(statsItem));
   LOG(INFO) << "Stats task finished";
   return nebula::cpp2::ErrorCode::SUCCEEDED;
@@ -317,6 +489,8 @@ void StatsTask::finish(nebula::cpp2::ErrorCode rc) {
         }
       }
 
+      IndexStatsUtils::merge(*result.index_stats_ref(), *item.index_stats_ref());
+
       (*result.positive_part_correlativity_ref())
           .insert((*item.positive_part_correlativity_ref()).begin(),
                   (*item.positive_part_correlativity_ref()).end());
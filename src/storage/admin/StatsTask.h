@@ -43,6 +43,15 @@ class StatsTask : public AdminTask {
    */
   void finish(nebula::cpp2::ErrorCode rc) override;
 
+  /**
+   * @brief Drop the statistics cached of the part, which is changed without committing any log,
+   * e.g. by ingesting the files
+   *
+   * @param spaceId
+   * @param part
+   */
+  static void evictPart(GraphSpaceID spaceId, PartitionID part);
+
  protected:
   nebula::cpp2::ErrorCode genSubTask(GraphSpaceID space,
                                      PartitionID part,
@@ -52,6 +61,23 @@ class StatsTask : public AdminTask {
  private:
   nebula::cpp2::ErrorCode getSchemas(GraphSpaceID spaceId);
 
+  // The last log committed to the part, none if unknown
+  std::optional<std::pair<LogID, TermID>> committedLogId(GraphSpaceID spaceId, PartitionID part);
+
+  // Reuse the statistics of the part counted last time, if no log is committed since then
+  bool reuseStats(GraphSpaceID spaceId, PartitionID part, const std::pair<LogID, TermID>& logId);
+
+  void cacheStats(GraphSpaceID spaceId,
+                  PartitionID part,
+                  const std::pair<LogID, TermID>& logId,
+                  const nebula::meta::cpp2::StatsItem& item);
+
+  // Stats the number of entries, distinct values and histogram of the first field of each index
+  nebula::cpp2::ErrorCode genIndexStats(
+      GraphSpaceID spaceId,
+      PartitionID part,
+      std::unordered_map<IndexID, nebula::meta::cpp2::IndexStats>* indexStats);
+
  protected:
   GraphSpaceID spaceId_;
 
@@ -61,6 +87,13 @@ class StatsTask : public AdminTask {
   // All edgeTypes and edgeName of the spaceId
   std::unordered_map<EdgeType, std::string> edges_;
 
+  // All tag and edge indexes of the spaceId
+  std::vector<std::shared_ptr<nebula::meta::cpp2::IndexItem>> indexes_;
+
+  // The expired data disappears by compaction without any log, so the statistics are not reused
+  // if any schema has ttl
+  bool hasTTL_{false};
+
   folly::ConcurrentHashMap<PartitionID, nebula::meta::cpp2::StatsItem> statistics_;
 
   // The number of subtasks equals to the number of parts in request
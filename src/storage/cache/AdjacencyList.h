@@ -0,0 +1,185 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_CACHE_ADJACENCYLIST_H_
+#define STORAGE_CACHE_ADJACENCYLIST_H_
+
+#include "common/base/Base.h"
+#include "kvstore/KVIterator.h"
+#include "storage/cache/VertexCache.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief The edges of one edge type of a vertex are cached in a contiguous buffer, each edge
+ * is encoded as: | key length (uint32) | key | value length (uint32) | value |
+ *
+ * The keys are kept as they are in kvstore, so the cached edges could be read by the same
+ * SingleEdgeIterator as the ones from kvstore, and TTL is still checked when reading.
+ */
+class AdjacencyList final {
+ public:
+  static void append(std::string& buffer, folly::StringPiece key, folly::StringPiece val) {
+    appendPiece(buffer, key);
+    appendPiece(buffer, val);
+  }
+
+  // Read the piece starting at offset, and move the offset after it
+  static folly::StringPiece readPiece(const std::string& buffer, size_t& offset) {
+    uint32_t len;
+    memcpy(&len, buffer.data() + offset, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    folly::StringPiece piece(buffer.data() + offset, len);
+    offset += len;
+    return piece;
+  }
+
+ private:
+  static void appendPiece(std::string& buffer, folly::StringPiece piece) {
+    uint32_t len = piece.size();
+    buffer.append(reinterpret_cast<const char*>(&len), sizeof(uint32_t));
+    buffer.append(piece.data(), piece.size());
+  }
+};
+
+/**
+ * @brief Iterate over a cached adjacency list
+ */
+class AdjacencyListIterator final : public kvstore::KVIterator {
+ public:
+  explicit AdjacencyListIterator(std::shared_ptr<const std::string> buffer)
+      : buffer_(std::move(buffer)) {
+    read();
+  }
+
+  bool valid() const override {
+    return valid_;
+  }
+
+  void next() override {
+    read();
+  }
+
+  void prev() override {
+    LOG(FATAL) << "Not supported";
+  }
+
+  folly::StringPiece key() const override {
+    return key_;
+  }
+
+  folly::StringPiece val() const override {
+    return val_;
+  }
+
+ private:
+  void read() {
+    valid_ = offset_ < buffer_->size();
+    if (valid_) {
+      key_ = AdjacencyList::readPiece(*buffer_, offset_);
+      val_ = AdjacencyList::readPiece(*buffer_, offset_);
+    }
+  }
+
+  std::shared_ptr<const std::string> buffer_;
+  size_t offset_{0};
+  bool valid_{false};
+  folly::StringPiece key_;
+  folly::StringPiece val_;
+};
+
+/**
+ * @brief Wrap the prefix iterator of kvstore, and record the edges while iterating. When all
+ * edges have been iterated and there are at least minDegree of them, the adjacency list is put
+ * into the cache. Nothing is cached if the iteration stops early, e.g. because of the limit.
+ */
+class AdjacencyListRecorder final : public kvstore::KVIterator {
+ public:
+  AdjacencyListRecorder(std::unique_ptr<kvstore::KVIterator> iter,
+                        VertexCache* cache,
+                        GraphSpaceID spaceId,
+                        PartitionID partId,
+                        const VertexID& vId,
+                        EdgeType edgeType,
+                        uint64_t version,
+                        size_t minDegree)
+      : iter_(std::move(iter)),
+        cache_(cache),
+        spaceId_(spaceId),
+        partId_(partId),
+        vId_(vId),
+        edgeType_(edgeType),
+        version_(version),
+        minDegree_(minDegree) {
+    record();
+  }
+
+  bool valid() const override {
+    return iter_->valid();
+  }
+
+  void next() override {
+    iter_->next();
+    record();
+  }
+
+  void prev() override {
+    LOG(FATAL) << "Not supported";
+  }
+
+  folly::StringPiece key() const override {
+    return iter_->key();
+  }
+
+  folly::StringPiece val() const override {
+    return iter_->val();
+  }
+
+ private:
+  void record() {
+    if (aborted_) {
+      return;
+    }
+    if (!iter_->valid()) {
+      aborted_ = true;
+      if (count_ >= minDegree_) {
+        cache_->insert(spaceId_,
+                       partId_,
+                       vId_,
+                       edgeType_,
+                       std::make_shared<const std::string>(std::move(buffer_)),
+                       version_);
+      }
+      return;
+    }
+    AdjacencyList::append(buffer_, iter_->key(), iter_->val());
+    ++count_;
+    if (buffer_.size() > cache_->entryCapacity()) {
+      // Too large to be cached, stop recording
+      aborted_ = true;
+      buffer_.clear();
+      buffer_.shrink_to_fit();
+    }
+  }
+
+  std::unique_ptr<kvstore::KVIterator> iter_;
+  VertexCache* cache_;
+  GraphSpaceID spaceId_;
+  PartitionID partId_;
+  VertexID vId_;
+  EdgeType edgeType_;
+  uint64_t version_;
+  size_t minDegree_;
+
+  bool aborted_{false};
+  size_t count_{0};
+  std::string buffer_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // STORAGE_CACHE_ADJACENCYLIST_H_
@@ -0,0 +1,209 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/cache/VertexCache.h"
+
+#include "common/base/MurmurHash2.h"
+
+namespace nebula {
+namespace storage {
+
+// Approximate memory used by the list node and the hash map slot of an entry
+static constexpr size_t kEntryOverhead = 64;
+// Approximate memory used by each cached schema besides the data
+static constexpr size_t kDataOverhead = sizeof(std::pair<TagID, std::string>) + 16;
+
+VertexCache::VertexCache(size_t capacity, uint32_t bucketsExp)
+    : bucketCapacity_(capacity >> bucketsExp), bucketsExp_(bucketsExp) {}
+
+std::shared_ptr<const std::string> VertexCache::get(GraphSpaceID spaceId,
+                                                    PartitionID partId,
+                                                    const VertexID& vId,
+                                                    TagID schemaId,
+                                                    uint64_t* version) {
+  auto space = getSpace(spaceId, true);
+  auto k = key(partId, vId);
+  auto& b = bucket(*space, k);
+  folly::SharedMutex::ReadHolder guard(b.lock);
+  *version = b.version;
+  auto iter = b.index.find(k);
+  if (iter == b.index.end()) {
+    return nullptr;
+  }
+  auto& entry = *iter->second;
+  for (const auto& data : entry.data) {
+    if (data.first == schemaId) {
+      entry.referenced.store(true, std::memory_order_relaxed);
+      return data.second;
+    }
+  }
+  return nullptr;
+}
+
+void VertexCache::insert(GraphSpaceID spaceId,
+                         PartitionID partId,
+                         const VertexID& vId,
+                         TagID schemaId,
+                         std::shared_ptr<const std::string> data,
+                         uint64_t version) {
+  auto space = getSpace(spaceId, true);
+  auto k = key(partId, vId);
+  auto& b = bucket(*space, k);
+  auto bytes = data->size() + kDataOverhead;
+  if (bytes + k.size() + kEntryOverhead > bucketCapacity_) {
+    return;
+  }
+  folly::SharedMutex::WriteHolder guard(b.lock);
+  if (b.version != version) {
+    // Some vertex in the bucket has been evicted since the row was read, the row may be stale
+    return;
+  }
+  auto iter = b.index.find(k);
+  if (iter == b.index.end()) {
+    // Inserted behind the hand, so it's checked last
+    auto entry = b.entries.emplace(b.hand);
+    entry->partId = partId;
+    entry->key = std::move(k);
+    entry->bytes = entry->key.size() + kEntryOverhead;
+    b.bytes += entry->bytes;
+    iter = b.index.emplace(entry->key, entry).first;
+  } else {
+    iter->second->referenced.store(true, std::memory_order_relaxed);
+  }
+  auto& entry = *iter->second;
+  for (const auto& it : entry.data) {
+    if (it.first == schemaId) {
+      return;
+    }
+  }
+  entry.data.emplace_back(schemaId, std::move(data));
+  entry.bytes += bytes;
+  b.bytes += bytes;
+  shrink(b);
+}
+
+void VertexCache::evict(GraphSpaceID spaceId, PartitionID partId, const VertexID& vId) {
+  auto space = getSpace(spaceId, false);
+  if (space == nullptr) {
+    return;
+  }
+  auto k = key(partId, vId);
+  auto& b = bucket(*space, k);
+  folly::SharedMutex::WriteHolder guard(b.lock);
+  ++b.version;
+  auto iter = b.index.find(k);
+  if (iter != b.index.end()) {
+    erase(b, iter->second);
+  }
+}
+
+void VertexCache::evictPart(GraphSpaceID spaceId, PartitionID partId) {
+  auto space = getSpace(spaceId, false);
+  if (space == nullptr) {
+    return;
+  }
+  for (auto& b : space->buckets) {
+    folly::SharedMutex::WriteHolder guard(b.lock);
+    ++b.version;
+    for (auto iter = b.entries.begin(); iter != b.entries.end();) {
+      auto curr = iter++;
+      if (curr->partId == partId) {
+        erase(b, curr);
+      }
+    }
+  }
+}
+
+void VertexCache::clearSpace(GraphSpaceID spaceId) {
+  std::shared_ptr<SpaceCache> space;
+  {
+    folly::RWSpinLock::WriteHolder wh(lock_);
+    auto iter = spaces_.find(spaceId);
+    if (iter == spaces_.end()) {
+      return;
+    }
+    space = std::move(iter->second);
+    spaces_.erase(iter);
+  }
+  // The readers holding the old space could still insert into it, which is harmless since it's
+  // not reachable any more. Bump the versions anyway so they give up early.
+  for (auto& b : space->buckets) {
+    folly::SharedMutex::WriteHolder guard(b.lock);
+    ++b.version;
+  }
+}
+
+size_t VertexCache::usage(GraphSpaceID spaceId) {
+  auto space = getSpace(spaceId, false);
+  if (space == nullptr) {
+    return 0;
+  }
+  size_t bytes = 0;
+  for (auto& b : space->buckets) {
+    folly::SharedMutex::ReadHolder guard(b.lock);
+    bytes += b.bytes;
+  }
+  return bytes;
+}
+
+std::shared_ptr<VertexCache::SpaceCache> VertexCache::getSpace(GraphSpaceID spaceId,
+                                                               bool create) {
+  {
+    folly::RWSpinLock::ReadHolder rh(lock_);
+    auto iter = spaces_.find(spaceId);
+    if (iter != spaces_.end()) {
+      return iter->second;
+    }
+  }
+  if (!create) {
+    return nullptr;
+  }
+  folly::RWSpinLock::WriteHolder wh(lock_);
+  auto& space = spaces_[spaceId];
+  if (space == nullptr) {
+    space = std::make_shared<SpaceCache>(1UL << bucketsExp_);
+  }
+  return space;
+}
+
+// static
+std::string VertexCache::key(PartitionID partId, const VertexID& vId) {
+  std::string k;
+  k.reserve(sizeof(PartitionID) + vId.size());
+  k.append(reinterpret_cast<const char*>(&partId), sizeof(PartitionID)).append(vId);
+  return k;
+}
+
+VertexCache::Bucket& VertexCache::bucket(SpaceCache& space, const std::string& k) {
+  auto hash = MurmurHash2()(k.data(), k.size());
+  return space.buckets[hash & ((1UL << bucketsExp_) - 1)];
+}
+
+void VertexCache::shrink(Bucket& b) {
+  while (b.bytes > bucketCapacity_ && !b.entries.empty()) {
+    if (b.hand == b.entries.end()) {
+      b.hand = b.entries.begin();
+    }
+    // A referenced entry gets a second chance
+    if (b.hand->referenced.exchange(false, std::memory_order_relaxed)) {
+      ++b.hand;
+    } else {
+      erase(b, b.hand);
+    }
+  }
+}
+
+// static
+void VertexCache::erase(Bucket& b, std::list<Entry>::iterator iter) {
+  if (b.hand == iter) {
+    ++b.hand;
+  }
+  b.bytes -= iter->bytes;
+  b.index.erase(iter->key);
+  b.entries.erase(iter);
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,141 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_CACHE_VERTEXCACHE_H_
+#define STORAGE_CACHE_VERTEXCACHE_H_
+
+#include <folly/RWSpinLock.h>
+#include <folly/SharedMutex.h>
+
+#include <list>
+
+#include "common/base/Base.h"
+#include "common/thrift/ThriftTypes.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief Cache the encoded data of hot vertices by schema id, so that reading them
+ * doesn't need to access kvstore. It's used for the tag rows of vertices, and the
+ * adjacency lists of supernodes of each edge type.
+ *
+ * The entries are grouped by vertex, each space has its own buckets limited by memory
+ * in bytes. The buckets are evicted in CLOCK order: a hit only marks the entry as
+ * referenced, so the readers share the lock of the bucket and never reorder it, and
+ * the eviction gives the referenced entries a second chance. A write must evict the
+ * vertex after it's committed. To avoid
+ * inserting a row read before the write but inserted after the eviction, the
+ * reader gets a version from get() before the lookup, and insert() is ignored if
+ * any eviction happens in the bucket since then.
+ */
+class VertexCache final {
+ public:
+  /**
+   * @brief Construct a new Vertex Cache object
+   *
+   * @param capacity Memory limit of each space in bytes
+   * @param bucketsExp There are 2^bucketsExp buckets for each space
+   */
+  explicit VertexCache(size_t capacity, uint32_t bucketsExp = 4);
+
+  /**
+   * @brief Get the data of the vertex under the schema, return nullptr if missed.
+   *
+   * @param schemaId Tag id or edge type
+   * @param version Version of the bucket, should be passed to insert() when missed
+   */
+  std::shared_ptr<const std::string> get(GraphSpaceID spaceId,
+                                         PartitionID partId,
+                                         const VertexID& vId,
+                                         TagID schemaId,
+                                         uint64_t* version);
+
+  /**
+   * @brief Insert the data read from kvstore, unless the vertex is evicted since get()
+   */
+  void insert(GraphSpaceID spaceId,
+              PartitionID partId,
+              const VertexID& vId,
+              TagID schemaId,
+              std::shared_ptr<const std::string> data,
+              uint64_t version);
+
+  /**
+   * @brief Evict all data of the vertex
+   */
+  void evict(GraphSpaceID spaceId, PartitionID partId, const VertexID& vId);
+
+  /**
+   * @brief Evict all vertices of the part, e.g. when the part becomes leader again
+   * since the writes applied as a follower don't evict the cache.
+   */
+  void evictPart(GraphSpaceID spaceId, PartitionID partId);
+
+  /**
+   * @brief Evict all vertices of the space
+   */
+  void clearSpace(GraphSpaceID spaceId);
+
+  /**
+   * @brief Memory used by the space in bytes
+   */
+  size_t usage(GraphSpaceID spaceId);
+
+  /**
+   * @brief Max bytes of data could be cached for one vertex
+   */
+  size_t entryCapacity() const {
+    return bucketCapacity_;
+  }
+
+ private:
+  struct Entry {
+    PartitionID partId{0};
+    // partId + vId
+    std::string key;
+    std::vector<std::pair<TagID, std::shared_ptr<const std::string>>> data;
+    size_t bytes{0};
+    // Set by the hits, and cleared when the clock hand passes
+    std::atomic<bool> referenced{false};
+  };
+
+  struct Bucket {
+    // Shared by the readers, which only set the referenced flags
+    folly::SharedMutex lock;
+    std::list<Entry> entries;
+    // The next entry to check for eviction, the new entries are inserted right before it
+    std::list<Entry>::iterator hand{entries.end()};
+    std::unordered_map<folly::StringPiece, std::list<Entry>::iterator> index;
+    size_t bytes{0};
+    uint64_t version{0};
+  };
+
+  struct SpaceCache {
+    explicit SpaceCache(size_t num) : buckets(num) {}
+    std::vector<Bucket> buckets;
+  };
+
+  std::shared_ptr<SpaceCache> getSpace(GraphSpaceID spaceId, bool create);
+
+  static std::string key(PartitionID partId, const VertexID& vId);
+
+  Bucket& bucket(SpaceCache& space, const std::string& key);
+
+  // Remove the entries not referenced since the hand passed until the bucket fits the capacity
+  void shrink(Bucket& bucket);
+
+  static void erase(Bucket& bucket, std::list<Entry>::iterator iter);
+
+  size_t bucketCapacity_;
+  uint32_t bucketsExp_;
+  folly::RWSpinLock lock_;
+  std::unordered_map<GraphSpaceID, std::shared_ptr<SpaceCache>> spaces_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // STORAGE_CACHE_VERTEXCACHE_H_
@@ -14,7 +14,7 @@ namespace nebula {
 namespace storage {
 
 Value StorageExpressionContext::readValue(const std::string& propName) const {
-  if (!schema_) {
+  if (!schema_ || reader_ == nullptr) {
     return Value::kNullValue;
   }
 
@@ -41,7 +41,7 @@ Value StorageExpressionContext::getEdgeProp(const std::string& edgeName,
   if (isIndex_) {
     return getIndexValue(prop, true);
   }
-  if (isEdge_ && reader_ != nullptr) {
+  if (isEdge_ && (reader_ != nullptr || keyOnly_)) {
     if (edgeName != name_) {
       return Value::kEmpty;
     }
@@ -214,6 +214,19 @@ class StorageExpressionContext final : public ExpressionContext {
   void reset(RowReader* reader, const std::string& key) {
     reader_ = reader;
     key_ = key;
+    keyOnly_ = false;
+  }
+
+  /**
+   * @brief Reset the edge key when only the props in key are read, e.g. _src, _dst, _rank and
+   * _type, so that they could be filtered before decoding the value. The props in value are null.
+   *
+   * @param key Edge key to reset.
+   */
+  void resetEdgeKey(folly::StringPiece key) {
+    reader_ = nullptr;
+    key_.assign(key.data(), key.size());
+    keyOnly_ = true;
   }
 
   /**
@@ -222,6 +235,7 @@ class StorageExpressionContext final : public ExpressionContext {
    */
   void reset() {
     reader_ = nullptr;
+    keyOnly_ = false;
     key_ = "";
     name_ = "";
     schema_ = nullptr;
@@ -294,6 +308,8 @@ class StorageExpressionContext final : public ExpressionContext {
 
   RowReader* reader_{nullptr};
   std::string key_;
+  // only the props in edge key could be read
+  bool keyOnly_{false};
   // tag or edge name
   std::string name_;
   // tag or edge latest schema
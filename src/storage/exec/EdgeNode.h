@@ -7,8 +7,11 @@
 #define STORAGE_EXEC_EDGENODE_H_
 
 #include "common/base/Base.h"
+#include "storage/StorageFlags.h"
+#include "storage/cache/AdjacencyList.h"
 #include "storage/exec/RelNode.h"
 #include "storage/exec/StorageIterator.h"
+#include "storage/stats/StorageStats.h"
 
 namespace nebula {
 namespace storage {
@@ -34,6 +37,19 @@ class EdgeNode : public IterateNode<T> {
     return edgeType_;
   }
 
+  /**
+   * @brief Check whether the edge could pass the filter only on the props in key, so that the
+   * value of the edges filtered out are not decoded
+   */
+  bool checkKey(folly::StringPiece key) {
+    if (exp_ == nullptr) {
+      return true;
+    }
+    keyCtx_->resetEdgeKey(key);
+    auto ret = exp_->eval(*keyCtx_).toBool();
+    return ret.isBool() && ret.getBool();
+  }
+
  protected:
   EdgeNode(RuntimeContext* context,
            EdgeContext* edgeContext,
@@ -48,17 +64,21 @@ class EdgeNode : public IterateNode<T> {
         expCtx_(expCtx),
         exp_(exp) {
     UNUSED(expCtx_);
-    UNUSED(exp_);
     auto schemaIter = edgeContext_->schemas_.find(std::abs(edgeType_));
     CHECK(schemaIter != edgeContext_->schemas_.end());
     CHECK(!schemaIter->second.empty());
     schemas_ = &(schemaIter->second);
     ttl_ = QueryUtils::getEdgeTTLInfo(edgeContext_, std::abs(edgeType_));
     edgeName_ = edgeContext_->edgeNames_[edgeType_];
+    if (exp_ != nullptr) {
+      keyCtx_ = std::make_unique<StorageExpressionContext>(
+          context_->vIdLen(), context_->isIntId(), edgeName_, schemas_->back().get(), true);
+    }
     IterateNode<T>::name_ = "EdgeNode";
   }
 
-  EdgeNode(RuntimeContext* context, EdgeContext* ctx) : context_(context), edgeContext_(ctx) {
+  EdgeNode(RuntimeContext* context, EdgeContext* ctx)
+      : context_(context), edgeContext_(ctx), expCtx_(nullptr), exp_(nullptr) {
     IterateNode<T>::name_ = "EdgeNode";
   }
 
@@ -67,7 +87,9 @@ class EdgeNode : public IterateNode<T> {
   EdgeType edgeType_;
   const std::vector<PropContext>* props_;
   StorageExpressionContext* expCtx_;
+  // The filter only on the props in edge key, e.g. _src, _dst, _rank and _type
   Expression* exp_;
+  std::unique_ptr<StorageExpressionContext> keyCtx_;
 
   const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>* schemas_ = nullptr;
   std::optional<std::pair<std::string, int64_t>> ttl_;
@@ -127,7 +149,8 @@ class FetchEdgeNode final : public EdgeNode<cpp2::EdgeKey> {
                                    *edgeKey.edge_type_ref(),
                                    *edgeKey.ranking_ref(),
                                    (*edgeKey.dst_ref()).getStr());
-    ret = context_->env()->kvstore_->get(context_->spaceId(), partId, key_, &val_);
+    ret = context_->env()->kvstore_->get(
+        context_->spaceId(), partId, key_, &val_, context_->readFromFollower(partId));
     if (ret == nebula::cpp2::ErrorCode::SUCCEEDED) {
       return doExecute(key_, val_);
     } else if (ret == nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
@@ -153,6 +176,11 @@ class FetchEdgeNode final : public EdgeNode<cpp2::EdgeKey> {
 
  private:
   void resetReader() {
+    if (ttl_.has_value() && CommonUtils::checkRowExpiredForTTL(
+                                schemas_->back().get(), val_, ttl_.value().second)) {
+      reader_.reset();
+      return;
+    }
     reader_.reset(*schemas_, val_);
     if (!reader_ ||
         (ttl_.has_value() &&
@@ -171,7 +199,8 @@ class FetchEdgeNode final : public EdgeNode<cpp2::EdgeKey> {
 };
 
 // SingleEdgeNode is used to scan all edges of a specified edgeType of the same
-// srcId
+// srcId. If keyOnly is set, i.e. only the props in edge key are read, the values are not loaded,
+// which saves reading the blobs when the values are separated.
 class SingleEdgeNode final : public EdgeNode<VertexID> {
  public:
   using RelNode::doExecute;
@@ -180,9 +209,12 @@ class SingleEdgeNode final : public EdgeNode<VertexID> {
                  EdgeType edgeType,
                  const std::vector<PropContext>* props,
                  StorageExpressionContext* expCtx = nullptr,
-                 Expression* exp = nullptr)
+                 Expression* exp = nullptr,
+                 bool keyOnly = false)
       : EdgeNode(context, edgeContext, edgeType, props, expCtx, exp) {
     name_ = "SingleEdgeNode";
+    // The value is needed to check the ttl
+    keyOnly_ = keyOnly && !ttl_.has_value();
   }
 
   SingleEdgeIterator* iter() {
@@ -195,6 +227,9 @@ class SingleEdgeNode final : public EdgeNode<VertexID> {
 
   void next() override {
     iter_->next();
+    if (iter_->valid()) {
+      rows_++;
+    }
   }
 
   folly::StringPiece key() const override {
@@ -209,6 +244,10 @@ class SingleEdgeNode final : public EdgeNode<VertexID> {
     return iter_->reader();
   }
 
+  std::map<std::string, int64_t> profileStats() const override {
+    return {{"decode_us", static_cast<int64_t>(decodeDuration_.elapsedInUSec())}};
+  }
+
   nebula::cpp2::ErrorCode doExecute(PartitionID partId, const VertexID& vId) override {
     auto ret = RelNode::doExecute(partId, vId);
     if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -218,10 +257,63 @@ class SingleEdgeNode final : public EdgeNode<VertexID> {
     VLOG(1) << "partId " << partId << ", vId " << vId << ", edgeType " << edgeType_
             << ", prop size " << props_->size();
     std::unique_ptr<kvstore::KVIterator> iter;
+    // The cache is only evicted by the writes on the leader, so it is bypassed on followers
+    auto readFromFollower = context_->readFromFollower(partId);
+    auto* adjacencyCache = readFromFollower ? nullptr : context_->env()->adjacencyCache_.get();
+    uint64_t version = 0;
+    if (adjacencyCache != nullptr) {
+      auto edges = adjacencyCache->get(context_->spaceId(), partId, vId, edgeType_, &version);
+      if (edges != nullptr) {
+        stats::StatsManager::addValue(kNumAdjacencyCacheHits);
+        iter_.reset(new SingleEdgeIterator(context_,
+                                           std::make_unique<AdjacencyListIterator>(edges),
+                                           edgeType_,
+                                           schemas_,
+                                           &ttl_,
+                                           keyCtx_.get(),
+                                           exp_,
+                                           keyOnly_,
+                                           profile_ ? &decodeDuration_ : nullptr));
+        if (iter_->valid()) {
+          rows_++;
+        }
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+      }
+      stats::StatsManager::addValue(kNumAdjacencyCacheMisses);
+    }
     prefix_ = NebulaKeyUtils::edgePrefix(context_->vIdLen(), partId, vId, edgeType_);
-    ret = context_->env()->kvstore_->prefix(context_->spaceId(), partId, prefix_, &iter);
+    ret = context_->env()->kvstore_->prefix(
+        context_->spaceId(), partId, prefix_, &iter, readFromFollower);
+    // The recorder reads the values to fill the cache
+    if (ret == nebula::cpp2::ErrorCode::SUCCEEDED && iter && iter->valid() &&
+        adjacencyCache != nullptr && !keyOnly_) {
+      // The edges of a vertex read often are cached even if it has fewer of them
+      auto* hotKeys = context_->env()->hotKeys_;
+      auto minDegree = hotKeys != nullptr && hotKeys->isHotVertex(context_->spaceId(), partId, vId)
+                           ? FLAGS_adjacency_cache_hot_min_degree
+                           : FLAGS_adjacency_cache_min_degree;
+      iter = std::make_unique<AdjacencyListRecorder>(std::move(iter),
+                                                     adjacencyCache,
+                                                     context_->spaceId(),
+                                                     partId,
+                                                     vId,
+                                                     edgeType_,
+                                                     version,
+                                                     minDegree);
+    }
     if (ret == nebula::cpp2::ErrorCode::SUCCEEDED && iter && iter->valid()) {
-      iter_.reset(new SingleEdgeIterator(context_, std::move(iter), edgeType_, schemas_, &ttl_));
+      iter_.reset(new SingleEdgeIterator(context_,
+                                         std::move(iter),
+                                         edgeType_,
+                                         schemas_,
+                                         &ttl_,
+                                         keyCtx_.get(),
+                                         exp_,
+                                         keyOnly_,
+                                         profile_ ? &decodeDuration_ : nullptr));
+      if (iter_->valid()) {
+        rows_++;
+      }
     } else {
       iter_.reset();
     }
@@ -231,6 +323,8 @@ class SingleEdgeNode final : public EdgeNode<VertexID> {
  private:
   std::unique_ptr<SingleEdgeIterator> iter_;
   std::string prefix_;
+  bool keyOnly_{false};
+  time::Duration decodeDuration_{true};
 };
 
 }  // namespace storage
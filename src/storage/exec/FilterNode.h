@@ -8,6 +8,7 @@
 
 #include "common/base/Base.h"
 #include "common/expression/Expression.h"
+#include "common/expression/ExpressionProgram.h"
 #include "storage/context/StorageExpressionContext.h"
 #include "storage/exec/HashJoinNode.h"
 
@@ -40,7 +41,11 @@ class FilterNode : public IterateNode<T> {
              IterateNode<T>* upstream,
              StorageExpressionContext* expCtx = nullptr,
              Expression* exp = nullptr)
-      : IterateNode<T>(upstream), context_(context), expCtx_(expCtx), filterExp_(exp) {
+      : IterateNode<T>(upstream),
+        context_(context),
+        expCtx_(expCtx),
+        filterExp_(exp),
+        program_(ExpressionProgram::compile(exp)) {
     IterateNode<T>::name_ = "FilterNode";
   }
 
@@ -68,8 +73,27 @@ class FilterNode : public IterateNode<T> {
     mode_ = mode;
   }
 
+  std::map<std::string, int64_t> profileStats() const override {
+    return {{"rows_in", rowsIn_},
+            {"filter_us", static_cast<int64_t>(filterDuration_.elapsedInUSec())}};
+  }
+
  private:
   bool check() override {
+    if (UNLIKELY(this->profile_)) {
+      filterDuration_.resume();
+      auto ret = doCheck();
+      filterDuration_.pause();
+      rowsIn_++;
+      if (ret) {
+        this->rows_++;
+      }
+      return ret;
+    }
+    return doCheck();
+  }
+
+  bool doCheck() {
     if (filterExp_ == nullptr) {
       return true;
     }
@@ -83,8 +107,12 @@ class FilterNode : public IterateNode<T> {
     }
   }
 
+  const Value& evalFilter() {
+    return program_ != nullptr ? program_->eval(*expCtx_) : filterExp_->eval(*expCtx_);
+  }
+
   bool checkTagOnly() {
-    auto result = filterExp_->eval(*expCtx_);
+    const auto& result = evalFilter();
     // NULL is always false
     auto ret = result.toBool();
     return ret.isBool() && ret.getBool();
@@ -94,7 +122,7 @@ class FilterNode : public IterateNode<T> {
   bool checkTagAndEdge() {
     expCtx_->reset(this->reader(), this->key().str());
     // result is false when filter out
-    auto result = filterExp_->eval(*expCtx_);
+    const auto& result = evalFilter();
     // NULL is always false
     auto ret = result.toBool();
     return ret.isBool() && ret.getBool();
@@ -104,8 +132,11 @@ class FilterNode : public IterateNode<T> {
   RuntimeContext* context_;
   StorageExpressionContext* expCtx_;
   Expression* filterExp_;
+  std::unique_ptr<ExpressionProgram> program_;
   FilterMode mode_{FilterMode::TAG_AND_EDGE};
   int32_t callCheck{0};
+  int64_t rowsIn_{0};
+  time::Duration filterDuration_{true};
 };
 
 }  // namespace storage
@@ -11,6 +11,7 @@
 #include "storage/StorageFlags.h"
 #include "storage/exec/AggregateNode.h"
 #include "storage/exec/HashJoinNode.h"
+#include "storage/exec/IndexTopNNode.h"
 
 namespace nebula {
 namespace storage {
@@ -66,8 +67,9 @@ class GetNeighborsNode : public QueryNode<VertexID> {
     }
 
     // add default null for each edge node and the last column of yield
-    // expression
-    row.resize(row.size() + edgeContext_->propContexts_.size() + 1, Value());
+    // expression, there is no edge column if only the stats are returned
+    auto edgeColumns = edgeContext_->statsOnly_ ? 0 : edgeContext_->propContexts_.size();
+    row.resize(row.size() + edgeColumns + 1, Value());
 
     ret = iterateEdges(row);
     if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -86,6 +88,7 @@ class GetNeighborsNode : public QueryNode<VertexID> {
     // so if it it an edge, this test is always true
     if (!context_->filterInvalidResultOut || context_->resultStat_ == ResultStatus::NORMAL) {
       resultDataSet_->rows.emplace_back(std::move(row));
+      rows_++;
     }
 
     return nebula::cpp2::ErrorCode::SUCCEEDED;
@@ -107,6 +110,10 @@ class GetNeighborsNode : public QueryNode<VertexID> {
       if (edgeRowCount >= limit_) {
         return nebula::cpp2::ErrorCode::SUCCEEDED;
       }
+      if (edgeContext_->statsOnly_) {
+        // the stats are collected by AggregateNode in `next`, no prop need to return
+        continue;
+      }
       auto key = upstream_->key();
       auto reader = upstream_->reader();
       auto props = context_->props_;
@@ -114,8 +121,15 @@ class GetNeighborsNode : public QueryNode<VertexID> {
 
       list.reserve(props->size());
       // collect props need to return
-      if (!QueryUtils::collectEdgeProps(
-               key, context_->vIdLen(), context_->isIntId(), reader, props, list)
+      if (!QueryUtils::collectEdgeProps(key,
+                                        context_->vIdLen(),
+                                        context_->isIntId(),
+                                        reader,
+                                        props,
+                                        list,
+                                        nullptr,
+                                        "",
+                                        &projections_)
                .ok()) {
         return nebula::cpp2::ErrorCode::E_EDGE_PROP_NOT_FOUND;
       }
@@ -136,6 +150,7 @@ class GetNeighborsNode : public QueryNode<VertexID> {
   EdgeContext* edgeContext_;
   nebula::DataSet* resultDataSet_;
   int64_t limit_;
+  PropProjections projections_;
 };
 
 class GetNeighborsSampleNode : public GetNeighborsNode {
@@ -145,8 +160,10 @@ class GetNeighborsSampleNode : public GetNeighborsNode {
                          IterateNode<VertexID>* upstream,
                          EdgeContext* edgeContext,
                          nebula::DataSet* resultDataSet,
-                         int64_t limit)
-      : GetNeighborsNode(context, hashJoinNode, upstream, edgeContext, resultDataSet, limit) {
+                         int64_t limit,
+                         std::vector<int64_t>* degrees = nullptr)
+      : GetNeighborsNode(context, hashJoinNode, upstream, edgeContext, resultDataSet, limit),
+        degrees_(degrees) {
     sampler_ = std::make_unique<nebula::algorithm::ReservoirSampling<Sample>>(limit);
   }
 
@@ -194,10 +211,142 @@ class GetNeighborsSampleNode : public GetNeighborsNode {
       cell.values.emplace_back(std::move(list));
     }
 
+    // the degree of each returned row, used to split the edge budget of the request
+    if (degrees_ != nullptr) {
+      degrees_->emplace_back(edgeRowCount);
+    }
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   }
 
   std::unique_ptr<nebula::algorithm::ReservoirSampling<Sample>> sampler_;
+  std::vector<int64_t>* degrees_;
+};
+
+// GetNeighborsTopNNode keeps the top N edges of all vertices of a part by the order by
+// expressions in a bounded heap, rather than the first N edges of each vertex. The rows of the
+// vertices are pending until `finish` is called after the last vertex of the part, then the top
+// edges are put into the rows, and the rows with any edge are appended to the result.
+class GetNeighborsTopNNode : public GetNeighborsNode {
+ public:
+  using OrderBy = std::pair<Expression*, cpp2::OrderDirection>;
+
+  GetNeighborsTopNNode(RuntimeContext* context,
+                       IterateNode<VertexID>* hashJoinNode,
+                       IterateNode<VertexID>* upstream,
+                       EdgeContext* edgeContext,
+                       nebula::DataSet* resultDataSet,
+                       StorageExpressionContext* expCtx,
+                       const std::vector<OrderBy>* orderBy,
+                       int64_t limit)
+      : GetNeighborsNode(context, hashJoinNode, upstream, edgeContext, &pending_, limit),
+        output_(resultDataSet),
+        expCtx_(expCtx),
+        orderBy_(orderBy) {
+    name_ = "GetNeighborsTopNNode";
+    heap_.setHeapSize(limit);
+    heap_.setComparator([this](Edge& lhs, Edge& rhs) {
+      for (size_t i = 0; i < orderBy_->size(); i++) {
+        const auto& lValue = std::get<0>(lhs)[i];
+        const auto& rValue = std::get<0>(rhs)[i];
+        if (lValue == rValue) {
+          continue;
+        }
+        if ((*orderBy_)[i].second == cpp2::OrderDirection::ASCENDING) {
+          return lValue < rValue;
+        } else {
+          return lValue > rValue;
+        }
+      }
+      return false;
+    });
+  }
+
+  nebula::cpp2::ErrorCode finish() {
+    RowReaderWrapper reader;
+    nebula::List list;
+    auto edges = heap_.moveTopK();
+    heap_.setHeapSize(limit_);
+    for (auto& edge : edges) {
+      auto& row = pending_.rows[std::get<1>(edge)].values;
+      auto columnIdx = std::get<2>(edge);
+      auto edgeType = std::get<3>(edge);
+      const auto& key = std::get<4>(edge);
+      const auto& val = std::get<5>(edge);
+      reader = RowReaderWrapper::getEdgePropReader(
+          context_->env()->schemaMan_, context_->spaceId(), std::abs(edgeType), val);
+      if (!reader) {
+        continue;
+      }
+      if (!QueryUtils::collectEdgeProps(
+               key, context_->vIdLen(), context_->isIntId(), reader.get(), std::get<6>(edge), list)
+               .ok()) {
+        return nebula::cpp2::ErrorCode::E_EDGE_PROP_NOT_FOUND;
+      }
+      if (row[columnIdx].empty()) {
+        row[columnIdx].setList(nebula::List());
+      }
+      row[columnIdx].mutableList().values.emplace_back(std::move(list));
+    }
+
+    // the edge columns are between the tag columns and the last column of yield expression
+    auto first = edgeContext_->offset_;
+    auto last = first + edgeContext_->propContexts_.size();
+    for (auto& row : pending_.rows) {
+      auto& values = row.values;
+      if (edgeContext_->statCount_ > 0 ||
+          std::any_of(values.begin() + first, values.begin() + last, [](const auto& v) {
+            return v.isList();
+          })) {
+        output_->rows.emplace_back(std::move(row));
+      }
+    }
+    pending_.rows.clear();
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+ private:
+  // sort keys, row index, column index, edge type, key, value and props to return
+  using Edge = std::tuple<std::vector<Value>,
+                          size_t,
+                          size_t,
+                          EdgeType,
+                          std::string,
+                          std::string,
+                          const std::vector<PropContext>*>;
+
+  nebula::cpp2::ErrorCode iterateEdges(std::vector<Value>&) override {
+    if (limit_ <= 0) {
+      return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+    for (; upstream_->valid(); upstream_->next()) {
+      if (context_->isPlanKilled()) {
+        return nebula::cpp2::ErrorCode::E_PLAN_IS_KILLED;
+      }
+      auto key = upstream_->key();
+      auto reader = upstream_->reader();
+      expCtx_->reset(reader, key.str());
+      std::vector<Value> sortKeys;
+      sortKeys.reserve(orderBy_->size());
+      for (const auto& orderBy : *orderBy_) {
+        sortKeys.emplace_back(orderBy.first->eval(*expCtx_));
+      }
+      // the row of current vertex will be the next pending row
+      heap_.push(std::make_tuple(std::move(sortKeys),
+                                 pending_.rows.size(),
+                                 context_->columnIdx_,
+                                 context_->edgeType_,
+                                 key.str(),
+                                 upstream_->val().str(),
+                                 context_->props_));
+    }
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+  nebula::DataSet pending_;
+  nebula::DataSet* output_;
+  StorageExpressionContext* expCtx_;
+  const std::vector<OrderBy>* orderBy_;
+  TopNHeap<Edge> heap_;
 };
 
 }  // namespace storage
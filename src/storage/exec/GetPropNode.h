@@ -83,8 +83,15 @@ class GetTagPropNode : public QueryNode<VertexID> {
               folly::StringPiece key,
               RowReader* reader,
               const std::vector<PropContext>* props) -> nebula::cpp2::ErrorCode {
-            auto status = QueryUtils::collectVertexProps(
-                key, vIdLen, isIntId, reader, props, row, expCtx_.get(), tagNode->getTagName());
+            auto status = QueryUtils::collectVertexProps(key,
+                                                         vIdLen,
+                                                         isIntId,
+                                                         reader,
+                                                         props,
+                                                         row,
+                                                         expCtx_.get(),
+                                                         tagNode->getTagName(),
+                                                         &projections_);
             if (!status.ok()) {
               return nebula::cpp2::ErrorCode::E_TAG_PROP_NOT_FOUND;
             }
@@ -110,6 +117,7 @@ class GetTagPropNode : public QueryNode<VertexID> {
   std::unique_ptr<StorageExpressionContext> expCtx_{nullptr};
   Expression* filter_{nullptr};
   const std::size_t limit_{std::numeric_limits<std::size_t>::max()};
+  PropProjections projections_;
 };
 
 class GetEdgePropNode : public QueryNode<cpp2::EdgeKey> {
@@ -161,8 +169,15 @@ class GetEdgePropNode : public QueryNode<cpp2::EdgeKey> {
               folly::StringPiece key,
               RowReader* reader,
               const std::vector<PropContext>* props) -> nebula::cpp2::ErrorCode {
-            auto status = QueryUtils::collectEdgeProps(
-                key, vIdLen, isIntId, reader, props, row, expCtx_.get(), edgeNode->getEdgeName());
+            auto status = QueryUtils::collectEdgeProps(key,
+                                                       vIdLen,
+                                                       isIntId,
+                                                       reader,
+                                                       props,
+                                                       row,
+                                                       expCtx_.get(),
+                                                       edgeNode->getEdgeName(),
+                                                       &projections_);
             if (!status.ok()) {
               return nebula::cpp2::ErrorCode::E_TAG_PROP_NOT_FOUND;
             }
@@ -188,6 +203,7 @@ class GetEdgePropNode : public QueryNode<cpp2::EdgeKey> {
   std::unique_ptr<StorageExpressionContext> expCtx_{nullptr};
   Expression* filter_{nullptr};
   const std::size_t limit_{std::numeric_limits<std::size_t>::max()};
+  PropProjections projections_;
 };
 
 }  // namespace storage
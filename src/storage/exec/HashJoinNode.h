@@ -18,8 +18,9 @@ namespace storage {
 // HashJoinNode has input of several TagNode and EdgeNode, the EdgeNode is
 // several SingleEdgeNode of different edge types all edges of a vertex. The
 // output would be the result of tag, it is a List, each cell save a list of
-// property values, if tag not found, it will be a empty value. Also it will
-// return a iterator of edges which can pass ttl check and ready to be read.
+// property values, or the encoded row if the request asks for the encoded rows,
+// if tag not found, it will be a empty value. Also it will return a iterator of
+// edges which can pass ttl check and ready to be read.
 class HashJoinNode : public IterateNode<VertexID> {
  public:
   using RelNode::doExecute;
@@ -69,9 +70,28 @@ class HashJoinNode : public IterateNode<VertexID> {
               folly::StringPiece key,
               RowReader* reader,
               const std::vector<PropContext>* props) -> nebula::cpp2::ErrorCode {
+            const auto& tagName = tagNode->getTagName();
+            if (context_->encodedRows()) {
+              // Only the props of the filter are decoded, the returned ones are decoded by the
+              // client from the row when they are read
+              if (expCtx_ != nullptr) {
+                for (const auto& prop : *props) {
+                  if (!prop.filtered_) {
+                    continue;
+                  }
+                  auto value = QueryUtils::readVertexProp(
+                      key, context_->vIdLen(), context_->isIntId(), reader, prop);
+                  if (!value.ok()) {
+                    return nebula::cpp2::ErrorCode::E_TAG_PROP_NOT_FOUND;
+                  }
+                  expCtx_->setTagProp(tagName, prop.name_, std::move(value).value());
+                }
+              }
+              result.values.emplace_back(reader->getRawData().str());
+              return nebula::cpp2::ErrorCode::SUCCEEDED;
+            }
             nebula::List list;
             list.reserve(props->size());
-            const auto& tagName = tagNode->getTagName();
             auto status = QueryUtils::collectVertexProps(key,
                                                          context_->vIdLen(),
                                                          context_->isIntId(),
@@ -79,7 +99,8 @@ class HashJoinNode : public IterateNode<VertexID> {
                                                          props,
                                                          list,
                                                          expCtx_,
-                                                         tagName);
+                                                         tagName,
+                                                         &projections_);
             if (!status.ok()) {
               return nebula::cpp2::ErrorCode::E_TAG_PROP_NOT_FOUND;
             }
@@ -166,6 +187,7 @@ class HashJoinNode : public IterateNode<VertexID> {
   StorageExpressionContext* expCtx_;
 
   std::unique_ptr<MultiEdgeIterator> iter_;
+  PropProjections projections_;
 };
 
 }  // namespace storage
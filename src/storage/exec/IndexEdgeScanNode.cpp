@@ -91,6 +91,10 @@ nebula::cpp2::ErrorCode IndexEdgeScanNode::getBaseData(folly::StringPiece key,
   return kvstore_->get(context_->spaceId(), partId_, kv.first, &kv.second);
 }
 
+folly::StringPiece IndexEdgeScanNode::filteredVid(folly::StringPiece key) {
+  return IndexKeyUtils::getIndexDstId(context_->vIdLen(), key);
+}
+
 Map<std::string, Value> IndexEdgeScanNode::decodeFromBase(const std::string& key,
                                                           const std::string& value) {
   Map<std::string, Value> values;
@@ -31,6 +31,7 @@ class IndexEdgeScanNode : public IndexScanNode {
 
  private:
   Row decodeFromIndex(folly::StringPiece key) override;
+  folly::StringPiece filteredVid(folly::StringPiece key) override;
   nebula::cpp2::ErrorCode getBaseData(folly::StringPiece key,
                                       std::pair<std::string, std::string>& kv) override;
   Map<std::string, Value> decodeFromBase(const std::string& key, const std::string& value) override;
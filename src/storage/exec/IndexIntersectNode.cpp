@@ -0,0 +1,98 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+#include "storage/exec/IndexIntersectNode.h"
+namespace nebula {
+namespace storage {
+IndexIntersectNode::IndexIntersectNode(const IndexIntersectNode& node)
+    : IndexNode(node), keyColumns_(node.keyColumns_), keyPos_(node.keyPos_) {}
+
+IndexIntersectNode::IndexIntersectNode(RuntimeContext* context,
+                                       const std::vector<std::string>& keyColumns)
+    : IndexNode(context, "IndexIntersectNode"), keyColumns_(keyColumns) {}
+
+::nebula::cpp2::ErrorCode IndexIntersectNode::init(InitContext& ctx) {
+  for (auto& col : keyColumns_) {
+    ctx.requiredColumns.insert(col);
+  }
+  // All the children return the same columns, as IndexDedupNode
+  for (size_t i = 0; i < children_.size() - 1; i++) {
+    auto tmp = ctx;
+    auto ret = children_[i]->init(tmp);
+    if (ret != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return ret;
+    }
+  }
+  auto ret = children_.back()->init(ctx);
+  if (ret != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return ret;
+  }
+  for (auto& col : keyColumns_) {
+    keyPos_.push_back(ctx.retColMap[col]);
+  }
+  return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+List IndexIntersectNode::key(const Row& row) const {
+  List values;
+  values.reserve(keyPos_.size());
+  for (auto p : keyPos_) {
+    values.emplace_back(row[p]);
+  }
+  return values;
+}
+
+::nebula::cpp2::ErrorCode IndexIntersectNode::doExecute(PartitionID partId) {
+  keys_.clear();
+  auto ret = IndexNode::doExecute(partId);
+  if (ret != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return ret;
+  }
+  for (size_t i = 1; i < children_.size(); i++) {
+    folly::F14FastSet<List, Hasher> keys;
+    do {
+      auto result = children_[i]->next();
+      if (!result.success()) {
+        return result.code();
+      }
+      if (!result.hasData()) {
+        break;
+      }
+      auto k = key(result.row());
+      if (i == 1 || keys_.count(k) != 0) {
+        keys.emplace(std::move(k));
+      }
+    } while (true);
+    keys_ = std::move(keys);
+    if (keys_.empty()) {
+      break;
+    }
+  }
+  return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+IndexNode::Result IndexIntersectNode::doNext() {
+  while (!keys_.empty()) {
+    auto result = children_.front()->next();
+    if (!result.hasData()) {
+      return result;
+    }
+    // Each key is returned once even if the first child returns it more than once
+    if (keys_.erase(key(result.row())) != 0) {
+      return result;
+    }
+  }
+  return Result();
+}
+
+std::unique_ptr<IndexNode> IndexIntersectNode::copy() {
+  return std::make_unique<IndexIntersectNode>(*this);
+}
+
+std::string IndexIntersectNode::identify() {
+  return fmt::format("{}(intersect=[{}])", name_, folly::join(',', keyColumns_));
+}
+
+}  // namespace storage
+}  // namespace nebula
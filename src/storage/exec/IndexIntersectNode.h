@@ -0,0 +1,59 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+#ifndef STORAGE_EXEC_INDEXINTERSECTNODE_H
+#define STORAGE_EXEC_INDEXINTERSECTNODE_H
+#include "common/datatypes/DataSet.h"
+#include "folly/container/F14Set.h"
+#include "storage/exec/IndexNode.h"
+namespace nebula {
+namespace storage {
+/**
+ *
+ * IndexIntersectNode
+ *
+ * reference: IndexNode, IndexDedupNode
+ *
+ * `IndexIntersectNode` returns the rows of the first child whose keys are returned by all the
+ * children, so the conditions on the different indexes are answered by the scans of the indexes
+ * without accessing the base data. The keys of the other children are collected and intersected
+ * when the part is executed, then the rows of the first child are iterated and qualified.
+ *                   ┌───────────┐
+ *                   │ IndexNode │
+ *                   └─────┬─────┘
+ *                         │
+ *              ┌──────────┴─────────┐
+ *              │ IndexIntersectNode │
+ *              └────────────────────┘
+ * Member:
+ * `keyColumns_`: columns' name which identify a vertex or an edge
+ * `keyPos_`    : key columns' position in child return row
+ * `keys_`      : the keys returned by all the children but the first one, and not returned yet
+ */
+
+class IndexIntersectNode : public IndexNode {
+ public:
+  IndexIntersectNode(const IndexIntersectNode& node);
+  IndexIntersectNode(RuntimeContext* context, const std::vector<std::string>& keyColumns);
+  ::nebula::cpp2::ErrorCode init(InitContext& ctx) override;
+  std::unique_ptr<IndexNode> copy() override;
+  std::string identify() override;
+
+ private:
+  ::nebula::cpp2::ErrorCode doExecute(PartitionID partId) override;
+  Result doNext() override;
+  List key(const Row& row) const;
+  struct Hasher {
+    size_t operator()(const List& key) const {
+      return std::hash<List>()(key);
+    }
+  };
+  std::vector<std::string> keyColumns_;
+  std::vector<size_t> keyPos_;
+  folly::F14FastSet<List, Hasher> keys_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif
@@ -14,7 +14,10 @@ IndexNode::IndexNode(RuntimeContext* context, const std::string& name)
 }
 
 IndexNode::IndexNode(const IndexNode& node)
-    : context_(node.context_), spaceId_(node.spaceId_), name_(node.name_) {}
+    : context_(node.context_),
+      spaceId_(node.spaceId_),
+      name_(node.name_),
+      profileDetail_(node.profileDetail_) {}
 
 nebula::cpp2::ErrorCode IndexNode::doExecute(PartitionID partId) {
   for (auto& child : children_) {
@@ -359,17 +359,29 @@ IndexScanNode::IndexScanNode(const IndexScanNode& node)
       indexId_(node.indexId_),
       index_(node.index_),
       columnHints_(node.columnHints_),
+      subRange_(node.subRange_),
+      extraColumnHints_(node.extraColumnHints_),
+      skipScan_(node.skipScan_),
+      leadingLen_(node.leadingLen_),
       kvstore_(node.kvstore_),
       indexNullable_(node.indexNullable_),
       requiredColumns_(node.requiredColumns_),
       requiredAndHintColumns_(node.requiredAndHintColumns_),
       ttlProps_(node.ttlProps_),
       needAccessBase_(node.needAccessBase_),
+      includedPos_(node.includedPos_),
       colPosMap_(node.colPosMap_) {
-  if (node.path_->isRange()) {
-    path_ = std::make_unique<RangePath>(*dynamic_cast<RangePath*>(node.path_.get()));
-  } else {
-    path_ = std::make_unique<PrefixPath>(*dynamic_cast<PrefixPath*>(node.path_.get()));
+  auto copyPath = [](Path* path) -> std::unique_ptr<Path> {
+    if (path->isRange()) {
+      return std::make_unique<RangePath>(*dynamic_cast<RangePath*>(path));
+    }
+    return std::make_unique<PrefixPath>(*dynamic_cast<PrefixPath*>(path));
+  };
+  if (node.path_ != nullptr) {
+    path_ = copyPath(node.path_.get());
+  }
+  for (auto& path : node.extraPaths_) {
+    extraPaths_.emplace_back(copyPath(path.get()));
   }
 }
 
@@ -381,6 +393,11 @@ IndexScanNode::IndexScanNode(const IndexScanNode& node)
   for (auto& hint : columnHints_) {
     requiredAndHintColumns_.insert(hint.get_column_name());
   }
+  for (auto* hints : extraColumnHints_) {
+    for (auto& hint : *hints) {
+      requiredAndHintColumns_.insert(hint.get_column_name());
+    }
+  }
   for (auto& col : ctx.requiredColumns) {
     requiredColumns_.push_back(col);
   }
@@ -401,6 +418,17 @@ IndexScanNode::IndexScanNode(const IndexScanNode& node)
     }
     tmp.erase(field.get_name());
   }
+  // The included columns are stored in the index value entirely
+  if (index_->include_fields_ref().has_value()) {
+    const auto& includes = *index_->include_fields_ref();
+    for (size_t i = 0; i < includes.size(); i++) {
+      tmp.erase(includes[i].get_name());
+      auto iter = colPosMap_.find(includes[i].get_name());
+      if (iter != colPosMap_.end()) {
+        includedPos_.emplace_back(i, iter->second);
+      }
+    }
+  }
   tmp.erase(kVid);
   tmp.erase(kTag);
   tmp.erase(kRank);
@@ -408,7 +436,19 @@ IndexScanNode::IndexScanNode(const IndexScanNode& node)
   tmp.erase(kDst);
   tmp.erase(kType);
   needAccessBase_ = !tmp.empty();
+  if (skipScan_) {
+    // The path is built for each value of the first field while scanning
+    const auto& leading = index_->get_fields().front();
+    requiredAndHintColumns_.insert(leading.get_name());
+    auto type = IndexKeyUtils::toValueType(leading.get_type().get_type());
+    leadingLen_ = IndexKeyUtils::encodeNullValue(type, leading.get_type().get_type_length()).size();
+    return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
   path_ = Path::make(index_.get(), getSchema().back().get(), columnHints_, context_->vIdLen());
+  for (auto* hints : extraColumnHints_) {
+    extraPaths_.emplace_back(
+        Path::make(index_.get(), getSchema().back().get(), *hints, context_->vIdLen()));
+  }
   return ::nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
@@ -420,18 +460,24 @@ nebula::cpp2::ErrorCode IndexScanNode::doExecute(PartitionID partId) {
 
 IndexNode::Result IndexScanNode::doNext() {
   for (; iter_ && iter_->valid(); iter_->next()) {
+    if (!ranges_.empty() && !seekRange()) {
+      break;
+    }
     if (!checkTTL()) {
       continue;
     }
-    auto q = path_->qualified(iter_->key());
-    if (q == QualifiedStrategy::INCOMPATIBLE) {
+    if (!context_->planContext_->mayContainVid(filteredVid(iter_->key()))) {
+      continue;
+    }
+    bool compatible = false;
+    if (!qualified(iter_->key(), compatible)) {
       continue;
     }
-    bool compatible = q == QualifiedStrategy::COMPATIBLE;
     if (compatible && !needAccessBase_) {
       auto key = iter_->key().toString();
-      iter_->next();
       Row row = decodeFromIndex(key);
+      decodeIncludedFromIndex(iter_->val(), row);
+      iter_->next();
       return Result(std::move(row));
     }
     std::pair<std::string, std::string> kv;
@@ -448,12 +494,8 @@ IndexNode::Result IndexScanNode::doNext() {
       return Result(ret);
     }
     Map<std::string, Value> rowData = decodeFromBase(kv.first, kv.second);
-    if (!compatible) {
-      q = path_->qualified(rowData);
-      CHECK(q != QualifiedStrategy::UNCERTAIN);
-      if (q == QualifiedStrategy::INCOMPATIBLE) {
-        continue;
-      }
+    if (!compatible && !qualified(rowData)) {
+      continue;
     }
     Row row;
     for (auto& col : requiredColumns_) {
@@ -479,9 +521,163 @@ bool IndexScanNode::checkTTL() {
   return true;
 }
 
+bool IndexScanNode::qualified(folly::StringPiece key, bool& compatible) {
+  if (ranges_.empty()) {
+    auto q = path_->qualified(key);
+    compatible = q == QualifiedStrategy::COMPATIBLE;
+    return q != QualifiedStrategy::INCOMPATIBLE;
+  }
+  compatible = false;
+  uncertainPaths_.clear();
+  for (auto i = rangeIdx_; i < ranges_.size() && key >= ranges_[i].start; i++) {
+    if (key >= ranges_[i].end) {
+      continue;
+    }
+    auto q = ranges_[i].path->qualified(key);
+    if (q == QualifiedStrategy::COMPATIBLE) {
+      compatible = true;
+      return true;
+    }
+    if (q == QualifiedStrategy::UNCERTAIN) {
+      uncertainPaths_.emplace_back(ranges_[i].path);
+    }
+  }
+  return !uncertainPaths_.empty();
+}
+
+bool IndexScanNode::qualified(const Map<std::string, Value>& rowData) {
+  if (ranges_.empty()) {
+    uncertainPaths_.assign(1, path_.get());
+  }
+  for (auto* path : uncertainPaths_) {
+    auto q = path->qualified(rowData);
+    CHECK(q != QualifiedStrategy::UNCERTAIN);
+    if (q == QualifiedStrategy::COMPATIBLE) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IndexScanNode::seekRange() {
+  while (iter_->valid()) {
+    auto key = iter_->key();
+    while (rangeIdx_ < ranges_.size() && key >= ranges_[rangeIdx_].end) {
+      rangeIdx_++;
+    }
+    if (rangeIdx_ == ranges_.size()) {
+      if (!skipScan_ || !skipLeading()) {
+        return false;
+      }
+      continue;
+    }
+    if (key >= ranges_[rangeIdx_].start) {
+      return true;
+    }
+    // The key is in the gap before the next range
+    iter_->seek(ranges_[rangeIdx_].start);
+  }
+  return false;
+}
+
+namespace {
+
+// The keys with the prefix are all less than the prefix whose last byte is increased, it's empty
+// if there is no such key
+std::string prefixEnd(std::string prefix) {
+  while (!prefix.empty() && static_cast<uint8_t>(prefix.back()) == 0xFF) {
+    prefix.pop_back();
+  }
+  if (!prefix.empty()) {
+    prefix.back()++;
+  }
+  return prefix;
+}
+
+// The key range [start, end) of the path in the part
+std::pair<std::string, std::string> pathRange(Path* path, PartitionID partId) {
+  path->resetPart(partId);
+  if (path->isRange()) {
+    auto rangePath = dynamic_cast<RangePath*>(path);
+    return {rangePath->getStartKey(), rangePath->getEndKey()};
+  }
+  const auto& prefix = dynamic_cast<PrefixPath*>(path)->getPrefixKey();
+  return {prefix, prefixEnd(prefix)};
+}
+
+}  // namespace
+
+std::pair<std::string, std::string> IndexScanNode::keyRange(PartitionID partId) {
+  if (skipScan_) {
+    auto prefix = IndexKeyUtils::indexPrefix(partId, index_->get_index_id());
+    auto end = prefixEnd(prefix);
+    return {std::move(prefix), std::move(end)};
+  }
+  auto range = pathRange(path_.get(), partId);
+  for (auto& path : extraPaths_) {
+    auto [start, end] = pathRange(path.get(), partId);
+    range.first = std::min(range.first, start);
+    range.second = std::max(range.second, end);
+  }
+  return range;
+}
+
 nebula::cpp2::ErrorCode IndexScanNode::resetIter(PartitionID partId) {
-  path_->resetPart(partId);
   nebula::cpp2::ErrorCode ret = nebula::cpp2::ErrorCode::SUCCEEDED;
+  ranges_.clear();
+  rangeIdx_ = 0;
+  if (skipScan_) {
+    scanBound_ = keyRange(partId);
+    if (subRange_.has_value()) {
+      scanBound_.first = std::max(scanBound_.first, subRange_->first);
+      scanBound_.second = std::min(scanBound_.second, subRange_->second);
+    }
+    if (scanBound_.first >= scanBound_.second) {
+      iter_.reset();
+      return ret;
+    }
+    ret = kvstore_->range(spaceId_, partId, scanBound_.first, scanBound_.second, &iter_);
+    if (ret == nebula::cpp2::ErrorCode::SUCCEEDED && iter_->valid()) {
+      buildLeadingRange();
+    }
+    return ret;
+  }
+  if (!extraPaths_.empty()) {
+    std::vector<Path*> paths{path_.get()};
+    for (auto& path : extraPaths_) {
+      paths.emplace_back(path.get());
+    }
+    for (auto* path : paths) {
+      auto [start, end] = pathRange(path, partId);
+      if (subRange_.has_value()) {
+        start = std::max(start, subRange_->first);
+        end = std::min(end, subRange_->second);
+      }
+      if (start < end) {
+        ranges_.push_back({std::move(start), std::move(end), path});
+      }
+    }
+    if (ranges_.empty()) {
+      iter_.reset();
+      return ret;
+    }
+    std::sort(ranges_.begin(), ranges_.end(), [](const auto& a, const auto& b) {
+      return a.start < b.start;
+    });
+    scanBound_.first = ranges_.front().start;
+    scanBound_.second = ranges_.front().end;
+    for (auto& range : ranges_) {
+      scanBound_.second = std::max(scanBound_.second, range.end);
+    }
+    return kvstore_->range(spaceId_, partId, scanBound_.first, scanBound_.second, &iter_);
+  }
+  if (subRange_.has_value()) {
+    auto [start, end] = keyRange(partId);
+    scanBound_.first = std::max(start, subRange_->first);
+    scanBound_.second = std::min(end, subRange_->second);
+    return kvstore_->range(spaceId_, partId, scanBound_.first, scanBound_.second, &iter_);
+  }
+  path_->resetPart(partId);
   if (path_->isRange()) {
     auto rangePath = dynamic_cast<RangePath*>(path_.get());
     kvstore_->range(spaceId_, partId, rangePath->getStartKey(), rangePath->getEndKey(), &iter_);
@@ -492,6 +688,53 @@ nebula::cpp2::ErrorCode IndexScanNode::resetIter(PartitionID partId) {
   return ret;
 }
 
+void IndexScanNode::buildLeadingRange() {
+  auto key = iter_->key();
+  const auto& fields = index_->get_fields();
+  bool isEdge = index_->get_schema_id().edge_type_ref().has_value();
+  cpp2::IndexColumnHint leading;
+  leading.column_name_ref() = fields.front().get_name();
+  leading.scan_type_ref() = cpp2::ScanType::PREFIX;
+  leading.begin_value_ref() = IndexKeyUtils::getValueFromIndexKey(context_->vIdLen(),
+                                                                  key,
+                                                                  fields.front().get_name(),
+                                                                  fields,
+                                                                  isEdge,
+                                                                  indexNullable_);
+  std::vector<cpp2::IndexColumnHint> hints{std::move(leading)};
+  hints.insert(hints.end(), columnHints_.begin(), columnHints_.end());
+  leadingPath_ = Path::make(index_.get(), getSchema().back().get(), hints, context_->vIdLen());
+  auto [start, end] = pathRange(leadingPath_.get(), partId_);
+  ranges_.assign(1, {std::max(start, scanBound_.first), std::min(end, scanBound_.second)});
+  ranges_.front().path = leadingPath_.get();
+  rangeIdx_ = 0;
+  auto prefixLen = sizeof(PartitionID) + sizeof(IndexID);
+  leadingEnd_ = prefixEnd(key.subpiece(0, prefixLen + leadingLen_).toString());
+}
+
+bool IndexScanNode::skipLeading() {
+  if (leadingEnd_.empty()) {
+    return false;
+  }
+  iter_->seek(leadingEnd_);
+  if (!iter_->valid()) {
+    return false;
+  }
+  buildLeadingRange();
+  return true;
+}
+
+void IndexScanNode::decodeIncludedFromIndex(folly::StringPiece val, Row& row) {
+  if (includedPos_.empty()) {
+    return;
+  }
+  auto included = IndexKeyUtils::parseIndexIncluded(val);
+  for (auto& [from, to] : includedPos_) {
+    // An entry without the included values, e.g. written by an older version, is read as null
+    row.values[to] = from < included.size() ? std::move(included.values[from]) : Value::kNullValue;
+  }
+}
+
 void IndexScanNode::decodePropFromIndex(folly::StringPiece key,
                                         const Map<std::string, size_t>& colPosMap,
                                         std::vector<Value>& values) {
@@ -554,7 +797,22 @@ void IndexScanNode::decodePropFromIndex(folly::StringPiece key,
 }
 
 std::string IndexScanNode::identify() {
-  return fmt::format("{}(IndexID={}, Path=({}))", name_, indexId_, path_->toString());
+  if (skipScan_) {
+    std::vector<std::string> columns;
+    for (const auto& hint : columnHints_) {
+      columns.emplace_back(hint.get_column_name());
+    }
+    return fmt::format("{}(IndexID={}, SkipScan={}, Hints=[{}])",
+                       name_,
+                       indexId_,
+                       index_->get_fields().front().get_name(),
+                       folly::join(',', columns));
+  }
+  auto paths = fmt::format("Path=({})", path_->toString());
+  for (auto& path : extraPaths_) {
+    paths += fmt::format(", Path=({})", path->toString());
+  }
+  return fmt::format("{}(IndexID={}, {})", name_, indexId_, paths);
 }
 
 // End of IndexScan
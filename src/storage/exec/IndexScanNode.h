@@ -8,6 +8,7 @@
 
 #include <cstring>
 #include <functional>
+#include <optional>
 
 #include "common/base/Base.h"
 #include "common/datatypes/DataSet.h"
@@ -70,6 +71,44 @@ class IndexScanNode : public IndexNode {
   ::nebula::cpp2::ErrorCode init(InitContext& ctx) override;
   std::string identify() override;
 
+  /**
+   * @brief Scan the index data satisfying the hints as well, so that a scan with several ranges,
+   * e.g. the ones of an IN-list, is done by one iterator seeking from range to range. The output
+   * is in key order without duplicates even if the ranges overlap.
+   *
+   * @param hints column hints on the same index, must be added before init
+   */
+  void addColumnHints(const std::vector<cpp2::IndexColumnHint>& hints) {
+    extraColumnHints_.emplace_back(&hints);
+  }
+
+  /**
+   * @brief Return the key range [start, end) of the index data to scan in the part
+   *
+   * @param partId
+   * @return std::pair<std::string, std::string>
+   */
+  std::pair<std::string, std::string> keyRange(PartitionID partId);
+
+  /**
+   * @brief Only scan the keys within [start, end) of the part, so that the range of a part could
+   * be split and scanned by several nodes concurrently
+   */
+  void setSubRange(std::string start, std::string end) {
+    subRange_ = std::make_pair(std::move(start), std::move(end));
+  }
+
+  /**
+   * @brief Scan the column hints, which start from the second field of the index, for each
+   * distinct value of the first field. The keys of a value are scanned by the path of the hints
+   * prefixed by the value, then the scan seeks to the keys of the next value. It's efficient if
+   * the first field has a few distinct values. The first field must be neither nullable nor a
+   * variable length string, whose values are exactly encoded in the keys.
+   */
+  void setSkipScan(bool skipScan) {
+    skipScan_ = skipScan;
+  }
+
  protected:
   nebula::cpp2::ErrorCode doExecute(PartitionID partId) final;
   Result doNext() final;
@@ -98,6 +137,23 @@ class IndexScanNode : public IndexNode {
    */
   virtual Row decodeFromIndex(folly::StringPiece key) = 0;
 
+  /**
+   * @brief get the vid checked by the vid filter of the request from index key, the vertex or the
+   * dst of the edge
+   *
+   * @param key index key
+   * @return folly::StringPiece the padded vid
+   */
+  virtual folly::StringPiece filteredVid(folly::StringPiece key) = 0;
+
+  /**
+   * @brief decode the values of the columns included in the index from the index value
+   *
+   * @param val index value
+   * @param row result of decodeFromIndex(), the included columns are set in it
+   */
+  void decodeIncludedFromIndex(folly::StringPiece val, Row& row);
+
   /**
    * @brief get the base data key-value according to index key
    *
@@ -119,6 +175,31 @@ class IndexScanNode : public IndexNode {
                                                  const std::string& value) = 0;
   virtual const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>& getSchema() = 0;
 
+  /**
+   * @brief Move the iterator to the first key within the ranges if it's not, the ranges ended are
+   * skipped. Only used when there are several ranges.
+   *
+   * @return false if all the ranges have been scanned
+   */
+  bool seekRange();
+
+  /**
+   * @brief Qualify the index key by the paths whose ranges contain it
+   *
+   * @param key index key
+   * @param compatible set to true if any path is compatible with the key, otherwise the paths are
+   * uncertain about it and the base data needs to be qualified
+   * @return false if all the paths are incompatible with the key
+   */
+  bool qualified(folly::StringPiece key, bool& compatible);
+
+  /**
+   * @brief Qualify the base data by the paths which are uncertain about the index key
+   *
+   * @return true if any of them is compatible with the base data
+   */
+  bool qualified(const Map<std::string, Value>& rowData);
+
   /**
    * @brief Check whether the indexkey has expired
    *
@@ -135,6 +216,16 @@ class IndexScanNode : public IndexNode {
    * @see Path
    */
   nebula::cpp2::ErrorCode resetIter(PartitionID partId);
+  /**
+   * @brief build the range of the skip scan for the value of the first field in the current key
+   */
+  void buildLeadingRange();
+  /**
+   * @brief seek to the keys of the next value of the first field for the skip scan
+   *
+   * @return false if there are no more values
+   */
+  bool skipLeading();
   PartitionID partId_;
   /**
    * @brief index_ in this Node to access
@@ -149,6 +240,47 @@ class IndexScanNode : public IndexNode {
    * @see Path
    */
   std::unique_ptr<Path> path_;
+  /**
+   * @brief the sub range of the part to scan, the whole range of the path is scanned if not set
+   */
+  std::optional<std::pair<std::string, std::string>> subRange_;
+  /**
+   * @brief the column hints added by addColumnHints(), and the paths built from them
+   */
+  std::vector<const std::vector<cpp2::IndexColumnHint>*> extraColumnHints_;
+  std::vector<std::unique_ptr<Path>> extraPaths_;
+  /**
+   * @brief the skip scan, the path of the current value of the first field, and the key following
+   * all the keys of the value
+   */
+  bool skipScan_{false};
+  size_t leadingLen_{0};
+  std::unique_ptr<Path> leadingPath_;
+  std::string leadingEnd_;
+  /**
+   * @brief key range of a path in current part
+   */
+  struct ScanRange {
+    std::string start;
+    std::string end;
+    Path* path;
+  };
+  /**
+   * @brief the ranges of all the paths sorted by start key, it's empty if there is only one path
+   */
+  std::vector<ScanRange> ranges_;
+  /**
+   * @brief the first range not ended yet
+   */
+  size_t rangeIdx_{0};
+  /**
+   * @brief the paths uncertain about the current key, they qualify the base data then
+   */
+  std::vector<Path*> uncertainPaths_;
+  /**
+   * @brief the bounds of the iterator, the kvstore iterator refers to them
+   */
+  std::pair<std::string, std::string> scanBound_;
   /**
    * @brief current kvstore iterator.It while be reset `doExecute` and iterated during `doNext`
    */
@@ -171,6 +303,10 @@ class IndexScanNode : public IndexNode {
    */
   std::pair<bool, std::pair<int64_t, std::string>> ttlProps_;
   bool needAccessBase_{false};
+  /**
+   * @brief the position in include_fields and in the returned row of the included columns needed
+   */
+  std::vector<std::pair<size_t, size_t>> includedPos_;
   bool fatalOnBaseNotFound_{false};
   Map<std::string, size_t> colPosMap_;
 };
@@ -6,12 +6,17 @@
 namespace nebula {
 namespace storage {
 IndexSelectionNode::IndexSelectionNode(const IndexSelectionNode& node)
-    : IndexNode(node), expr_(node.expr_->clone()), colPos_(node.colPos_) {
+    : IndexNode(node),
+      expr_(node.expr_->clone()),
+      program_(ExpressionProgram::compile(expr_)),
+      colPos_(node.colPos_) {
   ctx_ = std::make_unique<IndexExprContext>(colPos_);
 }
 
 IndexSelectionNode::IndexSelectionNode(RuntimeContext* context, Expression* expr)
-    : IndexNode(context, "IndexSelectionNode"), expr_(expr->clone()) {}
+    : IndexNode(context, "IndexSelectionNode"),
+      expr_(expr->clone()),
+      program_(ExpressionProgram::compile(expr_)) {}
 nebula::cpp2::ErrorCode IndexSelectionNode::init(InitContext& ctx) {
   DCHECK_EQ(children_.size(), 1);
   SelectionExprVisitor vis;
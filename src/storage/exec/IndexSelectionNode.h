@@ -7,6 +7,7 @@
 
 #include "common/context/ExpressionContext.h"
 #include "common/expression/Expression.h"
+#include "common/expression/ExpressionProgram.h"
 #include "folly/container/F14Map.h"
 #include "storage/ExprVisitorBase.h"
 #include "storage/exec/IndexExprContext.h"
@@ -56,10 +57,11 @@ class IndexSelectionNode : public IndexNode {
   Result doNext() override;
   inline bool filter(const Row &row) {
     ctx_->setRow(row);
-    auto &result = expr_->eval(*ctx_);
+    auto &result = program_ != nullptr ? program_->eval(*ctx_) : expr_->eval(*ctx_);
     return result.type() == Value::Type::BOOL ? result.getBool() : false;
   }
   Expression *expr_;
+  std::unique_ptr<ExpressionProgram> program_;
   Map<std::string, size_t> colPos_;
   // TODO(hs.zhang): `ExprContext` could be moved out later if we unify the volcano in go/lookup
   std::unique_ptr<IndexExprContext> ctx_;
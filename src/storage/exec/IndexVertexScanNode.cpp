@@ -79,6 +79,10 @@ Row IndexVertexScanNode::decodeFromIndex(folly::StringPiece key) {
   return Row(std::move(values));
 }
 
+folly::StringPiece IndexVertexScanNode::filteredVid(folly::StringPiece key) {
+  return IndexKeyUtils::getIndexVertexID(context_->vIdLen(), key);
+}
+
 Map<std::string, Value> IndexVertexScanNode::decodeFromBase(const std::string& key,
                                                             const std::string& value) {
   Map<std::string, Value> values;
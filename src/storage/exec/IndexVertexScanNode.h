@@ -37,6 +37,7 @@ class IndexVertexScanNode final : public IndexScanNode {
   nebula::cpp2::ErrorCode getBaseData(folly::StringPiece key,
                                       std::pair<std::string, std::string>& kv) override;
   Row decodeFromIndex(folly::StringPiece key) override;
+  folly::StringPiece filteredVid(folly::StringPiece key) override;
   Map<std::string, Value> decodeFromBase(const std::string& key, const std::string& value) override;
 
   using TagSchemas = std::vector<std::shared_ptr<const nebula::meta::NebulaSchemaProvider>>;
@@ -6,6 +6,7 @@
 #ifndef STORAGE_EXEC_QUERYUTILS_H_
 #define STORAGE_EXEC_QUERYUTILS_H_
 
+#include "codec/RowReaderV2.h"
 #include "common/base/Base.h"
 #include "common/expression/Expression.h"
 #include "common/utils/DefaultValueContext.h"
@@ -16,6 +17,48 @@
 namespace nebula {
 namespace storage {
 
+/**
+ * @brief The projections of the props in value for each schema version. The projection of a
+ * schema version is built when its first row is read, and then reused by the later rows, so the
+ * props are decoded without looking up the schema for each of them.
+ */
+class PropProjections final {
+ public:
+  /**
+   * @brief Decode the props in value of the row, return nullptr if the row is not encoded in V2.
+   * The values are in the order of the props in value, and valid until next decode.
+   *
+   * @param reader Reader of the row
+   * @param props Props to decode, those in key are skipped
+   * @return std::vector<Value>*
+   */
+  std::vector<Value>* decode(RowReader* reader, const std::vector<PropContext>* props) {
+    if (reader == nullptr || reader->readerVer() != 2) {
+      return nullptr;
+    }
+    auto* schema = reader->getSchema();
+    auto& projection = projections_[std::make_pair(schema, props)];
+    if (projection == nullptr) {
+      std::vector<std::string> fields;
+      for (const auto& prop : *props) {
+        if (prop.propInKeyType_ == PropContext::PropInKeyType::NONE) {
+          fields.emplace_back(prop.name_);
+        }
+      }
+      projection = std::make_unique<RowProjectionV2>(schema, fields);
+    }
+    values_.clear();
+    projection->decode(reader->getRawData(), values_);
+    return &values_;
+  }
+
+ private:
+  std::unordered_map<std::pair<const meta::SchemaProviderIf*, const std::vector<PropContext>*>,
+                     std::unique_ptr<RowProjectionV2>>
+      projections_;
+  std::vector<Value> values_;
+};
+
 class QueryUtils final {
  public:
   static inline bool vTrue(const Value& v) {
@@ -66,7 +109,21 @@ class QueryUtils final {
   static StatusOr<nebula::Value> readValue(RowReader* reader,
                                            const std::string& propName,
                                            const meta::SchemaProviderIf::Field* field) {
-    auto value = reader->getValueByName(propName);
+    return checkValue(reader->getValueByName(propName), propName, field);
+  }
+
+  /**
+   * @brief Check the value decoded from a row, the default value or null is returned if the row
+   * doesn't have the field
+   *
+   * @param value Value decoded
+   * @param propName Filed name
+   * @param field Field definition
+   * @return StatusOr<nebula::Value>
+   */
+  static StatusOr<nebula::Value> checkValue(nebula::Value value,
+                                            const std::string& propName,
+                                            const meta::SchemaProviderIf::Field* field) {
     if (value.type() == Value::Type::NULLVALUE) {
       // read null value
       auto nullType = value.getNull();
@@ -120,14 +177,26 @@ class QueryUtils final {
                                               size_t vIdLen,
                                               bool isIntId,
                                               RowReader* reader,
-                                              const PropContext& prop) {
+                                              const PropContext& prop,
+                                              Value* decoded = nullptr) {
+    return readEdgeProp(EdgeKeyView(vIdLen, key), isIntId, reader, prop, decoded);
+  }
+
+  static StatusOr<nebula::Value> readEdgeProp(const EdgeKeyView& key,
+                                              bool isIntId,
+                                              RowReader* reader,
+                                              const PropContext& prop,
+                                              Value* decoded = nullptr) {
     switch (prop.propInKeyType_) {
       // prop in value
       case PropContext::PropInKeyType::NONE: {
+        if (decoded != nullptr) {
+          return checkValue(std::move(*decoded), prop.name_, prop.field_);
+        }
         return readValue(reader, prop.name_, prop.field_);
       }
       case PropContext::PropInKeyType::SRC: {
-        auto srcId = NebulaKeyUtils::getSrcId(vIdLen, key);
+        auto srcId = key.srcId();
         if (isIntId) {
           return *reinterpret_cast<const int64_t*>(srcId.data());
         } else {
@@ -135,15 +204,13 @@ class QueryUtils final {
         }
       }
       case PropContext::PropInKeyType::TYPE: {
-        auto edgeType = NebulaKeyUtils::getEdgeType(vIdLen, key);
-        return edgeType;
+        return key.edgeType();
       }
       case PropContext::PropInKeyType::RANK: {
-        auto edgeRank = NebulaKeyUtils::getRank(vIdLen, key);
-        return edgeRank;
+        return key.rank();
       }
       case PropContext::PropInKeyType::DST: {
-        auto dstId = NebulaKeyUtils::getDstId(vIdLen, key);
+        auto dstId = key.dstId();
         if (isIntId) {
           return *reinterpret_cast<const int64_t*>(dstId.data());
         } else {
@@ -160,14 +227,26 @@ class QueryUtils final {
                                                 size_t vIdLen,
                                                 bool isIntId,
                                                 RowReader* reader,
-                                                const PropContext& prop) {
+                                                const PropContext& prop,
+                                                Value* decoded = nullptr) {
+    return readVertexProp(TagKeyView(vIdLen, key), isIntId, reader, prop, decoded);
+  }
+
+  static StatusOr<nebula::Value> readVertexProp(const TagKeyView& key,
+                                                bool isIntId,
+                                                RowReader* reader,
+                                                const PropContext& prop,
+                                                Value* decoded = nullptr) {
     switch (prop.propInKeyType_) {
       // prop in value
       case PropContext::PropInKeyType::NONE: {
+        if (decoded != nullptr) {
+          return checkValue(std::move(*decoded), prop.name_, prop.field_);
+        }
         return readValue(reader, prop.name_, prop.field_);
       }
       case PropContext::PropInKeyType::VID: {
-        auto vId = NebulaKeyUtils::getVertexId(vIdLen, key);
+        auto vId = key.vertexId();
         if (isIntId) {
           return *reinterpret_cast<const int64_t*>(vId.data());
         } else {
@@ -175,8 +254,7 @@ class QueryUtils final {
         }
       }
       case PropContext::PropInKeyType::TAG: {
-        auto tag = NebulaKeyUtils::getTagId(vIdLen, key);
-        return tag;
+        return key.tagId();
       }
       default:
         LOG(FATAL) << "Should not read here";
@@ -191,19 +269,27 @@ class QueryUtils final {
                                    const std::vector<PropContext>* props,
                                    nebula::List& list,
                                    StorageExpressionContext* expCtx = nullptr,
-                                   const std::string& tagName = "") {
+                                   const std::string& tagName = "",
+                                   PropProjections* projections = nullptr) {
+    auto* decoded = projections == nullptr ? nullptr : projections->decode(reader, props);
+    size_t decodedIdx = 0;
+    TagKeyView keyView(vIdLen, key);
     for (const auto& prop : *props) {
+      Value* decodedValue = nullptr;
+      if (decoded != nullptr && prop.propInKeyType_ == PropContext::PropInKeyType::NONE) {
+        decodedValue = &(*decoded)[decodedIdx++];
+      }
       if (!(prop.returned_ || (prop.filtered_ && expCtx != nullptr))) {
         continue;
       }
-      auto value = QueryUtils::readVertexProp(key, vIdLen, isIntId, reader, prop);
+      auto value = QueryUtils::readVertexProp(keyView, isIntId, reader, prop, decodedValue);
       NG_RETURN_IF_ERROR(value);
+      if (prop.filtered_ && expCtx != nullptr) {
+        expCtx->setTagProp(tagName, prop.name_, value.value());
+      }
       if (prop.returned_) {
         VLOG(2) << "Collect prop " << prop.name_;
-        list.emplace_back(value.value());
-      }
-      if (prop.filtered_ && expCtx != nullptr) {
-        expCtx->setTagProp(tagName, prop.name_, std::move(value).value());
+        list.emplace_back(std::move(value).value());
       }
     }
     return Status::OK();
@@ -216,19 +302,27 @@ class QueryUtils final {
                                  const std::vector<PropContext>* props,
                                  nebula::List& list,
                                  StorageExpressionContext* expCtx = nullptr,
-                                 const std::string& edgeName = "") {
+                                 const std::string& edgeName = "",
+                                 PropProjections* projections = nullptr) {
+    auto* decoded = projections == nullptr ? nullptr : projections->decode(reader, props);
+    size_t decodedIdx = 0;
+    EdgeKeyView keyView(vIdLen, key);
     for (const auto& prop : *props) {
+      Value* decodedValue = nullptr;
+      if (decoded != nullptr && prop.propInKeyType_ == PropContext::PropInKeyType::NONE) {
+        decodedValue = &(*decoded)[decodedIdx++];
+      }
       if (!(prop.returned_ || (prop.filtered_ && expCtx != nullptr))) {
         continue;
       }
-      auto value = QueryUtils::readEdgeProp(key, vIdLen, isIntId, reader, prop);
+      auto value = QueryUtils::readEdgeProp(keyView, isIntId, reader, prop, decodedValue);
       NG_RETURN_IF_ERROR(value);
+      if (prop.filtered_ && expCtx != nullptr) {
+        expCtx->setEdgeProp(edgeName, prop.name_, value.value());
+      }
       if (prop.returned_) {
         VLOG(2) << "Collect prop " << prop.name_;
-        list.emplace_back(value.value());
-      }
-      if (prop.filtered_ && expCtx != nullptr) {
-        expCtx->setEdgeProp(edgeName, prop.name_, std::move(value).value());
+        list.emplace_back(std::move(value).value());
       }
     }
     return Status::OK();
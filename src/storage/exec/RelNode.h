@@ -93,10 +93,22 @@ class RelNode {
     return name_;
   }
 
+  /**
+   * @brief Stats of the node other than the rows and the duration, e.g. the time spent in decoding
+   * the values, only collected if profile_ is set
+   */
+  virtual std::map<std::string, int64_t> profileStats() const {
+    return {};
+  }
+
   std::string name_ = "RelNode";
   std::vector<RelNode<T>*> dependencies_;
   bool isDependent_ = false;
   time::Duration duration_{true};
+  // Whether the request is profiled, see StoragePlan::enableProfile
+  bool profile_ = false;
+  // Rows produced by the node
+  int64_t rows_ = 0;
 };
 
 // QueryNode is the node which would read data from kvstore, it usually generate
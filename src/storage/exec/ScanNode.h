@@ -7,7 +7,9 @@
 #define STORAGE_EXEC_SCANNODE_H
 
 #include "common/base/Base.h"
+#include "common/utils/IndexKeyUtils.h"
 #include "storage/exec/GetPropNode.h"
+#include "storage/exec/IndexTopNNode.h"
 
 namespace nebula {
 namespace storage {
@@ -82,6 +84,9 @@ class ScanVertexPropNode : public QueryNode<Cursor> {
     std::string currentVertexId;
     for (; iter->valid() && static_cast<int64_t>(resultDataSet_->rowSize()) < rowLimit;
          iter->next()) {
+      if (context_->isPlanKilled()) {
+        return nebula::cpp2::ErrorCode::E_PLAN_IS_KILLED;
+      }
       auto key = iter->key();
       auto tagId = NebulaKeyUtils::getTagId(vIdLen, key);
       auto tagIdIndex = tagNodesIndex_.find(tagId);
@@ -187,7 +192,12 @@ class ScanVertexPropNode : public QueryNode<Cursor> {
   Expression* filter_{nullptr};
 };
 
-// Node to scan edge of one partition
+/**
+ * @brief Node to scan edge of one partition. When only one edge type is scanned and it has an
+ * index without fields, the keys of the index are scanned instead and the edges are read by them,
+ * since the edges of one type are not contiguous in the part but the index keys are. The cursor is
+ * an index key then, which is in the same order as the edge key of the type.
+ */
 class ScanEdgePropNode : public QueryNode<Cursor> {
  public:
   using RelNode<Cursor>::doExecute;
@@ -199,7 +209,9 @@ class ScanEdgePropNode : public QueryNode<Cursor> {
                    std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
                    nebula::DataSet* resultDataSet,
                    StorageExpressionContext* expCtx = nullptr,
-                   Expression* filter = nullptr)
+                   Expression* filter = nullptr,
+                   const std::vector<std::pair<size_t, cpp2::OrderDirection>>* orderBy = nullptr,
+                   std::optional<IndexID> typeIndex = std::nullopt)
       : context_(context),
         edgeNodes_(std::move(edgeNodes)),
         enableReadFollower_(enableReadFollower),
@@ -207,7 +219,9 @@ class ScanEdgePropNode : public QueryNode<Cursor> {
         cursors_(cursors),
         resultDataSet_(resultDataSet),
         expCtx_(expCtx),
-        filter_(filter) {
+        filter_(filter),
+        orderBy_(orderBy),
+        typeIndex_(typeIndex) {
     QueryNode::name_ = "ScanEdgePropNode";
     for (std::size_t i = 0; i < edgeNodes_.size(); ++i) {
       edgeNodesIndex_.emplace(edgeNodes_[i]->edgeType(), i);
@@ -220,10 +234,80 @@ class ScanEdgePropNode : public QueryNode<Cursor> {
       return ret;
     }
 
-    std::string start;
+    // The whole part is scanned and only the top rows are kept when ordered, the limit is of
+    // each part rather than the response, and there is no next cursor
+    topN_ = orderBy_ != nullptr && !orderBy_->empty() && limit_ > 0;
+    heap_ = TopNHeap<Row>();
+    if (topN_) {
+      heap_.setHeapSize(limit_);
+      heap_.setComparator([this](Row& lhs, Row& rhs) {
+        for (const auto& [index, direction] : *orderBy_) {
+          const auto& lValue = lhs.values[index];
+          const auto& rValue = rhs.values[index];
+          if (lValue == rValue) {
+            continue;
+          }
+          if (direction == cpp2::OrderDirection::ASCENDING) {
+            return lValue < rValue;
+          } else {
+            return lValue > rValue;
+          }
+        }
+        return false;
+      });
+    }
+
+    std::string nextCursor;
+    bool byIndex = typeIndex_.has_value() && (cursor.empty() || IndexKeyUtils::isIndexKey(cursor));
+    if (byIndex) {
+      // The index is not complete when it is being rebuilt
+      auto state = context_->env()->getIndexState(context_->spaceId(), partId);
+      byIndex = state == IndexState::FINISHED;
+    }
+    if (byIndex) {
+      ret = scanByIndex(partId, cursor, nextCursor);
+    } else {
+      ret = scanAll(partId, cursor, nextCursor);
+    }
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return ret;
+    }
+    if (topN_) {
+      auto rows = heap_.moveTopK();
+      std::move(rows.begin(), rows.end(), std::back_inserter(resultDataSet_->rows));
+    }
+
+    cpp2::ScanCursor c;
+    if (!nextCursor.empty()) {
+      c.next_cursor_ref() = std::move(nextCursor);
+    }
+    cursors_->emplace(partId, std::move(c));
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+ private:
+  bool needMore() const {
+    return topN_ || static_cast<int64_t>(resultDataSet_->rowSize()) < limit_;
+  }
+
+  nebula::cpp2::ErrorCode scanAll(PartitionID partId,
+                                  const Cursor& cursor,
+                                  std::string& nextCursor) {
+    auto vIdLen = context_->vIdLen();
     std::string prefix = NebulaKeyUtils::edgePrefix(partId);
+    std::string start;
     if (cursor.empty()) {
       start = prefix;
+    } else if (IndexKeyUtils::isIndexKey(cursor)) {
+      // The cursor of the index scan while the index is not available any more. The index keys
+      // are ordered as the edges of the type, and the cursor is the first one not returned yet,
+      // so the scan goes on from its edge
+      start = NebulaKeyUtils::edgeKey(vIdLen,
+                                      partId,
+                                      IndexKeyUtils::getIndexSrcId(vIdLen, cursor).str(),
+                                      edgeNodes_.front()->edgeType(),
+                                      IndexKeyUtils::getIndexRank(vIdLen, cursor),
+                                      IndexKeyUtils::getIndexDstId(vIdLen, cursor).str());
     } else {
       start = cursor;
     }
@@ -234,12 +318,10 @@ class ScanEdgePropNode : public QueryNode<Cursor> {
     if (kvRet != nebula::cpp2::ErrorCode::SUCCEEDED) {
       return kvRet;
     }
-
-    auto rowLimit = limit_;
-    auto vIdLen = context_->vIdLen();
-    auto isIntId = context_->isIntId();
-    for (; iter->valid() && static_cast<int64_t>(resultDataSet_->rowSize()) < rowLimit;
-         iter->next()) {
+    for (; iter->valid() && needMore(); iter->next()) {
+      if (context_->isPlanKilled()) {
+        return nebula::cpp2::ErrorCode::E_PLAN_IS_KILLED;
+      }
       auto key = iter->key();
       if (!NebulaKeyUtils::isEdge(vIdLen, key)) {
         continue;
@@ -249,19 +331,99 @@ class ScanEdgePropNode : public QueryNode<Cursor> {
       if (edgeNodeIndex == edgeNodesIndex_.end()) {
         continue;
       }
-      auto value = iter->val();
-      edgeNodes_[edgeNodeIndex->second]->doExecute(key.toString(), value.toString());
-      collectOneRow(isIntId, vIdLen);
+      auto& edgeNode = edgeNodes_[edgeNodeIndex->second];
+      // The value is not read if the edge is filtered out by the props in key
+      if (!edgeNode->checkKey(key)) {
+        continue;
+      }
+      edgeNode->doExecute(key.toString(), iter->val().toString());
+      collectRow();
+    }
+    if (iter->valid()) {
+      nextCursor = iter->key().str();
+    }
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+  nebula::cpp2::ErrorCode scanByIndex(PartitionID partId,
+                                      const Cursor& cursor,
+                                      std::string& nextCursor) {
+    static constexpr size_t kBatchSize = 256;
+    auto vIdLen = context_->vIdLen();
+    auto& edgeNode = edgeNodes_.front();
+    auto edgeType = edgeNode->edgeType();
+    auto prefix = IndexKeyUtils::indexPrefix(partId, typeIndex_.value());
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto kvRet = context_->env()->kvstore_->rangeWithPrefix(context_->spaceId(),
+                                                           partId,
+                                                           cursor.empty() ? prefix : cursor,
+                                                           prefix,
+                                                           &iter,
+                                                           enableReadFollower_);
+    if (kvRet != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return kvRet;
     }
 
-    cpp2::ScanCursor c;
+    std::vector<std::string> indexKeys;
+    std::vector<std::string> edgeKeys;
+    while (iter->valid() && needMore()) {
+      if (context_->isPlanKilled()) {
+        return nebula::cpp2::ErrorCode::E_PLAN_IS_KILLED;
+      }
+      // The edges are read in batches, which are sorted by the kvstore
+      indexKeys.clear();
+      edgeKeys.clear();
+      for (; iter->valid() && indexKeys.size() < kBatchSize; iter->next()) {
+        auto indexKey = iter->key();
+        auto srcId = IndexKeyUtils::getIndexSrcId(vIdLen, indexKey).str();
+        auto dstId = IndexKeyUtils::getIndexDstId(vIdLen, indexKey).str();
+        auto edgeKey = NebulaKeyUtils::edgeKey(
+            vIdLen, partId, srcId, edgeType, IndexKeyUtils::getIndexRank(vIdLen, indexKey), dstId);
+        if (!edgeNode->checkKey(edgeKey)) {
+          continue;
+        }
+        indexKeys.emplace_back(indexKey.str());
+        edgeKeys.emplace_back(std::move(edgeKey));
+      }
+      if (edgeKeys.empty()) {
+        continue;
+      }
+      std::vector<std::string> values;
+      auto ret = context_->env()->kvstore_->multiGet(
+          context_->spaceId(), partId, edgeKeys, &values, enableReadFollower_);
+      if (ret.first != nebula::cpp2::ErrorCode::SUCCEEDED &&
+          ret.first != nebula::cpp2::ErrorCode::E_PARTIAL_RESULT) {
+        return ret.first;
+      }
+      for (size_t i = 0; i < edgeKeys.size(); i++) {
+        if (!needMore()) {
+          // The rest of the batch is scanned again by the next cursor
+          nextCursor = std::move(indexKeys[i]);
+          return nebula::cpp2::ErrorCode::SUCCEEDED;
+        }
+        if (!ret.second[i].ok()) {
+          continue;
+        }
+        edgeNode->doExecute(edgeKeys[i], values[i]);
+        collectRow();
+      }
+    }
     if (iter->valid()) {
-      c.next_cursor_ref() = iter->key().str();
+      nextCursor = iter->key().str();
     }
-    cursors_->emplace(partId, std::move(c));
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   }
 
+  void collectRow() {
+    auto rowCount = resultDataSet_->rowSize();
+    collectOneRow(context_->isIntId(), context_->vIdLen());
+    if (topN_ && resultDataSet_->rowSize() > rowCount) {
+      heap_.push(std::move(resultDataSet_->rows.back()));
+      resultDataSet_->rows.pop_back();
+    }
+  }
+
+ public:
   void collectOneRow(bool isIntId, std::size_t vIdLen) {
     List row;
     nebula::cpp2::ErrorCode ret = nebula::cpp2::ErrorCode::SUCCEEDED;
@@ -325,6 +487,12 @@ class ScanEdgePropNode : public QueryNode<Cursor> {
   nebula::DataSet* resultDataSet_;
   StorageExpressionContext* expCtx_{nullptr};
   Expression* filter_{nullptr};
+  // the column index and direction to sort the rows
+  const std::vector<std::pair<size_t, cpp2::OrderDirection>>* orderBy_{nullptr};
+  // The index of the only edge type scanned, which has a key for each edge of the type
+  std::optional<IndexID> typeIndex_;
+  bool topN_{false};
+  TopNHeap<Row> heap_;
 };
 
 }  // namespace storage
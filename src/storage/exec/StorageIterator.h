@@ -8,9 +8,13 @@
 
 #include "codec/RowReaderWrapper.h"
 #include "common/base/Base.h"
+#include "common/expression/Expression.h"
+#include "common/time/Duration.h"
+#include "common/utils/NebulaKeyUtils.h"
 #include "kvstore/KVIterator.h"
 #include "storage/CommonUtils.h"
 #include "storage/StorageFlags.h"
+#include "storage/context/StorageExpressionContext.h"
 namespace nebula {
 namespace storage {
 
@@ -74,13 +78,29 @@ class SingleEdgeIterator : public StorageIterator {
    * @param edgeType EdgeType to be read.
    * @param schemas EdgeType's all version schemas.
    * @param ttl
+   * @param keyCtx Expression context to evaluate the key filter.
+   * @param keyFilter Filter only on the props in edge key, checked before decoding the value.
+   * @param keyOnly Whether only the props in edge key are read, if so the value is neither read nor
+   * decoded and the reader is always null. Must not be set if the edge has ttl.
+   * @param decodeDuration Time spent in decoding the values, only measured if it is not null.
    */
   SingleEdgeIterator(RuntimeContext* context,
                      std::unique_ptr<kvstore::KVIterator> iter,
                      EdgeType edgeType,
                      const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>* schemas,
-                     const std::optional<std::pair<std::string, int64_t>>* ttl)
-      : context_(context), iter_(std::move(iter)), edgeType_(edgeType), schemas_(schemas) {
+                     const std::optional<std::pair<std::string, int64_t>>* ttl,
+                     StorageExpressionContext* keyCtx = nullptr,
+                     Expression* keyFilter = nullptr,
+                     bool keyOnly = false,
+                     time::Duration* decodeDuration = nullptr)
+      : context_(context),
+        iter_(std::move(iter)),
+        edgeType_(edgeType),
+        schemas_(schemas),
+        keyCtx_(keyCtx),
+        keyFilter_(keyFilter),
+        keyOnly_(keyOnly),
+        decodeDuration_(decodeDuration) {
     CHECK(!!iter_);
     if (ttl->has_value()) {
       hasTtl_ = true;
@@ -93,7 +113,7 @@ class SingleEdgeIterator : public StorageIterator {
   }
 
   bool valid() const override {
-    return reader_ != nullptr;
+    return valid_;
   }
 
   void next() override {
@@ -101,6 +121,7 @@ class SingleEdgeIterator : public StorageIterator {
       iter_->next();
       if (!iter_->valid()) {
         reader_.reset();
+        valid_ = false;
         break;
       }
     } while (!check());
@@ -127,7 +148,40 @@ class SingleEdgeIterator : public StorageIterator {
    * @brief return true when the value iter to a valid edge value
    */
   bool check() {
-    reader_.reset(*schemas_, iter_->val());
+    valid_ = false;
+    if (context_ != nullptr &&
+        !context_->planContext_->mayContainVid(
+            NebulaKeyUtils::getDstId(context_->vIdLen(), iter_->key()))) {
+      reader_.reset();
+      return false;
+    }
+    if (keyFilter_ != nullptr) {
+      keyCtx_->resetEdgeKey(iter_->key());
+      auto ret = keyFilter_->eval(*keyCtx_).toBool();
+      if (!ret.isBool() || !ret.getBool()) {
+        reader_.reset();
+        return false;
+      }
+    }
+    if (keyOnly_) {
+      // The value, which could be a blob stored out of the sst, is not touched at all
+      reader_.reset();
+      valid_ = true;
+      return true;
+    }
+    if (hasTtl_ && CommonUtils::checkRowExpiredForTTL(
+                       schemas_->back().get(), iter_->val(), ttlDuration_)) {
+      reader_.reset();
+      return false;
+    }
+    auto val = iter_->val();
+    if (UNLIKELY(decodeDuration_ != nullptr)) {
+      decodeDuration_->resume();
+      reader_.reset(*schemas_, val);
+      decodeDuration_->pause();
+    } else {
+      reader_.reset(*schemas_, val);
+    }
     if (!reader_) {
       context_->resultStat_ = ResultStatus::ILLEGAL_DATA;
       return false;
@@ -139,6 +193,7 @@ class SingleEdgeIterator : public StorageIterator {
       return false;
     }
 
+    valid_ = true;
     return true;
   }
 
@@ -146,6 +201,11 @@ class SingleEdgeIterator : public StorageIterator {
   std::unique_ptr<kvstore::KVIterator> iter_;
   EdgeType edgeType_;
   const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>* schemas_ = nullptr;
+  StorageExpressionContext* keyCtx_{nullptr};
+  Expression* keyFilter_{nullptr};
+  bool keyOnly_{false};
+  time::Duration* decodeDuration_{nullptr};
+  bool valid_{false};
   bool hasTtl_ = false;
   std::string ttlCol_;
   int64_t ttlDuration_;
@@ -6,6 +6,9 @@
 #ifndef STORAGE_EXEC_STORAGEPLAN_H_
 #define STORAGE_EXEC_STORAGEPLAN_H_
 
+#include <folly/Executor.h>
+#include <folly/synchronization/Baton.h>
+
 #include "common/base/Base.h"
 #include "storage/CommonUtils.h"
 #include "storage/exec/RelNode.h"
@@ -13,6 +16,65 @@
 namespace nebula {
 namespace storage {
 
+/**
+ * @brief Run the independent tasks, e.g. the reads of the sibling nodes of a batch of vertices,
+ * concurrently on the executor, and return when all of them are done.
+ *
+ * The calling thread runs the tasks not yet picked up by the executor as well, and only waits for
+ * the ones being run by the other threads. So it never deadlocks even if it's one of the threads of
+ * a busy executor, and the tasks are run serially if no other thread is free.
+ *
+ * If any task throws, the others are still run, and the first exception is rethrown in the calling
+ * thread once all of them are done.
+ *
+ * @param executor Executor to run the tasks, run them in the calling thread if it's null
+ * @param tasks Tasks which could run concurrently
+ */
+inline void runConcurrently(folly::Executor* executor, std::vector<std::function<void()>> tasks) {
+  if (executor == nullptr || tasks.size() <= 1) {
+    for (auto& task : tasks) {
+      task();
+    }
+    return;
+  }
+  struct State {
+    std::vector<std::function<void()>> tasks;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    folly::Baton<> finished;
+    std::mutex lock;
+    std::exception_ptr error;
+  };
+  // The runners scheduled are still run after all the tasks are done, they only touch the state
+  auto state = std::make_shared<State>();
+  state->tasks = std::move(tasks);
+  auto run = [state]() {
+    auto num = state->tasks.size();
+    for (auto i = state->next++; i < num; i = state->next++) {
+      // A task throwing is still done, or the calling thread would wait for it forever
+      try {
+        state->tasks[i]();
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(state->lock);
+        if (!state->error) {
+          state->error = std::current_exception();
+        }
+      }
+      if (++state->done == num) {
+        state->finished.post();
+      }
+    }
+  };
+  for (size_t i = 1; i < state->tasks.size(); i++) {
+    executor->add(run);
+  }
+  run();
+  state->finished.wait();
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
 /**
  * @brief Storage query plan
  *
@@ -76,6 +138,13 @@ class StoragePlan {
     return nodes_.size() - 1;
   }
 
+  // Collect the stats of the nodes other than the duration, which cost more
+  void enableProfile() {
+    for (auto& node : nodes_) {
+      node->profile_ = true;
+    }
+  }
+
   RelNode<T>* getNode(size_t idx) {
     CHECK_LT(idx, nodes_.size());
     return nodes_[idx].get();
@@ -7,8 +7,12 @@
 #define STORAGE_EXEC_TAGNODE_H_
 
 #include "common/base/Base.h"
+#include "kvstore/RocksReadProfiler.h"
+#include "storage/StorageFlags.h"
 #include "storage/exec/RelNode.h"
 #include "storage/exec/StorageIterator.h"
+#include "storage/exec/StoragePlan.h"
+#include "storage/stats/StorageStats.h"
 
 namespace nebula {
 namespace storage {
@@ -63,8 +67,40 @@ class TagNode final : public IterateNode<VertexID> {
     VLOG(1) << "partId " << partId << ", vId " << vId << ", tagId " << tagId_ << ", prop size "
             << props_->size();
     key_ = NebulaKeyUtils::tagKey(context_->vIdLen(), partId, vId, tagId_);
-    ret = context_->env()->kvstore_->get(context_->spaceId(), partId, key_, &value_);
+    // The cache is only evicted by the writes on the leader, so it is bypassed on followers
+    auto readFromFollower = context_->readFromFollower(partId);
+    auto* vertexCache = readFromFollower ? nullptr : context_->env()->vertexCache_.get();
+    auto prefetched = prefetched_.find(key_);
+    if (prefetched != prefetched_.end()) {
+      if (prefetched->second.has_value()) {
+        value_ = *prefetched->second;
+        resetReader();
+      }
+      // regard key not found as succeed as well, upper node will handle it
+      return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+    uint64_t version = 0;
+    if (vertexCache != nullptr) {
+      auto row = vertexCache->get(context_->spaceId(), partId, vId, tagId_, &version);
+      if (row != nullptr) {
+        stats::StatsManager::addValue(kNumVertexCacheHits);
+        value_ = *row;
+        resetReader();
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+      }
+      stats::StatsManager::addValue(kNumVertexCacheMisses);
+    }
+    ret = context_->env()->kvstore_->get(
+        context_->spaceId(), partId, key_, &value_, readFromFollower);
     if (ret == nebula::cpp2::ErrorCode::SUCCEEDED) {
+      if (vertexCache != nullptr) {
+        vertexCache->insert(context_->spaceId(),
+                            partId,
+                            vId,
+                            tagId_,
+                            std::make_shared<const std::string>(value_),
+                            version);
+      }
       return doExecute(key_, value_);
     } else if (ret == nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
       // regard key not found as succeed as well, upper node will handle it
@@ -73,6 +109,107 @@ class TagNode final : public IterateNode<VertexID> {
     return ret;
   }
 
+  /**
+   * @brief Read the tag of the vertices in one batched multiGet, the later doExecute of these
+   * vertices are served by the prefetched values. The vertices in cache are not read again, and
+   * the keys failed to read are read by doExecute one by one.
+   *
+   * @param partId Partition of the vertices
+   * @param vIds Vertices to read
+   */
+  void prefetch(PartitionID partId, const std::vector<VertexID>& vIds) {
+    prefetched_.clear();
+    auto readFromFollower = context_->readFromFollower(partId);
+    auto* vertexCache = readFromFollower ? nullptr : context_->env()->vertexCache_.get();
+    std::vector<std::string> keys;
+    std::vector<std::pair<const VertexID*, uint64_t>> misses;
+    std::unordered_set<std::string> visited;
+    for (const auto& vId : vIds) {
+      auto key = NebulaKeyUtils::tagKey(context_->vIdLen(), partId, vId, tagId_);
+      if (!visited.emplace(key).second) {
+        continue;
+      }
+      uint64_t version = 0;
+      if (vertexCache != nullptr) {
+        auto row = vertexCache->get(context_->spaceId(), partId, vId, tagId_, &version);
+        if (row != nullptr) {
+          stats::StatsManager::addValue(kNumVertexCacheHits);
+          prefetched_.emplace(std::move(key), *row);
+          continue;
+        }
+        stats::StatsManager::addValue(kNumVertexCacheMisses);
+      }
+      keys.emplace_back(std::move(key));
+      misses.emplace_back(&vId, version);
+    }
+    if (keys.empty()) {
+      return;
+    }
+
+    std::vector<std::string> values;
+    auto ret = context_->env()->kvstore_->multiGet(
+        context_->spaceId(), partId, keys, &values, readFromFollower);
+    if (ret.first != nebula::cpp2::ErrorCode::SUCCEEDED &&
+        ret.first != nebula::cpp2::ErrorCode::E_PARTIAL_RESULT) {
+      return;
+    }
+    const auto& status = ret.second;
+    for (size_t i = 0; i < keys.size(); i++) {
+      if (status[i].ok()) {
+        if (vertexCache != nullptr) {
+          vertexCache->insert(context_->spaceId(),
+                              partId,
+                              *misses[i].first,
+                              tagId_,
+                              std::make_shared<const std::string>(values[i]),
+                              misses[i].second);
+        }
+        prefetched_.emplace(std::move(keys[i]), std::move(values[i]));
+      } else if (status[i].isKeyNotFound()) {
+        prefetched_.emplace(std::move(keys[i]), std::nullopt);
+      }
+    }
+  }
+
+  /**
+   * @brief Prefetch the tags of the vertices by all the tag nodes, each tag is read by its own
+   * multiGet concurrently on the executor, instead of one after another for each vertex.
+   *
+   * @param executor Executor to read the tags, e.g. the reader pool
+   * @param tagNodes Tag nodes to prefetch
+   * @param partId Partition of the vertices
+   * @param vIds Vertices to read
+   * @param addReadStats Take the stats of the reads on the other threads of the executor, which
+   * are not seen by the profiler of the calling thread, the reads are not profiled if it's empty
+   */
+  static void prefetch(
+      folly::Executor* executor,
+      const std::vector<TagNode*>& tagNodes,
+      PartitionID partId,
+      const std::vector<VertexID>& vIds,
+      const std::function<void(const std::map<std::string, int64_t>&)>& addReadStats = nullptr) {
+    if (vIds.empty()) {
+      return;
+    }
+    auto caller = std::this_thread::get_id();
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(tagNodes.size());
+    for (auto* tagNode : tagNodes) {
+      tasks.emplace_back([tagNode, partId, &vIds, caller, &addReadStats]() {
+        // The perf context of rocksdb is thread local
+        std::optional<kvstore::RocksReadProfiler> readProfiler;
+        if (addReadStats && std::this_thread::get_id() != caller) {
+          readProfiler.emplace();
+        }
+        tagNode->prefetch(partId, vIds);
+        if (readProfiler.has_value()) {
+          addReadStats(readProfiler->stats());
+        }
+      });
+    }
+    runConcurrently(FLAGS_read_tags_concurrently ? executor : nullptr, std::move(tasks));
+  }
+
   /**
    * @brief For resuming from a breakpoint.
    *
@@ -136,10 +273,16 @@ class TagNode final : public IterateNode<VertexID> {
     key_.clear();
     value_.clear();
     reader_.reset();
+    prefetched_.clear();
   }
 
  private:
   void resetReader() {
+    if (ttl_.has_value() && CommonUtils::checkRowExpiredForTTL(
+                                schemas_->back().get(), value_, ttl_.value().second)) {
+      reader_.reset();
+      return;
+    }
     reader_.reset(*schemas_, value_);
     if (!reader_ ||
         (ttl_.has_value() &&
@@ -165,6 +308,8 @@ class TagNode final : public IterateNode<VertexID> {
   std::string key_;
   std::string value_;
   RowReaderWrapper reader_;
+  // The values read by prefetch of tag key, std::nullopt if the key doesn't exist
+  std::unordered_map<std::string, std::optional<std::string>> prefetched_;
 };
 
 }  // namespace storage
@@ -6,10 +6,15 @@
 #ifndef STORAGE_EXEC_UPDATENODE_H_
 #define STORAGE_EXEC_UPDATENODE_H_
 
+#include "codec/RowWriterV3.h"
 #include "common/base/Base.h"
+#include "common/expression/ArithmeticExpression.h"
+#include "common/expression/ConstantExpression.h"
 #include "common/expression/Expression.h"
+#include "common/expression/PropertyExpression.h"
 #include "common/utils/OperationKeyUtils.h"
 #include "kvstore/LogEncoder.h"
+#include "storage/MergeOperator.h"
 #include "storage/StorageFlags.h"
 #include "storage/context/StorageExpressionContext.h"
 #include "storage/exec/FilterNode.h"
@@ -156,6 +161,147 @@ class UpdateNode : public RelNode<T> {
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   }
 
+  /**
+   * @brief Allow the update to be written as a merge operand, which is only done when there is no
+   * condition and nothing to return.
+   */
+  void setCounterMerge(bool counterMerge) {
+    counterMerge_ = counterMerge;
+  }
+
+  /**
+   * @brief Build the merge operand if all the updated props are in the form of `x = x + c` or
+   * `x = x - c`, in which c is a numeric constant. Must be called after the latest schema is got.
+   *
+   * @param sym Name of the tag or edge
+   * @param schemaId Tag id or edge type
+   * @return std::optional<CounterOperand> The operand, or none if it should be updated as usual.
+   */
+  std::optional<CounterOperand> counterOperand(const std::string& sym, int32_t schemaId) {
+    if (!counterMerge_ || insertable_ || updatedProps_.empty()) {
+      return std::nullopt;
+    }
+    CounterOperand operand;
+    operand.spaceId = context_->spaceId();
+    operand.isEdge = isEdge_;
+    operand.schemaId = schemaId;
+    ObjectPool pool;
+    for (auto& prop : updatedProps_) {
+      const auto& name = prop.get_name();
+      auto field = schema_->field(name);
+      auto exp = Expression::decode(&pool, prop.get_value());
+      if (field == nullptr || exp == nullptr) {
+        return std::nullopt;
+      }
+      auto delta = counterDelta(exp, sym, name);
+      if (!delta.has_value()) {
+        return std::nullopt;
+      }
+      auto type = field->type();
+      if (type == nebula::cpp2::PropertyType::DOUBLE || type == nebula::cpp2::PropertyType::FLOAT) {
+        if (delta->isInt()) {
+          delta = static_cast<double>(delta->getInt());
+        }
+      } else if (type != nebula::cpp2::PropertyType::INT64 || !delta->isInt()) {
+        return std::nullopt;
+      }
+      operand.deltas.emplace_back(name, std::move(delta).value());
+    }
+    return operand;
+  }
+
+  /**
+   * @brief Whether any of the updated props is a column of the index or included by it
+   */
+  bool updatesIndex(const meta::cpp2::IndexItem& index) const {
+    auto contains = [this](const std::vector<meta::cpp2::ColumnDef>& cols) {
+      for (const auto& col : cols) {
+        for (const auto& prop : updatedProps_) {
+          if (col.get_name() == prop.get_name()) {
+            return true;
+          }
+        }
+      }
+      return false;
+    };
+    return contains(index.get_fields()) ||
+           (index.include_fields_ref().has_value() && contains(*index.include_fields_ref()));
+  }
+
+  /**
+   * @brief The constant added to the prop by the expression
+   */
+  static std::optional<Value> counterDelta(Expression* exp,
+                                           const std::string& sym,
+                                           const std::string& name) {
+    auto kind = exp->kind();
+    if (kind != Expression::Kind::kAdd && kind != Expression::Kind::kMinus) {
+      return std::nullopt;
+    }
+    auto isProp = [&sym, &name](const Expression* e) {
+      auto k = e->kind();
+      if (k != Expression::Kind::kSrcProperty && k != Expression::Kind::kTagProperty &&
+          k != Expression::Kind::kEdgeProperty) {
+        return false;
+      }
+      auto prop = static_cast<const PropertyExpression*>(e);
+      return prop->sym() == sym && prop->prop() == name;
+    };
+    auto isNumber = [](const Expression* e) {
+      if (e->kind() != Expression::Kind::kConstant) {
+        return false;
+      }
+      const auto& v = static_cast<const ConstantExpression*>(e)->value();
+      return v.isInt() || v.isFloat();
+    };
+    auto arith = static_cast<ArithmeticExpression*>(exp);
+    const Expression* constant = nullptr;
+    if (isProp(arith->left()) && isNumber(arith->right())) {
+      constant = arith->right();
+    } else if (kind == Expression::Kind::kAdd && isNumber(arith->left()) &&
+               isProp(arith->right())) {
+      constant = arith->left();
+    } else {
+      return std::nullopt;
+    }
+    auto delta = static_cast<const ConstantExpression*>(constant)->value();
+    if (kind == Expression::Kind::kMinus) {
+      if (delta.isFloat()) {
+        return -delta.getFloat();
+      }
+      if (delta.getInt() == std::numeric_limits<int64_t>::min()) {
+        return std::nullopt;
+      }
+      return -delta.getInt();
+    }
+    return delta;
+  }
+
+  /**
+   * @brief Write the merge operand of the row read by the filter node, the row must exist.
+   */
+  nebula::cpp2::ErrorCode mergeCounters(PartitionID partId, CounterOperand&& operand) {
+    if (this->context_->resultStat_ == ResultStatus::ILLEGAL_DATA) {
+      return nebula::cpp2::ErrorCode::E_INVALID_DATA;
+    }
+    if (!filterNode_->valid()) {
+      return nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND;
+    }
+    kvstore::BatchHolder batchHolder;
+    batchHolder.merge(filterNode_->key().str(), operand.encode());
+
+    auto ret = nebula::cpp2::ErrorCode::SUCCEEDED;
+    folly::Baton<true, std::atomic> baton;
+    auto callback = [&ret, &baton](nebula::cpp2::ErrorCode code) {
+      ret = code;
+      baton.post();
+    };
+    context_->env()->kvstore_->asyncAppendBatch(
+        context_->spaceId(), partId, encodeBatchValue(batchHolder.getBatch()), callback);
+    baton.wait();
+    return ret;
+  }
+
  protected:
   // ============================ input
   // =====================================================
@@ -194,6 +340,7 @@ class UpdateNode : public RelNode<T> {
 
   StorageExpressionContext* expCtx_;
   bool isEdge_{false};
+  bool counterMerge_{false};
 };
 
 /**
@@ -228,9 +375,14 @@ class UpdateTagNode : public UpdateNode<VertexID> {
     CHECK_NOTNULL(context_->env()->kvstore_);
     IndexCountWrapper wrapper(context_->env());
 
+    auto lockKey = std::make_tuple(context_->spaceId(), partId, tagId_, vId);
     // Update is read-modify-write, which is an atomic operation.
-    std::vector<VMLI> dummyLock = {std::make_tuple(context_->spaceId(), partId, tagId_, vId)};
-    nebula::MemoryLockGuard<VMLI> lg(context_->env()->verticesML_.get(), std::move(dummyLock));
+    std::vector<VMLI> dummyLock = {std::move(lockKey)};
+    nebula::MemoryLockGuard<VMLI> lg(context_->env()->verticesML_.get(),
+                                     std::move(dummyLock),
+                                     false,
+                                     true,
+                                     std::chrono::milliseconds(FLAGS_update_lock_wait_ms));
     if (!lg) {
       auto conflict = lg.conflictKey();
       LOG(ERROR) << "vertex conflict " << std::get<0>(conflict) << ":" << std::get<1>(conflict)
@@ -238,6 +390,18 @@ class UpdateTagNode : public UpdateNode<VertexID> {
       return nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
     }
 
+    auto operand = tagCounterOperand();
+    if (operand.has_value()) {
+      // Increments are merged into the row without the read-modify-write, the row is only read to
+      // check that it exists. The lock is held until the merge is committed, so that it's not
+      // overwritten by a read-modify-write of the row in between
+      auto ret = RelNode::doExecute(partId, vId);
+      if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        return ret;
+      }
+      return this->mergeCounters(partId, std::move(operand).value());
+    }
+
     auto ret = RelNode::doExecute(partId, vId);
     if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
       return ret;
@@ -308,6 +472,22 @@ class UpdateTagNode : public UpdateNode<VertexID> {
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   }
 
+  /**
+   * @brief The merge operand if the tag could be updated by merge
+   */
+  std::optional<CounterOperand> tagCounterOperand() {
+    if (!counterMerge_ || tagContext_->ttlInfo_.count(tagId_) > 0 ||
+        getLatestTagSchemaAndName() != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return std::nullopt;
+    }
+    for (const auto& index : indexes_) {
+      if (index->get_schema_id().get_tag_id() == tagId_ && updatesIndex(*index)) {
+        return std::nullopt;
+      }
+    }
+    return counterOperand(tagName_, tagId_);
+  }
+
   /**
    * @brief Insert props row.
    *
@@ -421,13 +601,21 @@ class UpdateTagNode : public UpdateNode<VertexID> {
     }
 
     auto nVal = rowWriter_->moveEncodedStr();
+    if (FLAGS_row_format_version == 3) {
+      wRet = RowWriterV3::upgrade(schema_, nVal);
+      if (wRet != WriteResult::SUCCEEDED) {
+        LOG(ERROR) << "Encode row failed ";
+        return std::nullopt;
+      }
+    }
 
     // update index if exists
     // Note: when insert_ is true, either there is no origin data or TTL expired
     // when there is no origin data, there is no the old index.
     // when TTL exists, there is no index.
     // when insert_ is true, not old index, val_ is empty.
-    if (!indexes_.empty()) {
+    // The indexes of a split vertex are only in its own part.
+    if (!indexes_.empty() && !context_->env()->isMirrorVertex(context_->spaceId(), partId, vId)) {
       RowReaderWrapper nReader;
       for (auto& index : indexes_) {
         if (tagId_ == index->get_schema_id().get_tag_id()) {
@@ -440,10 +628,10 @@ class UpdateTagNode : public UpdateNode<VertexID> {
             auto ois = indexKeys(partId, vId, reader_, index);
             if (!ois.empty()) {
               auto iState = context_->env()->getIndexState(context_->spaceId(), partId);
-              if (context_->env()->checkRebuilding(iState)) {
-                auto deleteOpKey = OperationKeyUtils::deleteOperationKey(partId);
+              if (context_->env()->checkIndexLogged(iState, *index)) {
                 for (auto& oi : ois) {
-                  batchHolder->put(std::string(deleteOpKey), std::move(oi));
+                  auto deleteOpKey = OperationKeyUtils::deleteOperationKey(partId, oi);
+                  batchHolder->put(std::move(deleteOpKey), std::move(oi));
                 }
               } else if (context_->env()->checkIndexLocked(iState)) {
                 LOG(ERROR) << "The index has been locked: " << index->get_index_name();
@@ -467,10 +655,9 @@ class UpdateTagNode : public UpdateNode<VertexID> {
           }
           auto nis = indexKeys(partId, vId, nReader.get(), index);
           if (!nis.empty()) {
-            auto v = CommonUtils::ttlValue(schema_, nReader.get());
-            auto niv = v.ok() ? IndexKeyUtils::indexVal(std::move(v).value()) : "";
+            auto niv = CommonUtils::indexVal(schema_, nReader.get(), index.get());
             auto indexState = context_->env()->getIndexState(context_->spaceId(), partId);
-            if (context_->env()->checkRebuilding(indexState)) {
+            if (context_->env()->checkIndexLogged(indexState, *index)) {
               for (auto& ni : nis) {
                 auto modifyKey = OperationKeyUtils::modifyOperationKey(partId, std::move(ni));
                 batchHolder->put(std::move(modifyKey), std::string(niv));
@@ -548,14 +735,19 @@ class UpdateEdgeNode : public UpdateNode<cpp2::EdgeKey> {
     auto ret = nebula::cpp2::ErrorCode::SUCCEEDED;
     IndexCountWrapper wrapper(context_->env());
 
+    auto lockKey = std::make_tuple(context_->spaceId(),
+                                   partId,
+                                   edgeKey.get_src().getStr(),
+                                   edgeKey.get_edge_type(),
+                                   edgeKey.get_ranking(),
+                                   edgeKey.get_dst().getStr());
     // Update is read-modify-write, which is an atomic operation.
-    std::vector<EMLI> dummyLock = {std::make_tuple(context_->spaceId(),
-                                                   partId,
-                                                   edgeKey.get_src().getStr(),
-                                                   edgeKey.get_edge_type(),
-                                                   edgeKey.get_ranking(),
-                                                   edgeKey.get_dst().getStr())};
-    nebula::MemoryLockGuard<EMLI> lg(context_->env()->edgesML_.get(), std::move(dummyLock));
+    std::vector<EMLI> dummyLock = {std::move(lockKey)};
+    nebula::MemoryLockGuard<EMLI> lg(context_->env()->edgesML_.get(),
+                                     std::move(dummyLock),
+                                     false,
+                                     true,
+                                     std::chrono::milliseconds(FLAGS_update_lock_wait_ms));
     if (!lg) {
       auto conflict = lg.conflictKey();
       LOG(ERROR) << "edge conflict " << std::get<0>(conflict) << ":" << std::get<1>(conflict) << ":"
@@ -564,6 +756,18 @@ class UpdateEdgeNode : public UpdateNode<cpp2::EdgeKey> {
       return nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
     }
 
+    auto operand = edgeCounterOperand();
+    if (operand.has_value() && *edgeKey.edge_type_ref() == edgeType_) {
+      // Increments are merged into the row without the read-modify-write, the row is only read to
+      // check that it exists. The lock is held until the merge is committed, so that it's not
+      // overwritten by a read-modify-write of the row in between
+      ret = RelNode::doExecute(partId, edgeKey);
+      if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        return ret;
+      }
+      return this->mergeCounters(partId, std::move(operand).value());
+    }
+
     auto op = [&partId, &edgeKey, this]() -> std::optional<std::string> {
       this->exeResult_ = RelNode::doExecute(partId, edgeKey);
       if (this->exeResult_ == nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -650,6 +854,22 @@ class UpdateEdgeNode : public UpdateNode<cpp2::EdgeKey> {
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   }
 
+  /**
+   * @brief The merge operand if the edge could be updated by merge
+   */
+  std::optional<CounterOperand> edgeCounterOperand() {
+    if (!counterMerge_ || edgeContext_->ttlInfo_.count(std::abs(edgeType_)) > 0 ||
+        getLatestEdgeSchemaAndName() != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return std::nullopt;
+    }
+    for (const auto& index : indexes_) {
+      if (index->get_schema_id().get_edge_type() == edgeType_ && updatesIndex(*index)) {
+        return std::nullopt;
+      }
+    }
+    return counterOperand(edgeName_, std::abs(edgeType_));
+  }
+
   /**
    * @brief Insert props row
    *
@@ -772,6 +992,13 @@ class UpdateEdgeNode : public UpdateNode<cpp2::EdgeKey> {
     }
 
     auto nVal = rowWriter_->moveEncodedStr();
+    if (FLAGS_row_format_version == 3) {
+      wRet = RowWriterV3::upgrade(schema_, nVal);
+      if (wRet != WriteResult::SUCCEEDED) {
+        VLOG(1) << "Encode row failed ";
+        return std::nullopt;
+      }
+    }
     // update index if exists
     // Note: when insert_ is true, either there is no origin data or TTL expired
     // when there is no origin data, there is no the old index.
@@ -790,10 +1017,10 @@ class UpdateEdgeNode : public UpdateNode<cpp2::EdgeKey> {
             auto ois = indexKeys(partId, reader_, edgeKey, index);
             if (!ois.empty()) {
               auto iState = context_->env()->getIndexState(context_->spaceId(), partId);
-              if (context_->env()->checkRebuilding(iState)) {
-                auto deleteOpKey = OperationKeyUtils::deleteOperationKey(partId);
+              if (context_->env()->checkIndexLogged(iState, *index)) {
                 for (auto& oi : ois) {
-                  batchHolder->put(std::string(deleteOpKey), std::move(oi));
+                  auto deleteOpKey = OperationKeyUtils::deleteOperationKey(partId, oi);
+                  batchHolder->put(std::move(deleteOpKey), std::move(oi));
                 }
               } else if (context_->env()->checkIndexLocked(iState)) {
                 LOG(ERROR) << "The index has been locked: " << index->get_index_name();
@@ -817,10 +1044,9 @@ class UpdateEdgeNode : public UpdateNode<cpp2::EdgeKey> {
           }
           auto niks = indexKeys(partId, nReader.get(), edgeKey, index);
           if (!niks.empty()) {
-            auto v = CommonUtils::ttlValue(schema_, nReader.get());
-            auto niv = v.ok() ? IndexKeyUtils::indexVal(std::move(v).value()) : "";
+            auto niv = CommonUtils::indexVal(schema_, nReader.get(), index.get());
             auto indexState = context_->env()->getIndexState(context_->spaceId(), partId);
-            if (context_->env()->checkRebuilding(indexState)) {
+            if (context_->env()->checkIndexLogged(indexState, *index)) {
               for (auto& nik : niks) {
                 auto modifyKey = OperationKeyUtils::modifyOperationKey(partId, std::move(nik));
                 batchHolder->put(std::move(modifyKey), std::string(niv));
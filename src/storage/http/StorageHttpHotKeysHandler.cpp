@@ -0,0 +1,104 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/http/StorageHttpHotKeysHandler.h"
+
+#include <folly/Conv.h>
+#include <folly/json.h>
+#include <proxygen/httpserver/RequestHandler.h>
+#include <proxygen/httpserver/ResponseBuilder.h>
+#include <proxygen/lib/http/ProxygenErrorEnum.h>
+
+#include "common/base/Base.h"
+
+namespace nebula {
+namespace storage {
+
+using proxygen::HTTPMessage;
+using proxygen::HTTPMethod;
+using proxygen::ProxygenError;
+using proxygen::ResponseBuilder;
+using proxygen::UpgradeProtocol;
+
+void StorageHttpHotKeysHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
+  if (headers->getMethod().value() != HTTPMethod::GET) {
+    // Unsupported method
+    resp_ = "Not supported";
+    err_ = HttpCode::E_UNSUPPORTED_METHOD;
+    return;
+  }
+  if (hotKeys_ == nullptr) {
+    resp_ = "Hot keys are not tracked, turn on enable_hot_keys";
+    err_ = HttpCode::E_ILLEGAL_ARGUMENT;
+    return;
+  }
+
+  std::string kind;
+  if (headers->hasQueryParam("kind")) {
+    kind = headers->getQueryParam("kind");
+    if (hotKeys_->tracker(kind) == nullptr) {
+      resp_ = "Unknown kind: " + kind;
+      err_ = HttpCode::E_ILLEGAL_ARGUMENT;
+      return;
+    }
+  }
+  size_t top = kDefaultTop;
+  if (headers->hasQueryParam("top")) {
+    auto ret = folly::tryTo<size_t>(headers->getQueryParam("top"));
+    if (!ret.hasValue()) {
+      resp_ = "Illegal top: " + headers->getQueryParam("top");
+      err_ = HttpCode::E_ILLEGAL_ARGUMENT;
+      return;
+    }
+    top = ret.value();
+  }
+  GraphSpaceID spaceId = 0;
+  if (headers->hasQueryParam("space")) {
+    auto spaceName = headers->getQueryParam("space");
+    auto ret = schemaMan_->toGraphSpaceID(spaceName);
+    if (!ret.ok()) {
+      resp_ = "Space not found: " + spaceName;
+      err_ = HttpCode::E_ILLEGAL_ARGUMENT;
+      return;
+    }
+    spaceId = ret.value();
+  }
+  resp_ = folly::toPrettyJson(hotKeys_->toJson(kind, top, spaceId));
+}
+
+void StorageHttpHotKeysHandler::onBody(std::unique_ptr<folly::IOBuf>) noexcept {
+  // Do nothing, we only support GET
+}
+
+void StorageHttpHotKeysHandler::onEOM() noexcept {
+  switch (err_) {
+    case HttpCode::E_UNSUPPORTED_METHOD:
+      ResponseBuilder(downstream_).status(405, "Method not allowed").body(resp_).sendWithEOM();
+      return;
+    case HttpCode::E_ILLEGAL_ARGUMENT:
+      ResponseBuilder(downstream_).status(400, "Illegal argument").body(resp_).sendWithEOM();
+      return;
+    default:
+      break;
+  }
+
+  ResponseBuilder(downstream_).status(200, "OK").body(resp_).sendWithEOM();
+}
+
+void StorageHttpHotKeysHandler::onUpgrade(UpgradeProtocol) noexcept {
+  // Do nothing
+}
+
+void StorageHttpHotKeysHandler::requestComplete() noexcept {
+  delete this;
+}
+
+void StorageHttpHotKeysHandler::onError(ProxygenError error) noexcept {
+  LOG(ERROR) << "Web service StorageHttpHotKeysHandler got error: "
+             << proxygen::getErrorString(error);
+}
+
+}  // namespace storage
+}  // namespace nebula
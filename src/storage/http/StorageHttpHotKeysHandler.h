@@ -0,0 +1,52 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_HTTP_STORAGEHTTPHOTKEYSHANDLER_H
+#define STORAGE_HTTP_STORAGEHTTPHOTKEYSHANDLER_H
+
+#include <proxygen/httpserver/RequestHandler.h>
+
+#include "common/base/Base.h"
+#include "common/meta/SchemaManager.h"
+#include "storage/stats/HotKeys.h"
+#include "webservice/Common.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief Show the hot vertices and parts of the requests to this storaged in json, e.g.
+ * http://ip:port/hot_keys?kind=get_neighbors&top=10&space=xxx, all of the parameters are
+ * optional.
+ */
+class StorageHttpHotKeysHandler : public proxygen::RequestHandler {
+ public:
+  StorageHttpHotKeysHandler(meta::SchemaManager* schemaMan, HotKeys* hotKeys)
+      : schemaMan_(schemaMan), hotKeys_(hotKeys) {}
+
+  void onRequest(std::unique_ptr<proxygen::HTTPMessage> headers) noexcept override;
+
+  void onBody(std::unique_ptr<folly::IOBuf> body) noexcept override;
+
+  void onEOM() noexcept override;
+
+  void onUpgrade(proxygen::UpgradeProtocol proto) noexcept override;
+
+  void requestComplete() noexcept override;
+
+  void onError(proxygen::ProxygenError err) noexcept override;
+
+ private:
+  static constexpr size_t kDefaultTop = 20;
+
+  meta::SchemaManager* schemaMan_ = nullptr;
+  HotKeys* hotKeys_ = nullptr;
+  HttpCode err_{HttpCode::SUCCEEDED};
+  std::string resp_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif
@@ -0,0 +1,86 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/http/StorageHttpRaftHandler.h"
+
+#include <folly/json.h>
+#include <proxygen/httpserver/RequestHandler.h>
+#include <proxygen/httpserver/ResponseBuilder.h>
+#include <proxygen/lib/http/ProxygenErrorEnum.h>
+
+#include "common/base/Base.h"
+#include "kvstore/NebulaStore.h"
+
+namespace nebula {
+namespace storage {
+
+using proxygen::HTTPMessage;
+using proxygen::HTTPMethod;
+using proxygen::ProxygenError;
+using proxygen::ResponseBuilder;
+using proxygen::UpgradeProtocol;
+
+void StorageHttpRaftHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
+  if (headers->getMethod().value() != HTTPMethod::GET) {
+    // Unsupported method
+    resp_ = "Not supported";
+    err_ = HttpCode::E_UNSUPPORTED_METHOD;
+    return;
+  }
+  auto* store = dynamic_cast<kvstore::NebulaStore*>(kv_);
+  if (store == nullptr) {
+    resp_ = "The kvstore is not replicated by raft";
+    err_ = HttpCode::E_ILLEGAL_ARGUMENT;
+    return;
+  }
+
+  GraphSpaceID spaceId = 0;
+  if (headers->hasQueryParam("space")) {
+    auto spaceName = headers->getQueryParam("space");
+    auto ret = schemaMan_->toGraphSpaceID(spaceName);
+    if (!ret.ok()) {
+      resp_ = "Space not found: " + spaceName;
+      err_ = HttpCode::E_ILLEGAL_ARGUMENT;
+      return;
+    }
+    spaceId = ret.value();
+  }
+  resp_ = folly::toPrettyJson(store->replicationStats(spaceId));
+}
+
+void StorageHttpRaftHandler::onBody(std::unique_ptr<folly::IOBuf>) noexcept {
+  // Do nothing, we only support GET
+}
+
+void StorageHttpRaftHandler::onEOM() noexcept {
+  switch (err_) {
+    case HttpCode::E_UNSUPPORTED_METHOD:
+      ResponseBuilder(downstream_).status(405, "Method not allowed").body(resp_).sendWithEOM();
+      return;
+    case HttpCode::E_ILLEGAL_ARGUMENT:
+      ResponseBuilder(downstream_).status(400, "Illegal argument").body(resp_).sendWithEOM();
+      return;
+    default:
+      break;
+  }
+
+  ResponseBuilder(downstream_).status(200, "OK").body(resp_).sendWithEOM();
+}
+
+void StorageHttpRaftHandler::onUpgrade(UpgradeProtocol) noexcept {
+  // Do nothing
+}
+
+void StorageHttpRaftHandler::requestComplete() noexcept {
+  delete this;
+}
+
+void StorageHttpRaftHandler::onError(ProxygenError error) noexcept {
+  LOG(ERROR) << "Web service StorageHttpRaftHandler got error: "
+             << proxygen::getErrorString(error);
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,50 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_HTTP_STORAGEHTTPRAFTHANDLER_H
+#define STORAGE_HTTP_STORAGEHTTPRAFTHANDLER_H
+
+#include <proxygen/httpserver/RequestHandler.h>
+
+#include "common/base/Base.h"
+#include "common/meta/SchemaManager.h"
+#include "kvstore/KVStore.h"
+#include "webservice/Common.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief Show the replication state of the raft parts of this storaged in json, e.g. the commit
+ * lag, follower lag and pending logs of each part, by http://ip:port/raft?space=xxx, the space is
+ * optional.
+ */
+class StorageHttpRaftHandler : public proxygen::RequestHandler {
+ public:
+  StorageHttpRaftHandler(meta::SchemaManager* schemaMan, kvstore::KVStore* kv)
+      : schemaMan_(schemaMan), kv_(kv) {}
+
+  void onRequest(std::unique_ptr<proxygen::HTTPMessage> headers) noexcept override;
+
+  void onBody(std::unique_ptr<folly::IOBuf> body) noexcept override;
+
+  void onEOM() noexcept override;
+
+  void onUpgrade(proxygen::UpgradeProtocol proto) noexcept override;
+
+  void requestComplete() noexcept override;
+
+  void onError(proxygen::ProxygenError err) noexcept override;
+
+ private:
+  meta::SchemaManager* schemaMan_ = nullptr;
+  kvstore::KVStore* kv_ = nullptr;
+  HttpCode err_{HttpCode::SUCCEEDED};
+  std::string resp_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif
@@ -0,0 +1,131 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/index/IndexLogApplier.h"
+
+#include <folly/synchronization/Baton.h>
+
+#include "common/time/WallClock.h"
+#include "common/utils/OperationKeyUtils.h"
+#include "kvstore/LogEncoder.h"
+#include "storage/StorageFlags.h"
+#include "storage/stats/StorageStats.h"
+
+namespace nebula {
+namespace storage {
+
+bool IndexLogApplier::start() {
+  worker_ = std::make_unique<thread::GenericWorker>();
+  if (!worker_->start("index-log-applier")) {
+    LOG(ERROR) << "Start the index log applier failed";
+    return false;
+  }
+  worker_->addRepeatTask(FLAGS_index_log_apply_interval_ms, &IndexLogApplier::applyAll, this);
+  return true;
+}
+
+void IndexLogApplier::stop() {
+  if (worker_ != nullptr) {
+    worker_->stop();
+    worker_->wait();
+    worker_.reset();
+  }
+}
+
+void IndexLogApplier::applyAll() {
+  std::unordered_map<GraphSpaceID, std::vector<meta::cpp2::LeaderInfo>> leaders;
+  env_->kvstore_->allLeader(leaders);
+  for (const auto& spaceLeaders : leaders) {
+    auto space = spaceLeaders.first;
+    if (!env_->hasAsyncIndex(space)) {
+      continue;
+    }
+    for (const auto& leader : spaceLeaders.second) {
+      auto part = leader.get_part_id();
+      // Only a batch of each part is applied in a round, so that a busy part doesn't delay others
+      auto ret = applyOnce(space, part);
+      if (!nebula::ok(ret)) {
+        VLOG(1) << "Apply the index log of space " << space << " part " << part << " failed, "
+                << apache::thrift::util::enumNameSafe(nebula::error(ret));
+      }
+    }
+  }
+}
+
+ErrorOr<nebula::cpp2::ErrorCode, int64_t> IndexLogApplier::applyOnce(GraphSpaceID space,
+                                                                     PartitionID part) {
+  std::lock_guard<std::mutex> guard(partLock(space, part));
+  if (env_->getIndexState(space, part) != IndexState::FINISHED) {
+    // The log is replayed by the rebuild task
+    return 0;
+  }
+
+  std::unique_ptr<kvstore::KVIterator> iter;
+  auto prefix = OperationKeyUtils::operationPrefix(part);
+  auto code = env_->kvstore_->prefix(space, part, prefix, &iter);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return code;
+  }
+  if (!iter->valid()) {
+    return 0;
+  }
+  auto now = time::WallClock::fastNowInMicroSec();
+  auto lagMs = std::max<int64_t>(now - OperationKeyUtils::getOperationTime(iter->key()), 0) / 1000;
+  stats::StatsManager::addValue(kIndexLogLagMs, lagMs);
+
+  kvstore::BatchHolder batchHolder;
+  size_t count = 0;
+  for (; iter->valid() && count < FLAGS_index_log_apply_batch_size; iter->next(), count++) {
+    auto opKey = iter->key();
+    auto opVal = iter->val();
+    if (OperationKeyUtils::isModifyOperation(opKey)) {
+      batchHolder.put(OperationKeyUtils::getOperationKey(opKey), opVal.str());
+    } else if (OperationKeyUtils::isDeleteOperation(opKey)) {
+      batchHolder.remove(opVal.str());
+    } else {
+      LOG(ERROR) << "Unknown operation in the index log of space " << space << " part " << part;
+    }
+    batchHolder.remove(opKey.str());
+  }
+  int64_t next = iter->valid() ? OperationKeyUtils::getOperationTime(iter->key()) : 0;
+
+  folly::Baton<true, std::atomic> baton;
+  env_->kvstore_->asyncAppendBatch(
+      space,
+      part,
+      encodeBatchValue(batchHolder.getBatch()),
+      [&code, &baton](nebula::cpp2::ErrorCode ret) {
+        code = ret;
+        baton.post();
+      });
+  baton.wait();
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return code;
+  }
+  stats::StatsManager::addValue(kNumIndexLogApplied, count);
+  return next;
+}
+
+bool IndexLogApplier::waitApplied(GraphSpaceID space, PartitionID part, int64_t timeoutMs) {
+  auto since = time::WallClock::fastNowInMicroSec();
+  auto deadline = time::WallClock::fastNowInMilliSec() + timeoutMs;
+  while (true) {
+    auto ret = applyOnce(space, part);
+    if (!nebula::ok(ret)) {
+      return false;
+    }
+    auto next = nebula::value(ret);
+    // The operations logged after the call are not waited for
+    if (next == 0 || next > since) {
+      return true;
+    }
+    if (time::WallClock::fastNowInMilliSec() >= deadline) {
+      return false;
+    }
+  }
+}
+
+}  // namespace storage
+}  // namespace nebula
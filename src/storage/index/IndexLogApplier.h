@@ -0,0 +1,76 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_INDEX_INDEXLOGAPPLIER_H_
+#define STORAGE_INDEX_INDEXLOGAPPLIER_H_
+
+#include <folly/hash/Hash.h>
+
+#include "common/base/Base.h"
+#include "common/base/ErrorOr.h"
+#include "common/thread/GenericWorker.h"
+#include "storage/CommonUtils.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief Apply the operation logs of the indexes maintained asynchronously, i.e. the ones created
+ * with `async_maintain = true`. The writes of these indexes only append the index keys to put or
+ * remove to the operation log of the part, the same one used when rebuilding indexes, so that a
+ * write costs no more than one key per index.
+ *
+ * The applier replays the logs of the parts led by this host every index_log_apply_interval_ms,
+ * in batches of index_log_apply_batch_size operations. The parts rebuilding indexes are skipped,
+ * whose logs are replayed by the rebuild task. The lag, i.e. the age of the oldest operation
+ * found, is exported as index_log_lag_ms.
+ */
+class IndexLogApplier final {
+ public:
+  explicit IndexLogApplier(StorageEnv* env) : env_(env) {}
+
+  ~IndexLogApplier() {
+    stop();
+  }
+
+  bool start();
+
+  void stop();
+
+  /**
+   * @brief Wait until the operations of the part logged before the call are applied, the operations
+   * are applied by the caller if they are not yet.
+   *
+   * @param timeoutMs The max time to wait
+   * @return Whether the operations are applied
+   */
+  bool waitApplied(GraphSpaceID space, PartitionID part, int64_t timeoutMs);
+
+  /**
+   * @brief Apply a batch of the operations of the part
+   *
+   * @return ErrorOr<nebula::cpp2::ErrorCode, int64_t> The time in microseconds of the first
+   * operation left, or 0 if all the operations are applied
+   */
+  ErrorOr<nebula::cpp2::ErrorCode, int64_t> applyOnce(GraphSpaceID space, PartitionID part);
+
+ private:
+  void applyAll();
+
+  std::mutex& partLock(GraphSpaceID space, PartitionID part) {
+    return locks_[folly::hash::hash_combine(space, part) % locks_.size()];
+  }
+
+ private:
+  StorageEnv* env_{nullptr};
+  std::unique_ptr<thread::GenericWorker> worker_;
+  // The operations of a part are applied by one thread at a time, otherwise an operation applied
+  // again could overwrite the later ones
+  std::array<std::mutex, 64> locks_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_INDEX_INDEXLOGAPPLIER_H_
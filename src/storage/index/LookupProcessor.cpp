@@ -7,12 +7,15 @@
 #include <thrift/lib/cpp2/protocol/JSONProtocol.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
+#include "common/time/WallClock.h"
 #include "folly/Likely.h"
 #include "interface/gen-cpp2/common_types.tcc"
 #include "interface/gen-cpp2/meta_types.tcc"
 #include "interface/gen-cpp2/storage_types.tcc"
+#include "kvstore/RocksReadProfiler.h"
 #include "storage/exec/IndexAggregateNode.h"
 #include "storage/exec/IndexDedupNode.h"
+#include "storage/exec/IndexIntersectNode.h"
 #include "storage/exec/IndexEdgeScanNode.h"
 #include "storage/exec/IndexLimitNode.h"
 #include "storage/exec/IndexNode.h"
@@ -20,6 +23,8 @@
 #include "storage/exec/IndexSelectionNode.h"
 #include "storage/exec/IndexTopNNode.h"
 #include "storage/exec/IndexVertexScanNode.h"
+#include "storage/index/IndexLogApplier.h"
+#include "storage/stats/StorageStats.h"
 namespace nebula {
 namespace storage {
 ProcessorCounters kLookupCounters;
@@ -68,6 +73,7 @@ void LookupProcessor::doProcess(const cpp2::LookupIndexRequest& req) {
     onFinished();
     return;
   }
+  waitIndexApplied(req);
   if (!FLAGS_query_concurrently) {
     runInSingleThread(req.get_parts(), std::move(plan));
   } else {
@@ -114,33 +120,74 @@ void LookupProcessor::doProcess(const cpp2::LookupIndexRequest& req) {
 
 ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<IndexNode>> LookupProcessor::buildPlan(
     const cpp2::LookupIndexRequest& req) {
-  std::vector<std::unique_ptr<IndexNode>> nodes;
+  // The contexts on the same index with the same filter, e.g. the ones of an IN-list, are scanned
+  // by one node seeking from range to range, so the keys are visited once and need no dedup. It
+  // doesn't apply to geography index, whose ranges of cells contain the same rows, so the rows of
+  // the ranges are deduplicated before the filter, which is the exact geography predicate,
+  // rather than evaluating it on each duplicate. The contexts to intersect and the skip scans are
+  // always scanned by their own nodes.
+  bool intersect = req.get_indices().get_intersect();
+  std::vector<std::pair<IndexID, std::string>> nodeKeys;
+  std::vector<std::vector<std::unique_ptr<IndexNode>>> scans;
   for (auto& ctx : req.get_indices().get_contexts()) {
-    auto scan = buildOneContext(ctx);
+    std::pair<IndexID, std::string> nodeKey(
+        ctx.get_index_id(), ctx.filter_ref().is_set() ? *ctx.filter_ref() : "");
+    auto iter = std::find(nodeKeys.begin(), nodeKeys.end(), nodeKey);
+    if (intersect || ctx.get_skip_scan()) {
+      iter = nodeKeys.end();
+    }
+    if (iter != nodeKeys.end() && !isGeoIndex(ctx.get_index_id())) {
+      auto* scan = static_cast<IndexScanNode*>(scans[iter - nodeKeys.begin()].front().get());
+      scan->addColumnHints(ctx.get_column_hints());
+      continue;
+    }
+    auto scan = buildScanNode(ctx);
     if (!ok(scan)) {
       return error(scan);
     }
-    nodes.emplace_back(std::move(value(scan)));
+    if (iter != nodeKeys.end()) {
+      scans[iter - nodeKeys.begin()].emplace_back(std::move(value(scan)));
+      continue;
+    }
+    scans.emplace_back();
+    scans.back().emplace_back(std::move(value(scan)));
+    nodeKeys.emplace_back(std::move(nodeKey));
   }
-  for (size_t i = 0; i < nodes.size(); i++) {
+  std::vector<std::unique_ptr<IndexNode>> nodes;
+  for (size_t i = 0; i < scans.size(); i++) {
+    std::unique_ptr<IndexNode> node;
+    if (scans[i].size() == 1) {
+      node = std::move(scans[i].front());
+    } else {
+      node = std::make_unique<IndexDedupNode>(context_.get(), dedupColumns());
+      for (auto& scan : scans[i]) {
+        node->addChild(std::move(scan));
+      }
+    }
+    const auto& filter = nodeKeys[i].second;
+    if (!filter.empty()) {
+      auto expr = Expression::decode(context_->objPool(), filter);
+      auto filterNode = std::make_unique<IndexSelectionNode>(context_.get(), expr);
+      filterNode->addChild(std::move(node));
+      node = std::move(filterNode);
+    }
     auto projection =
         std::make_unique<IndexProjectionNode>(context_.get(), *req.get_return_columns());
-    projection->addChild(std::move(nodes[i]));
-    nodes[i] = std::move(projection);
+    projection->addChild(std::move(node));
+    nodes.emplace_back(std::move(projection));
   }
   if (nodes.size() > 1) {
-    std::vector<std::string> dedupColumn;
-    if (context_->isEdge()) {
-      dedupColumn = std::vector<std::string>{kSrc, kRank, kDst};
+    std::unique_ptr<IndexNode> merge;
+    if (intersect) {
+      merge = std::make_unique<IndexIntersectNode>(context_.get(), dedupColumns());
     } else {
-      dedupColumn = std::vector<std::string>{kVid};
+      merge = std::make_unique<IndexDedupNode>(context_.get(), dedupColumns());
     }
-    auto dedup = std::make_unique<IndexDedupNode>(context_.get(), dedupColumn);
     for (auto& node : nodes) {
-      dedup->addChild(std::move(node));
+      merge->addChild(std::move(node));
     }
     nodes.clear();
-    nodes[0] = std::move(dedup);
+    nodes.emplace_back(std::move(merge));
   }
   if (req.limit_ref().has_value()) {
     auto limit = *req.get_limit();
@@ -167,7 +214,54 @@ ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<IndexNode>> LookupProcessor::bu
   return std::move(nodes[0]);
 }
 
-ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<IndexNode>> LookupProcessor::buildOneContext(
+std::vector<std::string> LookupProcessor::dedupColumns() {
+  if (context_->isEdge()) {
+    return {kSrc, kRank, kDst};
+  }
+  return {kVid};
+}
+
+bool LookupProcessor::isGeoIndex(IndexID indexId) {
+  auto idx = context_->isEdge() ? env_->indexMan_->getEdgeIndex(context_->spaceId(), indexId)
+                                : env_->indexMan_->getTagIndex(context_->spaceId(), indexId);
+  if (!idx.ok()) {
+    return false;
+  }
+  const auto& cols = idx.value()->get_fields();
+  return std::any_of(cols.begin(), cols.end(), [](const meta::cpp2::ColumnDef& col) {
+    return col.get_type().get_type() == nebula::cpp2::PropertyType::GEOGRAPHY;
+  });
+}
+
+bool LookupProcessor::isAsyncIndex(IndexID indexId) {
+  auto idx = context_->isEdge() ? env_->indexMan_->getEdgeIndex(context_->spaceId(), indexId)
+                                : env_->indexMan_->getTagIndex(context_->spaceId(), indexId);
+  return idx.ok() && StorageEnv::isAsyncIndex(*idx.value());
+}
+
+void LookupProcessor::waitIndexApplied(const cpp2::LookupIndexRequest& req) {
+  auto* applier = env_->indexLogApplier_;
+  if (FLAGS_lookup_index_barrier_ms == 0 || applier == nullptr) {
+    return;
+  }
+  const auto& contexts = req.get_indices().get_contexts();
+  if (std::none_of(contexts.begin(), contexts.end(), [this](const auto& ctx) {
+        return isAsyncIndex(ctx.get_index_id());
+      })) {
+    return;
+  }
+  auto deadline = time::WallClock::fastNowInMilliSec() + FLAGS_lookup_index_barrier_ms;
+  for (auto part : req.get_parts()) {
+    auto timeout = std::max<int64_t>(deadline - time::WallClock::fastNowInMilliSec(), 0);
+    if (!applier->waitApplied(context_->spaceId(), part, timeout)) {
+      // The lookup goes on with the index as it is
+      VLOG(1) << "The index log of part " << part << " is not applied in time";
+      stats::StatsManager::addValue(kNumLookupBarrierTimeouts);
+    }
+  }
+}
+
+ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<IndexNode>> LookupProcessor::buildScanNode(
     const cpp2::IndexQueryContext& ctx) {
   std::unique_ptr<IndexNode> node;
   DLOG(INFO) << ctx.get_column_hints().size();
@@ -183,6 +277,9 @@ ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<IndexNode>> LookupProcessor::bu
         std::any_of(cols.begin(), cols.end(), [](const meta::cpp2::ColumnDef& col) {
           return col.nullable_ref().value_or(false);
         });
+    if (ctx.get_skip_scan() && !canSkipScan(cols, ctx.get_column_hints())) {
+      return nebula::cpp2::ErrorCode::E_INVALID_OPERATION;
+    }
     node = std::make_unique<IndexEdgeScanNode>(context_.get(),
                                                ctx.get_index_id(),
                                                ctx.get_column_hints(),
@@ -198,26 +295,50 @@ ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<IndexNode>> LookupProcessor::bu
         std::any_of(cols.begin(), cols.end(), [](const meta::cpp2::ColumnDef& col) {
           return col.nullable_ref().value_or(false);
         });
+    if (ctx.get_skip_scan() && !canSkipScan(cols, ctx.get_column_hints())) {
+      return nebula::cpp2::ErrorCode::E_INVALID_OPERATION;
+    }
     node = std::make_unique<IndexVertexScanNode>(context_.get(),
                                                  ctx.get_index_id(),
                                                  ctx.get_column_hints(),
                                                  context_->env()->kvstore_,
                                                  hasNullableCol);
   }
-  if (ctx.filter_ref().is_set() && !ctx.get_filter().empty()) {
-    auto expr = Expression::decode(context_->objPool(), *ctx.filter_ref());
-    auto filterNode = std::make_unique<IndexSelectionNode>(context_.get(), expr);
-    filterNode->addChild(std::move(node));
-    node = std::move(filterNode);
-  }
+  static_cast<IndexScanNode*>(node.get())->setSkipScan(ctx.get_skip_scan());
   return node;
 }
 
+bool LookupProcessor::canSkipScan(const std::vector<meta::cpp2::ColumnDef>& cols,
+                                  const std::vector<cpp2::IndexColumnHint>& hints) {
+  // The values of the first field are decoded from the keys exactly, and the hints are on the
+  // following fields in order
+  if (cols.empty() || cols.front().nullable_ref().value_or(false)) {
+    return false;
+  }
+  auto type = cols.front().get_type().get_type();
+  if (type == nebula::cpp2::PropertyType::STRING || type == nebula::cpp2::PropertyType::GEOGRAPHY) {
+    return false;
+  }
+  if (hints.size() + 1 > cols.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < hints.size(); i++) {
+    if (hints[i].get_column_name() != cols[i + 1].get_name()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void LookupProcessor::runInSingleThread(const std::vector<PartitionID>& parts,
                                         std::unique_ptr<IndexNode> plan) {
   // printPlan(plan.get());
   std::vector<std::deque<Row>> datasetList;
   std::vector<::nebula::cpp2::ErrorCode> codeList;
+  std::optional<kvstore::RocksReadProfiler> readProfiler;
+  if (UNLIKELY(profileReads())) {
+    readProfiler.emplace();
+  }
   for (auto part : parts) {
     DLOG(INFO) << "execute part:" << part;
     plan->execute(part);
@@ -253,6 +374,9 @@ void LookupProcessor::runInSingleThread(const std::vector<PartitionID>& parts,
       handleErrorCode(codeList[i], context_->spaceId(), parts[i]);
     }
   }
+  if (readProfiler.has_value()) {
+    addReadStats(readProfiler->stats());
+  }
   if (UNLIKELY(profileDetailFlag_)) {
     profilePlan(plan.get());
   }
@@ -262,51 +386,109 @@ void LookupProcessor::runInSingleThread(const std::vector<PartitionID>& parts,
 
 void LookupProcessor::runInMultipleThread(const std::vector<PartitionID>& parts,
                                           std::unique_ptr<IndexNode> plan) {
-  std::vector<std::unique_ptr<IndexNode>> planCopy = reproducePlan(plan.get(), parts.size());
+  // Each task scans a part, or a sub range of a part if the index range is split
+  struct Task {
+    PartitionID part;
+    std::optional<std::pair<std::string, std::string>> range;
+  };
+  std::vector<Task> tasks;
+  auto* scan = FLAGS_lookup_sub_ranges_per_part > 1 ? singleScanNode(plan.get()) : nullptr;
+  for (auto part : parts) {
+    if (scan == nullptr) {
+      tasks.push_back({part, std::nullopt});
+      continue;
+    }
+    auto [start, end] = scan->keyRange(part);
+    auto boundaries = env_->kvstore_->splitRange(
+        context_->spaceId(), part, start, end, FLAGS_lookup_sub_ranges_per_part);
+    boundaries.emplace_back(std::move(end));
+    for (auto& boundary : boundaries) {
+      tasks.push_back({part, std::make_pair(start, boundary)});
+      start = std::move(boundary);
+    }
+  }
+  std::vector<std::unique_ptr<IndexNode>> planCopy = reproducePlan(plan.get(), tasks.size());
+  for (size_t i = 0; i < tasks.size(); i++) {
+    if (tasks[i].range.has_value()) {
+      singleScanNode(planCopy[i].get())
+          ->setSubRange(tasks[i].range->first, tasks[i].range->second);
+    }
+  }
+
   using ReturnType = std::tuple<PartitionID, ::nebula::cpp2::ErrorCode, std::deque<Row>, Row>;
-  std::vector<folly::Future<ReturnType>> futures;
-  for (size_t i = 0; i < parts.size(); i++) {
-    futures.emplace_back(folly::via(
-        executor_, [this, plan = std::move(planCopy[i]), part = parts[i]]() -> ReturnType {
-          ::nebula::cpp2::ErrorCode code = ::nebula::cpp2::ErrorCode::SUCCEEDED;
-          std::deque<Row> dataset;
-          plan->execute(part);
-          do {
-            auto result = plan->next();
-            if (!result.success()) {
-              code = result.code();
-              break;
-            }
-            if (result.hasData()) {
-              dataset.emplace_back(std::move(result).row());
-            } else {
-              break;
-            }
-          } while (true);
-          if (UNLIKELY(profileDetailFlag_)) {
-            profilePlan(plan.get());
-          }
-          Row statResult;
-          if (code == nebula::cpp2::ErrorCode::SUCCEEDED && statTypes_.size() > 0) {
-            auto indexAgg = dynamic_cast<IndexAggregateNode*>(plan.get());
-            statResult = indexAgg->calculateStats();
-          }
-          return {part, code, dataset, statResult};
-        }));
+  auto runTask = [this](IndexNode* taskPlan, PartitionID part) -> ReturnType {
+    ::nebula::cpp2::ErrorCode code = ::nebula::cpp2::ErrorCode::SUCCEEDED;
+    std::deque<Row> dataset;
+    // The perf context of rocksdb is thread local, a task is run in one thread
+    std::optional<kvstore::RocksReadProfiler> readProfiler;
+    if (UNLIKELY(profileReads())) {
+      readProfiler.emplace();
+    }
+    taskPlan->execute(part);
+    do {
+      auto result = taskPlan->next();
+      if (!result.success()) {
+        code = result.code();
+        break;
+      }
+      if (result.hasData()) {
+        dataset.emplace_back(std::move(result).row());
+      } else {
+        break;
+      }
+    } while (true);
+    if (readProfiler.has_value()) {
+      addReadStats(readProfiler->stats());
+    }
+    if (UNLIKELY(profileDetailFlag_)) {
+      profilePlan(taskPlan);
+    }
+    Row statResult;
+    if (code == nebula::cpp2::ErrorCode::SUCCEEDED && statTypes_.size() > 0) {
+      auto indexAgg = dynamic_cast<IndexAggregateNode*>(taskPlan);
+      statResult = indexAgg->calculateStats();
+    }
+    return {part, code, dataset, statResult};
+  };
+
+  // The tasks are taken by at most max_lookup_concurrency workers in order, so that one request
+  // could not occupy all the threads
+  size_t concurrency = tasks.size();
+  if (FLAGS_max_lookup_concurrency > 0) {
+    concurrency = std::min(concurrency, static_cast<size_t>(FLAGS_max_lookup_concurrency));
+  }
+  auto plans = std::make_shared<std::vector<std::pair<PartitionID, std::unique_ptr<IndexNode>>>>();
+  for (size_t i = 0; i < tasks.size(); i++) {
+    plans->emplace_back(tasks[i].part, std::move(planCopy[i]));
   }
-  folly::collectAll(futures).via(executor_).thenTry([this](auto&& t) {
+  auto results = std::make_shared<std::vector<ReturnType>>(plans->size());
+  auto next = std::make_shared<std::atomic<size_t>>(0);
+  std::vector<folly::Future<folly::Unit>> futures;
+  for (size_t i = 0; i < concurrency; i++) {
+    futures.emplace_back(folly::via(executor_, [results, next, plans, runTask]() {
+      for (auto j = next->fetch_add(1); j < plans->size(); j = next->fetch_add(1)) {
+        (*results)[j] = runTask((*plans)[j].second.get(), (*plans)[j].first);
+      }
+    }));
+  }
+  folly::collectAll(futures).via(executor_).thenTry([this, results, plans](auto&& t) {
     CHECK(!t.hasException());
-    const auto& tries = t.value();
+    for (const auto& result : t.value()) {
+      CHECK(!result.hasException());
+    }
+    // The rows of a part are dropped if any of its sub ranges failed
+    std::unordered_set<PartitionID> failedParts;
+    for (auto& [partId, code, dataset, statResult] : *results) {
+      if (code != ::nebula::cpp2::ErrorCode::SUCCEEDED && failedParts.emplace(partId).second) {
+        handleErrorCode(code, context_->spaceId(), partId);
+      }
+    }
     std::vector<Row> statResults;
-    for (size_t j = 0; j < tries.size(); j++) {
-      CHECK(!tries[j].hasException());
-      auto& [partId, code, dataset, statResult] = tries[j].value();
-      if (code == ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+    for (auto& [partId, code, dataset, statResult] : *results) {
+      if (failedParts.count(partId) == 0) {
         for (auto& row : dataset) {
           resultDataSet_.emplace_back(std::move(row));
         }
-      } else {
-        handleErrorCode(code, context_->spaceId(), partId);
       }
       statResults.emplace_back(std::move(statResult));
     }
@@ -414,6 +596,25 @@ void LookupProcessor::mergeStatsResult(const std::vector<Row>& statsResult) {
   statsDataSet_.emplace_back(std::move(result));
 }
 
+IndexScanNode* LookupProcessor::singleScanNode(IndexNode* root) {
+  IndexScanNode* scan = nullptr;
+  std::function<bool(IndexNode*)> find = [&](IndexNode* node) {
+    if (auto* scanNode = dynamic_cast<IndexScanNode*>(node)) {
+      if (scan != nullptr) {
+        return false;
+      }
+      scan = scanNode;
+    }
+    for (auto& child : node->children()) {
+      if (!find(child.get())) {
+        return false;
+      }
+    }
+    return true;
+  };
+  return find(root) ? scan : nullptr;
+}
+
 std::vector<std::unique_ptr<IndexNode>> LookupProcessor::reproducePlan(IndexNode* root,
                                                                        size_t count) {
   std::vector<std::unique_ptr<IndexNode>> ret(count);
@@ -443,6 +644,7 @@ void LookupProcessor::profilePlan(IndexNode* root) {
     } else {
       iter->second += node->duration().elapsedInUSec();
     }
+    profileNode(id, node->rows(), node->duration().elapsedInUSec(), {});
     for (auto& child : node->children()) {
       q.push(child.get());
     }
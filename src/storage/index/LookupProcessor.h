@@ -9,6 +9,7 @@
 #include "interface/gen-cpp2/storage_types.h"
 #include "storage/BaseProcessor.h"
 #include "storage/exec/IndexNode.h"
+#include "storage/exec/IndexScanNode.h"
 namespace nebula {
 namespace storage {
 extern ProcessorCounters kLookupCounters;
@@ -31,6 +32,7 @@ class LookupProcessor : public BaseProcessor<cpp2::LookupIndexResp> {
       : BaseProcessor<cpp2::LookupIndexResp>(env, counters), executor_(executor) {}
   void doProcess(const cpp2::LookupIndexRequest& req);
   void onProcessFinished() {
+    resultDataSet_.writePacked = planContext_ != nullptr && planContext_->packDataSet_;
     BaseProcessor<cpp2::LookupIndexResp>::resp_.data_ref() = std::move(resultDataSet_);
     BaseProcessor<cpp2::LookupIndexResp>::resp_.stat_data_ref() = std::move(statsDataSet_);
   }
@@ -40,9 +42,32 @@ class LookupProcessor : public BaseProcessor<cpp2::LookupIndexResp> {
   ::nebula::cpp2::ErrorCode prepare(const cpp2::LookupIndexRequest& req);
   ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<IndexNode>> buildPlan(
       const cpp2::LookupIndexRequest& req);
-  ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<IndexNode>> buildOneContext(
+  // Build the scan node of a context, the filter of the context is applied by the caller
+  ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<IndexNode>> buildScanNode(
       const cpp2::IndexQueryContext& ctx);
+  // Whether the hints could be scanned for each value of the first field of the index
+  static bool canSkipScan(const std::vector<meta::cpp2::ColumnDef>& cols,
+                          const std::vector<cpp2::IndexColumnHint>& hints);
+  std::vector<std::string> dedupColumns();
   std::vector<std::unique_ptr<IndexNode>> reproducePlan(IndexNode* root, size_t count);
+  /**
+   * @brief Return the scan node if there is only one in the plan, the range of a part could only be
+   * split if there is one, otherwise the rows of different ranges need to be deduplicated
+   */
+  IndexScanNode* singleScanNode(IndexNode* root);
+  /**
+   * @brief Whether the index is on a geography column
+   */
+  bool isGeoIndex(IndexID indexId);
+  /**
+   * @brief Whether the index is maintained asynchronously
+   */
+  bool isAsyncIndex(IndexID indexId);
+  /**
+   * @brief Wait for the operations logged of the indexes maintained asynchronously to be applied
+   * to the parts, at most lookup_index_barrier_ms
+   */
+  void waitIndexApplied(const cpp2::LookupIndexRequest& req);
   ErrorOr<nebula::cpp2::ErrorCode, std::vector<std::pair<std::string, cpp2::StatType>>>
   handleStatProps(const std::vector<cpp2::StatProp>& statProps);
   void mergeStatsResult(const std::vector<Row>& statsResult);
@@ -13,6 +13,7 @@
 #include "common/utils/IndexKeyUtils.h"
 #include "common/utils/NebulaKeyUtils.h"
 #include "common/utils/OperationKeyUtils.h"
+#include "storage/mutate/DegreeCounter.h"
 #include "storage/stats/StorageStats.h"
 
 namespace nebula {
@@ -54,7 +55,8 @@ void AddEdgesProcessor::process(const cpp2::AddEdgesRequest& req) {
 
   CHECK_NOTNULL(env_->kvstore_);
 
-  if (indexes_.empty()) {
+  // The degrees are counted in the atomic op as well as the indexes
+  if (indexes_.empty() && !FLAGS_enable_degree_counters) {
     doProcess(req);
   } else {
     doProcessWithIndex(req);
@@ -73,6 +75,16 @@ void AddEdgesProcessor::doProcess(const cpp2::AddEdgesRequest& req) {
     auto code = nebula::cpp2::ErrorCode::SUCCEEDED;
     std::unordered_set<std::string> visited;
     visited.reserve(newEdges.size());
+    // The edges already existing are read together
+    std::unordered_set<std::string> existed;
+    if (ifNotExists_) {
+      auto ret = findExistedEdges(partId, newEdges);
+      if (!nebula::ok(ret)) {
+        handleAsync(spaceId_, partId, nebula::error(ret));
+        continue;
+      }
+      existed = std::move(nebula::value(ret));
+    }
 
     for (auto& newEdge : newEdges) {
       auto edgeKey = *newEdge.key_ref();
@@ -96,20 +108,11 @@ void AddEdgesProcessor::doProcess(const cpp2::AddEdgesRequest& req) {
                                          *edgeKey.edge_type_ref(),
                                          *edgeKey.ranking_ref(),
                                          edgeKey.dst_ref()->getStr());
+      addEdgeToEvict(partId, edgeKey.src_ref()->getStr());
       if (ifNotExists_) {
-        if (!visited.emplace(key).second) {
+        if (!visited.emplace(key).second || existed.count(key) > 0) {
           continue;
         }
-        auto obsIdx = findOldValue(partId, key);
-        if (nebula::ok(obsIdx)) {
-          // already exists in kvstore
-          if (!nebula::value(obsIdx).empty()) {
-            continue;
-          }
-        } else {
-          code = nebula::error(obsIdx);
-          break;
-        }
       }
       auto schema = env_->schemaMan_->getEdgeSchema(spaceId_, std::abs(*edgeKey.edge_type_ref()));
       if (!schema) {
@@ -118,9 +121,10 @@ void AddEdgesProcessor::doProcess(const cpp2::AddEdgesRequest& req) {
         break;
       }
 
-      auto props = newEdge.get_props();
       WriteResult wRet;
-      auto retEnc = encodeRowVal(schema.get(), propNames, props, wRet);
+      auto retEnc = newEdge.encoded_props_ref().has_value()
+                        ? checkEncodedRowVal(schema.get(), *newEdge.encoded_props_ref(), wRet)
+                        : encodeRowVal(schema.get(), propNames, newEdge.get_props(), wRet);
       if (!retEnc.ok()) {
         LOG(ERROR) << retEnc.status();
         code = writeResultTo(wRet, true);
@@ -132,6 +136,7 @@ void AddEdgesProcessor::doProcess(const cpp2::AddEdgesRequest& req) {
     if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
       handleAsync(spaceId_, partId, code);
     } else {
+      addHotWrites(HotKeys::kAddEdges, spaceId_, partId, data);
       if (consistOp_) {
         auto batchHolder = std::make_unique<kvstore::BatchHolder>();
         (*consistOp_)(*batchHolder, &data);
@@ -183,10 +188,12 @@ void AddEdgesProcessor::doProcessWithIndex(const cpp2::AddEdgesRequest& req) {
                                          *edgeKey.edge_type_ref(),
                                          *edgeKey.ranking_ref(),
                                          (*edgeKey.dst_ref()).getStr());
+      addEdgeToEvict(partId, edgeKey.src_ref()->getStr());
       // collect values
       WriteResult writeResult;
-      const auto& props = edge.get_props();
-      auto encode = encodeRowVal(schema.get(), propNames, props, writeResult);
+      auto encode = edge.encoded_props_ref().has_value()
+                        ? checkEncodedRowVal(schema.get(), *edge.encoded_props_ref(), writeResult)
+                        : encodeRowVal(schema.get(), propNames, edge.get_props(), writeResult);
       if (!encode.ok()) {
         LOG(ERROR) << encode.status();
         code = writeResultTo(writeResult, true);
@@ -199,6 +206,7 @@ void AddEdgesProcessor::doProcessWithIndex(const cpp2::AddEdgesRequest& req) {
       handleAsync(spaceId_, partId, code);
     } else {
       stats::StatsManager::addValue(kNumEdgesInserted, kvs.size());
+      addHotWrites(HotKeys::kAddEdges, spaceId_, partId, kvs);
       auto atomicOp =
           [partId, data = std::move(kvs), this]() mutable -> kvstore::MergeableAtomicOpResult {
         return addEdgesWithIndex(partId, std::move(data));
@@ -216,8 +224,39 @@ kvstore::MergeableAtomicOpResult AddEdgesProcessor::addEdgesWithIndex(
   ret.code = nebula::cpp2::ErrorCode::E_RAFT_ATOMIC_OP_FAILED;
   IndexCountWrapper wrapper(env_);
   std::unique_ptr<kvstore::BatchHolder> batchHolder = std::make_unique<kvstore::BatchHolder>();
-  for (auto& [key, value] : data) {
+  // Each edge is written along with its index keys
+  batchHolder->reserve(data.size() * (1 + indexes_.size()));
+  std::optional<DegreeCounter> degrees;
+  if (FLAGS_enable_degree_counters) {
+    degrees.emplace(env_, spaceId_, partId, spaceVidLen_);
+  }
+
+  // The old values are read together instead of one by one: those of the out-edges to maintain the
+  // indexes, or those of all edges to count the degrees
+  std::vector<std::string> readKeys;
+  std::vector<size_t> readIndex(data.size(), data.size());
+  for (size_t i = 0; i < data.size(); i++) {
+    auto edgeType = NebulaKeyUtils::getEdgeType(spaceVidLen_, data[i].first);
+    if ((edgeType > 0 && !ignoreExistedIndex_) || degrees.has_value()) {
+      readIndex[i] = readKeys.size();
+      readKeys.emplace_back(data[i].first);
+    }
+  }
+  auto oldValues = findOldValues(spaceId_, partId, readKeys);
+  if (!nebula::ok(oldValues)) {
+    return ret;
+  }
+  auto& oldVals = nebula::value(oldValues);
+
+  for (size_t i = 0; i < data.size(); i++) {
+    const auto& key = data[i].first;
+    const auto& value = data[i].second;
     auto edgeType = NebulaKeyUtils::getEdgeType(spaceVidLen_, key);
+    // whether the edge exists before, only known when it is read
+    std::optional<bool> existed;
+    if (readIndex[i] < readKeys.size()) {
+      existed = !oldVals[readIndex[i]].empty();
+    }
     RowReaderWrapper oldReader;
     RowReaderWrapper newReader =
         RowReaderWrapper::getEdgePropReader(env_->schemaMan_, spaceId_, std::abs(edgeType), value);
@@ -228,22 +267,14 @@ kvstore::MergeableAtomicOpResult AddEdgesProcessor::addEdgesWithIndex(
 
     // only out-edge need to handle index
     if (edgeType > 0) {
-      std::string oldVal;
       if (!ignoreExistedIndex_) {
-        // read the old key value and initialize row reader if exists
-        auto result = findOldValue(partId, key);
-        if (nebula::ok(result)) {
-          if (ifNotExists_ && !nebula::value(result).empty()) {
-            continue;
-          } else if (!nebula::value(result).empty()) {
-            oldVal = std::move(nebula::value(result));
-            oldReader =
-                RowReaderWrapper::getEdgePropReader(env_->schemaMan_, spaceId_, edgeType, oldVal);
-            ret.readSet.emplace_back(key);
-          }
-        } else {
-          // read old value failed
-          return ret;
+        // initialize row reader by the old value if exists
+        if (ifNotExists_ && *existed) {
+          continue;
+        } else if (*existed) {
+          oldReader = RowReaderWrapper::getEdgePropReader(
+              env_->schemaMan_, spaceId_, edgeType, oldVals[readIndex[i]]);
+          ret.readSet.emplace_back(key);
         }
       }
       for (const auto& index : indexes_) {
@@ -256,11 +287,11 @@ kvstore::MergeableAtomicOpResult AddEdgesProcessor::addEdgesWithIndex(
               // Check the index is building for the specified partition or
               // not.
               auto indexState = env_->getIndexState(spaceId_, partId);
-              if (env_->checkRebuilding(indexState)) {
-                auto delOpKey = OperationKeyUtils::deleteOperationKey(partId);
+              if (env_->checkIndexLogged(indexState, *index)) {
                 for (auto& idxKey : oldIndexKeys) {
                   ret.writeSet.push_back(idxKey);
-                  batchHolder->put(std::string(delOpKey), std::move(idxKey));
+                  auto delOpKey = OperationKeyUtils::deleteOperationKey(partId, idxKey);
+                  batchHolder->put(std::move(delOpKey), std::move(idxKey));
                 }
               } else if (env_->checkIndexLocked(indexState)) {
                 return ret;
@@ -277,11 +308,10 @@ kvstore::MergeableAtomicOpResult AddEdgesProcessor::addEdgesWithIndex(
           if (newReader != nullptr) {
             auto newIndexKeys = indexKeys(partId, newReader.get(), key, index, nullptr);
             if (!newIndexKeys.empty()) {
-              // check if index has ttl field, write it to index value if exists
-              auto field = CommonUtils::ttlValue(schema.get(), newReader.get());
-              auto indexVal = field.ok() ? IndexKeyUtils::indexVal(std::move(field).value()) : "";
+              // write the ttl field and the included fields to index value if exist
+              auto indexVal = CommonUtils::indexVal(schema.get(), newReader.get(), index.get());
               auto indexState = env_->getIndexState(spaceId_, partId);
-              if (env_->checkRebuilding(indexState)) {
+              if (env_->checkIndexLogged(indexState, *index)) {
                 for (auto& idxKey : newIndexKeys) {
                   auto opKey = OperationKeyUtils::modifyOperationKey(partId, idxKey);
                   ret.writeSet.push_back(opKey);
@@ -301,6 +331,12 @@ kvstore::MergeableAtomicOpResult AddEdgesProcessor::addEdgesWithIndex(
         }
       }
     }
+    if (degrees.has_value()) {
+      if (ifNotExists_ && *existed) {
+        continue;
+      }
+      degrees->add(key, *existed ? 0 : 1);
+    }
     // step 3, Insert new edge data
     ret.writeSet.push_back(key);
     // for why use a copy not move here:
@@ -318,6 +354,11 @@ kvstore::MergeableAtomicOpResult AddEdgesProcessor::addEdgesWithIndex(
     batchHolder->put(std::string(key), std::string(value));
   }
 
+  if (degrees.has_value() &&
+      degrees->flush(batchHolder.get(), &ret) != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return ret;
+  }
+
   if (consistOp_) {
     (*consistOp_)(*batchHolder, nullptr);
   }
@@ -327,25 +368,35 @@ kvstore::MergeableAtomicOpResult AddEdgesProcessor::addEdgesWithIndex(
   return ret;
 }
 
-ErrorOr<nebula::cpp2::ErrorCode, std::string> AddEdgesProcessor::findOldValue(
-    PartitionID partId, const folly::StringPiece& rawKey) {
-  auto key = NebulaKeyUtils::edgeKey(spaceVidLen_,
-                                     partId,
-                                     NebulaKeyUtils::getSrcId(spaceVidLen_, rawKey).str(),
-                                     NebulaKeyUtils::getEdgeType(spaceVidLen_, rawKey),
-                                     NebulaKeyUtils::getRank(spaceVidLen_, rawKey),
-                                     NebulaKeyUtils::getDstId(spaceVidLen_, rawKey).str());
-  std::string val;
-  auto ret = env_->kvstore_->get(spaceId_, partId, key, &val);
-  if (ret == nebula::cpp2::ErrorCode::SUCCEEDED) {
-    return val;
-  } else if (ret == nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
-    return std::string();
-  } else {
-    LOG(ERROR) << "Error! ret = " << apache::thrift::util::enumNameSafe(ret) << ", spaceId "
-               << spaceId_;
-    return ret;
+ErrorOr<nebula::cpp2::ErrorCode, std::unordered_set<std::string>>
+AddEdgesProcessor::findExistedEdges(PartitionID partId, const std::vector<cpp2::NewEdge>& edges) {
+  std::vector<std::string> keys;
+  keys.reserve(edges.size());
+  for (const auto& edge : edges) {
+    const auto& edgeKey = edge.get_key();
+    // The invalid ones are reported when they are written
+    if (!NebulaKeyUtils::isValidVidLen(
+            spaceVidLen_, edgeKey.get_src().getStr(), edgeKey.get_dst().getStr())) {
+      continue;
+    }
+    keys.emplace_back(NebulaKeyUtils::edgeKey(spaceVidLen_,
+                                              partId,
+                                              edgeKey.get_src().getStr(),
+                                              edgeKey.get_edge_type(),
+                                              edgeKey.get_ranking(),
+                                              edgeKey.get_dst().getStr()));
+  }
+  auto values = findOldValues(spaceId_, partId, keys);
+  if (!nebula::ok(values)) {
+    return nebula::error(values);
+  }
+  std::unordered_set<std::string> existed;
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (!nebula::value(values)[i].empty()) {
+      existed.emplace(std::move(keys[i]));
+    }
   }
+  return existed;
 }
 
 std::vector<std::string> AddEdgesProcessor::indexKeys(
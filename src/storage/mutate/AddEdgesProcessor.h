@@ -41,8 +41,9 @@ class AddEdgesProcessor : public BaseProcessor<cpp2::ExecResponse> {
   kvstore::MergeableAtomicOpResult addEdgesWithIndex(PartitionID partId,
                                                      std::vector<kvstore::KV>&& data);
 
-  ErrorOr<nebula::cpp2::ErrorCode, std::string> findOldValue(PartitionID partId,
-                                                             const folly::StringPiece& rawKey);
+  // Keys of the edges already existing, which are read together
+  ErrorOr<nebula::cpp2::ErrorCode, std::unordered_set<std::string>> findExistedEdges(
+      PartitionID partId, const std::vector<cpp2::NewEdge>& edges);
 
   std::vector<std::string> indexKeys(PartitionID partId,
                                      RowReader* reader,
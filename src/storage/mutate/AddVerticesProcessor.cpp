@@ -21,6 +21,9 @@ namespace storage {
 
 ProcessorCounters kAddVerticesCounters;
 
+// The props of a tag without prop names are in the order of the schema
+static const std::vector<std::string> kNoPropNames;
+
 void AddVerticesProcessor::process(const cpp2::AddVerticesRequest& req) {
   spaceId_ = req.get_space_id();
   const auto& partVertices = req.get_parts();
@@ -71,6 +74,16 @@ void AddVerticesProcessor::doProcess(const cpp2::AddVerticesRequest& req) {
     auto code = nebula::cpp2::ErrorCode::SUCCEEDED;
     std::unordered_set<std::string> visited;
     visited.reserve(vertices.size());
+    // The tags already existing are read together
+    std::unordered_set<std::string> existed;
+    if (ifNotExists_) {
+      auto ret = findExistedTags(partId, vertices);
+      if (!nebula::ok(ret)) {
+        handleAsync(spaceId_, partId, nebula::error(ret));
+        continue;
+      }
+      existed = std::move(nebula::value(ret));
+    }
     for (auto& vertex : vertices) {
       auto vid = vertex.get_id().getStr();
       const auto& newTags = vertex.get_tags();
@@ -82,6 +95,7 @@ void AddVerticesProcessor::doProcess(const cpp2::AddVerticesRequest& req) {
         break;
       }
       data.emplace_back(NebulaKeyUtils::vertexKey(spaceVidLen_, partId, vid), "");
+      addVertexToEvict(partId, vid);
       for (auto& newTag : newTags) {
         auto tagId = newTag.get_tag_id();
         VLOG(3) << "PartitionID: " << partId << ", VertexID: " << vid << ", TagID: " << tagId;
@@ -95,28 +109,18 @@ void AddVerticesProcessor::doProcess(const cpp2::AddVerticesRequest& req) {
 
         auto key = NebulaKeyUtils::tagKey(spaceVidLen_, partId, vid, tagId);
         if (ifNotExists_) {
-          if (!visited.emplace(key).second) {
+          if (!visited.emplace(key).second || existed.count(key) > 0) {
             continue;
           }
-          auto obsIdx = findOldValue(partId, vid, tagId);
-          if (nebula::ok(obsIdx)) {
-            if (!nebula::value(obsIdx).empty()) {
-              continue;
-            }
-          } else {
-            code = nebula::error(obsIdx);
-            break;
-          }
         }
-        auto props = newTag.get_props();
         auto iter = propNamesMap.find(tagId);
-        std::vector<std::string> propNames;
-        if (iter != propNamesMap.end()) {
-          propNames = iter->second;
-        }
+        const auto& propNames = iter != propNamesMap.end() ? iter->second : kNoPropNames;
 
         WriteResult wRet;
-        auto retEnc = encodeRowVal(schema.get(), propNames, props, wRet);
+        auto retEnc =
+            newTag.encoded_props_ref().has_value()
+                ? checkEncodedRowVal(schema.get(), *newTag.encoded_props_ref(), wRet)
+                : encodeRowVal(schema.get(), propNames, newTag.get_props(), wRet);
         if (!retEnc.ok()) {
           LOG(ERROR) << retEnc.status();
           code = writeResultTo(wRet, false);
@@ -128,6 +132,7 @@ void AddVerticesProcessor::doProcess(const cpp2::AddVerticesRequest& req) {
     if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
       handleAsync(spaceId_, partId, code);
     } else {
+      addHotWrites(HotKeys::kAddVertices, spaceId_, partId, data);
       doPut(spaceId_, partId, std::move(data));
       stats::StatsManager::addValue(kNumVerticesInserted, data.size());
     }
@@ -161,6 +166,7 @@ void AddVerticesProcessor::doProcessWithIndex(const cpp2::AddVerticesRequest& re
       }
 
       verticeData.emplace_back(NebulaKeyUtils::vertexKey(spaceVidLen_, partId, vid));
+      addVertexToEvict(partId, vid);
       for (const auto& newTag : newTags) {
         auto tagId = newTag.get_tag_id();
         VLOG(3) << "PartitionID: " << partId << ", VertexID: " << vid << ", TagID: " << tagId;
@@ -174,15 +180,14 @@ void AddVerticesProcessor::doProcessWithIndex(const cpp2::AddVerticesRequest& re
 
         auto key = NebulaKeyUtils::tagKey(spaceVidLen_, partId, vid, tagId);
         // collect values
-        const auto& props = newTag.get_props();
         auto iter = propNamesMap.find(tagId);
-        std::vector<std::string> propNames;
-        if (iter != propNamesMap.end()) {
-          propNames = iter->second;
-        }
+        const auto& propNames = iter != propNamesMap.end() ? iter->second : kNoPropNames;
 
         WriteResult writeResult;
-        auto encode = encodeRowVal(schema.get(), propNames, props, writeResult);
+        auto encode =
+            newTag.encoded_props_ref().has_value()
+                ? checkEncodedRowVal(schema.get(), *newTag.encoded_props_ref(), writeResult)
+                : encodeRowVal(schema.get(), propNames, newTag.get_props(), writeResult);
         if (!encode.ok()) {
           LOG(ERROR) << encode.status();
           code = writeResultTo(writeResult, false);
@@ -196,6 +201,7 @@ void AddVerticesProcessor::doProcessWithIndex(const cpp2::AddVerticesRequest& re
       handleAsync(spaceId_, partId, code);
     } else {
       stats::StatsManager::addValue(kNumVerticesInserted, verticeData.size());
+      addHotWrites(HotKeys::kAddVertices, spaceId_, partId, tags);
       auto atomicOp = [=, tags = std::move(tags), vertices = std::move(verticeData)]() mutable {
         return addVerticesWithIndex(partId, tags, vertices);
       };
@@ -214,10 +220,31 @@ kvstore::MergeableAtomicOpResult AddVerticesProcessor::addVerticesWithIndex(
   ret.code = nebula::cpp2::ErrorCode::E_RAFT_ATOMIC_OP_FAILED;
   IndexCountWrapper wrapper(env_);
   auto batchHolder = std::make_unique<kvstore::BatchHolder>();
+  // Each tag is written along with its index keys
+  batchHolder->reserve(vertices.size() + data.size() * (1 + indexes_.size()));
   for (auto& vertice : vertices) {
     batchHolder->put(std::string(vertice), "");
   }
-  for (auto& [key, value] : data) {
+
+  // The old values to maintain the indexes are read together instead of one by one
+  std::vector<std::string> oldVals;
+  if (!ignoreExistedIndex_) {
+    std::vector<std::string> keys;
+    keys.reserve(data.size());
+    for (const auto& kv : data) {
+      keys.emplace_back(kv.first);
+    }
+    auto result = findOldValues(spaceId_, partId, keys);
+    if (!nebula::ok(result)) {
+      // read old value failed
+      return ret;
+    }
+    oldVals = std::move(nebula::value(result));
+  }
+
+  for (size_t i = 0; i < data.size(); i++) {
+    const auto& key = data[i].first;
+    const auto& value = data[i].second;
     auto vId = NebulaKeyUtils::getVertexId(spaceVidLen_, key);
     auto tagId = NebulaKeyUtils::getTagId(spaceVidLen_, key);
     RowReaderWrapper oldReader;
@@ -229,26 +256,19 @@ kvstore::MergeableAtomicOpResult AddVerticesProcessor::addVerticesWithIndex(
       DLOG(INFO) << "===>>> failed";
       return ret;
     }
-    std::string oldVal;
     if (!ignoreExistedIndex_) {
-      // read the old key value and initialize row reader if exists
-      auto result = findOldValue(partId, vId.str(), tagId);
-      if (nebula::ok(result)) {
-        if (ifNotExists_ && !nebula::value(result).empty()) {
-          continue;
-        } else if (!nebula::value(result).empty()) {
-          oldVal = std::move(nebula::value(result));
-          oldReader = RowReaderWrapper::getTagPropReader(env_->schemaMan_, spaceId_, tagId, oldVal);
-          ret.readSet.emplace_back(key);
-        }
-      } else {
-        // read old value failed
-        DLOG(INFO) << "===>>> failed";
-        return ret;
+      // initialize row reader by the old value if exists
+      if (ifNotExists_ && !oldVals[i].empty()) {
+        continue;
+      } else if (!oldVals[i].empty()) {
+        oldReader =
+            RowReaderWrapper::getTagPropReader(env_->schemaMan_, spaceId_, tagId, oldVals[i]);
+        ret.readSet.emplace_back(key);
       }
     }
+    auto mirror = env_->isMirrorVertex(spaceId_, partId, vId);
     for (const auto& index : indexes_) {
-      if (tagId == index->get_schema_id().get_tag_id()) {
+      if (!mirror && tagId == index->get_schema_id().get_tag_id()) {
         // step 1, Delete old version index if exists.
         if (oldReader != nullptr) {
           auto oldIndexKeys = indexKeys(partId, vId.str(), oldReader.get(), index, schema.get());
@@ -256,11 +276,11 @@ kvstore::MergeableAtomicOpResult AddVerticesProcessor::addVerticesWithIndex(
             // Check the index is building for the specified partition or
             // not.
             auto indexState = env_->getIndexState(spaceId_, partId);
-            if (env_->checkRebuilding(indexState)) {
-              auto delOpKey = OperationKeyUtils::deleteOperationKey(partId);
+            if (env_->checkIndexLogged(indexState, *index)) {
               for (auto& idxKey : oldIndexKeys) {
+                auto delOpKey = OperationKeyUtils::deleteOperationKey(partId, idxKey);
                 ret.writeSet.emplace_back(std::string(delOpKey));
-                batchHolder->put(std::string(delOpKey), std::move(idxKey));
+                batchHolder->put(std::move(delOpKey), std::move(idxKey));
               }
             } else if (env_->checkIndexLocked(indexState)) {
               LOG(ERROR) << "The index has been locked: " << index->get_index_name();
@@ -279,11 +299,10 @@ kvstore::MergeableAtomicOpResult AddVerticesProcessor::addVerticesWithIndex(
         if (newReader != nullptr) {
           auto newIndexKeys = indexKeys(partId, vId.str(), newReader.get(), index, schema.get());
           if (!newIndexKeys.empty()) {
-            // check if index has ttl field, write it to index value if exists
-            auto field = CommonUtils::ttlValue(schema.get(), newReader.get());
-            auto indexVal = field.ok() ? IndexKeyUtils::indexVal(std::move(field).value()) : "";
+            // write the ttl field and the included fields to index value if exist
+            auto indexVal = CommonUtils::indexVal(schema.get(), newReader.get(), index.get());
             auto indexState = env_->getIndexState(spaceId_, partId);
-            if (env_->checkRebuilding(indexState)) {
+            if (env_->checkIndexLogged(indexState, *index)) {
               for (auto& idxKey : newIndexKeys) {
                 auto opKey = OperationKeyUtils::modifyOperationKey(partId, idxKey);
                 ret.writeSet.emplace_back(std::string(opKey));
@@ -312,20 +331,31 @@ kvstore::MergeableAtomicOpResult AddVerticesProcessor::addVerticesWithIndex(
   return ret;
 }
 
-ErrorOr<nebula::cpp2::ErrorCode, std::string> AddVerticesProcessor::findOldValue(
-    PartitionID partId, const VertexID& vId, TagID tagId) {
-  auto key = NebulaKeyUtils::tagKey(spaceVidLen_, partId, vId, tagId);
-  std::string val;
-  auto ret = env_->kvstore_->get(spaceId_, partId, key, &val);
-  if (ret == nebula::cpp2::ErrorCode::SUCCEEDED) {
-    return val;
-  } else if (ret == nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
-    return std::string();
-  } else {
-    LOG(ERROR) << "Error! ret = " << apache::thrift::util::enumNameSafe(ret) << ", spaceId "
-               << spaceId_;
-    return ret;
+ErrorOr<nebula::cpp2::ErrorCode, std::unordered_set<std::string>>
+AddVerticesProcessor::findExistedTags(PartitionID partId,
+                                      const std::vector<cpp2::NewVertex>& vertices) {
+  std::vector<std::string> keys;
+  for (const auto& vertex : vertices) {
+    auto vid = vertex.get_id().getStr();
+    // The invalid ones are reported when they are written
+    if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vid)) {
+      continue;
+    }
+    for (const auto& tag : vertex.get_tags()) {
+      keys.emplace_back(NebulaKeyUtils::tagKey(spaceVidLen_, partId, vid, tag.get_tag_id()));
+    }
+  }
+  auto values = findOldValues(spaceId_, partId, keys);
+  if (!nebula::ok(values)) {
+    return nebula::error(values);
+  }
+  std::unordered_set<std::string> existed;
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (!nebula::value(values)[i].empty()) {
+      existed.emplace(std::move(keys[i]));
+    }
   }
+  return existed;
 }
 
 std::vector<std::string> AddVerticesProcessor::indexKeys(
@@ -34,9 +34,9 @@ class AddVerticesProcessor : public BaseProcessor<cpp2::ExecResponse> {
   AddVerticesProcessor(StorageEnv* env, const ProcessorCounters* counters)
       : BaseProcessor<cpp2::ExecResponse>(env, counters) {}
 
-  ErrorOr<nebula::cpp2::ErrorCode, std::string> findOldValue(PartitionID partId,
-                                                             const VertexID& vId,
-                                                             TagID tagId);
+  // Keys of the tags already existing, which are read together
+  ErrorOr<nebula::cpp2::ErrorCode, std::unordered_set<std::string>> findExistedTags(
+      PartitionID partId, const std::vector<cpp2::NewVertex>& vertices);
 
   std::vector<std::string> indexKeys(PartitionID partId,
                                      const VertexID& vId,
@@ -0,0 +1,53 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/mutate/DegreeCounter.h"
+
+#include "common/utils/NebulaKeyUtils.h"
+
+namespace nebula {
+namespace storage {
+
+void DegreeCounter::add(folly::StringPiece edgeKey, int64_t delta) {
+  edgeKeys_.emplace_back(edgeKey.str());
+  if (delta == 0) {
+    return;
+  }
+  auto key = NebulaKeyUtils::degreeKey(vIdLen_,
+                                       partId_,
+                                       NebulaKeyUtils::getSrcId(vIdLen_, edgeKey).str(),
+                                       NebulaKeyUtils::getEdgeType(vIdLen_, edgeKey));
+  deltas_[key] += delta;
+}
+
+nebula::cpp2::ErrorCode DegreeCounter::flush(kvstore::BatchHolder* batch,
+                                             kvstore::MergeableAtomicOpResult* result) {
+  for (const auto& [key, delta] : deltas_) {
+    if (delta == 0) {
+      continue;
+    }
+    std::string val;
+    auto ret = env_->kvstore_->get(spaceId_, partId_, key, &val);
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED &&
+        ret != nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
+      return ret;
+    }
+    auto degree = decode(val) + delta;
+    if (degree > 0) {
+      batch->put(std::string(key), encode(degree));
+    } else {
+      batch->remove(std::string(key));
+    }
+    result->readSet.emplace_back(key);
+    result->writeSet.emplace_back(key);
+  }
+  for (const auto& edgeKey : edgeKeys_) {
+    result->readSet.emplace_back(edgeKey);
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+}  // namespace storage
+}  // namespace nebula
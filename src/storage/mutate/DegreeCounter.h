@@ -0,0 +1,63 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_MUTATE_DEGREECOUNTER_H_
+#define STORAGE_MUTATE_DEGREECOUNTER_H_
+
+#include "common/base/Base.h"
+#include "kvstore/Common.h"
+#include "kvstore/LogEncoder.h"
+#include "storage/CommonUtils.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief Changes of the degree counters made by the edges written in one atomic op.
+ *
+ * The degree of a vertex by an edge type is the number of edge keys of the type starting from the
+ * vertex, so an in-edge counts the in-degree of its dst in the part of the dst. The counters are
+ * read and written in the atomic op, and both the counters and the edges checked are added to its
+ * read set, so that the concurrent writes to the same vertices are serialized.
+ */
+class DegreeCounter final {
+ public:
+  DegreeCounter(StorageEnv* env, GraphSpaceID spaceId, PartitionID partId, size_t vIdLen)
+      : env_(env), spaceId_(spaceId), partId_(partId), vIdLen_(vIdLen) {}
+
+  /**
+   * @brief Count an edge key inserted (1) or removed (-1), or only record that the edge has been
+   * checked (0)
+   */
+  void add(folly::StringPiece edgeKey, int64_t delta);
+
+  /**
+   * @brief Write the new value of the changed counters into the batch, and add the keys read and
+   * written to the result of the atomic op
+   */
+  nebula::cpp2::ErrorCode flush(kvstore::BatchHolder* batch,
+                                kvstore::MergeableAtomicOpResult* result);
+
+  static std::string encode(int64_t degree) {
+    return std::string(reinterpret_cast<const char*>(&degree), sizeof(int64_t));
+  }
+
+  static int64_t decode(folly::StringPiece val) {
+    return val.size() == sizeof(int64_t) ? readInt<int64_t>(val.data(), sizeof(int64_t)) : 0;
+  }
+
+ private:
+  StorageEnv* env_;
+  GraphSpaceID spaceId_;
+  PartitionID partId_;
+  size_t vIdLen_;
+  std::vector<std::string> edgeKeys_;
+  // degree key => delta
+  std::unordered_map<std::string, int64_t> deltas_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_MUTATE_DEGREECOUNTER_H_
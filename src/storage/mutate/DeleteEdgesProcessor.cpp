@@ -11,6 +11,8 @@
 #include "common/utils/IndexKeyUtils.h"
 #include "common/utils/NebulaKeyUtils.h"
 #include "common/utils/OperationKeyUtils.h"
+#include "storage/StorageFlags.h"
+#include "storage/mutate/DegreeCounter.h"
 #include "storage/stats/StorageStats.h"
 
 namespace nebula {
@@ -48,7 +50,7 @@ void DeleteEdgesProcessor::process(const cpp2::DeleteEdgesRequest& req) {
   indexes_ = std::move(iRet).value();
 
   CHECK_NOTNULL(env_->kvstore_);
-  if (indexes_.empty()) {
+  if (indexes_.empty() && !FLAGS_enable_degree_counters) {
     // Operate every part, the graph layer guarantees the unique of the edgeKey
     for (auto& part : partEdges) {
       std::vector<std::string> keys;
@@ -72,6 +74,7 @@ void DeleteEdgesProcessor::process(const cpp2::DeleteEdgesRequest& req) {
                                             *edgeKey.ranking_ref(),
                                             edgeKey.dst_ref()->getStr());
         keys.emplace_back(edge.data(), edge.size());
+        addEdgeToEvict(partId, edgeKey.src_ref()->getStr());
       }
       if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
         handleAsync(spaceId_, partId, code);
@@ -129,12 +132,32 @@ void DeleteEdgesProcessor::process(const cpp2::DeleteEdgesRequest& req) {
           }
           dummyLock.emplace_back(std::move(l));
         }
+        addEdgeToEvict(partId, edgeKey.src_ref()->getStr());
       }
       if (err != nebula::cpp2::ErrorCode::SUCCEEDED) {
         env_->edgesML_->unlockBatch(dummyLock);
         handleAsync(spaceId_, partId, err);
         continue;
       }
+      if (FLAGS_enable_degree_counters) {
+        // The edges and the counters are read in the atomic op, which is serialized with the
+        // other writes of the part
+        nebula::MemoryLockGuard<EMLI> lg(env_->edgesML_.get(), std::move(dummyLock), false, false);
+        auto atomicOp = [partId, edges = part.second, this]() -> kvstore::MergeableAtomicOpResult {
+          return deleteEdgesWithDegrees(partId, edges);
+        };
+        env_->kvstore_->asyncAtomicOp(
+            spaceId_,
+            partId,
+            std::move(atomicOp),
+            [l = std::move(lg), icw = std::move(wrapper), partId, this](
+                nebula::cpp2::ErrorCode code) {
+              UNUSED(l);
+              UNUSED(icw);
+              handleAsync(spaceId_, partId, code);
+            });
+        continue;
+      }
       auto batch = deleteEdges(partId, std::move(part.second));
       if (!nebula::ok(batch)) {
         env_->edgesML_->unlockBatch(dummyLock);
@@ -156,8 +179,25 @@ void DeleteEdgesProcessor::process(const cpp2::DeleteEdgesRequest& req) {
   }
 }
 
-ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteEdgesProcessor::deleteEdges(
+kvstore::MergeableAtomicOpResult DeleteEdgesProcessor::deleteEdgesWithDegrees(
     PartitionID partId, const std::vector<cpp2::EdgeKey>& edges) {
+  kvstore::MergeableAtomicOpResult ret;
+  DegreeCounter degrees(env_, spaceId_, partId, spaceVidLen_);
+  auto batch = deleteEdges(partId, edges, &degrees, &ret);
+  if (!nebula::ok(batch)) {
+    ret.code = nebula::error(batch);
+    return ret;
+  }
+  ret.code = nebula::cpp2::ErrorCode::SUCCEEDED;
+  ret.batch = std::move(nebula::value(batch));
+  return ret;
+}
+
+ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteEdgesProcessor::deleteEdges(
+    PartitionID partId,
+    const std::vector<cpp2::EdgeKey>& edges,
+    DegreeCounter* degrees,
+    kvstore::MergeableAtomicOpResult* result) {
   std::unique_ptr<kvstore::BatchHolder> batchHolder = std::make_unique<kvstore::BatchHolder>();
   for (auto& edge : edges) {
     auto type = *edge.edge_type_ref();
@@ -194,10 +234,10 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteEdgesProcessor::deleteEdges(
               spaceVidLen_, partId, indexId, srcId, rank, dstId, std::move(valuesRet).value());
 
           auto indexState = env_->getIndexState(spaceId_, partId);
-          if (env_->checkRebuilding(indexState)) {
-            auto deleteOpKey = OperationKeyUtils::deleteOperationKey(partId);
+          if (env_->checkIndexLogged(indexState, *index)) {
             for (auto& indexKey : indexKeys) {
-              batchHolder->put(std::string(deleteOpKey), std::move(indexKey));
+              auto deleteOpKey = OperationKeyUtils::deleteOperationKey(partId, indexKey);
+              batchHolder->put(std::move(deleteOpKey), std::move(indexKey));
             }
           } else if (env_->checkIndexLocked(indexState)) {
             LOG(ERROR) << "The index has been locked: " << index->get_index_name();
@@ -209,9 +249,16 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteEdgesProcessor::deleteEdges(
           }
         }
       }
+      if (degrees != nullptr) {
+        degrees->add(key, -1);
+        result->writeSet.emplace_back(key);
+      }
       batchHolder->remove(std::move(key));
       stats::StatsManager::addValue(kNumEdgesDeleted);
     } else if (ret == nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
+      if (degrees != nullptr) {
+        degrees->add(key, 0);
+      }
       continue;
     } else {
       VLOG(3) << "Error! ret = " << apache::thrift::util::enumNameSafe(ret) << ", spaceId "
@@ -220,6 +267,13 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteEdgesProcessor::deleteEdges(
     }
   }
 
+  if (degrees != nullptr) {
+    auto code = degrees->flush(batchHolder.get(), result);
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+  }
+
   if (tossHookFunc_) {
     HookFuncPara para;
     para.batch.emplace(batchHolder.get());
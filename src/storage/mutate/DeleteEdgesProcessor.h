@@ -9,6 +9,7 @@
 #include "common/base/Base.h"
 #include "kvstore/LogEncoder.h"
 #include "storage/BaseProcessor.h"
+#include "storage/mutate/DegreeCounter.h"
 #include "storage/transaction/ConsistTypes.h"
 
 namespace nebula {
@@ -34,8 +35,16 @@ class DeleteEdgesProcessor : public BaseProcessor<cpp2::ExecResponse> {
   DeleteEdgesProcessor(StorageEnv* env, const ProcessorCounters* counters)
       : BaseProcessor<cpp2::ExecResponse>(env, counters) {}
 
+  // Delete the edges in an atomic op, with the degree counters of their src updated
+  kvstore::MergeableAtomicOpResult deleteEdgesWithDegrees(PartitionID partId,
+                                                          const std::vector<cpp2::EdgeKey>& edges);
+
+  // The degrees and the result of atomic op are only given when the degrees are counted
   ErrorOr<nebula::cpp2::ErrorCode, std::string> deleteEdges(
-      PartitionID partId, const std::vector<cpp2::EdgeKey>& edges);
+      PartitionID partId,
+      const std::vector<cpp2::EdgeKey>& edges,
+      DegreeCounter* degrees = nullptr,
+      kvstore::MergeableAtomicOpResult* result = nullptr);
 
  private:
   GraphSpaceID spaceId_;
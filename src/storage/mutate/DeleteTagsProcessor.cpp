@@ -56,6 +56,7 @@ void DeleteTagsProcessor::process(const cpp2::DeleteTagsRequest& req) {
       keys.clear();
       for (const auto& entry : delTags) {
         const auto& vId = entry.get_id().getStr();
+        addVertexToEvict(partId, vId);
         for (const auto& tagId : entry.get_tags()) {
           auto key = NebulaKeyUtils::tagKey(spaceVidLen_, partId, vId, tagId);
           keys.emplace_back(std::move(key));
@@ -96,6 +97,8 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteTagsProcessor::deleteTags(
   std::unique_ptr<kvstore::BatchHolder> batchHolder = std::make_unique<kvstore::BatchHolder>();
   for (const auto& entry : delTags) {
     const auto& vId = entry.get_id().getStr();
+    addVertexToEvict(partId, vId);
+    auto mirror = env_->isMirrorVertex(spaceId_, partId, vId);
     for (const auto& tagId : entry.get_tags()) {
       auto key = NebulaKeyUtils::tagKey(spaceVidLen_, partId, vId, tagId);
       auto tup = std::make_tuple(spaceId_, partId, tagId, vId);
@@ -122,7 +125,7 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteTagsProcessor::deleteTags(
         return nebula::cpp2::ErrorCode::E_INVALID_DATA;
       }
       for (auto& index : indexes_) {
-        if (index->get_schema_id().get_tag_id() == tagId) {
+        if (!mirror && index->get_schema_id().get_tag_id() == tagId) {
           auto indexId = index->get_index_id();
 
           auto valuesRet = IndexKeyUtils::collectIndexValues(reader.get(), index.get());
@@ -134,10 +137,10 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteTagsProcessor::deleteTags(
 
           // Check the index is building for the specified partition or not
           auto indexState = env_->getIndexState(spaceId_, partId);
-          if (env_->checkRebuilding(indexState)) {
-            auto deleteOpKey = OperationKeyUtils::deleteOperationKey(partId);
+          if (env_->checkIndexLogged(indexState, *index)) {
             for (auto& indexKey : indexKeys) {
-              batchHolder->put(std::string(deleteOpKey), std::move(indexKey));
+              auto deleteOpKey = OperationKeyUtils::deleteOperationKey(partId, indexKey);
+              batchHolder->put(std::move(deleteOpKey), std::move(indexKey));
             }
           } else if (env_->checkIndexLocked(indexState)) {
             return nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
@@ -47,13 +47,25 @@ void DeleteVerticesProcessor::process(const cpp2::DeleteVerticesRequest& req) {
 
   CHECK_NOTNULL(env_->kvstore_);
   if (indexes_.empty()) {
-    // Operate every part, the graph layer guarantees the unique of the vid
-    std::vector<std::string> keys;
-    keys.reserve(32);
+    auto tags = env_->schemaMan_->getAllLatestVerTagSchema(spaceId_);
+    if (!tags.ok()) {
+      LOG(ERROR) << tags.status();
+      for (auto& part : partVertices) {
+        pushResultCode(nebula::cpp2::ErrorCode::E_SPACE_NOT_FOUND, part.first);
+      }
+      onFinished();
+      return;
+    }
+    tagIds_.reserve(tags.value().size());
+    for (const auto& tag : tags.value()) {
+      tagIds_.emplace_back(tag.first);
+    }
+    // Operate every part, the graph layer guarantees the unique of the vid. The rows of a vertex
+    // are removed by the keys of all the tags, so nothing is read
     for (auto& part : partVertices) {
       auto partId = part.first;
       const auto& vertexIds = part.second;
-      keys.clear();
+      kvstore::BatchHolder batchHolder;
       auto code = nebula::cpp2::ErrorCode::SUCCEEDED;
       for (auto& vid : vertexIds) {
         if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vid.getStr())) {
@@ -62,26 +74,20 @@ void DeleteVerticesProcessor::process(const cpp2::DeleteVerticesRequest& req) {
           code = nebula::cpp2::ErrorCode::E_INVALID_VID;
           break;
         }
-        keys.emplace_back(NebulaKeyUtils::vertexKey(spaceVidLen_, partId, vid.getStr()));
-        auto prefix = NebulaKeyUtils::tagPrefix(spaceVidLen_, partId, vid.getStr());
-        std::unique_ptr<kvstore::KVIterator> iter;
-        code = env_->kvstore_->prefix(spaceId_, partId, prefix, &iter);
-        if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
-          VLOG(3) << "Error! ret = " << static_cast<int32_t>(code) << ", spaceID " << spaceId_;
-          break;
-        }
-        while (iter->valid()) {
-          auto key = iter->key();
-          keys.emplace_back(key.str());
-          iter->next();
-        }
+        batchHolder.remove(NebulaKeyUtils::vertexKey(spaceVidLen_, partId, vid.getStr()));
+        removeTags(batchHolder, partId, vid.getStr());
+        addVertexToEvict(partId, vid.getStr());
       }
       if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
         handleAsync(spaceId_, partId, code);
         continue;
       }
-      doRemove(spaceId_, partId, std::move(keys));
-      stats::StatsManager::addValue(kNumVerticesDeleted, keys.size());
+      stats::StatsManager::addValue(kNumVerticesDeleted, vertexIds.size());
+      env_->kvstore_->asyncAppendBatch(
+          spaceId_,
+          partId,
+          encodeBatchValue(batchHolder.getBatch()),
+          [partId, this](nebula::cpp2::ErrorCode ret) { handleAsync(spaceId_, partId, ret); });
     }
   } else {
     for (auto& pv : partVertices) {
@@ -121,6 +127,7 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteVerticesProcessor::deleteVer
       return code;
     }
     batchHolder->remove(NebulaKeyUtils::vertexKey(spaceVidLen_, partId, vertex.getStr()));
+    addVertexToEvict(partId, vertex.getStr());
     auto prefix = NebulaKeyUtils::tagPrefix(spaceVidLen_, partId, vertex.getStr());
     std::unique_ptr<kvstore::KVIterator> iter;
     auto ret = env_->kvstore_->prefix(spaceId_, partId, prefix, &iter);
@@ -129,6 +136,7 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteVerticesProcessor::deleteVer
       return ret;
     }
 
+    auto mirror = env_->isMirrorVertex(spaceId_, partId, vertex.getStr());
     while (iter->valid()) {
       auto key = iter->key();
       auto tagId = NebulaKeyUtils::getTagId(spaceVidLen_, key);
@@ -143,7 +151,7 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteVerticesProcessor::deleteVer
       auto schema = env_->schemaMan_->getTagSchema(spaceId_, tagId);
       RowReaderWrapper reader;
       for (auto& index : indexes_) {
-        if (index->get_schema_id().get_tag_id() == tagId) {
+        if (!mirror && index->get_schema_id().get_tag_id() == tagId) {
           auto indexId = index->get_index_id();
 
           if (reader == nullptr) {
@@ -164,10 +172,10 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteVerticesProcessor::deleteVer
 
           // Check the index is building for the specified partition or not
           auto indexState = env_->getIndexState(spaceId_, partId);
-          if (env_->checkRebuilding(indexState)) {
-            auto deleteOpKey = OperationKeyUtils::deleteOperationKey(partId);
+          if (env_->checkIndexLogged(indexState, *index)) {
             for (auto& indexKey : indexKeys) {
-              batchHolder->put(std::string(deleteOpKey), std::move(indexKey));
+              auto deleteOpKey = OperationKeyUtils::deleteOperationKey(partId, indexKey);
+              batchHolder->put(std::move(deleteOpKey), std::move(indexKey));
             }
           } else if (env_->checkIndexLocked(indexState)) {
             LOG(ERROR) << "The index has been locked: " << index->get_index_name();
@@ -188,5 +196,15 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteVerticesProcessor::deleteVer
   return encodeBatchValue(batchHolder->getBatch());
 }
 
+void DeleteVerticesProcessor::removeTags(kvstore::BatchHolder& batchHolder,
+                                         PartitionID partId,
+                                         const VertexID& vId) {
+  // Point deletes rather than one range tombstone per vertex, which the reads of rocksdb have to
+  // go through until they're compacted
+  for (auto tagId : tagIds_) {
+    batchHolder.remove(NebulaKeyUtils::tagKey(spaceVidLen_, partId, vId, tagId));
+  }
+}
+
 }  // namespace storage
 }  // namespace nebula
@@ -33,9 +33,13 @@ class DeleteVerticesProcessor : public BaseProcessor<cpp2::ExecResponse> {
                                                                const std::vector<Value>& vertices,
                                                                std::vector<VMLI>& target);
 
+  // Remove the rows of all the tags of the space of the vertex, without reading them
+  void removeTags(kvstore::BatchHolder& batchHolder, PartitionID partId, const VertexID& vId);
+
  private:
   GraphSpaceID spaceId_;
   std::vector<std::shared_ptr<nebula::meta::cpp2::IndexItem>> indexes_;
+  std::vector<TagID> tagIds_;
 };
 
 }  // namespace storage
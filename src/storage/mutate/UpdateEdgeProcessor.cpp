@@ -80,6 +80,16 @@ void UpdateEdgeProcessor::doProcess(const cpp2::UpdateEdgeRequest& req) {
   auto plan = buildPlan(&resultDataSet_);
 
   auto ret = plan.go(partId, edgeKey_);
+  if (env_->adjacencyCache_ != nullptr) {
+    // The update is done synchronously in the plan, evict the edge no matter it succeeded
+    env_->adjacencyCache_->evict(spaceId_, partId, edgeKey_.get_src().getStr());
+  }
+  env_->bumpWriteEpoch(spaceId_);
+  if (env_->hotKeys_ != nullptr) {
+    auto* hotKeys = env_->hotKeys_->tracker(HotKeys::kUpdateEdge);
+    hotKeys->addVertex(spaceId_, partId, edgeKey_.get_src().getStr(), 0);
+    hotKeys->addPart(spaceId_, partId, 0);
+  }
   if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
     handleErrorCode(ret, spaceId_, partId);
     if (ret == nebula::cpp2::ErrorCode::E_FILTER_OUT) {
@@ -160,6 +170,9 @@ StoragePlan<cpp2::EdgeKey> UpdateEdgeProcessor::buildPlan(nebula::DataSet* resul
                                                      expCtx_.get(),
                                                      &edgeContext_);
   updateNode->addDependency(filterNode.get());
+  // The increments could be merged into the row only if there is no condition or result to yield
+  updateNode->setCounterMerge(FLAGS_update_counter_merge && filterExp_ == nullptr &&
+                              returnPropsExp_.empty());
 
   auto resultNode = std::make_unique<UpdateResNode<cpp2::EdgeKey>>(
       context_.get(), updateNode.get(), getReturnPropsExp(), expCtx_.get(), result);
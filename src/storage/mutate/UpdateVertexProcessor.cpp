@@ -74,6 +74,16 @@ void UpdateVertexProcessor::doProcess(const cpp2::UpdateVertexRequest& req) {
   VLOG(3) << "Update vertex, spaceId: " << spaceId_ << ", partId: " << partId << ", vId: " << vId;
   auto plan = buildPlan(&resultDataSet_);
   auto ret = plan.go(partId, vId.getStr());
+  if (env_->vertexCache_ != nullptr) {
+    // The update is done synchronously in the plan, evict the vertex no matter it succeeded
+    env_->vertexCache_->evict(spaceId_, partId, vId.getStr());
+  }
+  env_->bumpWriteEpoch(spaceId_);
+  if (env_->hotKeys_ != nullptr) {
+    auto* hotKeys = env_->hotKeys_->tracker(HotKeys::kUpdateVertex);
+    hotKeys->addVertex(spaceId_, partId, vId.getStr(), 0);
+    hotKeys->addPart(spaceId_, partId, 0);
+  }
 
   if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
     handleErrorCode(ret, spaceId_, partId);
@@ -146,6 +156,9 @@ StoragePlan<VertexID> UpdateVertexProcessor::buildPlan(nebula::DataSet* result)
                                                     expCtx_.get(),
                                                     &tagContext_);
   updateNode->addDependency(filterNode.get());
+  // The increments could be merged into the row only if there is no condition or result to yield
+  updateNode->setCounterMerge(FLAGS_update_counter_merge && filterExp_ == nullptr &&
+                              returnPropsExp_.empty());
 
   auto resultNode = std::make_unique<UpdateResNode<VertexID>>(
       context_.get(), updateNode.get(), getReturnPropsExp(), expCtx_.get(), result);
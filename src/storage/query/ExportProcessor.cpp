@@ -0,0 +1,448 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/query/ExportProcessor.h"
+
+#include <folly/futures/Future.h>
+
+#include "codec/RowReaderWrapper.h"
+#include "common/time/WallClock.h"
+#include "common/utils/ColumnarBuilder.h"
+#include "common/utils/NebulaKeyUtils.h"
+#include "kvstore/RocksScanMode.h"
+#include "storage/StorageFlags.h"
+
+namespace nebula {
+namespace storage {
+
+ProcessorCounters kExportCounters;
+
+namespace {
+
+using PropertyType = nebula::cpp2::PropertyType;
+
+// The first key after all the keys of the prefix
+std::string prefixEnd(std::string prefix) {
+  while (!prefix.empty() && static_cast<uint8_t>(prefix.back()) == 0xFF) {
+    prefix.pop_back();
+  }
+  if (!prefix.empty()) {
+    prefix.back() = static_cast<char>(static_cast<uint8_t>(prefix.back()) + 1);
+  }
+  return prefix;
+}
+
+}  // namespace
+
+ExportSnapshots::ExportSnapshots() : nextExportId_(time::WallClock::fastNowInMicroSec()) {}
+
+const void* ExportSnapshots::acquire(kvstore::KVStore* kvstore,
+                                     int64_t exportId,
+                                     GraphSpaceID spaceId,
+                                     PartitionID partId,
+                                     bool canReadFromFollower) {
+  auto now = time::WallClock::fastNowInSec();
+  auto key = std::make_tuple(exportId, spaceId, partId);
+  {
+    auto snapshots = snapshots_.wlock();
+    auto iter = snapshots->find(key);
+    if (iter != snapshots->end()) {
+      iter->second.lastUsedSec = now;
+      iter->second.readers++;
+      return iter->second.snapshot;
+    }
+  }
+  auto* snapshot = kvstore->GetSnapshot(spaceId, partId, canReadFromFollower);
+  if (snapshot == nullptr) {
+    return nullptr;
+  }
+  const void* taken = nullptr;
+  {
+    auto snapshots = snapshots_.wlock();
+    auto result = snapshots->emplace(key, Entry{snapshot, now});
+    result.first->second.readers++;
+    if (!result.second) {
+      // Taken by another request of the export at the same time
+      taken = snapshot;
+    }
+    snapshot = result.first->second.snapshot;
+  }
+  if (taken != nullptr) {
+    kvstore->ReleaseSnapshot(spaceId, partId, taken);
+  }
+  return snapshot;
+}
+
+void ExportSnapshots::release(kvstore::KVStore* kvstore,
+                              int64_t exportId,
+                              GraphSpaceID spaceId,
+                              PartitionID partId,
+                              bool finished) {
+  const void* snapshot = nullptr;
+  {
+    auto snapshots = snapshots_.wlock();
+    auto iter = snapshots->find(std::make_tuple(exportId, spaceId, partId));
+    if (iter == snapshots->end()) {
+      return;
+    }
+    auto& entry = iter->second;
+    entry.readers--;
+    entry.finished = entry.finished || finished;
+    if (entry.readers > 0 || !entry.finished) {
+      return;
+    }
+    snapshot = entry.snapshot;
+    snapshots->erase(iter);
+  }
+  kvstore->ReleaseSnapshot(spaceId, partId, snapshot);
+}
+
+void ExportSnapshots::expire(kvstore::KVStore* kvstore) {
+  auto deadline = time::WallClock::fastNowInSec() - FLAGS_export_snapshot_ttl_secs;
+  std::vector<std::pair<Key, const void*>> expired;
+  {
+    auto snapshots = snapshots_.wlock();
+    for (auto iter = snapshots->begin(); iter != snapshots->end();) {
+      if (iter->second.readers == 0 && iter->second.lastUsedSec < deadline) {
+        expired.emplace_back(iter->first, iter->second.snapshot);
+        iter = snapshots->erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+  }
+  for (const auto& [key, snapshot] : expired) {
+    LOG(INFO) << "Release the snapshot of export " << std::get<0>(key) << ", space "
+              << std::get<1>(key) << ", part " << std::get<2>(key) << " not used in time";
+    kvstore->ReleaseSnapshot(std::get<1>(key), std::get<2>(key), snapshot);
+  }
+}
+
+void ExportProcessor::process(const cpp2::ExportRequest& req) {
+  if (executor_ != nullptr) {
+    executor_->add([req, this]() { this->doProcess(req); });
+  } else {
+    doProcess(req);
+  }
+}
+
+void ExportProcessor::reject(nebula::cpp2::ErrorCode code, const cpp2::ExportRequest& req) {
+  // All the leader parts are exported if no part is given, so the parts could be empty
+  resp_.code_ref() = code;
+  BaseProcessor<cpp2::ExportResponse>::reject(code, req);
+}
+
+void ExportProcessor::doProcess(const cpp2::ExportRequest& req) {
+  spaceId_ = req.get_space_id();
+  edge_ = req.get_edge();
+  // Negative means no limit
+  limit_ = req.get_limit() < 0 ? std::numeric_limits<int64_t>::max() : req.get_limit();
+  batchSize_ = std::max(1, req.get_batch_size());
+  rawRows_ = req.get_raw_rows();
+  maxBytesPerSecond_ = req.get_max_bytes_per_second();
+  enableReadFollower_ = req.get_enable_read_from_follower();
+  exportId_ = req.snapshot_id_ref().has_value() ? *req.snapshot_id_ref()
+                                                : ExportSnapshots::instance().newExportId();
+  ExportSnapshots::instance().expire(env_->kvstore_);
+
+  auto retCode = getSpaceVidLen(spaceId_);
+  if (retCode == nebula::cpp2::ErrorCode::SUCCEEDED) {
+    retCode = buildSchemas(req.get_schema_ids());
+  }
+  if (retCode != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    reject(retCode, req);
+    return;
+  }
+
+  auto parts = partsToExport(req);
+  if (executor_ == nullptr || !FLAGS_query_concurrently || parts.size() <= 1) {
+    std::vector<std::pair<PartitionID, PartResult>> results;
+    for (const auto& [partId, cursor] : parts) {
+      results.emplace_back(partId, exportPart(partId, cursor.next_cursor_ref().value_or("")));
+    }
+    onPartsFinished(std::move(results));
+    return;
+  }
+
+  std::vector<folly::Future<std::pair<PartitionID, PartResult>>> futures;
+  for (const auto& [partId, cursor] : parts) {
+    futures.emplace_back(folly::via(
+        executor_, [this, partId = partId, start = cursor.next_cursor_ref().value_or("")] {
+          return std::make_pair(partId, exportPart(partId, start));
+        }));
+  }
+  folly::collectAll(futures).via(executor_).thenTry([this](auto&& t) mutable {
+    CHECK(!t.hasException());
+    std::vector<std::pair<PartitionID, PartResult>> results;
+    for (auto& result : t.value()) {
+      CHECK(!result.hasException());
+      results.emplace_back(std::move(result).value());
+    }
+    onPartsFinished(std::move(results));
+  });
+}
+
+nebula::cpp2::ErrorCode ExportProcessor::buildSchemas(const std::vector<int32_t>& schemaIds) {
+  std::unordered_map<int32_t, std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>> all;
+  if (edge_) {
+    auto edges = env_->schemaMan_->getAllVerEdgeSchema(spaceId_);
+    if (!edges.ok()) {
+      return nebula::cpp2::ErrorCode::E_SPACE_NOT_FOUND;
+    }
+    all = std::move(edges).value();
+  } else {
+    auto tags = env_->schemaMan_->getAllVerTagSchema(spaceId_);
+    if (!tags.ok()) {
+      return nebula::cpp2::ErrorCode::E_SPACE_NOT_FOUND;
+    }
+    all = std::move(tags).value();
+  }
+
+  for (const auto& [schemaId, versions] : all) {
+    if (!schemaIds.empty() &&
+        std::find(schemaIds.begin(), schemaIds.end(), schemaId) == schemaIds.end()) {
+      continue;
+    }
+    if (versions.empty()) {
+      continue;
+    }
+    Schema schema;
+    schema.versions = versions;
+    auto ttl = CommonUtils::ttlProps(versions.back().get());
+    if (ttl.first) {
+      schema.ttl = std::move(ttl.second);
+    }
+    schemas_.emplace(schemaId, std::move(schema));
+  }
+  for (auto schemaId : schemaIds) {
+    if (schemas_.count(schemaId) == 0) {
+      return edge_ ? nebula::cpp2::ErrorCode::E_EDGE_NOT_FOUND
+                   : nebula::cpp2::ErrorCode::E_TAG_NOT_FOUND;
+    }
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+std::unordered_map<PartitionID, cpp2::ScanCursor> ExportProcessor::partsToExport(
+    const cpp2::ExportRequest& req) {
+  if (!req.get_parts().empty()) {
+    return req.get_parts();
+  }
+  std::unordered_map<PartitionID, cpp2::ScanCursor> parts;
+  std::unordered_map<GraphSpaceID, std::vector<meta::cpp2::LeaderInfo>> leaders;
+  env_->kvstore_->allLeader(leaders);
+  auto iter = leaders.find(spaceId_);
+  if (iter != leaders.end()) {
+    for (const auto& leader : iter->second) {
+      parts.emplace(leader.get_part_id(), cpp2::ScanCursor());
+    }
+  }
+  return parts;
+}
+
+ExportProcessor::PartResult ExportProcessor::exportPart(PartitionID partId,
+                                                        const std::string& cursor) {
+  PartResult result;
+  auto& snapshots = ExportSnapshots::instance();
+  auto* snapshot =
+      snapshots.acquire(env_->kvstore_, exportId_, spaceId_, partId, enableReadFollower_);
+  if (snapshot == nullptr) {
+    auto part = env_->kvstore_->part(spaceId_, partId);
+    result.code =
+        nebula::ok(part) ? nebula::cpp2::ErrorCode::E_LEADER_CHANGED : nebula::error(part);
+    return result;
+  }
+
+  auto prefix = edge_ ? NebulaKeyUtils::edgePrefix(partId) : NebulaKeyUtils::tagPrefix(partId);
+  auto end = prefixEnd(prefix);
+  std::unique_ptr<kvstore::KVIterator> iter;
+  kvstore::ScanModeGuard scanMode(kvstore::ScanMode::kBackground);
+  result.code = env_->kvstore_->range(spaceId_,
+                                      partId,
+                                      cursor.empty() ? prefix : cursor,
+                                      end,
+                                      &iter,
+                                      enableReadFollower_,
+                                      snapshot);
+  if (result.code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    snapshots.release(env_->kvstore_, exportId_, spaceId_, partId, true);
+    return result;
+  }
+
+  std::vector<ColumnarBuilder> columns;
+  int32_t batchSchemaId = 0;
+  size_t batchRows = 0;
+  auto flush = [&]() {
+    if (batchRows == 0) {
+      return;
+    }
+    cpp2::ExportBatch batch;
+    batch.part_id_ref() = partId;
+    batch.schema_id_ref() = batchSchemaId;
+    batch.num_rows_ref() = batchRows;
+    int64_t bytes = 0;
+    for (auto& column : columns) {
+      bytes += column.bytes();
+      batch.columns_ref()->emplace_back(column.finish());
+    }
+    result.delaySecs = std::max(result.delaySecs, throttle(bytes));
+    result.batches.emplace_back(std::move(batch));
+    columns.clear();
+    batchRows = 0;
+  };
+  auto newBatch = [&](int32_t schemaId, const Schema& schema) {
+    batchSchemaId = schemaId;
+    auto vidType = isIntId_ ? PropertyType::INT64 : PropertyType::STRING;
+    if (edge_) {
+      columns.emplace_back(kSrc, vidType);
+      columns.emplace_back(kRank, PropertyType::INT64);
+      columns.emplace_back(kDst, vidType);
+    } else {
+      columns.emplace_back(kVid, vidType);
+    }
+    if (rawRows_) {
+      columns.emplace_back("_row", PropertyType::STRING);
+      return;
+    }
+    const auto& latest = schema.versions.back();
+    for (size_t i = 0; i < latest->getNumFields(); i++) {
+      const auto* field = latest->field(i);
+      columns.emplace_back(field->name(), field->type());
+    }
+  };
+  auto appendVid = [this](ColumnarBuilder& column, folly::StringPiece vid) {
+    if (isIntId_) {
+      column.appendInt(*reinterpret_cast<const int64_t*>(vid.data()));
+    } else {
+      column.appendBytes(vid.subpiece(0, vid.find_first_of('\0')));
+    }
+  };
+
+  int64_t rows = 0;
+  for (; iter->valid(); iter->next()) {
+    auto key = iter->key();
+    int32_t schemaId = 0;
+    if (edge_) {
+      // The in edges are the same as the out edges
+      if (!NebulaKeyUtils::isEdge(spaceVidLen_, key) ||
+          NebulaKeyUtils::getEdgeType(spaceVidLen_, key) <= 0) {
+        continue;
+      }
+      schemaId = NebulaKeyUtils::getEdgeType(spaceVidLen_, key);
+    } else {
+      if (!NebulaKeyUtils::isTag(spaceVidLen_, key)) {
+        continue;
+      }
+      schemaId = NebulaKeyUtils::getTagId(spaceVidLen_, key);
+    }
+    auto found = schemas_.find(schemaId);
+    if (found == schemas_.end()) {
+      continue;
+    }
+    const auto& schema = found->second;
+    if (rows >= limit_) {
+      result.nextCursor = key.str();
+      break;
+    }
+
+    auto val = iter->val();
+    RowReaderWrapper reader;
+    if (rawRows_) {
+      if (schema.ttl.has_value() &&
+          CommonUtils::checkRowExpiredForTTL(
+              schema.versions.back().get(), val, schema.ttl->first)) {
+        continue;
+      }
+    } else {
+      reader = RowReaderWrapper::getRowReader(schema.versions, val);
+      if (!reader) {
+        VLOG(1) << "Can't get the reader of the row of " << schemaId;
+        continue;
+      }
+      if (schema.ttl.has_value() &&
+          CommonUtils::checkDataExpiredForTTL(
+              schema.versions.back().get(), &reader, schema.ttl->second, schema.ttl->first)) {
+        continue;
+      }
+    }
+
+    if (batchRows > 0 && (schemaId != batchSchemaId || batchRows >= batchSize_)) {
+      flush();
+    }
+    if (batchRows == 0) {
+      newBatch(schemaId, schema);
+    }
+    size_t col = 0;
+    if (edge_) {
+      appendVid(columns[col++], NebulaKeyUtils::getSrcId(spaceVidLen_, key));
+      columns[col++].appendInt(NebulaKeyUtils::getRank(spaceVidLen_, key));
+      appendVid(columns[col++], NebulaKeyUtils::getDstId(spaceVidLen_, key));
+    } else {
+      appendVid(columns[col++], NebulaKeyUtils::getVertexId(spaceVidLen_, key));
+    }
+    if (rawRows_) {
+      columns[col].appendBytes(val);
+    } else {
+      const auto& latest = schema.versions.back();
+      for (size_t i = 0; i < latest->getNumFields(); i++, col++) {
+        columns[col].append(reader->getValueByIndex(i));
+      }
+    }
+    batchRows++;
+    rows++;
+  }
+  flush();
+
+  snapshots.release(env_->kvstore_, exportId_, spaceId_, partId, !result.nextCursor.has_value());
+  return result;
+}
+
+double ExportProcessor::throttle(int64_t bytes) {
+  if (maxBytesPerSecond_ <= 0) {
+    return 0;
+  }
+  // A batch larger than the rate is waited for as a whole
+  auto rate = static_cast<double>(maxBytesPerSecond_);
+  auto delay =
+      bucket_.consumeWithBorrowNonBlocking(bytes, rate, std::max(rate, static_cast<double>(bytes)));
+  return delay.value_or(0);
+}
+
+void ExportProcessor::onPartsFinished(std::vector<std::pair<PartitionID, PartResult>>&& results) {
+  std::unordered_map<PartitionID, cpp2::ScanCursor> cursors;
+  double delaySecs = 0;
+  for (auto& [partId, result] : results) {
+    delaySecs = std::max(delaySecs, result.delaySecs);
+    if (result.code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      handleErrorCode(result.code, spaceId_, partId);
+      continue;
+    }
+    for (auto& batch : result.batches) {
+      resp_.batches_ref()->emplace_back(std::move(batch));
+    }
+    if (result.nextCursor.has_value()) {
+      cpp2::ScanCursor cursor;
+      cursor.next_cursor_ref() = std::move(result.nextCursor).value();
+      cursors.emplace(partId, std::move(cursor));
+    }
+  }
+  resp_.cursors_ref() = std::move(cursors);
+  resp_.snapshot_id_ref() = exportId_;
+  if (delaySecs <= 0) {
+    onFinished();
+    return;
+  }
+  // The response is held back by the throttle instead of sleeping on the reader thread
+  auto delay = std::chrono::microseconds(static_cast<int64_t>(delaySecs * 1000000));
+  if (executor_ == nullptr) {
+    folly::futures::sleep(delay).wait();
+    onFinished();
+    return;
+  }
+  folly::futures::sleep(delay).via(executor_).thenTry([this](auto&&) { onFinished(); });
+}
+
+}  // namespace storage
+}  // namespace nebula
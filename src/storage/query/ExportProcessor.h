@@ -0,0 +1,163 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_QUERY_EXPORTPROCESSOR_H_
+#define STORAGE_QUERY_EXPORTPROCESSOR_H_
+
+#include <folly/Synchronized.h>
+#include <folly/TokenBucket.h>
+#include <folly/container/F14Map.h>
+
+#include "common/base/Base.h"
+#include "storage/BaseProcessor.h"
+
+namespace nebula {
+namespace storage {
+
+extern ProcessorCounters kExportCounters;
+
+/**
+ * @brief The snapshots of the parts being exported, so that all the pages of a part are read from
+ * the same snapshot. A snapshot is released when its part is exported, or if it's not used in
+ * --export_snapshot_ttl_secs, e.g. the client is gone. It's never released while a page is being
+ * read from it.
+ */
+class ExportSnapshots final {
+ public:
+  static ExportSnapshots& instance() {
+    static ExportSnapshots snapshots;
+    return snapshots;
+  }
+
+  int64_t newExportId() {
+    return nextExportId_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief The snapshot of the part in the export, which is taken by the first call. Each
+   * snapshot acquired must be released after the page is read.
+   *
+   * @return const void* nullptr if the snapshot could not be taken, e.g. not the leader
+   */
+  const void* acquire(kvstore::KVStore* kvstore,
+                      int64_t exportId,
+                      GraphSpaceID spaceId,
+                      PartitionID partId,
+                      bool canReadFromFollower);
+
+  /**
+   * @brief Stop using the snapshot of the part, it's dropped once no page is read from it if the
+   * part is finished
+   */
+  void release(kvstore::KVStore* kvstore,
+               int64_t exportId,
+               GraphSpaceID spaceId,
+               PartitionID partId,
+               bool finished);
+
+  // Release the snapshots not used in --export_snapshot_ttl_secs, except the ones being read
+  void expire(kvstore::KVStore* kvstore);
+
+  size_t size() const {
+    return snapshots_.rlock()->size();
+  }
+
+ private:
+  ExportSnapshots();
+
+  using Key = std::tuple<int64_t, GraphSpaceID, PartitionID>;
+
+  struct Entry {
+    const void* snapshot{nullptr};
+    int64_t lastUsedSec{0};
+    // The pages being read from the snapshot
+    int32_t readers{0};
+    bool finished{false};
+  };
+
+  std::atomic<int64_t> nextExportId_;
+  folly::Synchronized<folly::F14FastMap<Key, Entry>> snapshots_;
+};
+
+/**
+ * @brief Processor to export all the vertices or the out edges of the parts in columnar batches,
+ * without boxing the props into the rows of a DataSet. The parts are exported in parallel, each
+ * from its snapshot, and paged by the cursors like the scans. The props are decoded into the
+ * columns, or the encoded rows are returned as they are if raw_rows is set. The batches are
+ * throttled by max_bytes_per_second of the request.
+ */
+class ExportProcessor : public BaseProcessor<cpp2::ExportResponse> {
+ public:
+  /**
+   * @brief Construct instance of ExportProcessor
+   *
+   * @param env Related environment variables for storage.
+   * @param counters Statistic counter pointer for export.
+   * @param executor Expected executor for this processor, running directly if nullptr.
+   * @return ExportProcessor* Constructed instance.
+   */
+  static ExportProcessor* instance(StorageEnv* env,
+                                   const ProcessorCounters* counters = &kExportCounters,
+                                   folly::Executor* executor = nullptr) {
+    return new ExportProcessor(env, counters, executor);
+  }
+
+  void process(const cpp2::ExportRequest& req);
+
+  /**
+   * @brief Fail the whole export with the code, which is returned in the code of the response
+   */
+  void reject(nebula::cpp2::ErrorCode code, const cpp2::ExportRequest& req);
+
+ protected:
+  ExportProcessor(StorageEnv* env, const ProcessorCounters* counters, folly::Executor* executor)
+      : BaseProcessor<cpp2::ExportResponse>(env, counters), executor_(executor) {}
+
+ private:
+  // The versions of a tag or an edge type, the latest is the last
+  struct Schema {
+    std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>> versions;
+    std::optional<std::pair<int64_t, std::string>> ttl;
+  };
+
+  struct PartResult {
+    nebula::cpp2::ErrorCode code{nebula::cpp2::ErrorCode::SUCCEEDED};
+    std::vector<cpp2::ExportBatch> batches;
+    std::optional<std::string> nextCursor;
+    // The seconds to wait before the batches are returned
+    double delaySecs{0};
+  };
+
+  void doProcess(const cpp2::ExportRequest& req);
+
+  nebula::cpp2::ErrorCode buildSchemas(const std::vector<int32_t>& schemaIds);
+
+  // The parts of the request, or all the leader parts of the space on this host
+  std::unordered_map<PartitionID, cpp2::ScanCursor> partsToExport(const cpp2::ExportRequest& req);
+
+  PartResult exportPart(PartitionID partId, const std::string& cursor);
+
+  // The seconds to wait until the bytes are allowed by max_bytes_per_second
+  double throttle(int64_t bytes);
+
+  void onPartsFinished(std::vector<std::pair<PartitionID, PartResult>>&& results);
+
+ private:
+  folly::Executor* executor_{nullptr};
+  GraphSpaceID spaceId_;
+  bool edge_{false};
+  int64_t limit_{0};
+  size_t batchSize_{0};
+  bool rawRows_{false};
+  int64_t maxBytesPerSecond_{0};
+  bool enableReadFollower_{false};
+  int64_t exportId_{0};
+  folly::F14FastMap<int32_t, Schema> schemas_;
+  folly::DynamicTokenBucket bucket_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_QUERY_EXPORTPROCESSOR_H_
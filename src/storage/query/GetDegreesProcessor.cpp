@@ -0,0 +1,110 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/query/GetDegreesProcessor.h"
+
+#include "common/utils/NebulaKeyUtils.h"
+#include "storage/mutate/DegreeCounter.h"
+
+namespace nebula {
+namespace storage {
+
+ProcessorCounters kGetDegreesCounters;
+
+void GetDegreesProcessor::process(const cpp2::GetDegreesRequest& req) {
+  if (executor_ != nullptr) {
+    executor_->add([req, this]() { this->doProcess(req); });
+  } else {
+    doProcess(req);
+  }
+}
+
+void GetDegreesProcessor::doProcess(const cpp2::GetDegreesRequest& req) {
+  spaceId_ = req.get_space_id();
+  auto retCode = getSpaceVidLen(spaceId_);
+  if (retCode == nebula::cpp2::ErrorCode::SUCCEEDED) {
+    retCode = buildEdgeTypes(req.get_edge_types());
+  }
+  if (retCode != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    for (auto& p : req.get_parts()) {
+      pushResultCode(retCode, p.first);
+    }
+    onFinished();
+    return;
+  }
+
+  for (const auto& [partId, vIds] : req.get_parts()) {
+    for (const auto& vId : vIds) {
+      auto code = getDegrees(partId, vId);
+      if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        handleErrorCode(code, spaceId_, partId);
+        break;
+      }
+    }
+  }
+  resp_.degrees_ref() = std::move(degrees_);
+  onFinished();
+}
+
+nebula::cpp2::ErrorCode GetDegreesProcessor::buildEdgeTypes(
+    const std::vector<EdgeType>& edgeTypes) {
+  if (edgeTypes.empty()) {
+    auto edges = env_->schemaMan_->getAllVerEdgeSchema(spaceId_);
+    if (!edges.ok()) {
+      return nebula::cpp2::ErrorCode::E_SPACE_NOT_FOUND;
+    }
+    for (const auto& entry : edges.value()) {
+      edgeTypes_.emplace_back(entry.first);
+      edgeTypes_.emplace_back(-entry.first);
+    }
+  } else {
+    edgeTypes_ = edgeTypes;
+  }
+  degrees_.colNames.emplace_back(kVid);
+  for (auto edgeType : edgeTypes_) {
+    auto edgeName = env_->schemaMan_->toEdgeName(spaceId_, std::abs(edgeType));
+    if (!edgeName.ok()) {
+      return nebula::cpp2::ErrorCode::E_EDGE_NOT_FOUND;
+    }
+    degrees_.colNames.emplace_back(
+        folly::stringPrintf("_degree:%c%s", edgeType > 0 ? '+' : '-', edgeName.value().c_str()));
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode GetDegreesProcessor::getDegrees(PartitionID partId, const Value& vId) {
+  if (!vId.isStr() || !NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId.getStr())) {
+    return nebula::cpp2::ErrorCode::E_INVALID_VID;
+  }
+  const auto& id = vId.getStr();
+  std::vector<std::string> keys;
+  keys.reserve(edgeTypes_.size());
+  for (auto edgeType : edgeTypes_) {
+    keys.emplace_back(NebulaKeyUtils::degreeKey(spaceVidLen_, partId, id, edgeType));
+  }
+  std::vector<std::string> values;
+  auto ret = env_->kvstore_->multiGet(spaceId_, partId, keys, &values);
+  if (ret.first != nebula::cpp2::ErrorCode::SUCCEEDED &&
+      ret.first != nebula::cpp2::ErrorCode::E_PARTIAL_RESULT) {
+    return ret.first;
+  }
+
+  Row row;
+  row.values.reserve(edgeTypes_.size() + 1);
+  if (isIntId_) {
+    row.values.emplace_back(*reinterpret_cast<const int64_t*>(id.data()));
+  } else {
+    row.values.emplace_back(id);
+  }
+  for (size_t i = 0; i < edgeTypes_.size(); ++i) {
+    bool found = i < ret.second.size() && ret.second[i].ok();
+    row.values.emplace_back(found ? DegreeCounter::decode(values[i]) : 0L);
+  }
+  degrees_.rows.emplace_back(std::move(row));
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,62 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_QUERY_GETDEGREESPROCESSOR_H_
+#define STORAGE_QUERY_GETDEGREESPROCESSOR_H_
+
+#include "common/base/Base.h"
+#include "storage/BaseProcessor.h"
+
+namespace nebula {
+namespace storage {
+
+extern ProcessorCounters kGetDegreesCounters;
+
+/**
+ * @brief Processor to read the degree counters of vertices by edge type, each of which is one
+ * point lookup instead of a scan of the edges. The degrees not counted are returned as 0.
+ */
+class GetDegreesProcessor : public BaseProcessor<cpp2::GetDegreesResponse> {
+ public:
+  /**
+   * @brief Construct instance of GetDegreesProcessor
+   *
+   * @param env Related environment variables for storage.
+   * @param counters Statistic counter pointer for getting degrees.
+   * @param executor Expected executor for this processor, running directly if nullptr.
+   * @return GetDegreesProcessor* Constructed instance.
+   */
+  static GetDegreesProcessor* instance(StorageEnv* env,
+                                       const ProcessorCounters* counters = &kGetDegreesCounters,
+                                       folly::Executor* executor = nullptr) {
+    return new GetDegreesProcessor(env, counters, executor);
+  }
+
+  void process(const cpp2::GetDegreesRequest& req);
+
+ protected:
+  GetDegreesProcessor(StorageEnv* env,
+                      const ProcessorCounters* counters,
+                      folly::Executor* executor)
+      : BaseProcessor<cpp2::GetDegreesResponse>(env, counters), executor_(executor) {}
+
+ private:
+  void doProcess(const cpp2::GetDegreesRequest& req);
+
+  // Build the column names of the given edge types, or all the edge types in both directions
+  nebula::cpp2::ErrorCode buildEdgeTypes(const std::vector<EdgeType>& edgeTypes);
+
+  nebula::cpp2::ErrorCode getDegrees(PartitionID partId, const Value& vId);
+
+ private:
+  folly::Executor* executor_{nullptr};
+  GraphSpaceID spaceId_;
+  std::vector<EdgeType> edgeTypes_;
+  DataSet degrees_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_QUERY_GETDEGREESPROCESSOR_H_
@@ -5,6 +5,9 @@
 
 #include "storage/query/GetNeighborsProcessor.h"
 
+#include <numeric>
+
+#include "kvstore/RocksReadProfiler.h"
 #include "storage/StorageFlags.h"
 #include "storage/exec/AggregateNode.h"
 #include "storage/exec/EdgeNode.h"
@@ -13,6 +16,7 @@
 #include "storage/exec/HashJoinNode.h"
 #include "storage/exec/MultiTagNode.h"
 #include "storage/exec/TagNode.h"
+#include "storage/query/GetPropProcessor.h"
 
 namespace nebula {
 namespace storage {
@@ -53,6 +57,21 @@ void GetNeighborsProcessor::doProcess(const cpp2::GetNeighborsRequest& req) {
     return;
   }
 
+  confirmLeadership(req, [this](const cpp2::GetNeighborsRequest& confirmed) {
+    readParts(confirmed);
+  });
+}
+
+void GetNeighborsProcessor::readParts(const cpp2::GetNeighborsRequest& req) {
+  if (env_->hotKeys_ != nullptr) {
+    hotKeys_ = env_->hotKeys_->tracker(HotKeys::kGetNeighbors);
+    for (size_t i = 0; i < resultDataSet_.colNames.size(); i++) {
+      if (folly::StringPiece(resultDataSet_.colNames[i]).startsWith("_edge:")) {
+        edgeColumns_.emplace_back(i);
+      }
+    }
+  }
+
   int64_t limit = FLAGS_max_edge_returned_per_vertex;
   bool random = false;
   if ((*req.traverse_spec_ref()).limit_ref().has_value()) {
@@ -63,6 +82,18 @@ void GetNeighborsProcessor::doProcess(const cpp2::GetNeighborsRequest& req) {
       random = *(*req.traverse_spec_ref()).random_ref();
     }
   }
+  if (random && (*req.traverse_spec_ref()).edge_budget_ref().has_value() &&
+      !edgeContext_.propContexts_.empty()) {
+    edgeBudget_ = *(*req.traverse_spec_ref()).edge_budget_ref();
+  }
+  if ((*req.traverse_spec_ref()).dst_vertex_props_ref().has_value()) {
+    dstVertexProps_ = *(*req.traverse_spec_ref()).dst_vertex_props_ref();
+    if (req.common_ref().has_value()) {
+      dstCommon_ = *req.common_ref();
+      // The filter is of the srcs, not the dsts
+      dstCommon_.vid_filter_ref().reset();
+    }
+  }
 
   // todo(doodle): specify by each query
   if (!FLAGS_query_concurrently) {
@@ -77,11 +108,26 @@ void GetNeighborsProcessor::runInSingleThread(const cpp2::GetNeighborsRequest& r
                                               bool random) {
   contexts_.emplace_back(RuntimeContext(planContext_.get()));
   expCtxs_.emplace_back(StorageExpressionContext(spaceVidLen_, isIntId_));
-  auto plan = buildPlan(&contexts_.front(), &expCtxs_.front(), &resultDataSet_, limit, random);
+  GetNeighborsTopNNode* topN = nullptr;
+  std::vector<TagNode*> tags;
+  auto plan = buildPlan(&contexts_.front(),
+                        &expCtxs_.front(),
+                        &resultDataSet_,
+                        limit,
+                        random,
+                        &topN,
+                        edgeBudget_ >= 0 ? &degrees_ : nullptr,
+                        &tags);
+  std::optional<kvstore::RocksReadProfiler> readProfiler;
+  if (UNLIKELY(profileReads())) {
+    readProfiler.emplace();
+  }
   std::unordered_set<PartitionID> failedParts;
   for (const auto& partEntry : req.get_parts()) {
     contexts_.front().resultStat_ = ResultStatus::NORMAL;
     auto partId = partEntry.first;
+    size_t partEdges = 0;
+    prefetchTags(tags, partId, partEntry.second);
     for (const auto& row : partEntry.second) {
       CHECK_GE(row.values.size(), 1);
       auto vId = row.values[0].getStr();
@@ -95,25 +141,46 @@ void GetNeighborsProcessor::runInSingleThread(const cpp2::GetNeighborsRequest& r
       }
 
       // the first column of each row would be the vertex id
+      auto rowsBefore = resultDataSet_.rows.size();
       auto ret = plan.go(partId, vId);
       if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
         if (failedParts.find(partId) == failedParts.end()) {
           failedParts.emplace(partId);
           handleErrorCode(ret, spaceId_, partId);
         }
+      } else if (hotKeys_ != nullptr) {
+        auto edges = edgesOfRows(resultDataSet_, rowsBefore);
+        hotKeys_->addVertex(spaceId_, partId, vId, edges);
+        partEdges += edges;
+      }
+    }
+    if (hotKeys_ != nullptr) {
+      hotKeys_->addPart(spaceId_, partId, partEdges);
+    }
+    // the top edges are kept for each part
+    if (topN != nullptr) {
+      auto ret = topN->finish();
+      if (ret != nebula::cpp2::ErrorCode::SUCCEEDED &&
+          failedParts.find(partId) == failedParts.end()) {
+        failedParts.emplace(partId);
+        handleErrorCode(ret, spaceId_, partId);
       }
     }
   }
+  if (readProfiler.has_value()) {
+    addReadStats(readProfiler->stats());
+  }
   if (UNLIKELY(profileDetailFlag_)) {
     profilePlan(plan);
   }
   onProcessFinished();
-  onFinished();
+  readDstVertices();
 }
 
 void GetNeighborsProcessor::runInMultipleThread(const cpp2::GetNeighborsRequest& req,
                                                 int64_t limit,
                                                 bool random) {
+  degreesOfPart_.resize(req.get_parts().size());
   for (size_t i = 0; i < req.get_parts().size(); i++) {
     nebula::DataSet result = resultDataSet_;
     results_.emplace_back(std::move(result));
@@ -121,69 +188,112 @@ void GetNeighborsProcessor::runInMultipleThread(const cpp2::GetNeighborsRequest&
     expCtxs_.emplace_back(StorageExpressionContext(spaceVidLen_, isIntId_));
   }
   size_t i = 0;
-  std::vector<folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>>> futures;
-  for (const auto& [partId, rows] : req.get_parts()) {
-    futures.emplace_back(
-        runInExecutor(&contexts_[i], &expCtxs_[i], &results_[i], partId, rows, limit, random));
+  std::vector<std::pair<PartitionID, PartTask>> tasks;
+  // The request is not kept until the parts are run, so the rows are copied once and moved into
+  // the tasks
+  auto parts = req.get_parts();
+  for (auto& [partId, rows] : parts) {
+    auto* context = &contexts_[i];
+    auto* expCtx = &expCtxs_[i];
+    auto* result = &results_[i];
+    auto* degrees = edgeBudget_ >= 0 ? &degreesOfPart_[i] : nullptr;
+    tasks.emplace_back(partId,
+                       [this,
+                        context,
+                        expCtx,
+                        result,
+                        partId = partId,
+                        rows = std::move(rows),
+                        limit,
+                        random,
+                        degrees]() {
+                         return runPart(
+                             context, expCtx, result, partId, rows, limit, random, degrees);
+                       });
     i++;
   }
 
-  folly::collectAll(futures).via(executor_).thenTry([this](auto&& t) mutable {
-    CHECK(!t.hasException());
-    const auto& tries = t.value();
-    for (size_t j = 0; j < tries.size(); j++) {
-      CHECK(!tries[j].hasException());
-      const auto& [code, partId] = tries[j].value();
+  runPartsConcurrently(std::move(tasks), [this](PartCodes&& codes) {
+    for (size_t j = 0; j < codes.size(); j++) {
+      const auto& [code, partId] = codes[j];
       if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
         handleErrorCode(code, spaceId_, partId);
       } else {
         resultDataSet_.append(std::move(results_[j]));
+        degrees_.insert(degrees_.end(), degreesOfPart_[j].begin(), degreesOfPart_[j].end());
       }
     }
     this->onProcessFinished();
-    this->onFinished();
+    this->readDstVertices();
   });
 }
 
-folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> GetNeighborsProcessor::runInExecutor(
-    RuntimeContext* context,
-    StorageExpressionContext* expCtx,
-    nebula::DataSet* result,
-    PartitionID partId,
-    const std::vector<nebula::Row>& rows,
-    int64_t limit,
-    bool random) {
-  return folly::via(
-      executor_, [this, context, expCtx, result, partId, input = std::move(rows), limit, random]() {
-        auto plan = buildPlan(context, expCtx, result, limit, random);
-        for (const auto& row : input) {
-          CHECK_GE(row.values.size(), 1);
-          auto vId = row.values[0].getStr();
-
-          if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId)) {
-            LOG(INFO) << "Space " << spaceId_ << ", vertex length invalid, "
-                      << " space vid len: " << spaceVidLen_ << ",  vid is " << vId;
-            return std::make_pair(nebula::cpp2::ErrorCode::E_INVALID_VID, partId);
-          }
+nebula::cpp2::ErrorCode GetNeighborsProcessor::runPart(RuntimeContext* context,
+                                                       StorageExpressionContext* expCtx,
+                                                       nebula::DataSet* result,
+                                                       PartitionID partId,
+                                                       const std::vector<nebula::Row>& rows,
+                                                       int64_t limit,
+                                                       bool random,
+                                                       std::vector<int64_t>* degrees) {
+  GetNeighborsTopNNode* topN = nullptr;
+  std::vector<TagNode*> tags;
+  auto plan = buildPlan(context, expCtx, result, limit, random, &topN, degrees, &tags);
+  // The perf context of rocksdb is thread local, the plan of a part is run in one thread
+  std::optional<kvstore::RocksReadProfiler> readProfiler;
+  if (UNLIKELY(this->profileReads())) {
+    readProfiler.emplace();
+  }
+  size_t partEdges = 0;
+  prefetchTags(tags, partId, rows);
+  for (const auto& row : rows) {
+    CHECK_GE(row.values.size(), 1);
+    auto vId = row.values[0].getStr();
+
+    if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId)) {
+      LOG(INFO) << "Space " << spaceId_ << ", vertex length invalid, "
+                << " space vid len: " << spaceVidLen_ << ",  vid is " << vId;
+      return nebula::cpp2::ErrorCode::E_INVALID_VID;
+    }
 
-          // the first column of each row would be the vertex id
-          auto ret = plan.go(partId, vId);
-          if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
-            return std::make_pair(ret, partId);
-          }
-        }
-        if (UNLIKELY(this->profileDetailFlag_)) {
-          profilePlan(plan);
-        }
-        return std::make_pair(nebula::cpp2::ErrorCode::SUCCEEDED, partId);
-      });
+    // the first column of each row would be the vertex id
+    auto rowsBefore = result->rows.size();
+    auto ret = plan.go(partId, vId);
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return ret;
+    }
+    if (hotKeys_ != nullptr) {
+      auto edges = edgesOfRows(*result, rowsBefore);
+      hotKeys_->addVertex(spaceId_, partId, vId, edges);
+      partEdges += edges;
+    }
+  }
+  if (hotKeys_ != nullptr) {
+    hotKeys_->addPart(spaceId_, partId, partEdges);
+  }
+  if (topN != nullptr) {
+    auto ret = topN->finish();
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return ret;
+    }
+  }
+  if (readProfiler.has_value()) {
+    addReadStats(readProfiler->stats());
+  }
+  if (UNLIKELY(this->profileDetailFlag_)) {
+    profilePlan(plan);
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
 StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(RuntimeContext* context,
                                                        StorageExpressionContext* expCtx,
                                                        nebula::DataSet* result,
                                                        int64_t limit,
-                                                       bool random) {
+                                                       bool random,
+                                                       GetNeighborsTopNNode** topNNode,
+                                                       std::vector<int64_t>* degrees,
+                                                       std::vector<TagNode*>* tagNodes) {
   /*
   The StoragePlan looks like this:
              +------------------+                      or, if there is no edge:
@@ -221,8 +331,23 @@ StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(RuntimeContext* context,
     plan.addNode(std::move(tag));
   }
   std::vector<SingleEdgeNode*> edges;
+  // The filter, the order by and the stats are evaluated on the edge props, and the sampling reads
+  // the values as well
+  bool valueUnused = filter_ == nullptr && orderBy_.empty() && !random &&
+                     edgeContext_.statCount_ == 0;
   for (const auto& ec : edgeContext_.propContexts_) {
-    auto edge = std::make_unique<SingleEdgeNode>(context, &edgeContext_, ec.first, &ec.second);
+    // The values are not read at all if all the props are in the key, e.g. only _dst is returned
+    bool keyOnly = valueUnused && std::all_of(ec.second.begin(), ec.second.end(), [](auto& prop) {
+                     return prop.propInKeyType_ != PropContext::PropInKeyType::NONE;
+                   });
+    auto edge = std::make_unique<SingleEdgeNode>(
+        context,
+        &edgeContext_,
+        ec.first,
+        &ec.second,
+        nullptr,
+        edgeKeyFilter_ == nullptr ? nullptr : edgeKeyFilter_->clone(),
+        keyOnly);
     edges.emplace_back(edge.get());
     plan.addNode(std::move(edge));
   }
@@ -271,9 +396,16 @@ StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(RuntimeContext* context,
   }
 
   std::unique_ptr<GetNeighborsNode> output;
-  if (random) {
+  if (!orderBy_.empty()) {
+    auto topN = std::make_unique<GetNeighborsTopNNode>(
+        context, join, upstream, &edgeContext_, result, expCtx, &orderBy_, limit);
+    if (topNNode != nullptr) {
+      *topNNode = topN.get();
+    }
+    output = std::move(topN);
+  } else if (random) {
     output = std::make_unique<GetNeighborsSampleNode>(
-        context, join, upstream, &edgeContext_, result, limit);
+        context, join, upstream, &edgeContext_, result, limit, degrees);
   } else {
     output =
         std::make_unique<GetNeighborsNode>(context, join, upstream, &edgeContext_, result, limit);
@@ -281,9 +413,34 @@ StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(RuntimeContext* context,
   output->addDependency(upstream);
   plan.addNode(std::move(output));
 
+  if (UNLIKELY(profileDetailFlag_)) {
+    plan.enableProfile();
+  }
+  if (tagNodes != nullptr) {
+    *tagNodes = std::move(tags);
+  }
   return plan;
 }
 
+void GetNeighborsProcessor::prefetchTags(const std::vector<TagNode*>& tagNodes,
+                                         PartitionID partId,
+                                         const std::vector<nebula::Row>& rows) {
+  if (tagNodes.empty() || FLAGS_get_prop_batch_read_threshold == 0 ||
+      rows.size() < FLAGS_get_prop_batch_read_threshold) {
+    return;
+  }
+  std::vector<VertexID> vIds;
+  vIds.reserve(rows.size());
+  for (const auto& row : rows) {
+    const auto& vId = row.values[0].getStr();
+    // The invalid vid is reported when executing the plan
+    if (NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId)) {
+      vIds.emplace_back(vId);
+    }
+  }
+  TagNode::prefetch(executor_, tagNodes, partId, vIds, readStatsAdder());
+}
+
 nebula::cpp2::ErrorCode GetNeighborsProcessor::checkAndBuildContexts(
     const cpp2::GetNeighborsRequest& req) {
   resultDataSet_.colNames.emplace_back(kVid);
@@ -320,6 +477,35 @@ nebula::cpp2::ErrorCode GetNeighborsProcessor::checkAndBuildContexts(
   if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
     return code;
   }
+  if (!edgeContext_.propContexts_.empty()) {
+    splitEdgeKeyFilter();
+  }
+  code = buildOrderBy(req.get_traverse_spec());
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return code;
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode GetNeighborsProcessor::buildOrderBy(const cpp2::TraverseSpec& req) {
+  // the edges are only sorted when both order by and limit are given, and they are returned
+  if (!req.order_by_ref().has_value() || (*req.order_by_ref()).empty() ||
+      !req.limit_ref().has_value() || *req.limit_ref() < 0 || req.random_ref().value_or(false) ||
+      edgeContext_.propContexts_.empty() || edgeContext_.statsOnly_) {
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+  auto pool = &this->planContext_->objPool_;
+  for (const auto& orderBy : *req.order_by_ref()) {
+    auto exp = Expression::decode(pool, orderBy.get_prop());
+    if (exp == nullptr) {
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    auto code = checkExp(exp, false, true, false, true);
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+    orderBy_.emplace_back(exp, orderBy.get_direction());
+  }
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
@@ -355,8 +541,14 @@ nebula::cpp2::ErrorCode GetNeighborsProcessor::buildEdgeContext(const cpp2::Trav
     if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
       return ret;
     }
+    // the edges are only iterated to calculate the stats, no edge column is returned, the
+    // sampled edges are always returned
+    edgeContext_.statsOnly_ = req.stats_only_ref().value_or(false) &&
+                              !req.random_ref().value_or(false) && edgeContext_.statCount_ > 0;
+  }
+  if (!edgeContext_.statsOnly_) {
+    buildEdgeColName(std::move(returnProps));
   }
-  buildEdgeColName(std::move(returnProps));
   buildEdgeTTLInfo();
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
@@ -460,15 +652,197 @@ nebula::cpp2::ErrorCode GetNeighborsProcessor::handleEdgeStatProps(
 }
 
 void GetNeighborsProcessor::onProcessFinished() {
+  if (edgeBudget_ >= 0) {
+    applyEdgeBudget();
+  }
   resp_.vertices_ref() = std::move(resultDataSet_);
 }
 
+void GetNeighborsProcessor::applyEdgeBudget() {
+  auto& rows = resultDataSet_.rows;
+  if (rows.size() != degrees_.size()) {
+    LOG(WARNING) << "The degrees of " << degrees_.size() << " vertices mismatch the "
+                 << rows.size() << " rows, edge budget is skipped";
+    return;
+  }
+
+  // the share of each vertex is rounded down, and the rest of the budget are given to the ones
+  // with the largest remainders
+  std::vector<int64_t> quotas = degrees_;
+  auto total = std::accumulate(degrees_.begin(), degrees_.end(), static_cast<int64_t>(0));
+  if (total > edgeBudget_) {
+    std::vector<std::pair<double, size_t>> remainders;
+    remainders.reserve(rows.size());
+    int64_t assigned = 0;
+    for (size_t i = 0; i < rows.size(); i++) {
+      double share = static_cast<double>(edgeBudget_) * degrees_[i] / total;
+      quotas[i] = static_cast<int64_t>(share);
+      assigned += quotas[i];
+      remainders.emplace_back(share - quotas[i], i);
+    }
+    std::sort(remainders.begin(), remainders.end(), std::greater<std::pair<double, size_t>>());
+    for (size_t i = 0; i < remainders.size() && assigned < edgeBudget_; i++) {
+      quotas[remainders[i].second]++;
+      assigned++;
+    }
+  }
+
+  auto first = edgeContext_.offset_;
+  auto last = first + edgeContext_.propContexts_.size();
+  std::vector<Value> truncated;
+  for (size_t i = 0; i < rows.size(); i++) {
+    auto& values = rows[i].values;
+    int64_t returned = 0;
+    for (size_t col = first; col < last; col++) {
+      if (values[col].isList()) {
+        returned += values[col].getList().size();
+      }
+    }
+    // the edges may be cut by the per vertex limit already
+    if (std::min(returned, quotas[i]) < degrees_[i]) {
+      truncated.emplace_back(values[0]);
+    }
+    if (returned <= quotas[i]) {
+      continue;
+    }
+    // sample the quota of the edges sampled before, which are in all edge columns of the row
+    nebula::algorithm::ReservoirSampling<std::pair<size_t, size_t>> sampler(quotas[i]);
+    for (size_t col = first; col < last; col++) {
+      if (!values[col].isList()) {
+        continue;
+      }
+      for (size_t idx = 0; idx < values[col].getList().size(); idx++) {
+        sampler.sampling(std::make_pair(col, idx));
+      }
+    }
+    auto samples = sampler.samples();
+    std::sort(samples.begin(), samples.end());
+    std::vector<nebula::List> kept(last - first);
+    for (const auto& [col, idx] : samples) {
+      kept[col - first].values.emplace_back(std::move(values[col].mutableList().values[idx]));
+    }
+    for (size_t col = first; col < last; col++) {
+      if (kept[col - first].values.empty()) {
+        values[col] = Value();
+      } else {
+        values[col] = std::move(kept[col - first]);
+      }
+    }
+  }
+  resp_.truncated_vertices_ref() = std::move(truncated);
+}
+
+size_t GetNeighborsProcessor::edgesOfRows(const nebula::DataSet& result, size_t from) const {
+  size_t edges = 0;
+  for (size_t i = from; i < result.rows.size(); i++) {
+    const auto& values = result.rows[i].values;
+    for (auto column : edgeColumns_) {
+      if (column < values.size() && values[column].isList()) {
+        edges += values[column].getList().size();
+      }
+    }
+  }
+  return edges;
+}
+
 void GetNeighborsProcessor::profilePlan(StoragePlan<VertexID>& plan) {
   auto& nodes = plan.getNodes();
   std::lock_guard<std::mutex> lck(BaseProcessor<cpp2::GetNeighborsResponse>::profileMut_);
   for (auto& node : nodes) {
     profileDetail(node->name_, node->duration_.elapsedInUSec());
+    if (node->isDependent_) {
+      // The dummy output node of the plan is left out
+      profileNode(node->name_, node->rows_, node->duration_.elapsedInUSec(), node->profileStats());
+    }
   }
 }
+void GetNeighborsProcessor::readDstVertices() {
+  if (!dstVertexProps_.has_value() || !resp_.vertices_ref().has_value()) {
+    onFinished();
+    return;
+  }
+  auto numParts = env_->metaClient_->partsNum(spaceId_);
+  if (!numParts.ok()) {
+    onFinished();
+    return;
+  }
+  const auto& vertices = *resp_.vertices_ref();
+  // The edge columns and the index of _dst in their props
+  std::vector<std::pair<size_t, size_t>> dstColumns;
+  for (size_t i = 0; i < vertices.colNames.size(); i++) {
+    std::vector<folly::StringPiece> names;
+    folly::split(':', vertices.colNames[i], names);
+    if (names.size() < 3 || names[0] != "_edge") {
+      continue;
+    }
+    auto found = std::find(names.begin() + 2, names.end(), kDst);
+    if (found != names.end()) {
+      dstColumns.emplace_back(i, found - names.begin() - 2);
+    }
+  }
+
+  std::unordered_map<PartitionID, bool> localParts;
+  std::unordered_set<Value> dsts;
+  std::vector<Value> fetched;
+  cpp2::GetPropRequest req;
+  for (const auto& row : vertices.rows) {
+    for (const auto& [col, index] : dstColumns) {
+      const auto& edges = row.values[col];
+      if (!edges.isList()) {
+        continue;
+      }
+      for (const auto& edge : edges.getList().values) {
+        if (!edge.isList() || edge.getList().values.size() <= index) {
+          continue;
+        }
+        const auto& dst = edge.getList().values[index];
+        if (!dsts.emplace(dst).second) {
+          continue;
+        }
+        // The vids of an INT64 space are given in their binary form
+        std::string vId;
+        if (dst.isInt()) {
+          auto id = dst.getInt();
+          vId.assign(reinterpret_cast<const char*>(&id), sizeof(id));
+        } else if (dst.isStr()) {
+          vId = dst.getStr();
+        } else {
+          continue;
+        }
+        auto partId = env_->metaClient_->partId(numParts.value(), vId);
+        auto local = localParts.find(partId);
+        if (local == localParts.end()) {
+          auto part = env_->kvstore_->part(spaceId_, partId);
+          local = localParts.emplace(partId, nebula::ok(part) && nebula::value(part)->isLeader())
+                      .first;
+        }
+        if (local->second) {
+          (*req.parts_ref())[partId].emplace_back(Row({Value(std::move(vId))}));
+          fetched.emplace_back(dst);
+        }
+      }
+    }
+  }
+  if (fetched.empty()) {
+    onFinished();
+    return;
+  }
+
+  req.space_id_ref() = spaceId_;
+  req.vertex_props_ref() = std::move(*dstVertexProps_);
+  req.common_ref() = std::move(dstCommon_);
+  auto* processor = GetPropProcessor::instance(env_, nullptr, executor_);
+  processor->getFuture().thenValue(
+      [this, fetched = std::move(fetched)](cpp2::GetPropResponse&& resp) mutable {
+        // The dsts of a failed part are left to be read by the graph
+        if (resp.get_result().get_failed_parts().empty() && resp.props_ref().has_value()) {
+          resp_.dst_vertices_ref() = std::move(*resp.props_ref());
+          resp_.fetched_dsts_ref() = std::move(fetched);
+        }
+        onFinished();
+      });
+  processor->process(req);
+}
+
 }  // namespace storage
 }  // namespace nebula
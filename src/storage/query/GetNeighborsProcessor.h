@@ -9,6 +9,7 @@
 #include <gtest/gtest_prod.h>
 
 #include "common/base/Base.h"
+#include "storage/exec/GetNeighborsNode.h"
 #include "storage/exec/StoragePlan.h"
 #include "storage/query/QueryBaseProcessor.h"
 
@@ -53,7 +54,16 @@ class GetNeighborsProcessor
                                   StorageExpressionContext* expCtx,
                                   nebula::DataSet* result,
                                   int64_t limit = 0,
-                                  bool random = false);
+                                  bool random = false,
+                                  GetNeighborsTopNNode** topNNode = nullptr,
+                                  std::vector<int64_t>* degrees = nullptr,
+                                  std::vector<TagNode*>* tagNodes = nullptr);
+
+  // Read the tags of the vertices of a part in batches before running the plan of each vertex, so
+  // the tags are not read one after another along with the edges
+  void prefetchTags(const std::vector<TagNode*>& tagNodes,
+                    PartitionID partId,
+                    const std::vector<nebula::Row>& rows);
 
   void onProcessFinished() override;
 
@@ -62,8 +72,13 @@ class GetNeighborsProcessor
  private:
   void doProcess(const cpp2::GetNeighborsRequest& req);
 
+  // Read the parts of the request whose leadership is confirmed
+  void readParts(const cpp2::GetNeighborsRequest& req);
+
   nebula::cpp2::ErrorCode buildTagContext(const cpp2::TraverseSpec& req);
   nebula::cpp2::ErrorCode buildEdgeContext(const cpp2::TraverseSpec& req);
+  // decode the order by expressions to keep the top edges of each part
+  nebula::cpp2::ErrorCode buildOrderBy(const cpp2::TraverseSpec& req);
 
   // build tag/edge col name in response when prop specified
   void buildTagColName(const std::vector<cpp2::VertexProp>& tagProps);
@@ -75,20 +90,44 @@ class GetNeighborsProcessor
   void runInSingleThread(const cpp2::GetNeighborsRequest& req, int64_t limit, bool random);
   void runInMultipleThread(const cpp2::GetNeighborsRequest& req, int64_t limit, bool random);
 
-  folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> runInExecutor(
-      RuntimeContext* context,
-      StorageExpressionContext* expCtx,
-      nebula::DataSet* result,
-      PartitionID partId,
-      const std::vector<nebula::Row>& rows,
-      int64_t limit,
-      bool random);
+  nebula::cpp2::ErrorCode runPart(RuntimeContext* context,
+                                  StorageExpressionContext* expCtx,
+                                  nebula::DataSet* result,
+                                  PartitionID partId,
+                                  const std::vector<nebula::Row>& rows,
+                                  int64_t limit,
+                                  bool random,
+                                  std::vector<int64_t>* degrees);
   void profilePlan(StoragePlan<VertexID>& plan);
 
+  // split the edge budget across the vertices in proportion to their degrees, and trim the sampled
+  // edges of each vertex to its share
+  void applyEdgeBudget();
+
+  // the number of edges in the rows of result since the row from
+  size_t edgesOfRows(const nebula::DataSet& result, size_t from) const;
+
+  // read the props of the dsts in the parts led by this host by GetProp in place, so the graph
+  // doesn't need to send another request for them, then finish the response
+  void readDstVertices();
+
  private:
   std::vector<RuntimeContext> contexts_;
   std::vector<StorageExpressionContext> expCtxs_;
   std::vector<nebula::DataSet> results_;
+  std::vector<GetNeighborsTopNNode::OrderBy> orderBy_;
+  // the max edges returned by the request when sampling, negative if not given
+  int64_t edgeBudget_{-1};
+  // the degree of each row in result, and of each part in multiple threads
+  std::vector<int64_t> degrees_;
+  std::vector<std::vector<int64_t>> degreesOfPart_;
+  // the hot vertices and parts of get neighbors, nullptr if not tracked
+  HotKeyTracker* hotKeys_{nullptr};
+  // the indexes of the edge columns in result
+  std::vector<size_t> edgeColumns_;
+  // the props of the dsts to read, and the common of the request to read them by
+  std::optional<std::vector<cpp2::VertexProp>> dstVertexProps_;
+  cpp2::RequestCommon dstCommon_;
 };
 
 }  // namespace storage
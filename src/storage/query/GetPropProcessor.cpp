@@ -5,6 +5,9 @@
 
 #include "storage/query/GetPropProcessor.h"
 
+#include <folly/ScopeGuard.h>
+
+#include "kvstore/RocksReadProfiler.h"
 #include "storage/exec/GetPropNode.h"
 
 namespace nebula {
@@ -33,6 +36,9 @@ void GetPropProcessor::doProcess(const cpp2::GetPropRequest& req) {
     onFinished();
     return;
   }
+  if (req.common_ref().has_value() && req.get_common()->profile_detail_ref().value_or(false)) {
+    profileDetailFlag_ = true;
+  }
   this->planContext_ = std::make_unique<PlanContext>(
       this->env_, spaceId_, this->spaceVidLen_, this->isIntId_, req.common_ref());
 
@@ -45,6 +51,24 @@ void GetPropProcessor::doProcess(const cpp2::GetPropRequest& req) {
     return;
   }
 
+  confirmLeadership(
+      req, [this](const cpp2::GetPropRequest& confirmed) { readParts(confirmed); });
+}
+
+void GetPropProcessor::readParts(const cpp2::GetPropRequest& req) {
+  if (env_->hotKeys_ != nullptr) {
+    auto* hotKeys = env_->hotKeys_->tracker(HotKeys::kGetProps);
+    for (const auto& [partId, rows] : req.get_parts()) {
+      for (const auto& row : rows) {
+        // The key of an edge is counted as its source vertex
+        if (!row.values.empty() && row.values[0].isStr()) {
+          hotKeys->addVertex(spaceId_, partId, row.values[0].getStr(), 0);
+        }
+      }
+      hotKeys->addPart(spaceId_, partId, 0);
+    }
+  }
+
   // todo(doodle): specify by each query
   if (!FLAGS_query_concurrently) {
     runInSingleThread(req);
@@ -55,11 +79,17 @@ void GetPropProcessor::doProcess(const cpp2::GetPropRequest& req) {
 
 void GetPropProcessor::runInSingleThread(const cpp2::GetPropRequest& req) {
   contexts_.emplace_back(RuntimeContext(planContext_.get()));
+  std::optional<kvstore::RocksReadProfiler> readProfiler;
+  if (UNLIKELY(profileReads())) {
+    readProfiler.emplace();
+  }
   std::unordered_set<PartitionID> failedParts;
   if (!isEdge_) {
-    auto plan = buildTagPlan(&contexts_.front(), &resultDataSet_);
+    std::vector<TagNode*> tags;
+    auto plan = buildTagPlan(&contexts_.front(), &resultDataSet_, &tags);
     for (const auto& partEntry : req.get_parts()) {
       auto partId = partEntry.first;
+      prefetchTags(tags, partId, partEntry.second);
       for (const auto& row : partEntry.second) {
         auto vId = row.values[0].getStr();
 
@@ -70,6 +100,9 @@ void GetPropProcessor::runInSingleThread(const cpp2::GetPropRequest& req) {
           onFinished();
           return;
         }
+        if (!planContext_->mayContainVid(vId)) {
+          continue;
+        }
 
         auto ret = plan.go(partId, vId);
         if (ret != nebula::cpp2::ErrorCode::SUCCEEDED &&
@@ -99,6 +132,9 @@ void GetPropProcessor::runInSingleThread(const cpp2::GetPropRequest& req) {
           onFinished();
           return;
         }
+        if (!planContext_->mayContainVid((*edgeKey.dst_ref()).getStr())) {
+          continue;
+        }
 
         auto ret = plan.go(partId, edgeKey);
         if (ret != nebula::cpp2::ErrorCode::SUCCEEDED &&
@@ -109,6 +145,9 @@ void GetPropProcessor::runInSingleThread(const cpp2::GetPropRequest& req) {
       }
     }
   }
+  if (readProfiler.has_value()) {
+    addReadStats(readProfiler->stats());
+  }
   onProcessFinished();
   onFinished();
 }
@@ -120,18 +159,23 @@ void GetPropProcessor::runInMultipleThread(const cpp2::GetPropRequest& req) {
     contexts_.emplace_back(RuntimeContext(planContext_.get()));
   }
   size_t i = 0;
-  std::vector<folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>>> futures;
-  for (const auto& [partId, rows] : req.get_parts()) {
-    futures.emplace_back(runInExecutor(&contexts_[i], &results_[i], partId, rows));
+  std::vector<std::pair<PartitionID, PartTask>> tasks;
+  // The request is not kept until the parts are run, so the rows are copied once and moved into
+  // the tasks
+  auto parts = req.get_parts();
+  for (auto& [partId, rows] : parts) {
+    auto* context = &contexts_[i];
+    auto* result = &results_[i];
+    tasks.emplace_back(partId,
+                       [this, context, result, partId = partId, rows = std::move(rows)]() {
+                         return runPart(context, result, partId, rows);
+                       });
     i++;
   }
 
-  folly::collectAll(futures).via(executor_).thenTry([this](auto&& t) mutable {
-    CHECK(!t.hasException());
-    const auto& tries = t.value();
-    for (size_t j = 0; j < tries.size(); j++) {
-      CHECK(!tries[j].hasException());
-      const auto& [code, partId] = tries[j].value();
+  runPartsConcurrently(std::move(tasks), [this](PartCodes&& codes) {
+    for (size_t j = 0; j < codes.size(); j++) {
+      const auto& [code, partId] = codes[j];
       if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
         handleErrorCode(code, spaceId_, partId);
       } else {
@@ -143,58 +187,74 @@ void GetPropProcessor::runInMultipleThread(const cpp2::GetPropRequest& req) {
   });
 }
 
-folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> GetPropProcessor::runInExecutor(
-    RuntimeContext* context,
-    nebula::DataSet* result,
-    PartitionID partId,
-    const std::vector<nebula::Row>& rows) {
-  return folly::via(executor_, [this, context, result, partId, input = std::move(rows)]() {
-    if (!isEdge_) {
-      auto plan = buildTagPlan(context, result);
-      for (const auto& row : input) {
-        auto vId = row.values[0].getStr();
+nebula::cpp2::ErrorCode GetPropProcessor::runPart(RuntimeContext* context,
+                                                  nebula::DataSet* result,
+                                                  PartitionID partId,
+                                                  const std::vector<nebula::Row>& rows) {
+  // The perf context of rocksdb is thread local, a part is got in one thread
+  std::optional<kvstore::RocksReadProfiler> readProfiler;
+  if (UNLIKELY(profileReads())) {
+    readProfiler.emplace();
+  }
+  SCOPE_EXIT {
+    if (readProfiler.has_value()) {
+      addReadStats(readProfiler->stats());
+    }
+  };
+  if (!isEdge_) {
+    std::vector<TagNode*> tags;
+    auto plan = buildTagPlan(context, result, &tags);
+    prefetchTags(tags, partId, rows);
+    for (const auto& row : rows) {
+      auto vId = row.values[0].getStr();
 
-        if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId)) {
-          LOG(INFO) << "Space " << spaceId_ << ", vertex length invalid, "
-                    << " space vid len: " << spaceVidLen_ << ",  vid is " << vId;
-          return std::make_pair(nebula::cpp2::ErrorCode::E_INVALID_VID, partId);
-        }
+      if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId)) {
+        LOG(INFO) << "Space " << spaceId_ << ", vertex length invalid, "
+                  << " space vid len: " << spaceVidLen_ << ",  vid is " << vId;
+        return nebula::cpp2::ErrorCode::E_INVALID_VID;
+      }
+      if (!planContext_->mayContainVid(vId)) {
+        continue;
+      }
 
-        auto ret = plan.go(partId, vId);
-        if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
-          return std::make_pair(ret, partId);
-        }
+      auto ret = plan.go(partId, vId);
+      if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        return ret;
       }
-      return std::make_pair(nebula::cpp2::ErrorCode::SUCCEEDED, partId);
-    } else {
-      auto plan = buildEdgePlan(context, result);
-      for (const auto& row : input) {
-        cpp2::EdgeKey edgeKey;
-        edgeKey.src_ref() = row.values[0].getStr();
-        edgeKey.edge_type_ref() = row.values[1].getInt();
-        edgeKey.ranking_ref() = row.values[2].getInt();
-        edgeKey.dst_ref() = row.values[3].getStr();
+    }
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  } else {
+    auto plan = buildEdgePlan(context, result);
+    for (const auto& row : rows) {
+      cpp2::EdgeKey edgeKey;
+      edgeKey.src_ref() = row.values[0].getStr();
+      edgeKey.edge_type_ref() = row.values[1].getInt();
+      edgeKey.ranking_ref() = row.values[2].getInt();
+      edgeKey.dst_ref() = row.values[3].getStr();
 
-        if (!NebulaKeyUtils::isValidVidLen(
-                spaceVidLen_, (*edgeKey.src_ref()).getStr(), (*edgeKey.dst_ref()).getStr())) {
-          LOG(INFO) << "Space " << spaceId_ << " vertex length invalid, "
-                    << "space vid len: " << spaceVidLen_ << ", edge srcVid: " << *edgeKey.src_ref()
-                    << ", dstVid: " << *edgeKey.dst_ref();
-          return std::make_pair(nebula::cpp2::ErrorCode::E_INVALID_VID, partId);
-        }
+      if (!NebulaKeyUtils::isValidVidLen(
+              spaceVidLen_, (*edgeKey.src_ref()).getStr(), (*edgeKey.dst_ref()).getStr())) {
+        LOG(INFO) << "Space " << spaceId_ << " vertex length invalid, "
+                  << "space vid len: " << spaceVidLen_ << ", edge srcVid: " << *edgeKey.src_ref()
+                  << ", dstVid: " << *edgeKey.dst_ref();
+        return nebula::cpp2::ErrorCode::E_INVALID_VID;
+      }
+      if (!planContext_->mayContainVid((*edgeKey.dst_ref()).getStr())) {
+        continue;
+      }
 
-        auto ret = plan.go(partId, edgeKey);
-        if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
-          return std::make_pair(ret, partId);
-        }
+      auto ret = plan.go(partId, edgeKey);
+      if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        return ret;
       }
-      return std::make_pair(nebula::cpp2::ErrorCode::SUCCEEDED, partId);
     }
-  });
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
 }
 
 StoragePlan<VertexID> GetPropProcessor::buildTagPlan(RuntimeContext* context,
-                                                     nebula::DataSet* result) {
+                                                     nebula::DataSet* result,
+                                                     std::vector<TagNode*>* tagNodes) {
   StoragePlan<VertexID> plan;
   std::vector<TagNode*> tags;
   for (const auto& tc : tagContext_.propContexts_) {
@@ -208,9 +268,33 @@ StoragePlan<VertexID> GetPropProcessor::buildTagPlan(RuntimeContext* context,
     output->addDependency(tag);
   }
   plan.addNode(std::move(output));
+  if (tagNodes != nullptr) {
+    *tagNodes = std::move(tags);
+  }
   return plan;
 }
 
+void GetPropProcessor::prefetchTags(const std::vector<TagNode*>& tagNodes,
+                                    PartitionID partId,
+                                    const std::vector<nebula::Row>& rows) {
+  if (FLAGS_get_prop_batch_read_threshold == 0 ||
+      rows.size() < FLAGS_get_prop_batch_read_threshold) {
+    return;
+  }
+  // Without filter, the vertices after limit won't be read
+  auto num = filter_ == nullptr ? std::min(rows.size(), limit_) : rows.size();
+  std::vector<VertexID> vIds;
+  vIds.reserve(num);
+  for (size_t i = 0; i < num; i++) {
+    const auto& vId = rows[i].values[0].getStr();
+    // The invalid vid is reported when executing the plan
+    if (NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId) && planContext_->mayContainVid(vId)) {
+      vIds.emplace_back(vId);
+    }
+  }
+  TagNode::prefetch(executor_, tagNodes, partId, vIds, readStatsAdder());
+}
+
 StoragePlan<cpp2::EdgeKey> GetPropProcessor::buildEdgePlan(RuntimeContext* context,
                                                            nebula::DataSet* result) {
   StoragePlan<cpp2::EdgeKey> plan;
@@ -325,6 +409,7 @@ void GetPropProcessor::buildEdgeColName(const std::vector<cpp2::EdgeProp>& edgeP
 }
 
 void GetPropProcessor::onProcessFinished() {
+  resultDataSet_.writePacked = planContext_ != nullptr && planContext_->packDataSet_;
   resp_.props_ref() = std::move(resultDataSet_);
 }
 
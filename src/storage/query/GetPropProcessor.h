@@ -8,6 +8,7 @@
 
 #include "common/base/Base.h"
 #include "storage/exec/StoragePlan.h"
+#include "storage/exec/TagNode.h"
 #include "storage/query/QueryBaseProcessor.h"
 
 namespace nebula {
@@ -49,12 +50,26 @@ class GetPropProcessor : public QueryBaseProcessor<cpp2::GetPropRequest, cpp2::G
    */
   void doProcess(const cpp2::GetPropRequest& req);
 
+  /**
+   * @brief Read the parts of the request whose leadership is confirmed.
+   *
+   * @param req Request of the confirmed parts.
+   */
+  void readParts(const cpp2::GetPropRequest& req);
+
  protected:
   GetPropProcessor(StorageEnv* env, const ProcessorCounters* counters, folly::Executor* executor)
       : QueryBaseProcessor<cpp2::GetPropRequest, cpp2::GetPropResponse>(env, counters, executor) {}
 
  private:
-  StoragePlan<VertexID> buildTagPlan(RuntimeContext* context, nebula::DataSet* result);
+  StoragePlan<VertexID> buildTagPlan(RuntimeContext* context,
+                                     nebula::DataSet* result,
+                                     std::vector<TagNode*>* tagNodes = nullptr);
+
+  // Read the tags of the vertices of a part in one batch before executing the plan on them
+  void prefetchTags(const std::vector<TagNode*>& tagNodes,
+                    PartitionID partId,
+                    const std::vector<nebula::Row>& rows);
 
   StoragePlan<cpp2::EdgeKey> buildEdgePlan(RuntimeContext* context, nebula::DataSet* result);
 
@@ -75,11 +90,10 @@ class GetPropProcessor : public QueryBaseProcessor<cpp2::GetPropRequest, cpp2::G
   void runInSingleThread(const cpp2::GetPropRequest& req);
   void runInMultipleThread(const cpp2::GetPropRequest& req);
 
-  folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> runInExecutor(
-      RuntimeContext* context,
-      nebula::DataSet* result,
-      PartitionID partId,
-      const std::vector<nebula::Row>& rows);
+  nebula::cpp2::ErrorCode runPart(RuntimeContext* context,
+                                  nebula::DataSet* result,
+                                  PartitionID partId,
+                                  const std::vector<nebula::Row>& rows);
 
  private:
   std::vector<RuntimeContext> contexts_;
@@ -0,0 +1,195 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/query/KHopGetNeighborsProcessor.h"
+
+#include "storage/query/GetNeighborsProcessor.h"
+
+namespace nebula {
+namespace storage {
+
+ProcessorCounters kKHopGetNeighborsCounters;
+
+void KHopGetNeighborsProcessor::process(const cpp2::KHopGetNeighborsRequest& req) {
+  req_ = req;
+  if (executor_ != nullptr) {
+    executor_->add([this]() { this->doProcess(); });
+  } else {
+    doProcess();
+  }
+}
+
+void KHopGetNeighborsProcessor::doProcess() {
+  spaceId_ = req_.get_space_id();
+  steps_ = req_.get_steps();
+  auto retCode = getSpaceVidLen(spaceId_);
+  if (retCode == nebula::cpp2::ErrorCode::SUCCEEDED && steps_ < 1) {
+    retCode = nebula::cpp2::ErrorCode::E_INVALID_PARM;
+  }
+  if (retCode == nebula::cpp2::ErrorCode::SUCCEEDED) {
+    auto numParts = env_->metaClient_->partsNum(spaceId_);
+    if (numParts.ok()) {
+      numParts_ = numParts.value();
+    } else {
+      retCode = nebula::cpp2::ErrorCode::E_SPACE_NOT_FOUND;
+    }
+  }
+  if (retCode == nebula::cpp2::ErrorCode::SUCCEEDED && steps_ > 1) {
+    retCode = buildDstSpec();
+  }
+  if (retCode != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    for (auto& p : req_.get_parts()) {
+      pushResultCode(retCode, p.first);
+    }
+    onFinished();
+    return;
+  }
+  expand(1, req_.get_parts());
+}
+
+nebula::cpp2::ErrorCode KHopGetNeighborsProcessor::buildDstSpec() {
+  const auto& spec = req_.get_traverse_spec();
+  dstSpec_.edge_types_ref() = spec.get_edge_types();
+  dstSpec_.edge_direction_ref() = spec.get_edge_direction();
+  std::vector<cpp2::EdgeProp> edgeProps;
+  if (spec.edge_props_ref().has_value() && !spec.edge_props_ref()->empty()) {
+    for (const auto& edgeProp : *spec.edge_props_ref()) {
+      cpp2::EdgeProp prop;
+      prop.type_ref() = edgeProp.get_type();
+      prop.props_ref() = {kDst};
+      edgeProps.emplace_back(std::move(prop));
+    }
+  } else {
+    // Follow all the edges in the given direction, as GetNeighbors does for an empty prop list
+    auto edges = env_->schemaMan_->getAllVerEdgeSchema(spaceId_);
+    if (!edges.ok()) {
+      return nebula::cpp2::ErrorCode::E_SPACE_NOT_FOUND;
+    }
+    auto direction = spec.get_edge_direction();
+    for (const auto& entry : edges.value()) {
+      cpp2::EdgeProp prop;
+      prop.props_ref() = {kDst};
+      if (direction != cpp2::EdgeDirection::IN_EDGE) {
+        prop.type_ref() = entry.first;
+        edgeProps.emplace_back(prop);
+      }
+      if (direction != cpp2::EdgeDirection::OUT_EDGE) {
+        prop.type_ref() = -entry.first;
+        edgeProps.emplace_back(std::move(prop));
+      }
+    }
+  }
+  dstSpec_.edge_props_ref() = std::move(edgeProps);
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+void KHopGetNeighborsProcessor::expand(int32_t hop, PartRows frontier) {
+  cpp2::GetNeighborsRequest req;
+  req.space_id_ref() = spaceId_;
+  req.parts_ref() = std::move(frontier);
+  if (hop == steps_) {
+    req.column_names_ref() = req_.get_column_names();
+    req.traverse_spec_ref() = req_.get_traverse_spec();
+  } else {
+    req.column_names_ref() = {kVid};
+    req.traverse_spec_ref() = dstSpec_;
+  }
+  if (req_.common_ref().has_value()) {
+    req.common_ref() = *req_.common_ref();
+  }
+  auto* processor = GetNeighborsProcessor::instance(env_, nullptr, executor_);
+  processor->getFuture().thenValue(
+      [this, hop](auto&& resp) { this->onExpanded(hop, std::move(resp)); });
+  processor->process(req);
+}
+
+void KHopGetNeighborsProcessor::onExpanded(int32_t hop, cpp2::GetNeighborsResponse&& resp) {
+  for (const auto& part : resp.get_result().get_failed_parts()) {
+    codes_.emplace_back(part);
+  }
+  if (hop == steps_) {
+    if (resp.truncated_vertices_ref().has_value()) {
+      resp_.truncated_vertices_ref() = std::move(*resp.truncated_vertices_ref());
+    }
+    finish(resp.vertices_ref().has_value() ? std::move(*resp.vertices_ref()) : DataSet());
+    return;
+  }
+  auto frontier = resp.vertices_ref().has_value() ? nextFrontier(hop, *resp.vertices_ref())
+                                                  : PartRows();
+  if (frontier.empty()) {
+    finish(DataSet());
+    return;
+  }
+  expand(hop + 1, std::move(frontier));
+}
+
+KHopGetNeighborsProcessor::PartRows KHopGetNeighborsProcessor::nextFrontier(int32_t hop,
+                                                                            const DataSet& ds) {
+  std::vector<size_t> edgeCols;
+  for (size_t i = 0; i < ds.colNames.size(); ++i) {
+    if (folly::StringPiece(ds.colNames[i]).startsWith("_edge:")) {
+      edgeCols.emplace_back(i);
+    }
+  }
+  PartRows frontier;
+  std::unordered_set<Value> dsts;
+  for (const auto& row : ds.rows) {
+    for (auto i : edgeCols) {
+      const auto& edges = row.values[i];
+      if (!edges.isList()) {
+        continue;
+      }
+      for (const auto& edge : edges.getList().values) {
+        if (!edge.isList() || edge.getList().values.empty()) {
+          continue;
+        }
+        const auto& dst = edge.getList().values.front();
+        if (!dsts.emplace(dst).second) {
+          continue;
+        }
+        // The vids of an INT64 space are given in their binary form
+        std::string vId;
+        if (dst.isInt()) {
+          auto id = dst.getInt();
+          vId.assign(reinterpret_cast<const char*>(&id), sizeof(id));
+        } else if (dst.isStr()) {
+          vId = dst.getStr();
+        } else {
+          continue;
+        }
+        auto partId = env_->metaClient_->partId(numParts_, vId);
+        // The edges of a split vertex are spread among its parts, so it's left to the graph
+        if (isLocal(partId) && env_->metaClient_->splitParts(spaceId_, vId) == 1) {
+          frontier[partId].emplace_back(Row({Value(std::move(vId))}));
+        } else {
+          pending_[hop].emplace_back(dst);
+        }
+      }
+    }
+  }
+  return frontier;
+}
+
+bool KHopGetNeighborsProcessor::isLocal(PartitionID partId) {
+  auto it = localParts_.find(partId);
+  if (it != localParts_.end()) {
+    return it->second;
+  }
+  auto part = env_->kvstore_->part(spaceId_, partId);
+  bool local = nebula::ok(part) && nebula::value(part)->isLeader();
+  localParts_.emplace(partId, local);
+  return local;
+}
+
+void KHopGetNeighborsProcessor::finish(DataSet&& vertices) {
+  resp_.vertices_ref() = std::move(vertices);
+  if (!pending_.empty()) {
+    resp_.pending_ref() = std::move(pending_);
+  }
+  onFinished();
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,85 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_QUERY_KHOPGETNEIGHBORSPROCESSOR_H_
+#define STORAGE_QUERY_KHOPGETNEIGHBORSPROCESSOR_H_
+
+#include "common/base/Base.h"
+#include "storage/BaseProcessor.h"
+
+namespace nebula {
+namespace storage {
+
+extern ProcessorCounters kKHopGetNeighborsCounters;
+
+/**
+ * @brief Processor to expand vertices by multiple hops inside the storage.
+ *
+ * Each hop is a GetNeighborsProcessor over the frontier in the parts led by this host. The
+ * intermediate hops only fetch the destinations of the edges, which are deduplicated to be the
+ * next frontier, and the destinations in the other parts are returned as pending vertices to be
+ * expanded by their own leaders. Only the last hop is evaluated with the whole traverse spec.
+ */
+class KHopGetNeighborsProcessor : public BaseProcessor<cpp2::KHopGetNeighborsResponse> {
+ public:
+  /**
+   * @brief Construct instance of KHopGetNeighborsProcessor
+   *
+   * @param env Related environment variables for storage.
+   * @param counters Statistic counter pointer for k-hop getting neighbors.
+   * @param executor Expected executor for this processor, running directly if nullptr.
+   * @return KHopGetNeighborsProcessor* Constructed instance.
+   */
+  static KHopGetNeighborsProcessor* instance(
+      StorageEnv* env,
+      const ProcessorCounters* counters = &kKHopGetNeighborsCounters,
+      folly::Executor* executor = nullptr) {
+    return new KHopGetNeighborsProcessor(env, counters, executor);
+  }
+
+  void process(const cpp2::KHopGetNeighborsRequest& req);
+
+ protected:
+  KHopGetNeighborsProcessor(StorageEnv* env,
+                            const ProcessorCounters* counters,
+                            folly::Executor* executor)
+      : BaseProcessor<cpp2::KHopGetNeighborsResponse>(env, counters), executor_(executor) {}
+
+ private:
+  using PartRows = std::unordered_map<PartitionID, std::vector<Row>>;
+
+  void doProcess();
+
+  // Build the traverse spec of the intermediate hops, which only returns the destinations
+  nebula::cpp2::ErrorCode buildDstSpec();
+
+  // Expand the frontier by the hop-th hop
+  void expand(int32_t hop, PartRows frontier);
+
+  void onExpanded(int32_t hop, cpp2::GetNeighborsResponse&& resp);
+
+  // Split the deduplicated destinations of an intermediate hop into the next frontier led by
+  // this host and the pending vertices
+  PartRows nextFrontier(int32_t hop, const DataSet& ds);
+
+  bool isLocal(PartitionID partId);
+
+  void finish(DataSet&& vertices);
+
+ private:
+  folly::Executor* executor_{nullptr};
+  cpp2::KHopGetNeighborsRequest req_;
+  GraphSpaceID spaceId_;
+  int32_t steps_{1};
+  int32_t numParts_{0};
+  cpp2::TraverseSpec dstSpec_;
+  // Parts led by this host or not, looked up once per request
+  std::unordered_map<PartitionID, bool> localParts_;
+  std::unordered_map<int32_t, std::vector<Value>> pending_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_QUERY_KHOPGETNEIGHBORSPROCESSOR_H_
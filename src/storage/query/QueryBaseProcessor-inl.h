@@ -238,6 +238,107 @@ std::vector<cpp2::EdgeProp> QueryBaseProcessor<REQ, RESP>::buildAllEdgeProps(
   return result;
 }
 
+template <typename REQ, typename RESP>
+void QueryBaseProcessor<REQ, RESP>::confirmLeadership(const REQ& req,
+                                                      folly::Function<void(const REQ&)> read) {
+  auto maxStalenessMs = planContext_->maxStalenessMs_;
+  std::vector<PartitionID> parts;
+  std::vector<folly::Future<nebula::cpp2::ErrorCode>> futures;
+  for (const auto& part : req.get_parts()) {
+    auto partId = part.first;
+    if (maxStalenessMs > 0 &&
+        this->env_->kvstore_->followerReadable(spaceId_, partId, maxStalenessMs)) {
+      continue;
+    }
+    // Returns immediately if the lease is still valid
+    auto future = this->env_->kvstore_->readIndex(spaceId_, partId);
+    if (future.isReady() && future.hasValue() &&
+        future.value() == nebula::cpp2::ErrorCode::SUCCEEDED) {
+      continue;
+    }
+    parts.emplace_back(partId);
+    futures.emplace_back(std::move(future));
+  }
+  if (futures.empty()) {
+    read(req);
+    return;
+  }
+
+  // The read goes on with the parts confirmed, the request is kept until the processor finishes
+  confirmedReq_ = std::make_unique<REQ>(req);
+  auto readConfirmed = [this, parts = std::move(parts), read = std::move(read)](
+                           std::vector<folly::Try<nebula::cpp2::ErrorCode>>&& tries) mutable {
+    for (size_t i = 0; i < tries.size(); i++) {
+      auto code = tries[i].hasException() ? nebula::cpp2::ErrorCode::E_LEADER_LEASE_FAILED
+                                          : tries[i].value();
+      if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+        continue;
+      }
+      VLOG(1) << "Confirm the leadership of space " << spaceId_ << " part " << parts[i]
+              << " failed, " << apache::thrift::util::enumNameSafe(code);
+      // The lease failed means the leader may have been changed without being known yet
+      if (code == nebula::cpp2::ErrorCode::E_LEADER_LEASE_FAILED) {
+        this->pushResultCode(nebula::cpp2::ErrorCode::E_LEADER_CHANGED, parts[i]);
+      } else {
+        this->handleErrorCode(code, spaceId_, parts[i]);
+      }
+      confirmedReq_->parts_ref()->erase(parts[i]);
+    }
+    read(*confirmedReq_);
+  };
+  // The leadership of all parts are confirmed concurrently
+  if (executor_ != nullptr) {
+    folly::collectAll(std::move(futures)).via(executor_).thenValue(std::move(readConfirmed));
+  } else {
+    readConfirmed(folly::collectAll(std::move(futures)).get());
+  }
+}
+
+template <typename REQ, typename RESP>
+void QueryBaseProcessor<REQ, RESP>::runPartsConcurrently(
+    std::vector<std::pair<PartitionID, PartTask>> tasks, folly::Function<void(PartCodes&&)> done) {
+  struct Join {
+    std::atomic<size_t> pending{0};
+    PartCodes codes;
+    folly::Function<void(PartCodes&&)> done;
+  };
+  if (tasks.empty()) {
+    done(PartCodes());
+    return;
+  }
+  auto join = std::make_shared<Join>();
+  join->pending = tasks.size();
+  join->codes.resize(tasks.size());
+  join->done = std::move(done);
+  auto* planContext = planContext_.get();
+  for (size_t i = 0; i < tasks.size(); i++) {
+    auto partId = tasks[i].first;
+    executor_->add([join, planContext, i, partId, task = std::move(tasks[i].second)]() mutable {
+      const auto& deadline = planContext->deadline_;
+      bool killed = planContext->isKilled_.load(std::memory_order_relaxed) ||
+                    (deadline.has_value() && std::chrono::steady_clock::now() >= *deadline);
+      auto code = nebula::cpp2::ErrorCode::E_PLAN_IS_KILLED;
+      if (!killed) {
+        // The part throwing fails alone, or the request would never be finished
+        try {
+          code = task();
+        } catch (const std::exception& e) {
+          LOG(ERROR) << "Part " << partId << " failed: " << e.what();
+          code = nebula::cpp2::ErrorCode::E_UNKNOWN;
+        } catch (...) {
+          LOG(ERROR) << "Part " << partId << " failed by an unknown exception";
+          code = nebula::cpp2::ErrorCode::E_UNKNOWN;
+        }
+      }
+      join->codes[i] = std::make_pair(code, partId);
+      // The processor may be deleted by done, nothing of it is touched after
+      if (join->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        join->done(std::move(join->codes));
+      }
+    });
+  }
+}
+
 template <typename REQ, typename RESP>
 nebula::cpp2::ErrorCode QueryBaseProcessor<REQ, RESP>::getSpaceVertexSchema() {
   auto tags = this->env_->schemaMan_->getAllVerTagSchema(spaceId_);
@@ -259,6 +360,129 @@ nebula::cpp2::ErrorCode QueryBaseProcessor<REQ, RESP>::getSpaceEdgeSchema() {
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
+template <typename REQ, typename RESP>
+void QueryBaseProcessor<REQ, RESP>::splitEdgeKeyFilter() {
+  if (filter_ == nullptr) {
+    return;
+  }
+  std::vector<Expression*> conjuncts;
+  std::function<void(Expression*)> flatten = [&](Expression* exp) {
+    if (exp->kind() == Expression::Kind::kLogicalAnd) {
+      for (auto* operand : static_cast<LogicalExpression*>(exp)->operands()) {
+        flatten(operand);
+      }
+    } else {
+      conjuncts.emplace_back(exp);
+    }
+  };
+  flatten(filter_);
+
+  std::vector<Expression*> keyConjuncts;
+  std::vector<Expression*> valueConjuncts;
+  for (auto* conjunct : conjuncts) {
+    if (isEdgeKeyExp(conjunct)) {
+      keyConjuncts.emplace_back(conjunct);
+    } else {
+      valueConjuncts.emplace_back(conjunct);
+    }
+  }
+  if (keyConjuncts.empty()) {
+    return;
+  }
+  // The filter is true only when all the conjuncts are true, so they could be checked separately
+  auto pool = &this->planContext_->objPool_;
+  auto combine = [pool](std::vector<Expression*> exps) -> Expression* {
+    if (exps.empty()) {
+      return nullptr;
+    } else if (exps.size() == 1) {
+      return exps.front();
+    }
+    auto* andExp = LogicalExpression::makeAnd(pool);
+    andExp->setOperands(std::move(exps));
+    return andExp;
+  };
+  edgeKeyFilter_ = combine(std::move(keyConjuncts));
+  filter_ = combine(std::move(valueConjuncts));
+}
+
+template <typename REQ, typename RESP>
+bool QueryBaseProcessor<REQ, RESP>::isEdgeKeyExp(const Expression* exp) {
+  switch (exp->kind()) {
+    case Expression::Kind::kConstant:
+    case Expression::Kind::kEdgeRank:
+    case Expression::Kind::kEdgeDst:
+    case Expression::Kind::kEdgeSrc:
+    case Expression::Kind::kEdgeType: {
+      return true;
+    }
+    case Expression::Kind::kEdgeProperty: {
+      const auto& propName = static_cast<const PropertyExpression*>(exp)->prop();
+      return propName == kSrc || propName == kType || propName == kRank || propName == kDst;
+    }
+    case Expression::Kind::kAdd:
+    case Expression::Kind::kMinus:
+    case Expression::Kind::kMultiply:
+    case Expression::Kind::kDivision:
+    case Expression::Kind::kMod: {
+      auto* ariExp = static_cast<const ArithmeticExpression*>(exp);
+      return isEdgeKeyExp(ariExp->left()) && isEdgeKeyExp(ariExp->right());
+    }
+    case Expression::Kind::kIsNull:
+    case Expression::Kind::kIsNotNull:
+    case Expression::Kind::kIsEmpty:
+    case Expression::Kind::kIsNotEmpty:
+    case Expression::Kind::kUnaryPlus:
+    case Expression::Kind::kUnaryNegate:
+    case Expression::Kind::kUnaryNot: {
+      return isEdgeKeyExp(static_cast<const UnaryExpression*>(exp)->operand());
+    }
+    case Expression::Kind::kRelEQ:
+    case Expression::Kind::kRelNE:
+    case Expression::Kind::kRelLT:
+    case Expression::Kind::kRelLE:
+    case Expression::Kind::kRelGT:
+    case Expression::Kind::kRelGE:
+    case Expression::Kind::kRelREG:
+    case Expression::Kind::kContains:
+    case Expression::Kind::kNotContains:
+    case Expression::Kind::kStartsWith:
+    case Expression::Kind::kNotStartsWith:
+    case Expression::Kind::kEndsWith:
+    case Expression::Kind::kNotEndsWith:
+    case Expression::Kind::kRelNotIn:
+    case Expression::Kind::kRelIn: {
+      auto* relExp = static_cast<const RelationalExpression*>(exp);
+      return isEdgeKeyExp(relExp->left()) && isEdgeKeyExp(relExp->right());
+    }
+    case Expression::Kind::kList: {
+      const auto& items = static_cast<const ListExpression*>(exp)->items();
+      return std::all_of(items.begin(), items.end(), [](const auto* item) {
+        return isEdgeKeyExp(item);
+      });
+    }
+    case Expression::Kind::kSet: {
+      const auto& items = static_cast<const SetExpression*>(exp)->items();
+      return std::all_of(items.begin(), items.end(), [](const auto* item) {
+        return isEdgeKeyExp(item);
+      });
+    }
+    case Expression::Kind::kLogicalAnd:
+    case Expression::Kind::kLogicalOr:
+    case Expression::Kind::kLogicalXor: {
+      const auto& operands = static_cast<const LogicalExpression*>(exp)->operands();
+      return std::all_of(operands.begin(), operands.end(), [](const auto* operand) {
+        return isEdgeKeyExp(operand);
+      });
+    }
+    case Expression::Kind::kTypeCasting: {
+      return isEdgeKeyExp(static_cast<const TypeCastingExpression*>(exp)->operand());
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
 template <typename REQ, typename RESP>
 nebula::cpp2::ErrorCode QueryBaseProcessor<REQ, RESP>::checkExp(
     const Expression* exp, bool returned, bool filtered, bool updated, bool allowNoexistentProp) {
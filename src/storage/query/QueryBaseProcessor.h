@@ -138,6 +138,8 @@ struct EdgeContext {
   // offset is the start index of first edge type in a response row
   size_t offset_;
   size_t statCount_ = 0;
+  // only the stats are returned, the edges are not
+  bool statsOnly_ = false;
 
   // additional operator for eventually-consistent edges
   std::vector<std::pair<std::string, std::string>> kvAppend;
@@ -172,6 +174,37 @@ class QueryBaseProcessor : public BaseProcessor<RESP> {
       const REQ& req, std::function<const std::string*(const REQ& req)>&& getFilter);
   nebula::cpp2::ErrorCode buildYields(const REQ& req);
 
+  // Move the conjuncts of filter only on the props in edge key into edgeKeyFilter_, they are
+  // checked before decoding the edge value
+  void splitEdgeKeyFilter();
+
+  // Whether the expression only reads the props in edge key, e.g. _src, _dst, _rank and _type
+  static bool isEdgeKeyExp(const Expression* exp);
+
+  /**
+   * @brief Confirm the leadership of the parts whose leader lease has expired, then read the
+   * confirmed parts of the request. The parts read as follower are not confirmed, and the ones
+   * failed to confirm are reported without being read, as E_LEADER_CHANGED if the lease failed.
+   *
+   * The parts are read in place if all the leases are valid. Otherwise the read is chained to the
+   * confirmations on the executor with a copy of the request, so the thread is not blocked by the
+   * heartbeats.
+   */
+  void confirmLeadership(const REQ& req, folly::Function<void(const REQ&)> read);
+
+  using PartTask = folly::Function<nebula::cpp2::ErrorCode()>;
+  using PartCodes = std::vector<std::pair<nebula::cpp2::ErrorCode, PartitionID>>;
+
+  /**
+   * @brief Run the task of each part on the executor, then call done with the codes of the parts
+   * in order on the thread finishing the last one. The parts are joined by a counter shared by
+   * them, rather than a future of each part collected and continued by another one. The parts not
+   * started yet when the plan is killed or out of time are given up as killed, and the parts
+   * throwing fail with E_UNKNOWN.
+   */
+  void runPartsConcurrently(std::vector<std::pair<PartitionID, PartTask>> tasks,
+                            folly::Function<void(PartCodes&&)> done);
+
   // build ttl info map
   void buildTagTTLInfo();
   void buildEdgeTTLInfo();
@@ -204,9 +237,13 @@ class QueryBaseProcessor : public BaseProcessor<RESP> {
   GraphSpaceID spaceId_;
   folly::Executor* executor_{nullptr};
   std::unique_ptr<PlanContext> planContext_;
+  // The request read after the leadership is confirmed asynchronously, see confirmLeadership
+  std::unique_ptr<REQ> confirmedReq_;
   TagContext tagContext_;
   EdgeContext edgeContext_;
   Expression* filter_{nullptr};
+  // The conjuncts of filter only on the props in edge key
+  Expression* edgeKeyFilter_{nullptr};
 
   // Collect prop in value expression in upsert set clause
   std::unordered_set<std::string> valueProps_;
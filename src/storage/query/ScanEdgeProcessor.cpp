@@ -6,6 +6,7 @@
 #include "storage/query/ScanEdgeProcessor.h"
 
 #include "common/utils/NebulaKeyUtils.h"
+#include "kvstore/RocksScanMode.h"
 #include "storage/StorageFlags.h"
 #include "storage/exec/QueryUtils.h"
 
@@ -72,9 +73,60 @@ nebula::cpp2::ErrorCode ScanEdgeProcessor::checkAndBuildContexts(const cpp2::Sca
       return nullptr;
     }
   });
+  // The props of the other edges are null in the row of an edge, but they are empty when only
+  // the key is read, so the filter is only split when scanning one edge type
+  if (ret == nebula::cpp2::ErrorCode::SUCCEEDED && edgeContext_.propContexts_.size() == 1) {
+    splitEdgeKeyFilter();
+    if (FLAGS_scan_edge_by_index) {
+      typeIndex_ = findTypeIndex(edgeContext_.propContexts_.front().first);
+    }
+  }
+  // The rows are only sorted with a limit
+  if (ret == nebula::cpp2::ErrorCode::SUCCEEDED && req.order_by_ref().has_value() &&
+      req.get_limit() >= 0) {
+    const auto& colNames = resultDataSet_.colNames;
+    for (const auto& orderBy : *req.order_by_ref()) {
+      auto iter = std::find(colNames.begin(), colNames.end(), orderBy.get_prop());
+      if (iter == colNames.end()) {
+        VLOG(1) << "Can't find the order by column " << orderBy.get_prop();
+        return nebula::cpp2::ErrorCode::E_EDGE_PROP_NOT_FOUND;
+      }
+      orderBy_.emplace_back(iter - colNames.begin(), orderBy.get_direction());
+    }
+  }
   return ret;
 }
 
+std::optional<IndexID> ScanEdgeProcessor::findTypeIndex(EdgeType edgeType) {
+  if (env_->indexMan_ == nullptr) {
+    return std::nullopt;
+  }
+  auto indexes = env_->indexMan_->getEdgeIndexes(spaceId_);
+  if (!indexes.ok()) {
+    return std::nullopt;
+  }
+  std::optional<IndexID> found;
+  for (const auto& index : indexes.value()) {
+    if (index->get_schema_id().get_edge_type() != edgeType) {
+      continue;
+    }
+    // The index maintained asynchronously may miss the latest edges
+    if (env_->indexLogApplier_ != nullptr && StorageEnv::isAsyncIndex(*index)) {
+      continue;
+    }
+    // Only the keys of an index without fields are in the order of the edge keys of the type, so
+    // that a scan by the index could go on by the edge keys from its cursor
+    if (index->get_fields().empty()) {
+      found = index->get_index_id();
+      break;
+    }
+  }
+  if (found.has_value()) {
+    VLOG(1) << "Scan the edges of type " << edgeType << " by index " << found.value();
+  }
+  return found;
+}
+
 void ScanEdgeProcessor::buildEdgeColName(const std::vector<cpp2::EdgeProp>& edgeProps) {
   for (const auto& edgeProp : edgeProps) {
     auto edgeType = edgeProp.get_type();
@@ -86,6 +138,7 @@ void ScanEdgeProcessor::buildEdgeColName(const std::vector<cpp2::EdgeProp>& edge
 }
 
 void ScanEdgeProcessor::onProcessFinished() {
+  resultDataSet_.writePacked = planContext_ != nullptr && planContext_->packDataSet_;
   resp_.props_ref() = std::move(resultDataSet_);
   resp_.cursors_ref() = std::move(cursors_);
 }
@@ -98,8 +151,13 @@ StoragePlan<Cursor> ScanEdgeProcessor::buildPlan(
   StoragePlan<Cursor> plan;
   std::vector<std::unique_ptr<FetchEdgeNode>> edges;
   for (const auto& ec : edgeContext_.propContexts_) {
-    edges.emplace_back(
-        std::make_unique<FetchEdgeNode>(context, &edgeContext_, ec.first, &ec.second));
+    edges.emplace_back(std::make_unique<FetchEdgeNode>(
+        context,
+        &edgeContext_,
+        ec.first,
+        &ec.second,
+        nullptr,
+        edgeKeyFilter_ == nullptr ? nullptr : edgeKeyFilter_->clone()));
   }
   auto output = std::make_unique<ScanEdgePropNode>(context,
                                                    std::move(edges),
@@ -108,29 +166,25 @@ StoragePlan<Cursor> ScanEdgeProcessor::buildPlan(
                                                    cursors,
                                                    result,
                                                    expCtx,
-                                                   filter_ == nullptr ? nullptr : filter_->clone());
+                                                   filter_ == nullptr ? nullptr : filter_->clone(),
+                                                   &orderBy_,
+                                                   typeIndex_);
 
   plan.addNode(std::move(output));
   return plan;
 }
 
-folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> ScanEdgeProcessor::runInExecutor(
+nebula::cpp2::ErrorCode ScanEdgeProcessor::runPart(
     RuntimeContext* context,
     nebula::DataSet* result,
     std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
     PartitionID partId,
-    Cursor cursor,
+    const Cursor& cursor,
     StorageExpressionContext* expCtx) {
-  return folly::via(executor_,
-                    [this, context, result, cursors, partId, input = std::move(cursor), expCtx]() {
-                      auto plan = buildPlan(context, result, cursors, expCtx);
-
-                      auto ret = plan.go(partId, input);
-                      if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
-                        return std::make_pair(ret, partId);
-                      }
-                      return std::make_pair(nebula::cpp2::ErrorCode::SUCCEEDED, partId);
-                    });
+  auto plan = buildPlan(context, result, cursors, expCtx);
+
+  kvstore::ScanModeGuard scanMode(kvstore::ScanMode::kLong);
+  return plan.go(partId, cursor);
 }
 
 void ScanEdgeProcessor::runInSingleThread(const cpp2::ScanEdgeRequest& req) {
@@ -138,6 +192,7 @@ void ScanEdgeProcessor::runInSingleThread(const cpp2::ScanEdgeRequest& req) {
   expCtxs_.emplace_back(StorageExpressionContext(spaceVidLen_, isIntId_));
   std::unordered_set<PartitionID> failedParts;
   auto plan = buildPlan(&contexts_.front(), &resultDataSet_, &cursors_, &expCtxs_.front());
+  kvstore::ScanModeGuard scanMode(kvstore::ScanMode::kLong);
   for (const auto& partEntry : req.get_parts()) {
     auto partId = partEntry.first;
     auto cursor = partEntry.second;
@@ -163,24 +218,22 @@ void ScanEdgeProcessor::runInMultipleThread(const cpp2::ScanEdgeRequest& req) {
     expCtxs_.emplace_back(StorageExpressionContext(spaceVidLen_, isIntId_));
   }
   size_t i = 0;
-  std::vector<folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>>> futures;
+  std::vector<std::pair<PartitionID, PartTask>> tasks;
   for (const auto& [partId, cursor] : req.get_parts()) {
-    futures.emplace_back(
-        runInExecutor(&contexts_[i],
-                      &results_[i],
-                      &cursorsOfPart_[i],
-                      partId,
-                      cursor.next_cursor_ref().has_value() ? cursor.next_cursor_ref().value() : "",
-                      &expCtxs_[i]));
+    auto* context = &contexts_[i];
+    auto* result = &results_[i];
+    auto* cursors = &cursorsOfPart_[i];
+    auto* expCtx = &expCtxs_[i];
+    Cursor start = cursor.next_cursor_ref().value_or("");
+    tasks.emplace_back(partId, [this, context, result, cursors, partId = partId, start, expCtx]() {
+      return runPart(context, result, cursors, partId, start, expCtx);
+    });
     i++;
   }
 
-  folly::collectAll(futures).via(executor_).thenTry([this](auto&& t) mutable {
-    CHECK(!t.hasException());
-    const auto& tries = t.value();
-    for (size_t j = 0; j < tries.size(); j++) {
-      CHECK(!tries[j].hasException());
-      const auto& [code, partId] = tries[j].value();
+  runPartsConcurrently(std::move(tasks), [this](PartCodes&& codes) {
+    for (size_t j = 0; j < codes.size(); j++) {
+      const auto& [code, partId] = codes[j];
       if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
         handleErrorCode(code, spaceId_, partId);
       } else {
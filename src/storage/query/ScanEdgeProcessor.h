@@ -56,6 +56,12 @@ class ScanEdgeProcessor : public QueryBaseProcessor<cpp2::ScanEdgeRequest, cpp2:
 
   nebula::cpp2::ErrorCode checkAndBuildContexts(const cpp2::ScanEdgeRequest& req) override;
 
+  /**
+   * @brief Find an index without fields of the edge type, so that the edges of the type are
+   * scanned by the index keys rather than all the edges of the part
+   */
+  std::optional<IndexID> findTypeIndex(EdgeType edgeType);
+
   void buildEdgeColName(const std::vector<cpp2::EdgeProp>& edgeProps);
 
   StoragePlan<Cursor> buildPlan(RuntimeContext* context,
@@ -63,13 +69,12 @@ class ScanEdgeProcessor : public QueryBaseProcessor<cpp2::ScanEdgeRequest, cpp2:
                                 std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
                                 StorageExpressionContext* expCtx);
 
-  folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> runInExecutor(
-      RuntimeContext* context,
-      nebula::DataSet* result,
-      std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
-      PartitionID partId,
-      Cursor cursor,
-      StorageExpressionContext* expCtx);
+  nebula::cpp2::ErrorCode runPart(RuntimeContext* context,
+                                  nebula::DataSet* result,
+                                  std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
+                                  PartitionID partId,
+                                  const Cursor& cursor,
+                                  StorageExpressionContext* expCtx);
 
   void runInSingleThread(const cpp2::ScanEdgeRequest& req);
 
@@ -85,6 +90,10 @@ class ScanEdgeProcessor : public QueryBaseProcessor<cpp2::ScanEdgeRequest, cpp2:
   std::unordered_map<PartitionID, cpp2::ScanCursor> cursors_;
   int64_t limit_{-1};
   bool enableReadFollower_{false};
+  // the column index and direction of the order by, the top rows of each part are returned
+  std::vector<std::pair<size_t, cpp2::OrderDirection>> orderBy_;
+  // The index to scan when only one edge type is scanned
+  std::optional<IndexID> typeIndex_;
 };
 
 }  // namespace storage
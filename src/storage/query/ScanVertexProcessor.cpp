@@ -8,6 +8,7 @@
 #include <limits>
 
 #include "common/utils/NebulaKeyUtils.h"
+#include "kvstore/RocksScanMode.h"
 #include "storage/StorageFlags.h"
 #include "storage/exec/QueryUtils.h"
 
@@ -90,6 +91,7 @@ void ScanVertexProcessor::buildTagColName(const std::vector<cpp2::VertexProp>& t
 }
 
 void ScanVertexProcessor::onProcessFinished() {
+  resultDataSet_.writePacked = planContext_ != nullptr && planContext_->packDataSet_;
   resp_.props_ref() = std::move(resultDataSet_);
   resp_.cursors_ref() = std::move(cursors_);
 }
@@ -118,24 +120,17 @@ StoragePlan<Cursor> ScanVertexProcessor::buildPlan(
   return plan;
 }
 
-folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> ScanVertexProcessor::runInExecutor(
+nebula::cpp2::ErrorCode ScanVertexProcessor::runPart(
     RuntimeContext* context,
     nebula::DataSet* result,
     std::unordered_map<PartitionID, cpp2::ScanCursor>* cursorsOfPart,
     PartitionID partId,
-    Cursor cursor,
+    const Cursor& cursor,
     StorageExpressionContext* expCtx) {
-  return folly::via(
-      executor_,
-      [this, context, result, cursorsOfPart, partId, input = std::move(cursor), expCtx]() {
-        auto plan = buildPlan(context, result, cursorsOfPart, expCtx);
-
-        auto ret = plan.go(partId, input);
-        if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
-          return std::make_pair(ret, partId);
-        }
-        return std::make_pair(nebula::cpp2::ErrorCode::SUCCEEDED, partId);
-      });
+  auto plan = buildPlan(context, result, cursorsOfPart, expCtx);
+
+  kvstore::ScanModeGuard scanMode(kvstore::ScanMode::kLong);
+  return plan.go(partId, cursor);
 }
 
 void ScanVertexProcessor::runInSingleThread(const cpp2::ScanVertexRequest& req) {
@@ -143,6 +138,7 @@ void ScanVertexProcessor::runInSingleThread(const cpp2::ScanVertexRequest& req)
   expCtxs_.emplace_back(StorageExpressionContext(spaceVidLen_, isIntId_));
   std::unordered_set<PartitionID> failedParts;
   auto plan = buildPlan(&contexts_.front(), &resultDataSet_, &cursors_, &expCtxs_.front());
+  kvstore::ScanModeGuard scanMode(kvstore::ScanMode::kLong);
   for (const auto& partEntry : req.get_parts()) {
     auto partId = partEntry.first;
     auto cursor = partEntry.second;
@@ -168,24 +164,22 @@ void ScanVertexProcessor::runInMultipleThread(const cpp2::ScanVertexRequest& req
     expCtxs_.emplace_back(StorageExpressionContext(spaceVidLen_, isIntId_));
   }
   size_t i = 0;
-  std::vector<folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>>> futures;
+  std::vector<std::pair<PartitionID, PartTask>> tasks;
   for (const auto& [partId, cursor] : req.get_parts()) {
-    futures.emplace_back(
-        runInExecutor(&contexts_[i],
-                      &results_[i],
-                      &cursorsOfPart_[i],
-                      partId,
-                      cursor.next_cursor_ref().has_value() ? cursor.next_cursor_ref().value() : "",
-                      &expCtxs_[i]));
+    auto* context = &contexts_[i];
+    auto* result = &results_[i];
+    auto* cursors = &cursorsOfPart_[i];
+    auto* expCtx = &expCtxs_[i];
+    Cursor start = cursor.next_cursor_ref().value_or("");
+    tasks.emplace_back(partId, [this, context, result, cursors, partId = partId, start, expCtx]() {
+      return runPart(context, result, cursors, partId, start, expCtx);
+    });
     i++;
   }
 
-  folly::collectAll(futures).via(executor_).thenTry([this](auto&& t) mutable {
-    CHECK(!t.hasException());
-    const auto& tries = t.value();
-    for (size_t j = 0; j < tries.size(); j++) {
-      CHECK(!tries[j].hasException());
-      const auto& [code, partId] = tries[j].value();
+  runPartsConcurrently(std::move(tasks), [this](PartCodes&& codes) {
+    for (size_t j = 0; j < codes.size(); j++) {
+      const auto& [code, partId] = codes[j];
       if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
         handleErrorCode(code, spaceId_, partId);
       } else {
@@ -63,13 +63,12 @@ class ScanVertexProcessor : public QueryBaseProcessor<cpp2::ScanVertexRequest, c
                                 std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
                                 StorageExpressionContext* expCtx);
 
-  folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> runInExecutor(
-      RuntimeContext* context,
-      nebula::DataSet* result,
-      std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
-      PartitionID partId,
-      Cursor cursor,
-      StorageExpressionContext* expCtx);
+  nebula::cpp2::ErrorCode runPart(RuntimeContext* context,
+                                  nebula::DataSet* result,
+                                  std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
+                                  PartitionID partId,
+                                  const Cursor& cursor,
+                                  StorageExpressionContext* expCtx);
 
   void runInSingleThread(const cpp2::ScanVertexRequest& req);
 
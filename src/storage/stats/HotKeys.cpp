@@ -0,0 +1,198 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/stats/HotKeys.h"
+
+#include "common/time/WallClock.h"
+#include "storage/StorageFlags.h"
+
+namespace nebula {
+namespace storage {
+
+template <typename Sketch>
+void HotKeyTracker::Shard<Sketch>::decay(int64_t nowSec) {
+  auto current = nowSec / std::max<int64_t>(FLAGS_hot_keys_decay_secs, 1);
+  if (current != epoch) {
+    if (epoch != 0) {
+      auto times = static_cast<int>(std::min<int64_t>(current - epoch, 64));
+      requests.decay(times);
+      volume.decay(times);
+    }
+    epoch = current;
+  }
+}
+
+HotKeyTracker::HotKeyTracker(std::string unit, size_t capacity) : unit_(std::move(unit)) {
+  for (auto& shard : vertexShards_) {
+    shard = std::make_unique<Shard<VertexSketch>>(capacity);
+  }
+  partShard_ = std::make_unique<Shard<PartSketch>>(capacity);
+}
+
+void HotKeyTracker::addVertex(GraphSpaceID space,
+                              PartitionID part,
+                              const std::string& vid,
+                              uint64_t volume) {
+  uint64_t interval = std::max<uint32_t>(FLAGS_hot_keys_sample_interval, 1);
+  thread_local uint64_t sampled = 0;
+  if (++sampled % interval != 0) {
+    return;
+  }
+  VertexKey key{space, part, vid};
+  auto& shard = *vertexShards_[VertexKeyHash()(key) % kNumShards];
+  std::lock_guard<std::mutex> guard(shard.lock);
+  shard.decay(time::WallClock::fastNowInSec());
+  shard.requests.add(key, interval);
+  if (volume > 0) {
+    shard.volume.add(key, volume * interval);
+  }
+}
+
+void HotKeyTracker::addPart(GraphSpaceID space, PartitionID part, uint64_t volume) {
+  auto key = std::make_pair(space, part);
+  std::lock_guard<std::mutex> guard(partShard_->lock);
+  partShard_->decay(time::WallClock::fastNowInSec());
+  partShard_->requests.add(key);
+  if (volume > 0) {
+    partShard_->volume.add(key, volume);
+  }
+}
+
+uint64_t HotKeyTracker::vertexRequests(GraphSpaceID space,
+                                       PartitionID part,
+                                       const std::string& vid) {
+  VertexKey key{space, part, vid};
+  auto& shard = *vertexShards_[VertexKeyHash()(key) % kNumShards];
+  std::lock_guard<std::mutex> guard(shard.lock);
+  shard.decay(time::WallClock::fastNowInSec());
+  const auto* counter = shard.requests.find(key);
+  return counter == nullptr ? 0 : counter->count - counter->error;
+}
+
+void HotKeyTracker::addPartRequests(
+    std::unordered_map<GraphSpaceID, std::unordered_map<PartitionID, int64_t>>& loads) {
+  std::lock_guard<std::mutex> guard(partShard_->lock);
+  partShard_->decay(time::WallClock::fastNowInSec());
+  for (const auto& counter : partShard_->requests.top(partShard_->requests.size())) {
+    loads[counter.key.first][counter.key.second] += static_cast<int64_t>(counter.count);
+  }
+}
+
+template <typename Sketch, typename KeyToJson>
+folly::dynamic HotKeyTracker::topJson(const std::vector<typename Sketch::Counter>& counters,
+                                      size_t top,
+                                      KeyToJson&& keyToJson) {
+  folly::dynamic json = folly::dynamic::array();
+  for (const auto& counter : counters) {
+    if (json.size() >= top) {
+      break;
+    }
+    auto entry = keyToJson(counter.key);
+    if (entry.isNull()) {
+      continue;
+    }
+    entry["count"] = static_cast<int64_t>(counter.count);
+    entry["error"] = static_cast<int64_t>(counter.error);
+    json.push_back(std::move(entry));
+  }
+  return json;
+}
+
+folly::dynamic HotKeyTracker::toJson(size_t top, GraphSpaceID space) {
+  // The shards have disjoint keys, so the top of all is in the tops of the shards
+  std::vector<VertexSketch::Counter> vertexRequests;
+  std::vector<VertexSketch::Counter> vertexVolume;
+  auto now = time::WallClock::fastNowInSec();
+  for (auto& shard : vertexShards_) {
+    std::lock_guard<std::mutex> guard(shard->lock);
+    shard->decay(now);
+    auto requests = shard->requests.top(shard->requests.size());
+    vertexRequests.insert(vertexRequests.end(), requests.begin(), requests.end());
+    auto volume = shard->volume.top(shard->volume.size());
+    vertexVolume.insert(vertexVolume.end(), volume.begin(), volume.end());
+  }
+  std::vector<PartSketch::Counter> partRequests;
+  std::vector<PartSketch::Counter> partVolume;
+  {
+    std::lock_guard<std::mutex> guard(partShard_->lock);
+    partShard_->decay(now);
+    partRequests = partShard_->requests.top(partShard_->requests.size());
+    partVolume = partShard_->volume.top(partShard_->volume.size());
+  }
+  auto byCount = [](const auto& a, const auto& b) { return a.count > b.count; };
+  std::sort(vertexRequests.begin(), vertexRequests.end(), byCount);
+  std::sort(vertexVolume.begin(), vertexVolume.end(), byCount);
+
+  auto vertexToJson = [space](const VertexKey& key) {
+    if (space > 0 && key.space != space) {
+      return folly::dynamic(nullptr);
+    }
+    folly::dynamic entry = folly::dynamic::object();
+    entry["space"] = key.space;
+    entry["part"] = key.part;
+    entry["vid"] = key.vid;
+    return entry;
+  };
+  auto partToJson = [space](const PartKey& key) {
+    if (space > 0 && key.first != space) {
+      return folly::dynamic(nullptr);
+    }
+    folly::dynamic entry = folly::dynamic::object();
+    entry["space"] = key.first;
+    entry["part"] = key.second;
+    return entry;
+  };
+  folly::dynamic json = folly::dynamic::object();
+  json["vertices_by_requests"] = topJson<VertexSketch>(vertexRequests, top, vertexToJson);
+  json["parts_by_requests"] = topJson<PartSketch>(partRequests, top, partToJson);
+  if (!unit_.empty()) {
+    json["vertices_by_" + unit_] = topJson<VertexSketch>(vertexVolume, top, vertexToJson);
+    json["parts_by_" + unit_] = topJson<PartSketch>(partVolume, top, partToJson);
+  }
+  return json;
+}
+
+HotKeys::HotKeys() {
+  // The volume of reads is the edges returned, and of writes the bytes written
+  const std::vector<std::pair<const char*, const char*>> kinds = {{kGetNeighbors, "edges"},
+                                                                  {kGetProps, ""},
+                                                                  {kAddVertices, "bytes"},
+                                                                  {kAddEdges, "bytes"},
+                                                                  {kUpdateVertex, ""},
+                                                                  {kUpdateEdge, ""}};
+  for (const auto& [kind, unit] : kinds) {
+    trackers_.emplace(kind, std::make_unique<HotKeyTracker>(unit, FLAGS_hot_keys_capacity));
+  }
+  getNeighbors_ = trackers_[kGetNeighbors].get();
+}
+
+HotKeyTracker* HotKeys::tracker(const std::string& kind) const {
+  auto iter = trackers_.find(kind);
+  return iter == trackers_.end() ? nullptr : iter->second.get();
+}
+
+bool HotKeys::isHotVertex(GraphSpaceID space, PartitionID part, const std::string& vid) const {
+  return getNeighbors_->vertexRequests(space, part, vid) >= FLAGS_hot_key_min_requests;
+}
+
+void HotKeys::partLoads(
+    std::unordered_map<GraphSpaceID, std::unordered_map<PartitionID, int64_t>>& loads) const {
+  for (const auto& entry : trackers_) {
+    entry.second->addPartRequests(loads);
+  }
+}
+
+folly::dynamic HotKeys::toJson(const std::string& kind, size_t top, GraphSpaceID space) const {
+  folly::dynamic json = folly::dynamic::object();
+  for (const auto& [name, tracker] : trackers_) {
+    if (kind.empty() || kind == name) {
+      json[name] = tracker->toJson(top, space);
+    }
+  }
+  return json;
+}
+
+}  // namespace storage
+}  // namespace nebula
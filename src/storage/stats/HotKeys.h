@@ -0,0 +1,159 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_STATS_HOTKEYS_H_
+#define STORAGE_STATS_HOTKEYS_H_
+
+#include <folly/dynamic.h>
+
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "common/base/Base.h"
+#include "common/stats/SpaceSaving.h"
+#include "common/thrift/ThriftTypes.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief The heavy hitters of the vertices and parts accessed by the requests of a kind of
+ * processor, by the number of requests and by the volume, e.g. bytes written or edges read. The
+ * counts are halved every hot_keys_decay_secs, so they reflect the recent load.
+ *
+ * Every part of a request is counted. To stay cheap, only one of every hot_keys_sample_interval
+ * vertices is counted, by the weight of the interval. The vertices are sharded by hash, each
+ * shard has its own lock and sketch.
+ */
+class HotKeyTracker final {
+ public:
+  struct VertexKey {
+    GraphSpaceID space;
+    PartitionID part;
+    std::string vid;
+
+    bool operator==(const VertexKey& rhs) const {
+      return space == rhs.space && part == rhs.part && vid == rhs.vid;
+    }
+  };
+
+  struct VertexKeyHash {
+    size_t operator()(const VertexKey& key) const {
+      return std::hash<std::string>()(key.vid) ^ (static_cast<size_t>(key.space) << 16) ^
+             static_cast<size_t>(key.part);
+    }
+  };
+
+  struct PartKeyHash {
+    size_t operator()(const std::pair<GraphSpaceID, PartitionID>& key) const {
+      return (static_cast<size_t>(key.first) << 32) ^ static_cast<size_t>(key.second);
+    }
+  };
+
+  using PartKey = std::pair<GraphSpaceID, PartitionID>;
+  using VertexSketch = stats::SpaceSaving<VertexKey, VertexKeyHash>;
+  using PartSketch = stats::SpaceSaving<PartKey, PartKeyHash>;
+
+  /**
+   * @param unit The unit of volume, e.g. "bytes" or "edges", empty if no volume is counted
+   * @param capacity The number of vertices counted by each shard
+   */
+  HotKeyTracker(std::string unit, size_t capacity);
+
+  void addVertex(GraphSpaceID space, PartitionID part, const std::string& vid, uint64_t volume);
+
+  void addPart(GraphSpaceID space, PartitionID part, uint64_t volume);
+
+  // The guaranteed number of recent requests to the vertex, zero if it is not counted
+  uint64_t vertexRequests(GraphSpaceID space, PartitionID part, const std::string& vid);
+
+  // Add the recent requests of the parts counted
+  void addPartRequests(
+      std::unordered_map<GraphSpaceID, std::unordered_map<PartitionID, int64_t>>& loads);
+
+  /**
+   * @brief The top vertices and parts by requests and by volume
+   *
+   * @param space Only the keys of the space if it is positive
+   */
+  folly::dynamic toJson(size_t top, GraphSpaceID space);
+
+ private:
+  static constexpr size_t kNumShards = 16;
+
+  template <typename Sketch>
+  struct Shard {
+    explicit Shard(size_t capacity) : requests(capacity), volume(capacity) {}
+
+    // Halve the counts once per decay period passed, lock must be held
+    void decay(int64_t nowSec);
+
+    std::mutex lock;
+    int64_t epoch{0};
+    Sketch requests;
+    Sketch volume;
+  };
+
+  template <typename Sketch, typename KeyToJson>
+  static folly::dynamic topJson(const std::vector<typename Sketch::Counter>& counters,
+                                size_t top,
+                                KeyToJson&& keyToJson);
+
+ private:
+  const std::string unit_;
+  std::array<std::unique_ptr<Shard<VertexSketch>>, kNumShards> vertexShards_;
+  std::unique_ptr<Shard<PartSketch>> partShard_;
+};
+
+/**
+ * @brief The hot key trackers of all kinds of processors in a storaged
+ */
+class HotKeys final {
+ public:
+  static constexpr const char* kGetNeighbors = "get_neighbors";
+  static constexpr const char* kGetProps = "get_props";
+  static constexpr const char* kAddVertices = "add_vertices";
+  static constexpr const char* kAddEdges = "add_edges";
+  static constexpr const char* kUpdateVertex = "update_vertex";
+  static constexpr const char* kUpdateEdge = "update_edge";
+
+  // All trackers are created here, so they are looked up without a lock
+  HotKeys();
+
+  // The tracker of the kind of processor, nullptr if unknown
+  HotKeyTracker* tracker(const std::string& kind) const;
+
+  /**
+   * @brief Whether the vertex is read by at least hot_key_min_requests recent requests of
+   * get neighbors, e.g. its edges are worth caching
+   */
+  bool isHotVertex(GraphSpaceID space, PartitionID part, const std::string& vid) const;
+
+  /**
+   * @brief The recent requests of the parts of all kinds, reported to metad to balance the
+   * leaders by load
+   */
+  void partLoads(
+      std::unordered_map<GraphSpaceID, std::unordered_map<PartitionID, int64_t>>& loads) const;
+
+  /**
+   * @brief The top keys of the trackers
+   *
+   * @param kind Only the tracker of the kind if not empty
+   * @param space Only the keys of the space if it is positive
+   */
+  folly::dynamic toJson(const std::string& kind, size_t top, GraphSpaceID space) const;
+
+ private:
+  std::map<std::string, std::unique_ptr<HotKeyTracker>> trackers_;
+  HotKeyTracker* getNeighbors_{nullptr};
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_STATS_HOTKEYS_H_
@@ -13,6 +13,15 @@ stats::CounterId kNumVerticesInserted;
 stats::CounterId kNumEdgesDeleted;
 stats::CounterId kNumTagsDeleted;
 stats::CounterId kNumVerticesDeleted;
+stats::CounterId kNumVertexCacheHits;
+stats::CounterId kNumVertexCacheMisses;
+stats::CounterId kNumAdjacencyCacheHits;
+stats::CounterId kNumAdjacencyCacheMisses;
+stats::CounterId kNumIndexLogApplied;
+stats::CounterId kIndexLogLagMs;
+stats::CounterId kNumLookupBarrierTimeouts;
+stats::CounterId kNumResourceGroupRequests;
+stats::CounterId kNumResourceGroupRejected;
 
 void initStorageStats() {
   kNumEdgesInserted = stats::StatsManager::registerStats("num_edges_inserted", "rate, sum");
@@ -20,6 +29,24 @@ void initStorageStats() {
   kNumEdgesDeleted = stats::StatsManager::registerStats("num_edges_deleted", "rate, sum");
   kNumTagsDeleted = stats::StatsManager::registerStats("num_tags_deleted", "rate, sum");
   kNumVerticesDeleted = stats::StatsManager::registerStats("num_vertices_deleted", "rate, sum");
+  kNumVertexCacheHits = stats::StatsManager::registerStats("num_vertex_cache_hits", "rate, sum");
+  kNumVertexCacheMisses =
+      stats::StatsManager::registerStats("num_vertex_cache_misses", "rate, sum");
+  kNumAdjacencyCacheHits =
+      stats::StatsManager::registerStats("num_adjacency_cache_hits", "rate, sum");
+  kNumAdjacencyCacheMisses =
+      stats::StatsManager::registerStats("num_adjacency_cache_misses", "rate, sum");
+  kNumIndexLogApplied = stats::StatsManager::registerStats("num_index_log_applied", "rate, sum");
+  // Age of the oldest operation not applied yet, of the indexes maintained asynchronously
+  kIndexLogLagMs =
+      stats::StatsManager::registerHisto("index_log_lag_ms", 100, 0, 10000, "avg, p95, p99");
+  kNumLookupBarrierTimeouts =
+      stats::StatsManager::registerStats("num_lookup_barrier_timeouts", "rate, sum");
+  // Labelled by the resource group
+  kNumResourceGroupRequests =
+      stats::StatsManager::registerStats("num_resource_group_requests", "rate, sum");
+  kNumResourceGroupRejected =
+      stats::StatsManager::registerStats("num_resource_group_rejected", "rate, sum");
 
 #ifndef BUILD_STANDALONE
   initMetaClientStats();
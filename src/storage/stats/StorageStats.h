@@ -15,6 +15,15 @@ extern stats::CounterId kNumVerticesInserted;
 extern stats::CounterId kNumEdgesDeleted;
 extern stats::CounterId kNumTagsDeleted;
 extern stats::CounterId kNumVerticesDeleted;
+extern stats::CounterId kNumVertexCacheHits;
+extern stats::CounterId kNumVertexCacheMisses;
+extern stats::CounterId kNumAdjacencyCacheHits;
+extern stats::CounterId kNumAdjacencyCacheMisses;
+extern stats::CounterId kNumIndexLogApplied;
+extern stats::CounterId kIndexLogLagMs;
+extern stats::CounterId kNumLookupBarrierTimeouts;
+extern stats::CounterId kNumResourceGroupRequests;
+extern stats::CounterId kNumResourceGroupRejected;
 
 /**
  * @brief Init storage statistic points for storage/meta client/kv
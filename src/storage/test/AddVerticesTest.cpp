@@ -6,6 +6,8 @@
 #include <gtest/gtest.h>
 #include <rocksdb/db.h>
 
+#include "codec/RowWriterV2.h"
+#include "codec/RowWriterV3.h"
 #include "common/base/Base.h"
 #include "common/fs/TempDir.h"
 #include "common/utils/NebulaKeyUtils.h"
@@ -95,6 +97,58 @@ TEST(AddVerticesTest, MultiVersionTest) {
   checkAddVerticesData(req, env, 81, 2);
 }
 
+TEST(AddVerticesTest, EncodedPropsTest) {
+  fs::TempDir rootPath("/tmp/AddVerticesTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+
+  LOG(INFO) << "Build AddVerticesRequest with encoded props...";
+  cpp2::AddVerticesRequest req = mock::MockData::mockAddVerticesReq();
+  auto spaceId = req.get_space_id();
+  for (auto& part : *req.parts_ref()) {
+    for (auto& newVertex : part.second) {
+      for (auto& newTag : *newVertex.tags_ref()) {
+        auto schema = env->schemaMan_->getTagSchema(spaceId, newTag.get_tag_id());
+        ASSERT_TRUE(schema != nullptr);
+        RowWriterV2 writer(schema.get());
+        const auto& props = newTag.get_props();
+        for (size_t i = 0; i < props.size(); i++) {
+          ASSERT_EQ(WriteResult::SUCCEEDED, writer.setValue(i, props[i]));
+        }
+        ASSERT_EQ(WriteResult::SUCCEEDED, writer.finish());
+        auto row = std::move(writer).moveEncodedStr();
+        ASSERT_EQ(WriteResult::SUCCEEDED, RowWriterV3::upgrade(schema.get(), row));
+        newTag.encoded_props_ref() = std::move(row);
+      }
+    }
+  }
+
+  {
+    LOG(INFO) << "Test AddVerticesProcessor...";
+    auto* processor = AddVerticesProcessor::instance(env, nullptr);
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, resp.result.failed_parts.size());
+    checkAddVerticesData(req, env, 81, 0);
+  }
+  {
+    LOG(INFO) << "Truncated encoded props are rejected...";
+    auto badReq = req;
+    auto& tags = *badReq.parts_ref()->begin()->second.front().tags_ref();
+    tags.front().encoded_props_ref()->resize(2);
+
+    auto* processor = AddVerticesProcessor::instance(env, nullptr);
+    auto fut = processor->getFuture();
+    processor->process(badReq);
+    auto resp = std::move(fut).get();
+    ASSERT_EQ(1, resp.result.failed_parts.size());
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_INVALID_FIELD_VALUE,
+              resp.result.failed_parts[0].get_code());
+  }
+}
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -0,0 +1,213 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+
+#include "clients/storage/InternalStorageClient.h"
+#include "codec/RowReaderWrapper.h"
+#include "codec/RowWriterV2.h"
+#include "common/base/Base.h"
+#include "common/base/MurmurHash2.h"
+#include "common/fs/TempDir.h"
+#include "common/utils/NebulaKeyUtils.h"
+#include "interface/gen-cpp2/meta_types.h"
+#include "mock/AdHocIndexManager.h"
+#include "mock/AdHocSchemaManager.h"
+#include "mock/MockCluster.h"
+#include "storage/admin/AlgoMailbox.h"
+#include "storage/admin/AlgoTask.h"
+
+namespace nebula {
+namespace storage {
+
+int gJobId = 0;
+
+// Deliver the messages of the algo tasks to the local mailbox instead of sending them by rpc
+class LocalInternalStorageClient : public InternalStorageClient {
+ public:
+  explicit LocalInternalStorageClient(StorageEnv* env)
+      : InternalStorageClient(std::make_shared<folly::IOThreadPoolExecutor>(1), env->metaClient_) {}
+
+  folly::Future<nebula::cpp2::ErrorCode> algoMessages(const HostAddr& host,
+                                                      const cpp2::AlgoMessagesRequest& req,
+                                                      folly::EventBase* evb) override {
+    UNUSED(host);
+    UNUSED(evb);
+    AlgoMailbox::instance()->deliver(req);
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+};
+
+class AlgoTaskTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    LOG(INFO) << "SetUp AlgoTaskTest TestCase";
+    rootPath_ = std::make_unique<fs::TempDir>("/tmp/AlgoTaskTest.XXXXXX");
+    cluster_ = std::make_unique<nebula::mock::MockCluster>();
+    cluster_->initStorageKV(rootPath_->path());
+    env_ = cluster_->storageEnv_.get();
+
+    // tag 1 (name, comp, core), edge 101 without properties
+    schemaMan_ = std::make_unique<nebula::mock::AdHocSchemaManager>(kParts);
+    auto tag = std::make_shared<meta::NebulaSchemaProvider>(0);
+    tag->addField("name", nebula::cpp2::PropertyType::STRING, 0, false, "");
+    tag->addField("comp", nebula::cpp2::PropertyType::STRING, 0, true);
+    tag->addField("core", nebula::cpp2::PropertyType::BOOL, 0, true);
+    schemaMan_->addTagSchema(kSpace, 1, tag);
+    schemaMan_->addEdgeSchema(kSpace, 101, std::make_shared<meta::NebulaSchemaProvider>(0));
+    // The result tag should not be indexed, only tag 2 is
+    indexMan_ = std::make_unique<nebula::mock::AdHocIndexManager>();
+    indexMan_->addTagIndex(kSpace, 2, 1, std::vector<meta::cpp2::ColumnDef>());
+    client_ = std::make_unique<LocalInternalStorageClient>(env_);
+    env_->schemaMan_ = schemaMan_.get();
+    env_->indexMan_ = indexMan_.get();
+    env_->interClient_ = client_.get();
+
+    // The component of a, b, c and d is "a", and the 2-core of them is a, b and c. The vertex e
+    // has no tag row.
+    for (const auto& vId : {"a", "b", "c", "d"}) {
+      RowWriterV2 writer(tag.get());
+      writer.setValue("name", std::string("name_") + vId);
+      writer.finish();
+      put(partOf(vId), NebulaKeyUtils::tagKey(kVIdLen, partOf(vId), vId, 1),
+          writer.moveEncodedStr());
+    }
+    for (const auto& edge : std::vector<std::pair<std::string, std::string>>{
+             {"a", "b"}, {"b", "c"}, {"c", "a"}, {"c", "d"}, {"d", "e"}}) {
+      const auto& src = edge.first;
+      const auto& dst = edge.second;
+      put(partOf(src), NebulaKeyUtils::edgeKey(kVIdLen, partOf(src), src, 101, 0, dst), "");
+      put(partOf(dst), NebulaKeyUtils::edgeKey(kVIdLen, partOf(dst), dst, -101, 0, src), "");
+    }
+  }
+
+  static void TearDownTestCase() {
+    LOG(INFO) << "TearDown AlgoTaskTest TestCase";
+    cluster_.reset();
+    client_.reset();
+    indexMan_.reset();
+    schemaMan_.reset();
+    rootPath_.reset();
+  }
+
+  static PartitionID partOf(const std::string& vId) {
+    MurmurHash2 hash;
+    return hash(vId.data()) % kParts + 1;
+  }
+
+  static void put(PartitionID partId, std::string key, std::string val) {
+    std::vector<kvstore::KV> data;
+    data.emplace_back(std::move(key), std::move(val));
+    folly::Baton<true, std::atomic> baton;
+    env_->kvstore_->asyncMultiPut(
+        kSpace, partId, std::move(data), [&baton](nebula::cpp2::ErrorCode code) {
+          EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+          baton.post();
+        });
+    baton.wait();
+  }
+
+  static nebula::cpp2::ErrorCode run(std::vector<std::string> paras) {
+    cpp2::TaskPara parameter;
+    parameter.space_id_ref() = kSpace;
+    parameter.parts_ref() = std::vector<PartitionID>{1, 2, 3, 4, 5, 6};
+    parameter.task_specific_paras_ref() = std::move(paras);
+
+    cpp2::AddTaskRequest request;
+    request.job_type_ref() = meta::cpp2::JobType::ALGO;
+    request.job_id_ref() = ++gJobId;
+    request.task_id_ref() = 0;
+    request.para_ref() = std::move(parameter);
+
+    auto callback = [](nebula::cpp2::ErrorCode, nebula::meta::cpp2::StatsItem&) {};
+    TaskContext context(request, callback);
+    AlgoTask task(env_, std::move(context));
+    EXPECT_TRUE(task.check());
+    auto subTasks = task.genSubTasks();
+    if (!nebula::ok(subTasks)) {
+      return nebula::error(subTasks);
+    }
+    auto tasks = nebula::value(std::move(subTasks));
+    EXPECT_EQ(1, tasks.size());
+    return tasks[0].invoke();
+  }
+
+  // The props of tag 1 of the vertex, empty if the vertex has no tag row
+  static std::unordered_map<std::string, Value> readTag(const std::string& vId) {
+    std::string row;
+    auto key = NebulaKeyUtils::tagKey(kVIdLen, partOf(vId), vId, 1);
+    auto code = env_->kvstore_->get(kSpace, partOf(vId), key, &row);
+    std::unordered_map<std::string, Value> props;
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND, code);
+      return props;
+    }
+    auto reader = RowReaderWrapper::getTagPropReader(schemaMan_.get(), kSpace, 1, row);
+    EXPECT_TRUE(reader != nullptr);
+    for (const auto& name : {"name", "comp", "core"}) {
+      props[name] = reader->getValueByName(name);
+    }
+    return props;
+  }
+
+  static constexpr GraphSpaceID kSpace = 1;
+  static constexpr int32_t kParts = 6;
+  static constexpr size_t kVIdLen = 32;
+  static constexpr char kAssignment[] = "127.0.0.1:1=1,2,3,4,5,6";
+
+  static StorageEnv* env_;
+
+ private:
+  static std::unique_ptr<fs::TempDir> rootPath_;
+  static std::unique_ptr<nebula::mock::MockCluster> cluster_;
+  static std::unique_ptr<nebula::mock::AdHocSchemaManager> schemaMan_;
+  static std::unique_ptr<nebula::mock::AdHocIndexManager> indexMan_;
+  static std::unique_ptr<LocalInternalStorageClient> client_;
+};
+
+StorageEnv* AlgoTaskTest::env_{nullptr};
+std::unique_ptr<fs::TempDir> AlgoTaskTest::rootPath_{nullptr};
+std::unique_ptr<nebula::mock::MockCluster> AlgoTaskTest::cluster_{nullptr};
+std::unique_ptr<nebula::mock::AdHocSchemaManager> AlgoTaskTest::schemaMan_{nullptr};
+std::unique_ptr<nebula::mock::AdHocIndexManager> AlgoTaskTest::indexMan_{nullptr};
+std::unique_ptr<LocalInternalStorageClient> AlgoTaskTest::client_{nullptr};
+
+TEST_F(AlgoTaskTest, WriteOnlyResultProp) {
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, run({"wcc", "1", "comp", "", kAssignment}));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, run({"kcore", "1", "core", "k=2", kAssignment}));
+  for (const auto& vId : {"a", "b", "c", "d"}) {
+    auto props = readTag(vId);
+    ASSERT_EQ(3, props.size());
+    // The other props are kept
+    EXPECT_EQ(Value(std::string("name_") + vId), props["name"]);
+    EXPECT_EQ(Value("a"), props["comp"]);
+    EXPECT_EQ(Value(std::string(vId) != "d"), props["core"]);
+  }
+  // The vertex without the tag is not inserted the tag
+  EXPECT_TRUE(readTag("e").empty());
+}
+
+TEST_F(AlgoTaskTest, InvalidAssignment) {
+  // No assignment
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_INVALID_PARM, run({"wcc", "1", "comp", ""}));
+  // Part 6 is not assigned
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_INVALID_PARM,
+            run({"wcc", "1", "comp", "", "127.0.0.1:1=1,2,3;127.0.0.1:2=4,5"}));
+  // Bad address
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_INVALID_PARM,
+            run({"wcc", "1", "comp", "", "127.0.0.1=1,2,3,4,5,6"}));
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+
+  return RUN_ALL_TESTS();
+}
@@ -20,6 +20,8 @@
 #include "storage/transaction/ChainAddEdgesLocalProcessor.h"
 #include "storage/transaction/ConsistUtil.h"
 
+DECLARE_uint32(toss_chain_batch_edges);
+
 namespace nebula {
 namespace storage {
 
@@ -176,6 +178,44 @@ TEST(ChainAddEdgesTest, processRemoteUnknownTest) {
   EXPECT_EQ(334, numOfKey(req, util.genDoublePrime, env));
 }
 
+TEST(ChainAddEdgesTest, BatchTest) {
+  auto makeReq = [](const std::string& src, const std::string& dst) {
+    cpp2::NewEdge edge;
+    edge.key_ref()->src_ref() = src;
+    edge.key_ref()->edge_type_ref() = 101;
+    edge.key_ref()->ranking_ref() = 0;
+    edge.key_ref()->dst_ref() = dst;
+    cpp2::AddEdgesRequest req;
+    req.space_id_ref() = mockSpaceId;
+    (*req.parts_ref())[1].emplace_back(std::move(edge));
+    return req;
+  };
+
+  auto batch = TransactionManagerTester::makeBatch(makeReq("a", "b"));
+  auto other = TransactionManagerTester::makeBatch(makeReq("a", "c"));
+  EXPECT_TRUE(TransactionManagerTester::mergeBatch(batch, other));
+  EXPECT_EQ(2, batch.numEdges);
+  EXPECT_EQ(2, batch.promises.size());
+  EXPECT_EQ(2, batch.req.get_parts().at(1).size());
+
+  // The same edge goes to another chain
+  auto dup = TransactionManagerTester::makeBatch(makeReq("a", "b"));
+  EXPECT_FALSE(TransactionManagerTester::mergeBatch(batch, dup));
+
+  // So do the edges of different props
+  auto req = makeReq("a", "d");
+  req.prop_names_ref() = std::vector<std::string>{"teamName"};
+  auto diffProps = TransactionManagerTester::makeBatch(std::move(req));
+  EXPECT_FALSE(TransactionManagerTester::mergeBatch(batch, diffProps));
+
+  auto limit = FLAGS_toss_chain_batch_edges;
+  FLAGS_toss_chain_batch_edges = 2;
+  auto full = TransactionManagerTester::makeBatch(makeReq("a", "e"));
+  EXPECT_FALSE(TransactionManagerTester::mergeBatch(batch, full));
+  FLAGS_toss_chain_batch_edges = limit;
+  EXPECT_EQ(2, batch.numEdges);
+}
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -22,8 +22,18 @@ using KeyGenerator = std::function<std::string(PartitionID partId, const cpp2::N
 
 class TransactionManagerTester {
  public:
+  using EdgesChainBatch = TransactionManager::EdgesChainBatch;
+
   explicit TransactionManagerTester(TransactionManager* p) : man_(p) {}
 
+  static EdgesChainBatch makeBatch(cpp2::AddEdgesRequest req) {
+    return TransactionManager::makeEdgesChainBatch(std::move(req), folly::Promise<Code>());
+  }
+
+  static bool mergeBatch(EdgesChainBatch& dst, EdgesChainBatch& src) {
+    return TransactionManager::mergeEdgesChainBatch(dst, src);
+  }
+
   void stop() {
     man_->stop();
     int32_t numCheckIdle = 0;
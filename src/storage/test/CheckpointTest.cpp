@@ -55,6 +55,30 @@ TEST(CheckpointTest, simpleTest) {
     files = fs::FileUtils::listAllFilesInDir(checkpoint2.data());
     ASSERT_EQ(4, files.size());
   }
+
+  // The incremental checkpoint without new writes shares all the sst files with the base
+  {
+    auto* processor = CreateCheckpointProcessor::instance(env);
+    cpp2::CreateCPRequest req;
+    std::vector<GraphSpaceID> ids{1};
+    req.space_ids_ref() = ids;
+    req.name_ref() = "checkpoint_inc";
+    req.base_name_ref() = "checkpoint_test";
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+    ASSERT_FALSE(resp.get_info().empty());
+    for (const auto& info : resp.get_info()) {
+      ASSERT_TRUE(info.new_files_ref().has_value());
+      ASSERT_FALSE(info.new_files_ref()->empty());
+      for (const auto& file : *info.new_files_ref()) {
+        folly::StringPiece name(file);
+        EXPECT_FALSE(name.endsWith(".sst")) << file;
+        EXPECT_TRUE(fs::FileUtils::exist(fs::FileUtils::joinPath(info.get_path(), file)));
+      }
+    }
+  }
 }
 
 }  // namespace storage
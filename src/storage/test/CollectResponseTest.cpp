@@ -0,0 +1,136 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+
+#include "clients/storage/StorageClientBase.h"
+#include "common/base/Base.h"
+#include "common/thrift/ThriftLocalClientManager.h"
+#include "storage/test/ChainTestUtils.h"
+
+namespace nebula {
+namespace storage {
+
+constexpr int32_t mockSpaceId = 1;
+
+// The rpc are made by the remote functions of the tests
+class FakeClient {
+ public:
+  static std::shared_ptr<FakeClient> getInstance() {
+    static auto client = std::make_shared<FakeClient>();
+    return client;
+  }
+};
+
+using TestClientBase = StorageClientBase<FakeClient, thrift::LocalClientManager<FakeClient>>;
+
+class TestStorageClient : public TestClientBase {
+ public:
+  TestStorageClient(std::shared_ptr<folly::IOThreadPoolExecutor> threadPool,
+                    meta::MetaClient* metaClient)
+      : TestClientBase(threadPool, metaClient) {}
+
+  using TestClientBase::collectResponse;
+};
+
+class CollectResponseTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    metaClient_ = MetaClientTestUpdater::makeDefault();
+    threadPool_ = std::make_shared<folly::IOThreadPoolExecutor>(2);
+    client_ = std::make_unique<TestStorageClient>(threadPool_, metaClient_.get());
+  }
+
+  void TearDown() override {
+    client_.reset();
+    threadPool_.reset();
+  }
+
+  cpp2::GetNeighborsRequest request(PartitionID partId) {
+    cpp2::GetNeighborsRequest req;
+    req.space_id_ref() = mockSpaceId;
+    req.column_names_ref() = {"_vid"};
+    req.parts_ref() = std::unordered_map<PartitionID, std::vector<Row>>{{partId, {Row({"a"})}}};
+    return req;
+  }
+
+  // The response of the request to a part holds the part id, and is delayed by 500ms per part
+  auto remote() {
+    return [](FakeClient*, const cpp2::GetNeighborsRequest& req) {
+      auto partId = req.get_parts().begin()->first;
+      cpp2::GetNeighborsResponse resp;
+      resp.result_ref() = cpp2::ResponseCommon();
+      DataSet ds({"_vid"});
+      ds.emplace_back(Row({partId}));
+      resp.vertices_ref() = std::move(ds);
+      return folly::makeFuture()
+          .delayed(std::chrono::milliseconds((partId - 1) * 500))
+          .thenValue([resp = std::move(resp)](auto&&) { return resp; });
+    };
+  }
+
+  HostAddr host1_{"127.0.0.1", 1};
+  HostAddr host2_{"127.0.0.1", 2};
+  std::unique_ptr<meta::MetaClient> metaClient_;
+  std::shared_ptr<folly::IOThreadPoolExecutor> threadPool_;
+  std::unique_ptr<TestStorageClient> client_;
+};
+
+TEST_F(CollectResponseTest, HandleEachResponseOnArrival) {
+  std::vector<std::pair<HostAddr, cpp2::GetNeighborsRequest>> requests;
+  requests.emplace_back(host1_, request(1));
+  requests.emplace_back(host2_, request(2));
+
+  folly::Baton<> firstHandled;
+  std::atomic<int32_t> handled{0};
+  std::mutex lock;
+  std::vector<Value> vids;
+  ResponseHandler<cpp2::GetNeighborsResponse> onResponse = [&](cpp2::GetNeighborsResponse& resp) {
+    ASSERT_TRUE(resp.vertices_ref().has_value());
+    // Take the data out of the response
+    auto ds = std::move(*resp.vertices_ref());
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      for (auto& row : ds.rows) {
+        vids.emplace_back(row.values.front());
+      }
+    }
+    if (handled.fetch_add(1) == 0) {
+      firstHandled.post();
+    }
+  };
+  auto future = client_->collectResponse(nullptr, std::move(requests), remote(), onResponse);
+
+  // The fast response is consumed while the slow one is still on the way
+  ASSERT_TRUE(firstHandled.try_wait_for(std::chrono::milliseconds(300)));
+  EXPECT_EQ(1, handled.load());
+  EXPECT_FALSE(future.isReady());
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    EXPECT_EQ(std::vector<Value>{1}, vids);
+  }
+
+  auto resp = std::move(future).get();
+  EXPECT_TRUE(resp.succeeded());
+  EXPECT_EQ(2, handled.load());
+  EXPECT_EQ((std::vector<Value>{1, 2}), vids);
+  // The responses are still collected without the data taken, whose size was counted before
+  ASSERT_EQ(2, resp.responses().size());
+  for (auto& r : resp.responses()) {
+    EXPECT_TRUE(r.vertices_ref()->rows.empty());
+  }
+  EXPECT_GT(resp.responseBytes(), 0);
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+  return RUN_ALL_TESTS();
+}
@@ -13,8 +13,10 @@
 #include "interface/gen-cpp2/storage_types.h"
 #include "mock/MockCluster.h"
 #include "mock/MockData.h"
+#include "storage/StorageFlags.h"
 #include "storage/mutate/AddEdgesProcessor.h"
 #include "storage/mutate/DeleteEdgesProcessor.h"
+#include "storage/query/GetDegreesProcessor.h"
 #include "storage/test/TestUtils.h"
 
 namespace nebula {
@@ -67,6 +69,94 @@ TEST(DeleteEdgesTest, SimpleTest) {
   }
 }
 
+// Check the counted degrees of all the src and edge types in the request
+static void checkDegrees(StorageEnv* env, const cpp2::AddEdgesRequest& addReq, bool deleted) {
+  // src => edge type => the number of edges
+  std::unordered_map<PartitionID, std::map<std::string, std::map<EdgeType, int64_t>>> expected;
+  std::set<EdgeType> edgeTypes;
+  for (const auto& [partId, edges] : addReq.get_parts()) {
+    std::set<std::tuple<std::string, EdgeType, EdgeRanking, std::string>> keys;
+    for (const auto& edge : edges) {
+      const auto& key = edge.get_key();
+      edgeTypes.emplace(key.get_edge_type());
+      auto& degree = expected[partId][key.get_src().getStr()][key.get_edge_type()];
+      if (keys.emplace(key.get_src().getStr(),
+                       key.get_edge_type(),
+                       key.get_ranking(),
+                       key.get_dst().getStr())
+              .second &&
+          !deleted) {
+        ++degree;
+      }
+    }
+  }
+
+  cpp2::GetDegreesRequest req;
+  req.space_id_ref() = addReq.get_space_id();
+  req.edge_types_ref() = std::vector<EdgeType>(edgeTypes.begin(), edgeTypes.end());
+  for (const auto& [partId, srcs] : expected) {
+    for (const auto& src : srcs) {
+      (*req.parts_ref())[partId].emplace_back(src.first);
+    }
+  }
+  auto* processor = GetDegreesProcessor::instance(env, nullptr);
+  auto fut = processor->getFuture();
+  processor->process(req);
+  auto resp = std::move(fut).get();
+  ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+  const auto& degrees = *resp.degrees_ref();
+  ASSERT_EQ(edgeTypes.size() + 1, degrees.colNames.size());
+  size_t numRows = 0;
+  for (const auto& srcs : expected) {
+    numRows += srcs.second.size();
+  }
+  ASSERT_EQ(numRows, degrees.rows.size());
+  for (const auto& row : degrees.rows) {
+    const auto& src = row.values[0].getStr();
+    size_t i = 1;
+    for (auto edgeType : edgeTypes) {
+      int64_t degree = 0;
+      for (const auto& srcs : expected) {
+        auto srcIter = srcs.second.find(src);
+        if (srcIter != srcs.second.end() && srcIter->second.count(edgeType)) {
+          degree = srcIter->second.at(edgeType);
+        }
+      }
+      EXPECT_EQ(degree, row.values[i++].getInt());
+    }
+  }
+}
+
+TEST(DeleteEdgesTest, DegreeCountersTest) {
+  FLAGS_enable_degree_counters = true;
+  fs::TempDir rootPath("/tmp/DeleteEdgesTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  cpp2::AddEdgesRequest addReq = mock::MockData::mockAddEdgesReq();
+
+  // The edges inserted again are not counted twice
+  for (int i = 0; i < 2; i++) {
+    auto* processor = AddEdgesProcessor::instance(env, nullptr);
+    auto fut = processor->getFuture();
+    processor->process(addReq);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    checkDegrees(env, addReq, false);
+  }
+
+  {
+    auto* processor = DeleteEdgesProcessor::instance(env, nullptr);
+    cpp2::DeleteEdgesRequest req = mock::MockData::mockDeleteEdgesReq();
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    checkDegrees(env, addReq, true);
+  }
+  FLAGS_enable_degree_counters = false;
+}
+
 TEST(DeleteEdgesTest, MultiVersionTest) {
   fs::TempDir rootPath("/tmp/DeleteEdgesTest.XXXXXX");
   mock::MockCluster cluster;
@@ -0,0 +1,317 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+
+#include "codec/RowReaderWrapper.h"
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include "common/utils/NebulaKeyUtils.h"
+#include "kvstore/NebulaStore.h"
+#include "storage/StorageFlags.h"
+#include "storage/query/ExportProcessor.h"
+#include "storage/test/QueryTestUtils.h"
+
+namespace nebula {
+namespace storage {
+
+cpp2::ExportRequest buildRequest(bool edge, std::vector<int32_t> schemaIds, int64_t limit) {
+  cpp2::ExportRequest req;
+  req.space_id_ref() = 1;
+  req.edge_ref() = edge;
+  req.schema_ids_ref() = std::move(schemaIds);
+  req.limit_ref() = limit;
+  return req;
+}
+
+cpp2::ExportResponse exportData(StorageEnv* env,
+                                const cpp2::ExportRequest& req,
+                                folly::Executor* executor = nullptr) {
+  auto* processor = ExportProcessor::instance(env, nullptr, executor);
+  auto f = processor->getFuture();
+  processor->process(req);
+  return std::move(f).get();
+}
+
+// The string values of the variable width column
+std::vector<std::string> strings(const nebula::cpp2::ColumnarColumn& column) {
+  CHECK(column.offsets_ref().has_value());
+  const auto& offsets = *column.offsets_ref();
+  const auto* begin = reinterpret_cast<const int32_t*>(offsets.data());
+  std::vector<std::string> values;
+  for (size_t i = 0; i + 1 < offsets.size() / sizeof(int32_t); i++) {
+    values.emplace_back(column.get_values().substr(begin[i], begin[i + 1] - begin[i]));
+  }
+  return values;
+}
+
+TEST(ExportTest, Vertices) {
+  fs::TempDir rootPath("/tmp/ExportTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+
+  TagID player = 1;
+  // All the leader parts on the host
+  auto resp = exportData(env, buildRequest(false, {player}, -1));
+  ASSERT_EQ(0, resp.result.failed_parts.size());
+  EXPECT_TRUE(resp.get_cursors().empty());
+  auto schema = env->schemaMan_->getTagSchema(1, player);
+  ASSERT_NE(nullptr, schema);
+
+  size_t totalRows = 0;
+  for (const auto& batch : resp.get_batches()) {
+    ASSERT_EQ(player, batch.get_schema_id());
+    const auto& columns = batch.get_columns();
+    ASSERT_EQ(schema->getNumFields() + 1, columns.size());
+    ASSERT_EQ(kVid, columns[0].get_name());
+    auto vIds = strings(columns[0]);
+    ASSERT_EQ(batch.get_num_rows(), vIds.size());
+
+    auto nameIndex = schema->getFieldIndex("name");
+    ASSERT_GE(nameIndex, 0);
+    const auto& names = columns[nameIndex + 1];
+    ASSERT_EQ("name", names.get_name());
+    EXPECT_EQ(vIds, strings(names));
+
+    auto ageIndex = schema->getFieldIndex("age");
+    ASSERT_GE(ageIndex, 0);
+    const auto& ages = columns[ageIndex + 1];
+    ASSERT_EQ(nebula::cpp2::PropertyType::INT64, ages.get_type());
+    ASSERT_EQ(batch.get_num_rows() * sizeof(int64_t), ages.get_values().size());
+    const auto* ageValues = reinterpret_cast<const int64_t*>(ages.get_values().data());
+    for (size_t i = 0; i < vIds.size(); i++) {
+      auto iter = std::find_if(mock::MockData::players_.begin(),
+                               mock::MockData::players_.end(),
+                               [&](const auto& p) { return p.name_ == vIds[i]; });
+      ASSERT_NE(mock::MockData::players_.end(), iter);
+      EXPECT_EQ(iter->age_, ageValues[i]);
+    }
+    totalRows += batch.get_num_rows();
+  }
+  EXPECT_EQ(mock::MockData::players_.size(), totalRows);
+  EXPECT_EQ(0, ExportSnapshots::instance().size());
+}
+
+TEST(ExportTest, PagedEdges) {
+  fs::TempDir rootPath("/tmp/ExportTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+
+  EdgeType serve = 101;
+  auto req = buildRequest(true, {serve}, 5);
+  req.batch_size_ref() = 2;
+  req.raw_rows_ref() = true;
+  auto schemas = env->schemaMan_->getAllVerEdgeSchema(1);
+  ASSERT_TRUE(schemas.ok());
+  const auto& versions = schemas.value()[serve];
+
+  size_t totalRows = 0;
+  size_t pages = 0;
+  while (true) {
+    auto resp = exportData(env, req);
+    ASSERT_EQ(0, resp.result.failed_parts.size());
+    for (const auto& batch : resp.get_batches()) {
+      ASSERT_LE(batch.get_num_rows(), 2);
+      const auto& columns = batch.get_columns();
+      ASSERT_EQ(4, columns.size());
+      ASSERT_EQ(kSrc, columns[0].get_name());
+      ASSERT_EQ(kRank, columns[1].get_name());
+      ASSERT_EQ(kDst, columns[2].get_name());
+      ASSERT_EQ("_row", columns[3].get_name());
+      auto srcs = strings(columns[0]);
+      auto rows = strings(columns[3]);
+      ASSERT_EQ(batch.get_num_rows(), rows.size());
+      for (size_t i = 0; i < rows.size(); i++) {
+        auto reader = RowReaderWrapper::getRowReader(versions, rows[i]);
+        ASSERT_TRUE(!!reader);
+        EXPECT_EQ(srcs[i], reader->getValueByName("playerName").getStr());
+      }
+      totalRows += batch.get_num_rows();
+    }
+    pages++;
+    if (resp.get_cursors().empty()) {
+      break;
+    }
+    req.parts_ref() = resp.get_cursors();
+    req.snapshot_id_ref() = resp.get_snapshot_id();
+  }
+  EXPECT_EQ(mock::MockData::serves_.size(), totalRows);
+  EXPECT_GT(pages, 1);
+  EXPECT_EQ(0, ExportSnapshots::instance().size());
+}
+
+TEST(ExportTest, Snapshot) {
+  fs::TempDir rootPath("/tmp/ExportTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+
+  TagID player = 1;
+  PartitionID partId = 1;
+  auto req = buildRequest(false, {player}, 1);
+  (*req.parts_ref())[partId] = cpp2::ScanCursor();
+  req.raw_rows_ref() = true;
+  auto resp = exportData(env, req);
+  ASSERT_EQ(0, resp.result.failed_parts.size());
+  ASSERT_EQ(1, resp.get_cursors().size());
+  EXPECT_EQ(1, ExportSnapshots::instance().size());
+
+  // A vertex after the cursor is added after the first page
+  std::vector<kvstore::KV> data;
+  data.emplace_back(NebulaKeyUtils::tagKey(32, partId, "zzz", player), "");
+  folly::Baton<true, std::atomic> baton;
+  env->kvstore_->asyncMultiPut(1, partId, std::move(data), [&](nebula::cpp2::ErrorCode code) {
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+    baton.post();
+  });
+  baton.wait();
+
+  req.parts_ref() = resp.get_cursors();
+  req.snapshot_id_ref() = resp.get_snapshot_id();
+  req.limit_ref() = -1;
+  auto rest = exportData(env, req);
+  ASSERT_EQ(0, rest.result.failed_parts.size());
+  EXPECT_TRUE(rest.get_cursors().empty());
+  for (const auto& batch : rest.get_batches()) {
+    for (const auto& vId : strings(batch.get_columns()[0])) {
+      EXPECT_NE("zzz", vId);
+    }
+  }
+  EXPECT_EQ(0, ExportSnapshots::instance().size());
+}
+
+TEST(ExportTest, Errors) {
+  fs::TempDir rootPath("/tmp/ExportTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  {
+    // The whole export fails even if no part is given
+    auto req = buildRequest(false, {}, -1);
+    req.space_id_ref() = 100;
+    auto resp = exportData(env, req);
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_SPACE_NOT_FOUND, resp.get_code());
+    EXPECT_TRUE(resp.get_batches().empty());
+  }
+  {
+    auto resp = exportData(env, buildRequest(false, {10000}, -1));
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_TAG_NOT_FOUND, resp.get_code());
+  }
+  {
+    auto resp = exportData(env, buildRequest(true, {10000}, -1));
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_EDGE_NOT_FOUND, resp.get_code());
+  }
+  {
+    auto resp = exportData(env, buildRequest(false, {}, -1));
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+  }
+}
+
+TEST(ExportTest, Throttle) {
+  fs::TempDir rootPath("/tmp/ExportTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  auto executor = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+  TagID player = 1;
+  auto req = buildRequest(false, {player}, -1);
+  req.batch_size_ref() = 1;
+  req.raw_rows_ref() = true;
+  auto resp = exportData(env, req, executor.get());
+  size_t bytes = 0;
+  for (const auto& batch : resp.get_batches()) {
+    for (const auto& column : batch.get_columns()) {
+      bytes += column.get_values().size() + column.offsets_ref().value_or("").size();
+    }
+  }
+  ASSERT_GT(bytes, 0);
+
+  // Twice of the rate is returned after a second at least, the first burst is not waited for
+  req.max_bytes_per_second_ref() = bytes / 2;
+  auto start = std::chrono::steady_clock::now();
+  auto throttled = exportData(env, req, executor.get());
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(resp.get_batches().size(), throttled.get_batches().size());
+  EXPECT_GE(elapsed, std::chrono::milliseconds(800));
+  EXPECT_EQ(0, ExportSnapshots::instance().size());
+}
+
+TEST(ExportTest, SnapshotReaders) {
+  fs::TempDir rootPath("/tmp/ExportTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto* kvstore = env->kvstore_;
+  auto& snapshots = ExportSnapshots::instance();
+  GraphSpaceID spaceId = 1;
+  PartitionID partId = 1;
+  auto numSnapshots = [&] {
+    auto prop = kvstore->getProperty(spaceId, "rocksdb.num-snapshots");
+    CHECK(nebula::ok(prop));
+    return folly::parseJson(nebula::value(prop))["Engine 0"].asString();
+  };
+
+  // Two pages of the same part are read at the same time
+  auto exportId = snapshots.newExportId();
+  auto* snapshot = snapshots.acquire(kvstore, exportId, spaceId, partId, false);
+  ASSERT_NE(nullptr, snapshot);
+  EXPECT_EQ(snapshot, snapshots.acquire(kvstore, exportId, spaceId, partId, false));
+  EXPECT_EQ("1", numSnapshots());
+
+  // Neither a finished page nor the expiration releases the snapshot being read
+  snapshots.release(kvstore, exportId, spaceId, partId, true);
+  auto ttl = FLAGS_export_snapshot_ttl_secs;
+  FLAGS_export_snapshot_ttl_secs = -10;
+  snapshots.expire(kvstore);
+  EXPECT_EQ(1, snapshots.size());
+  EXPECT_EQ("1", numSnapshots());
+
+  snapshots.release(kvstore, exportId, spaceId, partId, false);
+  EXPECT_EQ(0, snapshots.size());
+  EXPECT_EQ("0", numSnapshots());
+
+  // An unfinished part is released by the expiration
+  snapshots.acquire(kvstore, exportId, spaceId, partId, false);
+  snapshots.release(kvstore, exportId, spaceId, partId, false);
+  EXPECT_EQ(1, snapshots.size());
+  snapshots.expire(kvstore);
+  FLAGS_export_snapshot_ttl_secs = ttl;
+  EXPECT_EQ(0, snapshots.size());
+  EXPECT_EQ("0", numSnapshots());
+
+  // The snapshot of a removed part is released by the engine as well
+  snapshots.acquire(kvstore, exportId, spaceId, partId, false);
+  EXPECT_EQ("1", numSnapshots());
+  auto* store = dynamic_cast<kvstore::NebulaStore*>(kvstore);
+  ASSERT_NE(nullptr, store);
+  store->removePart(spaceId, partId);
+  snapshots.release(kvstore, exportId, spaceId, partId, true);
+  EXPECT_EQ(0, snapshots.size());
+  EXPECT_EQ("0", numSnapshots());
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+  return RUN_ALL_TESTS();
+}
@@ -7,6 +7,7 @@
 
 #include "common/base/Base.h"
 #include "common/fs/TempDir.h"
+#include "storage/mutate/DeleteEdgesProcessor.h"
 #include "storage/query/GetNeighborsProcessor.h"
 #include "storage/test/QueryTestUtils.h"
 
@@ -665,6 +666,55 @@ TEST(GetNeighborsTest, StatTest) {
     QueryTestUtils::checkResponse(
         *resp.vertices_ref(), vertices, over, tags, edges, 1, 5, &expectStat);
   }
+  {
+    LOG(INFO) << "CollectStatOnly";
+    std::vector<VertexID> vertices = {"LeBron James"};
+    std::vector<EdgeType> over = {serve};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+    tags.emplace_back(player, std::vector<std::string>{"name"});
+    edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+    auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+    std::vector<cpp2::StatProp> statProps;
+    {
+      // count of served teams
+      cpp2::StatProp statProp;
+      statProp.alias_ref() = ("Count");
+      const auto& exp = *EdgeRankExpression::make(pool, folly::to<std::string>(serve));
+      statProp.prop_ref() = (Expression::encode(exp));
+      statProp.stat_ref() = (cpp2::StatType::COUNT);
+      statProps.emplace_back(std::move(statProp));
+    }
+    {
+      // count teamGames_ in all served history
+      cpp2::StatProp statProp;
+      statProp.alias_ref() = ("Total games");
+      const auto& exp =
+          *EdgePropertyExpression::make(pool, folly::to<std::string>(serve), "teamGames");
+      statProp.prop_ref() = (Expression::encode(exp));
+      statProp.stat_ref() = (cpp2::StatType::SUM);
+      statProps.emplace_back(std::move(statProp));
+    }
+    (*req.traverse_spec_ref()).stat_props_ref() = (std::move(statProps));
+    (*req.traverse_spec_ref()).stats_only_ref() = true;
+
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+
+    ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    // vId, stat, player, expr, there is no edge column
+    const auto& ds = *resp.vertices_ref();
+    std::vector<std::string> expectColNames = {
+        kVid, "_stats:Count:Total games", "_tag:1:name", "_expr"};
+    EXPECT_EQ(expectColNames, ds.colNames);
+    ASSERT_EQ(1, ds.rows.size());
+    ASSERT_EQ(4, ds.rows[0].values.size());
+    EXPECT_EQ("LeBron James", ds.rows[0].values[0]);
+    std::vector<Value> expectStat = {4, 548 + 294 + 301 + 115};
+    EXPECT_EQ(List(std::move(expectStat)), ds.rows[0].values[1].getList());
+  }
 }
 
 TEST(GetNeighborsTest, LimitSampleTest) {
@@ -813,6 +863,40 @@ TEST(GetNeighborsTest, LimitSampleTest) {
               (*resp.vertices_ref()).rows[0].values[3].getList().values.size() +
                   (*resp.vertices_ref()).rows[0].values[4].getList().values.size());
   }
+  {
+    LOG(INFO) << "SampleWithEdgeBudget";
+    std::vector<VertexID> vertices = {"Dwyane Wade", "Tim Duncan"};
+    std::vector<EdgeType> over = {serve};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+    tags.emplace_back(player, std::vector<std::string>{"name"});
+    edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+
+    auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+    (*req.traverse_spec_ref()).limit_ref() = (10);
+    (*req.traverse_spec_ref()).random_ref() = (true);
+    (*req.traverse_spec_ref()).edge_budget_ref() = (2);
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+
+    // vId, stat, player, serve, expr
+    // Dwyane Wade has 4 serve edges and Tim Duncan has 1, the budget of 2 edges are all given
+    // to Dwyane Wade by the degrees
+    ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    ASSERT_EQ(2, (*resp.vertices_ref()).rows.size());
+    for (const auto& row : (*resp.vertices_ref()).rows) {
+      ASSERT_EQ(5, row.values.size());
+      if (row.values[0].getStr() == "Dwyane Wade") {
+        ASSERT_EQ(2, row.values[3].getList().values.size());
+      } else {
+        ASSERT_EQ(Value::Type::__EMPTY__, row.values[3].type());
+      }
+    }
+    ASSERT_TRUE(resp.truncated_vertices_ref().has_value());
+    ASSERT_EQ(2, (*resp.truncated_vertices_ref()).size());
+  }
 }
 
 TEST(GetNeighborsTest, MaxEdgReturnedPerVertexTest) {
@@ -2018,6 +2102,333 @@ TEST(GetNeighborsTest, FilterTest) {
          Value(),
          Value()});
   }
+  {
+    LOG(INFO) << "FilterOnEdgeKey";
+    std::vector<VertexID> vertices = {"Tracy McGrady"};
+    std::vector<EdgeType> over = {serve};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+    tags.emplace_back(player, std::vector<std::string>{"name", "age", "avgScore"});
+    edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+    auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+    {
+      // where serve._rank >= 2004 and serve.endYear > 2010 and serve._dst != "Hawks", the
+      // conjuncts on rank and dst are checked before decoding the edge value
+      const auto& exp = *LogicalExpression::makeAnd(
+          pool,
+          LogicalExpression::makeAnd(
+              pool,
+              RelationalExpression::makeGE(
+                  pool,
+                  EdgeRankExpression::make(pool, folly::to<std::string>(serve)),
+                  ConstantExpression::make(pool, Value(2004))),
+              RelationalExpression::makeGT(
+                  pool,
+                  EdgePropertyExpression::make(pool, folly::to<std::string>(serve), "endYear"),
+                  ConstantExpression::make(pool, Value(2010)))),
+          RelationalExpression::makeNE(
+              pool,
+              EdgeDstIdExpression::make(pool, folly::to<std::string>(serve)),
+              ConstantExpression::make(pool, Value("Hawks"))));
+      (*req.traverse_spec_ref()).filter_ref() = (Expression::encode(exp));
+    }
+
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+
+    ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    // vId, stat, player, serve, expr
+    nebula::DataSet expected;
+    expected.colNames = {kVid,
+                         "_stats",
+                         "_tag:1:name:age:avgScore",
+                         "_edge:+101:teamName:startYear:endYear",
+                         "_expr"};
+    nebula::Row row({"Tracy McGrady",
+                     Value(),
+                     nebula::List({"Tracy McGrady", 41, 19.6}),
+                     nebula::List(nebula::List({"Pistons", 2010, 2011})),
+                     Value()});
+    expected.rows.emplace_back(std::move(row));
+    ASSERT_EQ(expected, *resp.vertices_ref());
+  }
+  {
+    LOG(INFO) << "FilterOnlyOnEdgeKey";
+    std::vector<VertexID> vertices = {"Tracy McGrady"};
+    std::vector<EdgeType> over = {serve};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+    tags.emplace_back(player, std::vector<std::string>{"name", "age", "avgScore"});
+    edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+    auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+    {
+      // where serve._dst == "Magic"
+      const auto& exp = *RelationalExpression::makeEQ(
+          pool,
+          EdgeDstIdExpression::make(pool, folly::to<std::string>(serve)),
+          ConstantExpression::make(pool, Value("Magic")));
+      (*req.traverse_spec_ref()).filter_ref() = (Expression::encode(exp));
+    }
+
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+
+    ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    // vId, stat, player, serve, expr
+    nebula::DataSet expected;
+    expected.colNames = {kVid,
+                         "_stats",
+                         "_tag:1:name:age:avgScore",
+                         "_edge:+101:teamName:startYear:endYear",
+                         "_expr"};
+    nebula::Row row({"Tracy McGrady",
+                     Value(),
+                     nebula::List({"Tracy McGrady", 41, 19.6}),
+                     nebula::List(nebula::List({"Magic", 2000, 2004})),
+                     Value()});
+    expected.rows.emplace_back(std::move(row));
+    ASSERT_EQ(expected, *resp.vertices_ref());
+  }
+}
+
+TEST(GetNeighborsTest, TopNTest) {
+  fs::TempDir rootPath("/tmp/GetNeighborsTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+  auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+  EdgeType serve = 101;
+  std::vector<EdgeType> over = {serve};
+  std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+  std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+  edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear"});
+
+  // the start years of the serve edges returned, the edges are in the fourth column
+  auto getStartYears = [](const nebula::DataSet& ds) {
+    std::vector<int64_t> years;
+    for (const auto& row : ds.rows) {
+      EXPECT_TRUE(row.values[3].isList());
+      if (!row.values[3].isList()) {
+        continue;
+      }
+      for (const auto& edge : row.values[3].getList().values) {
+        years.emplace_back(edge.getList().values[1].getInt());
+      }
+    }
+    std::sort(years.begin(), years.end(), std::greater<int64_t>());
+    return years;
+  };
+  auto go = [&](const std::vector<VertexID>& vertices, int64_t limit, bool ordered) {
+    auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+    if (ordered) {
+      cpp2::OrderBy orderBy;
+      orderBy.prop_ref() = Expression::encode(
+          *EdgePropertyExpression::make(pool, folly::to<std::string>(serve), "startYear"));
+      orderBy.direction_ref() = cpp2::OrderDirection::DESCENDING;
+      (*req.traverse_spec_ref()).order_by_ref() = std::vector<cpp2::OrderBy>{orderBy};
+    }
+    if (limit >= 0) {
+      (*req.traverse_spec_ref()).limit_ref() = limit;
+    }
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    return std::move(*resp.vertices_ref());
+  };
+
+  {
+    LOG(INFO) << "TopNOfOneVertex";
+    std::vector<VertexID> vertices = {"Tracy McGrady"};
+    auto all = getStartYears(go(vertices, -1, false));
+    ASSERT_GT(all.size(), 2);
+    auto topN = getStartYears(go(vertices, 2, true));
+    ASSERT_EQ(std::vector<int64_t>(all.begin(), all.begin() + 2), topN);
+  }
+  {
+    LOG(INFO) << "TopNOfVerticesInParts";
+    std::vector<VertexID> vertices = {"Tracy McGrady", "Tim Duncan", "Tony Parker", "Kobe Bryant"};
+    auto all = getStartYears(go(vertices, -1, false));
+    auto result = go(vertices, 1, true);
+    // one edge at most for each part, and the vertices without edge are not returned
+    auto topN = getStartYears(result);
+    ASSERT_EQ(result.rows.size(), topN.size());
+    ASSERT_LE(topN.size(), vertices.size());
+    ASSERT_FALSE(topN.empty());
+    ASSERT_EQ(all.front(), topN.front());
+  }
+  {
+    LOG(INFO) << "OrderByWithoutLimit";
+    std::vector<VertexID> vertices = {"Tracy McGrady"};
+    auto all = getStartYears(go(vertices, -1, false));
+    ASSERT_EQ(all, getStartYears(go(vertices, -1, true)));
+  }
+}
+
+TEST(GetNeighborsTest, AdjacencyCacheTest) {
+  fs::TempDir rootPath("/tmp/GetNeighborsTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+  auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+  env->adjacencyCache_ = std::make_unique<VertexCache>(1024 * 1024);
+  FLAGS_adjacency_cache_min_degree = 1;
+
+  TagID player = 1;
+  EdgeType serve = 101;
+  std::vector<VertexID> vertices = {"Tim Duncan"};
+  PartitionID partId = (std::hash<std::string>()(vertices[0]) % totalParts) + 1;
+  std::vector<EdgeType> over = {serve};
+  std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+  std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+  tags.emplace_back(player, std::vector<std::string>{"name", "age", "avgScore"});
+  edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+
+  // The first request fills the cache, and the second one is served by it
+  uint64_t version = 0;
+  for (int32_t i = 0; i < 2; i++) {
+    auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+
+    ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    // vId, stat, player, serve, expr
+    QueryTestUtils::checkResponse(*resp.vertices_ref(), vertices, over, tags, edges, 1, 5);
+    ASSERT_NE(nullptr, env->adjacencyCache_->get(1, partId, vertices[0], serve, &version));
+  }
+
+  // Any edge written evicts the adjacency lists of its source vertex
+  {
+    cpp2::DeleteEdgesRequest req;
+    req.space_id_ref() = 1;
+    cpp2::EdgeKey key;
+    key.src_ref() = vertices[0];
+    key.edge_type_ref() = serve;
+    key.ranking_ref() = 0;
+    key.dst_ref() = "Not Exist";
+    (*req.parts_ref())[partId].emplace_back(std::move(key));
+
+    auto* processor = DeleteEdgesProcessor::instance(env, nullptr);
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    ASSERT_EQ(0, resp.result.failed_parts.size());
+    EXPECT_EQ(nullptr, env->adjacencyCache_->get(1, partId, vertices[0], serve, &version));
+  }
+  FLAGS_adjacency_cache_min_degree = 1000;
+}
+
+TEST(GetNeighborsTest, ProfileTest) {
+  fs::TempDir rootPath("/tmp/GetNeighborsProfileTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+  auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+  TagID player = 1;
+  EdgeType serve = 101;
+  std::vector<VertexID> vertices = {"Tim Duncan", "Tony Parker"};
+  std::vector<EdgeType> over = {serve};
+  std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+  std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+  tags.emplace_back(player, std::vector<std::string>{"name", "age", "avgScore"});
+  edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+  auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+  cpp2::RequestCommon common;
+  common.profile_detail_ref() = true;
+  req.common_ref() = std::move(common);
+
+  auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+  auto fut = processor->getFuture();
+  processor->process(req);
+  auto resp = std::move(fut).get();
+  ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+  ASSERT_TRUE(resp.result_ref()->node_profiles_ref().has_value());
+
+  std::unordered_map<std::string, cpp2::NodeProfile> profiles;
+  for (const auto& node : *resp.result_ref()->node_profiles_ref()) {
+    profiles.emplace(node.get_name(), node);
+  }
+  ASSERT_EQ(1, profiles.count("GetNeighborsNode"));
+  EXPECT_EQ(vertices.size(), profiles["GetNeighborsNode"].get_rows());
+  ASSERT_EQ(1, profiles.count("SingleEdgeNode"));
+  EXPECT_LT(0, profiles["SingleEdgeNode"].get_rows());
+  EXPECT_EQ(1, profiles["SingleEdgeNode"].get_stats().count("decode_us"));
+  ASSERT_EQ(1, profiles.count("kvstore"));
+  EXPECT_EQ(1, profiles["kvstore"].get_stats().count("block_cache_hits"));
+}
+
+TEST(GetNeighborsTest, EncodedRowsTest) {
+  fs::TempDir rootPath("/tmp/GetNeighborsEncodedRowsTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+  auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+  GraphSpaceID spaceId = 1;
+  TagID player = 1;
+  EdgeType serve = 101;
+  std::vector<VertexID> vertices = {"Tim Duncan"};
+  std::vector<EdgeType> over = {serve};
+  std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+  std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+  std::vector<std::string> props = {"name", "age", "avgScore"};
+  tags.emplace_back(player, props);
+  edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+
+  auto getNeighbors = [&](bool encodedRows) {
+    auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+    cpp2::RequestCommon common;
+    common.encoded_rows_ref() = encodedRows;
+    req.common_ref() = std::move(common);
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    return std::move(fut).get();
+  };
+  auto decodedResp = getNeighbors(false);
+  ASSERT_EQ(0, (*decodedResp.result_ref()).failed_parts.size());
+  auto encodedResp = getNeighbors(true);
+  ASSERT_EQ(0, (*encodedResp.result_ref()).failed_parts.size());
+
+  // vId, stat, player, serve, expr
+  const auto& decoded = *decodedResp.vertices_ref();
+  const auto& encoded = *encodedResp.vertices_ref();
+  ASSERT_EQ(decoded.colNames, encoded.colNames);
+  ASSERT_EQ(1, encoded.rows.size());
+  ASSERT_EQ(5, encoded.rows[0].size());
+  // The edges are the same, and the tag is sent as the row read from the store
+  EXPECT_EQ(decoded.rows[0].values[3], encoded.rows[0].values[3]);
+  ASSERT_TRUE(encoded.rows[0].values[2].isStr());
+  const auto& propList = decoded.rows[0].values[2].getList();
+  auto reader = RowReaderWrapper::getTagPropReader(
+      env->schemaMan_, spaceId, player, encoded.rows[0].values[2].getStr());
+  ASSERT_TRUE(!!reader);
+  for (size_t i = 0; i < props.size(); i++) {
+    EXPECT_EQ(propList.values[i], reader->getValueByName(props[i]));
+  }
 }
 
 }  // namespace storage
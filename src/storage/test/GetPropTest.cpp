@@ -6,7 +6,9 @@
 
 #include "common/base/Base.h"
 #include "common/fs/TempDir.h"
+#include "common/utils/BloomFilter.h"
 #include "kvstore/RocksEngineConfig.h"
+#include "kvstore/RocksReadProfiler.h"
 #include "storage/query/GetPropProcessor.h"
 #include "storage/test/QueryTestUtils.h"
 
@@ -658,6 +660,45 @@ TEST(GetPropTest, ConcurrencyTest) {
   FLAGS_query_concurrently = false;
 }
 
+TEST(GetPropTest, ConfirmLeadershipTest) {
+  fs::TempDir rootPath("/tmp/GetPropTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+  TagID player = 1;
+  std::vector<VertexID> vertices = {"Tim Duncan"};
+  std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+  tags.emplace_back(player, std::vector<std::string>{"name"});
+  auto req = buildVertexRequest(totalParts, vertices, tags);
+  // The part is not on the host, so its leadership could not be confirmed
+  PartitionID missingPart = totalParts + 1;
+  nebula::Row row;
+  row.values.emplace_back("Tony Parker");
+  (*req.parts_ref())[missingPart].emplace_back(std::move(row));
+
+  // The parts are read in place without an executor, or continued on the executor after the
+  // confirmations
+  for (auto* executor : {static_cast<folly::Executor*>(nullptr),
+                         static_cast<folly::Executor*>(threadPool.get())}) {
+    auto* processor = GetPropProcessor::instance(env, nullptr, executor);
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+
+    ASSERT_EQ(1, (*resp.result_ref()).failed_parts.size());
+    EXPECT_EQ(missingPart, (*resp.result_ref()).failed_parts[0].get_part_id());
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_PART_NOT_FOUND,
+              (*resp.result_ref()).failed_parts[0].get_code());
+    // The confirmed part is still read
+    ASSERT_EQ(1, (*resp.props_ref()).rows.size());
+    EXPECT_EQ("Tim Duncan", (*resp.props_ref()).rows[0].values[0]);
+  }
+}
+
 TEST(QueryVertexPropsTest, PrefixBloomFilterTest) {
   FLAGS_enable_rocksdb_statistics = true;
   FLAGS_enable_rocksdb_prefix_filtering = true;
@@ -969,6 +1010,82 @@ TEST(GetPropTest, LimitTest) {
   }
 }
 
+TEST(GetPropTest, ProfileReadsTest) {
+  fs::TempDir rootPath("/tmp/GetPropTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+
+  TagID player = 1;
+  std::vector<VertexID> vertices = {"Tim Duncan", "Tony Parker"};
+  std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+  tags.emplace_back(player, std::vector<std::string>{"name", "age"});
+  auto req = buildVertexRequest(totalParts, vertices, tags);
+  cpp2::RequestCommon common;
+  common.profile_detail_ref() = true;
+  req.common_ref() = std::move(common);
+
+  auto* processor = GetPropProcessor::instance(env, nullptr, nullptr);
+  auto fut = processor->getFuture();
+  processor->process(req);
+  auto resp = std::move(fut).get();
+  ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+  ASSERT_EQ(vertices.size(), resp.props_ref()->rows.size());
+
+  // The reads of rocksdb are attached to the profile as the kvstore node
+  ASSERT_TRUE(resp.result_ref()->node_profiles_ref().has_value());
+  const auto& nodes = *resp.result_ref()->node_profiles_ref();
+  auto iter = std::find_if(
+      nodes.begin(), nodes.end(), [](const auto& node) { return node.get_name() == "kvstore"; });
+  ASSERT_NE(nodes.end(), iter);
+  for (const auto& name : kvstore::RocksReadProfiler::statNames()) {
+    EXPECT_EQ(1, iter->get_stats().count(name)) << name;
+  }
+}
+
+TEST(GetPropTest, VidFilterTest) {
+  fs::TempDir rootPath("/tmp/GetPropTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+
+  TagID player = 1;
+  std::vector<VertexID> joined = {"Tim Duncan", "Tony Parker"};
+  auto filter = BloomFilter::withKeys(joined.size());
+  for (const auto& vId : joined) {
+    filter.add(vId);
+  }
+  cpp2::VidFilter vidFilter;
+  vidFilter.bits_ref() = filter.bits();
+  vidFilter.num_hashes_ref() = filter.numHashes();
+
+  std::vector<VertexID> vertices = {"Tim Duncan", "Tony Parker", "LeBron James", "Kobe Bryant"};
+  std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+  tags.emplace_back(player, std::vector<std::string>{"name"});
+  auto req = buildVertexRequest(totalParts, vertices, tags);
+  cpp2::RequestCommon common;
+  common.vid_filter_ref() = vidFilter;
+  req.common_ref() = std::move(common);
+
+  auto* processor = GetPropProcessor::instance(env, nullptr, nullptr);
+  auto fut = processor->getFuture();
+  processor->process(req);
+  auto resp = std::move(fut).get();
+
+  ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+  // Only the vertices in the filter are read
+  std::vector<VertexID> names;
+  for (const auto& row : (*resp.props_ref()).rows) {
+    names.emplace_back(row.values[1].getStr());
+  }
+  std::sort(names.begin(), names.end());
+  EXPECT_EQ(joined, names);
+}
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -0,0 +1,159 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "clients/storage/StorageClientBase.h"
+#include "common/base/Base.h"
+#include "common/thrift/ThriftLocalClientManager.h"
+#include "storage/test/ChainTestUtils.h"
+
+namespace nebula {
+namespace storage {
+
+constexpr int32_t mockSpaceId = 1;
+constexpr int32_t mockPartNum = 1;
+
+// The rpc are made by the remote functions of the tests
+class FakeClient {
+ public:
+  static std::shared_ptr<FakeClient> getInstance() {
+    static auto client = std::make_shared<FakeClient>();
+    return client;
+  }
+};
+
+using TestClientBase = StorageClientBase<FakeClient, thrift::LocalClientManager<FakeClient>>;
+
+class TestStorageClient : public TestClientBase {
+ public:
+  TestStorageClient(std::shared_ptr<folly::IOThreadPoolExecutor> threadPool,
+                    meta::MetaClient* metaClient)
+      : TestClientBase(threadPool, metaClient) {}
+
+  using TestClientBase::getResponse;
+  using TestClientBase::hedgedResponse;
+};
+
+class HedgedReadTest : public ::testing::Test {
+ protected:
+  struct Rpc {
+    int64_t delayMs;
+    bool succeeded;
+  };
+
+  void SetUp() override {
+    FLAGS_storage_client_hedge_reads = true;
+    FLAGS_storage_client_hedge_budget_percent = 100;
+    metaClient_ = MetaClientTestUpdater::makeDefault();
+    auto* spaceCache = MetaClientTestUpdater::getLocalCache(metaClient_.get(), mockSpaceId);
+    spaceCache->partsAlloc_[1] = {host1_, host2_};
+    threadPool_ = std::make_shared<folly::IOThreadPoolExecutor>(2);
+    client_ = std::make_unique<TestStorageClient>(threadPool_, metaClient_.get());
+
+    req_.space_id_ref() = mockSpaceId;
+    req_.column_names_ref() = {"_vid"};
+    req_.parts_ref() = std::unordered_map<PartitionID, std::vector<Row>>{{1, {Row({"a"})}}};
+    cpp2::RequestCommon common;
+    common.max_staleness_ms_ref() = 1000;
+    req_.common_ref() = std::move(common);
+
+    // The tail latency of the host, after which the rpc is hedged
+    auto resp = client_->getResponse(nullptr, host1_, req_, remote({{50, true}})).get();
+    ASSERT_TRUE(resp.ok());
+    calls_->store(0);
+  }
+
+  void TearDown() override {
+    client_.reset();
+    threadPool_.reset();
+  }
+
+  // The rpc made one after another respond as the given ones
+  auto remote(std::vector<Rpc> rpcs) {
+    return [calls = calls_, rpcs = std::move(rpcs)](FakeClient*,
+                                                     const cpp2::GetNeighborsRequest&) {
+      auto rpc = rpcs[std::min(calls->fetch_add(1), rpcs.size() - 1)];
+      cpp2::ResponseCommon result;
+      if (!rpc.succeeded) {
+        cpp2::PartitionResult part;
+        part.code_ref() = nebula::cpp2::ErrorCode::E_UNKNOWN;
+        part.part_id_ref() = 1;
+        result.failed_parts_ref() = {part};
+      }
+      cpp2::GetNeighborsResponse resp;
+      resp.result_ref() = std::move(result);
+      return folly::makeFuture()
+          .delayed(std::chrono::milliseconds(rpc.delayMs))
+          .thenValue([resp = std::move(resp)](auto&&) { return resp; });
+    };
+  }
+
+  bool succeeded(const StatusOr<cpp2::GetNeighborsResponse>& resp) {
+    return resp.ok() && resp.value().get_result().get_failed_parts().empty();
+  }
+
+  gflags::FlagSaver saver_;
+  HostAddr host1_{"127.0.0.1", 1};
+  HostAddr host2_{"127.0.0.1", 2};
+  std::unique_ptr<meta::MetaClient> metaClient_;
+  std::shared_ptr<folly::IOThreadPoolExecutor> threadPool_;
+  std::unique_ptr<TestStorageClient> client_;
+  cpp2::GetNeighborsRequest req_;
+  std::shared_ptr<std::atomic<size_t>> calls_ = std::make_shared<std::atomic<size_t>>(0);
+};
+
+TEST_F(HedgedReadTest, SlowHost) {
+  time::Duration duration;
+  auto resp =
+      client_->hedgedResponse(nullptr, host1_, req_, remote({{1000, true}, {0, true}})).get();
+  EXPECT_TRUE(succeeded(resp));
+  EXPECT_EQ(2, calls_->load());
+  // Taken from the replica hedging the slow host
+  EXPECT_LT(duration.elapsedInMSec(), 500);
+  // The rpc to the slow host is done before the client is gone
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+}
+
+TEST_F(HedgedReadTest, FailedBeforeHedged) {
+  // The failure of the host is not taken, the other replica is tried at once
+  auto resp = client_->hedgedResponse(nullptr, host1_, req_, remote({{0, false}, {0, true}})).get();
+  EXPECT_TRUE(succeeded(resp));
+  EXPECT_EQ(2, calls_->load());
+}
+
+TEST_F(HedgedReadTest, HedgeFailed) {
+  // The hedge fails first, so the response of the host is waited for
+  auto resp =
+      client_->hedgedResponse(nullptr, host1_, req_, remote({{300, true}, {0, false}})).get();
+  EXPECT_TRUE(succeeded(resp));
+  EXPECT_EQ(2, calls_->load());
+}
+
+TEST_F(HedgedReadTest, BothFailed) {
+  auto resp = client_->hedgedResponse(nullptr, host1_, req_, remote({{0, false}})).get();
+  ASSERT_TRUE(resp.ok());
+  EXPECT_FALSE(succeeded(resp));
+  EXPECT_EQ(2, calls_->load());
+}
+
+TEST_F(HedgedReadTest, NoOtherReplica) {
+  auto* spaceCache = MetaClientTestUpdater::getLocalCache(metaClient_.get(), mockSpaceId);
+  spaceCache->partsAlloc_[1] = {host1_};
+  auto resp = client_->hedgedResponse(nullptr, host1_, req_, remote({{0, false}})).get();
+  ASSERT_TRUE(resp.ok());
+  EXPECT_FALSE(succeeded(resp));
+  EXPECT_EQ(1, calls_->load());
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+  return RUN_ALL_TESTS();
+}
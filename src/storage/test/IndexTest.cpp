@@ -22,6 +22,7 @@
 #include "kvstore/KVEngine.h"
 #include "kvstore/KVIterator.h"
 #include "storage/exec/IndexDedupNode.h"
+#include "storage/exec/IndexIntersectNode.h"
 #include "storage/exec/IndexEdgeScanNode.h"
 #include "storage/exec/IndexLimitNode.h"
 #include "storage/exec/IndexNode.h"
@@ -423,6 +424,191 @@ TEST_F(IndexScanTest, Vertex) {
     }
   }  // End of Case 2
 }
+TEST_F(IndexScanTest, SubRange) {
+  auto rows = R"(
+    int | int
+    1   | 2
+    2   | 3
+    3   | 4
+    4   | 5
+  )"_row;
+  auto schema = R"(
+    a   | int | | false
+    b   | int | | false
+  )"_schema;
+  auto indices = R"(
+    TAG(t,1)
+    (i1,2):a
+  )"_index(schema);
+  bool hasNullableCol = schema->hasNullableCol();
+  auto kv = encodeTag(rows, 1, schema, indices);
+  auto kvstore = std::make_unique<MockKVStore>();
+  std::vector<std::string> indexKeys;
+  for (auto& item : kv[1]) {
+    kvstore->put(item.first, item.second);
+    indexKeys.emplace_back(item.first);
+  }
+  std::sort(indexKeys.begin(), indexKeys.end());
+  std::vector<ColumnHint> columnHints;
+  IndexID indexId = 0;
+  auto context = makeContext(1, 0);
+  auto scan = [&](std::optional<std::pair<std::string, std::string>> subRange) {
+    auto scanNode = std::make_unique<IndexVertexScanNode>(
+        context.get(), indexId, columnHints, kvstore.get(), hasNullableCol);
+    IndexScanTestHelper helper;
+    helper.setIndex(scanNode.get(), indices[0]);
+    helper.setTag(scanNode.get(), schema);
+    InitContext initCtx;
+    initCtx.requiredColumns = {kVid, "a"};
+    scanNode->init(initCtx);
+    if (subRange.has_value()) {
+      scanNode->setSubRange(subRange->first, subRange->second);
+    }
+    scanNode->execute(0);
+    std::vector<Value> result;
+    while (true) {
+      auto res = scanNode->next();
+      EXPECT_TRUE(res.success());
+      if (!res.hasData()) {
+        break;
+      }
+      result.emplace_back(res.row()[initCtx.retColMap["a"]]);
+    }
+    return std::make_pair(std::move(result), scanNode->keyRange(0));
+  };
+  auto [all, range] = scan(std::nullopt);
+  ASSERT_EQ(4, all.size());
+  EXPECT_LE(range.first, indexKeys.front());
+  EXPECT_GT(range.second, indexKeys.back());
+
+  // Split the range by the third key, each sub range has two of the rows
+  auto first = scan(std::make_pair(range.first, indexKeys[2])).first;
+  auto second = scan(std::make_pair(indexKeys[2], range.second)).first;
+  EXPECT_EQ((std::vector<Value>{all[0], all[1]}), first);
+  EXPECT_EQ((std::vector<Value>{all[2], all[3]}), second);
+}
+TEST_F(IndexScanTest, MultiRange) {
+  auto rows = R"(
+    int | int
+    1   | 2
+    2   | 3
+    3   | 4
+    4   | 5
+    2   | 6
+  )"_row;
+  auto schema = R"(
+    a   | int | | false
+    b   | int | | false
+  )"_schema;
+  auto indices = R"(
+    TAG(t,1)
+    (i1,2):a
+  )"_index(schema);
+  bool hasNullableCol = schema->hasNullableCol();
+  auto kv = encodeTag(rows, 1, schema, indices);
+  auto kvstore = std::make_unique<MockKVStore>();
+  for (auto& item : kv[1]) {
+    kvstore->put(item.first, item.second);
+  }
+  IndexID indexId = 0;
+  auto context = makeContext(1, 0);
+  auto scan = [&](const std::vector<std::vector<ColumnHint>>& hintsList) {
+    auto scanNode = std::make_unique<IndexVertexScanNode>(
+        context.get(), indexId, hintsList[0], kvstore.get(), hasNullableCol);
+    for (size_t i = 1; i < hintsList.size(); i++) {
+      scanNode->addColumnHints(hintsList[i]);
+    }
+    IndexScanTestHelper helper;
+    helper.setIndex(scanNode.get(), indices[0]);
+    helper.setTag(scanNode.get(), schema);
+    InitContext initCtx;
+    initCtx.requiredColumns = {kVid, "a"};
+    scanNode->init(initCtx);
+    scanNode->execute(0);
+    std::vector<Value> result;
+    while (true) {
+      auto res = scanNode->next();
+      EXPECT_TRUE(res.success());
+      if (!res.hasData()) {
+        break;
+      }
+      result.emplace_back(res.row()[initCtx.retColMap["a"]]);
+    }
+    return result;
+  };
+  // a IN [4, 2, 2], the duplicated ranges are scanned once in key order
+  auto result = scan({{makeColumnHint("a", Value(4))},
+                      {makeColumnHint("a", Value(2))},
+                      {makeColumnHint("a", Value(2))}});
+  EXPECT_EQ((std::vector<Value>{2, 2, 4}), result);
+  // a == 4 OR 1 <= a < 3, the ranges overlap
+  result = scan({{makeColumnHint("a", Value(4))},
+                 {makeColumnHint<true, false>("a", Value(1), Value(3))},
+                 {makeColumnHint("a", Value(2))}});
+  EXPECT_EQ((std::vector<Value>{1, 2, 2, 4}), result);
+  // The value not exists
+  result = scan({{makeColumnHint("a", Value(5))}, {makeColumnHint("a", Value(3))}});
+  EXPECT_EQ((std::vector<Value>{3}), result);
+}
+TEST_F(IndexScanTest, SkipScan) {
+  auto rows = R"(
+    int | int
+    1   | 2
+    1   | 3
+    2   | 2
+    3   | 1
+    3   | 2
+    3   | 5
+  )"_row;
+  auto schema = R"(
+    a   | int | | false
+    b   | int | | false
+  )"_schema;
+  auto indices = R"(
+    TAG(t,1)
+    (i1,2):a,b
+  )"_index(schema);
+  bool hasNullableCol = schema->hasNullableCol();
+  auto kv = encodeTag(rows, 1, schema, indices);
+  auto kvstore = std::make_unique<MockKVStore>();
+  for (auto& item : kv[1]) {
+    kvstore->put(item.first, item.second);
+  }
+  IndexID indexId = 0;
+  auto context = makeContext(1, 0);
+  auto scan = [&](const std::vector<ColumnHint>& hints) {
+    auto scanNode = std::make_unique<IndexVertexScanNode>(
+        context.get(), indexId, hints, kvstore.get(), hasNullableCol);
+    scanNode->setSkipScan(true);
+    IndexScanTestHelper helper;
+    helper.setIndex(scanNode.get(), indices[0]);
+    helper.setTag(scanNode.get(), schema);
+    InitContext initCtx;
+    initCtx.requiredColumns = {kVid, "a", "b"};
+    scanNode->init(initCtx);
+    scanNode->execute(0);
+    std::vector<std::pair<Value, Value>> result;
+    while (true) {
+      auto res = scanNode->next();
+      EXPECT_TRUE(res.success());
+      if (!res.hasData()) {
+        break;
+      }
+      result.emplace_back(res.row()[initCtx.retColMap["a"]], res.row()[initCtx.retColMap["b"]]);
+    }
+    return result;
+  };
+  using Result = std::vector<std::pair<Value, Value>>;
+  // b == 2 for each value of a
+  auto result = scan({makeColumnHint("b", Value(2))});
+  EXPECT_EQ((Result{{1, 2}, {2, 2}, {3, 2}}), result);
+  // 2 <= b < 5 for each value of a
+  result = scan({makeColumnHint<true, false>("b", Value(2), Value(5))});
+  EXPECT_EQ((Result{{1, 2}, {1, 3}, {2, 2}, {3, 2}}), result);
+  // The value not exists
+  result = scan({makeColumnHint("b", Value(4))});
+  EXPECT_EQ(Result{}, result);
+}
 TEST_F(IndexScanTest, Edge) {
   auto rows = R"(
     int | int | int
@@ -2119,6 +2305,64 @@ TEST_F(IndexTest, Dedup) {
   )"_row;
   ASSERT_EQ(collectResult(dedup.get()), expect);
 }
+TEST_F(IndexTest, Intersect) {
+  auto rows1 = R"(
+    int | int
+    1   | 2
+    3   | 3
+    2   | 2
+    1   | 4
+  )"_row;
+  auto rows2 = R"(
+    int | int
+    2   | 3
+    1   | 5
+    4   | 6
+  )"_row;
+  auto ctx = makeContext();
+  auto intersect =
+      std::make_unique<IndexIntersectNode>(ctx.get(), std::vector<std::string>{"a"});
+  for (auto* rows : {&rows1, &rows2}) {
+    auto child = std::make_unique<MockIndexNode>(ctx.get());
+    auto offset = std::make_shared<size_t>(0);
+    child->executeFunc = [offset](PartitionID) {
+      *offset = 0;
+      return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+    };
+    child->nextFunc = [rows, offset]() -> IndexNode::Result {
+      if (*offset < rows->size()) {
+        auto row = (*rows)[(*offset)++];
+        return IndexNode::Result(std::move(row));
+      }
+      return IndexNode::Result();
+    };
+    child->initFunc = [](InitContext& initCtx) -> ::nebula::cpp2::ErrorCode {
+      initCtx.returnColumns = {"a", "b"};
+      initCtx.retColMap = {{"a", 0}, {"b", 1}};
+      return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+    };
+    intersect->addChild(std::move(child));
+  }
+  InitContext initCtx;
+  ASSERT_EQ(::nebula::cpp2::ErrorCode::SUCCEEDED, intersect->init(initCtx));
+  ASSERT_EQ(::nebula::cpp2::ErrorCode::SUCCEEDED, intersect->execute(0));
+  std::vector<Row> result;
+  while (true) {
+    auto res = intersect->next();
+    ASSERT_TRUE(res.success());
+    if (!res.hasData()) {
+      break;
+    }
+    result.emplace_back(std::move(res).row());
+  }
+  // The rows of the first child whose keys are returned by both, each key once
+  auto expect = R"(
+    int | int
+    1   | 2
+    2   | 2
+  )"_row;
+  ASSERT_EQ(expect, result);
+}
 }  // namespace storage
 }  // namespace nebula
 int main(int argc, char** argv) {
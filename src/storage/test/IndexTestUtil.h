@@ -125,7 +125,8 @@ class MockKVStore : public ::nebula::kvstore::KVStore {
                                 const std::string& start,
                                 const std::string& end,
                                 std::unique_ptr<KVIterator>* iter,
-                                bool) override {
+                                bool,
+                                const void*) override {
     CHECK_EQ(spaceId, spaceId_);
     std::unique_ptr<MockKVIterator> mockIter;
     mockIter = std::make_unique<MockKVIterator>(kv_, kv_.lower_bound(start));
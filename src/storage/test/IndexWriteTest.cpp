@@ -9,12 +9,14 @@
 #include "common/base/Base.h"
 #include "common/fs/TempDir.h"
 #include "common/utils/NebulaKeyUtils.h"
+#include "common/utils/OperationKeyUtils.h"
 #include "interface/gen-cpp2/common_types.h"
 #include "interface/gen-cpp2/storage_types.h"
 #include "mock/AdHocIndexManager.h"
 #include "mock/AdHocSchemaManager.h"
 #include "mock/MockCluster.h"
 #include "mock/MockData.h"
+#include "storage/index/IndexLogApplier.h"
 #include "storage/index/LookupProcessor.h"
 #include "storage/mutate/AddEdgesProcessor.h"
 #include "storage/mutate/AddVerticesProcessor.h"
@@ -482,6 +484,98 @@ TEST(IndexTest, AlterTagIndexTest) {
   }
 }
 
+TEST(IndexTest, AsyncIndexTest) {
+  GraphSpaceID spaceId = 1;
+  TagID tagId = 111;
+  IndexID indexId = 222;
+  fs::TempDir rootPath("/tmp/AsyncIndexTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto vIdLen = env->schemaMan_->getSpaceVidLen(spaceId).value();
+
+  // Mock a tag schema and an index maintained asynchronously
+  {
+    auto* schemaMan = reinterpret_cast<mock::AdHocSchemaManager*>(env->schemaMan_);
+    schemaMan->addTagSchema(spaceId, tagId, mock::MockData::mockGeneralTagSchemaV1());
+    auto* indexMan = reinterpret_cast<mock::AdHocIndexManager*>(env->indexMan_);
+    indexMan->addTagIndex(spaceId, tagId, indexId, mock::MockData::mockGeneralTagIndexColumns());
+    meta::cpp2::IndexParams params;
+    params.async_maintain_ref() = true;
+    env->indexMan_->getTagIndex(spaceId, indexId).value()->index_params_ref() = params;
+  }
+  // The log is applied by the test instead of the background thread
+  IndexLogApplier applier(env);
+  env->indexLogApplier_ = &applier;
+
+  // verify insert
+  {
+    cpp2::AddVerticesRequest req;
+    req.space_id_ref() = spaceId;
+    req.if_not_exists_ref() = true;
+    for (auto partId = 1; partId <= 6; partId++) {
+      nebula::storage::cpp2::NewVertex newVertex;
+      nebula::storage::cpp2::NewTag newTag;
+      newTag.tag_id_ref() = tagId;
+      std::vector<Value> props;
+      props.emplace_back(Value(true));
+      props.emplace_back(Value(1L));
+      props.emplace_back(Value(1.1f));
+      props.emplace_back(Value(1.1f));
+      props.emplace_back(Value("string"));
+      newTag.props_ref() = std::move(props);
+      std::vector<nebula::storage::cpp2::NewTag> newTags;
+      newTags.push_back(std::move(newTag));
+      newVertex.id_ref() = convertVertexId(vIdLen, partId);
+      newVertex.tags_ref() = std::move(newTags);
+      (*req.parts_ref())[partId].emplace_back(std::move(newVertex));
+    }
+    auto* processor = AddVerticesProcessor::instance(env, nullptr);
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, resp.result.failed_parts.size());
+
+    LOG(INFO) << "Check the index is written by the applier...";
+    for (auto partId = 1; partId <= 6; partId++) {
+      auto indexPrefix = IndexKeyUtils::indexPrefix(partId, indexId);
+      auto opPrefix = OperationKeyUtils::operationPrefix(partId);
+      EXPECT_EQ(0, verifyResultNum(spaceId, partId, indexPrefix, env->kvstore_));
+      EXPECT_EQ(1, verifyResultNum(spaceId, partId, opPrefix, env->kvstore_));
+
+      auto ret = applier.applyOnce(spaceId, partId);
+      ASSERT_TRUE(nebula::ok(ret));
+      EXPECT_EQ(0, nebula::value(ret));
+      EXPECT_EQ(1, verifyResultNum(spaceId, partId, indexPrefix, env->kvstore_));
+      EXPECT_EQ(0, verifyResultNum(spaceId, partId, opPrefix, env->kvstore_));
+    }
+  }
+  // verify delete
+  {
+    auto* processor = DeleteVerticesProcessor::instance(env, nullptr);
+    cpp2::DeleteVerticesRequest req;
+    req.space_id_ref() = spaceId;
+    for (auto partId = 1; partId <= 6; partId++) {
+      std::vector<Value> vertices;
+      vertices.emplace_back(Value(convertVertexId(vIdLen, partId)));
+      (*req.parts_ref())[partId] = std::move(vertices);
+    }
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, resp.result.failed_parts.size());
+
+    LOG(INFO) << "Check the index is deleted once the log is applied...";
+    for (auto partId = 1; partId <= 6; partId++) {
+      auto indexPrefix = IndexKeyUtils::indexPrefix(partId, indexId);
+      EXPECT_EQ(1, verifyResultNum(spaceId, partId, indexPrefix, env->kvstore_));
+      EXPECT_TRUE(applier.waitApplied(spaceId, partId, 1000));
+      EXPECT_EQ(0, verifyResultNum(spaceId, partId, indexPrefix, env->kvstore_));
+    }
+  }
+  env->indexLogApplier_ = nullptr;
+}
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -0,0 +1,144 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include "storage/query/GetNeighborsProcessor.h"
+#include "storage/query/KHopGetNeighborsProcessor.h"
+#include "storage/test/ChainTestUtils.h"
+#include "storage/test/QueryTestUtils.h"
+
+namespace nebula {
+namespace storage {
+
+constexpr int32_t mockSpaceId = 1;
+constexpr int32_t mockPartNum = 1;
+
+class KHopGetNeighborsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rootPath_ = std::make_unique<fs::TempDir>("/tmp/KHopGetNeighborsTest.XXXXXX");
+    cluster_.initStorageKV(rootPath_->path());
+    env_ = cluster_.storageEnv_.get();
+    totalParts_ = cluster_.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env_, totalParts_));
+    ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env_, totalParts_));
+    threadPool_ = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+    // The parts of the space, which the destinations are hashed into
+    metaClient_ = MetaClientTestUpdater::makeDefault();
+    spaceCache_ = MetaClientTestUpdater::getLocalCache(metaClient_.get(), mockSpaceId);
+    spaceCache_->partsAlloc_.clear();
+    for (PartitionID partId = 1; partId <= totalParts_; ++partId) {
+      spaceCache_->partsAlloc_[partId] = {HostAddr("", 0)};
+    }
+    env_->metaClient_ = metaClient_.get();
+
+    tags_.emplace_back(1, std::vector<std::string>{"name"});
+    edges_.emplace_back(kTeammate, std::vector<std::string>{"teamName", "startYear"});
+  }
+
+  // The rows of the neighbors ordered by the vids
+  static std::vector<Row> sorted(const DataSet& ds) {
+    auto rows = ds.rows;
+    std::sort(rows.begin(), rows.end(), [](const Row& lhs, const Row& rhs) {
+      return lhs.values[0].getStr() < rhs.values[0].getStr();
+    });
+    return rows;
+  }
+
+  // The neighbors of the vertices by one step of GetNeighbors
+  std::vector<Row> neighborsOf(const std::vector<VertexID>& vertices) {
+    auto req = QueryTestUtils::buildRequest(totalParts_, vertices, {kTeammate}, tags_, edges_);
+    auto* processor = GetNeighborsProcessor::instance(env_, nullptr, threadPool_.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    return sorted(*resp.vertices_ref());
+  }
+
+  cpp2::KHopGetNeighborsResponse kHop(const std::vector<VertexID>& vertices, int32_t steps) {
+    auto gnReq = QueryTestUtils::buildRequest(totalParts_, vertices, {kTeammate}, tags_, edges_);
+    cpp2::KHopGetNeighborsRequest req;
+    req.space_id_ref() = gnReq.get_space_id();
+    req.column_names_ref() = gnReq.get_column_names();
+    req.parts_ref() = gnReq.get_parts();
+    req.traverse_spec_ref() = gnReq.get_traverse_spec();
+    req.steps_ref() = steps;
+    auto* processor = KHopGetNeighborsProcessor::instance(env_, nullptr, threadPool_.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    return std::move(fut).get();
+  }
+
+  static constexpr EdgeType kTeammate = 102;
+
+  std::unique_ptr<fs::TempDir> rootPath_;
+  // Outlives the cluster which refers to it
+  std::unique_ptr<meta::MetaClient> metaClient_;
+  mock::MockCluster cluster_;
+  StorageEnv* env_{nullptr};
+  int32_t totalParts_{0};
+  std::shared_ptr<folly::IOThreadPoolExecutor> threadPool_;
+  meta::SpaceInfoCache* spaceCache_{nullptr};
+  std::vector<std::pair<TagID, std::vector<std::string>>> tags_;
+  std::vector<std::pair<EdgeType, std::vector<std::string>>> edges_;
+};
+
+TEST_F(KHopGetNeighborsTest, ExpandSteps) {
+  {
+    // The same as GetNeighbors
+    auto resp = kHop({"Tim Duncan"}, 1);
+    ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    EXPECT_EQ(neighborsOf({"Tim Duncan"}), sorted(*resp.vertices_ref()));
+    EXPECT_FALSE(resp.pending_ref().has_value());
+  }
+  {
+    // Tim Duncan => Tony Parker, Manu Ginobili
+    auto resp = kHop({"Tim Duncan"}, 2);
+    ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    EXPECT_EQ(neighborsOf({"Manu Ginobili", "Tony Parker"}), sorted(*resp.vertices_ref()));
+    EXPECT_FALSE(resp.pending_ref().has_value());
+  }
+  {
+    // Tony Parker, Manu Ginobili => Tim Duncan, Manu Ginobili, Tony Parker, each expanded once
+    auto resp = kHop({"Tim Duncan"}, 3);
+    ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    EXPECT_EQ(neighborsOf({"Manu Ginobili", "Tim Duncan", "Tony Parker"}),
+              sorted(*resp.vertices_ref()));
+    EXPECT_FALSE(resp.pending_ref().has_value());
+  }
+  {
+    // No teammate to expand
+    auto resp = kHop({"Spurs"}, 2);
+    ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    EXPECT_TRUE((*resp.vertices_ref()).rows.empty());
+  }
+  {
+    auto resp = kHop({"Tim Duncan"}, 0);
+    ASSERT_EQ(1, (*resp.result_ref()).failed_parts.size());
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_INVALID_PARM,
+              (*resp.result_ref()).failed_parts.front().get_code());
+  }
+}
+
+TEST_F(KHopGetNeighborsTest, PendingSplitVertex) {
+  // The edges of a split vertex are spread among its parts, so it's left to graphd
+  spaceCache_->spaceDesc_.split_vertices_ref() =
+      std::map<std::string, int32_t>{{"Manu Ginobili", 2}};
+  auto resp = kHop({"Tim Duncan"}, 2);
+  ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+  EXPECT_EQ(neighborsOf({"Tony Parker"}), sorted(*resp.vertices_ref()));
+  ASSERT_TRUE(resp.pending_ref().has_value());
+  // Pending after the first hop
+  std::unordered_map<int32_t, std::vector<Value>> expected = {{1, {"Manu Ginobili"}}};
+  EXPECT_EQ(expected, *resp.pending_ref());
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -87,6 +87,57 @@ TEST_F(KillQueryTest, GetNeighbors) {
     ASSERT_EQ(part.get_code(), ::nebula::cpp2::ErrorCode::E_PLAN_IS_KILLED);
   }
 }
+TEST_F(KillQueryTest, GetNeighborsCoalesced) {
+  auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(1);
+  auto totalParts = cluster_->getTotalParts();
+  auto env = cluster_->storageEnv_.get();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+  TagID player = 1;
+  EdgeType serve = 101;
+  std::vector<VertexID> vertices = {"Tim Duncan"};
+  std::vector<EdgeType> over = {serve};
+  std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+  std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+  tags.emplace_back(player, std::vector<std::string>{"name", "age", "avgScore"});
+  edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+
+  // The request coalesced from the plans of two queries
+  auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+  cpp2::RequestCommon common;
+  common.session_id_ref() = 1;
+  common.plan_id_ref() = 1;
+  std::vector<cpp2::PlanID> plans(2);
+  plans[0].session_id_ref() = 1;
+  plans[0].plan_id_ref() = 1;
+  plans[1].session_id_ref() = 2;
+  plans[1].plan_id_ref() = 1;
+  common.coalesced_plans_ref() = std::move(plans);
+  req.common_ref() = common;
+
+  // Keeps running as long as one of the queries is not killed
+  client_->killQuery(1, 1);
+  {
+    auto processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    ASSERT_EQ(0, resp.get_result().get_failed_parts().size());
+  }
+
+  client_->killQuery(2, 1);
+  {
+    auto processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    ASSERT_EQ(req.get_parts().size(), resp.get_result().get_failed_parts().size());
+    for (auto& part : resp.get_result().get_failed_parts()) {
+      ASSERT_EQ(part.get_code(), ::nebula::cpp2::ErrorCode::E_PLAN_IS_KILLED);
+    }
+  }
+}
+
 TEST_F(KillQueryTest, TagIndex) {
   auto env = cluster_->storageEnv_.get();
   GraphSpaceID spaceId = 1;
@@ -59,6 +59,30 @@ BENCHMARK_RELATIVE(StringKey) {
   pool->join();
 }
 
+// Update the same few keys concurrently, which is the case of hot counters
+void forHotKeys(TupleLock* lock, int64_t i) noexcept {
+  auto key = std::make_tuple(1, static_cast<int32_t>(i % 8), 1, std::string("hot"));
+  nebula::MemoryLockGuard<Tuple> lg(lock, std::vector<Tuple>{key});
+}
+
+BENCHMARK(HotKeysSingleShard) {
+  auto lock = std::make_unique<TupleLock>(1);
+  auto pool = std::make_unique<ThreadPool>(FLAGS_num_threads);
+  for (auto i = 0; i < FLAGS_total_spaces * 100; ++i) {
+    pool->add(std::bind(forHotKeys, lock.get(), i));
+  }
+  pool->join();
+}
+
+BENCHMARK_RELATIVE(HotKeysSharded) {
+  auto lock = std::make_unique<TupleLock>();
+  auto pool = std::make_unique<ThreadPool>(FLAGS_num_threads);
+  for (auto i = 0; i < FLAGS_total_spaces * 100; ++i) {
+    pool->add(std::bind(forHotKeys, lock.get(), i));
+  }
+  pool->join();
+}
+
 }  // namespace storage
 }  // namespace nebula
 
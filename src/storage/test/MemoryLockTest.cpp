@@ -122,6 +122,49 @@ TEST_F(MemoryLockTest, DedupTest) {
   EXPECT_EQ(0, mlock.size());
 }
 
+TEST_F(MemoryLockTest, ShardTest) {
+  MemoryLockCore<std::string> mlock(4);
+  std::vector<std::string> keys;
+  for (int i = 0; i < 100; i++) {
+    keys.emplace_back(folly::to<std::string>(i));
+  }
+  {
+    LockGuard lk(&mlock, keys);
+    EXPECT_TRUE(lk);
+    EXPECT_EQ(100, mlock.size());
+    EXPECT_TRUE(mlock.contains("50"));
+
+    // The keys of other shards locked before the conflict key are rolled back
+    LockGuard lk2(&mlock, std::vector<std::string>{"a", "b", "c", "d", "e", "f", "50"});
+    EXPECT_FALSE(lk2);
+    EXPECT_EQ("50", lk2.conflictKey());
+    EXPECT_EQ(100, mlock.size());
+  }
+  EXPECT_EQ(0, mlock.size());
+  EXPECT_FALSE(mlock.contains("50"));
+}
+
+TEST_F(MemoryLockTest, WaitTest) {
+  MemoryLockCore<std::string> mlock;
+  {
+    EXPECT_TRUE(mlock.try_lock("1"));
+    // Not unlocked in time
+    LockGuard lk(&mlock, std::vector<std::string>{"1"}, false, true, std::chrono::milliseconds(10));
+    EXPECT_FALSE(lk);
+  }
+  {
+    std::thread t([&mlock]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      mlock.unlock("1");
+    });
+    LockGuard lk(
+        &mlock, std::vector<std::string>{"1", "2"}, false, true, std::chrono::seconds(10));
+    EXPECT_TRUE(lk);
+    t.join();
+  }
+  EXPECT_EQ(0, mlock.size());
+}
+
 }  // namespace storage
 }  // namespace nebula
 
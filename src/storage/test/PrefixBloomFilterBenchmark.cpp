@@ -14,6 +14,7 @@
 #include "mock/MockCluster.h"
 
 DEFINE_int64(vertex_per_part, 100, "vertex count with each partition");
+DEFINE_int32(edge_type_num, 10, "edge type count of each vertex");
 
 namespace nebula {
 namespace storage {
@@ -64,6 +65,79 @@ void testPrefixSeek(StorageEnv* env, int32_t partCount, int32_t iters) {
   }
 }
 
+// The edges of each type are flushed into their own sst files
+void mockEdgeData(StorageEnv* env, int32_t partCount) {
+  LOG(INFO) << "Prepare edge data...";
+  size_t vIdLen = 16;
+  GraphSpaceID spaceId = 1;
+  for (EdgeType edgeType = 101; edgeType <= 100 + FLAGS_edge_type_num; edgeType++) {
+    for (PartitionID partId = 1; partId <= partCount; partId++) {
+      std::vector<kvstore::KV> data;
+      for (int32_t vertexId = partId * FLAGS_vertex_per_part;
+           vertexId < (partId + 1) * FLAGS_vertex_per_part;
+           vertexId++) {
+        for (int32_t dst = 0; dst < 10; dst++) {
+          auto key = NebulaKeyUtils::edgeKey(
+              vIdLen, partId, std::to_string(vertexId), edgeType, 0, std::to_string(dst));
+          data.emplace_back(std::move(key), folly::stringPrintf("%d_%d", vertexId, dst));
+        }
+      }
+      folly::Baton<true, std::atomic> baton;
+      env->kvstore_->asyncMultiPut(
+          spaceId, partId, std::move(data), [&](nebula::cpp2::ErrorCode code) {
+            ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+            baton.post();
+          });
+      baton.wait();
+    }
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, env->kvstore_->flush(spaceId));
+  }
+}
+
+// Read the edges of one type of each vertex, as GetNeighbors over one edge type does
+void testEdgePrefixSeek(StorageEnv* env, int32_t partCount, int32_t iters) {
+  size_t vIdLen = 16;
+  GraphSpaceID spaceId = 1;
+  EdgeType edgeType = 101;
+  for (decltype(iters) i = 0; i < iters; i++) {
+    for (PartitionID partId = 1; partId <= partCount; partId++) {
+      for (int32_t vertexId = partId * FLAGS_vertex_per_part;
+           vertexId < (partId + 1) * FLAGS_vertex_per_part;
+           vertexId++) {
+        auto prefix =
+            NebulaKeyUtils::edgePrefix(vIdLen, partId, std::to_string(vertexId), edgeType);
+        std::unique_ptr<kvstore::KVIterator> iter;
+        auto code = env->kvstore_->prefix(spaceId, partId, prefix, &iter);
+        ASSERT_EQ(code, nebula::cpp2::ErrorCode::SUCCEEDED);
+        CHECK(iter->valid());
+        iter->next();
+      }
+    }
+  }
+}
+
+void benchmarkEdgePrefix(int32_t n, bool edgeTypeFilter, const std::string& filterPolicy) {
+  folly::BenchmarkSuspender braces;
+  FLAGS_rocksdb_column_family_options = R"({
+        "level0_file_num_compaction_trigger":"100"
+    })";
+  FLAGS_enable_rocksdb_prefix_filtering = true;
+  FLAGS_rocksdb_edge_type_prefix_filter = edgeTypeFilter;
+  FLAGS_rocksdb_filter_policy = filterPolicy;
+  FLAGS_rocksdb_block_cache = 0;
+  fs::TempDir rootPath("/tmp/GetPropTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto partCount = cluster.getTotalParts();
+  auto* env = cluster.storageEnv_.get();
+  mockEdgeData(env, partCount);
+  braces.dismiss();
+  testEdgePrefixSeek(env, partCount, n);
+  braces.rehire();
+  FLAGS_rocksdb_edge_type_prefix_filter = false;
+  FLAGS_rocksdb_filter_policy = "bloom";
+}
+
 BENCHMARK(PrefixWithFilterOff, n) {
   folly::BenchmarkSuspender braces;
   FLAGS_rocksdb_column_family_options = R"({
@@ -97,6 +171,20 @@ BENCHMARK_RELATIVE(PrefixWithFilterOn, n) {
   testPrefixSeek(env, partCount, n);
 }
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(EdgePrefixWithVertexFilter, n) {
+  benchmarkEdgePrefix(n, false, "bloom");
+}
+
+BENCHMARK_RELATIVE(EdgePrefixWithEdgeTypeFilter, n) {
+  benchmarkEdgePrefix(n, true, "bloom");
+}
+
+BENCHMARK_RELATIVE(EdgePrefixWithEdgeTypeRibbonFilter, n) {
+  benchmarkEdgePrefix(n, true, "ribbon");
+}
+
 }  // namespace storage
 }  // namespace nebula
 
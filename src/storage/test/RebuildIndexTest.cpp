@@ -9,6 +9,7 @@
 #include "common/fs/TempDir.h"
 #include "mock/MockCluster.h"
 #include "mock/MockData.h"
+#include "storage/StorageFlags.h"
 #include "storage/admin/AdminTaskManager.h"
 #include "storage/admin/RebuildEdgeIndexTask.h"
 #include "storage/admin/RebuildTagIndexTask.h"
@@ -576,6 +577,71 @@ TEST_F(RebuildIndexTest, RebuildEdgeIndex) {
   }
 }
 
+// Scan the parts in several ranges of a snapshot
+TEST_F(RebuildIndexTest, RebuildTagIndexConcurrently) {
+  FLAGS_rebuild_index_part_concurrency = 4;
+  // Add Vertices
+  {
+    auto* processor = AddVerticesProcessor::instance(RebuildIndexTest::env_, nullptr);
+    cpp2::AddVerticesRequest req = mock::MockData::mockAddVerticesReq();
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, resp.result.failed_parts.size());
+  }
+
+  cpp2::TaskPara parameter;
+  parameter.space_id_ref() = 1;
+  std::vector<PartitionID> parts = {1, 2, 3, 4, 5, 6};
+  parameter.parts_ref() = parts;
+  parameter.task_specific_paras_ref() = {"4", "5"};
+
+  cpp2::AddTaskRequest request;
+  request.job_type_ref() = meta::cpp2::JobType::REBUILD_TAG_INDEX;
+  request.job_id_ref() = ++gJobId;
+  request.task_id_ref() = 19;
+  request.para_ref() = std::move(parameter);
+
+  auto callback = [](nebula::cpp2::ErrorCode, nebula::meta::cpp2::StatsItem&) {};
+  TaskContext context(request, callback);
+
+  auto task = std::make_shared<RebuildTagIndexTask>(RebuildIndexTest::env_, std::move(context));
+  manager_->addAsyncTask(task);
+
+  // Wait for the task finished
+  do {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  } while (!manager_->isFinished(context.jobId_, context.taskId_));
+
+  // Every vertex is indexed once, no matter which range it is in
+  int indexDataNum = 0;
+  for (auto part : parts) {
+    auto prefix = IndexKeyUtils::indexPrefix(part);
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto ret = RebuildIndexTest::env_->kvstore_->prefix(1, part, prefix, &iter);
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, ret);
+    while (iter && iter->valid()) {
+      indexDataNum++;
+      iter->next();
+    }
+  }
+  EXPECT_EQ(162, indexDataNum);
+
+  FLAGS_rebuild_index_part_concurrency = 1;
+  RebuildIndexTest::env_->rebuildIndexGuard_->clear();
+  sleep(1);
+
+  // Delete vertices
+  {
+    auto* processor = DeleteVerticesProcessor::instance(RebuildIndexTest::env_, nullptr);
+    cpp2::DeleteVerticesRequest req = mock::MockData::mockDeleteVerticesReq();
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, resp.result.failed_parts.size());
+  }
+}
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -0,0 +1,136 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/executors/ScopedEventBaseThread.h>
+#include <gtest/gtest.h>
+
+#include "clients/storage/RequestCoalescer.h"
+#include "common/base/Base.h"
+
+namespace nebula {
+namespace storage {
+
+// Answers each vertex requested with a row of its vid, and records the requests sent
+class FakeClient {
+ public:
+  folly::Future<cpp2::GetNeighborsResponse> future_getNeighbors(
+      const cpp2::GetNeighborsRequest& req) {
+    sent.emplace_back(req);
+    DataSet data({"_vid"});
+    for (const auto& part : req.get_parts()) {
+      for (const auto& row : part.second) {
+        data.emplace_back(Row({row.values.front()}));
+      }
+    }
+    cpp2::GetNeighborsResponse resp;
+    resp.result_ref() = cpp2::ResponseCommon();
+    resp.vertices_ref() = std::move(data);
+    return folly::makeFuture(std::move(resp));
+  }
+
+  folly::Future<cpp2::GetPropResponse> future_getProps(const cpp2::GetPropRequest&) {
+    return folly::makeFuture(cpp2::GetPropResponse());
+  }
+
+  std::vector<cpp2::GetNeighborsRequest> sent;
+};
+
+static cpp2::GetNeighborsRequest buildRequest(const std::vector<std::string>& vids,
+                                              SessionID sessionId,
+                                              ExecutionPlanID planId,
+                                              int64_t timeoutMs) {
+  cpp2::GetNeighborsRequest req;
+  req.space_id_ref() = 1;
+  req.column_names_ref() = {"_vid"};
+  std::unordered_map<PartitionID, std::vector<Row>> parts;
+  for (const auto& vid : vids) {
+    parts[1].emplace_back(Row({vid}));
+  }
+  req.parts_ref() = std::move(parts);
+  req.traverse_spec_ref() = cpp2::TraverseSpec();
+  cpp2::RequestCommon common;
+  common.session_id_ref() = sessionId;
+  common.plan_id_ref() = planId;
+  common.timeout_ms_ref() = timeoutMs;
+  req.common_ref() = std::move(common);
+  return req;
+}
+
+static std::vector<std::string> vidsOf(const cpp2::GetNeighborsResponse& resp) {
+  std::vector<std::string> vids;
+  for (const auto& row : resp.get_vertices()->rows) {
+    vids.emplace_back(row.values.front().getStr());
+  }
+  std::sort(vids.begin(), vids.end());
+  return vids;
+}
+
+TEST(RequestCoalescerTest, CoalesceQueries) {
+  gflags::FlagSaver saver;
+  FLAGS_storage_client_coalesce_window_us = 1;
+  RequestCoalescer<FakeClient> coalescer;
+  FakeClient client;
+  folly::ScopedEventBaseThread thread;
+
+  folly::Future<cpp2::GetNeighborsResponse> f1 = folly::makeFuture(cpp2::GetNeighborsResponse());
+  folly::Future<cpp2::GetNeighborsResponse> f2 = folly::makeFuture(cpp2::GetNeighborsResponse());
+  thread.getEventBase()->runInEventBaseThreadAndWait([&]() {
+    f1 = coalescer.getNeighbors(&client, buildRequest({"a", "b"}, 1, 10, 100));
+    f2 = coalescer.getNeighbors(&client, buildRequest({"b", "c"}, 2, 20, 200));
+  });
+  auto resp1 = std::move(f1).get();
+  auto resp2 = std::move(f2).get();
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), vidsOf(resp1));
+  EXPECT_EQ((std::vector<std::string>{"b", "c"}), vidsOf(resp2));
+
+  ASSERT_EQ(1, client.sent.size());
+  const auto& merged = client.sent.front();
+  EXPECT_EQ(3, merged.get_parts().at(1).size());
+  // The merged request carries the plans of both queries and runs as long as the longest one
+  ASSERT_TRUE(merged.common_ref().has_value());
+  const auto& common = *merged.common_ref();
+  EXPECT_EQ(1, common.session_id_ref().value_or(0));
+  EXPECT_EQ(10, common.plan_id_ref().value_or(0));
+  EXPECT_EQ(200, common.timeout_ms_ref().value_or(0));
+  ASSERT_TRUE(common.coalesced_plans_ref().has_value());
+  const auto& plans = *common.coalesced_plans_ref();
+  ASSERT_EQ(2, plans.size());
+  EXPECT_EQ(1, plans[0].get_session_id());
+  EXPECT_EQ(10, plans[0].get_plan_id());
+  EXPECT_EQ(2, plans[1].get_session_id());
+  EXPECT_EQ(20, plans[1].get_plan_id());
+}
+
+TEST(RequestCoalescerTest, SingleRequest) {
+  gflags::FlagSaver saver;
+  FLAGS_storage_client_coalesce_window_us = 1;
+  RequestCoalescer<FakeClient> coalescer;
+  FakeClient client;
+  folly::ScopedEventBaseThread thread;
+
+  folly::Future<cpp2::GetNeighborsResponse> f = folly::makeFuture(cpp2::GetNeighborsResponse());
+  thread.getEventBase()->runInEventBaseThreadAndWait(
+      [&]() { f = coalescer.getNeighbors(&client, buildRequest({"a"}, 1, 10, 100)); });
+  auto resp = std::move(f).get();
+  EXPECT_EQ((std::vector<std::string>{"a"}), vidsOf(resp));
+
+  // A request sent alone is sent as it is
+  ASSERT_EQ(1, client.sent.size());
+  const auto& common = *client.sent.front().common_ref();
+  EXPECT_EQ(1, common.session_id_ref().value_or(0));
+  EXPECT_EQ(10, common.plan_id_ref().value_or(0));
+  EXPECT_EQ(100, common.timeout_ms_ref().value_or(0));
+  EXPECT_FALSE(common.coalesced_plans_ref().has_value());
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,115 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <folly/synchronization/Baton.h>
+
+#include "common/base/Base.h"
+#include "common/thread/NumaTopology.h"
+#include "mock/AdHocSchemaManager.h"
+#include "storage/ResourceGroups.h"
+
+namespace nebula {
+namespace storage {
+
+TEST(ResourceGroupsTest, PickTest) {
+  gflags::FlagSaver saver;
+  // The bad items are skipped
+  FLAGS_storage_resource_groups = "oltp:2, batch:1:2,bad,bad:0,bad:1:-1";
+  FLAGS_space_resource_groups = "1:batch,2:unknown";
+  mock::AdHocSchemaManager schemaMan;
+  StorageEnv env;
+  env.schemaMan_ = &schemaMan;
+  auto defaultPool = ResourceGroups::makePool("reader-pool", 1);
+  ResourceGroups groups({defaultPool}, &env);
+
+  auto* defaultGroup = groups.group(ResourceGroups::kDefaultGroup);
+  auto* oltp = groups.group("oltp");
+  auto* batch = groups.group("batch");
+  ASSERT_NE(nullptr, defaultGroup);
+  ASSERT_NE(nullptr, oltp);
+  ASSERT_NE(nullptr, batch);
+  EXPECT_EQ(nullptr, groups.group("bad"));
+  EXPECT_EQ(defaultPool.get(), defaultGroup->executor());
+  // Not NUMA aware
+  EXPECT_EQ(-1, groups.numaNode(1, 1));
+
+  // The group of the space, the name of space 1 is "1" in the mock
+  EXPECT_EQ(batch, groups.pick(1, nullptr));
+  EXPECT_EQ(defaultGroup, groups.pick(2, nullptr));
+  EXPECT_EQ(defaultGroup, groups.pick(3, nullptr));
+  // The group in the request takes precedence
+  std::string name = "oltp";
+  EXPECT_EQ(oltp, groups.pick(1, &name));
+  name = "unknown";
+  EXPECT_EQ(batch, groups.pick(1, &name));
+
+  cpp2::GetPropRequest req;
+  req.space_id_ref() = 1;
+  EXPECT_EQ(batch, groups.pick(req));
+  cpp2::RequestCommon common;
+  common.resource_group_ref() = "oltp";
+  req.common_ref() = std::move(common);
+  EXPECT_EQ(oltp, groups.pick(req));
+}
+
+TEST(ResourceGroupsTest, AdmitTest) {
+  gflags::FlagSaver saver;
+  FLAGS_storage_resource_groups = "batch:1:2";
+  FLAGS_space_resource_groups = "";
+  ResourceGroups groups(ResourceGroups::makePools("reader-pool", 1), nullptr);
+
+  auto* batch = groups.group("batch");
+  ASSERT_NE(nullptr, batch);
+  EXPECT_TRUE(batch->admit());
+  EXPECT_TRUE(batch->admit());
+  EXPECT_FALSE(batch->admit());
+  EXPECT_EQ(2, batch->inflight());
+  batch->release();
+  EXPECT_TRUE(batch->admit());
+  batch->release();
+  batch->release();
+  EXPECT_EQ(0, batch->inflight());
+
+  // The default group has no limit
+  auto* defaultGroup = groups.group(ResourceGroups::kDefaultGroup);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(defaultGroup->admit());
+  }
+}
+
+TEST(ResourceGroupsTest, NumaPoolsTest) {
+  gflags::FlagSaver saver;
+  FLAGS_numa_aware = true;
+  FLAGS_storage_resource_groups = "batch:4";
+  FLAGS_space_resource_groups = "";
+  auto numNodes = thread::NumaTopology::instance().numNodes();
+  ResourceGroups groups(ResourceGroups::makePools("reader-pool", 4), nullptr);
+
+  auto* batch = groups.group("batch");
+  ASSERT_NE(nullptr, batch);
+  // One pool per node, taken in turn when the node is unknown
+  std::set<folly::Executor*> pools;
+  for (size_t i = 0; i < numNodes; i++) {
+    pools.emplace(batch->executor());
+  }
+  EXPECT_EQ(numNodes, pools.size());
+  EXPECT_EQ(batch->executor(0), batch->executor(0));
+
+  folly::Baton<> baton;
+  batch->executor(0)->add([&baton] { baton.post(); });
+  baton.wait();
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+  return RUN_ALL_TESTS();
+}
@@ -207,6 +207,95 @@ TEST(ScanEdgeTest, CursorTest) {
   }
 }
 
+TEST(ScanEdgeTest, ScanByIndexTest) {
+  fs::TempDir rootPath("/tmp/ScanByIndexTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  // Only the keys of the index without fields, i.e. index 103 of serve, are written
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts, true, false));
+
+  EdgeType serve = 101;
+  auto edge = std::make_pair(
+      serve,
+      std::vector<std::string>{kSrc, kType, kRank, kDst, "teamName", "startYear", "endYear"});
+  for (bool byIndex : {true, false}) {
+    LOG(INFO) << "Scan one edge with limit = 5, scan_edge_by_index = " << byIndex;
+    FLAGS_scan_edge_by_index = byIndex;
+    size_t totalRowCount = 0;
+    for (PartitionID partId = 1; partId <= totalParts; partId++) {
+      bool hasNext = true;
+      std::string cursor = "";
+      while (hasNext) {
+        auto req = buildRequest({partId}, {cursor}, {edge}, 5);
+        auto* processor = ScanEdgeProcessor::instance(env, nullptr);
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+
+        ASSERT_EQ(0, resp.result.failed_parts.size());
+        checkResponse(*resp.props_ref(), edge, edge.second.size(), totalRowCount);
+        hasNext = resp.get_cursors().at(partId).next_cursor_ref().has_value();
+        if (hasNext) {
+          cursor = *resp.get_cursors().at(partId).next_cursor_ref();
+          // The cursor of a scan by index is an index key
+          EXPECT_EQ(byIndex, IndexKeyUtils::isIndexKey(cursor));
+        }
+      }
+    }
+    EXPECT_EQ(mock::MockData::serves_.size(), totalRowCount);
+  }
+  FLAGS_scan_edge_by_index = true;
+}
+
+TEST(ScanEdgeTest, ScanByIndexFallbackTest) {
+  fs::TempDir rootPath("/tmp/ScanByIndexFallbackTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts, true, false));
+
+  EdgeType serve = 101;
+  auto edge = std::make_pair(
+      serve,
+      std::vector<std::string>{kSrc, kType, kRank, kDst, "teamName", "startYear", "endYear"});
+  size_t totalRowCount = 0;
+  std::set<std::tuple<std::string, int64_t, std::string>> edges;
+  for (PartitionID partId = 1; partId <= totalParts; partId++) {
+    // The index is not used any more after the first page, whose cursor is an index key
+    FLAGS_scan_edge_by_index = true;
+    bool hasNext = true;
+    std::string cursor = "";
+    while (hasNext) {
+      auto req = buildRequest({partId}, {cursor}, {edge}, 3);
+      auto* processor = ScanEdgeProcessor::instance(env, nullptr);
+      auto f = processor->getFuture();
+      processor->process(req);
+      auto resp = std::move(f).get();
+
+      ASSERT_EQ(0, resp.result.failed_parts.size());
+      checkResponse(*resp.props_ref(), edge, edge.second.size(), totalRowCount);
+      for (const auto& row : resp.props_ref()->rows) {
+        // No edge is returned twice at the boundary of the cursor
+        auto key = std::make_tuple(
+            row.values[0].getStr(), row.values[2].getInt(), row.values[3].getStr());
+        EXPECT_TRUE(edges.emplace(std::move(key)).second);
+      }
+      hasNext = resp.get_cursors().at(partId).next_cursor_ref().has_value();
+      if (hasNext) {
+        cursor = *resp.get_cursors().at(partId).next_cursor_ref();
+        EXPECT_EQ(FLAGS_scan_edge_by_index, IndexKeyUtils::isIndexKey(cursor));
+      }
+      FLAGS_scan_edge_by_index = false;
+    }
+  }
+  // Nor is one skipped
+  EXPECT_EQ(mock::MockData::serves_.size(), totalRowCount);
+  FLAGS_scan_edge_by_index = true;
+}
+
 TEST(ScanEdgeTest, MultiplePartsTest) {
   fs::TempDir rootPath("/tmp/ScanVertexTest.XXXXXX");
   mock::MockCluster cluster;
@@ -295,6 +384,74 @@ TEST(ScanEdgeTest, LimitTest) {
   }
 }
 
+TEST(ScanEdgeTest, TopNTest) {
+  fs::TempDir rootPath("/tmp/ScanVertexTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+
+  EdgeType serve = 101;
+
+  {
+    LOG(INFO) << "Scan the top edges of one part sorted by a property";
+    constexpr std::size_t limit = 3;
+    auto edge = std::make_pair(serve, std::vector<std::string>{kSrc, kDst, "startYear"});
+    std::vector<int64_t> expected;
+    {
+      auto req = buildRequest({1}, {""}, {edge}, -1);
+      auto* processor = ScanEdgeProcessor::instance(env, nullptr);
+      auto f = processor->getFuture();
+      processor->process(req);
+      auto resp = std::move(f).get();
+      ASSERT_EQ(0, resp.result.failed_parts.size());
+      for (const auto& row : (*resp.props_ref()).rows) {
+        expected.emplace_back(row.values[2].getInt());
+      }
+      ASSERT_GT(expected.size(), limit);
+      std::sort(expected.begin(), expected.end(), std::greater<int64_t>());
+      expected.resize(limit);
+    }
+
+    auto req = buildRequest({1}, {""}, {edge}, limit);
+    cpp2::OrderBy orderBy;
+    orderBy.prop_ref() = folly::to<std::string>(serve) + ".startYear";
+    orderBy.direction_ref() = cpp2::OrderDirection::DESCENDING;
+    req.order_by_ref() = std::vector<cpp2::OrderBy>{orderBy};
+    auto* processor = ScanEdgeProcessor::instance(env, nullptr);
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+
+    ASSERT_EQ(0, resp.result.failed_parts.size());
+    std::vector<int64_t> years;
+    for (const auto& row : (*resp.props_ref()).rows) {
+      years.emplace_back(row.values[2].getInt());
+    }
+    std::sort(years.begin(), years.end(), std::greater<int64_t>());
+    EXPECT_EQ(expected, years);
+    // the whole part is scanned
+    EXPECT_FALSE((*resp.cursors_ref()).at(1).next_cursor_ref().has_value());
+  }
+  {
+    LOG(INFO) << "Scan with the order by column not returned";
+    auto edge = std::make_pair(serve, std::vector<std::string>{kSrc, kDst});
+    auto req = buildRequest({1}, {""}, {edge}, 3);
+    cpp2::OrderBy orderBy;
+    orderBy.prop_ref() = folly::to<std::string>(serve) + ".startYear";
+    orderBy.direction_ref() = cpp2::OrderDirection::ASCENDING;
+    req.order_by_ref() = std::vector<cpp2::OrderBy>{orderBy};
+    auto* processor = ScanEdgeProcessor::instance(env, nullptr);
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    ASSERT_EQ(1, resp.result.failed_parts.size());
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_EDGE_PROP_NOT_FOUND, resp.result.failed_parts[0].code);
+  }
+}
+
 TEST(ScanEdgeTest, FilterTest) {
   fs::TempDir rootPath("/tmp/ScanVertexTest.XXXXXX");
   mock::MockCluster cluster;
@@ -331,6 +331,40 @@ TEST(ScanVertexTest, LimitTest) {
   }
 }
 
+TEST(ScanVertexTest, KilledPlanTest) {
+  fs::TempDir rootPath("/tmp/ScanVertexTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  env->killedPlans_ = std::make_unique<KilledPlans>();
+  env->killedPlans_->add(10, 20);
+
+  TagID player = 1;
+  auto tag = std::make_pair(player, std::vector<std::string>{kVid, "name"});
+  for (auto planId : {20, 21}) {
+    auto req = buildRequest({2}, {""}, {tag});
+    cpp2::RequestCommon common;
+    common.session_id_ref() = 10;
+    common.plan_id_ref() = planId;
+    req.common_ref() = std::move(common);
+    auto* processor = ScanVertexProcessor::instance(env, nullptr);
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+
+    if (planId == 20) {
+      ASSERT_EQ(1, resp.result.failed_parts.size());
+      EXPECT_EQ(nebula::cpp2::ErrorCode::E_PLAN_IS_KILLED, resp.result.failed_parts[0].code);
+    } else {
+      ASSERT_EQ(0, resp.result.failed_parts.size());
+      EXPECT_FALSE(resp.props_ref()->rows.empty());
+    }
+  }
+  env->killedPlans_.reset();
+}
+
 TEST(ScanVertexTest, MultipleTagsTest) {
   fs::TempDir rootPath("/tmp/ScanVertexTest.XXXXXX");
   mock::MockCluster cluster;
@@ -390,6 +390,60 @@ TEST_F(StatsTaskTest, StatsTagAndEdgeData) {
   }
 }
 
+// The parts not changed since the last stats are not scanned again
+TEST_F(StatsTaskTest, ReuseUnchangedParts) {
+  GraphSpaceID spaceId = 1;
+  std::vector<PartitionID> parts = {1, 2, 3, 4, 5, 6};
+  auto stats = [&]() {
+    cpp2::TaskPara parameter;
+    parameter.space_id_ref() = spaceId;
+    parameter.parts_ref() = parts;
+
+    cpp2::AddTaskRequest request;
+    request.job_type_ref() = meta::cpp2::JobType::STATS;
+    request.job_id_ref() = ++gJobId;
+    request.task_id_ref() = 16;
+    request.para_ref() = std::move(parameter);
+
+    nebula::meta::cpp2::StatsItem statsItem;
+    auto callback = [&](nebula::cpp2::ErrorCode ret, nebula::meta::cpp2::StatsItem& result) {
+      if (ret == nebula::cpp2::ErrorCode::SUCCEEDED &&
+          result.get_status() == nebula::meta::cpp2::JobStatus::FINISHED) {
+        statsItem = std::move(result);
+      }
+    };
+    TaskContext context(request, callback);
+    auto task = std::make_shared<StatsTask>(StatsTaskTest::env_, std::move(context));
+    manager_->addAsyncTask(task);
+    do {
+      usleep(50);
+    } while (!manager_->isFinished(context.jobId_, context.taskId_));
+    for (int i = 0; i < 50; i++) {
+      if (statsItem.get_status() == nebula::meta::cpp2::JobStatus::FINISHED) {
+        break;
+      }
+      sleep(1);
+    }
+    EXPECT_EQ(nebula::meta::cpp2::JobStatus::FINISHED, statsItem.get_status());
+    return statsItem;
+  };
+
+  auto vertices = *stats().space_vertices_ref();
+  ASSERT_EQ(vertices, *stats().space_vertices_ref());
+
+  // Write a vertex bypassing the raft like ingesting, which is not seen until the part is evicted
+  auto vIdLen = env_->schemaMan_->getSpaceVidLen(spaceId);
+  ASSERT_TRUE(vIdLen.ok());
+  auto part = env_->kvstore_->part(spaceId, 1);
+  ASSERT_TRUE(nebula::ok(part));
+  auto key = NebulaKeyUtils::vertexKey(vIdLen.value(), 1, "ingested");
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, nebula::value(part)->engine()->put(key, ""));
+  ASSERT_EQ(vertices, *stats().space_vertices_ref());
+
+  StatsTask::evictPart(spaceId, 1);
+  ASSERT_EQ(vertices + 1, *stats().space_vertices_ref());
+}
+
 }  // namespace storage
 }  // namespace nebula
 
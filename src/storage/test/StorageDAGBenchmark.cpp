@@ -4,6 +4,7 @@
  * This source code is licensed under Apache 2.0 License.
  */
 #include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 
 #include "common/base/Base.h"
@@ -185,6 +186,35 @@ StoragePlan<std::string> chainStorageDAG() {
   return dag;
 }
 
+// A node blocked by reading, e.g. a TagNode reading the tags of a batch of vertices
+class ReadNode final : public RelNode<std::string> {
+ public:
+  explicit ReadNode(const std::string& name) : RelNode<std::string>(name) {}
+
+  nebula::cpp2::ErrorCode doExecute(PartitionID partId, const std::string& vId) override {
+    auto ret = RelNode<std::string>::doExecute(partId, vId);
+    read();
+    return ret;
+  }
+
+  static void read() {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+};
+
+// Fetch 5 tags and the edges of a vertex
+StoragePlan<std::string> readStorageDAG() {
+  StoragePlan<std::string> dag;
+  auto out = std::make_unique<RelNode<std::string>>("leaf");
+  for (size_t i = 0; i < 6; i++) {
+    auto node = std::make_unique<ReadNode>(folly::to<std::string>(i));
+    auto idx = dag.addNode(std::move(node));
+    out->addDependency(dag.getNode(idx));
+  }
+  dag.addNode(std::move(out));
+  return dag;
+}
+
 BENCHMARK(future_fanout, iters) {
   FutureDAG<std::string> dag;
   BENCHMARK_SUSPEND {
@@ -227,6 +257,46 @@ BENCHMARK_RELATIVE(recursive_chain, iters) {
   }
 }
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(serial_reads, iters) {
+  StoragePlan<std::string> dag;
+  BENCHMARK_SUSPEND {
+    dag = readStorageDAG();
+  }
+  for (size_t i = 0; i < iters; i++) {
+    dag.go(0, "readStorageDAG");
+  }
+}
+
+BENCHMARK_RELATIVE(concurrent_reads, iters) {
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor;
+  BENCHMARK_SUSPEND {
+    executor = std::make_unique<folly::CPUThreadPoolExecutor>(6);
+  }
+  for (size_t i = 0; i < iters; i++) {
+    std::vector<std::function<void()>> tasks(6, &ReadNode::read);
+    runConcurrently(executor.get(), std::move(tasks));
+  }
+  BENCHMARK_SUSPEND {
+    executor.reset();
+  }
+}
+
+BENCHMARK_RELATIVE(concurrent_reads_busy_executor, iters) {
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor;
+  BENCHMARK_SUSPEND {
+    executor = std::make_unique<folly::CPUThreadPoolExecutor>(1);
+  }
+  for (size_t i = 0; i < iters; i++) {
+    std::vector<std::function<void()>> tasks(6, &ReadNode::read);
+    runConcurrently(executor.get(), std::move(tasks));
+  }
+  BENCHMARK_SUSPEND {
+    executor.reset();
+  }
+}
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -3,6 +3,7 @@
  * This source code is licensed under Apache 2.0 License.
  */
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 
 #include "common/base/Base.h"
@@ -72,6 +73,39 @@ TEST_F(StorageDAGTest, RerunTest) {
   }
 }
 
+TEST_F(StorageDAGTest, RunConcurrentlyTest) {
+  folly::CPUThreadPoolExecutor executor(4);
+  // Run serially without the executor
+  std::vector<folly::Executor*> runners = {&executor, nullptr};
+  for (auto* runner : runners) {
+    std::atomic<size_t> count{0};
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < 100; i++) {
+      tasks.emplace_back([&count]() { ++count; });
+    }
+    runConcurrently(runner, std::move(tasks));
+    ASSERT_EQ(100, count.load());
+  }
+}
+
+TEST_F(StorageDAGTest, RunConcurrentlyThrowTest) {
+  folly::CPUThreadPoolExecutor executor(4);
+  std::atomic<size_t> count{0};
+  std::vector<std::function<void()>> tasks;
+  for (size_t i = 0; i < 10; i++) {
+    tasks.emplace_back([&count, i]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      ++count;
+      if (i % 3 == 1) {
+        throw std::runtime_error(folly::sformat("task {} failed", i));
+      }
+    });
+  }
+  // It returns once all the tasks are done, rather than waiting for the ones thrown forever
+  ASSERT_THROW(runConcurrently(&executor, std::move(tasks)), std::runtime_error);
+  ASSERT_EQ(10, count.load());
+}
+
 }  // namespace storage
 }  // namespace nebula
 
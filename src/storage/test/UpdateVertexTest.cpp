@@ -6,8 +6,10 @@
 #include <gtest/gtest.h>
 #include <rocksdb/db.h>
 
+#include "codec/CounterOperand.h"
 #include "codec/RowReader.h"
 #include "common/base/Base.h"
+#include "common/expression/ArithmeticExpression.h"
 #include "common/expression/ConstantExpression.h"
 #include "common/fs/TempDir.h"
 #include "common/utils/NebulaKeyUtils.h"
@@ -18,6 +20,8 @@
 
 DECLARE_bool(mock_ttl_col);
 DECLARE_int32(mock_ttl_duration);
+DECLARE_bool(update_counter_merge);
+DECLARE_uint32(update_lock_wait_ms);
 
 namespace nebula {
 namespace storage {
@@ -1480,6 +1484,195 @@ TEST(UpdateVertexTest, Upsert_Field_Type_And_Value_Match_Test) {
   EXPECT_EQ("America", val.getStr());
 }
 
+// games = games + 1, avgScore = avgScore - 0.5, without condition and yield
+TEST(UpdateVertexTest, Counter_Merge_Test) {
+  FLAGS_update_counter_merge = true;
+  fs::TempDir rootPath("/tmp/UpdateVertexTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto parts = cluster.getTotalParts();
+
+  GraphSpaceID spaceId = 1;
+  TagID tagId = 1;
+  auto status = env->schemaMan_->getSpaceVidLen(spaceId);
+  ASSERT_TRUE(status.ok());
+  auto spaceVidLen = status.value();
+
+  EXPECT_TRUE(mockVertexData(env, parts, spaceVidLen));
+
+  auto partId = std::hash<std::string>()("Tim Duncan") % parts + 1;
+  VertexID vertexId("Tim Duncan");
+  auto key = NebulaKeyUtils::tagKey(spaceVidLen, partId, vertexId, tagId);
+  auto readProps = [&]() {
+    std::string val;
+    auto ret = env->kvstore_->get(spaceId, partId, key, &val);
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, ret);
+    auto reader = RowReaderWrapper::getTagPropReader(env->schemaMan_, spaceId, tagId, val);
+    EXPECT_TRUE(reader);
+    return std::make_pair(reader->getValueByName("games").getInt(),
+                          reader->getValueByName("avgScore").getFloat());
+  };
+  auto origin = readProps();
+
+  auto update = [&](const VertexID& vId) {
+    cpp2::UpdateVertexRequest req;
+    req.space_id_ref() = spaceId;
+    req.part_id_ref() = std::hash<std::string>()(vId.getStr()) % parts + 1;
+    req.vertex_id_ref() = vId;
+    req.tag_id_ref() = tagId;
+
+    std::vector<cpp2::UpdatedProp> updatedProps;
+    cpp2::UpdatedProp uProp1;
+    uProp1.name_ref() = "games";
+    const auto& val1 =
+        *ArithmeticExpression::makeAdd(pool,
+                                       SourcePropertyExpression::make(pool, "1", "games"),
+                                       ConstantExpression::make(pool, 1L));
+    uProp1.value_ref() = Expression::encode(val1);
+    updatedProps.emplace_back(uProp1);
+    cpp2::UpdatedProp uProp2;
+    uProp2.name_ref() = "avgScore";
+    const auto& val2 =
+        *ArithmeticExpression::makeMinus(pool,
+                                         SourcePropertyExpression::make(pool, "1", "avgScore"),
+                                         ConstantExpression::make(pool, 0.5));
+    uProp2.value_ref() = Expression::encode(val2);
+    updatedProps.emplace_back(uProp2);
+    req.updated_props_ref() = std::move(updatedProps);
+    req.insertable_ref() = false;
+
+    auto* processor = UpdateVertexProcessor::instance(env, nullptr);
+    auto f = processor->getFuture();
+    processor->process(req);
+    return std::move(f).get();
+  };
+
+  for (int i = 0; i < 2; i++) {
+    auto resp = update(vertexId);
+    EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    EXPECT_EQ(1, (*resp.props_ref()).colNames.size());
+    EXPECT_EQ("_inserted", (*resp.props_ref()).colNames[0]);
+  }
+  auto updated = readProps();
+  EXPECT_EQ(origin.first + 2, updated.first);
+  EXPECT_DOUBLE_EQ(origin.second - 1.0, updated.second);
+
+  // The vertex must exist
+  auto resp = update(VertexID("Not Exist"));
+  EXPECT_EQ(1, (*resp.result_ref()).failed_parts.size());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND,
+            (*resp.result_ref()).failed_parts[0].get_code());
+
+  // The merge takes the lock of the row as a read-modify-write does
+  auto lockKey = std::make_tuple(spaceId, partId, tagId, vertexId.getStr());
+  ASSERT_TRUE(env->verticesML_->try_lock(lockKey));
+  auto waitMs = FLAGS_update_lock_wait_ms;
+  FLAGS_update_lock_wait_ms = 10;
+  resp = update(vertexId);
+  EXPECT_EQ(1, (*resp.result_ref()).failed_parts.size());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR,
+            (*resp.result_ref()).failed_parts[0].get_code());
+  env->verticesML_->unlock(lockKey);
+  FLAGS_update_lock_wait_ms = waitMs;
+  EXPECT_EQ(updated, readProps());
+  FLAGS_update_counter_merge = false;
+}
+
+// A merge into a missing row is skipped when the log is applied, instead of leaving an empty value
+TEST(UpdateVertexTest, Counter_Merge_Missing_Row_Test) {
+  fs::TempDir rootPath("/tmp/UpdateVertexTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto parts = cluster.getTotalParts();
+
+  GraphSpaceID spaceId = 1;
+  TagID tagId = 1;
+  auto status = env->schemaMan_->getSpaceVidLen(spaceId);
+  ASSERT_TRUE(status.ok());
+  auto spaceVidLen = status.value();
+  EXPECT_TRUE(mockVertexData(env, parts, spaceVidLen));
+
+  auto partId = std::hash<std::string>()("Tim Duncan") % parts + 1;
+  auto key = NebulaKeyUtils::tagKey(spaceVidLen, partId, "Tim Duncan", tagId);
+  auto missingKey = NebulaKeyUtils::tagKey(spaceVidLen, partId, "Not Exist", tagId);
+  std::string origin;
+  ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+            env->kvstore_->get(spaceId, partId, key, &origin));
+
+  CounterOperand operand;
+  operand.spaceId = spaceId;
+  operand.schemaId = tagId;
+  operand.deltas.emplace_back("games", 1L);
+  auto write = [&](kvstore::BatchHolder& batchHolder) {
+    folly::Baton<true, std::atomic> baton;
+    env->kvstore_->asyncAppendBatch(
+        spaceId, partId, encodeBatchValue(batchHolder.getBatch()), [&](auto code) {
+          EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+          baton.post();
+        });
+    baton.wait();
+  };
+  auto readGames = [&](const std::string& k) -> StatusOr<int64_t> {
+    std::string val;
+    auto ret = env->kvstore_->get(spaceId, partId, k, &val);
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return Status::Error("not found");
+    }
+    auto reader = RowReaderWrapper::getTagPropReader(env->schemaMan_, spaceId, tagId, val);
+    if (reader == nullptr) {
+      return Status::Error("bad row");
+    }
+    return reader->getValueByName("games").getInt();
+  };
+  auto games = readGames(key);
+  ASSERT_TRUE(games.ok());
+
+  {
+    // The row never exists
+    kvstore::BatchHolder batchHolder;
+    batchHolder.merge(std::string(missingKey), operand.encode());
+    write(batchHolder);
+    EXPECT_FALSE(readGames(missingKey).ok());
+    std::string val;
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND,
+              env->kvstore_->get(spaceId, partId, missingKey, &val));
+  }
+  {
+    // The row is put before the merge in the same batch
+    kvstore::BatchHolder batchHolder;
+    batchHolder.put(std::string(missingKey), std::string(origin));
+    batchHolder.merge(std::string(missingKey), operand.encode());
+    write(batchHolder);
+    auto merged = readGames(missingKey);
+    ASSERT_TRUE(merged.ok());
+    EXPECT_EQ(games.value() + 1, merged.value());
+  }
+  {
+    // The row is removed before the merge in the same batch
+    kvstore::BatchHolder batchHolder;
+    batchHolder.remove(std::string(key));
+    batchHolder.merge(std::string(key), operand.encode());
+    write(batchHolder);
+    std::string val;
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND,
+              env->kvstore_->get(spaceId, partId, key, &val));
+  }
+  {
+    // The rows are removed by range before the merge in the same batch
+    kvstore::BatchHolder batchHolder;
+    auto prefix = NebulaKeyUtils::tagPrefix(spaceVidLen, partId, "Not Exist");
+    batchHolder.rangeRemove(NebulaKeyUtils::firstKey(prefix, sizeof(TagID)),
+                            NebulaKeyUtils::lastKey(prefix, sizeof(TagID)));
+    batchHolder.merge(std::string(missingKey), operand.encode());
+    write(batchHolder);
+    std::string val;
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND,
+              env->kvstore_->get(spaceId, partId, missingKey, &val));
+  }
+}
+
 }  // namespace storage
 }  // namespace nebula
 
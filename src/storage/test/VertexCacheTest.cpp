@@ -0,0 +1,198 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include "storage/cache/AdjacencyList.h"
+#include "storage/cache/VertexCache.h"
+#include "storage/mutate/DeleteVerticesProcessor.h"
+#include "storage/query/GetPropProcessor.h"
+#include "storage/test/QueryTestUtils.h"
+
+namespace nebula {
+namespace storage {
+
+TEST(VertexCacheTest, SimpleTest) {
+  VertexCache cache(1024 * 1024);
+  uint64_t version = 0;
+  EXPECT_EQ(nullptr, cache.get(1, 1, "a", 1, &version));
+  cache.insert(1, 1, "a", 1, std::make_shared<const std::string>("row1"), version);
+  cache.insert(1, 1, "a", 2, std::make_shared<const std::string>("row2"), version);
+
+  auto row = cache.get(1, 1, "a", 1, &version);
+  ASSERT_NE(nullptr, row);
+  EXPECT_EQ("row1", *row);
+  row = cache.get(1, 1, "a", 2, &version);
+  ASSERT_NE(nullptr, row);
+  EXPECT_EQ("row2", *row);
+  // Different part, space or tag
+  EXPECT_EQ(nullptr, cache.get(1, 2, "a", 1, &version));
+  EXPECT_EQ(nullptr, cache.get(2, 1, "a", 1, &version));
+  EXPECT_EQ(nullptr, cache.get(1, 1, "a", 3, &version));
+  EXPECT_GT(cache.usage(1), 0);
+
+  cache.evict(1, 1, "a");
+  EXPECT_EQ(nullptr, cache.get(1, 1, "a", 1, &version));
+  EXPECT_EQ(nullptr, cache.get(1, 1, "a", 2, &version));
+  EXPECT_EQ(0, cache.usage(1));
+}
+
+TEST(VertexCacheTest, StaleInsertTest) {
+  VertexCache cache(1024 * 1024, 0);
+  uint64_t version = 0;
+  EXPECT_EQ(nullptr, cache.get(1, 1, "a", 1, &version));
+  // The vertex is written and evicted after the old row was read
+  cache.evict(1, 1, "a");
+  cache.insert(1, 1, "a", 1, std::make_shared<const std::string>("stale"), version);
+  EXPECT_EQ(nullptr, cache.get(1, 1, "a", 1, &version));
+
+  cache.insert(1, 1, "a", 1, std::make_shared<const std::string>("row"), version);
+  EXPECT_NE(nullptr, cache.get(1, 1, "a", 1, &version));
+}
+
+TEST(VertexCacheTest, CapacityTest) {
+  // Only one bucket so that the order of eviction is deterministic
+  VertexCache cache(4096, 0);
+  std::string row(100, 'x');
+  uint64_t version = 0;
+  for (int32_t i = 0; i < 100; i++) {
+    auto vId = folly::to<std::string>(i);
+    cache.get(1, 1, vId, 1, &version);
+    cache.insert(1, 1, vId, 1, std::make_shared<const std::string>(row), version);
+    EXPECT_LE(cache.usage(1), 4096);
+  }
+  // The least recently used ones are evicted
+  EXPECT_EQ(nullptr, cache.get(1, 1, "0", 1, &version));
+  EXPECT_NE(nullptr, cache.get(1, 1, "99", 1, &version));
+
+  // Too large to cache
+  cache.insert(1, 1, "large", 1, std::make_shared<const std::string>(8192, 'x'), version);
+  EXPECT_EQ(nullptr, cache.get(1, 1, "large", 1, &version));
+}
+
+TEST(VertexCacheTest, SecondChanceTest) {
+  VertexCache cache(4096, 0);
+  std::string row(100, 'x');
+  uint64_t version = 0;
+  auto fill = [&](int32_t from, int32_t to) {
+    for (int32_t i = from; i < to; i++) {
+      auto vId = folly::to<std::string>(i);
+      cache.get(1, 1, vId, 1, &version);
+      cache.insert(1, 1, vId, 1, std::make_shared<const std::string>(row), version);
+    }
+  };
+  fill(0, 10);
+  // The hit entry is skipped by the next eviction, while the older ones not hit are evicted
+  EXPECT_NE(nullptr, cache.get(1, 1, "0", 1, &version));
+  fill(10, 30);
+  EXPECT_LE(cache.usage(1), 4096);
+  EXPECT_NE(nullptr, cache.get(1, 1, "0", 1, &version));
+  EXPECT_EQ(nullptr, cache.get(1, 1, "1", 1, &version));
+  EXPECT_NE(nullptr, cache.get(1, 1, "29", 1, &version));
+}
+
+TEST(VertexCacheTest, EvictPartAndSpaceTest) {
+  VertexCache cache(1024 * 1024);
+  uint64_t version = 0;
+  for (PartitionID partId = 1; partId <= 3; partId++) {
+    for (GraphSpaceID spaceId = 1; spaceId <= 2; spaceId++) {
+      cache.get(spaceId, partId, "a", 1, &version);
+      cache.insert(spaceId, partId, "a", 1, std::make_shared<const std::string>("row"), version);
+    }
+  }
+  cache.evictPart(1, 2);
+  EXPECT_NE(nullptr, cache.get(1, 1, "a", 1, &version));
+  EXPECT_EQ(nullptr, cache.get(1, 2, "a", 1, &version));
+  EXPECT_NE(nullptr, cache.get(1, 3, "a", 1, &version));
+  EXPECT_NE(nullptr, cache.get(2, 2, "a", 1, &version));
+
+  cache.clearSpace(1);
+  EXPECT_EQ(0, cache.usage(1));
+  EXPECT_EQ(nullptr, cache.get(1, 1, "a", 1, &version));
+  EXPECT_NE(nullptr, cache.get(2, 1, "a", 1, &version));
+}
+
+TEST(VertexCacheTest, AdjacencyListTest) {
+  std::string buffer;
+  AdjacencyList::append(buffer, "key1", "val1");
+  AdjacencyList::append(buffer, "key2", "");
+  AdjacencyListIterator iter(std::make_shared<const std::string>(std::move(buffer)));
+  ASSERT_TRUE(iter.valid());
+  EXPECT_EQ("key1", iter.key());
+  EXPECT_EQ("val1", iter.val());
+  iter.next();
+  ASSERT_TRUE(iter.valid());
+  EXPECT_EQ("key2", iter.key());
+  EXPECT_EQ("", iter.val());
+  iter.next();
+  EXPECT_FALSE(iter.valid());
+}
+
+TEST(VertexCacheTest, ReadAndWriteTest) {
+  fs::TempDir rootPath("/tmp/VertexCacheTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  env->vertexCache_ = std::make_unique<VertexCache>(1024 * 1024);
+
+  GraphSpaceID spaceId = 1;
+  TagID player = 1;
+  VertexID vId = "Tim Duncan";
+  PartitionID partId = (std::hash<std::string>()(vId) % totalParts) + 1;
+
+  auto getProps = [&]() {
+    cpp2::GetPropRequest req;
+    req.space_id_ref() = spaceId;
+    (*req.parts_ref())[partId].emplace_back(Row({vId}));
+    cpp2::VertexProp vertexProp;
+    vertexProp.tag_ref() = player;
+    vertexProp.props_ref() = std::vector<std::string>{"name", "age"};
+    req.vertex_props_ref() = {vertexProp};
+
+    auto* processor = GetPropProcessor::instance(env, nullptr, nullptr);
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    return *resp.props_ref();
+  };
+
+  nebula::DataSet expected;
+  expected.colNames = {kVid, "1.name", "1.age"};
+  expected.rows.emplace_back(Row({vId, vId, 44}));
+  // The first read fills the cache, and the second one is served by it
+  EXPECT_EQ(expected, getProps());
+  uint64_t version = 0;
+  EXPECT_NE(nullptr, env->vertexCache_->get(spaceId, partId, vId, player, &version));
+  EXPECT_EQ(expected, getProps());
+
+  {
+    cpp2::DeleteVerticesRequest req;
+    req.space_id_ref() = spaceId;
+    (*req.parts_ref())[partId].emplace_back(vId);
+    auto* processor = DeleteVerticesProcessor::instance(env, nullptr);
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, resp.result.failed_parts.size());
+  }
+  EXPECT_EQ(nullptr, env->vertexCache_->get(spaceId, partId, vId, player, &version));
+  // The deleted vertex is not returned any more
+  EXPECT_EQ(0, getProps().rows.size());
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+  return RUN_ALL_TESTS();
+}
@@ -7,7 +7,6 @@
 
 #include "storage/StorageFlags.h"
 #include "storage/mutate/AddEdgesProcessor.h"
-#include "storage/transaction/ChainAddEdgesLocalProcessor.h"
 #include "storage/transaction/ConsistUtil.h"
 #include "storage/transaction/TransactionManager.h"
 
@@ -23,15 +22,8 @@ void ChainAddEdgesGroupProcessor::process(const cpp2::AddEdgesRequest& req) {
 
   auto delegateProcess = [&](auto& item) {
     auto localPartId = item.first.first;
-    auto* proc = ChainAddEdgesLocalProcessor::instance(env_);
-    proc->setRemotePartId(item.first.second);
-    proc->getFuture().thenValue([=](auto&& resp) {
-      auto code = resp.get_result().get_failed_parts().empty()
-                      ? nebula::cpp2::ErrorCode::SUCCEEDED
-                      : resp.get_result().get_failed_parts().begin()->get_code();
-      handleAsync(space, localPartId, code);
-    });
-    proc->process(item.second);
+    env_->txnMan_->addEdgesChain(item.first.second, std::move(item.second))
+        .thenValue([=](auto&& code) { handleAsync(space, localPartId, code); });
   };
 
   std::for_each(shuffledReq.begin(), shuffledReq.end(), delegateProcess);
@@ -43,7 +35,11 @@ void ChainAddEdgesGroupProcessor::shuffleRequest(const cpp2::AddEdgesRequest& re
   if (!numOfPart.ok()) {
     return;
   }
-  auto getPart = [&](auto& vid) { return env_->metaClient_->partId(numOfPart.value(), vid); };
+  // The reversed edge is in the part of dst chosen by src, in case dst is split
+  auto getPart = [&](auto& key) {
+    return env_->metaClient_->edgePart(
+        req.get_space_id(), numOfPart.value(), key.get_dst().getStr(), key.get_src().getStr());
+  };
 
   auto genNewReq = [&](auto& reqIn) {
     cpp2::AddEdgesRequest ret;
@@ -57,7 +53,7 @@ void ChainAddEdgesGroupProcessor::shuffleRequest(const cpp2::AddEdgesRequest& re
     auto& localPart = part.first;
 
     auto shuffleEdge = [&](auto&& edge) {
-      auto remotePart = getPart(edge.get_key().get_dst().getStr());
+      auto remotePart = getPart(edge.get_key());
       auto key = std::make_pair(localPart, remotePart);
       auto it = shuffledReq.find(key);
       if (it == shuffledReq.end()) {
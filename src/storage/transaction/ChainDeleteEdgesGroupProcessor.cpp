@@ -56,7 +56,8 @@ StatusOr<SplitedRequest> ChainDeleteEdgesGroupProcessor::splitRequest(
     auto localPartId = onePart.first;
     for (auto& edgeKey : onePart.second) {
       auto& remoteVid = edgeKey.get_dst().getStr();
-      auto remotePartId = env_->metaClient_->partId(partNum, remoteVid);
+      auto remotePartId = env_->metaClient_->edgePart(
+          req.get_space_id(), partNum, remoteVid, edgeKey.get_src().getStr());
       auto key = std::make_pair(localPartId, remotePartId);
       if (ret.count(key) == 0) {
         ret[key].space_id_ref() = req.get_space_id();
@@ -161,7 +161,8 @@ Code ChainDeleteEdgesLocalProcessor::checkRequest(const cpp2::DeleteEdgesRequest
 
   auto& oneEdgeKey = req.get_parts().begin()->second.front();
   auto& remoteVid = oneEdgeKey.get_dst().getStr();
-  remotePartId_ = env_->metaClient_->partId(stPartNum.value(), remoteVid);
+  remotePartId_ = env_->metaClient_->edgePart(
+      spaceId_, stPartNum.value(), remoteVid, oneEdgeKey.get_src().getStr());
 
   term_ = (nebula::value(part))->termId();
 
@@ -29,8 +29,9 @@ folly::SemiFuture<nebula::cpp2::ErrorCode> ChainResumeAddDoublePrimeProcessor::p
     return Code::E_SPACE_NOT_FOUND;
   }
   auto& parts = req_.get_parts();
+  auto& srcId = parts.begin()->second.back().get_key().get_src().getStr();
   auto& dstId = parts.begin()->second.back().get_key().get_dst().getStr();
-  remotePartId_ = env_->metaClient_->partId(numOfPart.value(), dstId);
+  remotePartId_ = env_->metaClient_->edgePart(spaceId, numOfPart.value(), dstId, srcId);
 
   return Code::SUCCEEDED;
 }
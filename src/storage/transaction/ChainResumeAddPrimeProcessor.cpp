@@ -31,8 +31,8 @@ folly::SemiFuture<nebula::cpp2::ErrorCode> ChainResumeAddPrimeProcessor::prepare
   auto& parts = req_.get_parts();
   auto& srcId = parts.begin()->second.back().get_key().get_src().getStr();
   auto& dstId = parts.begin()->second.back().get_key().get_dst().getStr();
-  localPartId_ = env_->metaClient_->partId(numOfPart.value(), srcId);
-  remotePartId_ = env_->metaClient_->partId(numOfPart.value(), dstId);
+  localPartId_ = env_->metaClient_->edgePart(spaceId, numOfPart.value(), srcId, dstId);
+  remotePartId_ = env_->metaClient_->edgePart(spaceId, numOfPart.value(), dstId, srcId);
 
   return rcPrepare_;
 }
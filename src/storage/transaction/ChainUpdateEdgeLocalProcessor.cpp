@@ -245,7 +245,9 @@ cpp2::UpdateEdgeRequest ChainUpdateEdgeLocalProcessor::reverseRequest(
   auto partsNum = env_->metaClient_->partsNum(req.get_space_id());
   CHECK(partsNum.ok());
   auto srcVid = reversedRequest.get_edge_key().get_src().getStr();
-  auto partId = env_->metaClient_->partId(partsNum.value(), srcVid);
+  auto dstVid = reversedRequest.get_edge_key().get_dst().getStr();
+  auto partId =
+      env_->metaClient_->edgePart(req.get_space_id(), partsNum.value(), srcVid, dstVid);
   reversedRequest.part_id_ref() = partId;
 
   return reversedRequest;
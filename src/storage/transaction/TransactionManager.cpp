@@ -6,12 +6,14 @@
 #include "storage/transaction/TransactionManager.h"
 
 #include <folly/container/Enumerate.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include "codec/RowWriterV2.h"
 #include "common/utils/NebulaKeyUtils.h"
 #include "kvstore/NebulaStore.h"
 #include "storage/CommonUtils.h"
 #include "storage/StorageFlags.h"
+#include "storage/transaction/ChainAddEdgesLocalProcessor.h"
 #include "storage/transaction/ChainProcessorFactory.h"
 
 namespace nebula {
@@ -19,6 +21,13 @@ namespace storage {
 
 DEFINE_int32(resume_interval_secs, 10, "Resume interval");
 DEFINE_int32(toss_worker_num, 16, "Resume interval");
+DEFINE_uint32(toss_chain_batch_edges,
+              1024,
+              "Max edges of the requests of the same part pair batched into one chain while a "
+              "chain of them is running, 0 means each request runs its own chain");
+DEFINE_uint32(toss_resume_concurrency,
+              64,
+              "Max dangling edges resumed at the same time, 0 means no limit");
 
 TransactionManager::TransactionManager(StorageEnv* env) : env_(env) {
   LOG(INFO) << "TransactionManager ctor()";
@@ -88,6 +97,117 @@ void TransactionManager::addChainTask(ChainBaseProcessor* proc) {
       .ensure([=]() { proc->finish(); });
 }
 
+folly::Future<Code> TransactionManager::addEdgesChain(PartitionID remotePartId,
+                                                      cpp2::AddEdgesRequest&& req) {
+  CHECK_EQ(req.get_parts().size(), 1);
+  ChainKey key = std::make_tuple(req.get_space_id(), req.get_parts().begin()->first, remotePartId);
+  folly::Promise<Code> promise;
+  auto future = promise.getFuture();
+  auto batch = makeEdgesChainBatch(std::move(req), std::move(promise));
+  if (FLAGS_toss_chain_batch_edges == 0) {
+    runEdgesChain(key, std::move(batch), false);
+    return future;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(chainLock_);
+    auto& slot = chainSlots_[key];
+    if (slot.running) {
+      // Wait for the running chain, along with the other requests coming meanwhile
+      if (slot.pending.empty() || !mergeEdgesChainBatch(slot.pending.back(), batch)) {
+        slot.pending.emplace_back(std::move(batch));
+      }
+      return future;
+    }
+    slot.running = true;
+  }
+  runEdgesChain(key, std::move(batch), true);
+  return future;
+}
+
+TransactionManager::EdgesChainBatch TransactionManager::makeEdgesChainBatch(
+    cpp2::AddEdgesRequest&& req, folly::Promise<Code>&& promise) {
+  EdgesChainBatch batch;
+  for (const auto& edge : req.get_parts().begin()->second) {
+    std::string key;
+    apache::thrift::CompactSerializer::serialize(edge.get_key(), &key);
+    batch.keys.emplace(std::move(key));
+  }
+  batch.numEdges = req.get_parts().begin()->second.size();
+  batch.req = std::move(req);
+  batch.promises.emplace_back(std::move(promise));
+  return batch;
+}
+
+bool TransactionManager::mergeEdgesChainBatch(EdgesChainBatch& dst, EdgesChainBatch& src) {
+  if (dst.numEdges + src.numEdges > FLAGS_toss_chain_batch_edges) {
+    return false;
+  }
+  auto& dstEdges = dst.req.parts_ref()->begin()->second;
+  auto& srcEdges = src.req.parts_ref()->begin()->second;
+  // The props of the edges are in the same order, and the default values are filled by the schema
+  // of the first edge
+  if (dst.req.get_prop_names() != src.req.get_prop_names() ||
+      dst.req.get_if_not_exists() != src.req.get_if_not_exists() || dstEdges.empty() ||
+      srcEdges.empty() ||
+      dstEdges.front().get_key().get_edge_type() != srcEdges.front().get_key().get_edge_type()) {
+    return false;
+  }
+  // The edges of a chain are locked together, so the same edge in two requests goes to two chains
+  for (const auto& key : src.keys) {
+    if (dst.keys.count(key) > 0) {
+      return false;
+    }
+  }
+  dst.keys.insert(src.keys.begin(), src.keys.end());
+  dst.numEdges += src.numEdges;
+  std::move(srcEdges.begin(), srcEdges.end(), std::back_inserter(dstEdges));
+  std::move(src.promises.begin(), src.promises.end(), std::back_inserter(dst.promises));
+  return true;
+}
+
+void TransactionManager::runEdgesChain(const ChainKey& key, EdgesChainBatch&& batch, bool batched) {
+  VLOG(2) << "Run the chain of " << batch.numEdges << " edges from " << batch.promises.size()
+          << " requests, space " << std::get<0>(key) << ", local part " << std::get<1>(key)
+          << ", remote part " << std::get<2>(key);
+  auto* proc = ChainAddEdgesLocalProcessor::instance(env_);
+  proc->setRemotePartId(std::get<2>(key));
+  proc->getFuture().thenTry(
+      [this, key, batched, promises = std::move(batch.promises)](auto&& t) mutable {
+        auto code = Code::E_UNKNOWN;
+        if (t.hasValue()) {
+          const auto& failedParts = t.value().get_result().get_failed_parts();
+          code = failedParts.empty() ? Code::SUCCEEDED : failedParts.begin()->get_code();
+        }
+        for (auto& promise : promises) {
+          promise.setValue(code);
+        }
+        if (batched) {
+          onEdgesChainDone(key);
+        }
+      });
+  proc->process(batch.req);
+}
+
+void TransactionManager::onEdgesChainDone(const ChainKey& key) {
+  EdgesChainBatch next;
+  {
+    std::lock_guard<std::mutex> guard(chainLock_);
+    auto iter = chainSlots_.find(key);
+    CHECK(iter != chainSlots_.end());
+    if (iter->second.pending.empty()) {
+      chainSlots_.erase(iter);
+      return;
+    }
+    next = std::move(iter->second.pending.front());
+    iter->second.pending.pop_front();
+  }
+  // Run it out of the callback of the last chain
+  worker_->add([this, key, next = std::move(next)]() mutable {
+    runEdgesChain(key, std::move(next), true);
+  });
+}
+
 TransactionManager::SPtrLock TransactionManager::getLockCore(GraphSpaceID spaceId,
                                                              GraphSpaceID partId,
                                                              TermID termId,
@@ -157,26 +277,57 @@ void TransactionManager::addPrime(GraphSpaceID spaceId,
                                   ResumeType type) {
   VLOG(2) << "addPrime() space=" << spaceId << ", hex=" << folly::hexlify(egKey)
           << ", ResumeType=" << static_cast<int>(type);
-  auto* proc = ChainProcessorFactory::make(env_, spaceId, termId, egKey, type);
-  if (proc == nullptr) {
-    VLOG(1) << "delPrime() space=" << spaceId << ", hex=" << folly::hexlify(egKey);
-    auto lk = getLockCore(spaceId, partId, termId, false);
-    if (lk) {
-      lk->unlock(egKey);
-    }
-    return;
-  }
-  auto fut = proc->getFinished();
-  std::move(fut).thenValue([=](auto&& code) {
-    if (code == Code::SUCCEEDED) {
-      VLOG(2) << "delPrime() space=" << spaceId << ", hex=" << folly::hexlify(egKey);
+  scheduleResume([=]() {
+    auto* proc = ChainProcessorFactory::make(env_, spaceId, termId, egKey, type);
+    if (proc == nullptr) {
+      VLOG(1) << "delPrime() space=" << spaceId << ", hex=" << folly::hexlify(egKey);
       auto lk = getLockCore(spaceId, partId, termId, false);
       if (lk) {
         lk->unlock(egKey);
       }
+      onResumeDone();
+      return;
     }
+    auto fut = proc->getFinished();
+    std::move(fut)
+        .thenValue([=](auto&& code) {
+          if (code == Code::SUCCEEDED) {
+            VLOG(2) << "delPrime() space=" << spaceId << ", hex=" << folly::hexlify(egKey);
+            auto lk = getLockCore(spaceId, partId, termId, false);
+            if (lk) {
+              lk->unlock(egKey);
+            }
+          }
+        })
+        .ensure([this]() { onResumeDone(); });
+    addChainTask(proc);
   });
-  addChainTask(proc);
+}
+
+void TransactionManager::scheduleResume(std::function<void()>&& resume) {
+  {
+    std::lock_guard<std::mutex> guard(resumeLock_);
+    if (FLAGS_toss_resume_concurrency > 0 && runningResumes_ >= FLAGS_toss_resume_concurrency) {
+      pendingResumes_.emplace_back(std::move(resume));
+      return;
+    }
+    ++runningResumes_;
+  }
+  resume();
+}
+
+void TransactionManager::onResumeDone() {
+  std::function<void()> next;
+  {
+    std::lock_guard<std::mutex> guard(resumeLock_);
+    if (pendingResumes_.empty()) {
+      --runningResumes_;
+      return;
+    }
+    next = std::move(pendingResumes_.front());
+    pendingResumes_.pop_front();
+  }
+  worker_->add(std::move(next));
 }
 
 void TransactionManager::onNewPartAdded(std::shared_ptr<kvstore::Part>& part) {
@@ -57,6 +57,18 @@ class TransactionManager {
    */
   void addChainTask(ChainBaseProcessor* proc);
 
+  /**
+   * @brief Add the edges of a request from its local part to the remote part in a chain. While a
+   *        chain of the same part pair is running, the later requests are batched into the next
+   *        chain, which writes one set of primes, sends one remote rpc and commits once for all
+   *        of them.
+   *
+   * @param remotePartId Part of the reversed edges
+   * @param req Request of the edges in a single local part
+   * @return folly::Future<Code> Result of the chain the edges are in
+   */
+  folly::Future<Code> addEdgesChain(PartitionID remotePartId, cpp2::AddEdgesRequest&& req);
+
   /**
    * @brief Get the Lock Core object to set a memory lock for a key.
    *
@@ -131,6 +143,38 @@ class TransactionManager {
 
   void waitUntil(std::function<bool()>&& cond, folly::Promise<folly::Unit>&& p);
 
+  // Edges of the requests to be added in one chain
+  struct EdgesChainBatch {
+    cpp2::AddEdgesRequest req;
+    size_t numEdges{0};
+    // serialized edge keys, an edge could be in a batch only once
+    std::unordered_set<std::string> keys;
+    std::vector<folly::Promise<Code>> promises;
+  };
+
+  // space, local part and remote part of a chain
+  using ChainKey = std::tuple<GraphSpaceID, PartitionID, PartitionID>;
+
+  struct EdgesChainSlot {
+    bool running{false};
+    std::deque<EdgesChainBatch> pending;
+  };
+
+  static EdgesChainBatch makeEdgesChainBatch(cpp2::AddEdgesRequest&& req,
+                                             folly::Promise<Code>&& promise);
+
+  // Merge the batch into dst if they could be in the same chain
+  static bool mergeEdgesChainBatch(EdgesChainBatch& dst, EdgesChainBatch& src);
+
+  void runEdgesChain(const ChainKey& key, EdgesChainBatch&& batch, bool batched);
+
+  void onEdgesChainDone(const ChainKey& key);
+
+  // Resume the dangling edge when there is room, at most toss_resume_concurrency ones run at once
+  void scheduleResume(std::function<void()>&& resume);
+
+  void onResumeDone();
+
  protected:
   using SpacePart = std::pair<GraphSpaceID, PartitionID>;
 
@@ -155,6 +199,13 @@ class TransactionManager {
   folly::ConcurrentHashMap<SpacePart, TermID> currTerm_;
 
   folly::ConcurrentHashMap<SpacePart, TermID> prevTerms_;
+
+  std::mutex chainLock_;
+  std::unordered_map<ChainKey, EdgesChainSlot> chainSlots_;
+
+  std::mutex resumeLock_;
+  std::deque<std::function<void()>> pendingResumes_;
+  size_t runningResumes_{0};
 };
 
 }  // namespace storage
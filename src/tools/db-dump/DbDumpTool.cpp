@@ -49,6 +49,19 @@ optional:
          Would output all if set 0 or negative number.
          Default: 1000
 
+       --threads=<N>
+         The threads to scan the parts in parallel, used when no vids are given.
+         The records of a part are printed together, but the parts are not in order.
+         Default: 1
+
+       --max_read_mb_per_sec=<N>
+         The max MB read in one second, 0 means no limit.
+         Default: 0
+
+       --progress_interval_secs=<N>
+         The interval to report the progress to stderr, 0 means not to report.
+         Default: 10
+
 
 )");
 }
@@ -64,6 +77,8 @@ void printParams() {
   std::cout << "tags: " << FLAGS_tags << "\n";
   std::cout << "edges: " << FLAGS_edges << "\n";
   std::cout << "limit: " << FLAGS_limit << "\n";
+  std::cout << "threads: " << FLAGS_threads << "\n";
+  std::cout << "max read mb per sec: " << FLAGS_max_read_mb_per_sec << "\n";
   std::cout << "===========================PARAMS============================\n\n";
 }
 
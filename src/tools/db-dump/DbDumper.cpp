@@ -5,8 +5,11 @@
 
 #include "tools/db-dump/DbDumper.h"
 
+#include <folly/ScopeGuard.h>
+
 #include "common/fs/FileUtils.h"
 #include "common/time/Duration.h"
+#include "common/time/WallClock.h"
 #include "common/utils/NebulaKeyUtils.h"
 
 DEFINE_string(space_name, "", "The space name.");
@@ -18,10 +21,37 @@ DEFINE_string(vids, "", "A list of vertex ids separated by comma.");
 DEFINE_string(tags, "", "A list of tag name separated by comma.");
 DEFINE_string(edges, "", "A list of edge name separated by comma.");
 DEFINE_int64(limit, 1000, "Limit to output.");
+DEFINE_int32(threads,
+             1,
+             "The threads to scan the parts, used when no vids are given. The records of a part "
+             "are printed together, but the parts are not in order");
+DEFINE_int32(max_read_mb_per_sec, 0, "The max MB read in one second, 0 means no limit");
+DEFINE_int32(progress_interval_secs,
+             10,
+             "The interval to report the progress to stderr, 0 means not to report");
 
 namespace nebula {
 namespace storage {
 
+namespace {
+
+// The bytes read accounted together, and the output buffered by a thread before written
+constexpr int64_t kAccountBytes = 1 << 20;
+constexpr int64_t kFlushBytes = 1 << 20;
+
+}  // namespace
+
+void DbDumper::Stats::merge(const Stats& other) {
+  for (const auto& [tagId, count] : other.tagStat) {
+    tagStat[tagId] += count;
+  }
+  for (const auto& [edgeType, count] : other.edgeStat) {
+    edgeStat[edgeType] += count;
+  }
+  vertexCount += other.vertexCount;
+  edgeCount += other.edgeCount;
+}
+
 Status DbDumper::init() {
   auto status = initMeta();
   if (!status.ok()) {
@@ -168,6 +198,144 @@ bool DbDumper::isValidVidLen(VertexID vid) {
 
 void DbDumper::run() {
   time::Duration dur;
+  limiter_ = std::make_unique<kvstore::RateLimiter>();
+  lastTimeMs_ = time::WallClock::fastNowInMilliSec();
+
+  std::mutex reporterLock;
+  std::condition_variable reporterCond;
+  bool finished = false;
+  std::thread reporter;
+  if (FLAGS_progress_interval_secs > 0) {
+    reporter = std::thread([&] {
+      std::unique_lock<std::mutex> guard(reporterLock);
+      auto interval = std::chrono::seconds(FLAGS_progress_interval_secs);
+      while (!reporterCond.wait_for(guard, interval, [&] { return finished; })) {
+        reportProgress();
+      }
+    });
+  }
+
+  if (FLAGS_threads > 1 && vids_.empty()) {
+    scanParts();
+  } else {
+    seekSpecified();
+  }
+
+  if (reporter.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard(reporterLock);
+      finished = true;
+    }
+    reporterCond.notify_one();
+    reporter.join();
+  }
+  printStatistics(dur.elapsedInUSec());
+}
+
+void DbDumper::scanParts() {
+  std::vector<PartitionID> parts(parts_.begin(), parts_.end());
+  if (parts.empty()) {
+    for (PartitionID partId = 1; partId <= partNum_; partId++) {
+      parts.emplace_back(partId);
+    }
+  }
+  std::sort(parts.begin(), parts.end());
+  partsTotal_ = parts.size();
+
+  // Only the vertices are printed if only tags are given, and vice versa
+  bool scanVertices = !tagIds_.empty() || edgeTypes_.empty();
+  bool scanEdges = !edgeTypes_.empty() || tagIds_.empty();
+  if (!tagIds_.empty()) {
+    beforePrintVertex_.emplace_back([this](const folly::StringPiece& key) {
+      return tagIds_.count(NebulaKeyUtils::getTagId(spaceVidLen_, key)) != 0;
+    });
+  }
+  if (!edgeTypes_.empty()) {
+    beforePrintEdge_.emplace_back([this](const folly::StringPiece& key) {
+      return edgeTypes_.count(NebulaKeyUtils::getEdgeType(spaceVidLen_, key)) != 0;
+    });
+  }
+
+  std::atomic<size_t> next{0};
+  auto scan = [&] {
+    for (auto i = next++; i < parts.size(); i = next++) {
+      if (FLAGS_limit > 0 && count_ >= FLAGS_limit) {
+        break;
+      }
+      std::vector<std::string> prefixes;
+      if (scanVertices) {
+        prefixes.emplace_back(NebulaKeyUtils::tagPrefix(parts[i]));
+      }
+      if (scanEdges) {
+        prefixes.emplace_back(NebulaKeyUtils::edgePrefix(parts[i]));
+      }
+      Stats stats;
+      std::ostringstream buffer;
+      for (const auto& prefix : prefixes) {
+        const auto it = db_->NewIterator(rocksdb::ReadOptions());
+        it->Seek(rocksdb::Slice(prefix));
+        const auto prefixIt = std::make_unique<kvstore::RocksPrefixIter>(it, prefix);
+        iterates(prefixIt.get(), stats, &buffer);
+      }
+      flushBuffer(buffer);
+      std::lock_guard<std::mutex> guard(lock_);
+      stats_.merge(stats);
+      partsDone_++;
+    }
+  };
+
+  auto threads = std::min<size_t>(FLAGS_threads, parts.size());
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < threads; i++) {
+    workers.emplace_back(scan);
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void DbDumper::flushBuffer(std::ostringstream& buffer) {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    std::cout << buffer.str();
+  }
+  buffer.str("");
+}
+
+void DbDumper::accountRead(int64_t keys, int64_t bytes) {
+  keysRead_ += keys;
+  bytesRead_ += bytes;
+  int64_t rate = static_cast<int64_t>(FLAGS_max_read_mb_per_sec) << 20;
+  if (rate <= 0) {
+    return;
+  }
+  // A consumption larger than the burst is not waited for, so consume by pieces
+  while (bytes > 0) {
+    auto piece = std::min(bytes, rate);
+    limiter_->consume(piece, rate, rate);
+    bytes -= piece;
+  }
+}
+
+void DbDumper::reportProgress() {
+  auto now = time::WallClock::fastNowInMilliSec();
+  auto secs = std::max<int64_t>(now - lastTimeMs_, 1) / 1000.0;
+  auto bytesRead = bytesRead_.load();
+  std::string parts;
+  if (partsTotal_ > 0) {
+    parts = folly::sformat("parts {}/{}, ", partsDone_.load(), partsTotal_);
+  }
+  std::cerr << folly::sformat("Progress: {}read {} keys {:.1f} MB ({:.1f} MB/s), dumped {}\n",
+                              parts,
+                              keysRead_.load(),
+                              bytesRead / 1048576.0,
+                              (bytesRead - lastBytesRead_) / 1048576.0 / secs,
+                              count_.load());
+  lastTimeMs_ = now;
+  lastBytesRead_ = bytesRead;
+}
+
+void DbDumper::seekSpecified() {
   auto noPrint = [](const folly::StringPiece& key) -> bool {
     UNUSED(key);
     return false;
@@ -400,38 +568,51 @@ void DbDumper::run() {
       std::cerr << "error";
     }
   }
+}
 
+void DbDumper::printStatistics(int64_t elapsedUs) {
+  auto secs = std::max<int64_t>(elapsedUs, 1) / 1000000.0;
   std::cout << "===========================STATISTICS============================\n";
   std::cout << "COUNT: " << count_ << "\n";
-  std::cout << "VERTEX COUNT: " << vertexCount_ << "\n";
-  std::cout << "EDGE COUNT: " << edgeCount_ << "\n";
+  std::cout << "VERTEX COUNT: " << stats_.vertexCount << "\n";
+  std::cout << "EDGE COUNT: " << stats_.edgeCount << "\n";
   std::cout << "TAG STATISTICS: \n";
-  for (auto& t : tagStat_) {
+  for (auto& t : stats_.tagStat) {
     std::cout << "\t" << getTagName(t.first) << " : " << t.second << "\n";
   }
   std::cout << "EDGE STATISTICS: \n";
-  for (auto& e : edgeStat_) {
+  for (auto& e : stats_.edgeStat) {
     std::cout << "\t" << getEdgeName(e.first) << " : " << e.second << "\n";
   }
   std::cout << "============================STATISTICS===========================\n";
-  std::cout << "Time cost: " << dur.elapsedInUSec() << " us\n\n";
+  std::cout << "Time cost: " << elapsedUs << " us\n";
+  std::cout << folly::sformat("Read: {} keys, {:.1f} MB, {:.1f} MB/s\n\n",
+                              keysRead_.load(),
+                              bytesRead_ / 1048576.0,
+                              bytesRead_ / 1048576.0 / secs);
 }
 
 void DbDumper::seekToFirst() {
   const auto it = db_->NewIterator(rocksdb::ReadOptions());
   it->SeekToFirst();
   const auto prefixIt = std::make_unique<kvstore::RocksPrefixIter>(it, "");
-  iterates(prefixIt.get());
+  iterates(prefixIt.get(), stats_);
 }
 
 void DbDumper::seek(std::string& prefix) {
   const auto it = db_->NewIterator(rocksdb::ReadOptions());
   it->Seek(rocksdb::Slice(prefix));
   const auto prefixIt = std::make_unique<kvstore::RocksPrefixIter>(it, prefix);
-  iterates(prefixIt.get());
+  iterates(prefixIt.get(), stats_);
 }
 
-void DbDumper::iterates(kvstore::RocksPrefixIter* it) {
+void DbDumper::iterates(kvstore::RocksPrefixIter* it, Stats& stats, std::ostringstream* buffer) {
+  std::ostream& out = buffer == nullptr ? std::cout : *buffer;
+  int64_t keys = 0;
+  int64_t bytes = 0;
+  SCOPE_EXIT {
+    accountRead(keys, bytes);
+  };
   for (; it->valid(); it->next()) {
     if (FLAGS_limit > 0 && count_ >= FLAGS_limit) {
       break;
@@ -439,6 +620,16 @@ void DbDumper::iterates(kvstore::RocksPrefixIter* it) {
 
     auto key = it->key();
     auto value = it->val();
+    keys++;
+    bytes += key.size() + value.size();
+    if (bytes >= kAccountBytes) {
+      accountRead(keys, bytes);
+      keys = 0;
+      bytes = 0;
+    }
+    if (buffer != nullptr && buffer->tellp() >= kFlushBytes) {
+      flushBuffer(*buffer);
+    }
 
     if (NebulaKeyUtils::isTag(spaceVidLen_, key)) {
       // filter the data
@@ -456,23 +647,23 @@ void DbDumper::iterates(kvstore::RocksPrefixIter* it) {
       auto tagId = NebulaKeyUtils::getTagId(spaceVidLen_, key);
       // only print to screen with scan mode
       if (FLAGS_mode == "scan") {
-        printTagKey(key);
+        printTagKey(key, out);
         auto reader = RowReaderWrapper::getTagPropReader(schemaMng_.get(), spaceId_, tagId, value);
         if (!reader) {
           std::cerr << "Can't get tag reader of " << tagId;
           continue;
         }
-        printValue(reader.get());
+        printValue(reader.get(), out);
       }
 
       // statistics
-      auto tagStat = tagStat_.find(tagId);
-      if (tagStat == tagStat_.end()) {
-        tagStat_.emplace(tagId, 1);
+      auto tagStat = stats.tagStat.find(tagId);
+      if (tagStat == stats.tagStat.end()) {
+        stats.tagStat.emplace(tagId, 1);
       } else {
         ++(tagStat->second);
       }
-      ++vertexCount_;
+      ++stats.vertexCount;
       ++count_;
     } else if (NebulaKeyUtils::isEdge(spaceVidLen_, key)) {
       // filter the data
@@ -494,51 +685,51 @@ void DbDumper::iterates(kvstore::RocksPrefixIter* it) {
       }
       // only print to screen with scan mode
       if (FLAGS_mode == "scan") {
-        printEdgeKey(key);
+        printEdgeKey(key, out);
         auto reader =
             RowReaderWrapper::getEdgePropReader(schemaMng_.get(), spaceId_, edgeType, value);
         if (!reader) {
           std::cerr << "Can't get edge reader of " << edgeType;
           continue;
         }
-        printValue(reader.get());
+        printValue(reader.get(), out);
       }
 
       // statistics
-      auto edgeStat = edgeStat_.find(edgeType);
-      if (edgeStat == edgeStat_.end()) {
-        edgeStat_.emplace(edgeType, 1);
+      auto edgeStat = stats.edgeStat.find(edgeType);
+      if (edgeStat == stats.edgeStat.end()) {
+        stats.edgeStat.emplace(edgeType, 1);
       } else {
         ++(edgeStat->second);
       }
-      ++edgeCount_;
+      ++stats.edgeCount;
       ++count_;
     }
   }
 }
 
-inline void DbDumper::printTagKey(const folly::StringPiece& key) {
+inline void DbDumper::printTagKey(const folly::StringPiece& key, std::ostream& out) {
   auto part = NebulaKeyUtils::getPart(key);
   auto vid = getVertexId(NebulaKeyUtils::getVertexId(spaceVidLen_, key));
   auto tagId = NebulaKeyUtils::getTagId(spaceVidLen_, key);
-  std::cout << "[vertex] key: " << part << ", " << vid << ", " << getTagName(tagId);
+  out << "[vertex] key: " << part << ", " << vid << ", " << getTagName(tagId);
 }
 
-inline void DbDumper::printEdgeKey(const folly::StringPiece& key) {
+inline void DbDumper::printEdgeKey(const folly::StringPiece& key, std::ostream& out) {
   auto part = NebulaKeyUtils::getPart(key);
   auto edgeType = NebulaKeyUtils::getEdgeType(spaceVidLen_, key);
   auto src = getVertexId(NebulaKeyUtils::getSrcId(spaceVidLen_, key));
   auto dst = getVertexId(NebulaKeyUtils::getDstId(spaceVidLen_, key));
   auto rank = NebulaKeyUtils::getRank(spaceVidLen_, key);
-  std::cout << "[edge] key: " << part << ", " << src << ", " << getEdgeName(edgeType) << ", "
-            << rank << ", " << dst;
+  out << "[edge] key: " << part << ", " << src << ", " << getEdgeName(edgeType) << ", " << rank
+      << ", " << dst;
 }
 
-void DbDumper::printValue(const RowReader* reader) {
+void DbDumper::printValue(const RowReader* reader, std::ostream& out) {
   if (reader == nullptr) {
     return;
   }
-  std::cout << " value: ";
+  out << " value: ";
   auto schema = reader->getSchema();
   if (schema == nullptr) {
     std::cerr << "schema not found.";
@@ -549,11 +740,11 @@ void DbDumper::printValue(const RowReader* reader) {
   while (iter) {
     auto value = reader->getValueByIndex(index);
     auto retVal = value.toString();
-    std::cout << retVal << ", ";
+    out << retVal << ", ";
     ++iter;
     ++index;
   }
-  std::cout << "\n";
+  out << "\n";
 }
 
 std::string DbDumper::getTagName(const TagID tagId) {
@@ -13,6 +13,7 @@
 #include "common/base/Base.h"
 #include "common/base/Status.h"
 #include "common/meta/ServerBasedSchemaManager.h"
+#include "kvstore/RateLimiter.h"
 #include "kvstore/RocksEngine.h"
 
 DECLARE_string(space_name);
@@ -24,6 +25,9 @@ DECLARE_string(vids);
 DECLARE_string(tags);
 DECLARE_string(edges);
 DECLARE_int64(limit);
+DECLARE_int32(threads);
+DECLARE_int32(max_read_mb_per_sec);
+DECLARE_int32(progress_interval_secs);
 
 namespace nebula {
 namespace storage {
@@ -39,6 +43,16 @@ class DbDumper {
   void run();
 
  private:
+  // The statistics of the keys dumped
+  struct Stats {
+    std::unordered_map<TagID, uint32_t> tagStat;
+    std::unordered_map<EdgeType, uint32_t> edgeStat;
+    int64_t vertexCount{0};
+    int64_t edgeCount{0};
+
+    void merge(const Stats& other);
+  };
+
   Status initMeta();
 
   Status initSpace();
@@ -47,21 +61,37 @@ class DbDumper {
 
   Status openDb();
 
+  // Seek by the parts, vids, tags and edges given
+  void seekSpecified();
+
   void seekToFirst();
 
   void seek(std::string& prefix);
 
-  void iterates(kvstore::RocksPrefixIter* it);
+  // Scan the whole parts by --threads, the output of a thread is buffered and written together
+  void scanParts();
+
+  // Print to the buffer if given, otherwise to stdout
+  void iterates(kvstore::RocksPrefixIter* it, Stats& stats, std::ostringstream* buffer = nullptr);
+
+  void flushBuffer(std::ostringstream& buffer);
+
+  // Account the bytes read, wait if exceeding --max_read_mb_per_sec
+  void accountRead(int64_t keys, int64_t bytes);
+
+  void reportProgress();
+
+  void printStatistics(int64_t elapsedUs);
 
-  inline void printTagKey(const folly::StringPiece& key);
+  inline void printTagKey(const folly::StringPiece& key, std::ostream& out);
 
-  inline void printEdgeKey(const folly::StringPiece& key);
+  inline void printEdgeKey(const folly::StringPiece& key, std::ostream& out);
 
   std::string getTagName(const TagID tagId);
 
   std::string getEdgeName(const EdgeType edgeType);
 
-  void printValue(const RowReader* reader);
+  void printValue(const RowReader* reader, std::ostream& out);
 
   bool isValidVidLen(VertexID vid);
 
@@ -84,11 +114,19 @@ class DbDumper {
   std::vector<std::function<bool(const folly::StringPiece&)>> beforePrintEdge_;
 
   // For statistics
-  std::unordered_map<TagID, uint32_t> tagStat_;
-  std::unordered_map<EdgeType, uint32_t> edgeStat_;
-  int64_t count_{0};
-  int64_t vertexCount_{0};
-  int64_t edgeCount_{0};
+  Stats stats_;
+  std::atomic<int64_t> count_{0};
+  // Protect stats_ and stdout when scanning the parts by threads
+  std::mutex lock_;
+
+  // For the progress and the read limit
+  std::unique_ptr<kvstore::RateLimiter> limiter_;
+  std::atomic<int64_t> keysRead_{0};
+  std::atomic<int64_t> bytesRead_{0};
+  std::atomic<int32_t> partsDone_{0};
+  int32_t partsTotal_{0};
+  int64_t lastTimeMs_{0};
+  int64_t lastBytesRead_{0};
 };
 
 }  // namespace storage
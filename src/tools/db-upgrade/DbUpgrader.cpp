@@ -5,8 +5,11 @@
 
 #include "tools/db-upgrade/DbUpgrader.h"
 
+#include <thrift/lib/cpp/util/EnumUtils.h>
+
 #include "common/datatypes/Value.h"
 #include "common/fs/FileUtils.h"
+#include "common/time/WallClock.h"
 #include "common/utils/IndexKeyUtils.h"
 #include "common/utils/NebulaKeyUtils.h"
 #include "rocksdb/sst_file_writer.h"
@@ -23,7 +26,10 @@ DEFINE_string(dst_db_path,
               "Destination data path(data_path in storage 2.0 conf), "
               "multi paths should be split by comma");
 DEFINE_string(upgrade_meta_server, "127.0.0.1:45500", "Meta servers' address.");
-DEFINE_uint32(write_batch_num, 100, "The size of the batch written to rocksdb");
+DEFINE_uint32(write_batch_num,
+              100,
+              "The size of the batch of the system data written to rocksdb, the vertices, edges "
+              "and indexes are written to sst files");
 DEFINE_string(upgrade_version,
               "",
               "When the value is 1:2, upgrade the data from 1.x to 2.0 GA. "
@@ -35,12 +41,168 @@ DEFINE_bool(compactions,
             "whether to compact data");
 DEFINE_uint32(max_concurrent_parts, 10, "The parts could be processed simultaneously");
 DEFINE_uint32(max_concurrent_spaces, 5, "The spaces could be processed simultaneously");
+DEFINE_uint32(memory_budget_mb,
+              4096,
+              "The memory of the data buffered before written to sst files, shared by the parts "
+              "processed simultaneously on all data paths");
+DEFINE_uint32(max_io_mb_per_sec, 0, "The max MB read and written in one second, 0 means no limit");
+DEFINE_uint32(progress_interval_secs, 30, "The interval to report the progress");
 
 namespace nebula {
 namespace storage {
 
 using nebula::cpp2::PropertyType;
 
+namespace {
+
+// The bytes accounted together, to not contend on the counters for each key
+constexpr int64_t kAccountBytes = 1 << 20;
+
+// Account the keys read by a part
+class ReadCounter final {
+ public:
+  ~ReadCounter() {
+    UpgradeProgress::instance().read(keys_, bytes_);
+  }
+
+  void add(folly::StringPiece key, folly::StringPiece val) {
+    keys_++;
+    bytes_ += key.size() + val.size();
+    if (bytes_ >= kAccountBytes) {
+      UpgradeProgress::instance().read(keys_, bytes_);
+      keys_ = 0;
+      bytes_ = 0;
+    }
+  }
+
+ private:
+  int64_t keys_{0};
+  int64_t bytes_{0};
+};
+
+}  // namespace
+
+UpgradeProgress::UpgradeProgress()
+    : limiter_(std::make_unique<kvstore::RateLimiter>()),
+      lastTimeMs_(time::WallClock::fastNowInMilliSec()) {}
+
+void UpgradeProgress::read(int64_t keys, int64_t bytes) {
+  keysRead_ += keys;
+  bytesRead_ += bytes;
+  throttle(bytes);
+}
+
+void UpgradeProgress::written(int64_t keys, int64_t bytes) {
+  keysWritten_ += keys;
+  bytesWritten_ += bytes;
+  throttle(bytes);
+}
+
+void UpgradeProgress::throttle(int64_t bytes) {
+  int64_t rate = static_cast<int64_t>(FLAGS_max_io_mb_per_sec) << 20;
+  if (rate == 0) {
+    return;
+  }
+  // A consumption larger than the burst is not waited for, so consume by pieces
+  while (bytes > 0) {
+    auto piece = std::min(bytes, rate);
+    limiter_->consume(piece, rate, rate);
+    bytes -= piece;
+  }
+}
+
+void UpgradeProgress::report() {
+  auto now = time::WallClock::fastNowInMilliSec();
+  auto secs = std::max<int64_t>(now - lastTimeMs_, 1) / 1000.0;
+  auto bytesRead = bytesRead_.load();
+  auto bytesWritten = bytesWritten_.load();
+  LOG(INFO) << folly::sformat(
+      "Progress: parts {}/{}, read {} keys {:.1f} MB ({:.1f} MB/s), written {} keys {:.1f} MB "
+      "({:.1f} MB/s)",
+      partsDone.load(),
+      partsTotal.load(),
+      keysRead_.load(),
+      bytesRead / 1048576.0,
+      (bytesRead - lastBytesRead_) / 1048576.0 / secs,
+      keysWritten_.load(),
+      bytesWritten / 1048576.0,
+      (bytesWritten - lastBytesWritten_) / 1048576.0 / secs);
+  lastTimeMs_ = now;
+  lastBytesRead_ = bytesRead;
+  lastBytesWritten_ = bytesWritten;
+}
+
+SstBatchWriter::SstBatchWriter(kvstore::RocksEngine* engine,
+                               PartitionID partId,
+                               size_t bufferBytes)
+    : engine_(engine), partId_(partId), bufferBytes_(bufferBytes) {
+  // Next to the data, so the files could be moved into it rather than copied
+  dir_ = fs::FileUtils::joinPath(engine_->getDataRoot(),
+                                 folly::stringPrintf("upgrade-part-%d", partId_));
+  if (!fs::FileUtils::makeDir(dir_)) {
+    LOG(FATAL) << "makeDir " << dir_ << " failed";
+  }
+}
+
+SstBatchWriter::~SstBatchWriter() {
+  fs::FileUtils::remove(dir_.c_str(), true);
+}
+
+void SstBatchWriter::add(std::vector<kvstore::KV>& data) {
+  for (auto& kv : data) {
+    bufferedBytes_ += kv.first.size() + kv.second.size();
+    buffer_.emplace_back(std::move(kv));
+  }
+  data.clear();
+  if (bufferedBytes_ >= bufferBytes_) {
+    flush();
+  }
+}
+
+void SstBatchWriter::finish() {
+  flush();
+}
+
+void SstBatchWriter::flush() {
+  if (buffer_.empty()) {
+    return;
+  }
+  std::stable_sort(buffer_.begin(), buffer_.end(), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+  ::rocksdb::Options option;
+  option.compression = ::rocksdb::CompressionType::kNoCompression;
+  ::rocksdb::SstFileWriter writer(::rocksdb::EnvOptions(), option);
+  auto file = fs::FileUtils::joinPath(dir_, folly::stringPrintf("%d.sst", files_++));
+  auto s = writer.Open(file);
+  int64_t keys = 0;
+  for (size_t i = 0; s.ok() && i < buffer_.size(); i++) {
+    // The last one of the same key is written
+    if (i + 1 < buffer_.size() && buffer_[i + 1].first == buffer_[i].first) {
+      continue;
+    }
+    s = writer.Put(buffer_[i].first, buffer_[i].second);
+    keys++;
+  }
+  if (s.ok()) {
+    s = writer.Finish();
+  }
+  if (!s.ok()) {
+    LOG(FATAL) << "Write sst file " << file << " of part " << partId_ << " failed: "
+               << s.ToString();
+  }
+  // Ingested one by one, so a later file takes precedence over the earlier ones of the part
+  auto code = engine_->ingest({file}, true);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    LOG(FATAL) << "Ingest sst file " << file << " of part " << partId_
+               << " failed: " << apache::thrift::util::enumNameSafe(code);
+  }
+  UpgradeProgress::instance().written(keys, bufferedBytes_);
+  fs::FileUtils::remove(file.c_str());
+  buffer_.clear();
+  bufferedBytes_ = 0;
+}
+
 Status UpgraderSpace::init(meta::MetaClient* mclient,
                            meta::ServerBasedSchemaManager* sMan,
                            meta::IndexManager* iMan,
@@ -107,6 +269,16 @@ Status UpgraderSpace::initSpace(const std::string& sId) {
     return ret;
   }
 
+  // The budget is shared by the parts processed simultaneously on all data paths
+  std::vector<folly::StringPiece> paths;
+  folly::split(",", FLAGS_src_db_path, paths, true);
+  size_t concurrency = std::max<size_t>(paths.size(), 1) *
+                       std::max(FLAGS_max_concurrent_spaces, 1U) *
+                       std::max(FLAGS_max_concurrent_parts, 1U);
+  partBufferBytes_ = std::max<size_t>(
+      (static_cast<size_t>(FLAGS_memory_budget_mb) << 20) / concurrency, 1 << 20);
+  UpgradeProgress::instance().partsTotal += parts_.size();
+
   pool_ = std::make_unique<folly::IOThreadPoolExecutor>(FLAGS_max_concurrent_parts);
   // Parallel process part
   for (auto& partId : parts_) {
@@ -225,17 +397,12 @@ void UpgraderSpace::runPartV1() {
       LOG(ERROR) << "Handle vertex/edge/index data in space id " << spaceId_ << " part id "
                  << partId << " failed";
 
-      auto unFinishedPart = --unFinishedPart_;
-      if (unFinishedPart == 0) {
-        // all parts has finished
-        LOG(INFO) << "Handle last part: " << partId << " vertex/edge/index data in space id "
-                  << spaceId_ << " finished";
-      } else {
-        pool_->add(std::bind(&UpgraderSpace::runPartV1, this));
-      }
+      partFinished(partId, &UpgraderSpace::runPartV1);
       return;
     }
 
+    SstBatchWriter writer(writeEngine_.get(), partId, partBufferBytes_);
+    ReadCounter reads;
     std::vector<kvstore::KV> data;
     TagID lastTagId = 0;
     int64_t lastVertexId = 0;
@@ -247,6 +414,7 @@ void UpgraderSpace::runPartV1() {
 
     while (iter && iter->valid()) {
       auto key = iter->key();
+      reads.add(key, iter->val());
       if (NebulaKeyUtilsV1::isVertex(key)) {
         auto vId = NebulaKeyUtilsV1::getVertexId(key);
         auto tagId = NebulaKeyUtilsV1::getTagId(key);
@@ -335,41 +503,32 @@ void UpgraderSpace::runPartV1() {
         lastDstVertexId = dvId;
       }
 
-      if (data.size() >= FLAGS_write_batch_num) {
-        VLOG(2) << "Send record total rows " << data.size();
-        auto code = writeEngine_->multiPut(data);
-        if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
-          LOG(FATAL) << "Write multi put in space id " << spaceId_ << " part id " << partId
-                     << " failed.";
-        }
-        data.clear();
-      }
-
+      writer.add(data);
       iter->next();
     }
-
-    auto code = writeEngine_->multiPut(data);
-    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
-      LOG(FATAL) << "Write multi put in space id " << spaceId_ << " part id " << partId
-                 << " failed.";
-    }
-    data.clear();
+    writer.add(data);
+    writer.finish();
     LOG(INFO) << "Handle vertex/edge/index data in space id " << spaceId_ << " part id " << partId
               << " finished";
 
-    auto unFinishedPart = --unFinishedPart_;
-    if (unFinishedPart == 0) {
-      // all parts has finished
-      LOG(INFO) << "Handle last part: " << partId << " vertex/edge/index data in space id "
-                << spaceId_ << " finished";
-    } else {
-      pool_->add(std::bind(&UpgraderSpace::runPartV1, this));
-    }
+    partFinished(partId, &UpgraderSpace::runPartV1);
   } else {
     LOG(INFO) << "Handle vertex/edge/index of parts data in space id " << spaceId_ << " finished";
   }
 }
 
+void UpgraderSpace::partFinished(PartitionID partId, void (UpgraderSpace::*runPart)()) {
+  UpgradeProgress::instance().partsDone++;
+  auto unFinishedPart = --unFinishedPart_;
+  if (unFinishedPart == 0) {
+    // all parts has finished
+    LOG(INFO) << "Handle last part: " << partId << " vertex/edge/index data in space id "
+              << spaceId_ << " finished";
+  } else {
+    pool_->add(std::bind(runPart, this));
+  }
+}
+
 void UpgraderSpace::doProcessV1() {
   LOG(INFO) << "Start to handle data in space id " << spaceId_;
 
@@ -439,17 +598,12 @@ void UpgraderSpace::runPartV2() {
       LOG(ERROR) << "Handle vertex/edge/index data in space id " << spaceId_ << " part id "
                  << partId << " failed";
 
-      auto unFinishedPart = --unFinishedPart_;
-      if (unFinishedPart == 0) {
-        // all parts has finished
-        LOG(INFO) << "Handle last part: " << partId << " vertex/edge/index data in space id "
-                  << spaceId_ << " finished";
-      } else {
-        pool_->add(std::bind(&UpgraderSpace::runPartV2, this));
-      }
+      partFinished(partId, &UpgraderSpace::runPartV2);
       return;
     }
 
+    SstBatchWriter writer(writeEngine_.get(), partId, partBufferBytes_);
+    ReadCounter reads;
     std::vector<kvstore::KV> data;
     TagID lastTagId = 0;
     VertexID lastVertexId = "";
@@ -461,6 +615,7 @@ void UpgraderSpace::runPartV2() {
 
     while (iter && iter->valid()) {
       auto key = iter->key();
+      reads.add(key, iter->val());
       if (NebulaKeyUtilsV2::isVertex(spaceVidLen_, key)) {
         auto vId = NebulaKeyUtilsV2::getVertexId(spaceVidLen_, key).str();
         auto tagId = NebulaKeyUtilsV2::getTagId(spaceVidLen_, key);
@@ -544,36 +699,15 @@ void UpgraderSpace::runPartV2() {
         lastDstVertexId = dvId;
       }
 
-      if (data.size() >= FLAGS_write_batch_num) {
-        VLOG(2) << "Send record total rows " << data.size();
-        auto code = writeEngine_->multiPut(data);
-        if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
-          LOG(FATAL) << "Write multi put in space id " << spaceId_ << " part id " << partId
-                     << " failed.";
-        }
-        data.clear();
-      }
-
+      writer.add(data);
       iter->next();
     }
-
-    auto code = writeEngine_->multiPut(data);
-    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
-      LOG(FATAL) << "Write multi put in space id " << spaceId_ << " part id " << partId
-                 << " failed.";
-    }
-    data.clear();
+    writer.add(data);
+    writer.finish();
     LOG(INFO) << "Handle vertex/edge/index data in space id " << spaceId_ << " part id " << partId
               << " succeed";
 
-    auto unFinishedPart = --unFinishedPart_;
-    if (unFinishedPart == 0) {
-      // all parts has finished
-      LOG(INFO) << "Handle last part: " << partId << " vertex/edge/index data in space id "
-                << spaceId_ << " finished.";
-    } else {
-      pool_->add(std::bind(&UpgraderSpace::runPartV2, this));
-    }
+    partFinished(partId, &UpgraderSpace::runPartV2);
   } else {
     LOG(INFO) << "Handle vertex/edge/index of parts data in space id " << spaceId_ << " finished";
   }
@@ -900,50 +1034,15 @@ void UpgraderSpace::runPartV3() {
       LOG(ERROR) << "Handle vertex/edge/index data in space id " << spaceId_ << " part id "
                  << partId << " failed";
 
-      auto unFinishedPart = --unFinishedPart_;
-      if (unFinishedPart == 0) {
-        // all parts has finished
-        LOG(INFO) << "Handle last part: " << partId << " vertex/edge/index data in space id "
-                  << spaceId_ << " finished";
-      } else {
-        pool_->add(std::bind(&UpgraderSpace::runPartV3, this));
-      }
+      partFinished(partId, &UpgraderSpace::runPartV3);
       return;
     }
-    int64_t ingestFileCount = 0;
-    auto write_sst = [&, this](const std::vector<kvstore::KV>& data) {
-      ::rocksdb::Options option;
-      option.create_if_missing = true;
-      option.compression = ::rocksdb::CompressionType::kNoCompression;
-      ::rocksdb::SstFileWriter sst_file_writer(::rocksdb::EnvOptions(), option);
-      std::string file = ::fmt::format(".nebula_upgrade.space-{}.part-{}-{}-{}.sst",
-                                       spaceId_,
-                                       partId,
-                                       ingestFileCount++,
-                                       std::time(nullptr));
-      ::rocksdb::Status s = sst_file_writer.Open(file);
-      if (!s.ok()) {
-        LOG(FATAL) << "Faild upgrade V3 of space " << spaceId_ << ", part " << partId << ":"
-                   << s.code();
-      }
-      for (auto item : data) {
-        s = sst_file_writer.Put(item.first, item.second);
-        if (!s.ok()) {
-          LOG(FATAL) << "Faild upgrade V3 of space " << spaceId_ << ", part " << partId << ":"
-                     << s.code();
-        }
-      }
-      s = sst_file_writer.Finish();
-      if (!s.ok()) {
-        LOG(FATAL) << "Faild upgrade V3 of space " << spaceId_ << ", part " << partId << ":"
-                   << s.code();
-      }
-      std::lock_guard<std::mutex> lck(this->ingest_sst_file_mut_);
-      ingest_sst_file_.push_back(file);
-    };
+    SstBatchWriter writer(readEngine_.get(), partId, partBufferBytes_);
+    ReadCounter reads;
     std::vector<kvstore::KV> data;
     std::string lastVertexKey = "";
     while (iter && iter->valid()) {
+      reads.add(iter->key(), iter->val());
       auto vertex = NebulaKeyUtilsV3::getVertexKey(iter->key());
       if (vertex == lastVertexKey) {
         iter->next();
@@ -951,27 +1050,14 @@ void UpgraderSpace::runPartV3() {
       }
       data.emplace_back(vertex, "");
       lastVertexKey = vertex;
-      if (data.size() >= 100000) {
-        write_sst(data);
-        data.clear();
-      }
+      writer.add(data);
       iter->next();
     }
-    if (!data.empty()) {
-      write_sst(data);
-      data.clear();
-    }
+    writer.finish();
     LOG(INFO) << "Handle vertex/edge/index data in space id " << spaceId_ << " part id " << partId
               << " succeed";
 
-    auto unFinishedPart = --unFinishedPart_;
-    if (unFinishedPart == 0) {
-      // all parts has finished
-      LOG(INFO) << "Handle last part: " << partId << " vertex/edge/index data in space id "
-                << spaceId_ << " finished.";
-    } else {
-      pool_->add(std::bind(&UpgraderSpace::runPartV3, this));
-    }
+    partFinished(partId, &UpgraderSpace::runPartV3);
   } else {
     LOG(INFO) << "Handle vertex/edge/index of parts data in space id " << spaceId_ << " finished";
   }
@@ -992,12 +1078,6 @@ void UpgraderSpace::doProcessV3() {
     sleep(10);
   }
 
-  if (ingest_sst_file_.size() != 0) {
-    auto code = readEngine_->ingest(ingest_sst_file_, true);
-    if (code != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
-      LOG(FATAL) << "Faild upgrade 2:3 when ingest sst file:" << static_cast<int>(code);
-    }
-  }
   readEngine_->put(NebulaKeyUtils::dataVersionKey(), NebulaKeyUtilsV3::dataVersionValue());
 }
 std::vector<std::string> UpgraderSpace::indexVertexKeys(
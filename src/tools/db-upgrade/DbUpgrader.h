@@ -17,6 +17,7 @@
 #include "common/base/Status.h"
 #include "common/meta/ServerBasedIndexManager.h"
 #include "common/meta/ServerBasedSchemaManager.h"
+#include "kvstore/RateLimiter.h"
 #include "kvstore/RocksEngine.h"
 
 DECLARE_string(src_db_path);
@@ -27,10 +28,79 @@ DECLARE_string(upgrade_version);
 DECLARE_bool(compactions);
 DECLARE_uint32(max_concurrent_parts);
 DECLARE_uint32(max_concurrent_spaces);
+DECLARE_uint32(memory_budget_mb);
+DECLARE_uint32(max_io_mb_per_sec);
+DECLARE_uint32(progress_interval_secs);
 
 namespace nebula {
 namespace storage {
 
+// The progress of the upgrade of all data paths
+class UpgradeProgress final {
+ public:
+  static UpgradeProgress& instance() {
+    static UpgradeProgress progress;
+    return progress;
+  }
+
+  // Account the keys read, and wait if the io is over max_io_mb_per_sec
+  void read(int64_t keys, int64_t bytes);
+
+  // Account the keys written, and wait if the io is over max_io_mb_per_sec
+  void written(int64_t keys, int64_t bytes);
+
+  // Log the progress, and the throughput since the last report
+  void report();
+
+  std::atomic<int64_t> partsTotal{0};
+  std::atomic<int64_t> partsDone{0};
+
+ private:
+  UpgradeProgress();
+
+  void throttle(int64_t bytes);
+
+ private:
+  std::atomic<int64_t> keysRead_{0};
+  std::atomic<int64_t> bytesRead_{0};
+  std::atomic<int64_t> keysWritten_{0};
+  std::atomic<int64_t> bytesWritten_{0};
+  std::unique_ptr<kvstore::RateLimiter> limiter_;
+
+  // The state of the last report
+  int64_t lastTimeMs_;
+  int64_t lastBytesRead_{0};
+  int64_t lastBytesWritten_{0};
+};
+
+// Buffer the kvs of a part, and write them to sst files which are ingested into the engine, rather
+// than writing them by batches. The kvs are sorted when they are written, and the later ones of
+// the same key take precedence as in batches.
+class SstBatchWriter final {
+ public:
+  SstBatchWriter(kvstore::RocksEngine* engine, PartitionID partId, size_t bufferBytes);
+
+  ~SstBatchWriter();
+
+  // Take the kvs, they are written once the buffer is full
+  void add(std::vector<kvstore::KV>& data);
+
+  // Write the kvs buffered
+  void finish();
+
+ private:
+  void flush();
+
+ private:
+  kvstore::RocksEngine* engine_;
+  PartitionID partId_;
+  size_t bufferBytes_;
+  std::string dir_;
+  std::vector<kvstore::KV> buffer_;
+  size_t bufferedBytes_{0};
+  int32_t files_{0};
+};
+
 // Upgrade a space of data path in storage conf
 class UpgraderSpace {
  public:
@@ -118,6 +188,9 @@ class UpgraderSpace {
 
   void runPartV3();
 
+  // The end of a part, run the next one in the queue
+  void partFinished(PartitionID partId, void (UpgraderSpace::*runPart)());
+
  public:
   // Source data path
   std::string srcPath_;
@@ -167,8 +240,8 @@ class UpgraderSpace {
 
   std::atomic<size_t> unFinishedPart_;
 
-  std::mutex ingest_sst_file_mut_;
-  std::vector<std::string> ingest_sst_file_;
+  // The memory of the kvs buffered by each part
+  size_t partBufferBytes_;
 };
 
 // Upgrade one data path in storage conf
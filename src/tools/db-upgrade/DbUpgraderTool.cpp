@@ -7,6 +7,8 @@
 #include "kvstore/RocksEngineConfig.h"
 #include "tools/db-upgrade/DbUpgrader.h"
 
+DECLARE_bool(move_files);
+
 void printHelp() {
   fprintf(
       stderr,
@@ -46,7 +48,8 @@ required:
 
  optional:
        --write_batch_num=<N>
-         The size of the batch written to rocksdb.
+         The size of the batch of the system data written to rocksdb, the
+         vertices, edges and indexes are written to sst files.
          Default: 100
 
        --compactions=<true|false>
@@ -60,6 +63,19 @@ required:
        --max_concurrent_spaces<N>
          Maximum number of concurrent spaces allowed.
          Default: 5
+
+       --memory_budget_mb=<N>
+         The memory of the data buffered before written to sst files, shared by
+         the parts processed simultaneously on all data paths.
+         Default: 4096
+
+       --max_io_mb_per_sec=<N>
+         The max MB read and written in one second, 0 means no limit.
+         Default: 0
+
+       --progress_interval_secs=<N>
+         The interval to report the progress and throughput.
+         Default: 30
 )");
 }
 
@@ -75,6 +91,8 @@ void printParams() {
   std::cout << "maximum number of concurrent parts allowed:" << FLAGS_max_concurrent_parts << "\n";
   std::cout << "maximum number of concurrent spaces allowed: " << FLAGS_max_concurrent_spaces
             << "\n";
+  std::cout << "memory budget: " << FLAGS_memory_budget_mb << "MB\n";
+  std::cout << "max io: " << FLAGS_max_io_mb_per_sec << "MB/s\n";
   std::cout << "===========================PARAMS============================\n\n";
 }
 
@@ -105,6 +123,8 @@ int main(int argc, char* argv[]) {
   }
 
   google::SetStderrLogging(google::INFO);
+  // The sst files written are next to the data, so they are linked rather than copied
+  FLAGS_move_files = true;
 
   printParams();
 
@@ -194,10 +214,28 @@ int main(int argc, char* argv[]) {
     }));
   }
 
+  std::mutex lock;
+  std::condition_variable cond;
+  bool finished = false;
+  std::thread reporter([&] {
+    std::unique_lock<std::mutex> guard(lock);
+    auto interval = std::chrono::seconds(std::max(FLAGS_progress_interval_secs, 1U));
+    while (!cond.wait_for(guard, interval, [&] { return finished; })) {
+      nebula::storage::UpgradeProgress::instance().report();
+    }
+  });
+
   // Wait for all threads to finish
   for (auto& t : threads) {
     t.join();
   }
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    finished = true;
+  }
+  cond.notify_one();
+  reporter.join();
+  nebula::storage::UpgradeProgress::instance().report();
 
   LOG(INFO) << "Upgrade phase end";
   return 0;
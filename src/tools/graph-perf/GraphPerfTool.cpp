@@ -0,0 +1,601 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
+#include <folly/init/Init.h>
+#include <folly/json.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
+
+#include "common/base/Base.h"
+#include "common/base/StatusOr.h"
+#include "common/graph/Response.h"
+#include "common/network/NetworkUtils.h"
+#include "common/thrift/ThriftClientManager.h"
+#include "interface/gen-cpp2/GraphServiceAsyncClient.h"
+
+DEFINE_string(graph_server_addrs, "127.0.0.1:9669", "The addresses of graphd, the load is spread");
+DEFINE_string(user, "root", "The user to authenticate as");
+DEFINE_string(password, "nebula", "The password of the user");
+DEFINE_string(space_name, "snb", "The space of the dataset");
+DEFINE_int32(io_threads, 8, "Client io threads");
+DEFINE_int32(timeout_ms, 60000, "The timeout of a query");
+
+// The dataset
+DEFINE_bool(prepare,
+            false,
+            "Create the space and the schema, and load the dataset before the run. The schema is "
+            "Person-[KNOWS]->Person and Person-[LIKES]->Post, the ids of persons are [1, persons] "
+            "and the ids of posts follow");
+DEFINE_int32(partition_num, 10, "The partitions of the space created");
+DEFINE_int32(replica_factor, 1, "The replicas of the space created");
+DEFINE_int32(schema_wait_secs, 20, "How long to wait for the schema created to be loaded");
+DEFINE_int64(persons, 100000, "The number of persons");
+DEFINE_int32(avg_knows, 20, "The average number of persons a person knows");
+DEFINE_int32(posts_per_person, 5, "The number of posts of a person");
+DEFINE_int32(avg_likes, 10, "The average number of posts a person likes");
+DEFINE_int32(load_batch, 500, "The vertices or edges inserted by a statement when loading");
+DEFINE_int32(load_concurrency, 16, "The insert statements in flight when loading");
+DEFINE_string(sst_hdfs_path,
+              "",
+              "Load the dataset by downloading and ingesting the sst files under the hdfs path, "
+              "which are generated by an external tool such as nebula-exchange, instead of "
+              "inserting it");
+
+// The run
+DEFINE_string(mix,
+              "go:30,match:20,path:10,lookup:20,insert:20",
+              "The weights of the classes of queries, of go, match, path, lookup and insert");
+DEFINE_double(qps, 100, "The target rate of arrivals of queries");
+DEFINE_int32(duration_secs, 60, "How long to run");
+DEFINE_int32(max_inflight,
+             1000,
+             "The arrivals are dropped when so many queries are in flight, rather than delayed");
+DEFINE_int64(seed, 0, "The seed of the generator of the dataset and queries, 0 means random");
+DEFINE_int64(profile_slow_ms,
+             1000,
+             "The queries slower than so many milliseconds are run again by PROFILE after the "
+             "run, 0 means none");
+DEFINE_int32(profile_max_outliers, 10, "The max number of slow queries profiled");
+DEFINE_string(profile_dump_path,
+              "graph_perf_profiles.json",
+              "Where the profiles of the slow queries are dumped");
+DEFINE_string(json_output, "", "Where the result is written as json if not empty");
+
+namespace nebula {
+namespace graph {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief A load tool driving graphd end to end, by the queries of an LDBC SNB like dataset. The
+ * arrivals are open loop, i.e. a poisson process of the target rate regardless of the responses,
+ * and the latency of a query is counted from its arrival, so a slow server is not hidden by
+ * fewer queries sent.
+ */
+class GraphPerf {
+ public:
+  int run() {
+    auto addrs = network::NetworkUtils::toHosts(FLAGS_graph_server_addrs);
+    if (!addrs.ok() || addrs.value().empty()) {
+      LOG(ERROR) << "Illegal graph_server_addrs: " << FLAGS_graph_server_addrs;
+      return EXIT_FAILURE;
+    }
+    hosts_ = std::move(addrs).value();
+    auto status = parseMix();
+    if (!status.ok()) {
+      LOG(ERROR) << status;
+      return EXIT_FAILURE;
+    }
+    rng_.seed(FLAGS_seed != 0 ? FLAGS_seed : std::random_device()());
+    ioPool_ = std::make_shared<folly::IOThreadPoolExecutor>(FLAGS_io_threads);
+
+    // A session of each graphd, which is shared by the queries sent to it
+    for (const auto& host : hosts_) {
+      auto session = authenticate(host);
+      if (!session.ok()) {
+        LOG(ERROR) << "Failed to authenticate to " << host << ": " << session.status();
+        return EXIT_FAILURE;
+      }
+      sessions_.emplace_back(session.value());
+    }
+    if (FLAGS_prepare) {
+      status = prepare();
+      if (!status.ok()) {
+        LOG(ERROR) << "Failed to prepare the dataset: " << status;
+        return EXIT_FAILURE;
+      }
+    }
+    for (size_t i = 0; i < hosts_.size(); i++) {
+      auto resp = execute(i, "USE " + FLAGS_space_name);
+      if (!resp.ok()) {
+        LOG(ERROR) << "Failed to use the space: " << resp.status();
+        return EXIT_FAILURE;
+      }
+    }
+
+    drive();
+    report();
+    profileOutliers();
+
+    for (size_t i = 0; i < hosts_.size(); i++) {
+      auto* evb = ioPool_->getEventBase();
+      folly::via(evb, [this, evb, i] {
+        auto client = clientMan_.client(hosts_[i], evb, false, FLAGS_timeout_ms);
+        return client->future_signout(sessions_[i]);
+      }).wait();
+    }
+    ioPool_->stop();
+    return EXIT_SUCCESS;
+  }
+
+ private:
+  enum class QueryClass { kGo = 0, kMatch, kPath, kLookup, kInsert, kMax };
+
+  struct ClassStats {
+    std::mutex lock;
+    std::vector<int64_t> latenciesUs;
+    int64_t errors{0};
+    int64_t dropped{0};
+  };
+
+  struct Outlier {
+    QueryClass queryClass;
+    std::string stmt;
+    int64_t latencyUs;
+  };
+
+  static const char* className(QueryClass queryClass) {
+    static const char* kNames[] = {"go", "match", "path", "lookup", "insert"};
+    return kNames[static_cast<size_t>(queryClass)];
+  }
+
+  Status parseMix() {
+    std::vector<folly::StringPiece> entries;
+    folly::split(",", FLAGS_mix, entries, true);
+    for (auto entry : entries) {
+      folly::StringPiece name, weight;
+      if (!folly::split(":", entry, name, weight)) {
+        return Status::Error("Illegal mix: %s", FLAGS_mix.c_str());
+      }
+      name = folly::trimWhitespace(name);
+      size_t i = 0;
+      for (; i < static_cast<size_t>(QueryClass::kMax); i++) {
+        if (name == className(static_cast<QueryClass>(i))) {
+          break;
+        }
+      }
+      auto value = folly::tryTo<double>(folly::trimWhitespace(weight));
+      if (i == static_cast<size_t>(QueryClass::kMax) || !value.hasValue() || value.value() < 0) {
+        return Status::Error("Illegal mix: %s", FLAGS_mix.c_str());
+      }
+      weights_[i] = value.value();
+    }
+    if (std::all_of(weights_.begin(), weights_.end(), [](auto w) { return w == 0; })) {
+      return Status::Error("No query in the mix: %s", FLAGS_mix.c_str());
+    }
+    return Status::OK();
+  }
+
+  StatusOr<int64_t> authenticate(const HostAddr& host) {
+    auto* evb = ioPool_->getEventBase();
+    auto resp = folly::via(evb,
+                           [this, evb, &host] {
+                             auto client = clientMan_.client(host, evb, false, FLAGS_timeout_ms);
+                             return client->future_authenticate(FLAGS_user, FLAGS_password);
+                           })
+                    .getTry();
+    if (resp.hasException()) {
+      return Status::Error("%s", resp.exception().what().c_str());
+    }
+    auto& auth = resp.value();
+    if (auth.errorCode != ErrorCode::SUCCEEDED || auth.sessionId == nullptr) {
+      return Status::Error("%s", auth.errorMsg != nullptr ? auth.errorMsg->c_str() : "");
+    }
+    return *auth.sessionId;
+  }
+
+  folly::Future<ExecutionResponse> executeAsync(size_t session, std::string stmt) {
+    auto* evb = ioPool_->getEventBase();
+    return folly::via(evb, [this, evb, session, stmt = std::move(stmt)]() mutable {
+      auto client = clientMan_.client(hosts_[session], evb, false, FLAGS_timeout_ms);
+      return client->future_execute(sessions_[session], std::move(stmt));
+    });
+  }
+
+  StatusOr<ExecutionResponse> execute(size_t session, std::string stmt) {
+    auto resp = executeAsync(session, std::move(stmt)).getTry();
+    if (resp.hasException()) {
+      return Status::Error("%s", resp.exception().what().c_str());
+    }
+    if (resp.value().errorCode != ErrorCode::SUCCEEDED) {
+      auto* msg = resp.value().errorMsg.get();
+      return Status::Error("%s", msg != nullptr ? msg->c_str() : "");
+    }
+    return std::move(resp).value();
+  }
+
+  Status prepare() {
+    const std::vector<std::string> schema = {
+        folly::sformat("CREATE SPACE IF NOT EXISTS {}(partition_num={}, replica_factor={}, "
+                       "vid_type=INT64)",
+                       FLAGS_space_name,
+                       FLAGS_partition_num,
+                       FLAGS_replica_factor),
+        "USE " + FLAGS_space_name,
+        "CREATE TAG IF NOT EXISTS Person(firstName string, lastName string, gender string, "
+        "birthday int, creationDate int)",
+        "CREATE TAG IF NOT EXISTS Post(content string, length int, creationDate int)",
+        "CREATE EDGE IF NOT EXISTS KNOWS(creationDate int)",
+        "CREATE EDGE IF NOT EXISTS LIKES(creationDate int)",
+        "CREATE TAG INDEX IF NOT EXISTS person_birthday ON Person(birthday)",
+    };
+    for (const auto& stmt : schema) {
+      auto resp = execute(0, stmt);
+      if (!resp.ok()) {
+        return Status::Error("%s: %s", stmt.c_str(), resp.status().toString().c_str());
+      }
+      if (stmt.find("CREATE SPACE") == 0) {
+        std::this_thread::sleep_for(std::chrono::seconds(FLAGS_schema_wait_secs));
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(FLAGS_schema_wait_secs));
+
+    if (!FLAGS_sst_hdfs_path.empty()) {
+      for (const auto& stmt : {"SUBMIT JOB DOWNLOAD HDFS \"" + FLAGS_sst_hdfs_path + "\"",
+                               std::string("SUBMIT JOB INGEST")}) {
+        auto resp = execute(0, stmt);
+        if (!resp.ok()) {
+          return Status::Error("%s: %s", stmt.c_str(), resp.status().toString().c_str());
+        }
+        LOG(INFO) << stmt << " submitted, wait for the job to finish before a run";
+      }
+      return Status::OK();
+    }
+    return loadDataset();
+  }
+
+  // Insert the dataset batch by batch, the statements of a batch are generated by gen(i)
+  Status insertBatches(const std::string& what,
+                       int64_t total,
+                       const std::function<std::string(int64_t)>& gen) {
+    std::vector<folly::Future<ExecutionResponse>> inflight;
+    auto wait = [&inflight]() -> Status {
+      auto results = folly::collectAll(inflight).get();
+      inflight.clear();
+      for (auto& result : results) {
+        if (result.hasException()) {
+          return Status::Error("%s", result.exception().what().c_str());
+        }
+        if (result.value().errorCode != ErrorCode::SUCCEEDED) {
+          auto* msg = result.value().errorMsg.get();
+          return Status::Error("%s", msg != nullptr ? msg->c_str() : "");
+        }
+      }
+      return Status::OK();
+    };
+    for (int64_t i = 0; i < total; i += FLAGS_load_batch) {
+      std::string stmt;
+      for (int64_t j = i; j < std::min<int64_t>(i + FLAGS_load_batch, total); j++) {
+        stmt.append(j == i ? "" : ", ").append(gen(j));
+      }
+      inflight.emplace_back(executeAsync(i / FLAGS_load_batch % hosts_.size(), what + stmt));
+      if (inflight.size() >= static_cast<size_t>(FLAGS_load_concurrency)) {
+        NG_RETURN_IF_ERROR(wait());
+      }
+      LOG_EVERY_N(INFO, 100) << what << i << "/" << total;
+    }
+    return wait();
+  }
+
+  Status loadDataset() {
+    static const std::vector<std::string> kFirstNames = {
+        "Jan", "Ali", "Yang", "Maria", "John", "Anh", "Carlos", "Ivan", "Chen", "Ken"};
+    static const std::vector<std::string> kLastNames = {
+        "Smith", "Wang", "Garcia", "Kumar", "Ivanov", "Kim", "Silva", "Chen", "Nguyen", "Li"};
+    auto persons = FLAGS_persons;
+    NG_RETURN_IF_ERROR(insertBatches(
+        "INSERT VERTEX Person(firstName, lastName, gender, birthday, creationDate) VALUES ",
+        persons,
+        [this](int64_t i) {
+          return folly::sformat("{}:(\"{}\", \"{}\", \"{}\", {}, {})",
+                                i + 1,
+                                kFirstNames[rng_() % kFirstNames.size()],
+                                kLastNames[rng_() % kLastNames.size()],
+                                rng_() % 2 == 0 ? "male" : "female",
+                                randomBirthday(),
+                                randomDate());
+        }));
+    NG_RETURN_IF_ERROR(insertBatches(
+        "INSERT VERTEX Post(content, length, creationDate) VALUES ", posts(), [this](int64_t i) {
+          auto length = 20 + rng_() % 200;
+          return folly::sformat("{}:(\"{}\", {}, {})",
+                                FLAGS_persons + i + 1,
+                                std::string(length, 'x'),
+                                length,
+                                randomDate());
+        }));
+    NG_RETURN_IF_ERROR(insertBatches("INSERT EDGE KNOWS(creationDate) VALUES ",
+                                     persons * FLAGS_avg_knows,
+                                     [this](int64_t i) {
+                                       return folly::sformat("{}->{}:({})",
+                                                             i / FLAGS_avg_knows + 1,
+                                                             skewedPerson(),
+                                                             randomDate());
+                                     }));
+    NG_RETURN_IF_ERROR(insertBatches(
+        "INSERT EDGE LIKES(creationDate) VALUES ", persons * FLAGS_avg_likes, [this](int64_t i) {
+          return folly::sformat("{}->{}:({})",
+                                i / FLAGS_avg_likes + 1,
+                                FLAGS_persons + 1 + rng_() % std::max<int64_t>(posts(), 1),
+                                randomDate());
+        }));
+    LOG(INFO) << "Loaded " << persons << " persons and " << posts() << " posts";
+    return Status::OK();
+  }
+
+  int64_t posts() const {
+    return FLAGS_persons * FLAGS_posts_per_person;
+  }
+
+  int64_t randomPerson() {
+    return 1 + rng_() % FLAGS_persons;
+  }
+
+  // The degrees of persons follow a power law as the ones of SNB, a few persons are known a lot
+  int64_t skewedPerson() {
+    auto u = std::uniform_real_distribution<double>(0, 1)(rng_);
+    return 1 + static_cast<int64_t>(std::pow(u, 3) * (FLAGS_persons - 1));
+  }
+
+  int64_t randomBirthday() {
+    return 19500101 + (rng_() % 56) * 10000 + (1 + rng_() % 12) * 100 + 1 + rng_() % 28;
+  }
+
+  int64_t randomDate() {
+    // Seconds in [2010, 2013), the time range of SNB
+    return 1262304000 + rng_() % (3 * 365 * 86400);
+  }
+
+  QueryClass randomClass() {
+    auto total = std::accumulate(weights_.begin(), weights_.end(), 0.0);
+    auto point = std::uniform_real_distribution<double>(0, total)(rng_);
+    for (size_t i = 0; i < weights_.size(); i++) {
+      if (point < weights_[i]) {
+        return static_cast<QueryClass>(i);
+      }
+      point -= weights_[i];
+    }
+    return QueryClass::kGo;
+  }
+
+  std::string makeQuery(QueryClass queryClass) {
+    switch (queryClass) {
+      case QueryClass::kGo:
+        return folly::sformat(
+            "GO 1 TO 2 STEPS FROM {} OVER KNOWS YIELD DISTINCT dst(edge) AS friend | LIMIT 100",
+            randomPerson());
+      case QueryClass::kMatch:
+        // The recent posts liked by the friends, like the interactive complex read 2 of SNB
+        return folly::sformat(
+            "MATCH (p:Person)-[:KNOWS]->(f:Person)-[l:LIKES]->(m:Post) WHERE id(p) == {} "
+            "RETURN id(f) AS friend, id(m) AS post, l.creationDate AS date "
+            "ORDER BY date DESC LIMIT 20",
+            randomPerson());
+      case QueryClass::kPath:
+        return folly::sformat(
+            "FIND SHORTEST PATH FROM {} TO {} OVER KNOWS UPTO 4 STEPS YIELD path AS p",
+            randomPerson(),
+            randomPerson());
+      case QueryClass::kLookup:
+        return folly::sformat(
+            "LOOKUP ON Person WHERE Person.birthday == {} YIELD id(vertex) AS id",
+            randomBirthday());
+      case QueryClass::kInsert:
+        return folly::sformat("INSERT EDGE KNOWS(creationDate) VALUES {}->{}:({})",
+                              randomPerson(),
+                              skewedPerson(),
+                              randomDate());
+      case QueryClass::kMax:
+        break;
+    }
+    LOG(FATAL) << "Unknown query class";
+    return "";
+  }
+
+  void drive() {
+    LOG(INFO) << "Run " << FLAGS_mix << " at " << FLAGS_qps << " qps for " << FLAGS_duration_secs
+              << " seconds";
+    std::exponential_distribution<double> interval(FLAGS_qps);
+    auto start = Clock::now();
+    auto end = start + std::chrono::seconds(FLAGS_duration_secs);
+    auto arrival = start;
+    auto lastProgress = start;
+    size_t next = 0;
+    while (true) {
+      arrival += std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(interval(rng_)));
+      if (arrival >= end) {
+        break;
+      }
+      std::this_thread::sleep_until(arrival);
+      auto queryClass = randomClass();
+      auto& stats = stats_[static_cast<size_t>(queryClass)];
+      if (inflight_.load() >= FLAGS_max_inflight) {
+        std::lock_guard<std::mutex> guard(stats.lock);
+        stats.dropped++;
+        continue;
+      }
+      inflight_++;
+      auto stmt = makeQuery(queryClass);
+      executeAsync(next++ % hosts_.size(), stmt)
+          .thenTry([this, queryClass, arrival, stmt](folly::Try<ExecutionResponse>&& resp) {
+            auto latencyUs =
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - arrival)
+                    .count();
+            bool failed = resp.hasException() || resp.value().errorCode != ErrorCode::SUCCEEDED;
+            onFinished(queryClass, stmt, latencyUs, failed);
+          });
+      if (Clock::now() - lastProgress >= std::chrono::seconds(10)) {
+        lastProgress = Clock::now();
+        LOG(INFO) << "Progress " << std::chrono::duration_cast<std::chrono::seconds>(
+                                        lastProgress - start)
+                                        .count()
+                  << "s, in flight " << inflight_.load();
+      }
+    }
+    // Let the queries in flight finish
+    while (inflight_.load() > 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    elapsedSecs_ = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  void onFinished(QueryClass queryClass, const std::string& stmt, int64_t latencyUs, bool failed) {
+    auto& stats = stats_[static_cast<size_t>(queryClass)];
+    {
+      std::lock_guard<std::mutex> guard(stats.lock);
+      if (failed) {
+        stats.errors++;
+      } else {
+        stats.latenciesUs.emplace_back(latencyUs);
+      }
+    }
+    if (!failed && FLAGS_profile_slow_ms > 0 && latencyUs > FLAGS_profile_slow_ms * 1000) {
+      std::lock_guard<std::mutex> guard(outliersLock_);
+      if (outliers_.size() < static_cast<size_t>(FLAGS_profile_max_outliers)) {
+        outliers_.emplace_back(Outlier{queryClass, stmt, latencyUs});
+      }
+    }
+    inflight_--;
+  }
+
+  void report() {
+    auto percentile = [](const std::vector<int64_t>& sorted, double pct) {
+      auto index = static_cast<size_t>(pct * (sorted.size() - 1));
+      return sorted[index] / 1000.0;
+    };
+    LOG(INFO) << folly::sformat("{:<8}{:>10}{:>10}{:>8}{:>8}{:>10}{:>10}{:>10}{:>10}{:>10}",
+                                "class",
+                                "queries",
+                                "qps",
+                                "errors",
+                                "dropped",
+                                "p50(ms)",
+                                "p90(ms)",
+                                "p99(ms)",
+                                "p999(ms)",
+                                "max(ms)");
+    folly::dynamic json = folly::dynamic::object();
+    json["target_qps"] = FLAGS_qps;
+    json["mix"] = FLAGS_mix;
+    json["elapsed_secs"] = elapsedSecs_;
+    json["classes"] = folly::dynamic::object();
+    for (size_t i = 0; i < stats_.size(); i++) {
+      auto& stats = stats_[i];
+      std::lock_guard<std::mutex> guard(stats.lock);
+      if (weights_[i] == 0) {
+        continue;
+      }
+      auto& latencies = stats.latenciesUs;
+      auto queries = latencies.size();
+      std::sort(latencies.begin(), latencies.end());
+      if (latencies.empty()) {
+        latencies.emplace_back(0);
+      }
+      LOG(INFO) << folly::sformat(
+          "{:<8}{:>10}{:>10.1f}{:>8}{:>8}{:>10.2f}{:>10.2f}{:>10.2f}{:>10.2f}{:>10.2f}",
+          className(static_cast<QueryClass>(i)),
+          queries,
+          queries / elapsedSecs_,
+          stats.errors,
+          stats.dropped,
+          percentile(latencies, 0.5),
+          percentile(latencies, 0.9),
+          percentile(latencies, 0.99),
+          percentile(latencies, 0.999),
+          latencies.back() / 1000.0);
+      folly::dynamic entry = folly::dynamic::object();
+      entry["queries"] = static_cast<int64_t>(queries);
+      entry["qps"] = queries / elapsedSecs_;
+      entry["errors"] = stats.errors;
+      entry["dropped"] = stats.dropped;
+      entry["p50_ms"] = percentile(latencies, 0.5);
+      entry["p90_ms"] = percentile(latencies, 0.9);
+      entry["p99_ms"] = percentile(latencies, 0.99);
+      entry["p999_ms"] = percentile(latencies, 0.999);
+      entry["max_ms"] = latencies.back() / 1000.0;
+      json["classes"][className(static_cast<QueryClass>(i))] = std::move(entry);
+    }
+    if (!FLAGS_json_output.empty() &&
+        !folly::writeFile(folly::toPrettyJson(json), FLAGS_json_output.c_str())) {
+      LOG(ERROR) << "Failed to write the result to " << FLAGS_json_output;
+    }
+  }
+
+  // Run the slow queries again by PROFILE, the plans show where the time went on the server
+  void profileOutliers() {
+    if (outliers_.empty()) {
+      return;
+    }
+    folly::dynamic profiles = folly::dynamic::array();
+    for (const auto& outlier : outliers_) {
+      folly::dynamic entry = folly::dynamic::object();
+      entry["class"] = className(outlier.queryClass);
+      entry["statement"] = outlier.stmt;
+      entry["latency_us"] = outlier.latencyUs;
+      auto resp = execute(0, "PROFILE " + outlier.stmt);
+      if (!resp.ok()) {
+        entry["error"] = resp.status().toString();
+      } else {
+        entry["profiled_latency_us"] = resp.value().latencyInUs;
+        if (resp.value().planDesc != nullptr) {
+          entry["plan"] = resp.value().planDesc->toJson();
+        }
+      }
+      profiles.push_back(std::move(entry));
+    }
+    if (!folly::writeFile(folly::toPrettyJson(profiles), FLAGS_profile_dump_path.c_str())) {
+      LOG(ERROR) << "Failed to write the profiles to " << FLAGS_profile_dump_path;
+      return;
+    }
+    LOG(INFO) << "The profiles of " << outliers_.size() << " slow queries are dumped to "
+              << FLAGS_profile_dump_path;
+  }
+
+ private:
+  std::vector<HostAddr> hosts_;
+  std::vector<int64_t> sessions_;
+  std::shared_ptr<folly::IOThreadPoolExecutor> ioPool_;
+  thrift::ThriftClientManager<cpp2::GraphServiceAsyncClient> clientMan_;
+  // Only used by the thread driving the run
+  std::mt19937_64 rng_;
+  std::array<double, static_cast<size_t>(QueryClass::kMax)> weights_{};
+  std::array<ClassStats, static_cast<size_t>(QueryClass::kMax)> stats_;
+  std::atomic<int32_t> inflight_{0};
+  double elapsedSecs_{0};
+  std::mutex outliersLock_;
+  std::vector<Outlier> outliers_;
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+  nebula::graph::GraphPerf perf;
+  return perf.run();
+}
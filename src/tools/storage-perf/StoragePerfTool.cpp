@@ -3,11 +3,15 @@
  * This source code is licensed under Apache 2.0 License.
  */
 
+#include <folly/FileUtil.h>
 #include <folly/TokenBucket.h>
-#include <folly/stats/BucketedTimeSeries.h>
-#include <folly/stats/TimeseriesHistogram.h>
+#include <folly/json.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
 
+#include <cmath>
+#include <fstream>
+#include <random>
+
 #include "clients/storage/StorageClient.h"
 #include "common/base/Base.h"
 #include "common/thread/GenericWorker.h"
@@ -22,9 +26,18 @@ DEFINE_string(method,
               "method type being tested,"
               "such as getNeighbors, addVertices, addEdges, "
               "getVertices, getEdges");
+DEFINE_string(mix,
+              "",
+              "The weights of the methods tested together, e.g. getNeighbors:80,addEdges:20, "
+              "only the method of --method is tested if empty");
 DEFINE_string(meta_server_addrs, "", "meta server address");
 DEFINE_int32(min_vertex_id, 1, "The smallest vertex Id, need convert to string");
 DEFINE_int32(max_vertex_id, 10000, "The biggest vertex Id, need convert to string");
+DEFINE_string(vid_distribution,
+              "uniform",
+              "The distribution of the vertices read, uniform or zipf, by which a few vertices "
+              "are hot");
+DEFINE_double(zipf_theta, 0.99, "The skew of the zipf distribution, in (0, 1)");
 DEFINE_string(space_name, "test", "Specify the space name");
 DEFINE_string(tag_name,
               "test_tag",
@@ -38,20 +51,156 @@ DEFINE_int32(property_size, 1000, "The property size of per property");
 DEFINE_bool(random_message, true, "Whether to write random message to storage service");
 DEFINE_int32(concurrency, 50, "concurrent requests");
 DEFINE_int32(batch_num, 1, "batch vertices for one request");
+DEFINE_bool(open_loop,
+            false,
+            "Send the requests as a poisson process of --qps regardless of the responses, and "
+            "count the latency from the intended sending time, so a slow server is not hidden by "
+            "fewer requests sent. Otherwise the requests are sent by --threads in a closed loop");
+DEFINE_int32(max_inflight,
+             10000,
+             "The requests are dropped when so many are in flight in the open loop, rather than "
+             "delayed");
+DEFINE_string(json_output, "", "Where the result is written as json if not empty");
+DEFINE_string(timeline_output,
+              "",
+              "Where the latencies of each interval are appended as json lines if not empty, to "
+              "see how they change over time, e.g. during a balance or compaction");
+DEFINE_int32(timeline_interval_ms, 1000, "The interval of --timeline_output");
 
 DECLARE_int32(heartbeat_interval_secs);
 
 namespace nebula {
 namespace storage {
 
-thread_local uint32_t position = 1;
+/**
+ * @brief A histogram of latencies in the manner of HdrHistogram: the values below 64 are exact,
+ * and the larger ones are in buckets of 1/32 of their power of two, so any percentile is within
+ * about 3% of the true value. It is lock free.
+ */
+class LatencyHistogram final {
+ public:
+  void add(uint64_t value) {
+    counts_[index(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    auto max = max_.load(std::memory_order_relaxed);
+    while (value > max && !max_.compare_exchange_weak(max, value)) {
+    }
+  }
 
-class Perf {
+  uint64_t count() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t max() const {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  double mean() const {
+    auto count = this->count();
+    return count == 0 ? 0 : static_cast<double>(sum_.load(std::memory_order_relaxed)) / count;
+  }
+
+  // Not atomic as a whole, the values added during a reset may be partly kept
+  void reset() {
+    for (auto& count : counts_) {
+      count.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+  }
+
+  // The highest value of the bucket where the percentile falls, pct is in [0, 1]
+  uint64_t percentile(double pct) const {
+    auto count = this->count();
+    if (count == 0) {
+      return 0;
+    }
+    auto target = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(pct * count)), 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; i++) {
+      seen += counts_[i].load(std::memory_order_relaxed);
+      if (seen >= target) {
+        return std::min(highest(i), max());
+      }
+    }
+    return max();
+  }
+
+ private:
+  static constexpr int kSubBits = 6;
+  static constexpr uint64_t kSub = 1 << kSubBits;
+  static constexpr uint64_t kHalf = kSub / 2;
+  static constexpr size_t kBuckets = kSub + (64 - kSubBits) * kHalf;
+
+  static size_t index(uint64_t value) {
+    if (value < kSub) {
+      return value;
+    }
+    auto shift = 64 - __builtin_clzll(value) - kSubBits;
+    return kSub + (shift - 1) * kHalf + ((value >> shift) - kHalf);
+  }
+
+  static uint64_t highest(size_t index) {
+    if (index < kSub) {
+      return index;
+    }
+    auto shift = (index - kSub) / kHalf + 1;
+    auto sub = (index - kSub) % kHalf + kHalf;
+    return ((sub + 1) << shift) - 1;
+  }
+
+ private:
+  std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * @brief The zipfian generator of YCSB, rank i in [0, n) is drawn with probability proportional
+ * to 1 / (i + 1)^theta. The ranks are scattered over the range so the hot vertices are not
+ * neighbours, e.g. of the same part.
+ */
+class ZipfGenerator final {
  public:
-  Perf()
-      : latencies_(10, 0, 3000, {10, {std::chrono::seconds(20)}}),
-        qps_(10, 0, 1000000, {10, {std::chrono::seconds(20)}}) {}
+  ZipfGenerator(uint64_t n, double theta) : n_(std::max<uint64_t>(n, 1)), theta_(theta) {
+    for (uint64_t i = 1; i <= n_; i++) {
+      zetaN_ += 1.0 / std::pow(i, theta_);
+    }
+    auto zeta2 = 1.0 + 1.0 / std::pow(2, theta_);
+    alpha_ = 1.0 / (1.0 - theta_);
+    eta_ = (1.0 - std::pow(2.0 / n_, 1.0 - theta_)) / (1.0 - zeta2 / zetaN_);
+    halfPowTheta_ = 1.0 + std::pow(0.5, theta_);
+  }
+
+  uint64_t next() {
+    auto u = folly::Random::randDouble01();
+    auto uz = u * zetaN_;
+    uint64_t rank = 0;
+    if (uz < 1.0) {
+      rank = 0;
+    } else if (uz < halfPowTheta_) {
+      rank = 1;
+    } else {
+      rank = static_cast<uint64_t>(n_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+    }
+    // A prime much larger than n is coprime to n, so it permutes the ranks
+    return (std::min(rank, n_ - 1) * 2654435761ULL) % n_;
+  }
+
+ private:
+  const uint64_t n_;
+  const double theta_;
+  double zetaN_{0};
+  double alpha_;
+  double eta_;
+  double halfPowTheta_;
+};
 
+class Perf {
+ public:
   int run() {
     LOG(INFO) << "Total threads " << FLAGS_threads << ", qps " << FLAGS_qps;
     auto metaAddrsRet = nebula::network::NetworkUtils::toHosts(FLAGS_meta_server_addrs);
@@ -60,7 +209,17 @@ class Perf {
                  << ", FLAGS_meta_server_addrs:" << FLAGS_meta_server_addrs;
       return EXIT_FAILURE;
     }
-
+    if (!parseMix()) {
+      LOG(ERROR) << "Illegal mix: " << FLAGS_mix << ", method: " << FLAGS_method;
+      return EXIT_FAILURE;
+    }
+    if (FLAGS_vid_distribution == "zipf") {
+      zipf_ = std::make_unique<ZipfGenerator>(FLAGS_max_vertex_id - FLAGS_min_vertex_id,
+                                              FLAGS_zipf_theta);
+    } else if (FLAGS_vid_distribution != "uniform") {
+      LOG(ERROR) << "Unknown vid_distribution: " << FLAGS_vid_distribution;
+      return EXIT_FAILURE;
+    }
     threadPool_ = std::make_shared<folly::IOThreadPoolExecutor>(FLAGS_io_threads);
     meta::MetaClientOptions options;
     options.skipConfig_ = true;
@@ -131,61 +290,266 @@ class Perf {
     }
 
     storageClient_ = std::make_unique<StorageClient>(threadPool_, mClient_.get());
+    std::thread timeline;
+    if (!FLAGS_timeline_output.empty()) {
+      timeline = std::thread(&Perf::runTimeline, this);
+    }
     time::Duration duration;
 
-    std::vector<std::thread> threads;
-    threads.reserve(FLAGS_threads);
-    for (int i = 0; i < FLAGS_threads; i++) {
-      threads.emplace_back(std::bind(&Perf::runInternal, this));
+    if (FLAGS_open_loop) {
+      runOpenLoop();
+    } else {
+      std::vector<std::thread> threads;
+      threads.reserve(FLAGS_threads);
+      for (int i = 0; i < FLAGS_threads; i++) {
+        threads.emplace_back(std::bind(&Perf::runInternal, this));
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
     }
-    for (auto& t : threads) {
-      t.join();
+    // Let the requests in flight finish
+    while (inflight_.load() > 0) {
+      usleep(1000);
+    }
+    auto elapsedMs = duration.elapsedInMSec();
+    if (timeline.joinable()) {
+      stopped_ = true;
+      timeline.join();
     }
 
     mClient_->notifyStop();
     mClient_->stop();
     threadPool_->stop();
-    LOG(INFO) << "Total time cost " << duration.elapsedInMSec() << "ms, "
+    LOG(INFO) << "Total time cost " << elapsedMs << "ms, "
               << "total requests " << finishedRequests_;
+    report(elapsedMs);
     return 0;
   }
 
+  // The closed loop, each thread sends the requests of the tokens it takes
   void runInternal() {
     while (finishedRequests_ < FLAGS_totalReqs) {
-      if (FLAGS_method == "getNeighbors") {
-        getNeighborsTask();
-      } else if (FLAGS_method == "addVertices") {
-        addVerticesTask();
-      } else if (FLAGS_method == "addEdges") {
-        addEdgesTask();
-      } else if (FLAGS_method == "getVertices") {
-        getVerticesTask();
-      } else if (FLAGS_method == "getEdges") {
-        getEdgesTask();
-      } else {
-        LOG(FATAL) << "Should not reach here.";
+      auto tokens = tokenBucket_.consumeOrDrain(FLAGS_concurrency, FLAGS_qps, FLAGS_concurrency);
+      for (auto i = 0; i < tokens; i++) {
+        send(randomMethod(), time::WallClock::fastNowInMicroSec());
       }
       PLOG_EVERY_N(INFO, 2000) << "Progress "
                                << finishedRequests_ / static_cast<double>(FLAGS_totalReqs) * 100
-                               << "%"
-                               << ", qps=" << qps_.rate(0) << ", latency(us) median = "
-                               << latencies_.getPercentileEstimate(0.5, 0)
-                               << ", p90 = " << latencies_.getPercentileEstimate(0.9, 0)
-                               << ", p99 = " << latencies_.getPercentileEstimate(0.99, 0);
+                               << "%, in flight " << inflight_.load();
       usleep(500);
     }
   }
 
+  // The open loop, the requests arrive as a poisson process regardless of the responses
+  void runOpenLoop() {
+    std::mt19937_64 rng(folly::Random::rand64());
+    std::exponential_distribution<double> interval(FLAGS_qps);
+    auto arrival = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < FLAGS_totalReqs; i++) {
+      arrival += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(interval(rng)));
+      std::this_thread::sleep_until(arrival);
+      // The latency counts from when the request should have been sent
+      auto intended = time::WallClock::fastNowInMicroSec() -
+                      std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - arrival)
+                          .count();
+      auto& method = randomMethod();
+      if (inflight_.load() >= FLAGS_max_inflight) {
+        method.dropped++;
+        windows_[window_.load()].dropped++;
+        continue;
+      }
+      send(method, intended);
+      LOG_EVERY_N(INFO, 10000) << "Progress " << i / static_cast<double>(FLAGS_totalReqs) * 100
+                               << "%, in flight " << inflight_.load();
+    }
+  }
+
+  // Append the latencies of all methods in each interval to --timeline_output. The windows are
+  // swapped at each interval, so a request is counted in the interval when it finishes.
+  void runTimeline() {
+    std::ofstream out(FLAGS_timeline_output, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+      LOG(ERROR) << "Failed to open " << FLAGS_timeline_output;
+      return;
+    }
+    auto interval = std::chrono::milliseconds(std::max(FLAGS_timeline_interval_ms, 1));
+    auto next = std::chrono::steady_clock::now() + interval;
+    while (!stopped_.load()) {
+      std::this_thread::sleep_until(next);
+      next += interval;
+      auto& window = windows_[window_.load()];
+      window_ = 1 - window_.load();
+      // Let the requests which have taken the old window add to it
+      usleep(1000);
+      auto& latencies = window.latencies;
+      folly::dynamic entry = folly::dynamic::object();
+      entry["time_ms"] = time::WallClock::fastNowInMilliSec();
+      entry["requests"] = latencies.count();
+      entry["errors"] = window.errors.load();
+      entry["dropped"] = window.dropped.load();
+      entry["in_flight"] = inflight_.load();
+      entry["mean_us"] = latencies.mean();
+      entry["p50_us"] = latencies.percentile(0.5);
+      entry["p99_us"] = latencies.percentile(0.99);
+      entry["p999_us"] = latencies.percentile(0.999);
+      entry["max_us"] = latencies.max();
+      out << folly::toJson(entry) << std::endl;
+      latencies.reset();
+      window.errors = 0;
+      window.dropped = 0;
+    }
+  }
+
  private:
+  struct Window {
+    LatencyHistogram latencies;
+    std::atomic<int64_t> errors{0};
+    std::atomic<int64_t> dropped{0};
+  };
+
+  struct Method {
+    std::string name;
+    double weight{0};
+    LatencyHistogram latencies;
+    std::atomic<int64_t> errors{0};
+    std::atomic<int64_t> dropped{0};
+  };
+
+  bool parseMix() {
+    static const std::vector<std::string> kMethods = {
+        "getNeighbors", "addVertices", "addEdges", "getVertices", "getEdges"};
+    std::vector<std::string> entries;
+    if (FLAGS_mix.empty()) {
+      entries.emplace_back(FLAGS_method + ":1");
+    } else {
+      folly::split(",", FLAGS_mix, entries, true);
+    }
+    for (const auto& entry : entries) {
+      std::string name;
+      double weight = 0;
+      if (!folly::split(":", entry, name, weight) || weight < 0 ||
+          std::find(kMethods.begin(), kMethods.end(), name) == kMethods.end()) {
+        return false;
+      }
+      auto method = std::make_unique<Method>();
+      method->name = name;
+      method->weight = weight;
+      totalWeight_ += weight;
+      methods_.emplace_back(std::move(method));
+    }
+    return totalWeight_ > 0;
+  }
+
+  Method& randomMethod() {
+    auto point = folly::Random::randDouble(0, totalWeight_);
+    for (auto& method : methods_) {
+      if (point < method->weight) {
+        return *method;
+      }
+      point -= method->weight;
+    }
+    return *methods_.back();
+  }
+
+  void send(Method& method, int64_t start) {
+    inflight_++;
+    folly::Future<bool> future = folly::makeFuture(false);
+    if (method.name == "getNeighbors") {
+      future = getNeighborsTask();
+    } else if (method.name == "addVertices") {
+      future = addVerticesTask();
+    } else if (method.name == "addEdges") {
+      future = addEdgesTask();
+    } else if (method.name == "getVertices") {
+      future = getVerticesTask();
+    } else if (method.name == "getEdges") {
+      future = getEdgesTask();
+    } else {
+      LOG(FATAL) << "Should not reach here.";
+    }
+    std::move(future).thenTry([this, &method, start](folly::Try<bool>&& succeeded) {
+      if (succeeded.hasException() || !succeeded.value()) {
+        LOG_EVERY_N(ERROR, 100) << "Request of " << method.name << " failed";
+        method.errors++;
+        windows_[window_.load()].errors++;
+      } else {
+        auto latency = time::WallClock::fastNowInMicroSec() - start;
+        method.latencies.add(latency);
+        windows_[window_.load()].latencies.add(latency);
+      }
+      finishedRequests_++;
+      inflight_--;
+    });
+  }
+
+  void report(int64_t elapsedMs) {
+    auto seconds = std::max<double>(elapsedMs / 1000.0, 0.001);
+    LOG(INFO) << folly::sformat("{:<14}{:>10}{:>10}{:>8}{:>8}{:>10}{:>10}{:>10}{:>10}{:>10}",
+                                "method",
+                                "requests",
+                                "qps",
+                                "errors",
+                                "dropped",
+                                "p50(us)",
+                                "p90(us)",
+                                "p99(us)",
+                                "p999(us)",
+                                "max(us)");
+    folly::dynamic json = folly::dynamic::object();
+    json["open_loop"] = FLAGS_open_loop;
+    json["target_qps"] = FLAGS_qps;
+    json["vid_distribution"] = FLAGS_vid_distribution;
+    json["elapsed_ms"] = elapsedMs;
+    json["methods"] = folly::dynamic::object();
+    for (const auto& method : methods_) {
+      auto& latencies = method->latencies;
+      LOG(INFO) << folly::sformat(
+          "{:<14}{:>10}{:>10.1f}{:>8}{:>8}{:>10}{:>10}{:>10}{:>10}{:>10}",
+          method->name,
+          latencies.count(),
+          latencies.count() / seconds,
+          method->errors.load(),
+          method->dropped.load(),
+          latencies.percentile(0.5),
+          latencies.percentile(0.9),
+          latencies.percentile(0.99),
+          latencies.percentile(0.999),
+          latencies.max());
+      folly::dynamic entry = folly::dynamic::object();
+      entry["requests"] = latencies.count();
+      entry["qps"] = latencies.count() / seconds;
+      entry["errors"] = method->errors.load();
+      entry["dropped"] = method->dropped.load();
+      entry["mean_us"] = latencies.mean();
+      entry["p50_us"] = latencies.percentile(0.5);
+      entry["p90_us"] = latencies.percentile(0.9);
+      entry["p99_us"] = latencies.percentile(0.99);
+      entry["p999_us"] = latencies.percentile(0.999);
+      entry["max_us"] = latencies.max();
+      json["methods"][method->name] = std::move(entry);
+    }
+    if (!FLAGS_json_output.empty() &&
+        !folly::writeFile(folly::toPrettyJson(json), FLAGS_json_output.c_str())) {
+      LOG(ERROR) << "Failed to write the result to " << FLAGS_json_output;
+    }
+  }
+
+  VertexID randomVertex() {
+    auto range = FLAGS_max_vertex_id - FLAGS_min_vertex_id;
+    auto offset = zipf_ != nullptr ? zipf_->next() : folly::Random::rand32(range);
+    return std::to_string(FLAGS_min_vertex_id + offset);
+  }
+
   std::vector<VertexID> randomVertices() {
-    return {std::to_string(FLAGS_min_vertex_id +
-                           folly::Random::rand32(FLAGS_max_vertex_id - FLAGS_min_vertex_id))};
+    return {randomVertex()};
   }
 
   std::vector<Value> randomEdges() {
     std::vector<Value> values;
-    auto src =
-        folly::Random::rand32(FLAGS_max_vertex_id - FLAGS_min_vertex_id) + FLAGS_min_vertex_id;
+    auto src = folly::to<int64_t>(randomVertex());
     values.emplace_back(std::to_string(src));
     values.emplace_back(edgeType_);
     values.emplace_back(0);
@@ -240,12 +604,11 @@ class Perf {
 
   std::vector<cpp2::NewVertex> genVertices() {
     std::vector<cpp2::NewVertex> newVertices;
-    static int vintId = FLAGS_min_vertex_id;
+    static std::atomic<int> vintId{FLAGS_min_vertex_id};
 
     for (int32_t i = 0; i < FLAGS_batch_num; i++) {
       storage::cpp2::NewVertex v;
-      v.id_ref() = std::to_string(vintId);
-      vintId++;
+      v.id_ref() = std::to_string(vintId++);
       std::vector<nebula::storage::cpp2::NewTag> newTags;
       storage::cpp2::NewTag newTag;
       newTag.tag_id_ref() = tagId_;
@@ -260,25 +623,25 @@ class Perf {
 
   std::vector<cpp2::NewEdge> genEdges() {
     std::vector<cpp2::NewEdge> edges;
-    static int vintId = FLAGS_min_vertex_id;
+    static std::atomic<int> vintId{FLAGS_min_vertex_id};
 
     for (int32_t i = 0; i < FLAGS_batch_num; i++) {
       cpp2::NewEdge edge;
       cpp2::EdgeKey eKey;
-      eKey.src_ref() = std::to_string(vintId);
+      auto src = vintId++;
+      eKey.src_ref() = std::to_string(src);
       eKey.edge_type_ref() = edgeType_;
-      eKey.dst_ref() = std::to_string(vintId + 1);
+      eKey.dst_ref() = std::to_string(src + 1);
       eKey.ranking_ref() = 0;
       edge.key_ref() = std::move(eKey);
       auto props = genData(edgeProps_.size());
       edge.props_ref() = std::move(props);
       edges.emplace_back(std::move(edge));
-      vintId++;
     }
     return edges;
   }
 
-  void getNeighborsTask() {
+  folly::Future<bool> getNeighborsTask() {
     auto* evb = threadPool_->getEventBase();
     std::vector<std::string> colNames;
     colNames.emplace_back(kVid);
@@ -294,96 +657,44 @@ class Perf {
     auto vProps = vertexProps();
     auto eProps = edgeProps();
 
-    auto tokens = tokenBucket_.consumeOrDrain(FLAGS_concurrency, FLAGS_qps, FLAGS_concurrency);
-    for (auto i = 0; i < tokens; i++) {
-      auto start = time::WallClock::fastNowInMicroSec();
-
-      StorageClient::CommonRequestParam param(spaceId_, 0, 0, false);
-      storageClient_
-          ->getNeighbors(param,
-                         colNames,
-                         vertices,
-                         {edgeType_},
-                         edgeDire,
-                         &statProps,
-                         &vProps,
-                         &eProps,
-                         nullptr)
-          .via(evb)
-          .thenValue([this, start](auto&& resps) {
-            if (!resps.succeeded()) {
-              LOG(ERROR) << "Request failed!";
-            } else {
-              VLOG(3) << "request succeeded!";
-            }
-            this->finishedRequests_++;
-            auto now = time::WallClock::fastNowInMicroSec();
-            latencies_.addValue(std::chrono::seconds(time::WallClock::fastNowInSec()), now - start);
-            qps_.addValue(std::chrono::seconds(time::WallClock::fastNowInSec()), 1);
-          })
-          .thenError([this](auto&& e) {
-            LOG(ERROR) << "request failed, e = " << e.what();
-            this->finishedRequests_++;
-          });
-    }
+    StorageClient::CommonRequestParam param(spaceId_, 0, 0, false);
+    return storageClient_
+        ->getNeighbors(param,
+                       colNames,
+                       vertices,
+                       {edgeType_},
+                       edgeDire,
+                       &statProps,
+                       &vProps,
+                       &eProps,
+                       nullptr)
+        .via(evb)
+        .thenValue([](auto&& resps) { return resps.succeeded(); });
   }
 
-  void addVerticesTask() {
+  folly::Future<bool> addVerticesTask() {
     auto* evb = threadPool_->getEventBase();
-    auto tokens = tokenBucket_.consumeOrDrain(FLAGS_concurrency, FLAGS_qps, FLAGS_concurrency);
-    for (auto i = 0; i < tokens; i++) {
-      auto start = time::WallClock::fastNowInMicroSec();
-      StorageClient::CommonRequestParam param(spaceId_, 0, 0);
-      storageClient_->addVertices(param, genVertices(), tagProps_, true, false)
-          .via(evb)
-          .thenValue([this, start](auto&& resps) {
-            if (!resps.succeeded()) {
-              for (auto& entry : resps.failedParts()) {
-                LOG(ERROR) << "Request failed, part " << entry.first << ", error "
-                           << apache::thrift::util::enumNameSafe(entry.second);
-              }
-            } else {
-              VLOG(1) << "request succeeded!";
-            }
-            this->finishedRequests_++;
-            auto now = time::WallClock::fastNowInMicroSec();
-            latencies_.addValue(std::chrono::seconds(time::WallClock::fastNowInSec()), now - start);
-            qps_.addValue(std::chrono::seconds(time::WallClock::fastNowInSec()), 1);
-          })
-          .thenError([this](auto&& e) {
-            LOG(ERROR) << "Request failed, e = " << e.what();
-            this->finishedRequests_++;
-          });
-    }
+    StorageClient::CommonRequestParam param(spaceId_, 0, 0);
+    return storageClient_->addVertices(param, genVertices(), tagProps_, true, false)
+        .via(evb)
+        .thenValue([](auto&& resps) {
+          for (auto& entry : resps.failedParts()) {
+            LOG(ERROR) << "Request failed, part " << entry.first << ", error "
+                       << apache::thrift::util::enumNameSafe(entry.second);
+          }
+          return resps.succeeded();
+        });
   }
 
-  void addEdgesTask() {
+  folly::Future<bool> addEdgesTask() {
     auto* evb = threadPool_->getEventBase();
-    auto tokens = tokenBucket_.consumeOrDrain(FLAGS_concurrency, FLAGS_qps, FLAGS_concurrency);
-    for (auto i = 0; i < tokens; i++) {
-      auto start = time::WallClock::fastNowInMicroSec();
-      StorageClient::CommonRequestParam param(spaceId_, 0, 0);
-      storageClient_->addEdges(param, genEdges(), edgeProps_, true, false)
-          .via(evb)
-          .thenValue([this, start](auto&& resps) {
-            if (!resps.succeeded()) {
-              LOG(ERROR) << "Request failed!";
-            } else {
-              VLOG(3) << "request succeeded!";
-            }
-            this->finishedRequests_++;
-            auto now = time::WallClock::fastNowInMicroSec();
-            latencies_.addValue(std::chrono::seconds(time::WallClock::fastNowInSec()), now - start);
-            qps_.addValue(std::chrono::seconds(time::WallClock::fastNowInSec()), 1);
-          })
-          .thenError([this](auto&&) {
-            LOG(ERROR) << "Request failed!";
-            this->finishedRequests_++;
-          });
-    }
+    StorageClient::CommonRequestParam param(spaceId_, 0, 0);
+    return storageClient_->addEdges(param, genEdges(), edgeProps_, true, false)
+        .via(evb)
+        .thenValue([](auto&& resps) { return resps.succeeded(); });
   }
 
-  void getVerticesTask() {
+  folly::Future<bool> getVerticesTask() {
     auto* evb = threadPool_->getEventBase();
     nebula::DataSet input;
     input.colNames = {kVid};
@@ -394,47 +705,23 @@ class Perf {
     }
     input.emplace_back(std::move(row));
     auto vProps = vertexProps();
-    auto start = time::WallClock::fastNowInMicroSec();
     StorageClient::CommonRequestParam param(spaceId_, 0, 0);
-    storageClient_->getProps(param, std::move(input), &vProps, nullptr, nullptr)
+    return storageClient_->getProps(param, std::move(input), &vProps, nullptr, nullptr)
         .via(evb)
-        .thenValue([this, start](auto&& resps) {
-          if (!resps.succeeded()) {
-            LOG(ERROR) << "Request failed!";
-          } else {
-            VLOG(3) << "request succeeded!";
-          }
-          this->finishedRequests_++;
-          auto now = time::WallClock::fastNowInMicroSec();
-          latencies_.addValue(std::chrono::seconds(time::WallClock::fastNowInSec()), now - start);
-          qps_.addValue(std::chrono::seconds(time::WallClock::fastNowInSec()), 1);
-        })
-        .thenError([](auto&&) { LOG(ERROR) << "Request failed!"; });
+        .thenValue([](auto&& resps) { return resps.succeeded(); });
   }
 
-  void getEdgesTask() {
+  folly::Future<bool> getEdgesTask() {
     auto* evb = threadPool_->getEventBase();
     nebula::DataSet input;
     input.colNames = {kSrc, kType, kRank, kDst};
     nebula::Row row(randomEdges());
     input.emplace_back(std::move(row));
     auto eProps = edgeProps();
-    auto start = time::WallClock::fastNowInMicroSec();
     StorageClient::CommonRequestParam param(spaceId_, 0, 0);
-    storageClient_->getProps(param, std::move(input), nullptr, &eProps, nullptr)
+    return storageClient_->getProps(param, std::move(input), nullptr, &eProps, nullptr)
         .via(evb)
-        .thenValue([this, start](auto&& resps) {
-          if (!resps.succeeded()) {
-            LOG(ERROR) << "Request failed!";
-          } else {
-            VLOG(3) << "request succeeded!";
-          }
-          this->finishedRequests_++;
-          auto now = time::WallClock::fastNowInMicroSec();
-          latencies_.addValue(std::chrono::seconds(time::WallClock::fastNowInSec()), now - start);
-          qps_.addValue(std::chrono::seconds(time::WallClock::fastNowInSec()), 1);
-        })
-        .thenError([](auto&&) { LOG(ERROR) << "Request failed!"; });
+        .thenValue([](auto&& resps) { return resps.succeeded(); });
   }
 
  private:
@@ -448,8 +735,13 @@ class Perf {
   std::unordered_map<TagID, std::vector<std::string>> tagProps_;
   std::vector<std::string> edgeProps_;
   folly::DynamicTokenBucket tokenBucket_;
-  folly::TimeseriesHistogram<int64_t> latencies_;
-  folly::TimeseriesHistogram<int64_t> qps_;
+  std::vector<std::unique_ptr<Method>> methods_;
+  double totalWeight_{0};
+  std::unique_ptr<ZipfGenerator> zipf_;
+  std::atomic<int32_t> inflight_{0};
+  std::array<Window, 2> windows_;
+  std::atomic<int32_t> window_{0};
+  std::atomic<bool> stopped_{false};
 };
 
 }  // namespace storage
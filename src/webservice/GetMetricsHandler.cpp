@@ -0,0 +1,67 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "webservice/GetMetricsHandler.h"
+
+#include <proxygen/httpserver/ResponseBuilder.h>
+#include <proxygen/lib/http/ProxygenErrorEnum.h>
+
+#include "common/stats/StatsManager.h"
+
+namespace nebula {
+
+using nebula::stats::StatsManager;
+using proxygen::HTTPMessage;
+using proxygen::HTTPMethod;
+using proxygen::ProxygenError;
+using proxygen::ResponseBuilder;
+using proxygen::UpgradeProtocol;
+
+void GetMetricsHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
+  if (!headers->getMethod() || headers->getMethod().value() != HTTPMethod::GET) {
+    // Unsupported method
+    err_ = HttpCode::E_UNSUPPORTED_METHOD;
+    return;
+  }
+}
+
+void GetMetricsHandler::onBody(std::unique_ptr<folly::IOBuf>) noexcept {
+  // Do nothing, we only support GET
+}
+
+void GetMetricsHandler::onEOM() noexcept {
+  switch (err_) {
+    case HttpCode::E_UNSUPPORTED_METHOD:
+      ResponseBuilder(downstream_)
+          .status(WebServiceUtils::to(HttpStatusCode::METHOD_NOT_ALLOWED),
+                  WebServiceUtils::toString(HttpStatusCode::METHOD_NOT_ALLOWED))
+          .sendWithEOM();
+      return;
+    default:
+      break;
+  }
+
+  ResponseBuilder(downstream_)
+      .status(WebServiceUtils::to(HttpStatusCode::OK),
+              WebServiceUtils::toString(HttpStatusCode::OK))
+      .header("Content-Type", "text/plain; version=0.0.4; charset=utf-8")
+      .body(StatsManager::readAllPrometheus())
+      .sendWithEOM();
+}
+
+void GetMetricsHandler::onUpgrade(UpgradeProtocol) noexcept {
+  // Do nothing
+}
+
+void GetMetricsHandler::requestComplete() noexcept {
+  delete this;
+}
+
+void GetMetricsHandler::onError(ProxygenError err) noexcept {
+  LOG(ERROR) << "Web service GetMetricsHandler got error: " << proxygen::getErrorString(err);
+  delete this;
+}
+
+}  // namespace nebula
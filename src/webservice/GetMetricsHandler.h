@@ -0,0 +1,41 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef WEBSERVICE_GETMETRICSHANDLER_H_
+#define WEBSERVICE_GETMETRICSHANDLER_H_
+
+#include <proxygen/httpserver/RequestHandler.h>
+
+#include "common/base/Base.h"
+#include "webservice/Common.h"
+
+namespace nebula {
+
+/**
+ * @brief Export the stats and gauges in the text exposition format of Prometheus, so that they
+ * could be scraped directly
+ */
+class GetMetricsHandler : public proxygen::RequestHandler {
+ public:
+  GetMetricsHandler() = default;
+
+  void onRequest(std::unique_ptr<proxygen::HTTPMessage> headers) noexcept override;
+
+  void onBody(std::unique_ptr<folly::IOBuf> body) noexcept override;
+
+  void onEOM() noexcept override;
+
+  void onUpgrade(proxygen::UpgradeProtocol proto) noexcept override;
+
+  void requestComplete() noexcept override;
+
+  void onError(proxygen::ProxygenError err) noexcept override;
+
+ private:
+  HttpCode err_{HttpCode::SUCCEEDED};
+};
+
+}  // namespace nebula
+#endif  // WEBSERVICE_GETMETRICSHANDLER_H_
@@ -0,0 +1,148 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "webservice/ProfileHandler.h"
+
+#include <proxygen/httpserver/ResponseBuilder.h>
+#include <proxygen/lib/http/ProxygenErrorEnum.h>
+
+#include "webservice/Profiler.h"
+
+DEFINE_int32(ws_max_profile_seconds, 300, "The longest duration of a profile by the web service");
+
+namespace nebula {
+
+using proxygen::HTTPMessage;
+using proxygen::HTTPMethod;
+using proxygen::ProxygenError;
+using proxygen::ResponseBuilder;
+using proxygen::UpgradeProtocol;
+
+void ProfileHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
+  if (!headers->getMethod() || headers->getMethod().value() != HTTPMethod::GET) {
+    // Unsupported method
+    err_ = HttpCode::E_UNSUPPORTED_METHOD;
+    return;
+  }
+  if (headers->hasQueryParam("seconds")) {
+    auto seconds = folly::tryTo<int32_t>(headers->getQueryParam("seconds"));
+    if (!seconds.hasValue() || seconds.value() <= 0 ||
+        seconds.value() > FLAGS_ws_max_profile_seconds) {
+      err_ = HttpCode::E_ILLEGAL_ARGUMENT;
+      errMsg_ = folly::stringPrintf("The seconds should be in [1, %d]",
+                                    FLAGS_ws_max_profile_seconds);
+      return;
+    }
+    seconds_ = seconds.value();
+  }
+  if (headers->hasQueryParam("hz")) {
+    auto hz = folly::tryTo<int32_t>(headers->getQueryParam("hz"));
+    if (!hz.hasValue() || hz.value() <= 0 || hz.value() > 1000) {
+      err_ = HttpCode::E_ILLEGAL_ARGUMENT;
+      errMsg_ = "The hz should be in [1, 1000]";
+      return;
+    }
+    hz_ = hz.value();
+  }
+  const auto& format = headers->getQueryParam("format");
+  if (kind_ == Kind::kCpu) {
+    if (!format.empty() && format != "pprof" && format != "folded") {
+      err_ = HttpCode::E_ILLEGAL_ARGUMENT;
+      errMsg_ = "The format should be pprof or folded";
+      return;
+    }
+    folded_ = format == "folded";
+  } else if (kind_ == Kind::kContention) {
+    if (!format.empty() && format != "folded") {
+      err_ = HttpCode::E_ILLEGAL_ARGUMENT;
+      errMsg_ = "The contention profile is only in folded format";
+      return;
+    }
+    folded_ = true;
+  }
+}
+
+void ProfileHandler::onBody(std::unique_ptr<folly::IOBuf>) noexcept {
+  // Do nothing, we only support GET
+}
+
+void ProfileHandler::onEOM() noexcept {
+  switch (err_) {
+    case HttpCode::E_UNSUPPORTED_METHOD:
+      ResponseBuilder(downstream_)
+          .status(WebServiceUtils::to(HttpStatusCode::METHOD_NOT_ALLOWED),
+                  WebServiceUtils::toString(HttpStatusCode::METHOD_NOT_ALLOWED))
+          .sendWithEOM();
+      return;
+    case HttpCode::E_ILLEGAL_ARGUMENT:
+      ResponseBuilder(downstream_)
+          .status(WebServiceUtils::to(HttpStatusCode::BAD_REQUEST),
+                  WebServiceUtils::toString(HttpStatusCode::BAD_REQUEST))
+          .body(errMsg_)
+          .sendWithEOM();
+      return;
+    default:
+      break;
+  }
+
+  StatusOr<std::string> profile;
+  switch (kind_) {
+    case Kind::kCpu: {
+      LOG(INFO) << "Take a CPU profile of " << seconds_ << " seconds at " << hz_ << " hz";
+      auto samples = Profiler::profileCpu(seconds_, hz_);
+      if (!samples.ok()) {
+        profile = samples.status();
+      } else if (folded_) {
+        profile = Profiler::toFolded(samples.value());
+      } else {
+        profile = Profiler::toPprof(samples.value(), 1000000 / hz_);
+      }
+      break;
+    }
+    case Kind::kContention: {
+      LOG(INFO) << "Take a contention profile of " << seconds_ << " seconds";
+      auto samples = Profiler::profileContention(seconds_);
+      if (!samples.ok()) {
+        profile = samples.status();
+      } else {
+        profile = Profiler::toFolded(samples.value());
+      }
+      break;
+    }
+    case Kind::kHeap:
+      profile = Profiler::dumpHeap();
+      break;
+  }
+
+  if (!profile.ok()) {
+    ResponseBuilder(downstream_)
+        .status(WebServiceUtils::to(HttpStatusCode::FORBIDDEN),
+                WebServiceUtils::toString(HttpStatusCode::FORBIDDEN))
+        .body(profile.status().toString())
+        .sendWithEOM();
+    return;
+  }
+  ResponseBuilder(downstream_)
+      .status(WebServiceUtils::to(HttpStatusCode::OK),
+              WebServiceUtils::toString(HttpStatusCode::OK))
+      .header("Content-Type", folded_ ? "text/plain" : "application/octet-stream")
+      .body(std::move(profile).value())
+      .sendWithEOM();
+}
+
+void ProfileHandler::onUpgrade(UpgradeProtocol) noexcept {
+  // Do nothing
+}
+
+void ProfileHandler::requestComplete() noexcept {
+  delete this;
+}
+
+void ProfileHandler::onError(ProxygenError err) noexcept {
+  LOG(ERROR) << "Web service ProfileHandler got error: " << proxygen::getErrorString(err);
+  delete this;
+}
+
+}  // namespace nebula
@@ -0,0 +1,55 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef WEBSERVICE_PROFILEHANDLER_H_
+#define WEBSERVICE_PROFILEHANDLER_H_
+
+#include <proxygen/httpserver/RequestHandler.h>
+
+#include "common/base/Base.h"
+#include "webservice/Common.h"
+
+namespace nebula {
+
+/**
+ * @brief Take a profile of this process on demand, for example:
+ *   /pprof/profile?seconds=30&hz=99&format=pprof  the CPU profile in pprof or folded format
+ *   /pprof/contention?seconds=30                   the waits for the profiled mutexes, folded
+ *   /pprof/heap                                    the heap profile of jemalloc
+ * The request returns after the profile is taken.
+ */
+class ProfileHandler : public proxygen::RequestHandler {
+ public:
+  enum class Kind {
+    kCpu,
+    kContention,
+    kHeap,
+  };
+
+  explicit ProfileHandler(Kind kind) : kind_(kind) {}
+
+  void onRequest(std::unique_ptr<proxygen::HTTPMessage> headers) noexcept override;
+
+  void onBody(std::unique_ptr<folly::IOBuf> body) noexcept override;
+
+  void onEOM() noexcept override;
+
+  void onUpgrade(proxygen::UpgradeProtocol proto) noexcept override;
+
+  void requestComplete() noexcept override;
+
+  void onError(proxygen::ProxygenError err) noexcept override;
+
+ private:
+  const Kind kind_;
+  HttpCode err_{HttpCode::SUCCEEDED};
+  std::string errMsg_;
+  int32_t seconds_{30};
+  int32_t hz_{99};
+  bool folded_{false};
+};
+
+}  // namespace nebula
+#endif  // WEBSERVICE_PROFILEHANDLER_H_
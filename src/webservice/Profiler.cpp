@@ -0,0 +1,248 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "webservice/Profiler.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <folly/FileUtil.h>
+#include <folly/ScopeGuard.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "common/thread/ProfiledMutex.h"
+
+// Defined when linked with jemalloc
+extern "C" int mallctl(const char* name, void* oldp, size_t* oldlenp, void* newp, size_t newlen)
+    __attribute__((__weak__));
+
+namespace nebula {
+namespace {
+
+constexpr int kMaxCpuDepth = 32;
+// The samples beyond are dropped, e.g. 30 seconds of 16 busy threads at 99 hz fit in
+constexpr size_t kMaxCpuSamples = 1 << 16;
+// The frames of the signal handler and the signal trampoline
+constexpr int kSignalFrames = 2;
+
+struct CpuSample {
+  // Set after the frames are written, zero if the sample is not taken
+  std::atomic<int32_t> depth{0};
+  void* frames[kMaxCpuDepth];
+};
+
+// Whether a CPU profile is running
+std::atomic<bool> gCpuProfiling{false};
+// Whether the signal handler takes samples
+std::atomic<bool> gCpuSampling{false};
+std::atomic<size_t> gNextCpuSample{0};
+// Allocated by the first profile and never freed, a late signal could still be handled
+CpuSample* gCpuSamples = nullptr;
+
+void onProfSignal(int, siginfo_t*, void*) {
+  if (!gCpuSampling.load(std::memory_order_acquire)) {
+    return;
+  }
+  auto savedErrno = errno;
+  auto index = gNextCpuSample.fetch_add(1, std::memory_order_relaxed);
+  if (index < kMaxCpuSamples) {
+    auto& sample = gCpuSamples[index];
+    auto depth = ::backtrace(sample.frames, kMaxCpuDepth);
+    sample.depth.store(depth, std::memory_order_release);
+  }
+  errno = savedErrno;
+}
+
+std::string symbolize(uintptr_t address, std::unordered_map<uintptr_t, std::string>& cache) {
+  auto iter = cache.find(address);
+  if (iter != cache.end()) {
+    return iter->second;
+  }
+  std::string name;
+  Dl_info info;
+  if (::dladdr(reinterpret_cast<void*>(address), &info) != 0 && info.dli_sname != nullptr) {
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    name = (status == 0 && demangled != nullptr) ? demangled : info.dli_sname;
+    ::free(demangled);
+  } else {
+    name = folly::stringPrintf("0x%lx", address);
+  }
+  cache.emplace(address, name);
+  return name;
+}
+
+}  // namespace
+
+StatusOr<std::vector<StackSample>> Profiler::profileCpu(int32_t seconds, int32_t hz) {
+  bool expected = false;
+  if (!gCpuProfiling.compare_exchange_strong(expected, true)) {
+    return Status::Error("A CPU profile is running");
+  }
+  SCOPE_EXIT {
+    gCpuProfiling.store(false);
+  };
+  if (gCpuSamples == nullptr) {
+    gCpuSamples = new CpuSample[kMaxCpuSamples];
+  }
+  for (size_t i = 0; i < kMaxCpuSamples; i++) {
+    gCpuSamples[i].depth.store(0, std::memory_order_relaxed);
+  }
+  gNextCpuSample.store(0, std::memory_order_relaxed);
+  // The unwinder may allocate when backtrace is called first, which must not be in the handler
+  void* warmUp[1];
+  ::backtrace(warmUp, 1);
+
+  struct sigaction action;
+  ::memset(&action, 0, sizeof(action));
+  action.sa_sigaction = onProfSignal;
+  action.sa_flags = SA_RESTART | SA_SIGINFO;
+  ::sigemptyset(&action.sa_mask);
+  if (::sigaction(SIGPROF, &action, nullptr) != 0) {
+    return Status::Error("Failed to handle SIGPROF: %s", ::strerror(errno));
+  }
+  gCpuSampling.store(true, std::memory_order_release);
+  struct itimerval timer;
+  ::memset(&timer, 0, sizeof(timer));
+  // tv_usec must be less than a second, so hz = 1 is one second, not 1000000 microseconds
+  auto intervalUs = 1000000 / hz;
+  timer.it_interval.tv_sec = intervalUs / 1000000;
+  timer.it_interval.tv_usec = intervalUs % 1000000;
+  timer.it_value = timer.it_interval;
+  if (::setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+    gCpuSampling.store(false, std::memory_order_release);
+    return Status::Error("Failed to set the profiling timer: %s", ::strerror(errno));
+  }
+
+  std::this_thread::sleep_for(std::chrono::seconds(seconds));
+
+  ::memset(&timer, 0, sizeof(timer));
+  ::setitimer(ITIMER_PROF, &timer, nullptr);
+  gCpuSampling.store(false, std::memory_order_release);
+  // The default action of SIGPROF terminates the process, so a pending one is ignored instead
+  ::signal(SIGPROF, SIG_IGN);
+  // Let the handlers being run finish their samples
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  auto taken = gNextCpuSample.load(std::memory_order_relaxed);
+  if (taken > kMaxCpuSamples) {
+    LOG(WARNING) << "Dropped " << taken - kMaxCpuSamples << " CPU samples of " << taken;
+  }
+  std::map<std::vector<uintptr_t>, int64_t> counts;
+  for (size_t i = 0; i < std::min(taken, kMaxCpuSamples); i++) {
+    auto& sample = gCpuSamples[i];
+    auto depth = sample.depth.load(std::memory_order_acquire);
+    if (depth <= kSignalFrames) {
+      continue;
+    }
+    std::vector<uintptr_t> stack;
+    for (int j = kSignalFrames; j < depth; j++) {
+      stack.emplace_back(reinterpret_cast<uintptr_t>(sample.frames[j]));
+    }
+    counts[std::move(stack)]++;
+  }
+  std::vector<StackSample> samples;
+  samples.reserve(counts.size());
+  for (auto& [stack, count] : counts) {
+    samples.emplace_back(StackSample{"", stack, count});
+  }
+  return samples;
+}
+
+StatusOr<std::vector<StackSample>> Profiler::profileContention(int32_t seconds) {
+  auto& profiler = thread::ContentionProfiler::instance();
+  if (!profiler.start()) {
+    return Status::Error("A contention profile is running");
+  }
+  std::this_thread::sleep_for(std::chrono::seconds(seconds));
+  std::vector<StackSample> samples;
+  for (auto& wait : profiler.stop()) {
+    samples.emplace_back(StackSample{std::move(wait.lock), std::move(wait.stack), wait.waitUs});
+  }
+  return samples;
+}
+
+StatusOr<std::string> Profiler::dumpHeap() {
+  if (mallctl == nullptr) {
+    return Status::Error("Not linked with jemalloc");
+  }
+  bool enabled = false;
+  size_t len = sizeof(enabled);
+  if (mallctl("opt.prof", &enabled, &len, nullptr, 0) != 0 || !enabled) {
+    return Status::Error("Heap profiling is off, start the process with MALLOC_CONF=prof:true");
+  }
+  static std::mutex dumpLock;
+  std::lock_guard<std::mutex> guard(dumpLock);
+  char path[] = "/tmp/nebula-heap-XXXXXX";
+  auto fd = ::mkstemp(path);
+  if (fd < 0) {
+    return Status::Error("Failed to create the heap profile: %s", ::strerror(errno));
+  }
+  ::close(fd);
+  SCOPE_EXIT {
+    ::unlink(path);
+  };
+  const char* file = path;
+  if (mallctl("prof.dump", nullptr, nullptr, &file, sizeof(file)) != 0) {
+    return Status::Error("Failed to dump the heap profile");
+  }
+  std::string profile;
+  if (!folly::readFile(path, profile)) {
+    return Status::Error("Failed to read the heap profile");
+  }
+  return profile;
+}
+
+std::string Profiler::toPprof(const std::vector<StackSample>& samples, int32_t periodUs) {
+  // The header is {0, header words, version, sampling period, padding}
+  std::vector<uintptr_t> words = {0, 3, 0, static_cast<uintptr_t>(periodUs), 0};
+  for (const auto& sample : samples) {
+    words.emplace_back(static_cast<uintptr_t>(sample.value));
+    words.emplace_back(sample.stack.size());
+    words.insert(words.end(), sample.stack.begin(), sample.stack.end());
+  }
+  // The trailer is a record of no sample
+  words.insert(words.end(), {0, 1, 0});
+  std::string profile(reinterpret_cast<const char*>(words.data()),
+                      words.size() * sizeof(uintptr_t));
+  // The mappings which pprof symbolizes the addresses with
+  std::string maps;
+  if (folly::readFile("/proc/self/maps", maps)) {
+    profile.append(maps);
+  }
+  return profile;
+}
+
+std::string Profiler::toFolded(const std::vector<StackSample>& samples) {
+  std::unordered_map<uintptr_t, std::string> symbols;
+  // Different addresses of a function are folded into one line
+  std::map<std::string, int64_t> lines;
+  for (const auto& sample : samples) {
+    std::string line = sample.root;
+    for (auto iter = sample.stack.rbegin(); iter != sample.stack.rend(); ++iter) {
+      if (!line.empty()) {
+        line.append(";");
+      }
+      line.append(symbolize(*iter, symbols));
+    }
+    lines[line] += sample.value;
+  }
+  std::string folded;
+  for (const auto& [line, value] : lines) {
+    folded.append(line).append(" ").append(std::to_string(value)).append("\n");
+  }
+  return folded;
+}
+
+}  // namespace nebula
@@ -0,0 +1,61 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef WEBSERVICE_PROFILER_H_
+#define WEBSERVICE_PROFILER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/base/Base.h"
+#include "common/base/StatusOr.h"
+
+namespace nebula {
+
+/**
+ * @brief A stack and its value, which is the number of samples of a CPU profile or the
+ * microseconds waited of a contention profile. The stack is leaf first.
+ */
+struct StackSample {
+  // The name of the outermost frame, e.g. the lock waited for, or empty
+  std::string root;
+  std::vector<uintptr_t> stack;
+  int64_t value{0};
+};
+
+/**
+ * @brief The profilers of this process served by the web service. Only one profile of a kind is
+ * taken at a time.
+ */
+class Profiler final {
+ public:
+  /**
+   * @brief Sample the stacks of the threads running on CPU by SIGPROF, the samples are taken by
+   * the signal handler into a fixed buffer, so the overhead is a stack walk per sample.
+   *
+   * @param seconds How long to profile, the calling thread sleeps meanwhile
+   * @param hz Samples per second of the CPU time
+   */
+  static StatusOr<std::vector<StackSample>> profileCpu(int32_t seconds, int32_t hz);
+
+  // Record the waits for the profiled mutexes for the duration
+  static StatusOr<std::vector<StackSample>> profileContention(int32_t seconds);
+
+  /**
+   * @brief Dump the heap profile of jemalloc, which is readable by jeprof or pprof with the
+   * binary. It fails unless the process is started with MALLOC_CONF=prof:true.
+   */
+  static StatusOr<std::string> dumpHeap();
+
+  // Encode the samples in the legacy binary CPU profile format of pprof, symbolized by pprof
+  static std::string toPprof(const std::vector<StackSample>& samples, int32_t periodUs);
+
+  // Encode the samples as folded stacks, i.e. "root;outer;...;leaf value" per line
+  static std::string toFolded(const std::vector<StackSample>& samples);
+};
+
+}  // namespace nebula
+#endif  // WEBSERVICE_PROFILER_H_
@@ -11,8 +11,10 @@
 
 #include "common/thread/NamedThread.h"
 #include "webservice/GetFlagsHandler.h"
+#include "webservice/GetMetricsHandler.h"
 #include "webservice/GetStatsHandler.h"
 #include "webservice/NotFoundHandler.h"
+#include "webservice/ProfileHandler.h"
 #include "webservice/Router.h"
 #include "webservice/SetFlagsHandler.h"
 #include "webservice/StatusHandler.h"
@@ -79,6 +81,22 @@ Status WebService::start(uint16_t httpPort) {
     DCHECK(params.empty());
     return new GetStatsHandler();
   });
+  router().get("/metrics").handler([](web::PathParams&& params) {
+    DCHECK(params.empty());
+    return new GetMetricsHandler();
+  });
+  router().get("/pprof/profile").handler([](web::PathParams&& params) {
+    DCHECK(params.empty());
+    return new ProfileHandler(ProfileHandler::Kind::kCpu);
+  });
+  router().get("/pprof/contention").handler([](web::PathParams&& params) {
+    DCHECK(params.empty());
+    return new ProfileHandler(ProfileHandler::Kind::kContention);
+  });
+  router().get("/pprof/heap").handler([](web::PathParams&& params) {
+    DCHECK(params.empty());
+    return new ProfileHandler(ProfileHandler::Kind::kHeap);
+  });
   router().get("/status").handler([](web::PathParams&& params) {
     DCHECK(params.empty());
     return new StatusHandler();
@@ -0,0 +1,120 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "common/thread/ProfiledMutex.h"
+#include "webservice/Profiler.h"
+#include "webservice/WebService.h"
+#include "webservice/test/TestUtils.h"
+
+namespace nebula {
+
+class ProfilerTestEnv : public ::testing::Environment {
+ public:
+  void SetUp() override {
+    FLAGS_ws_http_port = 0;
+    VLOG(1) << "Starting web service...";
+    webSvc_ = std::make_unique<WebService>();
+    auto status = webSvc_->start();
+    ASSERT_TRUE(status.ok()) << status;
+  }
+
+  void TearDown() override {
+    webSvc_.reset();
+    VLOG(1) << "Web service stopped";
+  }
+
+ private:
+  std::unique_ptr<WebService> webSvc_;
+};
+
+TEST(ProfilerTest, CpuProfile) {
+  std::atomic<bool> stop{false};
+  std::thread busy([&stop]() {
+    volatile uint64_t sum = 0;
+    while (!stop.load()) {
+      sum = sum + 1;
+    }
+  });
+  auto samples = Profiler::profileCpu(1, 100);
+  stop = true;
+  busy.join();
+  ASSERT_TRUE(samples.ok()) << samples.status();
+  int64_t total = 0;
+  for (const auto& sample : samples.value()) {
+    EXPECT_FALSE(sample.stack.empty());
+    total += sample.value;
+  }
+  EXPECT_GT(total, 0);
+  EXPECT_FALSE(Profiler::toFolded(samples.value()).empty());
+
+  auto pprof = Profiler::toPprof(samples.value(), 10000);
+  ASSERT_GE(pprof.size(), 5 * sizeof(uintptr_t));
+  const auto* header = reinterpret_cast<const uintptr_t*>(pprof.data());
+  EXPECT_EQ(0, header[0]);
+  EXPECT_EQ(3, header[1]);
+  EXPECT_EQ(10000, header[3]);
+}
+
+TEST(ProfilerTest, CpuProfileOneHz) {
+  // The interval of the timer is a whole second
+  auto samples = Profiler::profileCpu(1, 1);
+  ASSERT_TRUE(samples.ok()) << samples.status();
+}
+
+TEST(ProfilerTest, ContentionProfile) {
+  thread::ProfiledMutex mutex("test_lock");
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&]() {
+      while (!stop.load()) {
+        std::lock_guard<thread::ProfiledMutex> guard(mutex);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    });
+  }
+  auto samples = Profiler::profileContention(1);
+  stop = true;
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_TRUE(samples.ok()) << samples.status();
+  int64_t waitUs = 0;
+  for (const auto& sample : samples.value()) {
+    EXPECT_EQ("test_lock", sample.root);
+    waitUs += sample.value;
+  }
+  EXPECT_GT(waitUs, 0);
+  auto folded = Profiler::toFolded(samples.value());
+  EXPECT_EQ(0, folded.find("test_lock;"));
+}
+
+TEST(ProfilerTest, HttpProfile) {
+  std::string resp;
+  ASSERT_TRUE(getUrl("/pprof/contention?seconds=1", resp));
+  // No profiled mutex is contended
+  EXPECT_TRUE(resp.empty());
+
+  ASSERT_TRUE(getUrl("/pprof/profile?seconds=0", resp));
+  EXPECT_EQ("The seconds should be in [1, 300]", resp);
+
+  ASSERT_TRUE(getUrl("/pprof/contention?format=pprof", resp));
+  EXPECT_EQ("The contention profile is only in folded format", resp);
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+
+  ::testing::AddGlobalTestEnvironment(new nebula::ProfilerTestEnv());
+
+  return RUN_ALL_TESTS();
+}
@@ -196,6 +196,46 @@ TEST(StatsReaderTest, GetHistoTest) {
   }
 }
 
+TEST(StatsReaderTest, GetMetricsTest) {
+  auto counterId = StatsManager::registerStats("metric01", "sum");
+  auto labeledId = StatsManager::counterWithLabels(counterId, {{"space", "test"}});
+  auto gaugeId = StatsManager::registerStats("metric02", "sum");
+  auto histoId = StatsManager::registerHisto("metric03", 1000, 0, 2000, "p99");
+  StatsManager::addValue(counterId, 3);
+  StatsManager::addValue(labeledId, 2);
+  StatsManager::addValue(gaugeId, 2);
+  StatsManager::decValue(gaugeId);
+  StatsManager::addValue(histoId, 1);
+  StatsManager::addValue(histoId, 4000);
+  StatsManager::registerGauges("test", [](std::vector<StatsManager::Gauge>& gauges) {
+    gauges.emplace_back(StatsManager::Gauge{"metric04", {{"space", "1"}, {"part", "2"}}, 5});
+  });
+
+  std::string resp;
+  ASSERT_TRUE(getUrl("/metrics", resp));
+  auto contains = [&resp](const std::string& line) {
+    return resp.find(line + "\n") != std::string::npos;
+  };
+  EXPECT_TRUE(contains("# TYPE nebula_metric01 counter"));
+  EXPECT_TRUE(contains("nebula_metric01 3"));
+  EXPECT_TRUE(contains("nebula_metric01{space=\"test\"} 2"));
+  EXPECT_TRUE(contains("# TYPE nebula_metric02 gauge"));
+  EXPECT_TRUE(contains("nebula_metric02 1"));
+  EXPECT_TRUE(contains("# TYPE nebula_metric03 histogram"));
+  EXPECT_TRUE(contains("nebula_metric03_bucket{le=\"1\"} 1"));
+  EXPECT_TRUE(contains("nebula_metric03_bucket{le=\"2000\"} 1"));
+  EXPECT_TRUE(contains("nebula_metric03_bucket{le=\"5000\"} 2"));
+  EXPECT_TRUE(contains("nebula_metric03_bucket{le=\"+Inf\"} 2"));
+  EXPECT_TRUE(contains("nebula_metric03_sum 4001"));
+  EXPECT_TRUE(contains("nebula_metric03_count 2"));
+  EXPECT_TRUE(contains("# TYPE nebula_metric04 gauge"));
+  EXPECT_TRUE(contains("nebula_metric04{space=\"1\",part=\"2\"} 5"));
+
+  StatsManager::removeGauges("test");
+  ASSERT_TRUE(getUrl("/metrics", resp));
+  EXPECT_EQ(std::string::npos, resp.find("nebula_metric04"));
+}
+
 }  // namespace nebula
 
 int main(int argc, char** argv) {
@@ -0,0 +1,268 @@
+#!/usr/bin/env python3
+# --coding:utf-8--
+#
+# Copyright (c) 2022 vesoft inc. All rights reserved.
+#
+# This source code is licensed under Apache 2.0 License.
+"""Measure the foreground latency while the cluster goes through admin events.
+
+storage_perf runs in the open loop for the whole scenario and writes the
+latencies of each interval to a timeline. Meanwhile the events are triggered
+one by one, with some time to settle between them:
+
+    leader_balance   SUBMIT JOB BALANCE LEADER
+    data_balance     SUBMIT JOB BALANCE DATA
+    compaction       SUBMIT JOB COMPACT
+    rebuild_index    REBUILD TAG INDEX <--index>
+    wipe_replica     stop the target storaged, remove its data, and start it,
+                     so its parts catch up from the leaders by snapshots
+    restart          stop and start the target storaged
+
+For each event it reports the baseline p99 before the event, the peak p99 and
+the errors during it, and the recovery time, from the start of the event until
+the p99 is back within the tolerance of the baseline for a few intervals.
+
+    fault_scenarios.py --storage-perf build/bin/storage_perf \\
+        --perf-args "--meta_server_addrs=127.0.0.1:9559 --mix=getNeighbors:80,addEdges:20" \\
+        --graph 127.0.0.1:9669 --space test --qps 2000 \\
+        --events leader_balance,compaction,restart \\
+        --target-host 127.0.0.1:9779 \\
+        --stop-cmd "ssh {host} scripts/nebula.service stop storaged" \\
+        --start-cmd "ssh {host} scripts/nebula.service start storaged"
+"""
+
+import argparse
+import json
+import os
+import shlex
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+from nebula3.Config import Config
+from nebula3.gclient.net import ConnectionPool
+
+JOB_EVENTS = {
+    'leader_balance': 'SUBMIT JOB BALANCE LEADER',
+    'data_balance': 'SUBMIT JOB BALANCE DATA',
+    'compaction': 'SUBMIT JOB COMPACT',
+}
+PROCESS_EVENTS = ('wipe_replica', 'restart')
+
+
+class Scenario(object):
+    def __init__(self, args):
+        self.args = args
+        host, port = args.graph.split(':')
+        config = Config()
+        config.timeout = 60000
+        self.pool = ConnectionPool()
+        assert self.pool.init([(host, int(port))], config), 'graph is not ready'
+        self.session = self.pool.get_session(args.user, args.password)
+        self.execute('USE {}'.format(args.space))
+
+    def close(self):
+        self.session.release()
+        self.pool.close()
+
+    def execute(self, stmt):
+        resp = self.session.execute(stmt)
+        if not resp.is_succeeded():
+            raise RuntimeError('{}: {}'.format(stmt, resp.error_msg()))
+        return resp
+
+    def wait_job(self, job_id):
+        deadline = time.time() + self.args.event_timeout
+        while time.time() < deadline:
+            resp = self.execute('SHOW JOB {}'.format(job_id))
+            status = resp.row_values(0)[2].as_string()
+            if status in ('FINISHED', 'FAILED', 'STOPPED'):
+                return status
+            time.sleep(1)
+        return 'TIMEOUT'
+
+    def host_status(self, host):
+        resp = self.execute('SHOW HOSTS')
+        for i in range(resp.row_size()):
+            row = resp.row_values(i)
+            if '{}:{}'.format(row[0].as_string(), row[1].as_int()) == host:
+                return row[2].as_string()
+        return None
+
+    def wait_host(self, host, status):
+        deadline = time.time() + self.args.event_timeout
+        while time.time() < deadline:
+            if self.host_status(host) == status:
+                return status
+            time.sleep(1)
+        return 'TIMEOUT'
+
+    def shell(self, template):
+        cmd = template.format(host=self.args.target_host.split(':')[0])
+        subprocess.run(cmd, shell=True, check=True)
+
+    def trigger(self, event):
+        """Trigger the event and wait until it is done, return how it ended"""
+        if event in JOB_EVENTS:
+            resp = self.execute(JOB_EVENTS[event])
+            return self.wait_job(resp.row_values(0)[0].as_int())
+        if event == 'rebuild_index':
+            resp = self.execute('REBUILD TAG INDEX {}'.format(self.args.index))
+            return self.wait_job(resp.row_values(0)[0].as_int())
+        if event in PROCESS_EVENTS:
+            self.shell(self.args.stop_cmd)
+            if event == 'wipe_replica':
+                self.shell(self.args.wipe_cmd)
+            self.shell(self.args.start_cmd)
+            # The catch up of the parts shows in the latencies, not in the host status
+            return self.wait_host(self.args.target_host, 'ONLINE')
+        raise ValueError('Unknown event {}'.format(event))
+
+
+def load_timeline(path):
+    timeline = []
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line:
+                timeline.append(json.loads(line))
+    return timeline
+
+
+def analyze(timeline, event, args):
+    """The latency degradation and recovery of an event, from the windows of the timeline"""
+    start_ms = event['start'] * 1000
+    end_ms = event['end'] * 1000
+    before = [
+        w['p99_us'] for w in timeline
+        if start_ms - args.baseline_secs * 1000 <= w['time_ms'] < start_ms and w['requests'] > 0
+    ]
+    baseline = statistics.median(before) if before else 0
+    during = [w for w in timeline if w['time_ms'] >= start_ms and w['time_ms'] < event['next']]
+    peak = max((w['p99_us'] for w in during), default=0)
+    errors = sum(w['errors'] + w['dropped'] for w in during)
+
+    # Recovered once the p99 stays within the tolerance for some consecutive windows,
+    # the errors or a stall with no requests finished are not recovered
+    limit = baseline * (1 + args.tolerance)
+    recovered_ms = None
+    streak = 0
+    for w in during:
+        healthy = w['requests'] > 0 and w['errors'] == 0 and w['p99_us'] <= limit
+        streak = streak + 1 if healthy else 0
+        if streak == 1:
+            first_healthy = w['time_ms']
+        if streak >= args.recovery_windows and w['time_ms'] >= end_ms:
+            recovered_ms = first_healthy
+            break
+    return {
+        'event': event['name'],
+        'result': event['result'],
+        'duration_secs': round(event['end'] - event['start'], 1),
+        'baseline_p99_us': baseline,
+        'peak_p99_us': peak,
+        'degradation': round(peak / baseline, 2) if baseline > 0 else None,
+        'errors': errors,
+        'recovery_secs': round((recovered_ms - start_ms) / 1000, 1)
+        if recovered_ms is not None else None,
+    }
+
+
+def report(results):
+    print('{:<16}{:>10}{:>10}{:>14}{:>14}{:>8}{:>8}{:>12}'.format(
+        'event', 'result', 'secs', 'base p99(us)', 'peak p99(us)', 'x', 'errors',
+        'recovery(s)'))
+    for r in results:
+        print('{:<16}{:>10}{:>10}{:>14}{:>14}{:>8}{:>8}{:>12}'.format(
+            r['event'], r['result'], r['duration_secs'], r['baseline_p99_us'], r['peak_p99_us'],
+            str(r['degradation']), r['errors'],
+            'never' if r['recovery_secs'] is None else r['recovery_secs']))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--storage-perf', default='build/bin/storage_perf')
+    parser.add_argument('--perf-args', default='', help='The other arguments of storage_perf')
+    parser.add_argument('--qps', type=int, default=1000, help='The load during the scenario')
+    parser.add_argument('--graph', default='127.0.0.1:9669', help='The graphd to run admin on')
+    parser.add_argument('--user', default='root')
+    parser.add_argument('--password', default='nebula')
+    parser.add_argument('--space', default='test')
+    parser.add_argument('--events',
+                        default='leader_balance,data_balance,compaction,rebuild_index,'
+                        'wipe_replica,restart')
+    parser.add_argument('--index', help='The tag index of rebuild_index')
+    parser.add_argument('--target-host', help='The storaged host:port of wipe_replica and restart')
+    parser.add_argument('--stop-cmd', help='The shell command to stop storaged on {host}')
+    parser.add_argument('--start-cmd', help='The shell command to start storaged on {host}')
+    parser.add_argument('--wipe-cmd', help='The shell command to remove the data on {host}')
+    parser.add_argument('--warmup-secs', type=int, default=60)
+    parser.add_argument('--settle-secs', type=int, default=60, help='The time after each event')
+    parser.add_argument('--event-timeout', type=int, default=3600)
+    parser.add_argument('--baseline-secs', type=int, default=30,
+                        help='The windows before an event its baseline is from')
+    parser.add_argument('--tolerance', type=float, default=0.2,
+                        help='How far above the baseline p99 is still regarded as recovered')
+    parser.add_argument('--recovery-windows', type=int, default=5)
+    parser.add_argument('--output', help='Where the results are written as json')
+    args = parser.parse_args()
+
+    events = [e.strip() for e in args.events.split(',') if e.strip()]
+    unknown = set(events) - set(JOB_EVENTS) - set(PROCESS_EVENTS) - {'rebuild_index'}
+    if unknown:
+        parser.error('Unknown events: {}'.format(', '.join(sorted(unknown))))
+    if 'rebuild_index' in events and not args.index:
+        parser.error('rebuild_index needs --index')
+    if set(events) & set(PROCESS_EVENTS) and not (args.target_host and args.stop_cmd
+                                                   and args.start_cmd):
+        parser.error('wipe_replica and restart need --target-host, --stop-cmd and --start-cmd')
+    if 'wipe_replica' in events and not args.wipe_cmd:
+        parser.error('wipe_replica needs --wipe-cmd')
+
+    scenario = Scenario(args)
+    timeline_path = tempfile.mktemp(suffix='.timeline')
+    # Long enough for the events, it is stopped after the last one
+    total = args.qps * (args.warmup_secs + (args.event_timeout + args.settle_secs) * len(events))
+    cmd = [args.storage_perf] + shlex.split(args.perf_args) + [
+        '--open_loop=true',
+        '--qps={}'.format(args.qps),
+        '--totalReqs={}'.format(min(total, 2**31 - 1)),
+        '--timeline_output={}'.format(timeline_path),
+    ]
+    perf = subprocess.Popen(cmd)
+    recorded = []
+    try:
+        time.sleep(args.warmup_secs)
+        for name in events:
+            print('Triggering {}'.format(name), flush=True)
+            start = time.time()
+            try:
+                result = scenario.trigger(name)
+            except (RuntimeError, subprocess.CalledProcessError) as e:
+                print('Failed to trigger {}: {}'.format(name, e), file=sys.stderr)
+                result = 'ERROR'
+            end = time.time()
+            time.sleep(args.settle_secs)
+            recorded.append({'name': name, 'result': result, 'start': start, 'end': end})
+    finally:
+        perf.terminate()
+        perf.wait()
+        scenario.close()
+
+    timeline = load_timeline(timeline_path)
+    os.remove(timeline_path)
+    for i, event in enumerate(recorded):
+        event['next'] = (recorded[i + 1]['start'] if i + 1 < len(recorded) else time.time()) * 1000
+    results = [analyze(timeline, event, args) for event in recorded]
+    report(results)
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump({'events': results, 'timeline': timeline}, f, indent=2)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
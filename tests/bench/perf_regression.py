@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+# --coding:utf-8--
+#
+# Copyright (c) 2022 vesoft inc. All rights reserved.
+#
+# This source code is licensed under Apache 2.0 License.
+"""Run the benchmarks and compare the results with a stored baseline.
+
+The folly benchmarks under */test are built into <build>/bin/bench and print
+their results as json with --json, which covers graphd, storaged, codec and
+the common libs. The graph_perf and storage_perf tools need running services,
+so they are only run when their arguments are given.
+
+    # Record the baseline of the current commit
+    perf_regression.py run --build-dir build --baseline-dir perf-baselines
+
+    # Compare the current commit with the baseline of a given commit
+    perf_regression.py run --build-dir build --output current.json
+    perf_regression.py compare --baseline-dir perf-baselines \\
+        --baseline <commit> --current current.json --threshold 0.1
+"""
+
+import argparse
+import json
+import os
+import re
+import shlex
+import subprocess
+import sys
+import tempfile
+import time
+
+# The metrics of which a higher value is better, all others are times or latencies
+HIGHER_IS_BETTER = re.compile(r'(^|[./])(qps|throughput|.*_per_sec)$')
+
+
+def git_commit(path):
+    try:
+        out = subprocess.check_output(['git', 'rev-parse', 'HEAD'], cwd=path)
+        return out.decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return 'unknown'
+
+
+def run_folly_benchmark(binary, timeout):
+    """Run a folly benchmark, the result maps each benchmark to its time of an
+    iteration in ns"""
+    proc = subprocess.run([binary, '--json'],
+                          stdout=subprocess.PIPE,
+                          stderr=subprocess.PIPE,
+                          timeout=timeout)
+    if proc.returncode != 0:
+        raise RuntimeError('{} exited with {}: {}'.format(
+            binary, proc.returncode, proc.stderr.decode()[-1000:]))
+    # The json is the last thing printed, skip anything logged before it
+    out = proc.stdout.decode()
+    start = out.find('{')
+    if start < 0:
+        raise RuntimeError('{} printed no json'.format(binary))
+    return {name: float(value) for name, value in json.loads(out[start:]).items()}
+
+
+def flatten(prefix, value, metrics):
+    if isinstance(value, dict):
+        for key, item in value.items():
+            flatten('{}.{}'.format(prefix, key) if prefix else key, item, metrics)
+    elif isinstance(value, (int, float)) and not isinstance(value, bool):
+        metrics[prefix] = float(value)
+
+
+def run_tool(binary, args, timeout):
+    """Run graph_perf or storage_perf, the result is their json output flattened"""
+    with tempfile.NamedTemporaryFile(suffix='.json') as output:
+        cmd = [binary] + shlex.split(args) + ['--json_output=' + output.name]
+        subprocess.run(cmd, check=True, timeout=timeout)
+        with open(output.name) as f:
+            result = json.load(f)
+    metrics = {}
+    flatten('', result, metrics)
+    # Only the latencies and throughput measure the performance
+    return {
+        name: value
+        for name, value in metrics.items()
+        if re.search(r'(p\d+|max|mean)_(ms|us)$|(^|\.)qps$', name)
+    }
+
+
+def run(args):
+    bench_dir = os.path.join(args.build_dir, 'bin', 'bench')
+    tools_dir = os.path.join(args.build_dir, 'bin')
+    pattern = re.compile(args.filter) if args.filter else None
+    results = {}
+    failures = []
+    binaries = sorted(os.listdir(bench_dir)) if os.path.isdir(bench_dir) else []
+    for name in binaries:
+        binary = os.path.join(bench_dir, name)
+        if not os.access(binary, os.X_OK) or (pattern and not pattern.search(name)):
+            continue
+        print('Running {}'.format(name), flush=True)
+        try:
+            results[name] = run_folly_benchmark(binary, args.timeout)
+        except (RuntimeError, subprocess.TimeoutExpired, ValueError) as e:
+            print('Failed to run {}: {}'.format(name, e), file=sys.stderr)
+            failures.append(name)
+    for name, tool_args in (('graph_perf', args.graph_perf_args),
+                            ('storage_perf', args.storage_perf_args)):
+        if tool_args is None:
+            continue
+        print('Running {}'.format(name), flush=True)
+        try:
+            results[name] = run_tool(os.path.join(tools_dir, name), tool_args, args.timeout)
+        except (OSError, subprocess.SubprocessError, ValueError) as e:
+            print('Failed to run {}: {}'.format(name, e), file=sys.stderr)
+            failures.append(name)
+
+    commit = args.commit or git_commit(os.path.dirname(os.path.abspath(__file__)))
+    report = {
+        'commit': commit,
+        'timestamp': int(time.time()),
+        'results': results,
+        'failures': failures,
+    }
+    output = args.output
+    if output is None:
+        os.makedirs(args.baseline_dir, exist_ok=True)
+        output = os.path.join(args.baseline_dir, commit + '.json')
+    with open(output, 'w') as f:
+        json.dump(report, f, indent=2, sort_keys=True)
+    print('Results of {} benchmarks written to {}'.format(len(results), output))
+    return 1 if failures else 0
+
+
+def load(path_or_commit, baseline_dir):
+    path = path_or_commit
+    if not os.path.isfile(path):
+        path = os.path.join(baseline_dir, path_or_commit + '.json')
+    with open(path) as f:
+        return json.load(f)
+
+
+def compare(args):
+    baseline = load(args.baseline, args.baseline_dir)
+    current = load(args.current, args.baseline_dir)
+    regressions = []
+    improvements = []
+    missing = []
+    for binary, metrics in sorted(baseline['results'].items()):
+        for name, base in sorted(metrics.items()):
+            value = current['results'].get(binary, {}).get(name)
+            if value is None:
+                missing.append('{}/{}'.format(binary, name))
+                continue
+            if base <= 0:
+                continue
+            change = (value - base) / base
+            if HIGHER_IS_BETTER.search(name):
+                change = -change
+            entry = (binary, name, base, value, change)
+            if change > args.threshold:
+                regressions.append(entry)
+            elif change < -args.threshold:
+                improvements.append(entry)
+
+    print('Baseline {}, current {}, threshold {:.1%}'.format(
+        baseline['commit'], current['commit'], args.threshold))
+    for title, entries in (('Regressions', regressions), ('Improvements', improvements)):
+        if not entries:
+            continue
+        print('\n{}:'.format(title))
+        print('{:<32}{:<64}{:>14}{:>14}{:>10}'.format(
+            'binary', 'benchmark', 'baseline', 'current', 'change'))
+        for binary, name, base, value, change in entries:
+            print('{:<32}{:<64}{:>14.4g}{:>14.4g}{:>+10.1%}'.format(
+                binary, name, base, value, change))
+    if missing:
+        print('\nMissing in current: {}'.format(', '.join(missing)))
+    if current.get('failures'):
+        print('\nFailed in current: {}'.format(', '.join(current['failures'])))
+    return 1 if regressions or current.get('failures') else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--baseline-dir',
+                        default='perf-baselines',
+                        help='Where the baselines are stored, one file per commit')
+    subparsers = parser.add_subparsers(dest='command', required=True)
+
+    run_parser = subparsers.add_parser('run', help='Run the benchmarks')
+    run_parser.add_argument('--build-dir', default='build', help='The cmake build directory')
+    run_parser.add_argument('--filter', help='Only run the benchmarks matching the regex')
+    run_parser.add_argument('--timeout', type=int, default=1800, help='Timeout of a run in secs')
+    run_parser.add_argument('--commit', help='The commit recorded, HEAD by default')
+    run_parser.add_argument('--output',
+                            help='Where the results are written, the baseline of the '
+                            'commit by default')
+    run_parser.add_argument('--graph-perf-args',
+                            help='Run graph_perf with these arguments, e.g. '
+                            '"--graph_server_addrs=127.0.0.1:9669 --duration_secs=60"')
+    run_parser.add_argument('--storage-perf-args',
+                            help='Run storage_perf with these arguments, e.g. '
+                            '"--meta_server_addrs=127.0.0.1:9559 --method=getNeighbors"')
+
+    compare_parser = subparsers.add_parser('compare', help='Compare with a baseline')
+    compare_parser.add_argument('--baseline',
+                                required=True,
+                                help='A result file, or a commit of which the baseline is stored')
+    compare_parser.add_argument('--current',
+                                required=True,
+                                help='A result file, or a commit of which the baseline is stored')
+    compare_parser.add_argument('--threshold',
+                                type=float,
+                                default=0.1,
+                                help='The relative change regarded as a regression')
+
+    args = parser.parse_args()
+    return run(args) if args.command == 'run' else compare(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -637,6 +637,26 @@ Feature: Basic Aggregate and GroupBy
       | sum |
       | 6   |
 
+  Scenario: Approximate aggregates
+    When executing query:
+      """
+      UNWIND [1,2,3,3,4,5,null] AS d
+      RETURN approx_count_distinct(d) AS ndv,
+             approx_median(d) AS median,
+             approx_p99(d) AS p99,
+             size(reservoir_sample(d)) AS sampled
+      """
+    Then the result should be, in any order, with relax comparison:
+      | ndv | median | p99  | sampled |
+      | 5   | 3.0    | 5.0  | 6       |
+    When executing query:
+      """
+      UNWIND [1,"a"] AS d RETURN approx_median(d) AS median
+      """
+    Then the result should be, in any order:
+      | median   |
+      | BAD_TYPE |
+
   Scenario: Reference the output of group by
     When executing query:
       """
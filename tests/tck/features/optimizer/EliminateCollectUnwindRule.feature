@@ -0,0 +1,67 @@
+# Copyright (c) 2022 vesoft inc. All rights reserved.
+#
+# This source code is licensed under Apache 2.0 License.
+Feature: Eliminate Collect Unwind Rule
+
+  Background:
+    Given a graph with space named "nba"
+
+  Scenario: Eliminate collect and unwind
+    When executing query:
+      """
+      MATCH (:player {name:"Tim Duncan"})-[e:like]->(dst)
+      WITH collect(dst.player.age) AS ages
+      UNWIND ages AS age
+      RETURN age + 1 AS age
+      """
+    Then the result should be, in any order:
+      | age |
+      | 37  |
+      | 42  |
+    When executing query:
+      """
+      UNWIND [1, null, 2, 2, 3] AS a
+      WITH collect(a) AS xs
+      UNWIND xs AS x
+      RETURN x * 2 AS y
+      """
+    Then the result should be, in any order:
+      | y |
+      | 2 |
+      | 4 |
+      | 4 |
+      | 6 |
+    When executing query:
+      """
+      UNWIND [1, null, 2, 2, 3] AS a
+      WITH collect(DISTINCT a) AS xs
+      UNWIND xs AS x
+      RETURN x * 2 AS y
+      """
+    Then the result should be, in any order:
+      | y |
+      | 2 |
+      | 4 |
+      | 6 |
+    When executing query:
+      """
+      UNWIND [] AS a
+      WITH collect(a) AS xs
+      UNWIND xs AS x
+      RETURN x
+      """
+    Then the result should be, in any order:
+      | x |
+
+  Scenario: Keep collect and unwind if the list is still read
+    When executing query:
+      """
+      UNWIND [1, null, 2] AS a
+      WITH collect(a) AS xs
+      UNWIND xs AS x
+      RETURN x, size(xs) AS n
+      """
+    Then the result should be, in any order:
+      | x | n |
+      | 1 | 2 |
+      | 2 | 2 |
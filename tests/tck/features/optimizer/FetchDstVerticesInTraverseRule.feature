@@ -0,0 +1,28 @@
+# Copyright (c) 2022 vesoft inc. All rights reserved.
+#
+# This source code is licensed under Apache 2.0 License.
+Feature: Fetch Dst Vertices In Traverse Rule
+
+  Background:
+    Given a graph with space named "nba"
+
+  Scenario: Read the dst vertices along with the edges
+    When executing query:
+      """
+      MATCH (:player {name:"Tim Duncan"})-[:like]->(d)
+      RETURN d.player.name AS name, d.player.age AS age
+      """
+    Then the result should be, in any order:
+      | name            | age |
+      | "Tony Parker"   | 36  |
+      | "Manu Ginobili" | 41  |
+    When executing query:
+      """
+      MATCH (:player {name:"Tony Parker"})-[:like]->(d:player)
+      RETURN d.player.name AS name, d.player.age AS age
+      """
+    Then the result should be, in any order:
+      | name                | age |
+      | "LaMarcus Aldridge" | 33  |
+      | "Manu Ginobili"     | 41  |
+      | "Tim Duncan"        | 42  |
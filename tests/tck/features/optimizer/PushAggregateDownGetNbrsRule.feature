@@ -0,0 +1,94 @@
+# Copyright (c) 2022 vesoft inc. All rights reserved.
+#
+# This source code is licensed under Apache 2.0 License.
+Feature: Push Aggregate down GetNeighbors rule
+
+  Background:
+    Given a graph with space named "nba"
+
+  Scenario: push count group by source vertex down to GetNeighbors
+    When profiling query:
+      """
+      GO FROM "Tim Duncan", "Tony Parker", "Spurs" OVER like YIELD src(edge) AS src |
+      GROUP BY $-.src YIELD $-.src AS src, count(*) AS cnt
+      """
+    Then the result should be, in any order:
+      | src           | cnt |
+      | "Tim Duncan"  | 2   |
+      | "Tony Parker" | 3   |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info         |
+      | 4  | Aggregate    | 5            |                       |
+      | 5  | Filter       | 6            |                       |
+      | 6  | Project      | 7            |                       |
+      | 7  | GetNeighbors | 0            | {"statsOnly": "true"} |
+      | 0  | Start        |              |                       |
+    When profiling query:
+      """
+      GO FROM "Tim Duncan", "Tony Parker" OVER like, serve YIELD id($^) AS src |
+      GROUP BY $-.src YIELD count(*) AS cnt, $-.src AS src
+      """
+    Then the result should be, in any order:
+      | cnt | src           |
+      | 3   | "Tim Duncan"  |
+      | 5   | "Tony Parker" |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info         |
+      | 4  | Aggregate    | 5            |                       |
+      | 5  | Filter       | 6            |                       |
+      | 6  | Project      | 7            |                       |
+      | 7  | GetNeighbors | 0            | {"statsOnly": "true"} |
+      | 0  | Start        |              |                       |
+
+  Scenario: push count without group key down to GetNeighbors
+    When profiling query:
+      """
+      GO FROM "Tim Duncan", "Tony Parker" OVER like YIELD like._dst AS dst |
+      YIELD count(*) AS cnt
+      """
+    Then the result should be, in any order:
+      | cnt |
+      | 5   |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info         |
+      | 4  | Aggregate    | 5            |                       |
+      | 5  | Filter       | 6            |                       |
+      | 6  | Project      | 7            |                       |
+      | 7  | GetNeighbors | 0            | {"statsOnly": "true"} |
+      | 0  | Start        |              |                       |
+
+  Scenario: not push aggregate of nullable property down to GetNeighbors
+    When profiling query:
+      """
+      GO FROM "Tim Duncan", "Tony Parker" OVER like YIELD src(edge) AS src, like.likeness AS l |
+      GROUP BY $-.src YIELD $-.src AS src, sum($-.l) AS total
+      """
+    Then the result should be, in any order:
+      | src           | total |
+      | "Tim Duncan"  | 190   |
+      | "Tony Parker" | 280   |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info |
+      | 4  | Aggregate    | 5            |               |
+      | 5  | Project      | 6            |               |
+      | 6  | GetNeighbors | 0            |               |
+      | 0  | Start        |              |               |
+
+  Scenario: not push count group by destination vertex down to GetNeighbors
+    When profiling query:
+      """
+      GO FROM "Tim Duncan", "Tony Parker" OVER like YIELD dst(edge) AS dst |
+      GROUP BY $-.dst YIELD $-.dst AS dst, count(*) AS cnt
+      """
+    Then the result should be, in any order:
+      | dst                 | cnt |
+      | "Tony Parker"       | 1   |
+      | "Manu Ginobili"     | 2   |
+      | "Tim Duncan"        | 1   |
+      | "LaMarcus Aldridge" | 1   |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info |
+      | 4  | Aggregate    | 5            |               |
+      | 5  | Project      | 6            |               |
+      | 6  | GetNeighbors | 0            |               |
+      | 0  | Start        |              |               |
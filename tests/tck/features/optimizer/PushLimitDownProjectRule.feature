@@ -22,12 +22,10 @@ Feature: Push Limit down project rule
       | <("Tim Duncan" :bachelor{name: "Tim Duncan", speciality: "psychology"} :player{age: 42, name: "Tim Duncan"})-[:like@0 {likeness: 95}]->("Manu Ginobili" :player{age: 41, name: "Manu Ginobili"})>                                 |
       | <("Tim Duncan" :bachelor{name: "Tim Duncan", speciality: "psychology"} :player{age: 42, name: "Tim Duncan"})-[:like@0 {likeness: 95}]->("Tony Parker" :player{age: 36, name: "Tony Parker"})>                                     |
     And the execution plan should be:
-      | id | name           | dependencies | operator info |
-      | 19 | Project        | 16           |               |
-      | 16 | Limit          | 11           |               |
-      | 11 | Filter         | 4            |               |
-      | 4  | AppendVertices | 3            |               |
-      | 3  | Traverse       | 2            |               |
-      | 2  | Dedup          | 1            |               |
-      | 1  | PassThrough    | 0            |               |
-      | 0  | Start          |              |               |
+      | id | name               | dependencies | operator info |
+      | 19 | FilterProjectLimit | 4            |               |
+      | 4  | AppendVertices     | 3            |               |
+      | 3  | Traverse           | 2            |               |
+      | 2  | Dedup              | 1            |               |
+      | 1  | PassThrough        | 0            |               |
+      | 0  | Start              |              |               |
@@ -0,0 +1,82 @@
+# Copyright (c) 2022 vesoft inc. All rights reserved.
+#
+# This source code is licensed under Apache 2.0 License.
+Feature: Push TopN down GetNeighbors rule
+
+  Background:
+    Given a graph with space named "nba"
+
+  Scenario: push topn of edge property down to GetNeighbors
+    When profiling query:
+      """
+      GO 1 STEPS FROM "Marco Belinelli", "Tim Duncan" OVER like
+      YIELD like.likeness AS likeness |
+      ORDER BY $-.likeness DESC |
+      LIMIT 2
+      """
+    Then the result should be, in order:
+      | likeness |
+      | 95       |
+      | 95       |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info  |
+      | 0  | DataCollect  | 1            |                |
+      | 1  | TopN         | 2            |                |
+      | 2  | Project      | 3            |                |
+      | 3  | GetNeighbors | 4            | {"limit": "2"} |
+      | 4  | Start        |              |                |
+    When profiling query:
+      """
+      GO 1 STEPS FROM "Tim Duncan" OVER like
+      YIELD like.likeness AS likeness, like._dst AS dst |
+      ORDER BY $-.likeness DESC, $-.dst |
+      LIMIT 1
+      """
+    Then the result should be, in order:
+      | likeness | dst             |
+      | 95       | "Manu Ginobili" |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info  |
+      | 0  | DataCollect  | 1            |                |
+      | 1  | TopN         | 2            |                |
+      | 2  | Project      | 3            |                |
+      | 3  | GetNeighbors | 4            | {"limit": "1"} |
+      | 4  | Start        |              |                |
+
+  Scenario: push topn with offset down to GetNeighbors
+    When profiling query:
+      """
+      GO 1 STEPS FROM "Marco Belinelli" OVER like
+      YIELD like.likeness AS likeness |
+      ORDER BY $-.likeness |
+      LIMIT 1, 1
+      """
+    Then the result should be, in order:
+      | likeness |
+      | 55       |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info  |
+      | 0  | DataCollect  | 1            |                |
+      | 1  | TopN         | 2            |                |
+      | 2  | Project      | 3            |                |
+      | 3  | GetNeighbors | 4            | {"limit": "2"} |
+      | 4  | Start        |              |                |
+
+  Scenario: not push topn of source vertex property down to GetNeighbors
+    When profiling query:
+      """
+      GO 1 STEPS FROM "Marco Belinelli" OVER like
+      YIELD $^.player.name AS name |
+      ORDER BY $-.name |
+      LIMIT 1
+      """
+    Then the result should be, in order:
+      | name              |
+      | "Marco Belinelli" |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info   |
+      | 0  | DataCollect  | 1            |                 |
+      | 1  | TopN         | 2            |                 |
+      | 2  | Project      | 3            |                 |
+      | 3  | GetNeighbors | 4            | {"limit": "-1"} |
+      | 4  | Start        |              |                 |
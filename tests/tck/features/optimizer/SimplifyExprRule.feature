@@ -0,0 +1,48 @@
+# Copyright (c) 2022 vesoft inc. All rights reserved.
+#
+# This source code is licensed under Apache 2.0 License.
+Feature: simplify the expressions of filter and project
+
+  Background:
+    Given a graph with space named "nba"
+
+  Scenario: simplify the filter condition
+    When executing query:
+      """
+      MATCH (v:player{name: "Tim Duncan"})-[:like]->(n)
+      WHERE n.player.age > 40 - 1 AND true AND n.player.age > 40 - 1
+      RETURN n.player.name AS name
+      """
+    Then the result should be, in any order:
+      | name            |
+      | "Manu Ginobili" |
+    When executing query:
+      """
+      MATCH (v:player{name: "Tim Duncan"})-[:like]->(n)
+      WHERE NOT (n.player.age < 40 - 1 OR false)
+      RETURN n.player.name AS name
+      """
+    Then the result should be, in any order:
+      | name            |
+      | "Manu Ginobili" |
+    When executing query:
+      """
+      MATCH (v:player{name: "Tim Duncan"})-[:like]->(n)
+      WHERE n.player.age > 40 OR true
+      RETURN n.player.name AS name
+      """
+    Then the result should be, in any order:
+      | name            |
+      | "Tony Parker"   |
+      | "Manu Ginobili" |
+
+  Scenario: simplify the project columns
+    When executing query:
+      """
+      MATCH (v:player{name: "Tim Duncan"})-[:like]->(n)
+      RETURN n.player.name, n.player.age > 40 - 1 AND true AS old
+      """
+    Then the result should be, in any order:
+      | n.player.name   | old   |
+      | "Tony Parker"   | false |
+      | "Manu Ginobili" | true  |
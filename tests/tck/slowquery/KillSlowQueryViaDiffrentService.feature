@@ -31,8 +31,8 @@ Feature: Slow Query Test
       SHOW QUERIES
       """
     Then the result should be, in order:
-      | SessionID | ExecutionPlanID | User   | Host | StartTime | DurationInUSec | Status    | Query                                                           |
-      | /\d+/     | /\d+/           | "root" | /.*/ | /.*/      | /\d+/          | "RUNNING" | "GO 100000 STEPS FROM \"Tim Duncan\" OVER like YIELD like._dst" |
+      | SessionID | ExecutionPlanID | User   | Host | StartTime | DurationInUSec | MemoryInBytes | Status    | Query                                                           | CpuTimeInUSec | PeakMemoryInBytes | StorageRpcs | StorageResponseBytes | RowsScanned | StageDurationInUSec |
+      | /\d+/     | /\d+/           | "root" | /.*/ | /.*/      | /\d+/          | /\d+/         | "RUNNING" | "GO 100000 STEPS FROM \"Tim Duncan\" OVER like YIELD like._dst" | /\d+/         | /\d+/             | /\d+/       | /\d+/                | /\d+/       | /.*/                |
     When executing query via graph 1:
       """
       SHOW QUERIES